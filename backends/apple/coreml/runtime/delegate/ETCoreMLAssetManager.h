@@ -99,6 +99,14 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSUInteger)compact:(NSUInteger)sizeInBytes error:(NSError* __autoreleasing*)error;
 
 
+/// Compacts the assets storage in the background if it's larger than `maxAssetsSizeInBytes`.
+/// The least recently used assets that aren't in use are removed until the storage is at most
+/// three quarters of `maxAssetsSizeInBytes`.
+///
+/// Called after every store and at initialization. Call it after an asset stops being used, so
+/// that assets that were skipped because they were in use can be removed.
+- (void)triggerCompaction;
+
 /// Purges the assets storage. The assets are moved to the trash directory and are asynchronously
 /// deleted.
 ///
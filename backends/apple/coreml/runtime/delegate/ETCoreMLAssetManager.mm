@@ -229,11 +229,12 @@ get_assets_to_remove(ModelAssetsStore& store,
                      NSMapTable<NSString *, ETCoreMLAsset *> *assets_in_use_map,
                      std::error_code &error) {
     std::vector<Asset> assets;
-    store.impl()->get_keys_sorted_by_access_count([store = store.impl(),
-                                                   &bytes_to_remove,
-                                                   &assets,
-                                                   assets_in_use_map,
-                                                   &error](const std::string& key) {
+    // Evict the least recently used assets first.
+    store.impl()->get_keys_sorted_by_access_time([store = store.impl(),
+                                                  &bytes_to_remove,
+                                                  &assets,
+                                                  assets_in_use_map,
+                                                  &error](const std::string& key) {
         if (bytes_to_remove <= 0) {
             return false;
         }
@@ -258,6 +259,11 @@ get_assets_to_remove(ModelAssetsStore& store,
 }
 } //namespace
 
+namespace {
+/// The fraction of the maximum assets size that an automatic compaction shrinks the store to.
+constexpr double kCompactionTargetRatio = 0.75;
+} //namespace
+
 @interface ETCoreMLAssetManager () <NSFileManagerDelegate> {
     ModelAssetsStore _assetsStore;
     ModelAssetsMetaStore _assetsMetaStore;
@@ -437,14 +443,16 @@ get_assets_to_remove(ModelAssetsStore& store,
 }
 
 - (void)triggerCompaction {
-    if (self.estimatedSizeInBytes < self.maxAssetsSizeInBytes) {
+    if (self.estimatedSizeInBytes <= self.maxAssetsSizeInBytes) {
         return;
     }
     
+    // Compact below the limit so that the next few stores don't each trigger another compaction.
+    NSUInteger targetSizeInBytes = static_cast<NSUInteger>(self.maxAssetsSizeInBytes * kCompactionTargetRatio);
     __weak __typeof(self) weakSelf = self;
     dispatch_async(self.syncQueue, ^{
         NSError *localError = nil;
-        if (![weakSelf _compact:self.maxAssetsSizeInBytes error:&localError]) {
+        if (![weakSelf _compact:targetSizeInBytes error:&localError] && localError) {
             ETCoreMLLogError(localError,
                              "%@: Failed to compact asset store.",
                              NSStringFromClass(ETCoreMLAssetManager.class));
@@ -52,6 +52,36 @@ typedef void ModelHandle;
                           args:(NSArray<MLMultiArray*>*)args
                          error:(NSError* __autoreleasing*)error;
 
+/// Executes the loaded model and reports how many outputs had to be copied.
+///
+/// An output is written in place when its data type, shape, and layout match the model's
+/// output description. Otherwise CoreML writes it to a buffer of its own, and the result
+/// is copied into the output.
+///
+/// @param handle The handle to the loaded model.
+/// @param args The arguments to the model.
+/// @param numberOfCopiedOutputs   If not `NULL`, set to the number of outputs that were copied.
+/// @param error   On failure, error is filled with the failure information.
+/// @retval `YES` if the execution succeeded otherwise `NO`.
+- (BOOL)executeModelWithHandle:(ModelHandle*)handle
+                          args:(NSArray<MLMultiArray*>*)args
+         numberOfCopiedOutputs:(nullable NSUInteger*)numberOfCopiedOutputs
+                         error:(NSError* __autoreleasing*)error;
+
+/// Executes the loaded model once for each element of `argsBatch`, as a single batch prediction.
+///
+/// Batching amortizes the cost of dispatching the model, for example onto the Neural Engine.
+/// Each element of `argsBatch` holds the inputs and outputs of one execution, like the `args`
+/// of `executeModelWithHandle:args:error:`. The outputs are always copied from the results.
+///
+/// @param handle The handle to the loaded model.
+/// @param argsBatch The arguments of each execution.
+/// @param error   On failure, error is filled with the failure information.
+/// @retval `YES` if all the executions succeeded otherwise `NO`.
+- (BOOL)executeModelWithHandle:(ModelHandle*)handle
+                     argsBatch:(NSArray<NSArray<MLMultiArray*>*>*)argsBatch
+                         error:(NSError* __autoreleasing*)error;
+
 /// Unloads the loaded model.
 ///
 /// @param handle The handle to the loaded model.
@@ -69,8 +69,41 @@ BOOL is_backed_by_same_buffer(MLMultiArray *array1, MLMultiArray *array2) {
     return result;
 }
 
+BOOL is_contiguous(MLMultiArray *array) {
+    NSInteger expected_stride = 1;
+    for (NSInteger i = static_cast<NSInteger>(array.shape.count) - 1; i >= 0; i--) {
+        if (array.strides[i].integerValue != expected_stride) {
+            return NO;
+        }
+        expected_stride *= array.shape[i].integerValue;
+    }
+    
+    return YES;
+}
+
+/// Returns `YES` if CoreML can write the output described by `description` directly into `output`.
+/// CoreML allocates a buffer of its own for a backing that doesn't match the description.
+BOOL can_back_output(MLMultiArray *output, MLFeatureDescription * _Nullable description) {
+    MLMultiArrayConstraint *constraint = description.multiArrayConstraint;
+    if (description.type != MLFeatureTypeMultiArray || !constraint) {
+        return NO;
+    }
+    if (constraint.dataType != output.dataType) {
+        return NO;
+    }
+    // Flexible outputs only have their shape fixed at prediction time.
+    if (constraint.shapeConstraint.type == MLMultiArrayShapeConstraintTypeUnspecified &&
+        constraint.shape.count > 0 &&
+        ![constraint.shape isEqualToArray:output.shape]) {
+        return NO;
+    }
+    
+    return ::is_contiguous(output);
+}
+
 MLPredictionOptions *get_prediction_options(NSArray<MLMultiArray *> *outputs,
                                             NSOrderedSet<NSString *> *output_names,
+                                            MLModelDescription *model_description,
                                             NSError * __autoreleasing *error) {
     MLPredictionOptions *options = [MLPredictionOptions new];
     NSMutableDictionary<NSString *, id> *output_backings = [NSMutableDictionary new];
@@ -81,41 +114,53 @@ MLPredictionOptions *get_prediction_options(NSArray<MLMultiArray *> *outputs,
             ETCoreMLLogErrorAndSetNSError(error, 0, "%@: Model is broken.", NSStringFromClass(ETCoreMLModelManager.class));
             return nil;
         }
-        output_backings[output_name] = output;
+        // Outputs that can't back the prediction are copied from CoreML's result instead.
+        if (::can_back_output(output, model_description.outputDescriptionsByName[output_name])) {
+            output_backings[output_name] = output;
+        }
     }
     options.outputBackings = output_backings;
     
     return options;
 }
 
-BOOL copy(MLMultiArray *src, MLMultiArray *dst, NSError * __autoreleasing *error) {
+BOOL copy(MLMultiArray *src, MLMultiArray *dst, BOOL *copied, NSError * __autoreleasing *error) {
     if (![src.shape isEqualToArray:dst.shape]) {
         ETCoreMLLogErrorAndSetNSError(error, 0, "%@: Model is broken", NSStringFromClass(ETCoreMLModelManager.class));
         return NO;
     }
+    *copied = NO;
     if (::is_backed_by_same_buffer(src, dst)) {
         return YES;
     }
     @autoreleasepool {
         [src copyInto:dst];
     }
+    *copied = YES;
     return YES;
 }
 
 BOOL set_outputs(NSArray<MLMultiArray *> *outputs,
                  id<MLFeatureProvider> feature_provider,
                  NSOrderedSet<NSString *> *output_names,
+                 NSUInteger *number_of_copied_outputs,
                  NSError * __autoreleasing *error) {
     NSEnumerator<NSString *> *enumerator = [output_names objectEnumerator];
+    NSUInteger n_copied = 0;
     for (MLMultiArray *output in outputs) {
         NSString *name = [enumerator nextObject];
         MLFeatureValue *featureValue = [feature_provider featureValueForName:name];
         MLMultiArray *result = featureValue.multiArrayValue;
-        if (!::copy(result, output, error)) {
+        BOOL copied = NO;
+        if (!::copy(result, output, &copied, error)) {
             return NO;
         }
+        n_copied += copied ? 1 : 0;
     }
     
+    if (number_of_copied_outputs) {
+        *number_of_copied_outputs = n_copied;
+    }
     return YES;
 }
 
@@ -512,6 +557,13 @@ void add_compute_unit(std::string& identifier, MLComputeUnits compute_units) {
 - (BOOL)executeModelWithHandle:(ModelHandle *)handle
                           args:(NSArray<MLMultiArray *> *)args
                          error:(NSError * __autoreleasing *)error {
+    return [self executeModelWithHandle:handle args:args numberOfCopiedOutputs:NULL error:error];
+}
+
+- (BOOL)executeModelWithHandle:(ModelHandle *)handle
+                          args:(NSArray<MLMultiArray *> *)args
+         numberOfCopiedOutputs:(nullable NSUInteger *)numberOfCopiedOutputs
+                         error:(NSError * __autoreleasing *)error {
     ETCoreMLModel *model = [self modelWithHandle:handle];
     if (!model) {
         ETCoreMLLogErrorAndSetNSError(error,
@@ -536,7 +588,10 @@ void add_compute_unit(std::string& identifier, MLComputeUnits compute_units) {
         return NO;
     }
     
-    MLPredictionOptions *predictionOptions = ::get_prediction_options(outputs, model.orderedOutputNames, error);
+    MLPredictionOptions *predictionOptions = ::get_prediction_options(outputs,
+                                                                      model.orderedOutputNames,
+                                                                      model.mlModel.modelDescription,
+                                                                      error);
     if (!predictionOptions) {
         return NO;
     }
@@ -548,7 +603,66 @@ void add_compute_unit(std::string& identifier, MLComputeUnits compute_units) {
         return NO;
     }
     
-    return ::set_outputs(outputs, outputFeatures, model.orderedOutputNames, error);
+    return ::set_outputs(outputs, outputFeatures, model.orderedOutputNames, numberOfCopiedOutputs, error);
+}
+
+- (BOOL)executeModelWithHandle:(ModelHandle *)handle
+                     argsBatch:(NSArray<NSArray<MLMultiArray *> *> *)argsBatch
+                         error:(NSError * __autoreleasing *)error {
+    ETCoreMLModel *model = [self modelWithHandle:handle];
+    if (!model) {
+        ETCoreMLLogErrorAndSetNSError(error,
+                                      0,
+                                      "%@: Model is already unloaded.",
+                                      NSStringFromClass(self.class));
+        return NO;
+    }
+    
+    const NSUInteger nInputs = model.orderedInputNames.count;
+    const NSUInteger nArgs = nInputs + model.orderedOutputNames.count;
+    NSMutableArray<id<MLFeatureProvider>> *inputFeaturesBatch = [NSMutableArray arrayWithCapacity:argsBatch.count];
+    for (NSArray<MLMultiArray *> *args in argsBatch) {
+        if (args.count != nArgs) {
+            ETCoreMLLogErrorAndSetNSError(error,
+                                          ETCoreMLErrorCorruptedModel,
+                                          "%@: Model is invalid.",
+                                          NSStringFromClass(self.class));
+            return NO;
+        }
+        
+        NSArray<MLMultiArray *> *inputs = [args subarrayWithRange:NSMakeRange(0, nInputs)];
+        id<MLFeatureProvider> inputFeatures = ::get_feature_provider(inputs, model.orderedInputNames, error);
+        if (!inputFeatures) {
+            return NO;
+        }
+        [inputFeaturesBatch addObject:inputFeatures];
+    }
+    
+    MLArrayBatchProvider *batchProvider = [[MLArrayBatchProvider alloc] initWithFeatureProviderArray:inputFeaturesBatch];
+    id<MLBatchProvider> outputFeaturesBatch = [model.mlModel predictionsFromBatch:batchProvider
+                                                                          options:[MLPredictionOptions new]
+                                                                            error:error];
+    if (!outputFeaturesBatch) {
+        return NO;
+    }
+    
+    if (outputFeaturesBatch.count != static_cast<NSInteger>(argsBatch.count)) {
+        ETCoreMLLogErrorAndSetNSError(error,
+                                      ETCoreMLErrorCorruptedModel,
+                                      "%@: Model is invalid.",
+                                      NSStringFromClass(self.class));
+        return NO;
+    }
+    
+    for (NSUInteger i = 0; i < argsBatch.count; i++) {
+        NSArray<MLMultiArray *> *args = argsBatch[i];
+        NSArray<MLMultiArray *> *outputs = [args subarrayWithRange:NSMakeRange(nInputs, nArgs - nInputs)];
+        if (!::set_outputs(outputs, [outputFeaturesBatch featuresAtIndex:i], model.orderedOutputNames, NULL, error)) {
+            return NO;
+        }
+    }
+    
+    return YES;
 }
 
 - (BOOL)unloadModelWithHandle:(ModelHandle *)handle {
@@ -561,6 +675,9 @@ void add_compute_unit(std::string& identifier, MLComputeUnits compute_units) {
         os_unfair_lock_unlock(&_lock);
     }
     
+    // The model's asset may have been kept in the store only because it was in use.
+    [self.assetManager triggerCompaction];
+
     return result;
 }
 
@@ -5,6 +5,7 @@
 //
 // Please refer to the license found in the LICENSE file in the root directory of the source tree.
 
+#include <string>
 #include <system_error>
 #include <vector>
 
@@ -20,14 +21,23 @@ public:
     using Handle = void;
 
     struct Config {
-        // Max models cache size in bytes.
+        // Max models cache size in bytes. The least recently used models are evicted in the
+        // background once the cache grows past this size.
         size_t max_models_cache_size = 2 * size_t(1024) * size_t(1024) * size_t(1024);
-        // If set to `true`, delegate pre-warms the most recently used asset.
+        // If set to `true`, delegate pre-warms the most recently used assets.
         bool should_prewarm_asset = true;
+        // The number of most recently used assets to pre-warm.
+        size_t max_prewarmed_assets = 1;
         // If set to `true`, delegate pre-warms the model in `init`.
         bool should_prewarm_model = true;
     };
 
+    /// Statistics of an `execute` call.
+    struct ExecuteStats {
+        // The number of outputs that CoreML didn't write in place, which had to be copied.
+        size_t num_copied_outputs = 0;
+    };
+
     /// The error codes for the `BackendDelegate`.
     enum class ErrorCode : int8_t {
         CorruptedData = 1, // AOT blob can't be parsed.
@@ -81,8 +91,46 @@ public:
     /// @param args The inputs and outputs to the model.
     /// @param error   On failure, error is filled with the failure information.
     /// @retval `true` if the execution succeeded otherwise `false`.
-    virtual bool
-    execute(Handle* handle, const std::vector<MultiArray>& args, std::error_code& error) const noexcept = 0;
+    inline bool execute(Handle* handle, const std::vector<MultiArray>& args, std::error_code& error) const noexcept {
+        ExecuteStats stats;
+        return execute(handle, args, stats, error);
+    }
+
+    /// Must execute the CoreML model with the specified handle, and report
+    /// statistics of the execution.
+    ///
+    /// @param handle The model handle.
+    /// @param args The inputs and outputs to the model.
+    /// @param stats   On success, stats is filled with the execution statistics.
+    /// @param error   On failure, error is filled with the failure information.
+    /// @retval `true` if the execution succeeded otherwise `false`.
+    virtual bool execute(Handle* handle,
+                         const std::vector<MultiArray>& args,
+                         ExecuteStats& stats,
+                         std::error_code& error) const noexcept = 0;
+
+    /// Must execute the CoreML model once for each element of `args_batch`, as
+    /// a single batch prediction.
+    ///
+    /// Each element of `args_batch` holds the inputs and outputs of one
+    /// execution, like the `args` of `execute`.
+    ///
+    /// @param handle The model handle.
+    /// @param args_batch The inputs and outputs of each execution.
+    /// @param error   On failure, error is filled with the failure information.
+    /// @retval `true` if all the executions succeeded otherwise `false`.
+    virtual bool execute_batch(Handle* handle,
+                               const std::vector<std::vector<MultiArray>>& args_batch,
+                               std::error_code& error) const noexcept = 0;
+
+    /// Must return an identifier of the model with the specified handle.
+    ///
+    /// Handles that were initialized from the same AOT blob return the same
+    /// identifier, so their executions can be batched together.
+    ///
+    /// @param handle The model handle.
+    /// @retval The model identifier.
+    virtual std::string get_model_identifier(Handle* handle) const noexcept = 0;
 
     /// Must return `true` if the delegate is available for execution otherwise
     /// `false`.
@@ -164,7 +164,7 @@ public:
         
         model_manager_ = (asset_manager != nil) ? [[ETCoreMLModelManager alloc] initWithAssetManager:asset_manager] : nil;
         if (model_manager_ != nil && config_.should_prewarm_asset) {
-            [model_manager_ prewarmRecentlyUsedAssetsWithMaxCount:1];
+            [model_manager_ prewarmRecentlyUsedAssetsWithMaxCount:config.max_prewarmed_assets];
         }
         available_.store(model_manager_ != nil, std::memory_order_seq_cst);
     }
@@ -189,7 +189,10 @@ public:
         return modelHandle;
     }
     
-    bool execute(Handle* handle, const std::vector<MultiArray>& args, std::error_code& ec) const noexcept override {
+    bool execute(Handle* handle,
+                 const std::vector<MultiArray>& args,
+                 ExecuteStats& stats,
+                 std::error_code& ec) const noexcept override {
         NSError *error = nil;
         NSMutableArray<MLMultiArray *> *model_args = [NSMutableArray arrayWithCapacity:args.size()];
         for (const auto& arg : args) {
@@ -200,14 +203,50 @@ public:
             [model_args addObject:multi_array];
         }
         
-        if (![model_manager_ executeModelWithHandle:handle args:model_args error:&error]) {
+        NSUInteger n_copied_outputs = 0;
+        if (![model_manager_ executeModelWithHandle:handle
+                                               args:model_args
+                              numberOfCopiedOutputs:&n_copied_outputs
+                                              error:&error]) {
             ec = static_cast<ErrorCode>(error.code);
             return false;
         }
         
+        stats.num_copied_outputs = n_copied_outputs;
+        
         return true;
     }
     
+    bool execute_batch(Handle* handle,
+                       const std::vector<std::vector<MultiArray>>& args_batch,
+                       std::error_code& ec) const noexcept override {
+        NSError *error = nil;
+        NSMutableArray<NSArray<MLMultiArray *> *> *model_args_batch = [NSMutableArray arrayWithCapacity:args_batch.size()];
+        for (const auto& args : args_batch) {
+            NSMutableArray<MLMultiArray *> *model_args = [NSMutableArray arrayWithCapacity:args.size()];
+            for (const auto& arg : args) {
+                MLMultiArray *multi_array = to_ml_multiarray(arg, &error);
+                if (!multi_array) {
+                    return false;
+                }
+                [model_args addObject:multi_array];
+            }
+            [model_args_batch addObject:model_args];
+        }
+        
+        if (![model_manager_ executeModelWithHandle:handle argsBatch:model_args_batch error:&error]) {
+            ec = static_cast<ErrorCode>(error.code);
+            return false;
+        }
+        
+        return true;
+    }
+    
+    std::string get_model_identifier(Handle* handle) const noexcept override {
+        ETCoreMLModel *model = [model_manager_ modelWithHandle:handle];
+        return model.identifier.length > 0 ? std::string(model.identifier.UTF8String) : std::string();
+    }
+    
     bool is_valid_handle(Handle* handle) const noexcept override {
         return [model_manager_ modelWithHandle:handle] != nil;
     }
@@ -8,7 +8,10 @@
 #import <coreml_backend/delegate.h>
 
 #import <backend_delegate.h>
+#import <atomic>
 #import <memory>
+#import <mutex>
+#import <string>
 #import <unordered_map>
 #import <vector>
 
@@ -19,6 +22,8 @@
 #import <ETCoreMLStrings.h>
 
 #import <executorch/runtime/core/evalue.h>
+#import <executorch/runtime/core/event_tracer_hooks_delegate.h>
+#import <executorch/runtime/platform/platform.h>
 
 namespace {
 using namespace torch::executor;
@@ -30,6 +35,10 @@ inline id check_class(id obj, Class cls) {
 
 #define SAFE_CAST(Object, Type) ((Type *)check_class(Object, [Type class]))
 
+/// The name of the ETDump event logged when outputs had to be copied. The event's metadata is the
+/// number of copied outputs.
+constexpr const char *kOutputCopyEventName = "coreml_output_copy";
+
 std::optional<MultiArray::DataType> get_data_type(ScalarType scalar_type) {
     if (scalar_type == ScalarType::Float) {
         return MultiArray::DataType::Float;
@@ -95,7 +104,16 @@ std::optional<BackendDelegate::Config> parse_config(NSURL *plistURL) {
     }
     
     {
-        NSNumber *max_models_cache_size_in_bytes = SAFE_CAST(dict[@"maxModelsCacheSizeInBytes"], NSNumber);
+        NSNumber *max_prewarmed_assets = SAFE_CAST(dict[@"maxPrewarmedAssetsCount"], NSNumber);
+        if (max_prewarmed_assets) {
+            config.max_prewarmed_assets = max_prewarmed_assets.unsignedLongValue;
+        }
+    }
+    
+    {
+        // The bundled config uses `maxAssetsSizeInBytes`.
+        NSNumber *max_models_cache_size_in_bytes = SAFE_CAST(dict[@"maxAssetsSizeInBytes"], NSNumber);
+        max_models_cache_size_in_bytes = max_models_cache_size_in_bytes ?: SAFE_CAST(dict[@"maxModelsCacheSizeInBytes"], NSNumber);
         if (max_models_cache_size_in_bytes) {
             config.max_models_cache_size = max_models_cache_size_in_bytes.unsignedLongLongValue;
         }
@@ -112,13 +130,88 @@ BackendDelegate::Config get_delegate_config(NSString *config_name) {
 }
 } //namespace
 
+namespace executorchcoreml {
+
+/// Queues asynchronous executions per model until they fill a batch.
+class BatchQueue {
+public:
+    /// A queued execution.
+    struct Request {
+        BackendDelegate::Handle* handle;
+        std::vector<MultiArray> args;
+        BackendCompletion completion;
+    };
+    
+    /// Queues `request` under `model_identifier`. Returns the model's batch once it holds
+    /// `max_batch_size` requests, otherwise an empty vector.
+    std::vector<Request> enqueue(const std::string& model_identifier, Request request) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& batch = pending_[model_identifier];
+        batch.emplace_back(std::move(request));
+        if (batch.size() < max_batch_size.load(std::memory_order_relaxed)) {
+            return {};
+        }
+        std::vector<Request> result = std::move(batch);
+        pending_.erase(model_identifier);
+        return result;
+    }
+    
+    /// Removes and returns every queued batch.
+    std::vector<std::vector<Request>> take_all() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::vector<Request>> result;
+        result.reserve(pending_.size());
+        for (auto& entry : pending_) {
+            result.emplace_back(std::move(entry.second));
+        }
+        pending_.clear();
+        return result;
+    }
+    
+    std::atomic<size_t> max_batch_size{1};
+    
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<Request>> pending_;
+};
+
+} // namespace executorchcoreml
+
+namespace {
+using namespace executorchcoreml;
+
+/// Runs the requests, which share a model, as one batch prediction and completes them.
+void run_batch(const BackendDelegate& impl, std::vector<BatchQueue::Request>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    std::vector<std::vector<MultiArray>> args_batch;
+    args_batch.reserve(batch.size());
+    for (auto& request : batch) {
+        args_batch.emplace_back(std::move(request.args));
+    }
+    
+    std::error_code ec;
+    Error status = Error::Ok;
+    if (!impl.execute_batch(batch.front().handle, args_batch, ec)) {
+        ET_LOG(Error, "%s: Failed to run a batch of %zu executions.",
+               ETCoreMLStrings.delegateIdentifier.UTF8String, batch.size());
+        status = Error::DelegateInvalidHandle;
+    }
+    for (const auto& request : batch) {
+        request.completion.complete(status);
+    }
+}
+} //namespace
+
 namespace torch {
 namespace executor {
 
 using namespace executorchcoreml;
 
 CoreMLBackendDelegate::CoreMLBackendDelegate() noexcept
-:impl_(BackendDelegate::make(get_delegate_config(ETCoreMLStrings.configPlistName)))
+:impl_(BackendDelegate::make(get_delegate_config(ETCoreMLStrings.configPlistName))),
+batch_queue_(std::make_shared<BatchQueue>())
 {}
 
 Result<DelegateHandle *>
@@ -171,14 +264,42 @@ Error CoreMLBackendDelegate::execute(BackendExecutionContext& context,
         delegate_args.emplace_back(std::move(multi_array.value()));
     }
     
+    if (context.can_complete_async() && batch_queue_->max_batch_size.load(std::memory_order_relaxed) > 1) {
+        BatchQueue::Request request{handle, std::move(delegate_args), context.completion()};
+        auto batch = batch_queue_->enqueue(impl_->get_model_identifier(handle), std::move(request));
+        run_batch(*impl_, batch);
+        return Error::Pending;
+    }
+    
     std::error_code ec;
-    ET_CHECK_OR_RETURN_ERROR(impl_->execute(handle, delegate_args, ec),
+    BackendDelegate::ExecuteStats stats;
+    ET_CHECK_OR_RETURN_ERROR(impl_->execute(handle, delegate_args, stats, ec),
                              DelegateInvalidHandle,
                              "%s: Failed to run the model.",
                              ETCoreMLStrings.delegateIdentifier.UTF8String);
+    
+    // Record every execution where CoreML didn't write the outputs in place, so that the
+    // cost of the copies shows up in ETDump.
+    if (stats.num_copied_outputs > 0) {
+        char metadata[32];
+        snprintf(metadata, sizeof(metadata), "%zu", stats.num_copied_outputs);
+        et_timestamp_t now = et_pal_current_ticks();
+        event_tracer_log_profiling_delegate(context.event_tracer(), kOutputCopyEventName, -1, now, now, metadata);
+    }
     return Error::Ok;
 }
 
+void CoreMLBackendDelegate::set_max_batch_size(size_t max_batch_size) noexcept {
+    batch_queue_->max_batch_size.store(max_batch_size, std::memory_order_relaxed);
+}
+
+void CoreMLBackendDelegate::flush_batches() const noexcept {
+    auto batches = batch_queue_->take_all();
+    for (auto& batch : batches) {
+        run_batch(*impl_, batch);
+    }
+}
+
 bool CoreMLBackendDelegate::is_available() const {
     ET_LOG(Debug, "%s: is_available called.", ETCoreMLStrings.delegateIdentifier.UTF8String);
     return impl_->is_available();
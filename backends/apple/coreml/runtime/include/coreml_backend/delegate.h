@@ -15,6 +15,7 @@
 
 namespace executorchcoreml {
 class BackendDelegate;
+class BatchQueue;
 }
 
 namespace torch {
@@ -39,10 +40,14 @@ public:
 
     /// Executes the loaded model.
     ///
+    /// If batching is enabled with `set_max_batch_size` and the execution may
+    /// complete asynchronously, the execution is queued and `Error::Pending` is
+    /// returned. See `set_max_batch_size`.
+    ///
     /// @param context An execution context specific to the CoreML backend.
     /// @param handle The handle returned by an earlier call to `init`.
     /// @param args The models inputs and outputs.
-    /// @retval On success, `Error::Ok` otherwise any other `Error` case.
+    /// @retval On success, `Error::Ok` or `Error::Pending` otherwise any other `Error` case.
     Error execute(BackendExecutionContext& context, DelegateHandle* handle, EValue** args) const override;
 
     /// Returns `true` if the delegate is available otherwise `false`.
@@ -62,8 +67,28 @@ public:
     /// asynchronously deleted.
     bool purge_models_cache() const noexcept;
 
+    /// Sets the maximum number of asynchronous executions of the same model that
+    /// run as a single batch prediction.
+    ///
+    /// Executions started with `Method::execute_async()` are queued per model,
+    /// and `execute` returns `Error::Pending`. Once `max_batch_size` executions
+    /// of a model are queued, the call that queued the last one runs them all
+    /// with one batch prediction and completes them. This lets a server run K
+    /// pending requests, each with its own `Method`, as one prediction.
+    /// Synchronous executions are never queued. The default, 1, disables
+    /// batching.
+    ///
+    /// @param max_batch_size The maximum number of executions in a batch.
+    void set_max_batch_size(size_t max_batch_size) noexcept;
+
+    /// Runs every queued execution now, in one batch per model, and completes
+    /// them. Call this when no more requests are expected soon, so that a
+    /// partial batch doesn't wait indefinitely.
+    void flush_batches() const noexcept;
+
 private:
     std::shared_ptr<executorchcoreml::BackendDelegate> impl_;
+    std::shared_ptr<executorchcoreml::BatchQueue> batch_queue_;
 };
 } // namespace executor
 } // namespace torch
@@ -7,9 +7,16 @@
 
 #include "inmemory_filesystem.hpp"
 
-#include <fstream>
+#include <fcntl.h>
 #include <iostream>
 #include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <copyfile.h>
+#include <sys/clonefile.h>
+#endif
 
 #if __has_include(<filesystem>)
 #include <filesystem>
@@ -30,16 +37,24 @@ class InMemoryFileNode : public InMemoryFileSystem::InMemoryNode {
 public:
     InMemoryFileNode(std::string name,
                      InMemoryFileSystem::Attributes attributes,
-                     std::shared_ptr<MemoryBuffer> buffer) noexcept
-        : InMemoryNode(std::move(name), std::move(attributes), InMemoryNode::Kind::File), buffer_(std::move(buffer)) { }
+                     std::shared_ptr<MemoryBuffer> buffer,
+                     std::string source_path = "") noexcept
+        : InMemoryNode(std::move(name), std::move(attributes), InMemoryNode::Kind::File),
+          buffer_(std::move(buffer)),
+          source_path_(std::move(source_path)) { }
 
     InMemoryFileNode(InMemoryFileNode const&) = delete;
     InMemoryFileNode& operator=(InMemoryFileNode const&) = delete;
 
     inline std::shared_ptr<MemoryBuffer> getBuffer() const noexcept { return buffer_; }
 
+    /// Returns the path of the file that the buffer was read from, or an empty string if the
+    /// node was not created from the filesystem.
+    inline const std::string& source_path() const noexcept { return source_path_; }
+
 private:
     const std::shared_ptr<MemoryBuffer> buffer_;
+    const std::string source_path_;
 };
 
 class InMemoryDirectoryNode : public InMemoryFileSystem::InMemoryNode {
@@ -140,7 +155,8 @@ std::unique_ptr<InMemoryFileSystem::InMemoryNode> make_file_node(const std::file
     }
 
     auto attributes = get_file_attributes(path);
-    return std::make_unique<InMemoryFileNode>(std::move(name), std::move(attributes), std::move(buffer));
+    return std::make_unique<InMemoryFileNode>(
+        std::move(name), std::move(attributes), std::move(buffer), std::move(file_path));
 }
 
 std::unique_ptr<InMemoryFileSystem::InMemoryNode> make_directory_node(const std::filesystem::path& path,
@@ -194,29 +210,79 @@ bool write_node(InMemoryFileSystem::InMemoryNode* node,
                 bool recursive,
                 std::error_code& error);
 
-bool write_file_node(InMemoryFileNode* node, const std::filesystem::path& dst_path, std::error_code& error) {
+/// Copies the file that a node was read from, if it still has the node's size. On APFS `clonefile`
+/// shares the blocks of the source file, so nothing is read or written.
+bool copy_source_file(const std::string& src_path,
+                      const std::filesystem::path& dst_path,
+                      size_t size,
+                      std::error_code& error) {
     error.clear();
-    std::filesystem::path file_path = dst_path;
-    file_path.append(node->name());
-    std::ofstream stream;
-    stream.open(file_path, std::ofstream::out);
-    if (!stream.good()) {
+    if (std::filesystem::file_size(src_path, error) != size || error) {
+        return false;
+    }
+#if defined(__APPLE__)
+    if (clonefile(src_path.c_str(), dst_path.c_str(), 0) == 0) {
+        return true;
+    }
+    if (copyfile(src_path.c_str(), dst_path.c_str(), nullptr, COPYFILE_DATA) == 0) {
+        return true;
+    }
+    error = std::error_code(errno, std::system_category());
+    return false;
+#else
+    return std::filesystem::copy_file(src_path, dst_path, error);
+#endif
+}
+
+/// Writes a buffer to a new file straight from its memory, which for a buffer sliced from a
+/// memory-mapped blob pages in the blob sequentially rather than copying it first.
+bool write_buffer(const MemoryBuffer& buffer, const std::filesystem::path& dst_path, std::error_code& error) {
+    error.clear();
+    int fd = open(dst_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
         error = std::error_code(errno, std::system_category());
         return false;
     }
-    auto buffer = node->getBuffer().get();
-    if (buffer->size() > 0) {
-        char* bufferPtr = static_cast<char*>(buffer->data());
-        stream.write(bufferPtr, static_cast<std::streamsize>(buffer->size()));
+
+    const uint8_t* data = static_cast<const uint8_t*>(buffer.data());
+    size_t remaining = buffer.size();
+    if (buffer.kind() == MemoryBuffer::Kind::MMap && remaining > 0) {
+        // madvise needs a page aligned start.
+        const size_t page_size = static_cast<size_t>(getpagesize());
+        const uintptr_t start = reinterpret_cast<uintptr_t>(data) & ~(uintptr_t)(page_size - 1);
+        madvise(reinterpret_cast<void*>(start), remaining + (reinterpret_cast<uintptr_t>(data) - start), MADV_SEQUENTIAL);
     }
-    if (!stream.good()) {
+    while (remaining > 0) {
+        ssize_t written = write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = std::error_code(errno, std::system_category());
+            break;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    if (close(fd) != 0 && !error) {
         error = std::error_code(errno, std::system_category());
     }
-    stream.close();
 
     return !error;
 }
 
+bool write_file_node(InMemoryFileNode* node, const std::filesystem::path& dst_path, std::error_code& error) {
+    error.clear();
+    std::filesystem::path file_path = dst_path;
+    file_path.append(node->name());
+    auto buffer = node->getBuffer();
+    if (!node->source_path().empty() && copy_source_file(node->source_path(), file_path, buffer->size(), error)) {
+        return true;
+    }
+
+    return write_buffer(*buffer, file_path, error);
+}
+
 bool write_directory_node(InMemoryDirectoryNode* node,
                           const std::filesystem::path& dst_path,
                           bool recursive,
@@ -228,4 +228,33 @@ std::vector<MultiArray> toMultiArrays(NSArray<MLMultiArray *> *mlMultiArrays) {
     }
 }
 
+- (void)testMulModelBatchExecution {
+    NSURL *modelURL = [[self class] bundledResourceWithName:@"mul_coreml_all" extension:@"bin"];
+    XCTAssertNotNil(modelURL);
+    NSError *localError = nil;
+    NSData *data = [NSData dataWithContentsOfURL:modelURL];
+    BackendDelegate::Handle *handle = _delegate->init(Buffer(data.bytes, data.length), {});
+    ETCoreMLModel *model = (__bridge ETCoreMLModel *)handle;
+    std::vector<std::vector<MultiArray>> argsBatch;
+    NSMutableArray<MLMultiArray *> *outputs = [NSMutableArray array];
+    NSMutableArray<NSArray<MLMultiArray *> *> *argsArrays = [NSMutableArray array];
+    for (int x = 1; x <= 3; x++) {
+        NSArray<MLMultiArray *> *inputs = [ETCoreMLTestUtils inputsForModel:model repeatedValues:@[@(x), @(10)] error:&localError];
+        XCTAssertNotNil(inputs);
+        MLMultiArray *output = [ETCoreMLTestUtils filledMultiArrayWithShape:inputs[0].shape dataType:inputs[0].dataType repeatedValue:@(0) error:&localError];
+        NSArray<MLMultiArray *> *args = [inputs arrayByAddingObject:output];
+        [outputs addObject:output];
+        [argsArrays addObject:args];
+        argsBatch.emplace_back(toMultiArrays(args));
+    }
+    std::error_code errorCode;
+    XCTAssertTrue(_delegate->execute_batch(handle, argsBatch, errorCode));
+    for (NSUInteger j = 0; j < outputs.count; j++) {
+        for (NSUInteger i = 0; i < outputs[j].count; i++) {
+            NSNumber *value = [outputs[j] objectAtIndexedSubscript:i];
+            XCTAssertEqual(value.integerValue, static_cast<NSInteger>(j + 1) * 10);
+        }
+    }
+}
+
 @end
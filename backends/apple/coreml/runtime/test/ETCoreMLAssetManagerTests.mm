@@ -134,6 +134,32 @@
     XCTAssertEqual([self.assetManager compact:100 error:&localError], 0);
 }
 
+- (void)testCompactionRemovesLeastRecentlyUsedAssets {
+    NSUInteger n = 3;
+    NSError *localError = nil;
+    NSMutableArray<NSString *> *identifiers = [NSMutableArray arrayWithCapacity:n];
+    NSInteger assetSizeInBytes = 0;
+    for (NSUInteger i = 0; i < n; i++) {
+        NSString *identifier = [NSUUID UUID].UUIDString;
+        NSURL *assetURL = [ETCoreMLTestUtils createUniqueAssetInDirectoryAtURL:self.testDirectoryURL withContent:@"testing" fileManager:self.fileManager error:&localError];
+        XCTAssertNotNil(assetURL);
+        ETCoreMLAsset *asset = [self.assetManager storeAssetAtURL:assetURL withIdentifier:identifier error:&localError];
+        assetSizeInBytes = asset.totalSizeInBytes;
+        [asset close];
+        [identifiers addObject:identifier];
+    }
+    
+    // Accessing the first asset makes it the most recently used one.
+    ETCoreMLAsset *asset = [self.assetManager assetWithIdentifier:identifiers[0] error:&localError];
+    XCTAssertNotNil(asset);
+    [asset close];
+    
+    XCTAssertEqual([self.assetManager compact:assetSizeInBytes error:&localError], assetSizeInBytes);
+    XCTAssertTrue([self.assetManager hasAssetWithIdentifier:identifiers[0] error:&localError]);
+    XCTAssertFalse([self.assetManager hasAssetWithIdentifier:identifiers[1] error:&localError]);
+    XCTAssertFalse([self.assetManager hasAssetWithIdentifier:identifiers[2] error:&localError]);
+}
+
 - (void)testPurge {
     NSUInteger n = 5;
     NSError *localError = nil;
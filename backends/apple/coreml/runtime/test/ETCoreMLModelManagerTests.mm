@@ -120,6 +120,36 @@
     }
 }
 
+- (void)testOutputWithDifferentDataTypeIsCopied {
+    NSURL *modelURL = [[self class] bundledResourceWithName:@"mul_coreml_all" extension:@"bin"];
+    XCTAssertNotNil(modelURL);
+    
+    NSError *localError = nil;
+    NSData *data = [NSData dataWithContentsOfURL:modelURL];
+    MLModelConfiguration *configuration = [[MLModelConfiguration alloc] init];
+    configuration.computeUnits = MLComputeUnitsAll;
+    ModelHandle *handle = [self.modelManager loadModelFromAOTData:data configuration:configuration error:&localError];
+    ETCoreMLModel *model = [self.modelManager modelWithHandle:handle];
+    int x = 20;
+    int y = 50;
+    NSArray<MLMultiArray *> *inputs = [ETCoreMLTestUtils inputsForModel:model repeatedValues:@[@(x), @(y)] error:&localError];
+    XCTAssertNotNil(inputs);
+    // CoreML can't write into an output of a different data type, so the result must be copied.
+    MLMultiArrayDataType dataType = (inputs[0].dataType == MLMultiArrayDataTypeFloat64) ? MLMultiArrayDataTypeFloat32 : MLMultiArrayDataTypeFloat64;
+    MLMultiArray *output = [ETCoreMLTestUtils filledMultiArrayWithShape:inputs[0].shape dataType:dataType repeatedValue:@(0) error:&localError];
+    NSArray<MLMultiArray *> *args = [inputs arrayByAddingObject:output];
+    NSUInteger numberOfCopiedOutputs = 0;
+    XCTAssertTrue([self.modelManager executeModelWithHandle:handle
+                                                       args:args
+                                      numberOfCopiedOutputs:&numberOfCopiedOutputs
+                                                      error:&localError]);
+    XCTAssertEqual(numberOfCopiedOutputs, 1);
+    for (NSUInteger i = 0; i < output.count; i++) {
+        NSNumber *value = [output objectAtIndexedSubscript:i];
+        XCTAssertEqual(value.integerValue, x * y);
+    }
+}
+
 - (void)testMulModelExecution {
     NSURL *modelURL = [[self class] bundledResourceWithName:@"mul_coreml_all" extension:@"bin"];
     XCTAssertNotNil(modelURL);
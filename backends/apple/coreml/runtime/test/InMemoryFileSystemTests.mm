@@ -240,4 +240,27 @@ using namespace inmemoryfs;
     }
 }
 
+- (void)testWriteItemCreatedFromFileSystem {
+    Content content("abc", "xyz");
+    std::shared_ptr<MemoryBuffer> buffer = toMemoryBuffer(content);
+    NSURL *srcURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    NSURL *dstURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    NSFileManager *fm = [[NSFileManager alloc] init];
+    NSError *localError = nil;
+    XCTAssertTrue([fm createDirectoryAtURL:srcURL withIntermediateDirectories:NO attributes:@{} error:&localError]);
+    XCTAssertTrue([fm createDirectoryAtURL:dstURL withIntermediateDirectories:NO attributes:@{} error:&localError]);
+    NSData *data = [NSData dataWithBytesNoCopy:buffer->data() length:buffer->size() freeWhenDone:NO];
+    XCTAssertTrue([data writeToURL:[srcURL URLByAppendingPathComponent:@"content.json"] atomically:YES]);
+    
+    std::error_code error;
+    auto fs = InMemoryFileSystem::make(srcURL.path.UTF8String, error);
+    XCTAssertTrue(fs != nullptr);
+    // The file is cloned or copied from the source file.
+    XCTAssertTrue(fs->write_item_to_disk({}, dstURL.path.UTF8String, true, error));
+    NSURL *fileURL = [[dstURL URLByAppendingPathComponent:srcURL.lastPathComponent] URLByAppendingPathComponent:@"content.json"];
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:fileURL], data);
+    XCTAssertTrue([fm removeItemAtURL:srcURL error:&localError]);
+    XCTAssertTrue([fm removeItemAtURL:dstURL error:&localError]);
+}
+
 @end
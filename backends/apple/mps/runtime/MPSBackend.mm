@@ -51,15 +51,67 @@ class MPSBackend final : public PyTorchBackendInterface {
 
   // Function that actually executes the model in the backend.
   Error execute(
-    __ET_UNUSED BackendExecutionContext& context,
+    BackendExecutionContext& context,
     DelegateHandle* handle,
     EValue** args) const override {
     auto executor = static_cast<mps::delegate::MPSExecutor*>(handle);
     std::vector<const Tensor*> input_pointers;
     std::vector<const Tensor*> output_pointers;
 
-    Error err = Error::Ok;
+    Error err = get_tensors(executor, args, input_pointers, output_pointers);
+    if (err != Error::Ok) {
+      return err;
+    }
+
+    err = executor->set_inputs_outputs(input_pointers, output_pointers);
+    if (err != Error::Ok) {
+      return err;
+    }
+
+    return run(context, executor, output_pointers);
+  }
 
+  bool supports_binding() const override {
+    return true;
+  }
+
+  Error bind(DelegateHandle* handle, EValue** args) const override {
+    auto executor = static_cast<mps::delegate::MPSExecutor*>(handle);
+    std::vector<const Tensor*> input_pointers;
+    std::vector<const Tensor*> output_pointers;
+
+    Error err = get_tensors(executor, args, input_pointers, output_pointers);
+    if (err != Error::Ok) {
+      return err;
+    }
+    return executor->bind(input_pointers, output_pointers);
+  }
+
+  // Runs on the tensor wrappers that bind() built, without collecting the
+  // tensors or comparing their data pointers again.
+  Error execute_bound(
+    BackendExecutionContext& context,
+    DelegateHandle* handle) const override {
+    auto executor = static_cast<mps::delegate::MPSExecutor*>(handle);
+    executor->prepare_bound_run();
+    return run(context, executor, executor->bound_outputs());
+  }
+
+  void destroy(DelegateHandle* handle) const override {
+    if (handle != nullptr) {
+      auto executor = static_cast<mps::delegate::MPSExecutor*>(handle);
+      // manually in init(), we must destroy it manually here.
+      executor->~MPSExecutor();
+    }
+  }
+
+ private:
+  // Collects the input and output tensors of a delegate call from its args.
+  static Error get_tensors(
+    mps::delegate::MPSExecutor* executor,
+    EValue** args,
+    std::vector<const Tensor*>& input_pointers,
+    std::vector<const Tensor*>& output_pointers) {
     int i = 0;
     int total_placeholders = executor->getNumInputs() + executor->getNumOutputs();
     while ((input_pointers.size() != executor->getNumInputs()    ||
@@ -93,22 +145,21 @@ class MPSBackend final : public PyTorchBackendInterface {
       }
       i++;
     }
-
-    err = executor->set_inputs_outputs(input_pointers, output_pointers);
-    if (err != Error::Ok) {
-      return err;
-    }
-
-    err = executor->forward(output_pointers);
-    return err;
+    return Error::Ok;
   }
 
-  void destroy(DelegateHandle* handle) const override {
-    if (handle != nullptr) {
-      auto executor = static_cast<mps::delegate::MPSExecutor*>(handle);
-      // manually in init(), we must destroy it manually here.
-      executor->~MPSExecutor();
+  // Runs the graph on the tensors that were last set or bound.
+  static Error run(
+    BackendExecutionContext& context,
+    mps::delegate::MPSExecutor* executor,
+    std::vector<const Tensor*>& output_pointers) {
+    // Under Method::execute_async(), return while the GPU runs so that the
+    // caller can prepare the next execution in the meantime.
+    if (context.can_complete_async()) {
+      return executor->forward_async(output_pointers, context.completion());
     }
+
+    return executor->forward(output_pointers);
   }
 };
 
@@ -7,10 +7,12 @@
 #import <MetalPerformanceShaders/MetalPerformanceShaders.h>
 #import <MetalPerformanceShadersGraph/MetalPerformanceShadersGraph.h>
 #include "MPSCompiler.h"
+#include "MPSDevice.h"
 #include <executorch/backends/apple/mps/utils/MPSGraphPackageExport.h>
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
-#include <unordered_map>
+#include <cstring>
 #include <string>
+#include <unordered_map>
 
 #define MPS_UNUSED(x) ( (void)(x) )
 
@@ -28,44 +30,138 @@ void printLoadedGraph(MPSGraphExecutable* executable) {
   NSLog(@"Loaded graph: %@", [executable debugDescription]);
 }
 
-MPSGraphExecutable* loadExecutable(
-  const void* buffer_pointer,
-  size_t num_bytes) {
-  ExirMPSGraphPackage* exirMPSGraphPackage = (ExirMPSGraphPackage*)buffer_pointer;
+// 64-bit FNV-1a over the serialized graph package.
+uint64_t hashPackage(const void* buffer_pointer, size_t num_bytes) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(buffer_pointer);
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < num_bytes; i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// Returns the directory that holds the compiled executables of previous
+// launches, creating it if needed, or nil if it can't be created.
+NSString* executableCacheDirectory() {
+  NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES);
+  NSString* baseDirectory = [paths count] > 0 ? [paths objectAtIndex:0] : NSTemporaryDirectory();
+  NSString* directory = [baseDirectory stringByAppendingPathComponent:@"executorch_mps"];
+  NSError* error = nil;
+  if (![[NSFileManager defaultManager] createDirectoryAtPath:directory
+                                 withIntermediateDirectories:YES
+                                                  attributes:nil
+                                                       error:&error]) {
+    ET_LOG(Info, "MPS executable cache disabled: %s", error.localizedDescription.UTF8String);
+    return nil;
+  }
+  return directory;
+}
+
+// Returns the path of the compiled executable for this package on this OS
+// build and GPU. Compiled executables aren't portable across either.
+NSString* executableCachePath(NSString* directory, const void* buffer_pointer, size_t num_bytes) {
+  NSString* osVersion = [[NSProcessInfo processInfo] operatingSystemVersionString];
+  NSString* gpuName = [MPSDevice::getInstance()->device() name];
+  NSString* target = [NSString stringWithFormat:@"%@|%@", osVersion, gpuName];
+  const uint64_t key = hashPackage(buffer_pointer, num_bytes) ^
+      (hashPackage(target.UTF8String, strlen(target.UTF8String)) * 31);
+  return [directory stringByAppendingPathComponent:
+      [NSString stringWithFormat:@"%016llx_%zu.mpsgraphpackage", (unsigned long long)key, num_bytes]];
+}
+
+MPSGraphExecutable* newExecutableFromPackage(NSString* path) {
+  MPSGraphCompilationDescriptor *compilationDescriptor = [MPSGraphCompilationDescriptor new];
+  MPSGraphExecutable *executable = [[MPSGraphExecutable alloc] initWithMPSGraphPackageAtURL:[NSURL fileURLWithPath:path]
+                                                                       compilationDescriptor:compilationDescriptor];
+  [compilationDescriptor release];
+  return executable;
+}
+
+// Writes the serialized package to a new directory under `directory` and
+// returns its path, or nil on failure.
+NSString* writePackage(NSString* directory, const void* buffer_pointer) {
+  const ExirMPSGraphPackage* exirMPSGraphPackage = (const ExirMPSGraphPackage*)buffer_pointer;
   NSData *new_manifest_plist_data = [NSData dataWithBytes:exirMPSGraphPackage->data length:exirMPSGraphPackage->model_0_offset];
   NSData *new_model_0_data = [NSData dataWithBytes:exirMPSGraphPackage->data + exirMPSGraphPackage->model_0_offset length:exirMPSGraphPackage->model_1_offset - exirMPSGraphPackage->model_0_offset];
   NSData *new_model_1_data = [NSData dataWithBytes:exirMPSGraphPackage->data + exirMPSGraphPackage->model_1_offset length:exirMPSGraphPackage->total_bytes - sizeof(ExirMPSGraphPackage) - exirMPSGraphPackage->model_1_offset];
 
-  NSError* error = nil;
-  NSString* packageName = [NSString stringWithUTF8String:(
-      std::string("%@/mpsgraphmodule_") + std::to_string(arc4random_uniform(INT_MAX)) + ".mpsgraphpackage").c_str()];
-#if TARGET_OS_IPHONE
-  NSArray *paths = NSSearchPathForDirectoriesInDomains
-      (NSDocumentDirectory, NSUserDomainMask, YES);
-  NSString *documentsDirectory = [paths objectAtIndex:0];
-#else
-  NSString *documentsDirectory = @"/tmp";
-#endif
-
-  NSString *dataFileNSStr = [NSString stringWithFormat:packageName,
-                                                        documentsDirectory];
-
+  NSString* dataFileNSStr = [directory stringByAppendingPathComponent:
+      [NSString stringWithFormat:@"mpsgraphmodule_%@.mpsgraphpackage", [[NSUUID UUID] UUIDString]]];
   NSString* manifestFileStr = [NSString stringWithFormat:@"%@/manifest.plist", dataFileNSStr];
   NSString* model0FileStr = [NSString stringWithFormat:@"%@/model_0.mpsgraph", dataFileNSStr];
   NSString* model1FileStr = [NSString stringWithFormat:@"%@/model_1.mpsgraph", dataFileNSStr];
 
+  NSError* error = nil;
   NSFileManager *fileManager= [NSFileManager defaultManager];
-  [fileManager createDirectoryAtPath:dataFileNSStr withIntermediateDirectories:NO attributes:nil error:&error];
-
-  [new_manifest_plist_data writeToFile:manifestFileStr options:NSDataWritingAtomic error:&error];
-  [new_model_0_data writeToFile:model0FileStr options:NSDataWritingAtomic error:&error];
-  [new_model_1_data writeToFile:model1FileStr options:NSDataWritingAtomic error:&error];
+  if (![fileManager createDirectoryAtPath:dataFileNSStr withIntermediateDirectories:YES attributes:nil error:&error] ||
+      ![new_manifest_plist_data writeToFile:manifestFileStr options:NSDataWritingAtomic error:&error] ||
+      ![new_model_0_data writeToFile:model0FileStr options:NSDataWritingAtomic error:&error] ||
+      ![new_model_1_data writeToFile:model1FileStr options:NSDataWritingAtomic error:&error]) {
+    ET_LOG(Error, "Failed to write the MPSGraph package: %s", error.localizedDescription.UTF8String);
+    [fileManager removeItemAtPath:dataFileNSStr error:nil];
+    return nil;
+  }
+  return dataFileNSStr;
+}
 
-  NSURL *bundleURL = [NSURL fileURLWithPath:dataFileNSStr];
+// Specializes the executable for this device and its input shapes, and saves
+// it at `cachePath` so that later launches skip graph building and
+// specialization. Failures only cost the next launch a recompile.
+void saveExecutable(MPSGraphExecutable* executable, NSString* directory, NSString* cachePath) {
+  MPSGraphDevice* device = [MPSGraphDevice deviceWithMTLDevice:MPSDevice::getInstance()->device()];
   MPSGraphCompilationDescriptor *compilationDescriptor = [MPSGraphCompilationDescriptor new];
-  MPSGraphExecutable *newExec = [[MPSGraphExecutable new] initWithMPSGraphPackageAtURL:bundleURL compilationDescriptor:compilationDescriptor];
+  [executable specializeWithDevice:device
+                        inputTypes:[executable getInputShapes]
+             compilationDescriptor:compilationDescriptor];
+  [compilationDescriptor release];
+
+  // Serialize next to the final path and move it into place, so that a
+  // concurrent or interrupted launch never sees a partial package.
+  NSString* tmpPath = [directory stringByAppendingPathComponent:
+      [NSString stringWithFormat:@"tmp_%@.mpsgraphpackage", [[NSUUID UUID] UUIDString]]];
+  MPSGraphExecutableSerializationDescriptor* serializationDescriptor = [MPSGraphExecutableSerializationDescriptor new];
+  [executable serializeToMPSGraphPackageAtURL:[NSURL fileURLWithPath:tmpPath] descriptor:serializationDescriptor];
+  [serializationDescriptor release];
+
+  NSFileManager *fileManager= [NSFileManager defaultManager];
+  NSError* error = nil;
+  if (![fileManager moveItemAtPath:tmpPath toPath:cachePath error:&error]) {
+    ET_LOG(Info, "Failed to cache the MPSGraph executable: %s", error.localizedDescription.UTF8String);
+    [fileManager removeItemAtPath:tmpPath error:nil];
+  }
+}
 
-  return newExec;
+MPSGraphExecutable* loadExecutable(
+  const void* buffer_pointer,
+  size_t num_bytes) {
+  NSFileManager *fileManager= [NSFileManager defaultManager];
+  NSString* cacheDirectory = executableCacheDirectory();
+  NSString* cachePath = nil;
+  if (cacheDirectory != nil) {
+    cachePath = executableCachePath(cacheDirectory, buffer_pointer, num_bytes);
+    if ([fileManager fileExistsAtPath:cachePath]) {
+      MPSGraphExecutable* cached = newExecutableFromPackage(cachePath);
+      if (cached != nil) {
+        return cached;
+      }
+      ET_LOG(Info, "Discarding unreadable cached MPSGraph executable");
+      [fileManager removeItemAtPath:cachePath error:nil];
+    }
+  }
+
+  NSString* packagePath = writePackage(
+      cacheDirectory != nil ? cacheDirectory : NSTemporaryDirectory(), buffer_pointer);
+  if (packagePath == nil) {
+    return nil;
+  }
+  MPSGraphExecutable* executable = newExecutableFromPackage(packagePath);
+  // The executable holds everything it needs once it's loaded.
+  [fileManager removeItemAtPath:packagePath error:nil];
+
+  if (executable != nil && cachePath != nil) {
+    saveExecutable(executable, cacheDirectory, cachePath);
+  }
+  return executable;
 }
 
 /*
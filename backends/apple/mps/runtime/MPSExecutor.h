@@ -9,6 +9,7 @@
 #include <MetalPerformanceShaders/MetalPerformanceShaders.h>
 #include <MetalPerformanceShadersGraph/MetalPerformanceShadersGraph.h>
 
+#include <executorch/runtime/backend/backend_execution_context.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 
@@ -29,15 +30,32 @@ class MPSExecutor {
 
   NSMutableArray<MPSGraphTensorData *>* inputsArray_;
   NSMutableArray<MPSGraphTensorData *>* outputsArray_;
-#if TARGET_OS_SIMULATOR
-  NSMutableArray<id<MTLBuffer>>* output_buffers_;
-#endif
+
+  // Data pointers of the tensors that inputsArray_ and outputsArray_ wrap.
+  std::vector<const void*> inputDataPtrs_;
+  std::vector<const void*> outputDataPtrs_;
+  // Shared-storage copies of the tensors whose memory Metal cannot use
+  // directly, or nil where the tensor's memory is used without a copy.
+  std::vector<id<MTLBuffer>> inputStagingBuffers_;
+  std::vector<id<MTLBuffer>> outputStagingBuffers_;
+  bool hasOutputStagingBuffers_ = false;
+  // The command buffer of the last forward_async() call, which may still be
+  // running on the GPU.
+  id<MTLCommandBuffer> pendingCommandBuffer_ = nil;
+  // The tensors of the most recent bind().
+  std::vector<const Tensor*> boundInputs_;
+  std::vector<const Tensor*> boundOutputs_;
+
+  void releaseTensorData();
+  void waitForPendingWork();
+  void copyStagedInputs(const std::vector<const Tensor*>& inputs);
+  void copyStagedOutputs(const std::vector<const Tensor*>& outputs);
 
  public:
   MPSExecutor() = default;
   ~MPSExecutor() {
-    [inputsArray_ release];
-    [outputsArray_ release];
+    waitForPendingWork();
+    releaseTensorData();
   }
 
   inline size_t getNumInputs() {
@@ -54,9 +72,28 @@ class MPSExecutor {
 
   __ET_NODISCARD Error forward(std::vector<const Tensor*>& outputs);
 
+  // Commits the graph to the GPU and returns Error::Pending without waiting
+  // for it. `completion` is called from a Metal thread once the outputs have
+  // been written.
+  __ET_NODISCARD Error
+  forward_async(std::vector<const Tensor*>& outputs, BackendCompletion completion);
+
   __ET_NODISCARD Error
   set_inputs_outputs(std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs);
 
+  // Keeps the tensors of a delegate call and wraps them for the graph, so
+  // that runs on them only need prepare_bound_run().
+  __ET_NODISCARD Error
+  bind(std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs);
+
+  // Readies the tensors of the most recent bind() for another run, which
+  // only copies the inputs that go through staging buffers.
+  void prepare_bound_run();
+
+  inline std::vector<const Tensor*>& bound_outputs() {
+    return boundOutputs_;
+  }
+
   friend class MPSCompiler;
 };
 
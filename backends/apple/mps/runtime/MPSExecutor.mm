@@ -11,6 +11,9 @@
 
 #include "MPSExecutor.h"
 
+#include <unistd.h>
+#include <algorithm>
+
 @interface MPSNDArray ()
 -(nonnull instancetype) initWithBuffer:(id<MTLBuffer> _Nonnull) buffer
                             descriptor:(MPSNDArrayDescriptor * _Nonnull) descriptor;
@@ -26,50 +29,176 @@ namespace executor {
 namespace mps {
 namespace delegate {
 
-__ET_NODISCARD Error
-MPSExecutor::set_inputs_outputs(std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs) {
-  ET_CHECK_OR_RETURN_ERROR(inputs.size() == getNumInputs(), Internal, "Inputs mismatch");
-  ET_CHECK_OR_RETURN_ERROR(outputs.size() == getNumOutputs(), Internal, "Outputs mismatch");
+namespace {
 
-#if !TARGET_OS_SIMULATOR
-  if (outputsArray_ != nil) {
-    return Error::Ok;
+// Returns a buffer over the tensor's memory that the GPU accesses directly.
+// Returns nil if Metal can't wrap it without a copy: the memory must start on
+// a page boundary, and the simulator doesn't support wrapping at all.
+id<MTLBuffer> newNoCopyBuffer(const Tensor& tensor) {
+#if TARGET_OS_SIMULATOR
+  return nil;
+#else
+  const uintptr_t pageSize = getpagesize();
+  void* data = tensor.mutable_data_ptr();
+  if (data == nullptr || reinterpret_cast<uintptr_t>(data) % pageSize != 0) {
+    return nil;
   }
+  // The wrapped length must be a whole number of pages. The rest of the last
+  // page is mapped, and the graph never touches it.
+  const NSUInteger length =
+      std::max<NSUInteger>((tensor.nbytes() + pageSize - 1) / pageSize * pageSize, pageSize);
+  return [MPSDevice::getInstance()->device() newBufferWithBytesNoCopy:data
+                                                               length:length
+                                                              options:MTLResourceStorageModeShared
+                                                          deallocator:nil];
 #endif
+}
 
-  inputsArray_ = [[NSMutableArray<MPSGraphTensorData *> alloc] init];
-  outputsArray_ = [[NSMutableArray<MPSGraphTensorData *> alloc] init];
+id<MTLBuffer> newStagingBuffer(const Tensor& tensor) {
+  return [MPSDevice::getInstance()->device() newBufferWithLength:std::max<size_t>(tensor.nbytes(), 1)
+                                                         options:MTLResourceStorageModeShared];
+}
 
-#if TARGET_OS_SIMULATOR
-  output_buffers_ = [[NSMutableArray<id<MTLBuffer>> alloc] init];
-#endif
+MPSGraphTensorData* newTensorData(id<MTLBuffer> buffer, MPSGraphShapedType* shape) {
+  MPSNDArrayDescriptor *tensorDesc = [MPSNDArrayDescriptor descriptorWithDataType:[shape dataType]
+                                                                            shape:[shape shape]];
+  tensorDesc.preferPackedRows = YES;
+  MPSNDArray *ndArrayData = [[MPSNDArray alloc] initWithBuffer:buffer descriptor:tensorDesc];
+  MPSGraphTensorData* tensorData = [[MPSGraphTensorData alloc] initWithMPSNDArray:ndArrayData];
+  [ndArrayData release];
+  return tensorData;
+}
 
-  for (int i = 0; i < inputs.size(); i++) {
-    MPSNDArrayDescriptor *tensorDesc = [MPSNDArrayDescriptor descriptorWithDataType:[inputShapes_[i] dataType]
-                                                                              shape:[inputShapes_[i] shape]];
-    tensorDesc.preferPackedRows = YES;
-    id<MTLBuffer> inputBuffer = ::mps::getMTLBufferStorage(*inputs[i]);
-    MPSNDArray *ndArrayData = [[MPSNDArray alloc] initWithBuffer:inputBuffer descriptor:tensorDesc];
-    MPSGraphTensorData* tensorData = [[MPSGraphTensorData alloc] initWithMPSNDArray:ndArrayData];
-    [inputsArray_ addObject:tensorData];
+bool dataPtrsMatch(const std::vector<const Tensor*>& tensors, const std::vector<const void*>& ptrs) {
+  if (tensors.size() != ptrs.size()) {
+    return false;
   }
+  for (size_t i = 0; i < tensors.size(); i++) {
+    if (tensors[i]->const_data_ptr() != ptrs[i]) {
+      return false;
+    }
+  }
+  return true;
+}
 
+} // namespace
+
+void MPSExecutor::releaseTensorData() {
+  [inputsArray_ release];
+  [outputsArray_ release];
+  inputsArray_ = nil;
+  outputsArray_ = nil;
+  for (id<MTLBuffer> buffer : inputStagingBuffers_) {
+    [buffer release];
+  }
+  for (id<MTLBuffer> buffer : outputStagingBuffers_) {
+    [buffer release];
+  }
+  inputStagingBuffers_.clear();
+  outputStagingBuffers_.clear();
+  inputDataPtrs_.clear();
+  outputDataPtrs_.clear();
+  hasOutputStagingBuffers_ = false;
+}
+
+void MPSExecutor::waitForPendingWork() {
+  if (pendingCommandBuffer_ != nil) {
+    [pendingCommandBuffer_ waitUntilCompleted];
+    [pendingCommandBuffer_ release];
+    pendingCommandBuffer_ = nil;
+  }
+}
+
+void MPSExecutor::copyStagedOutputs(const std::vector<const Tensor*>& outputs) {
   for (int i = 0; i < outputs.size(); i++) {
-    MPSNDArrayDescriptor *tensorDesc = [MPSNDArrayDescriptor descriptorWithDataType:[outputShapes_[i] dataType]
-                                                                              shape:[outputShapes_[i] shape]];
-    tensorDesc.preferPackedRows = YES;
-    id<MTLBuffer> outputBuffer = ::mps::getMTLBufferStorage(*outputs[i]);
-    MPSNDArray *ndArrayData = [[MPSNDArray alloc] initWithBuffer:outputBuffer descriptor:tensorDesc];
-    MPSGraphTensorData* tensorData = [[MPSGraphTensorData alloc] initWithMPSNDArray:ndArrayData];
-    [outputsArray_ addObject:tensorData];
-#if TARGET_OS_SIMULATOR
-    [output_buffers_ addObject:[outputBuffer retain]];
-#endif
+    if (outputStagingBuffers_[i] != nil) {
+      memcpy(outputs[i]->mutable_data_ptr(), [outputStagingBuffers_[i] contents], outputs[i]->nbytes());
+    }
+  }
+}
+
+__ET_NODISCARD Error
+MPSExecutor::set_inputs_outputs(std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs) {
+  ET_CHECK_OR_RETURN_ERROR(inputs.size() == getNumInputs(), Internal, "Inputs mismatch");
+  ET_CHECK_OR_RETURN_ERROR(outputs.size() == getNumOutputs(), Internal, "Outputs mismatch");
+
+  // The wrappers and staging buffers below may still be in use by the GPU.
+  waitForPendingWork();
+
+  // The graph reads and writes the tensors' memory in place, so the wrappers
+  // only need rebuilding when the tensors move, e.g. after set_input().
+  if (outputsArray_ == nil || !dataPtrsMatch(inputs, inputDataPtrs_) ||
+      !dataPtrsMatch(outputs, outputDataPtrs_)) {
+    releaseTensorData();
+    inputsArray_ = [[NSMutableArray<MPSGraphTensorData *> alloc] init];
+    outputsArray_ = [[NSMutableArray<MPSGraphTensorData *> alloc] init];
+
+    for (int i = 0; i < inputs.size(); i++) {
+      id<MTLBuffer> staging = nil;
+      id<MTLBuffer> buffer = newNoCopyBuffer(*inputs[i]);
+      if (buffer == nil) {
+        staging = newStagingBuffer(*inputs[i]);
+        buffer = [staging retain];
+      }
+      MPSGraphTensorData* tensorData = newTensorData(buffer, inputShapes_[i]);
+      [inputsArray_ addObject:tensorData];
+      [tensorData release];
+      [buffer release];
+      inputStagingBuffers_.push_back(staging);
+      inputDataPtrs_.push_back(inputs[i]->const_data_ptr());
+    }
+
+    for (int i = 0; i < outputs.size(); i++) {
+      id<MTLBuffer> staging = nil;
+      id<MTLBuffer> buffer = newNoCopyBuffer(*outputs[i]);
+      if (buffer == nil) {
+        staging = newStagingBuffer(*outputs[i]);
+        buffer = [staging retain];
+        hasOutputStagingBuffers_ = true;
+      }
+      MPSGraphTensorData* tensorData = newTensorData(buffer, outputShapes_[i]);
+      [outputsArray_ addObject:tensorData];
+      [tensorData release];
+      [buffer release];
+      outputStagingBuffers_.push_back(staging);
+      outputDataPtrs_.push_back(outputs[i]->const_data_ptr());
+    }
   }
 
+  copyStagedInputs(inputs);
+
   return Error::Ok;
 }
 
+__ET_NODISCARD Error
+MPSExecutor::bind(std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs) {
+  Error err = set_inputs_outputs(inputs, outputs);
+  if (err != Error::Ok) {
+    boundInputs_.clear();
+    boundOutputs_.clear();
+    return err;
+  }
+  boundInputs_ = inputs;
+  boundOutputs_ = outputs;
+  return Error::Ok;
+}
+
+void MPSExecutor::prepare_bound_run() {
+  // The staging buffers may still be in use by the GPU.
+  waitForPendingWork();
+  copyStagedInputs(boundInputs_);
+}
+
+void MPSExecutor::copyStagedInputs(const std::vector<const Tensor*>& inputs) {
+  // Tensors that the GPU can't access directly go through their staging
+  // buffers.
+  for (int i = 0; i < inputs.size(); i++) {
+    if (inputStagingBuffers_[i] != nil) {
+      memcpy([inputStagingBuffers_[i] contents], inputs[i]->const_data_ptr(), inputs[i]->nbytes());
+    }
+  }
+}
+
 __ET_NODISCARD Error MPSExecutor::forward(std::vector<const Tensor*>& outputs) {
   Error err = Error::Ok;
   MPSStream* mpsStream = getDefaultMPSStream();
@@ -78,16 +207,12 @@ __ET_NODISCARD Error MPSExecutor::forward(std::vector<const Tensor*>& outputs) {
                         inputsArray:inputsArray_
                         resultsArray:outputsArray_
                 executionDescriptor:nil];
-  if (mps::delegate::getDefaultMPSStream()->commitAndContinueEnabled()) {
+  // Staged outputs must be copied out, so they can't be left in flight.
+  if (mps::delegate::getDefaultMPSStream()->commitAndContinueEnabled() &&
+      !hasOutputStagingBuffers_) {
     err = mpsStream->synchronize(SyncType::COMMIT_AND_CONTINUE);
   } else {
     err = mpsStream->synchronize(SyncType::COMMIT_AND_WAIT);
-#if TARGET_OS_SIMULATOR
-  for (int i = 0; i < outputs.size(); i++) {
-    uint8_t* data = outputs[i]->mutable_data_ptr<uint8_t>();
-    memcpy(data, [output_buffers_[i] contents], [output_buffers_[i] length]);
-  }
-#endif
   }
 
   ET_CHECK_OR_RETURN_ERROR(
@@ -95,9 +220,50 @@ __ET_NODISCARD Error MPSExecutor::forward(std::vector<const Tensor*>& outputs) {
     Internal,
     "Could not synchronize on the MPSStream");
 
+  copyStagedOutputs(outputs);
+
   return Error::Ok;
 }
 
+__ET_NODISCARD Error
+MPSExecutor::forward_async(std::vector<const Tensor*>& outputs, BackendCompletion completion) {
+  MPSStream* mpsStream = getDefaultMPSStream();
+  // A command buffer that continues after its commit would signal completion
+  // for work encoded by later calls as well, so run synchronously instead.
+  if (mpsStream->commitAndContinueEnabled()) {
+    return forward(outputs);
+  }
+
+  id<MTLCommandBuffer> commandBuffer = mpsStream->commandBuffer();
+  [executable_ encodeToCommandBuffer:commandBuffer
+                        inputsArray:inputsArray_
+                        resultsArray:outputsArray_
+                executionDescriptor:nil];
+
+  std::vector<const Tensor*> pendingOutputs = outputs;
+  [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+    Error status = Error::Ok;
+    if (buffer.status == MTLCommandBufferStatusError) {
+      ET_LOG(Error, "MPS command buffer failed: %s", buffer.error.localizedDescription.UTF8String);
+      status = Error::Internal;
+    } else {
+      copyStagedOutputs(pendingOutputs);
+    }
+    // Must come last: the Method may resume, and destroy this executor, as
+    // soon as it is called.
+    completion.complete(status);
+  }];
+  pendingCommandBuffer_ = [commandBuffer retain];
+
+  Error err = mpsStream->synchronize(SyncType::COMMIT);
+  ET_CHECK_OR_RETURN_ERROR(
+    err == Error::Ok,
+    Internal,
+    "Could not commit to the MPSStream");
+
+  return Error::Pending;
+}
+
 } // namespace delegate
 } // namespace mps
 } // namespace executor
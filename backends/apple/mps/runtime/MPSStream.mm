@@ -148,6 +148,9 @@ void MPSStream::flush() {
     // if commitAndContinue is disabled (e.g., for Profiler), we keep the command
     // buffer so we could wait on it later, if required.
     if (!_enableCommitAndContinue) {
+      // Command buffers complete in commit order, so waiting on the latest
+      // one covers any earlier one.
+      [_prevCommandBuffer release];
       _prevCommandBuffer = _commandBuffer;
     } else {
       [_commandBuffer release];
@@ -12,8 +12,10 @@
 
 #include <cstring>
 #include <memory>
+#include <new>
 #include <vector>
 
+#include <executorch/backends/arm/runtime/ArmBackendEthosU.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
@@ -33,6 +35,12 @@ namespace executor {
 #define CS300_SRAM_LOW ((void*)0x11000000)
 #define CS300_SRAM_HIGH ((void*)0x110FFFFF)
 
+// The number of Ethos-U NPUs that the application has initialized with
+// ethosu_init(), and so the number of inferences that may run at once.
+#ifndef ET_ARM_NUM_NPUS
+#define ET_ARM_NUM_NPUS 1
+#endif
+
 class ArmBackend final : public PyTorchBackendInterface {
  public:
   ArmBackend() {}
@@ -89,29 +97,44 @@ class ArmBackend final : public PyTorchBackendInterface {
       return Error::InvalidProgram;
     }
 
-    // Return the same buffer we were passed - this data will be
-    // executed directly
-    return processed;
+    // The command stream, weights and scratch area are used directly from
+    // the processed data, so it stays alive until destroy().
+    MemoryAllocator* runtime_allocator = context.get_runtime_allocator();
+    ArmBackendHandle* handle = ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(
+        runtime_allocator, ArmBackendHandle);
+    new (handle) ArmBackendHandle();
+    handle->processed = processed;
+    if (!this->vela_read(data, &handle->handles, size)) {
+      ET_LOG(Error, "ArmBackend::vela_read: error, invalid binary layout");
+      handle->~ArmBackendHandle();
+      return Error::InvalidProgram;
+    }
+    const VelaHandles& handles = handle->handles;
+    if (handles.input_offset.size() != handles.input_shapes.size() ||
+        handles.output_offset.size() != handles.output_shapes.size()) {
+      ET_LOG(Error, "ArmBackend::init: I/O offsets and shapes differ");
+      handle->~ArmBackendHandle();
+      return Error::InvalidProgram;
+    }
+
+    // Ethos-U low level driver expected order for Ethos U-55, we have
+    // constant weight data, then scratch (which contains input and output).
+    // Neither moves, so every invocation reuses them with the command stream.
+    handle->bases[0] = (uint64_t)handles.weight_data;
+    handle->bases[1] = (uint64_t)handles.scratch_data;
+    handle->bases_size[0] = handles.weight_data_size;
+    handle->bases_size[1] = handles.scratch_data_size;
+    return handle;
   }
 
   Error execute(
       BackendExecutionContext& context,
       DelegateHandle* input_handle,
       EValue** args) const override {
-    FreeableBuffer* processed = (FreeableBuffer*)input_handle;
+    ArmBackendHandle* handle = (ArmBackendHandle*)input_handle;
+    const VelaHandles& handles = handle->handles;
 
-    ET_LOG(Info, "ArmBackend::execute %p", processed->data());
-
-    VelaHandles handles;
-
-    // Command stream - we know at this point it's aligned
-    char* data = (char*)processed->data();
-
-    // Read key sections from the vela_bin_stream
-    if (!this->vela_read(data, &handles, processed->size())) {
-      ET_LOG(Error, "ArmBackend::vela_read: error, invalid binary layout");
-      return Error::InvalidProgram;
-    }
+    ET_LOG(Info, "ArmBackend::execute %p", handle->processed->data());
 
     ET_LOG(
         Debug,
@@ -123,42 +146,97 @@ class ArmBackend final : public PyTorchBackendInterface {
         handles.scratch_data,
         handles.scratch_data_size);
 
+    // The inputs and outputs live in the delegate's scratch area, so an
+    // inference in flight must finish before the next one writes inputs.
+    if (handle->running) {
+      ET_LOG(
+          Error,
+          "ArmBackend::execute: this delegate is still running asynchronously");
+      return Error::InvalidState;
+    }
+    const bool run_async = context.can_complete_async();
+    PendingInference* slot = nullptr;
+    if (run_async) {
+      // With every NPU busy, ethosu_reserve_driver() would wait for one that
+      // only arm_backend_poll() can release.
+      for (PendingInference& pending : pending_) {
+        if (pending.driver == nullptr) {
+          slot = &pending;
+          break;
+        }
+      }
+      if (slot == nullptr) {
+        ET_LOG(
+            Error,
+            "ArmBackend::execute: all %d NPUs are running asynchronously",
+            ET_ARM_NUM_NPUS);
+        return Error::InvalidState;
+      }
+    }
+
     // Write inputs into SRAM scratch area defined by Vela
     for (int i = 0; i < handles.input_shapes.size(); i++) {
-      const char* input_addr = handles.scratch_data + handles.input_offset[i];
-      // Process input EValue into scratch
-      // TODO: Optimise into direct write from Vela into the SRAM or DRAM output
-      //       for compatible data layouts.
-      int* input_address = (int*)input_addr;
-      auto tensor_in = args[i]->toTensor();
-      for (int j = 0; j < tensor_in.numel(); j++) {
-        // TODO: extend beyond tensors with 4 byte elements
-        input_address[j] = tensor_in.mutable_data_ptr<int>()[j];
+      char* input_addr =
+          (char*)handles.scratch_data + handles.input_offset[i];
+      const Tensor& tensor_in = args[i]->toTensor();
+      Error err = check_io_layout(tensor_in, handles.input_shapes[i]);
+      if (err != Error::Ok) {
+        ET_LOG(Error, "ArmBackend::execute: input %d doesn't match Vela", i);
+        return err;
+      }
+      // The tensor holds the same elements in the same order as the scratch
+      // area, so a single memcpy suffices whatever the element size. It is
+      // skipped when the tensor's data already lives in the scratch area.
+      if (tensor_in.const_data_ptr() != input_addr) {
+        memcpy(input_addr, tensor_in.const_data_ptr(), tensor_in.nbytes());
       }
     }
 
-    // Allocate driver handle and synchronously invoke driver
+    // Reserves any free NPU, so that independent delegates, or the Methods of
+    // other threads, run on all of them.
     ethosu_driver* drv = ethosu_reserve_driver();
     if (drv == NULL) {
       ET_LOG(Error, "ArmBackend::execute: ethosu_reserve_driver failed");
       return Error::InvalidState;
     }
 
-    // Ethos-U low level driver expected order for Ethos U-55, we have
-    // constant weight data, then scratch (which contains input and output)
-    // scratch is written above in this function.
-    uint64_t bases[2] = {
-        (uint64_t)handles.weight_data, (uint64_t)handles.scratch_data};
-    size_t bases_size[2] = {
-        handles.weight_data_size, handles.scratch_data_size};
+    if (run_async) {
+      // Start the NPU and return; arm_backend_poll() finishes the inference
+      // once the NPU is done, while the CPU runs other work.
+      int result = ethosu_invoke_async(
+          drv,
+          (void*)handles.cmd_data,
+          handles.cmd_data_size,
+          handle->bases,
+          handle->bases_size,
+          2, /* fixed array of pointers to binary interface*/
+          nullptr);
+      if (result != 0) {
+        ethosu_release_driver(drv);
+        ET_LOG(
+            Error,
+            "ArmBackend::execute: Ethos-U invocation failed error (%d)",
+            result);
+        return Error::InvalidProgram;
+      }
+      slot->driver = drv;
+      slot->handle = handle;
+      slot->args = args;
+      slot->completion = context.completion();
+      handle->running = true;
+      return Error::Pending;
+    }
+
+    // Synchronously invoke driver
     int result = ethosu_invoke_v3(
         drv,
         (void*)handles.cmd_data,
         handles.cmd_data_size,
-        bases,
-        bases_size,
+        handle->bases,
+        handle->bases_size,
         2, /* fixed array of pointers to binary interface*/
         nullptr);
+    ethosu_release_driver(drv);
 
     if (result != 0) {
       ET_LOG(
@@ -168,32 +246,50 @@ class ArmBackend final : public PyTorchBackendInterface {
       return Error::InvalidProgram;
     }
 
-    // output data from Ethos U
-    // We only handle one output at the moment
-    const char* output_addr = handles.scratch_data + handles.output_offset[0];
-    // Outputs are in the index immediately after inputs
-    int output_index = handles.input_shapes.size();
+    return copy_outputs(handles, args);
+  }
 
-    if (handles.output_shapes.size() != 1) {
-      ET_LOG(
-          Error,
-          "ArmBackend::execute: currently only support one return tensor");
-      return Error::InvalidProgram;
-    }
-    // Process results into EValue storage
-    // TODO: optimise into direct write for compatible, contig layout
-    int* output_address = (int*)output_addr;
-    auto tensor_out = args[output_index]->toTensor();
-    for (int j = 0; j < tensor_out.numel(); j++) {
-      // TODO: extend beyond tensors with 4 byte elements
-      tensor_out.mutable_data_ptr<int>()[j] = output_address[j];
+  /**
+   * Finishes the asynchronous inferences started by execute() that are done.
+   * See arm_backend_poll().
+   */
+  static Error poll(bool block) {
+    bool running = false;
+    for (size_t i = 0; i < ET_ARM_NUM_NPUS; i++) {
+      if (pending_[i].driver == nullptr) {
+        continue;
+      }
+      int result = ethosu_wait(pending_[i].driver, block);
+      if (result == 1) {
+        // Still running.
+        running = true;
+        continue;
+      }
+      ethosu_release_driver(pending_[i].driver);
+
+      // Clear the pending state before completing, so that the completion
+      // callback may start the next inference.
+      PendingInference done = pending_[i];
+      pending_[i] = PendingInference();
+      done.handle->running = false;
+      Error status = Error::InvalidProgram;
+      if (result == 0) {
+        status = copy_outputs(done.handle->handles, done.args);
+      } else {
+        ET_LOG(
+            Error,
+            "ArmBackend::poll: Ethos-U invocation failed error (%d)",
+            result);
+      }
+      done.completion.complete(status);
     }
-
-    return Error::Ok;
+    return running ? Error::Pending : Error::Ok;
   }
 
   void destroy(DelegateHandle* handle) const override {
-    return;
+    if (handle != nullptr) {
+      ((ArmBackendHandle*)handle)->~ArmBackendHandle();
+    }
   }
 
  private:
@@ -210,6 +306,48 @@ class ArmBackend final : public PyTorchBackendInterface {
     vector<vector<int>> output_shapes;
   } VelaHandles;
 
+  /// The delegate handle: the Vela sections of one delegate blob.
+  struct ArmBackendHandle {
+    FreeableBuffer* processed;
+    VelaHandles handles;
+    /// The base pointers that the command stream addresses, set up by init().
+    uint64_t bases[2];
+    size_t bases_size[2];
+    /// True while an asynchronous inference of this delegate is in flight.
+    bool running = false;
+  };
+
+  /// An inference that execute() started asynchronously.
+  struct PendingInference {
+    ethosu_driver* driver = nullptr;
+    ArmBackendHandle* handle = nullptr;
+    EValue** args = nullptr;
+    BackendCompletion completion;
+  };
+  /// The inferences in flight, at most one per NPU.
+  static PendingInference pending_[ET_ARM_NUM_NPUS];
+
+  /**
+   * Copies the outputs from the Vela scratch area into `args`, where they
+   * follow the inputs.
+   */
+  static Error copy_outputs(const VelaHandles& handles, EValue** args) {
+    const size_t num_inputs = handles.input_shapes.size();
+    for (size_t i = 0; i < handles.output_shapes.size(); i++) {
+      const char* output_addr = handles.scratch_data + handles.output_offset[i];
+      const Tensor& tensor_out = args[num_inputs + i]->toTensor();
+      Error err = check_io_layout(tensor_out, handles.output_shapes[i]);
+      if (err != Error::Ok) {
+        ET_LOG(Error, "ArmBackend: output %zu doesn't match Vela", i);
+        return err;
+      }
+      if (tensor_out.const_data_ptr() != output_addr) {
+        memcpy(tensor_out.mutable_data_ptr(), output_addr, tensor_out.nbytes());
+      }
+    }
+    return Error::Ok;
+  }
+
   typedef struct {
     char name[16];
     uint32_t size;
@@ -227,6 +365,35 @@ class ArmBackend final : public PyTorchBackendInterface {
     int offsets[];
   } VelaOffsets;
 
+  /**
+   * Checks that `tensor` can be copied to or from a Vela scratch area of
+   * `shape` with a plain memcpy: the same number of elements, stored
+   * contiguously in the same order. Vela shapes are NHWC with leading 1s;
+   * the element size comes from the tensor, so int8, int16 and int32 tensors
+   * are all supported.
+   */
+  static Error check_io_layout(const Tensor& tensor, const vector<int>& shape) {
+    ssize_t vela_numel = 1;
+    for (int dim : shape) {
+      vela_numel *= dim;
+    }
+    if (tensor.numel() != vela_numel) {
+      ET_LOG(
+          Error,
+          "ArmBackend: tensor has %zd elements, Vela expects %zd",
+          (ssize_t)tensor.numel(),
+          vela_numel);
+      return Error::InvalidProgram;
+    }
+    for (size_t i = 0; i < tensor.dim_order().size(); i++) {
+      if (tensor.dim_order()[i] != i) {
+        ET_LOG(Error, "ArmBackend: only contiguous tensors are supported");
+        return Error::NotSupported;
+      }
+    }
+    return Error::Ok;
+  }
+
   static int next_mul_16(int n) {
     return ((n - 1) | 15) + 1;
   }
@@ -305,6 +472,12 @@ class ArmBackend final : public PyTorchBackendInterface {
   }
 };
 
+ArmBackend::PendingInference ArmBackend::pending_[ET_ARM_NUM_NPUS];
+
+Error arm_backend_poll(bool block) {
+  return ArmBackend::poll(block);
+}
+
 namespace {
 auto backend = ArmBackend();
 Backend backend_id{"ArmBackend", &backend};
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2023 Arm Limited and/or its affiliates.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ * Application interface of the Arm backend for the Ethos-U baremetal driver
+ * stack.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Finishes an Ethos-U inference that ArmBackend started asynchronously.
+ *
+ * When a Method runs through execute_async(), ArmBackend starts the NPU and
+ * returns Error::Pending instead of waiting for it, so the CPU can run other
+ * work, such as preparing the next input. The application must then call
+ * this function: either with `block` false whenever the NPU's completion
+ * interrupt has fired, or with `block` true once it runs out of other work.
+ * When the inference has finished, this copies its outputs into the Method
+ * and calls the Method's completion callback, which typically calls
+ * Method::resume_async().
+ *
+ * Up to ET_ARM_NUM_NPUS asynchronous inferences can be in flight at a time,
+ * one on each NPU that the application initialized with ethosu_init(), and at
+ * most one per delegate. Each call finishes all of them that are done. Must
+ * not be called from an interrupt handler.
+ *
+ * @param[in] block Whether to wait for the NPUs that are still running.
+ *
+ * @retval Error::Ok No asynchronous inference is in flight anymore.
+ * @retval Error::Pending `block` was false and an NPU is still running.
+ */
+Error arm_backend_poll(bool block);
+
+} // namespace executor
+} // namespace torch
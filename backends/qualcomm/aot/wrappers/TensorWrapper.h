@@ -35,6 +35,10 @@ class TensorWrapper {
 
   Error FillDataBuffer(const void* data, bool copy_data = false);
 
+  // Point the tensor at memory registered with QNN instead of a client
+  // buffer. FillDataBuffer() switches it back to a client buffer.
+  void SetMemHandle(Qnn_MemHandle_t mem_handle);
+
   // update qnn tensor meta
   // this function is used to recover metadata from QNN context binary.
   void UpdateQnnTensorMeta(const Qnn_Tensor_t& tensor_src);
@@ -61,6 +65,22 @@ class TensorWrapper {
     return QNN_VER_PTR(tensor_)->clientBuf.data;
   };
 
+  std::uint32_t GetRank() const {
+    return QNN_VER_PTR(tensor_)->rank;
+  };
+
+  std::uint32_t* GetDims() const {
+    return QNN_VER_PTR(tensor_)->dimensions;
+  };
+
+  Qnn_DataType_t GetDataType() const {
+    return QNN_VER_PTR(tensor_)->dataType;
+  };
+
+  std::uint32_t GetBytes() const {
+    return bytes_;
+  };
+
   std::string GetName() const {
     return qnn_tensor_name_;
   };
@@ -67,6 +67,7 @@ class QnnOperatorSupport(OperatorSupportBase):
 
 class QnnPartitioner(Partitioner):
     compiler_specs = []
+    quantized_io = False
 
     @classmethod
     def set_compiler_spec(cls, compiler_specs: List[CompileSpec]):
@@ -74,9 +75,21 @@ class QnnPartitioner(Partitioner):
         # please pay attention to it
         QnnPartitioner.compiler_specs = compiler_specs
 
+    @classmethod
+    def set_quantized_io(cls, quantized_io: bool):
+        """
+        If true, quantized program inputs and outputs that only a QNN delegate
+        uses keep their quantized dtype, e.g. uint8, instead of being float.
+        The delegate then reads and writes them without quantizing or
+        dequantizing, so that callers like camera pipelines can pass quantized
+        data straight through.
+        """
+        QnnPartitioner.quantized_io = quantized_io
+
     def __init__(self):
         self.supported_modules = set(supported_modules)
         self.compiler_specs_snapshot = copy.deepcopy(QnnPartitioner.compiler_specs)
+        self.quantized_io = QnnPartitioner.quantized_io
         self.delegation_spec = DelegationSpec(
             QnnBackend.__name__, self.compiler_specs_snapshot
         )
@@ -121,12 +134,33 @@ class QnnPartitioner(Partitioner):
                 node.meta["delegation_tag"] = delegation_tag
                 self.partition_tags[delegation_tag] = self.delegation_spec
 
+    def tag_quantized_io(self, graph_module: torch.fx.GraphModule) -> None:
+        def to_quantized(node: torch.fx.Node) -> None:
+            # InsertIOQDQ leaves these to the caller, and the program sees the
+            # quantized dtype.
+            node.meta["quantized_io"] = True
+            node.meta["val"] = node.meta["val"].to(node.meta["quant_attrs"]["dtype"])
+
+        for node in graph_module.graph.nodes:
+            if not node.meta.get("quant_attrs"):
+                continue
+            users = list(node.users.keys())
+            if node.op == "placeholder":
+                if users and all("delegation_tag" in user.meta for user in users):
+                    to_quantized(node)
+            elif "delegation_tag" in node.meta and all(
+                user.op == "output" for user in users
+            ):
+                to_quantized(node)
+
     # override
     def partition(self, exported_program: ExportedProgram) -> PartitionResult:
         graph_module = exported_program.graph_module
         partitions = self.generate_partitions(graph_module)
         if len(partitions) != 0:
             self.tag_nodes(partitions)
+            if self.quantized_io:
+                self.tag_quantized_io(graph_module)
         for node in graph_module.graph.nodes:
             if hasattr(node, "meta"):
                 # pop certain keys in meta for not affecting the passes in compilation
@@ -16,6 +16,8 @@ class InsertIOQDQ(ExportPass):
     'fold_qdq pass'.
     This pass will insert quantize nodes right after inputs, dequantize nodes
     right before outputs according to stored quantization encodings.
+    Inputs and outputs that the partitioner tagged as "quantized_io" are
+    already quantized, so they are left as they are.
     """
 
     q_dq_map = {
@@ -67,6 +69,9 @@ class InsertIOQDQ(ExportPass):
     def _insert(self, graph_module: torch.fx.GraphModule) -> torch.fx.GraphModule:
         for n in graph_module.graph.nodes:
             # insert q after input
+            if n.meta.get("quantized_io"):
+                continue
+
             if n.op == "placeholder" and n.meta.get("quant_attrs"):
                 self._insert_node(graph_module, n, n.meta["quant_attrs"]["encoding"])
 
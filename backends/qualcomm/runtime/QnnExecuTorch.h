@@ -8,8 +8,10 @@
 #pragma once
 
 #ifdef __cplusplus
+#include <cstddef>
 #include <cstdint>
 #else
+#include <stddef.h>
 #include <stdint.h>
 #endif
 
@@ -165,6 +167,36 @@ typedef struct { // NOLINT
 /// Create the QNN Delegate options structure and populate with default values.
 QnnExecuTorchOptions QnnExecuTorchOptionsDefault();
 
+/// Change the performance mode of every loaded HTP delegate, overriding the
+/// htp_performance_mode they were compiled with. Raise it to kHtpBurst before
+/// a latency-critical burst of executions and lower it again afterwards, so
+/// the HTP does not stay at high clocks while idle. The mode sets both the
+/// HTP clock vote and how long the CPU polls for results before sleeping.
+/// kHtpDefault releases the vote. Delegates loaded later still start in the
+/// mode they were compiled with. Returns false if a delegate failed to vote.
+bool QnnExecuTorchSetHtpPerformanceMode(
+    QnnExecuTorchHtpPerformanceMode perf_mode);
+
+/// Set the directory where the delegate keeps a copy of each QNN context it
+/// loads, keyed by the context binary in the program, the SoC model and the
+/// version of the QNN libraries on the device. Later loads of the same
+/// delegate read the copy from this directory instead. Pass nullptr or "" to
+/// disable the cache, which is the default. Must not be called while a
+/// program is being loaded.
+void QnnExecuTorchSetContextCacheDir(const char* dir);
+
+/// Allocate a buffer that the HTP can access directly. When the data of a
+/// delegate input or output tensor starts at such a buffer, the delegate
+/// registers it with QNN instead of having QNN copy the data on every
+/// execution. Use it for the tensors passed to Method::set_input() and
+/// Method::set_output_data_ptr(). Returns nullptr if shared buffers are not
+/// available on the device, or if alignment is larger than a page.
+void* QnnExecuTorchAllocCustomMem(size_t bytes, size_t alignment);
+
+/// Free a buffer returned by QnnExecuTorchAllocCustomMem(). Every Method that
+/// used the buffer must be destroyed first.
+void QnnExecuTorchFreeCustomMem(void* buffer_ptr);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -161,19 +161,28 @@ Error QnnExecuTorchBackend::execute(
   std::vector<Qnn_Tensor_t> input_tensor_structs;
   std::vector<Qnn_Tensor_t> output_tensor_structs;
 
+  // Tensors in shared buffers are registered with QNN so that the HTP uses
+  // them directly. Other tensors are passed as client buffers, which QNN
+  // copies to and from its own shared memory. GraphExecute() is synchronous,
+  // so neither needs a copy of its own here.
   for (int i = 0; i < input_tensors.size(); ++i) {
-    input_tensors[i]->FillDataBuffer(
-        args[i]->toTensor().data_ptr(), true /* copy_data */);
+    void* data_ptr = args[i]->toTensor().mutable_data_ptr();
+    if (qnn_manager->RegisterMem(data_ptr, input_tensors[i]) != Error::Ok) {
+      input_tensors[i]->FillDataBuffer(data_ptr, false /* copy_data */);
+    }
     input_tensor_structs.push_back(input_tensors[i]->CloneTensorStruct());
   }
 
   for (int i = input_tensors.size();
        i < input_tensors.size() + output_tensors.size();
        ++i) {
-    output_tensors[i - input_tensors.size()]->FillDataBuffer(
-        args[i]->toTensor().data_ptr(), false /* copy_data */);
-    output_tensor_structs.push_back(
-        output_tensors[i - input_tensors.size()]->CloneTensorStruct());
+    const std::shared_ptr<TensorWrapper>& output_tensor =
+        output_tensors[i - input_tensors.size()];
+    void* data_ptr = args[i]->toTensor().mutable_data_ptr();
+    if (qnn_manager->RegisterMem(data_ptr, output_tensor) != Error::Ok) {
+      output_tensor->FillDataBuffer(data_ptr, false /* copy_data */);
+    }
+    output_tensor_structs.push_back(output_tensor->CloneTensorStruct());
   }
 
   ET_CHECK_OR_RETURN_ERROR(
@@ -6,17 +6,25 @@
  * LICENSE file in the root directory of this source tree.
  */
 #include <executorch/backends/qualcomm/runtime/QnnManager.h>
+#include <executorch/backends/qualcomm/runtime/SharedBuffer.h>
 #include <executorch/backends/qualcomm/runtime/backends/QnnImplementation.h>
 
+#include <cinttypes>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 namespace torch {
 namespace executor {
 namespace qnn {
+namespace {
+std::string context_cache_dir; // NOLINT(cert-err58-cpp)
+} // namespace
+
+// The QNN libraries stay loaded after a QnnManager is destroyed, since other
+// QnnManagers may share its backend and device.
 QnnManager::~QnnManager() {
   backend_params_ptr_.reset(new BackendConfigParameters());
-  logger_.reset();
-  qnn_loaded_backend_.TerminateAllBackends();
 }
 
 QnnManager::QnnManager(const QnnExecuTorchOptions* options)
@@ -62,8 +70,6 @@ Error QnnManager::LoadQnnLibrary() {
 Error QnnManager::Init() {
   ET_CHECK_OR_RETURN_ERROR(
       LoadQnnLibrary() == Error::Ok, Internal, "Fail to load Qnn library");
-  logger_ = std::make_unique<QnnLogger>(
-      qnn_loaded_backend_, LoggingCallback, log_level_);
   if (backend_params_ptr_->backend_init_state_ ==
       BackendInitializeState::UNINITIALIZED) {
     QNN_EXECUTORCH_LOG(
@@ -71,33 +77,149 @@ Error QnnManager::Init() {
         "[Qnn ExecuTorch] Initialize Qnn backend "
         "parameters for Qnn executorch backend type %d",
         backend_type_);
-    backend_params_ptr_ = QnnBackendFactory().Create(
-        qnn_loaded_backend_,
-        logger_.get(),
-        qnn_context_blob_,
-        backend_type_,
-        graph_name_,
-        htp_options_);
-    ET_CHECK_OR_RETURN_ERROR(
-        backend_params_ptr_->qnn_backend_ptr_->Configure() == Error::Ok,
-        Internal,
-        "Fail to configure Qnn backend");
-    ET_CHECK_OR_RETURN_ERROR(
-        backend_params_ptr_->qnn_device_ptr_->Configure() == Error::Ok,
-        Internal,
-        "Fail to configure Qnn device");
-    ET_CHECK_OR_RETURN_ERROR(
-        backend_params_ptr_->qnn_context_ptr_->Configure() == Error::Ok,
-        Internal,
-        "Fail to configure Qnn context");
+    const std::string cache_path = GetContextCachePath();
+    const QnnExecuTorchContextBinary program_context_blob = qnn_context_blob_;
+    bool from_cache =
+        !cache_path.empty() && LoadContextCache(cache_path) == Error::Ok;
+
+    Error err = InitBackendParams();
+    if (err != Error::Ok && from_cache) {
+      QNN_EXECUTORCH_LOG(
+          kLogLevelWarn,
+          "[Qnn ExecuTorch] Discarding unusable cached context %s",
+          cache_path.c_str());
+      std::remove(cache_path.c_str());
+      backend_params_ptr_ = std::make_unique<BackendConfigParameters>();
+      qnn_context_blob_ = program_context_blob;
+      cached_context_blob_.clear();
+      from_cache = false;
+      err = InitBackendParams();
+    }
     ET_CHECK_OR_RETURN_ERROR(
-        backend_params_ptr_->qnn_graph_ptr_->Configure() == Error::Ok,
-        Internal,
-        "Fail to configure Qnn graph");
-    backend_params_ptr_->backend_init_state_ =
-        BackendInitializeState::INITIALIZED;
+        err == Error::Ok, Internal, "Fail to initialize Qnn backend");
+
+    if (!cache_path.empty() && !from_cache &&
+        SaveContextCache(cache_path) != Error::Ok) {
+      QNN_EXECUTORCH_LOG(
+          kLogLevelWarn,
+          "[Qnn ExecuTorch] Failed to cache context to %s",
+          cache_path.c_str());
+    }
+  }
+
+  return Error::Ok;
+}
+
+Error QnnManager::InitBackendParams() {
+  // The factory configures the backend, device and context, which may be
+  // shared with other QnnManagers.
+  std::unique_ptr<BackendConfigParameters> backend_params =
+      QnnBackendFactory().Create(
+          qnn_loaded_backend_,
+          log_level_,
+          qnn_context_blob_,
+          backend_type_,
+          graph_name_,
+          htp_options_);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend_params != nullptr, Internal, "Fail to create Qnn backend");
+  backend_params_ptr_ = std::move(backend_params);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend_params_ptr_->qnn_graph_ptr_->Configure() == Error::Ok,
+      Internal,
+      "Fail to configure Qnn graph");
+  backend_params_ptr_->backend_init_state_ =
+      BackendInitializeState::INITIALIZED;
+  return Error::Ok;
+}
+
+std::string QnnManager::GetContextCachePath() {
+  if (context_cache_dir.empty() || qnn_context_blob_.buffer == nullptr) {
+    return "";
+  }
+  Qnn_ApiVersion_t api_version = QNN_API_VERSION_INIT;
+  Qnn_ErrorHandle_t error =
+      qnn_loaded_backend_.GetQnnInterface().qnn_backend_get_api_version(
+          &api_version);
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelWarn,
+        "[Qnn ExecuTorch] Can't get QNN API version, so the context cache is "
+        "disabled. Error %d",
+        QNN_GET_ERROR_CODE(error));
+    return "";
   }
+  // A cached context is only valid for the same program, SoC and QNN
+  // libraries, so all of them are part of its name.
+  char name[128];
+  std::snprintf(
+      name,
+      sizeof(name),
+      "qnn_context_%016" PRIx64 "_soc%d_core%u.%u.%u_backend%u.%u.%u.bin",
+      QnnBackendCache::HashContextBinary(qnn_context_blob_),
+      static_cast<int>(htp_options_.soc_model),
+      api_version.coreApiVersion.major,
+      api_version.coreApiVersion.minor,
+      api_version.coreApiVersion.patch,
+      api_version.backendApiVersion.major,
+      api_version.backendApiVersion.minor,
+      api_version.backendApiVersion.patch);
+  return context_cache_dir + "/" + name;
+}
 
+Error QnnManager::LoadContextCache(const std::string& cache_path) {
+  std::ifstream file(cache_path, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return Error::NotFound;
+  }
+  const std::streamsize size = file.tellg();
+  if (size <= 0) {
+    return Error::InvalidProgram;
+  }
+  cached_context_blob_.resize(static_cast<size_t>(size));
+  file.seekg(0, std::ios::beg);
+  if (!file.read(cached_context_blob_.data(), size)) {
+    cached_context_blob_.clear();
+    return Error::AccessFailed;
+  }
+  QNN_EXECUTORCH_LOG(
+      kLogLevelInfo,
+      "[Qnn ExecuTorch] Loading cached context %s",
+      cache_path.c_str());
+  qnn_context_blob_.buffer = cached_context_blob_.data();
+  qnn_context_blob_.nbytes = cached_context_blob_.size();
+  return Error::Ok;
+}
+
+Error QnnManager::SaveContextCache(const std::string& cache_path) {
+  QnnExecuTorchContextBinary context_binary = QNN_EXECUTORCH_CONTEXT_BINARY;
+  ET_CHECK_OR_RETURN_ERROR(
+      backend_params_ptr_->qnn_context_ptr_->GetContextBinary(
+          context_binary) == Error::Ok,
+      Internal,
+      "Fail to get context binary.");
+
+  // Write to a temporary file and rename it, so that a process that dies
+  // mid-write never leaves a truncated context behind.
+  const std::string tmp_path = cache_path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open() ||
+        !file.write(
+            static_cast<const char*>(context_binary.buffer),
+            static_cast<std::streamsize>(context_binary.nbytes))) {
+      std::remove(tmp_path.c_str());
+      return Error::AccessFailed;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return Error::AccessFailed;
+  }
+  QNN_EXECUTORCH_LOG(
+      kLogLevelInfo,
+      "[Qnn ExecuTorch] Cached context to %s",
+      cache_path.c_str());
   return Error::Ok;
 }
 
@@ -140,13 +262,34 @@ Error QnnManager::Execute(
   return Error::Ok;
 }
 
+Error QnnManager::RegisterMem(
+    void* data_ptr,
+    const std::shared_ptr<TensorWrapper>& tensor_wrapper) {
+  QnnMemManager* mem_manager = backend_params_ptr_->qnn_mem_manager_ptr_.get();
+  if (mem_manager == nullptr) {
+    return Error::NotSupported;
+  }
+  Qnn_MemHandle_t handle = mem_manager->GetMemHandle(data_ptr);
+  if (handle == nullptr) {
+    SharedBuffer& shared_buffer = SharedBuffer::GetSharedBufferManager();
+    if (shared_buffer.GetAllocatedSize(data_ptr) < tensor_wrapper->GetBytes()) {
+      return Error::NotFound;
+    }
+    Error err = mem_manager->RegisterIonMem(
+        tensor_wrapper, shared_buffer.MemToFd(data_ptr), data_ptr);
+    if (err != Error::Ok) {
+      return err;
+    }
+    handle = mem_manager->GetMemHandle(data_ptr);
+  }
+  tensor_wrapper->SetMemHandle(handle);
+  return Error::Ok;
+}
+
 void QnnManager::Destroy() {
   QNN_EXECUTORCH_LOG(
       kLogLevelInfo, "[Qnn ExecuTorch] Destroy Qnn backend parameters");
   backend_params_ptr_.reset(new BackendConfigParameters());
-  logger_.reset();
-
-  qnn_loaded_backend_.TerminateAllBackends();
 }
 
 bool QnnManager::IsAvailable() {
@@ -256,6 +399,10 @@ Error QnnManager::Compile(
 } // namespace executor
 } // namespace torch
 
+void QnnExecuTorchSetContextCacheDir(const char* dir) {
+  torch::executor::qnn::context_cache_dir = dir == nullptr ? "" : dir;
+}
+
 QnnExecuTorchOptions QnnExecuTorchOptionsDefault() {
   QnnExecuTorchOptions options;
   std::memset(
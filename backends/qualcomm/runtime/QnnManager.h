@@ -15,6 +15,8 @@
 #include <executorch/runtime/core/error.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace torch {
 namespace executor {
@@ -34,6 +36,13 @@ class QnnManager {
 
   void Destroy();
 
+  // Points tensor_wrapper at data_ptr without copying when data_ptr is a
+  // buffer from QnnExecuTorchAllocCustomMem() that is large enough for the
+  // tensor. Returns an error if the tensor must use a client buffer instead.
+  Error RegisterMem(
+      void* data_ptr,
+      const std::shared_ptr<TensorWrapper>& tensor_wrapper);
+
   bool IsAvailable();
 
   bool IsNodeSupportedByBackend(
@@ -53,6 +62,20 @@ class QnnManager {
  private:
   Error LoadQnnLibrary();
 
+  // Creates the QNN backend, device, context and graph from
+  // qnn_context_blob_.
+  Error InitBackendParams();
+
+  // Returns the path of the on-disk copy of qnn_context_blob_, or "" if the
+  // context cache is disabled or unavailable for this context.
+  std::string GetContextCachePath();
+
+  // Points qnn_context_blob_ at the context binary stored at cache_path.
+  Error LoadContextCache(const std::string& cache_path);
+
+  // Writes the binary of the current context to cache_path.
+  Error SaveContextCache(const std::string& cache_path);
+
   static constexpr const char* htp_library_name_ = "libQnnHtp.so";
   static constexpr const char* gpu_library_name_ = "libQnnGpu.so";
   static constexpr const char* dsp_library_name_ = "libQnnDsp.so";
@@ -64,9 +87,9 @@ class QnnManager {
   QnnExecuTorchHtpBackendOptions htp_options_;
   QnnExecuTorchLogLevel log_level_;
   QnnExecuTorchContextBinary qnn_context_blob_;
+  std::vector<char> cached_context_blob_;
   std::unique_ptr<BackendConfigParameters> backend_params_ptr_;
   QnnImplementation qnn_loaded_backend_;
-  std::unique_ptr<QnnLogger> logger_;
   std::vector<std::shared_ptr<TensorWrapper>> input_tensors_;
   std::vector<std::shared_ptr<TensorWrapper>> output_tensors_;
 };
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <executorch/backends/qualcomm/runtime/QnnExecuTorch.h>
+#include <executorch/backends/qualcomm/runtime/SharedBuffer.h>
+
+#include <dlfcn.h>
+namespace torch {
+namespace executor {
+namespace qnn {
+SharedBuffer& SharedBuffer::GetSharedBufferManager() {
+  static SharedBuffer shared_buffer_manager;
+  return shared_buffer_manager;
+}
+
+SharedBuffer::~SharedBuffer() {
+  if (lib_cdsp_rpc_ == nullptr) {
+    return;
+  }
+  for (const auto& allocation : allocated_sizes_) {
+    rpc_mem_free_(allocation.first);
+  }
+  allocated_sizes_.clear();
+  dlclose(lib_cdsp_rpc_);
+  lib_cdsp_rpc_ = nullptr;
+}
+
+Error SharedBuffer::Load() {
+  if (load_attempted_) {
+    return lib_cdsp_rpc_ != nullptr ? Error::Ok : Error::NotSupported;
+  }
+  load_attempted_ = true;
+
+  lib_cdsp_rpc_ = dlopen(rpc_library_name_, RTLD_NOW | RTLD_LOCAL);
+  if (lib_cdsp_rpc_ == nullptr) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelWarn,
+        "[Qnn ExecuTorch] Unable to load %s: %s",
+        rpc_library_name_,
+        dlerror());
+    return Error::NotSupported;
+  }
+  rpc_mem_alloc_ =
+      reinterpret_cast<RpcMemAllocFn>(dlsym(lib_cdsp_rpc_, "rpcmem_alloc"));
+  rpc_mem_free_ =
+      reinterpret_cast<RpcMemFreeFn>(dlsym(lib_cdsp_rpc_, "rpcmem_free"));
+  rpc_mem_to_fd_ =
+      reinterpret_cast<RpcMemToFdFn>(dlsym(lib_cdsp_rpc_, "rpcmem_to_fd"));
+  if (rpc_mem_alloc_ == nullptr || rpc_mem_free_ == nullptr ||
+      rpc_mem_to_fd_ == nullptr) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelWarn,
+        "[Qnn ExecuTorch] Unable to find rpcmem symbols in %s",
+        rpc_library_name_);
+    dlclose(lib_cdsp_rpc_);
+    lib_cdsp_rpc_ = nullptr;
+    return Error::NotSupported;
+  }
+  return Error::Ok;
+}
+
+void* SharedBuffer::AllocMem(size_t bytes, size_t alignment) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (Load() != Error::Ok) {
+    return nullptr;
+  }
+  if (alignment > rpcmem_alignment_ || bytes == 0 ||
+      bytes > static_cast<size_t>(INT32_MAX)) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelError,
+        "[Qnn ExecuTorch] Unsupported shared buffer of %zu bytes "
+        "aligned to %zu",
+        bytes,
+        alignment);
+    return nullptr;
+  }
+  void* buf = rpc_mem_alloc_(
+      rpcmem_heap_id_system_, rpcmem_default_flags_, static_cast<int>(bytes));
+  if (buf == nullptr) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelError,
+        "[Qnn ExecuTorch] Failed to allocate %zu bytes of shared buffer",
+        bytes);
+    return nullptr;
+  }
+  allocated_sizes_[buf] = bytes;
+  return buf;
+}
+
+int32_t SharedBuffer::MemToFd(void* buf) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (allocated_sizes_.count(buf) == 0) {
+    return -1;
+  }
+  return rpc_mem_to_fd_(buf);
+}
+
+void SharedBuffer::FreeMem(void* buf) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (allocated_sizes_.erase(buf) == 0) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelWarn,
+        "[Qnn ExecuTorch] Buffer %p is not a shared buffer",
+        buf);
+    return;
+  }
+  rpc_mem_free_(buf);
+}
+
+size_t SharedBuffer::GetAllocatedSize(void* buf) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = allocated_sizes_.find(buf);
+  return it == allocated_sizes_.end() ? 0 : it->second;
+}
+} // namespace qnn
+} // namespace executor
+} // namespace torch
+
+void* QnnExecuTorchAllocCustomMem(size_t bytes, size_t alignment) {
+  return torch::executor::qnn::SharedBuffer::GetSharedBufferManager().AllocMem(
+      bytes, alignment);
+}
+
+void QnnExecuTorchFreeCustomMem(void* buffer_ptr) {
+  torch::executor::qnn::SharedBuffer::GetSharedBufferManager().FreeMem(
+      buffer_ptr);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <executorch/backends/qualcomm/runtime/Logging.h>
+#include <executorch/runtime/core/error.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+namespace torch {
+namespace executor {
+namespace qnn {
+// Allocates buffers from rpcmem (ION / DMA-BUF memory shared with the
+// Hexagon DSP). A buffer allocated here can be registered with QNN as a mem
+// handle, so the HTP reads and writes it directly instead of QNN copying the
+// data to and from its own shared memory on every execution.
+class SharedBuffer {
+ public:
+  SharedBuffer(const SharedBuffer&) = delete;
+  SharedBuffer& operator=(const SharedBuffer&) = delete;
+
+  static SharedBuffer& GetSharedBufferManager();
+
+  // Returns nullptr if libcdsprpc.so is unavailable, the allocation fails, or
+  // alignment is larger than the page alignment that rpcmem guarantees.
+  void* AllocMem(size_t bytes, size_t alignment);
+
+  // Returns -1 if buf was not returned by AllocMem().
+  int32_t MemToFd(void* buf);
+
+  void FreeMem(void* buf);
+
+  // Returns the size of the allocation starting at buf, or 0 if buf was not
+  // returned by AllocMem().
+  size_t GetAllocatedSize(void* buf);
+
+ private:
+  SharedBuffer() = default;
+  ~SharedBuffer();
+
+  Error Load();
+
+  using RpcMemAllocFn = void* (*)(int, uint32_t, int);
+  using RpcMemFreeFn = void (*)(void*);
+  using RpcMemToFdFn = int (*)(void*);
+
+  static constexpr const char* rpc_library_name_ = "libcdsprpc.so";
+  // RPCMEM_HEAP_ID_SYSTEM and RPCMEM_DEFAULT_FLAGS from rpcmem.h
+  static constexpr int rpcmem_heap_id_system_ = 25;
+  static constexpr uint32_t rpcmem_default_flags_ = 1;
+  static constexpr size_t rpcmem_alignment_ = 4096;
+
+  void* lib_cdsp_rpc_{nullptr};
+  bool load_attempted_{false};
+  RpcMemAllocFn rpc_mem_alloc_{nullptr};
+  RpcMemFreeFn rpc_mem_free_{nullptr};
+  RpcMemToFdFn rpc_mem_to_fd_{nullptr};
+  std::unordered_map<void*, size_t> allocated_sizes_;
+  std::mutex mutex_;
+};
+} // namespace qnn
+} // namespace executor
+} // namespace torch
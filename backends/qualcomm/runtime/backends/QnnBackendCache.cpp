@@ -150,6 +150,16 @@ QnnBackendCache::~QnnBackendCache() {
   qnn_sys_impl_.Unload();
 }
 
+std::uint64_t QnnBackendCache::HashContextBinary(
+    const QnnExecuTorchContextBinary& qnn_context_blob) {
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  const auto* bytes = static_cast<const std::uint8_t*>(qnn_context_blob.buffer);
+  for (std::uint64_t i = 0; i < qnn_context_blob.nbytes; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
 std::vector<Qnn_Tensor_t> QnnBackendCache::GetGraphInputs() {
   if (state_ != DESERIALIZE)
     return {};
@@ -49,6 +49,10 @@ class QnnBackendCache {
     return graph_name_;
   }
 
+  // 64-bit FNV-1a of the blob's bytes, which identifies a context binary.
+  static std::uint64_t HashContextBinary(
+      const QnnExecuTorchContextBinary& qnn_context_blob);
+
  private:
   Error GetQnnGraphInfoFromBinary();
 
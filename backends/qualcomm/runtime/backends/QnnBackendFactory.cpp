@@ -6,12 +6,118 @@
  * LICENSE file in the root directory of this source tree.
  */
 #include <executorch/backends/qualcomm/runtime/backends/QnnBackendFactory.h>
+
+#include <mutex>
+#include <unordered_map>
 namespace torch {
 namespace executor {
 namespace qnn {
+namespace {
+// Owns a backend and device along with the implementation and logger they
+// were created with, so they can outlive the QnnManager that created them.
+// Members are destroyed in reverse order: device, backend, logger.
+struct SharedBackend {
+  explicit SharedBackend(const QnnImplementation& impl)
+      : implementation(impl) {}
+  QnnImplementation implementation;
+  std::unique_ptr<QnnLogger> logger;
+  std::unique_ptr<QnnBackend> backend;
+  std::unique_ptr<QnnDevice> device;
+};
+
+// Keeps the backend alive for as long as the context created on it.
+struct SharedContext {
+  std::shared_ptr<SharedBackend> backend;
+  std::unique_ptr<QnnContext> context;
+};
+
+// Handles that are in use by at least one BackendConfigParameters.
+std::mutex registry_mutex;
+// NOLINTNEXTLINE(fuchsia-statically-constructed-objects)
+std::unordered_map<std::string, std::weak_ptr<SharedBackend>> shared_backends;
+// NOLINTNEXTLINE(fuchsia-statically-constructed-objects)
+std::unordered_map<std::string, std::weak_ptr<SharedContext>> shared_contexts;
+
+std::string GetHtpBackendKey(
+    const QnnImplementation& implementation,
+    const QnnExecuTorchHtpBackendOptions& htp_options) {
+  return std::to_string(implementation.GetQnnInterface().GetBackendId()) +
+      "/" + std::to_string(htp_options.soc_model) + "/" +
+      std::to_string(htp_options.performance_mode) + "/" +
+      std::to_string(htp_options.pd_session);
+}
+
+std::shared_ptr<SharedBackend> GetOrCreateHtpBackend(
+    const QnnImplementation& implementation,
+    QnnExecuTorchLogLevel log_level,
+    const QnnExecuTorchHtpBackendOptions& htp_options) {
+  const std::string key = GetHtpBackendKey(implementation, htp_options);
+  std::shared_ptr<SharedBackend> shared = shared_backends[key].lock();
+  if (shared != nullptr) {
+    return shared;
+  }
+
+  shared = std::make_shared<SharedBackend>(implementation);
+  shared->logger = std::make_unique<QnnLogger>(
+      shared->implementation, LoggingCallback, log_level);
+  shared->backend = std::make_unique<HtpBackend>(
+      shared->implementation, shared->logger.get());
+  shared->device = std::make_unique<HtpDevice>(
+      shared->implementation, shared->logger.get(), htp_options);
+  if (shared->backend->Configure() != Error::Ok) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelError, "[Qnn ExecuTorch] Fail to configure Qnn backend");
+    return nullptr;
+  }
+  if (shared->device->Configure() != Error::Ok) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelError, "[Qnn ExecuTorch] Fail to configure Qnn device");
+    return nullptr;
+  }
+  shared_backends[key] = shared;
+  return shared;
+}
+
+std::shared_ptr<SharedContext> GetOrCreateHtpContext(
+    const std::shared_ptr<SharedBackend>& backend,
+    const std::string& backend_key,
+    const QnnExecuTorchContextBinary& qnn_context_blob,
+    const QnnExecuTorchHtpBackendOptions& htp_options) {
+  // A context that graphs are still being added to (no context binary yet)
+  // belongs to its QnnManager alone.
+  const bool shareable = qnn_context_blob.buffer != nullptr;
+  const std::string key = backend_key + "/" +
+      std::to_string(QnnBackendCache::HashContextBinary(qnn_context_blob)) +
+      "/" + std::to_string(qnn_context_blob.nbytes);
+  std::shared_ptr<SharedContext> shared =
+      shareable ? shared_contexts[key].lock() : nullptr;
+  if (shared != nullptr) {
+    return shared;
+  }
+
+  shared = std::make_shared<SharedContext>();
+  shared->backend = backend;
+  shared->context = std::make_unique<HtpContext>(
+      backend->implementation,
+      backend->backend.get(),
+      backend->device.get(),
+      qnn_context_blob,
+      htp_options);
+  if (shared->context->Configure() != Error::Ok) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelError, "[Qnn ExecuTorch] Fail to configure Qnn context");
+    return nullptr;
+  }
+  if (shareable) {
+    shared_contexts[key] = shared;
+  }
+  return shared;
+}
+} // namespace
+
 std::unique_ptr<BackendConfigParameters> QnnBackendFactory::Create(
     const QnnImplementation& implementation,
-    QnnLogger* logger,
+    QnnExecuTorchLogLevel log_level,
     const QnnExecuTorchContextBinary& qnn_context_blob,
     const QnnExecuTorchBackendType& backend_type,
     const std::string& graph_name,
@@ -20,27 +126,45 @@ std::unique_ptr<BackendConfigParameters> QnnBackendFactory::Create(
   switch (backend_type) {
     case kGpuBackend:
       throw NotImplementedException();
-    case kHtpBackend:
+    case kHtpBackend: {
+      std::shared_ptr<SharedBackend> backend;
+      std::shared_ptr<SharedContext> context;
+      {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        backend =
+            GetOrCreateHtpBackend(implementation, log_level, htp_options);
+        if (backend == nullptr) {
+          return nullptr;
+        }
+        context = GetOrCreateHtpContext(
+            backend,
+            GetHtpBackendKey(implementation, htp_options),
+            qnn_context_blob,
+            htp_options);
+        if (context == nullptr) {
+          return nullptr;
+        }
+      }
+
+      // Alias the shared handles, so that each pointer keeps the whole
+      // SharedBackend or SharedContext alive.
       backend_params->qnn_backend_ptr_ =
-          std::make_unique<HtpBackend>(implementation, logger);
+          std::shared_ptr<QnnBackend>(backend, backend->backend.get());
       backend_params->qnn_device_ptr_ =
-          std::make_unique<HtpDevice>(implementation, logger, htp_options);
-
-      backend_params->qnn_context_ptr_ = std::make_unique<HtpContext>(
-          implementation,
-          backend_params->qnn_backend_ptr_.get(),
-          backend_params->qnn_device_ptr_.get(),
-          qnn_context_blob,
-          htp_options);
+          std::shared_ptr<QnnDevice>(backend, backend->device.get());
+      backend_params->qnn_context_ptr_ =
+          std::shared_ptr<QnnContext>(context, context->context.get());
 
       backend_params->qnn_graph_ptr_ = std::make_unique<HtpGraph>(
-          implementation,
+          backend->implementation,
           backend_params->qnn_context_ptr_.get(),
           graph_name,
           htp_options);
+      backend_params->qnn_mem_manager_ptr_ = std::make_unique<QnnMemManager>(
+          backend->implementation, backend_params->qnn_context_ptr_.get());
       backend_params->backend_init_state_ = BackendInitializeState::INITIALIZED;
       return backend_params;
-      break;
+    }
     case kDspBackend:
       throw NotImplementedException();
     case kUndefinedBackend:
@@ -15,6 +15,7 @@
 #include <executorch/backends/qualcomm/runtime/backends/QnnGraphCommon.h>
 #include <executorch/backends/qualcomm/runtime/backends/QnnImplementation.h>
 #include <executorch/backends/qualcomm/runtime/backends/QnnLogger.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnMemManager.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpBackend.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpContext.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDevice.h>
@@ -26,13 +27,16 @@ namespace executor {
 namespace qnn {
 typedef enum { UNINITIALIZED, INITIALIZED } BackendInitializeState;
 
-// @brief Struct containing all handles for a given QNN backend
+// @brief Struct containing all handles for a given QNN backend.
+// The backend, device and context may be shared with other QnnManagers, see
+// QnnBackendFactory::Create().
 typedef struct BackendConfigParameters {
-  std::unique_ptr<QnnBackend> qnn_backend_ptr_;
+  std::shared_ptr<QnnBackend> qnn_backend_ptr_;
   BackendInitializeState backend_init_state_;
-  std::unique_ptr<QnnContext> qnn_context_ptr_;
-  std::unique_ptr<QnnDevice> qnn_device_ptr_;
+  std::shared_ptr<QnnContext> qnn_context_ptr_;
+  std::shared_ptr<QnnDevice> qnn_device_ptr_;
   std::unique_ptr<QnnGraph> qnn_graph_ptr_;
+  std::unique_ptr<QnnMemManager> qnn_mem_manager_ptr_;
 
   // Default ctor
   BackendConfigParameters()
@@ -40,9 +44,11 @@ typedef struct BackendConfigParameters {
         backend_init_state_(BackendInitializeState::UNINITIALIZED),
         qnn_context_ptr_(nullptr),
         qnn_device_ptr_(nullptr),
-        qnn_graph_ptr_(nullptr) {}
+        qnn_graph_ptr_(nullptr),
+        qnn_mem_manager_ptr_(nullptr) {}
   // Default dtor
   ~BackendConfigParameters() {
+    qnn_mem_manager_ptr_.reset();
     qnn_graph_ptr_.reset();
     qnn_context_ptr_.reset();
     qnn_device_ptr_.reset();
@@ -54,9 +60,15 @@ typedef struct BackendConfigParameters {
 
 class QnnBackendFactory : public QnnFactory {
  public:
+  // Creates the handles for a delegate and configures all but the graph.
+  // Delegates that load the same library with the same HTP options share one
+  // backend and device, and delegates with the same context binary share one
+  // context, which also holds the weights only once. Shared handles are
+  // freed with the last BackendConfigParameters that uses them. Returns
+  // nullptr on failure.
   std::unique_ptr<BackendConfigParameters> Create(
       const QnnImplementation& implementation,
-      QnnLogger* logger,
+      QnnExecuTorchLogLevel log_level,
       const QnnExecuTorchContextBinary& qnn_context_blob,
       const QnnExecuTorchBackendType& backend_type,
       const std::string& graph_name,
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <executorch/backends/qualcomm/runtime/backends/QnnMemManager.h>
+namespace torch {
+namespace executor {
+namespace qnn {
+Error QnnMemManager::RegisterIonMem(
+    const std::shared_ptr<TensorWrapper>& tensor_wrapper,
+    int32_t mem_fd,
+    void* mem_ptr) {
+  const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
+  Qnn_MemHandle_t handle = nullptr;
+  Qnn_ErrorHandle_t error = QNN_SUCCESS;
+
+  Qnn_MemDescriptor_t descriptor = {
+      {tensor_wrapper->GetRank(), tensor_wrapper->GetDims(), nullptr},
+      tensor_wrapper->GetDataType(),
+      QNN_MEM_TYPE_ION,
+      {{mem_fd}}};
+  error = qnn_interface.qnn_mem_register(
+      context_->GetHandle(),
+      &descriptor,
+      /*numDescriptors=*/1,
+      &handle);
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelWarn,
+        "[Qnn ExecuTorch] Tensor %s failed to register shared memory. "
+        "Error %d",
+        tensor_wrapper->GetName().c_str(),
+        QNN_GET_ERROR_CODE(error));
+    return Error::Internal;
+  }
+  QNN_EXECUTORCH_LOG(
+      kLogLevelInfo,
+      "[Qnn ExecuTorch] Tensor %s is successfully registered to shared "
+      "memory.",
+      tensor_wrapper->GetName().c_str());
+  registered_map_.insert({mem_ptr, handle});
+  return Error::Ok;
+}
+
+void QnnMemManager::DeRegisterMem() {
+  const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
+  Qnn_ErrorHandle_t error = QNN_SUCCESS;
+
+  for (const auto& entry : registered_map_) {
+    error = qnn_interface.qnn_mem_de_register(&entry.second, /*numHandles=*/1);
+    if (error != QNN_SUCCESS) {
+      QNN_EXECUTORCH_LOG(
+          kLogLevelWarn,
+          "[Qnn ExecuTorch] Failed to de-register shared memory. Error %d",
+          QNN_GET_ERROR_CODE(error));
+    }
+  }
+  registered_map_.clear();
+}
+} // namespace qnn
+} // namespace executor
+} // namespace torch
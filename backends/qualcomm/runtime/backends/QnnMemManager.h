@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <executorch/backends/qualcomm/aot/wrappers/TensorWrapper.h>
+#include <executorch/backends/qualcomm/runtime/Logging.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnContextCommon.h>
+#include <executorch/backends/qualcomm/runtime/backends/QnnImplementation.h>
+
+#include <memory>
+#include <unordered_map>
+namespace torch {
+namespace executor {
+namespace qnn {
+// Registers shared buffers with a QNN context and keeps the mem handles until
+// the context is destroyed.
+class QnnMemManager {
+ public:
+  explicit QnnMemManager(
+      const QnnImplementation& implementation,
+      QnnContext* context)
+      : implementation_(implementation), context_(context) {}
+  ~QnnMemManager() {
+    DeRegisterMem();
+  }
+
+  // Registers the ION buffer mem_fd, whose mapping starts at mem_ptr, as the
+  // memory of tensor_wrapper. A buffer keeps its first registration, so it
+  // must always be used for the same tensor of the graph.
+  Error RegisterIonMem(
+      const std::shared_ptr<TensorWrapper>& tensor_wrapper,
+      int32_t mem_fd,
+      void* mem_ptr);
+
+  // Returns nullptr if mem_ptr has not been registered.
+  Qnn_MemHandle_t GetMemHandle(void* mem_ptr) const {
+    auto it = registered_map_.find(mem_ptr);
+    return it == registered_map_.end() ? nullptr : it->second;
+  }
+
+  void DeRegisterMem();
+
+ private:
+  const QnnImplementation& implementation_;
+  QnnContext* context_;
+  std::unordered_map<void*, Qnn_MemHandle_t> registered_map_;
+};
+} // namespace qnn
+} // namespace executor
+} // namespace torch
@@ -10,6 +10,8 @@
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDevice.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpUtils.h>
 
+#include <unordered_set>
+
 #include "Saver/QnnSaverCommon.h"
 
 namespace torch {
@@ -17,6 +19,18 @@ namespace executor {
 namespace qnn {
 constexpr const int kNumRpcPollingPowerConfigs = 2;
 namespace {
+// Every live HtpDevice, so that QnnExecuTorchSetHtpPerformanceMode() can
+// reach the devices of all loaded delegates.
+std::mutex& LiveDevicesMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unordered_set<HtpDevice*>& LiveDevices() {
+  static std::unordered_set<HtpDevice*> devices;
+  return devices;
+}
+
 template <typename... Args>
 Qnn_ErrorHandle_t HtpPerfInfraStubForSaver(Args... args) {
   return QNN_SUCCESS;
@@ -266,6 +280,10 @@ std::vector<QnnHtpPerfInfrastructure_PowerConfig_t> SetRpcPollingPowerConfig(
 } // namespace
 
 HtpDevice::~HtpDevice() {
+  {
+    std::lock_guard<std::mutex> lock(LiveDevicesMutex());
+    LiveDevices().erase(this);
+  }
   if (htp_perf_infra_ != nullptr && powerconfig_client_id_ != 0 &&
       !down_vote_power_configs_ptr_.empty()) {
     htp_perf_infra_->setPowerConfig(
@@ -356,73 +374,123 @@ Error HtpDevice::MakeConfig(std::vector<const QnnDevice_Config_t*>& config) {
   return Error::Ok;
 }
 
-void HtpDevice::PerformanceVote() {
-  if (IsPerfModeEnabled()) {
-    htp_perf_infra_->setPowerConfig(
-        powerconfig_client_id_, perf_power_configs_ptr_.data());
-  }
-};
+Error HtpDevice::CreatePowerConfigId() {
+  const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
+  Qnn_ErrorHandle_t error = QNN_SUCCESS;
 
-void HtpDevice::ReleasePerformanceVote() {
-  if (IsPerfModeEnabled()) {
-    htp_perf_infra_->setPowerConfig(
-        powerconfig_client_id_, down_vote_power_configs_ptr_.data());
+  // Get htp_perf_infra
+  if (GetPerfInfra(qnn_interface, &owned_htp_perf_infra_) != Error::Ok) {
+    return Error::Internal;
   }
-};
+  htp_perf_infra_ = &owned_htp_perf_infra_;
 
-Error HtpDevice::AfterCreateDevice() {
-  if (IsPerfModeEnabled()) {
-    const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
-    Qnn_ErrorHandle_t error = QNN_SUCCESS;
+  // Get power client id
+  error = htp_perf_infra_->createPowerConfigId(
+      /*device_id=*/0, /*core_id=*/0, &powerconfig_client_id_);
 
-    // Get htp_perf_infra
-    htp_perf_infra_ = &owned_htp_perf_infra_;
-    if (GetPerfInfra(qnn_interface, htp_perf_infra_) != Error::Ok) {
-      return Error::Internal;
-    }
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelError,
+        "[Qnn ExecuTorch] HTP backend unable to create "
+        "power config. Error %d",
+        QNN_GET_ERROR_CODE(error));
+    return Error::Internal;
+  }
 
-    // Get power client id
-    error = htp_perf_infra_->createPowerConfigId(
-        /*device_id=*/0, /*core_id=*/0, &powerconfig_client_id_);
+  down_vote_power_configs_ = SetVotePowerConfig(
+      powerconfig_client_id_,
+      QnnExecuTorchHtpPerformanceMode::kHtpDefault,
+      PerformanceModeVoteType::kDownVote);
+  down_vote_power_configs_ptr_ =
+      ObtainNullTermPtrVector(down_vote_power_configs_);
+  return Error::Ok;
+}
 
-    if (error != QNN_SUCCESS) {
-      QNN_EXECUTORCH_LOG(
-          kLogLevelError,
-          "[Qnn ExecuTorch] HTP backend unable to create "
-          "power config. Error %d",
-          QNN_GET_ERROR_CODE(error));
-      return Error::Internal;
+Error HtpDevice::SetPerformanceMode(
+    QnnExecuTorchHtpPerformanceMode perf_mode) {
+  std::lock_guard<std::mutex> lock(perf_mutex_);
+  if (powerconfig_client_id_ == 0) {
+    if (perf_mode == QnnExecuTorchHtpPerformanceMode::kHtpDefault) {
+      // Nothing has been voted for yet.
+      htp_options_.performance_mode = perf_mode;
+      return Error::Ok;
     }
+    ET_CHECK_OR_RETURN_ERROR(
+        CreatePowerConfigId() == Error::Ok,
+        Internal,
+        "Fail to create HTP power config");
+  }
 
-    // Set vector of PowerConfigs and map it to a vector of pointers.
+  // Set vector of PowerConfigs and map it to a vector of pointers.
+  Qnn_ErrorHandle_t error = QNN_SUCCESS;
+  if (perf_mode == QnnExecuTorchHtpPerformanceMode::kHtpDefault) {
+    error = htp_perf_infra_->setPowerConfig(
+        powerconfig_client_id_, down_vote_power_configs_ptr_.data());
+  } else {
     perf_power_configs_ = SetVotePowerConfig(
-        powerconfig_client_id_,
-        htp_options_.performance_mode,
-        PerformanceModeVoteType::kUpVote);
+        powerconfig_client_id_, perf_mode, PerformanceModeVoteType::kUpVote);
     perf_power_configs_ptr_ = ObtainNullTermPtrVector(perf_power_configs_);
+    error = htp_perf_infra_->setPowerConfig(
+        powerconfig_client_id_, perf_power_configs_ptr_.data());
+  }
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelError,
+        "[Qnn ExecuTorch] HTP backend unable to vote for performance "
+        "mode %d. Error %d",
+        perf_mode,
+        QNN_GET_ERROR_CODE(error));
+    return Error::Internal;
+  }
 
-    down_vote_power_configs_ = SetVotePowerConfig(
-        powerconfig_client_id_,
-        QnnExecuTorchHtpPerformanceMode::kHtpDefault,
-        PerformanceModeVoteType::kDownVote);
-    down_vote_power_configs_ptr_ =
-        ObtainNullTermPtrVector(down_vote_power_configs_);
-
-    // vote immediately
-    PerformanceVote();
+  // Set Rpc polling mode
+  rpc_power_configs_ = SetRpcPollingPowerConfig(perf_mode);
+  rpc_power_configs_ptr_ = ObtainNullTermPtrVector(rpc_power_configs_);
+  error = htp_perf_infra_->setPowerConfig(
+      powerconfig_client_id_, rpc_power_configs_ptr_.data());
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG(
+        kLogLevelError,
+        "[Qnn ExecuTorch] HTP backend unable to set RPC polling for "
+        "performance mode %d. Error %d",
+        perf_mode,
+        QNN_GET_ERROR_CODE(error));
+    return Error::Internal;
+  }
 
-    // Set Rpc polling mode
-    rpc_power_configs_ =
-        SetRpcPollingPowerConfig(htp_options_.performance_mode);
-    rpc_power_configs_ptr_ = ObtainNullTermPtrVector(rpc_power_configs_);
+  htp_options_.performance_mode = perf_mode;
+  return Error::Ok;
+}
 
-    htp_perf_infra_->setPowerConfig(
-        powerconfig_client_id_, rpc_power_configs_ptr_.data());
+Error HtpDevice::AfterCreateDevice() {
+  if (IsPerfModeEnabled()) {
+    // vote immediately
+    ET_CHECK_OR_RETURN_ERROR(
+        SetPerformanceMode(htp_options_.performance_mode) == Error::Ok,
+        Internal,
+        "Fail to set HTP performance mode");
   }
 
+  std::lock_guard<std::mutex> lock(LiveDevicesMutex());
+  LiveDevices().insert(this);
   return Error::Ok;
 }
 
 } // namespace qnn
 } // namespace executor
 } // namespace torch
+
+bool QnnExecuTorchSetHtpPerformanceMode(
+    QnnExecuTorchHtpPerformanceMode perf_mode) {
+  using torch::executor::Error;
+  using torch::executor::qnn::HtpDevice;
+  using torch::executor::qnn::LiveDevices;
+  using torch::executor::qnn::LiveDevicesMutex;
+
+  bool success = true;
+  std::lock_guard<std::mutex> lock(LiveDevicesMutex());
+  for (HtpDevice* device : LiveDevices()) {
+    success &= device->SetPerformanceMode(perf_mode) == Error::Ok;
+  }
+  return success;
+}
@@ -12,6 +12,7 @@
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDevicePlatformInfoConfig.h>
 
 #include <memory>
+#include <mutex>
 
 #include "HTP/QnnHtpDevice.h"
 namespace torch {
@@ -36,14 +37,17 @@ class HtpDevice : public QnnDevice {
     kDownVote = 2,
   };
 
+  // Votes for the clocks and RPC polling of perf_mode, replacing the mode in
+  // the delegate options. kHtpDefault releases the vote.
+  Error SetPerformanceMode(QnnExecuTorchHtpPerformanceMode perf_mode);
+
  protected:
   Error MakeConfig(std::vector<const QnnDevice_Config_t*>& config) override;
 
   Error AfterCreateDevice() override;
 
  private:
-  void PerformanceVote();
-  void ReleasePerformanceVote();
+  Error CreatePowerConfigId();
 
   inline bool IsPerfModeEnabled() {
     return htp_options_.performance_mode !=
@@ -81,6 +85,8 @@ class HtpDevice : public QnnDevice {
   std::vector<const QnnHtpPerfInfrastructure_PowerConfig_t*>
       down_vote_power_configs_ptr_;
 
+  // Guards the power config members and htp_options_.performance_mode.
+  std::mutex perf_mutex_;
   QnnExecuTorchHtpBackendOptions htp_options_;
   HtpInfo qcom_target_soc_info_;
 };
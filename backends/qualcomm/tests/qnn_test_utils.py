@@ -24,6 +24,7 @@ from executorch.backends.qualcomm.utils.utils import (
 )
 from executorch.examples.portable.utils import _EDGE_COMPILE_CONFIG
 from executorch.exir.backend.backend_api import to_backend
+from executorch.exir.scalar_type import ScalarType
 from torch.ao.quantization.quantize_pt2e import convert_pt2e, prepare_pt2e
 
 
@@ -131,6 +132,7 @@ class TestQNN(unittest.TestCase):
         soc_model: SoCModel = SoCModel.SM8550,
         debug: bool = False,
         saver: bool = False,
+        quantized_io: bool = False,
     ) -> exir.ExirExportedProgram:
         class WrappedModule(torch.nn.Module):
             def __init__(self):
@@ -144,6 +146,7 @@ class TestQNN(unittest.TestCase):
             is_fp16=is_fp16, soc_model=soc_model, debug=debug, saver=saver
         )
         QnnPartitioner.set_compiler_spec(compiler_specs)
+        QnnPartitioner.set_quantized_io(quantized_io)
         if use_partitioner:
             delegated_program = capture_program(module, sample_inputs)
             delegated_program.exported_program = to_backend(
@@ -170,4 +173,13 @@ class TestQNN(unittest.TestCase):
             QnnBackend.__name__,
         )
 
+        if quantized_io:
+            # The delegate reads and writes the program's inputs and outputs in
+            # their quantized dtype.
+            plan = exec_prog.program.execution_plan[0]
+            for index in list(plan.inputs) + list(plan.outputs):
+                self.assertNotEqual(
+                    plan.values[index].val.scalar_type, ScalarType.FLOAT
+                )
+
         return exec_prog.buffer
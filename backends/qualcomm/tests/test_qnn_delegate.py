@@ -874,6 +874,27 @@ class TestQNNINT8(TestQNN):
         model_name = "ptq_qnn_relu_model"
         save_model_and_expected_output(Relu(), buffer, example_inputs, model_name)
 
+    def test_qnn_backend_ptq_quantized_io(self):
+        class Conv2dRelu(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.conv = torch.nn.Conv2d(
+                    in_channels=3, out_channels=3, kernel_size=(3, 3), padding=1
+                )
+                self.relu = torch.nn.ReLU()
+
+            def forward(self, x):
+                return self.relu(self.conv(x))
+
+        instance = Conv2dRelu()
+        example_inputs = (torch.randn([1, 3, 8, 8]),)
+        quant_instance = get_qdq_module(instance, example_inputs)
+        buffer = self.lower_module_and_test_output(
+            quant_instance, example_inputs, quantized_io=True
+        )
+        model_name = "ptq_qnn_quantized_io_model"
+        save_model_and_expected_output(instance, buffer, example_inputs, model_name)
+
     def test_qnn_backend_ptq_linear(self):
         class Linear(torch.nn.Module):
             def __init__(self):
@@ -13,14 +13,85 @@
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/platform/profiler.h>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib> /* strtol */
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <type_traits>
 
 namespace torch {
 namespace executor {
 
+namespace {
+
+/**
+ * The handle of a Vulkan delegate: its graph, and the worker that waits for
+ * the GPU when the delegate is executed asynchronously.
+ *
+ * ComputeGraph::execute() submits the recorded command buffer and blocks on
+ * its fence. Under Method::execute_async() that wait moves to the worker, so
+ * the Method can run CPU kernels that don't depend on the delegate meanwhile.
+ */
+struct VulkanDelegate {
+  explicit VulkanDelegate(at::native::vulkan::GraphConfig config)
+      : graph(config) {}
+
+  at::native::vulkan::ComputeGraph graph;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  /// Started by the first asynchronous execution.
+  std::thread worker;
+  bool stopping = false;
+  /// The execution handed to the worker, if any. A delegate is executed at
+  /// most once at a time.
+  EValue** pending_args = nullptr;
+  BackendCompletion pending_completion;
+};
+
+/// Copies the outputs of the last execution of `graph` into `args`, which holds
+/// the inputs directly followed by the outputs.
+void copy_outputs(at::native::vulkan::ComputeGraph& graph, EValue** args) {
+  const size_t num_inputs = graph.inputs().size();
+  for (size_t i = 0; i < graph.outputs().size(); i++) {
+    graph.copy_from_staging(
+        graph.outputs()[i],
+        args[num_inputs + i]->toTensor().mutable_data_ptr(),
+        args[num_inputs + i]->toTensor().numel());
+  }
+}
+
+void run_worker(VulkanDelegate* delegate) {
+  std::unique_lock<std::mutex> lock(delegate->mutex);
+  while (true) {
+    delegate->changed.wait(lock, [&] {
+      return delegate->stopping || delegate->pending_args != nullptr;
+    });
+    if (delegate->pending_args == nullptr) {
+      return;
+    }
+    EValue** args = delegate->pending_args;
+    BackendCompletion completion = delegate->pending_completion;
+    lock.unlock();
+
+    delegate->graph.execute();
+    copy_outputs(delegate->graph, args);
+
+    lock.lock();
+    delegate->pending_args = nullptr;
+    delegate->pending_completion = BackendCompletion();
+    // The Method may resume, and execute this delegate again, as soon as it
+    // is told, so the state must be clear before that.
+    lock.unlock();
+    completion.complete(Error::Ok);
+    lock.lock();
+  }
+}
+
+} // namespace
+
 class VulkanBackend final : public PyTorchBackendInterface {
  public:
   ~VulkanBackend() override = default;
@@ -255,30 +326,34 @@ class VulkanBackend final : public PyTorchBackendInterface {
         flatbuffers_fbsource::GetBufferIdentifier(processed->data()),
         at::vulkan::delegate::VkGraphIdentifier());
 
-    at::native::vulkan::ComputeGraph* compute_graph =
-        ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(
-            context.get_runtime_allocator(), at::native::vulkan::ComputeGraph);
+    VulkanDelegate* delegate = ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(
+        context.get_runtime_allocator(), VulkanDelegate);
 
-    new (compute_graph) at::native::vulkan::ComputeGraph(generate_config());
+    new (delegate) VulkanDelegate(generate_config());
 
-    Error err = compileModel(processed->data(), compute_graph);
+    Error err = compileModel(processed->data(), &delegate->graph);
 
     if (err != Error::Ok) {
+      delegate->~VulkanDelegate();
       return err;
     }
 
-    return compute_graph;
+    return delegate;
   }
 
   Error execute(
-      __ET_UNUSED BackendExecutionContext& context,
+      BackendExecutionContext& context,
       DelegateHandle* handle,
       EValue** args) const override {
     EXECUTORCH_SCOPE_PROF("VulkanBackend::execute");
 
-    at::native::vulkan::ComputeGraph* compute_graph =
-        static_cast<at::native::vulkan::ComputeGraph*>(handle);
+    VulkanDelegate* delegate = static_cast<VulkanDelegate*>(handle);
+    at::native::vulkan::ComputeGraph* compute_graph = &delegate->graph;
 
+    // The command buffer was recorded once by encode_execute() in init(), so
+    // execute() only resubmits it. The graph owns the GPU storage of its inputs
+    // and outputs, and ComputeGraph only exposes them through its staging
+    // buffers, so I/O has to be copied through staging here.
     const size_t num_inputs = compute_graph->inputs().size();
     for (size_t i = 0; i < num_inputs; i++) {
       compute_graph->copy_into_staging(
@@ -287,28 +362,39 @@ class VulkanBackend final : public PyTorchBackendInterface {
           args[i]->toTensor().numel());
     }
 
-    compute_graph->execute();
-
-    for (size_t i = 0; i < compute_graph->outputs().size(); i++) {
-      // args holds inputs directly followed by outputs, so the i'th output
-      // for compute_graph corresponds to the (i + num_inputs)'th arg
-      compute_graph->copy_from_staging(
-          compute_graph->outputs()[i],
-          args[num_inputs + i]->toTensor().mutable_data_ptr(),
-          args[num_inputs + i]->toTensor().numel());
+    if (context.can_complete_async()) {
+      // The inputs are in staging, so the caller may overwrite them; the
+      // worker waits for the GPU and writes the outputs.
+      std::lock_guard<std::mutex> lock(delegate->mutex);
+      if (!delegate->worker.joinable()) {
+        delegate->worker = std::thread(run_worker, delegate);
+      }
+      delegate->pending_args = args;
+      delegate->pending_completion = context.completion();
+      delegate->changed.notify_one();
+      return Error::Pending;
     }
 
+    compute_graph->execute();
+    copy_outputs(*compute_graph, args);
+
     return Error::Ok;
   }
 
   void destroy(DelegateHandle* handle) const override {
     if (handle != nullptr) {
-      at::native::vulkan::ComputeGraph* compute_graph =
-          static_cast<at::native::vulkan::ComputeGraph*>(handle);
-      // at::native::vulkan::ComputeGraph is not trivially destructible. Since
-      // this was constructed manually in init(), we must destroy it manually
-      // here.
-      compute_graph->~ComputeGraph();
+      VulkanDelegate* delegate = static_cast<VulkanDelegate*>(handle);
+      {
+        std::lock_guard<std::mutex> lock(delegate->mutex);
+        delegate->stopping = true;
+        delegate->changed.notify_one();
+      }
+      if (delegate->worker.joinable()) {
+        delegate->worker.join();
+      }
+      // VulkanDelegate is not trivially destructible. Since this was
+      // constructed manually in init(), we must destroy it manually here.
+      delegate->~VulkanDelegate();
     }
   }
 };
@@ -0,0 +1,83 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from typing import Dict, final
+
+import torch
+from executorch.backends.vulkan.vulkan_preprocess import VulkanBackend
+from executorch.exir.backend.canonical_partitioners.pattern_op_partitioner import (
+    generate_pattern_op_partitions,
+)
+from executorch.exir.backend.partitioner import (
+    DelegationSpec,
+    Partitioner,
+    PartitionResult,
+)
+from executorch.exir.dialects._ops import ops as exir_ops
+from torch.export import ExportedProgram
+from torch.fx.passes.operator_support import OperatorSupportBase
+
+
+class VulkanSupportedOperators(OperatorSupportBase):
+    """
+    Accepts the nodes that vulkan_preprocess can serialize and the Vulkan
+    ComputeGraph can run: binary arithmetic between two fp32 tensors.
+    """
+
+    _SUPPORTED_OPS = [
+        exir_ops.edge.aten.add.Tensor,
+        exir_ops.edge.aten.sub.Tensor,
+        exir_ops.edge.aten.mul.Tensor,
+        exir_ops.edge.aten.div.Tensor,
+    ]
+
+    @staticmethod
+    def _is_fp32_tensor(node: torch.fx.Node) -> bool:
+        val = node.meta.get("val", None)
+        return isinstance(val, torch.Tensor) and val.dtype == torch.float32
+
+    def is_node_supported(self, submodules, node: torch.fx.Node) -> bool:
+        if node.op != "call_function" or node.target not in self._SUPPORTED_OPS:
+            return False
+        # The runtime always adds with alpha = 1 and only takes tensor operands.
+        if node.kwargs.get("alpha", 1) != 1 or len(node.args) != 2:
+            return False
+        return self._is_fp32_tensor(node) and all(
+            isinstance(arg, torch.fx.Node) and self._is_fp32_tensor(arg)
+            for arg in node.args
+        )
+
+
+@final
+class VulkanPartitioner(Partitioner):
+    """
+    Delegates each connected group of supported nodes to the Vulkan backend,
+    leaving every other node to run on the CPU.
+    """
+
+    def __init__(self) -> None:
+        self.op_support = VulkanSupportedOperators()
+        self.delegation_spec = DelegationSpec(VulkanBackend.__name__, [])
+
+    def partition(self, exported_program: ExportedProgram) -> PartitionResult:
+        partition_tags: Dict[str, DelegationSpec] = {}
+        partition_list = generate_pattern_op_partitions(
+            exported_program.graph_module, op_support=self.op_support
+        )
+        for partition in partition_list:
+            delegation_tag = f"vulkan_{partition.id}"
+            partition_tags[delegation_tag] = self.delegation_spec
+            for node in partition.nodes:
+                node.meta["delegation_tag"] = delegation_tag
+                # Constants are serialized into the delegate with the ops that
+                # use them.
+                for arg in node.args:
+                    if isinstance(arg, torch.fx.Node) and arg.op == "get_attr":
+                        arg.meta["delegation_tag"] = delegation_tag
+
+        return PartitionResult(
+            tagged_exported_program=exported_program, partition_tags=partition_tags
+        )
@@ -12,6 +12,9 @@ import executorch.exir as exir
 import torch
 
 # import the vulkan backend implementation
+from executorch.backends.vulkan.partitioner.vulkan_partitioner import (
+    VulkanPartitioner,
+)
 from executorch.backends.vulkan.vulkan_preprocess import VulkanBackend
 
 from executorch.exir import ExecutorchProgram
@@ -94,6 +97,42 @@ class TestBackends(unittest.TestCase):
 
         self.assert_outputs_equal(model_output, ref_output)
 
+    def test_vulkan_backend_partitioner(self):
+        class PartiallySupportedModule(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+
+            def forward(self, x, y):
+                z = x + y
+                z = torch.relu(z)
+                z = z * x
+                return z
+
+        module = PartiallySupportedModule()
+        model_inputs = (
+            torch.rand(size=(2, 3), dtype=torch.float32),
+            torch.rand(size=(2, 3), dtype=torch.float32),
+        )
+
+        edgeir_m = exir.capture(module, model_inputs, exir.CaptureConfig()).to_edge()
+        # relu is not supported, so the add and the mul are delegated separately
+        # and relu runs on the CPU in between.
+        edgeir_m.exported_program = to_backend(
+            edgeir_m.exported_program, VulkanPartitioner
+        )
+        executorch_program: ExecutorchProgram = edgeir_m.to_executorch()
+
+        delegates = executorch_program.program.execution_plan[0].delegates
+        self.assertEqual(len(delegates), 2)
+        for delegate in delegates:
+            self.assertEqual(delegate.id, VulkanBackend.__name__)
+
+        executorch_module = _load_for_executorch_from_buffer(executorch_program.buffer)
+        # pyre-fixme[16]: Module `pytree` has no attribute `tree_flatten`.
+        inputs_flattened, _ = tree_flatten(model_inputs)
+        model_output = executorch_module.run_method("forward", tuple(inputs_flattened))
+        self.assert_outputs_equal(model_output, module(*model_inputs))
+
     def test_vulkan_backend_add(self):
         # This test is the simplest test by manually lowering some submodules, we can use paritioner for auto detecting lowerable parts
         class AddModule(torch.nn.Module):
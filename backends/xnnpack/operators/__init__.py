@@ -18,8 +18,10 @@ from . import (  # noqa
     op_div,
     op_elu,
     op_floor,
+    op_gelu,
     op_hardswish,
     op_hardtanh,
+    op_layer_norm,
     op_leaky_relu,
     op_linear,
     op_matrix_multiplication,
@@ -44,5 +46,6 @@ from . import (  # noqa
     op_static_constant_pad,
     op_static_resize_bilinear_2d,
     op_sub,
+    op_tanh,
     op_to_copy,
 )
@@ -5,7 +5,8 @@
 # LICENSE file in the root directory of this source tree.
 
 import ctypes
-from typing import cast, Dict, Optional, Tuple
+import struct
+from typing import cast, Dict, List, Optional, Tuple
 
 import torch
 from executorch.backends.transforms import get_shape
@@ -18,6 +19,7 @@ from executorch.backends.xnnpack.passes.channels_last_tagged_reshape_pass import
 
 from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
     Buffer,
+    PerChannelGroupQuant,
     PerChannelQuant,
     PerTensorQuant,
     XNNDatatype,
@@ -40,6 +42,7 @@ from torch.export import ExportedProgram
 
 XNN_TYPE_MAP = {
     torch.float32: XNNDatatype.xnn_datatype_fp32,
+    torch.float16: XNNDatatype.xnn_datatype_fp16,
 }
 
 
@@ -193,15 +196,24 @@ class NodeVisitor:
         return ext_id, id_out, flag
 
     def get_serialized_dtype(
-        self, quant_params: Optional[QuantParams]
+        self,
+        quant_params: Optional[QuantParams],
+        node: Optional[torch.fx.Node] = None,
     ) -> Tuple[XNNDatatype, XNNDatatype]:
         dtype, dq_dtype = (
             XNNDatatype.xnn_datatype_fp32,
             XNNDatatype.xnn_datatype_invalid,
         )
-        if quant_params is not None:
+        if quant_params is None:
+            # Half models keep their tensors, and weights, in fp16
+            val = node.meta.get("val", None) if node is not None else None
+            if isinstance(val, torch.Tensor) and val.dtype == torch.float16:
+                dtype = XNNDatatype.xnn_datatype_fp16
+        else:
             if quant_params.is_dynamic:
                 dq_dtype = XNNDatatype.xnn_datatype_qint8
+            elif quant_params.group_size > 0:
+                dtype = XNNDatatype.xnn_datatype_qbint4
             else:
                 if quant_params.per_channel:
                     dtype = (
@@ -219,6 +231,16 @@ class NodeVisitor:
         return (dtype, dq_dtype)
 
     def get_quant_params(self, quant_params: QuantParams) -> XNNQuantParams:
+        if quant_params.group_size > 0:
+            scale = cast(torch.Tensor, quant_params.scale)
+            # XNNPACK takes blockwise scales as bfloat16
+            scale_bits = scale.to(torch.bfloat16).view(torch.int16).to(torch.int32)
+            return PerChannelGroupQuant(
+                scale_bf16=(scale_bits & 0xFFFF).flatten().tolist(),
+                channel_dim=quant_params.axis,
+                group_size=quant_params.group_size,
+            )
+
         if quant_params.per_channel:
             scale = cast(torch.Tensor, quant_params.scale)
             return PerChannelQuant(
@@ -294,7 +316,7 @@ class NodeVisitor:
             check_or_raise(len(dims) == 4, "Converting to nhwc requires 4d tensor")
             dims = [dims[i] for i in PERM_NCHW_TO_NHWC]
 
-        dtype, dq_dtype = self.get_serialized_dtype(quant_params)
+        dtype, dq_dtype = self.get_serialized_dtype(quant_params, tensor)
 
         tvalue = XNNTensorValue(
             datatype=dtype,
@@ -335,6 +357,20 @@ class NodeVisitor:
         if quant_params is not None:
             vals_to_ids[quant_params.q_input] = id_out
 
+    @staticmethod
+    def pack_int4(const_val: torch.Tensor) -> torch.Tensor:
+        """
+        Packs int4 values in [-8, 7] two to a byte, as unsigned nibbles around
+        a zero point of 8 with the lower index in the low nibble, which is how
+        XNNPACK takes 4-bit weights.
+        """
+        check_or_raise(
+            const_val.dim() == 2 and const_val.shape[1] % 2 == 0,
+            f"Packing int4 needs a 2D tensor with an even number of columns, got {const_val.shape}",
+        )
+        nibbles = (const_val.to(torch.int16) + 8).to(torch.uint8)
+        return (nibbles[:, 0::2] | (nibbles[:, 1::2] << 4)).contiguous()
+
     def get_serialized_buffer(
         self,
         tensor: torch.fx.Node,
@@ -388,8 +424,10 @@ class NodeVisitor:
         # Quantize buffer if static data is indeed quantized
         if quant_params is not None and not quant_params.is_dynamic:
             const_val = quant_params.quantize_tensor(const_val).contiguous()
-        else:
-            # ensure that the const is fp32
+            if quant_params.group_size > 0:
+                const_val = self.pack_int4(const_val)
+        elif const_val.dtype != torch.float16:
+            # ensure that the const is fp32, unless it is fp16 like its graph
             const_val = const_val.to(dtype=torch.float32).contiguous()
 
         if swap_nc_for_depthwise_weights:
@@ -482,6 +520,93 @@ class NodeVisitor:
                     convert_to_nhwc=False,  # Bias is generally 1d and can not be in NHWC
                 )
 
+    @staticmethod
+    def get_float_dtype(node: torch.fx.Node) -> XNNDatatype:
+        """
+        Serialized datatype of the values that a visitor adds to compute
+        a float node in several XNNPACK nodes: fp16 for half nodes, else fp32
+        """
+        val = node.meta.get("val", None)
+        if isinstance(val, (tuple, list)):
+            val = val[0]
+        if isinstance(val, torch.Tensor) and val.dtype == torch.float16:
+            return XNNDatatype.xnn_datatype_fp16
+        return XNNDatatype.xnn_datatype_fp32
+
+    def define_intermediate_tensor(
+        self,
+        xnn_graph: XNNGraph,
+        dims: List[int],
+        dtype: XNNDatatype = XNNDatatype.xnn_datatype_fp32,
+    ) -> int:
+        """
+        Defines a value that only lives inside the XNNPACK graph, for ops that
+        are lowered to several XNNPACK nodes, and returns its id
+
+        Args:
+            xnn_graph: XNNGraph object for serializing into flatbuffer
+            dims: shape of the value, as XNNPACK sees it
+            dtype: serialized datatype of the value
+        """
+        id_out = len(xnn_graph.xvalues)
+        xnn_graph.xvalues.append(
+            XValue(
+                xvalue_union=XNNTensorValue(
+                    datatype=dtype,
+                    num_dims=len(dims),
+                    dims=list(dims),
+                    constant_buffer_idx=0,
+                    external_id=XNN_INVALID_VALUE_ID,
+                    flags=0,
+                    id_out=id_out,
+                )
+            )
+        )
+        return id_out
+
+    def define_scalar_constant(
+        self,
+        xnn_graph: XNNGraph,
+        value: float,
+        dtype: XNNDatatype = XNNDatatype.xnn_datatype_fp32,
+    ) -> int:
+        """
+        Defines a constant of shape [1], which XNNPACK's binary nodes broadcast
+        against the other input, and returns its id
+
+        Args:
+            xnn_graph: XNNGraph object for serializing into flatbuffer
+            value: the value of the constant
+            dtype: serialized datatype of the constant, fp32 or fp16
+        """
+        check_or_raise(
+            dtype
+            in (XNNDatatype.xnn_datatype_fp32, XNNDatatype.xnn_datatype_fp16),
+            f"Scalar constants must be fp32 or fp16, got {dtype}",
+        )
+        storage = struct.pack(
+            "<e" if dtype == XNNDatatype.xnn_datatype_fp16 else "<f", value
+        )
+        buffer_idx = len(xnn_graph.constant_buffer)
+        xnn_graph.constant_buffer.append(Buffer(storage=storage))
+        xnn_graph.mem_buffer_sizes.append(len(storage))
+
+        id_out = len(xnn_graph.xvalues)
+        xnn_graph.xvalues.append(
+            XValue(
+                xvalue_union=XNNTensorValue(
+                    datatype=dtype,
+                    num_dims=1,
+                    dims=[1],
+                    constant_buffer_idx=buffer_idx,
+                    external_id=XNN_INVALID_VALUE_ID,
+                    flags=0,
+                    id_out=id_out,
+                )
+            )
+        )
+        return id_out
+
     def define_node(
         self,
         node: torch.fx.Node,
@@ -13,12 +13,14 @@ from executorch.backends.xnnpack.operators.node_visitor import (
     NodeVisitor,
     register_node_visitor,
 )
+from executorch.backends.xnnpack.operators.quant_params import QuantParams
 from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
     XNNFullyConnected,
     XNNGraph,
     XNode,
 )
 
+from executorch.backends.xnnpack.utils.utils import is_param_node
 from executorch.backends.xnnpack.utils.xnnpack_constants import (
     XNN_FLAG_TRANSPOSE_WEIGHTS,
 )
@@ -39,6 +41,26 @@ class AddmmVisitor(NodeVisitor):
         debug_handle: int,
     ) -> None:
         input_type_map = InputTypeToIndex(node_input=1, node_weight=2, node_bias=0)
+
+        # mat2 is [in, out], but XNNPACK packs [out, in] filters with a plain
+        # copy per row. Transposing constant weights here saves XNNPACK from
+        # transposing them while packing every time the delegate is loaded.
+        weight_node = get_input_node(node, 2)
+        pretranspose_weights = (
+            weight_node not in vals_to_ids
+            and len(weight_node.users) == 1
+            and is_param_node(self.exported_program, weight_node)
+            and QuantParams.from_weights(weight_node, self.exported_program) is None
+        )
+        if pretranspose_weights:
+            # Swapping the first two dims of a 2d tensor transposes it.
+            self.define_tensor(
+                weight_node,
+                xnn_graph,
+                vals_to_ids,
+                swap_nc_for_depthwise_weights=True,
+            )
+
         self.define_nodes_tensor_inputs_outputs(
             node, xnn_graph, vals_to_ids, input_type_map=input_type_map
         )
@@ -55,7 +77,7 @@ class AddmmVisitor(NodeVisitor):
         # output
         output_id = vals_to_ids[node]
 
-        flag = XNN_FLAG_TRANSPOSE_WEIGHTS
+        flag = 0 if pretranspose_weights else XNN_FLAG_TRANSPOSE_WEIGHTS
 
         ser_node = XNode(
             xnode_union=XNNFullyConnected(
@@ -4,10 +4,11 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
-from typing import cast, Dict, List
+from typing import cast, Dict, List, Union
 
 import torch
 from executorch.backends.xnnpack.operators.node_visitor import (
+    get_tensor_value,
     NodeVisitor,
     register_node_visitor,
 )
@@ -19,7 +20,7 @@ from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
     XNNGraph,
     XNode,
 )
-from executorch.backends.xnnpack.utils.utils import PERM_NHWC_TO_NCHW
+from executorch.backends.xnnpack.utils.utils import check_or_raise, PERM_NHWC_TO_NCHW
 from executorch.backends.xnnpack.utils.xnnpack_constants import XNN_INVALID_VALUE_ID
 
 
@@ -61,41 +62,62 @@ class CeilingVisitor(NodeVisitor):
         if "XNN_NHWC_NODE" in node.meta:
             axis = PERM_NHWC_TO_NCHW[axis]
 
-        if num_tensors_to_cat == 2:
-            xnode = XNNConcatenate2(
-                axis=axis,
-                input1_id=vals_to_ids[list_of_tensors[0]],
-                input2_id=vals_to_ids[list_of_tensors[1]],
-                input3_id=XNN_INVALID_VALUE_ID,
-                input4_id=XNN_INVALID_VALUE_ID,
-                output_id=vals_to_ids[node],
-                flags=0,
-            )
-        elif num_tensors_to_cat == 3:
-            xnode = XNNConcatenate3(
-                axis=axis,
-                input1_id=vals_to_ids[list_of_tensors[0]],
-                input2_id=vals_to_ids[list_of_tensors[1]],
-                input3_id=vals_to_ids[list_of_tensors[2]],
-                input4_id=XNN_INVALID_VALUE_ID,
-                output_id=vals_to_ids[node],
-                flags=0,
-            )
-        elif num_tensors_to_cat == 4:
-            xnode = XNNConcatenate4(
-                axis=axis,
-                input1_id=vals_to_ids[list_of_tensors[0]],
-                input2_id=vals_to_ids[list_of_tensors[1]],
-                input3_id=vals_to_ids[list_of_tensors[2]],
-                input4_id=vals_to_ids[list_of_tensors[3]],
-                output_id=vals_to_ids[node],
-                flags=0,
+        input_ids = [vals_to_ids[tensor] for tensor in list_of_tensors]
+        check_or_raise(
+            num_tensors_to_cat >= 2,
+            "XNNPACK Unsupported number of tensors for concatenation",
+        )
+        if num_tensors_to_cat > 4:
+            # XNNPACK concatenates up to 4 tensors at once, so concatenate the
+            # first 4 into an intermediate value until at most 4 are left
+            check_or_raise(
+                QuantParams.from_outputs(node) is None,
+                "XNNPACK can not concatenate more than 4 quantized tensors",
             )
-        else:
-            raise ValueError("XNNPACK Unsupported number of tensors for concatenation")
+            dtype = self.get_float_dtype(node)
+            while len(input_ids) > 4:
+                dims = list(get_tensor_value(xnn_graph.xvalues[input_ids[0]]).dims)
+                concat_axis = axis % len(dims)
+                dims[concat_axis] = sum(
+                    get_tensor_value(xnn_graph.xvalues[input_id]).dims[concat_axis]
+                    for input_id in input_ids[:4]
+                )
+                partial_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+                xnn_graph.xnodes.append(
+                    XNode(
+                        xnode_union=self.concatenate(axis, input_ids[:4], partial_id),
+                        debug_handle=debug_handle,
+                    )
+                )
+                input_ids = [partial_id] + input_ids[4:]
+
+        xnode = self.concatenate(axis, input_ids, vals_to_ids[node])
 
         ser_node = XNode(
             xnode_union=xnode,
             debug_handle=debug_handle,
         )
         xnn_graph.xnodes.append(ser_node)
+
+    @staticmethod
+    def concatenate(
+        axis: int, input_ids: List[int], output_id: int
+    ) -> Union[XNNConcatenate2, XNNConcatenate3, XNNConcatenate4]:
+        """
+        Concatenate node of 2 - 4 inputs
+        """
+        concatenate_type = {
+            2: XNNConcatenate2,
+            3: XNNConcatenate3,
+            4: XNNConcatenate4,
+        }[len(input_ids)]
+        padded_ids = input_ids + [XNN_INVALID_VALUE_ID] * (4 - len(input_ids))
+        return concatenate_type(
+            axis=axis,
+            input1_id=padded_ids[0],
+            input2_id=padded_ids[1],
+            input3_id=padded_ids[2],
+            input4_id=padded_ids[3],
+            output_id=output_id,
+            flags=0,
+        )
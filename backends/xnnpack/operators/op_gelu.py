@@ -0,0 +1,86 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import math
+from typing import Dict
+
+import torch
+from executorch.backends.xnnpack.operators.node_visitor import (
+    get_tensor_value,
+    NodeVisitor,
+    register_node_visitor,
+)
+from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
+    XNNAdd,
+    XNNGraph,
+    XNNMultiply,
+    XNNSigmoid,
+    XNNSquare,
+    XNode,
+)
+from executorch.backends.xnnpack.utils.utils import check_or_raise, get_input_node
+
+
+@register_node_visitor
+class Gelu(NodeVisitor):
+    """
+    XNNPACK has no GELU node. The tanh approximation of GELU,
+    0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))), equals
+    x * sigmoid(x * (c1 + c2 * x^2)) with c1 = 2 * sqrt(2 / pi) and
+    c2 = 0.044715 * c1, which is lowered as six XNNPACK nodes. The exact GELU
+    needs erf, which XNNPACK lacks, so it is not supported.
+    """
+
+    target = "aten.gelu.default"
+
+    def __init__(self, *args) -> None:
+        super().__init__(*args)
+
+    def define_node(
+        self,
+        node: torch.fx.Node,
+        xnn_graph: XNNGraph,
+        vals_to_ids: Dict[torch.fx.Node, int],
+        debug_handle: int,
+    ) -> None:
+        check_or_raise(
+            node.kwargs.get("approximate", "none") == "tanh",
+            "XNNPACK only supports the tanh approximation of gelu",
+        )
+        self.define_nodes_tensor_inputs_outputs(node, xnn_graph, vals_to_ids)
+
+        # input
+        input_id = vals_to_ids[get_input_node(node, 0)]
+
+        # output
+        output_id = vals_to_ids[node]
+
+        dtype = self.get_float_dtype(node)
+        dims = get_tensor_value(xnn_graph.xvalues[input_id]).dims
+        c1 = 2.0 * math.sqrt(2.0 / math.pi)
+        c1_id = self.define_scalar_constant(xnn_graph, c1, dtype)
+        c2_id = self.define_scalar_constant(xnn_graph, 0.044715 * c1, dtype)
+        square_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+        cubic_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+        factor_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+        inner_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+        sigmoid_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+
+        for xnode in (
+            XNNSquare(input_id=input_id, output_id=square_id, flags=0),
+            XNNMultiply(
+                input1_id=square_id, input2_id=c2_id, output_id=cubic_id, flags=0
+            ),
+            XNNAdd(input1_id=cubic_id, input2_id=c1_id, output_id=factor_id, flags=0),
+            XNNMultiply(
+                input1_id=factor_id, input2_id=input_id, output_id=inner_id, flags=0
+            ),
+            XNNSigmoid(input_id=inner_id, output_id=sigmoid_id, flags=0),
+            XNNMultiply(
+                input1_id=input_id, input2_id=sigmoid_id, output_id=output_id, flags=0
+            ),
+        ):
+            xnn_graph.xnodes.append(XNode(xnode_union=xnode, debug_handle=debug_handle))
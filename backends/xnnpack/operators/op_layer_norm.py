@@ -0,0 +1,161 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import math
+from typing import cast, Dict, List, Optional
+
+import torch
+from executorch.backends.xnnpack.operators.node_visitor import (
+    NodeVisitor,
+    register_node_visitor,
+)
+from executorch.backends.xnnpack.operators.quant_params import QuantParams
+from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
+    XNNAdd,
+    XNNDiv,
+    XNNGlobalAvgPooling2d,
+    XNNGraph,
+    XNNMultiply,
+    XNNSquare,
+    XNNSquareRoot,
+    XNNStaticReshape,
+    XNNSubtract,
+    XNode,
+)
+from executorch.backends.xnnpack.utils.utils import check_or_raise, get_input_node
+
+
+@register_node_visitor
+class LayerNorm(NodeVisitor):
+    """
+    XNNPACK has no layer norm node. The input is reshaped to
+    [outer, 1, inner, 1], so that global average pooling computes the mean and
+    the variance over the normalized dimensions, and normalized with
+    elementwise nodes before the optional affine transform. Only the
+    normalized output may be used, not the mean or rstd outputs.
+    """
+
+    target = "aten.native_layer_norm.default"
+
+    def __init__(self, *args) -> None:
+        super().__init__(*args)
+
+    def define_node(
+        self,
+        node: torch.fx.Node,
+        xnn_graph: XNNGraph,
+        vals_to_ids: Dict[torch.fx.Node, int],
+        debug_handle: int,
+    ) -> None:
+        users = list(node.users.keys())
+        check_or_raise(
+            len(users) == 1 and users[0].args[1] == 0,
+            "XNNPACK only supports using the normalized output of layer norm",
+        )
+        output_node = users[0]
+
+        # input
+        input_node = get_input_node(node, 0)
+        self.define_tensor(
+            input_node,
+            xnn_graph,
+            vals_to_ids,
+            quant_params=QuantParams.from_inputs(input_node, self._exported_program),
+        )
+        input_id = vals_to_ids[input_node]
+
+        # weight and bias
+        affine_ids: List[Optional[int]] = []
+        for i in (2, 3):
+            param = node.args[i] if len(node.args) > i else None
+            if param is None:
+                affine_ids.append(None)
+                continue
+            param = cast(torch.fx.Node, param)
+            self.define_tensor(param, xnn_graph, vals_to_ids)
+            affine_ids.append(vals_to_ids[param])
+        weight_id, bias_id = affine_ids
+
+        # output, through the getitem that the skipped getitem visitor leaves
+        self.define_tensor(output_node, xnn_graph, vals_to_ids)
+        output_id = vals_to_ids[output_node]
+
+        input_shape = list(input_node.meta["val"].shape)
+        normalized_shape = cast(List[int], node.args[1])
+        split = len(input_shape) - len(normalized_shape)
+        outer = math.prod(input_shape[:split])
+        inner = math.prod(input_shape[split:])
+        eps = cast(float, node.args[4])
+
+        dtype = self.get_float_dtype(node)
+        eps_id = self.define_scalar_constant(xnn_graph, eps, dtype)
+        rows = [outer, 1, inner, 1]
+        stats = [outer, 1, 1, 1]
+        rows_id = self.define_intermediate_tensor(xnn_graph, rows, dtype)
+        mean_id = self.define_intermediate_tensor(xnn_graph, stats, dtype)
+        centered_id = self.define_intermediate_tensor(xnn_graph, rows, dtype)
+        squared_id = self.define_intermediate_tensor(xnn_graph, rows, dtype)
+        var_id = self.define_intermediate_tensor(xnn_graph, stats, dtype)
+        var_eps_id = self.define_intermediate_tensor(xnn_graph, stats, dtype)
+        std_id = self.define_intermediate_tensor(xnn_graph, stats, dtype)
+        normalized_id = self.define_intermediate_tensor(xnn_graph, rows, dtype)
+
+        xnodes = [
+            XNNStaticReshape(
+                num_dims=4,
+                new_shape=rows,
+                input_id=input_id,
+                output_id=rows_id,
+                flags=0,
+            ),
+            XNNGlobalAvgPooling2d(input_id=rows_id, output_id=mean_id, flags=0),
+            XNNSubtract(
+                input1_id=rows_id, input2_id=mean_id, output_id=centered_id, flags=0
+            ),
+            XNNSquare(input_id=centered_id, output_id=squared_id, flags=0),
+            XNNGlobalAvgPooling2d(input_id=squared_id, output_id=var_id, flags=0),
+            XNNAdd(input1_id=var_id, input2_id=eps_id, output_id=var_eps_id, flags=0),
+            XNNSquareRoot(input_id=var_eps_id, output_id=std_id, flags=0),
+            XNNDiv(
+                input1_id=centered_id,
+                input2_id=std_id,
+                output_id=normalized_id,
+                flags=0,
+            ),
+        ]
+
+        # Back to the input shape, then scale and shift, writing the output
+        # with the last node
+        steps = [(XNNMultiply, weight_id), (XNNAdd, bias_id)]
+        steps = [(op, param_id) for op, param_id in steps if param_id is not None]
+        reshaped_id = (
+            output_id
+            if not steps
+            else self.define_intermediate_tensor(xnn_graph, input_shape, dtype)
+        )
+        xnodes.append(
+            XNNStaticReshape(
+                num_dims=len(input_shape),
+                new_shape=input_shape,
+                input_id=normalized_id,
+                output_id=reshaped_id,
+                flags=0,
+            )
+        )
+        current_id = reshaped_id
+        for i, (op, param_id) in enumerate(steps):
+            next_id = (
+                output_id
+                if i == len(steps) - 1
+                else self.define_intermediate_tensor(xnn_graph, input_shape, dtype)
+            )
+            xnodes.append(
+                op(input1_id=current_id, input2_id=param_id, output_id=next_id, flags=0)
+            )
+            current_id = next_id
+
+        for xnode in xnodes:
+            xnn_graph.xnodes.append(XNode(xnode_union=xnode, debug_handle=debug_handle))
@@ -4,7 +4,8 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
-from typing import cast, Dict, List
+import math
+from typing import cast, Dict
 
 import torch
 from executorch.backends.xnnpack.operators.node_visitor import (
@@ -16,17 +17,24 @@ from executorch.backends.xnnpack.operators.node_visitor import (
 from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
     XNNGlobalAvgPooling2d,
     XNNGraph,
+    XNNStaticReshape,
     XNode,
 )
+from executorch.backends.xnnpack.utils.utils import (
+    get_input_node,
+    get_mean_trailing_dims,
+    is_spatial_mean,
+)
 
 
 @register_node_visitor
 class MeanDim(NodeVisitor):
     """
-    XNNPACK only supports a special case of mean dim in which the operation can be written
-    as Global Average Pooling. In order to be handled by xnnpack the input tensor must be 4d,
-    the dimensions to reduce must be the two innermost (-1, -2) or (-2, -1). and the flag
-    for keepdim must be set to True.
+    XNNPACK only supports mean dim as Global Average Pooling. A mean over the two
+    innermost dimensions (-1, -2) or (-2, -1) of a 4d tensor that keeps dims is
+    pooled over the NHWC tensor. Any other mean over the innermost dimensions
+    reshapes the input to [outer, 1, inner, 1], pools that and reshapes the
+    result to the output shape.
     """
 
     target = "aten.mean.dim"
@@ -41,6 +49,10 @@ class MeanDim(NodeVisitor):
         vals_to_ids: Dict[torch.fx.Node, int],
         debug_handle: int,
     ) -> None:
+        if not is_spatial_mean(node):
+            self.define_trailing_mean(node, xnn_graph, vals_to_ids, debug_handle)
+            return
+
         self.define_nodes_tensor_inputs_outputs(
             node, xnn_graph, vals_to_ids, convert_to_nhwc=True
         )
@@ -50,19 +62,6 @@ class MeanDim(NodeVisitor):
         # output
         output_id = vals_to_ids[node]
 
-        # mean dims
-        mean_dims = cast(List[int], node.args[1])
-        check_or_raise(
-            mean_dims == [-1, -2] or mean_dims == [-2, -1],
-            "XNNPACK only supports mean.dim across the innermost dimensions",
-        )
-
-        # keep dims
-        check_or_raise(
-            len(node.args) == 3 and bool(node.args[2]),
-            "XNNPACK only supports mean.dim that keeps dims",
-        )
-
         input_shape = get_tensor_value(xnn_graph.xvalues[input_id]).dims
         check_or_raise(
             len(input_shape) == 4, "Require input to mean.dim be 4 dimensional"
@@ -75,3 +74,57 @@ class MeanDim(NodeVisitor):
             debug_handle=debug_handle,
         )
         xnn_graph.xnodes.append(ser_node)
+
+    def define_trailing_mean(
+        self,
+        node: torch.fx.Node,
+        xnn_graph: XNNGraph,
+        vals_to_ids: Dict[torch.fx.Node, int],
+        debug_handle: int,
+    ) -> None:
+        num_dims = get_mean_trailing_dims(node)
+        check_or_raise(
+            num_dims is not None,
+            "XNNPACK only supports mean.dim across the innermost dimensions",
+        )
+        self.define_nodes_tensor_inputs_outputs(node, xnn_graph, vals_to_ids)
+
+        # input
+        input_node = get_input_node(node, 0)
+        input_id = vals_to_ids[input_node]
+
+        # output
+        output_id = vals_to_ids[node]
+
+        input_shape = list(input_node.meta["val"].shape)
+        split = len(input_shape) - cast(int, num_dims)
+        outer = math.prod(input_shape[:split])
+        inner = math.prod(input_shape[split:])
+        output_shape = list(node.meta["val"].shape) or [1]
+
+        dtype = self.get_float_dtype(node)
+        pooling_input_id = self.define_intermediate_tensor(
+            xnn_graph, [outer, 1, inner, 1], dtype
+        )
+        pooled_id = self.define_intermediate_tensor(xnn_graph, [outer, 1, 1, 1], dtype)
+
+        for xnode in (
+            XNNStaticReshape(
+                num_dims=4,
+                new_shape=[outer, 1, inner, 1],
+                input_id=input_id,
+                output_id=pooling_input_id,
+                flags=0,
+            ),
+            XNNGlobalAvgPooling2d(
+                input_id=pooling_input_id, output_id=pooled_id, flags=0
+            ),
+            XNNStaticReshape(
+                num_dims=len(output_shape),
+                new_shape=output_shape,
+                input_id=pooled_id,
+                output_id=output_id,
+                flags=0,
+            ),
+        ):
+            xnn_graph.xnodes.append(XNode(xnode_union=xnode, debug_handle=debug_handle))
@@ -0,0 +1,71 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from typing import Dict
+
+import torch
+from executorch.backends.xnnpack.operators.node_visitor import (
+    get_tensor_value,
+    NodeVisitor,
+    register_node_visitor,
+)
+from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
+    XNNGraph,
+    XNNMultiply,
+    XNNSigmoid,
+    XNNSubtract,
+    XNode,
+)
+from executorch.backends.xnnpack.utils.utils import get_input_node
+
+
+@register_node_visitor
+class Tanh(NodeVisitor):
+    """
+    XNNPACK has no tanh node, so tanh is lowered as 2 * sigmoid(2 * x) - 1
+    """
+
+    target = "aten.tanh.default"
+
+    def __init__(self, *args) -> None:
+        super().__init__(*args)
+
+    def define_node(
+        self,
+        node: torch.fx.Node,
+        xnn_graph: XNNGraph,
+        vals_to_ids: Dict[torch.fx.Node, int],
+        debug_handle: int,
+    ) -> None:
+        self.define_nodes_tensor_inputs_outputs(node, xnn_graph, vals_to_ids)
+
+        # input
+        input_id = vals_to_ids[get_input_node(node, 0)]
+
+        # output
+        output_id = vals_to_ids[node]
+
+        dtype = self.get_float_dtype(node)
+        dims = get_tensor_value(xnn_graph.xvalues[input_id]).dims
+        two_id = self.define_scalar_constant(xnn_graph, 2.0, dtype)
+        one_id = self.define_scalar_constant(xnn_graph, 1.0, dtype)
+        doubled_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+        sigmoid_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+        scaled_id = self.define_intermediate_tensor(xnn_graph, dims, dtype)
+
+        for xnode in (
+            XNNMultiply(
+                input1_id=input_id, input2_id=two_id, output_id=doubled_id, flags=0
+            ),
+            XNNSigmoid(input_id=doubled_id, output_id=sigmoid_id, flags=0),
+            XNNMultiply(
+                input1_id=sigmoid_id, input2_id=two_id, output_id=scaled_id, flags=0
+            ),
+            XNNSubtract(
+                input1_id=scaled_id, input2_id=one_id, output_id=output_id, flags=0
+            ),
+        ):
+            xnn_graph.xnodes.append(XNode(xnode_union=xnode, debug_handle=debug_handle))
@@ -40,6 +40,8 @@ class QuantParams:
         qmax: quantization maximum
         is_output: whether this is an output node or not
         is_input: whether this is an input node or not
+        group_size: for blockwise quantization of 2D weights, the number of
+            consecutive input channels that share a scale; 0 otherwise
     """
 
     def __init__(
@@ -55,6 +57,7 @@ class QuantParams:
         is_output: bool,
         is_input: bool,
         is_dynamic: bool = False,
+        group_size: int = 0,
     ) -> None:
         self.per_channel = per_channel
         self.q_input = q_input
@@ -67,8 +70,22 @@ class QuantParams:
         self.is_output = is_output
         self.is_input = is_input
         self.is_dynamic = is_dynamic
+        self.group_size = group_size
 
     def quantize_tensor(self, tensor: torch.Tensor) -> torch.Tensor:
+        if self.group_size > 0:
+            # scale and zp hold one entry per group of each output channel
+            scale = cast(torch.Tensor, self.scale).reshape(-1, 1)
+            zp = cast(torch.Tensor, self.zp).reshape(-1, 1)
+            groups = tensor.to(torch.float32).reshape(-1, self.group_size)
+            assert (
+                groups.shape[0] == scale.shape[0]
+            ), f"Invalid number of group quantization scales, group_size: {self.group_size}, scale size: {scale.shape}, tensor shape: {tensor.shape}"
+            quantized = torch.clamp(
+                torch.round(groups / scale) + zp, self.qmin, self.qmax
+            )
+            return quantized.to(self.dtype).reshape(tensor.shape)
+
         if self.per_channel:
             assert (
                 tensor.shape[self.axis] == cast(torch.Tensor, self.scale).shape[0]
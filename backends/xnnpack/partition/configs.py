@@ -62,6 +62,9 @@ SUPPORTED_OPS = [
     exir_ops.edge.aten.elu.default,
     exir_ops.edge.aten.avg_pool2d.default,
     exir_ops.edge.aten.leaky_relu.default,
+    exir_ops.edge.aten.tanh.default,
+    exir_ops.edge.aten.gelu.default,
+    exir_ops.edge.aten.native_layer_norm.default,
     exir_ops.edge.aten.addmm.default,  # TODO(T163877189) add constraint for addmm
 ]
 
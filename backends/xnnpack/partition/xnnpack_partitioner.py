@@ -20,7 +20,12 @@ from executorch.backends.xnnpack.partition.configs import (
     UNSUPPORTED_QUANT_MODULES,
 )
 from executorch.backends.xnnpack.partition.graphs.bilinear_2d import bilinear2d_graphs
-from executorch.backends.xnnpack.utils.utils import get_input_node, is_param_node
+from executorch.backends.xnnpack.utils.utils import (
+    get_input_node,
+    get_mean_trailing_dims,
+    is_param_node,
+    is_spatial_mean,
+)
 from executorch.backends.xnnpack.xnnpack_preprocess import XnnpackBackend
 
 from executorch.exir.backend.canonical_partitioners.pattern_op_partitioner import (
@@ -28,6 +33,7 @@ from executorch.exir.backend.canonical_partitioners.pattern_op_partitioner impor
     generate_pattern_op_partitions,
 )
 
+from executorch.exir.backend.compile_spec_schema import CompileSpec
 from executorch.exir.backend.partitioner import (
     DelegationSpec,
     Partitioner,
@@ -157,10 +163,30 @@ class XnnpackOperatorSupport(OperatorSupportBase):
     @_constraint(exir_ops.edge.aten.mean.dim)
     def mean_dim(node: torch.fx.Node, ep: ExportedProgram) -> bool:  # noqa
         """
-        Only select 2d cases are supported by XNNPACK
+        Only means over the innermost dimensions are supported by XNNPACK
+        """
+        if node.kwargs.get("dtype", None) is not None:
+            return False
+        return is_spatial_mean(node) or get_mean_trailing_dims(node) is not None
+
+    @_constraint(exir_ops.edge.aten.gelu.default)
+    def gelu(node: torch.fx.Node, ep: ExportedProgram) -> bool:  # noqa
+        """
+        Only the tanh approximation, since XNNPACK has no erf
+        """
+        return node.kwargs.get("approximate", "none") == "tanh"
+
+    @_constraint(exir_ops.edge.aten.native_layer_norm.default)
+    def layer_norm(node: torch.fx.Node, ep: ExportedProgram) -> bool:  # noqa
+        """
+        Only if the normalized output is consumed, not the mean or rstd
         """
-        dims = node.args[1]
-        return dims in ([-2, -1], [-1, -2])
+        users = list(node.users.keys())
+        return (
+            len(users) == 1
+            and users[0].target == operator.getitem
+            and users[0].args[1] == 0
+        )
 
     @_constraint(exir_ops.edge.aten.max_pool2d_with_indices.default)
     def maxpool2d_with_indices(
@@ -287,10 +313,15 @@ class XnnpackOperatorSupport(OperatorSupportBase):
     @_constraint(exir_ops.edge.aten.cat.default)
     def cat(node: torch.fx.Node, ep: ExportedProgram) -> bool:  # noqa
         """
-        Only support concatenation of 2 - 4 tensors
+        Support concatenation of 2 - 4 tensors, and of more float tensors
+        through intermediate concatenations
         """
-        num_tensors = len(cast(List[torch.fx.Node], node.args[0]))
-        return num_tensors >= 2 and num_tensors <= 4
+        tensors = cast(List[torch.fx.Node], node.args[0])
+        if len(tensors) <= 4:
+            return len(tensors) >= 2
+        return not any(
+            tensor.target in XnnpackQuantizedPartitioner._DQ_OPS for tensor in tensors
+        )
 
     @_constraint(exir_ops.edge.aten.slice_copy.Tensor)
     def slice_copy(node: torch.fx.Node, ep: ExportedProgram) -> bool:  # noqa
@@ -332,13 +363,16 @@ class XnnpackFloatingPointPartitioner(Partitioner):
         supported_modules: List[Callable] = SUPPORTED_MODULES,
         supported_ops: Optional[List[Callable]] = SUPPORTED_OPS,
         unsupported_modules: Optional[List[Callable]] = None,
+        compile_specs: Optional[List[CompileSpec]] = None,
     ):
         super().__init__()
         self.supported_modules = set(supported_modules)
         self.unsupported_modules = unsupported_modules
         self.supported_ops = set(supported_ops or [])
 
-        self.delegation_spec = DelegationSpec(XnnpackBackend.__name__, [])
+        self.delegation_spec = DelegationSpec(
+            XnnpackBackend.__name__, compile_specs or []
+        )
 
     @staticmethod
     def check_partitions(partitions: Union[dict, list]) -> bool:
@@ -600,6 +634,7 @@ class XnnpackPartitioner(Partitioner):
         supported_quant_modules: List[Callable] = SUPPORTED_QUANT_MODULES,
         supported_quant_ops: Optional[List[Callable]] = SUPPORTED_QUANT_OPS,
         quant: Optional[bool] = None,
+        compile_specs: Optional[List[CompileSpec]] = None,
     ):
         super().__init__()
         self.supported_modules = set(supported_modules)
@@ -610,7 +645,9 @@ class XnnpackPartitioner(Partitioner):
 
         self.quant = quant
 
-        self.delegation_spec = DelegationSpec(XnnpackBackend.__name__, [])
+        self.delegation_spec = DelegationSpec(
+            XnnpackBackend.__name__, compile_specs or []
+        )
         self.partition_tags: Dict[str, DelegationSpec] = {}
 
     def get_supported_modules(self, quant: bool) -> Set[Callable]:
@@ -8,7 +8,7 @@ from typing import Optional, Tuple
 
 import torch
 from executorch.backends.xnnpack.passes.xnnpack_pass import XNNPACKPass
-from executorch.backends.xnnpack.utils.utils import is_param_node
+from executorch.backends.xnnpack.utils.utils import is_param_node, is_spatial_mean
 from executorch.exir.dialects._ops import ops as exir_ops
 from executorch.exir.pass_base import PassResult
 
@@ -57,6 +57,7 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
         "output",
         exir_ops.edge.aten.squeeze_copy.dim,
         exir_ops.edge.aten.unsqueeze_copy.default,
+        exir_ops.edge.aten.native_layer_norm.default,
     }
 
     # Tag which is added to a node's meta to indicate that it uses NHWC format.
@@ -89,9 +90,14 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
         return not self.is_nhwc_node(node)
 
     def requires_nhwc_input(self, node: torch.fx.Node) -> bool:
+        if node.target == exir_ops.edge.aten.mean.dim:
+            # Only means over H and W pool the NHWC tensor
+            return is_spatial_mean(node)
         return node.target in self.memory_sensitive_ops_nhwc
 
     def requires_nchw_inputs(self, node: torch.fx.Node) -> bool:
+        if node.target == exir_ops.edge.aten.mean.dim:
+            return not is_spatial_mean(node)
         return node.target in self.memory_sensitive_ops_nchw
 
     def can_be_converted_to_nhwc(self, node: torch.fx.Node) -> bool:
@@ -7,9 +7,12 @@
  */
 
 #include <executorch/backends/xnnpack/runtime/XNNCompiler.h>
+#include <executorch/backends/xnnpack/runtime/XNNSubgraphCache.h>
 #include <executorch/backends/xnnpack/schema_generated.h>
 #include <executorch/backends/xnnpack/threadpool/threadpool.h>
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <cstdio>
+#include <mutex>
 #include <unordered_map>
 
 namespace torch {
@@ -65,6 +68,10 @@ xnn_datatype getDataType(const DataType& data_type) {
       return xnn_datatype::xnn_datatype_qcint8;
     case DataType::xnn_datatype_qcint32:
       return xnn_datatype::xnn_datatype_qcint32;
+#ifdef ENABLE_XNNPACK_QB4W
+    case DataType::xnn_datatype_qbint4:
+      return xnn_datatype::xnn_datatype_qbint4;
+#endif
     default:
       return xnn_datatype::xnn_datatype_invalid;
   }
@@ -100,6 +107,73 @@ std::vector<T> flatbufferDimsToVector(
   return dims_data;
 }
 
+/**
+Returns the tensor value of a serialized value, or nullptr if it is neither a
+tensor nor a quantized tensor.
+*/
+const fb_xnnpack::XNNTensorValue* getTensorValue(ValuePtr value) {
+  switch (value->xvalue_union_type()) {
+    case fb_xnnpack::XValueUnion::XNNTensorValue:
+      return value->xvalue_union_as_XNNTensorValue();
+    case fb_xnnpack::XValueUnion::XNNQuantizedTensorValue:
+      return value->xvalue_union_as_XNNQuantizedTensorValue()->tensor_value();
+    default:
+      return nullptr;
+  }
+}
+
+/**
+Does the executor's share of defining a tensor value that XNNPACK gave the
+id `id`: allocates the buffer that a dynamically quantized input is
+quantized into, and records external values as args. This is all that is
+left to do per delegate when the subgraph itself comes from a cache.
+*/
+Error wireTensor(
+    ValuePtr value,
+    uint32_t id,
+    XNNExecutor* executor,
+    MemoryAllocator* runtime_allocator) {
+  const fb_xnnpack::XNNTensorValue* tensor_value = getTensorValue(value);
+  ET_CHECK_OR_RETURN_ERROR(
+      tensor_value != nullptr,
+      Internal,
+      "Deserialized Tensor is Null, this should never happen");
+  if (value->xvalue_union_type() == fb_xnnpack::XValueUnion::XNNTensorValue &&
+      getDataType(tensor_value->dq_datatype()) ==
+          xnn_datatype::xnn_datatype_qint8) {
+    // TODO DD
+    // Refactor this into,
+    // Tensor = createTensor<dtype>(allocator, tensor_value);
+
+    std::vector<exec_aten::SizesType> input_shape =
+        flatbufferDimsToVector<exec_aten::SizesType>(tensor_value->dims());
+    auto qinput_tensor =
+        ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(runtime_allocator, TensorImpl);
+    new (qinput_tensor) TensorImpl(
+        ScalarType::QInt8,
+        input_shape.size(),
+        input_shape.data(),
+        /*data=*/nullptr);
+
+    // Add post padding to make xnnpack happy
+    constexpr size_t post_pad_bytes = XNN_EXTRA_BYTES;
+    void* qinput_storage = ET_ALLOCATE_OR_RETURN_ERROR(
+        runtime_allocator,
+        sizeof_scalar_type(ScalarType::QInt8) * qinput_tensor->numel() +
+            post_pad_bytes);
+    qinput_tensor->set_data(static_cast<int8_t*>(qinput_storage));
+
+    executor->addDynamicQinput(id, qinput_tensor);
+  }
+
+  // Append this external id to the arg list for execute(*args) to extract from
+  // as args[external_id]
+  if (tensor_value->external_id() != XNN_INVALID_VALUE_ID) {
+    executor->append_arg(tensor_value->external_id());
+  }
+  return Error::Ok;
+}
+
 /**
 Define serialized tensor value into
 the subgraph. While also keeping track of the remapped ids from
@@ -214,30 +288,6 @@ Error defineTensor(
               /*flags=*/tensor_value->flags(),
               /*id_out=*/&id);
 
-          // TODO DD
-          // Refactor this into,
-          // Tensor = createTensor<dtype>(allocator, tensor_value);
-
-          std::vector<exec_aten::SizesType> input_shape =
-              flatbufferDimsToVector<exec_aten::SizesType>(
-                  tensor_value->dims());
-          auto qinput_tensor = ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(
-              runtime_allocator, TensorImpl);
-          new (qinput_tensor) TensorImpl(
-              ScalarType::QInt8,
-              input_shape.size(),
-              input_shape.data(),
-              /*data=*/nullptr);
-
-          // Add post padding to make xnnpack happy
-          constexpr size_t post_pad_bytes = XNN_EXTRA_BYTES;
-          void* qinput_storage = ET_ALLOCATE_OR_RETURN_ERROR(
-              runtime_allocator,
-              sizeof_scalar_type(ScalarType::QInt8) * qinput_tensor->numel() +
-                  post_pad_bytes);
-          qinput_tensor->set_data(static_cast<int8_t*>(qinput_storage));
-
-          executor->addDynamicQinput(id, qinput_tensor);
           break;
         }
         default:
@@ -295,6 +345,47 @@ Error defineTensor(
             /*id_out=*/&id);
         break;
       }
+      case fb_xnnpack::XNNQuantParams::PerChannelGroupQuant: {
+#ifdef ENABLE_XNNPACK_QB4W
+        auto qparams = qtensor_value->quant_params_as_PerChannelGroupQuant();
+        ET_CHECK_OR_RETURN_ERROR(
+            tensor_value->num_dims() == 2 && qparams->channel_dim() == 0 &&
+                qparams->group_size() > 0 &&
+                dims_data[1] % qparams->group_size() == 0 &&
+                qparams->scale_bf16()->size() ==
+                    dims_data[0] * (dims_data[1] / qparams->group_size()),
+            InvalidProgram,
+            "Blockwise quantized tensor %u must be 2D with one scale per "
+            "group of input channels",
+            tensor_value->id_out());
+        ET_LOG(
+            Debug,
+            "define quant tensor (per channel group): buffer_ptr: %p, scale.numel(): %u, group_size: %d\n",
+            buffer_ptr,
+            qparams->scale_bf16()->size(),
+            qparams->group_size());
+        status = xnn_define_blockwise_quantized_tensor_value(
+            /*subgraph=*/subgraph_ptr,
+            /*datatype=*/getDataType(tensor_value->datatype()),
+            /*zero_point=*/8,
+            /*scale=*/qparams->scale_bf16()->data(),
+            /*num_dims=*/tensor_value->num_dims(),
+            /*channel_dim=*/qparams->channel_dim(),
+            /*block_size=*/qparams->group_size(),
+            /*dims=*/dims_data.data(),
+            /*data=*/buffer_ptr,
+            /*external_id=*/tensor_value->external_id(),
+            /*flags=*/tensor_value->flags(),
+            /*id_out=*/&id);
+        break;
+#else
+        ET_CHECK_OR_RETURN_ERROR(
+            false,
+            NotSupported,
+            "4-bit blockwise quantized tensors need a build with "
+            "ENABLE_XNNPACK_QB4W");
+#endif
+      }
       default: {
         ET_CHECK_OR_RETURN_ERROR(
             false,
@@ -315,13 +406,8 @@ Error defineTensor(
 
   // map serialized id to newly generated id
   remapped_ids.emplace(std::make_pair(tensor_value->id_out(), id));
-  // Append this external id to the arg list for execute(*args) to extract from
-  // as args[external_id]
-  if (tensor_value->external_id() != XNN_INVALID_VALUE_ID) {
-    executor->append_arg(tensor_value->external_id());
-  }
 
-  return Error::Ok;
+  return wireTensor(value, id, executor, runtime_allocator);
 };
 
 /*
@@ -1413,6 +1499,41 @@ DefineNodeFunc getDefineNodeFunc(fb_xnnpack::XNodeUnion nodeType) {
 }
 #undef _DEFINE
 
+/*
+Allocates the int32 buffer that XNNPACK writes the serialized value `old_id`
+into, if it is an external output of the graph.
+*/
+Error planInt32Output(
+    uint32_t old_id,
+    const std::unordered_map<uint32_t, uint32_t>& remapped_ids,
+    GraphPtr flatbuffer_graph,
+    XNNExecutor* executor,
+    MemoryAllocator* runtime_allocator) {
+  const fb_xnnpack::XNNTensorValue* tensor_value = nullptr;
+  for (auto value : *flatbuffer_graph->xvalues()) {
+    if (value->xvalue_union_type() ==
+            fb_xnnpack::XValueUnion::XNNTensorValue &&
+        value->xvalue_union_as_XNNTensorValue()->id_out() == old_id) {
+      tensor_value = value->xvalue_union_as_XNNTensorValue();
+      break;
+    }
+  }
+  if (tensor_value == nullptr ||
+      !(tensor_value->flags() & XNN_VALUE_FLAG_EXTERNAL_OUTPUT)) {
+    return Error::Ok;
+  }
+
+  size_t numel = 1;
+  for (auto dim : *tensor_value->dims()) {
+    numel *= dim;
+  }
+  // Add post padding to make xnnpack happy
+  int32_t* buffer = static_cast<int32_t*>(ET_ALLOCATE_OR_RETURN_ERROR(
+      runtime_allocator, numel * sizeof(int32_t) + XNN_EXTRA_BYTES));
+  executor->addInt32Output(remapped_ids.at(old_id), {buffer, numel});
+  return Error::Ok;
+}
+
 /*
 Builds the xnnpack runtime object using the buffer pointer. The buffer pointer
 must be a valid pointer to the serialized xnnpack object. It also fills the
@@ -1422,7 +1543,8 @@ __ET_NODISCARD Error XNNCompiler::compileModel(
     const void* buffer_pointer,
     size_t num_bytes,
     XNNExecutor* executor,
-    MemoryAllocator* runtime_allocator) {
+    MemoryAllocator* runtime_allocator,
+    const XNNCompileOptions& options) {
   ET_CHECK_OR_RETURN_ERROR(
       fb_xnnpack::XNNGraphBufferHasIdentifier(buffer_pointer),
       DelegateInvalidCompatibility,
@@ -1430,6 +1552,23 @@ __ET_NODISCARD Error XNNCompiler::compileModel(
       flatbuffers::GetBufferIdentifier(buffer_pointer),
       fb_xnnpack::XNNGraphIdentifier());
 
+  std::shared_ptr<XNNSubgraphCache> subgraph_cache;
+  std::unique_lock<std::mutex> subgraph_cache_lock;
+  if (options.cache_subgraph) {
+    subgraph_cache = XNNSubgraphCache::get_or_create(
+        buffer_pointer, num_bytes, options.mapped_buffer);
+    if (subgraph_cache != nullptr) {
+      subgraph_cache_lock =
+          std::unique_lock<std::mutex>(subgraph_cache->mutex());
+      // Read the cache's copy of the graph, which the subgraph's static
+      // values point into and which outlives `buffer_pointer`.
+      buffer_pointer = subgraph_cache->buffer();
+      executor->subgraph_cache_ = subgraph_cache;
+    }
+  }
+  const bool use_cached_subgraph =
+      subgraph_cache != nullptr && subgraph_cache->is_built();
+
   auto flatbuffer_graph = fb_xnnpack::GetXNNGraph(buffer_pointer);
   // initialize xnnpack
   xnn_status status = xnn_initialize(/*allocator =*/nullptr);
@@ -1439,74 +1578,182 @@ __ET_NODISCARD Error XNNCompiler::compileModel(
       "XNN Initialize failed with code: %s",
       xnn_status_to_string(status));
 
-  // create xnnpack subgraph
-  xnn_subgraph_t subgraph_ptr = nullptr;
-  status = xnn_create_subgraph(
-      /*external_value_ids=*/flatbuffer_graph->num_externs(),
-      /*flags=*/0,
-      &subgraph_ptr);
-  ET_CHECK_OR_RETURN_ERROR(
-      xnn_status_success == status,
-      Internal,
-      "XNN Subgraph creation failed with code: %s",
-      xnn_status_to_string(status));
-
-  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> subgraph(
-      subgraph_ptr, &xnn_delete_subgraph);
-
+  XNNSubgraphCache::SubgraphPtr subgraph(nullptr, &xnn_delete_subgraph);
   // mapping from old ids to new created value ids
   // The old ids that were serialied were generated AoT, since
   // we are re-defining tensor values, the defined IDs could be
   // different from the ones generated AoT, as a result, we need
   // a new mapping from the old ids to the newly created ones
-  std::unordered_map<uint32_t, uint32_t> remapped_ids;
-  // Invalid ids do not need to be remapped
-  remapped_ids.emplace(XNN_INVALID_VALUE_ID, XNN_INVALID_VALUE_ID);
-
+  std::unordered_map<uint32_t, uint32_t> defined_ids;
   Error err = Error::Ok;
-  for (auto value : *flatbuffer_graph->xvalues()) {
-    err = defineTensor(
-        subgraph.get(),
-        remapped_ids,
-        value,
-        flatbuffer_graph,
-        executor,
-        runtime_allocator);
-
-    if (err != Error::Ok) {
-      return err;
+  if (use_cached_subgraph) {
+    // The values and nodes are already defined, only this delegate's share
+    // of the values is left to set up.
+    const auto& cached_ids = subgraph_cache->remapped_ids();
+    for (auto value : *flatbuffer_graph->xvalues()) {
+      const fb_xnnpack::XNNTensorValue* tensor_value = getTensorValue(value);
+      ET_CHECK_OR_RETURN_ERROR(
+          tensor_value != nullptr,
+          Internal,
+          "Deserialized Tensor is Null, this should never happen");
+      err = wireTensor(
+          value,
+          cached_ids.at(tensor_value->id_out()),
+          executor,
+          runtime_allocator);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+#ifdef ENABLE_XNNPACK_PROFILING
+    for (auto node : *flatbuffer_graph->xnodes()) {
+      executor->node_debug_handles_.push_back(node->debug_handle());
+    }
+#endif
+  } else {
+    // create xnnpack subgraph
+    xnn_subgraph_t subgraph_ptr = nullptr;
+    status = xnn_create_subgraph(
+        /*external_value_ids=*/flatbuffer_graph->num_externs(),
+        /*flags=*/0,
+        &subgraph_ptr);
+    ET_CHECK_OR_RETURN_ERROR(
+        xnn_status_success == status,
+        Internal,
+        "XNN Subgraph creation failed with code: %s",
+        xnn_status_to_string(status));
+    subgraph.reset(subgraph_ptr);
+
+    // Invalid ids do not need to be remapped
+    defined_ids.emplace(XNN_INVALID_VALUE_ID, XNN_INVALID_VALUE_ID);
+
+    for (auto value : *flatbuffer_graph->xvalues()) {
+      err = defineTensor(
+          subgraph.get(),
+          defined_ids,
+          value,
+          flatbuffer_graph,
+          executor,
+          runtime_allocator);
+
+      if (err != Error::Ok) {
+        return err;
+      }
     }
-  }
 
-  for (auto node : *flatbuffer_graph->xnodes()) {
-    err = getDefineNodeFunc(node->xnode_union_type())(
-        subgraph.get(), remapped_ids, node);
-    if (err != Error::Ok) {
-      return err;
+    for (auto node : *flatbuffer_graph->xnodes()) {
+      err = getDefineNodeFunc(node->xnode_union_type())(
+          subgraph.get(), defined_ids, node);
+      if (err != Error::Ok) {
+        return err;
+      }
+#ifdef ENABLE_XNNPACK_PROFILING
+      executor->node_debug_handles_.push_back(node->debug_handle());
+#endif
     }
   }
+  xnn_subgraph_t subgraph_ptr =
+      use_cached_subgraph ? subgraph_cache->subgraph() : subgraph.get();
+  const std::unordered_map<uint32_t, uint32_t>& remapped_ids =
+      use_cached_subgraph ? subgraph_cache->remapped_ids() : defined_ids;
   uint32_t runtime_flags = 0;
 
 #ifdef ENABLE_XNNPACK_PROFILING
   runtime_flags |= XNN_FLAG_BASIC_PROFILING;
 #endif
+  if (options.force_fp16_inference) {
+    runtime_flags |= XNN_FLAG_FORCE_FP16_INFERENCE;
+  }
+
+  xnn_weights_cache_t weights_cache = nullptr;
+  std::unique_lock<std::mutex> weights_cache_lock;
+  if (options.share_weights_cache) {
+    executor->weights_cache_ = XNNWeightsCache::get_or_create(
+        buffer_pointer, num_bytes, runtime_flags);
+    if (executor->weights_cache_ != nullptr) {
+      weights_cache_lock =
+          std::unique_lock<std::mutex>(executor->weights_cache_->mutex());
+      weights_cache = executor->weights_cache_->get();
+    }
+  }
+
+  pthreadpool_t threadpool;
+  if (options.threadpool_name != nullptr) {
+    threadpool = torch::executorch::threadpool::get_named_pthreadpool(
+        options.threadpool_name, options.num_threads);
+  } else if (options.num_threads > 0) {
+    char name[32];
+    snprintf(name, sizeof(name), "xnnpack_%zu_threads", options.num_threads);
+    threadpool = torch::executorch::threadpool::get_named_pthreadpool(
+        name, options.num_threads);
+  } else {
+    threadpool = torch::executorch::threadpool::get_pthreadpool();
+  }
+
+  xnn_workspace_t workspace = nullptr;
+  if (options.workspace_name != nullptr) {
+    executor->workspace_ = XNNWorkspace::get_or_create(options.workspace_name);
+    ET_CHECK_OR_RETURN_ERROR(
+        executor->workspace_ != nullptr,
+        Internal,
+        "Failed to get XNNPACK workspace %s",
+        options.workspace_name);
+    workspace = executor->workspace_->get();
+  }
+  // Without a shared workspace, XNNPACK gives the runtime one of its own.
+  auto create_runtime = [&](xnn_weights_cache_t cache, xnn_runtime_t* out) {
+    if (workspace != nullptr) {
+      return xnn_create_runtime_v4(
+          subgraph_ptr, cache, workspace, threadpool, runtime_flags, out);
+    }
+    return xnn_create_runtime_v3(
+        subgraph_ptr, cache, threadpool, runtime_flags, out);
+  };
 
   xnn_runtime_t runtime_ptr = nullptr;
-  status = xnn_create_runtime_v2(
-      subgraph.get(),
-      torch::executorch::threadpool::get_pthreadpool(),
-      runtime_flags,
-      &runtime_ptr);
+  status = create_runtime(weights_cache, &runtime_ptr);
+  if (status != xnn_status_success && weights_cache != nullptr &&
+      executor->weights_cache_->is_finalized()) {
+    // A finalized cache only serves weights that are already packed, which
+    // fails if the graph only hashed the same as the one that filled it.
+    ET_LOG(
+        Info,
+        "Shared XNNPACK weights cache did not match, packing weights privately");
+    weights_cache_lock.unlock();
+    executor->weights_cache_.reset();
+    weights_cache = nullptr;
+    status = create_runtime(nullptr, &runtime_ptr);
+  }
   ET_CHECK_OR_RETURN_ERROR(
       xnn_status_success == status,
       Internal,
       "XNN Runtime creation failed with code: %s",
       xnn_status_to_string(status));
 
+  if (weights_cache != nullptr && !executor->weights_cache_->is_finalized()) {
+    status = executor->weights_cache_->finalize();
+    if (status != xnn_status_success) {
+      xnn_delete_runtime(runtime_ptr);
+      ET_CHECK_OR_RETURN_ERROR(
+          false,
+          Internal,
+          "XNN weights cache finalization failed with code: %s",
+          xnn_status_to_string(status));
+    }
+  }
+
   executor->runtime_ =
       std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)>(
           runtime_ptr, xnn_delete_runtime);
 
+  if (subgraph_cache != nullptr) {
+    if (!use_cached_subgraph) {
+      subgraph_cache->set_built(std::move(subgraph), defined_ids);
+    }
+    // A built entry never changes, so the rest can read it without the lock.
+    subgraph_cache_lock.unlock();
+  }
+
 #ifdef ENABLE_XNNPACK_PROFILING
   executor->init_profiler();
 #endif
@@ -1523,6 +1770,28 @@ __ET_NODISCARD Error XNNCompiler::compileModel(
   // External ids need to be in order for wiring with args
   std::sort(executor->output_ids_.begin(), executor->output_ids_.end());
 
+  // XNNPACK produces argmax indices as 32-bit integers, but ExecuTorch
+  // expects int64 outputs. Plan an int32 buffer for each index output of the
+  // graph here, so that execution only needs to widen it.
+  for (auto node : *flatbuffer_graph->xnodes()) {
+    if (node->xnode_union_type() !=
+        fb_xnnpack::XNodeUnion::XNNArgMaxPooling2d) {
+      continue;
+    }
+    uint32_t old_id =
+        node->xnode_union_as_XNNArgMaxPooling2d()->output_index_id();
+    err = planInt32Output(
+        old_id, remapped_ids, flatbuffer_graph, executor, runtime_allocator);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
+  err = executor->prepare_args();
+  if (err != Error::Ok) {
+    return err;
+  }
+
   if (!executor->qinputs_.empty() && flatbuffer_graph->xnodes()->size() > 0 &&
       flatbuffer_graph->xnodes()->Get(0)->xnode_union_type() ==
           fb_xnnpack::XNodeUnion::XNNFullyConnected) {
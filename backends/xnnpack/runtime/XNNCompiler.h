@@ -19,6 +19,34 @@ namespace executor {
 namespace xnnpack {
 namespace delegate {
 
+// Options for building a delegate, usually set through compile specs.
+struct XNNCompileOptions {
+  // Keep the packed weights in an XNNWeightsCache shared with the other
+  // delegates built from the same graph.
+  bool share_weights_cache = false;
+  // Build the subgraph once per serialized graph in the process and create
+  // the runtimes of later delegates from it (see XNNSubgraphCache).
+  bool cache_subgraph = false;
+  // Run on the named threadpool of this name (see get_named_threadpool()).
+  // If null and num_threads is 0, the global threadpool is used.
+  const char* threadpool_name = nullptr;
+  // Number of threads of the named threadpool if it is created for this
+  // delegate. Without a threadpool_name, delegates that ask for the same
+  // number of threads share a pool.
+  size_t num_threads = 0;
+  // Keep intermediate values in the XNNWorkspace of this name, shared with
+  // the other delegates that name it. If null, the runtime gets its own.
+  const char* workspace_name = nullptr;
+  // Run float operators with XNNPACK's fp16 kernels, converting fp32 inputs,
+  // outputs and weights at the edges (XNN_FLAG_FORCE_FP16_INFERENCE). Fails
+  // to build the delegate on CPUs without native fp16 arithmetic.
+  bool force_fp16_inference = false;
+  // The FreeableBuffer that holds the serialized graph, if it is a read-only
+  // file mapping (see BackendInitContext::is_processed_mapped()). A new
+  // XNNSubgraphCache entry takes it over instead of copying the graph.
+  FreeableBuffer* mapped_buffer = nullptr;
+};
+
 class XNNCompiler {
  public:
   // Takes Flatbuffer Serialized XNNPACK Model and rebuilds the xnn-subgraph
@@ -28,7 +56,8 @@ class XNNCompiler {
       const void* buffer_pointer,
       size_t num_bytes,
       XNNExecutor* executor,
-      MemoryAllocator* runtime_allocator);
+      MemoryAllocator* runtime_allocator,
+      const XNNCompileOptions& options = XNNCompileOptions());
 };
 
 } // namespace delegate
@@ -11,12 +11,17 @@
 #include <executorch/backends/xnnpack/runtime/utils/utils.h>
 #endif
 
+#include <algorithm>
+
 namespace torch {
 namespace executor {
 namespace xnnpack {
 namespace delegate {
 
-Error XNNExecutor::set_external_input(uint32_t id, Tensor* input) {
+Error XNNExecutor::set_external_input(
+    xnn_external_value& external,
+    Tensor* input) {
+  const uint32_t id = external.id;
   auto qinput_pair = qinputs_.find(id);
   if (qinput_pair != qinputs_.end()) {
 #ifdef ENABLE_DYNAMIC_QUANTIZATION
@@ -57,12 +62,14 @@ Error XNNExecutor::set_external_input(uint32_t id, Tensor* input) {
     }
     ET_CHECK_OR_RETURN_ERROR(
         e == Error::Ok, Internal, "QuantizePerTensor() failed");
-    externals_.emplace_back(xnn_external_value{
+    // The quantization parameters change with every input.
+    external = xnn_external_value{
         id,
         qinput.mutable_data_ptr(),
         {static_cast<float>(input_qparam.scale),
          static_cast<int8_t>(input_qparam.zero_point)},
-        batch_size});
+        batch_size};
+    needs_setup_ = true;
 #else
     ET_LOG(Error, "Dynamic Quantization is not supported");
     return Error::NotSupported;
@@ -79,11 +86,208 @@ Error XNNExecutor::set_external_input(uint32_t id, Tensor* input) {
         data_f32[j] = data_64[j];
       }
     }
-    externals_.emplace_back(xnn_external_value{id, input->mutable_data_ptr()});
+    void* data = input->mutable_data_ptr();
+    if (external.data != data) {
+      external.data = data;
+      needs_setup_ = true;
+    }
+  }
+  return Error::Ok;
+}
+
+Error XNNExecutor::prepare_args() {
+  const size_t num_inputs = input_ids_.size();
+  const size_t num_outputs = output_ids_.size();
+  ET_CHECK_OR_RETURN_ERROR(
+      external_id_args_.size() == num_inputs + num_outputs,
+      Internal,
+      "External id and expected delegate args mismatch");
+  std::sort(external_id_args_.begin(), external_id_args_.end());
+  is_sorted_args_list_ = true;
+
+  externals_.resize(num_inputs + num_outputs);
+  for (size_t i = 0; i < num_inputs; i++) {
+    externals_[i] = xnn_external_value{input_ids_[i], nullptr};
+  }
+  output_scratch_.assign(num_outputs, Span<int32_t>());
+  for (size_t i = 0; i < num_outputs; i++) {
+    externals_[num_inputs + i] = xnn_external_value{output_ids_[i], nullptr};
+    auto int32_output = int32_outputs_.find(output_ids_[i]);
+    if (int32_output != int32_outputs_.end()) {
+      output_scratch_[i] = int32_output->second;
+    }
+  }
+  needs_setup_ = true;
+#ifdef ENABLE_XNNPACK_RESHAPE
+  // No input has been reshaped yet, but the runtime must be reshaped once
+  // before it is first set up.
+  input_num_dims_.assign(num_inputs, 0);
+  input_dims_.assign(num_inputs * kTensorDimensionLimit, 0);
+  needs_reshape_ = true;
+#endif
+  return Error::Ok;
+}
+
+#ifdef ENABLE_XNNPACK_RESHAPE
+Error XNNExecutor::reshape_input(size_t index, const Tensor& input) {
+  const uint32_t id = input_ids_[index];
+  if (qinputs_.count(id) != 0) {
+    // Dynamically quantized inputs pass their batch size with the external
+    // value instead; see set_external_input().
+    return Error::Ok;
+  }
+  const size_t num_dims = input.dim();
+  ET_CHECK_OR_RETURN_ERROR(
+      num_dims <= kTensorDimensionLimit && num_dims <= XNN_MAX_TENSOR_DIMS,
+      InvalidArgument,
+      "Input %zu has %zu dims, more than XNNPACK supports",
+      index,
+      num_dims);
+  size_t* dims = &input_dims_[index * kTensorDimensionLimit];
+  bool changed = input_num_dims_[index] != num_dims;
+  for (size_t d = 0; d < num_dims; d++) {
+    const size_t size = input.size(d);
+    changed = changed || dims[d] != size;
+    dims[d] = size;
+  }
+  if (!changed) {
+    return Error::Ok;
+  }
+  input_num_dims_[index] = num_dims;
+
+  xnn_status status =
+      xnn_reshape_external_value(runtime_.get(), id, num_dims, dims);
+  ET_CHECK_OR_RETURN_ERROR(
+      status == xnn_status_success,
+      Internal,
+      "Failed to reshape input %zu with code: %s",
+      index,
+      xnn_status_to_string(status));
+  needs_reshape_ = true;
+  return Error::Ok;
+}
+
+Error XNNExecutor::resize_outputs(EValue** args) {
+  const size_t num_inputs = input_ids_.size();
+  for (size_t i = num_inputs; i < externals_.size(); i++) {
+    Tensor& output = args[external_id_args_[i]]->toTensor();
+    size_t num_dims = 0;
+    size_t dims[XNN_MAX_TENSOR_DIMS];
+    xnn_status status = xnn_get_external_value_shape(
+        runtime_.get(), externals_[i].id, &num_dims, dims);
+    ET_CHECK_OR_RETURN_ERROR(
+        status == xnn_status_success,
+        Internal,
+        "Failed to get the shape of output %zu with code: %s",
+        i - num_inputs,
+        xnn_status_to_string(status));
+    ET_CHECK_OR_RETURN_ERROR(
+        num_dims == output.dim(),
+        Internal,
+        "XNNPACK output %zu has %zu dims, but the output tensor has %zd",
+        i - num_inputs,
+        num_dims,
+        output.dim());
+
+    exec_aten::SizesType sizes[kTensorDimensionLimit];
+    for (size_t d = 0; d < num_dims; d++) {
+      sizes[d] = static_cast<exec_aten::SizesType>(dims[d]);
+    }
+    Error err = resize_tensor(output, {sizes, num_dims});
+    ET_CHECK_OR_RETURN_ERROR(
+        err == Error::Ok,
+        Internal,
+        "Failed to resize output %zu for XNNExecutor",
+        i - num_inputs);
+  }
+  return Error::Ok;
+}
+#endif
+
+Error XNNExecutor::set_inputs(EValue** args) {
+  const size_t num_inputs = input_ids_.size();
+  ET_CHECK_OR_RETURN_ERROR(
+      externals_.size() == external_id_args_.size() &&
+          externals_.size() == num_inputs + output_ids_.size(),
+      Internal,
+      "XNNPACK Delegate args were not prepared");
+
+  for (size_t i = 0; i < num_inputs; i++) {
+    Tensor* input = &args[external_id_args_[i]]->toTensor();
+    Error err = Error::Ok;
+#ifdef ENABLE_XNNPACK_RESHAPE
+    err = reshape_input(i, *input);
+    if (err != Error::Ok) {
+      return err;
+    }
+#endif
+    err = set_external_input(externals_[i], input);
+    ET_CHECK_OR_RETURN_ERROR(
+        err == Error::Ok, Internal, "Failed to set_external_input");
+  }
+#ifdef ENABLE_XNNPACK_RESHAPE
+  if (needs_reshape_) {
+    // Only shape inference runs here; the outputs keep their planned
+    // buffers, which are sized for the largest shapes.
+    xnn_status status = xnn_reshape_runtime(runtime_.get());
+    ET_CHECK_OR_RETURN_ERROR(
+        status == xnn_status_success,
+        Internal,
+        "XNN Runtime reshape failed with code: %s",
+        xnn_status_to_string(status));
+    needs_reshape_ = false;
+    needs_setup_ = true;
+    // Dynamically quantized delegates size their output in resizeOutput().
+    if (!needs_resize_output) {
+      Error err = resize_outputs(args);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
   }
+#endif
+  for (size_t i = num_inputs; i < externals_.size(); i++) {
+    Tensor& output = args[external_id_args_[i]]->toTensor();
+    const Span<int32_t> scratch = output_scratch_[i - num_inputs];
+    // Int64 outputs are produced into their int32 buffer, which never moves
+    // and is sized for the largest shape the output can have.
+    void* data = output.scalar_type() == ScalarType::Long &&
+            scratch.size() >= output.numel()
+        ? static_cast<void*>(scratch.data())
+        : output.mutable_data_ptr();
+    if (externals_[i].data != data) {
+      externals_[i].data = data;
+      needs_setup_ = true;
+    }
+  }
+  inputs_set_from_ = args;
   return Error::Ok;
 }
 
+void XNNExecutor::convert_int64_outputs(EValue** args) {
+  const size_t num_inputs = input_ids_.size();
+  for (size_t i = num_inputs; i < externals_.size(); i++) {
+    Tensor& output = args[external_id_args_[i]]->toTensor();
+    if (output.scalar_type() != ScalarType::Long) {
+      continue;
+    }
+    int64_t* data_64 = output.mutable_data_ptr<int64_t>();
+    const int32_t* data_32 = static_cast<const int32_t*>(externals_[i].data);
+    if (static_cast<const void*>(data_32) != data_64) {
+      // The buffers don't overlap, so this loop vectorizes.
+      for (size_t j = 0; j < output.numel(); j++) {
+        data_64[j] = data_32[j];
+      }
+    } else {
+      // There was no int32 buffer for this output, so XNNPACK wrote into the
+      // front of the tensor and it has to be widened in place from the back.
+      for (int64_t j = output.numel() - 1; j >= 0; j--) {
+        data_64[j] = data_32[j];
+      }
+    }
+  }
+}
+
 inline void XNNExecutor::get_runtime_operator_names(
     std::vector<char>& operator_names) {
   size_t required_size = 0;
@@ -143,22 +347,86 @@ inline void XNNExecutor::get_runtime_operator_timings(
 void XNNExecutor::init_profiler() {
   get_runtime_operator_names(op_names_);
   get_runtime_num_operators(num_ops_);
+  // The names are stored back to back, each one null-terminated.
+  op_name_ptrs_.clear();
+  size_t name_offset = 0;
+  for (size_t i = 0; i < num_ops_ && name_offset < op_names_.size(); i++) {
+    op_name_ptrs_.push_back(&op_names_[name_offset]);
+    name_offset += strlen(op_name_ptrs_.back()) + 1;
+  }
+  if (op_name_ptrs_.size() != num_ops_) {
+    ET_LOG(Error, "Failed to get XNNPACK Operator Names");
+    num_ops_ = op_name_ptrs_.size();
+  }
 }
 
-void XNNExecutor::log_op_timings() {
+void XNNExecutor::log_op_timings(
+    EventTracer* event_tracer,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time) {
   std::vector<uint64_t> op_stats;
   get_runtime_operator_timings(op_stats);
-  op_timings_.emplace_back(op_stats);
+  if (event_tracer != nullptr) {
+    log_op_timings_to_event_tracer(
+        event_tracer, op_stats, start_time, end_time);
+  }
+  op_timings_.emplace_back(std::move(op_stats));
+}
+
+void XNNExecutor::log_op_timings_to_event_tracer(
+    EventTracer* event_tracer,
+    const std::vector<uint64_t>& timing_stats,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time) {
+  // XNNPACK only reports how long each operator took, in microseconds, while
+  // the event tracer wants PAL timestamps, whose unit is platform specific. So
+  // lay the operators out back to back from the start of the run, scaled to
+  // span the whole run.
+  uint64_t total_us = 0;
+  for (uint64_t op_us : timing_stats) {
+    total_us += op_us;
+  }
+  const double ticks_per_us = total_us > 0
+      ? static_cast<double>(end_time - start_time) / total_us
+      : 0.0;
+
+  // Unless XNNPACK fused some nodes when it created the runtime, operators
+  // map one to one to the serialized nodes, whose debug handles are the
+  // delegate debug identifiers that XnnpackBackend.preprocess() recorded.
+  // Otherwise fall back to identifying the operators by their names.
+  const bool log_debug_handles = node_debug_handles_.size() == num_ops_;
+  uint64_t elapsed_us = 0;
+  for (size_t i = 0; i < num_ops_ && i < timing_stats.size(); i++) {
+    const et_timestamp_t op_start_time =
+        start_time + static_cast<et_timestamp_t>(elapsed_us * ticks_per_us);
+    elapsed_us += timing_stats[i];
+    const et_timestamp_t op_end_time =
+        start_time + static_cast<et_timestamp_t>(elapsed_us * ticks_per_us);
+    if (log_debug_handles) {
+      event_tracer_log_profiling_delegate(
+          event_tracer,
+          /*name=*/nullptr,
+          node_debug_handles_[i],
+          op_start_time,
+          op_end_time,
+          /*metadata=*/op_name_ptrs_[i]);
+    } else {
+      event_tracer_log_profiling_delegate(
+          event_tracer,
+          op_name_ptrs_[i],
+          /*delegate_debug_id=*/-1,
+          op_start_time,
+          op_end_time);
+    }
+  }
 }
 
 void XNNExecutor::print_avg_op_timings() {
   size_t num_iterations = op_timings_.size();
-  size_t name_len = 0;
   const char* op_name = nullptr;
   float avg_total = 0;
   for (size_t xnn_node_idx = 0; xnn_node_idx < num_ops_; xnn_node_idx++) {
-    op_name = &op_names_[name_len];
-    name_len += strlen(op_name) + 1;
+    op_name = op_name_ptrs_[xnn_node_idx];
     float total_op_time = 0;
     for (size_t it = 0; it < num_iterations; it++) {
       total_op_time += op_timings_[it][xnn_node_idx];
@@ -9,9 +9,14 @@
 #pragma once
 
 #include <executorch/backends/xnnpack/runtime/XNNStatus.h>
+#include <executorch/backends/xnnpack/runtime/XNNSubgraphCache.h>
+#include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/event_tracer_hooks_delegate.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/core/span.h>
 
 #include <xnnpack.h>
 #include <map>
@@ -25,6 +30,16 @@ namespace delegate {
 
 class XNNExecutor {
  private:
+  // The shared weights cache the runtime's packed weights live in, if any.
+  // Declared before runtime_ so that it outlives it.
+  std::shared_ptr<XNNWeightsCache> weights_cache_;
+  // The cached subgraph the runtime was created from, if any. The runtime's
+  // static values point into its copy of the graph, so it outlives runtime_.
+  std::shared_ptr<XNNSubgraphCache> subgraph_cache_;
+  // The workspace shared with other delegates, if any. Also outlives runtime_.
+  std::shared_ptr<XNNWorkspace> workspace_;
+  // workspace_->note_setup() as of this runtime's last setup.
+  uint64_t workspace_setup_ = 0;
   std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime_{
       nullptr,
       &xnn_delete_runtime};
@@ -32,11 +47,39 @@ class XNNExecutor {
   std::vector<uint32_t> output_ids_;
   std::vector<uint32_t> external_id_args_;
   bool is_sorted_args_list_ = false;
+  // One entry per input followed by one per output, in the order of
+  // input_ids_ and output_ids_. Sized once by prepare_args(); each call only
+  // patches the data pointers.
   std::vector<xnn_external_value> externals_;
+  // Whether externals_ changed since it was last passed to xnn_setup_runtime.
+  bool needs_setup_ = true;
   std::map<uint32_t, Tensor> qinputs_;
+  // Int32 buffers that XNNPACK writes index outputs into, keyed by external
+  // id. ExecuTorch expects those outputs as int64, so they are widened into
+  // the output tensors after each run.
+  std::map<uint32_t, Span<int32_t>> int32_outputs_;
+  // int32_outputs_ by output position, or an empty span. Set by
+  // prepare_args().
+  std::vector<Span<int32_t>> output_scratch_;
   bool needs_resize_output = false;
-
-  Error set_external_input(uint32_t id, Tensor* input);
+  // The args of the most recent bind_args(), for runs of the bound delegate.
+  EValue** bound_args_ = nullptr;
+  // The args that set_inputs() last set externals_ from, or null if it has to
+  // run again.
+  EValue** inputs_set_from_ = nullptr;
+#ifdef ENABLE_XNNPACK_RESHAPE
+  // The shape that each input's external value was last reshaped to, in the
+  // order of input_ids_, as kTensorDimensionLimit dims per input.
+  std::vector<size_t> input_num_dims_;
+  std::vector<size_t> input_dims_;
+  // Whether an input changed shape since the runtime was last reshaped.
+  bool needs_reshape_ = true;
+
+  Error reshape_input(size_t index, const Tensor& input);
+  Error resize_outputs(EValue** args);
+#endif
+
+  Error set_external_input(xnn_external_value& external, Tensor* input);
 
   // XNNPACK Profiling
   // Used to hold profiling data
@@ -45,19 +88,37 @@ class XNNExecutor {
   using microsecond_t = uint64_t;
   size_t num_ops_;
   std::vector<char> op_names_;
+  // op_name_ptrs_[j] points at the name of operator j inside op_names_
+  std::vector<const char*> op_name_ptrs_;
   // op_timings[i][j] represents the runtime of operator j on the ith run
   std::vector<std::vector<microsecond_t>> op_timings_;
+  // Debug handles of the serialized nodes, in the order they were defined
+  std::vector<uint32_t> node_debug_handles_;
 
   void get_runtime_operator_names(std::vector<char>& operator_names);
   void get_runtime_num_operators(size_t& num_operators);
   void get_runtime_operator_timings(std::vector<uint64_t>& timing_stats);
+  void log_op_timings_to_event_tracer(
+      EventTracer* event_tracer,
+      const std::vector<uint64_t>& timing_stats,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time);
 
  public:
   XNNExecutor() = default;
 
   // XNNPACK Profiling public fn
   void init_profiler();
-  void log_op_timings();
+  /**
+   * Records the operator timings of the run that forward() just completed,
+   * and logs them to `event_tracer` as delegate events if it is not null.
+   * `start_time` and `end_time` are the PAL timestamps taken around
+   * forward().
+   */
+  void log_op_timings(
+      EventTracer* event_tracer,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time);
   void print_avg_op_timings();
 
   inline void append_arg(uint32_t id) {
@@ -66,6 +127,12 @@ class XNNExecutor {
     is_sorted_args_list_ = false;
   }
 
+  /// The workspace this delegate shares with others, or null if it has one
+  /// of its own. Runs must hold its mutex().
+  inline XNNWorkspace* workspace() const {
+    return workspace_.get();
+  }
+
   inline size_t get_args_size() {
     return external_id_args_.size();
   }
@@ -106,50 +173,96 @@ class XNNExecutor {
     qinputs_.insert({id, Tensor(qinput)});
   }
 
-  __ET_NODISCARD Error
-  set_inputs(std::vector<Tensor*>& inputs, std::vector<Tensor*>& outputs) {
-    externals_.clear();
+  inline void addInt32Output(uint32_t id, Span<int32_t> buffer) {
+    int32_outputs_.insert({id, buffer});
+  }
 
-    ET_CHECK_OR_RETURN_ERROR(
-        inputs.size() == input_ids_.size(),
-        InvalidArgument,
-        "Expected %zu inputs but given %zu",
-        input_ids_.size(),
-        inputs.size());
-
-    for (int i = 0; i < inputs.size(); i++) {
-      auto err = set_external_input(input_ids_[i], inputs[i]);
-      ET_CHECK_OR_RETURN_ERROR(
-          err == Error::Ok, Internal, "Failed to set_external_input");
-    }
-    ET_CHECK_OR_RETURN_ERROR(
-        outputs.size() == output_ids_.size(),
-        InvalidArgument,
-        "Expected %zu outputs gut given %zu",
-        output_ids_.size(),
-        outputs.size());
-
-    for (int i = 0; i < outputs.size(); i++) {
-      externals_.emplace_back(xnn_external_value{
-          output_ids_[i], outputs[i]->mutable_data_ptr<float>()});
-    }
+  /**
+   * Sorts the args and lays out externals_ for them. Called once the runtime
+   * has been created and the input and output ids are known, so that
+   * execution does not need to allocate.
+   */
+  __ET_NODISCARD Error prepare_args();
+
+  /**
+   * Points the runtime's external values at the tensors in `args`, indexed
+   * by the delegate's sorted arg ids. The runtime only needs to be set up
+   * again if a data pointer changed or an input is dynamically quantized.
+   *
+   * With ENABLE_XNNPACK_RESHAPE, also reshapes the runtime if an input
+   * changed shape since the last call, and resizes the output tensors to
+   * the shapes XNNPACK infers for them.
+   */
+  __ET_NODISCARD Error set_inputs(EValue** args);
+
+  /**
+   * Keeps `args` for runs of the bound delegate. Their storage may have
+   * changed, so set_inputs() has to run again.
+   */
+  inline void bind_args(EValue** args) {
+    bound_args_ = args;
+    inputs_set_from_ = nullptr;
+  }
 
-    return Error::Ok;
+  inline EValue** bound_args() const {
+    return bound_args_;
   }
 
+  /**
+   * Returns true if externals_ are still up to date for `args`, so that
+   * set_inputs() can be skipped. Never the case for dynamically quantized
+   * inputs, which set_inputs() quantizes, or for inputs and outputs whose
+   * shapes can change between runs.
+   */
+  inline bool inputs_set_from(EValue** args) const {
+#ifdef ENABLE_XNNPACK_RESHAPE
+    (void)args;
+    return false;
+#else
+    return qinputs_.empty() && !needs_resize_output &&
+        inputs_set_from_ == args;
+#endif
+  }
+
+  /**
+   * Widens the outputs that XNNPACK produced as int32 into the int64 output
+   * tensors in `args`. Must be called after forward().
+   */
+  void convert_int64_outputs(EValue** args);
+
   __ET_NODISCARD Error forward() {
     ET_CHECK_OR_RETURN_ERROR(
         runtime_ != nullptr,
         Internal,
         "XNNPACK Delegate did not compile correctly");
-    xnn_status status =
-        xnn_setup_runtime(runtime_.get(), externals_.size(), externals_.data());
+    xnn_status status;
+    if (workspace_ != nullptr &&
+        workspace_->num_setups() != workspace_setup_) {
+      // Another runtime was set up on the workspace since, which may have
+      // moved it.
+      needs_setup_ = true;
+    }
+    if (needs_setup_) {
+#ifdef ENABLE_XNNPACK_RESHAPE
+      // set_inputs() already reshaped the runtime if it had to, which plain
+      // xnn_setup_runtime() would redo on every call.
+      status = xnn_setup_runtime_v2(
+          runtime_.get(), externals_.size(), externals_.data());
+#else
+      status = xnn_setup_runtime(
+          runtime_.get(), externals_.size(), externals_.data());
+#endif
 
-    ET_CHECK_OR_RETURN_ERROR(
-        status == xnn_status_success,
-        Internal,
-        "XNN Runtime setup failed with code: %s",
-        xnn_status_to_string(status));
+      ET_CHECK_OR_RETURN_ERROR(
+          status == xnn_status_success,
+          Internal,
+          "XNN Runtime setup failed with code: %s",
+          xnn_status_to_string(status));
+      needs_setup_ = false;
+      if (workspace_ != nullptr) {
+        workspace_setup_ = workspace_->note_setup();
+      }
+    }
 
     status = xnn_invoke_runtime(runtime_.get());
 
@@ -10,14 +10,29 @@
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
+#include <executorch/runtime/platform/platform.h>
 #include <executorch/runtime/platform/profiler.h>
+#include <cstring>
 #include <memory>
+#include <mutex>
 
 namespace torch {
 namespace executor {
 
 class XnnpackBackend final : public PyTorchBackendInterface {
  public:
+  /// Compile spec key for the number of threads to run the delegate with,
+  /// as a little-endian unsigned integer.
+  static constexpr const char* kNumThreadsKey = "num_threads";
+  /// Compile spec key for the name of the threadpool to run the delegate on.
+  /// Delegates that name the same pool share it, and other pools can be
+  /// pinned to different CPUs with set_named_threadpool_cpus().
+  static constexpr const char* kThreadPoolKey = "threadpool";
+  static constexpr size_t kMaxThreadPoolNameLength = 64;
+  /// Compile spec key that runs float operators with XNNPACK's fp16 kernels.
+  /// Its value is a single byte; any non-zero value enables it.
+  static constexpr const char* kFp16InferenceKey = "fp16_inference";
+
   ~XnnpackBackend() = default;
 
   bool is_available() const override {
@@ -37,96 +52,177 @@ class XnnpackBackend final : public PyTorchBackendInterface {
     // destructor manually in destroy().
     new (executor) xnnpack::delegate::XNNExecutor;
 
+    using xnnpack::delegate::XNNSubgraphCache;
+    using xnnpack::delegate::XNNWeightsCache;
+    using xnnpack::delegate::XNNWorkspace;
+    xnnpack::delegate::XNNCompileOptions options;
+    char threadpool_name[kMaxThreadPoolNameLength];
+    char workspace_name[XNNWorkspace::kMaxNameLength];
+    for (const CompileSpec& spec : compile_specs) {
+      const uint8_t* value = static_cast<const uint8_t*>(spec.value.buffer);
+      const size_t nbytes = spec.value.nbytes;
+      if (strcmp(spec.key, XNNWeightsCache::kShareWeightsCacheKey) == 0 &&
+          nbytes > 0) {
+        options.share_weights_cache = value[0] != 0;
+      } else if (
+          strcmp(spec.key, XNNSubgraphCache::kCacheSubgraphKey) == 0 &&
+          nbytes > 0) {
+        options.cache_subgraph = value[0] != 0;
+      } else if (strcmp(spec.key, kNumThreadsKey) == 0) {
+        // Little-endian unsigned integer of up to 8 bytes.
+        size_t num_threads = 0;
+        for (size_t i = 0; i < nbytes && i < sizeof(size_t); i++) {
+          num_threads |= static_cast<size_t>(value[i]) << (8 * i);
+        }
+        options.num_threads = num_threads;
+      } else if (strcmp(spec.key, kThreadPoolKey) == 0) {
+        ET_CHECK_OR_RETURN_ERROR(
+            nbytes < sizeof(threadpool_name),
+            InvalidArgument,
+            "Threadpool name of %zu bytes is longer than %zu",
+            nbytes,
+            sizeof(threadpool_name) - 1);
+        memcpy(threadpool_name, value, nbytes);
+        threadpool_name[nbytes] = '\0';
+        options.threadpool_name = threadpool_name;
+      } else if (strcmp(spec.key, XNNWorkspace::kWorkspaceKey) == 0) {
+        ET_CHECK_OR_RETURN_ERROR(
+            nbytes < sizeof(workspace_name),
+            InvalidArgument,
+            "Workspace name of %zu bytes is longer than %zu",
+            nbytes,
+            sizeof(workspace_name) - 1);
+        memcpy(workspace_name, value, nbytes);
+        workspace_name[nbytes] = '\0';
+        options.workspace_name = workspace_name;
+      } else if (strcmp(spec.key, kFp16InferenceKey) == 0 && nbytes > 0) {
+        options.force_fp16_inference = value[0] != 0;
+      }
+    }
+    if (context.is_processed_mapped()) {
+      // A cached subgraph can keep referencing the mapped graph rather than a
+      // copy of it.
+      options.mapped_buffer = processed;
+    }
+
     Error err = xnnpack::delegate::XNNCompiler::compileModel(
         processed->data(),
         processed->size(),
         executor,
-        context.get_runtime_allocator());
+        context.get_runtime_allocator(),
+        options);
     if (err != Error::Ok) {
       ET_LOG(Error, "XNNCompiler::compleModel failed: 0x%x", (unsigned int)err);
     }
 
-    // Free the flatbuffer
+    // Free the flatbuffer, unless the subgraph cache took it over, which left
+    // `processed` empty.
     processed->Free();
 
     return executor;
   }
 
+  // The caches, workspaces and threadpools that delegates share are looked up
+  // and filled under their own locks, so delegates can compile in parallel.
+  bool is_init_thread_safe() const override {
+    return true;
+  }
+
   Error execute(
-      __ET_UNUSED BackendExecutionContext& context,
+      BackendExecutionContext& context,
       DelegateHandle* handle,
       EValue** args) const override {
+    return run(
+        context,
+        static_cast<xnnpack::delegate::XNNExecutor*>(handle),
+        args,
+        /*set_inputs=*/true);
+  }
+
+  bool supports_binding() const override {
+    return true;
+  }
+
+  Error bind(DelegateHandle* handle, EValue** args) const override {
+    static_cast<xnnpack::delegate::XNNExecutor*>(handle)->bind_args(args);
+    return Error::Ok;
+  }
+
+  // Skips set_inputs() while the bound args keep their storage, which leaves
+  // forward() without any per-call setup.
+  Error execute_bound(BackendExecutionContext& context, DelegateHandle* handle)
+      const override {
     auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
+    EValue** args = executor->bound_args();
+    return run(context, executor, args, !executor->inputs_set_from(args));
+  }
 
-    std::vector<Tensor*> input_pointers;
-    std::vector<Tensor*> output_pointers;
-
-    ET_CHECK_OR_RETURN_ERROR(
-        executor->get_args_size() ==
-            executor->getNumInputs() + executor->getNumOutputs(),
-        Internal,
-        "External id and expected delegate args mismatch");
-
-    for (int i = 0; i < executor->get_args_size(); i++) {
-      int index = executor->get_arg_index(i);
-      if (i < executor->getNumInputs()) {
-        input_pointers.push_back(&args[index]->toTensor());
-      } else {
-        output_pointers.push_back(&args[index]->toTensor());
-      }
+  void destroy(DelegateHandle* handle) const override {
+    if (handle != nullptr) {
+      auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
+#ifdef ENABLE_XNNPACK_PROFILING
+      executor->print_avg_op_timings();
+#endif
+      // XNNExecutor is not trivially destructible. Since this was constructed
+      // manually in init(), we must destroy it manually here.
+      executor->~XNNExecutor();
     }
+  }
 
-    if (executor->needsResizeOutput()) {
-      Error err =
-          executor->resizeOutput(input_pointers.at(0), output_pointers.at(0));
-      if (err != Error::Ok) {
-        return err;
-      }
+ private:
+  // Runs the delegate on `args`, first pointing its external values at them
+  // if `set_inputs` is true.
+  Error run(
+      __ET_UNUSED BackendExecutionContext& context,
+      xnnpack::delegate::XNNExecutor* executor,
+      EValue** args,
+      bool set_inputs) const {
+    // Delegates that share a workspace keep their intermediate values in the
+    // same memory, so only one of them may run at a time.
+    std::unique_lock<std::mutex> workspace_lock;
+    if (executor->workspace() != nullptr) {
+      workspace_lock =
+          std::unique_lock<std::mutex>(executor->workspace()->mutex());
     }
 
-    Error err = executor->set_inputs(input_pointers, output_pointers);
+    Error err = Error::Ok;
+    if (set_inputs) {
+      if (executor->needsResizeOutput()) {
+        size_t output_index =
+            executor->get_arg_index(executor->getNumInputs());
+        err = executor->resizeOutput(
+            &args[executor->get_arg_index(0)]->toTensor(),
+            &args[output_index]->toTensor());
+        if (err != Error::Ok) {
+          return err;
+        }
+      }
 
-    if (err != Error::Ok) {
-      return err;
+      // The args were wired up at init(), so this only patches data
+      // pointers.
+      err = executor->set_inputs(args);
+      if (err != Error::Ok) {
+        return err;
+      }
     }
 
+#ifdef ENABLE_XNNPACK_PROFILING
+    et_timestamp_t start_time = et_pal_current_ticks();
+#endif
     err = executor->forward();
 #ifdef ENABLE_XNNPACK_PROFILING
-    executor->log_op_timings(); // Log the op execution time.
+    // Log the op execution time, and forward it to the event tracer so that
+    // ETDump has a breakdown of the delegate call.
+    executor->log_op_timings(
+        context.event_tracer(), start_time, et_pal_current_ticks());
 #endif
 
-    for (int i = executor->getNumInputs();
-         i < executor->getNumInputs() + executor->getNumOutputs();
-         i++) {
-      if (args[i]->isTensor()) {
-        exec_aten::Tensor output_tensor = args[i]->toTensor();
-        if (output_tensor.scalar_type() == ScalarType::Long) {
-          // Output datatype is int64. However, XNNPACK doesn't support
-          // int64. This means that the data was put into this tensor
-          // by XNNPACK as int32 and needs to be copied to int64 form
-          int64_t* data_64 = output_tensor.mutable_data_ptr<int64_t>();
-          const int32_t* data_32 = output_tensor.const_data_ptr<int32_t>();
-          for (int j = output_tensor.numel() - 1; j >= 0; j--) {
-            data_64[j] = data_32[j];
-          }
-        }
-      }
+    if (err == Error::Ok) {
+      executor->convert_int64_outputs(args);
     }
 
     return err;
   }
-
-  void destroy(DelegateHandle* handle) const override {
-    if (handle != nullptr) {
-      auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
-#ifdef ENABLE_XNNPACK_PROFILING
-      executor->print_avg_op_timings();
-#endif
-      // XNNExecutor is not trivially destructible. Since this was constructed
-      // manually in init(), we must destroy it manually here.
-      executor->~XNNExecutor();
-    }
-  }
 };
 
 namespace {
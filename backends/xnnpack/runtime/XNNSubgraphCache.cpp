@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNSubgraphCache.h>
+
+#include <cstring>
+#include <string_view>
+
+namespace torch {
+namespace executor {
+namespace xnnpack {
+namespace delegate {
+
+namespace {
+
+std::mutex& registry_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+/// Cached subgraphs by the hash of their serialized graph.
+std::unordered_map<size_t, std::shared_ptr<XNNSubgraphCache>>& registry() {
+  static auto* caches =
+      new std::unordered_map<size_t, std::shared_ptr<XNNSubgraphCache>>();
+  return *caches;
+}
+
+} // namespace
+
+std::shared_ptr<XNNSubgraphCache> XNNSubgraphCache::get_or_create(
+    const void* buffer,
+    size_t num_bytes,
+    FreeableBuffer* mapped) {
+  const size_t key = std::hash<std::string_view>()(
+      std::string_view(static_cast<const char*>(buffer), num_bytes));
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  auto& caches = registry();
+  auto it = caches.find(key);
+  if (it != caches.end()) {
+    // Running another graph's subgraph would be wrong, not just slow, so a
+    // hash match alone is not enough.
+    return it->second->matches(buffer, num_bytes) ? it->second : nullptr;
+  }
+  // The graph's constant buffers must stay as aligned as in a copy.
+  const bool keep_mapped = mapped != nullptr &&
+      reinterpret_cast<uintptr_t>(buffer) % alignof(Chunk) == 0;
+  std::shared_ptr<XNNSubgraphCache> created(
+      keep_mapped
+          ? new XNNSubgraphCache(std::move(*mapped), buffer, num_bytes)
+          : new XNNSubgraphCache(buffer, num_bytes));
+  caches.emplace(key, created);
+  return created;
+}
+
+void XNNSubgraphCache::clear() {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  registry().clear();
+}
+
+XNNSubgraphCache::XNNSubgraphCache(const void* buffer, size_t num_bytes)
+    : buffer_(new Chunk[(num_bytes + sizeof(Chunk) - 1) / sizeof(Chunk)]),
+      data_(buffer_.get()),
+      num_bytes_(num_bytes) {
+  memcpy(buffer_.get(), buffer, num_bytes);
+}
+
+XNNSubgraphCache::XNNSubgraphCache(
+    FreeableBuffer&& mapped,
+    const void* buffer,
+    size_t num_bytes)
+    : mapped_(std::move(mapped)), data_(buffer), num_bytes_(num_bytes) {}
+
+bool XNNSubgraphCache::matches(const void* buffer, size_t num_bytes) const {
+  return num_bytes == num_bytes_ && memcmp(data_, buffer, num_bytes) == 0;
+}
+
+void XNNSubgraphCache::set_built(
+    SubgraphPtr subgraph,
+    std::unordered_map<uint32_t, uint32_t> remapped_ids) {
+  subgraph_ = std::move(subgraph);
+  remapped_ids_ = std::move(remapped_ids);
+}
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <xnnpack.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace torch {
+namespace executor {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * An XNNPACK subgraph built from a serialized graph, kept so that delegates
+ * initialized again from the same graph, e.g. when Methods are recycled, can
+ * create their runtimes from it instead of defining every value and node
+ * again.
+ *
+ * Subgraphs are process-wide and looked up by the contents of the serialized
+ * graph, which the cache keeps since the subgraph's static values point into
+ * it: a copy, or the delegate's own buffer when that is a file mapping. Unlike
+ * weights caches, they stay cached after the last delegate that uses them is
+ * destroyed, until clear() is called.
+ */
+class XNNSubgraphCache final {
+ public:
+  /// Compile spec key that makes a delegate use the subgraph cache. Its
+  /// value is a single byte; any non-zero value enables it.
+  static constexpr const char* kCacheSubgraphKey = "cache_subgraph";
+
+  using SubgraphPtr =
+      std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)>;
+
+  /**
+   * Returns the cache entry for the serialized graph in `buffer`, creating an
+   * empty one if there is none yet. Returns nullptr if another graph already
+   * holds the entry, in which case the delegate should build its subgraph
+   * privately.
+   *
+   * If `mapped` is not null, it is a read-only file mapping that holds
+   * `buffer`, and a new entry takes it over instead of copying the graph.
+   */
+  static std::shared_ptr<XNNSubgraphCache> get_or_create(
+      const void* buffer,
+      size_t num_bytes,
+      FreeableBuffer* mapped = nullptr);
+
+  /// Drops all cached subgraphs. Delegates that use one keep it alive until
+  /// they are destroyed.
+  static void clear();
+
+  XNNSubgraphCache(const XNNSubgraphCache&) = delete;
+  XNNSubgraphCache& operator=(const XNNSubgraphCache&) = delete;
+
+  /// The cache's copy or mapping of the serialized graph, to build and wire
+  /// delegates from.
+  const void* buffer() const {
+    return data_;
+  }
+
+  /// Whether a delegate has built the subgraph yet.
+  bool is_built() const {
+    return subgraph_ != nullptr;
+  }
+
+  xnn_subgraph_t subgraph() const {
+    return subgraph_.get();
+  }
+
+  /// The ids that XNNPACK gave the serialized values, by serialized id.
+  const std::unordered_map<uint32_t, uint32_t>& remapped_ids() const {
+    return remapped_ids_;
+  }
+
+  /// Stores the subgraph that the first delegate built from buffer(), once
+  /// it created a runtime from it.
+  void set_built(
+      SubgraphPtr subgraph,
+      std::unordered_map<uint32_t, uint32_t> remapped_ids);
+
+  /// Serializes using the entry. Creating a runtime optimizes the subgraph
+  /// in place, so only one delegate may do it at a time.
+  std::mutex& mutex() {
+    return mutex_;
+  }
+
+ private:
+  /// Storage for the copy of the serialized graph, aligned like its constant
+  /// buffers.
+  struct alignas(16) Chunk {
+    uint8_t bytes[16];
+  };
+
+  XNNSubgraphCache(const void* buffer, size_t num_bytes);
+  XNNSubgraphCache(
+      FreeableBuffer&& mapped,
+      const void* buffer,
+      size_t num_bytes);
+
+  /// Whether `buffer` holds the same serialized graph as this entry.
+  bool matches(const void* buffer, size_t num_bytes) const;
+
+  std::unique_ptr<Chunk[]> buffer_;
+  /// Holds the serialized graph instead of buffer_, if it was mapped.
+  FreeableBuffer mapped_;
+  const void* data_;
+  const size_t num_bytes_;
+  SubgraphPtr subgraph_{nullptr, &xnn_delete_subgraph};
+  std::unordered_map<uint32_t, uint32_t> remapped_ids_;
+  std::mutex mutex_;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace executor
+} // namespace torch
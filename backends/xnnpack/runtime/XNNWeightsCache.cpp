@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
+
+#include <executorch/backends/xnnpack/runtime/XNNStatus.h>
+#include <executorch/runtime/platform/log.h>
+#include <cstring>
+#include <unordered_map>
+
+namespace torch {
+namespace executor {
+namespace xnnpack {
+namespace delegate {
+
+namespace {
+
+/// 64-bit FNV-1a over `num_bytes` of `buffer`, mixed with the size. Processes
+/// a word at a time, since the serialized graph holds all of the weights.
+uint64_t hash_buffer(const void* buffer, size_t num_bytes) {
+  constexpr uint64_t kPrime = 0x100000001b3ULL;
+  uint64_t hash = 0xcbf29ce484222325ULL ^ num_bytes;
+  const uint8_t* data = static_cast<const uint8_t*>(buffer);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= num_bytes; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kPrime;
+  }
+  for (; i < num_bytes; i++) {
+    hash = (hash ^ data[i]) * kPrime;
+  }
+  return hash;
+}
+
+std::mutex& registry_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+/// Live caches by the hash of their serialized graph.
+std::unordered_map<uint64_t, std::weak_ptr<XNNWeightsCache>>& registry() {
+  static auto* caches =
+      new std::unordered_map<uint64_t, std::weak_ptr<XNNWeightsCache>>();
+  return *caches;
+}
+
+} // namespace
+
+std::shared_ptr<XNNWeightsCache> XNNWeightsCache::get_or_create(
+    const void* buffer,
+    size_t num_bytes,
+    uint32_t runtime_flags) {
+  const uint64_t key = hash_buffer(buffer, num_bytes) ^
+      (static_cast<uint64_t>(runtime_flags) * 0x9e3779b97f4a7c15ULL);
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  auto& caches = registry();
+  auto it = caches.find(key);
+  if (it != caches.end()) {
+    std::shared_ptr<XNNWeightsCache> existing = it->second.lock();
+    if (existing != nullptr) {
+      return existing;
+    }
+  }
+
+  xnn_weights_cache_t cache = nullptr;
+  xnn_status status = xnn_create_weights_cache(&cache);
+  if (status != xnn_status_success) {
+    ET_LOG(
+        Error,
+        "Failed to create XNNPACK weights cache with code: %s",
+        xnn_status_to_string(status));
+    return nullptr;
+  }
+  std::shared_ptr<XNNWeightsCache> created(new XNNWeightsCache(key, cache));
+  caches[key] = created;
+  return created;
+}
+
+XNNWeightsCache::~XNNWeightsCache() {
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    auto& caches = registry();
+    auto it = caches.find(key_);
+    // A new cache may already have replaced this one for the same key.
+    if (it != caches.end() && it->second.expired()) {
+      caches.erase(it);
+    }
+  }
+  xnn_delete_weights_cache(cache_);
+}
+
+xnn_status XNNWeightsCache::finalize() {
+  xnn_status status = xnn_finalize_weights_cache(
+      cache_, xnn_weights_cache_finalization_kind_soft);
+  if (status == xnn_status_success) {
+    finalized_ = true;
+  }
+  return status;
+}
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace executor
+} // namespace torch
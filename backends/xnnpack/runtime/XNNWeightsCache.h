@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <xnnpack.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace torch {
+namespace executor {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * An XNNPACK weights cache that delegates built from the same serialized
+ * graph share, so that their packed weights are only kept once. This is what
+ * lets a program that is loaded once per worker thread, with a Method per
+ * thread, avoid repacking every weight for each Method.
+ *
+ * Caches are process-wide and looked up by the contents of the serialized
+ * graph. The first delegate to use a cache packs the weights into it and
+ * finalizes it; later delegates find all of their weights already packed.
+ * The cache is destroyed once the last delegate that uses it is.
+ */
+class XNNWeightsCache final {
+ public:
+  /// Compile spec key that makes a delegate share its weights cache. Its
+  /// value is a single byte; any non-zero value enables sharing.
+  static constexpr const char* kShareWeightsCacheKey = "share_weights_cache";
+
+  /**
+   * Returns the cache for the serialized graph in `buffer`, creating it if no
+   * live delegate uses one yet, or nullptr if XNNPACK failed to create it.
+   * Runtimes created with different `runtime_flags` pack weights differently,
+   * e.g. to fp16, so they get different caches.
+   */
+  static std::shared_ptr<XNNWeightsCache> get_or_create(
+      const void* buffer,
+      size_t num_bytes,
+      uint32_t runtime_flags = 0);
+
+  ~XNNWeightsCache();
+
+  XNNWeightsCache(const XNNWeightsCache&) = delete;
+  XNNWeightsCache& operator=(const XNNWeightsCache&) = delete;
+
+  xnn_weights_cache_t get() const {
+    return cache_;
+  }
+
+  /// Whether the weights have been packed, so the cache only serves lookups.
+  bool is_finalized() const {
+    return finalized_;
+  }
+
+  /// Finalizes the cache once the first runtime using it has been created.
+  /// Later runtimes may only look up weights, which keeps their addresses
+  /// stable for runtimes that already run.
+  xnn_status finalize();
+
+  /// Serializes creating runtimes against the cache, since the first one
+  /// fills it and the rest must wait for it to be finalized.
+  std::mutex& mutex() {
+    return mutex_;
+  }
+
+ private:
+  XNNWeightsCache(uint64_t key, xnn_weights_cache_t cache)
+      : key_(key), cache_(cache) {}
+
+  const uint64_t key_;
+  xnn_weights_cache_t cache_;
+  bool finalized_ = false;
+  std::mutex mutex_;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace executor
+} // namespace torch
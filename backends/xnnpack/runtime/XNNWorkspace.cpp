@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
+
+#include <executorch/backends/xnnpack/runtime/XNNStatus.h>
+#include <executorch/runtime/platform/log.h>
+#include <unordered_map>
+
+namespace torch {
+namespace executor {
+namespace xnnpack {
+namespace delegate {
+
+namespace {
+
+std::mutex& registry_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+/// Live workspaces by name.
+std::unordered_map<std::string, std::weak_ptr<XNNWorkspace>>& registry() {
+  static auto* workspaces =
+      new std::unordered_map<std::string, std::weak_ptr<XNNWorkspace>>();
+  return *workspaces;
+}
+
+} // namespace
+
+std::shared_ptr<XNNWorkspace> XNNWorkspace::get_or_create(const char* name) {
+  std::lock_guard<std::mutex> lock(registry_mutex());
+  auto& workspaces = registry();
+  auto it = workspaces.find(name);
+  if (it != workspaces.end()) {
+    std::shared_ptr<XNNWorkspace> existing = it->second.lock();
+    if (existing != nullptr) {
+      return existing;
+    }
+  }
+
+  xnn_workspace_t workspace = nullptr;
+  xnn_status status = xnn_create_workspace(&workspace);
+  if (status != xnn_status_success) {
+    ET_LOG(
+        Error,
+        "Failed to create XNNPACK workspace with code: %s",
+        xnn_status_to_string(status));
+    return nullptr;
+  }
+  std::shared_ptr<XNNWorkspace> created(new XNNWorkspace(name, workspace));
+  workspaces[name] = created;
+  return created;
+}
+
+XNNWorkspace::~XNNWorkspace() {
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    auto& workspaces = registry();
+    auto it = workspaces.find(name_);
+    // A new workspace may already have replaced this one for the same name.
+    if (it != workspaces.end() && it->second.expired()) {
+      workspaces.erase(it);
+    }
+  }
+  // Runtimes hold their own reference to the workspace, so this only frees
+  // it once they are gone too.
+  xnn_release_workspace(workspace_);
+}
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <xnnpack.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace torch {
+namespace executor {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * An XNNPACK workspace, the arena that a runtime keeps its intermediate
+ * values in, shared by every delegate that names it. Delegates that never
+ * run at the same time, like the many XNNPACK subgraphs of a partitioned
+ * Method, then only need as much scratch memory as the largest of them
+ * instead of the sum.
+ *
+ * Workspaces are process-wide and looked up by name. Delegates that share
+ * one must not run concurrently, so execution holds mutex() for the
+ * duration of the call. A workspace is destroyed once the last delegate
+ * that uses it is.
+ */
+class XNNWorkspace final {
+ public:
+  /// Compile spec key with the name of the workspace a delegate uses. Its
+  /// value is the name, without a terminating null.
+  static constexpr const char* kWorkspaceKey = "workspace";
+  static constexpr size_t kMaxNameLength = 64;
+
+  /**
+   * Returns the workspace named `name`, creating it if no live delegate uses
+   * one yet, or nullptr if XNNPACK failed to create it.
+   */
+  static std::shared_ptr<XNNWorkspace> get_or_create(const char* name);
+
+  ~XNNWorkspace();
+
+  XNNWorkspace(const XNNWorkspace&) = delete;
+  XNNWorkspace& operator=(const XNNWorkspace&) = delete;
+
+  xnn_workspace_t get() const {
+    return workspace_;
+  }
+
+  /// Serializes running the runtimes that share this workspace.
+  std::mutex& mutex() {
+    return mutex_;
+  }
+
+  /**
+   * Setting a runtime up may move the workspace, which leaves the other
+   * runtimes in it pointing at the old memory. Runtimes record the value
+   * that note_setup() returned when they were set up, and must be set up
+   * again before running if num_setups() no longer matches it. Both must be
+   * called with mutex() held.
+   */
+  uint64_t note_setup() {
+    return ++num_setups_;
+  }
+  uint64_t num_setups() const {
+    return num_setups_;
+  }
+
+ private:
+  XNNWorkspace(std::string name, xnn_workspace_t workspace)
+      : name_(std::move(name)), workspace_(workspace) {}
+
+  const std::string name_;
+  xnn_workspace_t workspace_;
+  uint64_t num_setups_ = 0;
+  std::mutex mutex_;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace executor
+} // namespace torch
@@ -366,6 +366,7 @@ class XNNDatatype(IntEnum):
     xnn_datatype_qint32 = 5
     xnn_datatype_qcint8 = 6
     xnn_datatype_qcint32 = 7
+    xnn_datatype_qbint4 = 8
 
 
 @dataclass
@@ -380,7 +381,14 @@ class PerTensorQuant:
     zero_point: int
 
 
-XNNQuantParams = Union[PerChannelQuant, PerTensorQuant]
+@dataclass
+class PerChannelGroupQuant:
+    scale_bf16: List[int]
+    channel_dim: int
+    group_size: int
+
+
+XNNQuantParams = Union[PerChannelQuant, PerTensorQuant, PerChannelGroupQuant]
 
 
 @dataclass
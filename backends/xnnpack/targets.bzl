@@ -2,6 +2,14 @@ load("@fbsource//xplat/executorch/backends/xnnpack/third-party:third_party_libs.
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 
 def define_common_targets():
+    # Supports dynamic input shapes by reshaping the XNNPACK runtime when they
+    # change. Needs an XNNPACK with xnn_reshape_runtime().
+    xnnpack_reshape = native.read_config("executorch", "xnnpack_reshape", "false") == "true"
+
+    # Accepts 4-bit blockwise quantized (qb4w) weights. Needs an XNNPACK with
+    # xnn_define_blockwise_quantized_tensor_value().
+    xnnpack_qb4w = native.read_config("executorch", "xnnpack_qb4w", "false") == "true"
+
     runtime.cxx_library(
         name = "dynamic_quant_utils",
         srcs = [
@@ -67,7 +75,9 @@ def define_common_targets():
         ],
         preprocessor_flags = [
             # "-DENABLE_XNNPACK_PROFILING",
-        ] + ([] if runtime.is_oss else ["-DENABLE_DYNAMIC_QUANTIZATION"]),
+        ] + ([] if runtime.is_oss else ["-DENABLE_DYNAMIC_QUANTIZATION"]) + (
+            ["-DENABLE_XNNPACK_RESHAPE"] if xnnpack_reshape else []
+        ) + (["-DENABLE_XNNPACK_QB4W"] if xnnpack_qb4w else []),
         deps = [
             third_party_dep("XNNPACK"),
             ":xnnpack_schema",
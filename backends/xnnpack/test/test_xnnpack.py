@@ -36,11 +36,25 @@ class TestXNNPACKFloatingPoint(TestXNNPACK):
                 super().__init__()
 
             def forward(self, x):
-                return torch.mean(x, (3), keepdim=True)
+                return torch.mean(x, (1), keepdim=True)
 
         example_inputs = (torch.randn(1, 5, 4, 4),)
         self.lower_and_test_with_partitioner(Mean(), example_inputs)
 
+    def test_xnnpack_backend_mean_dim_innermost(self):
+        class Mean(torch.nn.Module):
+            def __init__(self, dims, keepdim):
+                super().__init__()
+                self.dims = dims
+                self.keepdim = keepdim
+
+            def forward(self, x):
+                return torch.mean(x, self.dims, keepdim=self.keepdim)
+
+        example_inputs = (torch.randn(2, 5, 4, 3),)
+        for dims, keepdim in (((-1,), True), ((-1,), False), ((2, 3), False)):
+            self.lower_and_test_with_partitioner(Mean(dims, keepdim), example_inputs)
+
     def test_xnnpack_backend_static_transpose(self):
         class PermuteModule(torch.nn.Module):
             def __init__(self):
@@ -405,6 +419,35 @@ class TestXNNPACKFloatingPoint(TestXNNPACK):
         sigmoid_module = SigmoidModule()
         self.lower_and_test_with_partitioner(sigmoid_module, model_inputs)
 
+    def test_xnnpack_backend_tanh(self):
+        class TanhModule(torch.nn.Module):
+            def forward(self, x):
+                return torch.tanh(x)
+
+        model_inputs = (torch.randn(7, 5, 3),)
+        self.lower_and_test_with_partitioner(TanhModule(), model_inputs)
+
+    def test_xnnpack_backend_gelu_tanh(self):
+        gelu_module = torch.nn.GELU(approximate="tanh")
+        model_inputs = (torch.randn(7, 5, 3) * 4,)
+        self.lower_and_test_with_partitioner(gelu_module, model_inputs)
+
+    def test_xnnpack_backend_layer_norm(self):
+        for layer_norm in (
+            torch.nn.LayerNorm(16),
+            torch.nn.LayerNorm([4, 16], elementwise_affine=False),
+        ):
+            model_inputs = (torch.randn(2, 4, 16),)
+            self.lower_and_test_with_partitioner(layer_norm.eval(), model_inputs)
+
+    def test_xnnpack_backend_cat_many(self):
+        class CatModule(torch.nn.Module):
+            def forward(self, a, b, c, d, e, f):
+                return torch.cat((a, b, c, d, e, f), dim=1)
+
+        model_inputs = tuple(torch.randn(2, i + 1, 3) for i in range(6))
+        self.lower_and_test_with_partitioner(CatModule(), model_inputs)
+
     # FIXME (T148779166)
     @unittest.expectedFailure
     def test_xnnpack_backend_static_resize_bilinear_2d(self):
@@ -15,6 +15,7 @@ def define_common_targets():
 
     _THREADPOOL_HEADERS = [
         "threadpool.h",
+        "threadpool_chain_executor.h",
         "threadpool_guard.h",
     ] + (["fb/threadpool_use_n_threads.h"] if not runtime.is_oss else [])
 
@@ -26,6 +27,7 @@ def define_common_targets():
         ],
         exported_headers = _THREADPOOL_HEADERS,
         exported_deps = [
+            "//executorch/runtime/executor:chain_executor",
             third_party_dep("pthreadpool"),
             third_party_dep("cpuinfo"),
         ],
@@ -18,3 +18,13 @@ def define_common_targets():
             "//executorch/backends/xnnpack/threadpool:threadpool",
         ],
     )
+
+    runtime.cxx_binary(
+        name = "threadpool_contention_benchmark",
+        srcs = [
+            "threadpool_contention_benchmark.cpp",
+        ],
+        deps = [
+            "//executorch/backends/xnnpack/threadpool:threadpool",
+        ],
+    )
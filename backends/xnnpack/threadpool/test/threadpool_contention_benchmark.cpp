@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Measures how well concurrent callers of ThreadPool::run() share one pool,
+ * as happens when several Methods execute on different threads at once. Each
+ * caller thread runs a fixed number of parallel regions that each do a fixed
+ * amount of work, and the benchmark reports the wall time per region.
+ *
+ * Usage:
+ *   threadpool_contention_benchmark [callers] [regions] [pool_threads]
+ *
+ * With perfect scaling the time per region stays flat as callers are added,
+ * until the pools together have more threads than the machine has CPUs.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
+
+using torch::executorch::threadpool::ThreadPool;
+
+namespace {
+constexpr size_t kDefaultCallers = 4;
+constexpr size_t kDefaultRegions = 1000;
+constexpr size_t kDefaultPoolThreads = 2;
+constexpr size_t kTasksPerRegion = 64;
+constexpr size_t kWorkPerTask = 2000;
+
+size_t arg_or(int argc, char** argv, int index, size_t default_value) {
+  return argc > index
+      ? static_cast<size_t>(std::strtoull(argv[index], nullptr, 10))
+      : default_value;
+}
+
+// A region whose tasks each spin for a while, so that the benchmark measures
+// contention on the pool rather than the cost of an empty region.
+void run_region(ThreadPool& pool, std::vector<uint64_t>& sinks) {
+  pool.run(
+      [&sinks](size_t task_id) {
+        uint64_t value = task_id;
+        for (size_t i = 0; i < kWorkPerTask; ++i) {
+          value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        sinks[task_id] = value;
+      },
+      kTasksPerRegion);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t num_callers = arg_or(argc, argv, 1, kDefaultCallers);
+  const size_t num_regions = arg_or(argc, argv, 2, kDefaultRegions);
+  const size_t pool_threads = arg_or(argc, argv, 3, kDefaultPoolThreads);
+
+  ThreadPool pool(pool_threads);
+  std::vector<std::vector<uint64_t>> sinks(
+      num_callers, std::vector<uint64_t>(kTasksPerRegion, 0));
+
+  // Warm up, which also creates the spare pools that concurrent callers use.
+  for (size_t i = 0; i < num_callers; ++i) {
+    run_region(pool, sinks[i]);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> callers;
+  for (size_t i = 0; i < num_callers; ++i) {
+    callers.emplace_back([&pool, &sinks, num_regions, i]() {
+      for (size_t region = 0; region < num_regions; ++region) {
+        run_region(pool, sinks[i]);
+      }
+    });
+  }
+  for (std::thread& caller : callers) {
+    caller.join();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const double total_us =
+      std::chrono::duration<double, std::micro>(end - start).count();
+  const size_t total_regions = num_callers * num_regions;
+  printf(
+      "%zu callers x %zu regions on %zu pool threads: %.1f us total, "
+      "%.2f us per region\n",
+      num_callers,
+      num_regions,
+      pool.get_thread_count(),
+      total_us,
+      total_regions > 0 ? total_us / total_regions : 0.0);
+  return 0;
+}
@@ -7,11 +7,16 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <numeric>
 #include <random>
+#include <thread>
 
 #include <executorch/backends/xnnpack/threadpool/threadpool.h>
+#include <executorch/backends/xnnpack/threadpool/threadpool_chain_executor.h>
 #include <executorch/backends/xnnpack/threadpool/threadpool_guard.h>
 
 using namespace ::testing;
@@ -186,3 +191,175 @@ TEST(TestNoThreadPoolGuard, TestRunWithGuard) {
   }
   ASSERT_EQ(inner, 6);
 }
+
+TEST(ThreadPoolTest, ChainExecutorRunsEveryTask) {
+  torch::executorch::threadpool::ThreadPool threadpool(2);
+  torch::executorch::threadpool::ThreadPoolChainExecutor executor(&threadpool);
+
+  std::vector<int32_t> visited(16, 0);
+  executor.run(
+      [](void* context, size_t task_index) {
+        (*static_cast<std::vector<int32_t>*>(context))[task_index] += 1;
+      },
+      &visited,
+      visited.size());
+
+  for (size_t i = 0; i < visited.size(); ++i) {
+    EXPECT_EQ(visited[i], 1);
+  }
+}
+
+TEST(ThreadPoolTest, NamedThreadPoolsAreSharedByName) {
+  using namespace torch::executorch::threadpool;
+  ThreadPool* first = get_named_threadpool("named_test_pool", 2);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->get_thread_count(), 2);
+
+  // The thread count only applies when the pool is created.
+  EXPECT_EQ(get_named_threadpool("named_test_pool", 3), first);
+  EXPECT_EQ(first->get_thread_count(), 2);
+
+  ThreadPool* other = get_named_threadpool("other_named_test_pool", 1);
+  EXPECT_NE(other, first);
+  EXPECT_NE(other, get_threadpool());
+  EXPECT_EQ(other->get_thread_count(), 1);
+
+  {
+    NoThreadPoolGuard guard;
+    EXPECT_EQ(get_named_pthreadpool("named_test_pool", 2), nullptr);
+  }
+  EXPECT_NE(get_named_pthreadpool("named_test_pool", 2), nullptr);
+}
+
+TEST(ThreadPoolTest, NamedThreadPoolCpusMustBeSetBeforeCreation) {
+  using namespace torch::executorch::threadpool;
+  const uint32_t cpus[] = {0};
+  EXPECT_TRUE(set_named_threadpool_cpus("pinned_test_pool", cpus, 1));
+
+  ThreadPool* pool = get_named_threadpool("pinned_test_pool", 2);
+  ASSERT_NE(pool, nullptr);
+  std::vector<int32_t> visited(8, 0);
+  pool->run([&visited](size_t task_id) { visited[task_id] += 1; }, 8);
+  for (size_t i = 0; i < visited.size(); ++i) {
+    EXPECT_EQ(visited[i], 1);
+  }
+
+  EXPECT_FALSE(set_named_threadpool_cpus("pinned_test_pool", cpus, 1));
+}
+
+TEST(ThreadPoolTest, ConcurrentRunsDoNotSerialize) {
+  using namespace torch::executorch::threadpool;
+  constexpr size_t kNumCallers = ThreadPool::kMaxConcurrentRuns;
+  ThreadPool pool(2);
+
+  // Every caller's region blocks until all of them have entered one, which
+  // only happens if the calls to run() overlap.
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t num_entered = 0;
+  std::vector<bool> overlapped(kNumCallers, false);
+  auto caller = [&](size_t caller_id) {
+    pool.run(
+        [&](size_t task_id) {
+          if (task_id != 0) {
+            return;
+          }
+          std::unique_lock<std::mutex> lock{mutex};
+          ++num_entered;
+          cv.notify_all();
+          overlapped[caller_id] = cv.wait_for(
+              lock, std::chrono::seconds(10), [&num_entered]() {
+                return num_entered == kNumCallers;
+              });
+        },
+        4);
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumCallers; ++i) {
+    threads.emplace_back(caller, i);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < kNumCallers; ++i) {
+    EXPECT_TRUE(overlapped[i]) << "caller " << i;
+  }
+}
+
+TEST(ThreadPoolTest, RunsBeyondTheConcurrencyLimitWait) {
+  using namespace torch::executorch::threadpool;
+  constexpr size_t kNumCallers = 2 * ThreadPool::kMaxConcurrentRuns;
+  constexpr size_t kRange = 64;
+  ThreadPool pool(2);
+
+  std::vector<std::vector<int32_t>> visited(
+      kNumCallers, std::vector<int32_t>(kRange, 0));
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumCallers; ++i) {
+    threads.emplace_back([&pool, &visited, i]() {
+      for (size_t iter = 0; iter < 16; ++iter) {
+        pool.run(
+            [&visited, i](size_t task_id) { visited[i][task_id] += 1; },
+            kRange);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < kNumCallers; ++i) {
+    for (size_t j = 0; j < kRange; ++j) {
+      EXPECT_EQ(visited[i][j], 16);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, CoreClassesSelectSubsetsOfAllCores) {
+  using namespace torch::executorch::threadpool;
+  const std::vector<uint32_t> all = get_cpus(CoreClass::All);
+  ASSERT_FALSE(all.empty());
+  const std::vector<uint32_t> performance = get_cpus(CoreClass::Performance);
+  const std::vector<uint32_t> fastest = get_cpus(CoreClass::Fastest);
+  EXPECT_FALSE(performance.empty());
+  EXPECT_FALSE(fastest.empty());
+  EXPECT_LE(fastest.size(), performance.size());
+  EXPECT_LE(performance.size(), all.size());
+  for (uint32_t cpu : performance) {
+    EXPECT_NE(std::find(all.begin(), all.end(), cpu), all.end());
+  }
+  for (uint32_t cpu : fastest) {
+    EXPECT_NE(
+        std::find(performance.begin(), performance.end(), cpu),
+        performance.end());
+  }
+}
+
+TEST(ThreadPoolTest, ResizeKeepsPreviousPthreadpoolAlive) {
+  using namespace torch::executorch::threadpool;
+  ThreadPool* pool = get_named_threadpool("resize_test_pool", 2);
+  ASSERT_NE(pool, nullptr);
+  pthreadpool_t previous = get_named_pthreadpool("resize_test_pool", 2);
+  ASSERT_NE(previous, nullptr);
+
+  const std::vector<uint32_t> cpus = get_cpus(CoreClass::Performance);
+  ASSERT_TRUE(pool->resize(3, cpus.data(), cpus.size()));
+  EXPECT_EQ(pool->get_thread_count(), 3);
+  pthreadpool_t current = get_named_pthreadpool("resize_test_pool", 2);
+  EXPECT_NE(current, previous);
+
+  std::vector<int32_t> visited(16, 0);
+  pool->run([&visited](size_t task_id) { visited[task_id] += 1; }, 16);
+  // Delegates may still hold the previous pool, so it must keep working.
+  pthreadpool_parallelize_1d(
+      previous,
+      [](void* context, size_t task_id) {
+        (*static_cast<std::vector<int32_t>*>(context))[task_id] += 1;
+      },
+      &visited,
+      visited.size(),
+      0u);
+  for (size_t i = 0; i < visited.size(); ++i) {
+    EXPECT_EQ(visited[i], 2);
+  }
+}
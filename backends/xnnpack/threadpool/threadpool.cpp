@@ -9,11 +9,19 @@
 #include <executorch/backends/xnnpack/threadpool/threadpool.h>
 #include <executorch/backends/xnnpack/threadpool/threadpool_guard.h>
 #include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/log.h>
 #include <algorithm>
 
 #include <cpuinfo.h>
 
 #include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 namespace torch {
 namespace executorch {
@@ -35,31 +43,128 @@ void child_atfork() {
 #endif
 
 ThreadPool::ThreadPool(size_t thread_count)
-    : threadpool_(pthreadpool_create(thread_count), pthreadpool_destroy) {}
+    : ThreadPool(thread_count, nullptr, 0) {}
+
+ThreadPool::ThreadPool(
+    size_t thread_count,
+    const uint32_t* cpus,
+    size_t num_cpus)
+    : thread_count_(thread_count),
+      cpus_(cpus, cpus + num_cpus),
+      threadpool_(create_pthreadpool()),
+      current_(threadpool_.get()) {}
+
+ThreadPool::PthreadpoolPtr ThreadPool::create_pthreadpool() const {
+#if defined(__linux__)
+  // Threads inherit the affinity of the thread that creates them, so pin
+  // this thread while pthreadpool starts its workers and restore it after.
+  cpu_set_t previous;
+  bool pinned = false;
+  if (!cpus_.empty() &&
+      sched_getaffinity(0, sizeof(previous), &previous) == 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (uint32_t cpu : cpus_) {
+      if (cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+      }
+    }
+    pinned = sched_setaffinity(0, sizeof(set), &set) == 0;
+    if (!pinned) {
+      ET_LOG(Error, "Failed to pin threadpool to %zu CPUs", cpus_.size());
+    }
+  }
+  PthreadpoolPtr threadpool(
+      pthreadpool_create(thread_count_), pthreadpool_destroy);
+  if (pinned) {
+    sched_setaffinity(0, sizeof(previous), &previous);
+  }
+  return threadpool;
+#else
+  return PthreadpoolPtr(pthreadpool_create(thread_count_), pthreadpool_destroy);
+#endif
+}
 
 size_t ThreadPool::get_thread_count() const {
-  std::lock_guard<std::mutex> lock{mutex_};
+  pthreadpool_t threadpool = current_.load(std::memory_order_acquire);
+  ET_CHECK_MSG(threadpool, "Invalid threadpool!");
+  return pthreadpool_get_threads_count(threadpool);
+}
+
+bool ThreadPool::resize(
+    size_t thread_count,
+    const uint32_t* cpus,
+    size_t num_cpus) {
+  // Keeps run() off the primary pool.
+  std::lock_guard<std::mutex> run_lock{run_mutex_};
+  {
+    // Keeps run() off the spares, which were made for the old size.
+    std::unique_lock<std::mutex> lock{spares_mutex_};
+    resizing_ = true;
+    spares_idle_.wait(lock, [this] { return spares_.size() == num_spares_; });
+    spares_.clear();
+    num_spares_ = 0;
+  }
+
+  const size_t previous_thread_count = thread_count_;
+  std::vector<uint32_t> previous_cpus(cpus, cpus + num_cpus);
+  std::swap(cpus_, previous_cpus);
+  thread_count_ = thread_count;
+  PthreadpoolPtr threadpool = create_pthreadpool();
+  const bool created = threadpool != nullptr;
+  if (created) {
+    retired_.push_back(std::move(threadpool_));
+    threadpool_ = std::move(threadpool);
+    current_.store(threadpool_.get(), std::memory_order_release);
+  } else {
+    ET_LOG(Error, "Failed to resize threadpool to %zu threads", thread_count);
+    thread_count_ = previous_thread_count;
+    std::swap(cpus_, previous_cpus);
+  }
 
-  ET_CHECK_MSG(threadpool_.get(), "Invalid threadpool!");
-  return pthreadpool_get_threads_count(threadpool_.get());
+  std::lock_guard<std::mutex> lock{spares_mutex_};
+  resizing_ = false;
+  return created;
 }
 
-void ThreadPool::run(
-    const std::function<void(size_t)>& fn,
-    const size_t range) {
-  // Run on same thread if NoThreadPoolGuard guard is enabled
-  if (NoThreadPoolGuard::is_enabled()) {
-    for (size_t i = 0; i < range; ++i) {
-      fn(i);
+ThreadPool::PthreadpoolPtr ThreadPool::acquire_spare() {
+  {
+    std::lock_guard<std::mutex> lock{spares_mutex_};
+    if (resizing_) {
+      return PthreadpoolPtr(nullptr, pthreadpool_destroy);
     }
-    return;
+    if (!spares_.empty()) {
+      PthreadpoolPtr spare = std::move(spares_.back());
+      spares_.pop_back();
+      return spare;
+    }
+    if (num_spares_ + 1 >= kMaxConcurrentRuns) {
+      return PthreadpoolPtr(nullptr, pthreadpool_destroy);
+    }
+    ++num_spares_;
+  }
+  // Start the workers outside of the lock, since it takes a while.
+  PthreadpoolPtr spare = create_pthreadpool();
+  if (spare == nullptr) {
+    std::lock_guard<std::mutex> lock{spares_mutex_};
+    --num_spares_;
+    spares_idle_.notify_all();
   }
+  return spare;
+}
 
-  std::lock_guard<std::mutex> lock{mutex_};
+void ThreadPool::release_spare(PthreadpoolPtr spare) {
+  std::lock_guard<std::mutex> lock{spares_mutex_};
+  spares_.push_back(std::move(spare));
+  spares_idle_.notify_all();
+}
 
-  ET_CHECK_MSG(!NoThreadPoolGuard::is_enabled(), "Inside a threadpool guard!");
-  ET_CHECK_MSG(threadpool_.get(), "Invalid threadpool!");
+namespace {
 
+void parallelize(
+    pthreadpool_t threadpool,
+    const std::function<void(size_t)>& fn,
+    const size_t range) {
   struct Context final {
     const std::function<void(size_t)>& fn;
   } context{
@@ -67,7 +172,7 @@ void ThreadPool::run(
   };
 
   pthreadpool_parallelize_1d(
-      threadpool_.get(),
+      threadpool,
       // Note: pthreadpool_parallelize_1d() is a blocking function.  The
       // function pointer to this lambda passed on to
       // pthreadpool_parallelize_1d() cannot go out of scope until
@@ -80,9 +185,39 @@ void ThreadPool::run(
       0u);
 }
 
-// get_threadpool is not thread safe due to leak_corrupted_threadpool
-// Make this part threadsafe: TODO(kimishpatel)
-ThreadPool* get_threadpool() {
+} // namespace
+
+void ThreadPool::run(
+    const std::function<void(size_t)>& fn,
+    const size_t range) {
+  // Run on same thread if NoThreadPoolGuard guard is enabled
+  if (NoThreadPoolGuard::is_enabled()) {
+    for (size_t i = 0; i < range; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  ET_CHECK_MSG(
+      current_.load(std::memory_order_acquire), "Invalid threadpool!");
+
+  std::unique_lock<std::mutex> lock{run_mutex_, std::try_to_lock};
+  if (!lock.owns_lock()) {
+    PthreadpoolPtr spare = acquire_spare();
+    if (spare != nullptr) {
+      parallelize(spare.get(), fn, range);
+      release_spare(std::move(spare));
+      return;
+    }
+    // Every pool is busy; wait for the primary one like a lone caller would.
+    lock.lock();
+  }
+  parallelize(threadpool_.get(), fn, range);
+}
+
+namespace {
+
+int default_thread_count() {
   ET_CHECK_MSG(cpuinfo_initialize(), "cpuinfo initialization failed");
   int num_threads = cpuinfo_get_processors_count();
   /*
@@ -94,8 +229,75 @@ ThreadPool* get_threadpool() {
    * threadcount to the tsan limit unconditionally.
    */
   constexpr int tsan_thread_limit = 63;
-  num_threads = std::min(num_threads, tsan_thread_limit);
-  static auto threadpool = std::make_unique<ThreadPool>(num_threads);
+  return std::min(num_threads, tsan_thread_limit);
+}
+
+// The Linux id of the processor at `index` in cpuinfo's list, which is what
+// sched_setaffinity() expects. Pinning is Linux-only, so elsewhere the index
+// serves.
+uint32_t cpu_id(uint32_t index) {
+#if defined(__linux__)
+  return static_cast<uint32_t>(cpuinfo_get_processor(index)->linux_id);
+#else
+  return index;
+#endif
+}
+
+struct NamedThreadPool {
+  std::vector<uint32_t> cpus;
+  std::unique_ptr<ThreadPool> threadpool;
+};
+
+std::mutex& named_threadpools_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Leaked so that pools outlive any delegate destroyed during static
+// destruction.
+std::unordered_map<std::string, NamedThreadPool>& named_threadpools() {
+  static auto* pools = new std::unordered_map<std::string, NamedThreadPool>();
+  return *pools;
+}
+
+} // namespace
+
+std::vector<uint32_t> get_cpus(CoreClass core_class) {
+  ET_CHECK_MSG(cpuinfo_initialize(), "cpuinfo initialization failed");
+  const uint32_t num_clusters = cpuinfo_get_clusters_count();
+  uint64_t min_frequency = UINT64_MAX;
+  uint64_t max_frequency = 0;
+  for (uint32_t i = 0; i < num_clusters; ++i) {
+    const uint64_t frequency = cpuinfo_get_cluster(i)->frequency;
+    min_frequency = std::min(min_frequency, frequency);
+    max_frequency = std::max(max_frequency, frequency);
+  }
+  const bool heterogeneous = max_frequency > min_frequency;
+
+  std::vector<uint32_t> cpus;
+  for (uint32_t i = 0; i < num_clusters; ++i) {
+    const struct cpuinfo_cluster* cluster = cpuinfo_get_cluster(i);
+    if (heterogeneous) {
+      if (core_class == CoreClass::Performance &&
+          cluster->frequency == min_frequency) {
+        continue;
+      }
+      if (core_class == CoreClass::Fastest &&
+          cluster->frequency != max_frequency) {
+        continue;
+      }
+    }
+    for (uint32_t p = 0; p < cluster->processor_count; ++p) {
+      cpus.push_back(cpu_id(cluster->processor_start + p));
+    }
+  }
+  return cpus;
+}
+
+// get_threadpool is not thread safe due to leak_corrupted_threadpool
+// Make this part threadsafe: TODO(kimishpatel)
+ThreadPool* get_threadpool() {
+  static auto threadpool = std::make_unique<ThreadPool>(default_thread_count());
 
 // Inheriting from old threadpool to get around segfault issue
 // commented above at child_atfork
@@ -122,7 +324,54 @@ pthreadpool_t get_pthreadpool() {
   }
   ThreadPool* const threadpool = get_threadpool();
   ET_CHECK_MSG(threadpool, "Failed to acquire an instance of ThreadPool!");
-  return threadpool->threadpool_.get();
+  return threadpool->current_.load(std::memory_order_acquire);
+}
+
+bool resize_threadpool(size_t thread_count, CoreClass core_class) {
+  std::vector<uint32_t> cpus = get_cpus(core_class);
+  if (thread_count == 0) {
+    thread_count = cpus.size();
+  }
+  if (core_class == CoreClass::All) {
+    // Like the default pool, don't restrict the threads to any CPUs.
+    cpus.clear();
+  }
+  return get_threadpool()->resize(thread_count, cpus.data(), cpus.size());
+}
+
+bool set_named_threadpool_cpus(
+    const char* name,
+    const uint32_t* cpus,
+    size_t num_cpus) {
+  std::lock_guard<std::mutex> lock{named_threadpools_mutex()};
+  NamedThreadPool& pool = named_threadpools()[name];
+  if (pool.threadpool != nullptr) {
+    return false;
+  }
+  pool.cpus.assign(cpus, cpus + num_cpus);
+  return true;
+}
+
+ThreadPool* get_named_threadpool(const char* name, size_t thread_count) {
+  std::lock_guard<std::mutex> lock{named_threadpools_mutex()};
+  NamedThreadPool& pool = named_threadpools()[name];
+  if (pool.threadpool == nullptr) {
+    if (thread_count == 0) {
+      thread_count = default_thread_count();
+    }
+    pool.threadpool = std::make_unique<ThreadPool>(
+        thread_count, pool.cpus.data(), pool.cpus.size());
+  }
+  return pool.threadpool.get();
+}
+
+pthreadpool_t get_named_pthreadpool(const char* name, size_t thread_count) {
+  if (NoThreadPoolGuard::is_enabled()) {
+    return nullptr;
+  }
+  ThreadPool* const threadpool = get_named_threadpool(name, thread_count);
+  ET_CHECK_MSG(threadpool, "Failed to acquire an instance of ThreadPool!");
+  return threadpool->current_.load(std::memory_order_acquire);
 }
 
 } // namespace threadpool
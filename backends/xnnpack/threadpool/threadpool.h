@@ -2,20 +2,47 @@
 
 #include <pthreadpool.h>
 
+// @nolint PATTERNLINT Ok to use stdlib for this optional library
+#include <atomic>
+// @nolint PATTERNLINT Ok to use stdlib for this optional library
+#include <condition_variable>
 // @nolint PATTERNLINT Ok to use stdlib for this optional library
 #include <functional>
 // @nolint PATTERNLINT Ok to use stdlib for this optional library
 #include <memory>
 // @nolint PATTERNLINT Ok to use stdlib for this optional library
 #include <mutex>
+// @nolint PATTERNLINT Ok to use stdlib for this optional library
+#include <vector>
 
 namespace torch {
 namespace executorch {
 namespace threadpool {
 
+// Which cores of a CPU whose clusters differ in performance, like an ARM
+// big.LITTLE SoC, a pool runs on. Clusters are ranked by their maximum
+// frequency as reported by cpuinfo. On CPUs whose clusters all perform alike,
+// or whose frequencies are unknown, every class selects all cores.
+enum class CoreClass {
+  // Every core.
+  All,
+  // Every core except those of the slowest clusters, i.e. no little cores.
+  Performance,
+  // Only the cores of the fastest clusters, e.g. the prime core.
+  Fastest,
+};
+
+// Returns the CPUs of `core_class`, as the ids that pinning expects.
+std::vector<uint32_t> get_cpus(CoreClass core_class);
+
 class ThreadPool final {
  public:
   explicit ThreadPool(size_t thread_count = 0);
+
+  // Creates a pool whose worker threads are pinned to the `num_cpus` CPUs in
+  // `cpus`, e.g. to keep it on one cluster of a big.LITTLE system. Pinning is
+  // only supported on Linux and Android; elsewhere the CPUs are ignored.
+  ThreadPool(size_t thread_count, const uint32_t* cpus, size_t num_cpus);
   ~ThreadPool() = default;
 
   // Make threadpool non copyable
@@ -34,25 +61,70 @@ class ThreadPool final {
 
   size_t get_thread_count() const;
 
+  // Replaces the worker threads with `thread_count` new ones, pinned to the
+  // `num_cpus` CPUs in `cpus` if any, e.g. to move the pool off the little
+  // cores. Waits for the calls to run() in flight. Must not be called from
+  // within run().
+  //
+  // Delegates that were handed the previous pool by get_pthreadpool() keep
+  // using it, so it is kept alive, idle, until the ThreadPool is destroyed;
+  // reload them to pick up the new size. Returns false, and keeps the
+  // current threads, if the new ones can't be created.
+  bool resize(size_t thread_count, const uint32_t* cpus, size_t num_cpus);
+
   // Run, in parallel, function fn(task_id) over task_id in range [0, range).
   // This function is blocking.  All input is processed by the time it returns.
   // NoThreadPoolGuard (see threadpool_guard.h) can used to disable
-  // use of multiple threads with the scope of the guard
-  // When NoThreadPoolGuard is not used all calls to run method are serialized.
+  // use of multiple threads with the scope of the guard.
+  // Concurrent calls do not wait for each other: a call that finds the pool
+  // busy runs on a spare pool with the same thread count and CPUs instead.
+  // Up to kMaxConcurrentRuns calls run at once; any more wait for a pool.
   void run(const std::function<void(size_t)>& fn, size_t range);
 
+  // The most calls to run() that can be in flight at once, counting the one
+  // on the pool that get_pthreadpool() exposes.
+  static constexpr size_t kMaxConcurrentRuns = 4;
+
  private:
   friend pthreadpool_t get_pthreadpool();
+  friend pthreadpool_t get_named_pthreadpool(
+      const char* name,
+      size_t thread_count);
 
- private:
-  // This mutex is used inside get_thread_count API but it is not
-  // really needed. Since data members of ThreadPool objects are not
-  // really mutable.
-  // Figure out if we will allow set_num_threads API, in which mutex
-  // will be useful. Otherwise remove it.
-  // TODO(kimishpatel)
-  mutable std::mutex mutex_;
-  std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)> threadpool_;
+  using PthreadpoolPtr =
+      std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)>;
+
+  // Creates a pthreadpool with thread_count_ workers pinned to cpus_.
+  PthreadpoolPtr create_pthreadpool() const;
+
+  // Takes an idle spare pool, creating one if fewer than
+  // kMaxConcurrentRuns - 1 exist. Returns nullptr if all of them are busy.
+  PthreadpoolPtr acquire_spare();
+  void release_spare(PthreadpoolPtr spare);
+
+  // Only change in resize(), while run_mutex_ is held and no spare is in use.
+  size_t thread_count_;
+  std::vector<uint32_t> cpus_;
+
+  // The pool that run() prefers, and that XNNPACK is handed directly by
+  // get_pthreadpool(). run() holds run_mutex_ while it uses it, since
+  // pthreadpool itself serializes concurrent parallel regions on a pool.
+  // `current_` mirrors it for readers that don't hold the mutex.
+  PthreadpoolPtr threadpool_;
+  std::atomic<pthreadpool_t> current_;
+  std::mutex run_mutex_;
+
+  // The pools that resize() replaced, which delegates may still use.
+  std::vector<PthreadpoolPtr> retired_;
+
+  // Idle spare pools, and how many have been created in total. While
+  // `resizing_`, no spares are handed out, and spares_idle_ signals when the
+  // ones in use come back.
+  std::mutex spares_mutex_;
+  std::condition_variable spares_idle_;
+  std::vector<PthreadpoolPtr> spares_;
+  size_t num_spares_ = 0;
+  bool resizing_ = false;
 };
 
 // Return a singleton instance of ThreadPool for ATen/TH multithreading.
@@ -64,6 +136,28 @@ ThreadPool* get_threadpool();
 // use cases.
 pthreadpool_t get_pthreadpool();
 
+// Resizes the pool of get_threadpool() to `thread_count` threads pinned to
+// the cores of `core_class`; see ThreadPool::resize(). A `thread_count` of 0
+// picks one thread per core of the class.
+bool resize_threadpool(size_t thread_count, CoreClass core_class);
+
+// Sets the CPUs that the worker threads of the named pool `name` are pinned
+// to. Must be called before the pool is first requested; returns false if it
+// already exists.
+bool set_named_threadpool_cpus(
+    const char* name,
+    const uint32_t* cpus,
+    size_t num_cpus);
+
+// Returns the named pool `name`, creating it on first use. Everyone who asks
+// for the same name shares one pool, so that e.g. concurrently running
+// models can each be given a pool of their own. `thread_count` is only used
+// when the pool is created; 0 picks the same count as get_threadpool().
+ThreadPool* get_named_threadpool(const char* name, size_t thread_count);
+
+// Like get_pthreadpool(), for the named pool `name`.
+pthreadpool_t get_named_pthreadpool(const char* name, size_t thread_count);
+
 } // namespace threadpool
 } // namespace executorch
 } // namespace torch
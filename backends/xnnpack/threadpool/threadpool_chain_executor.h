@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
+#include <executorch/runtime/executor/chain_executor.h>
+
+namespace torch {
+namespace executorch {
+namespace threadpool {
+
+/**
+ * A ChainExecutor that runs independent chains of a Method on a ThreadPool.
+ *
+ * ThreadPool::run() is not reentrant, so the pool passed here should not be the
+ * one that kernels or delegates of the Method use internally (e.g., the
+ * singleton returned by get_threadpool()); otherwise a chain that calls into
+ * the pool would deadlock.
+ */
+class ThreadPoolChainExecutor final
+    : public ::torch::executor::ChainExecutor {
+ public:
+  explicit ThreadPoolChainExecutor(ThreadPool* threadpool)
+      : threadpool_(threadpool) {}
+
+  void run(TaskFn fn, void* context, size_t num_tasks) override {
+    threadpool_->run(
+        [fn, context](size_t task_index) { fn(context, task_index); },
+        num_tasks);
+  }
+
+ private:
+  ThreadPool* threadpool_;
+};
+
+} // namespace threadpool
+} // namespace executorch
+} // namespace torch
@@ -11,6 +11,7 @@ from executorch.exir import CaptureConfig
 from executorch.exir.backend.canonical_partitioners.duplicate_dequant_node_pass import (
     DuplicateDequantNodePass,
 )
+from executorch.exir.backend.compile_spec_schema import CompileSpec
 from executorch.exir.pass_manager import PassType
 
 ### XNNPACK Configs ###
@@ -48,3 +49,72 @@ def get_xnnpack_capture_config(
         return CaptureConfig(
             enable_dynamic_shape=dynamic_shape, enable_aot=enable_aot, _unlift=unlift
         )
+
+
+def get_xnnpack_share_weights_cache_compile_spec() -> CompileSpec:
+    """
+    Makes the XNNPACK delegates built with it share their packed weights at
+    runtime with the other delegates built from the same graph, e.g. when a
+    program is loaded once per worker thread.
+    """
+    return CompileSpec("share_weights_cache", bytes([1]))
+
+
+def get_xnnpack_cache_subgraph_compile_spec() -> CompileSpec:
+    """
+    Makes the XNNPACK delegates built with it keep their XNNPACK subgraph in a
+    process-wide cache, so that initializing a delegate from the same graph
+    again, e.g. when Methods are recycled, skips defining every value and
+    node. Combine it with the shared weights cache to also skip repacking the
+    weights.
+    """
+    return CompileSpec("cache_subgraph", bytes([1]))
+
+
+def get_xnnpack_threadpool_compile_specs(
+    num_threads: Optional[int] = None,
+    threadpool: Optional[str] = None,
+) -> List[CompileSpec]:
+    """
+    Selects the threadpool that XNNPACK delegates built with these compile
+    specs run on. Delegates that name the same `threadpool` share it, which
+    lets concurrently running models each get a pool of their own; the
+    runtime can pin a named pool to a set of CPUs with
+    set_named_threadpool_cpus() before loading. `num_threads` sizes the pool
+    if it is created for the delegate. Without either, the delegate uses the
+    global threadpool.
+    """
+    compile_specs = []
+    if num_threads is not None:
+        if num_threads <= 0:
+            raise ValueError(f"num_threads must be positive, got {num_threads}")
+        compile_specs.append(
+            CompileSpec("num_threads", num_threads.to_bytes(4, "little"))
+        )
+    if threadpool is not None:
+        compile_specs.append(CompileSpec("threadpool", threadpool.encode("utf-8")))
+    return compile_specs
+
+
+def get_xnnpack_fp16_inference_compile_spec() -> CompileSpec:
+    """
+    Makes the XNNPACK delegates built with it run float operators with
+    XNNPACK's fp16 kernels, converting fp32 inputs, outputs and weights at
+    the edges, so fp32-exported models get twice as wide SIMD on CPUs with
+    native fp16 arithmetic, e.g. ARMv8.2. Loading the delegate fails on
+    other CPUs. Models exported in fp16 run in fp16 without it.
+    """
+    return CompileSpec("fp16_inference", bytes([1]))
+
+
+def get_xnnpack_workspace_compile_spec(name: str) -> CompileSpec:
+    """
+    Makes the XNNPACK delegates built with it keep their intermediate values
+    in the workspace called `name`, shared at runtime with the other delegates
+    that name it. A program with many XNNPACK partitions then only needs the
+    scratch memory of its largest one. Delegates sharing a workspace never run
+    at the same time, so give concurrently running models different names.
+    """
+    if not name:
+        raise ValueError("workspace name must not be empty")
+    return CompileSpec("workspace", name.encode("utf-8"))
@@ -4,7 +4,7 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
-from typing import cast, Optional, Tuple
+from typing import cast, List, Optional, Tuple
 
 import executorch.exir as exir
 import torch
@@ -73,6 +73,40 @@ def get_relu_fused_node(node: torch.fx.Node) -> Optional[torch.fx.Node]:
     return None
 
 
+def is_spatial_mean(node: torch.fx.Node) -> bool:
+    """
+    Checks if a mean.dim node reduces the two innermost dimensions of a 4d
+    tensor and keeps them, which XNNPACK runs as global average pooling over
+    the NHWC tensor
+    """
+    dims = cast(Optional[List[int]], node.args[1])
+    keepdim = len(node.args) > 2 and bool(node.args[2])
+    input_val = get_input_node(node, 0).meta.get("val", None)
+    return (
+        dims in ([-2, -1], [-1, -2])
+        and keepdim
+        and input_val is not None
+        and input_val.dim() == 4
+    )
+
+
+def get_mean_trailing_dims(node: torch.fx.Node) -> Optional[int]:
+    """
+    Returns how many of the innermost dimensions a mean.dim node reduces, or
+    None if the reduced dimensions are not the innermost ones
+    """
+    input_val = get_input_node(node, 0).meta.get("val", None)
+    if input_val is None or input_val.dim() == 0:
+        return None
+    rank = input_val.dim()
+    dims = cast(Optional[List[int]], node.args[1])
+    # No dimensions reduce all of them
+    dims = sorted({d % rank for d in dims}) if dims else list(range(rank))
+    if dims != list(range(rank - len(dims), rank)):
+        return None
+    return len(dims)
+
+
 def is_get_attr_node(node: torch.fx.Node) -> bool:
     """
     Returns true if the given node is a get attr node for a tensor of the model
@@ -37,6 +37,7 @@ from executorch.exir.backend.backend_details import (
     CompileSpec,
     PreprocessResult,
 )
+from executorch.exir.backend.utils import DelegateMappingBuilder
 from torch._export.exported_program import ExportedProgram
 
 XNN_VALUE_FLAG_NON_EXTERNAL = 0
@@ -46,6 +47,7 @@ XNN_FLAG_TRANSPOSE_WEIGHTS = 1
 XNN_INVALID_VALUE_ID = 2**32 - 1
 XNN_TYPE_MAP = {
     torch.float32: XNNDatatype.xnn_datatype_fp32,
+    torch.float16: XNNDatatype.xnn_datatype_fp16,
     torch.uint8: XNNDatatype.xnn_datatype_quint8,
     torch.int8: XNNDatatype.xnn_datatype_qint8,
     torch.int32: XNNDatatype.xnn_datatype_qint32,
@@ -213,16 +215,31 @@ class XnnpackBackend(BackendDetails):
 
         node_visitors = get_node_visitors(ep, node_to_external_map)
 
+        # The runtime logs each XNNPACK node's timing with the node's debug
+        # handle as its delegate debug identifier, so map every handle to
+        # itself for the SDK to resolve them.
+        delegate_mapping_builder = DelegateMappingBuilder()
+        mapped_debug_handles = set()
+
         for node in graph_module.graph.nodes:
             if node.op == "call_function":
                 logger.info(f"Visiting: {node}, {node.target.__name__}")
                 if node.target.__name__ in node_visitors:
+                    debug_handle = node.meta.get("debug_handle", DEFAULT_DEBUG_HANDLE)
                     node_visitors[node.target.__name__].define_node(
                         node,
                         xnnpack_graph,
                         vals_to_ids,
-                        node.meta.get("debug_handle", DEFAULT_DEBUG_HANDLE),
+                        debug_handle,
                     )
+                    if (
+                        debug_handle != DEFAULT_DEBUG_HANDLE
+                        and debug_handle not in mapped_debug_handles
+                    ):
+                        delegate_mapping_builder.insert_delegate_mapping_entry(
+                            node, identifier=debug_handle
+                        )
+                        mapped_debug_handles.add(debug_handle)
                 else:
                     raise RuntimeError(
                         f"For {node}, {node.op}:{node.target.__name__} is not supported in XNNPACK Delegate"
@@ -235,4 +252,7 @@ class XnnpackBackend(BackendDetails):
                 continue
             else:
                 raise RuntimeError(f"{node.op} is not supported in XNNPACK")
-        return PreprocessResult(processed_bytes=convert_to_flatbuffer(xnnpack_graph))
+        return PreprocessResult(
+            processed_bytes=convert_to_flatbuffer(xnnpack_graph),
+            debug_handle_map=delegate_mapping_builder.get_delegate_mapping(),
+        )
@@ -8,8 +8,10 @@
 # both AOT and runtime.
 
 # Selective build. See codegen/tools/gen_oplist.py for how to use these
-# arguments.
+# arguments. An optional fourth argument names a model file, or a list of them,
+# to select the operators, and the dtypes of their kernels, from.
 function(gen_selected_ops ops_schema_yaml root_ops include_all_ops)
+  set(model_file "${ARGV3}")
   set(_oplist_yaml ${CMAKE_CURRENT_BINARY_DIR}/selected_operators.yaml)
   file(GLOB_RECURSE _codegen_tools_srcs "${EXECUTORCH_ROOT}/codegen/tools/*.py")
 
@@ -25,15 +27,42 @@ function(gen_selected_ops ops_schema_yaml root_ops include_all_ops)
   if(include_all_ops)
     list(APPEND _gen_oplist_command --include_all_operators)
   endif()
+  if(model_file)
+    list(JOIN model_file "," _model_files)
+    list(APPEND _gen_oplist_command --model_file_path="${_model_files}")
+  endif()
 
   message("Command - ${_gen_oplist_command}")
   add_custom_command(
     COMMENT "Generating selected_operators.yaml for custom ops"
     OUTPUT ${_oplist_yaml}
     COMMAND ${_gen_oplist_command}
-    DEPENDS ${ops_schema_yaml} ${_codegen_tools_srcs}
+    DEPENDS ${ops_schema_yaml} ${model_file} ${_codegen_tools_srcs}
+    WORKING_DIRECTORY ${EXECUTORCH_ROOT})
+
+endfunction()
+
+# Dtype selective build. Generates selected_op_variants.h from the
+# selected_operators.yaml of gen_selected_ops, and makes kernel_lib only keep
+# the dtypes that its selected operators use.
+function(gen_selected_op_variants kernel_lib)
+  set(_oplist_yaml ${CMAKE_CURRENT_BINARY_DIR}/selected_operators.yaml)
+  set(_variants_header ${CMAKE_CURRENT_BINARY_DIR}/selected_op_variants.h)
+  add_custom_command(
+    COMMENT "Generating selected_op_variants.h for dtype selective build"
+    OUTPUT ${_variants_header}
+    COMMAND
+      "${PYTHON_EXECUTABLE}" -m codegen.tools.gen_selected_op_variants
+      --yaml-file-path=${_oplist_yaml}
+      --output-dir=${CMAKE_CURRENT_BINARY_DIR}
+    DEPENDS ${_oplist_yaml}
+            ${EXECUTORCH_ROOT}/codegen/tools/gen_selected_op_variants.py
     WORKING_DIRECTORY ${EXECUTORCH_ROOT})
 
+  target_sources(${kernel_lib} PRIVATE ${_variants_header})
+  target_include_directories(${kernel_lib} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+  target_compile_definitions(${kernel_lib}
+                             PRIVATE EXECUTORCH_SELECTIVE_BUILD_DTYPE)
 endfunction()
 
 # Codegen for registering kernels. Kernels are defined in functions_yaml and
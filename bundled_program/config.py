@@ -7,7 +7,7 @@
 # pyre-strict
 
 from dataclasses import dataclass
-from typing import Any, get_args, List, Union
+from typing import Any, get_args, List, Optional, Union
 
 import torch
 from torch.utils._pytree import tree_flatten
@@ -53,12 +53,32 @@ class ConfigIOSet:
     expected_outputs: List[ConfigValue]
 
 
+@dataclass
+class PerformanceBudget:
+    """Performance that a method must meet when running its test sets.
+
+    The runtime runs each test set `num_warmup_iterations` times untimed and
+    then `num_iterations` times timed, and checks the latency percentiles over
+    all timed runs against the budgets. Latencies are in microseconds; a budget
+    of 0 is not checked.
+    """
+
+    num_iterations: int = 10
+    num_warmup_iterations: int = 1
+    p50_latency_us: int = 0
+    p90_latency_us: int = 0
+    p99_latency_us: int = 0
+    # Budget for the total size of the memory-planned buffers of the method.
+    max_planned_memory_bytes: int = 0
+
+
 @dataclass
 class ConfigExecutionPlanTest:
     """All info related to verify execution plan"""
 
     method_name: str
     test_sets: List[ConfigIOSet]
+    performance_budget: Optional[PerformanceBudget] = None
 
 
 class BundledConfig:
@@ -74,6 +94,7 @@ class BundledConfig:
         method_names: List[str],
         inputs: List[List[MethodInputType]],
         expected_outputs: List[List[MethodOutputType]],
+        performance_budgets: Optional[List[Optional[PerformanceBudget]]] = None,
     ) -> None:
         """Contruct the config given inputs and expected outputs
 
@@ -91,6 +112,8 @@ class BundledConfig:
 
             expected_outputs: Expected outputs for inputs sharing same index. The size of
                     expected_outputs should be the same as the size of inputs and provided method_names.
+            performance_budgets: Optional performance budget of each method, sharing the index
+                    of method_names. None, or a None element, means no budget for the method.
 
         Returns:
             self
@@ -108,10 +131,21 @@ class BundledConfig:
             )
         )
 
+        if performance_budgets is None:
+            performance_budgets = [None] * len(method_names)
+        assert len(performance_budgets) == len(method_names), (
+            "length of method_names and performance_budgets should match,"
+            + " but got {} and {}".format(len(method_names), len(performance_budgets))
+        )
+        for budget in performance_budgets:
+            assert (
+                budget is None or budget.num_iterations > 0
+            ), "A performance budget needs at least one timed iteration."
+
         self.execution_plan_tests: List[
             ConfigExecutionPlanTest
         ] = BundledConfig._gen_execution_plan_tests(
-            method_names, inputs, expected_outputs
+            method_names, inputs, expected_outputs, performance_budgets
         )
 
     @staticmethod
@@ -164,6 +198,7 @@ class BundledConfig:
         method_names: List[str],
         inputs: List[List[MethodInputType]],
         expected_outputs: List[List[MethodOutputType]],
+        performance_budgets: List[Optional[PerformanceBudget]],
     ) -> List[ConfigExecutionPlanTest]:
         """Generate execution plan test given inputs, expected outputs for verifying each execution plan"""
 
@@ -173,7 +208,8 @@ class BundledConfig:
             m_name,
             inputs_per_plan_test,
             expect_outputs_per_plan_test,
-        ) in zip(method_names, inputs, expected_outputs):
+            performance_budget,
+        ) in zip(method_names, inputs, expected_outputs, performance_budgets):
             test_sets: List[ConfigIOSet] = []
 
             # transfer I/O sets into ConfigIOSet for each execution plan
@@ -200,6 +236,7 @@ class BundledConfig:
                 ConfigExecutionPlanTest(
                     method_name=m_name,
                     test_sets=test_sets,
+                    performance_budget=performance_budget,
                 )
             )
 
@@ -21,6 +21,7 @@ from executorch.bundled_program.schema import (
     BundledExecutionPlanTest,
     BundledInt,
     BundledIOSet,
+    BundledPerformanceBudget,
     BundledProgram,
     BundledTensor,
     BundledValue,
@@ -314,10 +315,24 @@ def create_bundled_program(
                 BundledIOSet(inputs=inputs, expected_outputs=expected_outputs)
             )
 
+        performance_budget = None
+        if plan_test.performance_budget is not None:
+            budget = plan_test.performance_budget
+            performance_budget = BundledPerformanceBudget(
+                num_iterations=budget.num_iterations,
+                num_warmup_iterations=budget.num_warmup_iterations,
+                p50_latency_us=budget.p50_latency_us,
+                p90_latency_us=budget.p90_latency_us,
+                p99_latency_us=budget.p99_latency_us,
+                max_planned_memory_bytes=budget.max_planned_memory_bytes,
+            )
+
         # emit the whole execution plan test
         execution_plan_tests.append(
             BundledExecutionPlanTest(
-                method_name=plan_test.method_name, test_sets=test_sets
+                method_name=plan_test.method_name,
+                test_sets=test_sets,
+                performance_budget=performance_budget,
             )
         )
 
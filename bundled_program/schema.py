@@ -7,7 +7,7 @@
 # pyre-strict
 
 from dataclasses import dataclass
-from typing import List, Union
+from typing import List, Optional, Union
 
 from executorch.exir.scalar_type import ScalarType
 
@@ -69,6 +69,28 @@ class BundledIOSet:
     expected_outputs: List[BundledValue]
 
 
+@dataclass
+class BundledPerformanceBudget:
+    """Performance that a method must meet when running its test sets."""
+
+    # How many timed runs of each test set to do. The latency percentiles are
+    # over the runs of all test sets.
+    num_iterations: int
+
+    # How many untimed runs of each test set to do before the timed ones.
+    num_warmup_iterations: int
+
+    # Budgets for the latency percentiles of a single run, in microseconds.
+    # Zero means no budget.
+    p50_latency_us: int
+    p90_latency_us: int
+    p99_latency_us: int
+
+    # Budget for the total size of the memory-planned buffers of the method,
+    # in bytes. Zero means no budget.
+    max_planned_memory_bytes: int
+
+
 @dataclass
 class BundledExecutionPlanTest:
     """Context for testing and verifying an exceution plan."""
@@ -81,6 +103,9 @@ class BundledExecutionPlanTest:
     # Sets of input/outputs to test with.
     test_sets: List[BundledIOSet]
 
+    # The performance that the method must meet on test_sets, if any.
+    performance_budget: Optional[BundledPerformanceBudget] = None
+
 
 @dataclass
 class BundledProgram:
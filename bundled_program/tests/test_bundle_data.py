@@ -10,7 +10,7 @@ import unittest
 from typing import List
 
 import torch
-from executorch.bundled_program.config import ConfigValue
+from executorch.bundled_program.config import ConfigValue, PerformanceBudget
 from executorch.bundled_program.core import create_bundled_program
 from executorch.bundled_program.schema import (
     BundledBool,
@@ -70,6 +70,28 @@ class TestBundle(unittest.TestCase):
 
         self.assertEqual(bundled_program.program, _serialize_pte_binary(program))
 
+    def test_bundle_performance_budget(self) -> None:
+        program, bundled_config = get_common_program()
+        budget = PerformanceBudget(
+            num_iterations=20,
+            num_warmup_iterations=2,
+            p50_latency_us=1000,
+            p99_latency_us=5000,
+        )
+        bundled_config.execution_plan_tests[0].performance_budget = budget
+
+        bundled_program = create_bundled_program(program, bundled_config)
+
+        bundled_budget = bundled_program.execution_plan_tests[0].performance_budget
+        self.assertIsNotNone(bundled_budget)
+        self.assertEqual(bundled_budget.num_iterations, 20)
+        self.assertEqual(bundled_budget.num_warmup_iterations, 2)
+        self.assertEqual(bundled_budget.p50_latency_us, 1000)
+        self.assertEqual(bundled_budget.p90_latency_us, 0)
+        self.assertEqual(bundled_budget.p99_latency_us, 5000)
+        self.assertEqual(bundled_budget.max_planned_memory_bytes, 0)
+        self.assertIsNone(bundled_program.execution_plan_tests[1].performance_budget)
+
     def test_bundle_miss_methods(self) -> None:
         program, bundled_config = get_common_program()
 
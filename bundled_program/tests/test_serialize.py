@@ -8,6 +8,7 @@
 
 import unittest
 
+from executorch.bundled_program.config import PerformanceBudget
 from executorch.bundled_program.core import create_bundled_program
 
 from executorch.bundled_program.serialize import (
@@ -36,3 +37,18 @@ class TestSerialize(unittest.TestCase):
             regenerate_bundled_program,
             "Regenerated bundled program mismatches original one",
         )
+
+    def test_performance_budget_serialization(self) -> None:
+        program, bundled_config = get_common_program()
+        bundled_config.execution_plan_tests[0].performance_budget = PerformanceBudget(
+            num_iterations=5, p90_latency_us=2000, max_planned_memory_bytes=4096
+        )
+
+        bundled_program = create_bundled_program(program, bundled_config)
+        regenerate_bundled_program = deserialize_from_flatbuffer_to_bundled_program(
+            serialize_from_bundled_program_to_flatbuffer(bundled_program)
+        )
+        self.assertEqual(bundled_program, regenerate_bundled_program)
+        self.assertIsNone(
+            regenerate_bundled_program.execution_plan_tests[1].performance_budget
+        )
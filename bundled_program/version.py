@@ -10,4 +10,4 @@
 # This is the version number of the bundled program schema.
 # It should be forwarded to BundledProgram construtor as version.
 # Should update the version number whenever there's a update in the schema.
-BUNDLED_PROGRAM_SCHEMA_VERSION = 2
+BUNDLED_PROGRAM_SCHEMA_VERSION = 3
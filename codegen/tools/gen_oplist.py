@@ -203,7 +203,10 @@ def main(args: List[Any]) -> None:
     )
     parser.add_argument(
         "--model_file_path",
-        help=("Path to an executorch program"),
+        help=(
+            "Path to an executorch program, or a comma separated list of them to select "
+            "the operators and kernel keys that any of them use"
+        ),
         required=False,
     )
     parser.add_argument(
@@ -240,14 +243,18 @@ def main(args: List[Any]) -> None:
             et_kernel_metadata, {op: ["default"] for op in op_set}
         )
     if options.model_file_path:
-        assert os.path.isfile(
-            options.model_file_path
-        ), "The value for --model_file_path needs to be a valid file."
-        op_set.update(_get_operators(options.model_file_path))
-        source_name = options.model_file_path
-        et_kernel_metadata = merge_et_kernel_metadata(
-            et_kernel_metadata, _get_kernel_metadata_for_model(options.model_file_path)
-        )
+        model_files = [p for p in options.model_file_path.split(",") if len(p) > 0]
+        for model_file in model_files:
+            assert os.path.isfile(
+                model_file
+            ), "The value for --model_file_path needs to be valid files."
+            op_set.update(_get_operators(model_file))
+            # Each kernel key is the exact combination of dtypes and dim orders that an
+            # operator is called with; merging keeps the combinations of every model.
+            et_kernel_metadata = merge_et_kernel_metadata(
+                et_kernel_metadata, _get_kernel_metadata_for_model(model_file)
+            )
+        source_name = ",".join(os.path.basename(p) for p in model_files)
     if options.ops_schema_yaml_path:
         assert os.path.isfile(
             options.ops_schema_yaml_path
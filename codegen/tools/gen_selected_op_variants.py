@@ -0,0 +1,146 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import argparse
+import os
+import sys
+from typing import Any, Dict, List, Optional, Set
+
+import yaml
+
+# Names of exec_aten::ScalarType by their integer value, as they appear in the
+# et_kernel_metadata keys of selected_operators.yaml.
+_SCALAR_TYPES = [
+    "Byte",
+    "Char",
+    "Short",
+    "Int",
+    "Long",
+    "Half",
+    "Float",
+    "Double",
+    "ComplexHalf",
+    "ComplexFloat",
+    "ComplexDouble",
+    "Bool",
+    "QInt8",
+    "QUInt8",
+    "QInt32",
+    "BFloat16",
+    "QUInt4x2",
+    "QUInt2x4",
+]
+
+# Included by scalar_type_util.h from within namespace torch::executor.
+_HEADER = """// @generated by gen_selected_op_variants.py from {source}
+#pragma once
+
+inline constexpr bool should_include_kernel_dtype(
+    const char* operator_name,
+    exec_aten::ScalarType scalar_type) {{
+{body}
+}}
+"""
+
+
+def _base_name(op_name: str) -> str:
+    """Returns the name ET_SWITCH sees for `op_name`, e.g. "add" for
+    "aten::add.out". Kernels share it between overloads.
+    """
+    name = op_name.split("::")[-1]
+    return name.split(".")[0]
+
+
+def _parse_dtypes(kernel_key: str) -> Optional[Set[int]]:
+    """Returns the dtypes used by the args of a "v1/6;0,1|6;0,1" kernel key,
+    or None if the key does not restrict dtypes.
+    """
+    if "/" not in kernel_key:
+        return None
+    dtypes = set()
+    for arg in kernel_key.split("/", 1)[1].split("|"):
+        dtype = arg.split(";")[0]
+        if dtype:
+            dtypes.add(int(dtype))
+    return dtypes
+
+
+def get_selected_dtypes(selected_ops: Dict[str, Any]) -> Dict[str, Set[int]]:
+    """Maps the base name of each operator to the dtypes its kernels must
+    handle. Operators with a kernel key that does not name dtypes are left out,
+    so they keep every dtype.
+    """
+    if selected_ops.get("include_all_operators", False):
+        return {}
+    et_kernel_metadata = selected_ops.get("et_kernel_metadata") or {}
+    # Overloads share a base name, so an unrestricted overload unrestricts all.
+    unrestricted: Set[str] = set()
+    selected: Dict[str, Set[int]] = {}
+    for op_name, kernel_keys in et_kernel_metadata.items():
+        name = _base_name(op_name)
+        for kernel_key in kernel_keys:
+            dtypes = _parse_dtypes(kernel_key)
+            if dtypes is None:
+                unrestricted.add(name)
+            else:
+                selected.setdefault(name, set()).update(dtypes)
+    return {
+        name: dtypes for name, dtypes in selected.items() if name not in unrestricted
+    }
+
+
+def generate_header(selected_dtypes: Dict[str, Set[int]], source: str) -> str:
+    lines = []
+    for name in sorted(selected_dtypes):
+        dtypes = sorted(selected_dtypes[name])
+        checks = " ||\n        ".join(
+            f"scalar_type == exec_aten::ScalarType::{_SCALAR_TYPES[d]}"
+            for d in dtypes
+        )
+        lines.append(
+            f'  if (internal::kernel_name_equals(operator_name, "{name}")) {{\n'
+            f"    return {checks if checks else 'false'};\n"
+            "  }"
+        )
+    # Names that are not selected operators, such as helpers that switch on
+    # dtypes, keep every dtype.
+    lines.append("  return true;")
+    return _HEADER.format(source=source, body="\n".join(lines))
+
+
+def main(args: List[Any]) -> None:
+    """Generates selected_op_variants.h from selected_operators.yaml. Defining
+    EXECUTORCH_SELECTIVE_BUILD_DTYPE with the header on the include path makes
+    the ET_SWITCH macros drop the dtypes that no selected kernel uses.
+    """
+    parser = argparse.ArgumentParser(
+        description="Generate the dtypes selected for each operator"
+    )
+    parser.add_argument(
+        "--yaml-file-path",
+        "--yaml_file_path",
+        help="Path to selected_operators.yaml, as generated by gen_oplist.py",
+        required=True,
+    )
+    parser.add_argument(
+        "--output-dir",
+        "--output_dir",
+        help="Directory to write selected_op_variants.h to",
+        required=True,
+    )
+    options = parser.parse_args(args)
+
+    with open(options.yaml_file_path, "r") as f:
+        selected_ops = yaml.safe_load(f) or {}
+    header = generate_header(
+        get_selected_dtypes(selected_ops), os.path.basename(options.yaml_file_path)
+    )
+    with open(os.path.join(options.output_dir, "selected_op_variants.h"), "w") as f:
+        f.write(header)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
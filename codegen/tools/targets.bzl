@@ -78,6 +78,47 @@ def define_common_targets(is_fbcode = False):
         ],
     )
 
+    runtime.python_library(
+        name = "gen_selected_op_variants_lib",
+        srcs = ["gen_selected_op_variants.py"],
+        base_module = "executorch.codegen.tools",
+        visibility = [
+            "//executorch/...",
+        ],
+        deps = [
+            "fbsource//third-party/pypi/pyyaml:pyyaml",
+        ],
+    )
+
+    runtime.python_binary(
+        name = "gen_selected_op_variants",
+        main_module = "executorch.codegen.tools.gen_selected_op_variants",
+        deps = [
+            ":gen_selected_op_variants_lib",
+        ],
+        package_style = "inplace",
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.python_test(
+        name = "test_gen_selected_op_variants",
+        base_module = "",
+        srcs = [
+            "test/test_gen_selected_op_variants.py",
+        ],
+        deps = [
+            ":gen_selected_op_variants_lib",
+        ],
+        package_style = "inplace",
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
     runtime.python_library(
         name = "gen_all_oplist_lib",
         srcs = ["gen_all_oplist.py"],
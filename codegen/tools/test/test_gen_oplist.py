@@ -62,6 +62,47 @@ class TestGenOpList(unittest.TestCase):
         mock_get_operators.assert_called_once_with(temp_file.name)
         temp_file.close()
 
+    @patch("executorch.codegen.tools.gen_oplist._get_kernel_metadata_for_model")
+    @patch("executorch.codegen.tools.gen_oplist._get_operators")
+    @patch("executorch.codegen.tools.gen_oplist._dump_yaml")
+    def test_gen_op_list_with_multiple_model_paths_merges(
+        self,
+        mock_dump_yaml: NonCallableMock,
+        mock_get_operators: NonCallableMock,
+        mock_get_kernel_metadata_for_model: NonCallableMock,
+    ) -> None:
+        model_a = os.path.join(self.temp_dir.name, "a.pte")
+        model_b = os.path.join(self.temp_dir.name, "b.pte")
+        for path in (model_a, model_b):
+            open(path, "wb").close()
+        mock_get_operators.side_effect = [
+            ["aten::add.out"],
+            ["aten::add.out", "aten::mul.out"],
+        ]
+        mock_get_kernel_metadata_for_model.side_effect = [
+            {"aten::add.out": ["v1/6;0,1|6;0,1|6;0,1"]},
+            {
+                "aten::add.out": ["v1/3;0,1|3;0,1|3;0,1"],
+                "aten::mul.out": ["v1/6;0|6;0|6;0"],
+            },
+        ]
+        output_path = os.path.join(self.temp_dir.name, "output.yaml")
+        args = [
+            f"--output_path={output_path}",
+            f"--model_file_path={model_a},{model_b}",
+        ]
+        gen_oplist.main(args)
+        mock_dump_yaml.assert_called_once_with(
+            ["aten::add.out", "aten::mul.out"],
+            output_path,
+            "a.pte,b.pte",
+            {
+                "aten::add.out": ["v1/3;0,1|3;0,1|3;0,1", "v1/6;0,1|6;0,1|6;0,1"],
+                "aten::mul.out": ["v1/6;0|6;0|6;0"],
+            },
+            False,
+        )
+
     @patch("executorch.codegen.tools.gen_oplist._dump_yaml")
     def test_gen_op_list_with_valid_root_ops(
         self,
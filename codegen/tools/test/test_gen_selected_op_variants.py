@@ -0,0 +1,64 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import os
+import tempfile
+import unittest
+
+import executorch.codegen.tools.gen_selected_op_variants as gen_selected_op_variants
+import yaml
+
+
+class TestGenSelectedOpVariants(unittest.TestCase):
+    def test_dtypes_are_unioned_across_args_and_overloads(self) -> None:
+        selected = gen_selected_op_variants.get_selected_dtypes(
+            {
+                "et_kernel_metadata": {
+                    "aten::add.out": ["v1/6;0,1|6;0,1|6;0,1"],
+                    "aten::add.Scalar_out": ["v1/3;0,1|3;0,1"],
+                    "aten::mul.out": ["v1/6;0|4;0|6;0"],
+                }
+            }
+        )
+        self.assertEqual(selected, {"add": {3, 6}, "mul": {4, 6}})
+
+    def test_default_kernel_keeps_all_dtypes(self) -> None:
+        selected = gen_selected_op_variants.get_selected_dtypes(
+            {
+                "et_kernel_metadata": {
+                    "aten::add.out": ["v1/6;0,1|6;0,1"],
+                    "aten::add.Scalar_out": ["default"],
+                    "aten::mul.out": ["v1/6;0|6;0"],
+                }
+            }
+        )
+        self.assertEqual(selected, {"mul": {6}})
+
+    def test_include_all_operators_keeps_all_dtypes(self) -> None:
+        selected = gen_selected_op_variants.get_selected_dtypes(
+            {
+                "include_all_operators": True,
+                "et_kernel_metadata": {"aten::add.out": ["v1/6;0,1|6;0,1"]},
+            }
+        )
+        self.assertEqual(selected, {})
+
+    def test_generates_header(self) -> None:
+        with tempfile.TemporaryDirectory() as temp_dir:
+            yaml_path = os.path.join(temp_dir, "selected_operators.yaml")
+            with open(yaml_path, "w") as f:
+                yaml.safe_dump(
+                    {"et_kernel_metadata": {"aten::add.out": ["v1/6;0|11;0"]}}, f
+                )
+            gen_selected_op_variants.main(
+                ["--yaml-file-path", yaml_path, "--output-dir", temp_dir]
+            )
+            with open(os.path.join(temp_dir, "selected_op_variants.h")) as f:
+                header = f.read()
+        self.assertIn('kernel_name_equals(operator_name, "add")', header)
+        self.assertIn("scalar_type == exec_aten::ScalarType::Float", header)
+        self.assertIn("scalar_type == exec_aten::ScalarType::Bool", header)
+        self.assertIn("return true;", header)
@@ -32,6 +32,7 @@
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/platform/runtime.h>
 
+#include <unistd.h>
 #include <chrono>
 using namespace std::chrono;
 
@@ -323,7 +324,7 @@ int main(int argc, char** argv) {
   // These buffers correspond to different hardware memory banks. Most mobile
   // environments will only have a single buffer. Some embedded environments may
   // have more than one for, e.g., slow/large DRAM and fast/small SRAM.
-  std::vector<std::unique_ptr<uint8_t[]>> non_const_buffers;
+  std::vector<std::unique_ptr<uint8_t, decltype(&free)>> non_const_buffers;
   std::vector<MemoryAllocator> non_const_allocators;
   size_t num_non_const_buffers = 0;
   {
@@ -347,7 +348,14 @@ int main(int argc, char** argv) {
         (unsigned int)buffer_size.error());
     ET_LOG(
         Info, "Setting up non-const buffer %zu, size %lld.", id, *buffer_size);
-    non_const_buffers.push_back(std::make_unique<uint8_t[]>(*buffer_size));
+    // Page-aligned, so that the MPS delegate can use planned inputs and
+    // outputs that start on a page boundary without copying them.
+    void* buffer = nullptr;
+    ET_CHECK_MSG(
+        posix_memalign(&buffer, getpagesize(), *buffer_size) == 0,
+        "Failed to allocate non-const buffer %zu",
+        id);
+    non_const_buffers.emplace_back(static_cast<uint8_t*>(buffer), free);
     // Since the list of allocators began empty, buffer ID N will live at index
     // N-1.
     non_const_allocators.push_back(
@@ -20,12 +20,16 @@ from executorch.bundled_program.serialize import (
 )
 
 from executorch.exir.backend.backend_api import to_backend
+from executorch.exir.passes import MemoryPlanningPass
 
 from ....models import MODEL_NAME_TO_MODEL
 from ....models.model_factory import EagerModelFactory
 
 from ....portable.utils import save_pte_program
 
+# The largest page size of Apple platforms.
+MPS_PAGE_SIZE = 16384
+
 FORMAT = "[%(levelname)s %(asctime)s %(filename)s:%(lineno)s] %(message)s"
 logging.basicConfig(level=logging.INFO, format=FORMAT)
 
@@ -85,7 +89,15 @@ if __name__ == "__main__":
             exir.CaptureConfig(enable_aot=True, _unlift=True),
         )
         .to_edge(exir.EdgeCompileConfig(_check_ir_validity=False))
-        .to_executorch()
+        .to_executorch(
+            # Start every planned tensor on a page boundary, so that the MPS
+            # delegate can use its inputs and outputs without copying them.
+            exir.ExecutorchBackendConfig(
+                memory_planning_pass=MemoryPlanningPass(
+                    "greedy", alignment=MPS_PAGE_SIZE
+                )
+            )
+        )
     )
 
     model_name = f"{args.model_name}_mps"
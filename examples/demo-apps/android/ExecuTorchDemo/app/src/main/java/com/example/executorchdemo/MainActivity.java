@@ -30,6 +30,7 @@ import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
+import java.nio.FloatBuffer;
 import java.util.Objects;
 
 public class MainActivity extends Activity implements Runnable {
@@ -181,19 +182,27 @@ public class MainActivity extends Activity implements Runnable {
 
   @Override
   public void run() {
-    final Tensor inputTensor =
-        TensorImageUtils.bitmapToFloat32Tensor(
-            mBitmap,
-            TensorImageUtils.TORCHVISION_NORM_MEAN_RGB,
-            TensorImageUtils.TORCHVISION_NORM_STD_RGB);
-    final float[] inputs = inputTensor.getDataAsFloatArray();
+    // Normalize the image straight into the model's input memory, so that forward() doesn't copy
+    // it again.
+    final Tensor inputTensor = mModule.getInputTensor(0);
+    TensorImageUtils.bitmapToFloatBuffer(
+        mBitmap,
+        0,
+        0,
+        mBitmap.getWidth(),
+        mBitmap.getHeight(),
+        TensorImageUtils.TORCHVISION_NORM_MEAN_RGB,
+        TensorImageUtils.TORCHVISION_NORM_STD_RGB,
+        inputTensor.getDataAsFloatBuffer(),
+        0);
 
     final long startTime = SystemClock.elapsedRealtime();
     Tensor outputTensor = mModule.forward(EValue.from(inputTensor)).toTensor();
     final long inferenceTime = SystemClock.elapsedRealtime() - startTime;
     Log.d("ImageSegmentation", "inference time (ms): " + inferenceTime);
 
-    final float[] scores = outputTensor.getDataAsFloatArray();
+    // Reads the scores in place instead of copying them to a Java array.
+    final FloatBuffer scores = outputTensor.getDataAsFloatBuffer();
     int width = mBitmap.getWidth();
     int height = mBitmap.getHeight();
 
@@ -203,7 +212,7 @@ public class MainActivity extends Activity implements Runnable {
         int maxi = 0, maxj = 0, maxk = 0;
         double maxnum = -Double.MAX_VALUE;
         for (int i = 0; i < CLASSNUM; i++) {
-          float score = scores[i * (width * height) + j * width + k];
+          float score = scores.get(i * (width * height) + j * width + k);
           if (score > maxnum) {
             maxnum = score;
             maxi = i;
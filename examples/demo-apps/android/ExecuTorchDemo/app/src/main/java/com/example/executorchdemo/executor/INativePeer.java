@@ -12,4 +12,8 @@ interface INativePeer {
   void resetNative();
 
   EValue forward(EValue... inputs);
+
+  Tensor getInputTensor(int index);
+
+  void setOutputTensor(int index, Tensor tensor);
 }
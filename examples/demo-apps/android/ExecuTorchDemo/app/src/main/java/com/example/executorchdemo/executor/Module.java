@@ -56,6 +56,33 @@ public class Module {
     return mNativePeer.forward(inputs);
   }
 
+  /**
+   * Returns the 'forward' method's input at {@code index} as a tensor whose data is the model's own
+   * input memory. Writing to it, e.g. with {@link
+   * TensorImageUtils#imageYUV420CenterCropToFloatBuffer}, and passing it back to {@link #forward}
+   * runs the model without copying the input. The tensor is only valid until this module is
+   * destroyed.
+   *
+   * @param index index of the input.
+   * @return the input tensor.
+   */
+  public Tensor getInputTensor(int index) {
+    return mNativePeer.getInputTensor(index);
+  }
+
+  /**
+   * Makes the 'forward' method write its output at {@code index} straight into the data of {@code
+   * tensor}, which must be backed by a direct buffer created with one of the {@code
+   * Tensor.allocate*Buffer} methods, have the output's shape and dtype, and stay alive while the
+   * module runs. Only valid for outputs that the model does not allocate itself.
+   *
+   * @param index index of the output.
+   * @param tensor the tensor to write the output to.
+   */
+  public void setOutputTensor(int index, Tensor tensor) {
+    mNativePeer.setOutputTensor(index, tensor);
+  }
+
   /**
    * Explicitly destroys the native ExecuTorch program. Calling this method is not required, as the
    * native object will be destroyed when this object is garbage-collected. However, the timing of
@@ -35,4 +35,10 @@ class NativePeer implements INativePeer {
 
   @DoNotStrip
   public native EValue forward(EValue... inputs);
+
+  @DoNotStrip
+  public native Tensor getInputTensor(int index);
+
+  @DoNotStrip
+  public native void setOutputTensor(int index, Tensor tensor);
 }
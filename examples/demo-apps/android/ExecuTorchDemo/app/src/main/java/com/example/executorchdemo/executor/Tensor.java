@@ -407,6 +407,17 @@ public abstract class Tensor {
         "Tensor of type " + getClass().getSimpleName() + " cannot return data as float array.");
   }
 
+  /**
+   * @return the direct buffer that holds the tensor data, without copying. Writes to it change the
+   *     tensor; for a tensor from {@link Module#getInputTensor(int)}, they write straight into the
+   *     model's input.
+   * @throws IllegalStateException if it is called for a non-float32 tensor.
+   */
+  public FloatBuffer getDataAsFloatBuffer() {
+    throw new IllegalStateException(
+        "Tensor of type " + getClass().getSimpleName() + " cannot return data as float buffer.");
+  }
+
   /**
    * @return a Java long array that contains the tensor data. This may be a copy or reference.
    * @throws IllegalStateException if it is called for a non-int64 tensor.
@@ -543,6 +554,11 @@ public abstract class Tensor {
       return arr;
     }
 
+    @Override
+    public FloatBuffer getDataAsFloatBuffer() {
+      return data;
+    }
+
     @Override
     public DType dtype() {
       return DType.FLOAT32;
@@ -11,7 +11,6 @@ package com.example.executorchdemo.executor;
 import android.graphics.Bitmap;
 import android.graphics.ImageFormat;
 import android.media.Image;
-import android.util.Log;
 import com.facebook.soloader.nativeloader.NativeLoader;
 import com.facebook.soloader.nativeloader.SystemDelegate;
 import java.nio.Buffer;
@@ -76,10 +75,6 @@ public final class TensorImageUtils {
     bitmap.getPixels(pixels, 0, width, x, y, width, height);
     final int offset_g = pixelsCount;
     final int offset_b = 2 * pixelsCount;
-    for (int i = 0; i < 100; i++) {
-      final int c = pixels[i];
-      Log.i("Image", ": " + i + " " + ((c >> 16) & 0xff));
-    }
     for (int i = 0; i < pixelsCount; i++) {
       final int c = pixels[i];
       float r = ((c >> 16) & 0xff) / 255.0f;
@@ -224,7 +219,8 @@ public final class TensorImageUtils {
       if (!NativeLoader.isInitialized()) {
         NativeLoader.init(new SystemDelegate());
       }
-      NativeLoader.loadLibrary("pytorch_vision_jni");
+      // Implemented in jni_layer.cpp.
+      NativeLoader.loadLibrary("executorchdemo");
     }
 
     private static native void imageYUV420CenterCropToFloatBuffer(
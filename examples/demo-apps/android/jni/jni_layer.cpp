@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <memory>
@@ -58,6 +59,115 @@ constexpr static int kTensorDTypeFloat32 = 4;
 constexpr static int kTensorDTypeInt64 = 5;
 constexpr static int kTensorDTypeFloat64 = 6;
 
+namespace {
+
+/**
+ * Converts the center crop of a YUV_420_888 image to a normalized float CHW
+ * RGB tensor in one pass, rotating it clockwise by `rotate_cw_degrees` and
+ * scaling it to the tensor size with nearest-neighbor sampling. Camera frames
+ * thus go straight into the model's input, without an intermediate bitmap.
+ */
+void yuv420_center_crop_to_float_chw(
+    const uint8_t* y_data,
+    int y_row_stride,
+    int y_pixel_stride,
+    const uint8_t* u_data,
+    const uint8_t* v_data,
+    int uv_row_stride,
+    int uv_pixel_stride,
+    int image_width,
+    int image_height,
+    int rotate_cw_degrees,
+    int tensor_width,
+    int tensor_height,
+    const float* norm_mean_rgb,
+    const float* norm_std_rgb,
+    float* out) {
+  // 90 and 270 degree rotations swap the axes, so that output columns select
+  // source rows and output rows select source columns.
+  const bool swap_axes = rotate_cw_degrees == 90 || rotate_cw_degrees == 270;
+  const int rotated_width = swap_axes ? image_height : image_width;
+  const int rotated_height = swap_axes ? image_width : image_height;
+
+  // The largest centered crop of the rotated image with the tensor's aspect
+  // ratio.
+  int crop_width = rotated_width;
+  int crop_height = rotated_height;
+  if (int64_t(rotated_width) * tensor_height >
+      int64_t(rotated_height) * tensor_width) {
+    crop_width = int64_t(rotated_height) * tensor_width / tensor_height;
+  } else {
+    crop_height = int64_t(rotated_width) * tensor_height / tensor_width;
+  }
+  const int crop_x = (rotated_width - crop_width) / 2;
+  const int crop_y = (rotated_height - crop_height) / 2;
+
+  // The source coordinate that each output column and row selects.
+  std::vector<int> column_source(tensor_width);
+  for (int x = 0; x < tensor_width; ++x) {
+    const int rx = crop_x + int64_t(x) * crop_width / tensor_width;
+    switch (rotate_cw_degrees) {
+      case 90: // Source row.
+        column_source[x] = image_height - 1 - rx;
+        break;
+      case 180: // Source column.
+        column_source[x] = image_width - 1 - rx;
+        break;
+      default: // 0: source column, 270: source row.
+        column_source[x] = rx;
+    }
+  }
+  std::vector<int> row_source(tensor_height);
+  for (int y = 0; y < tensor_height; ++y) {
+    const int ry = crop_y + int64_t(y) * crop_height / tensor_height;
+    switch (rotate_cw_degrees) {
+      case 180: // Source row.
+        row_source[y] = image_height - 1 - ry;
+        break;
+      case 270: // Source column.
+        row_source[y] = image_width - 1 - ry;
+        break;
+      default: // 0: source row, 90: source column.
+        row_source[y] = ry;
+    }
+  }
+
+  // Fold the scaling to [0, 1] and the normalization into one multiply-add.
+  float scale[3];
+  float bias[3];
+  for (int c = 0; c < 3; ++c) {
+    scale[c] = 1.0f / (255.0f * norm_std_rgb[c]);
+    bias[c] = -norm_mean_rgb[c] / norm_std_rgb[c];
+  }
+
+  const size_t plane_size = size_t(tensor_width) * tensor_height;
+  float* out_r = out;
+  float* out_g = out + plane_size;
+  float* out_b = out + 2 * plane_size;
+  for (int y = 0; y < tensor_height; ++y) {
+    for (int x = 0; x < tensor_width; ++x) {
+      const int sx = swap_axes ? row_source[y] : column_source[x];
+      const int sy = swap_axes ? column_source[x] : row_source[y];
+      const float luma = y_data[sy * y_row_stride + sx * y_pixel_stride];
+      const int uv_index =
+          (sy >> 1) * uv_row_stride + (sx >> 1) * uv_pixel_stride;
+      const float u = u_data[uv_index] - 128.0f;
+      const float v = v_data[uv_index] - 128.0f;
+      // Full-range BT.601, as produced by Android cameras.
+      const float r = std::min(std::max(luma + 1.402f * v, 0.0f), 255.0f);
+      const float g = std::min(
+          std::max(luma - 0.344136f * u - 0.714136f * v, 0.0f), 255.0f);
+      const float b = std::min(std::max(luma + 1.772f * u, 0.0f), 255.0f);
+      const size_t i = size_t(y) * tensor_width + x;
+      out_r[i] = r * scale[0] + bias[0];
+      out_g[i] = g * scale[1] + bias[1];
+      out_b[i] = b * scale[2] + bias[2];
+    }
+  }
+}
+
+} // namespace
+
 class TensorHybrid : public facebook::jni::HybridClass<TensorHybrid> {
  public:
   constexpr static const char* kJavaDescriptor =
@@ -183,8 +293,11 @@ class JEValue : public facebook::jni::JavaClass<JEValue> {
       shapeVec.reserve(rank);
 
       auto numel = 1;
+      dim_order.resize(rank);
+      strides.resize(rank);
       for (int i = 0; i < rank; i++) {
         shapeVec.push_back(shapeArr[i]);
+        dim_order[i] = i;
       }
       for (int i = rank - 1; i >= 0; --i) {
         strides[i] = numel;
@@ -319,17 +432,23 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
       facebook::jni::alias_ref<
           facebook::jni::JArrayClass<JEValue::javaobject>::javaobject>
           jinputs) {
-    size_t n = jinputs->size();
-    auto kDimOrder = std::vector<uint8_t>({0, 1, 2, 3});
-    // strides will be filled by JEValueToTensorImpl
-    auto strides = std::vector<int32_t>({1, 1, 1, 1});
-    std::vector<exec_aten::SizesType> shapeVec;
-    // TODO: Inline the function
-    auto tensor_impl = JEValue::JEValueToTensorImpl(
-        jinputs->getElement(0), shapeVec, kDimOrder, strides);
-    EValue atEValue = EValue(exec_aten::Tensor(&tensor_impl));
-    Error set_input_status = method_->set_input(atEValue, 0);
-    ET_CHECK(set_input_status == Error::Ok);
+    const size_t n = jinputs->size();
+    // The TensorImpls point into these, so none of them may be reallocated
+    // until the method has run.
+    std::vector<std::vector<exec_aten::SizesType>> shapes(n);
+    std::vector<std::vector<uint8_t>> dim_orders(n);
+    std::vector<std::vector<int32_t>> strides(n);
+    std::vector<TensorImpl> tensor_impls;
+    tensor_impls.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      tensor_impls.push_back(JEValue::JEValueToTensorImpl(
+          jinputs->getElement(i), shapes[i], dim_orders[i], strides[i]));
+      // A tensor from getInputTensor() already holds the input data, in which
+      // case nothing is copied.
+      Error set_input_status =
+          method_->set_input(EValue(exec_aten::Tensor(&tensor_impls[i])), i);
+      ET_CHECK(set_input_status == Error::Ok);
+    }
     ET_LOG(Info, "Inputs prepared.");
 
     // Run the model.
@@ -340,17 +459,128 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
         status);
     ET_LOG(Info, "Model executed successfully.");
 
-    // Print the outputs.
+    // Outputs are wrapped without copying. Outputs set with setOutputTensor()
+    // are already in the Java tensor's buffer.
     auto outputs = std::vector<EValue>(method_->outputs_size());
     status = method_->get_outputs(outputs.data(), outputs.size());
     ET_CHECK(status == Error::Ok);
     return JEValue::newJEValueFromEValue(outputs[0]);
   }
 
+  facebook::jni::local_ref<TensorHybrid::javaobject> getInputTensor(
+      jint index) {
+    if (index < 0 || index >= method_->inputs_size() ||
+        !method_->get_input(index).isTensor()) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "Input %d is not a tensor",
+          index);
+    }
+    // Wraps the method's own input memory, so that Java can fill it in place.
+    return TensorHybrid::newJTensorFromTensor(
+        method_->mutable_input(index).toTensor());
+  }
+
+  void setOutputTensor(
+      jint index,
+      facebook::jni::alias_ref<TensorHybrid::javaobject> jtensor) {
+    static auto dataBufferMethod =
+        TensorHybrid::javaClassStatic()
+            ->getMethod<facebook::jni::local_ref<
+                facebook::jni::JBuffer::javaobject>()>("getRawDataBuffer");
+    facebook::jni::local_ref<facebook::jni::JBuffer> jbuffer =
+        dataBufferMethod(jtensor);
+    JNIEnv* jni = facebook::jni::Environment::current();
+    void* data = jni->GetDirectBufferAddress(jbuffer.get());
+    if (data == nullptr || index < 0 || index >= method_->outputs_size()) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "Output %d needs a tensor backed by a direct buffer",
+          index);
+    }
+    // set_output_data_ptr() checks that the buffer can hold the output.
+    const auto& output = method_->get_output(index);
+    const size_t nbytes = output.isTensor()
+        ? jni->GetDirectBufferCapacity(jbuffer.get()) *
+            output.toTensor().element_size()
+        : 0;
+    Error status = method_->set_output_data_ptr(data, nbytes, index);
+    if (status != Error::Ok) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "Cannot write output %d to this tensor: 0x%" PRIx32,
+          index,
+          status);
+    }
+  }
+
   static void registerNatives() {
     registerHybrid({
         makeNativeMethod("initHybrid", ExecuTorchJni::initHybrid),
         makeNativeMethod("forward", ExecuTorchJni::forward),
+        makeNativeMethod("getInputTensor", ExecuTorchJni::getInputTensor),
+        makeNativeMethod("setOutputTensor", ExecuTorchJni::setOutputTensor),
+    });
+  }
+};
+
+class TensorImageUtilsNativePeer
+    : public facebook::jni::JavaClass<TensorImageUtilsNativePeer> {
+ public:
+  constexpr static const char* kJavaDescriptor =
+      "Lcom/example/executorchdemo/executor/TensorImageUtils$NativePeer;";
+
+  static void imageYUV420CenterCropToFloatBuffer(
+      facebook::jni::alias_ref<jclass>,
+      facebook::jni::alias_ref<facebook::jni::JByteBuffer> yBuffer,
+      jint yRowStride,
+      jint yPixelStride,
+      facebook::jni::alias_ref<facebook::jni::JByteBuffer> uBuffer,
+      facebook::jni::alias_ref<facebook::jni::JByteBuffer> vBuffer,
+      jint uvRowStride,
+      jint uvPixelStride,
+      jint imageWidth,
+      jint imageHeight,
+      jint rotateCWDegrees,
+      jint tensorWidth,
+      jint tensorHeight,
+      facebook::jni::alias_ref<jfloatArray> normMeanRGB,
+      facebook::jni::alias_ref<jfloatArray> normStdRGB,
+      facebook::jni::alias_ref<facebook::jni::JBuffer> outBuffer,
+      jint outBufferOffset) {
+    JNIEnv* jni = facebook::jni::Environment::current();
+    auto* out =
+        static_cast<float*>(jni->GetDirectBufferAddress(outBuffer.get()));
+    if (out == nullptr) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "outBuffer must be a direct buffer");
+    }
+    const auto normMean = normMeanRGB->getRegion(0, 3);
+    const auto normStd = normStdRGB->getRegion(0, 3);
+    yuv420_center_crop_to_float_chw(
+        static_cast<const uint8_t*>(jni->GetDirectBufferAddress(yBuffer.get())),
+        yRowStride,
+        yPixelStride,
+        static_cast<const uint8_t*>(jni->GetDirectBufferAddress(uBuffer.get())),
+        static_cast<const uint8_t*>(jni->GetDirectBufferAddress(vBuffer.get())),
+        uvRowStride,
+        uvPixelStride,
+        imageWidth,
+        imageHeight,
+        rotateCWDegrees,
+        tensorWidth,
+        tensorHeight,
+        normMean.get(),
+        normStd.get(),
+        out + outBufferOffset);
+  }
+
+  static void registerNatives() {
+    javaClassStatic()->registerNatives({
+        makeNativeMethod(
+            "imageYUV420CenterCropToFloatBuffer",
+            TensorImageUtilsNativePeer::imageYUV420CenterCropToFloatBuffer),
     });
   }
 };
@@ -358,6 +588,8 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
 } // namespace executorch_jni
 
 JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void*) {
-  return facebook::jni::initialize(
-      vm, [] { executorch_jni::ExecuTorchJni::registerNatives(); });
+  return facebook::jni::initialize(vm, [] {
+    executorch_jni::ExecuTorchJni::registerNatives();
+    executorch_jni::TensorImageUtilsNativePeer::registerNatives();
+  });
 }
@@ -15,14 +15,21 @@ enum CameraControllerError: Error {
   case setup(String)
 }
 
+// An uncompressed camera frame and how to rotate it upright.
+struct CameraFrame {
+  let pixelBuffer: CVPixelBuffer
+  let orientation: CGImagePropertyOrientation
+}
+
 class CameraController: NSObject, ObservableObject, AVCapturePhotoCaptureDelegate {
   let captureSession = AVCaptureSession()
   private var photoOutput = AVCapturePhotoOutput()
+  private var pixelFormat: OSType = kCVPixelFormatType_32BGRA
   private var timer: Timer?
-  private var callback: ((Result<UIImage, Error>) -> Void)?
+  private var callback: ((Result<CameraFrame, Error>) -> Void)?
 
   func startCapturing(withTimeInterval interval: TimeInterval,
-                      callback: @escaping (Result<UIImage, Error>) -> Void) {
+                      callback: @escaping (Result<CameraFrame, Error>) -> Void) {
     authorize { error in
       if let error {
         DispatchQueue.main.async {
@@ -41,7 +48,10 @@ class CameraController: NSObject, ObservableObject, AVCapturePhotoCaptureDelegat
         DispatchQueue.main.async {
           self.callback = callback
           self.timer = Timer.scheduledTimer(withTimeInterval: interval, repeats: true) { _ in
-            self.photoOutput.capturePhoto(with: AVCapturePhotoSettings(), delegate: self)
+            // Uncompressed photos go to the model without a JPEG encode and decode.
+            let settings = AVCapturePhotoSettings(
+              format: [kCVPixelBufferPixelFormatTypeKey as String: self.pixelFormat])
+            self.photoOutput.capturePhoto(with: settings, delegate: self)
           }
         }
       }
@@ -96,6 +106,17 @@ class CameraController: NSObject, ObservableObject, AVCapturePhotoCaptureDelegat
       callback(CameraControllerError.setup("Cannot add photo output"))
       return
     }
+    let supportedPixelFormats = [
+      kCVPixelFormatType_32BGRA, kCVPixelFormatType_420YpCbCr8BiPlanarFullRange,
+    ]
+    guard
+      let pixelFormat = supportedPixelFormats.first(
+        where: photoOutput.availablePhotoPixelFormatTypes.contains)
+    else {
+      callback(CameraControllerError.setup("Cannot capture uncompressed photos"))
+      return
+    }
+    self.pixelFormat = pixelFormat
     callback(nil)
   }
 
@@ -106,15 +127,14 @@ class CameraController: NSObject, ObservableObject, AVCapturePhotoCaptureDelegat
     }
     if let error {
       callback(.failure(CameraControllerError.capture("Image capture error: \(error)")))
+      return
     }
-    guard let imageData = photo.fileDataRepresentation(),
-          let image = UIImage(data: imageData),
-          let cgImage = image.cgImage
+    guard let pixelBuffer = photo.pixelBuffer
     else {
       callback(.failure(CameraControllerError.capture("Couldn't get image data")))
       return
     }
-    var orientation = UIImage.Orientation.up
+    var orientation = CGImagePropertyOrientation.up
     switch UIDevice.current.orientation {
     case .portrait:
       orientation = .right
@@ -125,6 +145,6 @@ class CameraController: NSObject, ObservableObject, AVCapturePhotoCaptureDelegat
     default:
       break
     }
-    callback(.success(UIImage(cgImage: cgImage, scale: image.scale, orientation: orientation)))
+    callback(.success(CameraFrame(pixelBuffer: pixelBuffer, orientation: orientation)))
   }
 }
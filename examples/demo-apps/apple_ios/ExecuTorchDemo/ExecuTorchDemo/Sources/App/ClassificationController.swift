@@ -26,7 +26,7 @@ class ClassificationController: ObservableObject {
   private var classifier: ImageClassification?
   private var currentMode: Mode = .xnnpack
 
-  func classify(_ image: UIImage) {
+  func classify(_ frame: CameraFrame) {
     guard !isRunning else {
       print("Dropping frame")
       return
@@ -45,7 +45,9 @@ class ClassificationController: ObservableObject {
           self.classifier = try self.createClassifier(for: self.currentMode)
         }
         let startTime = CFAbsoluteTimeGetCurrent()
-        classifications = try self.classifier?.classify(image: image) ?? []
+        classifications =
+          try self.classifier?.classify(
+            pixelBuffer: frame.pixelBuffer, orientation: frame.orientation) ?? []
         elapsedTime = (CFAbsoluteTimeGetCurrent() - startTime) * 1000
       } catch {
         print("Error classifying image: \(error)")
@@ -42,8 +42,8 @@ struct ContentView: View {
     UIApplication.shared.isIdleTimerDisabled = true
     cameraController.startCapturing(withTimeInterval: 1.0) { result in
       switch result {
-      case .success(let image):
-        self.classificationController.classify(image)
+      case .success(let frame):
+        self.classificationController.classify(frame)
       case .failure(let error):
         self.handleError(error)
       }
@@ -6,6 +6,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+import CoreVideo
+import ImageIO
 import UIKit
 
 public struct Classification {
@@ -20,4 +22,7 @@ public struct Classification {
 
 public protocol ImageClassification {
   func classify(image: UIImage) throws -> [Classification]
+  func classify(
+    pixelBuffer: CVPixelBuffer, orientation: CGImagePropertyOrientation
+  ) throws -> [Classification]
 }
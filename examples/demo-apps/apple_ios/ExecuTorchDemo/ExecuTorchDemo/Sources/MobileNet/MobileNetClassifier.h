@@ -6,7 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#import <CoreVideo/CoreVideo.h>
 #import <Foundation/Foundation.h>
+#import <ImageIO/ImageIO.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -20,6 +22,15 @@ FOUNDATION_EXPORT NSErrorDomain const ETMobileNetClassifierErrorDomain;
                    output:(float*)output
                outputSize:(NSInteger)predictionBufferSize
                     error:(NSError**)error;
+// Resizes, center-crops and normalizes a 32BGRA or 420YpCbCr8BiPlanar pixel
+// buffer, e.g. a camera frame, straight into the input memory of the model,
+// without intermediate images or buffers.
+- (BOOL)classifyWithPixelBuffer:(CVPixelBufferRef)pixelBuffer
+                    orientation:(CGImagePropertyOrientation)orientation
+                         output:(float*)output
+                     outputSize:(NSInteger)outputSize
+                          error:(NSError**)error
+    NS_SWIFT_NAME(classify(pixelBuffer:orientation:output:outputSize:));
 
 @end
 
@@ -8,6 +8,8 @@
 
 #import "MobileNetClassifier.h"
 
+#include <algorithm>
+
 #include "Module.h"
 
 using namespace ::torch::executor;
@@ -17,8 +19,154 @@ NSErrorDomain const ETMobileNetClassifierErrorDomain =
 const int32_t kSize = 224;
 const int32_t kChannels = 3;
 
+namespace {
+
+// The model expects images resized to 256 and center-cropped to 224, with
+// the ImageNet normalization.
+const float kCropRatio = 224.0f / 256.0f;
+const float kMean[kChannels] = {0.485f, 0.456f, 0.406f};
+const float kStd[kChannels] = {0.229f, 0.224f, 0.225f};
+
+struct RGB {
+  float r;
+  float g;
+  float b;
+};
+
+// The planes of a pixel buffer whose base address is locked.
+struct PixelPlanes {
+  OSType format;
+  size_t width;
+  size_t height;
+  const uint8_t* data[2];
+  size_t bytesPerRow[2];
+};
+
+bool isSupportedFormat(OSType format) {
+  return format == kCVPixelFormatType_32BGRA ||
+      format == kCVPixelFormatType_420YpCbCr8BiPlanarFullRange ||
+      format == kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange;
+}
+
+bool isSupportedOrientation(CGImagePropertyOrientation orientation) {
+  return orientation == kCGImagePropertyOrientationUp ||
+      orientation == kCGImagePropertyOrientationDown ||
+      orientation == kCGImagePropertyOrientationLeft ||
+      orientation == kCGImagePropertyOrientationRight;
+}
+
+RGB readPixel(const PixelPlanes& planes, size_t x, size_t y) {
+  if (planes.format == kCVPixelFormatType_32BGRA) {
+    const uint8_t* pixel = planes.data[0] + y * planes.bytesPerRow[0] + x * 4;
+    return {float(pixel[2]), float(pixel[1]), float(pixel[0])};
+  }
+  // A luma plane and an interleaved CbCr plane at half resolution, converted
+  // with BT.601.
+  float luma = planes.data[0][y * planes.bytesPerRow[0] + x];
+  const uint8_t* chroma =
+      planes.data[1] + (y / 2) * planes.bytesPerRow[1] + (x / 2) * 2;
+  float cb = chroma[0] - 128.0f;
+  float cr = chroma[1] - 128.0f;
+  if (planes.format == kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange) {
+    luma = (luma - 16.0f) * (255.0f / 219.0f);
+    cb *= 255.0f / 224.0f;
+    cr *= 255.0f / 224.0f;
+  }
+  return {
+      std::clamp(luma + 1.402f * cr, 0.0f, 255.0f),
+      std::clamp(luma - 0.344136f * cb - 0.714136f * cr, 0.0f, 255.0f),
+      std::clamp(luma + 1.772f * cb, 0.0f, 255.0f)};
+}
+
+RGB samplePixel(const PixelPlanes& planes, float x, float y) {
+  x = std::clamp(x, 0.0f, float(planes.width - 1));
+  y = std::clamp(y, 0.0f, float(planes.height - 1));
+  const size_t x0 = size_t(x);
+  const size_t y0 = size_t(y);
+  const size_t x1 = std::min(x0 + 1, planes.width - 1);
+  const size_t y1 = std::min(y0 + 1, planes.height - 1);
+  const float fx = x - x0;
+  const float fy = y - y0;
+  const RGB topLeft = readPixel(planes, x0, y0);
+  const RGB topRight = readPixel(planes, x1, y0);
+  const RGB bottomLeft = readPixel(planes, x0, y1);
+  const RGB bottomRight = readPixel(planes, x1, y1);
+  auto lerp = [fx, fy](float a, float b, float c, float d) {
+    return (a + (b - a) * fx) * (1 - fy) + (c + (d - c) * fx) * fy;
+  };
+  return {
+      lerp(topLeft.r, topRight.r, bottomLeft.r, bottomRight.r),
+      lerp(topLeft.g, topRight.g, bottomLeft.g, bottomRight.g),
+      lerp(topLeft.b, topRight.b, bottomLeft.b, bottomRight.b)};
+}
+
+// Writes the upright, resized, center-cropped and normalized image to
+// `input` as planar RGB, sampling each output pixel from the source once.
+void preprocess(
+    const PixelPlanes& planes,
+    CGImagePropertyOrientation orientation,
+    float* input) {
+  const bool transposed = orientation == kCGImagePropertyOrientationLeft ||
+      orientation == kCGImagePropertyOrientationRight;
+  const float width = planes.width;
+  const float height = planes.height;
+  const float uprightWidth = transposed ? height : width;
+  const float uprightHeight = transposed ? width : height;
+  const float cropSize = std::min(uprightWidth, uprightHeight) * kCropRatio;
+  const float scale = cropSize / kSize;
+  const float originX = (uprightWidth - cropSize) / 2;
+  const float originY = (uprightHeight - cropSize) / 2;
+
+  float multipliers[kChannels];
+  float offsets[kChannels];
+  for (auto channel = 0; channel < kChannels; ++channel) {
+    multipliers[channel] = 1.0f / (255.0f * kStd[channel]);
+    offsets[channel] = -kMean[channel] / kStd[channel];
+  }
+  const auto planeSize = kSize * kSize;
+  for (auto y = 0; y < kSize; ++y) {
+    const float uprightY = originY + (y + 0.5f) * scale - 0.5f;
+    for (auto x = 0; x < kSize; ++x) {
+      const float uprightX = originX + (x + 0.5f) * scale - 0.5f;
+      float sourceX = uprightX;
+      float sourceY = uprightY;
+      switch (orientation) {
+        case kCGImagePropertyOrientationDown:
+          sourceX = width - 1 - uprightX;
+          sourceY = height - 1 - uprightY;
+          break;
+        case kCGImagePropertyOrientationLeft:
+          sourceX = width - 1 - uprightY;
+          sourceY = uprightX;
+          break;
+        case kCGImagePropertyOrientationRight:
+          sourceX = uprightY;
+          sourceY = height - 1 - uprightX;
+          break;
+        default:
+          break;
+      }
+      const RGB pixel = samplePixel(planes, sourceX, sourceY);
+      const auto index = y * kSize + x;
+      input[index] = pixel.r * multipliers[0] + offsets[0];
+      input[index + planeSize] = pixel.g * multipliers[1] + offsets[1];
+      input[index + planeSize * 2] = pixel.b * multipliers[2] + offsets[2];
+    }
+  }
+}
+
+NSError* makeError(NSInteger code, NSString* description) {
+  return [NSError errorWithDomain:ETMobileNetClassifierErrorDomain
+                             code:code
+                         userInfo:@{NSLocalizedDescriptionKey : description}];
+}
+
+} // namespace
+
 @implementation ETMobileNetClassifier {
   std::unique_ptr<demo::Module> _module;
+  // Holds the input of models that do not plan it in their own memory.
+  std::vector<float> _inputBuffer;
 }
 
 - (nullable instancetype)initWithFilePath:(NSString*)filePath
@@ -57,18 +205,90 @@ const int32_t kChannels = 3;
   std::vector<EValue> inputs = {EValue(Tensor(&tensorImpl))};
   std::vector<EValue> outputs;
 
-  const auto torchError = _module->forward(inputs, outputs);
+  return [self finishForward:_module->forward(inputs, outputs)
+                     outputs:outputs
+                      output:output
+                  outputSize:outputSize
+                       error:error];
+}
+
+- (BOOL)classifyWithPixelBuffer:(CVPixelBufferRef)pixelBuffer
+                    orientation:(CGImagePropertyOrientation)orientation
+                         output:(float*)output
+                     outputSize:(NSInteger)outputSize
+                          error:(NSError**)error {
+  const auto format = CVPixelBufferGetPixelFormatType(pixelBuffer);
+  if (!isSupportedFormat(format) || !isSupportedOrientation(orientation)) {
+    if (error) {
+      *error = makeError(
+          -1,
+          [NSString stringWithFormat:
+                        @"Unsupported pixel format %u or orientation %u",
+                        unsigned(format),
+                        unsigned(orientation)]);
+    }
+    return NO;
+  }
+  // Write the input where the model reads it, so that forward() does not
+  // copy it again.
+  float* input = nullptr;
+  auto inputTensor = _module->input(0);
+  if (inputTensor.ok() && inputTensor->scalar_type() == ScalarType::Float &&
+      inputTensor->numel() == kChannels * kSize * kSize) {
+    input = inputTensor->mutable_data_ptr<float>();
+  }
+  if (input == nullptr) {
+    _inputBuffer.resize(kChannels * kSize * kSize);
+    input = _inputBuffer.data();
+  }
+
+  CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+  PixelPlanes planes{
+      format,
+      CVPixelBufferGetWidth(pixelBuffer),
+      CVPixelBufferGetHeight(pixelBuffer)};
+  if (CVPixelBufferIsPlanar(pixelBuffer)) {
+    for (size_t plane = 0; plane < 2; ++plane) {
+      planes.data[plane] = static_cast<const uint8_t*>(
+          CVPixelBufferGetBaseAddressOfPlane(pixelBuffer, plane));
+      planes.bytesPerRow[plane] =
+          CVPixelBufferGetBytesPerRowOfPlane(pixelBuffer, plane);
+    }
+  } else {
+    planes.data[0] =
+        static_cast<const uint8_t*>(CVPixelBufferGetBaseAddress(pixelBuffer));
+    planes.bytesPerRow[0] = CVPixelBufferGetBytesPerRow(pixelBuffer);
+  }
+  preprocess(planes, orientation, input);
+  CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+  if (input == _inputBuffer.data()) {
+    return [self classifyWithInput:input
+                            output:output
+                        outputSize:outputSize
+                             error:error];
+  }
+  std::vector<EValue> outputs;
+  return [self finishForward:_module->forward(outputs)
+                     outputs:outputs
+                      output:output
+                  outputSize:outputSize
+                       error:error];
+}
+
+- (BOOL)finishForward:(Error)torchError
+              outputs:(const std::vector<EValue>&)outputs
+               output:(float*)output
+           outputSize:(NSInteger)outputSize
+                error:(NSError**)error {
   if (torchError != Error::Ok) {
     if (error) {
-      *error = [NSError
-          errorWithDomain:ETMobileNetClassifierErrorDomain
-                     code:NSInteger(torchError)
-                 userInfo:@{
-                   NSLocalizedDescriptionKey : [NSString
-                       stringWithFormat:
-                           @"Failed to run forward on the torch module, error code: %i",
-                           torchError]
-                 }];
+      *error = makeError(
+          NSInteger(torchError),
+          [NSString
+              stringWithFormat:
+                  @"Failed to run forward on the torch module, error code: %i",
+                  torchError]);
     }
     return NO;
   }
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+import CoreVideo
 import ImageClassification
 import UIKit
 
@@ -58,7 +59,25 @@ public class MobileNetClassifier: ImageClassification {
         output: &output,
         outputSize: labels.count)
     }
-    return softmax(output).enumerated().sorted(by: { $0.element > $1.element })
+    return classifications(from: output)
+  }
+
+  // Preprocesses the frame straight into the model input in native code,
+  // skipping the intermediate images and buffers of classify(image:).
+  public func classify(
+    pixelBuffer: CVPixelBuffer, orientation: CGImagePropertyOrientation
+  ) throws -> [Classification] {
+    var output = [Float](repeating: 0, count: labels.count)
+    try mobileNetClassifier.classify(
+      pixelBuffer: pixelBuffer,
+      orientation: orientation,
+      output: &output,
+      outputSize: labels.count)
+    return classifications(from: output)
+  }
+
+  private func classifications(from output: [Float]) -> [Classification] {
+    softmax(output).enumerated().sorted(by: { $0.element > $1.element })
       .compactMap { (index, probability) -> Classification? in
         guard index < labels.count else { return nil }
         return Classification(label: labels[index], confidence: probability)
@@ -64,6 +64,10 @@ Error Module::forward(
       return error;
     }
   }
+  return forward(outputs);
+}
+
+Error Module::forward(std::vector<EValue>& outputs) {
   Error error = method_->execute();
   if (error != Error::Ok) {
     return error;
@@ -74,4 +78,15 @@ Error Module::forward(
   return method_->get_outputs(outputs.data(), outputsSize);
 }
 
+Result<Tensor> Module::input(size_t index) {
+  if (index >= method_->inputs_size()) {
+    return Error::InvalidArgument;
+  }
+  const auto& input = method_->get_input(index);
+  if (!input.isTensor()) {
+    return Error::InvalidArgument;
+  }
+  return input.toTensor();
+}
+
 } // namespace torch::executor::demo
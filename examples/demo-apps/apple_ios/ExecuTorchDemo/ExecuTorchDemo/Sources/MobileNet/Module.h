@@ -25,6 +25,19 @@ class Module {
       const std::vector<EValue>& inputs,
       std::vector<EValue>& outputs);
 
+  /**
+   * Runs the method on the inputs that are already in its memory, e.g.
+   * written in place through input().
+   */
+  Error forward(std::vector<EValue>& outputs);
+
+  /**
+   * Returns input tensor `index` of the method. If the method plans the input,
+   * its data is the memory that forward() reads, so writing to it directly
+   * saves copying the input; otherwise its data is null.
+   */
+  Result<Tensor> input(size_t index);
+
  private:
   std::unique_ptr<DataLoader> dataLoader_;
   std::unique_ptr<Program> program_;
@@ -67,6 +67,42 @@ final class MobileNetClassifierTest: XCTestCase {
       }
       XCTAssertEqual(classification.label, expectedClassification.label)
       XCTAssertGreaterThan(classification.confidence, expectedClassification.confidence)
+
+      let pixelBuffer = try XCTUnwrap(makePixelBuffer(from: image))
+      guard
+        let pixelBufferClassification = try classifier?.classify(
+          pixelBuffer: pixelBuffer, orientation: .up
+        ).first
+      else {
+        XCTFail("Failed to run the model on the pixel buffer")
+        return
+      }
+      XCTAssertEqual(pixelBufferClassification.label, expectedClassification.label)
     }
   }
+
+  private func makePixelBuffer(from image: UIImage) -> CVPixelBuffer? {
+    guard let cgImage = image.cgImage else { return nil }
+    var pixelBuffer: CVPixelBuffer?
+    CVPixelBufferCreate(
+      kCFAllocatorDefault, cgImage.width, cgImage.height, kCVPixelFormatType_32BGRA, nil,
+      &pixelBuffer)
+    guard let pixelBuffer else { return nil }
+    CVPixelBufferLockBaseAddress(pixelBuffer, [])
+    defer { CVPixelBufferUnlockBaseAddress(pixelBuffer, []) }
+    let context = CGContext(
+      data: CVPixelBufferGetBaseAddress(pixelBuffer),
+      width: cgImage.width,
+      height: cgImage.height,
+      bitsPerComponent: 8,
+      bytesPerRow: CVPixelBufferGetBytesPerRow(pixelBuffer),
+      space: CGColorSpaceCreateDeviceRGB(),
+      bitmapInfo: CGImageAlphaInfo.premultipliedFirst.rawValue
+        | CGBitmapInfo.byteOrder32Little.rawValue
+    )
+    context?.draw(
+      cgImage,
+      in: CGRect(origin: .zero, size: CGSize(width: cgImage.width, height: cgImage.height)))
+    return pixelBuffer
+  }
 }
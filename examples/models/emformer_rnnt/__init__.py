@@ -7,11 +7,13 @@
 from .model import (
     EmformerRnntJoinerModel,
     EmformerRnntPredictorModel,
+    EmformerRnntStreamingTranscriberModel,
     EmformerRnntTranscriberModel,
 )
 
 __all__ = [
     EmformerRnntTranscriberModel,
+    EmformerRnntStreamingTranscriberModel,
     EmformerRnntPredictorModel,
     EmformerRnntJoinerModel,
 ]
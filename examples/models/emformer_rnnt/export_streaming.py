@@ -0,0 +1,43 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# Example script for exporting the streaming Emformer RNN-T transcriber to flatbuffer
+
+import logging
+
+import executorch.exir as exir
+from executorch.exir import ExecutorchBackendConfig
+from executorch.exir.passes import MemoryPlanningPass
+
+from ...portable.utils import export_to_exec_prog
+from .model import EmformerRnntStreamingTranscriberModel
+
+
+FORMAT = "[%(levelname)s %(asctime)s %(filename)s:%(lineno)s] %(message)s"
+logging.basicConfig(level=logging.INFO, format=FORMAT)
+
+# The memory id of the encoder state. Keeping it apart from the activations
+# makes Method::state_size() the size of the state alone, so that a
+# StatePool can keep the state of many streams compactly.
+STATE_MEM_ID = 2
+
+
+if __name__ == "__main__":
+    model = EmformerRnntStreamingTranscriberModel()
+    prog = export_to_exec_prog(
+        model.get_eager_model(),
+        model.get_example_inputs(),
+        edge_compile_config=exir.EdgeCompileConfig(_check_ir_validity=False),
+        backend_config=ExecutorchBackendConfig(
+            memory_planning_pass=MemoryPlanningPass(
+                "greedy", mutable_buffer_mem_id=STATE_MEM_ID
+            ),
+        ),
+    )
+    filename = "emformer_transcribe_streaming.pte"
+    with open(filename, "wb") as file:
+        prog.write_to_file(file)
+    logging.info(f"Saved exported program to {filename}")
@@ -19,6 +19,7 @@ logging.basicConfig(format=FORMAT)
 
 __all__ = [
     "EmformerRnntTranscriberModel",
+    "EmformerRnntStreamingTranscriberModel",
     "EmformerRnntPredictorModel",
     "EmformerRnntJoinerModel",
 ]
@@ -59,6 +60,71 @@ class EmformerRnntTranscriberModel(EagerModelBase):
         return (transcribe_inputs,)
 
 
+class EmformerRnntStreamingTranscriberExample(torch.nn.Module):
+    """
+    This is a wrapper for streaming transcription with the Emformer RNN-T architecture: each call
+    transcribes one chunk of audio features. The Emformer memory and left context that carry over
+    between chunks are kept in buffers that the exported method updates in place, so a chunk costs
+    the same however long the utterance has run, and the runtime keeps the state across executions.
+    """
+
+    def __init__(self) -> None:
+        super().__init__()
+        bundle = torchaudio.pipelines.EMFORMER_RNNT_BASE_LIBRISPEECH
+        decoder = bundle.get_decoder()
+        m = decoder.model
+        self.rnnt = m
+        # A chunk is a segment plus its right context, in feature frames.
+        self.chunk_length = bundle.segment_length + bundle.right_context_length
+        self.num_mel_bins = 80
+
+        # The initial state of every layer is all zeros: empty memory and left context, and no
+        # frames seen yet.
+        _, _, state = m.transcribe_streaming(
+            torch.zeros(1, self.chunk_length, self.num_mel_bins),
+            torch.tensor([self.chunk_length]),
+            None,
+        )
+        self.state_shape = [len(layer_state) for layer_state in state]
+        for layer, layer_state in enumerate(state):
+            for i, tensor in enumerate(layer_state):
+                self.register_buffer(f"state_{layer}_{i}", torch.zeros_like(tensor))
+
+    def get_state(self):
+        return [
+            [getattr(self, f"state_{layer}_{i}") for i in range(size)]
+            for layer, size in enumerate(self.state_shape)
+        ]
+
+    def forward(self, sources, source_lengths):
+        output, output_lengths, new_state = self.rnnt.transcribe_streaming(
+            sources, source_lengths, self.get_state()
+        )
+        for layer_state, new_layer_state in zip(self.get_state(), new_state):
+            for tensor, new_tensor in zip(layer_state, new_layer_state):
+                tensor.copy_(new_tensor)
+        return output, output_lengths
+
+
+class EmformerRnntStreamingTranscriberModel(EagerModelBase):
+    def __init__(self):
+        self.model = None
+
+    def get_eager_model(self) -> torch.nn.Module:
+        if self.model is None:
+            logging.info("Loading emformer rnnt streaming transcriber")
+            self.model = EmformerRnntStreamingTranscriberExample()
+            logging.info("Loaded emformer rnnt streaming transcriber")
+        return self.model
+
+    def get_example_inputs(self):
+        model = self.get_eager_model()
+        return (
+            torch.randn(1, model.chunk_length, model.num_mel_bins),
+            torch.tensor([model.chunk_length]),
+        )
+
+
 class EmformerRnntPredictorExample(torch.nn.Module):
     """
     This is a wrapper for validating predictor for the Emformer RNN-T architecture.
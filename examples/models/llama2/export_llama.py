@@ -0,0 +1,120 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# Example script for exporting Llama2 to flatbuffer
+
+import argparse
+import logging
+
+import executorch.exir as exir
+
+import torch
+from executorch.exir import ExecutorchBackendConfig, to_edge
+from executorch.exir.passes import MemoryPlanningPass
+from executorch.exir.passes.sym_shape_eval_pass import ConstraintBasedSymShapeEvalPass
+from torch._export import capture_pre_autograd_graph
+from torch.export import dynamic_dim, export
+
+from ...portable.utils import export_to_exec_prog
+from .model import Llama2Model
+
+
+FORMAT = "[%(levelname)s %(asctime)s %(filename)s:%(lineno)s] %(message)s"
+logging.basicConfig(level=logging.INFO, format=FORMAT)
+
+# The memory id of the KV cache. Keeping it apart from the activations lets the
+# runtime size and place the persistent state on its own, and keeps it at the
+# same offsets in every method.
+KV_CACHE_MEM_ID = 2
+
+
+def _export_method(model, example_inputs, constraints=None):
+    m = capture_pre_autograd_graph(model, example_inputs, constraints=constraints)
+    return export(m, example_inputs, constraints=constraints)
+
+
+def export_prefill_decode(llama: Llama2Model) -> exir.ExecutorchProgramManager:
+    """
+    Exports a program with two methods that share the weights and the KV cache:
+    `prefill` runs a whole prompt of dynamic length, and `decode` a single
+    token. Prefill is compute bound and decode memory bound, so each gets a
+    graph specialized for its shapes.
+
+    Both methods must be loaded before either executes, since loading a method
+    initializes the KV cache.
+    """
+    model = llama.get_eager_model().eval()
+
+    prefill_inputs = llama.get_prefill_example_inputs()
+    tokens, input_pos = prefill_inputs
+    prefill_constraints = [
+        dynamic_dim(tokens, 1) <= llama.get_max_seq_len(),
+        dynamic_dim(tokens, 1) == dynamic_dim(input_pos, 0),
+    ]
+    methods = {
+        "prefill": _export_method(model, prefill_inputs, prefill_constraints),
+        "decode": _export_method(model, llama.get_example_inputs()),
+    }
+
+    edge_manager = to_edge(
+        methods,
+        # Lets the runner size its buffers without knowing the model.
+        constant_methods={"get_max_seq_len": llama.get_max_seq_len()},
+        compile_config=exir.EdgeCompileConfig(_check_ir_validity=False),
+    )
+    return edge_manager.to_executorch(
+        ExecutorchBackendConfig(
+            sym_shape_eval_pass=ConstraintBasedSymShapeEvalPass(),
+            memory_planning_pass=MemoryPlanningPass(
+                "greedy", mutable_buffer_mem_id=KV_CACHE_MEM_ID
+            ),
+            # Constant buffers are deduplicated across the methods, and sharing
+            # the planned buffers makes them share the KV cache too.
+            share_memory_planned_buffers=True,
+        )
+    )
+
+
+def save_program(prog: exir.ExecutorchProgramManager, model_name: str) -> None:
+    filename = f"{model_name}.pte"
+    with open(filename, "wb") as file:
+        # Streams the weights to the file instead of building the whole
+        # binary in memory first.
+        prog.write_to_file(file)
+    logging.info(f"Saved exported program to {filename}")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--use_kv_cache",
+        action="store_true",
+        help="export prefill and decode methods that share a KV cache, which is "
+        "kept across executions",
+    )
+    parser.add_argument(
+        "--use_sdpa_op",
+        action="store_true",
+        help="compute attention with the fused executorch_prim::sdpa op, which "
+        "requires a runtime built with the optimized kernels",
+    )
+
+    args = parser.parse_args()
+
+    llama = Llama2Model(use_kv_cache=args.use_kv_cache, use_sdpa_op=args.use_sdpa_op)
+    if args.use_kv_cache:
+        prog = export_prefill_decode(llama)
+        save_program(prog, "llama2_kv")
+    else:
+        prog = export_to_exec_prog(
+            llama.get_eager_model(),
+            llama.get_example_inputs(),
+            # The custom sdpa op is not a core ATen op.
+            edge_compile_config=exir.EdgeCompileConfig(
+                _check_ir_validity=not args.use_sdpa_op
+            ),
+        )
+        save_program(prog, "llama2")
@@ -0,0 +1,53 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# Writes the vocabulary of a sentencepiece model in the format that the C++
+# runner's tokenizer reads; see runner/tokenizer.h.
+
+import argparse
+import struct
+
+from sentencepiece import SentencePieceProcessor
+
+
+def export_tokenizer(model_path: str, output_path: str) -> None:
+    sp = SentencePieceProcessor(model_file=model_path)
+    assert sp.vocab_size() == sp.get_piece_size()
+
+    pieces = []
+    for i in range(sp.vocab_size()):
+        piece = sp.id_to_piece(i)
+        # Control tokens keep their names, and the word boundary marker becomes
+        # a space, so that decoding is concatenation.
+        if i == sp.bos_id():
+            piece = "\n<s>\n"
+        elif i == sp.eos_id():
+            piece = "\n</s>\n"
+        piece = piece.replace("▁", " ")
+        pieces.append((piece.encode("utf-8"), sp.get_score(i)))
+
+    max_token_length = max(len(piece) for piece, _ in pieces)
+    with open(output_path, "wb") as f:
+        f.write(
+            struct.pack(
+                "<iiii", sp.vocab_size(), sp.bos_id(), sp.eos_id(), max_token_length
+            )
+        )
+        for piece, score in pieces:
+            f.write(struct.pack("<fi", score, len(piece)))
+            f.write(piece)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "-t", "--tokenizer_model", required=True, help="sentencepiece model file"
+    )
+    parser.add_argument(
+        "-o", "--output_path", default="tokenizer.bin", help="output file"
+    )
+    args = parser.parse_args()
+    export_tokenizer(args.tokenizer_model, args.output_path)
@@ -17,6 +17,9 @@ import torch.nn.functional as F
 
 from examples.models.model_base import EagerModelBase
 
+# Registers torch.ops.executorch_prim.sdpa
+from executorch.exir.passes.sdpa_op import sdpa  # noqa: F401
+
 from llama.model import ModelArgs, repeat_kv, RMSNorm
 from torch import nn
 
@@ -60,7 +63,9 @@ def apply_rotary_emb(
 
 
 class Attention(nn.Module):
-    def __init__(self, args: ModelArgs):
+    def __init__(
+        self, args: ModelArgs, use_kv_cache: bool = False, use_sdpa_op: bool = False
+    ):
         super().__init__()
         self.n_kv_heads = args.n_heads if args.n_kv_heads is None else args.n_kv_heads
         assert args.n_heads % self.n_kv_heads == 0
@@ -78,11 +83,30 @@ class Attention(nn.Module):
         mask = torch.triu(mask, diagonal=1)
         self.register_buffer("mask", mask)
 
+        # The keys and values of every position seen so far. The exported program updates them
+        # in place, and the runtime keeps them across executions of the method.
+        self.use_kv_cache = use_kv_cache
+        if use_kv_cache:
+            cache_shape = (
+                args.max_batch_size,
+                self.n_local_kv_heads,
+                args.max_seq_len,
+                self.head_dim,
+            )
+            self.register_buffer("k_cache", torch.zeros(cache_shape))
+            self.register_buffer("v_cache", torch.zeros(cache_shape))
+
+        # Whether to compute the attention with the fused executorch_prim::sdpa op, which reads
+        # the shared key and value heads directly and never materializes the scores. The runtime
+        # must be built with the optimized kernels.
+        self.use_sdpa_op = use_sdpa_op
+
     def forward(
         self,
         x: torch.Tensor,
         freqs_cos: torch.Tensor,
         freqs_sin: torch.Tensor,
+        input_pos: Optional[torch.Tensor] = None,
     ):
         bsz, seqlen, _ = x.shape
 
@@ -95,6 +119,21 @@ class Attention(nn.Module):
         # RoPE relative positional embeddings
         xq, xk = apply_rotary_emb(xq, xk, freqs_cos, freqs_sin)
 
+        if self.use_kv_cache:
+            assert input_pos is not None
+            return self._forward_with_kv_cache(xq, xk, xv, input_pos)
+
+        if self.use_sdpa_op:
+            output = torch.ops.executorch_prim.sdpa(
+                xq.transpose(1, 2),
+                xk.transpose(1, 2),
+                xv.transpose(1, 2),
+                None,
+                True,  # is_causal
+            )  # (bs, n_local_heads, seqlen, head_dim)
+            output = output.transpose(1, 2).contiguous().view(bsz, seqlen, -1)
+            return self.wo(output)
+
         # grouped multiquery attention: expand out keys and values
         xk = repeat_kv(xk, self.n_rep)  # (bs, seqlen, n_local_heads, head_dim)
         xv = repeat_kv(xv, self.n_rep)  # (bs, seqlen, n_local_heads, head_dim)
@@ -117,6 +156,48 @@ class Attention(nn.Module):
         output = self.wo(output)
         return output
 
+    def _forward_with_kv_cache(
+        self,
+        xq: torch.Tensor,
+        xk: torch.Tensor,
+        xv: torch.Tensor,
+        input_pos: torch.Tensor,
+    ):
+        bsz, seqlen, _, _ = xq.shape
+
+        # (bs, n_local_kv_heads, seqlen, head_dim)
+        xk = xk.transpose(1, 2)
+        xv = xv.transpose(1, 2)
+        # Write the new positions into the caches in place, then attend over all of the cache.
+        # Positions not written yet are masked out, which keeps the shapes static.
+        self.k_cache[:, :, input_pos] = xk
+        self.v_cache[:, :, input_pos] = xv
+
+        if self.use_sdpa_op:
+            output = torch.ops.executorch_prim.sdpa(
+                xq.transpose(1, 2),
+                self.k_cache,
+                self.v_cache,
+                self.mask[:, :, input_pos],
+            )  # (bs, n_local_heads, seqlen, head_dim)
+            output = output.transpose(1, 2).contiguous().view(bsz, seqlen, -1)
+            return self.wo(output)
+
+        # grouped multiquery attention: expand out keys and values
+        keys = repeat_kv(self.k_cache.transpose(1, 2), self.n_rep).transpose(1, 2)
+        values = repeat_kv(self.v_cache.transpose(1, 2), self.n_rep).transpose(1, 2)
+
+        xq = xq.transpose(1, 2)  # (bs, n_local_heads, seqlen, head_dim)
+        scores = torch.matmul(xq, keys.transpose(2, 3)) / math.sqrt(self.head_dim)
+        scores = scores + self.mask[:, :, input_pos]  # (bs, n_local_heads, seqlen, max_seq_len)
+        scores = F.softmax(scores.float(), dim=-1).type_as(xq)
+        output = torch.matmul(scores, values)  # (bs, n_local_heads, seqlen, head_dim)
+
+        output = output.transpose(1, 2).contiguous().view(bsz, seqlen, -1)
+
+        output = self.wo(output)
+        return output
+
 
 class FeedForward(nn.Module):
     def __init__(self, dim: int, hidden_dim: int, multiple_of: int):
@@ -132,12 +213,18 @@ class FeedForward(nn.Module):
 
 
 class TransformerBlock(nn.Module):
-    def __init__(self, layer_id: int, args: ModelArgs):
+    def __init__(
+        self,
+        layer_id: int,
+        args: ModelArgs,
+        use_kv_cache: bool = False,
+        use_sdpa_op: bool = False,
+    ):
         super().__init__()
         self.n_heads = args.n_heads
         self.dim = args.dim
         self.head_dim = args.dim // args.n_heads
-        self.attention = Attention(args)
+        self.attention = Attention(args, use_kv_cache, use_sdpa_op)
         self.feed_forward = FeedForward(
             dim=args.dim,
             hidden_dim=4 * args.dim,
@@ -147,8 +234,10 @@ class TransformerBlock(nn.Module):
         self.attention_norm = RMSNorm(args.dim, eps=args.norm_eps)
         self.ffn_norm = RMSNorm(args.dim, eps=args.norm_eps)
 
-    def forward(self, x, freqs_cos, freqs_sin):
-        h = x + self.attention.forward(self.attention_norm(x), freqs_cos, freqs_sin)
+    def forward(self, x, freqs_cos, freqs_sin, input_pos=None):
+        h = x + self.attention.forward(
+            self.attention_norm(x), freqs_cos, freqs_sin, input_pos
+        )
         out = h + self.feed_forward.forward(self.ffn_norm(h))
         return out
 
@@ -156,16 +245,21 @@ class TransformerBlock(nn.Module):
 class Transformer(nn.Module):
     last_loss: Optional[torch.Tensor]
 
-    def __init__(self, params: ModelArgs):
+    def __init__(
+        self, params: ModelArgs, use_kv_cache: bool = False, use_sdpa_op: bool = False
+    ):
         super().__init__()
         self.params = params
         self.vocab_size = params.vocab_size
         self.n_layers = params.n_layers
+        self.use_kv_cache = use_kv_cache
 
         self.tok_embeddings = nn.Embedding(params.vocab_size, params.dim)
         self.layers = torch.nn.ModuleList()
         for layer_id in range(params.n_layers):
-            self.layers.append(TransformerBlock(layer_id, params))
+            self.layers.append(
+                TransformerBlock(layer_id, params, use_kv_cache, use_sdpa_op)
+            )
         self.norm = RMSNorm(params.dim, eps=params.norm_eps)
         self.output = nn.Linear(params.dim, params.vocab_size, bias=False)
 
@@ -175,14 +269,25 @@ class Transformer(nn.Module):
         self.register_buffer("freqs_cos", freqs_cos, persistent=False)
         self.register_buffer("freqs_sin", freqs_sin, persistent=False)
 
-    def forward(self, tokens: torch.Tensor) -> torch.Tensor:
+    def forward(
+        self, tokens: torch.Tensor, input_pos: Optional[torch.Tensor] = None
+    ) -> torch.Tensor:
+        """
+        With the KV cache, input_pos holds the positions of the tokens in the sequence, and the
+        tokens of earlier calls are read from the cache instead of being passed again.
+        """
         _bsz, seqlen = tokens.shape
         h = self.tok_embeddings(tokens)
-        freqs_cos = self.freqs_cos[:seqlen]
-        freqs_sin = self.freqs_sin[:seqlen]
+        if self.use_kv_cache:
+            assert input_pos is not None, "input_pos is required with the KV cache"
+            freqs_cos = self.freqs_cos[input_pos]
+            freqs_sin = self.freqs_sin[input_pos]
+        else:
+            freqs_cos = self.freqs_cos[:seqlen]
+            freqs_sin = self.freqs_sin[:seqlen]
 
         for layer in self.layers:
-            h = layer(h, freqs_cos, freqs_sin)
+            h = layer(h, freqs_cos, freqs_sin, input_pos)
         # h = self.layers[0](h, freqs_cos, freqs_sin) # myuan: hack one layer for debug
 
         h = self.norm(h)
@@ -192,7 +297,7 @@ class Transformer(nn.Module):
 
 
 class Llama2Model(EagerModelBase):
-    def __init__(self):
+    def __init__(self, use_kv_cache: bool = False, use_sdpa_op: bool = False):
         ckpt_dir = Path(__file__).absolute().parent
         # The example is using a dummy small model with random weights for demo purpose only.
         # Follow the instruction in https://github.com/facebookresearch/llama to download the model
@@ -209,7 +314,8 @@ class Llama2Model(EagerModelBase):
             max_batch_size=max_batch_size,
             **params,
         )
-        self.model_ = Transformer(model_args)
+        self.use_kv_cache = use_kv_cache
+        self.model_ = Transformer(model_args, use_kv_cache, use_sdpa_op)
         self.model_.load_state_dict(
             checkpoint, strict=False
         )  # self.model_ = Transformer(gptconf)
@@ -218,6 +324,23 @@ class Llama2Model(EagerModelBase):
     def get_eager_model(self):
         return self.model_
 
-    @staticmethod
-    def get_example_inputs():
+    def get_example_inputs(self):
+        if self.use_kv_cache:
+            # One token at position 0
+            return (torch.tensor([[1]]), torch.tensor([0]))
         return (torch.tensor([[1]]),)
+
+    def get_prefill_example_inputs(self):
+        """
+        A prompt of several tokens from position 0, for the prefill method of a model with the
+        KV cache. The prompt length is dynamic in the exported method, up to max_seq_len.
+        """
+        assert self.use_kv_cache, "prefill requires the KV cache"
+        prompt_len = 4
+        return (
+            torch.arange(1, prompt_len + 1).reshape(1, prompt_len),
+            torch.arange(prompt_len),
+        )
+
+    def get_max_seq_len(self):
+        return self.model_.params.max_seq_len
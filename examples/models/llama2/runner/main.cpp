@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Generates text with a Llama 2 program exported by export_llama.py with
+ * --use_kv_cache, and reports the time to first token and the decode speed.
+ *
+ * Like executor_runner, it can be linked against any desired kernel or backend
+ * implementations.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+
+#include <gflags/gflags.h>
+
+#include <executorch/examples/models/llama2/runner/runner.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+
+DEFINE_string(
+    model_path,
+    "llama2_kv.pte",
+    "Model serialized in flatbuffer format.");
+
+DEFINE_string(
+    tokenizer_path,
+    "tokenizer.bin",
+    "Tokenizer vocabulary written by export_tokenizer.py.");
+
+DEFINE_string(prompt, "Once upon a time", "Prompt.");
+
+DEFINE_int32(
+    seq_len,
+    128,
+    "Total number of tokens, prompt included, to stop at. Capped at the "
+    "max_seq_len of the model.");
+
+DEFINE_double(
+    temperature,
+    0.8,
+    "Temperature; 0 always picks the most likely token.");
+
+DEFINE_int32(topk, 0, "If positive, samples from the top k tokens only.");
+
+DEFINE_double(
+    topp,
+    0.9,
+    "If in (0, 1), samples from the smallest set of tokens whose "
+    "probabilities add up to topp.");
+
+DEFINE_uint64(seed, 42, "Seed of the sampler.");
+
+DEFINE_string(
+    draft_model_path,
+    "",
+    "A smaller program over the same vocabulary, exported with the KV cache, "
+    "that proposes tokens for model_path to verify in one execution. The "
+    "output is unchanged; only the speed is.");
+
+DEFINE_int32(
+    num_draft_tokens,
+    4,
+    "Tokens that the draft model proposes per step, with draft_model_path.");
+
+using namespace torch::executor;
+
+int main(int argc, char** argv) {
+  runtime_init();
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+
+  Runner runner(
+      FLAGS_model_path,
+      FLAGS_tokenizer_path,
+      static_cast<float>(FLAGS_temperature),
+      FLAGS_topk,
+      static_cast<float>(FLAGS_topp),
+      FLAGS_seed,
+      FLAGS_draft_model_path,
+      FLAGS_num_draft_tokens);
+  Error err = runner.load();
+  if (err != Error::Ok) {
+    ET_LOG(Error, "Loading failed with status 0x%" PRIx32, err);
+    return 1;
+  }
+
+  printf("%s", FLAGS_prompt.c_str());
+  Runner::Stats stats;
+  err = runner.generate(
+      FLAGS_prompt,
+      FLAGS_seq_len,
+      [](const std::string& piece) {
+        printf("%s", piece.c_str());
+        fflush(stdout);
+      },
+      &stats);
+  printf("\n");
+  if (err != Error::Ok) {
+    ET_LOG(Error, "Generation failed with status 0x%" PRIx32, err);
+    return 1;
+  }
+
+  // The first generated token is sampled from the prompt's logits, so decode
+  // speed counts the ones after it.
+  const int64_t num_decoded = stats.num_generated_tokens - 1;
+  printf(
+      "Prompt tokens: %" PRId64 ", generated tokens: %" PRId64 "\n",
+      stats.num_prompt_tokens,
+      stats.num_generated_tokens);
+  printf(
+      "Prompt eval: %.2f ms (%.2f tokens/s)\n",
+      stats.prompt_eval_ms,
+      stats.prompt_eval_ms > 0
+          ? stats.num_prompt_tokens * 1000.0 / stats.prompt_eval_ms
+          : 0.0);
+  printf("Time to first token: %.2f ms\n", stats.time_to_first_token_ms);
+  printf(
+      "Decode: %.2f ms (%.2f tokens/s)\n",
+      stats.decode_ms,
+      num_decoded > 0 && stats.decode_ms > 0
+          ? num_decoded * 1000.0 / stats.decode_ms
+          : 0.0);
+  if (stats.num_draft_tokens > 0) {
+    printf(
+        "Draft tokens accepted: %" PRId64 " of %" PRId64 " (%.1f%%)\n",
+        stats.num_accepted_draft_tokens,
+        stats.num_draft_tokens,
+        stats.num_accepted_draft_tokens * 100.0 / stats.num_draft_tokens);
+  }
+  return 0;
+}
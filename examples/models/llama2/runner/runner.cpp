@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/examples/models/llama2/runner/runner.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+
+#include <executorch/runtime/platform/log.h>
+
+// Returns the error of `expr__` from the enclosing function unless it is Ok.
+#define RETURN_IF_ERROR(expr__)                    \
+  do {                                             \
+    const torch::executor::Error err__ = (expr__); \
+    if (err__ != torch::executor::Error::Ok) {     \
+      return err__;                                \
+    }                                              \
+  } while (0)
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+constexpr size_t kMethodAllocatorPoolSize = 4 * 1024U * 1024U; // 4 MB
+
+double ms_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+bool has_method(const Program& program, const char* name) {
+  return program.method_meta(name).ok();
+}
+
+struct LoadedMethods {
+  std::unique_ptr<Method>* methods[3];
+  Error error = Error::Ok;
+};
+
+int32_t argmax(const float* logits, int32_t vocab_size) {
+  return static_cast<int32_t>(
+      std::max_element(logits, logits + vocab_size) - logits);
+}
+
+void on_method_loaded(void* context, size_t index, Result<Method>&& method) {
+  auto* loaded = static_cast<LoadedMethods*>(context);
+  if (!method.ok()) {
+    loaded->error = method.error();
+    return;
+  }
+  *loaded->methods[index] = std::make_unique<Method>(std::move(method.get()));
+}
+
+} // namespace
+
+Runner::Runner(
+    const std::string& model_path,
+    const std::string& tokenizer_path,
+    float temperature,
+    int32_t topk,
+    float topp,
+    uint64_t seed,
+    const std::string& draft_model_path,
+    int32_t num_draft_tokens)
+    : tokenizer_path_(tokenizer_path),
+      temperature_(temperature),
+      topk_(topk),
+      topp_(topp),
+      seed_(seed),
+      num_draft_tokens_(num_draft_tokens),
+      model_(model_path) {
+  if (!draft_model_path.empty()) {
+    draft_ = std::make_unique<Model>(draft_model_path);
+  }
+}
+
+Error Runner::load() {
+  if (is_loaded()) {
+    return Error::Ok;
+  }
+
+  RETURN_IF_ERROR(model_.load());
+  if (draft_ != nullptr) {
+    // The target verifies all the draft tokens in one execution.
+    ET_CHECK_OR_RETURN_ERROR(
+        model_.has_prefill(),
+        InvalidProgram,
+        "Speculative decoding needs a program with a prefill method");
+    ET_CHECK_OR_RETURN_ERROR(
+        num_draft_tokens_ > 0,
+        InvalidArgument,
+        "num_draft_tokens must be positive, got %" PRId32,
+        num_draft_tokens_);
+    RETURN_IF_ERROR(draft_->load());
+  }
+
+  Result<Tokenizer> tokenizer = Tokenizer::load(tokenizer_path_.c_str());
+  RETURN_IF_ERROR(tokenizer.error());
+  tokenizer_ = std::make_unique<Tokenizer>(std::move(tokenizer.get()));
+  vocab_size_ = tokenizer_->vocab_size();
+  sampler_ = std::make_unique<Sampler>(
+      vocab_size_, temperature_, topk_, topp_, seed_);
+  return Error::Ok;
+}
+
+Error Runner::Model::load() {
+  if (decode_ != nullptr) {
+    return Error::Ok;
+  }
+
+  Result<util::FileDataLoader> loader =
+      util::FileDataLoader::from(path_.c_str());
+  RETURN_IF_ERROR(loader.error());
+  loader_ = std::make_unique<util::FileDataLoader>(std::move(loader.get()));
+  Result<Program> program = Program::load(loader_.get());
+  if (!program.ok()) {
+    ET_LOG(Error, "Failed to parse model file %s", path_.c_str());
+    return program.error();
+  }
+  program_ = std::make_unique<Program>(std::move(program.get()));
+
+  const bool split = has_method(*program_, "prefill");
+  const char* decode_name = split ? "decode" : "forward";
+  ET_CHECK_OR_RETURN_ERROR(
+      has_method(*program_, decode_name),
+      InvalidProgram,
+      "%s has no %s method",
+      path_.c_str(),
+      decode_name);
+
+  // The methods run one after the other, so one set of planned buffers, large
+  // enough for each of them, backs all of them. That also shares the KV cache,
+  // which export_llama.py plans at the same place in each method.
+  std::vector<const char*> names;
+  if (split) {
+    names.push_back("prefill");
+  }
+  names.push_back(decode_name);
+  std::vector<size_t> buffer_sizes;
+  for (const char* name : names) {
+    Result<MethodMeta> meta = program_->method_meta(name);
+    RETURN_IF_ERROR(meta.error());
+    buffer_sizes.resize(
+        std::max(buffer_sizes.size(), meta->num_memory_planned_buffers()));
+    for (size_t id = 0; id < meta->num_memory_planned_buffers(); ++id) {
+      buffer_sizes[id] = std::max(
+          buffer_sizes[id],
+          static_cast<size_t>(meta->memory_planned_buffer_size(id).get()));
+    }
+  }
+  planned_buffers_.resize(buffer_sizes.size());
+  for (size_t id = 0; id < buffer_sizes.size(); ++id) {
+    planned_buffers_[id].resize(buffer_sizes[id]);
+    planned_spans_.push_back({planned_buffers_[id].data(), buffer_sizes[id]});
+  }
+  method_allocator_pool_.resize(kMethodAllocatorPoolSize);
+  method_allocator_ = std::make_unique<MemoryAllocator>(
+      method_allocator_pool_.size(), method_allocator_pool_.data());
+  planned_memory_ = std::make_unique<HierarchicalAllocator>(
+      Span<Span<uint8_t>>(planned_spans_.data(), planned_spans_.size()));
+  memory_manager_ = std::make_unique<MemoryManager>(
+      method_allocator_.get(), planned_memory_.get());
+
+  // Loading initializes the KV cache, so every method that shares it loads
+  // here, before any of them executes.
+  std::unique_ptr<Method> max_seq_len_method;
+  std::vector<MemoryManager*> managers(names.size(), memory_manager_.get());
+  LoadedMethods loaded;
+  size_t num_loaded = 0;
+  if (split) {
+    loaded.methods[num_loaded++] = &prefill_;
+  }
+  loaded.methods[num_loaded++] = &decode_;
+  const bool has_max_seq_len = has_method(*program_, "get_max_seq_len");
+  if (has_max_seq_len) {
+    names.push_back("get_max_seq_len");
+    managers.push_back(memory_manager_.get());
+    loaded.methods[num_loaded++] = &max_seq_len_method;
+  }
+  Error err = program_->load_methods(
+      {names.data(), names.size()},
+      {managers.data(), managers.size()},
+      on_method_loaded,
+      &loaded);
+  if (err != Error::Ok || loaded.error != Error::Ok) {
+    ET_LOG(Error, "Failed to load the methods of %s", path_.c_str());
+    prefill_.reset();
+    decode_.reset();
+    return err != Error::Ok ? err : loaded.error;
+  }
+
+  if (has_max_seq_len) {
+    err = max_seq_len_method->execute();
+    RETURN_IF_ERROR(err);
+    max_seq_len_ =
+        static_cast<int32_t>(max_seq_len_method->get_output(0).toInt());
+  } else {
+    // Fall back on the capacity of the prefill input, if any.
+    max_seq_len_ = 0;
+    if (prefill_ != nullptr) {
+      Result<TensorInfo> tokens_info =
+          program_->method_meta("prefill")->input_tensor_meta(0);
+      RETURN_IF_ERROR(tokens_info.error());
+      max_seq_len_ = tokens_info->sizes()[1];
+    }
+  }
+  return Error::Ok;
+}
+
+Error Runner::Model::run(
+    const int32_t* tokens,
+    int32_t num_tokens,
+    int32_t start_pos,
+    int32_t vocab_size,
+    float** logits) {
+  ET_CHECK_OR_RETURN_ERROR(
+      num_tokens == 1 || prefill_ != nullptr,
+      NotSupported,
+      "%s can only run one token at a time",
+      path_.c_str());
+  Method& method = num_tokens == 1 ? *decode_ : *prefill_;
+  token_data_.resize(num_tokens);
+  pos_data_.resize(num_tokens);
+  for (int32_t i = 0; i < num_tokens; ++i) {
+    token_data_[i] = tokens[i];
+    pos_data_[i] = start_pos + i;
+  }
+  exec_aten::SizesType token_sizes[2] = {1, num_tokens};
+  exec_aten::SizesType pos_sizes[1] = {num_tokens};
+  TensorImpl token_impl(ScalarType::Long, 2, token_sizes, token_data_.data());
+  TensorImpl pos_impl(ScalarType::Long, 1, pos_sizes, pos_data_.data());
+  RETURN_IF_ERROR(method.set_input(Tensor(&token_impl), 0));
+  RETURN_IF_ERROR(method.set_input(Tensor(&pos_impl), 1));
+  RETURN_IF_ERROR(method.execute());
+
+  // The logits are [1, num_tokens, vocab_size].
+  const Tensor& out = method.get_output(0).toTensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      out.scalar_type() == ScalarType::Float &&
+          out.size(out.dim() - 1) == vocab_size &&
+          out.numel() == static_cast<int64_t>(num_tokens) * vocab_size,
+      InvalidProgram,
+      "Expected float logits over %" PRId32 " tokens from %s",
+      vocab_size,
+      path_.c_str());
+  *logits = out.mutable_data_ptr<float>();
+  return Error::Ok;
+}
+
+Error Runner::Model::run_last(
+    const int32_t* tokens,
+    int32_t num_tokens,
+    int32_t start_pos,
+    int32_t vocab_size,
+    float** logits) {
+  if (prefill_ != nullptr || num_tokens == 1) {
+    RETURN_IF_ERROR(run(tokens, num_tokens, start_pos, vocab_size, logits));
+    *logits += static_cast<size_t>(num_tokens - 1) * vocab_size;
+    return Error::Ok;
+  }
+  for (int32_t i = 0; i < num_tokens; ++i) {
+    RETURN_IF_ERROR(run(&tokens[i], 1, start_pos + i, vocab_size, logits));
+  }
+  return Error::Ok;
+}
+
+Error Runner::generate(
+    const std::string& prompt,
+    int32_t seq_len,
+    const std::function<void(const std::string&)>& on_token,
+    Stats* stats) {
+  RETURN_IF_ERROR(load());
+  const auto start = std::chrono::steady_clock::now();
+  for (const Model* model : {&model_, draft_.get()}) {
+    if (model != nullptr && model->max_seq_len() > 0) {
+      seq_len = std::min(seq_len, model->max_seq_len());
+    }
+  }
+
+  std::vector<int32_t> tokens;
+  RETURN_IF_ERROR(
+      tokenizer_->encode(prompt, /*bos=*/true, /*eos=*/false, &tokens));
+  const int32_t num_prompt_tokens = static_cast<int32_t>(tokens.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      num_prompt_tokens < seq_len,
+      InvalidArgument,
+      "The prompt has %" PRId32
+      " tokens, which leaves no room to generate within seq_len %" PRId32,
+      num_prompt_tokens,
+      seq_len);
+
+  // Runs the whole prompt at once if the program can, otherwise one token at
+  // a time.
+  float* logits = nullptr;
+  RETURN_IF_ERROR(model_.run_last(
+      tokens.data(), num_prompt_tokens, 0, vocab_size_, &logits));
+  const double prompt_eval_ms = ms_since(start);
+
+  const int32_t first = sampler_->sample(logits);
+  const double time_to_first_token_ms = ms_since(start);
+  const auto decode_start = std::chrono::steady_clock::now();
+  if (stats != nullptr) {
+    stats->num_draft_tokens = 0;
+    stats->num_accepted_draft_tokens = 0;
+  }
+  // Appends a generated token and reports it, unless it ends the generation.
+  // Returns whether to go on.
+  const std::function<bool(int32_t)> emit = [&](int32_t token) {
+    if (token == tokenizer_->eos_id()) {
+      return false;
+    }
+    on_token(tokenizer_->decode(tokens.back(), token));
+    tokens.push_back(token);
+    return static_cast<int32_t>(tokens.size()) < seq_len;
+  };
+  if (emit(first)) {
+    if (draft_ != nullptr) {
+      RETURN_IF_ERROR(generate_speculative(tokens, seq_len, emit, stats));
+    } else {
+      // The last token goes at position tokens.size() - 1, and running it
+      // yields the logits of the token after it.
+      do {
+        RETURN_IF_ERROR(model_.run(
+            &tokens.back(),
+            1,
+            static_cast<int32_t>(tokens.size()) - 1,
+            vocab_size_,
+            &logits));
+      } while (emit(sampler_->sample(logits)));
+    }
+  }
+
+  if (stats != nullptr) {
+    stats->num_prompt_tokens = num_prompt_tokens;
+    stats->num_generated_tokens = tokens.size() - num_prompt_tokens;
+    stats->prompt_eval_ms = prompt_eval_ms;
+    stats->time_to_first_token_ms = time_to_first_token_ms;
+    stats->decode_ms = ms_since(decode_start);
+  }
+  return Error::Ok;
+}
+
+Error Runner::generate_speculative(
+    std::vector<int32_t>& tokens,
+    int32_t seq_len,
+    const std::function<bool(int32_t)>& emit,
+    Stats* stats) {
+  // tokens[0, draft_len) are in the draft's KV cache, and all but the last
+  // token are in the target's.
+  int32_t draft_len = 0;
+  // The last token, followed by the draft tokens.
+  std::vector<int32_t> proposal;
+  for (;;) {
+    const int32_t len = static_cast<int32_t>(tokens.size());
+    // Each round emits up to one token more than it drafts.
+    const int32_t num_draft = std::min(num_draft_tokens_, seq_len - len - 1);
+    proposal.assign(1, tokens.back());
+    if (num_draft > 0) {
+      // Catch the draft up on the tokens that it has not seen, then let it
+      // continue greedily.
+      float* draft_logits = nullptr;
+      RETURN_IF_ERROR(draft_->run_last(
+          &tokens[draft_len],
+          len - draft_len,
+          draft_len,
+          vocab_size_,
+          &draft_logits));
+      proposal.push_back(argmax(draft_logits, vocab_size_));
+      for (int32_t i = 1; i < num_draft; ++i) {
+        RETURN_IF_ERROR(draft_->run(
+            &proposal.back(), 1, len + i - 1, vocab_size_, &draft_logits));
+        proposal.push_back(argmax(draft_logits, vocab_size_));
+      }
+    }
+
+    // One target execution yields the logits after each proposed token.
+    float* logits = nullptr;
+    RETURN_IF_ERROR(model_.run(
+        proposal.data(),
+        static_cast<int32_t>(proposal.size()),
+        len - 1,
+        vocab_size_,
+        &logits));
+    // A draft token is accepted if the target samples it too. The first token
+    // that the target samples differently replaces the rest of the draft, and
+    // if the whole draft is accepted, the target adds one more.
+    int32_t num_accepted = 0;
+    bool go_on = true;
+    for (int32_t i = 0; go_on; ++i) {
+      const int32_t token = sampler_->sample(logits + i * vocab_size_);
+      go_on = emit(token);
+      if (i == num_draft || token != proposal[i + 1]) {
+        break;
+      }
+      ++num_accepted;
+    }
+    if (stats != nullptr) {
+      stats->num_draft_tokens += num_draft;
+      stats->num_accepted_draft_tokens += num_accepted;
+    }
+    if (!go_on) {
+      return Error::Ok;
+    }
+    // The draft saw all but the last of its tokens. Both caches roll back by
+    // running the next round from the first rejected position; the entries
+    // after it are masked until they are overwritten.
+    if (num_draft > 0) {
+      draft_len = len + std::min(num_accepted, num_draft - 1);
+    }
+  }
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <executorch/examples/models/llama2/runner/sampler.h>
+#include <executorch/examples/models/llama2/runner/tokenizer.h>
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Generates text with a Llama 2 program exported with the KV cache by
+ * export_llama.py.
+ *
+ * The prompt runs through the `prefill` method at once and each new token
+ * through `decode`; the two share the weights, the KV cache and the planned
+ * memory. Programs with only a `forward` method run the prompt one token at a
+ * time through it. The logits are sampled straight from the output tensor.
+ *
+ * With a draft model, decoding is speculative: the draft, a smaller program
+ * over the same vocabulary, greedily proposes a few tokens, and the target
+ * model runs all of them at once through `prefill` and keeps the longest
+ * prefix that it would have sampled itself. Every token is still sampled from
+ * the target's logits, so the output is the same as without a draft; only
+ * the number of target executions drops.
+ */
+class Runner {
+ public:
+  /// Timings of one generate() call.
+  struct Stats {
+    int64_t num_prompt_tokens = 0;
+    int64_t num_generated_tokens = 0;
+    /// From the start of generate() until the first generated token is known.
+    double time_to_first_token_ms = 0;
+    /// Running the prompt through the model.
+    double prompt_eval_ms = 0;
+    /// Generating the tokens after the first one.
+    double decode_ms = 0;
+    /// Tokens proposed by the draft model, and how many of them the target
+    /// model accepted.
+    int64_t num_draft_tokens = 0;
+    int64_t num_accepted_draft_tokens = 0;
+  };
+
+  Runner(
+      const std::string& model_path,
+      const std::string& tokenizer_path,
+      float temperature,
+      int32_t topk,
+      float topp,
+      uint64_t seed,
+      const std::string& draft_model_path = "",
+      int32_t num_draft_tokens = 4);
+
+  /**
+   * Loads the programs, their methods and the tokenizer. Called by generate() if
+   * needed, but can be called earlier to keep loading out of the timings.
+   */
+  __ET_NODISCARD Error load();
+
+  bool is_loaded() const {
+    return tokenizer_ != nullptr;
+  }
+
+  /**
+   * Generates up to `seq_len` tokens in total, including the prompt, or until
+   * the model emits EOS. Calls `on_token` with the text of each generated
+   * token as soon as it is sampled.
+   */
+  __ET_NODISCARD Error generate(
+      const std::string& prompt,
+      int32_t seq_len,
+      const std::function<void(const std::string&)>& on_token,
+      Stats* stats = nullptr);
+
+ private:
+  /**
+   * One program and the memory that its methods share, including the KV
+   * cache. The cache is indexed by position and each position only attends to
+   * the ones before it, so rolling the cache back is just running the next
+   * tokens from an earlier position: the stale entries after it are masked
+   * until they are overwritten.
+   */
+  class Model {
+   public:
+    explicit Model(const std::string& path) : path_(path) {}
+
+    __ET_NODISCARD Error load();
+
+    /**
+     * Runs `num_tokens` tokens from `start_pos`, and points `logits` at the
+     * [num_tokens, vocab_size] logits of all of them. More than one token
+     * requires a `prefill` method.
+     */
+    __ET_NODISCARD Error run(
+        const int32_t* tokens,
+        int32_t num_tokens,
+        int32_t start_pos,
+        int32_t vocab_size,
+        float** logits);
+
+    /**
+     * Like run(), but points `logits` at the logits of the last token only,
+     * and falls back on one token at a time without a `prefill` method.
+     */
+    __ET_NODISCARD Error run_last(
+        const int32_t* tokens,
+        int32_t num_tokens,
+        int32_t start_pos,
+        int32_t vocab_size,
+        float** logits);
+
+    bool has_prefill() const {
+      return prefill_ != nullptr;
+    }
+
+    /// 0 if the program does not say.
+    int32_t max_seq_len() const {
+      return max_seq_len_;
+    }
+
+   private:
+    std::string path_;
+    std::unique_ptr<util::FileDataLoader> loader_;
+    std::unique_ptr<Program> program_;
+    std::vector<uint8_t> method_allocator_pool_;
+    std::vector<std::vector<uint8_t>> planned_buffers_;
+    std::vector<Span<uint8_t>> planned_spans_;
+    std::unique_ptr<MemoryAllocator> method_allocator_;
+    std::unique_ptr<HierarchicalAllocator> planned_memory_;
+    std::unique_ptr<MemoryManager> memory_manager_;
+    // Null when the program has no prefill method.
+    std::unique_ptr<Method> prefill_;
+    std::unique_ptr<Method> decode_;
+    int32_t max_seq_len_ = 0;
+
+    // Backs the token and position inputs.
+    std::vector<int64_t> token_data_;
+    std::vector<int64_t> pos_data_;
+  };
+
+  /**
+   * Generates with the draft model until `emit` returns false, starting with
+   * the last of `tokens` not yet run through either model. `emit` appends a
+   * token to `tokens` and reports it.
+   */
+  __ET_NODISCARD Error generate_speculative(
+      std::vector<int32_t>& tokens,
+      int32_t seq_len,
+      const std::function<bool(int32_t)>& emit,
+      Stats* stats);
+
+  std::string tokenizer_path_;
+  float temperature_;
+  int32_t topk_;
+  float topp_;
+  uint64_t seed_;
+  int32_t num_draft_tokens_;
+
+  Model model_;
+  // Null without a draft model.
+  std::unique_ptr<Model> draft_;
+  std::unique_ptr<Tokenizer> tokenizer_;
+  std::unique_ptr<Sampler> sampler_;
+  int32_t vocab_size_ = 0;
+};
+
+} // namespace executor
+} // namespace torch
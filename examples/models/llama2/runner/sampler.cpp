@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/examples/models/llama2/runner/sampler.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+// Softmax in place.
+void softmax(float* x, int32_t size) {
+  const float max_val = *std::max_element(x, x + size);
+  float sum = 0.0f;
+  for (int32_t i = 0; i < size; ++i) {
+    x[i] = std::exp(x[i] - max_val);
+    sum += x[i];
+  }
+  const float inv_sum = 1.0f / sum;
+  for (int32_t i = 0; i < size; ++i) {
+    x[i] *= inv_sum;
+  }
+}
+
+} // namespace
+
+Sampler::Sampler(
+    int32_t vocab_size,
+    float temperature,
+    int32_t topk,
+    float topp,
+    uint64_t seed)
+    : vocab_size_(vocab_size),
+      inv_temperature_(temperature > 0 ? 1.0f / temperature : 0.0f),
+      topk_(topk),
+      topp_(topp),
+      // xorshift state must not be zero
+      rng_state_(seed != 0 ? seed : 0x9E3779B97F4A7C15ULL),
+      candidates_(vocab_size) {}
+
+float Sampler::random_f32() {
+  // xorshift64*
+  rng_state_ ^= rng_state_ >> 12;
+  rng_state_ ^= rng_state_ << 25;
+  rng_state_ ^= rng_state_ >> 27;
+  const uint64_t r = rng_state_ * 0x2545F4914F6CDD1DULL;
+  // The top 24 bits, which a float holds exactly, in [0, 1).
+  return static_cast<float>(r >> 40) / 16777216.0f;
+}
+
+int32_t Sampler::sample_argmax(const float* probs) const {
+  return static_cast<int32_t>(
+      std::max_element(probs, probs + vocab_size_) - probs);
+}
+
+int32_t Sampler::sample_mult(const float* probs, float coin) const {
+  float cdf = 0.0f;
+  for (int32_t i = 0; i < vocab_size_; ++i) {
+    cdf += probs[i];
+    if (coin < cdf) {
+      return i;
+    }
+  }
+  return vocab_size_ - 1; // In case of rounding errors
+}
+
+int32_t Sampler::sample_candidates(size_t num_candidates, float coin) {
+  float total = 0.0f;
+  for (size_t i = 0; i < num_candidates; ++i) {
+    total += candidates_[i].prob;
+  }
+  const float r = coin * total;
+  float cdf = 0.0f;
+  for (size_t i = 0; i < num_candidates; ++i) {
+    cdf += candidates_[i].prob;
+    if (r < cdf) {
+      return candidates_[i].index;
+    }
+  }
+  return candidates_[num_candidates - 1].index; // In case of rounding errors
+}
+
+int32_t Sampler::sample(float* logits) {
+  if (inv_temperature_ == 0.0f) {
+    return sample_argmax(logits);
+  }
+  for (int32_t i = 0; i < vocab_size_; ++i) {
+    logits[i] *= inv_temperature_;
+  }
+  softmax(logits, vocab_size_);
+  const float coin = random_f32();
+
+  const bool use_topk = topk_ > 0 && topk_ < vocab_size_;
+  const bool use_topp = topp_ > 0.0f && topp_ < 1.0f;
+  if (!use_topk && !use_topp) {
+    return sample_mult(logits, coin);
+  }
+
+  // Only the candidates need sorting. With top-p alone, tokens less likely
+  // than (1 - topp) / (vocab_size - 1) cannot be in the nucleus, which
+  // usually drops most of the vocabulary.
+  const float cutoff = use_topk ? 0.0f : (1.0f - topp_) / (vocab_size_ - 1);
+  size_t n = 0;
+  for (int32_t i = 0; i < vocab_size_; ++i) {
+    if (logits[i] >= cutoff) {
+      candidates_[n++] = {logits[i], i};
+    }
+  }
+  if (n == 0) {
+    return sample_argmax(logits);
+  }
+  const auto by_prob = [](const ProbIndex& a, const ProbIndex& b) {
+    return a.prob > b.prob;
+  };
+  if (use_topk && static_cast<size_t>(topk_) < n) {
+    std::partial_sort(
+        candidates_.begin(),
+        candidates_.begin() + topk_,
+        candidates_.begin() + n,
+        by_prob);
+    n = topk_;
+  } else {
+    std::sort(candidates_.begin(), candidates_.begin() + n, by_prob);
+  }
+
+  if (use_topp) {
+    // Keep the smallest prefix whose probabilities exceed topp.
+    float cumulative = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+      cumulative += candidates_[i].prob;
+      if (cumulative > topp_) {
+        n = i + 1;
+        break;
+      }
+    }
+  }
+  return sample_candidates(n, coin);
+}
+
+} // namespace executor
+} // namespace torch
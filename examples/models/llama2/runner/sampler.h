@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Picks the next token from the logits of one position, with temperature,
+ * top-k and top-p (nucleus) sampling. Works on the logits in place, so the
+ * caller can pass a pointer straight into the method's output tensor.
+ */
+class Sampler {
+ public:
+  /**
+   * @param[in] vocab_size The number of logits per position.
+   * @param[in] temperature Divides the logits before the softmax. 0 always
+   *     picks the most likely token.
+   * @param[in] topk If positive, only the `topk` most likely tokens are
+   *     candidates.
+   * @param[in] topp If in (0, 1), only the most likely tokens whose
+   *     probabilities add up to `topp` are candidates.
+   * @param[in] seed Seeds the random number generator, so that runs are
+   *     reproducible.
+   */
+  Sampler(
+      int32_t vocab_size,
+      float temperature,
+      int32_t topk,
+      float topp,
+      uint64_t seed);
+
+  /**
+   * Samples a token id from `logits`, which has `vocab_size` elements and may
+   * be modified.
+   */
+  int32_t sample(float* logits);
+
+ private:
+  struct ProbIndex {
+    float prob;
+    int32_t index;
+  };
+
+  int32_t sample_argmax(const float* probs) const;
+  int32_t sample_mult(const float* probs, float coin) const;
+  int32_t sample_candidates(size_t num_candidates, float coin);
+  float random_f32();
+
+  const int32_t vocab_size_;
+  const float inv_temperature_;
+  const int32_t topk_;
+  const float topp_;
+  uint64_t rng_state_;
+  // Scratch space for the sorted candidates, allocated once.
+  std::vector<ProbIndex> candidates_;
+};
+
+} // namespace executor
+} // namespace torch
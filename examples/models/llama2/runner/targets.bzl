@@ -0,0 +1,46 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "get_oss_build_kwargs", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_library(
+        name = "runner_lib",
+        srcs = [
+            "runner.cpp",
+            "sampler.cpp",
+            "tokenizer.cpp",
+        ],
+        exported_headers = [
+            "runner.h",
+            "sampler.h",
+            "tokenizer.h",
+        ],
+        exported_deps = [
+            "//executorch/extension/data_loader:file_data_loader",
+            "//executorch/runtime/executor:program",
+        ],
+        visibility = [
+            "//executorch/examples/...",
+        ],
+    )
+
+    # Generates text with a Llama 2 program exported with the KV cache. Links
+    # the portable kernels; define a new binary based on :runner_lib to use
+    # other kernels or backends.
+    runtime.cxx_binary(
+        name = "llama_runner",
+        srcs = ["main.cpp"],
+        deps = [
+            ":runner_lib",
+            "//executorch/kernels/portable:generated_lib_all_ops",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        **get_oss_build_kwargs()
+    )
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/examples/models/llama2/runner/tokenizer.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+struct FileCloser {
+  void operator()(FILE* file) const {
+    fclose(file);
+  }
+};
+
+template <typename T>
+bool read_value(FILE* file, T* value) {
+  return fread(value, sizeof(T), 1, file) == 1;
+}
+
+/// Returns the length of the UTF-8 sequence that starts with `c`, or 1 for a
+/// byte that cannot start one.
+size_t utf8_length(unsigned char c) {
+  if ((c & 0xE0) == 0xC0) {
+    return 2;
+  }
+  if ((c & 0xF0) == 0xE0) {
+    return 3;
+  }
+  if ((c & 0xF8) == 0xF0) {
+    return 4;
+  }
+  return 1;
+}
+
+} // namespace
+
+Result<Tokenizer> Tokenizer::load(const char* path) {
+  std::unique_ptr<FILE, FileCloser> file(fopen(path, "rb"));
+  if (file == nullptr) {
+    ET_LOG(Error, "Could not open tokenizer file %s", path);
+    return Error::AccessFailed;
+  }
+  int32_t header[4];
+  if (fread(header, sizeof(int32_t), 4, file.get()) != 4) {
+    ET_LOG(Error, "Could not read the header of tokenizer file %s", path);
+    return Error::InvalidProgram;
+  }
+  const int32_t vocab_size = header[0];
+  if (vocab_size <= 0 || header[1] < 0 || header[1] >= vocab_size ||
+      header[2] < 0 || header[2] >= vocab_size) {
+    ET_LOG(
+        Error,
+        "Invalid tokenizer header: vocab_size %" PRId32 ", bos %" PRId32
+        ", eos %" PRId32,
+        vocab_size,
+        header[1],
+        header[2]);
+    return Error::InvalidProgram;
+  }
+
+  Tokenizer tokenizer;
+  tokenizer.bos_id_ = header[1];
+  tokenizer.eos_id_ = header[2];
+  tokenizer.max_token_length_ = header[3];
+  tokenizer.vocab_.resize(vocab_size);
+  tokenizer.scores_.resize(vocab_size);
+  tokenizer.token_ids_.reserve(vocab_size);
+  for (int32_t i = 0; i < vocab_size; ++i) {
+    int32_t length = 0;
+    if (!read_value(file.get(), &tokenizer.scores_[i]) ||
+        !read_value(file.get(), &length) || length < 0 ||
+        length > tokenizer.max_token_length_) {
+      ET_LOG(Error, "Invalid entry for token %" PRId32 " in %s", i, path);
+      return Error::InvalidProgram;
+    }
+    std::string& piece = tokenizer.vocab_[i];
+    piece.resize(length);
+    if (length > 0 &&
+        fread(&piece[0], 1, length, file.get()) !=
+            static_cast<size_t>(length)) {
+      ET_LOG(Error, "Truncated entry for token %" PRId32 " in %s", i, path);
+      return Error::InvalidProgram;
+    }
+    // The first of duplicate pieces wins, as in sentencepiece.
+    tokenizer.token_ids_.emplace(piece, i);
+  }
+  return tokenizer;
+}
+
+int32_t Tokenizer::lookup(const std::string& piece) const {
+  auto it = token_ids_.find(piece);
+  return it == token_ids_.end() ? -1 : it->second;
+}
+
+Error Tokenizer::encode(
+    const std::string& text,
+    bool bos,
+    bool eos,
+    std::vector<int32_t>* tokens) const {
+  tokens->clear();
+  if (bos) {
+    tokens->push_back(bos_id_);
+  }
+
+  // sentencepiece adds a dummy prefix, and export_tokenizer.py maps its word
+  // boundary marker back to a space.
+  const std::string prefixed = text.empty() ? text : " " + text;
+  const size_t first = tokens->size();
+
+  // Start from one token per UTF-8 character, falling back to one token per
+  // byte for characters that are not in the vocabulary.
+  for (size_t i = 0; i < prefixed.size();) {
+    const size_t length =
+        std::min(utf8_length(prefixed[i]), prefixed.size() - i);
+    const int32_t id = lookup(prefixed.substr(i, length));
+    if (id >= 0) {
+      tokens->push_back(id);
+    } else {
+      for (size_t j = i; j < i + length; ++j) {
+        char byte_piece[8];
+        snprintf(
+            byte_piece,
+            sizeof(byte_piece),
+            "<0x%02X>",
+            static_cast<unsigned char>(prefixed[j]));
+        const int32_t byte_id = lookup(byte_piece);
+        if (byte_id < 0) {
+          ET_LOG(Error, "The vocabulary has no token for byte %s", byte_piece);
+          return Error::InvalidArgument;
+        }
+        tokens->push_back(byte_id);
+      }
+    }
+    i += length;
+  }
+
+  // Merge the adjacent pair whose merged piece scores best, until no pair
+  // merges into a piece of the vocabulary.
+  std::string merged;
+  merged.reserve(2 * max_token_length_);
+  while (true) {
+    float best_score = -1e10f;
+    int32_t best_id = -1;
+    size_t best_idx = 0;
+    for (size_t i = first; i + 1 < tokens->size(); ++i) {
+      merged = vocab_[(*tokens)[i]];
+      merged += vocab_[(*tokens)[i + 1]];
+      const int32_t id = lookup(merged);
+      if (id >= 0 && scores_[id] > best_score) {
+        best_score = scores_[id];
+        best_id = id;
+        best_idx = i;
+      }
+    }
+    if (best_id < 0) {
+      break;
+    }
+    (*tokens)[best_idx] = best_id;
+    tokens->erase(tokens->begin() + best_idx + 1);
+  }
+
+  if (eos) {
+    tokens->push_back(eos_id_);
+  }
+  return Error::Ok;
+}
+
+std::string Tokenizer::decode(int32_t prev_token, int32_t token) const {
+  if (token < 0 || token >= vocab_size()) {
+    return "";
+  }
+  const std::string& piece = vocab_[token];
+  // sentencepiece strips the dummy prefix after BOS.
+  if (prev_token == bos_id_ && !piece.empty() && piece[0] == ' ') {
+    return piece.substr(1);
+  }
+  unsigned int byte = 0;
+  if (piece.size() == 6 && sscanf(piece.c_str(), "<0x%02X>", &byte) == 1) {
+    return std::string(1, static_cast<char>(byte));
+  }
+  return piece;
+}
+
+} // namespace executor
+} // namespace torch
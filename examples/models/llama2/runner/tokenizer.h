@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * A byte pair encoding tokenizer that matches sentencepiece's BPE models, as
+ * used by Llama 2. Reads the vocabulary that export_tokenizer.py writes from a
+ * sentencepiece model:
+ *
+ *   int32 vocab_size, int32 bos_id, int32 eos_id, int32 max_token_length,
+ *   then for each token: float32 score, int32 length, `length` bytes.
+ *
+ * Tokens of the form <0xXX> encode raw bytes, for text that is not in the
+ * vocabulary.
+ */
+class Tokenizer {
+ public:
+  /**
+   * Loads the vocabulary from the file at `path`.
+   */
+  static Result<Tokenizer> load(const char* path);
+
+  /**
+   * Encodes `text` into `tokens`. Prepends the BOS token if `bos` is true and
+   * appends the EOS token if `eos` is true.
+   */
+  __ET_NODISCARD Error encode(
+      const std::string& text,
+      bool bos,
+      bool eos,
+      std::vector<int32_t>* tokens) const;
+
+  /**
+   * Returns the text of `token`, which follows `prev_token` in the sequence.
+   */
+  std::string decode(int32_t prev_token, int32_t token) const;
+
+  int32_t vocab_size() const {
+    return static_cast<int32_t>(vocab_.size());
+  }
+
+  int32_t bos_id() const {
+    return bos_id_;
+  }
+
+  int32_t eos_id() const {
+    return eos_id_;
+  }
+
+ private:
+  Tokenizer() = default;
+
+  int32_t lookup(const std::string& piece) const;
+
+  std::vector<std::string> vocab_;
+  std::vector<float> scores_;
+  std::unordered_map<std::string, int32_t> token_ids_;
+  int32_t bos_id_ = 1;
+  int32_t eos_id_ = 2;
+  int32_t max_token_length_ = 0;
+};
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * This tool measures how long an ExecuTorch model file takes to execute.
+ *
+ * It loads a method, sets all input tensor data to ones, executes it for a
+ * number of warmup iterations and then for a number of timed iterations, and
+ * reports latency percentiles, throughput, peak RSS and the size of the
+ * memory-planned buffers. With --inputs_path, it instead replays the inputs
+ * bundled for the method in a bundled program, e.g. ones recorded from
+ * production traffic with util/input_recorder.h, so that the timings reflect
+ * real data. The results can also be written out as JSON so that
+ * runs on different builds or devices can be compared.
+ *
+ * Like executor_runner, it can be linked against any desired kernel or backend
+ * implementations.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/util/bundled_program_verification.h>
+#include <executorch/util/read_file.h>
+#include <executorch/util/util.h>
+
+static uint8_t method_allocator_pool[4 * 1024U * 1024U]; // 4 MB
+static uint8_t input_allocator_pool[64 * 1024U]; // 64 KB
+
+DEFINE_string(
+    model_path,
+    "model.pte",
+    "Model serialized in flatbuffer format.");
+
+DEFINE_string(
+    method_name,
+    "",
+    "Name of the method to benchmark. Defaults to the first method.");
+
+DEFINE_int32(
+    warmup_iterations,
+    5,
+    "Number of untimed executions before the timed ones.");
+
+DEFINE_int32(iterations, 50, "Number of timed executions.");
+
+DEFINE_string(
+    inputs_path,
+    "",
+    "If set, a bundled program file whose test sets for the method are used "
+    "as inputs, one set per execution in turn, instead of all-ones tensors. "
+    "Loading the inputs is not timed.");
+
+DEFINE_string(
+    cpus,
+    "",
+    "Comma-separated list of CPUs to pin to, e.g. \"4,5,6,7\". Threads that "
+    "the runtime or delegates create later inherit the pinning. Linux only.");
+
+DEFINE_string(
+    json_path,
+    "",
+    "If set, the results are also written to this path as JSON. Use \"-\" "
+    "for stdout.");
+
+using namespace torch::executor;
+using torch::executor::util::FileDataLoader;
+
+namespace {
+
+/**
+ * Pins the calling thread to the CPUs listed in `cpus`.
+ *
+ * @returns false if the list is malformed or the platform refused.
+ */
+bool pin_to_cpus(const std::string& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  size_t pos = 0;
+  while (pos < cpus.size()) {
+    size_t end = cpus.find(',', pos);
+    if (end == std::string::npos) {
+      end = cpus.size();
+    }
+    const std::string item = cpus.substr(pos, end - pos);
+    char* item_end = nullptr;
+    const long cpu = strtol(item.c_str(), &item_end, 10);
+    if (item.empty() || *item_end != '\0' || cpu < 0 || cpu >= CPU_SETSIZE) {
+      ET_LOG(Error, "Invalid CPU '%s' in --cpus", item.c_str());
+      return false;
+    }
+    CPU_SET(cpu, &set);
+    pos = end + 1;
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    ET_LOG(Error, "sched_setaffinity() failed for --cpus=%s", cpus.c_str());
+    return false;
+  }
+  return true;
+#else
+  ET_LOG(Error, "--cpus is not supported on this platform");
+  (void)cpus;
+  return false;
+#endif
+}
+
+/// Returns the peak resident set size of the process in bytes, or 0 if it is
+/// unknown.
+size_t peak_rss_bytes() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return static_cast<size_t>(usage.ru_maxrss); // Already in bytes.
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024; // In kilobytes.
+#endif
+#else
+  return 0;
+#endif
+}
+
+/// Returns the nearest-rank `percentile` of `sorted`, which must not be empty.
+double percentile(const std::vector<double>& sorted, double percentile) {
+  size_t rank = static_cast<size_t>(percentile / 100.0 * sorted.size() + 0.5);
+  rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+  return sorted[rank - 1];
+}
+
+struct BenchmarkResults {
+  std::string model_path;
+  std::string method_name;
+  int warmup_iterations;
+  int iterations;
+  /// The number of bundled input sets replayed, or 0 for all-ones inputs.
+  size_t input_sets;
+  double min_ms;
+  double mean_ms;
+  double p50_ms;
+  double p90_ms;
+  double p99_ms;
+  double max_ms;
+  double iterations_per_second;
+  size_t planned_buffer_bytes;
+  size_t peak_rss_bytes;
+};
+
+void print_results(const BenchmarkResults& r) {
+  printf("Method %s of %s\n", r.method_name.c_str(), r.model_path.c_str());
+  printf(
+      "  iterations: %d (after %d warmup)\n",
+      r.iterations,
+      r.warmup_iterations);
+  if (r.input_sets > 0) {
+    printf("  inputs: %zu bundled sets\n", r.input_sets);
+  }
+  printf(
+      "  latency ms: min %.3f  mean %.3f  p50 %.3f  p90 %.3f  p99 %.3f  "
+      "max %.3f\n",
+      r.min_ms,
+      r.mean_ms,
+      r.p50_ms,
+      r.p90_ms,
+      r.p99_ms,
+      r.max_ms);
+  printf("  throughput: %.2f iterations/s\n", r.iterations_per_second);
+  printf("  planned buffers: %zu bytes\n", r.planned_buffer_bytes);
+  printf("  peak RSS: %zu bytes\n", r.peak_rss_bytes);
+}
+
+/// Writes `s` as a JSON string literal.
+void write_json_string(FILE* file, const std::string& s) {
+  fputc('"', file);
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      fprintf(file, "\\%c", c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      fprintf(file, "\\u%04x", c);
+    } else {
+      fputc(c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+bool write_json(const BenchmarkResults& r, const std::string& path) {
+  FILE* file = path == "-" ? stdout : fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    ET_LOG(Error, "Could not open %s for writing", path.c_str());
+    return false;
+  }
+  fprintf(file, "{\n  \"model_path\": ");
+  write_json_string(file, r.model_path);
+  fprintf(file, ",\n  \"method_name\": ");
+  write_json_string(file, r.method_name);
+  fprintf(file, ",\n  \"warmup_iterations\": %d", r.warmup_iterations);
+  fprintf(file, ",\n  \"iterations\": %d", r.iterations);
+  fprintf(file, ",\n  \"input_sets\": %zu", r.input_sets);
+  fprintf(file, ",\n  \"min_ms\": %.6f", r.min_ms);
+  fprintf(file, ",\n  \"mean_ms\": %.6f", r.mean_ms);
+  fprintf(file, ",\n  \"p50_ms\": %.6f", r.p50_ms);
+  fprintf(file, ",\n  \"p90_ms\": %.6f", r.p90_ms);
+  fprintf(file, ",\n  \"p99_ms\": %.6f", r.p99_ms);
+  fprintf(file, ",\n  \"max_ms\": %.6f", r.max_ms);
+  fprintf(
+      file, ",\n  \"iterations_per_second\": %.6f", r.iterations_per_second);
+  fprintf(file, ",\n  \"planned_buffer_bytes\": %zu", r.planned_buffer_bytes);
+  fprintf(file, ",\n  \"peak_rss_bytes\": %zu\n}\n", r.peak_rss_bytes);
+  if (file != stdout) {
+    fclose(file);
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  runtime_init();
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+  if (FLAGS_iterations <= 0 || FLAGS_warmup_iterations < 0) {
+    ET_LOG(Error, "--iterations must be positive and --warmup_iterations >= 0");
+    return 1;
+  }
+
+  // Pin before anything is loaded, so that threads created by delegates
+  // inherit the affinity.
+  if (!FLAGS_cpus.empty() && !pin_to_cpus(FLAGS_cpus)) {
+    return 1;
+  }
+
+  const char* model_path = FLAGS_model_path.c_str();
+  Result<FileDataLoader> loader = FileDataLoader::from(model_path);
+  ET_CHECK_MSG(
+      loader.ok(), "FileDataLoader::from() failed: 0x%" PRIx32, loader.error());
+
+  Result<Program> program = Program::load(&loader.get());
+  if (!program.ok()) {
+    ET_LOG(Error, "Failed to parse model file %s", model_path);
+    return 1;
+  }
+
+  std::string method_name = FLAGS_method_name;
+  if (method_name.empty()) {
+    const auto method_name_result = program->get_method_name(0);
+    ET_CHECK_MSG(method_name_result.ok(), "Program has no methods");
+    method_name = *method_name_result;
+  }
+
+  Result<MethodMeta> method_meta = program->method_meta(method_name.c_str());
+  ET_CHECK_MSG(
+      method_meta.ok(),
+      "Failed to get method_meta for %s: 0x%x",
+      method_name.c_str(),
+      (unsigned int)method_meta.error());
+
+  MemoryAllocator method_allocator{
+      MemoryAllocator(sizeof(method_allocator_pool), method_allocator_pool)};
+
+  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers; // Owns the memory
+  std::vector<Span<uint8_t>> planned_spans; // Passed to the allocator
+  size_t planned_buffer_bytes = 0;
+  size_t num_memory_planned_buffers = method_meta->num_memory_planned_buffers();
+  for (size_t id = 0; id < num_memory_planned_buffers; ++id) {
+    // .get() will always succeed because id < num_memory_planned_buffers.
+    size_t buffer_size =
+        static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
+    planned_buffer_bytes += buffer_size;
+    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+    planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+  }
+  HierarchicalAllocator planned_memory(
+      {planned_spans.data(), planned_spans.size()});
+  MemoryManager memory_manager(&method_allocator, &planned_memory);
+
+  Result<Method> method =
+      program->load_method(method_name.c_str(), &memory_manager);
+  ET_CHECK_MSG(
+      method.ok(),
+      "Loading of method %s failed with status 0x%" PRIx32,
+      method_name.c_str(),
+      method.error());
+
+  auto inputs = util::PrepareInputTensors(*method);
+
+  // Replayed inputs: the whole bundled program stays loaded, and each
+  // execution loads the next of its test sets.
+  std::shared_ptr<char> bundled_inputs;
+  size_t num_input_sets = 0;
+  MemoryAllocator input_allocator(
+      sizeof(input_allocator_pool), input_allocator_pool);
+  if (!FLAGS_inputs_path.empty()) {
+    size_t bundled_inputs_size = 0;
+    Error status = util::read_file_content(
+        FLAGS_inputs_path.c_str(), &bundled_inputs, &bundled_inputs_size);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Could not read %s: 0x%" PRIx32,
+        FLAGS_inputs_path.c_str(),
+        status);
+    Result<size_t> num_sets = util::GetNumBundledTestSets(
+        bundled_inputs.get(), method_name.c_str());
+    ET_CHECK_MSG(
+        num_sets.ok() && num_sets.get() > 0,
+        "No inputs for method %s in %s",
+        method_name.c_str(),
+        FLAGS_inputs_path.c_str());
+    num_input_sets = num_sets.get();
+  }
+  auto load_inputs = [&](int iteration) {
+    if (num_input_sets == 0) {
+      return;
+    }
+    input_allocator.reset();
+    Error status = util::LoadBundledInput(
+        *method,
+        bundled_inputs.get(),
+        &input_allocator,
+        method_name.c_str(),
+        static_cast<size_t>(iteration) % num_input_sets);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Loading input set %zu failed with status 0x%" PRIx32,
+        static_cast<size_t>(iteration) % num_input_sets,
+        status);
+  };
+
+  for (int i = 0; i < FLAGS_warmup_iterations; ++i) {
+    load_inputs(i);
+    Error status = method->execute();
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Warmup execution of method %s failed with status 0x%" PRIx32,
+        method_name.c_str(),
+        status);
+  }
+
+  std::vector<double> latencies_ms;
+  latencies_ms.reserve(FLAGS_iterations);
+  double total_s = 0;
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    load_inputs(i);
+    const auto start = std::chrono::steady_clock::now();
+    Error status = method->execute();
+    const auto end = std::chrono::steady_clock::now();
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Execution of method %s failed with status 0x%" PRIx32,
+        method_name.c_str(),
+        status);
+    latencies_ms.push_back(
+        std::chrono::duration<double, std::milli>(end - start).count());
+    total_s += std::chrono::duration<double>(end - start).count();
+  }
+
+  BenchmarkResults results;
+  results.model_path = FLAGS_model_path;
+  results.method_name = method_name;
+  results.warmup_iterations = FLAGS_warmup_iterations;
+  results.iterations = FLAGS_iterations;
+  results.input_sets = num_input_sets;
+  double sum_ms = 0;
+  for (double ms : latencies_ms) {
+    sum_ms += ms;
+  }
+  results.mean_ms = sum_ms / latencies_ms.size();
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  results.min_ms = latencies_ms.front();
+  results.p50_ms = percentile(latencies_ms, 50);
+  results.p90_ms = percentile(latencies_ms, 90);
+  results.p99_ms = percentile(latencies_ms, 99);
+  results.max_ms = latencies_ms.back();
+  results.iterations_per_second = total_s > 0 ? FLAGS_iterations / total_s : 0;
+  results.planned_buffer_bytes = planned_buffer_bytes;
+  results.peak_rss_bytes = peak_rss_bytes();
+
+  // Keep stdout parseable when the JSON goes there.
+  if (FLAGS_json_path != "-") {
+    print_results(results);
+  }
+  util::FreeInputs(inputs);
+  if (!FLAGS_json_path.empty() && !write_json(results, FLAGS_json_path)) {
+    return 1;
+  }
+  return 0;
+}
@@ -27,6 +27,27 @@ def define_common_targets():
         ],
     )
 
+    # Like executor_runner_lib, but times repeated executions of a method and
+    # reports latency percentiles. Contains a main() function.
+    runtime.cxx_library(
+        name = "benchmark_runner_lib",
+        srcs = ["benchmark_runner.cpp"],
+        deps = [
+            "//executorch/runtime/executor:program",
+            "//executorch/extension/data_loader:file_data_loader",
+            "//executorch/util:bundled_program_verification",
+            "//executorch/util:read_file",
+            "//executorch/util:util",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        visibility = [
+            "//executorch/examples/...",
+        ],
+    )
+
     register_custom_op = native.read_config("executorch", "register_custom_op", "0")
     register_quantized_ops = native.read_config("executorch", "register_quantized_ops", "0")
 
@@ -52,3 +73,16 @@ def define_common_targets():
         define_static_target = True,
         **get_oss_build_kwargs()
     )
+
+    # Benchmark driver with the same kernels and backends as executor_runner.
+    runtime.cxx_binary(
+        name = "benchmark_runner",
+        srcs = [],
+        deps = [
+            ":benchmark_runner_lib",
+            "//executorch/runtime/executor/test:test_backend_compiler_lib",
+            "//executorch/kernels/portable:generated_lib_all_ops",
+        ] + custom_ops_lib,
+        define_static_target = True,
+        **get_oss_build_kwargs()
+    )
@@ -4,6 +4,8 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
+from typing import Tuple
+
 import torch
 from executorch.exir.scalar_type import ScalarType
 from torch.library import impl, Library
@@ -31,6 +33,30 @@ lib.define(
     "quantized_linear_pt2.out(Tensor src, Tensor weight, Tensor bias, float src_scale, int src_zero_point, float weight_scale, int weight_zero_point, Tensor out_multiplier, Tensor out_shift, int out_zero_point, *, Tensor(a!) out) ->  Tensor(a!)"
 )
 
+lib.define(
+    "quantized_conv(Tensor input, Tensor weight, Tensor bias, int[] stride, int[] padding, int[] dilation, int groups, int input_zero_point, int weight_zero_point, Tensor out_multiplier, Tensor out_shift, int out_zero_point) -> (Tensor Z)"
+)
+lib.define(
+    "quantized_conv.out(Tensor input, Tensor weight, Tensor bias, int[] stride, int[] padding, int[] dilation, int groups, int input_zero_point, int weight_zero_point, Tensor out_multiplier, Tensor out_shift, int out_zero_point, *, Tensor(a!) out) -> Tensor(a!)"
+)
+
+lib.define(
+    "quantized_matmul(Tensor X, int X_zero_point, Tensor Y, int Y_zero_point, Tensor out_multiplier, Tensor out_shift, int out_zero_point) -> (Tensor Z)"
+)
+lib.define(
+    "quantized_matmul.out(Tensor X, int X_zero_point, Tensor Y, int Y_zero_point, Tensor out_multiplier, Tensor out_shift, int out_zero_point, *, Tensor(a!) out) -> Tensor(a!)"
+)
+
+lib.define("quantized_relu(Tensor X, int X_zero_point) -> (Tensor Z)")
+lib.define(
+    "quantized_relu.out(Tensor X, int X_zero_point, *, Tensor(a!) out) -> Tensor(a!)"
+)
+
+lib.define("quantized_softmax(Tensor X, float X_scale, int dim) -> (Tensor Z)")
+lib.define(
+    "quantized_softmax.out(Tensor X, float X_scale, int dim, *, Tensor(a!) out) -> Tensor(a!)"
+)
+
 m = Library("xtensa", "IMPL", "Meta")
 
 
@@ -79,3 +105,63 @@ def quantized_linear_pt2_meta(
     assert len(weight_size) == 2
     out_size[-1] = weight_size[0]
     return src.new_empty(out_size, dtype=torch.uint8)
+
+
+@impl(m, "quantized_conv")
+def quantized_conv_meta(
+    input: torch.Tensor,
+    weight: torch.Tensor,
+    bias: torch.Tensor,
+    stride: Tuple[int],
+    padding: Tuple[int],
+    dilation: Tuple[int],
+    groups: int,
+    input_zero_point: int,
+    weight_zero_point: int,
+    out_multiplier: torch.Tensor,
+    out_shift: torch.Tensor,
+    out_zero_point: int,
+):
+    # input comes in shape [batches, in_c, in_h, in_w]
+    # weight comes in shape [out_c, in_c / groups, kernel_h, kernel_w]
+    # output comes in empty with shape [batches, out_c, out_h, out_w]
+    out_size = [input.size(0), weight.size(0)]
+    for i in range(2):
+        kernel = dilation[i] * (weight.size(2 + i) - 1) + 1
+        out_size.append((input.size(2 + i) + 2 * padding[i] - kernel) // stride[i] + 1)
+    return input.new_empty(out_size, dtype=torch.uint8)
+
+
+@impl(m, "quantized_matmul")
+def quantized_matmul_meta(
+    X: torch.Tensor,
+    X_zero_point: int,
+    Y: torch.Tensor,
+    Y_zero_point: int,
+    out_multiplier: torch.Tensor,
+    out_shift: torch.Tensor,
+    out_zero_point: int,
+):
+    # X comes in shape [leading_dims, M, K]
+    # Y comes in shape [leading_dims, K, N]
+    # output comes in empty with shape [leading_dims, M, N]
+    out_size = list(X.size())
+    out_size[-1] = Y.size(-1)
+    return X.new_empty(out_size, dtype=torch.uint8)
+
+
+@impl(m, "quantized_relu")
+def quantized_relu_meta(
+    X: torch.Tensor,
+    X_zero_point: int,
+):
+    return X.new_empty(X.size(), dtype=torch.uint8)
+
+
+@impl(m, "quantized_softmax")
+def quantized_softmax_meta(
+    X: torch.Tensor,
+    X_scale: float,
+    dim: int,
+):
+    return X.new_empty(X.size(), dtype=torch.uint8)
@@ -17,7 +17,12 @@ from torch import fx
 
 from torch.ao.quantization.observer import HistogramObserver, MinMaxObserver
 from torch.ao.quantization.pt2e.graph_utils import find_sequential_partitions
-from torch.ao.quantization.quantizer import Quantizer
+from torch.ao.quantization.quantizer import (
+    FixedQParamsQuantizationSpec,
+    Quantizer,
+    QuantizationSpecBase,
+    SharedQuantizationSpec,
+)
 from torch.ao.quantization.quantizer.composable_quantizer import ComposableQuantizer
 from torch.ao.quantization.quantizer.xnnpack_quantizer_utils import (
     OperatorConfig,
@@ -124,6 +129,8 @@ class PartitionAnchors:
     Quantizer uses inputs, weights and biases for quantization annotation. The others
     field contains tensor inputs that aren't quantized, and the literals fields contains
     is used for other types of input values as well as handling default parameters.
+    If set, output_qspec replaces the quantizer's output spec, for ops whose output
+    quantization is tied to their input or fixed by the kernel.
     """
 
     inputs: List[Tuple[fx.Node, int]] = field(default_factory=list)
@@ -132,6 +139,7 @@ class PartitionAnchors:
     others: List[Tuple[fx.Node, int]] = field(default_factory=list)
     literals: List[Tuple[fx.Node, int]] = field(default_factory=list)
     output: Optional[fx.Node] = None
+    output_qspec: Optional[QuantizationSpecBase] = None
 
 
 class QuantizationPattern(ABC):
@@ -180,6 +188,132 @@ class LinearPattern(QuantizationPattern):
         return torch.ops.xtensa.quantized_linear_pt2.default
 
 
+def _conv_literals(conv_node: fx.Node) -> Tuple[Any, Any, Any, int]:
+    """
+    Returns the stride, padding, dilation and groups of an aten.conv2d node,
+    filling in the defaults for the ones it leaves out.
+    """
+    defaults = ([1, 1], [0, 0], [1, 1], 1)
+    literals = list(conv_node.args[3:7])
+    literals += defaults[len(literals) :]
+    for i in range(3):
+        if isinstance(literals[i], (list, tuple)) and len(literals[i]) == 1:
+            literals[i] = [literals[i][0]] * 2
+    return tuple(literals)
+
+
+class Conv2dPattern(QuantizationPattern):
+    def partition_types(self) -> List[Type[torch.nn.Module]]:
+        return [torch.nn.Conv2d]
+
+    def get_anchors(
+        self, gm: GraphModule, fused_partition: List[GraphModule]
+    ) -> Optional[PartitionAnchors]:
+        conv_node = fused_partition[0].nodes[-1]
+
+        # The HiFi kernel handles regular and depthwise convolutions with explicit
+        # padding and no dilation.
+        _, padding, dilation, groups = _conv_literals(conv_node)
+        weight_shape = conv_node.args[1].meta["val"].shape
+        if isinstance(padding, str) or any(d != 1 for d in dilation):
+            return None
+        if groups != 1 and weight_shape[1] != 1:
+            return None
+
+        # Keep bias empty if not supplied
+        bias = []
+        if len(conv_node.args) > 2 and conv_node.args[2] is not None:
+            bias = [(conv_node, 2)]
+
+        return PartitionAnchors(
+            inputs=[(conv_node, 0)],
+            weights=[(conv_node, 1)],
+            biases=bias,
+            output=conv_node,
+        )
+
+    def replacement_op(self):
+        return torch.ops.xtensa.quantized_conv.default
+
+
+class MatmulPattern(QuantizationPattern):
+    def partition_types(self) -> List[Callable[..., Any]]:
+        return [torch.matmul]
+
+    def get_anchors(
+        self, gm: GraphModule, fused_partition: List[GraphModule]
+    ) -> Optional[PartitionAnchors]:
+        # Only fuse matmuls that were captured as a single mm or bmm, i.e. without
+        # broadcasting.
+        nodes = fused_partition[0].nodes
+        if len(nodes) != 1 or nodes[0].target not in (
+            torch.ops.aten.mm.default,
+            torch.ops.aten.bmm.default,
+        ):
+            return None
+        matmul_node = nodes[0]
+
+        return PartitionAnchors(
+            inputs=[(matmul_node, 0), (matmul_node, 1)],
+            output=matmul_node,
+        )
+
+    def replacement_op(self):
+        return torch.ops.xtensa.quantized_matmul.default
+
+
+class ReluPattern(QuantizationPattern):
+    def partition_types(self) -> List[Type[torch.nn.Module]]:
+        return [torch.nn.ReLU]
+
+    def get_anchors(
+        self, gm: GraphModule, fused_partition: List[GraphModule]
+    ) -> PartitionAnchors:
+        relu_node = fused_partition[0].nodes[-1]
+
+        # The output shares the input's quantization, so the kernel is a clamp.
+        return PartitionAnchors(
+            inputs=[(relu_node, 0)],
+            output=relu_node,
+            output_qspec=SharedQuantizationSpec((relu_node.args[0], relu_node)),
+        )
+
+    def replacement_op(self):
+        return torch.ops.xtensa.quantized_relu.default
+
+
+class SoftmaxPattern(QuantizationPattern):
+    def partition_types(self) -> List[Type[torch.nn.Module]]:
+        return [torch.nn.Softmax]
+
+    def get_anchors(
+        self, gm: GraphModule, fused_partition: List[GraphModule]
+    ) -> Optional[PartitionAnchors]:
+        softmax_node = fused_partition[0].nodes[-1]
+
+        # The HiFi kernel normalizes the last dimension.
+        dim = softmax_node.args[1]
+        if dim != -1 and dim != len(softmax_node.args[0].meta["val"].shape) - 1:
+            return None
+
+        # Like TFLite, the kernel produces outputs with a fixed scale of 1 / 256.
+        return PartitionAnchors(
+            inputs=[(softmax_node, 0)],
+            output=softmax_node,
+            output_qspec=FixedQParamsQuantizationSpec(
+                dtype=torch.uint8,
+                scale=1.0 / 256.0,
+                zero_point=0,
+                quant_min=0,
+                quant_max=255,
+                qscheme=torch.per_tensor_affine,
+            ),
+        )
+
+    def replacement_op(self):
+        return torch.ops.xtensa.quantized_softmax.default
+
+
 class GenericQuantizer(Quantizer):
     def __init__(self, pattern, quantization_config):
         super().__init__()
@@ -211,7 +345,7 @@ class GenericQuantizer(Quantizer):
                 continue
 
             anchors.output.meta["quantization_annotation"] = QuantizationAnnotation(
-                output_qspec=output_act_qspec,
+                output_qspec=anchors.output_qspec or output_act_qspec,
                 _annotated=True,
             )
 
@@ -266,6 +400,10 @@ class XtensaQuantizer(ComposableQuantizer):
         super().__init__(
             [
                 GenericQuantizer(LinearPattern(), static_qconfig),
+                GenericQuantizer(Conv2dPattern(), static_qconfig),
+                GenericQuantizer(MatmulPattern(), static_qconfig),
+                GenericQuantizer(ReluPattern(), static_qconfig),
+                GenericQuantizer(SoftmaxPattern(), static_qconfig),
             ]
         )
 
@@ -319,9 +457,9 @@ class QuantFusion(ExportPass):
                         inputs_inputs + weights_inputs + other_inputs + bias_inputs
                     )
                     kwargs = {}
-                    if (
-                        pattern.replacement_op()
-                        == torch.ops.xtensa.quantized_linear_pt2.default
+                    if pattern.replacement_op() in (
+                        torch.ops.xtensa.quantized_linear_pt2.default,
+                        torch.ops.xtensa.quantized_conv.default,
                     ):
                         weight_scale = (
                             weights_inputs[0].args[1]
@@ -369,21 +507,80 @@ class QuantFusion(ExportPass):
                         out_shift_ = graph_module.graph.call_function(
                             torch.ops.aten.full.default, ([1], out_shift[0].item())
                         )
-                        args = tuple(
-                            inputs_inputs
-                            + weights_inputs
-                            + other_inputs
-                            + [bias_int32_quant]
+                        if (
+                            pattern.replacement_op()
+                            == torch.ops.xtensa.quantized_conv.default
+                        ):
+                            args = tuple(
+                                inputs_inputs
+                                + weights_inputs
+                                + [bias_int32_quant]
+                                + list(_conv_literals(anchors.output))
+                            )
+                            kwargs = {
+                                "input_zero_point": dequants_inputs[0].args[2],
+                                "weight_zero_point": dequants_weights[0].args[2],
+                                "out_multiplier": out_multiplier_,
+                                "out_shift": out_shift_,
+                                "out_zero_point": quant_node.args[2],
+                            }
+                        else:
+                            args = tuple(
+                                inputs_inputs
+                                + weights_inputs
+                                + other_inputs
+                                + [bias_int32_quant]
+                            )
+                            kwargs = {
+                                "src_scale": dequants_inputs[0].args[1],
+                                "src_zero_point": dequants_inputs[0].args[2],
+                                "weight_scale": dequants_weights[0].args[1],
+                                "weight_zero_point": dequants_weights[0].args[2],
+                                "out_multiplier": out_multiplier_,
+                                "out_shift": out_shift_,
+                                "out_zero_point": quant_node.args[2],
+                            }
+                    elif (
+                        pattern.replacement_op()
+                        == torch.ops.xtensa.quantized_matmul.default
+                    ):
+                        requantize_scale = (
+                            dequants_inputs[0].args[1]
+                            * dequants_inputs[1].args[1]
+                            / quant_node.args[1]
+                        )
+                        (out_multiplier, out_shift) = quantize_tensor_multiplier(
+                            torch.tensor([requantize_scale])
+                        )
+                        out_multiplier_ = graph_module.graph.call_function(
+                            torch.ops.aten.full.default, ([1], out_multiplier[0].item())
+                        )
+                        out_shift_ = graph_module.graph.call_function(
+                            torch.ops.aten.full.default, ([1], out_shift[0].item())
+                        )
+                        args = (
+                            inputs_inputs[0],
+                            dequants_inputs[0].args[2],
+                            inputs_inputs[1],
+                            dequants_inputs[1].args[2],
+                            out_multiplier_,
+                            out_shift_,
+                            quant_node.args[2],
+                        )
+                    elif (
+                        pattern.replacement_op()
+                        == torch.ops.xtensa.quantized_relu.default
+                    ):
+                        args = (inputs_inputs[0], dequants_inputs[0].args[2])
+                    elif (
+                        pattern.replacement_op()
+                        == torch.ops.xtensa.quantized_softmax.default
+                    ):
+                        args = (
+                            inputs_inputs[0],
+                            dequants_inputs[0].args[1],
+                            anchors.output.args[1],
                         )
-                        kwargs = {
-                            "src_scale": dequants_inputs[0].args[1],
-                            "src_zero_point": dequants_inputs[0].args[2],
-                            "weight_scale": dequants_weights[0].args[1],
-                            "weight_zero_point": dequants_weights[0].args[2],
-                            "out_multiplier": out_multiplier_,
-                            "out_shift": out_shift_,
-                            "out_zero_point": quant_node.args[2],
-                        }
                     fused = graph_module.graph.call_function(
                         pattern.replacement_op(),
                         args,
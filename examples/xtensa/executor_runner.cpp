@@ -35,6 +35,8 @@
 #include <executorch/util/util.h>
 
 static uint8_t method_allocator_pool[18 * 1024U]; // 4 MB
+// Scratch memory for the NNLib-backed conv, matmul and softmax kernels.
+static uint8_t temp_allocator_pool[32 * 1024U];
 
 using namespace torch::executor;
 #include <xtensa/config/core.h>
@@ -163,8 +165,12 @@ int main(int argc, char** argv) {
   torch::executor::HierarchicalAllocator planned_memory(
       {planned_spans.data(), planned_spans.size()});
 
+  torch::executor::MemoryAllocator temp_allocator{
+      torch::executor::MemoryAllocator(
+          sizeof(temp_allocator_pool), temp_allocator_pool)};
+
   torch::executor::MemoryManager memory_manager(
-      &method_allocator, &planned_memory);
+      &method_allocator, &planned_memory, &temp_allocator);
 
   Result<torch::executor::Method> method =
       program->load_method(method_name, &memory_manager);
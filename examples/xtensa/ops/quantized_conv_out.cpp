@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "kernels.h"
+#include "xa_nnlib_kernels_api.h"
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace impl {
+namespace HiFi {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using RuntimeContext = torch::executor::RuntimeContext;
+
+namespace conv_util {
+// NNLib requires its buffers, and in particular its scratch memory, to be
+// aligned to 8 bytes.
+constexpr size_t kNNLibAlignment = 8;
+
+void* allocate_scratch(RuntimeContext& ctx, size_t size) {
+  torch::executor::Result<void*> temp =
+      ctx.allocate_temp(size, kNNLibAlignment);
+  ET_CHECK_MSG(
+      temp.ok(), "HiFi quantized::conv failed to allocate %zu bytes", size);
+  return temp.get();
+}
+
+// Copies the [outer, a, b, c] array src to the [outer, c, a, b] array dst,
+// e.g. from NHWC to NCHW.
+void move_last_dim_to_second(
+    uint8_t* __restrict__ dst,
+    const uint8_t* __restrict__ src,
+    size_t outer,
+    size_t a,
+    size_t b,
+    size_t c) {
+  const size_t inner = a * b;
+  for (size_t o = 0; o < outer; ++o) {
+    const uint8_t* s = src + o * inner * c;
+    uint8_t* d = dst + o * inner * c;
+    for (size_t i = 0; i < inner; ++i) {
+      for (size_t k = 0; k < c; ++k) {
+        d[k * inner + i] = s[i * c + k];
+      }
+    }
+  }
+}
+
+// Copies the [outer, c, a, b] array src to the [outer, a, b, c] array dst,
+// e.g. from NCHW to NHWC.
+void move_second_dim_to_last(
+    uint8_t* __restrict__ dst,
+    const uint8_t* __restrict__ src,
+    size_t outer,
+    size_t c,
+    size_t a,
+    size_t b) {
+  const size_t inner = a * b;
+  for (size_t o = 0; o < outer; ++o) {
+    const uint8_t* s = src + o * inner * c;
+    uint8_t* d = dst + o * inner * c;
+    for (size_t k = 0; k < c; ++k) {
+      for (size_t i = 0; i < inner; ++i) {
+        d[i * c + k] = s[k * inner + i];
+      }
+    }
+  }
+}
+} // namespace conv_util
+
+// Quantized 2D convolution of a uint8 NCHW input with uint8 weights in
+// PyTorch's [out_c, in_c / groups, kernel_h, kernel_w] layout. Regular
+// convolutions (groups == 1) run on NNLib's xa_nn_conv2d_std_asym8xasym8, and
+// depthwise ones (groups == in_c) on xa_nn_conv2d_depthwise_asym8xasym8.
+//
+// Both NNLib kernels work on channels-last data, so the input and weight are
+// transposed into temp memory, and the channels-last result is transposed
+// back into out. The transposes are linear in the size of the tensors, which
+// is small next to the cost of the convolution itself.
+void quantized_conv_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    exec_aten::ArrayRef<int64_t> stride,
+    exec_aten::ArrayRef<int64_t> padding,
+    exec_aten::ArrayRef<int64_t> dilation,
+    int64_t groups,
+    int64_t input_zero_point,
+    int64_t weight_zero_point,
+    const Tensor& out_multiplier,
+    const Tensor& out_shift,
+    int64_t out_zero_point,
+    Tensor& out) {
+  ET_CHECK_MSG(input.dim() == 4, "HiFi quantized::conv expects a 4D input");
+  ET_CHECK_MSG(
+      dilation[0] == 1 && dilation[1] == 1,
+      "HiFi quantized::conv does not support dilation");
+
+  const int32_t batches = input.size(0);
+  const int32_t in_c = input.size(1);
+  const int32_t in_h = input.size(2);
+  const int32_t in_w = input.size(3);
+  const int32_t out_c = weight.size(0);
+  const int32_t kernel_h = weight.size(2);
+  const int32_t kernel_w = weight.size(3);
+  const int32_t out_h = out.size(2);
+  const int32_t out_w = out.size(3);
+  const int32_t stride_h = stride[0];
+  const int32_t stride_w = stride[1];
+  const int32_t pad_h = padding[0];
+  const int32_t pad_w = padding[1];
+  const bool depthwise = groups != 1;
+  ET_CHECK_MSG(
+      !depthwise || groups == in_c,
+      "HiFi quantized::conv only supports groups == 1 or groups == in_c");
+
+  const uint8_t* __restrict__ in_data = input.const_data_ptr<uint8_t>();
+  const uint8_t* __restrict__ weight_data = weight.const_data_ptr<uint8_t>();
+  const int32_t* __restrict__ bias_data = bias.const_data_ptr<int32_t>();
+  uint8_t* __restrict__ out_data = out.mutable_data_ptr<uint8_t>();
+
+  // NNLib takes zero points as the biases to add to each value.
+  const int32_t input_zero_bias = -input_zero_point;
+  const int32_t weight_zero_bias = -weight_zero_point;
+  const int32_t multiplier = out_multiplier.const_data_ptr<int32_t>()[0];
+  const int32_t shift = out_shift.const_data_ptr<int32_t>()[0];
+
+  uint8_t* in_nhwc = static_cast<uint8_t*>(
+      conv_util::allocate_scratch(ctx, input.nbytes()));
+  conv_util::move_second_dim_to_last(
+      in_nhwc, in_data, batches, in_c, in_h, in_w);
+  uint8_t* out_nhwc =
+      static_cast<uint8_t*>(conv_util::allocate_scratch(ctx, out.nbytes()));
+  // Depthwise kernels are [kernel_h, kernel_w, out_c], and regular ones are
+  // [out_c, kernel_h, kernel_w, in_c].
+  uint8_t* kernel = static_cast<uint8_t*>(
+      conv_util::allocate_scratch(ctx, weight.nbytes()));
+  if (depthwise) {
+    conv_util::move_second_dim_to_last(
+        kernel, weight_data, 1, out_c, kernel_h, kernel_w);
+  } else {
+    conv_util::move_second_dim_to_last(
+        kernel, weight_data, out_c, in_c, kernel_h, kernel_w);
+  }
+
+  int32_t scratch_size = depthwise
+      ? xa_nn_conv2d_depthwise_getsize(
+            in_h,
+            in_w,
+            in_c,
+            kernel_h,
+            kernel_w,
+            out_c / in_c, // channels_multiplier
+            stride_w,
+            stride_h,
+            pad_w,
+            pad_h,
+            out_h,
+            out_w,
+            PREC_ASYM8,
+            0) // inp_data_format: NHWC
+      : xa_nn_conv2d_std_getsize(
+            in_h,
+            in_c,
+            kernel_h,
+            kernel_w,
+            stride_h,
+            pad_h,
+            out_h,
+            PREC_ASYM8);
+  ET_CHECK_MSG(scratch_size >= 0, "HiFi quantized::conv: invalid arguments");
+  void* scratch = conv_util::allocate_scratch(ctx, scratch_size);
+
+  const size_t in_plane = in_h * in_w * in_c;
+  const size_t out_plane = out_h * out_w * out_c;
+  for (int32_t n = 0; n < batches; ++n) {
+    int32_t ret = depthwise
+        ? xa_nn_conv2d_depthwise_asym8xasym8(
+              out_nhwc + n * out_plane,
+              kernel,
+              in_nhwc + n * in_plane,
+              bias_data,
+              in_h,
+              in_w,
+              in_c,
+              kernel_h,
+              kernel_w,
+              out_c / in_c, // channels_multiplier
+              stride_w,
+              stride_h,
+              pad_w,
+              pad_h,
+              out_h,
+              out_w,
+              input_zero_bias,
+              weight_zero_bias,
+              multiplier,
+              shift,
+              out_zero_point,
+              0, // inp_data_format: NHWC
+              0, // out_data_format: NHWC
+              scratch)
+        : xa_nn_conv2d_std_asym8xasym8(
+              out_nhwc + n * out_plane,
+              in_nhwc + n * in_plane,
+              kernel,
+              bias_data,
+              in_h,
+              in_w,
+              in_c,
+              kernel_h,
+              kernel_w,
+              out_c,
+              stride_w,
+              stride_h,
+              pad_w,
+              pad_h,
+              out_h,
+              out_w,
+              input_zero_bias,
+              weight_zero_bias,
+              multiplier,
+              shift,
+              out_zero_point,
+              0, // out_data_format: NHWC
+              scratch);
+    ET_DCHECK_MSG(ret == 0, "HiFi quantized::conv failed");
+  }
+
+  conv_util::move_last_dim_to_second(
+      out_data, out_nhwc, batches, out_h, out_w, out_c);
+
+  ctx.free_temp(scratch);
+  ctx.free_temp(kernel);
+  ctx.free_temp(out_nhwc);
+  ctx.free_temp(in_nhwc);
+}
+
+}; // namespace native
+}; // namespace HiFi
+}; // namespace impl
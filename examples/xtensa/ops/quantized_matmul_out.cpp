@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "kernels.h"
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <cstring>
+
+namespace impl {
+namespace HiFi {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using RuntimeContext = torch::executor::RuntimeContext;
+
+// Quantized matrix multiplication of two uint8 activations X [..., M, K] and
+// Y [..., K, N], broadcasting neither: leading dims must match.
+void quantized_matmul_out(
+    RuntimeContext& ctx,
+    const Tensor& X,
+    int64_t X_zero_point,
+    const Tensor& Y,
+    int64_t Y_zero_point,
+    const Tensor& out_multiplier,
+    const Tensor& out_shift,
+    int64_t out_zero_point,
+    Tensor& out) {
+  ET_CHECK_MSG(
+      X.dim() >= 2 && X.dim() == Y.dim(),
+      "HiFi quantized::matmul expects inputs of the same rank >= 2");
+  const int32_t M = X.size(X.dim() - 2);
+  const int32_t K = X.size(X.dim() - 1);
+  const int32_t N = Y.size(Y.dim() - 1);
+  const size_t batches = X.numel() / (M * K);
+
+  const uint8_t* __restrict__ x_data = X.const_data_ptr<uint8_t>();
+  const uint8_t* __restrict__ y_data = Y.const_data_ptr<uint8_t>();
+  uint8_t* __restrict__ out_data = out.mutable_data_ptr<uint8_t>();
+
+  // The NNLib kernel multiplies the rows of a matrix with a batch of vectors,
+  // so it computes out = X * Y as the rows of Y' times the rows of X. Y' and
+  // a zero bias go in temp memory.
+  torch::executor::Result<void*> temp =
+      ctx.allocate_temp(K * N + N * sizeof(int32_t), sizeof(int32_t));
+  ET_CHECK_MSG(temp.ok(), "HiFi quantized::matmul failed to allocate");
+  int32_t* bias = static_cast<int32_t*>(temp.get());
+  uint8_t* y_transposed = reinterpret_cast<uint8_t*>(bias + N);
+  std::memset(bias, 0, N * sizeof(int32_t));
+
+  for (size_t b = 0; b < batches; ++b) {
+    const uint8_t* y = y_data + b * K * N;
+    for (int32_t k = 0; k < K; ++k) {
+      for (int32_t n = 0; n < N; ++n) {
+        y_transposed[n * K + k] = y[k * N + n];
+      }
+    }
+    int32_t ret = impl::HiFi::kernels::matmul_asym8uxasym8u_asym8u(
+        out_data + b * M * N, // p_out
+        y_transposed, // p_mat1,
+        x_data + b * M * K, // p_mat2,
+        bias, // p_bias
+        N, // rows of p_mat1
+        K, // cols of p_mat1
+        K, // row_stride of p_mat1
+        M, // vec_count, i.e., rows of p_mat2
+        K, // vec_offset of p_mat2.
+        N, // out_offset, i.e., offset of next output element written
+        1, // out_stride, i.e., stride to go to next output row
+        -Y_zero_point, // mat1_zero_bias
+        -X_zero_point, // mat2_zero_bias
+        out_multiplier.const_data_ptr<int32_t>(), // out_multiplier
+        out_shift.const_data_ptr<int32_t>(), // out_shift
+        out_zero_point, // out_zero_bias
+        false); // per channel quantization
+    ET_DCHECK_MSG(ret == 0, "HiFi quantized::matmul failed");
+  }
+  ctx.free_temp(temp.get());
+}
+
+}; // namespace native
+}; // namespace HiFi
+}; // namespace impl
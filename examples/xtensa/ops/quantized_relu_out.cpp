@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "kernels.h"
+#include "xa_nnlib_kernels_api.h"
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace impl {
+namespace HiFi {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using RuntimeContext = torch::executor::RuntimeContext;
+
+// Quantized relu of a uint8 tensor. The output shares the input's scale and
+// zero point, so relu is a clamp of the quantized values to
+// [X_zero_point, 255].
+void quantized_relu_out(
+    RuntimeContext& ctx,
+    const Tensor& X,
+    int64_t X_zero_point,
+    Tensor& out) {
+  int32_t ret = xa_nn_vec_activation_min_max_asym8_asym8(
+      out.mutable_data_ptr<uint8_t>(),
+      X.const_data_ptr<uint8_t>(),
+      X_zero_point, // activation_min
+      255, // activation_max
+      X.numel());
+  ET_DCHECK_MSG(ret == 0, "HiFi quantized::relu failed");
+}
+
+}; // namespace native
+}; // namespace HiFi
+}; // namespace impl
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "kernels.h"
+#include "xa_nnlib_kernels_api.h"
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <algorithm>
+#include <cmath>
+
+namespace impl {
+namespace HiFi {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using RuntimeContext = torch::executor::RuntimeContext;
+
+namespace softmax_util {
+// Number of integer bits that the NNLib kernel uses for the rescaled
+// differences between the inputs and their maximum, as in TFLite.
+constexpr int kScaledDiffIntegerBits = 5;
+
+// Computes the fixed-point multiplier and left shift that NNLib applies to the
+// differences between the inputs and their maximum, and the most negative
+// difference that still contributes to the sum. This follows TFLite's
+// PreprocessSoftmaxScaling and CalculateInputRadius, with beta = 1.
+void compute_params(
+    double input_scale,
+    int32_t* multiplier,
+    int32_t* left_shift,
+    int32_t* diff_min) {
+  const double real_multiplier = std::min(
+      input_scale * (1ll << (31 - kScaledDiffIntegerBits)),
+      (1ll << 31) - 1.0);
+  int exponent = 0;
+  const double significand = std::frexp(real_multiplier, &exponent);
+  int64_t fixed = std::llround(significand * (1ll << 31));
+  if (fixed == (1ll << 31)) {
+    fixed /= 2;
+    ++exponent;
+  }
+  *multiplier = static_cast<int32_t>(fixed);
+  *left_shift = exponent;
+
+  const double max_input_rescaled = 1.0 * ((1 << kScaledDiffIntegerBits) - 1) *
+      (1ll << (31 - kScaledDiffIntegerBits)) / (1ll << exponent);
+  *diff_min = -static_cast<int32_t>(std::floor(max_input_rescaled));
+}
+} // namespace softmax_util
+
+// Quantized softmax of a uint8 tensor over its last dimension. Following
+// TFLite, the output is quantized with scale 1 / 256 and zero point 0, which
+// the quantizer fixes at export time.
+void quantized_softmax_out(
+    RuntimeContext& ctx,
+    const Tensor& X,
+    double X_scale,
+    int64_t dim,
+    Tensor& out) {
+  if (dim < 0) {
+    dim += X.dim();
+  }
+  ET_CHECK_MSG(
+      dim == X.dim() - 1,
+      "HiFi quantized::softmax only supports the last dimension");
+
+  int32_t multiplier = 0;
+  int32_t left_shift = 0;
+  int32_t diff_min = 0;
+  softmax_util::compute_params(X_scale, &multiplier, &left_shift, &diff_min);
+
+  const int32_t length = X.size(dim);
+  const size_t rows = X.numel() / length;
+  torch::executor::Result<void*> scratch = ctx.allocate_temp(
+      get_softmax_scratch_size(PREC_ASYM8, PREC_ASYM8, length), 8);
+  ET_CHECK_MSG(scratch.ok(), "HiFi quantized::softmax failed to allocate");
+
+  const uint8_t* __restrict__ in_data = X.const_data_ptr<uint8_t>();
+  uint8_t* __restrict__ out_data = out.mutable_data_ptr<uint8_t>();
+  for (size_t r = 0; r < rows; ++r) {
+    int32_t ret = xa_nn_vec_softmax_asym8_asym8(
+        out_data + r * length,
+        in_data + r * length,
+        diff_min,
+        left_shift,
+        multiplier,
+        length,
+        scratch.get());
+    ET_DCHECK_MSG(ret == 0, "HiFi quantized::softmax failed");
+  }
+  ctx.free_temp(scratch.get());
+}
+
+}; // namespace native
+}; // namespace HiFi
+}; // namespace impl
@@ -9,10 +9,12 @@
 from executorch.exir._serialize._program import (
     deserialize_pte_binary as _deserialize_pte_binary,
     serialize_pte_binary as _serialize_pte_binary,
+    serialize_pte_binary_to_file as _serialize_pte_binary_to_file,
 )
 
 # Internal APIs that should not be used outside of exir.
 __all__ = [
     "_deserialize_pte_binary",
     "_serialize_pte_binary",
+    "_serialize_pte_binary_to_file",
 ]
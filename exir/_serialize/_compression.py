@@ -0,0 +1,145 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+"""Encodes and decodes segment data in the LZ4 block format.
+
+See https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md. Only the block
+format is used: the size of the data after decompression is recorded in the
+Program's segment table instead of in a frame header.
+"""
+
+from typing import Dict
+
+# The smallest match that the format can encode.
+_MIN_MATCH: int = 4
+
+# The largest distance back to a match that the format can encode.
+_MAX_OFFSET: int = 0xFFFF
+
+# The format requires the last match to start at least this many bytes before
+# the end of the block...
+_MATCH_START_LIMIT: int = 12
+
+# ...and the last this many bytes to be literals.
+_LAST_LITERALS: int = 5
+
+
+def _write_length(out: bytearray, length: int) -> None:
+    """Appends the extra bytes of a literal or match length that didn't fit in
+    its 4-bit token field.
+    """
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _write_sequence(
+    out: bytearray, literals: bytes, offset: int = 0, match_length: int = 0
+) -> None:
+    """Appends a sequence to `out`. The final sequence of a block only has
+    literals, and is written with `match_length` of zero.
+    """
+    num_literals = len(literals)
+    match_code = match_length - _MIN_MATCH if match_length else 0
+    token = (min(num_literals, 15) << 4) | min(match_code, 15)
+    out.append(token)
+    if num_literals >= 15:
+        _write_length(out, num_literals - 15)
+    out += literals
+    if match_length:
+        out += offset.to_bytes(2, byteorder="little")
+        if match_code >= 15:
+            _write_length(out, match_code - 15)
+
+
+def compress_lz4_block(data: bytes) -> bytes:
+    """Returns `data` compressed into a single LZ4 block.
+
+    Uses a greedy search for the most recent earlier occurrence of each
+    4-byte sequence: slower and less thorough than the reference compressor,
+    but the output is valid for any LZ4 block decoder.
+    """
+    out = bytearray()
+    # Maps each 4-byte sequence to the offset where it was last seen.
+    last_seen: Dict[bytes, int] = {}
+    anchor = 0
+    i = 0
+    limit = len(data) - _MATCH_START_LIMIT
+    while i < limit:
+        key = data[i : i + _MIN_MATCH]
+        candidate = last_seen.get(key)
+        last_seen[key] = i
+        if candidate is None or i - candidate > _MAX_OFFSET:
+            i += 1
+            continue
+        match_length = _MIN_MATCH
+        max_length = len(data) - _LAST_LITERALS - i
+        while (
+            match_length < max_length
+            and data[candidate + match_length] == data[i + match_length]
+        ):
+            match_length += 1
+        _write_sequence(out, data[anchor:i], i - candidate, match_length)
+        i += match_length
+        anchor = i
+    _write_sequence(out, data[anchor:])
+    return bytes(out)
+
+
+def decompress_lz4_block(data: bytes, uncompressed_size: int) -> bytes:
+    """Returns the data encoded by a single LZ4 block.
+
+    Raises:
+        ValueError: If `data` is not a valid LZ4 block, or doesn't decompress
+            to exactly `uncompressed_size` bytes.
+    """
+    out = bytearray()
+    i = 0
+
+    def read_length(length: int) -> int:
+        nonlocal i
+        if length == 15:
+            while True:
+                if i >= len(data):
+                    raise ValueError("Truncated LZ4 length")
+                extra = data[i]
+                i += 1
+                length += extra
+                if extra != 255:
+                    break
+        return length
+
+    while i < len(data):
+        token = data[i]
+        i += 1
+        num_literals = read_length(token >> 4)
+        if i + num_literals > len(data):
+            raise ValueError("Truncated LZ4 literals")
+        out += data[i : i + num_literals]
+        i += num_literals
+        if i == len(data):
+            # The final sequence has no match.
+            break
+        if i + 2 > len(data):
+            raise ValueError("Truncated LZ4 match offset")
+        offset = int.from_bytes(data[i : i + 2], byteorder="little")
+        i += 2
+        if offset == 0 or offset > len(out):
+            raise ValueError(f"Invalid LZ4 match offset {offset}")
+        match_length = read_length(token & 0xF) + _MIN_MATCH
+        start = len(out) - offset
+        # Matches may overlap the bytes they produce, so copy one at a time.
+        for j in range(match_length):
+            out.append(out[start + j])
+    if len(out) != uncompressed_size:
+        raise ValueError(
+            f"LZ4 block decompressed to {len(out)} bytes, "
+            + f"expected {uncompressed_size}"
+        )
+    return bytes(out)
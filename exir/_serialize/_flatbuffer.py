@@ -13,7 +13,13 @@ import subprocess
 import tempfile
 
 from dataclasses import dataclass
-from typing import Callable, Dict, List, Optional, Sequence
+from typing import Any, Callable, Dict, List, Optional, Sequence
+
+try:
+    # Native serialization is only available where the C++ extension is built.
+    from executorch.exir._serialize import _bindings  # @manual
+except ImportError:
+    _bindings = None
 
 
 def _is_valid_alignment(alignment: int) -> bool:
@@ -285,6 +291,53 @@ def _program_json_to_flatbuffer(
             )
 
 
+def _has_native_flatbuffer_builder() -> bool:
+    """Returns True if _program_to_flatbuffer_native() can be used."""
+    return _bindings is not None
+
+
+# pyre-ignore
+def _program_to_flatbuffer_native(
+    program: Any,
+    *,
+    constant_tensor_alignment: Optional[int] = None,
+    delegate_alignment: Optional[int] = None,
+) -> _FlatbufferResult:
+    """Converts a Program into binary flatbuffer data without going through
+    JSON or a flatc subprocess.
+
+    Byte fields like Buffer.storage are copied into the flatbuffer as they are,
+    so this is much faster than _program_json_to_flatbuffer() and uses much
+    less memory when the program holds large constant tensors. Only available
+    if _has_native_flatbuffer_builder() returns True.
+
+    Args:
+        program: The exir.schema.Program to convert.
+        constant_tensor_alignment: If provided, the alignment to use for tensor
+            data embedded in the output flatbuffer data. If not provided, uses
+            the alignment in the schema.
+        delegate_alignment: If provided, the alignment to use for delegate
+            data embedded in the output flatbuffer data. If not provided, uses
+            the alignment in the schema.
+
+    Returns: The flatbuffer data and associated metadata.
+    """
+    if _bindings is None:
+        raise RuntimeError("Native flatbuffer serialization is not available")
+    with tempfile.TemporaryDirectory() as temp_dir:
+        schema_info = _prepare_schema(
+            out_dir=temp_dir,
+            constant_tensor_alignment=constant_tensor_alignment,
+            delegate_alignment=delegate_alignment,
+        )
+        return _FlatbufferResult(
+            data=_bindings.dataclass_to_flatbuffer(
+                schema_info.root_path, temp_dir, program
+            ),
+            max_alignment=schema_info.max_alignment,
+        )
+
+
 def _program_flatbuffer_to_json(program_flatbuffer: bytes) -> bytes:
     """Converts binary flatbuffer data into Program-compatible JSON.
 
@@ -7,28 +7,43 @@
 # pyre-strict
 
 import copy
+import io
 import json
 import re
+import zlib
 
 from dataclasses import dataclass
-from typing import ClassVar, List, Literal, Optional, Tuple
+from typing import BinaryIO, ClassVar, List, Literal, Optional, Tuple, Union
 
+from executorch.exir._serialize._compression import (
+    compress_lz4_block,
+    decompress_lz4_block,
+)
 from executorch.exir._serialize._dataclass import _DataclassEncoder, _json_to_dataclass
 from executorch.exir._serialize._flatbuffer import (
     _FlatbufferResult,
+    _has_native_flatbuffer_builder,
     _program_flatbuffer_to_json,
     _program_json_to_flatbuffer,
+    _program_to_flatbuffer_native,
 )
 
 from executorch.exir.schema import (
     BackendDelegateDataReference,
     BackendDelegateInlineData,
+    Buffer,
     DataLocation,
     DataSegment,
     Program,
+    SegmentCompression,
+    SubsegmentOffsets,
 )
 
 
+# Alignment of each tensor within the constant segment when the caller does not
+# provide one. Matches the default force_align of Buffer.storage in the schema.
+_DEFAULT_CONSTANT_TENSOR_ALIGNMENT: int = 16
+
 # Byte order of numbers written to program headers. Always little-endian
 # regardless of the host system, since all commonly-used modern CPUs are little
 # endian.
@@ -130,6 +145,19 @@ class _ExtendedHeader:
         # Segment base offset
         + 8
     )
+    # The length of a header that also has the optional program checksum.
+    LENGTH_WITH_CHECKSUM: ClassVar[int] = (
+        EXPECTED_LENGTH
+        # Program checksum
+        + 4
+    )
+    # The length of a header that also records the constant tensor alignment,
+    # which always comes with a program checksum.
+    LENGTH_WITH_TENSOR_ALIGNMENT: ClassVar[int] = (
+        LENGTH_WITH_CHECKSUM
+        # Tensor alignment
+        + 4
+    )
 
     # Instance attributes. @dataclass will turn these into ctor args.
 
@@ -144,6 +172,12 @@ class _ExtendedHeader:
     # The header length, in bytes, read from or to be written to the binary
     # header.
     length: int = EXPECTED_LENGTH
+    # The CRC-32 of the program data with this field zeroed, if the header has
+    # one. See _compute_program_checksum().
+    program_checksum: Optional[int] = None
+    # The alignment from the start of the file that the data of every constant
+    # tensor has, if the header records one.
+    tensor_alignment: Optional[int] = None
 
     @staticmethod
     def from_bytes(data: bytes) -> "_ExtendedHeader":
@@ -165,13 +199,32 @@ class _ExtendedHeader:
                 + f"< {_ExtendedHeader.EXPECTED_LENGTH}"
             )
 
+        length = int.from_bytes(data[4:8], byteorder=_HEADER_BYTEORDER)
+        program_checksum: Optional[int] = None
+        if (
+            length >= _ExtendedHeader.LENGTH_WITH_CHECKSUM
+            and len(data) >= _ExtendedHeader.LENGTH_WITH_CHECKSUM
+        ):
+            program_checksum = int.from_bytes(
+                data[24:28], byteorder=_HEADER_BYTEORDER
+            )
+        tensor_alignment: Optional[int] = None
+        if (
+            length >= _ExtendedHeader.LENGTH_WITH_TENSOR_ALIGNMENT
+            and len(data) >= _ExtendedHeader.LENGTH_WITH_TENSOR_ALIGNMENT
+        ):
+            tensor_alignment = int.from_bytes(
+                data[28:32], byteorder=_HEADER_BYTEORDER
+            )
         return _ExtendedHeader(
             magic=data[0:4],
-            length=int.from_bytes(data[4:8], byteorder=_HEADER_BYTEORDER),
+            length=length,
             program_size=int.from_bytes(data[8:16], byteorder=_HEADER_BYTEORDER),
             segment_base_offset=int.from_bytes(
                 data[16:24], byteorder=_HEADER_BYTEORDER
             ),
+            program_checksum=program_checksum,
+            tensor_alignment=tensor_alignment,
         )
 
     def is_valid(self) -> bool:
@@ -185,8 +238,21 @@ class _ExtendedHeader:
         """Returns the binary representation of the extended header.
 
         Note that this will ignore self.magic and self.length and will always
-        write the proper magic/length.
+        write the proper magic/length. The program checksum and the tensor
+        alignment are only written if they are not None, and a tensor alignment
+        requires a program checksum.
         """
+        if self.tensor_alignment is not None and self.program_checksum is None:
+            raise ValueError("tensor_alignment requires program_checksum")
+        length: int = (
+            self.EXPECTED_LENGTH
+            if self.program_checksum is None
+            else (
+                self.LENGTH_WITH_CHECKSUM
+                if self.tensor_alignment is None
+                else self.LENGTH_WITH_TENSOR_ALIGNMENT
+            )
+        )
         data: bytes = (
             # Extended header magic. This lets consumers detect whether the
             # header was inserted or not. Always use the proper magic value
@@ -197,16 +263,38 @@ class _ExtendedHeader:
             # fields to this header in the future. Always use the proper size
             # (i.e., ignore self.length) since there's no reason to create an
             # invalid header.
-            + self.EXPECTED_LENGTH.to_bytes(4, byteorder=_HEADER_BYTEORDER)
+            + length.to_bytes(4, byteorder=_HEADER_BYTEORDER)
             # uint64_t: Size of the flatbuffer data, including this header.
             + self.program_size.to_bytes(8, byteorder=_HEADER_BYTEORDER)
             # uint64_t: Offset to the start of the first segment, or zero if
             # there are no segments.
             + self.segment_base_offset.to_bytes(8, byteorder=_HEADER_BYTEORDER)
         )
+        if self.program_checksum is not None:
+            # uint32_t: CRC-32 of the program data, with this field zeroed.
+            data += self.program_checksum.to_bytes(4, byteorder=_HEADER_BYTEORDER)
+        if self.tensor_alignment is not None:
+            # uint32_t: Alignment of the data of every constant tensor.
+            data += self.tensor_alignment.to_bytes(4, byteorder=_HEADER_BYTEORDER)
         return data
 
 
+# The offset of the program checksum field within the program data: the
+# extended header starts after the 4-byte flatbuffer root offset and the 4-byte
+# file identifier.
+_PROGRAM_CHECKSUM_OFFSET: int = 8 + _ExtendedHeader.EXPECTED_LENGTH
+
+
+def _compute_program_checksum(program_data: bytes) -> int:
+    """Returns the checksum that the runtime verifies with
+    Program::Verification::Checksum: the CRC-32 of the program data, with the
+    checksum field taken as zeros. Segments are not covered.
+    """
+    crc = zlib.crc32(program_data[:_PROGRAM_CHECKSUM_OFFSET])
+    crc = zlib.crc32(b"\x00" * 4, crc)
+    return zlib.crc32(program_data[_PROGRAM_CHECKSUM_OFFSET + 4 :], crc)
+
+
 def _pad_to(data: bytes, length: int) -> bytes:
     """Returns the input followed by enough zero bytes to become the requested length.
 
@@ -237,9 +325,34 @@ def _get_extended_header(program_data: bytes) -> Optional[_ExtendedHeader]:
     return None
 
 
+class _Cord:
+    """Segment data made of several pieces, which can be written out one after
+    the other instead of first being joined into one large bytes object.
+    """
+
+    def __init__(self) -> None:
+        self._pieces: List[bytes] = []
+        self._size: int = 0
+
+    def append(self, data: bytes) -> None:
+        self._pieces.append(data)
+        self._size += len(data)
+
+    def __len__(self) -> int:
+        return self._size
+
+    def write_to(self, out: BinaryIO) -> None:
+        for piece in self._pieces:
+            out.write(piece)
+
+
+# The data of one segment.
+_SegmentData = Union[bytes, _Cord]
+
+
 def _extract_segments(
-    program: Program, segment_alignment: int
-) -> Tuple[Program, List[bytes]]:
+    program: Program, segment_alignment: int, compress: bool = False
+) -> Tuple[Program, List[_SegmentData]]:
     """Moves data from the Program into a list of segments.
 
     The returned program is a copy of `program`. Program.segments parallels the
@@ -249,6 +362,8 @@ def _extract_segments(
         program: The program to extract segments from.
         segment_alignment: Alignment in bytes. The starting offset of each
             segment will be aligned to this value.
+        compress: Whether to LZ4-compress each segment. Segments that don't
+            get smaller are stored uncompressed.
     Returns:
         A tuple of (modified program, list of segment data).
     """
@@ -263,7 +378,7 @@ def _extract_segments(
     # copy, reusing the actual data blobs.
     program = copy.deepcopy(program)
 
-    segments: List[bytes] = []
+    segments: List[_SegmentData] = []
     remaining_inline: List[BackendDelegateInlineData] = []
     inline_indices_seen: set[int] = set()
     for plan in program.execution_plan:
@@ -292,7 +407,14 @@ def _extract_segments(
             if inline.data:
                 # Move the delegate data out of the program.
                 segment_index = len(segments)
-                segments.append(inline.data)
+                data: bytes = inline.data
+                compression = SegmentCompression.NONE
+                if compress:
+                    compressed = compress_lz4_block(data)
+                    if len(compressed) < len(data):
+                        data = compressed
+                        compression = SegmentCompression.LZ4_BLOCK
+                segments.append(data)
                 delegate.processed = BackendDelegateDataReference(
                     location=DataLocation.SEGMENT,
                     index=segment_index,
@@ -307,7 +429,13 @@ def _extract_segments(
                 program.segments.append(
                     DataSegment(
                         offset=_aligned_size(prev_end, segment_alignment),
-                        size=len(inline.data),
+                        size=len(data),
+                        compression=compression,
+                        uncompressed_size=(
+                            len(inline.data)
+                            if compression != SegmentCompression.NONE
+                            else 0
+                        ),
                     ),
                 )
             else:
@@ -334,21 +462,80 @@ def _extract_segments(
     return (program, segments)
 
 
-def _append_segments(
+def _extract_constant_segment(
+    program: Program,
+    segments: List[_SegmentData],
+    segment_alignment: int,
+    tensor_alignment: int,
+) -> Program:
+    """Moves the constant tensor data of the Program into a new segment.
+
+    All of Program.constant_buffer is packed into one segment appended to
+    `segments` and Program.segments, and Program.constant_segment records where
+    each buffer starts within it. Entry 0, reserved for non-constant tensors,
+    is kept as an empty placeholder at offset 0.
+
+    Args:
+        program: The program to extract constants from. Modified in place;
+            callers should pass a copy.
+        segments: The segment data list to append the new segment to. Modified
+            in place.
+        segment_alignment: Alignment in bytes of the start of each segment.
+        tensor_alignment: Alignment in bytes of each tensor within the segment.
+    Returns:
+        The modified program.
+    """
+    if not any(buffer.storage for buffer in program.constant_buffer):
+        # Nothing worth moving; keep the (possibly empty) inline table.
+        return program
+
+    # Lay out the buffers back to back, each starting on an aligned offset.
+    # The buffers are not copied; they are written out one by one.
+    offsets: List[int] = []
+    pieces = _Cord()
+    for buffer in program.constant_buffer:
+        pad_length: int = _padding_required(len(pieces), tensor_alignment)
+        if pad_length > 0:
+            pieces.append(b"\x00" * pad_length)
+        offsets.append(len(pieces))
+        pieces.append(buffer.storage)
+
+    prev_end = (
+        program.segments[-1].offset + program.segments[-1].size
+        if program.segments
+        else 0
+    )
+    program.constant_segment = SubsegmentOffsets(
+        segment_index=len(segments), offsets=offsets
+    )
+    program.segments.append(
+        DataSegment(
+            offset=_aligned_size(prev_end, segment_alignment),
+            size=len(pieces),
+        )
+    )
+    segments.append(pieces)
+    program.constant_buffer = []
+    return program
+
+
+def _write_segments(
+    out: BinaryIO,
     program_data: bytes,
-    segments: List[bytes],
+    segments: List[_SegmentData],
     alignment: int,
     segment_table: List[DataSegment],
     base_offset: int,
-) -> bytes:
-    """Appends segments to the end of the program data.
+) -> None:
+    """Writes the program data to `out`, followed by the segments.
 
-    Appends each element of `segments` to `program_data`, with '\0' padding to
-    ensure that the offset of each segment is aligned to `alignment`.
+    Writes each element of `segments` after `program_data`, with '\0' padding
+    to ensure that the offset of each segment is aligned to `alignment`.
 
     Args:
-        program_data: The flatbuffer-serialized Program.
-        segments: The list of segments to append to `program_data`.
+        out: The file-like object to write to.
+        program_data: The data to write first.
+        segments: The list of segments to write after `program_data`.
         alignment: Alignment in bytes. The starting offset of each
             segment will be aligned to this value in the output data.
         segment_table: The expected offsets and sizes of each element in
@@ -357,9 +544,6 @@ def _append_segments(
         base_offset: The expected segment base offset from the extended header.
             Should point to the aligned offset following the end of
             `program_data`.
-    Returns:
-        A copy of `program_data` with the segment data and padding appended.
-        If there are no segments, returns `program_data` directly.
     Raises:
         ValueError: If the length of `segments` doesn't match the length of
             `segment_table`.
@@ -369,19 +553,14 @@ def _append_segments(
             f"Segments length {len(segments)} does not match "
             + f"segment_table length {len(segment_table)}"
         )
-    if not segments:
-        return program_data
 
-    # The pieces that will be concatenated to create the output data.
-    # `program_data` will be its first element.
-    padded_segments: List[bytes] = []
-    # Length of all elements in padded_segments. Only used for assertions.
+    # Number of bytes written so far. Only used for padding and assertions.
     current_offset: int = 0
     for i, segment in enumerate([program_data] + segments):
         # Add padding if necessary to align the start of this segment.
         pad_length: int = _padding_required(current_offset, alignment)
         if pad_length > 0:
-            padded_segments.append(b"\x00" * pad_length)
+            out.write(b"\x00" * pad_length)
             current_offset += pad_length
 
         # Make sure that we're about to add this segment to the offset that
@@ -409,21 +588,45 @@ def _append_segments(
 
         # Add the payload. If this is the final segment, it does not need
         # padding after it.
-        padded_segments.append(segment)
+        if isinstance(segment, _Cord):
+            segment.write_to(out)
+        else:
+            out.write(segment)
         current_offset += len(segment)
 
-    # Use join() instead of appending to avoid O(n) reallocation of these
-    # potentially-large buffers.
-    return b"".join(padded_segments)
+
+def _program_to_flatbuffer(
+    program: Program,
+    *,
+    constant_tensor_alignment: Optional[int],
+    delegate_alignment: Optional[int],
+) -> _FlatbufferResult:
+    """Converts the Program into flatbuffer data, natively if possible, and
+    otherwise by way of JSON and flatc.
+    """
+    if _has_native_flatbuffer_builder():
+        return _program_to_flatbuffer_native(
+            program,
+            constant_tensor_alignment=constant_tensor_alignment,
+            delegate_alignment=delegate_alignment,
+        )
+    return _program_json_to_flatbuffer(
+        _program_to_json(program),
+        constant_tensor_alignment=constant_tensor_alignment,
+        delegate_alignment=delegate_alignment,
+    )
 
 
 def serialize_pte_binary(
     program: Program,
     *,
     extract_segments: bool = False,
+    extract_constant_segment: bool = False,
+    compress_delegate_segments: bool = False,
     segment_alignment: int = 4096,
     constant_tensor_alignment: Optional[int] = None,
     delegate_alignment: Optional[int] = None,
+    program_checksum: bool = False,
 ) -> bytes:
     """Returns the runtime binary representation of the given Program.
 
@@ -436,38 +639,130 @@ def serialize_pte_binary(
               and the starting segment offset.
             - Update the Program.segments field with the offsets and lengths
               of each segment.
+        extract_constant_segment: Whether to also move the constant tensor
+            data from Program.constant_buffer into a segment, so that the
+            runtime can load each tensor when a method that uses it is loaded
+            instead of along with the flatbuffer data. Requires
+            extract_segments.
+        compress_delegate_segments: Whether to LZ4-compress the delegate data
+            segments, which the runtime then decompresses while loading them.
+            Shrinks the file, but the segments can no longer be mmap()ed.
+            Requires extract_segments.
         segment_alignment: Alignment in bytes. The starting offset of each
             segment will be aligned to this value in the output data.
         constant_tensor_alignment: If provided, the minimum alignment of tensor
             buffers in the program. Must be a power of 2. If not provided, uses
-            the value in the schema file.
+            the value in the schema file. With extract_segments, the alignment
+            is also recorded in the extended header along with a program
+            checksum, so that the runtime can check that it is preserved, and
+            segment_alignment must be a multiple of it.
         delegate_alignment: If provided, the minimum alignment of delegate data
             in the program. Must be a power of 2. If not provided, uses the
             value in the schema file.
+        program_checksum: Whether to add a checksum of the program data to the
+            extended header, which the runtime can verify with
+            Program::Verification::Checksum instead of the more expensive full
+            flatbuffer verification. Requires extract_segments.
     Returns:
         The serialized form of the Program, ready for execution by the runtime.
     """
+    out = io.BytesIO()
+    serialize_pte_binary_to_file(
+        program,
+        out,
+        extract_segments=extract_segments,
+        extract_constant_segment=extract_constant_segment,
+        compress_delegate_segments=compress_delegate_segments,
+        segment_alignment=segment_alignment,
+        constant_tensor_alignment=constant_tensor_alignment,
+        delegate_alignment=delegate_alignment,
+        program_checksum=program_checksum,
+    )
+    return out.getvalue()
+
+
+def serialize_pte_binary_to_file(
+    program: Program,
+    file: BinaryIO,
+    *,
+    extract_segments: bool = False,
+    extract_constant_segment: bool = False,
+    compress_delegate_segments: bool = False,
+    segment_alignment: int = 4096,
+    constant_tensor_alignment: Optional[int] = None,
+    delegate_alignment: Optional[int] = None,
+    program_checksum: bool = False,
+) -> None:
+    """Writes the runtime binary representation of the given Program to a file.
+
+    Produces the same data as serialize_pte_binary(), but writes the segments
+    to `file` one piece at a time, so that large constant data is never copied
+    into one buffer holding the whole output.
+
+    Args:
+        program: The Program to serialize.
+        file: The binary file-like object to write to.
+        See serialize_pte_binary() for the other arguments.
+    """
     # Segment data to be written to the file following the flatbuffer data.
-    segments: List[bytes] = []
+    segments: List[_SegmentData] = []
+    if extract_constant_segment and not extract_segments:
+        raise ValueError("extract_constant_segment requires extract_segments")
+    if compress_delegate_segments and not extract_segments:
+        raise ValueError("compress_delegate_segments requires extract_segments")
+    if program_checksum and not extract_segments:
+        raise ValueError("program_checksum requires extract_segments")
+    # The guaranteed alignment of constant tensor data to record in the header.
+    tensor_alignment: Optional[int] = (
+        constant_tensor_alignment if extract_segments else None
+    )
+    if tensor_alignment is not None:
+        if segment_alignment % tensor_alignment != 0:
+            raise ValueError(
+                f"segment_alignment {segment_alignment} is not a multiple of "
+                + f"constant_tensor_alignment {tensor_alignment}"
+            )
+        # Headers that record the alignment always have a checksum.
+        program_checksum = True
     if extract_segments:
         # May return a copy of the program to avoid modifying the input.
         program, segments = _extract_segments(
-            program=program, segment_alignment=segment_alignment
+            program=program,
+            segment_alignment=segment_alignment,
+            compress=compress_delegate_segments,
+        )
+    if extract_constant_segment:
+        # The program is already a copy made by _extract_segments.
+        program = _extract_constant_segment(
+            program=program,
+            segments=segments,
+            segment_alignment=segment_alignment,
+            tensor_alignment=constant_tensor_alignment
+            or _DEFAULT_CONSTANT_TENSOR_ALIGNMENT,
         )
 
     # Convert to a standard flatbuffer binary.
-    result: _FlatbufferResult = _program_json_to_flatbuffer(
-        _program_to_json(program),
+    result: _FlatbufferResult = _program_to_flatbuffer(
+        program,
         constant_tensor_alignment=constant_tensor_alignment,
         delegate_alignment=delegate_alignment,
     )
     if not extract_segments:
-        return result.data
+        file.write(result.data)
+        return
 
     # Size of the header to insert. Its size is padded to the largest
     # force_align value present in the schema.
     padded_header_length: int = _aligned_size(
-        input_size=_ExtendedHeader.EXPECTED_LENGTH,
+        input_size=(
+            _ExtendedHeader.LENGTH_WITH_TENSOR_ALIGNMENT
+            if tensor_alignment is not None
+            else (
+                _ExtendedHeader.LENGTH_WITH_CHECKSUM
+                if program_checksum
+                else _ExtendedHeader.EXPECTED_LENGTH
+            )
+        ),
         alignment=result.max_alignment,
     )
     # Size of the program with the header inserted.
@@ -480,8 +775,13 @@ def serialize_pte_binary(
     )
 
     # Construct and pad the extended header.
+    # The checksum is computed over the data with its own field zeroed, so
+    # write zeros for now.
     header_data: bytes = _ExtendedHeader(
-        program_size=program_size, segment_base_offset=segment_base_offset
+        program_size=program_size,
+        segment_base_offset=segment_base_offset,
+        program_checksum=0 if program_checksum else None,
+        tensor_alignment=tensor_alignment,
     ).to_bytes()
     header_data = _pad_to(header_data, padded_header_length)
 
@@ -496,25 +796,34 @@ def serialize_pte_binary(
     # Potentially large. Try to free it as soon as we can.
     del result.data
 
+    checksum: Optional[int] = None
+    if program_checksum:
+        checksum = _compute_program_checksum(program_data)
+        program_data = (
+            program_data[:_PROGRAM_CHECKSUM_OFFSET]
+            + checksum.to_bytes(4, byteorder=_HEADER_BYTEORDER)
+            + program_data[_PROGRAM_CHECKSUM_OFFSET + 4 :]
+        )
+
     # Double-check that the extended header is in the right place and has the
     # right contents.
     eh = _get_extended_header(program_data)
     assert eh is not None
     assert eh.program_size == program_size
     assert eh.segment_base_offset == segment_base_offset
-
-    if segments:
-        # Add segments to the end of the data, in order, with the appropriate
-        # padding.
-        program_data = _append_segments(
-            program_data=program_data,
-            segments=segments,
-            alignment=segment_alignment,
-            segment_table=program.segments,
-            base_offset=segment_base_offset,
-        )
-
-    return program_data
+    assert eh.program_checksum == checksum
+    assert eh.tensor_alignment == tensor_alignment
+
+    # Write the program, followed by the segments in order with the
+    # appropriate padding.
+    _write_segments(
+        out=file,
+        program_data=program_data,
+        segments=segments,
+        alignment=segment_alignment,
+        segment_table=program.segments,
+        base_offset=segment_base_offset,
+    )
 
 
 def _restore_segments(program: Program, segment_data: bytes) -> Program:
@@ -540,7 +849,12 @@ def _restore_segments(program: Program, segment_data: bytes) -> Program:
             raise ValueError(
                 f"Segment {i} {segment} overflows data length {len(segment_data)}"
             )
-        segments.append(segment_data[segment.offset : segment.offset + segment.size])
+        data = segment_data[segment.offset : segment.offset + segment.size]
+        if segment.compression == SegmentCompression.LZ4_BLOCK:
+            data = decompress_lz4_block(data, segment.uncompressed_size)
+        elif segment.compression != SegmentCompression.NONE:
+            raise ValueError(f"Segment {i} has unknown compression {segment}")
+        segments.append(data)
 
     # Find and replace the Program's references to these segments, inlining the
     # data.
@@ -564,6 +878,26 @@ def _restore_segments(program: Program, segment_data: bytes) -> Program:
                 location=DataLocation.INLINE, index=data_index
             )
 
+    # Move the constant tensor data back into Program.constant_buffer.
+    if program.constant_segment is not None and program.constant_segment.offsets:
+        index = program.constant_segment.segment_index
+        if index >= len(segments):
+            raise ValueError(
+                f"Constant segment index {index} >= num segments {len(segments)}"
+            )
+        constant_data: bytes = segments[index]
+        offsets: List[int] = program.constant_segment.offsets
+        if program.constant_buffer:
+            raise ValueError(
+                "Program has both constant_buffer and constant_segment entries"
+            )
+        for i, start in enumerate(offsets):
+            # Sizes are not recorded, so each buffer keeps the padding that
+            # separated it from the next one.
+            end = offsets[i + 1] if i + 1 < len(offsets) else len(constant_data)
+            program.constant_buffer.append(Buffer(storage=constant_data[start:end]))
+    program.constant_segment = None
+
     # Clear out the segments list since the original Program didn't have one.
     program.segments = []
     return program
@@ -8,9 +8,17 @@
 
 #include <flatbuffers/flatc.h> // @manual=fbsource//third-party/flatbuffers:flatc_library
 #include <flatbuffers/idl.h> // @manual=fbsource//third-party/flatbuffers:flatc_library
+#include <flatbuffers/util.h> // @manual=fbsource//third-party/flatbuffers:flatc_library
 #include <pybind11/pybind11.h> // @manual=fbsource//arvr/third-party/pybind11:pybind11
 #include <pybind11/stl.h> // @manual=fbsource//arvr/third-party/pybind11:pybind11
 
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
 namespace exir {
 namespace {
 void Warn(
@@ -28,6 +36,252 @@ void Error(
   throw std::runtime_error("Caught error in flatc compiler: " + err);
 }
 
+/**
+ * Builds a flatbuffer directly from a tree of Python dataclasses, such as an
+ * exir.schema.Program, driven by a parsed schema the same way flatc is driven
+ * by JSON. Byte vectors like constant tensor data and delegate blobs are copied
+ * from the Python buffers as raw memory, instead of being encoded as JSON lists
+ * of integers and parsed back.
+ *
+ * Dataclass attributes must have the names of the schema fields, and the value
+ * of a union field must be an instance of the class named after its member
+ * type, which is what the JSON serialization of exir.schema relies on too.
+ */
+class DataclassFlatbufferBuilder {
+ public:
+  explicit DataclassFlatbufferBuilder(const flatbuffers::Parser& parser)
+      : parser_(parser) {}
+
+  py::bytes build(py::handle root) {
+    if (parser_.root_struct_def_ == nullptr) {
+      throw std::runtime_error("Schema does not declare a root_type");
+    }
+    flatbuffers::uoffset_t root_offset =
+        build_table(*parser_.root_struct_def_, root);
+    builder_.Finish(
+        flatbuffers::Offset<void>(root_offset),
+        parser_.file_identifier_.empty() ? nullptr
+                                         : parser_.file_identifier_.c_str());
+    return py::bytes(
+        reinterpret_cast<const char*>(builder_.GetBufferPointer()),
+        builder_.GetSize());
+  }
+
+ private:
+  // A field whose value was written before the table was started.
+  struct OffsetField {
+    const flatbuffers::FieldDef* field;
+    flatbuffers::uoffset_t offset;
+  };
+
+  flatbuffers::uoffset_t build_table(
+      const flatbuffers::StructDef& def,
+      py::handle obj) {
+    if (def.fixed) {
+      throw std::runtime_error(
+          "Flatbuffer structs are not supported: " + def.name);
+    }
+    // Strings, vectors and child tables must all be serialized before this
+    // table is started.
+    std::vector<OffsetField> offsets;
+    std::vector<std::pair<const flatbuffers::FieldDef*, uint8_t>> union_types;
+    for (const flatbuffers::FieldDef* field : def.fields.vec) {
+      if (field->deprecated || !py::hasattr(obj, field->name.c_str())) {
+        continue;
+      }
+      py::object value = obj.attr(field->name.c_str());
+      if (value.is_none()) {
+        continue;
+      }
+      const flatbuffers::Type& type = field->value.type;
+      switch (type.base_type) {
+        case flatbuffers::BASE_TYPE_STRING:
+          offsets.push_back(
+              {field, builder_.CreateString(py::cast<std::string>(value)).o});
+          break;
+        case flatbuffers::BASE_TYPE_VECTOR:
+          offsets.push_back({field, build_vector(*field, value)});
+          break;
+        case flatbuffers::BASE_TYPE_STRUCT:
+          offsets.push_back({field, build_table(*type.struct_def, value)});
+          break;
+        case flatbuffers::BASE_TYPE_UNION: {
+          std::string member =
+              py::cast<std::string>(value.attr("__class__").attr("__name__"));
+          const flatbuffers::EnumVal* val = type.enum_def->Lookup(member);
+          if (val == nullptr || val->union_type.struct_def == nullptr) {
+            throw std::runtime_error(
+                member + " is not a member of union " + type.enum_def->name);
+          }
+          const flatbuffers::FieldDef* type_field =
+              def.fields.Lookup(field->name + "_type");
+          union_types.emplace_back(
+              type_field, static_cast<uint8_t>(val->GetAsUInt64()));
+          offsets.push_back(
+              {field, build_table(*val->union_type.struct_def, value)});
+          break;
+        }
+        default:
+          break;
+      }
+    }
+
+    flatbuffers::uoffset_t start = builder_.StartTable();
+    for (const flatbuffers::FieldDef* field : def.fields.vec) {
+      if (field->deprecated ||
+          !flatbuffers::IsScalar(field->value.type.base_type) ||
+          field->value.type.base_type == flatbuffers::BASE_TYPE_UTYPE ||
+          !py::hasattr(obj, field->name.c_str())) {
+        continue;
+      }
+      py::object value = obj.attr(field->name.c_str());
+      if (!value.is_none()) {
+        add_scalar(*field, value);
+      }
+    }
+    for (const auto& type_field : union_types) {
+      builder_.AddElement<uint8_t>(
+          type_field.first->value.offset, type_field.second, 0);
+    }
+    for (const OffsetField& entry : offsets) {
+      builder_.AddOffset(
+          entry.field->value.offset, flatbuffers::Offset<void>(entry.offset));
+    }
+    return builder_.EndTable(start);
+  }
+
+  flatbuffers::uoffset_t build_vector(
+      const flatbuffers::FieldDef& field,
+      py::handle value) {
+    const flatbuffers::Type& type = field.value.type;
+    size_t alignment = 0;
+    if (const flatbuffers::Value* force_align =
+            field.attributes.Lookup("force_align")) {
+      alignment = std::stoul(force_align->constant);
+    }
+    switch (type.element) {
+      case flatbuffers::BASE_TYPE_UCHAR:
+      case flatbuffers::BASE_TYPE_CHAR:
+        if (py::isinstance<py::buffer>(value)) {
+          // The bulk of a program: copy the bytes as they are.
+          py::buffer_info info =
+              py::reinterpret_borrow<py::buffer>(value).request();
+          size_t size = static_cast<size_t>(info.size * info.itemsize);
+          if (alignment > 0) {
+            builder_.ForceVectorAlignment(size, 1, alignment);
+          }
+          return builder_
+              .CreateVector(static_cast<const uint8_t*>(info.ptr), size)
+              .o;
+        }
+        return type.element == flatbuffers::BASE_TYPE_UCHAR
+            ? build_scalar_vector<uint8_t>(value, alignment)
+            : build_scalar_vector<int8_t>(value, alignment);
+      case flatbuffers::BASE_TYPE_BOOL:
+        return build_scalar_vector<uint8_t>(value, alignment);
+      case flatbuffers::BASE_TYPE_SHORT:
+        return build_scalar_vector<int16_t>(value, alignment);
+      case flatbuffers::BASE_TYPE_USHORT:
+        return build_scalar_vector<uint16_t>(value, alignment);
+      case flatbuffers::BASE_TYPE_INT:
+        return build_scalar_vector<int32_t>(value, alignment);
+      case flatbuffers::BASE_TYPE_UINT:
+        return build_scalar_vector<uint32_t>(value, alignment);
+      case flatbuffers::BASE_TYPE_LONG:
+        return build_scalar_vector<int64_t>(value, alignment);
+      case flatbuffers::BASE_TYPE_ULONG:
+        return build_scalar_vector<uint64_t>(value, alignment);
+      case flatbuffers::BASE_TYPE_FLOAT:
+        return build_scalar_vector<float>(value, alignment);
+      case flatbuffers::BASE_TYPE_DOUBLE:
+        return build_scalar_vector<double>(value, alignment);
+      case flatbuffers::BASE_TYPE_STRING: {
+        std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+        for (py::handle item : value) {
+          strings.push_back(builder_.CreateString(py::cast<std::string>(item)));
+        }
+        return builder_.CreateVector(strings).o;
+      }
+      case flatbuffers::BASE_TYPE_STRUCT: {
+        std::vector<flatbuffers::Offset<void>> tables;
+        for (py::handle item : value) {
+          tables.emplace_back(build_table(*type.struct_def, item));
+        }
+        return builder_.CreateVector(tables).o;
+      }
+      default:
+        throw std::runtime_error(
+            "Unsupported vector element type in field " + field.name);
+    }
+  }
+
+  template <typename T>
+  flatbuffers::uoffset_t build_scalar_vector(
+      py::handle value,
+      size_t alignment) {
+    std::vector<T> elements;
+    for (py::handle item : value) {
+      elements.push_back(py::cast<T>(item));
+    }
+    if (alignment > 0) {
+      builder_.ForceVectorAlignment(elements.size(), sizeof(T), alignment);
+    }
+    return builder_.CreateVector(elements).o;
+  }
+
+  void add_scalar(const flatbuffers::FieldDef& field, py::handle value) {
+    switch (field.value.type.base_type) {
+      case flatbuffers::BASE_TYPE_BOOL:
+        add_element<uint8_t>(field, py::cast<bool>(value) ? 1 : 0);
+        break;
+      case flatbuffers::BASE_TYPE_CHAR:
+        add_element<int8_t>(field, py::cast<int8_t>(value));
+        break;
+      case flatbuffers::BASE_TYPE_UCHAR:
+        add_element<uint8_t>(field, py::cast<uint8_t>(value));
+        break;
+      case flatbuffers::BASE_TYPE_SHORT:
+        add_element<int16_t>(field, py::cast<int16_t>(value));
+        break;
+      case flatbuffers::BASE_TYPE_USHORT:
+        add_element<uint16_t>(field, py::cast<uint16_t>(value));
+        break;
+      case flatbuffers::BASE_TYPE_INT:
+        add_element<int32_t>(field, py::cast<int32_t>(value));
+        break;
+      case flatbuffers::BASE_TYPE_UINT:
+        add_element<uint32_t>(field, py::cast<uint32_t>(value));
+        break;
+      case flatbuffers::BASE_TYPE_LONG:
+        add_element<int64_t>(field, py::cast<int64_t>(value));
+        break;
+      case flatbuffers::BASE_TYPE_ULONG:
+        add_element<uint64_t>(field, py::cast<uint64_t>(value));
+        break;
+      case flatbuffers::BASE_TYPE_FLOAT:
+        add_element<float>(field, py::cast<float>(value));
+        break;
+      case flatbuffers::BASE_TYPE_DOUBLE:
+        add_element<double>(field, py::cast<double>(value));
+        break;
+      default:
+        throw std::runtime_error(
+            "Unsupported scalar type in field " + field.name);
+    }
+  }
+
+  // Like flatc, leaves out values that match the schema default.
+  template <typename T>
+  void add_element(const flatbuffers::FieldDef& field, T value) {
+    T default_value = 0;
+    flatbuffers::StringToNumber(field.value.constant.c_str(), &default_value);
+    builder_.AddElement<T>(field.value.offset, value, default_value);
+  }
+
+  const flatbuffers::Parser& parser_;
+  flatbuffers::FlatBufferBuilder builder_;
+};
+
 } // namespace
 
 PYBIND11_MODULE(_bindings, m) {
@@ -96,6 +350,24 @@ PYBIND11_MODULE(_bindings, m) {
                 "--",
                 binPath.c_str()};
             return flatc.Compile(argv.size(), argv.data());
+          })
+      .def(
+          "dataclass_to_flatbuffer",
+          [](const std::string& schemaPath,
+             const std::string& includeDir,
+             py::handle root) {
+            std::string schema;
+            if (!flatbuffers::LoadFile(schemaPath.c_str(), false, &schema)) {
+              throw std::runtime_error("Cannot read schema " + schemaPath);
+            }
+            flatbuffers::Parser parser;
+            const char* include_paths[] = {includeDir.c_str(), nullptr};
+            if (!parser.Parse(
+                    schema.c_str(), include_paths, schemaPath.c_str())) {
+              throw std::runtime_error(
+                  "Cannot parse schema " + schemaPath + ": " + parser.error_);
+            }
+            return DataclassFlatbufferBuilder(parser).build(root);
           });
 }
 
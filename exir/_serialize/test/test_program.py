@@ -7,12 +7,23 @@
 
 import copy
 import difflib
+import io
 import json
 import unittest
+import zlib
 
 from typing import List, Sequence
 
-from executorch.exir._serialize._flatbuffer import _program_flatbuffer_to_json
+from executorch.exir._serialize._compression import (
+    compress_lz4_block,
+    decompress_lz4_block,
+)
+from executorch.exir._serialize._flatbuffer import (
+    _has_native_flatbuffer_builder,
+    _program_flatbuffer_to_json,
+    _program_json_to_flatbuffer,
+    _program_to_flatbuffer_native,
+)
 from executorch.exir._serialize._program import (
     _ExtendedHeader,
     _get_extended_header,
@@ -20,17 +31,20 @@ from executorch.exir._serialize._program import (
     _program_to_json,
     deserialize_pte_binary,
     serialize_pte_binary,
+    serialize_pte_binary_to_file,
 )
 
 from executorch.exir.schema import (
     BackendDelegate,
     BackendDelegateDataReference,
     BackendDelegateInlineData,
+    Buffer,
     ContainerMetadata,
     DataLocation,
     DataSegment,
     ExecutionPlan,
     Program,
+    SegmentCompression,
 )
 from executorch.exir.tests.common import get_test_program
 
@@ -430,6 +444,251 @@ class TestProgram(unittest.TestCase):
         program2 = deserialize_pte_binary(pte_data)
         self.assert_programs_equal(program, program2)
 
+    def test_round_trip_with_constant_segment(self) -> None:
+        # Create a program with some constant tensor data, plus a delegate
+        # blob so that the constants are not the only segment.
+        program = get_test_program()
+        constants = (
+            self.gen_blob_data(16, b"\x10\x11\x01"),
+            self.gen_blob_data(17, b"\x20\x22\x02"),
+            self.gen_blob_data(48, b"\x30\x33\x03"),
+        )
+        program.constant_buffer.extend(Buffer(storage=c) for c in constants)
+        add_delegate_data(
+            program,
+            program.execution_plan[0],
+            (self.gen_blob_data(16, b"\x40\x44\x04"),),
+        )
+
+        pte_data = serialize_pte_binary(
+            program,
+            extract_segments=True,
+            extract_constant_segment=True,
+            segment_alignment=SEGMENT_ALIGNMENT,
+            constant_tensor_alignment=32,
+        )
+
+        # The input Program should not have been modified.
+        self.assertEqual(len(program.constant_buffer), len(constants) + 1)
+        self.assertIsNone(program.constant_segment)
+
+        # The constants should have moved into the last segment, leaving the
+        # inline table empty.
+        eh = _get_extended_header(pte_data)
+        self.assertIsNotNone(eh)
+        program_with_segments = _json_to_program(_program_flatbuffer_to_json(pte_data))
+        self.assertEqual(program_with_segments.constant_buffer, [])
+        self.assertEqual(len(program_with_segments.segments), 2)
+        constant_segment = program_with_segments.constant_segment
+        self.assertIsNotNone(constant_segment)
+        self.assertEqual(constant_segment.segment_index, 1)
+        # Entry 0 is the placeholder for non-constant tensors, and each tensor
+        # starts on a 32-byte boundary.
+        self.assertEqual(constant_segment.offsets, [0, 0, 32, 64])
+
+        segment = program_with_segments.segments[1]
+        segment_data = pte_data[eh.segment_base_offset + segment.offset :]
+        for i, constant in enumerate(constants):
+            offset = constant_segment.offsets[i + 1]
+            self.assertEqual(segment_data[offset : offset + len(constant)], constant)
+
+        # Deserializing moves the constants back inline. Buffers keep the
+        # padding that followed them, which is all zeros.
+        program2 = deserialize_pte_binary(pte_data)
+        self.assertIsNone(program2.constant_segment)
+        self.assertEqual(len(program2.constant_buffer), len(constants) + 1)
+        self.assertEqual(program2.constant_buffer[0].storage, b"")
+        for constant, buffer in zip(constants, program2.constant_buffer[1:]):
+            self.assertEqual(buffer.storage[: len(constant)], constant)
+            self.assertEqual(buffer.storage[len(constant) :].strip(b"\x00"), b"")
+
+    def test_constant_segment_requires_extract_segments(self) -> None:
+        program = get_test_program()
+        program.constant_buffer.append(Buffer(storage=b"\x01\x02"))
+        with self.assertRaises(ValueError):
+            serialize_pte_binary(program, extract_constant_segment=True)
+
+    def test_serialize_to_file_matches_buffer(self) -> None:
+        program = get_test_program()
+        program.constant_buffer.extend(
+            Buffer(storage=self.gen_blob_data(n, b"\x10\x11\x01"))
+            for n in (16, 17, 48)
+        )
+        add_delegate_data(
+            program,
+            program.execution_plan[0],
+            (self.gen_blob_data(16, b"\x40\x44\x04"),),
+        )
+        for extract_segments in (False, True):
+            kwargs = {
+                "extract_segments": extract_segments,
+                "extract_constant_segment": extract_segments,
+                "segment_alignment": SEGMENT_ALIGNMENT,
+            }
+            out = io.BytesIO()
+            serialize_pte_binary_to_file(program, out, **kwargs)
+            self.assertEqual(out.getvalue(), serialize_pte_binary(program, **kwargs))
+
+    @unittest.skipUnless(
+        _has_native_flatbuffer_builder(), "native flatbuffer builder not built"
+    )
+    def test_native_flatbuffer_matches_json(self) -> None:
+        program = get_test_program()
+        program.constant_buffer.append(
+            Buffer(storage=self.gen_blob_data(33, b"\x10\x11\x01"))
+        )
+        add_delegate_data(program, program.execution_plan[0], (b"\x20\x21",))
+
+        native = _program_to_flatbuffer_native(program, constant_tensor_alignment=64)
+        from_json = _program_json_to_flatbuffer(
+            _program_to_json(program), constant_tensor_alignment=64
+        )
+        self.assertEqual(native.max_alignment, from_json.max_alignment)
+        # The layouts may differ, but both decode to the same program.
+        self.assert_programs_equal(
+            _json_to_program(_program_flatbuffer_to_json(native.data)), program
+        )
+        self.assert_programs_equal(
+            _json_to_program(_program_flatbuffer_to_json(from_json.data)), program
+        )
+
+    def test_round_trip_with_compressed_segments(self) -> None:
+        program = get_test_program()
+        blobs = (
+            # Compressible.
+            self.gen_blob_data(SEGMENT_ALIGNMENT + 1, b"\x10\x11\x01"),
+            # Too small to get smaller when compressed.
+            b"\x20\x21\x22",
+        )
+        add_delegate_data(program, program.execution_plan[0], blobs)
+
+        pte_data = serialize_pte_binary(
+            program,
+            extract_segments=True,
+            compress_delegate_segments=True,
+            segment_alignment=SEGMENT_ALIGNMENT,
+        )
+
+        eh = _get_extended_header(pte_data)
+        self.assertIsNotNone(eh)
+        program_with_segments = _json_to_program(_program_flatbuffer_to_json(pte_data))
+        segment_table: List[DataSegment] = program_with_segments.segments
+        self.assertEqual(len(segment_table), 2)
+
+        # The first segment holds an LZ4 block that decodes to the blob.
+        self.assertEqual(segment_table[0].compression, SegmentCompression.LZ4_BLOCK)
+        self.assertEqual(segment_table[0].uncompressed_size, len(blobs[0]))
+        self.assertLess(segment_table[0].size, len(blobs[0]))
+        start = eh.segment_base_offset + segment_table[0].offset
+        self.assertEqual(
+            decompress_lz4_block(
+                pte_data[start : start + segment_table[0].size], len(blobs[0])
+            ),
+            blobs[0],
+        )
+
+        # The second segment is stored as-is.
+        self.assertEqual(segment_table[1].compression, SegmentCompression.NONE)
+        self.assertEqual(segment_table[1].size, len(blobs[1]))
+
+        # Deserializing decompresses the segments.
+        program2 = deserialize_pte_binary(pte_data)
+        self.assert_programs_equal(program, program2)
+
+    def test_compressed_segments_require_extract_segments(self) -> None:
+        program = get_test_program()
+        with self.assertRaises(ValueError):
+            serialize_pte_binary(program, compress_delegate_segments=True)
+
+    def test_round_trip_with_program_checksum(self) -> None:
+        program = get_test_program()
+        add_delegate_data(program, program.execution_plan[0], (b"\x10\x11\x12",))
+
+        pte_data = serialize_pte_binary(
+            program,
+            extract_segments=True,
+            program_checksum=True,
+            segment_alignment=SEGMENT_ALIGNMENT,
+        )
+
+        # The checksum is the CRC-32 of the program data up to the segments,
+        # with the checksum field zeroed.
+        eh = _get_extended_header(pte_data)
+        self.assertIsNotNone(eh)
+        self.assertEqual(eh.length, _ExtendedHeader.LENGTH_WITH_CHECKSUM)
+        checksum_offset = 8 + _ExtendedHeader.EXPECTED_LENGTH
+        program_data = bytearray(pte_data[: eh.program_size])
+        program_data[checksum_offset : checksum_offset + 4] = b"\x00" * 4
+        self.assertEqual(eh.program_checksum, zlib.crc32(program_data))
+
+        # The checksum does not change the program.
+        program2 = deserialize_pte_binary(pte_data)
+        self.assert_programs_equal(program, program2)
+
+    def test_program_checksum_requires_extract_segments(self) -> None:
+        program = get_test_program()
+        with self.assertRaises(ValueError):
+            serialize_pte_binary(program, program_checksum=True)
+
+    def test_constant_tensor_alignment_recorded_in_header(self) -> None:
+        program = get_test_program()
+        program.constant_buffer.extend(
+            (
+                Buffer(storage=self.gen_blob_data(3, b"\x10\x11\x01")),
+                Buffer(storage=self.gen_blob_data(65, b"\x20\x22\x02")),
+            )
+        )
+        for extract_constant_segment in (False, True):
+            pte_data = serialize_pte_binary(
+                program,
+                extract_segments=True,
+                extract_constant_segment=extract_constant_segment,
+                segment_alignment=SEGMENT_ALIGNMENT,
+                constant_tensor_alignment=64,
+            )
+
+            # The alignment comes with a checksum.
+            eh = _get_extended_header(pte_data)
+            self.assertIsNotNone(eh)
+            self.assertEqual(eh.length, _ExtendedHeader.LENGTH_WITH_TENSOR_ALIGNMENT)
+            self.assertEqual(eh.tensor_alignment, 64)
+            self.assertIsNotNone(eh.program_checksum)
+
+            # Every constant starts on a 64-byte boundary of the file.
+            for constant in program.constant_buffer[1:]:
+                offset = pte_data.find(constant.storage)
+                self.assertGreater(offset, 0)
+                self.assertEqual(offset % 64, 0)
+
+    def test_constant_tensor_alignment_must_divide_segment_alignment(self) -> None:
+        program = get_test_program()
+        with self.assertRaises(ValueError):
+            serialize_pte_binary(
+                program,
+                extract_segments=True,
+                segment_alignment=32,
+                constant_tensor_alignment=64,
+            )
+
+    def test_lz4_block_round_trip(self) -> None:
+        for data in (
+            b"",
+            b"\x01",
+            bytes(range(256)) * 3,
+            self.gen_blob_data(1000, b"\x01\x02\x03"),
+            # Long literal runs and a match at the largest offset.
+            bytes(i * 7 % 251 for i in range(70000)) + bytes(range(64)) * 2,
+        ):
+            compressed = compress_lz4_block(data)
+            self.assertEqual(decompress_lz4_block(compressed, len(data)), data)
+
+        # Decoding checks the size and the match offsets.
+        with self.assertRaises(ValueError):
+            decompress_lz4_block(compress_lz4_block(b"\x00" * 100), 99)
+        with self.assertRaises(ValueError):
+            # A match that refers to data before the start of the block.
+            decompress_lz4_block(b"\x10\x41\x02\x00", 5)
+
     def test_unused_inline_delegate_blobs_with_segments(self) -> None:
         # Create a program with some delegate data blobs.
         program = get_test_program()
@@ -555,6 +814,67 @@ class TestExtendedHeader(unittest.TestCase):
         self.assertEqual(eh.program_size, EXAMPLE_PROGRAM_SIZE)
         self.assertEqual(eh.segment_base_offset, EXAMPLE_SEGMENT_BASE_OFFSET)
 
+    def test_to_bytes_with_program_checksum(self) -> None:
+        eh = _ExtendedHeader(
+            program_size=EXAMPLE_PROGRAM_SIZE,
+            segment_base_offset=EXAMPLE_SEGMENT_BASE_OFFSET,
+            program_checksum=0x44334433,
+        )
+        expected = (
+            # Magic bytes
+            b"eh00"
+            # uint32_t header size (little endian), now covering the checksum
+            + b"\x1c\x00\x00\x00"
+            + EXAMPLE_HEADER_DATA[8:]
+            # uint32_t program checksum
+            + b"\x33\x44\x33\x44"
+        )
+        self.assertEqual(eh.to_bytes(), expected)
+
+        eh2 = _ExtendedHeader.from_bytes(expected)
+        self.assertTrue(eh2.is_valid())
+        self.assertEqual(eh2.length, _ExtendedHeader.LENGTH_WITH_CHECKSUM)
+        self.assertEqual(eh2.program_checksum, 0x44334433)
+
+    def test_to_bytes_with_tensor_alignment(self) -> None:
+        eh = _ExtendedHeader(
+            program_size=EXAMPLE_PROGRAM_SIZE,
+            segment_base_offset=EXAMPLE_SEGMENT_BASE_OFFSET,
+            program_checksum=0x44334433,
+            tensor_alignment=64,
+        )
+        expected = (
+            # Magic bytes
+            b"eh00"
+            # uint32_t header size (little endian), covering both new fields
+            + b"\x20\x00\x00\x00"
+            + EXAMPLE_HEADER_DATA[8:]
+            # uint32_t program checksum
+            + b"\x33\x44\x33\x44"
+            # uint32_t tensor alignment
+            + b"\x40\x00\x00\x00"
+        )
+        self.assertEqual(eh.to_bytes(), expected)
+
+        eh2 = _ExtendedHeader.from_bytes(expected)
+        self.assertTrue(eh2.is_valid())
+        self.assertEqual(eh2.length, _ExtendedHeader.LENGTH_WITH_TENSOR_ALIGNMENT)
+        self.assertEqual(eh2.program_checksum, 0x44334433)
+        self.assertEqual(eh2.tensor_alignment, 64)
+
+    def test_tensor_alignment_requires_program_checksum(self) -> None:
+        eh = _ExtendedHeader(
+            program_size=EXAMPLE_PROGRAM_SIZE,
+            segment_base_offset=EXAMPLE_SEGMENT_BASE_OFFSET,
+            tensor_alignment=64,
+        )
+        with self.assertRaises(ValueError):
+            eh.to_bytes()
+
+    def test_from_bytes_without_program_checksum(self) -> None:
+        eh = _ExtendedHeader.from_bytes(EXAMPLE_HEADER_DATA)
+        self.assertIsNone(eh.program_checksum)
+
     def test_from_bytes_not_enough_data_fails(self) -> None:
         # Parsing a truncated prefix should fail.
         with self.assertRaises(ValueError):
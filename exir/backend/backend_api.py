@@ -124,6 +124,43 @@ def _(
     raise NotImplementedError(f"Backend {backend_id} was not found.")
 
 
+def add_alternative_lowering(
+    lowered_module: LoweredBackendModule,
+    backend_id: str,
+    compile_specs: List[CompileSpec],
+) -> LoweredBackendModule:
+    """
+    Lowers the original module of `lowered_module` to another backend, and
+    adds the result to its alternatives. The emitted program carries every
+    lowering of the partition, and the runtime loads the first one whose
+    backend is available on the device, or the one that a DelegateSelector
+    picks, e.g. the fastest one it measured.
+
+    To add an alternative to every partition of a program lowered with a
+    partitioner::
+
+        for _, lowered, _ in get_lowered_submodules(graph_module):
+            add_alternative_lowering(lowered, "XnnpackBackend", [])
+
+    Args:
+        lowered_module: The lowered partition.
+        backend_id: The backend to also lower it to.
+        compile_specs: The compile specs for that backend.
+
+    Returns:
+        LoweredBackendModule: The new alternative lowering.
+
+    Raises:
+        NotImplementedError: The backend was not found.
+        RuntimeError: The module cannot be processed by the backend.
+    """
+    alternative = to_backend(
+        backend_id, lowered_module.original_module, compile_specs
+    )
+    lowered_module.alternatives.append(alternative)
+    return alternative
+
+
 _ENABLE_VALIDATION: bool = True
 
 
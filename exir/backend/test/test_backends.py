@@ -10,7 +10,11 @@ from typing import Dict, List
 
 import executorch.exir as exir
 import torch
-from executorch.exir.backend.backend_api import LoweredBackendModule, to_backend
+from executorch.exir.backend.backend_api import (
+    add_alternative_lowering,
+    LoweredBackendModule,
+    to_backend,
+)
 from executorch.exir.backend.compile_spec_schema import CompileSpec
 from executorch.exir.backend.partitioner import (
     DelegationSpec,
@@ -851,6 +855,61 @@ class TestBackends(unittest.TestCase):
             torch.allclose(model_output[0], ref_output, atol=1e-03, rtol=1e-03),
         )
 
+    @vary_segments
+    def test_add_mul_partitioner_with_alternatives(self, extract_segments: bool):
+        class Model(torch.nn.Module):
+            def forward(self, a, x, b):
+                y = torch.mm(a, x)
+                z = y + b
+                a = z - a
+                y = torch.mm(a, x)
+                z = y + b
+                return z
+
+        m = Model()
+        inputs = (torch.randn(2, 2), torch.randn(2, 2), torch.randn(2, 2))
+
+        ep = exir.capture(m, inputs, exir.CaptureConfig()).to_edge()
+        executorch_prog = ep
+        executorch_prog.exported_program = to_backend(
+            ep.exported_program, AddMulPartitionerDemo
+        )
+        lowered_submodules = get_lowered_submodules(
+            executorch_prog.exported_program.graph_module
+        )
+        self.assertEqual(len(lowered_submodules), 2)
+        for _, lowered, _ in lowered_submodules:
+            alternative = add_alternative_lowering(lowered, QnnBackend.__name__, [])
+            self.assertEqual(lowered.alternatives, [alternative])
+
+        executorch_prog = executorch_prog.to_executorch(
+            config=exir.ExecutorchBackendConfig(extract_segments=extract_segments),
+        )
+
+        # Each partition is followed by its alternative lowering.
+        delegates = executorch_prog.program.execution_plan[0].delegates
+        self.assertEqual(
+            [delegate.id for delegate in delegates],
+            [
+                BackendWithCompilerDemo.__name__,
+                QnnBackend.__name__,
+                BackendWithCompilerDemo.__name__,
+                QnnBackend.__name__,
+            ],
+        )
+        self.assertEqual(delegates[0].alternatives, [1])
+        self.assertEqual(delegates[1].alternatives, None)
+        self.assertEqual(delegates[2].alternatives, [3])
+
+        # The runtime has no QnnBackend, so it loads the preferred lowerings.
+        executorch_module = _load_for_executorch_from_buffer(executorch_prog.buffer)
+        # pyre-fixme[16]: Module `pytree` has no attribute `tree_flatten`.
+        inputs_flattened, _ = tree_flatten(inputs)
+        model_output = executorch_module.run_method("forward", tuple(inputs_flattened))
+        self.assertTrue(
+            torch.allclose(model_output[0], m(*inputs), atol=1e-03, rtol=1e-03),
+        )
+
     @vary_segments
     def test_partitioner_with_attributes(self, extract_segments: bool):
         """
@@ -52,16 +52,84 @@ class ExecutorchBackendConfig:
     # This makes it possible to free those blobs at runtime.
     extract_segments: bool = False
 
+    # Whether to also move constant tensor data into a segment. The runtime
+    # then loads the constants a method uses when the method is loaded, rather
+    # than all of them along with the Program. Requires extract_segments.
+    extract_constant_segment: bool = False
+
+    # Whether to LZ4-compress delegate data segments. Shrinks the file, but the
+    # runtime then decompresses them into memory instead of mmap()ing them.
+    # Requires extract_segments.
+    compress_delegate_segments: bool = False
+
+    # Whether to add a CRC-32 of the program data to the extended header, so
+    # that the runtime can check the integrity of trusted programs with
+    # Program::Verification::Checksum instead of the full flatbuffer verifier.
+    # Requires extract_segments.
+    program_checksum: bool = False
+
     # When extracting segments, the starting offset of each segment will be
     # aligned to this value (in bytes). When using mmap() to load segments, this
     # should be a multiple of the OS page size.
     segment_alignment: int = 4096
 
+    # Whether to make every method that has memory-planned buffers report the
+    # same buffer sizes, so that the runtime can back all of them with one set
+    # of buffers. Only safe when the methods never run concurrently, and each
+    # method's execution overwrites the planned inputs and outputs of the
+    # others. Mutable buffers that several methods own are shared as well, and
+    # must be planned at the same location in each of them.
+    share_memory_planned_buffers: bool = False
+
     # If provided, the minimum alignment of tensor buffers in the program. Must
-    # be a power of 2. If not provided, uses the value in the schema file.
+    # be a power of 2. If not provided, uses the value in the schema file. With
+    # extract_segments, the alignment is also recorded in the extended header,
+    # and Program::load() fails unless the DataLoader preserves it, so kernels
+    # and delegates can rely on it. segment_alignment must then be a multiple
+    # of it.
     constant_tensor_alignment: Optional[int] = None
 
     # If provided, the minimum alignment of delegate data in the program. Must
     # be a power of 2. If not provided, uses the value in the schema file.
     delegate_alignment: Optional[int] = None
     sym_shape_eval_pass: PassType = HintBasedSymShapeEvalPass()
+
+    # Whether to replace view-like copy ops (view_copy, squeeze_copy,
+    # unsqueeze_copy, alias_copy and detach_copy) with views that share the
+    # memory planned for their input, instead of copying it.
+    remove_view_copy: bool = False
+
+    # How to fold the quantization of constant weights, so that it doesn't run
+    # on every inference. "float" folds quantize -> dequantize over a weight
+    # into a float weight, for graphs that run on float kernels. "quantized"
+    # runs QuantFusionPass first and keeps the weights quantized, which keeps
+    # the program small and uses quantized kernels. None disables folding.
+    weight_quant_folding: Optional[str] = "float"
+
+    # Whether to fold inference batch norms into the constant weights and bias
+    # of the convolution, addmm or mm that feeds them, so that they cost
+    # nothing at runtime. Batch norms that can't be folded stay standalone ops.
+    fold_batch_norm: bool = True
+
+    # Whether to fuse chains of float elementwise ops, such as mul -> add ->
+    # relu, into executorch_prim::fused_elementwise ops, so that their
+    # intermediate results never go through memory. The runtime must be built
+    # with the optimized kernels, which implement the fused op.
+    fuse_elementwise_ops: bool = False
+
+    # Whether to replace the decompositions of Llama's RMSNorm and rotary
+    # embeddings with the executorch_prim::rms_norm and executorch_prim::rope
+    # ops. The runtime must be built with the optimized kernels, which
+    # implement them.
+    fuse_rms_norm_and_rope: bool = False
+
+    # Whether to run convolutions, pooling, batch norm and the elementwise ops
+    # between them in the channels last dim order, converting to and from it
+    # only at the boundaries of such regions.
+    channels_last_propagation: bool = False
+
+    # Whether to reorder independent ops so that fewer intermediate tensors are
+    # live at once, before memory planning. Lowers the arena size of wide
+    # networks, such as Inception, whose traced order runs all branches of a
+    # block before any of them is consumed.
+    schedule_for_memory: bool = False
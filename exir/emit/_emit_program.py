@@ -162,12 +162,18 @@ def emit_program(
 
     # emit each entry point in order according to name.
     for name, exported_program in sorted(methods.items()):
-        if (
+        mutated_placeholders = [
+            node
+            for node in exported_program.graph.nodes
+            if node.op == "placeholder" and "mutable_buffer" in node.meta
+        ]
+        if len(mutated_placeholders) != len(
             exported_program.graph_signature.buffers_to_mutate
-        ):  # see if we are mutating any state
+        ):  # mutable buffers are only supported through memory planning
             raise ExportError(
                 ExportErrorType.INVALID_INPUT_TYPE,
-                "Buffers cannot be modified in executorch.",
+                "Buffers can only be modified in executorch when they are tagged as mutable "
+                "buffers before memory planning, as to_executorch() does.",
             )
         # create empty state
         emitter_state = _EmitterState(
@@ -185,10 +191,6 @@ def emit_program(
         emitter.run()
         plans.append(emitter.plan())
 
-        # update list length for future constant deduplication checks
-        emitter.program_state.cached_spec_list_length = len(
-            program_state.allocated_specs
-        )
         debug_handle_map[name] = emitter.debug_handle_map
         method_to_delegate_debug_id_map[
             name
@@ -29,6 +29,7 @@ their instructions.
 
 # pyre-strict
 import ctypes
+import hashlib
 import operator
 import typing
 from dataclasses import dataclass, field
@@ -38,6 +39,7 @@ import executorch.exir.memory as memory
 import executorch.extension.pytree as ex_pytree
 import torch
 import torch.fx
+from executorch.exir.control_flow import while_loop as exir_while
 from executorch.exir.delegate import executorch_call_delegate, is_lowered_module
 from executorch.exir.dialects.backend._ops import BackendOpOverload
 from executorch.exir.dialects.edge._ops import EdgeOpOverload
@@ -66,7 +68,10 @@ from executorch.exir.schema import (
     IntList,
     JumpFalseCall,
     KernelCall,
+    MapBegin,
+    MapEnd,
     MoveCall,
+    NamedConstant,
     Null,
     Operator,
     OptionalTensorList,
@@ -75,6 +80,8 @@ from executorch.exir.schema import (
     Tensor,
     TensorList,
     TensorShapeDynamism,
+    WhileBegin,
+    WhileEnd,
 )
 from executorch.exir.tensor import (
     layout_enum,
@@ -101,13 +108,9 @@ class _ProgramState:
     emitted.
     """
 
-    # Parallel list of specs and the buffers that backed them, have to add + 1 to any index in here
-    # as index 0 in the constant_buffer is reserved.
-    allocated_specs: List[TensorSpec] = field(default_factory=list)
-    # Weights in any arbitrary graph_module only need to compare against weights from previously
-    # emitted graph modules, not any weights emitted from itself. set to len(allocated_specs) after
-    # every method emission.
-    cached_spec_list_length: int = 0
+    # The index in constant_buffer of the first buffer with each SHA-256 digest of its data, so that
+    # identical constants of all methods share one buffer.
+    constant_buffer_indices: Dict[bytes, int] = field(default_factory=dict)
     # The 0 index is reserved to be pointed to by non-constant tensors, so add an empty placeholder.
     constant_buffer: List[Buffer] = field(default_factory=lambda: [Buffer(storage=b"")])
     # Delegate data stored directly in the flatbuffer. Pointed to by BackendDelegateDataReference,
@@ -128,7 +131,7 @@ class _EmitterState:
     delegates: List[BackendDelegate]
     num_values: int
     operator_cache: Dict[Tuple[str, str], int]
-    delegate_cache: Dict[bytes, int]
+    delegate_cache: Dict[Tuple[bytes, ...], int]
     emit_stacktrace: bool
 
     spec2id_dict: Dict[TensorSpec, int] = field(default_factory=dict)
@@ -347,78 +350,41 @@ class _Emitter(torch.fx.Interpreter):
             # For non-constant tensors, constant_buffer = 0.
             return EValue(make_tensor_value(0, allocation_info, spec))
 
-        def _get_buffer_idx(spec: TensorSpec, program_state: _ProgramState) -> int:
-            """Determines where in the program state the constant buffer corresponding to spec is
-            located.
-
-            Returns the index into the constant buffers list if this spec has been previously
-            allocated, -1 if unseen before. O(N^2) as for every tensor we have to compare it against
-            every tensor previously allocated. Could improve this to O(N) if we hashed the weights.
-            """
-            for i in range(0, program_state.cached_spec_list_length):
-                other_spec = program_state.allocated_specs[i]
+        # For constant tensors, allocation_info = None.
+        return EValue(make_tensor_value(self._constant_buffer_idx(spec), None, spec))
 
-                # Check for an empty buffer, special cased to avoid nullptr in buffer check.
-                if spec.allocated_memory == 0 and other_spec.allocated_memory == 0:
-                    return i + 1
+    def _constant_buffer_idx(self, spec: TensorSpec) -> int:
+        """Returns the index of the constant buffer holding the data of spec, adding it to the
+        program's constant buffers unless a byte-identical one is already there.
 
-                # compare meta data
-                if (
-                    spec.scalar_type == other_spec.scalar_type
-                    and spec.shape == other_spec.shape
-                    and spec.dim_order == other_spec.dim_order
-                    and typing.cast(torch.UntypedStorage, spec.storage).nbytes()
-                    == typing.cast(torch.UntypedStorage, other_spec.storage).nbytes()
-                ):
-                    spec_array_type = (
-                        ctypes.c_char
-                        * typing.cast(torch.UntypedStorage, spec.storage).nbytes()
-                    )
-                    other_spec_array_type = (
-                        ctypes.c_char
-                        * typing.cast(torch.UntypedStorage, other_spec.storage).nbytes()
-                    )
-                    # compare data
-                    if bytes(
-                        ctypes.cast(
-                            typing.cast(torch.UntypedStorage, spec.storage).data_ptr(),
-                            ctypes.POINTER(spec_array_type),
-                        ).contents
-                    ) == bytes(
-                        ctypes.cast(
-                            typing.cast(
-                                torch.UntypedStorage, other_spec.storage
-                            ).data_ptr(),
-                            ctypes.POINTER(other_spec_array_type),
-                        ).contents
-                    ):
-                        return i + 1  # +1 because the first buffer location is reserved
-            return -1
-
-        buffer_idx = _get_buffer_idx(spec, self.program_state)
-
-        # Haven't seen this constant before
-        if buffer_idx == -1:
-            if spec.allocated_memory == 0:
-                buffer = Buffer(storage=b"")
-            else:
-                array_type = (
-                    ctypes.c_char
-                    * typing.cast(torch.UntypedStorage, spec.storage).nbytes()
-                )
-                spec_array = ctypes.cast(
-                    typing.cast(torch.UntypedStorage, spec.storage).data_ptr(),
-                    ctypes.POINTER(array_type),
-                ).contents
-                buffer = Buffer(storage=bytes(spec_array))
+        Buffers are shared by content across all methods of the program, and within a method, e.g.
+        between tied weights or between zero-initialized biases of the same size. They hold raw
+        bytes, so tensors of different dtypes or shapes may share one as well.
+        """
+        if spec.allocated_memory == 0:
+            data = b""
+        else:
+            storage = typing.cast(torch.UntypedStorage, spec.storage)
+            array_type = ctypes.c_char * storage.nbytes()
+            data = bytes(
+                ctypes.cast(storage.data_ptr(), ctypes.POINTER(array_type)).contents
+            )
 
-            # Update buffer_idx to point to the end of the list where we are adding the new buffer.
-            buffer_idx = len(self.program_state.constant_buffer)
-            self.program_state.allocated_specs.append(spec)
-            self.program_state.constant_buffer.append(buffer)
+        program_state = self.program_state
+        digest = hashlib.sha256(data).digest()
+        buffer_idx = program_state.constant_buffer_indices.get(digest)
+        # Compare the data too, so that a hash collision can't alias two constants.
+        if (
+            buffer_idx is not None
+            and program_state.constant_buffer[buffer_idx].storage == data
+        ):
+            return buffer_idx
 
-        # For constant tensors, allocation_info = None.
-        return EValue(make_tensor_value(buffer_idx, None, spec))
+        # Haven't seen this constant before.
+        buffer_idx = len(program_state.constant_buffer)
+        program_state.constant_buffer.append(Buffer(storage=data))
+        program_state.constant_buffer_indices.setdefault(digest, buffer_idx)
+        return buffer_idx
 
     def _get_list_tuple_jit_type(
         self, val: Union[Tuple[_Argument], List[_Argument]]
@@ -649,6 +615,100 @@ class _Emitter(torch.fx.Interpreter):
     ) -> List[_AbstractValue]:
         """Emits torch.map.
 
+        Converts the higher order op into a MapBegin instruction, the instructions of the map
+        submodule, and a MapEnd instruction that jumps back to the MapBegin. Each iteration, the
+        MapBegin points the submodule's input placeholder at the next row of the mapped tensor, and
+        the submodule's output at the next row of the map output, so the submodule reads and writes
+        the rows in place:
+
+            0: MapBegin(x, placeholder, map_out, add_tensor, iter_idx, end_instruction=3)
+            1: aten::add.out(placeholder, arg1_1, add_tensor)
+            2: MapEnd(iter_idx, begin_instruction=0)
+
+        A submodule that returns one of its inputs has no output that can be pointed at a row, and
+        is emitted as a loop of copies instead; see _emit_map_with_copies.
+        """
+        assert isinstance(
+            subemitter_binding_output_values, list
+        ), f"Expect a list for subemitter_binding_output_values for map. Got {subemitter_binding_output_values}."
+
+        if len(subemitter_binding_output_values) != 1:
+            raise RuntimeError(
+                f"Multiple outputs are not supported. Got {len(subemitter_binding_output_values)}."
+            )
+        f, num_mapped_args = args[:2]
+        if num_mapped_args != 1:
+            raise RuntimeError(
+                f"Emitting map with more than one mapped args is not supported. Got {num_mapped_args}."
+            )
+        x, *inputs = args[2:]
+        assert isinstance(f, torch.fx.GraphModule)
+
+        output_node = next(iter(reversed(f.graph.nodes)))
+        if any(
+            isinstance(out, torch.fx.Node) and out.op in ("placeholder", "get_attr")
+            for out in pytree.tree_flatten(output_node.args[0])[0]
+        ):
+            return self._emit_map_with_copies(args, subemitter_binding_output_values)
+
+        # Counts the iterations done. MapBegin resets it once all rows are done, so that the method
+        # can run again.
+        iter_idx = self._emit_evalue(EValue(Int(0)))
+        # The input placeholder and output of the submodule aren't allocated EValue ids until the
+        # map emitter is run, and the end of the loop isn't known until then either, so they are
+        # -1 until then.
+        map_begin = MapBegin(
+            input_index=x.id,
+            slice_index=-1,
+            output_index=subemitter_binding_output_values[0].id,
+            body_output_index=-1,
+            iter_index=iter_idx.id,
+            end_instruction=-1,
+        )
+        begin_instruction = self.instruction_start_offset + len(self.chain.instructions)
+        self.chain.instructions.append(Instruction(map_begin))
+
+        map_emitter = _Emitter(
+            f,
+            self.emitter_state,
+            self.program_state,
+            instruction_start_offset=begin_instruction + 1,
+            # Only the first input is a placeholder, rest of the inputs are args to the map fn.
+            binding_input_values=[-1, *inputs],
+            binding_output_values=subemitter_binding_output_values,
+        )
+        map_emitter.run()
+
+        self._merge_chain(map_emitter.chain)
+        # Get rid of the move of the submodule output into the map output; MapBegin makes the
+        # submodule write it in place.
+        self.chain.instructions.pop()
+
+        self._internal_assert_emitter(
+            len(map_emitter.concrete_output_ids) == 1,
+            self.node,
+            "Map should return only one element",
+        )
+        map_begin.slice_index = map_emitter.binding_input_values[0].id
+        map_begin.body_output_index = map_emitter.concrete_output_ids[0].id
+
+        self.chain.instructions.append(
+            Instruction(
+                MapEnd(iter_index=iter_idx.id, begin_instruction=begin_instruction)
+            )
+        )
+        map_begin.end_instruction = self.instruction_start_offset + len(
+            self.chain.instructions
+        )
+        return subemitter_binding_output_values
+
+    def _emit_map_with_copies(
+        self,
+        args: Tuple[_Argument, ...],
+        subemitter_binding_output_values: List[_AbstractValue],
+    ) -> List[_AbstractValue]:
+        """Emits torch.map as a loop of copies.
+
         Converts the higher order op into a loop constructed from jump instructions and primitive
         int operations. A concat-like custom op is also injected into the submodule code to handle
         the construction of the map output.
@@ -679,20 +739,7 @@ class _Emitter(torch.fx.Interpreter):
             done_bool) # Emitter inserts a instruction here, if done_bool == False jump to
             selcect_copy op # if not continue. return add_tensor
         """
-        assert isinstance(
-            subemitter_binding_output_values, list
-        ), f"Expect a list for subemitter_binding_output_values for map. Got {subemitter_binding_output_values}."
-
-        if len(subemitter_binding_output_values) != 1:
-            raise RuntimeError(
-                f"Multiple outputs are not supported. Got {len(subemitter_binding_output_values)}."
-            )
-        f, num_mapped_args = args[:2]
-        if num_mapped_args != 1:
-            raise RuntimeError(
-                f"Emitting map with more than one mapped args is not supported. Got {num_mapped_args}."
-            )
-        x, *inputs = args[2:]
+        f, _, x, *inputs = args
         assert isinstance(f, torch.fx.GraphModule)
 
         # Generate the EValue that we will use as our iterator index to keep track of which
@@ -850,12 +897,130 @@ class _Emitter(torch.fx.Interpreter):
 
         return subemitter_binding_output_values
 
+    def _emit_while(
+        self,
+        args: Tuple[_Argument, ...],
+        subemitter_binding_output_values: List[_AbstractValue],
+    ) -> List[_AbstractValue]:
+        """Emits control_flow.while_loop.
+
+        The outputs of the while node hold the loop-carried state, which both submodules read. The
+        general emitted structure is:
+
+            <WhileBegin> - copies the initial values into the state the first time, and after that
+                swaps the state with the body outputs by pointer
+            <Cond>
+            <Jump Instruction> - jumps to the WhileEnd once the cond is false
+            <Body> - writes the next state into its own outputs
+            <Jump Instruction> - jumps back to the WhileBegin
+            <WhileEnd> - moves the final state back into the state's own buffers if needed
+
+        Each loop-carried tensor is thus double buffered between the state and the body output, and
+        is not copied between iterations.
+        """
+        cond_fn, body_fn, init = args
+        assert isinstance(cond_fn, torch.fx.GraphModule)
+        assert isinstance(body_fn, torch.fx.GraphModule)
+        state, _ = pytree.tree_flatten(subemitter_binding_output_values)
+        init_values, _ = pytree.tree_flatten(init)
+
+        # A body output is swapped with its state every iteration, so it must have a buffer of its
+        # own: it can only be a new tensor, or the state it replaces passed through unchanged.
+        body_output_node = next(iter(reversed(body_fn.graph.nodes)))
+        placeholders = [n for n in body_fn.graph.nodes if n.op == "placeholder"]
+        for i, out in enumerate(pytree.tree_flatten(body_output_node.args[0])[0]):
+            if not isinstance(out, torch.fx.Node):
+                continue
+            if (
+                out.op == "get_attr"
+                or (out.op == "placeholder" and placeholders.index(out) != i)
+                or out.target == memory.view
+            ):
+                raise InternalError(
+                    self._emit_node_specific_error(
+                        self.node,
+                        f"Output {i} of the while_loop body aliases another tensor. Clone it in "
+                        "the body so that it has a buffer of its own.",
+                    )
+                )
+
+        # Counts the iterations started. WhileEnd resets it, so that the method can run again.
+        iter_idx = self._emit_evalue(EValue(Int(0)))
+        while_begin = WhileBegin(
+            init_indices=[v.id for v in init_values],
+            state_indices=[v.id for v in state],
+            body_output_indices=[],
+            iter_index=iter_idx.id,
+        )
+        begin_instruction = self.instruction_start_offset + len(self.chain.instructions)
+        self.chain.instructions.append(Instruction(while_begin))
+
+        cond_emitter = _Emitter(
+            cond_fn,
+            self.emitter_state,
+            self.program_state,
+            instruction_start_offset=begin_instruction + 1,
+            binding_input_values=state,
+        )
+        cond_emitter.run()
+        self._merge_chain(cond_emitter.chain)
+        self._internal_assert_emitter(
+            len(cond_emitter.concrete_output_ids) == 1,
+            self.node,
+            "The while_loop cond should return only one element",
+        )
+        jf_instruction_to_exit = JumpFalseCall(
+            cond_value_index=cond_emitter.concrete_output_ids[0].id,
+            destination_instruction=-1,
+        )
+        self.chain.instructions.append(Instruction(jf_instruction_to_exit))
+
+        # The body writes into its own outputs rather than moving them into the state; WhileBegin
+        # swaps them in.
+        body_emitter = _Emitter(
+            body_fn,
+            self.emitter_state,
+            self.program_state,
+            instruction_start_offset=self.instruction_start_offset
+            + len(self.chain.instructions),
+            binding_input_values=state,
+        )
+        body_emitter.run()
+        self._merge_chain(body_emitter.chain)
+        self._internal_assert_emitter(
+            len(body_emitter.concrete_output_ids) == len(state),
+            self.node,
+            "The while_loop body should return one value per loop-carried value",
+        )
+        while_begin.body_output_indices = [
+            v.id for v in body_emitter.concrete_output_ids
+        ]
+
+        # We bake in constant False to make this an unconditional jump back to the WhileBegin.
+        value = self._emit_evalue(EValue(Bool(False)))
+        self.chain.instructions.append(
+            Instruction(
+                JumpFalseCall(
+                    cond_value_index=value.id,
+                    destination_instruction=begin_instruction,
+                )
+            )
+        )
+        jf_instruction_to_exit.destination_instruction = (
+            self.instruction_start_offset + len(self.chain.instructions)
+        )
+        self.chain.instructions.append(
+            Instruction(WhileEnd(begin_instruction=begin_instruction))
+        )
+        return subemitter_binding_output_values
+
     def _emit_control_flow(
         self, target: _Target, args: Tuple[_Argument, ...], kwargs: Dict[str, _Argument]
     ) -> _EmitterValue:
         """Wraps common logic for emitting all control flow operations.
 
-        See the more specific emission functions for more details on how cond or map get emitted.
+        See the more specific emission functions for more details on how cond, map or while get
+        emitted.
         """
         subemitter_binding_output_values = pytree.tree_map(
             lambda spec: self._emit_spec(spec),
@@ -866,6 +1031,8 @@ class _Emitter(torch.fx.Interpreter):
             return self._emit_cond(args, subemitter_binding_output_values)
         elif target is map_impl:
             return self._emit_map(args, subemitter_binding_output_values)
+        elif target is exir_while:
+            return self._emit_while(args, subemitter_binding_output_values)
         else:
             raise InternalError(
                 self._emit_node_specific_error(
@@ -936,6 +1103,25 @@ class _Emitter(torch.fx.Interpreter):
             return arg
         return self._emit_evalue(self._constant_to_evalue(arg, arg_type))
 
+    def _emit_backend_delegate(
+        self, lowered_module: "LoweredBackendModule"  # noqa
+    ) -> BackendDelegate:
+        """Adds the blob of a lowered module to the program, and returns the
+        BackendDelegate that refers to it."""
+        # Allocate an entry for the data. TODO(T150113674): Reuse any duplicate entries if
+        # present.
+        data_index: int = len(self.program_state.backend_delegate_data)
+        self.program_state.backend_delegate_data.append(
+            BackendDelegateInlineData(data=lowered_module.processed_bytes)
+        )
+        return BackendDelegate(
+            id=lowered_module.backend_id,
+            processed=BackendDelegateDataReference(
+                location=DataLocation.INLINE, index=data_index
+            ),
+            compile_specs=lowered_module.compile_specs,
+        )
+
     def _emit_delegate(
         self,
         lowered_module: "LoweredBackendModule",  # noqa
@@ -945,27 +1131,31 @@ class _Emitter(torch.fx.Interpreter):
         """Emit the delegates inputs and outputs as specified by the schema, then emit the
         delegate's blob."""
         processed_bytes = lowered_module.processed_bytes
+        # A lowering with alternatives is only shared with calls that have the
+        # same alternatives.
+        cache_key = (processed_bytes,) + tuple(
+            alternative.processed_bytes for alternative in lowered_module.alternatives
+        )
 
-        delegate_index = self.emitter_state.delegate_cache.get(processed_bytes)
+        delegate_index = self.emitter_state.delegate_cache.get(cache_key)
         delegate_ret = self._emit_spec(self.node.meta["spec"])
         if delegate_index is None:
-            # Allocate an entry for the data. TODO(T150113674): Reuse any duplicate entries if
-            # present.
-            data_index: int = len(self.program_state.backend_delegate_data)
-            self.program_state.backend_delegate_data.append(
-                BackendDelegateInlineData(data=processed_bytes)
-            )
-
-            backend_delegate = BackendDelegate(
-                id=lowered_module.backend_id,
-                processed=BackendDelegateDataReference(
-                    location=DataLocation.INLINE, index=data_index
-                ),
-                compile_specs=lowered_module.compile_specs,
-            )
-            delegate_index = len(self.emitter_state.delegate_cache)
+            backend_delegate = self._emit_backend_delegate(lowered_module)
+            delegate_index = len(self.emitter_state.delegates)
             self.emitter_state.delegates.append(backend_delegate)
-            self.emitter_state.delegate_cache[processed_bytes] = delegate_index
+            self.emitter_state.delegate_cache[cache_key] = delegate_index
+            if lowered_module.alternatives:
+                # The alternatives follow the lowering that they can replace.
+                # They are not cached, since the runtime does not call them
+                # directly.
+                backend_delegate.alternatives = []
+                for alternative in lowered_module.alternatives:
+                    backend_delegate.alternatives.append(
+                        len(self.emitter_state.delegates)
+                    )
+                    self.emitter_state.delegates.append(
+                        self._emit_backend_delegate(alternative)
+                    )
 
         # TODO(angelayi) Will need to emit the kwargs too, in the correct order according to the
         # function's spec and with default arguments. This requires us to store the function's spec
@@ -1118,6 +1308,35 @@ class _Emitter(torch.fx.Interpreter):
         # The value is not used but the caller expects an AbstractValue returned.
         return _AbstractValue(None, None)  # pyre-ignore
 
+    def _emit_view(self, args: Tuple[_Argument, ...]) -> _EmitterValue:
+        """Emits a call to executorch_prim::et_view, which makes the output alias the storage
+        of the input instead of copying it."""
+        assert len(args) == 2
+
+        self_arg = self._emit_argument(args[0], torch.TensorType)  # pyre-ignore
+        size_arg = self._emit_argument(args[1], torch.ListType.ofInts())
+        out_arg = self._emit_spec(self.node.meta["spec"])
+
+        op_index, _ = self._get_operator(
+            name="executorch_prim::et_view",
+            overload="default",
+        )
+        self.chain.instructions.append(
+            Instruction(
+                KernelCall(
+                    op_index=op_index,
+                    args=[self_arg.id, size_arg.id, out_arg.id],  # pyre-ignore
+                )
+            )
+        )
+        if self.emitter_state.emit_stacktrace:
+            chain_stacktrace = self.chain.stacktrace or []
+            chain_stacktrace.append(
+                _stacktrace_to_framelist(self.node.meta["stack_trace"])
+            )
+            self.chain.stacktrace = chain_stacktrace
+        return out_arg
+
     def fetch_attr(self, target: _Target) -> _AbstractValue:
         """Fetch weights and other module parameters. If the attribute is a tensor, emit it."""
         attr = super().fetch_attr(target)
@@ -1232,12 +1451,18 @@ class _Emitter(torch.fx.Interpreter):
             # pyre-ignore
             return self._emit_free(args[0])
 
+        elif target == memory.view:
+            return self._emit_view(args)
+
         elif target is torch.ops.higher_order.cond:
             return self._emit_control_flow(target, args, kwargs)
 
         elif target is map_impl:
             return self._emit_control_flow(target, args, kwargs)
 
+        elif target is exir_while:
+            return self._emit_control_flow(target, args, kwargs)
+
         elif target == executorch_call_delegate:
             lowered_module = args[0]
             assert is_lowered_module(lowered_module)
@@ -1306,6 +1531,8 @@ class _TopLevelEmitter(_Emitter):
 
         self.inputs: List[int] = []
         self.outputs: List[int] = []
+        # The parameters and buffers of the module, by their fully qualified names.
+        self.named_constants: List[NamedConstant] = []
 
         def create_container_str(spec: Optional[pytree.TreeSpec]) -> str:
             if spec is None:
@@ -1335,6 +1562,15 @@ class _TopLevelEmitter(_Emitter):
         """
         spec = self.node.meta["spec"]
         const_tensor = False
+        if "mutable_buffer" in self.node.meta:
+            # Mutable buffers keep the storage that memory planning gave them, and the constant
+            # buffer holds their initial value, which the runtime copies in when loading the method.
+            fqn = self.exported_program.graph_signature.inputs_to_buffers[target]
+            evalue = self._tensor_spec_to_evalue(spec)
+            evalue.val.constant_buffer_idx = self._constant_buffer_idx(
+                TensorSpec.from_tensor(self.exported_program.state_dict[fqn], const=True)
+            )
+            return self._emit_evalue(evalue)
         if isinstance(target, str) and (
             target in self.exported_program.graph_signature.inputs_to_parameters
             or target in self.exported_program.graph_signature.inputs_to_buffers
@@ -1357,6 +1593,8 @@ class _TopLevelEmitter(_Emitter):
         value = self._emit_evalue(evalue)
         if not const_tensor:
             self.inputs.append(value.id)
+        else:
+            self.named_constants.append(NamedConstant(name=fqn, value_index=value.id))
 
         return value
 
@@ -1371,7 +1609,10 @@ class _TopLevelEmitter(_Emitter):
         if isinstance(args_tuple, _AbstractValue):
             self.outputs.append(args_tuple.id)
         else:
-            for arg in args_tuple:
+            # The new values of mutated buffers come first; they were written in place and are
+            # not outputs of the method.
+            num_mutated = len(self.exported_program.graph_signature.buffers_to_mutate)
+            for arg in args_tuple[num_mutated:]:
                 # Every output should already have its value emitted outputs should only be abstract
                 # IDs at this point.
                 assert isinstance(arg, _AbstractValue)
@@ -1394,4 +1635,5 @@ class _TopLevelEmitter(_Emitter):
                 List[int], self.module.meta["non_const_buffer_sizes"]
             ),
             container_meta_type=self.container_meta_type,
+            named_constants=self.named_constants,
         )
@@ -11,6 +11,7 @@ import unittest
 from typing import List, Optional, Tuple
 
 import executorch.exir as exir
+import executorch.exir.control_flow as exir_control_flow
 
 import executorch.exir.schema as schema
 import executorch.exir.tests.models as models
@@ -32,11 +33,15 @@ from executorch.exir.schema import (
     JumpFalseCall,
     KernelCall,
     KernelTypes,
+    MapBegin,
+    MapEnd,
     MoveCall,
     Null,
     Program,
     String,
     Tensor,
+    WhileBegin,
+    WhileEnd,
 )
 from executorch.exir.tests.common import register_additional_test_aten_ops
 from executorch.exir.tests.models import MLP, Mul
@@ -713,62 +718,114 @@ class TestEmit(unittest.TestCase):
         )
         program = module.to_executorch().program
 
+        instructions = program.execution_plan[0].chains[0].instructions
+        # The map program is a MapBegin, the body, and a MapEnd that jumps back to the MapBegin.
+        # The MapBegin points the body's placeholder at a row of x and the body's output at a row
+        # of the map output, so there are no copies.
+        map_begin = instructions[0].instr_args
+        self.assertIsInstance(map_begin, MapBegin)
+        self.assertEqual(map_begin.input_index, program.execution_plan[0].inputs[0])
+        self.assertEqual(map_begin.output_index, program.execution_plan[0].outputs[0])
+        self.assertEqual(map_begin.end_instruction, len(instructions))
+        map_end = instructions[-1].instr_args
+        self.assertIsInstance(map_end, MapEnd)
+        self.assertEqual(map_end.begin_instruction, 0)
+        self.assertEqual(map_end.iter_index, map_begin.iter_index)
+
         op_table = program.execution_plan[0].operators
-        # The first two operators at the beginning of a map program should be sym_size
-        # and select_copy, which is what we verify here. The first operator is to generate
-        # the number of iterations and the second operator is to slice the input tensor to
-        # generate the tensor on which this iteration will operate on.
-        self.assertEqual(
-            op_table[
-                program.execution_plan[0].chains[0].instructions[0].instr_args.op_index
-            ].name,
-            "aten::sym_size",
-        )
-        self.assertEqual(
-            op_table[
-                program.execution_plan[0].chains[0].instructions[1].instr_args.op_index
-            ].name,
-            "aten::select_copy",
-        )
+        body = instructions[1:-1]
+        self.assertEqual(len(body), 1)
+        self.assertEqual(op_table[body[0].instr_args.op_index].name, "aten::add")
+        self.assertEqual(body[0].instr_args.args[0], map_begin.slice_index)
+        self.assertEqual(body[0].instr_args.args[-1], map_begin.body_output_index)
 
-        # The last three instructions in the map sub-program are:
-        # - Calling the custom op to append the output of this iteration to the accumulator tensor
-        # - Increment the iteration count.
-        # - Then checking if we've completed all the iterations.
-        # We check here that both of these have been generated.
-        self.assertEqual(
-            op_table[
-                program.execution_plan[0].chains[0].instructions[-5].instr_args.op_index
-            ].name,
-            "executorch_prim::et_copy_index",
+    def _capture_while(
+        self,
+        loop_body: typing.Callable[
+            [torch.Tensor, torch.Tensor], Tuple[torch.Tensor, torch.Tensor]
+        ],
+    ) -> exir.ExirExportedProgram:
+        inputs = (torch.zeros([1], dtype=torch.long), torch.tensor([3]))
+
+        def f(accum: torch.Tensor, cnt: torch.Tensor) -> Tuple[torch.Tensor, ...]:
+            @exir_control_flow.tracing_context(inputs=inputs)
+            def loop_cond(accum: torch.Tensor, cnt: torch.Tensor) -> torch.Tensor:
+                return cnt > torch.zeros([1], dtype=torch.long)
+
+            return exir_control_flow.while_loop(
+                loop_cond,
+                exir_control_flow.tracing_context(inputs=inputs)(loop_body),
+                (accum, cnt),
+            )
+
+        # exir's while_loop is only traced by the dispatch tracer.
+        return exir._capture_legacy_do_not_use(f, inputs).to_edge(
+            exir.EdgeCompileConfig(_check_ir_validity=False)
         )
-        self.assertEqual(
-            op_table[
-                program.execution_plan[0].chains[0].instructions[-4].instr_args.op_index
-            ].name,
-            "executorch_prim::add",
+
+    def test_emit_while(self) -> None:
+        def loop_body(
+            accum: torch.Tensor, cnt: torch.Tensor
+        ) -> Tuple[torch.Tensor, torch.Tensor]:
+            return accum + cnt, cnt - torch.ones([1], dtype=torch.long)
+
+        program = self._capture_while(loop_body).to_executorch().program
+        plan = program.execution_plan[0]
+        instructions = plan.chains[0].instructions
+
+        # The while program is a WhileBegin, the cond, a jump to the WhileEnd, the body, and a jump
+        # back to the WhileBegin. The body writes into its own outputs, which the WhileBegin swaps
+        # with the state, so there are no moves.
+        while_begin = instructions[0].instr_args
+        self.assertIsInstance(while_begin, WhileBegin)
+        self.assertEqual(while_begin.init_indices, plan.inputs)
+        self.assertEqual(while_begin.state_indices, plan.outputs)
+        self.assertEqual(len(while_begin.body_output_indices), 2)
+        self.assertTrue(
+            set(while_begin.body_output_indices).isdisjoint(while_begin.state_indices)
         )
+        self.assertIsInstance(plan.values[while_begin.iter_index].val, Int)
+        while_end = instructions[-1].instr_args
+        self.assertIsInstance(while_end, WhileEnd)
+        self.assertEqual(while_end.begin_instruction, 0)
+
+        jumps = [
+            (i, instr.instr_args)
+            for i, instr in enumerate(instructions)
+            if isinstance(instr.instr_args, JumpFalseCall)
+        ]
+        self.assertEqual(len(jumps), 2)
+        (exit_idx, exit_jump), (back_idx, back_jump) = jumps
+        self.assertEqual(exit_jump.destination_instruction, len(instructions) - 1)
+        self.assertEqual(back_idx, len(instructions) - 2)
+        self.assertEqual(back_jump.destination_instruction, 0)
+        self.assertEqual(plan.values[back_jump.cond_value_index].val, Bool(False))
+
+        op_table = plan.operators
+        cond = instructions[1:exit_idx]
+        self.assertTrue(all(isinstance(i.instr_args, KernelCall) for i in cond))
+        body = instructions[exit_idx + 1 : back_idx]
         self.assertEqual(
-            op_table[
-                program.execution_plan[0].chains[0].instructions[-3].instr_args.op_index
-            ].name,
-            "executorch_prim::eq",
-        )
-        # The last two instructions in the overall program check if we should jump back to the
-        # beginning of the loop and then resets the iteration counter if we fall through.
-        self.assertTrue(
-            isinstance(
-                program.execution_plan[0].chains[0].instructions[-2].instr_args,
-                JumpFalseCall,
-            )
+            [op_table[instr.instr_args.op_index].name for instr in body],
+            ["aten::add", "aten::sub"],
         )
         self.assertEqual(
-            op_table[
-                program.execution_plan[0].chains[0].instructions[-1].instr_args.op_index
-            ].name,
-            "executorch_prim::sub",
+            [instr.instr_args.args[-1] for instr in body],
+            while_begin.body_output_indices,
         )
 
+    def test_emit_while_rejects_aliased_body_output(self) -> None:
+        # Passing cnt through as the first output would make it share a buffer with the second
+        # state.
+        def loop_body(
+            accum: torch.Tensor, cnt: torch.Tensor
+        ) -> Tuple[torch.Tensor, torch.Tensor]:
+            return cnt, accum - torch.ones([1], dtype=torch.long)
+
+        edge = self._capture_while(loop_body)
+        with self.assertRaises(InternalError):
+            edge.to_executorch()
+
     def test_dim_order(self) -> None:
         class SimpleLinear(torch.nn.Module):
             def __init__(self) -> None:
@@ -988,6 +1045,57 @@ class TestEmit(unittest.TestCase):
             merged_program.execution_plan[1], program_sigmoid.program.execution_plan[0]
         )
 
+    def test_emit_identical_constants_share_buffer(self) -> None:
+        class TwoBiases(torch.nn.Module):
+            def __init__(self) -> None:
+                super().__init__()
+                self.first = torch.nn.Linear(5, 5)
+                self.second = torch.nn.Linear(5, 5)
+                torch.nn.init.zeros_(self.first.bias)
+                torch.nn.init.zeros_(self.second.bias)
+                self.register_buffer("offset", torch.zeros(5))
+
+            def forward(self, x: torch.Tensor) -> torch.Tensor:
+                return self.second(self.first(x)) + self.offset
+
+        program = (
+            exir.capture(TwoBiases(), (torch.ones(10, 5),), exir.CaptureConfig())
+            .to_edge(exir.EdgeCompileConfig(_check_ir_validity=False))
+            .to_executorch()
+            .program
+        )
+        # reserved spot, the two weights, and the zeros that both biases and the offset
+        # share
+        self.assertEqual(len(program.constant_buffer), 4)
+
+    def test_emit_named_constants(self) -> None:
+        class SimpleLinear(torch.nn.Module):
+            def __init__(self) -> None:
+                super().__init__()
+                self.linear = torch.nn.Linear(5, 5)
+
+            def forward(self, x: torch.Tensor) -> torch.Tensor:
+                return self.linear(x)
+
+        program = (
+            exir.capture(SimpleLinear(), (torch.ones(10, 5),), exir.CaptureConfig())
+            .to_edge(exir.EdgeCompileConfig(_check_ir_validity=False))
+            .to_executorch()
+            .program
+        )
+        plan = program.execution_plan[0]
+        named_constants = {
+            constant.name: constant.value_index for constant in plan.named_constants
+        }
+        self.assertEqual(
+            set(named_constants.keys()), {"linear.weight", "linear.bias"}
+        )
+        for value_index in named_constants.values():
+            tensor = plan.values[value_index].val
+            self.assertIsInstance(tensor, Tensor)
+            self.assertGreater(tensor.constant_buffer_idx, 0)
+            self.assertNotIn(value_index, plan.inputs)
+
     def test_emit_execution_plans_sorted(self) -> None:
         class Simple(torch.nn.Module):
             def __init__(self) -> None:
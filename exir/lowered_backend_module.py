@@ -57,6 +57,8 @@ class LoweredBackendModule(torch.nn.Module):
         CompileSpec
     ]  # A list of backend-specific objects with static metadata to configure the "compilation" process.
     _original_module: ExportedProgram  # The original EXIR module
+    # Other lowerings of the same module, which the runtime may use instead.
+    _alternatives: List["LoweredBackendModule"]
 
     def __init__(
         self,
@@ -70,6 +72,7 @@ class LoweredBackendModule(torch.nn.Module):
         self._backend_id = backend_id
         self._processed_bytes = processed_bytes
         self._compile_specs = compile_specs
+        self._alternatives = []
 
     @property
     def backend_id(self) -> str:
@@ -99,6 +102,16 @@ class LoweredBackendModule(torch.nn.Module):
         """
         return self._original_module
 
+    @property
+    def alternatives(self) -> List["LoweredBackendModule"]:
+        """
+        Returns other lowerings of the original module, in order of preference
+        after this one. The program carries all of them, and the runtime loads
+        the first one whose backend is available, or the one that its
+        DelegateSelector picks.
+        """
+        return self._alternatives
+
     # TODO(chenlai): consolidate the seriailization config with serialize_to_flatbuffer api
     def buffer(
         self,
@@ -33,6 +33,16 @@ def alloc(spec: AllocSpec) -> pytree.PyTree:
     return torch.empty(shape, dtype=dtype)
 
 
+def view(base: torch.Tensor, size: List[int]) -> torch.Tensor:
+    """
+    Returns `base` with the given size, sharing its storage. This is the target
+    of the call_function nodes that replace view-like *_copy ops; memory
+    planning places the result at the same offset as `base`, and the emitter
+    turns it into a call to executorch_prim::et_view.
+    """
+    return base.view(size)
+
+
 def free(spec: TensorSpec) -> None:
     """
     The function is nop. The major purpose is to put it in the Fx IR.
@@ -12,7 +12,7 @@ import operator
 import typing
 from collections import defaultdict
 from dataclasses import dataclass
-from typing import Any, Callable, Dict, Iterable, List, Set, Tuple, Union
+from typing import Any, Callable, Dict, Iterable, List, Optional, Set, Tuple, Union
 
 import torch
 from executorch.exir import memory
@@ -25,13 +25,13 @@ from executorch.exir.error import (
     InternalError,
 )
 from executorch.exir.operator.convert import is_out_variant
-from executorch.exir.schema import TensorShapeDynamism
+from executorch.exir.schema import Program, TensorShapeDynamism
 from executorch.exir.tensor import TensorSpec
 
 from functorch.experimental._map import map_impl
 from torch import fx
 from torch.fx import Node
-from torch.utils._pytree import tree_flatten
+from torch.utils._pytree import tree_flatten, tree_map
 
 REGISTERED_ALGOS: Dict[str, Callable[..., List[int]]] = {}
 
@@ -171,10 +171,17 @@ class Verifier:
             node.op for node in graph_module.graph.nodes
         }
         assert "output" in check_list, f"graph module has no output: {graph_module}"
+        # Mutable buffers are always allocated, as the method's state.
+        mutable_buffer_specs = get_mutable_buffer_specs(graph_module.graph.nodes)
 
         for nd in graph_module.graph.nodes:
             if nd.op in check_list:
-                if not (specs := get_node_tensor_specs(nd)):
+                specs = [
+                    spec
+                    for spec in get_node_tensor_specs(nd)
+                    if spec not in mutable_buffer_specs
+                ]
+                if not specs:
                     continue
                 assert len(specs) > 0, "Expect tensor specs"
                 allocated = any(
@@ -229,6 +236,43 @@ def _is_out_var_node(node: torch.fx.Node) -> bool:
     )
 
 
+def _is_view_node(node: torch.fx.Node) -> bool:
+    return node.op == "call_function" and node.target == memory.view
+
+
+def _is_in_place_alloc_node(node: torch.fx.Node) -> bool:
+    return (
+        node.op == "call_function"
+        and node.target == memory.alloc
+        and "in_place_of" in node.meta
+    )
+
+
+def _is_alias_node(node: torch.fx.Node) -> bool:
+    r"""
+    Return whether the node's output lives in the storage of another node's
+    instead of getting its own.
+    """
+    return _is_view_node(node) or _is_in_place_alloc_node(node)
+
+
+def _get_alias_base(node: Node) -> Node:
+    """
+    Return the node that owns the storage aliased by a (possibly nested) view
+    or in-place allocation. Out-variant ops are followed to their out
+    allocation, since they return the tensor they were given.
+    """
+    while True:
+        if _is_view_node(node):
+            node = typing.cast(Node, node.args[0])
+        elif _is_in_place_alloc_node(node):
+            node = typing.cast(Node, node.meta["in_place_of"])
+        elif _is_out_var_node(node) and isinstance(node.kwargs.get("out"), Node):
+            node = typing.cast(Node, node.kwargs["out"])
+        else:
+            return node
+
+
 def update_tensor_lifetime(spec: TensorSpec, node_idx: int) -> None:
     r"""
     Update the lifetime of the tensor to cover node_idx. A tensor's lifetime
@@ -253,10 +297,28 @@ def filter_nodes(inputs: Iterable[Any]) -> Iterable[Node]:
     return [nd for nd in tree_flatten(list(inputs))[0] if isinstance(nd, Node)]
 
 
+def _is_mutable_buffer(node: Node) -> bool:
+    return node.op == "placeholder" and "mutable_buffer" in node.meta
+
+
+def get_mutable_buffer_specs(nodes: Iterable[Node]) -> Set[TensorSpec]:
+    r"""
+    Return the specs of the buffers that the graph mutates. They are graph
+    inputs and outputs only in the functional graph; at runtime they are state
+    that the method owns.
+    """
+    return {
+        spec
+        for node in nodes
+        if _is_mutable_buffer(node)
+        for spec in get_node_tensor_specs(node)
+    }
+
+
 def get_graph_input_tensors(nodes: Iterable[Node]) -> Set[TensorSpec]:
     graph_input_tensors = set()
     for node in nodes:
-        if node.op == "placeholder":
+        if node.op == "placeholder" and not _is_mutable_buffer(node):
             for spec in get_node_tensor_specs(node):
                 graph_input_tensors.add(spec)
 
@@ -270,7 +332,7 @@ def get_graph_output_tensors(nodes: Iterable[Node]) -> Set[TensorSpec]:
             for spec in get_node_tensor_specs(node):
                 graph_output_tensors.add(spec)
 
-    return graph_output_tensors
+    return graph_output_tensors - get_mutable_buffer_specs(nodes)
 
 
 def collect_specs_from_nodes(  # noqa: C901
@@ -282,6 +344,7 @@ def collect_specs_from_nodes(  # noqa: C901
     dedup: bool = True,
     do_assertion: bool = True,
     ignore_dynamic_unbound_tensor: bool = True,
+    ignore_view_node: bool = True,
 ) -> Iterable[TensorSpec]:
     r"""
     Collect specs from the passed in nodes. Do filtering as controlled by
@@ -292,6 +355,9 @@ def collect_specs_from_nodes(  # noqa: C901
         ignore_out_var_node: whether to ignore out variant node
         dedup: whether do dedup
         do_assertion: whether to assert the filtered nodes belong to a resticted set like alloc, getitem
+        ignore_view_node: whether to ignore the outputs of memory.view and of
+            allocations planned in place of an input, which share the storage
+            of their base instead of getting their own
     """
     unique_spec = set()
     graph_input_tensors: Set[TensorSpec] = (
@@ -311,6 +377,9 @@ def collect_specs_from_nodes(  # noqa: C901
         if ignore_out_var_node and _is_out_var_node(node):
             continue
 
+        if ignore_view_node and _is_alias_node(node):
+            continue
+
         if not (specs := get_node_tensor_specs(node)):
             continue
 
@@ -320,6 +389,7 @@ def collect_specs_from_nodes(  # noqa: C901
                 or node.target
                 in [
                     memory.alloc,
+                    memory.view,
                     operator.getitem,
                     torch.ops.higher_order.cond,
                     exir_while,
@@ -370,12 +440,43 @@ def update_all_tensors_lifetime(graph_module: torch.fx.GraphModule) -> Set[Tenso
             dedup=False,
             do_assertion=False,
             ignore_dynamic_unbound_tensor=False,
+            ignore_view_node=False,
         ):
             update_tensor_lifetime(spec, node_idx)
             specs.add(spec)
     return specs
 
 
+def update_alias_bases_lifetime(graph_module: torch.fx.GraphModule) -> None:
+    r"""
+    Extend the lifetime of the base of each view or in-place allocation to
+    cover the alias's, since the alias lives in the base's storage.
+    """
+    for node in graph_module.graph.nodes:
+        if not _is_alias_node(node):
+            continue
+        base_spec = _get_alias_base(node).meta["spec"]
+        for node_idx in node.meta["spec"].lifetime:
+            if node_idx is not None:
+                update_tensor_lifetime(base_spec, node_idx)
+
+
+def share_alias_storage(graph_module: torch.fx.GraphModule) -> None:
+    r"""
+    Place each view or in-place allocation at the memory planned for its base.
+    A view of a base that memory planning left unallocated (e.g. a graph input
+    provided by the user) stays unallocated too; the runtime points it at the
+    base's data.
+    """
+    for node in graph_module.graph.nodes:
+        if not _is_alias_node(node):
+            continue
+        base_spec = _get_alias_base(node).meta["spec"]
+        spec = node.meta["spec"]
+        spec.mem_id = base_spec.mem_id
+        spec.mem_offset = base_spec.mem_offset
+
+
 @dataclass
 class SharedObject:
     r"""
@@ -546,6 +647,311 @@ def naive(
     return bufsizes
 
 
+def _input_mem_buffer_size(graph_module: torch.fx.GraphModule, mem_id: int) -> int:
+    r"""
+    Return the number of bytes of buffer mem_id that were already allocated
+    before planning graph_module (e.g. by the outer module of a submodule).
+    """
+    bufsizes = getattr(graph_module, "input_mem_buffer_sizes", None)
+    if bufsizes and len(bufsizes) > mem_id:
+        return bufsizes[mem_id]
+    return 0
+
+
+def _place_best_fit(specs: List[TensorSpec], base_offset: int) -> int:
+    r"""
+    Assign mem_offset for each spec, all of which belong to the same memory
+    buffer, and return the size of the buffer.
+
+    Tensors are placed from largest to smallest. Each one goes into the
+    smallest gap, between tensors already placed whose lifetimes overlap its
+    own, that can hold it; or after the last of those tensors if no gap is
+    large enough.
+    """
+    placed: List[TensorSpec] = []
+    total_size = base_offset
+    for spec in sorted(specs, key=lambda s: (-s.allocated_memory, s.lifetime[0])):
+        live = sorted(
+            (other for other in placed if Verifier.lifetime_overlap(spec, other)),
+            key=lambda s: s.mem_offset,
+        )
+        best_offset = None
+        best_gap = None
+        offset = base_offset
+        for other in live:
+            gap = other.mem_offset - offset
+            if gap >= spec.allocated_memory and (best_gap is None or gap < best_gap):
+                best_offset = offset
+                best_gap = gap
+            offset = max(offset, other.mem_offset + other.allocated_memory)
+        spec.mem_offset = best_offset if best_offset is not None else offset
+        placed.append(spec)
+        total_size = max(total_size, spec.mem_offset + spec.allocated_memory)
+    return total_size
+
+
+@register_algo
+def best_fit(
+    graph_module: torch.fx.GraphModule,
+    alignment: int,
+    alloc_graph_input: bool = True,
+    alloc_graph_output: bool = True,
+) -> List[int]:
+    r"""
+    Plan each tensor at an explicit offset instead of grouping tensors into
+    shared objects like greedy does, so that a large tensor's memory can be
+    split between several smaller tensors that are live at the same time.
+    """
+    specs_by_mem_id: Dict[int, List[TensorSpec]] = defaultdict(list)
+    do_assertion = not getattr(graph_module, "encounter_to_out_var_failure", False)
+    for spec in collect_specs_from_nodes(
+        graph_module.graph.nodes,
+        do_assertion=do_assertion,
+        ignore_graph_input=not alloc_graph_input,
+        ignore_graph_output=not alloc_graph_output,
+    ):
+        if spec.mem_id is None:
+            spec.mem_id = 1
+        spec.realign(alignment)
+        specs_by_mem_id[spec.mem_id].append(spec)
+
+    if len(specs_by_mem_id) == 0:
+        # Be consistent with the default behavior of naive.
+        total_sizes = [0, 0]
+    else:
+        total_sizes = [0] * (max(specs_by_mem_id.keys()) + 1)
+        for mem_id, specs in specs_by_mem_id.items():
+            total_sizes[mem_id] = _place_best_fit(
+                specs, _input_mem_buffer_size(graph_module, mem_id)
+            )
+
+    logging.debug(f"best_fit algorithm returns bufsizes: {total_sizes}")
+    return total_sizes
+
+
+@register_algo
+def smallest(
+    graph_module: torch.fx.GraphModule,
+    alignment: int,
+    alloc_graph_input: bool = True,
+    alloc_graph_output: bool = True,
+) -> List[int]:
+    r"""
+    Run both greedy and best_fit and keep the plan with the smaller total
+    buffer size. Neither algorithm is better than the other for every graph.
+    """
+    candidates = [greedy, best_fit]
+    totals = []
+    for algo in candidates:
+        bufsizes = algo(graph_module, alignment, alloc_graph_input, alloc_graph_output)
+        totals.append(sum(bufsizes))
+    best = totals.index(min(totals))
+    if best != len(candidates) - 1:
+        # The specs hold the last candidate's plan; redo the best one.
+        bufsizes = candidates[best](
+            graph_module, alignment, alloc_graph_input, alloc_graph_output
+        )
+    logging.debug(
+        f"smallest algorithm picks {candidates[best].__name__}, bufsizes: {bufsizes}"
+    )
+    return bufsizes
+
+
+@dataclass
+class MemoryTier:
+    r"""
+    A memory buffer that tiered memory planning may place tensors in.
+    """
+
+    # The buffer's mem_id, i.e. its index in the HierarchicalAllocator.
+    mem_id: int
+    # The most bytes the buffer can hold, or None if it is unbounded.
+    capacity: Optional[int] = None
+
+
+def _tensor_access_counts(graph_module: torch.fx.GraphModule) -> Dict[TensorSpec, int]:
+    r"""
+    Count, for each tensor, the nodes that take it as an argument, including
+    the out-variant ops that write it.
+    """
+    counts: Dict[TensorSpec, int] = defaultdict(int)
+    for node in graph_module.graph.nodes:
+        for arg in filter_nodes(itertools.chain(node.args, node.kwargs.values())):
+            for spec in get_node_tensor_specs(arg):
+                if spec is not None:
+                    counts[spec] += 1
+    return counts
+
+
+def plan_memory_tiers(
+    graph_module: torch.fx.GraphModule,
+    alignment: int,
+    alloc_graph_input: bool = True,
+    alloc_graph_output: bool = True,
+    *,
+    algo: Callable[..., List[int]],
+    tiers: List[MemoryTier],
+    is_hot: Optional[Callable[[Node], bool]] = None,
+) -> List[int]:
+    r"""
+    Spread the tensors that don't have a mem_id yet across `tiers`, ordered
+    from fastest to slowest, then plan each buffer with `algo`.
+
+    Tensors are ranked by how often nodes access them per byte, so small,
+    frequently accessed tensors stay in the fast tiers. Every tensor starts
+    in the fastest tier; while a tier's planned size exceeds its capacity,
+    its lowest-ranked tensors move to the next tier and the graph is planned
+    again. Tensors whose producing node is not accepted by `is_hot` go
+    straight to the slowest tier, which should be unbounded.
+    """
+    internal_assert(len(tiers) > 0, "Tiered memory planning needs a tier")
+    access_counts = _tensor_access_counts(graph_module)
+    producers: Dict[TensorSpec, Node] = {}
+    for node in graph_module.graph.nodes:
+        for spec in get_node_tensor_specs(node):
+            if spec is not None:
+                producers.setdefault(spec, node)
+
+    # Tensors whose tier is still to be decided, most valuable first.
+    candidates = [
+        spec
+        for spec in collect_specs_from_nodes(
+            graph_module.graph.nodes,
+            do_assertion=False,
+            ignore_graph_input=not alloc_graph_input,
+            ignore_graph_output=not alloc_graph_output,
+        )
+        if spec.mem_id is None
+    ]
+    for spec in candidates:
+        spec.realign(alignment)
+
+    def rank(spec: TensorSpec) -> float:
+        return access_counts[spec] / max(spec.allocated_memory, 1)
+
+    candidates.sort(key=rank, reverse=True)
+    tier_specs: List[List[TensorSpec]] = [[] for _ in tiers]
+    for spec in candidates:
+        if is_hot is None or is_hot(producers[spec]):
+            tier_specs[0].append(spec)
+        else:
+            tier_specs[-1].append(spec)
+
+    while True:
+        for tier, specs in zip(tiers, tier_specs):
+            for spec in specs:
+                spec.mem_id = tier.mem_id
+        bufsizes = algo(graph_module, alignment, alloc_graph_input, alloc_graph_output)
+
+        overflow = None
+        for tier_idx, tier in enumerate(tiers):
+            size = bufsizes[tier.mem_id] if tier.mem_id < len(bufsizes) else 0
+            if tier.capacity is not None and size > tier.capacity:
+                overflow = (tier_idx, size - tier.capacity)
+                break
+        if overflow is None:
+            return bufsizes
+
+        tier_idx, excess = overflow
+        if tier_idx == len(tiers) - 1 or len(tier_specs[tier_idx]) == 0:
+            raise ExportError(
+                ExportErrorType.VIOLATION_OF_SPEC,
+                f"Memory tier {tiers[tier_idx].mem_id} needs {excess} bytes "
+                + "more than its capacity and has no slower tier to spill to",
+            )
+        # Move the lowest-ranked tensors until at least `excess` bytes have
+        # left the tier. Storage reuse means this may not free enough, in
+        # which case the next iteration moves more.
+        moved = 0
+        while moved < excess and len(tier_specs[tier_idx]) > 0:
+            spec = tier_specs[tier_idx].pop()
+            tier_specs[tier_idx + 1].append(spec)
+            moved += spec.allocated_memory
+        tier_specs[tier_idx + 1].sort(key=rank, reverse=True)
+
+
+def get_buffer_size_lower_bounds(
+    graph_module: torch.fx.GraphModule,
+    alloc_graph_input: bool = True,
+    alloc_graph_output: bool = True,
+) -> List[int]:
+    r"""
+    Return, for each mem_id, the largest total size of the planned tensors
+    that are live at the same time. No plan for graph_module can use smaller
+    buffers, so comparing this with the planned sizes shows how much memory
+    fragmentation costs. Must be called after memory planning has assigned a
+    mem_id to each spec.
+    """
+    # For each mem_id, the change in live bytes at each node index.
+    deltas: Dict[int, Dict[int, int]] = defaultdict(lambda: defaultdict(int))
+    for spec in collect_specs_from_nodes(
+        graph_module.graph.nodes,
+        do_assertion=False,
+        ignore_graph_input=not alloc_graph_input,
+        ignore_graph_output=not alloc_graph_output,
+    ):
+        start, end = spec.lifetime
+        if spec.mem_id is None or start is None or end is None:
+            continue
+        deltas[spec.mem_id][start] += spec.allocated_memory
+        deltas[spec.mem_id][end + 1] -= spec.allocated_memory
+
+    num_buffers = max(deltas.keys()) + 1 if deltas else 2
+    lower_bounds = [0] * num_buffers
+    for mem_id, mem_deltas in deltas.items():
+        live = 0
+        peak = 0
+        for node_idx in sorted(mem_deltas.keys()):
+            live += mem_deltas[node_idx]
+            peak = max(peak, live)
+        lower_bounds[mem_id] = _input_mem_buffer_size(graph_module, mem_id) + peak
+    return lower_bounds
+
+
+def format_memory_planning_report(
+    bufsizes: List[int], lower_bounds: List[int]
+) -> str:
+    r"""
+    Describe, for each mem_id with planned memory, how the planned buffer size
+    compares with the lower bound from get_buffer_size_lower_bounds().
+    """
+    lines = []
+    for mem_id, size in enumerate(bufsizes):
+        if size == 0:
+            continue
+        bound = lower_bounds[mem_id] if mem_id < len(lower_bounds) else 0
+        lines.append(
+            f"mem_id {mem_id}: planned {size} bytes, lower bound {bound} bytes "
+            f"({size - bound} bytes over, {100.0 * bound / size:.1f}% efficient)"
+        )
+    return "\n".join(lines)
+
+
+def share_memory_planned_buffers(program: Program) -> None:
+    r"""
+    Give every method of the program that has memory-planned buffers the same
+    buffer sizes: for each mem_id, the largest size that any of them needs.
+
+    Each method's plan already starts at offset 0 of each buffer, so this
+    lets the runtime back all of the methods with a single set of buffers,
+    sized from any one method's MethodMeta. Methods that share buffers must
+    not execute concurrently, and each execution clobbers the planned
+    inputs and outputs of the others.
+    """
+    plans = [
+        plan for plan in program.execution_plan if any(plan.non_const_buffer_sizes)
+    ]
+    shared_sizes: List[int] = []
+    for plan in plans:
+        sizes = plan.non_const_buffer_sizes
+        if len(sizes) > len(shared_sizes):
+            shared_sizes.extend([0] * (len(sizes) - len(shared_sizes)))
+        for mem_id, size in enumerate(sizes):
+            shared_sizes[mem_id] = max(shared_sizes[mem_id], size)
+    for plan in plans:
+        plan.non_const_buffer_sizes = list(shared_sizes)
+
+
 def get_algo(algo_name: str) -> Callable[..., List[int]]:
     if algo_name not in REGISTERED_ALGOS:
         raise ExportError(
@@ -634,15 +1040,180 @@ def insert_calls_to_free(
     graph_module.recompile()
 
 
+# Elementwise out-variant ops whose portable kernels compute each element of
+# `out` only from the same element of `self` (and of other arguments that are
+# not aliased), so `out` may share `self`'s storage when the two have the same
+# sizes and dtype.
+_IN_PLACE_SAFE_OPS = {
+    "aten::abs",
+    "aten::add",
+    "aten::ceil",
+    "aten::clamp",
+    "aten::cos",
+    "aten::div",
+    "aten::exp",
+    "aten::floor",
+    "aten::gelu",
+    "aten::hardtanh",
+    "aten::log",
+    "aten::mul",
+    "aten::neg",
+    "aten::reciprocal",
+    "aten::relu",
+    "aten::rsqrt",
+    "aten::sigmoid",
+    "aten::sin",
+    "aten::sqrt",
+    "aten::sub",
+    "aten::tanh",
+}
+
+
+def _is_static_contiguous(spec: TensorSpec) -> bool:
+    return spec.is_static_shape_tensor and list(spec.dim_order) == list(
+        range(len(spec.shape))
+    )
+
+
+def plan_mutable_buffers(
+    graph_module: torch.fx.GraphModule, mem_id: Optional[int] = None
+) -> int:
+    r"""
+    Give each mutable buffer, a placeholder tagged with the index of the graph
+    output holding its new value in meta["mutable_buffer"], a single tensor
+    spec shared by the placeholder and the out-variant op that computes that
+    value. The op then updates the buffer in place, and since the spec lives
+    from the first node to the output, no other tensor reuses its storage and
+    the value persists across executions of the method.
+
+    If mem_id is given, the buffers are placed in that memory buffer rather
+    than with the other tensors. Must run after the ToOutVarPass and before
+    the alloc nodes' specs are set. Returns the number of mutable buffers.
+    """
+    nodes = list(graph_module.graph.nodes)
+    node_idx = {node: idx for idx, node in enumerate(nodes)}
+    output_node = nodes[-1]
+    outputs = tree_flatten(output_node.args[0])[0]
+    num_mutable_buffers = 0
+    for node in nodes:
+        if not _is_mutable_buffer(node):
+            continue
+        spec = node.meta["spec"]
+        result = outputs[node.meta["mutable_buffer"]]
+        if mem_id is not None:
+            spec.mem_id = mem_id
+        num_mutable_buffers += 1
+        if result is node:
+            continue
+        out_node = result.kwargs.get("out") if _is_out_var_node(result) else None
+        if not isinstance(out_node, Node) or out_node.target != memory.alloc:
+            raise ExportError(
+                ExportErrorType.NOT_SUPPORTED,
+                f"The new value of mutable buffer {node.name} must be computed by "
+                f"an out-variant op to update it in place, got {result}",
+            )
+        # The update overwrites the old value, so nothing may read it later.
+        readers = list(node.users)
+        while readers:
+            reader = readers.pop()
+            if _is_view_node(reader):
+                readers.extend(reader.users)
+            elif reader is not output_node and node_idx[reader] > node_idx[result]:
+                raise ExportError(
+                    ExportErrorType.NOT_SUPPORTED,
+                    f"Mutable buffer {node.name} is read by {reader} after it is "
+                    f"updated by {result}",
+                )
+        old_spec = result.meta["spec"]
+        result.meta["spec"] = spec
+        output_node.meta["spec"] = tree_map(
+            lambda s: spec if s is old_spec else s, output_node.meta["spec"]
+        )
+    return num_mutable_buffers
+
+
+def plan_in_place_ops(graph_module: torch.fx.GraphModule) -> int:
+    r"""
+    Let elementwise ops write their output into the storage of their `self`
+    argument when nothing reads `self` afterwards, by marking the output's
+    allocation node as an alias of `self`'s storage. Memory planning then
+    skips the output, and share_alias_storage() places it at `self`'s
+    offset.
+
+    Must run after the tensors' lifetimes have been computed. Returns the
+    number of ops that will run in place.
+    """
+    graph_output_specs = get_graph_output_tensors(graph_module.graph.nodes)
+    num_in_place = 0
+    for node_idx, node in enumerate(graph_module.graph.nodes):
+        if not _is_out_var_node(node):
+            continue
+        if node.target._schema.name not in _IN_PLACE_SAFE_OPS:
+            continue
+        out_node = node.kwargs.get("out")
+        self_node = node.args[0] if len(node.args) > 0 else node.kwargs.get("self")
+        if not isinstance(out_node, Node) or not isinstance(self_node, Node):
+            continue
+        if out_node.target != memory.alloc or _is_in_place_alloc_node(out_node):
+            continue
+        base_node = _get_alias_base(self_node)
+        # The storage of graph inputs may be provided by the caller.
+        if base_node.op != "call_function" or base_node.target != memory.alloc:
+            continue
+        out_spec = out_node.meta.get("spec")
+        self_spec = self_node.meta.get("spec")
+        base_spec = base_node.meta.get("spec")
+        if not all(
+            isinstance(spec, TensorSpec) for spec in (out_spec, self_spec, base_spec)
+        ):
+            continue
+        if (
+            out_spec in graph_output_specs
+            or base_spec.const
+            or not _is_static_contiguous(out_spec)
+            or not _is_static_contiguous(self_spec)
+            or out_spec.dtype != self_spec.dtype
+            or list(out_spec.shape) != list(self_spec.shape)
+            or out_spec.mem_id not in (None, base_spec.mem_id)
+        ):
+            continue
+        # Only reuse the storage if no later node reads it, including
+        # through other aliases, and no other argument of this node reads it
+        # with a different shape.
+        if base_spec.lifetime[1] != node_idx:
+            continue
+        other_args = filter_nodes(
+            itertools.chain(
+                node.args[1:] if len(node.args) > 0 else [],
+                (v for k, v in node.kwargs.items() if k not in ("self", "out")),
+            )
+        )
+        if any(
+            arg is not self_node and _get_alias_base(arg) is base_node
+            for arg in other_args
+        ):
+            continue
+        out_node.meta["in_place_of"] = base_node
+        for idx in out_spec.lifetime:
+            if idx is not None:
+                update_tensor_lifetime(base_spec, idx)
+        num_in_place += 1
+
+    logging.debug(f"Planned {num_in_place} ops to run in place")
+    return num_in_place
+
+
 def apply_algo(
     algo: Callable[[torch.fx.GraphModule, int, bool, bool], List[int]],
     graph_module: torch.fx.GraphModule,
     alignment: int,
     alloc_graph_input: bool = True,
     alloc_graph_output: bool = True,
+    allow_in_place: bool = False,
 ) -> List[int]:
     """
     Recursively apply algo to graph_module and its submodules for control flow.
+    If allow_in_place is True, plan_in_place_ops() runs first.
 
     Quite naively right now since it does not take the following optimizations
     into considerating:
@@ -653,9 +1224,16 @@ def apply_algo(
     TODO: make these optimizations once we have some baseline working.
     """
     specs = update_all_tensors_lifetime(graph_module)
+    update_alias_bases_lifetime(graph_module)
+    if allow_in_place:
+        plan_in_place_ops(graph_module)
     bufsizes: List[int] = algo(
         graph_module, alignment, alloc_graph_input, alloc_graph_output
     )
+    lower_bounds = get_buffer_size_lower_bounds(
+        graph_module, alloc_graph_input, alloc_graph_output
+    )
+    share_alias_storage(graph_module)
     insert_calls_to_free(graph_module, specs)
 
     def handle_submodule(submodule_nd: torch.fx.Node) -> None:
@@ -666,7 +1244,12 @@ def apply_algo(
         # buffer already allocated.
         submodule.input_mem_buffer_sizes = bufsizes
         bufsizes = apply_algo(
-            algo, submodule, alignment, alloc_graph_input=False, alloc_graph_output=True
+            algo,
+            submodule,
+            alignment,
+            alloc_graph_input=False,
+            alloc_graph_output=True,
+            allow_in_place=allow_in_place,
         )
         submodule.meta.update({"non_const_buffer_sizes": bufsizes})
 
@@ -682,6 +1265,11 @@ def apply_algo(
     for map_node in get_map_nodes(graph_module):
         handle_submodule(typing.cast(torch.fx.Node, map_node.args[0]))
 
-    graph_module.meta.update({"non_const_buffer_sizes": bufsizes})
+    graph_module.meta.update(
+        {
+            "non_const_buffer_sizes": bufsizes,
+            "non_const_buffer_lower_bounds": lower_bounds,
+        }
+    )
 
     return bufsizes
@@ -32,10 +32,20 @@ from executorch.exir.operator.convert import (
 
 from executorch.exir.pass_base import ExportPass
 from executorch.exir.pass_manager import PassManager, PassType
-from executorch.exir.passes.const_prop_pass import ConstPropPass
+from executorch.exir.passes.channels_last_propagation_pass import (
+    ChannelsLastPropagationPass,
+)
+from executorch.exir.passes.const_prop_pass import (
+    ConstPropPass,
+    WeightQuantFoldingPass,
+)
 from executorch.exir.passes.debug_handle_generator_pass import DebugHandleGeneratorPass
 
 from executorch.exir.passes.executorch_prim_ops_registry import _EXECUTORCH_SYM_OPS
+from executorch.exir.passes.fold_batch_norm_pass import FoldBatchNormPass
+from executorch.exir.passes.fuse_elementwise_pass import FuseElementwisePass
+from executorch.exir.passes.fuse_rms_norm_and_rope_pass import FuseRMSNormAndRoPEPass
+from executorch.exir.passes.memory_aware_schedule_pass import MemoryAwareSchedulePass
 from executorch.exir.passes.memory_format_ops_pass import MemoryFormatOpsPass
 from executorch.exir.passes.memory_planning_pass import MemoryPlanningPass
 from executorch.exir.passes.normalize_transpose_pass import NormalizeTransposePass
@@ -49,7 +59,12 @@ from executorch.exir.passes.replace_broken_ops_with_function_ops_pass import (
 )
 from executorch.exir.passes.replace_edge_with_backend_pass import EdgeToBackendOpsPass
 from executorch.exir.passes.replace_sym_size_op_pass import ReplaceSymSizeOpPass
+from executorch.exir.passes.replace_view_copy_with_view_pass import (
+    ReplaceViewCopyWithViewPass,
+)
 from executorch.exir.passes.scalar_to_tensor_pass import ScalarToTensorPass
+# Registers executorch_prim::sdpa, which models call directly
+from executorch.exir.passes.sdpa_op import sdpa  # noqa: F401
 from executorch.exir.passes.spec_prop_pass import SpecPropPass
 from executorch.exir.passes.sym_shape_eval_pass import HintBasedSymShapeEvalPass
 from executorch.exir.passes.sym_to_tensor_pass import SymToTensorPass
@@ -63,11 +78,18 @@ from torch.fx.passes.shape_prop import TensorMetadata
 __all__ = [
     "ExportPass",
     "ConstPropPass",
+    "WeightQuantFoldingPass",
     "QuantFusionPass",
     "OpReplacePass",
     "EdgeToBackendOpsPass",
+    "FoldBatchNormPass",
+    "FuseElementwisePass",
+    "FuseRMSNormAndRoPEPass",
+    "ChannelsLastPropagationPass",
+    "MemoryAwareSchedulePass",
     "MemoryFormatOpsPass",
     "HintBasedSymShapeEvalPass",
+    "ReplaceViewCopyWithViewPass",
 ]
 
 Argument = Optional[
@@ -247,6 +269,9 @@ to_out_var_skiplist: Set[Callable[[Any], Any]] = {
     # we won't see it in the input graph to the to_out_variant pass, unless
     # it's retraced after running to_out_variant with the first trace.
     memory.alloc,
+    # memory.view is added by ReplaceViewCopyWithViewPass in place of
+    # functional view copies, and is emitted as a call to et_view.
+    memory.view,
     executorch_call_delegate,
 }
 to_out_var_skiplist.update(_EXECUTORCH_SYM_OPS)
@@ -5,7 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 import copy
-from typing import Callable, List, Tuple
+from typing import Callable, List, Optional, Tuple
 
 import torch
 from executorch.exir.dialects._ops import bind_pattern_to_op, ops as exir_ops
@@ -16,6 +16,7 @@ from executorch.exir.passes.replace_aten_with_edge_pass import (
 )
 from torch import fx
 from torch.ao.quantization.fx._decomposed import quantized_decomposed_lib
+from torch.library import impl
 
 
 __all__ = [
@@ -29,6 +30,125 @@ quantized_decomposed_lib.define(
     "int weight_quant_min, int weight_quant_max, Tensor indices) -> Tensor",
 )
 
+quantized_decomposed_lib.define(
+    "embedding_4bit(Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, "
+    "int weight_quant_min, int weight_quant_max, Tensor indices) -> Tensor",
+)
+
+quantized_decomposed_lib.define(
+    "linear_byte(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, "
+    "int weight_quant_min, int weight_quant_max, Tensor? bias) -> Tensor",
+)
+
+quantized_decomposed_lib.define(
+    "linear_4bit(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, "
+    "int weight_quant_min, int weight_quant_max, Tensor? bias) -> Tensor",
+)
+
+quantized_decomposed_lib.define(
+    "linear_dynamic(Tensor input, Tensor weight, Tensor weight_scales, Tensor? weight_zero_points, "
+    "int weight_quant_min, int weight_quant_max, Tensor? bias) -> Tensor",
+)
+
+
+def _unpack_4bit(weight: torch.Tensor) -> torch.Tensor:
+    """Unpacks signed 4-bit values stored two per byte with an offset of 8,
+    the even one in the high nibble, into an int8 tensor twice as wide."""
+    high = (weight >> 4).to(torch.int8) - 8
+    low = (weight & 0x0F).to(torch.int8) - 8
+    return torch.stack([high, low], dim=-1).view(weight.shape[0], -1)
+
+
+def _dequantize_groupwise(
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+) -> torch.Tensor:
+    """Dequantizes a 2-D weight whose qparams are per row, [rows], or per group
+    of consecutive columns of each row, [rows, num_groups]."""
+    if weight_scales.dim() == 1:
+        weight_scales = weight_scales.unsqueeze(-1)
+    group_size = weight.shape[1] // weight_scales.shape[1]
+    scales = weight_scales.repeat_interleave(group_size, dim=1)
+    weight = weight.to(torch.float32)
+    if weight_zero_points is not None:
+        zero_points = weight_zero_points.view(weight_scales.shape)
+        weight = weight - zero_points.repeat_interleave(group_size, dim=1)
+    return weight * scales
+
+
+@impl(quantized_decomposed_lib, "embedding_4bit", "CompositeExplicitAutograd")
+def embedding_4bit(
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+    weight_quant_min: int,
+    weight_quant_max: int,
+    indices: torch.Tensor,
+) -> torch.Tensor:
+    weight = _dequantize_groupwise(
+        _unpack_4bit(weight), weight_scales, weight_zero_points
+    )
+    return torch.ops.aten.embedding.default(weight, indices)
+
+
+@impl(quantized_decomposed_lib, "linear_byte", "CompositeExplicitAutograd")
+def linear_byte(
+    input: torch.Tensor,
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+    weight_quant_min: int,
+    weight_quant_max: int,
+    bias: Optional[torch.Tensor],
+) -> torch.Tensor:
+    weight = _dequantize_groupwise(weight, weight_scales, weight_zero_points)
+    return torch.nn.functional.linear(input, weight, bias)
+
+
+@impl(quantized_decomposed_lib, "linear_4bit", "CompositeExplicitAutograd")
+def linear_4bit(
+    input: torch.Tensor,
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+    weight_quant_min: int,
+    weight_quant_max: int,
+    bias: Optional[torch.Tensor],
+) -> torch.Tensor:
+    weight = _dequantize_groupwise(
+        _unpack_4bit(weight), weight_scales, weight_zero_points
+    )
+    return torch.nn.functional.linear(input, weight, bias)
+
+
+@impl(quantized_decomposed_lib, "linear_dynamic", "CompositeExplicitAutograd")
+def linear_dynamic(
+    input: torch.Tensor,
+    weight: torch.Tensor,
+    weight_scales: torch.Tensor,
+    weight_zero_points: Optional[torch.Tensor],
+    weight_quant_min: int,
+    weight_quant_max: int,
+    bias: Optional[torch.Tensor],
+) -> torch.Tensor:
+    """Linear layer whose float input is quantized per tensor to int8 with
+    qparams chosen from its range, and whose weight is quantized per row."""
+    scale, zero_point = torch.ops.quantized_decomposed.choose_qparams.tensor(
+        input, -128, 127, torch.finfo(torch.float32).eps, torch.int8
+    )
+    input = torch.ops.quantized_decomposed.quantize_per_tensor.tensor(
+        input, scale, zero_point, -128, 127, torch.int8
+    )
+    input = torch.ops.quantized_decomposed.dequantize_per_tensor.tensor(
+        input, scale, zero_point, -128, 127, torch.int8
+    )
+    weight = weight.to(torch.float32)
+    if weight_zero_points is not None:
+        weight = weight - weight_zero_points.unsqueeze(-1)
+    weight = weight * weight_scales.unsqueeze(-1)
+    return torch.nn.functional.linear(input, weight, bias)
+
 
 quantized_decomposed_lib.define(
     "add(Tensor a, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, Tensor b, float b_scale, int b_zero_point, int b_quant_min, int b_quant_max, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor qc"
@@ -38,10 +158,136 @@ quantized_decomposed_lib.define(
     "add.scalar(Tensor qa, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, ScalarType a_dtype, Scalar b, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max, ScalarType out_dtype) -> Tensor"
 )
 
+quantized_decomposed_lib.define(
+    "linear(Tensor input, float input_scale, int input_zero_point, Tensor weight, float weight_scale, int weight_zero_point, Tensor? bias, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor"
+)
+
+quantized_decomposed_lib.define(
+    "matmul(Tensor a, float a_scale, int a_zero_point, Tensor b, float b_scale, int b_zero_point, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor"
+)
+
 quantized_decomposed_lib.define(
     "add_relu(Tensor a, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, Tensor b, float b_scale, int b_zero_point, int b_quant_min, int b_quant_max, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor qc"
 )
 
+quantized_decomposed_lib.define(
+    "mul(Tensor a, float a_scale, int a_zero_point, int a_quant_min, int a_quant_max, Tensor b, float b_scale, int b_zero_point, int b_quant_min, int b_quant_max, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor"
+)
+
+quantized_decomposed_lib.define(
+    "conv2d(Tensor input, float input_scale, int input_zero_point, Tensor weight, float weight_scale, int weight_zero_point, Tensor? bias, int[2] stride, int[2] padding, int[2] dilation, int groups, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor"
+)
+
+quantized_decomposed_lib.define(
+    "avg_pool2d(Tensor input, float input_scale, int input_zero_point, int[2] kernel_size, int[2] stride, int[2] padding, bool ceil_mode, bool count_include_pad, int? divisor_override, float out_scale, int out_zero_point, int out_quant_min, int out_quant_max) -> Tensor"
+)
+
+
+def _dequantize_per_tensor(
+    x: torch.Tensor, scale: float, zero_point: int
+) -> torch.Tensor:
+    return (x.to(torch.float32) - zero_point) * scale
+
+
+def _quantize_per_tensor(
+    x: torch.Tensor,
+    scale: float,
+    zero_point: int,
+    quant_min: int,
+    quant_max: int,
+    dtype: torch.dtype,
+) -> torch.Tensor:
+    return torch.clamp(
+        torch.round(x * (1.0 / scale)) + zero_point, quant_min, quant_max
+    ).to(dtype)
+
+
+@impl(quantized_decomposed_lib, "mul", "CompositeExplicitAutograd")
+def mul(
+    a: torch.Tensor,
+    a_scale: float,
+    a_zero_point: int,
+    a_quant_min: int,
+    a_quant_max: int,
+    b: torch.Tensor,
+    b_scale: float,
+    b_zero_point: int,
+    b_quant_min: int,
+    b_quant_max: int,
+    out_scale: float,
+    out_zero_point: int,
+    out_quant_min: int,
+    out_quant_max: int,
+) -> torch.Tensor:
+    out = _dequantize_per_tensor(a, a_scale, a_zero_point) * _dequantize_per_tensor(
+        b, b_scale, b_zero_point
+    )
+    return _quantize_per_tensor(
+        out, out_scale, out_zero_point, out_quant_min, out_quant_max, a.dtype
+    )
+
+
+@impl(quantized_decomposed_lib, "conv2d", "CompositeExplicitAutograd")
+def conv2d(
+    input: torch.Tensor,
+    input_scale: float,
+    input_zero_point: int,
+    weight: torch.Tensor,
+    weight_scale: float,
+    weight_zero_point: int,
+    bias: Optional[torch.Tensor],
+    stride: List[int],
+    padding: List[int],
+    dilation: List[int],
+    groups: int,
+    out_scale: float,
+    out_zero_point: int,
+    out_quant_min: int,
+    out_quant_max: int,
+) -> torch.Tensor:
+    out = torch.nn.functional.conv2d(
+        _dequantize_per_tensor(input, input_scale, input_zero_point),
+        _dequantize_per_tensor(weight, weight_scale, weight_zero_point),
+        bias,
+        stride,
+        padding,
+        dilation,
+        groups,
+    )
+    return _quantize_per_tensor(
+        out, out_scale, out_zero_point, out_quant_min, out_quant_max, input.dtype
+    )
+
+
+@impl(quantized_decomposed_lib, "avg_pool2d", "CompositeExplicitAutograd")
+def avg_pool2d(
+    input: torch.Tensor,
+    input_scale: float,
+    input_zero_point: int,
+    kernel_size: List[int],
+    stride: List[int],
+    padding: List[int],
+    ceil_mode: bool,
+    count_include_pad: bool,
+    divisor_override: Optional[int],
+    out_scale: float,
+    out_zero_point: int,
+    out_quant_min: int,
+    out_quant_max: int,
+) -> torch.Tensor:
+    out = torch.nn.functional.avg_pool2d(
+        _dequantize_per_tensor(input, input_scale, input_zero_point),
+        kernel_size,
+        stride if len(stride) > 0 else None,
+        padding,
+        ceil_mode,
+        count_include_pad,
+        divisor_override,
+    )
+    return _quantize_per_tensor(
+        out, out_scale, out_zero_point, out_quant_min, out_quant_max, input.dtype
+    )
+
 
 def _trace_and_lower_to_edge_ops(f: Callable) -> fx.GraphModule:
     gm = fx.symbolic_trace(f)
@@ -539,6 +785,570 @@ def _get_embedding_ops_patterns_and_replacements() -> List[
     return patterns_and_replacements
 
 
+def _get_linear_patterns_and_replacements() -> List[
+    Tuple[Callable, Callable, List[Callable]]
+]:
+    def get_pattern_and_replacement(x_dtype, weight_dtype, out_dtype):
+        @bind_pattern_to_op(quantized_decomposed_lib, "linear")
+        def pattern(
+            x,
+            x_scale,
+            x_zero_point,
+            x_qmin,
+            x_qmax,
+            weight,
+            weight_scale,
+            weight_zero_point,
+            weight_qmin,
+            weight_qmax,
+            bias,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            x = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                x, x_scale, x_zero_point, x_qmin, x_qmax, x_dtype
+            )
+            weight = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                weight,
+                weight_scale,
+                weight_zero_point,
+                weight_qmin,
+                weight_qmax,
+                weight_dtype,
+            )
+            weight = torch.ops.aten.permute_copy.default(weight, [1, 0])
+            out = torch.ops.aten.addmm.default(bias, x, weight)
+            out = torch.ops.quantized_decomposed.quantize_per_tensor.default(
+                out, out_scale, out_zero_point, out_qmin, out_qmax, out_dtype
+            )
+            return out
+
+        def replacement(
+            x,
+            x_scale,
+            x_zero_point,
+            x_qmin,
+            x_qmax,
+            weight,
+            weight_scale,
+            weight_zero_point,
+            weight_qmin,
+            weight_qmax,
+            bias,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            out = torch.ops.quantized_decomposed.linear.default(
+                x,
+                x_scale,
+                x_zero_point,
+                weight,
+                weight_scale,
+                weight_zero_point,
+                bias,
+                out_scale,
+                out_zero_point,
+                out_qmin,
+                out_qmax,
+            )
+            return out
+
+        @bind_pattern_to_op(quantized_decomposed_lib, "linear")
+        def pattern_without_bias(
+            x,
+            x_scale,
+            x_zero_point,
+            x_qmin,
+            x_qmax,
+            weight,
+            weight_scale,
+            weight_zero_point,
+            weight_qmin,
+            weight_qmax,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            x = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                x, x_scale, x_zero_point, x_qmin, x_qmax, x_dtype
+            )
+            weight = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                weight,
+                weight_scale,
+                weight_zero_point,
+                weight_qmin,
+                weight_qmax,
+                weight_dtype,
+            )
+            weight = torch.ops.aten.permute_copy.default(weight, [1, 0])
+            out = torch.ops.aten.mm.default(x, weight)
+            out = torch.ops.quantized_decomposed.quantize_per_tensor.default(
+                out, out_scale, out_zero_point, out_qmin, out_qmax, out_dtype
+            )
+            return out
+
+        def replacement_without_bias(
+            x,
+            x_scale,
+            x_zero_point,
+            x_qmin,
+            x_qmax,
+            weight,
+            weight_scale,
+            weight_zero_point,
+            weight_qmin,
+            weight_qmax,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            out = torch.ops.quantized_decomposed.linear.default(
+                x,
+                x_scale,
+                x_zero_point,
+                weight,
+                weight_scale,
+                weight_zero_point,
+                None,
+                out_scale,
+                out_zero_point,
+                out_qmin,
+                out_qmax,
+            )
+            return out
+
+        return [
+            (
+                _trace_and_lower_to_edge_ops(pattern),
+                _trace_and_lower_to_edge_ops(replacement),
+                [],
+            ),
+            (
+                _trace_and_lower_to_edge_ops(pattern_without_bias),
+                _trace_and_lower_to_edge_ops(replacement_without_bias),
+                [],
+            ),
+        ]
+
+    patterns_and_replacements = []
+    for x_dtype in (torch.uint8, torch.int8):
+        for weight_dtype in (torch.int8, torch.uint8):
+            patterns_and_replacements.extend(
+                get_pattern_and_replacement(x_dtype, weight_dtype, x_dtype)
+            )
+    return patterns_and_replacements
+
+
+def _dynamic_input_has_int8_range(match, original_graph, pattern_graph):
+    """check that the input of a dynamically quantized pattern is quantized to
+
+    [-128, 127], which is what linear_dynamic quantizes it to
+    """
+    for node in pattern_graph.nodes:
+        if node.op == "placeholder" and node.name in ("x_qmin", "x_qmax"):
+            expected = -128 if node.name == "x_qmin" else 127
+            if match.nodes_map[node] != expected:
+                return False
+    return True
+
+
+def _get_dynamic_linear_patterns_and_replacements() -> List[
+    Tuple[Callable, Callable, List[Callable]]
+]:
+    def get_pattern_and_replacement(weight_dtype):
+        def quantize_input(x, x_qmin, x_qmax, x_eps):
+            qparams = torch.ops.quantized_decomposed.choose_qparams.tensor(
+                x, x_qmin, x_qmax, x_eps, torch.int8
+            )
+            x = torch.ops.quantized_decomposed.quantize_per_tensor.tensor(
+                x, qparams[0], qparams[1], x_qmin, x_qmax, torch.int8
+            )
+            return torch.ops.quantized_decomposed.dequantize_per_tensor.tensor(
+                x, qparams[0], qparams[1], x_qmin, x_qmax, torch.int8
+            )
+
+        def dequantize_weight(
+            weight, weight_scales, weight_zero_points, weight_qmin, weight_qmax
+        ):
+            weight = torch.ops.quantized_decomposed.dequantize_per_channel.default(
+                weight,
+                weight_scales,
+                weight_zero_points,
+                0,
+                weight_qmin,
+                weight_qmax,
+                weight_dtype,
+            )
+            return torch.ops.aten.permute_copy.default(weight, [1, 0])
+
+        @bind_pattern_to_op(quantized_decomposed_lib, "linear_dynamic")
+        def pattern(
+            x,
+            x_qmin,
+            x_qmax,
+            x_eps,
+            weight,
+            weight_scales,
+            weight_zero_points,
+            weight_qmin,
+            weight_qmax,
+            bias,
+        ):
+            x = quantize_input(x, x_qmin, x_qmax, x_eps)
+            weight = dequantize_weight(
+                weight, weight_scales, weight_zero_points, weight_qmin, weight_qmax
+            )
+            return torch.ops.aten.addmm.default(bias, x, weight)
+
+        def replacement(
+            x,
+            x_qmin,
+            x_qmax,
+            x_eps,
+            weight,
+            weight_scales,
+            weight_zero_points,
+            weight_qmin,
+            weight_qmax,
+            bias,
+        ):
+            return torch.ops.quantized_decomposed.linear_dynamic.default(
+                x,
+                weight,
+                weight_scales,
+                weight_zero_points,
+                weight_qmin,
+                weight_qmax,
+                bias,
+            )
+
+        @bind_pattern_to_op(quantized_decomposed_lib, "linear_dynamic")
+        def pattern_without_bias(
+            x,
+            x_qmin,
+            x_qmax,
+            x_eps,
+            weight,
+            weight_scales,
+            weight_zero_points,
+            weight_qmin,
+            weight_qmax,
+        ):
+            x = quantize_input(x, x_qmin, x_qmax, x_eps)
+            weight = dequantize_weight(
+                weight, weight_scales, weight_zero_points, weight_qmin, weight_qmax
+            )
+            return torch.ops.aten.mm.default(x, weight)
+
+        def replacement_without_bias(
+            x,
+            x_qmin,
+            x_qmax,
+            x_eps,
+            weight,
+            weight_scales,
+            weight_zero_points,
+            weight_qmin,
+            weight_qmax,
+        ):
+            return torch.ops.quantized_decomposed.linear_dynamic.default(
+                x,
+                weight,
+                weight_scales,
+                weight_zero_points,
+                weight_qmin,
+                weight_qmax,
+                None,
+            )
+
+        return [
+            (
+                _trace_and_lower_to_edge_ops(pattern),
+                _trace_and_lower_to_edge_ops(replacement),
+                [_dynamic_input_has_int8_range],
+            ),
+            (
+                _trace_and_lower_to_edge_ops(pattern_without_bias),
+                _trace_and_lower_to_edge_ops(replacement_without_bias),
+                [_dynamic_input_has_int8_range],
+            ),
+        ]
+
+    patterns_and_replacements = []
+    for weight_dtype in (torch.int8, torch.uint8):
+        patterns_and_replacements.extend(get_pattern_and_replacement(weight_dtype))
+    return patterns_and_replacements
+
+
+def _get_matmul_patterns_and_replacements() -> List[
+    Tuple[Callable, Callable, List[Callable]]
+]:
+    def get_pattern_and_replacement(matmul_op, dtype):
+        @bind_pattern_to_op(quantized_decomposed_lib, "matmul")
+        def pattern(
+            a,
+            a_scale,
+            a_zero_point,
+            a_qmin,
+            a_qmax,
+            b,
+            b_scale,
+            b_zero_point,
+            b_qmin,
+            b_qmax,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            a = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                a, a_scale, a_zero_point, a_qmin, a_qmax, dtype
+            )
+            b = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                b, b_scale, b_zero_point, b_qmin, b_qmax, dtype
+            )
+            out = matmul_op(a, b)
+            out = torch.ops.quantized_decomposed.quantize_per_tensor.default(
+                out, out_scale, out_zero_point, out_qmin, out_qmax, dtype
+            )
+            return out
+
+        def replacement(
+            a,
+            a_scale,
+            a_zero_point,
+            a_qmin,
+            a_qmax,
+            b,
+            b_scale,
+            b_zero_point,
+            b_qmin,
+            b_qmax,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            out = torch.ops.quantized_decomposed.matmul.default(
+                a,
+                a_scale,
+                a_zero_point,
+                b,
+                b_scale,
+                b_zero_point,
+                out_scale,
+                out_zero_point,
+                out_qmin,
+                out_qmax,
+            )
+            return out
+
+        return [
+            (
+                _trace_and_lower_to_edge_ops(pattern),
+                _trace_and_lower_to_edge_ops(replacement),
+                [],
+            )
+        ]
+
+    patterns_and_replacements = []
+    for matmul_op in (torch.ops.aten.mm.default, torch.ops.aten.bmm.default):
+        for dtype in (torch.uint8, torch.int8):
+            patterns_and_replacements.extend(
+                get_pattern_and_replacement(matmul_op, dtype)
+            )
+    return patterns_and_replacements
+
+
+def _get_mul_patterns_and_replacements() -> List[
+    Tuple[Callable, Callable, List[Callable]]
+]:
+    def get_pattern_and_replacement(dtype):
+        @bind_pattern_to_op(quantized_decomposed_lib, "mul")
+        def pattern(
+            a,
+            a_scale,
+            a_zero_point,
+            a_qmin,
+            a_qmax,
+            b,
+            b_scale,
+            b_zero_point,
+            b_qmin,
+            b_qmax,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            a = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                a, a_scale, a_zero_point, a_qmin, a_qmax, dtype
+            )
+            b = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                b, b_scale, b_zero_point, b_qmin, b_qmax, dtype
+            )
+            out = torch.ops.aten.mul.Tensor(a, b)
+            out = torch.ops.quantized_decomposed.quantize_per_tensor.default(
+                out, out_scale, out_zero_point, out_qmin, out_qmax, dtype
+            )
+            return out
+
+        def replacement(
+            a,
+            a_scale,
+            a_zero_point,
+            a_qmin,
+            a_qmax,
+            b,
+            b_scale,
+            b_zero_point,
+            b_qmin,
+            b_qmax,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            out = torch.ops.quantized_decomposed.mul.default(
+                a,
+                a_scale,
+                a_zero_point,
+                a_qmin,
+                a_qmax,
+                b,
+                b_scale,
+                b_zero_point,
+                b_qmin,
+                b_qmax,
+                out_scale,
+                out_zero_point,
+                out_qmin,
+                out_qmax,
+            )
+            return out
+
+        return [
+            (
+                _trace_and_lower_to_edge_ops(pattern),
+                _trace_and_lower_to_edge_ops(replacement),
+                [],
+            )
+        ]
+
+    patterns_and_replacements = []
+    for dtype in (torch.uint8, torch.int8):
+        patterns_and_replacements.extend(get_pattern_and_replacement(dtype))
+    return patterns_and_replacements
+
+
+def _get_conv_patterns_and_replacements() -> List[
+    Tuple[Callable, Callable, List[Callable]]
+]:
+    def get_pattern_and_replacement(x_dtype, weight_dtype, out_dtype):
+        @bind_pattern_to_op(quantized_decomposed_lib, "conv2d")
+        def pattern(
+            x,
+            x_scale,
+            x_zero_point,
+            x_qmin,
+            x_qmax,
+            weight,
+            weight_scale,
+            weight_zero_point,
+            weight_qmin,
+            weight_qmax,
+            bias,
+            stride,
+            padding,
+            dilation,
+            groups,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            x = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                x, x_scale, x_zero_point, x_qmin, x_qmax, x_dtype
+            )
+            weight = torch.ops.quantized_decomposed.dequantize_per_tensor.default(
+                weight,
+                weight_scale,
+                weight_zero_point,
+                weight_qmin,
+                weight_qmax,
+                weight_dtype,
+            )
+            out = torch.ops.aten.convolution.default(
+                x, weight, bias, stride, padding, dilation, False, [0, 0], groups
+            )
+            out = torch.ops.quantized_decomposed.quantize_per_tensor.default(
+                out, out_scale, out_zero_point, out_qmin, out_qmax, out_dtype
+            )
+            return out
+
+        def replacement(
+            x,
+            x_scale,
+            x_zero_point,
+            x_qmin,
+            x_qmax,
+            weight,
+            weight_scale,
+            weight_zero_point,
+            weight_qmin,
+            weight_qmax,
+            bias,
+            stride,
+            padding,
+            dilation,
+            groups,
+            out_scale,
+            out_zero_point,
+            out_qmin,
+            out_qmax,
+        ):
+            out = torch.ops.quantized_decomposed.conv2d.default(
+                x,
+                x_scale,
+                x_zero_point,
+                weight,
+                weight_scale,
+                weight_zero_point,
+                bias,
+                stride,
+                padding,
+                dilation,
+                groups,
+                out_scale,
+                out_zero_point,
+                out_qmin,
+                out_qmax,
+            )
+            return out
+
+        return [
+            (
+                _trace_and_lower_to_edge_ops(pattern),
+                _trace_and_lower_to_edge_ops(replacement),
+                [],
+            )
+        ]
+
+    patterns_and_replacements = []
+    for x_dtype in (torch.uint8, torch.int8):
+        for weight_dtype in (torch.int8, torch.uint8):
+            patterns_and_replacements.extend(
+                get_pattern_and_replacement(x_dtype, weight_dtype, x_dtype)
+            )
+    return patterns_and_replacements
+
+
 """
 def _get_fixed_qparams_ops_patterns_and_replacements() -> List[Tuple[Callable, Callable, List[Callable]]]:
     fixed_qparams_op_to_qop = {
@@ -577,5 +1387,10 @@ def get_quant_patterns_and_replacements() -> List[
             *_get_slice_patterns_and_replacements(),
             # *_get_fixed_qparams_ops_patterns_and_replacements(),
             *_get_embedding_ops_patterns_and_replacements(),
+            *_get_linear_patterns_and_replacements(),
+            *_get_dynamic_linear_patterns_and_replacements(),
+            *_get_matmul_patterns_and_replacements(),
+            *_get_mul_patterns_and_replacements(),
+            *_get_conv_patterns_and_replacements(),
         ]
     )
@@ -0,0 +1,163 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import logging
+
+import executorch.exir.passes.dim_order_ops_registry  # noqa
+
+import torch
+from executorch.exir.dialects._ops import ops as exir_ops
+from executorch.exir.dialects.backend._ops import BackendOpOverload
+from executorch.exir.dialects.edge._ops import EdgeOpOverload
+from executorch.exir.dim_order_utils import get_dim_order
+from executorch.exir.pass_base import ExportPass, ProxyValue
+from torch.utils import _pytree as pytree
+
+logger = logging.getLogger(__file__)
+logger.setLevel(logging.INFO)
+
+# Ops whose kernels read and write channels last tensors directly, and which
+# produce channels last outputs from channels last inputs.
+_CHANNELS_LAST_OPS = {
+    "aten::convolution",
+    "aten::avg_pool2d",
+    "aten::max_pool2d_with_indices",
+    "aten::_native_batch_norm_legit_no_training",
+}
+
+# Ops whose kernels compute out[i] from the inputs at the same flat index i, so
+# they are correct for any dim order, as long as all tensors share it.
+_ELEMENTWISE_OPS = {
+    "aten::abs",
+    "aten::add",
+    "aten::clamp",
+    "aten::div",
+    "aten::exp",
+    "aten::hardtanh",
+    "aten::maximum",
+    "aten::minimum",
+    "aten::mul",
+    "aten::neg",
+    "aten::relu",
+    "aten::sigmoid",
+    "aten::sub",
+    "aten::tanh",
+}
+
+
+def _op_name(op) -> str:
+    if isinstance(op, (torch._ops.OpOverload, EdgeOpOverload, BackendOpOverload)):
+        return op._schema.name
+    return ""
+
+
+def _is_tensor(value) -> bool:
+    return isinstance(value, ProxyValue) and value.is_tensor()
+
+
+def _is_channels_last(value) -> bool:
+    if not _is_tensor(value):
+        return False
+    t = value.to_tensor()
+    # Tensors whose strides are also contiguous need no conversion
+    return (
+        t.dim() == 4
+        and not t.is_contiguous()
+        and t.is_contiguous(memory_format=torch.channels_last)
+    )
+
+
+class ChannelsLastPropagationPass(ExportPass):
+    """
+    Runs convolutions, pooling, batch norm and the elementwise ops between them
+    in the channels last dim order, which the conv and pooling kernels are
+    fastest in, while the rest of the graph, and the inputs and outputs of the
+    program, stay contiguous.
+
+    A _to_dim_order_copy to channels last is inserted before each conv whose
+    input is contiguous. Fake tensor propagation then carries channels last
+    through the ops in _CHANNELS_LAST_OPS, and through elementwise ops whose
+    tensor operands all have the same shape. Any other op that would read a
+    channels last tensor gets a _to_dim_order_copy back to contiguous instead,
+    so a chain like conv -> batch_norm -> relu -> max_pool -> conv only pays
+    for the layout conversions at its boundaries.
+
+    Must run before SpecPropPass, which derives the dim order of each
+    TensorSpec from the strides of its fake tensor.
+    """
+
+    def __init__(self) -> None:
+        super().__init__()
+        self.num_conversions = 0
+
+    def _to_dim_order(self, value, dim_order, meta):
+        self.num_conversions += 1
+        return super().call_operator(
+            exir_ops.edge.dim_order_ops._to_dim_order_copy.default,
+            (value,),
+            {"dim_order": dim_order},
+            meta,
+        )
+
+    def _to_contiguous(self, args, kwargs, meta):
+        def convert(value):
+            if not _is_channels_last(value):
+                return value
+            return self._to_dim_order(
+                value, get_dim_order(torch.contiguous_format, 4), meta
+            )
+
+        return pytree.tree_map_only(ProxyValue, convert, (args, kwargs))
+
+    # pyre-ignore
+    def call_operator(self, op, args, kwargs, meta):
+        name = _op_name(op)
+        if name == "aten::convolution":
+            if _is_tensor(args[0]) and args[0].to_tensor().dim() == 4:
+                if not _is_channels_last(args[0]):
+                    args = (
+                        self._to_dim_order(
+                            args[0], get_dim_order(torch.channels_last, 4), meta
+                        ),
+                        *args[1:],
+                    )
+                return super().call_operator(op, args, kwargs, meta)
+        elif name in _CHANNELS_LAST_OPS:
+            return super().call_operator(op, args, kwargs, meta)
+        elif name in _ELEMENTWISE_OPS and any(_is_channels_last(a) for a in args):
+            tensors = [a.to_tensor() for a in args if _is_tensor(a)]
+            if all(t.shape == tensors[0].shape for t in tensors):
+                args = tuple(
+                    (
+                        self._to_dim_order(
+                            a, get_dim_order(torch.channels_last, 4), meta
+                        )
+                        if _is_tensor(a) and not _is_channels_last(a)
+                        else a
+                    )
+                    for a in args
+                )
+                return super().call_operator(op, args, kwargs, meta)
+
+        args, kwargs = self._to_contiguous(args, kwargs, meta)
+        return super().call_operator(op, args, kwargs, meta)
+
+    # pyre-ignore
+    def call_delegate(self, lowered_module, args, kwargs, meta):
+        args, kwargs = self._to_contiguous(args, kwargs, meta)
+        return super().call_delegate(lowered_module, args, kwargs, meta)
+
+    # pyre-ignore
+    def output(self, results, meta):
+        results, _ = self._to_contiguous(results, {}, meta)
+        return super().output(results, meta)
+
+    # pyre-ignore
+    def call(self, graph_module):
+        self.num_conversions = 0
+        result = super().call(graph_module)
+        logger.debug(f"Inserted {self.num_conversions} dim order conversions")
+        return result
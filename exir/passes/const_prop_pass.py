@@ -6,6 +6,8 @@
 
 # pyre-strict
 
+from typing import List, Set
+
 import torch
 from executorch.exir.dialects._ops import ops
 
@@ -19,6 +21,59 @@ __all__ = [
 ]
 
 
+# pyre-ignore
+def is_const(arg) -> bool:
+    if isinstance(arg, FakeTensor):
+        return False
+    if isinstance(
+        arg,
+        (
+            float,
+            int,
+            bool,
+            str,
+            torch.Tensor,
+            torch.device,
+            torch.dtype,
+            torch.layout,
+        ),
+    ):
+        return True
+    if isinstance(arg, (tuple, list)):
+        return all(map(is_const, arg))
+    if isinstance(arg, dict):
+        return all(map(is_const, arg.values()))
+    return False
+
+
+_quant_ops = {
+    torch.ops.quantized_decomposed.quantize_per_channel.default,
+    torch.ops.quantized_decomposed.quantize_per_tensor.default,
+    ops.edge.quantized_decomposed.quantize_per_channel.default,
+    ops.edge.quantized_decomposed.quantize_per_tensor.default,
+}
+
+_dequant_ops = {
+    torch.ops.quantized_decomposed.dequantize_per_channel.default,
+    torch.ops.quantized_decomposed.dequantize_per_tensor.default,
+    ops.edge.quantized_decomposed.dequantize_per_channel.default,
+    ops.edge.quantized_decomposed.dequantize_per_tensor.default,
+}
+
+
+# pyre-ignore
+def _evaluate(op, args, kwargs):
+    guard = torch._C._DisableTorchDispatch()  # noqa
+    try:
+        args_data, kwargs_data = pytree.tree_map_only(
+            ProxyValue, lambda x: x.data, (args, kwargs)
+        )
+        result = op(*args_data, **kwargs_data)
+    finally:
+        del guard
+    return result.to_tensor() if isinstance(result, ProxyValue) else result
+
+
 class ConstPropPass(ExportPass):
     """
     Performs constant folding and constant propagation.
@@ -30,59 +85,60 @@ class ConstPropPass(ExportPass):
 
     # pyre-ignore
     def call_operator(self, op, args, kwargs, meta):
-        # pyre-ignore
-        def is_const(arg) -> bool:
-            if isinstance(arg, FakeTensor):
-                return False
-            if isinstance(
-                arg,
-                (
-                    float,
-                    int,
-                    bool,
-                    str,
-                    torch.Tensor,
-                    torch.device,
-                    torch.dtype,
-                    torch.layout,
-                ),
-            ):
-                return True
-            if isinstance(arg, (tuple, list)):
-                return all(map(is_const, arg))
-            if isinstance(arg, dict):
-                return all(map(is_const, arg.values()))
-            return False
-
-        dequant_quant_ops = {
-            torch.ops.quantized_decomposed.quantize_per_channel.default,
-            torch.ops.quantized_decomposed.quantize_per_tensor.default,
-            torch.ops.quantized_decomposed.dequantize_per_channel.default,
-            torch.ops.quantized_decomposed.dequantize_per_tensor.default,
-            torch.ops.quantized_decomposed.quantize_per_channel.default,
-            torch.ops.quantized_decomposed.dequantize_per_channel.default,
-            ops.edge.quantized_decomposed.quantize_per_channel.default,
-            ops.edge.quantized_decomposed.quantize_per_tensor.default,
-            ops.edge.quantized_decomposed.dequantize_per_channel.default,
-            ops.edge.quantized_decomposed.dequantize_per_tensor.default,
-            ops.edge.quantized_decomposed.quantize_per_channel.default,
-            ops.edge.quantized_decomposed.dequantize_per_channel.default,
-        }
-        op_is_q_dq = op in dequant_quant_ops
+        op_is_q_dq = op in _quant_ops or op in _dequant_ops
         # XNOR relationship, if propogate_quant is true only const prop quant ops,
         # if false propogate everything but quant ops
         if (
             (not op_is_q_dq and not self.propogate_quant)
             or (op_is_q_dq and self.propogate_quant)
         ) and is_const([args, kwargs]):
-            guard = torch._C._DisableTorchDispatch()  # noqa
-            try:
-                args_data, kwargs_data = pytree.tree_map_only(
-                    ProxyValue, lambda x: x.data, (args, kwargs)
-                )
-                result = op(*args_data, **kwargs_data)
-            finally:
-                del guard
-            return result.to_tensor() if isinstance(result, ProxyValue) else result
+            return _evaluate(op, args, kwargs)
         else:
             return super().call_operator(op, args, kwargs, meta)
+
+
+class WeightQuantFoldingPass(ExportPass):
+    """
+    Folds the quantization of constant weights into the weights themselves, so
+    that it doesn't run on every inference.
+
+    Quantize ops over constants are always folded into quantized constants. If
+    keep_quantized_storage is False, the dequantize ops that consume those are
+    folded too, leaving float weights that have already been through the
+    quantization round trip; this suits graphs that run on float kernels. If it
+    is True, the weights stay quantized, which keeps the program small, and
+    are expected to feed quantized kernels, e.g. after QuantFusionPass.
+
+    Dequantize ops over activations, or over weights that were quantized ahead
+    of export, are left alone.
+    """
+
+    def __init__(self, keep_quantized_storage: bool = False) -> None:
+        super().__init__()
+        self.keep_quantized_storage = keep_quantized_storage
+        # The tensors produced by folding quantize ops. Holding on to them keeps
+        # their ids from being reused while the pass runs.
+        self._folded_quants: List[torch.Tensor] = []
+        self._folded_quant_ids: Set[int] = set()
+
+    # pyre-ignore
+    def _is_folded_quant(self, arg) -> bool:
+        if isinstance(arg, ProxyValue):
+            arg = arg.data
+        return id(arg) in self._folded_quant_ids
+
+    # pyre-ignore
+    def call_operator(self, op, args, kwargs, meta):
+        if op in _quant_ops and is_const([args, kwargs]):
+            result = _evaluate(op, args, kwargs)
+            self._folded_quants.append(result)
+            self._folded_quant_ids.add(id(result))
+            return result
+        if (
+            op in _dequant_ops
+            and not self.keep_quantized_storage
+            and self._is_folded_quant(args[0])
+            and is_const([args, kwargs])
+        ):
+            return _evaluate(op, args, kwargs)
+        return super().call_operator(op, args, kwargs, meta)
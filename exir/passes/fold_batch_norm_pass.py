@@ -0,0 +1,265 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import logging
+import operator
+from typing import Optional, Tuple
+
+import torch
+from executorch.exir.dialects._ops import ops as exir_ops
+from executorch.exir.dialects.backend._ops import BackendOpOverload
+from executorch.exir.dialects.edge._ops import EdgeOpOverload
+from torch.fx.passes.infra.pass_base import PassBase, PassResult
+
+
+def _op_name(node: object) -> str:
+    if (
+        not isinstance(node, torch.fx.Node)
+        or node.op != "call_function"
+        or not isinstance(
+            node.target, (torch._ops.OpOverload, EdgeOpOverload, BackendOpOverload)
+        )
+    ):
+        return ""
+    return node.target._schema.name
+
+
+def _get_constant(
+    module: torch.fx.GraphModule, node: object
+) -> Optional[torch.Tensor]:
+    """Returns the tensor of a get_attr node, and None for any other node."""
+    if not isinstance(node, torch.fx.Node) or node.op != "get_attr":
+        return None
+    value = module
+    for atom in str(node.target).split("."):
+        value = getattr(value, atom, None)
+    return value if isinstance(value, torch.Tensor) else None
+
+
+def _get_transposed_constant(
+    module: torch.fx.GraphModule, node: object
+) -> Optional[torch.Tensor]:
+    """
+    Returns mat2 of an addmm or mm as a constant: either a 2-D get_attr, or the
+    transpose of one, which is how linear weights appear in the edge dialect.
+    """
+    value = _get_constant(module, node)
+    if value is not None:
+        return value if value.dim() == 2 else None
+    name = _op_name(node)
+    if name == "aten::t_copy" or (
+        name == "aten::permute_copy" and list(node.args[1]) == [1, 0]
+    ):
+        value = _get_constant(module, node.args[0])
+        if value is not None and value.dim() == 2:
+            return value.t()
+    return None
+
+
+def _batch_norm_args(node: torch.fx.Node) -> Optional[Tuple[object, ...]]:
+    """
+    Returns (input, weight, bias, running_mean, running_var, eps) if node is an
+    inference batch norm, and None otherwise.
+    """
+    name = _op_name(node)
+    if name == "aten::_native_batch_norm_legit_no_training":
+        input, weight, bias, mean, var, _momentum, eps = node.args
+    elif name == "aten::native_batch_norm" and node.args[5] is False:
+        input, weight, bias, mean, var, _training, _momentum, eps = node.args
+    else:
+        return None
+    return input, weight, bias, mean, var, eps
+
+
+class FoldBatchNormPass(PassBase):
+    """
+    Folds inference batch norms into the weights and bias of the convolution,
+    addmm or mm that produces their input, when the weights, bias and batch
+    norm parameters are all constants. Batch norm is then an affine map of
+    each output channel, x * scale + shift, which the producer computes for
+    free by scaling its weights by `scale` and adding `shift` to its bias.
+
+    A producer is only folded into if the batch norm is its only user, and
+    only the normalized output of the batch norm may be used. Transposed
+    convolutions are left alone.
+    """
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        num_folded = 0
+        for module in graph_module.modules():
+            if not isinstance(module, torch.fx.GraphModule):
+                continue
+            num_folded += self._fold(module)
+            module.recompile()
+
+        logging.debug(f"Folded {num_folded} batch norms")
+        return PassResult(graph_module, num_folded > 0)
+
+    def _register_constant(
+        self, module: torch.fx.GraphModule, prefix: str, value: torch.Tensor
+    ) -> torch.fx.Node:
+        i = 0
+        while hasattr(module, f"{prefix}_{i}"):
+            i += 1
+        name = f"{prefix}_{i}"
+        module.register_buffer(name, value)
+        node = module.graph.get_attr(name)
+        node.meta["val"] = value
+        return node
+
+    def _fold(self, module: torch.fx.GraphModule) -> int:  # noqa: C901
+        graph = module.graph
+        num_folded = 0
+        for bn in list(graph.nodes):
+            bn_args = _batch_norm_args(bn)
+            if bn_args is None:
+                continue
+            producer, weight, bias, mean, var, eps = bn_args
+            if not isinstance(producer, torch.fx.Node) or len(producer.users) != 1:
+                continue
+            # Only the normalized output may be used; the others are empty.
+            if any(
+                user.target is not operator.getitem or user.args[1] != 0
+                for user in bn.users
+            ):
+                continue
+
+            mean_value = _get_constant(module, mean)
+            var_value = _get_constant(module, var)
+            weight_value = _get_constant(module, weight)
+            bias_value = _get_constant(module, bias)
+            if (
+                mean_value is None
+                or var_value is None
+                or (weight is not None and weight_value is None)
+                or (bias is not None and bias_value is None)
+            ):
+                continue
+
+            with torch.no_grad():
+                scale = torch.rsqrt(var_value + eps)
+                if weight_value is not None:
+                    scale = scale * weight_value
+                shift = -mean_value * scale
+                if bias_value is not None:
+                    shift = shift + bias_value
+
+                name = _op_name(producer)
+                if name == "aten::convolution":
+                    folded = self._fold_into_convolution(
+                        module, producer, scale, shift
+                    )
+                elif name in ("aten::addmm", "aten::mm"):
+                    folded = self._fold_into_matmul(module, producer, scale, shift)
+                else:
+                    folded = False
+            if not folded:
+                continue
+
+            for user in list(bn.users):
+                user.replace_all_uses_with(bn.args[0])
+                graph.erase_node(user)
+            graph.erase_node(bn)
+            num_folded += 1
+
+        # The original weights of the folded producers may now be unused.
+        for node in reversed(list(graph.nodes)):
+            if (
+                node.op == "get_attr"
+                or _op_name(node) in ("aten::t_copy", "aten::permute_copy")
+            ) and len(node.users) == 0:
+                graph.erase_node(node)
+        return num_folded
+
+    def _fold_into_convolution(
+        self,
+        module: torch.fx.GraphModule,
+        conv: torch.fx.Node,
+        scale: torch.Tensor,
+        shift: torch.Tensor,
+    ) -> bool:
+        # (input, weight, bias, stride, padding, dilation, transposed,
+        # output_padding, groups)
+        if len(conv.args) != 9 or conv.args[6]:
+            return False
+        weight = _get_constant(module, conv.args[1])
+        bias = _get_constant(module, conv.args[2])
+        if weight is None or (conv.args[2] is not None and bias is None):
+            return False
+        if weight.shape[0] != scale.shape[0]:
+            return False
+
+        # The output channels are the first dim of the weights.
+        folded_weight = weight * scale.reshape([-1] + [1] * (weight.dim() - 1))
+        folded_bias = shift if bias is None else bias * scale + shift
+        with module.graph.inserting_before(conv):
+            weight_node = self._register_constant(
+                module, "_folded_bn_weight", folded_weight
+            )
+            bias_node = self._register_constant(
+                module, "_folded_bn_bias", folded_bias
+            )
+        args = list(conv.args)
+        args[1] = weight_node
+        args[2] = bias_node
+        conv.args = tuple(args)
+        return True
+
+    def _fold_into_matmul(
+        self,
+        module: torch.fx.GraphModule,
+        matmul: torch.fx.Node,
+        scale: torch.Tensor,
+        shift: torch.Tensor,
+    ) -> bool:
+        is_addmm = _op_name(matmul) == "aten::addmm"
+        if any(matmul.kwargs.get(k, 1) != 1 for k in ("alpha", "beta")):
+            return False
+        if is_addmm:
+            bias_arg, input, mat2_arg = matmul.args
+            bias = _get_constant(module, bias_arg)
+            if bias is None:
+                return False
+        else:
+            input, mat2_arg = matmul.args
+            bias = None
+        mat2 = _get_transposed_constant(module, mat2_arg)
+        # Batch norm normalizes dim 1, the columns of a 2-D matmul result.
+        val = matmul.meta.get("val")
+        if (
+            mat2 is None
+            or mat2.shape[1] != scale.shape[0]
+            or not isinstance(val, torch.Tensor)
+            or val.dim() != 2
+        ):
+            return False
+
+        folded_mat2 = mat2 * scale.reshape(1, -1)
+        folded_bias = shift if bias is None else bias * scale + shift
+        graph = module.graph
+        with graph.inserting_before(matmul):
+            mat2_node = self._register_constant(
+                module, "_folded_bn_weight", folded_mat2.contiguous()
+            )
+            bias_node = self._register_constant(
+                module, "_folded_bn_bias", folded_bias
+            )
+            if is_addmm:
+                matmul.args = (bias_node, input, mat2_node)
+                return True
+            # mm has no bias, so it becomes an addmm.
+            addmm_op = (
+                exir_ops.edge.aten.addmm.default
+                if isinstance(matmul.target, EdgeOpOverload)
+                else torch.ops.aten.addmm.default
+            )
+            addmm = graph.call_function(addmm_op, (bias_node, input, mat2_node))
+        addmm.meta = matmul.meta.copy()
+        matmul.replace_all_uses_with(addmm)
+        graph.erase_node(matmul)
+        return True
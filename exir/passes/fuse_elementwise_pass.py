@@ -0,0 +1,282 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import logging
+from typing import Callable, Dict, List, Optional, Set, Tuple
+
+import torch
+from executorch.exir.dialects.backend._ops import BackendOpOverload
+from executorch.exir.dialects.edge._ops import EdgeOpOverload
+from executorch.exir.passes.executorch_prim_ops_registry import executorch_prims_lib
+from torch.fx.passes.infra.pass_base import PassBase, PassResult
+from torch.library import impl
+
+# The body of a fused_elementwise op is a program for a stack machine that
+# computes one output element from the elements at the same index of its
+# inputs. Each instruction is an opcode, followed by an operand for
+# LOAD_INPUT and LOAD_CONST. The program leaves the output on the stack.
+# Keep in sync with kernels/optimized/cpu/op_fused_elementwise.cpp.
+LOAD_INPUT = 0
+LOAD_CONST = 1
+ADD = 2
+SUB = 3
+MUL = 4
+DIV = 5
+MAXIMUM = 6
+MINIMUM = 7
+NEG = 8
+RELU = 9
+EXP = 10
+SIGMOID = 11
+TANH = 12
+
+# The limits of the runtime interpreter.
+MAX_STACK_DEPTH = 8
+MAX_INPUTS = 64
+
+_BINARY_OPS: Dict[int, Callable[[torch.Tensor, torch.Tensor], torch.Tensor]] = {
+    ADD: torch.add,
+    SUB: torch.sub,
+    MUL: torch.mul,
+    DIV: torch.div,
+    MAXIMUM: torch.maximum,
+    MINIMUM: torch.minimum,
+}
+
+_UNARY_OPS: Dict[int, Callable[[torch.Tensor], torch.Tensor]] = {
+    NEG: torch.neg,
+    RELU: torch.relu,
+    EXP: torch.exp,
+    SIGMOID: torch.sigmoid,
+    TANH: torch.tanh,
+}
+
+executorch_prims_lib.define(
+    "fused_elementwise(Tensor[] inputs, int[] code, float[] constants) -> Tensor"
+)
+
+executorch_prims_lib.define(
+    "fused_elementwise.out(Tensor[] inputs, int[] code, float[] constants, *, "
+    "Tensor(a!) out) -> Tensor(a!)"
+)
+
+
+@impl(executorch_prims_lib, "fused_elementwise", "CompositeExplicitAutograd")
+def fused_elementwise(
+    inputs: List[torch.Tensor], code: List[int], constants: List[float]
+) -> torch.Tensor:
+    stack = []
+    pc = 0
+    while pc < len(code):
+        opcode = code[pc]
+        if opcode == LOAD_INPUT:
+            stack.append(inputs[code[pc + 1]])
+            pc += 2
+            continue
+        if opcode == LOAD_CONST:
+            stack.append(
+                torch.tensor(constants[code[pc + 1]], dtype=inputs[0].dtype)
+            )
+            pc += 2
+            continue
+        if opcode in _BINARY_OPS:
+            rhs = stack.pop()
+            stack.append(_BINARY_OPS[opcode](stack.pop(), rhs))
+        elif opcode in _UNARY_OPS:
+            stack.append(_UNARY_OPS[opcode](stack.pop()))
+        else:
+            raise RuntimeError(f"Unknown fused_elementwise opcode {opcode}")
+        pc += 1
+    assert len(stack) == 1, "fused_elementwise code must leave one value"
+    # Broadcast in case the code only reads constants
+    return stack[0].expand(inputs[0].shape).clone()
+
+
+@impl(executorch_prims_lib, "fused_elementwise.out", "CompositeExplicitAutograd")
+def fused_elementwise_out(
+    inputs: List[torch.Tensor],
+    code: List[int],
+    constants: List[float],
+    *,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    out.copy_(fused_elementwise(inputs, code, constants))
+    return out
+
+
+# (schema name, overload name) -> (opcode, number of operands)
+_FUSIBLE_OPS: Dict[Tuple[str, str], Tuple[int, int]] = {
+    ("aten::add", "Tensor"): (ADD, 2),
+    ("aten::add", "Scalar"): (ADD, 2),
+    ("aten::sub", "Tensor"): (SUB, 2),
+    ("aten::sub", "Scalar"): (SUB, 2),
+    ("aten::mul", "Tensor"): (MUL, 2),
+    ("aten::mul", "Scalar"): (MUL, 2),
+    ("aten::div", "Tensor"): (DIV, 2),
+    ("aten::div", "Scalar"): (DIV, 2),
+    ("aten::maximum", ""): (MAXIMUM, 2),
+    ("aten::minimum", ""): (MINIMUM, 2),
+    ("aten::neg", ""): (NEG, 1),
+    ("aten::relu", ""): (RELU, 1),
+    ("aten::exp", ""): (EXP, 1),
+    ("aten::sigmoid", ""): (SIGMOID, 1),
+    ("aten::tanh", ""): (TANH, 1),
+}
+
+
+def _get_val(node: torch.fx.Node) -> Optional[torch.Tensor]:
+    val = node.meta.get("val")
+    return val if isinstance(val, torch.Tensor) else None
+
+
+def _is_fusible(node: torch.fx.Node) -> bool:
+    if node.op != "call_function" or not isinstance(
+        node.target, (torch._ops.OpOverload, EdgeOpOverload, BackendOpOverload)
+    ):
+        return False
+    schema = node.target._schema
+    entry = _FUSIBLE_OPS.get((schema.name, schema.overload_name))
+    if entry is None:
+        return False
+    _, num_operands = entry
+    # add and sub take an alpha that scales the second operand
+    if node.kwargs.get("alpha", 1) != 1 or len(node.args) != num_operands:
+        return False
+
+    val = _get_val(node)
+    if (
+        val is None
+        or val.dtype != torch.float32
+        or not val.is_contiguous()
+        or any(not isinstance(s, int) for s in val.shape)
+    ):
+        return False
+    # Operands are either tensors of the same shape as the output, read at
+    # the same index, or numbers. Broadcasting is left to the regular kernels.
+    for arg in node.args:
+        if isinstance(arg, (int, float)) and not isinstance(arg, bool):
+            continue
+        if not isinstance(arg, torch.fx.Node):
+            return False
+        arg_val = _get_val(arg)
+        if (
+            arg_val is None
+            or arg_val.dtype != torch.float32
+            or not arg_val.is_contiguous()
+            or arg_val.shape != val.shape
+        ):
+            return False
+    return True
+
+
+class _FusionGroup:
+    def __init__(self, root: torch.fx.Node) -> None:
+        self.root = root
+        self.members: Set[torch.fx.Node] = {root}
+        self.inputs: List[torch.fx.Node] = []
+        self.constants: List[float] = []
+        self.code: List[int] = []
+
+    def absorb(self, node: torch.fx.Node) -> None:
+        # A producer joins the group if nothing else reads its output, so that
+        # the output never needs to be materialized.
+        for arg in node.args:
+            if (
+                isinstance(arg, torch.fx.Node)
+                and arg not in self.members
+                and len(arg.users) == 1
+                and _is_fusible(arg)
+            ):
+                self.members.add(arg)
+                self.absorb(arg)
+
+    def emit(self, node: torch.fx.Node) -> int:
+        """Appends the code that computes node, and returns the stack depth
+        that it needs."""
+        if node not in self.members:
+            if node not in self.inputs:
+                self.inputs.append(node)
+            self.code += [LOAD_INPUT, self.inputs.index(node)]
+            return 1
+        opcode, _ = _FUSIBLE_OPS[
+            (node.target._schema.name, node.target._schema.overload_name)
+        ]
+        depth = 0
+        for i, arg in enumerate(node.args):
+            if isinstance(arg, torch.fx.Node):
+                arg_depth = self.emit(arg)
+            else:
+                self.constants.append(float(arg))
+                self.code += [LOAD_CONST, len(self.constants) - 1]
+                arg_depth = 1
+            # Earlier operands stay on the stack while later ones are computed
+            depth = max(depth, i + arg_depth)
+        self.code.append(opcode)
+        return depth
+
+
+class FuseElementwisePass(PassBase):
+    """
+    Fuses maximal trees of float elementwise ops, such as mul -> add -> relu,
+    into single executorch_prim::fused_elementwise ops, whose body is a small
+    bytecode that the runtime interprets for a block of elements at a time.
+    Intermediate results then never round-trip through memory, which
+    dominates the cost of chains of elementwise ops over large activations.
+
+    Only ops over contiguous float tensors of the same static shape, or
+    numbers, are fused. The fused op has a kernel in kernels/optimized, so
+    this pass only runs when ExecutorchBackendConfig.fuse_elementwise_ops is
+    set. It must run before SpecPropPass and ToOutVarPass.
+    """
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        num_fused = 0
+        for module in graph_module.modules():
+            if not isinstance(module, torch.fx.GraphModule):
+                continue
+            num_fused += self._fuse(module)
+            module.recompile()
+
+        logging.debug(f"Fused {num_fused} elementwise ops")
+        return PassResult(graph_module, num_fused > 0)
+
+    def _fuse(self, module: torch.fx.GraphModule) -> int:
+        graph = module.graph
+        fused: Set[torch.fx.Node] = set()
+        groups = []
+        # Roots are visited before their producers, so each group is maximal
+        for node in reversed(graph.nodes):
+            if node in fused or not _is_fusible(node):
+                continue
+            group = _FusionGroup(node)
+            group.absorb(node)
+            if len(group.members) < 2:
+                continue
+            if (
+                group.emit(node) > MAX_STACK_DEPTH
+                or len(group.inputs) > MAX_INPUTS
+            ):
+                continue
+            fused |= group.members
+            groups.append(group)
+
+        num_fused = 0
+        for group in groups:
+            root = group.root
+            with graph.inserting_before(root):
+                fused_node = graph.call_function(
+                    torch.ops.executorch_prim.fused_elementwise.default,
+                    (group.inputs, group.code, group.constants),
+                )
+            fused_node.meta = root.meta.copy()
+            root.replace_all_uses_with(fused_node)
+            # Erase users before the nodes that they read
+            for node in [n for n in reversed(graph.nodes) if n in group.members]:
+                graph.erase_node(node)
+            num_fused += len(group.members)
+        return num_fused
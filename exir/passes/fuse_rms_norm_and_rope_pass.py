@@ -0,0 +1,406 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import logging
+import operator
+from typing import List, Optional, Sequence, Tuple
+
+import torch
+from executorch.exir.dialects.backend._ops import BackendOpOverload
+from executorch.exir.dialects.edge._ops import EdgeOpOverload
+from executorch.exir.passes.executorch_prim_ops_registry import executorch_prims_lib
+from torch.fx.passes.infra.pass_base import PassBase, PassResult
+from torch.library import impl
+
+executorch_prims_lib.define(
+    "rms_norm(Tensor input, Tensor weight, float eps) -> Tensor"
+)
+
+executorch_prims_lib.define(
+    "rms_norm.out(Tensor input, Tensor weight, float eps, *, Tensor(a!) out) "
+    "-> Tensor(a!)"
+)
+
+executorch_prims_lib.define(
+    "rope(Tensor input, Tensor freqs_cos, Tensor freqs_sin) -> Tensor"
+)
+
+executorch_prims_lib.define(
+    "rope.out(Tensor input, Tensor freqs_cos, Tensor freqs_sin, *, "
+    "Tensor(a!) out) -> Tensor(a!)"
+)
+
+
+@impl(executorch_prims_lib, "rms_norm", "CompositeExplicitAutograd")
+def rms_norm(input: torch.Tensor, weight: torch.Tensor, eps: float) -> torch.Tensor:
+    return input * torch.rsqrt(input.pow(2).mean(-1, keepdim=True) + eps) * weight
+
+
+@impl(executorch_prims_lib, "rms_norm.out", "CompositeExplicitAutograd")
+def rms_norm_out(
+    input: torch.Tensor, weight: torch.Tensor, eps: float, *, out: torch.Tensor
+) -> torch.Tensor:
+    out.copy_(rms_norm(input, weight, eps))
+    return out
+
+
+@impl(executorch_prims_lib, "rope", "CompositeExplicitAutograd")
+def rope(
+    input: torch.Tensor, freqs_cos: torch.Tensor, freqs_sin: torch.Tensor
+) -> torch.Tensor:
+    # input is [batch, seq_len, n_heads, head_dim], and the freqs are
+    # [seq_len, head_dim / 2].
+    x_r, x_i = input.reshape(input.shape[:-1] + (-1, 2)).unbind(-1)
+    cos = freqs_cos.view(1, freqs_cos.shape[0], 1, freqs_cos.shape[1])
+    sin = freqs_sin.view(1, freqs_sin.shape[0], 1, freqs_sin.shape[1])
+    out_r = x_r * cos - x_i * sin
+    out_i = x_r * sin + x_i * cos
+    return torch.stack([out_r, out_i], dim=-1).flatten(3)
+
+
+@impl(executorch_prims_lib, "rope.out", "CompositeExplicitAutograd")
+def rope_out(
+    input: torch.Tensor,
+    freqs_cos: torch.Tensor,
+    freqs_sin: torch.Tensor,
+    *,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    out.copy_(rope(input, freqs_cos, freqs_sin))
+    return out
+
+
+def _get_val(node: torch.fx.Node) -> Optional[torch.Tensor]:
+    val = node.meta.get("val")
+    return val if isinstance(val, torch.Tensor) else None
+
+
+def _is_float_contiguous(node: object, ndim: Optional[int] = None) -> bool:
+    if not isinstance(node, torch.fx.Node):
+        return False
+    val = _get_val(node)
+    return (
+        val is not None
+        and val.dtype == torch.float32
+        and val.is_contiguous()
+        and (ndim is None or val.dim() == ndim)
+        and all(isinstance(s, int) for s in val.shape)
+    )
+
+
+def _args_of(
+    node: object, name: str, overloads: Sequence[str] = ("",)
+) -> Optional[Tuple[object, ...]]:
+    """Returns the args of node if it calls the given op, and None otherwise."""
+    if (
+        not isinstance(node, torch.fx.Node)
+        or node.op != "call_function"
+        or not isinstance(
+            node.target, (torch._ops.OpOverload, EdgeOpOverload, BackendOpOverload)
+        )
+    ):
+        return None
+    schema = node.target._schema
+    if schema.name != name or schema.overload_name not in overloads:
+        return None
+    # add and sub take an alpha that scales the second operand
+    if node.kwargs.get("alpha", 1) != 1:
+        return None
+    return tuple(node.args)
+
+
+def _mul_operands(node: object) -> Optional[Tuple[object, object]]:
+    args = _args_of(node, "aten::mul", ("Tensor",))
+    return (args[0], args[1]) if args is not None and len(args) == 2 else None
+
+
+def _is_last_dim(dim: object, ndim: int) -> bool:
+    return dim in (-1, ndim - 1)
+
+
+def _match_normalized(
+    node: object,
+) -> Optional[Tuple[torch.fx.Node, float, List[torch.fx.Node]]]:
+    """
+    Matches x * rsqrt(mean(x^2, -1, keepdim=True) + eps), and returns x, eps
+    and the matched nodes.
+    """
+    operands = _mul_operands(node)
+    if operands is None:
+        return None
+    for x, rsqrt in (operands, operands[::-1]):
+        if not _is_float_contiguous(x):
+            continue
+        rsqrt_args = _args_of(rsqrt, "aten::rsqrt")
+        add_args = rsqrt_args and _args_of(
+            rsqrt_args[0], "aten::add", ("Tensor", "Scalar")
+        )
+        if not add_args or len(add_args) != 2:
+            continue
+        mean, eps = add_args
+        if not isinstance(eps, (int, float)) or isinstance(eps, bool):
+            continue
+        mean_args = _args_of(mean, "aten::mean", ("dim",))
+        if (
+            mean_args is None
+            or len(mean_args) != 3
+            or mean_args[2] is not True
+            or mean.kwargs.get("dtype") is not None
+            or len(mean_args[1]) != 1
+            or not _is_last_dim(mean_args[1][0], _get_val(x).dim())
+        ):
+            continue
+        square = mean_args[0]
+        pow_args = _args_of(square, "aten::pow", ("Tensor_Scalar",))
+        if pow_args == (x, 2) or _mul_operands(square) == (x, x):
+            return x, float(eps), [node, rsqrt, rsqrt_args[0], mean, square]
+    return None
+
+
+# The args of the op that replaces a match, the nodes of the match, root
+# first, and the nodes that it may share with other matches.
+_Match = Tuple[Tuple[object, ...], List[torch.fx.Node], List[torch.fx.Node]]
+
+
+def _match_rms_norm(node: torch.fx.Node) -> Optional[_Match]:
+    """Matches Llama's RMSNorm, normalized(x) * weight."""
+    operands = _mul_operands(node)
+    if operands is None:
+        return None
+    for normalized, weight in (operands, operands[::-1]):
+        match = _match_normalized(normalized)
+        if match is None or not _is_float_contiguous(weight, ndim=1):
+            continue
+        x, eps, members = match
+        if _get_val(weight).shape[0] != _get_val(x).shape[-1]:
+            continue
+        return (x, weight, eps), [node] + members, []
+    return None
+
+
+def _match_half(node: object) -> Optional[Tuple[torch.fx.Node, int]]:
+    """
+    Matches the even (0) or odd (1) elements of the pairs of x, taken from
+    view(x, [..., head_dim / 2, 2]) by select() or unbind(), and returns the
+    view and which of the two.
+    """
+    select_args = _args_of(node, "aten::select_copy", ("int",))
+    if select_args is not None:
+        view, dim, index = select_args
+    elif (
+        isinstance(node, torch.fx.Node)
+        and node.op == "call_function"
+        and node.target is operator.getitem
+    ):
+        unbind_args = _args_of(node.args[0], "aten::unbind_copy", ("int",))
+        if unbind_args is None:
+            return None
+        view = unbind_args[0]
+        dim = unbind_args[1] if len(unbind_args) > 1 else 0
+        index = node.args[1]
+    else:
+        return None
+    if index not in (0, 1) or not _is_last_dim(dim, 5):
+        return None
+    return view, index
+
+
+def _match_product(
+    node: object,
+) -> Optional[Tuple[torch.fx.Node, int, torch.fx.Node]]:
+    """
+    Matches half * freqs for a half of _match_half(), and returns the view,
+    which half and the freqs.
+    """
+    operands = _mul_operands(node)
+    if operands is None:
+        return None
+    for half, freqs in (operands, operands[::-1]):
+        match = _match_half(half)
+        if match is not None and isinstance(freqs, torch.fx.Node):
+            return match[0], match[1], freqs
+    return None
+
+
+def _match_freqs(node: torch.fx.Node, x_val: torch.Tensor) -> Optional[object]:
+    """
+    Matches the view of [seq_len, head_dim / 2] freqs as
+    [1, seq_len, 1, head_dim / 2] of reshape_for_broadcast(), and returns the
+    freqs.
+    """
+    view_args = _args_of(node, "aten::view_copy")
+    if (
+        view_args is None
+        or not _is_float_contiguous(node)
+        or not _is_float_contiguous(view_args[0], ndim=2)
+    ):
+        return None
+    _, seq_len, _, head_dim = x_val.shape
+    if list(_get_val(node).shape) != [1, seq_len, 1, head_dim // 2] or list(
+        _get_val(view_args[0]).shape
+    ) != [seq_len, head_dim // 2]:
+        return None
+    return view_args[0]
+
+
+def _match_rope(node: torch.fx.Node) -> Optional[_Match]:
+    """
+    Matches Llama's apply_rotary_emb() for one of xq or xk:
+
+        x_r, x_i = x.reshape(x.shape[:-1] + (-1, 2)).unbind(-1)
+        out_r = x_r * freqs_cos - x_i * freqs_sin
+        out_i = x_r * freqs_sin + x_i * freqs_cos
+        out = torch.stack([out_r, out_i], dim=-1).flatten(3)
+
+    where the freqs are viewed as [1, seq_len, 1, head_dim / 2].
+    """
+    flatten_args = _args_of(node, "aten::view_copy")
+    if flatten_args is None:
+        return None
+    members = [node]
+    stacked = flatten_args[0]
+    # stack() is decomposed into cat() of unsqueeze()s
+    cat_args = _args_of(stacked, "aten::cat")
+    stack_args = _args_of(stacked, "aten::stack")
+    if cat_args is not None and len(cat_args) == 2:
+        parts, dim = cat_args
+        outs = []
+        for part in parts:
+            unsqueeze_args = _args_of(part, "aten::unsqueeze_copy")
+            if unsqueeze_args is None or not _is_last_dim(unsqueeze_args[1], 5):
+                return None
+            outs.append(unsqueeze_args[0])
+            members.append(part)
+    elif stack_args is not None and len(stack_args) == 2:
+        outs, dim = stack_args
+    else:
+        return None
+    if len(outs) != 2 or not _is_last_dim(dim, 5):
+        return None
+    members.append(stacked)
+    out_r, out_i = outs
+
+    sub_args = _args_of(out_r, "aten::sub", ("Tensor",))
+    add_args = _args_of(out_i, "aten::add", ("Tensor",))
+    if sub_args is None or add_args is None:
+        return None
+    products = [_match_product(p) for p in (*sub_args, *add_args)]
+    if any(p is None for p in products):
+        return None
+    (view, r0, cos), (view1, i1, sin) = products[:2]
+    # out_i adds its products in either order
+    by_half = {p[1]: p for p in products[2:]}
+    if (
+        (r0, i1) != (0, 1)
+        or set(by_half) != {0, 1}
+        or {view1, by_half[0][0], by_half[1][0]} != {view}
+        or by_half[0][2] is not sin
+        or by_half[1][2] is not cos
+    ):
+        return None
+
+    view_args = _args_of(view, "aten::view_copy")
+    if (
+        view_args is None
+        or not _is_float_contiguous(view_args[0], ndim=4)
+        or not _is_float_contiguous(view)
+        or not _is_float_contiguous(node)
+    ):
+        return None
+    x = view_args[0]
+    x_val = _get_val(x)
+    batch, seq_len, n_heads, head_dim = x_val.shape
+    if (
+        head_dim % 2 != 0
+        or list(_get_val(view).shape) != [batch, seq_len, n_heads, head_dim // 2, 2]
+        or _get_val(node).shape != x_val.shape
+    ):
+        return None
+    freqs_cos = _match_freqs(cos, x_val)
+    freqs_sin = _match_freqs(sin, x_val)
+    if freqs_cos is None or freqs_sin is None:
+        return None
+
+    members += [out_r, out_i, *sub_args, *add_args]
+    for product in (*sub_args, *add_args):
+        half = next(a for a in product.args if _match_half(a) is not None)
+        members.append(half)
+        if _args_of(half, "aten::select_copy", ("int",)) is None:
+            members.append(half.args[0])
+    members.append(view)
+    # The freqs views are shared by the xq and xk patterns.
+    return (x, freqs_cos, freqs_sin), list(dict.fromkeys(members)), [cos, sin]
+
+
+class FuseRMSNormAndRoPEPass(PassBase):
+    """
+    Replaces the decompositions of Llama's RMSNorm and rotary embeddings
+    (apply_rotary_emb() of one of xq or xk) with executorch_prim::rms_norm
+    and executorch_prim::rope ops. Each pattern is otherwise a dozen small
+    portable ops, such as pow, mean, rsqrt, mul, select_copy and cat, over
+    tensors of the size of the activations, which dominate decoding time once
+    the matmuls are fast.
+
+    The patterns are matched structurally on the edge dialect graph, over
+    contiguous float tensors of static shapes, and are only replaced if their
+    intermediate results are not used elsewhere. The fused ops have kernels in
+    kernels/optimized, so this pass only runs when
+    ExecutorchBackendConfig.fuse_rms_norm_and_rope is set. It must run before
+    SpecPropPass and ToOutVarPass.
+    """
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        num_fused = 0
+        for module in graph_module.modules():
+            if not isinstance(module, torch.fx.GraphModule):
+                continue
+            num_fused += self._fuse(module)
+            module.recompile()
+
+        logging.debug(f"Fused {num_fused} RMSNorm and rotary embedding patterns")
+        return PassResult(graph_module, num_fused > 0)
+
+    def _fuse(self, module: torch.fx.GraphModule) -> int:
+        graph = module.graph
+        num_fused = 0
+        erased = set()
+        position = {node: i for i, node in enumerate(graph.nodes)}
+        for node in reversed(position):
+            if node in erased or node.op != "call_function":
+                continue
+            for target, matcher in (
+                (torch.ops.executorch_prim.rms_norm.default, _match_rms_norm),
+                (torch.ops.executorch_prim.rope.default, _match_rope),
+            ):
+                match = matcher(node)
+                if match is None:
+                    continue
+                args, members, shared = match
+                # Intermediate results that are used elsewhere would have to
+                # be computed anyway.
+                allowed_users = set(members) | set(shared)
+                if any(
+                    user not in allowed_users
+                    for member in members[1:]
+                    for user in member.users
+                ):
+                    continue
+                with graph.inserting_before(node):
+                    fused_node = graph.call_function(target, args)
+                fused_node.meta = node.meta.copy()
+                node.replace_all_uses_with(fused_node)
+                # Erase users before the nodes that they read
+                for member in sorted(
+                    members + shared, key=lambda n: position[n], reverse=True
+                ):
+                    if len(member.users) == 0:
+                        graph.erase_node(member)
+                        erased.add(member)
+                num_fused += 1
+                break
+        return num_fused
@@ -0,0 +1,203 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import logging
+import operator
+from typing import Any, Dict, List, Optional, Set, Tuple
+
+import torch
+from torch.fx.passes.infra.pass_base import PassBase, PassResult
+
+
+def _nbytes(value: Any) -> int:
+    """The bytes of the tensors in a node's "val", or 0 if they are unknown."""
+    if isinstance(value, torch.Tensor):
+        try:
+            return int(value.numel()) * value.element_size()
+        except Exception:
+            # Unbacked symbolic sizes have no hint.
+            return 0
+    if isinstance(value, (list, tuple)):
+        return sum(_nbytes(v) for v in value)
+    return 0
+
+
+def _is_effectful(node: torch.fx.Node) -> bool:
+    """Whether the node must keep its place relative to other such nodes."""
+    if node.op != "call_function":
+        return False
+    if node.is_impure():
+        return True
+    schema = getattr(node.target, "_schema", None)
+    return schema is not None and schema.is_mutable
+
+
+class _Schedule:
+    """The nodes of one graph, and what scheduling each of them costs."""
+
+    def __init__(self, graph: torch.fx.Graph) -> None:
+        self.nodes: List[torch.fx.Node] = [
+            n for n in graph.nodes if n.op not in ("placeholder", "get_attr", "output")
+        ]
+        self.position: Dict[torch.fx.Node, int] = {
+            n: i for i, n in enumerate(self.nodes)
+        }
+        # The bytes that each node's output holds while it is live. Inputs and
+        # constants are live for the whole execution, so they are not counted,
+        # and getitems share the storage of the node they index into.
+        self.size: Dict[torch.fx.Node, int] = {
+            n: 0 if self._is_getitem(n) else _nbytes(n.meta.get("val"))
+            for n in self.nodes
+        }
+        # The storage that each node reads, and the number of nodes that read
+        # each storage. Storage that the graph returns is never freed.
+        self.reads: Dict[torch.fx.Node, Set[torch.fx.Node]] = {}
+        self.num_readers: Dict[torch.fx.Node, int] = {n: 0 for n in self.nodes}
+        self.returned: Set[torch.fx.Node] = set()
+        for n in self.nodes:
+            reads = (
+                set()
+                if self._is_getitem(n)
+                else {
+                    self._owner(d) for d in n.all_input_nodes if d in self.position
+                }
+            )
+            self.reads[n] = reads
+            for d in reads:
+                self.num_readers[d] += 1
+            if any(u.op == "output" for u in n.users):
+                self.returned.add(self._owner(n))
+        # The nodes that each node must run after.
+        self.deps: Dict[torch.fx.Node, Set[torch.fx.Node]] = {}
+        previous_effect: Optional[torch.fx.Node] = None
+        for n in self.nodes:
+            deps = {d for d in n.all_input_nodes if d in self.position}
+            if _is_effectful(n):
+                if previous_effect is not None:
+                    deps.add(previous_effect)
+                previous_effect = n
+            self.deps[n] = deps
+        self.dependents: Dict[torch.fx.Node, Set[torch.fx.Node]] = {
+            n: set() for n in self.nodes
+        }
+        for n, deps in self.deps.items():
+            for d in deps:
+                self.dependents[d].add(n)
+
+    def _is_getitem(self, n: torch.fx.Node) -> bool:
+        return (
+            n.op == "call_function"
+            and n.target is operator.getitem
+            and n.args[0] in self.position
+        )
+
+    def _owner(self, n: torch.fx.Node) -> torch.fx.Node:
+        """The node whose output storage n's output lives in."""
+        return n.args[0] if self._is_getitem(n) else n
+
+    def _freed(self, n: torch.fx.Node, readers: Dict[torch.fx.Node, int]) -> int:
+        """The bytes that running n frees, given the readers still to run."""
+        freed = 0
+        for d in self.reads[n]:
+            if readers[d] == 1 and d not in self.returned:
+                freed += self.size[d]
+        if readers[n] == 0 and n not in self.returned:
+            # Outputs that nothing reads are dead right away.
+            freed += self.size[n]
+        return freed
+
+    def _run(self, n: torch.fx.Node, readers: Dict[torch.fx.Node, int]) -> None:
+        for d in self.reads[n]:
+            readers[d] -= 1
+
+    def peak(self, order: List[torch.fx.Node]) -> int:
+        """The most bytes of outputs that are live at once when running in order."""
+        readers = dict(self.num_readers)
+        live = 0
+        peak = 0
+        for n in order:
+            live += self.size[n]
+            peak = max(peak, live)
+            live -= self._freed(n, readers)
+            self._run(n, readers)
+        return peak
+
+    def greedy(self) -> List[torch.fx.Node]:
+        """
+        A topological order that at each step runs the ready node that grows
+        the live bytes the least, preferring nodes that consume what was just
+        produced, then the original order.
+        """
+        readers = dict(self.num_readers)
+        num_deps = {n: len(self.deps[n]) for n in self.nodes}
+        scheduled_at: Dict[torch.fx.Node, int] = {}
+        ready = [n for n in self.nodes if num_deps[n] == 0]
+        order: List[torch.fx.Node] = []
+
+        def key(n: torch.fx.Node) -> Tuple[int, int, int]:
+            growth = self.size[n] - self._freed(n, readers)
+            recency = max((scheduled_at[d] for d in self.deps[n]), default=-1)
+            return (growth, -recency, self.position[n])
+
+        while ready:
+            best = min(ready, key=key)
+            ready.remove(best)
+            scheduled_at[best] = len(order)
+            order.append(best)
+            self._run(best, readers)
+            for u in self.dependents[best]:
+                num_deps[u] -= 1
+                if num_deps[u] == 0:
+                    ready.append(u)
+        assert len(order) == len(self.nodes), "Graph has a cycle"
+        return order
+
+
+class MemoryAwareSchedulePass(PassBase):
+    """
+    Reorders independent nodes so that fewer intermediate tensors are live at
+    once, which lowers the arena size that memory planning needs. The emitted
+    instructions otherwise follow the order in which the graph was traced,
+    which for wide networks such as Inception keeps all branches of a block
+    alive until they are concatenated.
+
+    The new order is chosen greedily, and only kept if it lowers the peak of
+    live bytes estimated from the nodes' "val" metadata. Nodes with side
+    effects, such as in-place updates of mutable buffers, keep their order
+    relative to each other. Runs on the graphs of control flow submodules too,
+    each on its own. Must run before ToOutVarPass and memory planning.
+    """
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        modified = False
+        for module in graph_module.modules():
+            if not isinstance(module, torch.fx.GraphModule):
+                continue
+            if self._reorder(module):
+                module.graph.lint()
+                module.recompile()
+                modified = True
+        return PassResult(graph_module, modified)
+
+    def _reorder(self, module: torch.fx.GraphModule) -> bool:
+        schedule = _Schedule(module.graph)
+        if len(schedule.nodes) < 3:
+            return False
+        order = schedule.greedy()
+        before = schedule.peak(schedule.nodes)
+        after = schedule.peak(order)
+        if after >= before:
+            return False
+        logging.debug(
+            f"Reordered {len(order)} nodes, peak live bytes {before} -> {after}"
+        )
+        output = next(n for n in module.graph.nodes if n.op == "output")
+        for n in order:
+            # Moves n to just before the output, so the nodes end up in order.
+            output.prepend(n)
+        return True
@@ -4,8 +4,10 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
+import functools
 import logging
 import warnings
+from typing import Callable, List, Optional
 
 import torch
 from executorch.exir.error import internal_assert
@@ -13,13 +15,18 @@ from executorch.exir.memory import alloc
 from executorch.exir.memory_planning import (
     _is_out_var_node,
     apply_algo,
+    format_memory_planning_report,
     get_algo,
     get_node_tensor_specs,
+    MemoryTier,
+    plan_memory_tiers,
+    plan_mutable_buffers,
     Verifier,
 )
 from executorch.exir.operator.convert import get_out_args_from_opoverload
 from executorch.exir.pass_base import PassBase, PassResult
 from executorch.exir.tensor import ALIGNMENT
+from torch.fx import Node
 
 
 class MemoryPlanningPass(PassBase):
@@ -30,18 +37,32 @@ class MemoryPlanningPass(PassBase):
         alloc_graph_input: bool = True,
         alloc_graph_output: bool = True,
         alignment: int = ALIGNMENT,
+        allow_in_place: bool = False,
+        mutable_buffer_mem_id: Optional[int] = None,
     ) -> None:
         r"""
         alloc_graph_input/alloc_graph_output will have 4 different combinations
         to control if the memory planning algorithm need allocate memory for
         the graph input/output. The default behavior is the algorithm will allocate
         memory for both graph input and output.
+
+        If allow_in_place is True, elementwise ops whose `self` argument is not
+        used afterwards write their output into its storage; see
+        plan_in_place_ops(). The kernels used at runtime must support their
+        output aliasing `self`, as the portable kernels do.
+
+        Buffers that the program mutates, e.g. a KV cache, are planned for the
+        whole method and updated in place; see plan_mutable_buffers(). If
+        mutable_buffer_mem_id is given they get that memory buffer to
+        themselves, which the runtime keeps across executions like the rest.
         """
         self.memory_planning_algo = memory_planning_algo
         self.allow_lifetime_and_storage_overlap = allow_lifetime_and_storage_overlap
         self.alloc_graph_input = alloc_graph_input
         self.alloc_graph_output = alloc_graph_output
         self.alignment = alignment
+        self.allow_in_place = allow_in_place
+        self.mutable_buffer_mem_id = mutable_buffer_mem_id
 
     def _set_alloc_node_spec(self, graph_module: torch.fx.GraphModule) -> None:
         """
@@ -81,25 +102,38 @@ class MemoryPlanningPass(PassBase):
                         )
                         out_alloc_node.meta["spec"] = specs[i]
 
+    def _get_algo(self) -> Callable[..., List[int]]:
+        return get_algo(self.memory_planning_algo)
+
     def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
         """
         A pass for memory planning. The actual algorithm used will be picked by
         memory_planning_algo
         """
+        plan_mutable_buffers(graph_module, self.mutable_buffer_mem_id)
         self._set_alloc_node_spec(graph_module)
-        algo = get_algo(self.memory_planning_algo)
+        algo = self._get_algo()
 
         # TODO(shunting) if people have concern of adding a field to GraphModule
         # directly, we should define a GraphModule subclass that we can add our
         # customized fields. Using the graph_module object to convey information across
         # passes/stages is quite natural and avoid yet another 'context' data structure
         # to do the job.
-        _ = apply_algo(
+        bufsizes = apply_algo(
             algo,
             graph_module,
             self.alignment,
             self.alloc_graph_input,
             self.alloc_graph_output,
+            self.allow_in_place,
+        )
+        # The lower bounds only cover the top-level graph, so they stay valid
+        # but may be loose for graphs with control flow.
+        logging.info(
+            f"Memory planned by the {self.memory_planning_algo} algorithm:\n"
+            + format_memory_planning_report(
+                bufsizes, graph_module.meta["non_const_buffer_lower_bounds"]
+            )
         )
 
         # TODO: make the verifier do the work recursively to handle
@@ -115,3 +149,35 @@ class MemoryPlanningPass(PassBase):
         )
         verifier.verify_graph_input_output()
         return PassResult(graph_module, True)
+
+
+class TieredMemoryPlanningPass(MemoryPlanningPass):
+    def __init__(
+        self,
+        tiers: List[MemoryTier],
+        memory_planning_algo: str = "greedy",
+        is_hot: Optional[Callable[[Node], bool]] = None,
+        **kwargs,
+    ) -> None:
+        r"""
+        Memory planning that places tensors in several memory buffers, e.g. a
+        small SRAM or TCM buffer and a large DRAM one, respecting the capacity
+        of each. `tiers` is ordered from fastest to slowest; the last tier
+        should be unbounded. Small tensors that many nodes access get the fast
+        tiers first. If `is_hot` is given, only tensors produced by nodes that
+        it returns True for are considered for the tiers before the last.
+
+        Tensors that already have a mem_id (e.g. set by an earlier pass) keep
+        it. The remaining arguments are the same as for MemoryPlanningPass.
+        """
+        super().__init__(memory_planning_algo, **kwargs)
+        self.tiers = tiers
+        self.is_hot = is_hot
+
+    def _get_algo(self) -> Callable[..., List[int]]:
+        return functools.partial(
+            plan_memory_tiers,
+            algo=super()._get_algo(),
+            tiers=self.tiers,
+            is_hot=self.is_hot,
+        )
@@ -90,6 +90,75 @@ def _fuse_quantized_cat(model: GraphModule) -> None:
         model.graph.erase_node(qnode)
 
 
+def _fuse_quantized_avg_pool2d(model: GraphModule) -> None:
+    """fuse "dequantize -> avg_pool2d -> quantize" pattern to the quantized avg_pool2d
+    operator, the trailing arguments of avg_pool2d are optional so they are filled from
+    the schema before the replacement, rather than matched with a fixed pattern
+    """
+    for n in model.graph.nodes:
+        if (
+            n.op != "call_function"
+            or n.target
+            != exir_ops.edge.quantized_decomposed.quantize_per_tensor.default
+        ):
+            continue
+        qnode = n
+        maybe_pool = qnode.args[0]
+        if (
+            maybe_pool.op != "call_function"
+            or maybe_pool.target != exir_ops.edge.aten.avg_pool2d.default
+            or len(maybe_pool.users) != 1
+        ):
+            continue
+        dqnode = maybe_pool.args[0]
+        if (
+            dqnode.op != "call_function"
+            or dqnode.target
+            != exir_ops.edge.quantized_decomposed.dequantize_per_tensor.default
+        ):
+            continue
+        # the kernel only requantizes 8-bit values of the same dtype
+        if dqnode.args[5] != qnode.args[5] or qnode.args[5] not in (
+            torch.uint8,
+            torch.int8,
+        ):
+            continue
+
+        pool_args = list(maybe_pool.args)
+        for arg in maybe_pool.target._schema.arguments[len(pool_args) :]:
+            pool_args.append(maybe_pool.kwargs.get(arg.name, arg.default_value))
+        (
+            _,
+            kernel_size,
+            stride,
+            padding,
+            ceil_mode,
+            count_include_pad,
+            divisor_override,
+        ) = pool_args
+
+        with model.graph.inserting_before(qnode):
+            fused = model.graph.call_function(
+                exir_ops.edge.quantized_decomposed.avg_pool2d.default,
+                (
+                    dqnode.args[0],
+                    dqnode.args[1],
+                    dqnode.args[2],
+                    kernel_size,
+                    stride,
+                    padding,
+                    ceil_mode,
+                    count_include_pad,
+                    divisor_override,
+                    *qnode.args[1:5],
+                ),
+            )
+        fused.meta = qnode.meta
+        qnode.replace_all_uses_with(fused)
+        model.graph.erase_node(qnode)
+        model.graph.erase_node(maybe_pool)
+
+
 class QuantFusionPass(ExportPass):
     def __init__(self, _fix_node_meta_val=False):
         super().__init__()
@@ -116,6 +185,7 @@ class QuantFusionPass(ExportPass):
             )
 
         _fuse_quantized_cat(graph_module)
+        _fuse_quantized_avg_pool2d(graph_module)
         if self._fix_node_meta_val:
             for n in graph_module.graph.nodes:
                 if n.op == "call_function" and "val" not in n.meta:
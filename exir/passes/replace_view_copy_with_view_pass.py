@@ -0,0 +1,99 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import logging
+from typing import Optional
+
+import torch
+from executorch.exir import memory
+from executorch.exir.dialects.backend._ops import BackendOpOverload
+from executorch.exir.dialects.edge._ops import EdgeOpOverload
+from executorch.exir.tensor import TensorSpec
+from torch.fx.passes.infra.pass_base import PassBase, PassResult
+
+# Copy ops whose output, for a contiguous input, holds exactly the bytes of
+# the input: only the sizes differ. expand_copy and t_copy are not among them,
+# since their outputs are strided differently from their inputs and
+# ExecuTorch tensors are always dense.
+_VIEW_COPY_OPS = {
+    "aten::alias_copy",
+    "aten::detach_copy",
+    "aten::squeeze_copy",
+    "aten::unsqueeze_copy",
+    "aten::view_copy",
+}
+
+
+def _get_spec(node: torch.fx.Node) -> Optional[TensorSpec]:
+    spec = node.meta.get("spec")
+    return spec if isinstance(spec, TensorSpec) else None
+
+
+def _is_contiguous_static(spec: TensorSpec) -> bool:
+    return spec.is_static_shape_tensor and list(spec.dim_order) == list(
+        range(len(spec.shape))
+    )
+
+
+def _is_view_copy(node: torch.fx.Node) -> bool:
+    if node.op != "call_function" or not isinstance(
+        node.target, (torch._ops.OpOverload, EdgeOpOverload, BackendOpOverload)
+    ):
+        return False
+    schema = node.target._schema
+    return schema.name in _VIEW_COPY_OPS and schema.overload_name != "out"
+
+
+def _can_alias(node: torch.fx.Node) -> bool:
+    base = node.args[0]
+    if not isinstance(base, torch.fx.Node) or base.op == "get_attr":
+        return False
+    base_spec = _get_spec(base)
+    spec = _get_spec(node)
+    if base_spec is None or spec is None or base_spec.const:
+        return False
+    # The runtime may swap the data pointer of a graph output for a buffer
+    # provided by the caller, which would silently break the alias.
+    if any(user.op == "output" for user in node.users):
+        return False
+    return (
+        _is_contiguous_static(base_spec)
+        and _is_contiguous_static(spec)
+        and base_spec.dtype == spec.dtype
+    )
+
+
+class ReplaceViewCopyWithViewPass(PassBase):
+    """
+    Replaces view-like *_copy ops with memory.view, whose output aliases the
+    storage of its input instead of holding a copy of it: memory planning
+    places the output at the same offset as the input, and at runtime it is a
+    call to executorch_prim::et_view, which only sets up tensor metadata.
+
+    Only ops with static, contiguous inputs and outputs are replaced. This pass
+    must run after SpecPropPass and before ToOutVarPass.
+    """
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        num_replaced = 0
+        for module in graph_module.modules():
+            if not isinstance(module, torch.fx.GraphModule):
+                continue
+            for node in module.graph.nodes:
+                if not _is_view_copy(node) or not _can_alias(node):
+                    continue
+                spec = _get_spec(node)
+                assert spec is not None
+                node.target = memory.view
+                node.args = (node.args[0], list(spec.shape))
+                node.kwargs = {}
+                num_replaced += 1
+            module.recompile()
+
+        logging.debug(f"Replaced {num_replaced} view copies with views")
+        return PassResult(graph_module, num_replaced > 0)
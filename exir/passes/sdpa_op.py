@@ -0,0 +1,78 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+"""
+executorch_prim::sdpa, a fused scaled dot product attention that models call
+directly, such as the Llama 2 example with use_sdpa_op. Its kernel in
+kernels/optimized tiles over the keys with an online softmax, so the scores
+of all queries against all keys are never materialized.
+"""
+
+import math
+from typing import Optional
+
+import torch
+from executorch.exir.passes.executorch_prim_ops_registry import executorch_prims_lib
+from torch.library import impl
+
+executorch_prims_lib.define(
+    "sdpa(Tensor query, Tensor key, Tensor value, Tensor? attn_mask=None, "
+    "bool is_causal=False, float? scale=None) -> Tensor"
+)
+
+executorch_prims_lib.define(
+    "sdpa.out(Tensor query, Tensor key, Tensor value, Tensor? attn_mask=None, "
+    "bool is_causal=False, float? scale=None, *, Tensor(a!) out) -> Tensor(a!)"
+)
+
+
+@impl(executorch_prims_lib, "sdpa", "CompositeExplicitAutograd")
+def sdpa(
+    query: torch.Tensor,
+    key: torch.Tensor,
+    value: torch.Tensor,
+    attn_mask: Optional[torch.Tensor] = None,
+    is_causal: bool = False,
+    scale: Optional[float] = None,
+) -> torch.Tensor:
+    """
+    softmax(query @ key^T * scale + attn_mask) @ value, for
+    [batch, heads, q_len, head_dim] queries and
+    [batch, kv_heads, kv_len, head_dim] keys and values. Each group of
+    heads / kv_heads consecutive heads shares a key and value head. The causal
+    mask is aligned to the last key, so that query i sees the keys up to
+    i + kv_len - q_len. scale defaults to 1 / sqrt(head_dim).
+    """
+    n_rep = query.shape[1] // key.shape[1]
+    key = key.repeat_interleave(n_rep, dim=1)
+    value = value.repeat_interleave(n_rep, dim=1)
+    if scale is None:
+        scale = 1.0 / math.sqrt(query.shape[-1])
+    scores = torch.matmul(query, key.transpose(2, 3)) * scale
+    if attn_mask is not None:
+        scores = scores + attn_mask
+    if is_causal:
+        q_len, kv_len = scores.shape[-2:]
+        causal = torch.ones(q_len, kv_len, dtype=torch.bool).tril(kv_len - q_len)
+        scores = scores.masked_fill(~causal, float("-inf"))
+    return torch.matmul(torch.softmax(scores, dim=-1), value)
+
+
+@impl(executorch_prims_lib, "sdpa.out", "CompositeExplicitAutograd")
+def sdpa_out(
+    query: torch.Tensor,
+    key: torch.Tensor,
+    value: torch.Tensor,
+    attn_mask: Optional[torch.Tensor] = None,
+    is_causal: bool = False,
+    scale: Optional[float] = None,
+    *,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    out.copy_(sdpa(query, key, value, attn_mask, is_causal, scale))
+    return out
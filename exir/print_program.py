@@ -30,6 +30,8 @@ from executorch.exir.schema import (
     IntList,
     JumpFalseCall,
     KernelCall,
+    MapBegin,
+    MapEnd,
     MoveCall,
     Null,
     OptionalTensorList,
@@ -39,6 +41,8 @@ from executorch.exir.schema import (
     Tensor,
     TensorList,
     TensorShapeDynamism,
+    WhileBegin,
+    WhileEnd,
 )
 
 
@@ -232,6 +236,30 @@ def print_program(  # noqa: C901
             )
         elif isinstance(instr.instr_args, FreeCall):
             print(f"FREE {_format_arg(instr.instr_args.value_index)}")
+        elif isinstance(instr.instr_args, MapBegin):
+            map_begin = instr.instr_args
+            print(
+                f"MAP_BEGIN ({_format_arg(map_begin.iter_index)}) "
+                f"{_format_arg(map_begin.input_index)} -> {_format_arg(map_begin.slice_index)}, "
+                f"{_format_arg(map_begin.body_output_index)} -> {_format_arg(map_begin.output_index)}, "
+                f"done -> {map_begin.end_instruction}"
+            )
+        elif isinstance(instr.instr_args, MapEnd):
+            map_end = instr.instr_args
+            print(
+                f"MAP_END ({_format_arg(map_end.iter_index)}) -> {map_end.begin_instruction}"
+            )
+        elif isinstance(instr.instr_args, WhileBegin):
+            while_begin = instr.instr_args
+            init = ",".join(map(_format_arg, while_begin.init_indices))
+            state = ",".join(map(_format_arg, while_begin.state_indices))
+            body_outputs = ",".join(map(_format_arg, while_begin.body_output_indices))
+            print(
+                f"WHILE_BEGIN ({_format_arg(while_begin.iter_index)}) "
+                f"{init} -> {state} <- {body_outputs}"
+            )
+        elif isinstance(instr.instr_args, WhileEnd):
+            print(f"WHILE_END -> {instr.instr_args.begin_instruction}")
         else:
             raise InternalError(f"Unsupport instruction type {instr}")
 
@@ -5,24 +5,37 @@
 # LICENSE file in the root directory of this source tree.
 
 import copy
+import io
 import logging
-from typing import Any, Dict, List, Optional, Sequence, Set, Type, Union
+from typing import Any, BinaryIO, Dict, List, Optional, Sequence, Set, Type, Union
 
 import torch
 import torch._export
-from executorch.exir._serialize import _serialize_pte_binary
+from executorch.exir._serialize import (
+    _serialize_pte_binary,
+    _serialize_pte_binary_to_file,
+)
 from executorch.exir.backend.backend_api import to_backend
 from executorch.exir.backend.partitioner import TPartitioner
 from executorch.exir.capture._config import EdgeCompileConfig, ExecutorchBackendConfig
 from executorch.exir.emit import emit_program, EmitterOutput
 from executorch.exir.emit._emitter import _DelegateDebugIdentifierMap
-from executorch.exir.error import ExportError
+from executorch.exir.error import ExportError, ExportErrorType
+from executorch.exir.memory_planning import share_memory_planned_buffers
 from executorch.exir.pass_manager import PassType
 from executorch.exir.passes import (
     aten_to_edge_passes,
+    ChannelsLastPropagationPass,
     EdgeToBackendOpsPass,
+    FoldBatchNormPass,
+    FuseElementwisePass,
+    FuseRMSNormAndRoPEPass,
+    MemoryAwareSchedulePass,
     OpReplacePass,
+    QuantFusionPass,
+    ReplaceViewCopyWithViewPass,
 )
+from executorch.exir.passes.const_prop_pass import WeightQuantFoldingPass
 from executorch.exir.passes.remove_assert_async_pass import RemoveAssertAsyncPass
 from executorch.exir.passes.spec_prop_pass import SpecPropPass
 from executorch.exir.print_program import pretty_print, print_program
@@ -177,12 +190,16 @@ class ExirExportedProgram:
             raise RuntimeError("Must run to_edge before to_executorch.")
         config = config or ExecutorchBackendConfig()
         ep = self.exported_program
+        _tag_mutable_buffers(ep)
         new_prog = ep._transform(*edge_to_executorch_passes(config))
         new_prog = ExirExportedProgram(new_prog, self.after_to_edge_passes)
         executorch_prog = ExecutorchProgram(
             new_prog,
             emit_stacktrace=config.emit_stacktrace,
             extract_segments=config.extract_segments,
+            extract_constant_segment=config.extract_constant_segment,
+            compress_delegate_segments=config.compress_delegate_segments,
+            program_checksum=config.program_checksum,
             segment_alignment=config.segment_alignment,
             constant_tensor_alignment=config.constant_tensor_alignment,
             delegate_alignment=config.delegate_alignment,
@@ -214,6 +231,9 @@ class ExecutorchProgram:
         emit_stacktrace: bool,
         extract_segments: bool,
         segment_alignment: int,
+        extract_constant_segment: bool = False,
+        compress_delegate_segments: bool = False,
+        program_checksum: bool = False,
         constant_tensor_alignment: Optional[int] = None,
         delegate_alignment: Optional[int] = None,
     ) -> None:
@@ -226,6 +246,9 @@ class ExecutorchProgram:
         self._emitter_output: Optional[EmitterOutput] = None
         self._emit_stacktrace: bool = emit_stacktrace
         self._extract_segments: bool = extract_segments
+        self._extract_constant_segment: bool = extract_constant_segment
+        self._compress_delegate_segments: bool = compress_delegate_segments
+        self._program_checksum: bool = program_checksum
         self._segment_alignment: int = segment_alignment
         self._constant_tensor_alignment: Optional[int] = constant_tensor_alignment
         self._delegate_alignment: Optional[int] = delegate_alignment
@@ -236,6 +259,9 @@ class ExecutorchProgram:
             self._buffer = _serialize_pte_binary(
                 program=self.program,
                 extract_segments=self._extract_segments,
+                extract_constant_segment=self._extract_constant_segment,
+                compress_delegate_segments=self._compress_delegate_segments,
+                program_checksum=self._program_checksum,
                 segment_alignment=self._segment_alignment,
                 constant_tensor_alignment=self._constant_tensor_alignment,
                 delegate_alignment=self._delegate_alignment,
@@ -321,14 +347,92 @@ def _to_edge(ep, config: EdgeCompileConfig) -> "ExirExportedProgram":
     return new_ep
 
 
+def _tag_mutable_buffers(program: ExportedProgram) -> None:
+    """
+    Tag the placeholders of the buffers that the program mutates with the index of the graph
+    output holding their new value, so that memory planning can update them in place and keep
+    them across executions; see plan_mutable_buffers().
+    """
+    signature = program.graph_signature
+    if not signature.buffers_to_mutate:
+        return
+    output_node = next(iter(reversed(program.graph_module.graph.nodes)))
+    output_names = [
+        getattr(arg, "name", None) for arg in pytree.tree_flatten(output_node.args[0])[0]
+    ]
+    buffer_to_output = {
+        buffer: output_names.index(name)
+        for name, buffer in signature.buffers_to_mutate.items()
+    }
+    for node in program.graph_module.graph.nodes:
+        if node.op != "placeholder":
+            continue
+        buffer = signature.inputs_to_buffers.get(node.name)
+        if buffer in buffer_to_output:
+            node.meta["mutable_buffer"] = buffer_to_output[buffer]
+
+
+def _check_shared_mutable_buffers(programs: Dict[str, ExportedProgram]) -> None:
+    """
+    Methods that share their memory-planned buffers also share the state in them, so a mutable
+    buffer that several methods own must be planned at the same location in each of them.
+    """
+    locations: Dict[str, Any] = {}
+    for name, program in sorted(programs.items()):
+        for node in program.graph_module.graph.nodes:
+            if node.op != "placeholder" or "mutable_buffer" not in node.meta:
+                continue
+            fqn = program.graph_signature.inputs_to_buffers[node.name]
+            spec = node.meta["spec"]
+            location = (spec.mem_id, spec.mem_offset, spec.allocated_memory)
+            if locations.setdefault(fqn, (name, location))[1] != location:
+                raise ExportError(
+                    ExportErrorType.NOT_SUPPORTED,
+                    f"Mutable buffer {fqn} is planned at {location} in method {name} but "
+                    f"at {locations[fqn][1]} in method {locations[fqn][0]}, so the methods "
+                    "cannot share it. Plan the mutable buffers in their own memory buffer "
+                    "with MemoryPlanningPass(mutable_buffer_mem_id=...).",
+                )
+
+
+def _weight_quant_folding_passes(
+    config: ExecutorchBackendConfig,
+) -> List[PassType]:
+    if config.weight_quant_folding is None:
+        return []
+    if config.weight_quant_folding == "float":
+        return [WeightQuantFoldingPass()]
+    if config.weight_quant_folding == "quantized":
+        return [
+            QuantFusionPass(),
+            WeightQuantFoldingPass(keep_quantized_storage=True),
+        ]
+    raise ValueError(
+        f"Unknown weight_quant_folding {config.weight_quant_folding!r}, "
+        'expected "float", "quantized" or None'
+    )
+
+
 def edge_to_executorch_passes(config: ExecutorchBackendConfig) -> List[PassType]:
     # pyre-ignore
     passes: List[PassType] = [
         *config.passes,
+        *_weight_quant_folding_passes(config),
+        *([FoldBatchNormPass()] if config.fold_batch_norm else []),
+        *(
+            [ChannelsLastPropagationPass()]
+            if config.channels_last_propagation
+            else []
+        ),
+        # Before elementwise fusion, which would take the muls of the patterns
+        *([FuseRMSNormAndRoPEPass()] if config.fuse_rms_norm_and_rope else []),
+        *([FuseElementwisePass()] if config.fuse_elementwise_ops else []),
+        *([MemoryAwareSchedulePass()] if config.schedule_for_memory else []),
         SpecPropPass(),
         EdgeToBackendOpsPass(),
         RemoveAssertAsyncPass(),
         config.sym_shape_eval_pass,
+        *([ReplaceViewCopyWithViewPass()] if config.remove_view_copy else []),
         config.to_out_var_pass,
         config.memory_planning_pass,
     ]
@@ -486,9 +590,13 @@ class MultiMethodExecutorchProgram:
         emit_stacktrace: bool,
         extract_segments: bool,
         segment_alignment: int,
+        extract_constant_segment: bool = False,
+        compress_delegate_segments: bool = False,
+        program_checksum: bool = False,
         constant_tensor_alignment: Optional[int] = None,
         delegate_alignment: Optional[int] = None,
         prim_getters: Optional[Dict[str, Any]] = None,
+        share_planned_buffers: bool = False,
     ) -> None:
         self._buffer: Optional[bytes] = None
         temp: Dict[str, ExportedProgram] = {}
@@ -499,8 +607,14 @@ class MultiMethodExecutorchProgram:
             emit_stacktrace,
             executorch_dialect_program.prim_getters(),
         )
+        if share_planned_buffers:
+            _check_shared_mutable_buffers(temp)
+            share_memory_planned_buffers(self._emitter_output.program)
         self._executorch_dialect_ir_program = executorch_dialect_program
         self._extract_segments: bool = extract_segments
+        self._extract_constant_segment: bool = extract_constant_segment
+        self._compress_delegate_segments: bool = compress_delegate_segments
+        self._program_checksum: bool = program_checksum
         self._segment_alignment: int = segment_alignment
         self._constant_tensor_alignment: Optional[int] = constant_tensor_alignment
         self._delegate_alignment: Optional[int] = delegate_alignment
@@ -512,6 +626,9 @@ class MultiMethodExecutorchProgram:
             self._buffer = _serialize_pte_binary(
                 program=self._emitter_output.program,
                 extract_segments=self._extract_segments,
+                extract_constant_segment=self._extract_constant_segment,
+                compress_delegate_segments=self._compress_delegate_segments,
+                program_checksum=self._program_checksum,
                 segment_alignment=self._segment_alignment,
                 constant_tensor_alignment=self._constant_tensor_alignment,
                 delegate_alignment=self._delegate_alignment,
@@ -549,14 +666,20 @@ def multi_method_program_to_executorch(
 ) -> MultiMethodExecutorchProgram:
     config = config or ExecutorchBackendConfig()
     passes = edge_to_executorch_passes(config)
+    for prog in edge_dialect_program.methods().values():
+        _tag_mutable_buffers(prog.exported_program)
     return MultiMethodExecutorchProgram(
         executorch_dialect_program=edge_dialect_program.transform(*passes),
         emit_stacktrace=config.emit_stacktrace,
         extract_segments=config.extract_segments,
+        extract_constant_segment=config.extract_constant_segment,
+        compress_delegate_segments=config.compress_delegate_segments,
+        program_checksum=config.program_checksum,
         segment_alignment=config.segment_alignment,
         constant_tensor_alignment=config.constant_tensor_alignment,
         delegate_alignment=config.delegate_alignment,
         prim_getters=edge_dialect_program.prim_getters(),
+        share_planned_buffers=config.share_memory_planned_buffers,
     )
 
 
@@ -779,6 +902,7 @@ class EdgeProgramManager:
 
         execution_programs: Dict[str, ExportedProgram] = {}
         for name, program in self._edge_programs.items():
+            _tag_mutable_buffers(program)
             new_prog = program._transform(*edge_to_executorch_passes(config))
             execution_programs[name] = new_prog
 
@@ -836,15 +960,14 @@ class ExecutorchProgramManager:
             backend_config.emit_stacktrace,
             self._config_methods,
         )
+        if backend_config.share_memory_planned_buffers:
+            _check_shared_mutable_buffers(self._execution_programs)
+            share_memory_planned_buffers(self._emitter_output.program)
 
-        # Serialize emitter output to a buffer
-        self._buffer: bytes = _serialize_pte_binary(
-            program=self._emitter_output.program,
-            extract_segments=backend_config.extract_segments,
-            segment_alignment=backend_config.segment_alignment,
-            constant_tensor_alignment=backend_config.constant_tensor_alignment,
-            delegate_alignment=backend_config.delegate_alignment,
-        )
+        # The emitter output is serialized when it is first needed, so that
+        # write_to_file() can stream it instead of building the buffer.
+        self._backend_config: ExecutorchBackendConfig = backend_config
+        self._buffer: Optional[bytes] = None
 
     @property
     def methods(self) -> Set[str]:
@@ -897,9 +1020,39 @@ class ExecutorchProgramManager:
         """
         return self._emitter_output.program
 
+    def _serialize_to(self, file: BinaryIO) -> None:
+        config = self._backend_config
+        _serialize_pte_binary_to_file(
+            program=self._emitter_output.program,
+            file=file,
+            extract_segments=config.extract_segments,
+            extract_constant_segment=config.extract_constant_segment,
+            compress_delegate_segments=config.compress_delegate_segments,
+            program_checksum=config.program_checksum,
+            segment_alignment=config.segment_alignment,
+            constant_tensor_alignment=config.constant_tensor_alignment,
+            delegate_alignment=config.delegate_alignment,
+        )
+
     @property
     def buffer(self) -> bytes:
         """
         Returns a buffer containing the serialized ExecuTorch binary.
         """
+        if self._buffer is None:
+            out = io.BytesIO()
+            self._serialize_to(out)
+            self._buffer = out.getvalue()
         return self._buffer
+
+    def write_to_file(self, open_file: BinaryIO) -> None:
+        """
+        Writes the serialized ExecuTorch binary to the file object. Unless the
+        buffer has already been created, the constant data is streamed to the
+        file instead of being copied into one buffer holding the whole binary,
+        which matters for large models.
+        """
+        if self._buffer is not None:
+            open_file.write(self._buffer)
+        else:
+            self._serialize_to(open_file)
@@ -162,12 +162,45 @@ class FreeCall:
     value_index: int
 
 
+@dataclass
+class MapBegin:
+    input_index: int
+    slice_index: int
+    output_index: int
+    body_output_index: int
+    iter_index: int
+    end_instruction: int
+
+
+@dataclass
+class MapEnd:
+    iter_index: int
+    begin_instruction: int
+
+
+@dataclass
+class WhileBegin:
+    init_indices: List[int]
+    state_indices: List[int]
+    body_output_indices: List[int]
+    iter_index: int
+
+
+@dataclass
+class WhileEnd:
+    begin_instruction: int
+
+
 InstructionArguments = Union[
     KernelCall,
     DelegateCall,
     MoveCall,
     JumpFalseCall,
     FreeCall,
+    MapBegin,
+    MapEnd,
+    WhileBegin,
+    WhileEnd,
 ]
 
 
@@ -205,6 +238,8 @@ class BackendDelegate:
     id: str
     processed: BackendDelegateDataReference
     compile_specs: List[CompileSpec]
+    # Indices into ExecutionPlan.delegates of other lowerings of this partition.
+    alternatives: Optional[List[int]] = None
 
 
 @dataclass
@@ -221,6 +256,12 @@ class Operator:
     overload: str
 
 
+@dataclass
+class NamedConstant:
+    name: str
+    value_index: int
+
+
 @dataclass
 class ExecutionPlan:
     name: str
@@ -236,12 +277,27 @@ class ExecutionPlan:
     # Runtime should use the len(constant_buffer) as the ground truch of
     # constant memory buffer size, and ignore non_const_buffer_sizes[0].
     non_const_buffer_sizes: List[int]
+    # Names of the constant tensors of the plan, for swapping their data at runtime.
+    named_constants: Optional[List[NamedConstant]] = None
+
+
+class SegmentCompression(IntEnum):
+    NONE = 0
+    LZ4_BLOCK = 1
 
 
 @dataclass
 class DataSegment:
     offset: int
     size: int
+    compression: SegmentCompression = SegmentCompression.NONE
+    uncompressed_size: int = 0
+
+
+@dataclass
+class SubsegmentOffsets:
+    segment_index: int
+    offsets: List[int]
 
 
 @dataclass
@@ -251,3 +307,4 @@ class Program:
     constant_buffer: List[Buffer]
     backend_delegate_data: List[BackendDelegateInlineData]
     segments: List[DataSegment]
+    constant_segment: Optional[SubsegmentOffsets] = None
@@ -102,7 +102,10 @@ def determine_tensor_dynanism(shape: torch.Size) -> TensorShapeDynamism:
         return TensorShapeDynamism.STATIC
     else:
         try:
-            _ = eval_shape(shape)
+            # eval_shape gives None for data-dependent sizes, e.g. the first
+            # dimension of nonzero's output.
+            if any(s is None for s in eval_shape(shape)):
+                return TensorShapeDynamism.DYNAMIC_UNBOUND
             return TensorShapeDynamism.DYNAMIC_BOUND
         except torch.fx.experimental.symbolic_shapes.GuardOnDataDependentSymNode:
             return TensorShapeDynamism.DYNAMIC_UNBOUND
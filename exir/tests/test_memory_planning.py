@@ -19,9 +19,15 @@ from executorch.backends.fb.qnnpack.partition.qnnpack_partitioner import (
     QnnpackPartitioner,
 )
 from executorch.exir.backend.backend_api import to_backend, validation_disabled
-from executorch.exir.memory_planning import filter_nodes, Verifier
+from executorch.exir.memory_planning import (
+    filter_nodes,
+    MemoryTier,
+    share_memory_planned_buffers,
+    Verifier,
+)
 from executorch.exir.pass_base import PassResult
 from executorch.exir.pass_manager import PassManager
+from executorch.exir.passes.memory_planning_pass import TieredMemoryPlanningPass
 from executorch.exir.passes import (  # noqa
     ConstPropPass,
     DebugPass,
@@ -202,6 +208,26 @@ class MultiplePoolsToyModel(torch.nn.Module):
         return e
 
 
+class InPlaceChainModel(torch.nn.Module):
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        # a is only read by relu, and b only by sigmoid, so relu and sigmoid
+        # can write their outputs into a's storage.
+        a = x + x
+        b = torch.relu(a)
+        c = torch.sigmoid(b)
+        return c + x
+
+
+class MutableBufferModel(torch.nn.Module):
+    def __init__(self) -> None:
+        super().__init__()
+        self.register_buffer("cache", torch.zeros(4, 2))
+
+    def forward(self, x: torch.Tensor, pos: torch.Tensor) -> torch.Tensor:
+        self.cache[pos] = x
+        return self.cache.sum(dim=0)
+
+
 def maketest(
     module_cls: Type[torch.nn.Module],
     criteria: Optional[List[Tuple[str, bool]]] = None,
@@ -221,6 +247,7 @@ def maketest(
                 ("naive", False),
                 # greedy algorithm should reuse tensor storages in the testing model
                 ("greedy", True),
+                ("best_fit", True),
             ]
 
         for algo, expect_reuse in criteria:
@@ -417,6 +444,44 @@ class TestMisc(unittest.TestCase):
         for act, exp in zip(actual_list, expected_list):
             self.assertEqual(id(act), id(exp))
 
+    def test_share_memory_planned_buffers(self) -> None:
+        def make_execution_plan(
+            name: str, non_const_buffer_sizes: List[int]
+        ) -> schema.ExecutionPlan:
+            return schema.ExecutionPlan(
+                name=name,
+                container_meta_type=schema.ContainerMetadata("", ""),
+                values=[],
+                inputs=[],
+                outputs=[],
+                chains=[],
+                operators=[],
+                delegates=[],
+                non_const_buffer_sizes=non_const_buffer_sizes,
+            )
+
+        program = schema.Program(
+            version=0,
+            execution_plan=[
+                make_execution_plan("encode", [0, 64, 16]),
+                make_execution_plan("decode", [0, 32, 48, 8]),
+                # Methods without planned memory don't need the buffers.
+                make_execution_plan("get_max_seq_len", [0, 0]),
+            ],
+            constant_buffer=[],
+            backend_delegate_data=[],
+            segments=[],
+        )
+        share_memory_planned_buffers(program)
+
+        self.assertEqual(
+            program.execution_plan[0].non_const_buffer_sizes, [0, 64, 48, 8]
+        )
+        self.assertEqual(
+            program.execution_plan[1].non_const_buffer_sizes, [0, 64, 48, 8]
+        )
+        self.assertEqual(program.execution_plan[2].non_const_buffer_sizes, [0, 0])
+
     def quantize(self, eager_model: nn.Module) -> nn.Module:
         quantized_model = eager_model
         linear_qconfig_mapping = QConfigMapping().set_object_type(
@@ -520,6 +585,16 @@ class TestMisc(unittest.TestCase):
                 [(1, 0), (3, 0), (1, 4), (3, 4), (1, 0)],
                 [0, 8, 0, 8],
             ),
+            (
+                "best_fit",
+                [(1, 0), (3, 0), (1, 4), (3, 4), (1, 0)],
+                [0, 8, 0, 8],
+            ),
+            (
+                "smallest",
+                [(1, 0), (3, 0), (1, 4), (3, 4), (1, 0)],
+                [0, 8, 0, 8],
+            ),
         ]
     )
     def test_multiple_pools(
@@ -562,3 +637,171 @@ class TestMisc(unittest.TestCase):
                 self.assertEqual(node.meta["spec"].mem_offset, mem_offset)
                 idx += 1
         self.assertEqual(graph_module.meta["non_const_buffer_sizes"], expected_bufsizes)
+        # a and c are live at the same time in mem_id 1, as are b and d in
+        # mem_id 3, whatever the algorithm.
+        self.assertEqual(
+            graph_module.meta["non_const_buffer_lower_bounds"], [0, 8, 0, 8]
+        )
+
+    def test_in_place_ops(self) -> None:
+        for allow_in_place in (False, True):
+            edge_program = exir.capture(
+                InPlaceChainModel(),
+                (torch.ones(4),),
+            ).to_edge(exir.EdgeCompileConfig(_check_ir_validity=False))
+            program = edge_program.to_executorch(
+                exir.ExecutorchBackendConfig(
+                    memory_planning_pass=MemoryPlanningPass(
+                        "greedy", allow_in_place=allow_in_place
+                    )
+                )
+            )
+            graph_module = program.dump_graph_module()
+            Verifier(
+                graph_module, alloc_graph_input=True, alloc_graph_output=True
+            ).verify_storage_reuse()
+
+            num_in_place = 0
+            for node in graph_module.graph.nodes:
+                if node.op != "call_function" or node.target not in (
+                    torch.ops.aten.relu.out,
+                    torch.ops.aten.sigmoid.out,
+                ):
+                    continue
+                self_spec = node.args[0].meta["spec"]
+                out_spec = node.kwargs["out"].meta["spec"]
+                if (self_spec.mem_id, self_spec.mem_offset) == (
+                    out_spec.mem_id,
+                    out_spec.mem_offset,
+                ):
+                    num_in_place += 1
+            self.assertEqual(num_in_place, 2 if allow_in_place else 0)
+
+    def test_mutable_buffers(self) -> None:
+        edge_program = exir.to_edge(
+            torch.export.export(
+                MutableBufferModel(), (torch.ones(1, 2), torch.tensor([1]))
+            ),
+            compile_config=exir.EdgeCompileConfig(_check_ir_validity=False),
+        )
+        program = edge_program.to_executorch(
+            exir.ExecutorchBackendConfig(
+                memory_planning_pass=MemoryPlanningPass(
+                    "greedy", mutable_buffer_mem_id=2
+                )
+            )
+        )
+        graph_module = program.exported_program().graph_module
+        Verifier(
+            graph_module, alloc_graph_input=True, alloc_graph_output=True
+        ).verify_storage_reuse()
+
+        # The cache is planned in its own buffer, and is not reused by other
+        # tensors since it lives for the whole method.
+        self.assertEqual(len(graph_module.meta["non_const_buffer_sizes"]), 3)
+        self.assertEqual(graph_module.meta["non_const_buffer_sizes"][2], 32)
+
+        # The cache is not an input or an output of the method, and its value
+        # has both its initial data and a planned location.
+        plan = program.executorch_program.execution_plan[0]
+        self.assertEqual(len(plan.inputs), 2)
+        self.assertEqual(len(plan.outputs), 1)
+        states = [
+            value.val
+            for value in plan.values
+            if isinstance(value.val, schema.Tensor)
+            and value.val.constant_buffer_idx > 0
+            and value.val.allocation_info is not None
+        ]
+        self.assertEqual(len(states), 1)
+        self.assertEqual(states[0].allocation_info.memory_id, 2)
+
+    def test_mutable_buffers_shared_across_methods(self) -> None:
+        model = MutableBufferModel()
+        methods = {
+            "prefill": torch.export.export(
+                model, (torch.ones(2, 2), torch.tensor([0, 1]))
+            ),
+            "decode": torch.export.export(
+                model, (torch.ones(1, 2), torch.tensor([2]))
+            ),
+        }
+        program = exir.to_edge(
+            methods,
+            compile_config=exir.EdgeCompileConfig(_check_ir_validity=False),
+        ).to_executorch(
+            exir.ExecutorchBackendConfig(
+                memory_planning_pass=MemoryPlanningPass(
+                    "greedy", mutable_buffer_mem_id=2
+                ),
+                share_memory_planned_buffers=True,
+            )
+        )
+
+        # The initial value of the cache is stored once, and each method plans
+        # the cache at the same place in the shared buffer.
+        locations = []
+        for plan in program.executorch_program.execution_plan:
+            states = [
+                value.val
+                for value in plan.values
+                if isinstance(value.val, schema.Tensor)
+                and value.val.constant_buffer_idx > 0
+                and value.val.allocation_info is not None
+            ]
+            self.assertEqual(len(states), 1)
+            locations.append((states[0].constant_buffer_idx, states[0].allocation_info))
+        self.assertEqual(locations[0], locations[1])
+
+    def test_memory_tiers(self) -> None:
+        edge_program = exir.capture(
+            MultiplePoolsToyModel(),
+            (torch.ones(1),),
+        ).to_edge(exir.EdgeCompileConfig(_check_ir_validity=False))
+
+        # Every tensor is 4 bytes, and up to three are live at once, so the
+        # fast tier can only hold part of the graph.
+        program = edge_program.to_executorch(
+            exir.ExecutorchBackendConfig(
+                memory_planning_pass=TieredMemoryPlanningPass(
+                    tiers=[MemoryTier(mem_id=1, capacity=4), MemoryTier(mem_id=2)],
+                    alignment=1,
+                )
+            )
+        )
+        graph_module = program.dump_graph_module()
+
+        verifier = Verifier(
+            graph_module,
+            alloc_graph_input=True,
+            alloc_graph_output=True,
+        )
+        verifier.verify_storage_reuse()
+        verifier.verify_graph_input_output()
+
+        bufsizes = graph_module.meta["non_const_buffer_sizes"]
+        self.assertEqual(len(bufsizes), 3)
+        self.assertGreater(bufsizes[1], 0)
+        self.assertLessEqual(bufsizes[1], 4)
+        self.assertGreater(bufsizes[2], 0)
+
+    def test_memory_tiers_without_room(self) -> None:
+        edge_program = exir.capture(
+            MultiplePoolsToyModel(),
+            (torch.ones(1),),
+        ).to_edge(exir.EdgeCompileConfig(_check_ir_validity=False))
+
+        # The slowest tier is bounded too, so there is nowhere to spill to. The
+        # pass manager may wrap the ExportError.
+        with self.assertRaises(Exception):
+            edge_program.to_executorch(
+                exir.ExecutorchBackendConfig(
+                    memory_planning_pass=TieredMemoryPlanningPass(
+                        tiers=[
+                            MemoryTier(mem_id=1, capacity=4),
+                            MemoryTier(mem_id=2, capacity=4),
+                        ],
+                        alignment=1,
+                    )
+                )
+            )
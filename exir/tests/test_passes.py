@@ -5,6 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 # pyre-strict
+import copy
 import os
 import tempfile
 import unittest
@@ -15,23 +16,36 @@ import executorch.exir as exir
 # Import passes
 import executorch.exir.memory_planning  # noqa
 import torch
-from executorch.exir import CaptureConfig, EdgeCompileConfig, memory
+from executorch.exir import (
+    CaptureConfig,
+    EdgeCompileConfig,
+    ExecutorchBackendConfig,
+    memory,
+)
 from executorch.exir.dialects._ops import bind_pattern_to_op, ops, ops as exir_ops
 from executorch.exir.dialects.edge._ops import EdgeOpOverload
 from executorch.exir.emit import emit_program
 from executorch.exir.graph_module import get_control_flow_submodules
 from executorch.exir.pass_base import ExportPass, PassResult
 from executorch.exir.passes import (
+    ChannelsLastPropagationPass,
     dead_code_elimination_pass,
     DebugPass,
+    FoldBatchNormPass,
+    FuseElementwisePass,
+    FuseRMSNormAndRoPEPass,
     HintBasedSymShapeEvalPass,
+    MemoryAwareSchedulePass,
     MemoryPlanningPass,
     propagate_dynamic_shape,
     RemoveNoopPass,
     ReplaceSymSizeOpPass,
     ToOutVarPass,
 )
-from executorch.exir.passes.const_prop_pass import ConstPropPass
+from executorch.exir.passes.const_prop_pass import (
+    ConstPropPass,
+    WeightQuantFoldingPass,
+)
 from executorch.exir.passes.debug_handle_generator_pass import DebugHandleGeneratorPass
 from executorch.exir.passes.remove_assert_async_pass import RemoveAssertAsyncPass
 from executorch.exir.passes.remove_mixed_type_operators import RemoveMixedTypeOperators
@@ -449,6 +463,308 @@ class TestPasses(unittest.TestCase):
         new_gm = new_gm.graph_module
         self.assertEqual(count_additions(new_gm), 1)
 
+    def test_weight_quant_folding_pass(self) -> None:
+        class M(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.weight = torch.nn.Parameter(torch.randn(4, 3))
+
+            def forward(self, x):
+                w = torch.ops.quantized_decomposed.quantize_per_tensor(
+                    self.weight, 0.1, 0, -128, 127, torch.int8
+                )
+                w = torch.ops.quantized_decomposed.dequantize_per_tensor(
+                    w, 0.1, 0, -128, 127, torch.int8
+                )
+                x = torch.ops.quantized_decomposed.quantize_per_tensor(
+                    x, 0.1, 0, -128, 127, torch.int8
+                )
+                x = torch.ops.quantized_decomposed.dequantize_per_tensor(
+                    x, 0.1, 0, -128, 127, torch.int8
+                )
+                return torch.nn.functional.linear(x, w)
+
+        def count_ops(gm: torch.fx.GraphModule, op) -> int:
+            return sum((node.target == op) for node in gm.graph.nodes)
+
+        quantize = torch.ops.quantized_decomposed.quantize_per_tensor.default
+        dequantize = torch.ops.quantized_decomposed.dequantize_per_tensor.default
+        inputs = (torch.randn(2, 3),)
+        m = M()
+        graph_module = exir.capture(
+            m, inputs, CaptureConfig(enable_functionalization=True)
+        ).exported_program.graph_module
+        self.assertEqual(count_ops(graph_module, quantize), 2)
+        self.assertEqual(count_ops(graph_module, dequantize), 2)
+
+        # Only the activation's quantization is left, and the weight is folded
+        # into a float constant.
+        float_gm = WeightQuantFoldingPass()(graph_module).graph_module
+        self.assertEqual(count_ops(float_gm, quantize), 1)
+        self.assertEqual(count_ops(float_gm, dequantize), 1)
+        self.assertTrue(torch.allclose(float_gm(*inputs)[0], m(*inputs)))
+
+        # The weight stays an int8 constant, dequantized at runtime.
+        quantized_gm = WeightQuantFoldingPass(keep_quantized_storage=True)(
+            graph_module
+        ).graph_module
+        self.assertEqual(count_ops(quantized_gm, quantize), 1)
+        self.assertEqual(count_ops(quantized_gm, dequantize), 2)
+        self.assertTrue(torch.allclose(quantized_gm(*inputs)[0], m(*inputs)))
+
+    def test_fuse_elementwise_pass(self) -> None:
+        class M(torch.nn.Module):
+            def forward(self, x, y, z):
+                a = torch.relu(x * y + z)
+                # b is also an output, so it can't be fused into c
+                b = torch.sigmoid(a) - x
+                c = torch.tanh(b) / y
+                return b, c
+
+        def count_ops(gm: torch.fx.GraphModule, op) -> int:
+            return sum((node.target == op) for node in gm.graph.nodes)
+
+        fused_op = torch.ops.executorch_prim.fused_elementwise.default
+        inputs = (torch.randn(2, 3), torch.rand(2, 3) + 1, torch.randn(2, 3))
+        edge = exir.capture(M(), inputs, exir.CaptureConfig()).to_edge()
+
+        graph_module = copy.deepcopy(edge.exported_program.graph_module)
+        fused_gm = FuseElementwisePass()(graph_module).graph_module
+        self.assertEqual(count_ops(fused_gm, fused_op), 2)
+        for op in (
+            exir_ops.edge.aten.mul.Tensor,
+            exir_ops.edge.aten.add.Tensor,
+            exir_ops.edge.aten.relu.default,
+            exir_ops.edge.aten.sigmoid.default,
+            exir_ops.edge.aten.sub.Tensor,
+            exir_ops.edge.aten.tanh.default,
+            exir_ops.edge.aten.div.Tensor,
+        ):
+            self.assertEqual(count_ops(fused_gm, op), 0)
+        for expected, actual in zip(M()(*inputs), fused_gm(*inputs)):
+            self.assertTrue(torch.allclose(expected, actual))
+
+        prog = edge.to_executorch(ExecutorchBackendConfig(fuse_elementwise_ops=True))
+        FileCheck().check_count(
+            "torch.ops.executorch_prim.fused_elementwise.out", 2, exactly=True
+        ).run(prog.exported_program.graph_module.code)
+
+    def test_fuse_rms_norm_and_rope_pass(self) -> None:
+        # As in Llama's model.py
+        class RMSNorm(torch.nn.Module):
+            def __init__(self, dim: int, eps: float) -> None:
+                super().__init__()
+                self.eps = eps
+                self.weight = torch.nn.Parameter(torch.rand(dim))
+
+            def forward(self, x):
+                x = x * torch.rsqrt(x.pow(2).mean(-1, keepdim=True) + self.eps)
+                return x * self.weight
+
+        class M(torch.nn.Module):
+            def __init__(self) -> None:
+                super().__init__()
+                self.norm = RMSNorm(16, 1e-5)
+
+            def forward(self, xq, xk, freqs_cos, freqs_sin):
+                xq = self.norm(xq)
+                xq_r, xq_i = xq.reshape(xq.shape[:-1] + (-1, 2)).unbind(-1)
+                xk_r, xk_i = xk.reshape(xk.shape[:-1] + (-1, 2)).unbind(-1)
+                shape = (1, xq.shape[1], 1, xq.shape[-1] // 2)
+                freqs_cos = freqs_cos.view(shape)
+                freqs_sin = freqs_sin.view(shape)
+                xq_out_r = xq_r * freqs_cos - xq_i * freqs_sin
+                xq_out_i = xq_r * freqs_sin + xq_i * freqs_cos
+                xk_out_r = xk_r * freqs_cos - xk_i * freqs_sin
+                xk_out_i = xk_i * freqs_cos + xk_r * freqs_sin
+                xq_out = torch.stack([xq_out_r, xq_out_i], dim=-1).flatten(3)
+                xk_out = torch.stack([xk_out_r, xk_out_i], dim=-1).flatten(3)
+                return xq_out, xk_out
+
+        def count_ops(gm: torch.fx.GraphModule, op) -> int:
+            return sum((node.target == op) for node in gm.graph.nodes)
+
+        angles = torch.rand(3, 8)
+        inputs = (
+            torch.randn(1, 3, 2, 16),
+            torch.randn(1, 3, 2, 16),
+            torch.cos(angles),
+            torch.sin(angles),
+        )
+        m = M()
+        edge = exir.capture(m, inputs, exir.CaptureConfig()).to_edge()
+
+        graph_module = copy.deepcopy(edge.exported_program.graph_module)
+        fused_gm = FuseRMSNormAndRoPEPass()(graph_module).graph_module
+        self.assertEqual(
+            count_ops(fused_gm, torch.ops.executorch_prim.rms_norm.default), 1
+        )
+        self.assertEqual(count_ops(fused_gm, torch.ops.executorch_prim.rope.default), 2)
+        for op in (
+            exir_ops.edge.aten.rsqrt.default,
+            exir_ops.edge.aten.mean.dim,
+            exir_ops.edge.aten.mul.Tensor,
+            exir_ops.edge.aten.sub.Tensor,
+            exir_ops.edge.aten.add.Tensor,
+            exir_ops.edge.aten.cat.default,
+        ):
+            self.assertEqual(count_ops(fused_gm, op), 0)
+        for expected, actual in zip(m(*inputs), fused_gm(*inputs)):
+            self.assertTrue(torch.allclose(expected, actual, atol=1e-6))
+
+        prog = edge.to_executorch(
+            ExecutorchBackendConfig(fuse_rms_norm_and_rope=True)
+        )
+        code = prog.exported_program.graph_module.code
+        FileCheck().check_count(
+            "torch.ops.executorch_prim.rms_norm.out", 1, exactly=True
+        ).run(code)
+        FileCheck().check_count(
+            "torch.ops.executorch_prim.rope.out", 2, exactly=True
+        ).run(code)
+
+    def test_sdpa_op(self) -> None:
+        class M(torch.nn.Module):
+            def forward(self, q, k, v):
+                return torch.ops.executorch_prim.sdpa(q, k, v, None, True)
+
+        # Two query heads per key and value head
+        q = torch.randn(1, 4, 5, 8)
+        k = torch.randn(1, 2, 5, 8)
+        v = torch.randn(1, 2, 5, 8)
+        expected = torch.nn.functional.scaled_dot_product_attention(
+            q,
+            k.repeat_interleave(2, dim=1),
+            v.repeat_interleave(2, dim=1),
+            is_causal=True,
+        )
+        self.assertTrue(torch.allclose(M()(q, k, v), expected, atol=1e-6))
+
+        prog = (
+            exir.capture(M(), (q, k, v), exir.CaptureConfig())
+            .to_edge(exir.EdgeCompileConfig(_check_ir_validity=False))
+            .to_executorch()
+        )
+        FileCheck().check_count(
+            "torch.ops.executorch_prim.sdpa.out", 1, exactly=True
+        ).run(prog.exported_program.graph_module.code)
+
+    def test_channels_last_propagation_pass(self) -> None:
+        class M(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.conv1 = torch.nn.Conv2d(3, 8, 3)
+                self.bn = torch.nn.BatchNorm2d(8)
+                self.pool = torch.nn.MaxPool2d(2)
+                self.conv2 = torch.nn.Conv2d(8, 4, 3)
+
+            def forward(self, x):
+                y = self.pool(torch.relu(self.bn(self.conv1(x))))
+                return torch.flatten(self.conv2(y), 1)
+
+        def count_ops(gm: torch.fx.GraphModule, op) -> int:
+            return sum((node.target == op) for node in gm.graph.nodes)
+
+        to_dim_order_op = exir_ops.edge.dim_order_ops._to_dim_order_copy.default
+        model = M().eval()
+        inputs = (torch.randn(1, 3, 12, 12),)
+        edge = exir.capture(model, inputs, exir.CaptureConfig()).to_edge()
+
+        graph_module = copy.deepcopy(edge.exported_program.graph_module)
+        gm = ChannelsLastPropagationPass()(graph_module).graph_module
+        # Only into channels last before conv1, and out of it before flatten
+        self.assertEqual(count_ops(gm, to_dim_order_op), 2)
+        for node in gm.graph.nodes:
+            if node.target == exir_ops.edge.aten.convolution.default:
+                self.assertTrue(
+                    node.meta["val"].is_contiguous(memory_format=torch.channels_last)
+                )
+        self.assertTrue(torch.allclose(model(*inputs), gm(*inputs)[0], atol=1e-5))
+
+        prog = edge.to_executorch(
+            ExecutorchBackendConfig(channels_last_propagation=True)
+        )
+        FileCheck().check_count(
+            "torch.ops.dim_order_ops._to_dim_order_copy.out", 2, exactly=True
+        ).run(prog.exported_program.graph_module.code)
+
+    def test_memory_aware_schedule_pass(self) -> None:
+        class Wide(torch.nn.Module):
+            def forward(self, x):
+                # All branches are computed before any of them is reduced
+                a = x * 2
+                b = x * 3
+                c = x * 4
+                return a.sum() + b.sum() + c.sum()
+
+        def positions(gm: torch.fx.GraphModule, op) -> List[int]:
+            return [i for i, node in enumerate(gm.graph.nodes) if node.target == op]
+
+        inputs = (torch.randn(64, 64),)
+        edge = exir.capture(Wide(), inputs, exir.CaptureConfig()).to_edge()
+
+        graph_module = copy.deepcopy(edge.exported_program.graph_module)
+        gm = MemoryAwareSchedulePass()(graph_module).graph_module
+        # Each product is reduced before the next one is computed
+        muls = positions(gm, exir_ops.edge.aten.mul.Tensor)
+        sums = positions(gm, exir_ops.edge.aten.sum.default)
+        self.assertEqual(len(muls), 3)
+        self.assertTrue(all(m < s for m, s in zip(muls, sums)))
+        self.assertTrue(all(s < m for s, m in zip(sums, muls[1:])))
+        self.assertTrue(torch.allclose(Wide()(*inputs), gm(*inputs)[0]))
+
+        def arena_size(config: ExecutorchBackendConfig) -> int:
+            prog = copy.deepcopy(edge).to_executorch(config)
+            return prog.program.execution_plan[0].non_const_buffer_sizes[1]
+
+        self.assertLess(
+            arena_size(ExecutorchBackendConfig(schedule_for_memory=True)),
+            arena_size(ExecutorchBackendConfig()),
+        )
+
+    def test_fold_batch_norm_pass(self) -> None:
+        class M(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.conv = torch.nn.Conv2d(3, 8, 3)
+                self.bn2d = torch.nn.BatchNorm2d(8)
+                self.linear = torch.nn.Linear(8, 4)
+                self.bn1d = torch.nn.BatchNorm1d(4)
+                self.linear_no_bias = torch.nn.Linear(4, 4, bias=False)
+                self.bn1d_no_affine = torch.nn.BatchNorm1d(4, affine=False)
+
+            def forward(self, x):
+                y = torch.relu(self.bn2d(self.conv(x)))
+                y = self.bn1d(self.linear(y.mean([2, 3])))
+                return self.bn1d_no_affine(self.linear_no_bias(y))
+
+        def count_batch_norms(gm: torch.fx.GraphModule) -> int:
+            return sum(
+                node.target
+                == exir_ops.edge.aten._native_batch_norm_legit_no_training.default
+                for node in gm.graph.nodes
+            )
+
+        model = M()
+        # Non-trivial statistics, so that folding them has an effect
+        for bn in (model.bn2d, model.bn1d, model.bn1d_no_affine):
+            bn.running_mean.uniform_(-1, 1)
+            bn.running_var.uniform_(0.5, 2)
+        model.eval()
+        inputs = (torch.randn(2, 3, 8, 8),)
+        edge = exir.capture(model, inputs, exir.CaptureConfig()).to_edge()
+
+        graph_module = copy.deepcopy(edge.exported_program.graph_module)
+        self.assertEqual(count_batch_norms(graph_module), 3)
+        gm = FoldBatchNormPass()(graph_module).graph_module
+        self.assertEqual(count_batch_norms(gm), 0)
+        self.assertTrue(torch.allclose(model(*inputs), gm(*inputs)[0], atol=1e-5))
+
+        prog = edge.to_executorch()
+        FileCheck().check_not("batch_norm").run(
+            prog.exported_program.graph_module.code
+        )
+
     def test_export_scalar_to_tensor_pass(self) -> None:
         def mul(x: torch.Tensor) -> torch.Tensor:
             return x * 3.14
@@ -75,6 +75,75 @@ class TestQuantFusionPass(unittest.TestCase):
             m.exported_program.graph_module.code
         )
 
+    def test_mul(self) -> None:
+        class M(torch.nn.Module):
+            def forward(self, x, y):
+                return x * y
+
+        example_inputs = (torch.randn(1, 5), torch.randn(1, 5))
+        m = M().eval()
+        qconfig_mapping = get_default_qconfig_mapping("qnnpack")
+        m = prepare_fx(
+            m,
+            qconfig_mapping,
+            example_inputs,
+            backend_config=get_executorch_backend_config(),
+        )
+        m(*example_inputs)
+        m = _convert_to_reference_decomposed_fx(m)
+        config = EdgeCompileConfig(_check_ir_validity=False)
+        m = exir.capture(m, example_inputs, CaptureConfig()).to_edge(config=config)
+        m = m.transform(QuantFusionPass())
+        FileCheck().check(
+            "executorch_exir_dialects_edge__ops_quantized_decomposed_mul_default"
+        ).check_not("executorch_exir_dialects_edge__ops_aten_mul_Tensor").run(
+            m.exported_program.graph_module.code
+        )
+        m = m.to_executorch()
+        FileCheck().check("torch.ops.quantized_decomposed.mul.out").run(
+            m.exported_program.graph_module.code
+        )
+
+    def test_conv_avg_pool2d(self) -> None:
+        class M(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.conv = torch.nn.Conv2d(3, 4, 3, padding=1)
+
+            def forward(self, x):
+                return F.avg_pool2d(self.conv(x), 2)
+
+        example_inputs = (torch.randn(1, 3, 8, 8),)
+        m = M().eval()
+        qconfig_mapping = get_default_qconfig_mapping("qnnpack")
+        m = prepare_fx(
+            m,
+            qconfig_mapping,
+            example_inputs,
+            backend_config=get_executorch_backend_config(),
+        )
+        m(*example_inputs)
+        m = _convert_to_reference_decomposed_fx(m)
+        config = EdgeCompileConfig(_check_ir_validity=False)
+        m = exir.capture(m, example_inputs, CaptureConfig()).to_edge(config=config)
+        m = m.transform(QuantFusionPass())
+        # both the conv and the pool run on the quantized values
+        FileCheck().check(
+            "executorch_exir_dialects_edge__ops_quantized_decomposed_conv2d_default"
+        ).check(
+            "executorch_exir_dialects_edge__ops_quantized_decomposed_avg_pool2d_default"
+        ).check_not(
+            "executorch_exir_dialects_edge__ops_aten_convolution_default"
+        ).check_not(
+            "executorch_exir_dialects_edge__ops_aten_avg_pool2d_default"
+        ).run(
+            m.exported_program.graph_module.code
+        )
+        m = m.to_executorch()
+        FileCheck().check("torch.ops.quantized_decomposed.conv2d.out").check(
+            "torch.ops.quantized_decomposed.avg_pool2d.out"
+        ).run(m.exported_program.graph_module.code)
+
     def test_reshape(self) -> None:
         class M(torch.nn.Module):
             def forward(self, x, y):
@@ -0,0 +1,86 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import unittest
+
+import torch
+from executorch import exir
+from executorch.exir import (
+    CaptureConfig,
+    EdgeCompileConfig,
+    ExecutorchBackendConfig,
+    memory,
+)
+
+
+class ReshapeModule(torch.nn.Module):
+    def __init__(self) -> None:
+        super().__init__()
+        self.linear = torch.nn.Linear(8, 8)
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        y = self.linear(x)
+        # view_copy, unsqueeze_copy and squeeze_copy of intermediate results.
+        z = y.view(4, 2, 8).unsqueeze(0).squeeze(0)
+        z = z * 2
+        # This view is a graph output, so it keeps its copy.
+        return z.view(8, 8)
+
+
+class TestRemoveViewCopy(unittest.TestCase):
+    def _to_executorch(self, remove_view_copy: bool) -> exir.ExecutorchProgram:
+        return (
+            exir.capture(
+                ReshapeModule().eval(),
+                (torch.randn(8, 8),),
+                CaptureConfig(),
+            )
+            .to_edge(EdgeCompileConfig())
+            .to_executorch(
+                ExecutorchBackendConfig(remove_view_copy=remove_view_copy)
+            )
+        )
+
+    def test_views_share_base_storage(self) -> None:
+        prog = self._to_executorch(remove_view_copy=True)
+        graph_module = prog.dump_graph_module()
+
+        views = [
+            node
+            for node in graph_module.graph.nodes
+            if node.op == "call_function" and node.target == memory.view
+        ]
+        self.assertEqual(len(views), 3)
+        for node in views:
+            base = node.args[0]
+            while base.target == memory.view:
+                base = base.args[0]
+            spec = node.meta["spec"]
+            base_spec = base.meta["spec"]
+            self.assertEqual(spec.mem_id, base_spec.mem_id)
+            self.assertEqual(spec.mem_offset, base_spec.mem_offset)
+            # The base's storage must stay alive for as long as the view.
+            self.assertLessEqual(base_spec.lifetime[0], spec.lifetime[0])
+            self.assertGreaterEqual(base_spec.lifetime[1], spec.lifetime[1])
+
+        # The output view is still a copy.
+        output = graph_module.graph.output_node().args[0][0]
+        self.assertNotEqual(output.target, memory.view)
+
+        op_names = [op.name for op in prog.program.execution_plan[0].operators]
+        self.assertIn("executorch_prim::et_view", op_names)
+
+    def test_needs_less_memory(self) -> None:
+        with_views = self._to_executorch(remove_view_copy=True)
+        with_copies = self._to_executorch(remove_view_copy=False)
+
+        self.assertLess(
+            sum(with_views.program.execution_plan[0].non_const_buffer_sizes),
+            sum(with_copies.program.execution_plan[0].non_const_buffer_sizes),
+        )
+
+        op_names = [op.name for op in with_copies.program.execution_plan[0].operators]
+        self.assertNotIn("executorch_prim::et_view", op_names)
@@ -9,7 +9,9 @@
 #include <executorch/extension/aten_util/aten_bridge.h>
 
 #include <executorch/runtime/platform/assert.h>
+#include <algorithm>
 #include <cstring>
+#include <numeric>
 
 namespace torch {
 namespace util {
@@ -60,6 +62,21 @@ ET_CHECK_MSG(
       torchToExecuTorchScalarType(a.options().dtype()),
       b.scalar_type());
 }
+
+// Lexicographically compares a TensorMetaCache key, sizes followed by
+// strides, with the sizes and strides of t. Returns <0, 0 or >0.
+int compare_shape_key(const std::vector<int64_t>& key, const at::Tensor& t) {
+  at::IntArrayRef sizes = t.sizes();
+  at::IntArrayRef strides = t.strides();
+  const size_t len = 2 * sizes.size();
+  for (size_t i = 0, n = std::min(key.size(), len); i < n; ++i) {
+    int64_t v = i < sizes.size() ? sizes[i] : strides[i - sizes.size()];
+    if (key[i] != v) {
+      return key[i] < v ? -1 : 1;
+    }
+  }
+  return key.size() < len ? -1 : (key.size() > len ? 1 : 0);
+}
 } // namespace
 
 torch::executor::ScalarType torchToExecuTorchScalarType(caffe2::TypeMeta type) {
@@ -127,23 +144,90 @@ c10::ScalarType execuTorchtoTorchScalarType(torch::executor::ScalarType type) {
 void alias_etensor_to_attensor(
     at::Tensor& aten_tensor,
     torch::executor::Tensor& mutable_et) {
-  // TODO(kimishpatel): contiguous according to memformat
-  // Right now we assume everything is channels first contiguous
-  // Note that input tensor must be contiguous for us to alias.
+  // Strided tensors alias as long as some dim order describes them, i.e.
+  // their elements are dense and do not overlap. The strides of mutable_et
+  // are checked against those of aten_tensor below.
   // Mixing aliasing and copying is dangerous since if we aliased
   // the instance of mutatble_et to aten_tensor in the previous call,
   // then in the next call copying will not be the correct behavior.
-  ET_CHECK_MSG(aten_tensor.is_contiguous(), "Input tensor must be contiguous");
+  ET_CHECK_MSG(
+      aten_tensor.is_non_overlapping_and_dense(),
+      "Input tensor must be dense and non-overlapping");
   check_tensor_meta(aten_tensor, mutable_et);
   mutable_et.unsafeGetTensorImpl()->set_data(aten_tensor.mutable_data_ptr());
 }
 
+bool TensorMetaCache::KeyLess::operator()(
+    const Key& a,
+    const at::Tensor& b) const {
+  return compare_shape_key(a, b) < 0;
+}
+
+bool TensorMetaCache::KeyLess::operator()(
+    const at::Tensor& a,
+    const Key& b) const {
+  return compare_shape_key(b, a) > 0;
+}
+
+const TensorMetaCache::Meta& TensorMetaCache::get(
+    const at::Tensor& aten_tensor) {
+  auto it = entries_.find(aten_tensor);
+  if (it != entries_.end()) {
+    return it->second;
+  }
+  ET_CHECK_MSG(
+      aten_tensor.is_non_overlapping_and_dense(),
+      "Input tensor must be dense and non-overlapping");
+  const size_t dim = aten_tensor.dim();
+  Key key(aten_tensor.sizes().begin(), aten_tensor.sizes().end());
+  key.insert(
+      key.end(), aten_tensor.strides().begin(), aten_tensor.strides().end());
+
+  Meta meta;
+  meta.sizes.assign(aten_tensor.sizes().begin(), aten_tensor.sizes().end());
+  meta.strides.assign(
+      aten_tensor.strides().begin(), aten_tensor.strides().end());
+  // Outermost dim first. Ties, which only size-1 dims can have in a dense
+  // tensor, keep their index order so that contiguous tensors get the
+  // default dim order.
+  meta.dim_order.resize(dim);
+  std::iota(meta.dim_order.begin(), meta.dim_order.end(), 0);
+  std::stable_sort(
+      meta.dim_order.begin(),
+      meta.dim_order.end(),
+      [&](torch::executor::Tensor::DimOrderType a,
+          torch::executor::Tensor::DimOrderType b) {
+        return meta.strides[a] > meta.strides[b];
+      });
+  return entries_.emplace(std::move(key), std::move(meta)).first->second;
+}
+
+torch::executor::TensorImpl make_etensor_impl(
+    at::Tensor& aten_tensor,
+    TensorMetaCache& cache) {
+  const TensorMetaCache::Meta& meta = cache.get(aten_tensor);
+  // Static shapes, so the TensorImpl never writes through these pointers.
+  return torch::executor::TensorImpl(
+      torchToExecuTorchScalarType(aten_tensor.options().dtype()),
+      aten_tensor.dim(),
+      const_cast<torch::executor::Tensor::SizesType*>(meta.sizes.data()),
+      aten_tensor.mutable_data_ptr(),
+      const_cast<torch::executor::Tensor::DimOrderType*>(
+          meta.dim_order.data()),
+      const_cast<torch::executor::Tensor::StridesType*>(meta.strides.data()));
+}
+
 at::Tensor alias_attensor_to_etensor(const torch::executor::Tensor& etensor) {
   c10::ScalarType dtype = execuTorchtoTorchScalarType(etensor.scalar_type());
-  std::vector<int64_t> at_tensor_sizes(
-      etensor.sizes().begin(), etensor.sizes().end());
+  // Inline storage for common ranks, so that this does not allocate.
+  at::DimVector at_tensor_sizes(etensor.sizes().begin(), etensor.sizes().end());
+  at::DimVector at_tensor_strides(
+      etensor.strides().begin(), etensor.strides().end());
   at::Tensor t = at::from_blob(
-      etensor.mutable_data_ptr(), at_tensor_sizes, at::TensorOptions(dtype));
+      etensor.mutable_data_ptr(),
+      at_tensor_sizes,
+      at_tensor_strides,
+      at::TensorOptions(dtype));
   check_tensor_meta(t, etensor);
   return t;
 }
@@ -15,6 +15,7 @@
 #include <ATen/core/functional.h> // @manual=//caffe2/aten:ATen-core
 #include <c10/core/ScalarTypeToTypeMeta.h> // @manual=//caffe2/c10:c10
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -26,21 +27,76 @@ torch::executor::ScalarType torchToExecuTorchScalarType(caffe2::TypeMeta type);
 c10::ScalarType execuTorchtoTorchScalarType(torch::executor::ScalarType type);
 
 /*
- * @param[in] aten_tensor: Input at::Tensor
+ * @param[in] aten_tensor: Input at::Tensor. It may be strided, e.g. transposed
+ * or channels last, as long as its elements are dense and non-overlapping.
  * @param[in/out] mutable_et: ETensor whose underlying memory now will alias to
- * aten_tensor
+ * aten_tensor. Its sizes and strides must match those of aten_tensor.
  */
 void alias_etensor_to_attensor(at::Tensor& at, torch::executor::Tensor& et);
 
+/*
+ * Caches ETensor metadata (sizes, strides and dim order) by the shape of the
+ * at::Tensors it describes, so that aliasing a tensor of a shape seen before
+ * allocates nothing. ETensor metadata cannot point into the at::Tensor's own
+ * because SizesType and StridesType are narrower than int64_t.
+ *
+ * Entries are never evicted and their addresses never change, so the returned
+ * metadata stays valid for the lifetime of the cache. The cache is not
+ * thread-safe; callers must serialize calls to get().
+ */
+class TensorMetaCache {
+ public:
+  struct Meta {
+    std::vector<torch::executor::Tensor::SizesType> sizes;
+    std::vector<torch::executor::Tensor::StridesType> strides;
+    std::vector<torch::executor::Tensor::DimOrderType> dim_order;
+  };
+
+  /*
+   * Returns the metadata for the sizes and strides of aten_tensor, computing
+   * it on first use. aten_tensor must be dense and non-overlapping; its dim
+   * order is derived from its strides.
+   */
+  const Meta& get(const at::Tensor& aten_tensor);
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+ private:
+  // Sizes followed by strides. Compared against at::Tensors without building
+  // a key, so that lookups do not allocate.
+  using Key = std::vector<int64_t>;
+  struct KeyLess {
+    using is_transparent = void;
+    bool operator()(const Key& a, const Key& b) const {
+      return a < b;
+    }
+    bool operator()(const Key& a, const at::Tensor& b) const;
+    bool operator()(const at::Tensor& a, const Key& b) const;
+  };
+
+  std::map<Key, Meta, KeyLess> entries_;
+};
+
+/*
+ * Initializes tensor_impl so that it aliases aten_tensor, with metadata from
+ * cache. See TensorMetaCache for the lifetime of the metadata.
+ */
+torch::executor::TensorImpl make_etensor_impl(
+    at::Tensor& aten_tensor,
+    TensorMetaCache& cache);
+
 /*
  * @param[in] et: ETensor whose underlying memory now will alias to returned
  * output tensor
  * @param[ret] aten_tensor: output at::Tensor
  * Notes:
  * It is owned by the caller of alias_attensor_to_etensor.
- * Lifetime of tensor meta must be >= to that of the returned tensor since
- * this function uses at::from_blob API that constructs non-owning tensor
- * along with non-owning metadata, e.g. sizes.
+ * The returned tensor has the sizes and strides of et, so strided ETensors
+ * alias without a copy.
+ * Lifetime of the data of et must be >= to that of the returned tensor since
+ * this function uses at::from_blob API that constructs a non-owning tensor.
  * If such lifetime guarantees cannot be provided, returned tensor should be
  * cloned.
  */
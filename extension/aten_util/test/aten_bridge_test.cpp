@@ -146,3 +146,57 @@ TEST(ATenBridgeTest, AliasATTensorToETensor) {
   auto aliased_at_tensor = alias_attensor_to_etensor(etensor);
   EXPECT_EQ(aliased_at_tensor.const_data_ptr(), etensor_data.data());
 }
+
+TEST(ATenBridgeTest, MakeETensorImplTransposed) {
+  auto at_tensor = generate_at_tensor().transpose(0, 2);
+  TensorMetaCache cache;
+  torch::executor::TensorImpl tensor_impl =
+      make_etensor_impl(at_tensor, cache);
+  torch::executor::Tensor etensor(&tensor_impl);
+  EXPECT_EQ(at_tensor.const_data_ptr(), etensor.const_data_ptr());
+  for (size_t i = 0; i < at_tensor.dim(); ++i) {
+    EXPECT_EQ(at_tensor.size(i), etensor.size(i));
+    EXPECT_EQ(at_tensor.stride(i), etensor.strides()[i]);
+  }
+  // Strides {1, 6, 30}, so the last dim is outermost.
+  EXPECT_EQ(etensor.dim_order()[0], 2);
+  EXPECT_EQ(etensor.dim_order()[1], 1);
+  EXPECT_EQ(etensor.dim_order()[2], 0);
+  // Aliasing checks that the strides match.
+  alias_etensor_to_attensor(at_tensor, etensor);
+}
+
+TEST(ATenBridgeTest, TensorMetaCacheReusesShapes) {
+  TensorMetaCache cache;
+  auto a = generate_at_tensor();
+  auto b = generate_at_tensor();
+  const TensorMetaCache::Meta& meta = cache.get(a);
+  EXPECT_EQ(&meta, &cache.get(b));
+  EXPECT_EQ(cache.size(), 1u);
+
+  // Size-1 dims of contiguous tensors get the default dim order.
+  auto c = at::empty({4, 1, 6});
+  const TensorMetaCache::Meta& meta_c = cache.get(c);
+  EXPECT_EQ(meta_c.dim_order, get_default_dim_order(c));
+  // Same sizes, different strides.
+  cache.get(a.transpose(0, 1).contiguous().transpose(0, 1));
+  EXPECT_EQ(cache.size(), 3u);
+  EXPECT_EQ(&meta, &cache.get(a));
+}
+
+TEST(ATenBridgeTest, TensorMetaCacheNonDenseFail) {
+  TensorMetaCache cache;
+  auto sliced_tensor = generate_at_tensor().slice(1, 0, 2);
+  ET_EXPECT_DEATH(cache.get(sliced_tensor), "");
+}
+
+TEST(ATenBridgeTest, AliasATTensorToETensorStrided) {
+  auto at_tensor = generate_at_tensor().transpose(1, 2);
+  TensorMetaCache cache;
+  torch::executor::TensorImpl tensor_impl =
+      make_etensor_impl(at_tensor, cache);
+  torch::executor::Tensor etensor(&tensor_impl);
+  auto aliased_at_tensor = alias_attensor_to_etensor(etensor);
+  EXPECT_EQ(aliased_at_tensor.const_data_ptr(), at_tensor.const_data_ptr());
+  EXPECT_EQ(aliased_at_tensor.strides(), at_tensor.strides());
+}
@@ -138,19 +138,6 @@ Result<FreeableBuffer> FileDataLoader::Load(size_t offset, size_t size) {
     return FreeableBuffer(nullptr, 0, /*free_fn=*/nullptr);
   }
 
-  // Seek to the right place in the file.
-  off_t seek_offset = ::lseek(fd_, offset, SEEK_SET);
-  if (seek_offset != offset) {
-    ET_LOG(
-        Error,
-        "Seeking %s to offset %zu returned %zd: %s",
-        file_name_,
-        offset,
-        (ssize_t)seek_offset,
-        strerror(errno));
-    return Error::AccessFailed;
-  }
-
   // Allocate memory for the FreeableBuffer.
   size_t alloc_size = size;
   if (alignment_ > alignof(std::max_align_t)) {
@@ -182,19 +169,35 @@ Result<FreeableBuffer> FileDataLoader::Load(size_t offset, size_t size) {
       buffer,
       alloc_size);
 
-  // Read the data into the aligned address.
-  ssize_t nread = ::read(fd_, aligned_buffer, size);
-  if (nread < size) {
-    ET_LOG(
-        Error,
-        "Reading from %s at offset %zu: short read %zd < %zu",
-        file_name_,
-        offset,
-        nread,
-        size);
-    // Free `buffer`, which is what malloc() gave us, not `aligned_buffer`.
-    std::free(buffer);
-    return Error::AccessFailed;
+  // Read the data into the aligned address. pread() neither uses nor moves
+  // the file offset, so concurrent calls don't interfere with each other. It
+  // may return fewer bytes than requested, e.g. when interrupted or for very
+  // large reads, so keep reading until all of the data has arrived.
+  uint8_t* dest = static_cast<uint8_t*>(aligned_buffer);
+  size_t needed = size;
+  while (needed > 0) {
+    const size_t read_offset = offset + (size - needed);
+    ssize_t nread = ::pread(fd_, dest, needed, read_offset);
+    if (nread < 0 && errno == EINTR) {
+      // Interrupted by a signal; try again.
+      continue;
+    }
+    if (nread <= 0) {
+      // A zero return means the file ended early; it may have been truncated
+      // since it was opened.
+      ET_LOG(
+          Error,
+          "Reading %zu bytes from %s at offset %zu: %s",
+          needed,
+          file_name_,
+          read_offset,
+          nread == 0 ? "unexpected end of file" : strerror(errno));
+      // Free `buffer`, which is what malloc() gave us, not `aligned_buffer`.
+      std::free(buffer);
+      return Error::AccessFailed;
+    }
+    dest += nread;
+    needed -= nread;
   }
 
   // We can't naively free this pointer, since it may not be what malloc() gave
@@ -213,6 +216,43 @@ Result<FreeableBuffer> FileDataLoader::Load(size_t offset, size_t size) {
           reinterpret_cast<intptr_t>(buffer)));
 }
 
+Error FileDataLoader::Prefetch(size_t offset, size_t size) {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      fd_ >= 0,
+      InvalidState,
+      "Uninitialized");
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + size <= file_size_,
+      InvalidArgument,
+      "File %s: offset %zu + size %zu > file_size_ %zu",
+      file_name_,
+      offset,
+      size,
+      file_size_);
+#if defined(POSIX_FADV_WILLNEED)
+  // Starts asynchronous readahead of the range into the page cache.
+  int err = ::posix_fadvise(
+      fd_,
+      static_cast<off_t>(offset),
+      static_cast<off_t>(size),
+      POSIX_FADV_WILLNEED);
+  if (err != 0) {
+    // posix_fadvise() returns the error instead of setting errno.
+    ET_LOG(
+        Info,
+        "File %s: posix_fadvise(WILLNEED) failed: %s (%d)",
+        file_name_,
+        strerror(err),
+        err);
+    return Error::NotSupported;
+  }
+  return Error::Ok;
+#else
+  return Error::NotSupported;
+#endif
+}
+
 Result<size_t> FileDataLoader::size() const {
   ET_CHECK_OR_RETURN_ERROR(
       // Probably had its value moved to another instance.
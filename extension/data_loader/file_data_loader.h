@@ -24,6 +24,10 @@ namespace util {
  *
  * Note that this will keep the file open for the duration of its lifetime, to
  * avoid the overhead of opening it again for every Load() call.
+ *
+ * Load() is thread-safe: it reads with `pread()`, which does not share a file
+ * offset between calls, so several threads may load segments from the same
+ * instance concurrently without external locking.
  */
 class FileDataLoader : public DataLoader {
  public:
@@ -68,6 +72,13 @@ class FileDataLoader : public DataLoader {
   __ET_NODISCARD Result<FreeableBuffer> Load(size_t offset, size_t size)
       override;
 
+  /**
+   * Asks the OS to start reading the range into its page cache with
+   * `posix_fadvise(POSIX_FADV_WILLNEED)`, so that a later Load() of it copies
+   * from memory instead of waiting on the device.
+   */
+  __ET_NODISCARD Error Prefetch(size_t offset, size_t size) override;
+
   __ET_NODISCARD Result<size_t> size() const override;
 
  private:
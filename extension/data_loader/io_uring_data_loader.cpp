@@ -0,0 +1,786 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/io_uring_data_loader.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+namespace {
+
+/// The block size that O_DIRECT reads are aligned to. This covers the logical
+/// block size of common devices.
+constexpr size_t kDirectIoBlockSize = 4096;
+
+/// The largest read submitted to the ring. Larger loads are split into reads
+/// of this size, which the kernel can service in parallel.
+constexpr size_t kMaxReadSize = 1 << 20;
+
+/// The user_data of the no-op that tells the completion thread to exit. Reads
+/// use the address of their Request::Read, which is never null.
+constexpr uint64_t kShutdownUserData = 0;
+
+/**
+ * Returns true if the value is an integer power of 2.
+ */
+static bool is_power_of_2(size_t value) {
+  return value > 0 && (value & ~(value - 1)) == value;
+}
+
+/**
+ * Returns the next alignment for a given pointer.
+ */
+static uint8_t* align_pointer(void* ptr, size_t alignment) {
+  intptr_t addr = reinterpret_cast<intptr_t>(ptr);
+  if ((addr & (alignment - 1)) == 0) {
+    // Already aligned.
+    return reinterpret_cast<uint8_t*>(ptr);
+  }
+  // Bump forward.
+  addr = (addr | (alignment - 1)) + 1;
+  return reinterpret_cast<uint8_t*>(addr);
+}
+
+// There is no libc wrapper for the io_uring syscalls.
+int sys_io_uring_setup(unsigned entries, struct io_uring_params* params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(
+    int ring_fd,
+    unsigned to_submit,
+    unsigned min_complete,
+    unsigned flags) {
+  return static_cast<int>(::syscall(
+      __NR_io_uring_enter,
+      ring_fd,
+      to_submit,
+      min_complete,
+      flags,
+      /*sig=*/nullptr,
+      /*sigsz=*/0));
+}
+
+/**
+ * FreeableBuffer::FreeFn-compatible callback.
+ *
+ * `context` is actually a ptrdiff_t value (not a pointer) that contains the
+ * offset in bytes between `data` and the actual pointer to free.
+ */
+void FreeSegment(void* context, void* data, __ET_UNUSED size_t size) {
+  ptrdiff_t offset = reinterpret_cast<ptrdiff_t>(context);
+  ET_DCHECK_MSG(offset >= 0, "Unexpected offset %ld", (long int)offset);
+  std::free(static_cast<uint8_t*>(data) - offset);
+}
+
+} // namespace
+
+/**
+ * One LoadAsync() call: the buffer being filled, and the reads that fill it.
+ */
+struct IoUringDataLoader::Request {
+  /// One read into part of the buffer. Its address is the SQE's user_data.
+  struct Read {
+    Request* request;
+    /// The file offset of the next byte to read.
+    size_t offset;
+    /// Where the next byte goes.
+    uint8_t* dest;
+    size_t remaining;
+  };
+
+  LoadCallback callback;
+  void* context;
+
+  int fd;
+  size_t file_size;
+  const char* file_name;
+
+  /// What malloc() returned.
+  void* allocation;
+  /// The aligned start of the read range within `allocation`.
+  uint8_t* buffer;
+  /// The bytes read before the requested data to start on a block boundary.
+  size_t lead;
+  /// The requested size.
+  size_t size;
+  size_t alignment;
+
+  std::unique_ptr<Read[]> reads;
+  size_t num_reads;
+
+  // Guarded by Queue::mutex_.
+  size_t pending;
+  bool failed;
+};
+
+/**
+ * An io_uring and the thread that reaps its completions.
+ */
+class IoUringDataLoader::Queue {
+ public:
+  static Result<std::unique_ptr<Queue>> create(uint32_t depth);
+
+  /// Waits for the submitted reads to complete, then releases the ring.
+  ~Queue();
+
+  /**
+   * Submits all reads of `request`. On success, the request belongs to the
+   * queue, which will complete and delete it, possibly before this returns.
+   * On failure, none of the reads were submitted and the caller still owns
+   * the request.
+   */
+  __ET_NODISCARD Error submit(Request* request);
+
+ private:
+  Queue() = default;
+
+  /// Adds an SQE to the submission queue, without submitting it yet.
+  void push_locked(uint8_t opcode, const Request::Read* read);
+
+  /// Submits the pushed SQEs. Adds the number the kernel took to `submitted`.
+  __ET_NODISCARD Error flush_locked(size_t* submitted);
+
+  /// The body of thread_: reaps completions until shut down.
+  void reap();
+
+  /// Handles the completion of one read, finishing its request if it was the
+  /// last one.
+  void complete_read(Request::Read* read, int32_t res);
+
+  /// Calls the request's callback and deletes it.
+  static void finish(Request* request);
+
+  int ring_fd_ = -1;
+  void* sq_ring_ = MAP_FAILED;
+  size_t sq_ring_size_ = 0;
+  void* cq_ring_ = MAP_FAILED;
+  size_t cq_ring_size_ = 0;
+  void* sqes_ = MAP_FAILED;
+  size_t sqes_size_ = 0;
+
+  // Submission queue. Only written with mutex_ held.
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* sq_array_ = nullptr;
+  unsigned unsubmitted_ = 0;
+
+  // Completion queue. Only touched by thread_.
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  struct io_uring_cqe* cqes_ = nullptr;
+
+  /// The maximum number of SQEs in flight. The completion queue is larger
+  /// than this, so it can never overflow.
+  unsigned capacity_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable slot_available_;
+  unsigned in_flight_ = 0; // Guarded by mutex_.
+
+  std::thread thread_;
+};
+
+Result<std::unique_ptr<IoUringDataLoader::Queue>>
+IoUringDataLoader::Queue::create(uint32_t depth) {
+  std::unique_ptr<Queue> queue(new Queue());
+
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  queue->ring_fd_ = sys_io_uring_setup(depth, &params);
+  if (queue->ring_fd_ < 0) {
+    ET_LOG(
+        Error,
+        "io_uring_setup(%u) failed: %s (%d)",
+        (unsigned)depth,
+        strerror(errno),
+        errno);
+    return Error::NotSupported;
+  }
+
+  // Map the rings. Newer kernels share one mapping between them.
+  queue->sq_ring_size_ =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  queue->cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    queue->sq_ring_size_ =
+        std::max(queue->sq_ring_size_, queue->cq_ring_size_);
+    queue->cq_ring_size_ = queue->sq_ring_size_;
+  }
+  queue->sq_ring_ = ::mmap(
+      nullptr,
+      queue->sq_ring_size_,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      queue->ring_fd_,
+      IORING_OFF_SQ_RING);
+  if (queue->sq_ring_ != MAP_FAILED && single_mmap) {
+    queue->cq_ring_ = queue->sq_ring_;
+  } else if (queue->sq_ring_ != MAP_FAILED) {
+    queue->cq_ring_ = ::mmap(
+        nullptr,
+        queue->cq_ring_size_,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE,
+        queue->ring_fd_,
+        IORING_OFF_CQ_RING);
+  }
+  if (queue->cq_ring_ != MAP_FAILED) {
+    queue->sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    queue->sqes_ = ::mmap(
+        nullptr,
+        queue->sqes_size_,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE,
+        queue->ring_fd_,
+        IORING_OFF_SQES);
+  }
+  if (queue->sqes_ == MAP_FAILED) {
+    ET_LOG(Error, "Mapping io_uring failed: %s (%d)", strerror(errno), errno);
+    return Error::MemoryAllocationFailed;
+  }
+
+  uint8_t* sq_ring = static_cast<uint8_t*>(queue->sq_ring_);
+  queue->sq_tail_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+  queue->sq_mask_ =
+      *reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+  queue->sq_array_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+  uint8_t* cq_ring = static_cast<uint8_t*>(queue->cq_ring_);
+  queue->cq_head_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+  queue->cq_tail_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+  queue->cq_mask_ =
+      *reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+  queue->cqes_ =
+      reinterpret_cast<struct io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+  queue->capacity_ = params.sq_entries;
+
+  queue->thread_ = std::thread(&Queue::reap, queue.get());
+  return queue;
+}
+
+IoUringDataLoader::Queue::~Queue() {
+  if (thread_.joinable()) {
+    // Queue a no-op behind the outstanding reads, and let the thread exit
+    // once everything has completed.
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      slot_available_.wait(lock, [this] { return in_flight_ < capacity_; });
+      push_locked(IORING_OP_NOP, /*read=*/nullptr);
+      in_flight_++;
+      size_t submitted = 0;
+      Error err = flush_locked(&submitted);
+      // The thread would otherwise wait forever.
+      ET_CHECK_MSG(
+          err == Error::Ok,
+          "Failed to stop io_uring: 0x%" PRIx32,
+          static_cast<uint32_t>(err));
+    }
+    thread_.join();
+  }
+  if (sqes_ != MAP_FAILED) {
+    ::munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+    ::munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != MAP_FAILED) {
+    ::munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    ::close(ring_fd_);
+  }
+}
+
+void IoUringDataLoader::Queue::push_locked(
+    uint8_t opcode,
+    const Request::Read* read) {
+  const unsigned tail = *sq_tail_;
+  const unsigned index = tail & sq_mask_;
+  struct io_uring_sqe* sqe =
+      static_cast<struct io_uring_sqe*>(sqes_) + index;
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  if (read != nullptr) {
+    sqe->fd = read->request->fd;
+    sqe->off = read->offset;
+    sqe->addr = reinterpret_cast<uint64_t>(read->dest);
+    sqe->len = static_cast<uint32_t>(read->remaining);
+    sqe->user_data = reinterpret_cast<uint64_t>(read);
+  } else {
+    sqe->fd = -1;
+    sqe->user_data = kShutdownUserData;
+  }
+  sq_array_[index] = index;
+  // Publish the SQE before the kernel can see the new tail.
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  unsubmitted_++;
+}
+
+Error IoUringDataLoader::Queue::flush_locked(size_t* submitted) {
+  while (unsubmitted_ > 0) {
+    int ret = sys_io_uring_enter(
+        ring_fd_, unsubmitted_, /*min_complete=*/0, /*flags=*/0);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      ET_LOG(
+          Error,
+          "io_uring_enter() failed to submit %u reads: %s (%d)",
+          unsubmitted_,
+          ret == 0 ? "no progress" : strerror(errno),
+          ret == 0 ? 0 : errno);
+      // Take back the SQEs that the kernel has not consumed, so that a later
+      // submission does not pick them up.
+      __atomic_store_n(sq_tail_, *sq_tail_ - unsubmitted_, __ATOMIC_RELEASE);
+      unsubmitted_ = 0;
+      return Error::AccessFailed;
+    }
+    unsubmitted_ -= ret;
+    *submitted += ret;
+  }
+  return Error::Ok;
+}
+
+Error IoUringDataLoader::Queue::submit(Request* request) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Completions may arrive as soon as the first read is submitted, so count
+  // every read up front; the last completion finishes the request.
+  request->pending = request->num_reads;
+  request->failed = false;
+
+  size_t pushed = 0;
+  size_t submitted = 0;
+  Error err = Error::Ok;
+  while (pushed < request->num_reads) {
+    if (in_flight_ == capacity_) {
+      // Submit what we have, and wait for the completion thread to make room.
+      err = flush_locked(&submitted);
+      if (err != Error::Ok) {
+        break;
+      }
+      slot_available_.wait(lock, [this] { return in_flight_ < capacity_; });
+    }
+    push_locked(IORING_OP_READ, &request->reads[pushed]);
+    pushed++;
+    in_flight_++;
+  }
+  if (err == Error::Ok) {
+    // Submit the remaining reads with a single syscall.
+    err = flush_locked(&submitted);
+  }
+  if (err == Error::Ok) {
+    return Error::Ok;
+  }
+
+  // Forget the reads that never reached the kernel.
+  in_flight_ -= pushed - submitted;
+  slot_available_.notify_all();
+  if (submitted == 0) {
+    return err;
+  }
+  // Let the reads that were submitted complete, then fail the request.
+  request->failed = true;
+  request->pending -= request->num_reads - submitted;
+  if (request->pending == 0) {
+    lock.unlock();
+    finish(request);
+  }
+  return Error::Ok;
+}
+
+void IoUringDataLoader::Queue::reap() {
+  bool shutting_down = false;
+  while (true) {
+    if (shutting_down) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (in_flight_ == 0) {
+        return;
+      }
+    }
+    int ret = sys_io_uring_enter(
+        ring_fd_,
+        /*to_submit=*/0,
+        /*min_complete=*/1,
+        IORING_ENTER_GETEVENTS);
+    ET_CHECK_MSG(
+        ret >= 0 || errno == EINTR || errno == EAGAIN || errno == EBUSY,
+        "Waiting for io_uring completions failed: %s (%d)",
+        strerror(errno),
+        errno);
+
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const struct io_uring_cqe* cqe = &cqes_[head & cq_mask_];
+      const uint64_t user_data = cqe->user_data;
+      const int32_t res = cqe->res;
+      // Hand the CQE back to the kernel, and make room for another SQE,
+      // before running any callbacks.
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_flight_--;
+      }
+      slot_available_.notify_all();
+
+      if (user_data == kShutdownUserData) {
+        shutting_down = true;
+      } else {
+        complete_read(reinterpret_cast<Request::Read*>(user_data), res);
+      }
+    }
+  }
+}
+
+void IoUringDataLoader::Queue::complete_read(
+    Request::Read* read,
+    int32_t res) {
+  Request* request = read->request;
+  bool ok = true;
+  if (res < 0) {
+    ET_LOG(
+        Error,
+        "Reading %zu bytes from %s at offset %zu: %s",
+        read->remaining,
+        request->file_name,
+        read->offset,
+        strerror(-res));
+    ok = false;
+  } else {
+    read->offset += res;
+    read->dest += res;
+    read->remaining -= res;
+  }
+  // Reads come up short at the end of the file, which reads widened to whole
+  // blocks may go past, and very rarely otherwise. Finish the latter here
+  // rather than queueing another SQE.
+  while (ok && read->remaining > 0 && read->offset < request->file_size) {
+    ssize_t nread =
+        ::pread(request->fd, read->dest, read->remaining, read->offset);
+    if (nread < 0 && errno == EINTR) {
+      continue;
+    }
+    if (nread <= 0) {
+      // A zero return means the file ended early; it may have been truncated
+      // since it was opened.
+      ET_LOG(
+          Error,
+          "Reading %zu bytes from %s at offset %zu: %s",
+          read->remaining,
+          request->file_name,
+          read->offset,
+          nread == 0 ? "unexpected end of file" : strerror(errno));
+      ok = false;
+      break;
+    }
+    read->offset += nread;
+    read->dest += nread;
+    read->remaining -= nread;
+  }
+
+  bool last = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ok) {
+      request->failed = true;
+    }
+    last = --request->pending == 0;
+  }
+  if (last) {
+    finish(request);
+  }
+}
+
+void IoUringDataLoader::Queue::finish(Request* request) {
+  std::unique_ptr<Request> owned(request);
+  if (request->failed) {
+    std::free(request->allocation);
+    request->callback(request->context, Error::AccessFailed);
+    return;
+  }
+  uint8_t* data = request->buffer + request->lead;
+  if (request->lead % request->alignment != 0) {
+    // Widening the read to a block boundary misaligned the data.
+    std::memmove(request->buffer, data, request->size);
+    data = request->buffer;
+  }
+  // Pass the offset to the real buffer as context, as FileDataLoader does.
+  request->callback(
+      request->context,
+      FreeableBuffer(
+          data,
+          request->size,
+          FreeSegment,
+          /*free_fn_context=*/
+          reinterpret_cast<void*>(
+              reinterpret_cast<intptr_t>(data) -
+              reinterpret_cast<intptr_t>(request->allocation))));
+}
+
+IoUringDataLoader::IoUringDataLoader(
+    int fd,
+    size_t file_size,
+    size_t alignment,
+    size_t block_size,
+    const char* file_name,
+    std::unique_ptr<Queue> queue)
+    : file_name_(file_name),
+      file_size_(file_size),
+      alignment_(alignment),
+      block_size_(block_size),
+      fd_(fd),
+      queue_(std::move(queue)) {}
+
+IoUringDataLoader::IoUringDataLoader(IoUringDataLoader&& rhs) noexcept
+    : file_name_(rhs.file_name_),
+      file_size_(rhs.file_size_),
+      alignment_(rhs.alignment_),
+      block_size_(rhs.block_size_),
+      fd_(rhs.fd_),
+      queue_(std::move(rhs.queue_)) {
+  rhs.file_name_ = nullptr;
+  rhs.file_size_ = 0;
+  rhs.alignment_ = 0;
+  rhs.block_size_ = 0;
+  rhs.fd_ = -1;
+}
+
+IoUringDataLoader::~IoUringDataLoader() {
+  // Outstanding reads use the fd and the name, so wait for them first.
+  queue_.reset();
+  // file_name_ can be nullptr if this instance was moved from, but freeing a
+  // null pointer is safe.
+  std::free(const_cast<char*>(file_name_));
+  // fd_ can be -1 if this instance was moved from, but closing a negative fd is
+  // safe (though it will return an error).
+  ::close(fd_);
+}
+
+Result<IoUringDataLoader> IoUringDataLoader::from(
+    const char* file_name,
+    size_t alignment,
+    bool direct_io,
+    uint32_t queue_depth) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_power_of_2(alignment),
+      InvalidArgument,
+      "Alignment %zu is not a power of 2",
+      alignment);
+  ET_CHECK_OR_RETURN_ERROR(
+      queue_depth > 0, InvalidArgument, "Queue depth must be positive");
+
+  int fd = -1;
+  size_t block_size = 1;
+  if (direct_io) {
+    fd = ::open(file_name, O_RDONLY | O_DIRECT);
+    if (fd >= 0) {
+      block_size = kDirectIoBlockSize;
+    } else if (errno == EINVAL) {
+      // E.g., tmpfs does not support O_DIRECT.
+      ET_LOG(
+          Info, "%s does not support O_DIRECT; using cached reads", file_name);
+    }
+  }
+  if (fd < 0) {
+    fd = ::open(file_name, O_RDONLY);
+  }
+  if (fd < 0) {
+    ET_LOG(
+        Error, "Failed to open %s: %s (%d)", file_name, strerror(errno), errno);
+    return Error::AccessFailed;
+  }
+
+  // Cache the file size.
+  struct stat st;
+  int err = ::fstat(fd, &st);
+  if (err < 0) {
+    ET_LOG(
+        Error,
+        "Could not get length of %s: %s (%d)",
+        file_name,
+        ::strerror(errno),
+        errno);
+    ::close(fd);
+    return Error::AccessFailed;
+  }
+  size_t file_size = st.st_size;
+
+  // Copy the filename so we can print better debug messages if reads fail.
+  const char* file_name_copy = ::strdup(file_name);
+  if (file_name_copy == nullptr) {
+    ET_LOG(Error, "strdup(%s) failed", file_name);
+    ::close(fd);
+    return Error::MemoryAllocationFailed;
+  }
+
+  Result<std::unique_ptr<Queue>> queue = Queue::create(queue_depth);
+  if (!queue.ok()) {
+    std::free(const_cast<char*>(file_name_copy));
+    ::close(fd);
+    return queue.error();
+  }
+
+  return IoUringDataLoader(
+      fd,
+      file_size,
+      alignment,
+      block_size,
+      file_name_copy,
+      std::move(queue.get()));
+}
+
+Result<FreeableBuffer> IoUringDataLoader::Load(size_t offset, size_t size) {
+  struct Waiter {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::optional<Result<FreeableBuffer>> result;
+  } waiter;
+
+  Error err = LoadAsync(
+      offset,
+      size,
+      [](void* context, Result<FreeableBuffer> result) {
+        auto* w = static_cast<Waiter*>(context);
+        // Notify with the lock held, so that `waiter` outlives the call.
+        std::lock_guard<std::mutex> lock(w->mutex);
+        w->result.emplace(std::move(result));
+        w->done.notify_one();
+      },
+      &waiter);
+  if (err != Error::Ok) {
+    return err;
+  }
+
+  std::unique_lock<std::mutex> lock(waiter.mutex);
+  waiter.done.wait(lock, [&waiter] { return waiter.result.has_value(); });
+  return std::move(*waiter.result);
+}
+
+Error IoUringDataLoader::LoadAsync(
+    size_t offset,
+    size_t size,
+    LoadCallback callback,
+    void* context) {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      fd_ >= 0 && queue_ != nullptr,
+      InvalidState,
+      "Uninitialized");
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + size <= file_size_,
+      InvalidArgument,
+      "File %s: offset %zu + size %zu > file_size_ %zu",
+      file_name_,
+      offset,
+      size,
+      file_size_);
+
+  // Don't bother allocating/freeing for empty segments.
+  if (size == 0) {
+    callback(context, FreeableBuffer(nullptr, 0, /*free_fn=*/nullptr));
+    return Error::Ok;
+  }
+
+  // O_DIRECT reads must start and end on block boundaries, and land in
+  // block-aligned memory. block_size_ is 1 otherwise.
+  const size_t read_begin = offset & ~(block_size_ - 1);
+  const size_t read_end =
+      (offset + size + block_size_ - 1) & ~(block_size_ - 1);
+  const size_t read_size = read_end - read_begin;
+  const size_t buffer_alignment = std::max(alignment_, block_size_);
+
+  // Allocate memory for the FreeableBuffer.
+  size_t alloc_size = read_size;
+  if (buffer_alignment > alignof(std::max_align_t)) {
+    // malloc() will align to smaller values, but we must manually align to
+    // larger values.
+    alloc_size += buffer_alignment;
+  }
+  void* allocation = std::malloc(alloc_size);
+  if (allocation == nullptr) {
+    ET_LOG(
+        Error,
+        "Reading from %s at offset %zu: malloc(%zd) failed",
+        file_name_,
+        offset,
+        size);
+    return Error::MemoryAllocationFailed;
+  }
+
+  auto request = std::make_unique<Request>();
+  request->callback = callback;
+  request->context = context;
+  request->fd = fd_;
+  request->file_size = file_size_;
+  request->file_name = file_name_;
+  request->allocation = allocation;
+  request->buffer = align_pointer(allocation, buffer_alignment);
+  request->lead = offset - read_begin;
+  request->size = size;
+  request->alignment = alignment_;
+
+  // Split the range into reads that the kernel can work on in parallel.
+  request->num_reads = (read_size + kMaxReadSize - 1) / kMaxReadSize;
+  request->reads = std::make_unique<Request::Read[]>(request->num_reads);
+  for (size_t i = 0; i < request->num_reads; ++i) {
+    const size_t begin = i * kMaxReadSize;
+    request->reads[i].request = request.get();
+    request->reads[i].offset = read_begin + begin;
+    request->reads[i].dest = request->buffer + begin;
+    request->reads[i].remaining = std::min(kMaxReadSize, read_size - begin);
+  }
+
+  Error err = queue_->submit(request.get());
+  if (err != Error::Ok) {
+    std::free(allocation);
+    return err;
+  }
+  // The queue owns the request now, and may already have deleted it.
+  (void)request.release();
+  return Error::Ok;
+}
+
+Result<size_t> IoUringDataLoader::size() const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      fd_ >= 0,
+      InvalidState,
+      "Uninitialized");
+  return file_size_;
+}
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * A DataLoader that reads segments from a file through a Linux io_uring,
+ * allocating the memory with `malloc()`.
+ *
+ * LoadAsync() only queues the reads and returns; a thread owned by the loader
+ * waits for them to complete and calls the callbacks. Large loads are split
+ * into several reads that are submitted to the kernel together, so that the
+ * device can work on them in parallel. Load() is LoadAsync() followed by a
+ * wait for the result.
+ *
+ * Both Load() and LoadAsync() are thread-safe. Destroying the loader waits for
+ * outstanding loads to complete and calls their callbacks first.
+ *
+ * Requires Linux 5.6 or later.
+ */
+class IoUringDataLoader : public DataLoader {
+ public:
+  /**
+   * Creates a new IoUringDataLoader that wraps the named file.
+   *
+   * @param[in] file_name Path to the file to read from.
+   * @param[in] alignment Alignment in bytes of pointers returned by this
+   *     instance. Must be a power of two.
+   * @param[in] direct_io If true, open the file with `O_DIRECT` so that reads
+   *     bypass the OS page cache. Reads are then widened to whole blocks and
+   *     land in block-aligned buffers. Falls back to cached reads if the file
+   *     system does not support `O_DIRECT`.
+   * @param[in] queue_depth The maximum number of reads in flight at once.
+   *     Rounded up to a power of two by the kernel.
+   *
+   * @returns A new IoUringDataLoader on success.
+   * @retval Error::InvalidArgument `alignment` is not a power of two, or
+   *     `queue_depth` is zero.
+   * @retval Error::AccessFailed `file_name` could not be opened, or its size
+   *     could not be found.
+   * @retval Error::NotSupported io_uring is not available, e.g. because the
+   *     kernel is too old or a seccomp policy blocks it.
+   * @retval Error::MemoryAllocationFailed Internal memory allocation failure.
+   */
+  static Result<IoUringDataLoader> from(
+      const char* file_name,
+      size_t alignment = alignof(std::max_align_t),
+      bool direct_io = false,
+      uint32_t queue_depth = 64);
+
+  // Movable to be compatible with Result. Defined out of line, where Queue is
+  // a complete type.
+  IoUringDataLoader(IoUringDataLoader&& rhs) noexcept;
+
+  ~IoUringDataLoader() override;
+
+  __ET_NODISCARD Result<FreeableBuffer> Load(size_t offset, size_t size)
+      override;
+
+  /**
+   * Queues the reads for the range and returns without waiting for them. The
+   * callback runs on the loader's completion thread, except for empty loads,
+   * which complete before this returns. Callbacks hold up other completions
+   * while they run, and must not call Load() on the same loader.
+   */
+  __ET_NODISCARD Error LoadAsync(
+      size_t offset,
+      size_t size,
+      LoadCallback callback,
+      void* context) override;
+
+  __ET_NODISCARD Result<size_t> size() const override;
+
+ private:
+  class Queue;
+  struct Request;
+
+  IoUringDataLoader(
+      int fd,
+      size_t file_size,
+      size_t alignment,
+      size_t block_size,
+      const char* file_name,
+      std::unique_ptr<Queue> queue);
+
+  // Not safely copyable.
+  IoUringDataLoader(const IoUringDataLoader&) = delete;
+  IoUringDataLoader& operator=(const IoUringDataLoader&) = delete;
+  IoUringDataLoader& operator=(IoUringDataLoader&&) = delete;
+
+  const char* file_name_; // Owned by the instance.
+  size_t file_size_;
+  size_t alignment_;
+  /// The block size that reads are widened to, or 1 without O_DIRECT.
+  size_t block_size_;
+  int fd_; // Owned by the instance.
+  std::unique_ptr<Queue> queue_;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
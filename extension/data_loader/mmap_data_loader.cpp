@@ -37,7 +37,8 @@ MmapDataLoader::~MmapDataLoader() {
 
 Result<MmapDataLoader> MmapDataLoader::from(
     const char* file_name,
-    MmapDataLoader::MlockConfig mlock_config) {
+    MmapDataLoader::MlockConfig mlock_config,
+    MmapDataLoader::MapConfig map_config) {
   // Cache the page size.
   long page_size = sysconf(_SC_PAGESIZE);
   if (page_size < 0) {
@@ -85,14 +86,105 @@ Result<MmapDataLoader> MmapDataLoader::from(
       file_size,
       file_name_copy,
       static_cast<size_t>(page_size),
-      mlock_config);
+      mlock_config,
+      map_config);
 }
 
 namespace {
+
+/// Transparent huge pages can only back a file mapping whose address is
+/// congruent to its file offset modulo the huge page size. 2 MiB is the size
+/// on x86-64 and on arm64 with 4 KiB pages.
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
 /// FreeableBuffer::FreeFn-compatible callback.
 void MunmapSegment(__ET_UNUSED void* context, void* data, size_t size) {
   ::munmap(data, size);
 }
+
+/// FreeableBuffer::FreeFn-compatible callback for MapConfig::release_on_free.
+void ReleaseAndMunmapSegment(
+    __ET_UNUSED void* context,
+    void* data,
+    size_t size) {
+#if defined(MADV_PAGEOUT)
+  // MADV_DONTNEED would only drop this mapping's page table entries, which
+  // munmap() does anyway; MADV_PAGEOUT also reclaims the page cache pages that
+  // no other mapping uses. It skips locked pages, so unlock them first.
+  ::munlock(data, size);
+  ::madvise(data, size, MADV_PAGEOUT);
+#endif
+  ::munmap(data, size);
+}
+
+/**
+ * Like mmap(), but places the mapping at an address that is congruent to
+ * `offset` modulo kHugePageSize, so that huge pages can back it.
+ */
+void* mmap_huge_page_congruent(
+    size_t size,
+    int flags,
+    int fd,
+    size_t offset,
+    size_t page_size) {
+  // Reserve enough address space to find a congruent start in, then map the
+  // file over part of it.
+  const size_t reserve_size = size + kHugePageSize;
+  void* reserve = ::mmap(
+      nullptr,
+      reserve_size,
+      PROT_NONE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+      /*fd=*/-1,
+      /*offset=*/0);
+  if (reserve == MAP_FAILED) {
+    return MAP_FAILED;
+  }
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(reserve);
+  const uintptr_t start = begin + ((offset - begin) & (kHugePageSize - 1));
+  void* pages = ::mmap(
+      reinterpret_cast<void*>(start),
+      size,
+      PROT_READ,
+      flags | MAP_FIXED,
+      fd,
+      static_cast<off_t>(offset));
+  if (pages == MAP_FAILED) {
+    ::munmap(reserve, reserve_size);
+    return MAP_FAILED;
+  }
+  // Give back the parts of the reservation on either side of the mapping.
+  const uintptr_t end = start + ((size + page_size - 1) & ~(page_size - 1));
+  if (start > begin) {
+    ::munmap(reserve, start - begin);
+  }
+  if (begin + reserve_size > end) {
+    ::munmap(reinterpret_cast<void*>(end), begin + reserve_size - end);
+  }
+  return pages;
+}
+
+/// Calls madvise(), logging and ignoring failures since the advice is only a
+/// hint.
+void advise(
+    const char* file_name,
+    void* pages,
+    size_t size,
+    int advice,
+    const char* advice_name) {
+  if (::madvise(pages, size, advice) < 0) {
+    ET_LOG(
+        Info,
+        "File %s: ignoring madvise(%p, %zu, %s) failure: %s (%d)",
+        file_name,
+        pages,
+        size,
+        advice_name,
+        strerror(errno),
+        errno);
+  }
+}
+
 } // namespace
 
 Result<FreeableBuffer> MmapDataLoader::Load(size_t offset, size_t size) {
@@ -131,8 +223,15 @@ Result<FreeableBuffer> MmapDataLoader::Load(size_t offset, size_t size) {
   // Map the pages read-only. MAP_PRIVATE vs. MAP_SHARED doesn't matter since
   // the data is read-only, but use PRIVATE just to further avoid accidentally
   // modifying the file.
-  void* pages = mmap(
-      nullptr, size, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(offset));
+  int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+  if (map_config_.populate) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+  void* pages = map_config_.huge_pages
+      ? mmap_huge_page_congruent(size, flags, fd_, offset, page_size_)
+      : mmap(nullptr, size, PROT_READ, flags, fd_, static_cast<off_t>(offset));
   ET_CHECK_OR_RETURN_ERROR(
       pages != MAP_FAILED,
       AccessFailed,
@@ -164,7 +263,63 @@ Result<FreeableBuffer> MmapDataLoader::Load(size_t offset, size_t size) {
     // No need to keep track of this. munmap() will unlock as a side effect.
   }
 
-  return FreeableBuffer(pages, size, MunmapSegment);
+#if defined(MADV_HUGEPAGE)
+  if (map_config_.huge_pages) {
+    advise(file_name_, pages, size, MADV_HUGEPAGE, "MADV_HUGEPAGE");
+  }
+#endif
+  switch (map_config_.access_pattern) {
+    case AccessPattern::Normal:
+      break;
+    case AccessPattern::Sequential:
+      advise(file_name_, pages, size, MADV_SEQUENTIAL, "MADV_SEQUENTIAL");
+      break;
+    case AccessPattern::Random:
+      advise(file_name_, pages, size, MADV_RANDOM, "MADV_RANDOM");
+      break;
+  }
+
+  return FreeableBuffer(
+      pages,
+      size,
+      map_config_.release_on_free ? ReleaseAndMunmapSegment : MunmapSegment);
+}
+
+Error MmapDataLoader::Prefetch(size_t offset, size_t size) {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      fd_ >= 0,
+      InvalidState,
+      "Uninitialized");
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + size <= file_size_,
+      InvalidArgument,
+      "File %s: offset %zu + size %zu > file_size_ %zu",
+      file_name_,
+      offset,
+      size,
+      file_size_);
+#if defined(POSIX_FADV_WILLNEED)
+  // Starts asynchronous readahead of the range into the page cache.
+  int err = ::posix_fadvise(
+      fd_,
+      static_cast<off_t>(offset),
+      static_cast<off_t>(size),
+      POSIX_FADV_WILLNEED);
+  if (err != 0) {
+    // posix_fadvise() returns the error instead of setting errno.
+    ET_LOG(
+        Info,
+        "File %s: posix_fadvise(WILLNEED) failed: %s (%d)",
+        file_name_,
+        strerror(err),
+        err);
+    return Error::NotSupported;
+  }
+  return Error::Ok;
+#else
+  return Error::NotSupported;
+#endif
 }
 
 Result<size_t> MmapDataLoader::size() const {
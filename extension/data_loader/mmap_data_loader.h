@@ -41,6 +41,42 @@ class MmapDataLoader : public DataLoader {
     UseMlockIgnoreErrors,
   };
 
+  /**
+   * How the loaded pages will be accessed, passed to `madvise()` so that the
+   * kernel can tune its readahead.
+   */
+  enum class AccessPattern {
+    /// Don't call `madvise()`; use the kernel's default readahead.
+    Normal,
+    /// `MADV_SEQUENTIAL`: pages are read in order, e.g. while a delegate
+    /// copies its blob. Read ahead aggressively and drop pages soon after.
+    Sequential,
+    /// `MADV_RANDOM`: pages are read in no particular order, e.g. embedding
+    /// tables. Don't read ahead.
+    Random,
+  };
+
+  /**
+   * Hints for how to map loaded pages, in addition to MlockConfig. A
+   * value-initialized `MapConfig()` maps pages the same way as when no config
+   * is given. Hints that the host does not support are logged and ignored.
+   */
+  struct MapConfig {
+    /// Fault in all pages when mapping them with `MAP_POPULATE`, rather than
+    /// on first access.
+    bool populate;
+    /// Place each mapping so that it can be backed by transparent huge pages,
+    /// and ask for them with `MADV_HUGEPAGE`. Reduces TLB misses when large
+    /// weights are accessed randomly. The kernel only uses huge pages for file
+    /// mappings on file systems that support them.
+    bool huge_pages;
+    AccessPattern access_pattern;
+    /// When a loaded buffer is freed, ask the kernel to reclaim its pages
+    /// from the page cache before unmapping them, e.g. after a delegate has
+    /// copied its blob. Pages that are mapped elsewhere are kept.
+    bool release_on_free;
+  };
+
   /**
    * Creates a new MmapDataLoader that wraps the named file. Fails if
    * the file can't be opened for reading or if its size can't be found.
@@ -50,10 +86,12 @@ class MmapDataLoader : public DataLoader {
    *     overhead of opening it again for every Load() call.
    * @param[in] mlock_config How and whether to lock loaded pages with
    *     `mlock()`.
+   * @param[in] map_config Hints for how to map loaded pages.
    */
   static Result<MmapDataLoader> from(
       const char* file_name,
-      MlockConfig mlock_config = MlockConfig::UseMlock);
+      MlockConfig mlock_config = MlockConfig::UseMlock,
+      MapConfig map_config = MapConfig());
 
   /// DEPRECATED: Use the lowercase `from()` instead.
   __ET_DEPRECATED static Result<MmapDataLoader> From(
@@ -76,12 +114,14 @@ class MmapDataLoader : public DataLoader {
         file_size_(rhs.file_size_),
         page_size_(rhs.page_size_),
         fd_(rhs.fd_),
-        mlock_config_(rhs.mlock_config_) {
+        mlock_config_(rhs.mlock_config_),
+        map_config_(rhs.map_config_) {
     rhs.file_name_ = nullptr;
     rhs.file_size_ = 0;
     rhs.page_size_ = 0;
     rhs.fd_ = -1;
     rhs.mlock_config_ = MlockConfig::NoMlock;
+    rhs.map_config_ = MapConfig();
   }
 
   ~MmapDataLoader() override;
@@ -89,6 +129,18 @@ class MmapDataLoader : public DataLoader {
   __ET_NODISCARD Result<FreeableBuffer> Load(size_t offset, size_t size)
       override;
 
+  /**
+   * Asks the OS to start reading the range into its page cache with
+   * `posix_fadvise(POSIX_FADV_WILLNEED)`, so that the pages of a later Load()
+   * of it are already resident when touched.
+   */
+  __ET_NODISCARD Error Prefetch(size_t offset, size_t size) override;
+
+  /// Loaded buffers are `mmap()`ed pages of the file.
+  bool loads_mapped_data() const override {
+    return true;
+  }
+
   __ET_NODISCARD Result<size_t> size() const override;
 
  private:
@@ -97,12 +149,14 @@ class MmapDataLoader : public DataLoader {
       size_t file_size,
       const char* file_name,
       size_t page_size,
-      MlockConfig mlock_config)
+      MlockConfig mlock_config,
+      MapConfig map_config)
       : file_name_(file_name),
         file_size_(file_size),
         page_size_(page_size),
         fd_(fd),
-        mlock_config_(mlock_config) {}
+        mlock_config_(mlock_config),
+        map_config_(map_config) {}
 
   // Not safely copyable.
   MmapDataLoader(const MmapDataLoader&) = delete;
@@ -114,6 +168,7 @@ class MmapDataLoader : public DataLoader {
   size_t page_size_;
   int fd_; // Owned by the instance.
   MlockConfig mlock_config_;
+  MapConfig map_config_;
 };
 
 } // namespace util
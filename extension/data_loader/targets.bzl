@@ -67,3 +67,17 @@ def define_common_targets():
             "//executorch/runtime/core:core",
         ],
     )
+
+    runtime.cxx_library(
+        name = "io_uring_data_loader",
+        srcs = ["io_uring_data_loader.cpp"],
+        exported_headers = ["io_uring_data_loader.h"],
+        visibility = [
+            "//executorch/test/...",
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
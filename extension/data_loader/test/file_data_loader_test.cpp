@@ -9,6 +9,8 @@
 #include <executorch/extension/data_loader/file_data_loader.h>
 
 #include <cstring>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -131,6 +133,47 @@ TEST_P(FileDataLoaderTest, OutOfBoundsLoadFails) {
   }
 }
 
+TEST_P(FileDataLoaderTest, ConcurrentLoadsSucceed) {
+  // Write data whose bytes depend on their offset, so that a load from the
+  // wrong place is detectable.
+  std::vector<uint8_t> data(64 * 1024);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + i / 256);
+  }
+  TempFile tf(data.data(), data.size());
+
+  Result<FileDataLoader> fdl =
+      FileDataLoader::from(tf.path().c_str(), alignment());
+  ASSERT_EQ(fdl.error(), Error::Ok);
+
+  // Each thread repeatedly loads its own segments from the shared loader. With
+  // a shared file offset, the reads of different threads would interleave.
+  constexpr size_t kNumThreads = 8;
+  constexpr size_t kNumLoads = 512;
+  constexpr size_t kSegmentSize = 100;
+  std::vector<std::thread> threads;
+  std::vector<size_t> failures(kNumThreads, 0);
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < kNumLoads; ++i) {
+        const size_t offset =
+            ((t * kNumLoads + i) * 4099) % (data.size() - kSegmentSize);
+        Result<FreeableBuffer> fb = fdl->Load(offset, kSegmentSize);
+        if (!fb.ok() || fb->size() != kSegmentSize ||
+            std::memcmp(fb->data(), data.data() + offset, kSegmentSize) != 0) {
+          failures[t]++;
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    EXPECT_EQ(failures[t], 0) << "thread " << t;
+  }
+}
+
 TEST_P(FileDataLoaderTest, FromMissingFileFails) {
   // Wrapping a file that doesn't exist should fail.
   Result<FileDataLoader> fdl = FileDataLoader::from(
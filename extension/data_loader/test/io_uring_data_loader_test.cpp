@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/io_uring_data_loader.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/testing_util/temp_file.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/test/utils/alignment.h>
+
+using namespace ::testing;
+using torch::executor::Error;
+using torch::executor::FreeableBuffer;
+using torch::executor::Result;
+using torch::executor::testing::TempFile;
+using torch::executor::util::IoUringDataLoader;
+
+namespace {
+
+/// Returns data whose bytes depend on their offset, so that a load from the
+/// wrong place is detectable.
+std::vector<uint8_t> make_data(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + i / 256);
+  }
+  return data;
+}
+
+/// Collects the results of LoadAsync() calls.
+class Collector {
+ public:
+  static void OnLoad(void* context, Result<FreeableBuffer> result) {
+    auto* self = static_cast<Collector*>(context);
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    if (result.ok()) {
+      self->loaded_.emplace_back(std::vector<uint8_t>(
+          static_cast<const uint8_t*>(result->data()),
+          static_cast<const uint8_t*>(result->data()) + result->size()));
+    } else {
+      self->errors_++;
+    }
+    self->done_.notify_all();
+  }
+
+  /// Waits for `n` callbacks, and returns the data they loaded.
+  std::vector<std::vector<uint8_t>> Wait(size_t n) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return loaded_.size() + errors_ >= n; });
+    return loaded_;
+  }
+
+  size_t errors() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return errors_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable done_;
+  std::vector<std::vector<uint8_t>> loaded_;
+  size_t errors_ = 0;
+};
+
+} // namespace
+
+class IoUringDataLoaderTest
+    : public ::testing::TestWithParam<std::tuple<size_t, bool>> {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+
+  // The alignment in bytes that tests should use.
+  size_t alignment() const {
+    return std::get<0>(GetParam());
+  }
+
+  // Whether tests should read with O_DIRECT.
+  bool direct_io() const {
+    return std::get<1>(GetParam());
+  }
+
+  // Creates a loader for the file, or skips the test if the kernel doesn't
+  // support io_uring.
+  Result<IoUringDataLoader> MakeLoader(const TempFile& tf) {
+    Result<IoUringDataLoader> loader = IoUringDataLoader::from(
+        tf.path().c_str(), alignment(), direct_io(), /*queue_depth=*/8);
+    if (loader.error() == Error::NotSupported) {
+      io_uring_missing_ = true;
+    }
+    return loader;
+  }
+
+  bool io_uring_missing_ = false;
+};
+
+TEST_P(IoUringDataLoaderTest, InBoundsLoadsSucceed) {
+  std::vector<uint8_t> data = make_data(10000);
+  TempFile tf(data.data(), data.size());
+
+  Result<IoUringDataLoader> loader = MakeLoader(tf);
+  if (io_uring_missing_) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  // size() should succeed and reflect the total size.
+  Result<size_t> size = loader->size();
+  ASSERT_EQ(size.error(), Error::Ok);
+  EXPECT_EQ(*size, data.size());
+
+  // Loads at offsets and sizes that are not block aligned still return the
+  // requested bytes at the requested alignment.
+  const std::vector<std::pair<size_t, size_t>> ranges = {
+      {0, 8}, {1, 100}, {4095, 2}, {4096, 4096}, {5000, 5000}, {0, 10000}};
+  for (const auto& range : ranges) {
+    Result<FreeableBuffer> fb = loader->Load(range.first, range.second);
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_ALIGNED(fb->data(), alignment());
+    ASSERT_EQ(fb->size(), range.second);
+    EXPECT_EQ(
+        0, std::memcmp(fb->data(), data.data() + range.first, fb->size()))
+        << "offset " << range.first << " size " << range.second;
+
+    // Freeing should release the buffer and clear out the segment.
+    fb->Free();
+    EXPECT_EQ(fb->size(), 0);
+    EXPECT_EQ(fb->data(), nullptr);
+  }
+
+  // Loading zero-sized data succeeds, even at the end of the data.
+  {
+    Result<FreeableBuffer> fb = loader->Load(/*offset=*/data.size(), 0);
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(fb->size(), 0);
+  }
+}
+
+TEST_P(IoUringDataLoaderTest, LargeLoadSucceeds) {
+  // Larger than a single read, and more reads than the queue depth.
+  std::vector<uint8_t> data = make_data(10 * 1024 * 1024 + 123);
+  TempFile tf(data.data(), data.size());
+
+  Result<IoUringDataLoader> loader = MakeLoader(tf);
+  if (io_uring_missing_) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  Result<FreeableBuffer> fb = loader->Load(/*offset=*/7, data.size() - 7);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_ALIGNED(fb->data(), alignment());
+  ASSERT_EQ(fb->size(), data.size() - 7);
+  EXPECT_EQ(0, std::memcmp(fb->data(), data.data() + 7, fb->size()));
+}
+
+TEST_P(IoUringDataLoaderTest, LoadAsyncCallsCallbacks) {
+  std::vector<uint8_t> data = make_data(64 * 1024);
+  TempFile tf(data.data(), data.size());
+
+  Result<IoUringDataLoader> loader = MakeLoader(tf);
+  if (io_uring_missing_) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  // Queue more loads than the queue depth without waiting for any of them.
+  constexpr size_t kNumLoads = 32;
+  constexpr size_t kSegmentSize = 1000;
+  Collector collector;
+  for (size_t i = 0; i < kNumLoads; ++i) {
+    ASSERT_EQ(
+        loader->LoadAsync(
+            i * kSegmentSize, kSegmentSize, Collector::OnLoad, &collector),
+        Error::Ok);
+  }
+
+  // Every load completes exactly once. They may complete in any order, so
+  // match them up by their first byte.
+  std::vector<std::vector<uint8_t>> loaded = collector.Wait(kNumLoads);
+  EXPECT_EQ(collector.errors(), 0);
+  ASSERT_EQ(loaded.size(), kNumLoads);
+  std::vector<bool> seen(kNumLoads, false);
+  for (const std::vector<uint8_t>& buffer : loaded) {
+    ASSERT_EQ(buffer.size(), kSegmentSize);
+    for (size_t i = 0; i < kNumLoads; ++i) {
+      if (std::memcmp(
+              buffer.data(), data.data() + i * kSegmentSize, kSegmentSize) ==
+          0) {
+        EXPECT_FALSE(seen[i]) << "load " << i;
+        seen[i] = true;
+        break;
+      }
+    }
+  }
+  for (size_t i = 0; i < kNumLoads; ++i) {
+    EXPECT_TRUE(seen[i]) << "load " << i;
+  }
+}
+
+TEST_P(IoUringDataLoaderTest, DestructorWaitsForLoads) {
+  std::vector<uint8_t> data = make_data(4 * 1024 * 1024);
+  TempFile tf(data.data(), data.size());
+
+  Collector collector;
+  {
+    Result<IoUringDataLoader> loader = MakeLoader(tf);
+    if (io_uring_missing_) {
+      GTEST_SKIP() << "io_uring is not available";
+    }
+    ASSERT_EQ(loader.error(), Error::Ok);
+    ASSERT_EQ(
+        loader->LoadAsync(0, data.size(), Collector::OnLoad, &collector),
+        Error::Ok);
+  }
+
+  // The callback has already run.
+  std::vector<std::vector<uint8_t>> loaded = collector.Wait(1);
+  ASSERT_EQ(loaded.size(), 1);
+  EXPECT_EQ(loaded[0], data);
+}
+
+TEST_P(IoUringDataLoaderTest, OutOfBoundsLoadFails) {
+  // Create a temp file; contents don't matter.
+  uint8_t data[256] = {};
+  TempFile tf(data, sizeof(data));
+
+  Result<IoUringDataLoader> loader = MakeLoader(tf);
+  if (io_uring_missing_) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  // Loading beyond the end of the data should fail.
+  {
+    Result<FreeableBuffer> fb =
+        loader->Load(/*offset=*/0, /*size=*/sizeof(data) + 1);
+    EXPECT_NE(fb.error(), Error::Ok);
+  }
+
+  // Loading zero bytes still fails if it's past the end of the data.
+  {
+    Result<FreeableBuffer> fb =
+        loader->Load(/*offset=*/sizeof(data) + 1, /*size=*/0);
+    EXPECT_NE(fb.error(), Error::Ok);
+  }
+
+  // LoadAsync() reports the error without calling the callback.
+  Collector collector;
+  EXPECT_EQ(
+      loader->LoadAsync(0, sizeof(data) + 1, Collector::OnLoad, &collector),
+      Error::InvalidArgument);
+}
+
+TEST_P(IoUringDataLoaderTest, ConcurrentLoadsSucceed) {
+  std::vector<uint8_t> data = make_data(64 * 1024);
+  TempFile tf(data.data(), data.size());
+
+  Result<IoUringDataLoader> loader = MakeLoader(tf);
+  if (io_uring_missing_) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  // Each thread repeatedly loads its own segments from the shared loader.
+  constexpr size_t kNumThreads = 8;
+  constexpr size_t kNumLoads = 256;
+  constexpr size_t kSegmentSize = 100;
+  std::vector<std::thread> threads;
+  std::vector<size_t> failures(kNumThreads, 0);
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = 0; i < kNumLoads; ++i) {
+        const size_t offset =
+            ((t * kNumLoads + i) * 4099) % (data.size() - kSegmentSize);
+        Result<FreeableBuffer> fb = loader->Load(offset, kSegmentSize);
+        if (!fb.ok() || fb->size() != kSegmentSize ||
+            std::memcmp(fb->data(), data.data() + offset, kSegmentSize) != 0) {
+          failures[t]++;
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    EXPECT_EQ(failures[t], 0) << "thread " << t;
+  }
+}
+
+TEST_P(IoUringDataLoaderTest, FromMissingFileFails) {
+  // Wrapping a file that doesn't exist should fail.
+  Result<IoUringDataLoader> loader = IoUringDataLoader::from(
+      "/tmp/FILE_DOES_NOT_EXIST_EXECUTORCH_IO_URING_LOADER_TEST",
+      alignment(),
+      direct_io());
+  EXPECT_NE(loader.error(), Error::Ok);
+}
+
+TEST_P(IoUringDataLoaderTest, BadArgumentsFail) {
+  // Create a temp file; contents don't matter.
+  uint8_t data[256] = {};
+  TempFile tf(data, sizeof(data));
+
+  // Bad alignments fail.
+  const std::vector<size_t> bad_alignments = {0, 3, 5, 17};
+  for (size_t bad_alignment : bad_alignments) {
+    Result<IoUringDataLoader> loader =
+        IoUringDataLoader::from(tf.path().c_str(), bad_alignment, direct_io());
+    ASSERT_EQ(loader.error(), Error::InvalidArgument);
+  }
+
+  // So does an empty queue.
+  Result<IoUringDataLoader> loader = IoUringDataLoader::from(
+      tf.path().c_str(), alignment(), direct_io(), /*queue_depth=*/0);
+  ASSERT_EQ(loader.error(), Error::InvalidArgument);
+}
+
+// Tests that the move ctor works.
+TEST_P(IoUringDataLoaderTest, MoveCtor) {
+  // Create a loader.
+  std::string contents = "FILE_CONTENTS";
+  TempFile tf(contents);
+  Result<IoUringDataLoader> loader = MakeLoader(tf);
+  if (io_uring_missing_) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  ASSERT_EQ(loader.error(), Error::Ok);
+  EXPECT_EQ(loader->size().get(), contents.size());
+
+  // Move it into another instance.
+  IoUringDataLoader loader2(std::move(*loader));
+
+  // Old loader should now be invalid.
+  EXPECT_EQ(loader->Load(0, 0).error(), Error::InvalidState);
+  EXPECT_EQ(loader->size().error(), Error::InvalidState);
+
+  // New loader should point to the file.
+  EXPECT_EQ(loader2.size().get(), contents.size());
+  Result<FreeableBuffer> fb = loader2.Load(/*offset=*/0, contents.size());
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_ALIGNED(fb->data(), alignment());
+  ASSERT_EQ(fb->size(), contents.size());
+  EXPECT_EQ(0, std::memcmp(fb->data(), contents.data(), fb->size()));
+}
+
+// Run all IoUringDataLoaderTests with several alignments, with and without
+// O_DIRECT.
+INSTANTIATE_TEST_SUITE_P(
+    VariedSegments,
+    IoUringDataLoaderTest,
+    testing::Combine(
+        testing::Values(
+            1,
+            4,
+            alignof(std::max_align_t),
+            2 * alignof(std::max_align_t),
+            128,
+            8192),
+        testing::Bool()));
@@ -40,13 +40,16 @@ class MmapDataLoaderTest : public ::testing::Test {
   }
 
   // Declared as a method so it can see `page_size_`.
-  void test_in_bounds_loads_succeed(MmapDataLoader::MlockConfig mlock_config);
+  void test_in_bounds_loads_succeed(
+      MmapDataLoader::MlockConfig mlock_config,
+      MmapDataLoader::MapConfig map_config = MmapDataLoader::MapConfig());
 
   size_t page_size_;
 };
 
 void MmapDataLoaderTest::test_in_bounds_loads_succeed(
-    MmapDataLoader::MlockConfig mlock_config) {
+    MmapDataLoader::MlockConfig mlock_config,
+    MmapDataLoader::MapConfig map_config) {
   // Create a file containing multiple pages' worth of data, where each
   // 4-byte word has a different value.
   const size_t contents_size = 8 * page_size_;
@@ -58,7 +61,7 @@ void MmapDataLoaderTest::test_in_bounds_loads_succeed(
 
   // Wrap it in a loader.
   Result<MmapDataLoader> mdl =
-      MmapDataLoader::from(tf.path().c_str(), mlock_config);
+      MmapDataLoader::from(tf.path().c_str(), mlock_config, map_config);
   ASSERT_EQ(mdl.error(), Error::Ok);
 
   // size() should succeed and reflect the total size.
@@ -174,6 +177,62 @@ TEST_F(MmapDataLoaderTest, InBoundsLoadsSucceedUseMlockIgnoreErrors) {
       MmapDataLoader::MlockConfig::UseMlockIgnoreErrors);
 }
 
+TEST_F(MmapDataLoaderTest, InBoundsLoadsSucceedWithMapHints) {
+  // The hints don't change what is loaded, so exercise each of them to make
+  // sure the code still behaves correctly.
+  MmapDataLoader::MapConfig populate = MmapDataLoader::MapConfig();
+  populate.populate = true;
+  test_in_bounds_loads_succeed(MmapDataLoader::MlockConfig::NoMlock, populate);
+
+  MmapDataLoader::MapConfig sequential = MmapDataLoader::MapConfig();
+  sequential.access_pattern = MmapDataLoader::AccessPattern::Sequential;
+  test_in_bounds_loads_succeed(
+      MmapDataLoader::MlockConfig::NoMlock, sequential);
+
+  MmapDataLoader::MapConfig random = MmapDataLoader::MapConfig();
+  random.access_pattern = MmapDataLoader::AccessPattern::Random;
+  test_in_bounds_loads_succeed(MmapDataLoader::MlockConfig::NoMlock, random);
+
+  MmapDataLoader::MapConfig release = MmapDataLoader::MapConfig();
+  release.release_on_free = true;
+  test_in_bounds_loads_succeed(
+      MmapDataLoader::MlockConfig::UseMlockIgnoreErrors, release);
+
+  MmapDataLoader::MapConfig huge_pages = MmapDataLoader::MapConfig();
+  huge_pages.huge_pages = true;
+  test_in_bounds_loads_succeed(
+      MmapDataLoader::MlockConfig::UseMlockIgnoreErrors, huge_pages);
+}
+
+TEST_F(MmapDataLoaderTest, HugePageMappingsAreCongruentToOffsets) {
+  const size_t contents_size = 8 * page_size_;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  for (size_t i = 0; i < contents_size; ++i) {
+    contents[i] = static_cast<uint8_t>(i * 7 + i / 256);
+  }
+  TempFile tf(contents.get(), contents_size);
+
+  MmapDataLoader::MapConfig map_config = MmapDataLoader::MapConfig();
+  map_config.huge_pages = true;
+  Result<MmapDataLoader> mdl = MmapDataLoader::from(
+      tf.path().c_str(), MmapDataLoader::MlockConfig::NoMlock, map_config);
+  ASSERT_EQ(mdl.error(), Error::Ok);
+
+  // Huge pages can only back a mapping whose address matches its file offset
+  // modulo the huge page size.
+  constexpr uintptr_t kHugePageSize = 2 * 1024 * 1024;
+  for (size_t offset = 0; offset < contents_size; offset += page_size_) {
+    const size_t size = contents_size - offset;
+    Result<FreeableBuffer> fb = mdl->Load(offset, size);
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(
+        reinterpret_cast<uintptr_t>(fb->data()) % kHugePageSize,
+        offset % kHugePageSize);
+    ASSERT_EQ(fb->size(), size);
+    EXPECT_EQ(0, std::memcmp(fb->data(), &contents[offset], fb->size()));
+  }
+}
+
 TEST_F(MmapDataLoaderTest, FinalPageOfUnevenFileSucceeds) {
   // Create a file whose length is not an even multiple of a page.
   // Each 4-byte word in the file has a different value.
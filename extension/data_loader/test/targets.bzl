@@ -48,3 +48,14 @@ def define_common_targets():
             "//executorch/extension/data_loader:mmap_data_loader",
         ],
     )
+
+    runtime.cxx_test(
+        name = "io_uring_data_loader_test",
+        srcs = [
+            "io_uring_data_loader_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/testing_util:temp_file",
+            "//executorch/extension/data_loader:io_uring_data_loader",
+        ],
+    )
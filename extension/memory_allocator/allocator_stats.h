@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * Usage counters reported by the allocators in this directory that can free
+ * individual allocations.
+ */
+struct AllocatorStats {
+  /// Successful allocate() calls.
+  size_t num_allocations;
+  /// allocate() calls that returned nullptr.
+  size_t num_failed_allocations;
+  /// free() calls with a non-null pointer.
+  size_t num_frees;
+  /// Allocations that reused memory returned by an earlier free(), rather
+  /// than taking more of the backing memory.
+  size_t num_reuses;
+  /// Bytes requested by allocations that have not been freed.
+  size_t bytes_in_use;
+  /// The largest value that `bytes_in_use` has reached.
+  size_t peak_bytes_in_use;
+  /// Bytes taken from the backing memory, including per-allocation overhead
+  /// and memory that is currently free.
+  size_t bytes_reserved;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
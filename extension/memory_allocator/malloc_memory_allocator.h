@@ -10,6 +10,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <vector>
 
 #include <executorch/runtime/core/memory_allocator.h>
@@ -62,19 +63,27 @@ class MallocMemoryAllocator : public MemoryAllocator {
       size += alignment;
     }
     mem_ptrs_.emplace_back(std::malloc(size));
+    used_size_ += size;
     return alignPointer(mem_ptrs_.back(), alignment);
   }
 
+  // Returns the number of bytes malloc()ed since the last reset().
+  size_t used_size() const override {
+    return used_size_;
+  }
+
   // Free up each hosted memory pointer. The memory was created via malloc.
   void reset() override {
     for (auto mem_ptr : mem_ptrs_) {
-      free(mem_ptr);
+      std::free(mem_ptr);
     }
     mem_ptrs_.clear();
+    used_size_ = 0;
   }
 
  private:
   std::vector<void*> mem_ptrs_;
+  size_t used_size_ = 0;
 };
 } // namespace util
 } // namespace executor
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/numa_memory_allocator.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <executorch/runtime/platform/log.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace util {
+
+namespace {
+
+#if defined(__linux__)
+
+// From <linux/mempolicy.h>, which libnuma would otherwise provide.
+constexpr int kMpolBind = 2;
+// The most nodes that binding supports.
+constexpr size_t kMaxNodes = 1024;
+
+/**
+ * Parses a sysfs CPU or node list such as "0-3,8,10-11". Returns an empty
+ * list if the file can't be read.
+ */
+std::vector<uint32_t> read_sysfs_list(const std::string& path) {
+  std::vector<uint32_t> ids;
+  FILE* file = fopen(path.c_str(), "r");
+  if (file == nullptr) {
+    return ids;
+  }
+  char buf[4096];
+  const bool ok = fgets(buf, sizeof(buf), file) != nullptr;
+  fclose(file);
+  if (!ok) {
+    return ids;
+  }
+  const char* p = buf;
+  while (*p >= '0' && *p <= '9') {
+    char* end;
+    const unsigned long first = strtoul(p, &end, 10);
+    unsigned long last = first;
+    p = end;
+    if (*p == '-') {
+      last = strtoul(p + 1, &end, 10);
+      p = end;
+    }
+    for (unsigned long id = first; id <= last; ++id) {
+      ids.push_back(static_cast<uint32_t>(id));
+    }
+    if (*p == ',') {
+      ++p;
+    }
+  }
+  return ids;
+}
+
+#endif // __linux__
+
+size_t page_size() {
+#if defined(__linux__)
+  static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+#else
+  return 4096;
+#endif
+}
+
+} // namespace
+
+size_t numa_node_count() {
+#if defined(__linux__)
+  const std::vector<uint32_t> nodes =
+      read_sysfs_list("/sys/devices/system/node/online");
+  return nodes.empty() ? 0 : nodes.back() + 1;
+#else
+  return 0;
+#endif
+}
+
+std::vector<uint32_t> numa_node_cpus(size_t node) {
+#if defined(__linux__)
+  return read_sysfs_list(
+      "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+#else
+  (void)node;
+  return {};
+#endif
+}
+
+bool bind_current_thread_to_numa_node(size_t node) {
+#if defined(__linux__)
+  const std::vector<uint32_t> cpus = numa_node_cpus(node);
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (uint32_t cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)node;
+  return false;
+#endif
+}
+
+NumaMemoryAllocator::NumaMemoryAllocator(size_t node, size_t chunk_size)
+    : MemoryAllocator(0, nullptr), node_(node), chunk_size_(chunk_size) {}
+
+NumaMemoryAllocator::~NumaMemoryAllocator() {
+  reset();
+}
+
+bool NumaMemoryAllocator::add_chunk(size_t size) {
+  const size_t page = page_size();
+  size = std::max(size, chunk_size_);
+  size = (size + page - 1) / page * page;
+#if defined(__linux__)
+  void* data = mmap(
+      nullptr,
+      size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (data == MAP_FAILED) {
+    ET_LOG(Error, "Failed to map %zu bytes", size);
+    return false;
+  }
+  // Binding before the pages are first touched makes them fault in on the
+  // node. Failures, e.g. from a seccomp filter, leave the memory usable.
+  unsigned long mask[kMaxNodes / (8 * sizeof(unsigned long))] = {};
+  bool bound = node_ < kMaxNodes;
+  if (bound) {
+    mask[node_ / (8 * sizeof(unsigned long))] |= 1UL
+        << (node_ % (8 * sizeof(unsigned long)));
+    // The kernel ignores the last bit of maxnode.
+    bound = syscall(
+                SYS_mbind,
+                data,
+                size,
+                kMpolBind,
+                mask,
+                static_cast<unsigned long>(kMaxNodes + 1),
+                0) == 0;
+  }
+  if (!bound && bound_) {
+    ET_LOG(Info, "Can't bind memory to NUMA node %zu", node_);
+  }
+  bound_ = bound_ && bound;
+#else
+  void* data = std::malloc(size);
+  if (data == nullptr) {
+    return false;
+  }
+  bound_ = false;
+#endif
+  chunks_.push_back({data, size});
+  cur_ = static_cast<uint8_t*>(data);
+  end_ = cur_ + size;
+  return true;
+}
+
+void* NumaMemoryAllocator::allocate(size_t size, size_t alignment) {
+  EXECUTORCH_TRACK_ALLOCATION(prof_id(), size);
+  if (!isPowerOf2(alignment)) {
+    ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+    return nullptr;
+  }
+  uint8_t* start = cur_ == nullptr ? nullptr : alignPointer(cur_, alignment);
+  if (start == nullptr || start + size > end_) {
+    // Chunks start on a page, which is aligned enough for any alignment up
+    // to the page size.
+    if (!add_chunk(size + (alignment > page_size() ? alignment : 0))) {
+      return nullptr;
+    }
+    start = alignPointer(cur_, alignment);
+  }
+  cur_ = start + size;
+  used_size_ += size;
+  return start;
+}
+
+void NumaMemoryAllocator::reset() {
+  for (const Chunk& chunk : chunks_) {
+#if defined(__linux__)
+    munmap(chunk.data, chunk.size);
+#else
+    std::free(chunk.data);
+#endif
+  }
+  chunks_.clear();
+  cur_ = nullptr;
+  end_ = nullptr;
+  used_size_ = 0;
+  bound_ = true;
+}
+
+} // namespace util
+} // namespace executor
+} // namespace torch
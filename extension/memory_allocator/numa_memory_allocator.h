@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * Returns the number of NUMA nodes of the system, or 0 if it has no NUMA
+ * topology to speak of, e.g. because it is not Linux.
+ */
+size_t numa_node_count();
+
+/**
+ * Returns the CPUs of NUMA node `node`, as the ids that sched_setaffinity()
+ * and the threadpool's pinning expect, or an empty list if there is no such
+ * node.
+ */
+std::vector<uint32_t> numa_node_cpus(size_t node);
+
+/**
+ * Pins the calling thread to the CPUs of NUMA node `node`. Returns false if
+ * the node has no CPUs or pinning is not supported.
+ */
+bool bind_current_thread_to_numa_node(size_t node);
+
+/**
+ * A MemoryAllocator whose memory is bound to one NUMA node, so that a Method
+ * that runs on that node's CPUs never reaches across sockets for its memory.
+ * Use one per Method instance for both the method allocator and the
+ * memory-planned buffers, and run the instance on the same node:
+ *
+ * @code
+ *   NumaMemoryAllocator allocator(node);
+ *   bind_current_thread_to_numa_node(node);
+ *   // Workers of the XNNPACK pool named "numa<node>" run on the node, too.
+ *   std::vector<uint32_t> cpus = numa_node_cpus(node);
+ *   set_named_threadpool_cpus(name, cpus.data(), cpus.size());
+ *   for (size_t id = 0; id < method_meta.num_memory_planned_buffers(); ++id) {
+ *     size_t size = method_meta.memory_planned_buffer_size(id).get();
+ *     planned_spans.push_back({(uint8_t*)allocator.allocate(size), size});
+ *   }
+ * @endcode
+ *
+ * Memory is mapped from the OS in chunks of at least `chunk_size` bytes and
+ * bound to the node before it is first touched. Allocations are handed out
+ * from the chunks in order, and reset() returns the chunks to the OS. Where
+ * binding is not supported, e.g. outside of Linux, the chunks are plain
+ * malloc() memory and bound() returns false.
+ *
+ * Not thread-safe.
+ */
+class NumaMemoryAllocator : public MemoryAllocator {
+ public:
+  /// The default number of bytes that the allocator maps at once.
+  static constexpr size_t kDefaultChunkSize = 2 * 1024 * 1024;
+
+  /**
+   * @param[in] node The NUMA node to bind the memory to.
+   * @param[in] chunk_size The number of bytes to map from the OS at once.
+   */
+  explicit NumaMemoryAllocator(
+      size_t node,
+      size_t chunk_size = kDefaultChunkSize);
+
+  ~NumaMemoryAllocator() override;
+
+  NumaMemoryAllocator(const NumaMemoryAllocator&) = delete;
+  NumaMemoryAllocator& operator=(const NumaMemoryAllocator&) = delete;
+
+  /**
+   * Allocates `size` bytes on the allocator's node.
+   *
+   * @returns Aligned pointer to the allocated memory on success.
+   * @retval nullptr The OS is out of memory, or `alignment` was not a power
+   *     of 2.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override;
+
+  /// Returns the bytes handed out since the last reset().
+  size_t used_size() const override {
+    return used_size_;
+  }
+
+  /// Releases every allocation and returns the memory to the OS.
+  void reset() override;
+
+  /// Returns the node that the memory is bound to.
+  size_t node() const {
+    return node_;
+  }
+
+  /// Returns true if all memory mapped so far is bound to the node.
+  bool bound() const {
+    return bound_;
+  }
+
+ private:
+  struct Chunk {
+    void* data;
+    size_t size;
+  };
+
+  /// Maps a chunk of at least `size` bytes and binds it to the node.
+  bool add_chunk(size_t size);
+
+  const size_t node_;
+  const size_t chunk_size_;
+  std::vector<Chunk> chunks_;
+  uint8_t* cur_ = nullptr;
+  uint8_t* end_ = nullptr;
+  size_t used_size_ = 0;
+  bool bound_ = true;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/pool_memory_allocator.h>
+
+#include <cstring>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * Sits immediately before each pointer that allocate() returns, so that
+ * free() can find the block that holds it.
+ */
+struct PoolMemoryAllocator::BlockHeader {
+  /// The size that was passed to allocate().
+  size_t size;
+  /// Index into free_lists_ of the block's size.
+  uint32_t size_class;
+  /// Distance from the start of the block to the returned pointer.
+  uint32_t offset;
+};
+
+PoolMemoryAllocator::PoolMemoryAllocator(uint32_t size, uint8_t* base_address)
+    : MemoryAllocator(size, base_address) {
+  std::memset(free_lists_, 0, sizeof(free_lists_));
+  std::memset(&stats_, 0, sizeof(stats_));
+}
+
+void* PoolMemoryAllocator::allocate(size_t size, size_t alignment) {
+  if (!isPowerOf2(alignment)) {
+    ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+    stats_.num_failed_allocations++;
+    return nullptr;
+  }
+  if (alignment < alignof(BlockHeader)) {
+    alignment = alignof(BlockHeader);
+  }
+
+  // Blocks start on kMinBlockSize boundaries, so placing the header and
+  // aligning the pointer after it never needs more than this.
+  const size_t needed = size + sizeof(BlockHeader) +
+      (alignment > kMinBlockSize ? alignment : kMinBlockSize);
+  uint32_t size_class = 0;
+  while (size_class < kNumSizeClasses &&
+         (kMinBlockSize << size_class) < needed) {
+    size_class++;
+  }
+  if (size_class == kNumSizeClasses || needed < size) {
+    ET_LOG(Error, "Allocation of %zu bytes is too large for the pool", size);
+    stats_.num_failed_allocations++;
+    return nullptr;
+  }
+  const size_t block_size = kMinBlockSize << size_class;
+
+  uint8_t* block = static_cast<uint8_t*>(free_lists_[size_class]);
+  if (block != nullptr) {
+    // Pop a block that an earlier free() returned.
+    void* next = nullptr;
+    std::memcpy(&next, block, sizeof(next));
+    free_lists_[size_class] = next;
+    stats_.num_reuses++;
+  } else {
+    block = static_cast<uint8_t*>(
+        MemoryAllocator::allocate(block_size, kMinBlockSize));
+    if (block == nullptr) {
+      stats_.num_failed_allocations++;
+      return nullptr;
+    }
+    stats_.bytes_reserved += block_size;
+  }
+
+  uint8_t* ptr = alignPointer(block + sizeof(BlockHeader), alignment);
+  BlockHeader* header = reinterpret_cast<BlockHeader*>(ptr) - 1;
+  header->size = size;
+  header->size_class = size_class;
+  header->offset = static_cast<uint32_t>(ptr - block);
+
+  stats_.num_allocations++;
+  stats_.bytes_in_use += size;
+  if (stats_.bytes_in_use > stats_.peak_bytes_in_use) {
+    stats_.peak_bytes_in_use = stats_.bytes_in_use;
+  }
+  return ptr;
+}
+
+void PoolMemoryAllocator::free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  const BlockHeader* header = static_cast<const BlockHeader*>(ptr) - 1;
+  uint8_t* block = static_cast<uint8_t*>(ptr) - header->offset;
+  const uint32_t size_class = header->size_class;
+  stats_.num_frees++;
+  stats_.bytes_in_use -= header->size;
+
+  // Push the block; this overwrites the header if the block is small.
+  std::memcpy(block, &free_lists_[size_class], sizeof(void*));
+  free_lists_[size_class] = block;
+}
+
+void PoolMemoryAllocator::reset() {
+  MemoryAllocator::reset();
+  std::memset(free_lists_, 0, sizeof(free_lists_));
+  stats_.bytes_in_use = 0;
+  stats_.bytes_reserved = 0;
+}
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/extension/memory_allocator/allocator_stats.h>
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * A MemoryAllocator that carves power-of-two sized blocks out of a fixed
+ * buffer and keeps a free list per block size, so that free()d memory is
+ * reused by later allocations of a similar size instead of taking more of the
+ * buffer.
+ *
+ * Each allocation is rounded up to the next power of two (at least
+ * kMinBlockSize bytes) after adding a small header, so it wastes up to about
+ * half of its block. Blocks are never split or merged: a freed block is only
+ * reused for allocations that round up to the same size. reset() returns all
+ * blocks to the buffer at once.
+ *
+ * Useful as a temp allocator for kernels and delegates that free temporary
+ * buffers before allocating more within the same call.
+ *
+ * Not thread-safe.
+ */
+class PoolMemoryAllocator : public MemoryAllocator {
+ public:
+  /// The size of the smallest block, which is also the alignment of all
+  /// blocks.
+  static constexpr size_t kMinBlockSize = 16;
+
+  /**
+   * Constructs a pool that allocates from the `size` bytes at
+   * `base_address`, which it does not take ownership of.
+   */
+  PoolMemoryAllocator(uint32_t size, uint8_t* base_address);
+
+  /**
+   * Allocates `size` bytes, reusing a free block of the right size if there
+   * is one.
+   *
+   * @returns Aligned pointer to the allocated memory on success.
+   * @retval nullptr Not enough memory, or `alignment` was not a power of 2.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override;
+
+  /**
+   * Returns the block holding `ptr` to its free list. `ptr` must have been
+   * returned by allocate() on this allocator since the last reset(), and not
+   * already freed. Does nothing if `ptr` is nullptr.
+   */
+  void free(void* ptr) override;
+
+  /**
+   * Releases all allocations at once and empties the free lists. The counters
+   * in stats() are kept, except for the number of bytes in use and reserved.
+   */
+  void reset() override;
+
+  /// Returns usage counters since construction.
+  const AllocatorStats& stats() const {
+    return stats_;
+  }
+
+ private:
+  struct BlockHeader;
+
+  /// Number of block sizes: kMinBlockSize << 0 through kMinBlockSize << 27,
+  /// which covers any buffer that a uint32_t size can describe.
+  static constexpr size_t kNumSizeClasses = 28;
+
+  /// Heads of the per-size free lists. Each free block stores the pointer to
+  /// the next one in its first bytes.
+  void* free_lists_[kNumSizeClasses];
+
+  AllocatorStats stats_;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
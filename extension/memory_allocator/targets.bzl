@@ -20,3 +20,59 @@ def define_common_targets():
             "@EXECUTORCH_CLIENTS",
         ],
     )
+
+    runtime.cxx_library(
+        name = "pool_memory_allocator",
+        srcs = [
+            "pool_memory_allocator.cpp",
+        ],
+        exported_headers = [
+            "allocator_stats.h",
+            "pool_memory_allocator.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:memory_allocator",
+        ],
+        visibility = [
+            "//executorch/extension/memory_allocator/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "thread_local_arena_allocator",
+        srcs = [
+            "thread_local_arena_allocator.cpp",
+        ],
+        exported_headers = [
+            "allocator_stats.h",
+            "thread_local_arena_allocator.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:memory_allocator",
+        ],
+        visibility = [
+            "//executorch/extension/memory_allocator/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "numa_memory_allocator",
+        srcs = [
+            "numa_memory_allocator.cpp",
+        ],
+        exported_headers = [
+            "numa_memory_allocator.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:memory_allocator",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        visibility = [
+            "//executorch/extension/memory_allocator/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/numa_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using torch::executor::util::numa_node_count;
+using torch::executor::util::numa_node_cpus;
+using torch::executor::util::NumaMemoryAllocator;
+
+class NumaMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+TEST_F(NumaMemoryAllocatorTest, AllocationsAreDistinctAndAligned) {
+  // Binding may be refused in sandboxes, but the memory must work anyway.
+  NumaMemoryAllocator allocator(/*node=*/0, /*chunk_size=*/256);
+  EXPECT_EQ(allocator.node(), 0);
+
+  size_t used = 0;
+  for (size_t alignment : {1, 2, 4, 8, 16, 32, 64, 128, 256, 8192}) {
+    void* a = allocator.allocate(100, alignment);
+    void* b = allocator.allocate(100, alignment);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_TRUE(is_aligned(a, alignment));
+    EXPECT_TRUE(is_aligned(b, alignment));
+    std::memset(a, 0xaa, 100);
+    std::memset(b, 0xbb, 100);
+    EXPECT_EQ(static_cast<uint8_t*>(a)[99], 0xaa);
+    EXPECT_EQ(static_cast<uint8_t*>(b)[0], 0xbb);
+    used += 200;
+  }
+  EXPECT_EQ(allocator.used_size(), used);
+
+  // Larger than a chunk.
+  void* big = allocator.allocate(1 << 20);
+  ASSERT_NE(big, nullptr);
+  std::memset(big, 0xcc, 1 << 20);
+
+  allocator.reset();
+  EXPECT_EQ(allocator.used_size(), 0);
+  EXPECT_NE(allocator.allocate(100), nullptr);
+}
+
+TEST_F(NumaMemoryAllocatorTest, RejectsBadAlignment) {
+  NumaMemoryAllocator allocator(/*node=*/0);
+  EXPECT_EQ(allocator.allocate(100, 3), nullptr);
+  EXPECT_EQ(allocator.used_size(), 0);
+}
+
+TEST_F(NumaMemoryAllocatorTest, NodesHaveCpus) {
+  const size_t nodes = numa_node_count();
+  // Nodes can be offline, but a NUMA system has CPUs on at least one.
+  size_t cpus = 0;
+  for (size_t node = 0; node < nodes; ++node) {
+    cpus += numa_node_cpus(node).size();
+  }
+  EXPECT_EQ(cpus > 0, nodes > 0);
+  EXPECT_TRUE(numa_node_cpus(1 << 20).empty());
+}
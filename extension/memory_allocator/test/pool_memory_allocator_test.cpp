@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/pool_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using torch::executor::util::AllocatorStats;
+using torch::executor::util::PoolMemoryAllocator;
+
+class PoolMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+
+  alignas(64) uint8_t buffer_[4096];
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+TEST_F(PoolMemoryAllocatorTest, AllocationsAreDistinctAndAligned) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  for (size_t alignment : {1, 2, 4, 8, 16, 32, 64, 128}) {
+    void* a = allocator.allocate(10, alignment);
+    void* b = allocator.allocate(10, alignment);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(is_aligned(a, alignment));
+    EXPECT_TRUE(is_aligned(b, alignment));
+    // Writing every byte should not disturb the other allocation.
+    std::memset(a, 0xaa, 10);
+    std::memset(b, 0xbb, 10);
+    EXPECT_EQ(static_cast<uint8_t*>(a)[9], 0xaa);
+    EXPECT_EQ(static_cast<uint8_t*>(b)[0], 0xbb);
+  }
+}
+
+TEST_F(PoolMemoryAllocatorTest, FreedBlocksAreReused) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  void* a = allocator.allocate(100);
+  ASSERT_NE(a, nullptr);
+  const size_t reserved = allocator.stats().bytes_reserved;
+
+  // Freeing and allocating the same size repeatedly reuses the block instead
+  // of taking more of the buffer.
+  for (int i = 0; i < 100; ++i) {
+    allocator.free(a);
+    a = allocator.allocate(100);
+    ASSERT_NE(a, nullptr);
+  }
+  EXPECT_EQ(allocator.stats().bytes_reserved, reserved);
+  EXPECT_EQ(allocator.stats().num_reuses, 100);
+
+  // A similar size that rounds up to the same block also reuses it.
+  allocator.free(a);
+  void* b = allocator.allocate(110);
+  EXPECT_EQ(b, a);
+}
+
+TEST_F(PoolMemoryAllocatorTest, DifferentSizesUseDifferentBlocks) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  void* small = allocator.allocate(16);
+  ASSERT_NE(small, nullptr);
+  allocator.free(small);
+
+  // Too large for the freed block.
+  void* large = allocator.allocate(1000);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(allocator.stats().num_reuses, 0);
+}
+
+TEST_F(PoolMemoryAllocatorTest, FailsWhenBufferIsExhausted) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  // Larger than the whole buffer.
+  EXPECT_EQ(allocator.allocate(sizeof(buffer_)), nullptr);
+  EXPECT_EQ(allocator.stats().num_failed_allocations, 1);
+
+  // Fill the buffer with blocks, then free one so that the next allocation
+  // can succeed.
+  void* last = nullptr;
+  while (void* p = allocator.allocate(200)) {
+    last = p;
+  }
+  ASSERT_NE(last, nullptr);
+  EXPECT_EQ(allocator.stats().bytes_reserved, sizeof(buffer_));
+  allocator.free(last);
+  EXPECT_NE(allocator.allocate(200), nullptr);
+}
+
+TEST_F(PoolMemoryAllocatorTest, NonPowerOf2AlignmentFails) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+  EXPECT_EQ(allocator.allocate(8, 3), nullptr);
+  EXPECT_EQ(allocator.stats().num_failed_allocations, 1);
+}
+
+TEST_F(PoolMemoryAllocatorTest, StatsTrackUsage) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  void* a = allocator.allocate(100);
+  void* b = allocator.allocate(50);
+  allocator.free(a);
+  allocator.free(nullptr);
+  void* c = allocator.allocate(10);
+  ASSERT_NE(b, nullptr);
+  ASSERT_NE(c, nullptr);
+
+  AllocatorStats stats = allocator.stats();
+  EXPECT_EQ(stats.num_allocations, 3);
+  EXPECT_EQ(stats.num_frees, 1);
+  EXPECT_EQ(stats.bytes_in_use, 60);
+  EXPECT_EQ(stats.peak_bytes_in_use, 150);
+  EXPECT_GT(stats.bytes_reserved, 160);
+
+  // reset() releases everything but keeps the peak.
+  allocator.reset();
+  stats = allocator.stats();
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.bytes_reserved, 0);
+  EXPECT_EQ(stats.peak_bytes_in_use, 150);
+}
+
+TEST_F(PoolMemoryAllocatorTest, ResetEmptiesFreeLists) {
+  PoolMemoryAllocator allocator(sizeof(buffer_), buffer_);
+
+  void* a = allocator.allocate(100);
+  void* b = allocator.allocate(100);
+  allocator.free(b);
+  allocator.reset();
+
+  // After reset, allocation starts from the beginning of the buffer again,
+  // rather than handing out the block freed before the reset.
+  EXPECT_EQ(allocator.allocate(100), a);
+  EXPECT_EQ(allocator.stats().num_reuses, 0);
+}
@@ -15,3 +15,33 @@ def define_common_targets():
             "//executorch/extension/memory_allocator:malloc_memory_allocator",
         ],
     )
+
+    runtime.cxx_test(
+        name = "pool_memory_allocator_test",
+        srcs = [
+            "pool_memory_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:pool_memory_allocator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "thread_local_arena_allocator_test",
+        srcs = [
+            "thread_local_arena_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:thread_local_arena_allocator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "numa_memory_allocator_test",
+        srcs = [
+            "numa_memory_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:numa_memory_allocator",
+        ],
+    )
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/thread_local_arena_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using torch::executor::util::AllocatorStats;
+using torch::executor::util::ThreadLocalArenaAllocator;
+
+class ThreadLocalArenaAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+};
+
+bool is_aligned(const void* ptr, size_t alignment) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+  return addr % alignment == 0;
+}
+
+TEST_F(ThreadLocalArenaAllocatorTest, AllocationsAreDistinctAndAligned) {
+  ThreadLocalArenaAllocator allocator(/*chunk_size=*/256);
+
+  for (size_t alignment : {1, 2, 4, 8, 16, 32, 64, 128, 256}) {
+    void* a = allocator.allocate(100, alignment);
+    void* b = allocator.allocate(100, alignment);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_TRUE(is_aligned(a, alignment));
+    EXPECT_TRUE(is_aligned(b, alignment));
+    std::memset(a, 0xaa, 100);
+    std::memset(b, 0xbb, 100);
+    EXPECT_EQ(static_cast<uint8_t*>(a)[99], 0xaa);
+    EXPECT_EQ(static_cast<uint8_t*>(b)[0], 0xbb);
+  }
+}
+
+TEST_F(ThreadLocalArenaAllocatorTest, FreeingTheLatestAllocationsReusesThem) {
+  ThreadLocalArenaAllocator allocator;
+
+  void* a = allocator.allocate(100);
+  void* b = allocator.allocate(100);
+  void* c = allocator.allocate(100);
+  ASSERT_NE(c, nullptr);
+
+  // Freeing out of order reclaims nothing until everything after it is also
+  // free.
+  allocator.free(b);
+  void* d = allocator.allocate(100);
+  EXPECT_NE(d, b);
+  allocator.free(d);
+  allocator.free(c);
+
+  // Now b, c, and d are all free, so the next allocation takes b's place.
+  EXPECT_EQ(allocator.allocate(100), b);
+  EXPECT_GE(allocator.stats().num_reuses, 1);
+
+  (void)a;
+}
+
+TEST_F(ThreadLocalArenaAllocatorTest, RepeatedTempAllocationsDoNotGrow) {
+  ThreadLocalArenaAllocator allocator(/*chunk_size=*/1024);
+
+  for (int i = 0; i < 100; ++i) {
+    void* a = allocator.allocate(300);
+    void* b = allocator.allocate(300);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    allocator.free(b);
+    allocator.free(a);
+  }
+  EXPECT_EQ(allocator.stats().bytes_reserved, 1024);
+}
+
+TEST_F(ThreadLocalArenaAllocatorTest, LargeAllocationsGetTheirOwnChunk) {
+  ThreadLocalArenaAllocator allocator(/*chunk_size=*/64);
+
+  void* p = allocator.allocate(10000);
+  ASSERT_NE(p, nullptr);
+  std::memset(p, 0, 10000);
+  EXPECT_GE(allocator.stats().bytes_reserved, 10000);
+}
+
+TEST_F(ThreadLocalArenaAllocatorTest, ResetKeepsChunks) {
+  ThreadLocalArenaAllocator allocator(/*chunk_size=*/1024);
+
+  void* first = allocator.allocate(100);
+  allocator.allocate(2000);
+  const size_t reserved = allocator.stats().bytes_reserved;
+
+  allocator.reset();
+  EXPECT_EQ(allocator.stats().bytes_in_use, 0);
+
+  // The same sequence fits in the chunks from before.
+  EXPECT_EQ(allocator.allocate(100), first);
+  EXPECT_NE(allocator.allocate(2000), nullptr);
+  EXPECT_EQ(allocator.stats().bytes_reserved, reserved);
+}
+
+TEST_F(ThreadLocalArenaAllocatorTest, NonPowerOf2AlignmentFails) {
+  ThreadLocalArenaAllocator allocator;
+  EXPECT_EQ(allocator.allocate(8, 3), nullptr);
+  EXPECT_EQ(allocator.stats().num_failed_allocations, 1);
+}
+
+TEST_F(ThreadLocalArenaAllocatorTest, ThreadsUseSeparateArenas) {
+  ThreadLocalArenaAllocator allocator(/*chunk_size=*/4096);
+  constexpr int kNumThreads = 4;
+  constexpr int kNumIterations = 1000;
+
+  std::vector<std::thread> threads;
+  // Not vector<bool>, whose elements share bytes across threads.
+  std::vector<int> ok(kNumThreads, 0);
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&allocator, &ok, t]() {
+      bool good = true;
+      for (int i = 0; i < kNumIterations; ++i) {
+        auto* a = static_cast<uint8_t*>(allocator.allocate(64));
+        auto* b = static_cast<uint8_t*>(allocator.allocate(64));
+        if (a == nullptr || b == nullptr) {
+          good = false;
+          break;
+        }
+        std::memset(a, t, 64);
+        std::memset(b, t + 100, 64);
+        good = good && a[63] == t && b[0] == t + 100;
+        allocator.free(b);
+        allocator.free(a);
+      }
+      ok[t] = good;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kNumThreads; ++t) {
+    EXPECT_TRUE(ok[t]) << "thread " << t;
+  }
+
+  AllocatorStats stats = allocator.stats();
+  EXPECT_EQ(stats.num_allocations, 2 * kNumThreads * kNumIterations);
+  EXPECT_EQ(stats.num_frees, 2 * kNumThreads * kNumIterations);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  // Each thread only ever needed its first chunk.
+  EXPECT_EQ(stats.bytes_reserved, kNumThreads * 4096);
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/thread_local_arena_allocator.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+namespace {
+
+std::atomic<uint64_t> next_allocator_id{1};
+
+/// The arena that the calling thread last used, and the allocator it belongs
+/// to. Saves a lock on every call when a thread uses a single allocator.
+struct ArenaCache {
+  uint64_t allocator_id;
+  void* arena;
+};
+thread_local ArenaCache arena_cache = {0, nullptr};
+
+} // namespace
+
+struct ThreadLocalArenaAllocator::Arena {
+  struct Chunk {
+    uint8_t* data;
+    size_t size;
+  };
+
+  /// Sits immediately before each pointer that allocate() returns.
+  struct Header {
+    /// The allocation made before this one, or nullptr.
+    Header* prev;
+    /// The arena's position before this allocation, which it returns to once
+    /// this allocation and all later ones have been freed.
+    size_t chunk_index;
+    size_t offset;
+    /// The size that was passed to allocate().
+    size_t size;
+    bool freed;
+  };
+
+  explicit Arena(std::thread::id owner) : thread(owner) {
+    std::memset(&stats, 0, sizeof(stats));
+  }
+
+  ~Arena() {
+    for (const Chunk& chunk : chunks) {
+      std::free(chunk.data);
+    }
+  }
+
+  /// Returns true if the position (chunk_index, offset) is at or before the
+  /// furthest position this arena has reached since the last reset.
+  bool below_high_water(size_t chunk, size_t off) const {
+    return chunk < high_chunk_index ||
+        (chunk == high_chunk_index && off <= high_offset);
+  }
+
+  std::thread::id thread;
+  std::vector<Chunk> chunks;
+  /// The next free byte is at chunks[chunk_index].data + offset.
+  size_t chunk_index = 0;
+  size_t offset = 0;
+  /// The most recent allocation that has not been rolled back.
+  Header* top = nullptr;
+  /// The furthest position reached since the last reset.
+  size_t high_chunk_index = 0;
+  size_t high_offset = 0;
+  AllocatorStats stats;
+};
+
+ThreadLocalArenaAllocator::ThreadLocalArenaAllocator(size_t chunk_size)
+    : MemoryAllocator(0, nullptr),
+      chunk_size_(chunk_size),
+      id_(next_allocator_id.fetch_add(1)) {}
+
+ThreadLocalArenaAllocator::~ThreadLocalArenaAllocator() = default;
+
+ThreadLocalArenaAllocator::Arena*
+ThreadLocalArenaAllocator::arena_for_this_thread() {
+  if (arena_cache.allocator_id == id_) {
+    return static_cast<Arena*>(arena_cache.arena);
+  }
+  const std::thread::id self = std::this_thread::get_id();
+  Arena* arena = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& candidate : arenas_) {
+      if (candidate->thread == self) {
+        arena = candidate.get();
+        break;
+      }
+    }
+    if (arena == nullptr) {
+      arena = new (std::nothrow) Arena(self);
+      if (arena == nullptr) {
+        ET_LOG(Error, "Failed to allocate arena");
+        return nullptr;
+      }
+      arenas_.emplace_back(arena);
+    }
+  }
+  arena_cache = {id_, arena};
+  return arena;
+}
+
+void* ThreadLocalArenaAllocator::allocate(size_t size, size_t alignment) {
+  Arena* arena = arena_for_this_thread();
+  if (arena == nullptr) {
+    return nullptr;
+  }
+  if (!isPowerOf2(alignment)) {
+    ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+    arena->stats.num_failed_allocations++;
+    return nullptr;
+  }
+  if (alignment < alignof(Arena::Header)) {
+    alignment = alignof(Arena::Header);
+  }
+
+  // Find the first chunk, starting at the current position, with room for
+  // the header and the aligned allocation.
+  size_t chunk_index = arena->chunk_index;
+  size_t offset = arena->offset;
+  uint8_t* ptr = nullptr;
+  while (chunk_index < arena->chunks.size()) {
+    const Arena::Chunk& chunk = arena->chunks[chunk_index];
+    if (size < chunk.size) {
+      uint8_t* candidate = alignPointer(
+          chunk.data + offset + sizeof(Arena::Header), alignment);
+      if (candidate <= chunk.data + chunk.size - size) {
+        ptr = candidate;
+        break;
+      }
+    }
+    chunk_index++;
+    offset = 0;
+  }
+  if (ptr == nullptr) {
+    // Grow the arena. malloc() aligns to max_align_t, so the worst-case
+    // padding for larger alignments is bounded by `alignment`.
+    const size_t needed = size + sizeof(Arena::Header) + alignment;
+    const size_t chunk_size = needed > chunk_size_ ? needed : chunk_size_;
+    uint8_t* data = needed > size
+        ? static_cast<uint8_t*>(std::malloc(chunk_size))
+        : nullptr;
+    if (data == nullptr) {
+      ET_LOG(Error, "Failed to grow arena by %zu bytes", chunk_size);
+      arena->stats.num_failed_allocations++;
+      return nullptr;
+    }
+    arena->chunks.push_back({data, chunk_size});
+    arena->stats.bytes_reserved += chunk_size;
+    chunk_index = arena->chunks.size() - 1;
+    ptr = alignPointer(data + sizeof(Arena::Header), alignment);
+  }
+
+  Arena::Header* header = reinterpret_cast<Arena::Header*>(ptr) - 1;
+  header->prev = arena->top;
+  header->chunk_index = arena->chunk_index;
+  header->offset = arena->offset;
+  header->size = size;
+  header->freed = false;
+  arena->top = header;
+  arena->chunk_index = chunk_index;
+  arena->offset = static_cast<size_t>(
+      ptr + size - arena->chunks[chunk_index].data);
+
+  AllocatorStats& stats = arena->stats;
+  if (arena->below_high_water(arena->chunk_index, arena->offset)) {
+    // Only a rollback by free() moves the position backwards.
+    stats.num_reuses++;
+  } else {
+    arena->high_chunk_index = arena->chunk_index;
+    arena->high_offset = arena->offset;
+  }
+  stats.num_allocations++;
+  stats.bytes_in_use += size;
+  if (stats.bytes_in_use > stats.peak_bytes_in_use) {
+    stats.peak_bytes_in_use = stats.bytes_in_use;
+  }
+  return ptr;
+}
+
+void ThreadLocalArenaAllocator::free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Arena* arena = arena_for_this_thread();
+  if (arena == nullptr) {
+    return;
+  }
+  Arena::Header* header = static_cast<Arena::Header*>(ptr) - 1;
+  header->freed = true;
+  arena->stats.num_frees++;
+  arena->stats.bytes_in_use -= header->size;
+
+  // Roll back over every freed allocation at the top of the stack.
+  while (arena->top != nullptr && arena->top->freed) {
+    arena->chunk_index = arena->top->chunk_index;
+    arena->offset = arena->top->offset;
+    arena->top = arena->top->prev;
+  }
+}
+
+void ThreadLocalArenaAllocator::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& arena : arenas_) {
+    arena->chunk_index = 0;
+    arena->offset = 0;
+    arena->top = nullptr;
+    arena->high_chunk_index = 0;
+    arena->high_offset = 0;
+    arena->stats.bytes_in_use = 0;
+  }
+}
+
+AllocatorStats ThreadLocalArenaAllocator::stats() const {
+  AllocatorStats total;
+  std::memset(&total, 0, sizeof(total));
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& arena : arenas_) {
+    const AllocatorStats& stats = arena->stats;
+    total.num_allocations += stats.num_allocations;
+    total.num_failed_allocations += stats.num_failed_allocations;
+    total.num_frees += stats.num_frees;
+    total.num_reuses += stats.num_reuses;
+    total.bytes_in_use += stats.bytes_in_use;
+    total.peak_bytes_in_use += stats.peak_bytes_in_use;
+    total.bytes_reserved += stats.bytes_reserved;
+  }
+  return total;
+}
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <executorch/extension/memory_allocator/allocator_stats.h>
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * A MemoryAllocator that gives each calling thread its own malloc()-backed
+ * arena, so that the worker threads of a kernel or delegate can allocate
+ * temporary memory concurrently without contending on a lock.
+ *
+ * Within a thread, memory is handed out in stack order. free() releases an
+ * allocation; once the most recent allocations of a thread have all been
+ * freed, later allocations on that thread reuse their memory. An allocation
+ * freed out of order is reclaimed when everything allocated after it has
+ * also been freed, or by reset().
+ *
+ * Arenas grow by chunk_size bytes (or more, for larger allocations) when they
+ * run out, and keep their chunks across reset() so that a steady workload
+ * stops calling malloc() after its first run.
+ *
+ * allocate() and free() are thread-safe, but a pointer must be freed on the
+ * thread that allocated it. reset() and stats() must not run concurrently
+ * with allocate() or free() on other threads.
+ */
+class ThreadLocalArenaAllocator : public MemoryAllocator {
+ public:
+  /// The default number of bytes that an arena grows by.
+  static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+  /**
+   * @param[in] chunk_size The number of bytes that an arena grows by when it
+   *     runs out of memory.
+   */
+  explicit ThreadLocalArenaAllocator(size_t chunk_size = kDefaultChunkSize);
+
+  ~ThreadLocalArenaAllocator() override;
+
+  /**
+   * Allocates `size` bytes from the calling thread's arena, creating the
+   * arena on the thread's first call.
+   *
+   * @returns Aligned pointer to the allocated memory on success.
+   * @retval nullptr malloc() failed, or `alignment` was not a power of 2.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override;
+
+  /**
+   * Releases an allocation. Must be called on the thread that allocated
+   * `ptr`, since the last reset(). Does nothing if `ptr` is nullptr.
+   */
+  void free(void* ptr) override;
+
+  /**
+   * Releases every allocation on every thread, keeping the arenas' memory for
+   * reuse.
+   */
+  void reset() override;
+
+  /**
+   * Returns usage counters summed over all threads. `peak_bytes_in_use` is
+   * the sum of each thread's peak, which is an upper bound on the true peak.
+   */
+  AllocatorStats stats() const;
+
+ private:
+  struct Arena;
+
+  // Not copyable or movable: threads cache pointers to the arenas.
+  ThreadLocalArenaAllocator(const ThreadLocalArenaAllocator&) = delete;
+  ThreadLocalArenaAllocator& operator=(const ThreadLocalArenaAllocator&) =
+      delete;
+
+  /// Returns the calling thread's arena, creating it if needed.
+  Arena* arena_for_this_thread();
+
+  const size_t chunk_size_;
+  /// Distinguishes this allocator from earlier ones at the same address in
+  /// the threads' arena caches.
+  const uint64_t id_;
+
+  /// Guards arenas_.
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Arena>> arenas_;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/module.h>
+
+#include <algorithm>
+
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+
+namespace torch {
+namespace executor {
+
+Module::PlannedBuffers::PlannedBuffers(const std::vector<size_t>& sizes) {
+  buffers.reserve(sizes.size());
+  spans.reserve(sizes.size());
+  for (size_t size : sizes) {
+    buffers.emplace_back(new uint8_t[size]);
+    spans.emplace_back(buffers.back().get(), size);
+  }
+  allocator = std::make_unique<HierarchicalAllocator>(
+      Span<Span<uint8_t>>(spans.data(), spans.size()));
+}
+
+bool Module::PlannedBuffers::fits(const std::vector<size_t>& sizes) const {
+  if (sizes.size() > spans.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] > spans[i].size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Module::Module(
+    const std::string& file_path,
+    util::MmapDataLoader::MlockConfig mlock_config,
+    PlannedMemory planned_memory,
+    EventTracer* event_tracer)
+    : file_path_(file_path),
+      mlock_config_(mlock_config),
+      planned_memory_(planned_memory),
+      event_tracer_(event_tracer) {
+  runtime_init();
+}
+
+Module::Module(
+    std::unique_ptr<DataLoader> data_loader,
+    PlannedMemory planned_memory,
+    EventTracer* event_tracer)
+    : mlock_config_(util::MmapDataLoader::MlockConfig::NoMlock),
+      planned_memory_(planned_memory),
+      event_tracer_(event_tracer),
+      data_loader_(std::move(data_loader)) {
+  runtime_init();
+}
+
+Error Module::load(Program::Verification verification) {
+  if (is_loaded()) {
+    return Error::Ok;
+  }
+  if (data_loader_ == nullptr) {
+    Result<util::MmapDataLoader> loader =
+        util::MmapDataLoader::from(file_path_.c_str(), mlock_config_);
+    if (!loader.ok()) {
+      return loader.error();
+    }
+    data_loader_ =
+        std::make_unique<util::MmapDataLoader>(std::move(loader.get()));
+  }
+  Result<Program> program = Program::load(data_loader_.get(), verification);
+  if (!program.ok()) {
+    return program.error();
+  }
+  program_ = std::make_unique<Program>(std::move(program.get()));
+  return Error::Ok;
+}
+
+Result<std::unordered_set<std::string>> Module::method_names() {
+  Error err = load();
+  if (err != Error::Ok) {
+    return err;
+  }
+  std::unordered_set<std::string> names;
+  for (size_t i = 0; i < program_->num_methods(); ++i) {
+    names.emplace(program_->get_method_name(i).get());
+  }
+  return names;
+}
+
+Result<MethodMeta> Module::method_meta(const std::string& method_name) {
+  Error err = load();
+  if (err != Error::Ok) {
+    return err;
+  }
+  return program_->method_meta(method_name.c_str());
+}
+
+Result<std::vector<size_t>> Module::planned_buffer_sizes(
+    const std::string& method_name) {
+  std::vector<size_t> sizes;
+  auto add_sizes = [&sizes](const MethodMeta& meta) -> Error {
+    const size_t n = meta.num_memory_planned_buffers();
+    if (sizes.size() < n) {
+      sizes.resize(n, 0);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      Result<int64_t> size = meta.memory_planned_buffer_size(i);
+      if (!size.ok()) {
+        return size.error();
+      }
+      sizes[i] = std::max(sizes[i], static_cast<size_t>(size.get()));
+    }
+    return Error::Ok;
+  };
+
+  if (planned_memory_ == PlannedMemory::Shared) {
+    // Size the shared buffers for every method, so that loading a larger
+    // method later never needs to move them.
+    for (size_t i = 0; i < program_->num_methods(); ++i) {
+      Result<MethodMeta> meta =
+          program_->method_meta(program_->get_method_name(i).get());
+      if (!meta.ok()) {
+        return meta.error();
+      }
+      Error err = add_sizes(meta.get());
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  } else {
+    Result<MethodMeta> meta = program_->method_meta(method_name.c_str());
+    if (!meta.ok()) {
+      return meta.error();
+    }
+    Error err = add_sizes(meta.get());
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  return sizes;
+}
+
+Error Module::load_method(const std::string& method_name) {
+  if (is_method_loaded(method_name)) {
+    return Error::Ok;
+  }
+  Error err = load();
+  if (err != Error::Ok) {
+    return err;
+  }
+  // Fails early for unknown methods, before allocating anything.
+  Result<std::vector<size_t>> sizes = planned_buffer_sizes(method_name);
+  if (!sizes.ok()) {
+    return sizes.error();
+  }
+
+  auto holder = std::make_unique<MethodHolder>();
+  HierarchicalAllocator* planned_allocator = nullptr;
+  if (planned_memory_ == PlannedMemory::Shared) {
+    if (shared_planned_ == nullptr) {
+      shared_planned_ = std::make_unique<PlannedBuffers>(sizes.get());
+    }
+    planned_allocator = shared_planned_->allocator.get();
+  } else {
+    // Reuse the memory of an unloaded method if it is large enough, and
+    // allocate new memory otherwise.
+    auto reusable = std::find_if(
+        free_planned_buffers_.begin(),
+        free_planned_buffers_.end(),
+        [&sizes](const std::unique_ptr<PlannedBuffers>& buffers) {
+          return buffers->fits(sizes.get());
+        });
+    if (reusable != free_planned_buffers_.end()) {
+      holder->planned_buffers = std::move(*reusable);
+      free_planned_buffers_.erase(reusable);
+    } else {
+      holder->planned_buffers = std::make_unique<PlannedBuffers>(sizes.get());
+    }
+    planned_allocator = holder->planned_buffers->allocator.get();
+  }
+  holder->method_allocator = std::make_unique<util::MallocMemoryAllocator>();
+  holder->temp_allocator = std::make_unique<util::MallocMemoryAllocator>();
+  holder->memory_manager = std::make_unique<MemoryManager>(
+      holder->method_allocator.get(),
+      planned_allocator,
+      holder->temp_allocator.get());
+
+  Result<Method> method = program_->load_method(
+      method_name.c_str(), holder->memory_manager.get(), event_tracer_);
+  if (!method.ok()) {
+    if (holder->planned_buffers != nullptr) {
+      free_planned_buffers_.push_back(std::move(holder->planned_buffers));
+    }
+    return method.error();
+  }
+  holder->method = std::make_unique<Method>(std::move(method.get()));
+  methods_.emplace(method_name, std::move(holder));
+  return Error::Ok;
+}
+
+void Module::unload_method(const std::string& method_name) {
+  auto it = methods_.find(method_name);
+  if (it == methods_.end()) {
+    return;
+  }
+  // Destroy the method before handing its memory to another one.
+  it->second->method.reset();
+  if (it->second->planned_buffers != nullptr) {
+    free_planned_buffers_.push_back(std::move(it->second->planned_buffers));
+  }
+  methods_.erase(it);
+}
+
+Result<Method*> Module::get_method(const std::string& method_name) {
+  Error err = load_method(method_name);
+  if (err != Error::Ok) {
+    return err;
+  }
+  return methods_.at(method_name)->method.get();
+}
+
+Error Module::execute(
+    const std::string& method_name,
+    const std::vector<EValue>& inputs,
+    EValue* outputs,
+    size_t num_outputs) {
+  Result<Method*> method = get_method(method_name);
+  if (!method.ok()) {
+    return method.error();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      num_outputs == method.get()->outputs_size(),
+      InvalidArgument,
+      "Method '%s' has %zu outputs, but %zu were requested",
+      method_name.c_str(),
+      method.get()->outputs_size(),
+      num_outputs);
+  Error err = method.get()->set_inputs(
+      exec_aten::ArrayRef<EValue>(inputs.data(), inputs.size()));
+  if (err != Error::Ok) {
+    return err;
+  }
+  err = method.get()->execute();
+  if (err != Error::Ok) {
+    return err;
+  }
+  return method.get()->get_outputs(outputs, num_outputs);
+}
+
+Result<std::vector<EValue>> Module::execute(
+    const std::string& method_name,
+    const std::vector<EValue>& inputs) {
+  Result<Method*> method = get_method(method_name);
+  if (!method.ok()) {
+    return method.error();
+  }
+  std::vector<EValue> outputs(method.get()->outputs_size());
+  Error err = execute(method_name, inputs, outputs.data(), outputs.size());
+  if (err != Error::Ok) {
+    return err;
+  }
+  return outputs;
+}
+
+Error Module::set_output_data_ptr(
+    const std::string& method_name,
+    void* buffer,
+    size_t size,
+    size_t output_index) {
+  Result<Method*> method = get_method(method_name);
+  if (!method.ok()) {
+    return method.error();
+  }
+  return method.get()->set_output_data_ptr(buffer, size, output_index);
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/evalue.h>
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/core/hierarchical_allocator.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/memory_manager.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/method_meta.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Loads a Program and runs its methods, doing the setup that every runner
+ * otherwise repeats: creating the data loader, loading the program, and
+ * allocating the planned memory and allocators of each method.
+ *
+ * Everything is loaded on first use. The program is loaded by the first call
+ * that needs it, and each method the first time it is executed (or by
+ * load_method()), so methods that are never run cost neither memory nor
+ * initialization.
+ *
+ * The planned memory of a method is kept while the method is loaded, so its
+ * outputs and any state that it keeps in planned memory (e.g. a KV cache)
+ * persist between executions. The memory of an unloaded method is cached and
+ * reused by the next method that fits in it.
+ *
+ * Not thread-safe; a Module runs one method at a time.
+ */
+class Module final {
+ public:
+  /// How the methods of the module get their planned memory.
+  enum class PlannedMemory {
+    /// Each loaded method has its own planned memory.
+    PerMethod,
+    /**
+     * All methods use one set of planned buffers, each as large as the
+     * largest that any method needs. Executing a method clobbers the planned
+     * inputs, outputs and state of the others, so only use this when that is
+     * acceptable, e.g. for programs exported with
+     * ExecutorchBackendConfig.share_memory_planned_buffers.
+     */
+    Shared,
+  };
+
+  /**
+   * Creates a module that loads the program file at `file_path` with an
+   * MmapDataLoader, so that the constant data is paged in from the file
+   * instead of copied to the heap.
+   *
+   * @param[in] file_path The path of the .pte file.
+   * @param[in] mlock_config Whether to lock the mapped pages in memory.
+   * @param[in] planned_memory How the methods get their planned memory.
+   * @param[in] event_tracer The event tracer of the method runs, or nullptr.
+   *     Must outlive the module.
+   */
+  explicit Module(
+      const std::string& file_path,
+      util::MmapDataLoader::MlockConfig mlock_config =
+          util::MmapDataLoader::MlockConfig::UseMlockIgnoreErrors,
+      PlannedMemory planned_memory = PlannedMemory::PerMethod,
+      EventTracer* event_tracer = nullptr);
+
+  /**
+   * Creates a module that loads its program from `data_loader`.
+   *
+   * @param[in] data_loader The loader of the program data.
+   * @param[in] planned_memory How the methods get their planned memory.
+   * @param[in] event_tracer The event tracer of the method runs, or nullptr.
+   *     Must outlive the module.
+   */
+  explicit Module(
+      std::unique_ptr<DataLoader> data_loader,
+      PlannedMemory planned_memory = PlannedMemory::PerMethod,
+      EventTracer* event_tracer = nullptr);
+
+  Module(const Module&) = delete;
+  Module& operator=(const Module&) = delete;
+  Module(Module&&) = default;
+  Module& operator=(Module&&) = default;
+
+  /**
+   * Loads the program if it is not loaded yet. Called by the other methods
+   * as needed, so it is only necessary to call it to load the program
+   * eagerly or with a different verification.
+   *
+   * @param[in] verification The kind of verification to do on the program.
+   *
+   * @returns Error::Ok if the program is loaded.
+   */
+  __ET_NODISCARD Error
+  load(Program::Verification verification = Program::Verification::Minimal);
+
+  /// Returns true if the program is loaded.
+  bool is_loaded() const {
+    return program_ != nullptr;
+  }
+
+  /**
+   * Returns the names of the methods of the program.
+   */
+  Result<std::unordered_set<std::string>> method_names();
+
+  /**
+   * Loads the method named `method_name` if it is not loaded yet, and
+   * allocates its memory.
+   *
+   * @returns Error::Ok if the method is loaded.
+   */
+  __ET_NODISCARD Error load_method(const std::string& method_name);
+
+  /// Returns true if the method named `method_name` is loaded.
+  bool is_method_loaded(const std::string& method_name) const {
+    return methods_.count(method_name) > 0;
+  }
+
+  /**
+   * Unloads the method named `method_name`, keeping its planned memory for
+   * the next method that is loaded. Does nothing if the method is not loaded.
+   */
+  void unload_method(const std::string& method_name);
+
+  /**
+   * Returns the metadata of the method named `method_name`, without loading
+   * the method.
+   */
+  Result<MethodMeta> method_meta(const std::string& method_name);
+
+  /**
+   * Executes the method named `method_name`, loading it first if needed.
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] inputs The inputs of the method. Tensor inputs are copied into
+   *     the planned memory of the method, or used in place if the method does
+   *     not plan them.
+   *
+   * @returns The outputs of the method. Tensor outputs point into the planned
+   *     memory of the method, or into buffers set with set_output_data_ptr(),
+   *     so nothing is allocated for them; they are valid until the next
+   *     execution of the method (or of any method, with
+   *     PlannedMemory::Shared).
+   */
+  Result<std::vector<EValue>> execute(
+      const std::string& method_name,
+      const std::vector<EValue>& inputs);
+
+  /**
+   * Like the other execute(), but writes the outputs to `outputs`, which must
+   * hold exactly as many entries as the method has outputs, so that repeated
+   * executions do not allocate at all.
+   */
+  __ET_NODISCARD Error execute(
+      const std::string& method_name,
+      const std::vector<EValue>& inputs,
+      EValue* outputs,
+      size_t num_outputs);
+
+  /// Executes the "forward" method.
+  Result<std::vector<EValue>> forward(const std::vector<EValue>& inputs) {
+    return execute("forward", inputs);
+  }
+
+  /**
+   * Makes output `output_index` of the method named `method_name` write to
+   * `buffer`, loading the method first if needed. See
+   * Method::set_output_data_ptr(); only valid for outputs that the method
+   * does not plan.
+   */
+  __ET_NODISCARD Error set_output_data_ptr(
+      const std::string& method_name,
+      void* buffer,
+      size_t size,
+      size_t output_index);
+
+  /**
+   * Returns the loaded method named `method_name`, loading it first if
+   * needed, for uses that the module does not cover. The method is owned by
+   * the module and is valid until it is unloaded.
+   */
+  Result<Method*> get_method(const std::string& method_name);
+
+ private:
+  /// A set of planned buffers, and the allocator that hands them out.
+  struct PlannedBuffers {
+    // Left uninitialized; the methods write their planned tensors before
+    // reading them.
+    std::vector<std::unique_ptr<uint8_t[]>> buffers;
+    std::vector<Span<uint8_t>> spans;
+    std::unique_ptr<HierarchicalAllocator> allocator;
+
+    explicit PlannedBuffers(const std::vector<size_t>& sizes);
+
+    /// Returns true if each of `sizes` fits in the matching buffer.
+    bool fits(const std::vector<size_t>& sizes) const;
+  };
+
+  /// A loaded method and the memory that it uses.
+  struct MethodHolder {
+    /// Owned by the holder with PlannedMemory::PerMethod, or shared_planned_
+    /// otherwise.
+    std::unique_ptr<PlannedBuffers> planned_buffers;
+    std::unique_ptr<util::MallocMemoryAllocator> method_allocator;
+    std::unique_ptr<util::MallocMemoryAllocator> temp_allocator;
+    std::unique_ptr<MemoryManager> memory_manager;
+    std::unique_ptr<Method> method;
+  };
+
+  /// Returns the planned buffer sizes that the method named `method_name`
+  /// needs.
+  Result<std::vector<size_t>> planned_buffer_sizes(
+      const std::string& method_name);
+
+  std::string file_path_;
+  util::MmapDataLoader::MlockConfig mlock_config_;
+  PlannedMemory planned_memory_;
+  EventTracer* event_tracer_;
+
+  // Declared in dependency order, so that the methods are destroyed before
+  // the memory and program that they use.
+  std::unique_ptr<DataLoader> data_loader_;
+  std::unique_ptr<Program> program_;
+  /// The buffers that all methods use with PlannedMemory::Shared.
+  std::unique_ptr<PlannedBuffers> shared_planned_;
+  /// The planned buffers of unloaded methods, for reuse.
+  std::vector<std::unique_ptr<PlannedBuffers>> free_planned_buffers_;
+  std::unordered_map<std::string, std::unique_ptr<MethodHolder>> methods_;
+};
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/module.h>
+
+#include <cstdlib>
+#include <memory>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::Error;
+using torch::executor::EValue;
+using torch::executor::Module;
+using torch::executor::Result;
+using torch::executor::testing::TensorFactory;
+using torch::executor::util::FileDataLoader;
+
+class ModuleTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    add_path_ = std::getenv("ET_MODULE_ADD_PATH");
+    multi_entry_path_ = std::getenv("ET_MODULE_MULTI_ENTRY_PATH");
+  }
+
+  const char* add_path_;
+  const char* multi_entry_path_;
+};
+
+TEST_F(ModuleTest, LoadsLazily) {
+  Module module(add_path_);
+  EXPECT_FALSE(module.is_loaded());
+
+  Result<std::unordered_set<std::string>> names = module.method_names();
+  ASSERT_EQ(names.error(), Error::Ok);
+  EXPECT_EQ(names.get(), std::unordered_set<std::string>{"forward"});
+  EXPECT_TRUE(module.is_loaded());
+  EXPECT_FALSE(module.is_method_loaded("forward"));
+
+  // Reading the metadata does not load the method either.
+  ASSERT_EQ(module.method_meta("forward").error(), Error::Ok);
+  EXPECT_FALSE(module.is_method_loaded("forward"));
+}
+
+TEST_F(ModuleTest, ExecuteAdd) {
+  Module module(add_path_);
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({2, 2}, {1, 2, 3, 4});
+  Tensor y = tf.make({2, 2}, {5, 6, 7, 8});
+
+  Result<std::vector<EValue>> outputs =
+      module.forward({EValue(x), EValue(y), EValue(1.0)});
+  ASSERT_EQ(outputs.error(), Error::Ok);
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+  ASSERT_EQ(outputs->size(), 1);
+  EXPECT_TENSOR_EQ(outputs->at(0).toTensor(), tf.make({2, 2}, {6, 8, 10, 12}));
+
+  // The outputs can also go to caller-owned EValues.
+  const std::vector<EValue> inputs = {EValue(y), EValue(y), EValue(1.0)};
+  EValue output;
+  ASSERT_EQ(module.execute("forward", inputs, &output, 1), Error::Ok);
+  EXPECT_TENSOR_EQ(output.toTensor(), tf.make({2, 2}, {10, 12, 14, 16}));
+  EXPECT_EQ(
+      module.execute("forward", inputs, &output, 2), Error::InvalidArgument);
+}
+
+TEST_F(ModuleTest, CustomDataLoader) {
+  Result<FileDataLoader> loader = FileDataLoader::from(add_path_);
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Module module(std::make_unique<FileDataLoader>(std::move(loader.get())));
+
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({2, 2});
+  Result<std::vector<EValue>> outputs =
+      module.forward({EValue(x), EValue(x), EValue(2.0)});
+  ASSERT_EQ(outputs.error(), Error::Ok);
+  EXPECT_TENSOR_EQ(outputs->at(0).toTensor(), tf.full({2, 2}, 3));
+}
+
+TEST_F(ModuleTest, MissingMethodFails) {
+  Module module(add_path_);
+  EXPECT_NE(module.load_method("not_a_method"), Error::Ok);
+  EXPECT_NE(module.execute("not_a_method", {}).error(), Error::Ok);
+}
+
+TEST_F(ModuleTest, MissingFileFails) {
+  Module module("/path/does/not/exist.pte");
+  EXPECT_NE(module.load(), Error::Ok);
+  EXPECT_NE(module.forward({}).error(), Error::Ok);
+}
+
+TEST_F(ModuleTest, UnloadedMethodMemoryIsReused) {
+  Module module(multi_entry_path_);
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({2, 2});
+
+  ASSERT_EQ(module.execute("forward", {EValue(x)}).error(), Error::Ok);
+  module.unload_method("forward");
+  EXPECT_FALSE(module.is_method_loaded("forward"));
+
+  // forward2 runs in the memory of forward if it fits, or in its own.
+  Result<std::vector<EValue>> outputs = module.execute("forward2", {EValue(x)});
+  ASSERT_EQ(outputs.error(), Error::Ok);
+  EXPECT_TENSOR_EQ(outputs->at(0).toTensor(), tf.full({2, 2}, 6));
+}
+
+TEST_F(ModuleTest, LoadedMethodsKeepTheirOutputs) {
+  Module module(multi_entry_path_);
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({2, 2});
+
+  Result<std::vector<EValue>> first = module.execute("forward", {EValue(x)});
+  ASSERT_EQ(first.error(), Error::Ok);
+  Result<std::vector<EValue>> second = module.execute("forward2", {EValue(x)});
+  ASSERT_EQ(second.error(), Error::Ok);
+  EXPECT_TENSOR_EQ(first->at(0).toTensor(), tf.full({2, 2}, 4));
+  EXPECT_TENSOR_EQ(second->at(0).toTensor(), tf.full({2, 2}, 6));
+}
+
+TEST_F(ModuleTest, SharedPlannedMemory) {
+  Module module(
+      multi_entry_path_,
+      torch::executor::util::MmapDataLoader::MlockConfig::NoMlock,
+      Module::PlannedMemory::Shared);
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({2, 2});
+
+  Result<std::vector<EValue>> first = module.execute("forward", {EValue(x)});
+  ASSERT_EQ(first.error(), Error::Ok);
+  EXPECT_TENSOR_EQ(first->at(0).toTensor(), tf.full({2, 2}, 4));
+  Result<std::vector<EValue>> second = module.execute("forward2", {EValue(x)});
+  ASSERT_EQ(second.error(), Error::Ok);
+  EXPECT_TENSOR_EQ(second->at(0).toTensor(), tf.full({2, 2}, 6));
+}
@@ -0,0 +1,31 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets(is_fbcode = False):
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # The tests use these vars to find the program files to load. This uses
+    # an fbcode target path because the authoring/export tools intentionally
+    # don't work in xplat (since they're host-only tools).
+    if not runtime.is_oss and is_fbcode:
+        modules_env = {
+            "ET_MODULE_ADD_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleAdd.pte])",
+            "ET_MODULE_MULTI_ENTRY_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleMultipleEntry.pte])",
+        }
+
+        runtime.cxx_test(
+            name = "module_test",
+            srcs = [
+                "module_test.cpp",
+            ],
+            deps = [
+                "//executorch/extension/module:module",
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/kernels/portable:generated_lib",
+                "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            ],
+            env = modules_env,
+        )
@@ -0,0 +1,27 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_library(
+        name = "thread_parallel",
+        srcs = ["thread_parallel.cpp"],
+        exported_headers = ["thread_parallel.h"],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        exported_deps = [
+            # Also exports ET_USE_THREADPOOL, which switches parallel_for()
+            # in runtime/kernel/thread_parallel_interface.h over to this
+            # library.
+            "//executorch/backends/xnnpack/threadpool:threadpool",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
+#include <executorch/backends/xnnpack/threadpool/threadpool_guard.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace ::testing;
+using torch::executor::parallel_for;
+
+namespace {
+
+class ParallelForTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  // Runs parallel_for() over [begin, end) and records every chunk.
+  std::vector<std::pair<int64_t, int64_t>>
+  run(int64_t begin, int64_t end, int64_t grain_size) {
+    std::vector<std::pair<int64_t, int64_t>> chunks;
+    std::mutex mutex;
+    parallel_for(begin, end, grain_size, [&](int64_t b, int64_t e) {
+      std::lock_guard<std::mutex> lock{mutex};
+      chunks.emplace_back(b, e);
+    });
+    return chunks;
+  }
+};
+
+} // namespace
+
+TEST_F(ParallelForTest, CoversEveryIndexOnce) {
+  constexpr int64_t kBegin = 3;
+  constexpr int64_t kEnd = 1000;
+  for (int64_t grain_size : {1, 7, 64, 997, 5000}) {
+    std::vector<std::atomic<int>> visits(kEnd);
+    parallel_for(kBegin, kEnd, grain_size, [&](int64_t b, int64_t e) {
+      for (int64_t i = b; i < e; ++i) {
+        visits[i]++;
+      }
+    });
+    for (int64_t i = 0; i < kEnd; ++i) {
+      EXPECT_EQ(visits[i], i < kBegin ? 0 : 1)
+          << "index " << i << ", grain size " << grain_size;
+    }
+  }
+}
+
+TEST_F(ParallelForTest, ChunksAreAtLeastTheGrainSize) {
+  const size_t num_threads =
+      torch::executorch::threadpool::get_threadpool()->get_thread_count();
+  auto chunks = run(0, 100, 30);
+  EXPECT_LE(chunks.size(), std::min<size_t>(num_threads, 4));
+  int64_t total = 0;
+  for (const auto& chunk : chunks) {
+    EXPECT_LT(chunk.first, chunk.second);
+    total += chunk.second - chunk.first;
+    if (chunk.second != 100) {
+      EXPECT_GE(chunk.second - chunk.first, 30);
+    }
+  }
+  EXPECT_EQ(total, 100);
+}
+
+TEST_F(ParallelForTest, SmallRangesRunInOneChunk) {
+  auto chunks = run(0, 10, 10);
+  ASSERT_EQ(chunks.size(), 1);
+  EXPECT_EQ(chunks[0].first, 0);
+  EXPECT_EQ(chunks[0].second, 10);
+}
+
+TEST_F(ParallelForTest, EmptyRangeDoesNotCall) {
+  EXPECT_TRUE(run(5, 5, 1).empty());
+  EXPECT_TRUE(run(5, 2, 1).empty());
+}
+
+TEST_F(ParallelForTest, NoThreadPoolGuardRunsInOneChunk) {
+  torch::executorch::threadpool::NoThreadPoolGuard guard;
+  auto chunks = run(0, 1000, 1);
+  ASSERT_EQ(chunks.size(), 1);
+  EXPECT_EQ(chunks[0].first, 0);
+  EXPECT_EQ(chunks[0].second, 1000);
+}
+
+TEST_F(ParallelForTest, NestedCallsRunInline) {
+  std::atomic<int> num_inner_chunks{0};
+  std::atomic<int> num_outer_chunks{0};
+  parallel_for(0, 64, 1, [&](int64_t, int64_t) {
+    num_outer_chunks++;
+    parallel_for(0, 64, 1, [&](int64_t b, int64_t e) {
+      EXPECT_EQ(b, 0);
+      EXPECT_EQ(e, 64);
+      num_inner_chunks++;
+    });
+  });
+  EXPECT_EQ(num_inner_chunks, num_outer_chunks);
+}
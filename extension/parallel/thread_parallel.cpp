@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/parallel/thread_parallel.h>
+
+#include <executorch/backends/xnnpack/threadpool/threadpool.h>
+#include <executorch/backends/xnnpack/threadpool/threadpool_guard.h>
+#include <executorch/runtime/platform/assert.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+namespace {
+
+// Set while this thread runs a chunk, so that a nested parallel_for() runs
+// inline instead of waiting on the pool that is running it.
+thread_local bool in_parallel_region = false;
+
+class ParallelRegionGuard final {
+ public:
+  ParallelRegionGuard() : previous_(in_parallel_region) {
+    in_parallel_region = true;
+  }
+  ~ParallelRegionGuard() {
+    in_parallel_region = previous_;
+  }
+
+ private:
+  const bool previous_;
+};
+
+int64_t divup(int64_t x, int64_t y) {
+  return (x + y - 1) / y;
+}
+
+} // namespace
+
+void parallel_for_threadpool(
+    const int64_t begin,
+    const int64_t end,
+    int64_t grain_size,
+    void (*fn)(void* context, int64_t chunk_begin, int64_t chunk_end),
+    void* context) {
+  const int64_t range = end - begin;
+  if (range <= 0) {
+    return;
+  }
+  grain_size = std::max<int64_t>(grain_size, 1);
+  if (range <= grain_size || in_parallel_region ||
+      torch::executorch::threadpool::NoThreadPoolGuard::is_enabled()) {
+    fn(context, begin, end);
+    return;
+  }
+
+  torch::executorch::threadpool::ThreadPool* const threadpool =
+      torch::executorch::threadpool::get_threadpool();
+  ET_CHECK_MSG(threadpool, "Failed to acquire an instance of ThreadPool!");
+  // Rounds down, so that every chunk but the last has grain_size indices.
+  const int64_t num_tasks =
+      std::min<int64_t>(threadpool->get_thread_count(), range / grain_size);
+  if (num_tasks <= 1) {
+    fn(context, begin, end);
+    return;
+  }
+
+  const int64_t chunk_size = divup(range, num_tasks);
+  threadpool->run(
+      [begin, end, chunk_size, fn, context](size_t task_id) {
+        const int64_t chunk_begin = begin + task_id * chunk_size;
+        const int64_t chunk_end = std::min(end, chunk_begin + chunk_size);
+        if (chunk_begin < chunk_end) {
+          ParallelRegionGuard guard;
+          fn(context, chunk_begin, chunk_end);
+        }
+      },
+      num_tasks);
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
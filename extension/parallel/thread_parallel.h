@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+/**
+ * The threadpool-backed implementation of parallel_for(); see
+ * runtime/kernel/thread_parallel_interface.h. Kernels should call
+ * parallel_for() instead, which falls back to a plain loop when the
+ * threadpool is not linked in.
+ *
+ * Calls `fn(context, chunk_begin, chunk_end)` for each chunk.
+ */
+void parallel_for_threadpool(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    void (*fn)(void* context, int64_t chunk_begin, int64_t chunk_end),
+    void* context);
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
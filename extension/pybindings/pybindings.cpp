@@ -7,8 +7,10 @@
  */
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <unordered_map>
 
@@ -26,6 +28,7 @@
 #include <executorch/runtime/platform/profiler.h>
 #include <executorch/runtime/platform/runtime.h>
 #include <executorch/schema/bundled_program_schema_generated.h>
+#include <executorch/sdk/etdump/etdump_flatcc.h>
 #include <executorch/util/bundled_program_verification.h>
 #include <executorch/util/read_file.h>
 
@@ -64,9 +67,29 @@ using util::MmapDataLoader;
 
 class Module final {
  public:
-  explicit Module(std::unique_ptr<DataLoader> loader)
+  /**
+   * Loads the program from `loader`, and prepares `num_instances` copies of
+   * each of its methods. The instances share the program and its constant
+   * data, but each has its own memory, so up to `num_instances` threads can
+   * run methods of the module at the same time.
+   *
+   * Methods are loaded the first time an instance runs them, so a program
+   * with methods that Python never calls costs neither their memory nor
+   * their initialization.
+   *
+   * With `enable_etdump`, each instance records the events of its methods in
+   * an ETDumpGen, which take_etdump() collects. Only runtimes built with
+   * ET_EVENT_TRACER_ENABLED log any events.
+   */
+  explicit Module(
+      std::unique_ptr<DataLoader> loader,
+      size_t num_instances = 1,
+      bool enable_etdump = false)
       : loader_(std::move(loader)) {
     runtime_init();
+    THROW_IF_ERROR(
+        num_instances == 0 ? Error::InvalidArgument : Error::Ok,
+        "num_instances must be positive");
     Result<Program> program = Program::load(
         loader_.get(), Program::Verification::InternalConsistency);
     THROW_IF_ERROR(
@@ -76,67 +99,45 @@ class Module final {
     program_ = std::make_unique<Program>(std::move(program.get()));
 
     // Figure out the size of each non_const layer we need to support every
-    // method in the program. Map will be easier to use than a list because we
-    // dont know how many non_const arenas there will be
-    std::map<size_t, int64_t> non_const_buffer_sizes;
+    // method in the program. The methods of an instance take turns using the
+    // same arenas, so each one only needs to be as large as the largest
+    // method's layer.
     for (size_t i = 0; i < program_->num_methods(); ++i) {
       auto name = program_->get_method_name(i).get();
       auto method_meta = program_->method_meta(name).get();
       for (size_t j = 0; j < method_meta.num_non_const_buffers(); j++) {
         int64_t buffer_size = method_meta.non_const_buffer_size(j).get();
-        if (non_const_buffer_sizes.find(j) == non_const_buffer_sizes.end()) {
-          non_const_buffer_sizes.insert({j, buffer_size});
-        } else {
-          non_const_buffer_sizes[j] =
-              std::max(non_const_buffer_sizes[j], buffer_size);
+        if (non_const_buffer_sizes_.size() <= j) {
+          non_const_buffer_sizes_.resize(j + 1, 0);
         }
+        non_const_buffer_sizes_[j] =
+            std::max(non_const_buffer_sizes_[j], buffer_size);
       }
     }
 
-    // Allocate the arenas. Using vector because we need to remember the size as
-    // well, so vector is easier then unique_ptr.
-    std::vector<std::vector<uint8_t>> non_const_buffers_;
-    for (std::map<size_t, int64_t>::iterator i = non_const_buffer_sizes.begin();
-         i != non_const_buffer_sizes.end();
-         i++) {
-      non_const_buffers_.push_back(std::vector<uint8_t>(i->second));
-    }
-
-    memory_ = std::make_unique<Memory>(std::move(non_const_buffers_));
-
-    // Load methods
-    for (size_t i = 0; i < program_->num_methods(); ++i) {
-      auto name = program_->get_method_name(i).get();
-      // It's safe to use the same memory manager for all modules because
-      // we can guarantee that only one will be executing at a time.
-      // Everything in this module runs on a single thread.
-      Result<Method> method =
-          program_->load_method(name, memory_->mem_manager());
-      THROW_IF_ERROR(
-          method.error(),
-          "loading method %s failed with error 0x%" PRIx32,
-          name,
-          method.error());
-      methods_.insert(
-          {std::string(name),
-           std::make_unique<Method>(std::move(method.get()))});
+    for (size_t n = 0; n < num_instances; ++n) {
+      auto instance = std::make_unique<Instance>();
+      if (enable_etdump) {
+        instance->etdump = std::make_unique<ETDumpGen>();
+        instance->etdump->set_flush_sink(
+            append_to_string, &instance->etdump_data);
+      }
+      instances_.push_back(std::move(instance));
     }
   }
 
   Module(const Module&) = delete;
   Module& operator=(const Module&) = delete;
-  Module(Module&&) = default;
-  Module& operator=(Module&&) = default;
 
-  /// Executes the specified method on the provided inputs and returns its
-  /// outputs.
-  std::vector<EValue> run_method(
+  /// Executes `method` on the provided inputs and returns its outputs, which
+  /// point into the method's memory.
+  static std::vector<EValue> run_method(
+      Method& method,
       const std::string& method_name,
       const std::vector<EValue>& args) {
-    auto& method = methods_[method_name];
     exec_aten::ArrayRef<EValue> input_evalue_list(args.data(), args.size());
 
-    Error set_inputs_status = method->set_inputs(input_evalue_list);
+    Error set_inputs_status = method.set_inputs(input_evalue_list);
     THROW_IF_ERROR(
         set_inputs_status,
         "method->set_inputs() for method '%s' failed with error 0x%" PRIx32,
@@ -156,16 +157,16 @@ class Module final {
     c10::impl::ExcludeDispatchKeyGuard no_autograd(
         c10::autograd_dispatch_keyset);
 #endif
-    Error execute_status = method->execute();
+    Error execute_status = method.execute();
     THROW_IF_ERROR(
         execute_status,
         "method->execute() failed with error 0x%" PRIx32,
         execute_status);
     // process outputs
-    std::vector<EValue> result(method->outputs_size());
+    std::vector<EValue> result(method.outputs_size());
 
     Error get_outputs_status =
-        method->get_outputs(result.data(), method->outputs_size());
+        method.get_outputs(result.data(), method.outputs_size());
     THROW_IF_ERROR(
         get_outputs_status,
         "method->get_outputs() for method '%s' failed with error 0x%" PRIx32,
@@ -175,12 +176,56 @@ class Module final {
     return result;
   }
 
-  Method& get_method(const std::string& method_name) {
-    if (methods_.count(method_name) == 0) {
-      THROW_IF_ERROR(
-          Error(), "no such method in program: %s", method_name.c_str());
+  /// Returns the number of copies of each method.
+  size_t num_instances() const {
+    return instances_.size();
+  }
+
+  /**
+   * Calls `fn` with the method named `method_name` of an instance that no
+   * other thread is using, waiting for one to become idle if necessary. The
+   * method's outputs are only valid until `fn` returns.
+   */
+  template <typename Fn>
+  void with_method(const std::string& method_name, Fn&& fn) {
+    InstanceGuard guard(*this, acquire_instance());
+    fn(get_method(guard.instance(), method_name));
+  }
+
+  /// Returns whether the module was created with `enable_etdump`.
+  bool etdump_enabled() const {
+    return instances_[0]->etdump != nullptr;
+  }
+
+  /**
+   * Returns the ETDump of every run since the previous call, from every
+   * instance, and starts recording a new one. The result is a stream of
+   * size-prefixed ETDumps, one per instance that ran anything, which
+   * sdk/etdump/serialize.py reads as a single ETDump. Waits for runs in
+   * progress to finish.
+   */
+  std::string take_etdump() {
+    std::string result;
+    for (const auto& instance : instances_) {
+      instance->mutex.lock();
+      InstanceGuard guard(*this, instance.get());
+      instance->etdump->flush();
+      result += instance->etdump_data;
+      instance->etdump_data.clear();
     }
-    return *methods_[method_name].get();
+    return result;
+  }
+
+  /**
+   * Like with_method(), but always uses the first instance, so that a sequence
+   * of calls sees the state that the previous ones left in the method.
+   */
+  template <typename Fn>
+  void with_first_instance_method(const std::string& method_name, Fn&& fn) {
+    Instance* instance = instances_[0].get();
+    instance->mutex.lock();
+    InstanceGuard guard(*this, instance);
+    fn(get_method(guard.instance(), method_name));
   }
 
  private:
@@ -233,25 +278,142 @@ class Module final {
     }
   };
 
-  std::unique_ptr<Memory> memory_;
+  /// One copy of every method that has been used, with the memory it runs
+  /// in.
+  struct Instance {
+    /// Held by the thread that is using this instance.
+    std::mutex mutex;
+    /// Allocated when the instance loads its first method.
+    std::unique_ptr<Memory> memory;
+    std::unordered_map<std::string, std::unique_ptr<Method>> methods;
+    /// Records the events of `methods` if ETDump is enabled, or nullptr.
+    std::unique_ptr<ETDumpGen> etdump;
+    /// The ETDumps that `etdump` flushed since the last take_etdump().
+    std::string etdump_data;
+  };
+
+  /// An ETDumpGen flush sink that appends to the std::string `context`.
+  static void append_to_string(void* context, const void* data, size_t size) {
+    static_cast<std::string*>(context)->append(
+        static_cast<const char*>(data), size);
+  }
+
+  /// Returns the method named `method_name` of `instance`, loading it if this
+  /// is its first use. The calling thread must hold the instance.
+  Method& get_method(Instance& instance, const std::string& method_name) {
+    auto it = instance.methods.find(method_name);
+    if (it != instance.methods.end()) {
+      return *it->second;
+    }
+    THROW_IF_ERROR(
+        program_->method_meta(method_name.c_str()).error(),
+        "no such method in program: %s",
+        method_name.c_str());
+
+    if (!instance.memory) {
+      // Allocate the arenas. Using vector because we need to remember the
+      // size as well, so vector is easier then unique_ptr.
+      std::vector<std::vector<uint8_t>> non_const_buffers;
+      for (int64_t size : non_const_buffer_sizes_) {
+        non_const_buffers.push_back(std::vector<uint8_t>(size));
+      }
+      instance.memory = std::make_unique<Memory>(std::move(non_const_buffers));
+    }
+
+    // It's safe to use the same memory manager for all methods of an instance
+    // because only one thread at a time uses an instance, and runs one of its
+    // methods at a time.
+    Result<Method> method = program_->load_method(
+        method_name.c_str(),
+        instance.memory->mem_manager(),
+        instance.etdump.get());
+    THROW_IF_ERROR(
+        method.error(),
+        "loading method %s failed with error 0x%" PRIx32,
+        method_name.c_str(),
+        method.error());
+    return *instance.methods
+                .emplace(
+                    method_name,
+                    std::make_unique<Method>(std::move(method.get())))
+                .first->second;
+  }
+
+  /// Releases an instance that the calling thread has locked when destroyed.
+  class InstanceGuard {
+   public:
+    InstanceGuard(Module& module, Instance* instance)
+        : module_(module), instance_(instance) {}
+    ~InstanceGuard() {
+      module_.release_instance(instance_);
+    }
+    Instance& instance() {
+      return *instance_;
+    }
+
+   private:
+    Module& module_;
+    Instance* instance_;
+  };
+
+  /// Locks and returns an idle instance, waiting for one if necessary.
+  Instance* acquire_instance() {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    for (;;) {
+      for (const auto& instance : instances_) {
+        if (instance->mutex.try_lock()) {
+          return instance.get();
+        }
+      }
+      instance_released_.wait(lock);
+    }
+  }
+
+  /// Unlocks an instance and wakes a thread waiting for one.
+  void release_instance(Instance* instance) {
+    instance->mutex.unlock();
+    {
+      // A waiting thread holds pool_mutex_ from the time it finds no idle
+      // instance until it waits, so taking it here avoids a lost wakeup.
+      std::lock_guard<std::mutex> lock(pool_mutex_);
+    }
+    instance_released_.notify_one();
+  }
+
   std::unique_ptr<DataLoader> loader_; // program_ points to this.
-  std::unique_ptr<const Program> program_; // methods_ entries points to this.
-  std::unordered_map<std::string, std::unique_ptr<Method>> methods_;
+  std::unique_ptr<const Program> program_; // instances_ entries point to this.
+  std::vector<std::unique_ptr<Instance>> instances_;
+  /// The size of each non_const arena of an instance.
+  std::vector<int64_t> non_const_buffer_sizes_;
+  std::mutex pool_mutex_;
+  std::condition_variable instance_released_;
 };
 
 inline std::unique_ptr<Module> load_from_buffer(
     const void* ptr,
-    size_t ptr_len) {
+    size_t ptr_len,
+    size_t num_instances,
+    bool enable_etdump) {
   EXECUTORCH_SCOPE_PROF("load_from_buffer");
   auto loader = std::make_unique<BufferDataLoader>(ptr, ptr_len);
-  return std::make_unique<Module>(std::move(loader));
+  return std::make_unique<Module>(
+      std::move(loader), num_instances, enable_etdump);
 }
 
-inline std::unique_ptr<Module> load_from_file(const std::string& path) {
+/// Memory-maps the program at `path`, so that only the parts of it that the
+/// loaded methods use are read from disk. With `mlock`, the mapped segments
+/// are also locked into memory as they are loaded.
+inline std::unique_ptr<Module> load_from_file(
+    const std::string& path,
+    size_t num_instances,
+    bool mlock,
+    bool enable_etdump) {
   EXECUTORCH_SCOPE_PROF("load_from_file");
 
   Result<MmapDataLoader> res = MmapDataLoader::from(
-      path.c_str(), MmapDataLoader::MlockConfig::UseMlockIgnoreErrors);
+      path.c_str(),
+      mlock ? MmapDataLoader::MlockConfig::UseMlockIgnoreErrors
+            : MmapDataLoader::MlockConfig::NoMlock);
   THROW_IF_ERROR(
       res.error(),
       "Failed to create MmapDataLoader from file %s, error: 0x:%" PRIx32,
@@ -259,7 +421,8 @@ inline std::unique_ptr<Module> load_from_file(const std::string& path) {
       res.error());
 
   auto loader = std::make_unique<MmapDataLoader>(std::move(res.get()));
-  return std::make_unique<Module>(std::move(loader));
+  return std::make_unique<Module>(
+      std::move(loader), num_instances, enable_etdump);
 }
 
 static constexpr size_t kDEFAULT_BUNDLED_INPUT_POOL_SIZE = 16 * 1024U;
@@ -309,17 +472,39 @@ struct PyBundledModule final {
   MemoryAllocator bundled_input_allocator_;
 };
 
+/**
+ * A loaded program whose methods can be called from Python. Methods run with
+ * the GIL released, so other Python threads can run meanwhile; with more than
+ * one instance, so can other calls into the same module.
+ */
 struct PyModule final {
-  explicit PyModule(const py::bytes& buffer)
+  explicit PyModule(
+      const py::bytes& buffer,
+      size_t num_instances,
+      bool enable_etdump)
       : module_(torch::executor::load_from_buffer(
             buffer.cast<std::string_view>().data(),
-            py::len(buffer))) {}
+            py::len(buffer),
+            num_instances,
+            enable_etdump)) {}
 
   explicit PyModule(const void* ptr, size_t ptr_len)
-      : module_(torch::executor::load_from_buffer(ptr, ptr_len)) {}
-
-  explicit PyModule(const std::string& path)
-      : module_(torch::executor::load_from_file(path)) {}
+      : module_(torch::executor::load_from_buffer(
+            ptr,
+            ptr_len,
+            /*num_instances=*/1,
+            /*enable_etdump=*/false)) {}
+
+  explicit PyModule(
+      const std::string& path,
+      size_t num_instances,
+      bool mlock,
+      bool enable_etdump)
+      : module_(torch::executor::load_from_file(
+            path,
+            num_instances,
+            mlock,
+            enable_etdump)) {}
 
   PyModule(const PyModule&) = delete;
   PyModule& operator=(const PyModule&) = delete;
@@ -327,11 +512,19 @@ struct PyModule final {
   PyModule& operator=(PyModule&&) = default;
 
   // Module is only valid as long as the python buffer is alive.
-  static std::unique_ptr<PyModule> load_from_buffer(const py::bytes& buffer) {
-    return std::make_unique<PyModule>(buffer);
+  static std::unique_ptr<PyModule> load_from_buffer(
+      const py::bytes& buffer,
+      size_t num_instances,
+      bool enable_etdump) {
+    return std::make_unique<PyModule>(buffer, num_instances, enable_etdump);
   }
-  static std::unique_ptr<PyModule> load_from_file(const std::string& path) {
-    return std::make_unique<PyModule>(path);
+  static std::unique_ptr<PyModule> load_from_file(
+      const std::string& path,
+      size_t num_instances,
+      bool mlock,
+      bool enable_etdump) {
+    return std::make_unique<PyModule>(
+        path, num_instances, mlock, enable_etdump);
   }
 
   static std::unique_ptr<PyModule> load_from_bundled_program(
@@ -339,25 +532,28 @@ struct PyModule final {
     return std::make_unique<PyModule>(m.get_program_ptr(), m.get_program_len());
   }
 
+  /**
+   * Runs a method and returns its outputs. By default tensor outputs are
+   * copies. With `clone_outputs` false they alias the module's memory instead,
+   * which saves a copy per output but means they are only valid until the
+   * next call into the module overwrites them. Aliasing outputs keep the
+   * module's memory alive, even if the module itself is no longer referenced.
+   * An output backed by a buffer from set_output_buffer() is returned as the
+   * tensor that was registered.
+   */
   py::list run_method(
       const std::string& method_name,
-      const py::sequence& inputs) {
+      const py::sequence& inputs,
+      bool clone_outputs = true) {
     const auto inputs_size = py::len(inputs);
     std::vector<EValue> cpp_inputs;
     cpp_inputs.reserve(inputs_size);
 
 #ifndef USE_ATEN_LIB // Portable mode
-    // So the ETensors and their metadata stay in scope for Module->run_method.
+    // So the ETensors stay in scope for Module->run_method. Their metadata
+    // lives in input_meta_cache_. We store pointers to these vector elements
+    // so important to reserve so that we don't lose those on a vector resize.
     std::vector<torch::executor::TensorImpl> input_tensors;
-    std::vector<std::vector<torch::executor::Tensor::SizesType>> input_sizes;
-    std::vector<std::vector<torch::executor::Tensor::StridesType>>
-        input_strides;
-    std::vector<std::vector<torch::executor::Tensor::DimOrderType>>
-        input_dim_order;
-    // We store pointers to these vector elements so important to reserve so
-    // that we don't lose those on a vector resize. Don't need to do this for
-    // the others since they are vectors of vectors, and we don't store a
-    // pointer to the root level vector data.
     input_tensors.reserve(inputs_size);
 #endif
 
@@ -369,94 +565,275 @@ struct PyModule final {
         auto at_tensor = python_input.cast<at::Tensor>();
         // alias_etensor_to_attensor will assert on this later, so to better
         // propogate up to python we check early and throw an exception.
-        if (!at_tensor.is_contiguous()) {
-          auto error_msg = "Input " + std::to_string(i) + "for method " +
-              method_name + " is not contiguous.";
+        if (!at_tensor.is_non_overlapping_and_dense()) {
+          auto error_msg = "Input " + std::to_string(i) + " for method " +
+              method_name + " is not dense and non-overlapping.";
           throw std::runtime_error(error_msg);
         }
 
 #ifdef USE_ATEN_LIB
         EValue evalue(at_tensor);
 #else
-        // convert at::Tensor to torch::executor::Tensor
-        auto type = torch::util::torchToExecuTorchScalarType(
-            at_tensor.options().dtype());
-        size_t dim = at_tensor.dim();
-        // cant directly alias at::Tensor sizes and strides due to int64 vs
-        // int32 typing conflict
-        input_sizes.emplace_back(
-            at_tensor.sizes().begin(), at_tensor.sizes().end());
-        input_strides.emplace_back(
-            at_tensor.strides().begin(), at_tensor.strides().end());
-
-        // Only works for MemoryFormat::Contiguous inputs
-        std::vector<torch::executor::Tensor::DimOrderType> dim_order;
-        for (size_t cur_dim = 0; cur_dim < dim; cur_dim++) {
-          dim_order.push_back(cur_dim);
-        }
-        input_dim_order.push_back(std::move(dim_order));
-        input_tensors.emplace_back(
-            type,
-            dim,
-            input_sizes[i].data(),
-            nullptr,
-            input_dim_order[i].data(),
-            input_strides[i].data());
-
+        // convert at::Tensor to torch::executor::Tensor. Strided inputs keep
+        // their strides, and a dim order is derived from them.
+        input_tensors.push_back(
+            torch::util::make_etensor_impl(at_tensor, input_meta_cache_));
         torch::executor::Tensor temp =
-            torch::executor::Tensor(&input_tensors[i]);
-        torch::util::alias_etensor_to_attensor(at_tensor, temp);
+            torch::executor::Tensor(&input_tensors.back());
         EValue evalue(temp);
 #endif
 
         cpp_inputs.push_back(evalue);
-      } else if (py::isinstance<py::none>(python_input)) {
-        cpp_inputs.push_back(EValue());
-      } else if (py::isinstance<py::bool_>(python_input)) {
-        cpp_inputs.push_back(EValue(py::cast<bool>(python_input)));
-      } else if (py::isinstance<py::int_>(python_input)) {
-        cpp_inputs.push_back(EValue(py::cast<int64_t>(python_input)));
       } else {
-        // Unsupported pytype
-        ET_ASSERT_UNREACHABLE_MSG(type_str.c_str());
+        cpp_inputs.push_back(to_scalar_evalue(python_input, type_str));
       }
     }
 
-    auto outputs = module_->run_method(method_name, cpp_inputs);
+    std::vector<EValue> outputs;
+    std::vector<at::Tensor> output_tensors;
+    {
+      // Let other Python threads run while the method executes. Nothing here
+      // may touch Python objects.
+      py::gil_scoped_release no_gil;
+      module_->with_method(method_name, [&](Method& method) {
+        outputs = Module::run_method(method, method_name, cpp_inputs);
+        // Clone tensor outputs while this thread still holds the instance, so
+        // that they neither share a lifetime with the module object nor see
+        // another call overwrite them.
+        output_tensors.resize(outputs.size());
+        for (size_t i = 0; i < outputs.size(); ++i) {
+          if (outputs[i].isTensor()) {
+            output_tensors[i] = clone_outputs
+                ? to_attensor(outputs[i].toTensor()).clone()
+                : alias_output(outputs[i].toTensor());
+          }
+        }
+      });
+    }
 
-    // Retrieve outputs
-    const auto outputs_size = outputs.size();
-    py::list list(outputs_size);
-    for (size_t i = 0; i < outputs_size; ++i) {
-      auto& v = outputs[i];
-      if (Tag::None == v.tag) {
-        list[i] = py::none();
-      } else if (Tag::Int == v.tag) {
-        list[i] = py::cast(v.toInt());
-      } else if (Tag::Double == v.tag) {
-        list[i] = py::cast(v.toDouble());
-      } else if (Tag::Bool == v.tag) {
-        list[i] = py::cast(v.toBool());
-      } else if (Tag::String == v.tag) {
-        list[i] = py::cast(std::string(v.toString().data()));
-      } else if (Tag::Tensor == v.tag) {
+    return to_py_list(method_name, outputs, output_tensors, clone_outputs);
+  }
+
+  py::list forward(const py::sequence& inputs, bool clone_outputs = true) {
+    return run_method("forward", inputs, clone_outputs);
+  }
+
+  /**
+   * Builds the input metadata of a method once, from example inputs, so that
+   * run_batch() can reuse it for every set of inputs instead of converting
+   * each tensor from scratch. Later tensor inputs must have the same dtypes
+   * and shapes as the examples.
+   */
+  void prepare(const std::string& method_name, const py::sequence& inputs) {
+    const size_t inputs_size = py::len(inputs);
+    auto prepared = std::make_shared<PreparedInputs>();
+    prepared->is_tensor.resize(inputs_size, false);
+    prepared->dtypes.resize(inputs_size);
+    prepared->shapes.resize(inputs_size);
+    prepared->strides.resize(inputs_size);
+    prepared->evalues.resize(inputs_size);
+#ifndef USE_ATEN_LIB
+    prepared->tensors.resize(inputs_size);
+#endif
+    for (size_t i = 0; i < inputs_size; ++i) {
+      auto python_input = inputs[i];
+      const std::string& type_str = py::str(python_input.get_type());
+      if (type_str != "<class 'torch.Tensor'>") {
+        continue;
+      }
+      auto at_tensor = python_input.cast<at::Tensor>();
+      if (!at_tensor.is_non_overlapping_and_dense()) {
+        throw std::runtime_error(
+            "Input " + std::to_string(i) + " for method " + method_name +
+            " is not dense and non-overlapping.");
+      }
+      prepared->is_tensor[i] = true;
+      prepared->dtypes[i] = at_tensor.scalar_type();
+      prepared->shapes[i].assign(
+          at_tensor.sizes().begin(), at_tensor.sizes().end());
+      prepared->strides[i].assign(
+          at_tensor.strides().begin(), at_tensor.strides().end());
+#ifndef USE_ATEN_LIB
+      // The same conversion as run_method(), except that the data pointer is
+      // filled in for each set of inputs.
+      prepared->tensors[i] = std::make_unique<torch::executor::TensorImpl>(
+          torch::util::make_etensor_impl(at_tensor, input_meta_cache_));
+      prepared->evalues[i] =
+          EValue(torch::executor::Tensor(prepared->tensors[i].get()));
+#endif
+    }
+    prepared_[method_name] = std::move(prepared);
+  }
+
+  /**
+   * Runs a method once for each set of inputs in `batch` and returns a list
+   * with the outputs of each run. The method must have been prepare()d. The
+   * GIL is released and an instance is held for the whole batch, and tensor
+   * inputs only have their data pointers swapped between runs. Tensor outputs
+   * are always copies, since later runs overwrite the method's memory.
+   */
+  py::list run_batch(
+      const std::string& method_name,
+      const py::sequence& batch) {
+    auto it = prepared_.find(method_name);
+    if (it == prepared_.end()) {
+      throw std::runtime_error(
+          "run_batch() for method " + method_name +
+          " requires a call to prepare() first");
+    }
+    // Holds the metadata alive even if prepare() replaces it meanwhile.
+    std::shared_ptr<PreparedInputs> prepared = it->second;
+    const size_t inputs_size = prepared->evalues.size();
+
+    // Collect every set of inputs while holding the GIL.
+    const size_t batch_size = py::len(batch);
+    std::vector<std::vector<EValue>> batch_inputs(batch_size);
+    std::vector<std::vector<at::Tensor>> batch_tensors(batch_size);
+    for (size_t b = 0; b < batch_size; ++b) {
+      py::sequence inputs = batch[b];
+      if (py::len(inputs) != inputs_size) {
+        throw std::runtime_error(
+            "Inputs " + std::to_string(b) + " for method " + method_name +
+            " do not match the inputs given to prepare()");
+      }
+      batch_inputs[b] = prepared->evalues;
+      batch_tensors[b].resize(inputs_size);
+      for (size_t i = 0; i < inputs_size; ++i) {
+        auto python_input = inputs[i];
+        if (!prepared->is_tensor[i]) {
+          const std::string& type_str = py::str(python_input.get_type());
+          batch_inputs[b][i] = to_scalar_evalue(python_input, type_str);
+          continue;
+        }
+        auto at_tensor = python_input.cast<at::Tensor>();
+        if (at_tensor.scalar_type() != prepared->dtypes[i] ||
+            at_tensor.sizes() != at::IntArrayRef(prepared->shapes[i]) ||
+            at_tensor.strides() != at::IntArrayRef(prepared->strides[i])) {
+          throw std::runtime_error(
+              "Input " + std::to_string(i) + " of set " + std::to_string(b) +
+              " for method " + method_name +
+              " does not match the prepared input");
+        }
 #ifdef USE_ATEN_LIB
-        // Clone so the outputs in python do not share a lifetime with the
-        // module object
-        list[i] = py::cast(v.toTensor().clone());
-#else
-        list[i] = py::cast(
-            torch::util::alias_attensor_to_etensor(v.toTensor()).clone());
+        batch_inputs[b][i] = EValue(at_tensor);
 #endif
-      } else {
-        ET_ASSERT_UNREACHABLE_MSG("Invalid model output type");
+        batch_tensors[b][i] = std::move(at_tensor);
       }
     }
+
+    std::vector<std::vector<EValue>> batch_outputs(batch_size);
+    std::vector<std::vector<at::Tensor>> batch_output_tensors(batch_size);
+    {
+      py::gil_scoped_release no_gil;
+      // The prepared TensorImpls are shared, so one batch uses them at a time.
+      std::lock_guard<std::mutex> lock(prepared->mutex);
+      module_->with_method(method_name, [&](Method& method) {
+        for (size_t b = 0; b < batch_size; ++b) {
+#ifndef USE_ATEN_LIB
+          for (size_t i = 0; i < inputs_size; ++i) {
+            if (prepared->is_tensor[i]) {
+              prepared->tensors[i]->set_data(batch_tensors[b][i].data_ptr());
+            }
+          }
+#endif
+          std::vector<EValue>& outputs = batch_outputs[b];
+          outputs = Module::run_method(method, method_name, batch_inputs[b]);
+          batch_output_tensors[b].resize(outputs.size());
+          for (size_t i = 0; i < outputs.size(); ++i) {
+            if (outputs[i].isTensor()) {
+              batch_output_tensors[b][i] =
+                  to_attensor(outputs[i].toTensor()).clone();
+            }
+          }
+        }
+      });
+    }
+
+    py::list list(batch_size);
+    for (size_t b = 0; b < batch_size; ++b) {
+      list[b] = to_py_list(
+          method_name,
+          batch_outputs[b],
+          batch_output_tensors[b],
+          /*clone_outputs=*/true);
+    }
     return list;
   }
 
-  py::list forward(const py::sequence& inputs) {
-    return run_method("forward", inputs);
+  /**
+   * Returns the ETDump of every method run since the previous call, or since
+   * the module was loaded, and clears it. The bytes can be passed straight to
+   * sdk.inspector.Inspector(etdump_data=...). Requires a module loaded with
+   * `enable_etdump`.
+   */
+  py::bytes get_etdump() {
+    THROW_IF_ERROR(
+        module_->etdump_enabled() ? Error::Ok : Error::NotSupported,
+        "get_etdump() requires a module loaded with enable_etdump=True");
+    std::string etdump;
+    {
+      py::gil_scoped_release no_gil;
+      etdump = module_->take_etdump();
+    }
+    return py::bytes(etdump);
+  }
+
+  /**
+   * Benchmarks a method: runs it `num_warmup` times, drops what ETDump
+   * recorded so far, runs it `num_iterations` more times, and returns the
+   * ETDump of those runs, with one event block per run. Outputs are not
+   * copied, since they are thrown away.
+   */
+  py::bytes profile_method(
+      const std::string& method_name,
+      const py::sequence& inputs,
+      size_t num_warmup,
+      size_t num_iterations) {
+    // Checks that ETDump is enabled before running anything.
+    get_etdump();
+    for (size_t i = 0; i < num_warmup; ++i) {
+      run_method(method_name, inputs, /*clone_outputs=*/false);
+    }
+    get_etdump();
+    for (size_t i = 0; i < num_iterations; ++i) {
+      run_method(method_name, inputs, /*clone_outputs=*/false);
+    }
+    return get_etdump();
+  }
+
+  /**
+   * Makes output `output_index` of a method write straight into `buffer`,
+   * which must be a contiguous tensor of the output's dtype and at least its
+   * size. The module keeps a reference to `buffer`. Only works for outputs
+   * that the memory plan did not allocate, and for modules with a single
+   * instance, which would otherwise all write to the same buffer.
+   */
+  void set_output_buffer(
+      const std::string& method_name,
+      size_t output_index,
+      const at::Tensor& buffer) {
+    THROW_IF_ERROR(
+        module_->num_instances() == 1 ? Error::Ok : Error::NotSupported,
+        "set_output_buffer() requires a module with a single instance");
+    THROW_IF_ERROR(
+        buffer.is_contiguous() ? Error::Ok : Error::InvalidArgument,
+        "output buffer for method '%s' is not contiguous",
+        method_name.c_str());
+    Error status = Error::Ok;
+    module_->with_first_instance_method(method_name, [&](Method& method) {
+      status = method.set_output_data_ptr(
+          buffer.data_ptr(), buffer.nbytes(), output_index);
+    });
+    THROW_IF_ERROR(
+        status,
+        "set_output_data_ptr() for method '%s' failed with error 0x%" PRIx32,
+        method_name.c_str(),
+        status);
+    std::vector<at::Tensor>& buffers = output_buffers_[method_name];
+    if (buffers.size() <= output_index) {
+      buffers.resize(output_index + 1);
+    }
+    buffers[output_index] = buffer;
   }
 
   void load_bundled_input(
@@ -464,12 +841,15 @@ struct PyModule final {
       const string method_name,
       size_t testset_idx) {
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
-    Error status = util::LoadBundledInput(
-        module_->get_method(method_name),
-        bundled_program_ptr,
-        &m.get_bundled_input_allocator(),
-        method_name.c_str(),
-        testset_idx);
+    Error status = Error::Ok;
+    module_->with_first_instance_method(method_name, [&](Method& method) {
+      status = util::LoadBundledInput(
+          method,
+          bundled_program_ptr,
+          &m.get_bundled_input_allocator(),
+          method_name.c_str(),
+          testset_idx);
+    });
     ET_CHECK_MSG(
         status == Error::Ok,
         "LoadBundledInput failed with status %" PRIu32,
@@ -481,12 +861,15 @@ struct PyModule final {
       const string method_name,
       size_t testset_idx) {
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
-    Error status = util::VerifyResultWithBundledExpectedOutput(
-        module_->get_method(method_name),
-        bundled_program_ptr,
-        &m.get_bundled_input_allocator(),
-        method_name.c_str(),
-        testset_idx);
+    Error status = Error::Ok;
+    module_->with_first_instance_method(method_name, [&](Method& method) {
+      status = util::VerifyResultWithBundledExpectedOutput(
+          method,
+          bundled_program_ptr,
+          &m.get_bundled_input_allocator(),
+          method_name.c_str(),
+          testset_idx);
+    });
     ET_CHECK_MSG(
         status == Error::Ok,
         "Result verification failed with status %" PRIu32,
@@ -494,7 +877,12 @@ struct PyModule final {
   }
 
   void plan_execute(const string method_name) {
-    auto status = module_->get_method(method_name).execute();
+    Error status = Error::Ok;
+    {
+      py::gil_scoped_release no_gil;
+      module_->with_first_instance_method(
+          method_name, [&](Method& method) { status = method.execute(); });
+    }
     THROW_IF_ERROR(
         status,
         "executing execution plan for method 'forward' failed with error: 0x%" PRIx32,
@@ -502,7 +890,118 @@ struct PyModule final {
   }
 
  private:
-  std::unique_ptr<Module> module_;
+  /// Input metadata built by prepare().
+  struct PreparedInputs {
+    /// Held while a run_batch() call points the TensorImpls at its data.
+    std::mutex mutex;
+    std::vector<bool> is_tensor;
+    std::vector<at::ScalarType> dtypes;
+    std::vector<std::vector<int64_t>> shapes;
+    std::vector<std::vector<int64_t>> strides;
+    /// The inputs to pass to the method; entries for non-tensor inputs are
+    /// replaced for every run.
+    std::vector<EValue> evalues;
+#ifndef USE_ATEN_LIB
+    /// Metadata lives in the module's input_meta_cache_.
+    std::vector<std::unique_ptr<torch::executor::TensorImpl>> tensors;
+#endif
+  };
+
+  /// Converts a None, bool or int input to an EValue.
+  static EValue to_scalar_evalue(
+      const py::handle& python_input,
+      const std::string& type_str) {
+    if (py::isinstance<py::none>(python_input)) {
+      return EValue();
+    } else if (py::isinstance<py::bool_>(python_input)) {
+      return EValue(py::cast<bool>(python_input));
+    } else if (py::isinstance<py::int_>(python_input)) {
+      return EValue(py::cast<int64_t>(python_input));
+    } else {
+      // Unsupported pytype
+      ET_ASSERT_UNREACHABLE_MSG(type_str.c_str());
+    }
+  }
+
+  /// Converts the outputs of a run to Python objects. `output_tensors` holds
+  /// the at::Tensors to return for tensor outputs.
+  py::list to_py_list(
+      const std::string& method_name,
+      const std::vector<EValue>& outputs,
+      const std::vector<at::Tensor>& output_tensors,
+      bool clone_outputs) {
+    const auto outputs_size = outputs.size();
+    py::list list(outputs_size);
+    for (size_t i = 0; i < outputs_size; ++i) {
+      auto& v = outputs[i];
+      if (Tag::None == v.tag) {
+        list[i] = py::none();
+      } else if (Tag::Int == v.tag) {
+        list[i] = py::cast(v.toInt());
+      } else if (Tag::Double == v.tag) {
+        list[i] = py::cast(v.toDouble());
+      } else if (Tag::Bool == v.tag) {
+        list[i] = py::cast(v.toBool());
+      } else if (Tag::String == v.tag) {
+        list[i] = py::cast(std::string(v.toString().data()));
+      } else if (Tag::Tensor == v.tag) {
+        const at::Tensor* registered =
+            clone_outputs ? nullptr : find_output_buffer(method_name, i);
+        if (registered != nullptr &&
+            registered->data_ptr() == output_tensors[i].data_ptr()) {
+          list[i] = py::cast(*registered);
+        } else {
+          list[i] = py::cast(output_tensors[i]);
+        }
+      } else {
+        ET_ASSERT_UNREACHABLE_MSG("Invalid model output type");
+      }
+    }
+    return list;
+  }
+
+  static at::Tensor to_attensor(const exec_aten::Tensor& tensor) {
+#ifdef USE_ATEN_LIB
+    return tensor;
+#else
+    return torch::util::alias_attensor_to_etensor(tensor);
+#endif
+  }
+
+  /// Returns an at::Tensor that aliases `tensor` and keeps the module alive.
+  at::Tensor alias_output(const exec_aten::Tensor& tensor) {
+    at::Tensor src = to_attensor(tensor);
+    std::shared_ptr<Module> module = module_;
+    return at::from_blob(
+        src.data_ptr(),
+        src.sizes(),
+        src.strides(),
+        [module](void*) {},
+        src.options());
+  }
+
+  /// Returns the buffer registered for an output, or nullptr.
+  const at::Tensor* find_output_buffer(
+      const std::string& method_name,
+      size_t output_index) const {
+    auto it = output_buffers_.find(method_name);
+    if (it == output_buffers_.end() || it->second.size() <= output_index ||
+        !it->second[output_index].defined()) {
+      return nullptr;
+    }
+    return &it->second[output_index];
+  }
+
+  // Shared with aliasing outputs, which keep the module's memory alive.
+  std::shared_ptr<Module> module_;
+  // Buffers registered by set_output_buffer(), by method name and output.
+  std::unordered_map<std::string, std::vector<at::Tensor>> output_buffers_;
+  // Input metadata from prepare(), by method name.
+  std::unordered_map<std::string, std::shared_ptr<PreparedInputs>> prepared_;
+#ifndef USE_ATEN_LIB
+  // ETensor metadata of tensor inputs, by shape. Only used with the GIL held.
+  torch::util::TensorMetaCache input_meta_cache_;
+#endif
 };
 
 void create_profile_block(const std::string& name) {
@@ -512,11 +1011,19 @@ void create_profile_block(const std::string& name) {
 } // namespace
 
 PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
-  m.def("_load_for_executorch", PyModule::load_from_file, py::arg("path"));
+  m.def(
+      "_load_for_executorch",
+      PyModule::load_from_file,
+      py::arg("path"),
+      py::arg("num_instances") = 1,
+      py::arg("mlock") = false,
+      py::arg("enable_etdump") = false);
   m.def(
       "_load_for_executorch_from_buffer",
       &PyModule::load_from_buffer,
-      py::arg("buffer"));
+      py::arg("buffer"),
+      py::arg("num_instances") = 1,
+      py::arg("enable_etdump") = false);
   m.def(
       "_load_for_executorch_from_bundled_program",
       &PyModule::load_from_bundled_program,
@@ -542,8 +1049,41 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           "verify_result_with_bundled_expected_output",
           &PyModule::verify_result_with_bundled_expected_output)
       .def("plan_execute", &PyModule::plan_execute)
-      .def("run_method", &PyModule::run_method)
-      .def("forward", &PyModule::forward);
+      .def(
+          "run_method",
+          &PyModule::run_method,
+          py::arg("method_name"),
+          py::arg("inputs"),
+          py::arg("clone_outputs") = true)
+      .def(
+          "forward",
+          &PyModule::forward,
+          py::arg("inputs"),
+          py::arg("clone_outputs") = true)
+      .def(
+          "prepare",
+          &PyModule::prepare,
+          py::arg("method_name"),
+          py::arg("inputs"))
+      .def(
+          "run_batch",
+          &PyModule::run_batch,
+          py::arg("method_name"),
+          py::arg("batch"))
+      .def(
+          "set_output_buffer",
+          &PyModule::set_output_buffer,
+          py::arg("method_name"),
+          py::arg("output_index"),
+          py::arg("buffer"))
+      .def("get_etdump", &PyModule::get_etdump)
+      .def(
+          "profile_method",
+          &PyModule::profile_method,
+          py::arg("method_name"),
+          py::arg("inputs"),
+          py::arg("num_warmup") = 1,
+          py::arg("num_iterations") = 10);
 
   py::class_<PyBundledModule>(m, "BundledModule");
 }
@@ -8,11 +8,37 @@
 from typing import Any, Dict, List, Sequence, Tuple
 
 class ExecutorchModule:
-    def run_method(self, method_name: str, inputs: Sequence[Any]) -> List[Any]: ...
-    def forward(self, inputs: Sequence[Any]) -> List[Any]: ...
+    def run_method(
+        self, method_name: str, inputs: Sequence[Any], clone_outputs: bool = True
+    ) -> List[Any]: ...
+    def forward(
+        self, inputs: Sequence[Any], clone_outputs: bool = True
+    ) -> List[Any]: ...
+    def prepare(self, method_name: str, inputs: Sequence[Any]) -> None: ...
+    def run_batch(
+        self, method_name: str, batch: Sequence[Sequence[Any]]
+    ) -> List[List[Any]]: ...
+    def set_output_buffer(
+        self, method_name: str, output_index: int, buffer: Any
+    ) -> None: ...
+    def get_etdump(self) -> bytes: ...
+    def profile_method(
+        self,
+        method_name: str,
+        inputs: Sequence[Any],
+        num_warmup: int = 1,
+        num_iterations: int = 10,
+    ) -> bytes: ...
 
-def _load_for_executorch(path: str) -> ExecutorchModule: ...
-def _load_for_executorch_from_buffer(buffer: bytes) -> ExecutorchModule: ...
+def _load_for_executorch(
+    path: str,
+    num_instances: int = 1,
+    mlock: bool = False,
+    enable_etdump: bool = False,
+) -> ExecutorchModule: ...
+def _load_for_executorch_from_buffer(
+    buffer: bytes, num_instances: int = 1, enable_etdump: bool = False
+) -> ExecutorchModule: ...
 def _create_profile_block(name: str) -> None: ...
 def _dump_profile_results() -> bytes: ...
 def _reset_profile_results() -> None: ...
@@ -5,6 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 import unittest
+from concurrent.futures import ThreadPoolExecutor
 from typing import Any, Callable, Tuple
 
 import executorch.exir as exir
@@ -105,6 +106,14 @@ def make_test(  # noqa: C901
             executorch_output2 = executorch_module.run_method("forward2", inputs)[0]
             tester.assertTrue(torch.allclose(executorch_output2, torch.ones(2, 2) * 3))
 
+        def test_unknown_method(tester):
+            # Methods are loaded on first use, which fails for unknown names.
+            program, inputs = create_program(ModuleMulti())
+            executorch_module = load_fn(program.buffer)
+
+            with tester.assertRaises(RuntimeError):
+                executorch_module.run_method("forward3", inputs)
+
         def test_output_lifespan(tester):
             def lower_function_call():
                 program, inputs = create_program(ModuleMulti())
@@ -116,8 +125,72 @@ def make_test(  # noqa: C901
             outputs = lower_function_call()
             tester.assertTrue(torch.allclose(outputs[0], torch.ones(2, 2) * 2))
 
+        def test_concurrent_execution(tester):
+            program, _ = create_program(ModuleAdd())
+            executorch_module = load_fn(program.buffer, num_instances=2)
+
+            # Each call must see its own inputs, even when the two instances are
+            # busy and calls wait for one of them.
+            def run(i):
+                inputs = (torch.full((2, 2), float(i)), torch.ones(2, 2))
+                return executorch_module.forward(inputs)[0]
+
+            with ThreadPoolExecutor(max_workers=4) as executor:
+                outputs = list(executor.map(run, range(16)))
+
+            for i, output in enumerate(outputs):
+                tester.assertTrue(torch.allclose(output, torch.full((2, 2), i + 1.0)))
+
+        def test_aliased_outputs(tester):
+            def lower_function_call():
+                program, inputs = create_program(ModuleAdd())
+                executorch_module = load_fn(program.buffer)
+
+                return executorch_module.forward(inputs, clone_outputs=False)
+                # The outputs keep the module's memory alive.
+
+            outputs = lower_function_call()
+            tester.assertTrue(torch.allclose(outputs[0], torch.ones(2, 2) * 2))
+
+        def test_run_batch(tester):
+            program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(program.buffer)
+
+            executorch_module.prepare("forward", inputs)
+            batch = [(torch.full((2, 2), float(i)), torch.ones(2, 2)) for i in range(3)]
+            outputs = executorch_module.run_batch("forward", batch)
+
+            tester.assertEqual(len(outputs), 3)
+            for i, output in enumerate(outputs):
+                expected = torch.full((2, 2), i + 1.0)
+                tester.assertTrue(torch.allclose(output[0], expected))
+
+            # Inputs must match the shapes given to prepare().
+            with tester.assertRaises(RuntimeError):
+                executorch_module.run_batch("forward", [(torch.ones(3), torch.ones(3))])
+
+        def test_etdump(tester):
+            program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(program.buffer, enable_etdump=True)
+
+            etdump = executorch_module.profile_method(
+                "forward", inputs, num_warmup=1, num_iterations=3
+            )
+            tester.assertIsInstance(etdump, bytes)
+            # Every run so far has been collected.
+            tester.assertEqual(executorch_module.get_etdump(), b"")
+
+            # ETDump must be enabled when loading.
+            with tester.assertRaises(RuntimeError):
+                load_fn(program.buffer).get_etdump()
+
         test_e2e(tester)
         test_multiple_entry(tester)
+        test_unknown_method(tester)
         test_output_lifespan(tester)
+        test_concurrent_execution(tester)
+        test_aliased_outputs(tester)
+        test_run_batch(tester)
+        test_etdump(tester)
 
     return wrapper
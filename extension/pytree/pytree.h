@@ -15,6 +15,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 
 // NB: This is a local, pytree FunctionRef and not from the ExecuTorch runtime.
 #include <executorch/extension/pytree/function_ref.h>
@@ -738,6 +739,242 @@ std::pair<arr<T*>, std::unique_ptr<TreeSpec<Aux>>> flatten(
       std::make_unique<TreeSpec<Aux>>(clone(tree, spec_leaves.get()))};
 }
 
+// A TreeSpec parsed once into flat arrays, for callers that flatten or
+// unflatten many trees of the same structure. Nodes are stored in preorder
+// with the offset of their first leaf, so unflatten() is a view over the
+// leaves and flatten_into() writes into a caller-provided buffer; neither
+// allocates.
+class FlatTreeSpec final {
+ public:
+  struct Node {
+    Kind kind;
+    size_t size;
+    size_t leaves_num;
+    // Index of the node's first leaf in the flattened leaves.
+    size_t leaf_offset;
+    // Offset of the node's children in children_ and keys_.
+    size_t children_offset;
+  };
+
+  template <typename Aux>
+  explicit FlatTreeSpec(const TreeSpec<Aux>& spec) {
+    size_t leaves_num = 0;
+    add_node(spec, leaves_num);
+  }
+
+  explicit FlatTreeSpec(const StrTreeSpec& spec)
+      : FlatTreeSpec(from_str<Empty>(spec)) {}
+
+  size_t leaves_num() const {
+    return nodes_[0].leaves_num;
+  }
+
+  const Node& node(size_t idx) const {
+    pytree_assert(idx < nodes_.size());
+    return nodes_[idx];
+  }
+
+  size_t child(size_t idx, size_t child_idx) const {
+    const Node& n = node(idx);
+    pytree_assert(child_idx < n.size);
+    return children_[n.children_offset + child_idx];
+  }
+
+  const Key& key(size_t idx, size_t child_idx) const {
+    const Node& n = node(idx);
+    pytree_assert(n.kind == Kind::Dict && child_idx < n.size);
+    return keys_[n.children_offset + child_idx];
+  }
+
+ private:
+  template <typename Aux>
+  size_t add_node(const TreeSpec<Aux>& spec, size_t& leaves_num) {
+    const size_t idx = nodes_.size();
+    const size_t size = spec.size();
+    const size_t children_offset = children_.size();
+    nodes_.push_back({spec.kind(), size, 0, leaves_num, children_offset});
+    if (spec.isLeaf()) {
+      nodes_[idx].leaves_num = 1;
+      leaves_num++;
+      return idx;
+    }
+    children_.resize(children_offset + size);
+    keys_.resize(children_offset + size);
+    for (size_t i = 0; i < size; ++i) {
+      if (spec.isDict()) {
+        keys_[children_offset + i] = spec.key(i);
+      }
+      children_[children_offset + i] = add_node(spec[i], leaves_num);
+    }
+    nodes_[idx].leaves_num = leaves_num - nodes_[idx].leaf_offset;
+    return idx;
+  }
+
+  std::vector<Node> nodes_;
+  std::vector<size_t> children_;
+  std::vector<Key> keys_;
+};
+
+// A node of a tree with the structure of a FlatTreeSpec whose leaves are
+// stored contiguously in flattened order. Mirrors the accessors of
+// ContainerHandle.
+template <typename T>
+class TreeView final {
+ public:
+  using leaf_type = T;
+
+  TreeView(const FlatTreeSpec& spec, leaf_type* leaves, size_t node_idx = 0)
+      : spec_(&spec), leaves_(leaves), node_idx_(node_idx) {}
+
+  Kind kind() const {
+    return node().kind;
+  }
+
+  bool isDict() const {
+    return kind() == Kind::Dict;
+  }
+
+  bool isList() const {
+    return kind() == Kind::List;
+  }
+
+  bool isNamedTuple() const {
+    return kind() == Kind::NamedTuple;
+  }
+
+  bool isTuple() const {
+    return kind() == Kind::Tuple;
+  }
+
+  bool isLeaf() const {
+    return kind() == Kind::Leaf;
+  }
+
+  size_t size() const {
+    return node().size;
+  }
+
+  size_t leaves_num() const {
+    return node().leaves_num;
+  }
+
+  TreeView operator[](size_t idx) const {
+    return TreeView(*spec_, leaves_, spec_->child(node_idx_, idx));
+  }
+
+  const Key& key(size_t idx) const {
+    return spec_->key(node_idx_, idx);
+  }
+
+  bool contains(const KeyStr& lookup_key) const {
+    pytree_assert(isDict());
+    for (size_t i = 0; i < size(); ++i) {
+      if (key(i).kind() == Key::Kind::Str && key(i).as_str() == lookup_key) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  TreeView at(const Key& lookup_key) const {
+    pytree_assert(isDict());
+    for (size_t i = 0; i < size(); ++i) {
+      if (key(i) == lookup_key) {
+        return operator[](i);
+      }
+    }
+    pytree_unreachable();
+  }
+
+  TreeView at(const KeyInt& lookup_key) const {
+    pytree_assert(isDict());
+    for (size_t i = 0; i < size(); ++i) {
+      if (key(i).kind() == Key::Kind::Int && key(i).as_int() == lookup_key) {
+        return operator[](i);
+      }
+    }
+    pytree_unreachable();
+  }
+
+  TreeView at(const char* lookup_key) const {
+    pytree_assert(isDict());
+    for (size_t i = 0; i < size(); ++i) {
+      if (key(i).kind() == Key::Kind::Str && key(i).as_str() == lookup_key) {
+        return operator[](i);
+      }
+    }
+    pytree_unreachable();
+  }
+
+  leaf_type& leaf() const {
+    pytree_assert(isLeaf());
+    return leaves_[node().leaf_offset];
+  }
+
+  leaf_type* leaf_ptr() const {
+    pytree_assert(isLeaf());
+    return leaves_ + node().leaf_offset;
+  }
+
+  operator leaf_type() const {
+    return leaf();
+  }
+
+ private:
+  const FlatTreeSpec::Node& node() const {
+    return spec_->node(node_idx_);
+  }
+
+  const FlatTreeSpec* spec_;
+  leaf_type* leaves_;
+  size_t node_idx_;
+};
+
+template <typename T>
+TreeView<T> unflatten(const FlatTreeSpec& spec, T* leaves) {
+  return TreeView<T>(spec, leaves);
+}
+
+template <typename T, typename Aux>
+bool flatten_into_internal(
+    const FlatTreeSpec& spec,
+    size_t node_idx,
+    ContainerHandle<T, Aux>& tree,
+    T** leaves) {
+  const FlatTreeSpec::Node& node = spec.node(node_idx);
+  if (tree.kind() != node.kind) {
+    return false;
+  }
+  if (node.kind == Kind::Leaf) {
+    leaves[node.leaf_offset] = tree.leaf_ptr();
+    return true;
+  }
+  if (tree.size() != node.size) {
+    return false;
+  }
+  for (size_t i = 0; i < node.size; ++i) {
+    if (node.kind == Kind::Dict && tree.key(i) != spec.key(node_idx, i)) {
+      return false;
+    }
+    if (!flatten_into_internal(
+            spec, spec.child(node_idx, i), tree[i], leaves)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the spec.leaves_num() leaves of `tree` into `leaves`, in flattened
+// order. Returns false if the structure of `tree` does not match `spec`, in
+// which case `leaves` may be partially written.
+template <typename T, typename Aux>
+bool flatten_into(
+    const FlatTreeSpec& spec,
+    ContainerHandle<T, Aux>& tree,
+    T** leaves) {
+  return flatten_into_internal(spec, 0, tree, leaves);
+}
+
 } // namespace pytree
 } // namespace executor
 } // namespace torch
@@ -188,6 +188,59 @@ TEST(pytree, FlattenNestedDict) {
   }
 }
 
+TEST(pytree, FlatTreeSpecUnflatten) {
+  const FlatTreeSpec spec("D3#2#1#1('key0':L2#1#1($,$),1:$,'key2':T1#1($))");
+  ASSERT_EQ(spec.leaves_num(), 4);
+
+  // The same spec views different leaves without being parsed again.
+  Leaf items0[4] = {11, 12, 13, 14};
+  Leaf items1[4] = {21, 22, 23, 24};
+  for (Leaf* items : {items0, items1}) {
+    auto c = unflatten(spec, items);
+    ASSERT_TRUE(c.isDict());
+    ASSERT_EQ(c.size(), 3);
+    ASSERT_TRUE(c.key(0) == Key("key0"));
+    ASSERT_TRUE(c.key(1) == Key(1));
+    ASSERT_TRUE(c.contains("key2"));
+    ASSERT_FALSE(c.contains("key1"));
+
+    const auto list = c.at("key0");
+    ASSERT_TRUE(list.isList());
+    ASSERT_EQ(list.size(), 2);
+    ASSERT_EQ(list.leaves_num(), 2);
+    ASSERT_EQ(list[0], items[0]);
+    ASSERT_EQ(list[1], items[1]);
+    ASSERT_EQ(c.at(1), items[2]);
+    const auto tuple = c[2];
+    ASSERT_TRUE(tuple.isTuple());
+    ASSERT_EQ(tuple[0].leaf_ptr(), &items[3]);
+  }
+}
+
+TEST(pytree, FlatTreeSpecFlattenInto) {
+  const FlatTreeSpec spec("D2#2#1('key0':L2#1#1($,$),'key1':$)");
+
+  Leaf items[3] = {11, 12, 13};
+  auto c = ContainerHandle<Leaf>(Kind::Dict, 2);
+  auto list = ContainerHandle<Leaf>(Kind::List, 2);
+  list[0] = &items[0];
+  list[1] = &items[1];
+  c[0] = std::move(list);
+  c[1] = &items[2];
+  c.key(0) = Key("key0");
+  c.key(1) = Key("key1");
+
+  Leaf* leaves[3] = {};
+  ASSERT_TRUE(flatten_into(spec, c, leaves));
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(leaves[i], &items[i]);
+  }
+
+  // A tree with a different key does not match the spec.
+  c.key(1) = Key("other");
+  ASSERT_FALSE(flatten_into(spec, c, leaves));
+}
+
 } // namespace pytree
 } // namespace executor
 } // namespace torch
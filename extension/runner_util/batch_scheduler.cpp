@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/runner_util/batch_scheduler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+namespace {
+
+// Matches the alignment that memory planning gives tensors.
+constexpr size_t kBufferAlignment = 64;
+
+size_t align_up(size_t value) {
+  return (value + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+} // namespace
+
+struct BatchScheduler::Request {
+  exec_aten::ArrayRef<exec_aten::Tensor> outputs;
+  /// Set with the error of the batch once its outputs are written.
+  bool done = false;
+  Error error = Error::Ok;
+};
+
+struct BatchScheduler::Batch {
+  std::unique_ptr<uint8_t[]> storage;
+  /// max_batch_size rows of each input.
+  std::vector<uint8_t*> inputs;
+  /// The buffer of each output that is not memory-planned, or nullptr.
+  std::vector<uint8_t*> outputs;
+  /// The requests in the batch; request i is row i.
+  std::vector<Request*> requests;
+};
+
+struct BatchScheduler::Queue {
+  std::mutex mutex;
+  /// Signaled when a batch fills up or finishes.
+  std::condition_variable changed;
+  /// One batch per instance of the pool, and one more that forms while they
+  /// all run.
+  std::vector<Batch> batches;
+  std::vector<Batch*> free_batches;
+  /// The batch that requests join, if any.
+  Batch* open = nullptr;
+};
+
+Result<BatchScheduler> BatchScheduler::create(
+    MethodPool* pool,
+    Config config) {
+  ET_CHECK_OR_RETURN_ERROR(
+      pool != nullptr, InvalidArgument, "The pool must not be null");
+  ET_CHECK_OR_RETURN_ERROR(
+      config.max_batch_size > 0,
+      InvalidArgument,
+      "The batch size must be at least 1");
+  MethodPool::Lease method(*pool);
+  ET_CHECK_OR_RETURN_ERROR(
+      method.ok(),
+      InvalidState,
+      "Every instance of the pool is checked out");
+  MethodMeta meta = method->method_meta();
+  size_t max_batch_size = config.max_batch_size;
+
+  // Every input and output is a tensor whose dim 0 is the batch.
+  auto make_row = [&](Result<TensorInfo> info,
+                      const char* kind,
+                      size_t index) -> Result<Row> {
+    ET_CHECK_OR_RETURN_ERROR(
+        info.ok() && info->sizes().size() > 0 && info->sizes()[0] > 0,
+        InvalidArgument,
+        "%s %zu is not a tensor with a batch dimension",
+        kind,
+        index);
+    const size_t program_batch_size = static_cast<size_t>(info->sizes()[0]);
+    max_batch_size = std::min(max_batch_size, program_batch_size);
+    return Row{
+        info->scalar_type(),
+        std::vector<exec_aten::SizesType>(
+            info->sizes().begin(), info->sizes().end()),
+        info->nbytes() / program_batch_size,
+        info->nbytes(),
+        /*needs_buffer=*/false};
+  };
+  std::vector<Row> inputs;
+  for (size_t i = 0; i < method->inputs_size(); ++i) {
+    Result<Row> row = make_row(meta.input_tensor_meta(i), "Input", i);
+    if (!row.ok()) {
+      return row.error();
+    }
+    inputs.push_back(std::move(row.get()));
+  }
+  std::vector<Row> outputs;
+  for (size_t i = 0; i < method->outputs_size(); ++i) {
+    Result<Row> row = make_row(meta.output_tensor_meta(i), "Output", i);
+    if (!row.ok()) {
+      return row.error();
+    }
+    // Outputs that are not memory-planned have no data until
+    // set_output_data_ptr(); the instances of a pool share one plan.
+    row->needs_buffer =
+        method->get_output(i).toTensor().const_data_ptr() == nullptr;
+    outputs.push_back(std::move(row.get()));
+  }
+
+  size_t storage_size = kBufferAlignment;
+  for (const Row& row : inputs) {
+    storage_size += align_up(row.nbytes * max_batch_size);
+  }
+  for (const Row& row : outputs) {
+    // set_output_data_ptr() needs room for the largest batch of the program.
+    storage_size += row.needs_buffer ? align_up(row.max_nbytes) : 0;
+  }
+  std::unique_ptr<Queue> queue(new Queue());
+  queue->batches.resize(pool->size() + 1);
+  for (Batch& batch : queue->batches) {
+    batch.storage.reset(new (std::nothrow) uint8_t[storage_size]);
+    if (batch.storage == nullptr) {
+      ET_LOG(
+          Error, "Failed to allocate %zu bytes for a batch", storage_size);
+      return Error::MemoryAllocationFailed;
+    }
+    uint8_t* next = reinterpret_cast<uint8_t*>(
+        align_up(reinterpret_cast<uintptr_t>(batch.storage.get())));
+    for (const Row& row : inputs) {
+      batch.inputs.push_back(next);
+      next += align_up(row.nbytes * max_batch_size);
+    }
+    for (const Row& row : outputs) {
+      batch.outputs.push_back(row.needs_buffer ? next : nullptr);
+      next += row.needs_buffer ? align_up(row.max_nbytes) : 0;
+    }
+    batch.requests.reserve(max_batch_size);
+    queue->free_batches.push_back(&batch);
+  }
+  return BatchScheduler(
+      pool,
+      max_batch_size,
+      config.max_delay_us,
+      std::move(inputs),
+      std::move(outputs),
+      std::move(queue));
+}
+
+BatchScheduler::BatchScheduler(
+    MethodPool* pool,
+    size_t max_batch_size,
+    uint32_t max_delay_us,
+    std::vector<Row> inputs,
+    std::vector<Row> outputs,
+    std::unique_ptr<Queue> queue)
+    : pool_(pool),
+      max_batch_size_(max_batch_size),
+      max_delay_us_(max_delay_us),
+      inputs_(std::move(inputs)),
+      outputs_(std::move(outputs)),
+      queue_(std::move(queue)) {}
+
+BatchScheduler::~BatchScheduler() = default;
+
+Error BatchScheduler::check_tensors(
+    exec_aten::ArrayRef<exec_aten::Tensor> tensors,
+    const std::vector<Row>& rows,
+    const char* kind) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      tensors.size() == rows.size(),
+      InvalidArgument,
+      "Expected %zu %ss, got %zu",
+      rows.size(),
+      kind,
+      tensors.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const exec_aten::Tensor& tensor = tensors[i];
+    const Row& row = rows[i];
+    bool matches = tensor.scalar_type() == row.scalar_type &&
+        static_cast<size_t>(tensor.dim()) == row.sizes.size() &&
+        tensor.size(0) == 1;
+    for (size_t d = 1; matches && d < row.sizes.size(); ++d) {
+      matches = tensor.size(d) == row.sizes[d];
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        matches,
+        InvalidArgument,
+        "%s %zu must be a row of the method's %s, with a batch size of 1",
+        kind,
+        i,
+        kind);
+  }
+  return Error::Ok;
+}
+
+Error BatchScheduler::run(
+    exec_aten::ArrayRef<exec_aten::Tensor> inputs,
+    exec_aten::ArrayRef<exec_aten::Tensor> outputs) {
+  Error err = check_tensors(inputs, inputs_, "input");
+  if (err != Error::Ok) {
+    return err;
+  }
+  err = check_tensors(outputs, outputs_, "output");
+  if (err != Error::Ok) {
+    return err;
+  }
+
+  Queue& queue = *queue_;
+  Request request;
+  request.outputs = outputs;
+  std::unique_lock<std::mutex> lock(queue.mutex);
+
+  // Join the open batch, or open one once a buffer is free.
+  queue.changed.wait(lock, [&] {
+    return queue.open != nullptr || !queue.free_batches.empty();
+  });
+  const bool leader = queue.open == nullptr;
+  if (leader) {
+    queue.open = queue.free_batches.back();
+    queue.free_batches.pop_back();
+    queue.open->requests.clear();
+  }
+  Batch* batch = queue.open;
+  const size_t row = batch->requests.size();
+  batch->requests.push_back(&request);
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    std::memcpy(
+        batch->inputs[i] + row * inputs_[i].nbytes,
+        inputs[i].const_data_ptr(),
+        inputs_[i].nbytes);
+  }
+  if (batch->requests.size() == max_batch_size_) {
+    queue.open = nullptr;
+    queue.changed.notify_all();
+  }
+
+  if (!leader) {
+    queue.changed.wait(lock, [&] { return request.done; });
+    return request.error;
+  }
+
+  // The first request runs the batch once it is full, or once the delay has
+  // passed and an instance is idle. Until then, the batch keeps growing.
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::microseconds(max_delay_us_);
+  Method* method = nullptr;
+  while (true) {
+    if (queue.open != batch ||
+        std::chrono::steady_clock::now() >= deadline) {
+      method = pool_->try_acquire();
+      if (method != nullptr) {
+        break;
+      }
+      queue.changed.wait(lock);
+    } else {
+      queue.changed.wait_until(lock, deadline);
+    }
+  }
+  if (queue.open == batch) {
+    queue.open = nullptr;
+  }
+  lock.unlock();
+
+  err = execute(*batch, method);
+  pool_->release(method);
+
+  lock.lock();
+  for (Request* r : batch->requests) {
+    r->error = err;
+    r->done = true;
+  }
+  queue.free_batches.push_back(batch);
+  queue.changed.notify_all();
+  return request.error;
+}
+
+Error BatchScheduler::execute(Batch& batch, Method* method) {
+  const size_t batch_size = batch.requests.size();
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    std::vector<exec_aten::SizesType> sizes = inputs_[i].sizes;
+    sizes[0] = static_cast<exec_aten::SizesType>(batch_size);
+    TensorImpl impl(
+        inputs_[i].scalar_type,
+        static_cast<ssize_t>(sizes.size()),
+        sizes.data(),
+        batch.inputs[i]);
+    Error err = method->set_input(EValue(exec_aten::Tensor(&impl)), i);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    if (batch.outputs[i] != nullptr) {
+      Error err = method->set_output_data_ptr(
+          batch.outputs[i], outputs_[i].max_nbytes, i);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+
+  Error err = method->execute();
+  if (err != Error::Ok) {
+    ET_LOG(
+        Error,
+        "Batch of %zu failed: 0x%" PRIx32,
+        batch_size,
+        static_cast<uint32_t>(err));
+    return err;
+  }
+
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    const exec_aten::Tensor& out = method->get_output(i).toTensor();
+    ET_CHECK_OR_RETURN_ERROR(
+        out.size(0) == static_cast<exec_aten::SizesType>(batch_size) &&
+            out.nbytes() == outputs_[i].nbytes * batch_size,
+        InvalidState,
+        "Output %zu does not have a row of %zu bytes per request",
+        i,
+        outputs_[i].nbytes);
+    const uint8_t* rows = static_cast<const uint8_t*>(out.const_data_ptr());
+    for (size_t r = 0; r < batch_size; ++r) {
+      std::memcpy(
+          batch.requests[r]->outputs[i].mutable_data_ptr(),
+          rows + r * outputs_[i].nbytes,
+          outputs_[i].nbytes);
+    }
+  }
+  return Error::Ok;
+}
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <executorch/runtime/core/array_ref.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/method_pool.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * Batches concurrent single-sample requests to the instances of a
+ * MethodPool, for servers where many threads each run one sample, e.g. one
+ * user query, and a single execution of a batch costs much less than one
+ * execution per sample.
+ *
+ * The method must be exported with a dynamic batch dimension: dim 0 of every
+ * input and output, bounded by the size it has in the program. Each request
+ * passes tensors of batch size 1 whose other dims match the program. The
+ * first request of a batch waits up to `Config::max_delay_us` for others to
+ * join it, or until the batch is full. The rows of the batch are then
+ * stacked in buffers owned by the scheduler, run in one execution, and each
+ * request gets its row of every output copied into its output tensors.
+ *
+ * @code
+ *   BatchScheduler::Config config;
+ *   config.max_batch_size = 16;
+ *   config.max_delay_us = 2000;
+ *   Result<BatchScheduler> scheduler = BatchScheduler::create(&pool, config);
+ *   // On each server thread:
+ *   Error err = scheduler->run({&query, 1}, {&scores, 1});
+ * @endcode
+ *
+ * Up to `pool->size()` batches run at once, one per instance; requests that
+ * arrive while every instance is busy form the next batch in the meantime.
+ * So with a pool of one instance, the delay only applies while it is idle,
+ * and throughput comes from batches that grow while it runs.
+ *
+ * Outputs that are not memory-planned are written to buffers of the
+ * scheduler through Method::set_output_data_ptr(). The pool must outlive the
+ * scheduler, and its instances must not be checked out by anything else.
+ */
+class BatchScheduler final {
+ public:
+  struct Config {
+    /// The largest batch to run. Clamped to the batch size in the program.
+    size_t max_batch_size = 8;
+    /// How long the first request of a batch waits for others, in
+    /// microseconds. Bounds the latency that batching adds to a request.
+    uint32_t max_delay_us = 1000;
+  };
+
+  /**
+   * Creates a scheduler for the instances of `pool`.
+   *
+   * @param[in] pool The instances of the method to run.
+   * @param[in] config How to form batches.
+   *
+   * @retval Error::InvalidArgument if an input or output of the method is not
+   *     a tensor with a batch dimension, or max_batch_size is 0.
+   * @retval Error::InvalidState if every instance of the pool is checked out.
+   * @retval Error::MemoryAllocationFailed if the batch buffers can't be
+   *     allocated.
+   */
+  static Result<BatchScheduler> create(MethodPool* pool, Config config);
+  static Result<BatchScheduler> create(MethodPool* pool) {
+    return create(pool, Config());
+  }
+
+  BatchScheduler(BatchScheduler&& rhs) noexcept = default;
+  ~BatchScheduler();
+
+  BatchScheduler(const BatchScheduler&) = delete;
+  BatchScheduler& operator=(const BatchScheduler&) = delete;
+  BatchScheduler& operator=(BatchScheduler&&) = delete;
+
+  /**
+   * Runs one sample as part of a batch, and blocks until its outputs are
+   * written. May be called from many threads at once.
+   *
+   * @param[in] inputs One tensor per method input, with a batch size of 1.
+   * @param[in] outputs One tensor per method output, with a batch size of 1
+   *     and room for a row of the output, which is copied into it.
+   *
+   * @retval Error::InvalidArgument if the inputs or outputs do not match the
+   *     method.
+   * @returns Any error of the execution of the batch, for every request in
+   *     it.
+   */
+  __ET_NODISCARD Error run(
+      exec_aten::ArrayRef<exec_aten::Tensor> inputs,
+      exec_aten::ArrayRef<exec_aten::Tensor> outputs);
+
+  /// Returns the largest batch that the scheduler runs.
+  size_t max_batch_size() const {
+    return max_batch_size_;
+  }
+
+ private:
+  /// The shape of one row of an input or output.
+  struct Row {
+    exec_aten::ScalarType scalar_type;
+    /// The sizes of a batch; sizes[0] is set to the batch size.
+    std::vector<exec_aten::SizesType> sizes;
+    size_t nbytes;
+    /// The size of the tensor in the program, at its largest batch.
+    size_t max_nbytes;
+    /// True for outputs that are not memory-planned.
+    bool needs_buffer;
+  };
+
+  struct Request;
+  struct Batch;
+  /// The requests being batched, shared by the threads that call run().
+  struct Queue;
+
+  BatchScheduler(
+      MethodPool* pool,
+      size_t max_batch_size,
+      uint32_t max_delay_us,
+      std::vector<Row> inputs,
+      std::vector<Row> outputs,
+      std::unique_ptr<Queue> queue);
+
+  /// Checks that a request's tensors match the rows of the method.
+  __ET_NODISCARD Error check_tensors(
+      exec_aten::ArrayRef<exec_aten::Tensor> tensors,
+      const std::vector<Row>& rows,
+      const char* kind) const;
+
+  /// Runs a closed batch on `method`, and scatters its outputs to its
+  /// requests.
+  __ET_NODISCARD Error execute(Batch& batch, Method* method);
+
+  MethodPool* pool_;
+  size_t max_batch_size_;
+  uint32_t max_delay_us_;
+  std::vector<Row> inputs_;
+  std::vector<Row> outputs_;
+  std::unique_ptr<Queue> queue_;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
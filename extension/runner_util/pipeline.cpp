@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/runner_util/pipeline.h>
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+namespace {
+
+// Matches the alignment that memory planning gives tensors, and keeps
+// buffers that different threads write off each other's cache lines.
+constexpr size_t kBufferAlignment = 64;
+
+size_t align_up(size_t value) {
+  return (value + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+} // namespace
+
+struct Pipeline::Handoff {
+  std::mutex mutex;
+  std::condition_variable changed;
+  /// Runs that the earlier stage has written to the link buffers.
+  size_t produced = 0;
+  /// Runs that the later stage has finished reading from the link buffers.
+  size_t consumed = 0;
+};
+
+Result<Pipeline> Pipeline::create(
+    exec_aten::ArrayRef<Method*> stages,
+    exec_aten::ArrayRef<Link> links,
+    Config config) {
+  ET_CHECK_OR_RETURN_ERROR(
+      stages.size() > 0, InvalidArgument, "A pipeline needs a stage");
+  for (Method* stage : stages) {
+    ET_CHECK_OR_RETURN_ERROR(
+        stage != nullptr, InvalidArgument, "Stages must not be null");
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      config.queue_depth > 0,
+      InvalidArgument,
+      "The queue depth must be at least 1");
+  const size_t num_slots = config.threaded ? config.queue_depth : 1;
+
+  std::vector<LinkBuffers> buffers;
+  buffers.reserve(links.size());
+  for (size_t i = 0; i < links.size(); ++i) {
+    const Link& link = links[i];
+    ET_CHECK_OR_RETURN_ERROR(
+        link.stage + 1 < stages.size(),
+        InvalidArgument,
+        "Link %zu leaves stage %zu, which has no next stage",
+        i,
+        link.stage);
+    Method* producer = stages[link.stage];
+    Method* consumer = stages[link.stage + 1];
+    ET_CHECK_OR_RETURN_ERROR(
+        link.output_index < producer->outputs_size() &&
+            link.input_index < consumer->inputs_size(),
+        InvalidArgument,
+        "Link %zu connects output %zu to input %zu, which do not exist",
+        i,
+        link.output_index,
+        link.input_index);
+    for (size_t j = 0; j < i; ++j) {
+      ET_CHECK_OR_RETURN_ERROR(
+          links[j].stage != link.stage ||
+              links[j].input_index != link.input_index,
+          InvalidArgument,
+          "Input %zu of stage %zu is linked twice",
+          link.input_index,
+          link.stage + 1);
+    }
+    MethodMeta producer_meta = producer->method_meta();
+    MethodMeta consumer_meta = consumer->method_meta();
+    Result<TensorInfo> output = producer_meta.output_tensor_meta(
+        link.output_index);
+    Result<TensorInfo> input = consumer_meta.input_tensor_meta(
+        link.input_index);
+    ET_CHECK_OR_RETURN_ERROR(
+        output.ok() && input.ok(),
+        InvalidArgument,
+        "Link %zu does not connect a tensor output to a tensor input",
+        i);
+    ET_CHECK_OR_RETURN_ERROR(
+        output->scalar_type() == input->scalar_type(),
+        InvalidArgument,
+        "Link %zu connects dtype %" PRId8 " to dtype %" PRId8,
+        i,
+        static_cast<int8_t>(output->scalar_type()),
+        static_cast<int8_t>(input->scalar_type()));
+
+    // The size of the output in the program is its upper bound.
+    const size_t buffer_size = output->nbytes();
+    const size_t buffer_stride = align_up(buffer_size);
+    const size_t storage_size = buffer_stride * num_slots + kBufferAlignment;
+    std::unique_ptr<uint8_t[]> storage(
+        new (std::nothrow) uint8_t[storage_size]);
+    if (storage == nullptr) {
+      ET_LOG(
+          Error,
+          "Failed to allocate %zu bytes for link %zu",
+          storage_size,
+          i);
+      return Error::MemoryAllocationFailed;
+    }
+    uint8_t* aligned = reinterpret_cast<uint8_t*>(
+        align_up(reinterpret_cast<uintptr_t>(storage.get())));
+
+    // Fails if the output is memory-planned.
+    Error err =
+        producer->set_output_data_ptr(aligned, buffer_size, link.output_index);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Output %zu of stage %zu can't be linked: 0x%" PRIx32,
+          link.output_index,
+          link.stage,
+          static_cast<uint32_t>(err));
+      return err;
+    }
+    buffers.push_back(
+        {link,
+         output->scalar_type(),
+         std::move(storage),
+         aligned,
+         buffer_size,
+         buffer_stride,
+         std::vector<std::vector<exec_aten::SizesType>>(num_slots)});
+  }
+  return Pipeline(
+      std::vector<Method*>(stages.begin(), stages.end()),
+      std::move(buffers),
+      config.threaded,
+      num_slots);
+}
+
+Pipeline::Pipeline(
+    std::vector<Method*> stages,
+    std::vector<LinkBuffers> links,
+    bool threaded,
+    size_t num_slots)
+    : stages_(std::move(stages)),
+      links_(std::move(links)),
+      threaded_(threaded),
+      num_slots_(num_slots) {}
+
+Error Pipeline::run_stage(
+    size_t stage,
+    size_t run,
+    size_t slot,
+    const InputFn& set_inputs,
+    const OutputFn& read_outputs) {
+  Method* method = stages_[stage];
+  if (stage == 0) {
+    Error err = set_inputs(*method, run);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  for (LinkBuffers& link : links_) {
+    uint8_t* buffer = link.buffers + slot * link.buffer_stride;
+    if (link.link.stage + 1 == stage) {
+      std::vector<exec_aten::SizesType>& sizes = link.sizes[slot];
+      TensorImpl impl(
+          link.scalar_type,
+          static_cast<ssize_t>(sizes.size()),
+          sizes.data(),
+          buffer);
+      Error err =
+          method->set_input(EValue(Tensor(&impl)), link.link.input_index);
+      if (err != Error::Ok) {
+        return err;
+      }
+    } else if (link.link.stage == stage) {
+      Error err = method->set_output_data_ptr(
+          buffer, link.buffer_size, link.link.output_index);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+
+  Error err = method->execute();
+  if (err != Error::Ok) {
+    ET_LOG(
+        Error,
+        "Stage %zu failed in run %zu: 0x%" PRIx32,
+        stage,
+        run,
+        static_cast<uint32_t>(err));
+    return err;
+  }
+
+  // The next stage needs the shape of each output, which dynamic shapes may
+  // have changed.
+  for (LinkBuffers& link : links_) {
+    if (link.link.stage == stage) {
+      exec_aten::ArrayRef<exec_aten::SizesType> sizes =
+          method->get_output(link.link.output_index).toTensor().sizes();
+      link.sizes[slot].assign(sizes.begin(), sizes.end());
+    }
+  }
+  if (stage + 1 == stages_.size()) {
+    return read_outputs(*method, run);
+  }
+  return Error::Ok;
+}
+
+Error Pipeline::run_threaded(
+    size_t num_runs,
+    const InputFn& set_inputs,
+    const OutputFn& read_outputs) {
+  // handoffs[i] is between stage i and stage i + 1.
+  std::unique_ptr<Handoff[]> handoffs(new Handoff[stages_.size() - 1]);
+  std::atomic<bool> failed(false);
+  std::mutex error_mutex;
+  Error first_error = Error::Ok;
+
+  auto fail = [&](Error err) {
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (first_error == Error::Ok) {
+        first_error = err;
+      }
+    }
+    failed = true;
+    // Wake up the stages that wait for this one.
+    for (size_t i = 0; i + 1 < stages_.size(); ++i) {
+      std::lock_guard<std::mutex> lock(handoffs[i].mutex);
+      handoffs[i].changed.notify_all();
+    }
+  };
+
+  auto stage_loop = [&](size_t stage) {
+    Handoff* in = stage > 0 ? &handoffs[stage - 1] : nullptr;
+    Handoff* out = stage + 1 < stages_.size() ? &handoffs[stage] : nullptr;
+    for (size_t run = 0; run < num_runs; ++run) {
+      if (in != nullptr) {
+        // Wait until the previous stage has written this run's inputs.
+        std::unique_lock<std::mutex> lock(in->mutex);
+        in->changed.wait(lock, [&] { return failed || in->produced > run; });
+      }
+      if (out != nullptr) {
+        // Wait until the next stage is done with the buffers of this slot.
+        std::unique_lock<std::mutex> lock(out->mutex);
+        out->changed.wait(
+            lock, [&] { return failed || run - out->consumed < num_slots_; });
+      }
+      if (failed) {
+        return;
+      }
+      Error err =
+          run_stage(stage, run, run % num_slots_, set_inputs, read_outputs);
+      if (err != Error::Ok) {
+        fail(err);
+        return;
+      }
+      if (in != nullptr) {
+        std::lock_guard<std::mutex> lock(in->mutex);
+        ++in->consumed;
+        in->changed.notify_all();
+      }
+      if (out != nullptr) {
+        std::lock_guard<std::mutex> lock(out->mutex);
+        ++out->produced;
+        out->changed.notify_all();
+      }
+    }
+  };
+
+  // The first stage runs on the calling thread.
+  std::vector<std::thread> threads;
+  threads.reserve(stages_.size() - 1);
+  for (size_t stage = 1; stage < stages_.size(); ++stage) {
+    threads.emplace_back(stage_loop, stage);
+  }
+  stage_loop(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return first_error;
+}
+
+Error Pipeline::run(
+    size_t num_runs,
+    const InputFn& set_inputs,
+    const OutputFn& read_outputs) {
+  if (threaded_ && stages_.size() > 1) {
+    return run_threaded(num_runs, set_inputs, read_outputs);
+  }
+  for (size_t run = 0; run < num_runs; ++run) {
+    for (size_t stage = 0; stage < stages_.size(); ++stage) {
+      Error err = run_stage(stage, run, /*slot=*/0, set_inputs, read_outputs);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <executorch/runtime/core/array_ref.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/method.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * Runs a chain of loaded Methods, e.g. detector -> cropper -> classifier from
+ * separate programs, where outputs of each stage feed inputs of the next one
+ * without being copied.
+ *
+ * Every link between two stages gets buffers owned by the pipeline. The
+ * producing stage writes its output straight into one of them through
+ * Method::set_output_data_ptr(), and the consuming stage's input is pointed at
+ * it with Method::set_input(). So linked outputs must not be memory-planned,
+ * and linked inputs are only shared without a copy if the consuming method's
+ * inputs are not memory-planned either; otherwise set_input() copies them
+ * into the planned buffer. Export with
+ * `MemoryPlanningPass(alloc_graph_input=False, alloc_graph_output=False)`.
+ *
+ * @code
+ *   const Pipeline::Link links[] = {{0, 0, 0}, {1, 0, 0}};
+ *   Pipeline::Config config;
+ *   config.threaded = true;
+ *   Result<Pipeline> pipeline = Pipeline::create(stages, links, config);
+ *   pipeline->run(
+ *       num_frames,
+ *       [&](Method& detector, size_t frame) {
+ *         return detector.set_input(frames[frame], 0);
+ *       },
+ *       [&](Method& classifier, size_t frame) {
+ *         return consume(classifier.get_output(0), frame);
+ *       });
+ * @endcode
+ *
+ * With `Config::threaded`, each stage runs on a thread of its own, so stage
+ * `i` can work on run `r + 1` while stage `i + 1` works on run `r`. Each link
+ * then has `Config::queue_depth` buffers, which bound how far a stage may get
+ * ahead of the next one.
+ *
+ * Inputs and outputs that are not linked are up to the caller: the first
+ * stage's inputs are set by the InputFn, unlinked outputs that are not
+ * memory-planned need set_output_data_ptr() before run(), and other unlinked
+ * inputs keep whatever they were last set to.
+ *
+ * The methods must outlive the pipeline and must not be used by anything
+ * else during run().
+ */
+class Pipeline final {
+ public:
+  /// Output `output_index` of `stage` feeds input `input_index` of
+  /// `stage + 1`.
+  struct Link {
+    size_t stage;
+    size_t output_index;
+    size_t input_index;
+  };
+
+  struct Config {
+    /// Run each stage on a thread of its own, so that stages overlap.
+    bool threaded = false;
+    /// The number of buffers per link when threaded; i.e. the number of runs
+    /// that may be in flight between two stages.
+    size_t queue_depth = 2;
+  };
+
+  /**
+   * Sets the inputs of the first stage for run `run`. Called on the first
+   * stage's thread.
+   */
+  using InputFn = std::function<Error(Method& method, size_t run)>;
+
+  /**
+   * Consumes the outputs of the last stage for run `run`. Called on the last
+   * stage's thread, before the last stage starts the next run.
+   */
+  using OutputFn = std::function<Error(Method& method, size_t run)>;
+
+  /**
+   * Creates a pipeline of `stages`, in order, connected by `links`.
+   *
+   * @param[in] stages The loaded methods to run, first to last.
+   * @param[in] links The outputs that feed inputs of the next stage. An input
+   *     may be linked only once.
+   * @param[in] config How to run the stages.
+   *
+   * @retval Error::InvalidArgument if a link does not connect a tensor output
+   *     to a tensor input of the same dtype in the next stage.
+   * @retval Error::InvalidState if a linked output is memory-planned.
+   * @retval Error::MemoryAllocationFailed if the link buffers can't be
+   *     allocated.
+   */
+  static Result<Pipeline> create(
+      exec_aten::ArrayRef<Method*> stages,
+      exec_aten::ArrayRef<Link> links,
+      Config config);
+  static Result<Pipeline> create(
+      exec_aten::ArrayRef<Method*> stages,
+      exec_aten::ArrayRef<Link> links) {
+    return create(stages, links, Config());
+  }
+
+  Pipeline(Pipeline&& rhs) noexcept = default;
+  ~Pipeline() = default;
+
+  Pipeline(const Pipeline&) = delete;
+  Pipeline& operator=(const Pipeline&) = delete;
+  Pipeline& operator=(Pipeline&&) = delete;
+
+  /**
+   * Runs every stage `num_runs` times, and returns when all runs are done.
+   *
+   * @param[in] num_runs The number of inputs to push through the pipeline.
+   * @param[in] set_inputs Sets the first stage's inputs for each run.
+   * @param[in] read_outputs Consumes the last stage's outputs for each run.
+   *
+   * @returns The first error from a stage or a callback, after which no
+   *     stage starts another run.
+   */
+  __ET_NODISCARD Error
+  run(size_t num_runs, const InputFn& set_inputs, const OutputFn& read_outputs);
+
+  /// Returns the number of stages.
+  size_t num_stages() const {
+    return stages_.size();
+  }
+
+ private:
+  /// The buffers of one link.
+  struct LinkBuffers {
+    Link link;
+    exec_aten::ScalarType scalar_type;
+    std::unique_ptr<uint8_t[]> storage;
+    /// The first buffer, aligned within storage.
+    uint8_t* buffers;
+    /// The capacity of each buffer.
+    size_t buffer_size;
+    size_t buffer_stride;
+    /// The sizes of the output written to each buffer, for the next stage.
+    std::vector<std::vector<exec_aten::SizesType>> sizes;
+  };
+
+  /// How far two neighbouring stages are during a threaded run().
+  struct Handoff;
+
+  Pipeline(
+      std::vector<Method*> stages,
+      std::vector<LinkBuffers> links,
+      bool threaded,
+      size_t num_slots);
+
+  /// Runs `stage` once for `run`, using buffer `slot` of its links. Must not
+  /// run concurrently with itself for the same stage.
+  __ET_NODISCARD Error run_stage(
+      size_t stage,
+      size_t run,
+      size_t slot,
+      const InputFn& set_inputs,
+      const OutputFn& read_outputs);
+
+  __ET_NODISCARD Error run_threaded(
+      size_t num_runs,
+      const InputFn& set_inputs,
+      const OutputFn& read_outputs);
+
+  std::vector<Method*> stages_;
+  std::vector<LinkBuffers> links_;
+  bool threaded_;
+  /// The number of buffers per link.
+  size_t num_slots_;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
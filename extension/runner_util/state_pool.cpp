@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/runner_util/state_pool.h>
+
+#include <cinttypes>
+#include <new>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+namespace {
+
+// Aligns each slot at least as strictly as memory planning aligns the
+// tensors within the state, and keeps streams off each other's cache lines.
+constexpr size_t kSlotAlignment = 64;
+
+size_t align_up(size_t value) {
+  return (value + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+
+} // namespace
+
+Result<StatePool> StatePool::create(Method* method, size_t max_streams) {
+  ET_CHECK_OR_RETURN_ERROR(
+      method != nullptr && max_streams > 0,
+      InvalidArgument,
+      "A pool needs a method and at least one stream");
+  Result<size_t> state_size = method->state_size();
+  if (!state_size.ok()) {
+    return state_size.error();
+  }
+  const size_t slot_stride = align_up(state_size.get());
+  const size_t storage_size = slot_stride * max_streams + kSlotAlignment;
+  std::unique_ptr<uint8_t[]> storage(new (std::nothrow) uint8_t[storage_size]);
+  if (storage == nullptr) {
+    ET_LOG(
+        Error,
+        "Failed to allocate %zu bytes for %zu streams",
+        storage_size,
+        max_streams);
+    return Error::MemoryAllocationFailed;
+  }
+  uint8_t* slots = reinterpret_cast<uint8_t*>(
+      align_up(reinterpret_cast<uintptr_t>(storage.get())));
+  return StatePool(
+      method,
+      std::move(storage),
+      slots,
+      state_size.get(),
+      slot_stride,
+      max_streams);
+}
+
+StatePool::StatePool(
+    Method* method,
+    std::unique_ptr<uint8_t[]> storage,
+    uint8_t* slots,
+    size_t state_size,
+    size_t slot_stride,
+    size_t max_streams)
+    : method_(method),
+      storage_(std::move(storage)),
+      slots_(slots),
+      state_size_(state_size),
+      slot_stride_(slot_stride),
+      in_use_(max_streams, false),
+      num_streams_(0),
+      selected_(kNoStream) {}
+
+StatePool::StatePool(StatePool&& rhs) noexcept
+    : method_(rhs.method_),
+      storage_(std::move(rhs.storage_)),
+      slots_(rhs.slots_),
+      state_size_(rhs.state_size_),
+      slot_stride_(rhs.slot_stride_),
+      in_use_(std::move(rhs.in_use_)),
+      num_streams_(rhs.num_streams_),
+      selected_(rhs.selected_) {
+  rhs.method_ = nullptr;
+  rhs.slots_ = nullptr;
+  rhs.num_streams_ = 0;
+  rhs.selected_ = kNoStream;
+}
+
+StatePool::~StatePool() {
+  if (method_ != nullptr && selected_ != kNoStream) {
+    // Don't leave the method pointing at freed memory.
+    Error err = method_->set_state_buffer(nullptr, 0);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to restore the method's state: 0x%" PRIx32,
+          static_cast<uint32_t>(err));
+    }
+  }
+}
+
+Error StatePool::check_stream(size_t stream) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      stream < in_use_.size() && in_use_[stream],
+      InvalidArgument,
+      "Stream %zu is not open",
+      stream);
+  return Error::Ok;
+}
+
+Result<size_t> StatePool::open_stream() {
+  for (size_t stream = 0; stream < in_use_.size(); ++stream) {
+    if (in_use_[stream]) {
+      continue;
+    }
+    in_use_[stream] = true;
+    num_streams_++;
+    Error err = reset_stream(stream);
+    if (err != Error::Ok) {
+      in_use_[stream] = false;
+      num_streams_--;
+      return err;
+    }
+    return stream;
+  }
+  ET_LOG(Error, "All %zu streams are open", in_use_.size());
+  return Error::MemoryAllocationFailed;
+}
+
+Error StatePool::close_stream(size_t stream) {
+  Error err = check_stream(stream);
+  if (err != Error::Ok) {
+    return err;
+  }
+  if (selected_ == stream) {
+    err = method_->set_state_buffer(nullptr, 0);
+    if (err != Error::Ok) {
+      return err;
+    }
+    selected_ = kNoStream;
+  }
+  in_use_[stream] = false;
+  num_streams_--;
+  return Error::Ok;
+}
+
+Error StatePool::select_stream(size_t stream) {
+  Error err = check_stream(stream);
+  if (err != Error::Ok) {
+    return err;
+  }
+  if (selected_ == stream) {
+    return Error::Ok;
+  }
+  err = method_->set_state_buffer(
+      slots_ + stream * slot_stride_, slot_stride_);
+  if (err != Error::Ok) {
+    return err;
+  }
+  selected_ = stream;
+  return Error::Ok;
+}
+
+Error StatePool::reset_stream(size_t stream) {
+  Error err = select_stream(stream);
+  if (err != Error::Ok) {
+    return err;
+  }
+  return method_->reset_state();
+}
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/method.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * Keeps the mutable state of many concurrent streams for one loaded Method,
+ * e.g. the encoder context of a streaming speech recognizer for each live
+ * audio stream, so that every stream shares the method's weights and
+ * activations and only pays for its own state.
+ *
+ * The state of all streams is in one allocation of `max_streams` slots of
+ * Method::state_size() bytes. Selecting a stream points the method's state at
+ * its slot without copying, so each execution only does the work of one
+ * chunk of input:
+ *
+ * @code
+ *   Result<StatePool> pool = StatePool::create(&method, max_streams);
+ *   Result<size_t> stream = pool->open_stream();
+ *   for (each chunk of the stream) {
+ *     pool->select_stream(stream.get());
+ *     method.set_input(chunk, 0);
+ *     method.execute();
+ *   }
+ *   pool->close_stream(stream.get());
+ * @endcode
+ *
+ * The method must outlive the pool. When the pool is destroyed, the method's
+ * state goes back to its memory-planned buffer.
+ *
+ * Not thread-safe; the method runs one stream at a time.
+ */
+class StatePool final {
+ public:
+  /**
+   * Creates a pool for the state of up to `max_streams` streams of `method`.
+   *
+   * @param[in] method The loaded method whose state to pool.
+   * @param[in] max_streams The number of streams that can be open at once.
+   *
+   * @retval Error::NotFound if the method has no mutable state.
+   * @retval Error::MemoryAllocationFailed if the slots can't be allocated.
+   */
+  static Result<StatePool> create(Method* method, size_t max_streams);
+
+  StatePool(StatePool&& rhs) noexcept;
+  ~StatePool();
+
+  StatePool(const StatePool&) = delete;
+  StatePool& operator=(const StatePool&) = delete;
+  StatePool& operator=(StatePool&&) = delete;
+
+  /**
+   * Claims a free slot for a new stream, selects it, and sets its state to
+   * the initial values from the program.
+   *
+   * @returns The id of the stream on success.
+   * @retval Error::MemoryAllocationFailed if `max_streams()` streams are open.
+   */
+  Result<size_t> open_stream();
+
+  /**
+   * Frees the slot of `stream`. If the stream was selected, the method's
+   * state goes back to its memory-planned buffer until the next selection.
+   */
+  __ET_NODISCARD Error close_stream(size_t stream);
+
+  /// Points the method's state at the slot of `stream`.
+  __ET_NODISCARD Error select_stream(size_t stream);
+
+  /**
+   * Selects `stream` and sets its state back to the initial values, e.g.
+   * when an utterance ends and the stream starts over.
+   */
+  __ET_NODISCARD Error reset_stream(size_t stream);
+
+  /// Returns the bytes of state that each stream takes.
+  size_t state_size() const {
+    return state_size_;
+  }
+
+  /// Returns the number of streams that can be open at once.
+  size_t max_streams() const {
+    return in_use_.size();
+  }
+
+  /// Returns the number of open streams.
+  size_t num_streams() const {
+    return num_streams_;
+  }
+
+ private:
+  /// No stream is selected.
+  static constexpr size_t kNoStream = static_cast<size_t>(-1);
+
+  StatePool(
+      Method* method,
+      std::unique_ptr<uint8_t[]> storage,
+      uint8_t* slots,
+      size_t state_size,
+      size_t slot_stride,
+      size_t max_streams);
+
+  __ET_NODISCARD Error check_stream(size_t stream) const;
+
+  Method* method_;
+  std::unique_ptr<uint8_t[]> storage_;
+  /// The first slot, aligned within storage_.
+  uint8_t* slots_;
+  size_t state_size_;
+  size_t slot_stride_;
+  std::vector<bool> in_use_;
+  size_t num_streams_;
+  size_t selected_;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,68 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_library(
+        name = "state_pool",
+        srcs = [
+            "state_pool.cpp",
+        ],
+        exported_headers = [
+            "state_pool.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/executor:program",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        visibility = [
+            "//executorch/extension/runner_util/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "pipeline",
+        srcs = [
+            "pipeline.cpp",
+        ],
+        exported_headers = [
+            "pipeline.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/executor:program",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        visibility = [
+            "//executorch/extension/runner_util/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "batch_scheduler",
+        srcs = [
+            "batch_scheduler.cpp",
+        ],
+        exported_headers = [
+            "batch_scheduler.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/executor:program",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        visibility = [
+            "//executorch/extension/runner_util/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
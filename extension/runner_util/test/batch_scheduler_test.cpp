@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/runner_util/batch_scheduler.h>
+
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/executor/method_pool.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using exec_aten::TensorImpl;
+using torch::executor::Error;
+using torch::executor::MemoryAllocator;
+using torch::executor::MemoryManager;
+using torch::executor::Method;
+using torch::executor::MethodPool;
+using torch::executor::Program;
+using torch::executor::Result;
+using torch::executor::testing::ManagedMemoryManager;
+using torch::executor::util::BatchScheduler;
+using torch::executor::util::FileDataLoader;
+
+constexpr size_t kDefaultNonConstMemBytes = 32 * 1024U;
+constexpr size_t kDefaultRuntimeMemBytes = 32 * 1024U;
+constexpr size_t kPoolSize = 2;
+
+/**
+ * Batches requests to ModuleDynamicBatch, which adds one to a batch of up to
+ * 8 rows of 4 floats.
+ */
+class BatchSchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+
+    Result<FileDataLoader> loader =
+        FileDataLoader::from(std::getenv("ET_MODULE_DYNAMIC_BATCH_PATH"));
+    ASSERT_EQ(loader.error(), Error::Ok);
+    loader_ = std::make_unique<FileDataLoader>(std::move(loader.get()));
+    Result<Program> program = Program::load(loader_.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    program_ = std::make_unique<Program>(std::move(program.get()));
+
+    for (size_t i = 0; i < kPoolSize; i++) {
+      mmms_[i] = std::make_unique<ManagedMemoryManager>(
+          kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+      memory_managers_[i] = &mmms_[i]->get();
+    }
+    Result<MethodPool> pool = MethodPool::load(
+        program_.get(),
+        "forward",
+        torch::executor::ArrayRef<MemoryManager*>(memory_managers_, kPoolSize),
+        &pool_allocator_);
+    ASSERT_EQ(pool.error(), Error::Ok);
+    pool_ = std::make_unique<MethodPool>(std::move(pool.get()));
+  }
+
+  /// Runs one request whose input row is all `value`, and checks its output.
+  static void run_request(BatchScheduler& scheduler, float value) {
+    int32_t sizes[2] = {1, 4};
+    float input[4] = {value, value, value, value};
+    float output[4] = {};
+    TensorImpl input_impl(ScalarType::Float, 2, sizes, input);
+    TensorImpl output_impl(ScalarType::Float, 2, sizes, output);
+    Tensor input_tensor(&input_impl);
+    Tensor output_tensor(&output_impl);
+    ASSERT_EQ(
+        scheduler.run({&input_tensor, 1}, {&output_tensor, 1}), Error::Ok);
+    for (size_t i = 0; i < 4; i++) {
+      EXPECT_FLOAT_EQ(output[i], value + 1);
+    }
+  }
+
+ private:
+  // Must outlive program_.
+  std::unique_ptr<FileDataLoader> loader_;
+  std::unique_ptr<ManagedMemoryManager> mmms_[kPoolSize];
+  uint8_t pool_memory_[kPoolSize * sizeof(Method) + 64];
+  MemoryManager* memory_managers_[kPoolSize];
+  MemoryAllocator pool_allocator_{sizeof(pool_memory_), pool_memory_};
+
+ protected:
+  std::unique_ptr<Program> program_;
+  std::unique_ptr<MethodPool> pool_;
+};
+
+TEST_F(BatchSchedulerTest, SingleRequestRunsAfterTheDelay) {
+  BatchScheduler::Config config;
+  config.max_delay_us = 100;
+  Result<BatchScheduler> scheduler =
+      BatchScheduler::create(pool_.get(), config);
+  ASSERT_EQ(scheduler.error(), Error::Ok);
+  run_request(scheduler.get(), 41.f);
+}
+
+TEST_F(BatchSchedulerTest, ConcurrentRequestsGetTheirOwnRows) {
+  BatchScheduler::Config config;
+  // Larger than the program's batch size, so it is clamped.
+  config.max_batch_size = 16;
+  config.max_delay_us = 2000;
+  Result<BatchScheduler> scheduler =
+      BatchScheduler::create(pool_.get(), config);
+  ASSERT_EQ(scheduler.error(), Error::Ok);
+  EXPECT_EQ(scheduler->max_batch_size(), 8);
+
+  constexpr size_t kNumThreads = 12;
+  constexpr size_t kRequestsPerThread = 10;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t] {
+      for (size_t r = 0; r < kRequestsPerThread; r++) {
+        run_request(scheduler.get(), static_cast<float>(t * 100 + r));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST_F(BatchSchedulerTest, RejectsMismatchedTensors) {
+  Result<BatchScheduler> scheduler = BatchScheduler::create(pool_.get());
+  ASSERT_EQ(scheduler.error(), Error::Ok);
+
+  float data[2 * 4] = {};
+  int32_t row_sizes[2] = {1, 4};
+  int32_t batch_sizes[2] = {2, 4};
+  TensorImpl row_impl(ScalarType::Float, 2, row_sizes, data);
+  TensorImpl batch_impl(ScalarType::Float, 2, batch_sizes, data);
+  TensorImpl int_impl(ScalarType::Int, 2, row_sizes, data);
+  Tensor row(&row_impl);
+  Tensor batch(&batch_impl);
+  Tensor ints(&int_impl);
+
+  // Requests are single samples.
+  EXPECT_EQ(scheduler->run({&batch, 1}, {&row, 1}), Error::InvalidArgument);
+  EXPECT_EQ(scheduler->run({&row, 1}, {&batch, 1}), Error::InvalidArgument);
+  EXPECT_EQ(scheduler->run({&ints, 1}, {&row, 1}), Error::InvalidArgument);
+  EXPECT_EQ(scheduler->run({}, {&row, 1}), Error::InvalidArgument);
+
+  BatchScheduler::Config no_batch;
+  no_batch.max_batch_size = 0;
+  EXPECT_EQ(
+      BatchScheduler::create(pool_.get(), no_batch).error(),
+      Error::InvalidArgument);
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/runner_util/pipeline.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using exec_aten::TensorImpl;
+using torch::executor::Error;
+using torch::executor::EValue;
+using torch::executor::Method;
+using torch::executor::Program;
+using torch::executor::Result;
+using torch::executor::testing::ManagedMemoryManager;
+using torch::executor::util::FileDataLoader;
+using torch::executor::util::Pipeline;
+
+constexpr size_t kDefaultNonConstMemBytes = 32 * 1024;
+constexpr size_t kDefaultRuntimeMemBytes = 32 * 1024;
+
+/**
+ * Chains two copies of ModuleDynamicCatUnallocatedIO, which appends a row of
+ * ones to its input and whose inputs and outputs are not memory-planned. The
+ * boolean parameter runs the stages on threads.
+ */
+class PipelineTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+
+    Result<FileDataLoader> loader = FileDataLoader::from(
+        std::getenv("ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH"));
+    ASSERT_EQ(loader.error(), Error::Ok);
+    loader_ = std::make_unique<FileDataLoader>(std::move(loader.get()));
+    Result<Program> program = Program::load(loader_.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    program_ = std::make_unique<Program>(std::move(program.get()));
+
+    for (size_t i = 0; i < 2; ++i) {
+      mmms_.push_back(std::make_unique<ManagedMemoryManager>(
+          kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes));
+      Result<Method> method =
+          program_->load_method("forward", &mmms_.back()->get());
+      ASSERT_EQ(method.error(), Error::Ok);
+      methods_.push_back(std::make_unique<Method>(std::move(method.get())));
+      stages_.push_back(methods_.back().get());
+    }
+  }
+
+  ArrayRef<Method*> stages() {
+    return {stages_.data(), stages_.size()};
+  }
+
+  Pipeline::Config config() const {
+    Pipeline::Config config;
+    config.threaded = GetParam();
+    config.queue_depth = 2;
+    return config;
+  }
+
+  std::unique_ptr<FileDataLoader> loader_;
+  std::unique_ptr<Program> program_;
+  std::vector<std::unique_ptr<ManagedMemoryManager>> mmms_;
+  std::vector<std::unique_ptr<Method>> methods_;
+  std::vector<Method*> stages_;
+};
+
+TEST_P(PipelineTest, OutputsFeedTheNextStage) {
+  const Pipeline::Link links[] = {{0, 0, 0}};
+  Result<Pipeline> pipeline = Pipeline::create(stages(), links, config());
+  ASSERT_EQ(pipeline.error(), Error::Ok);
+  EXPECT_EQ(pipeline->num_stages(), 2);
+
+  // The last output is not linked, so it needs a buffer of the caller.
+  float output[4 * 4];
+  ASSERT_EQ(
+      stages_[1]->set_output_data_ptr(output, sizeof(output), 0), Error::Ok);
+
+  // Each run starts from a 2x4 input filled with the run number.
+  constexpr size_t kNumRuns = 8;
+  std::vector<std::vector<float>> inputs(kNumRuns);
+  std::vector<std::unique_ptr<TensorImpl>> impls;
+  int32_t sizes[2] = {2, 4};
+  for (size_t run = 0; run < kNumRuns; ++run) {
+    inputs[run].assign(2 * 4, static_cast<float>(run));
+    impls.push_back(std::make_unique<TensorImpl>(
+        ScalarType::Float, 2, sizes, inputs[run].data()));
+  }
+
+  size_t num_outputs = 0;
+  Error err = pipeline->run(
+      kNumRuns,
+      [&](Method& method, size_t run) {
+        return method.set_input(EValue(Tensor(impls[run].get())), 0);
+      },
+      [&](Method& method, size_t run) {
+        // The first stage made a 3x4, and the second one a 4x4.
+        const Tensor& out = method.get_output(0).toTensor();
+        EXPECT_EQ(out.const_data_ptr(), output);
+        EXPECT_EQ(out.size(0), 4);
+        EXPECT_EQ(out.size(1), 4);
+        for (size_t i = 0; i < 2 * 4; ++i) {
+          EXPECT_FLOAT_EQ(output[i], static_cast<float>(run));
+        }
+        for (size_t i = 2 * 4; i < 4 * 4; ++i) {
+          EXPECT_FLOAT_EQ(output[i], 1.f);
+        }
+        EXPECT_EQ(run, num_outputs);
+        ++num_outputs;
+        return Error::Ok;
+      });
+  ASSERT_EQ(err, Error::Ok);
+  EXPECT_EQ(num_outputs, kNumRuns);
+}
+
+TEST_P(PipelineTest, ErrorsStopTheRun) {
+  const Pipeline::Link links[] = {{0, 0, 0}};
+  Result<Pipeline> pipeline = Pipeline::create(stages(), links, config());
+  ASSERT_EQ(pipeline.error(), Error::Ok);
+  float output[4 * 4];
+  ASSERT_EQ(
+      stages_[1]->set_output_data_ptr(output, sizeof(output), 0), Error::Ok);
+
+  float input[2 * 4] = {};
+  int32_t sizes[2] = {2, 4};
+  TensorImpl impl(ScalarType::Float, 2, sizes, input);
+  size_t num_outputs = 0;
+  Error err = pipeline->run(
+      8,
+      [&](Method& method, size_t run) {
+        if (run == 3) {
+          return Error::Internal;
+        }
+        return method.set_input(EValue(Tensor(&impl)), 0);
+      },
+      [&](__ET_UNUSED Method& method, __ET_UNUSED size_t run) {
+        ++num_outputs;
+        return Error::Ok;
+      });
+  EXPECT_EQ(err, Error::Internal);
+  EXPECT_LE(num_outputs, 3);
+}
+
+TEST_P(PipelineTest, RejectsBadLinks) {
+  // The last stage has no next stage.
+  const Pipeline::Link from_last[] = {{1, 0, 0}};
+  EXPECT_EQ(
+      Pipeline::create(stages(), from_last, config()).error(),
+      Error::InvalidArgument);
+
+  // The method has a single input and output.
+  const Pipeline::Link missing_output[] = {{0, 1, 0}};
+  EXPECT_EQ(
+      Pipeline::create(stages(), missing_output, config()).error(),
+      Error::InvalidArgument);
+
+  const Pipeline::Link twice[] = {{0, 0, 0}, {0, 0, 0}};
+  EXPECT_EQ(
+      Pipeline::create(stages(), twice, config()).error(),
+      Error::InvalidArgument);
+
+  Pipeline::Config no_queue = config();
+  no_queue.queue_depth = 0;
+  EXPECT_EQ(
+      Pipeline::create(stages(), {}, no_queue).error(), Error::InvalidArgument);
+  EXPECT_EQ(Pipeline::create({}, {}).error(), Error::InvalidArgument);
+}
+
+INSTANTIATE_TEST_SUITE_P(Threaded, PipelineTest, testing::Values(false, true));
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/runner_util/state_pool.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/hierarchical_allocator.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/executor/memory_manager.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using exec_aten::TensorImpl;
+using torch::executor::Error;
+using torch::executor::EValue;
+using torch::executor::HierarchicalAllocator;
+using torch::executor::MemoryAllocator;
+using torch::executor::MemoryManager;
+using torch::executor::Method;
+using torch::executor::Program;
+using torch::executor::Result;
+using torch::executor::Span;
+using torch::executor::util::FileDataLoader;
+using torch::executor::util::StatePool;
+
+class StatePoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+
+    Result<FileDataLoader> loader =
+        FileDataLoader::from(std::getenv("ET_MODULE_STATEFUL_PATH"));
+    ASSERT_EQ(loader.error(), Error::Ok);
+    loader_ = std::make_unique<FileDataLoader>(std::move(loader.get()));
+    Result<Program> program = Program::load(loader_.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    program_ = std::make_unique<Program>(std::move(program.get()));
+
+    // ModuleStateful keeps its state in a planned buffer of its own.
+    auto method_meta = program_->method_meta("forward");
+    ASSERT_EQ(method_meta.error(), Error::Ok);
+    for (size_t id = 0; id < method_meta->num_memory_planned_buffers(); ++id) {
+      const size_t size = method_meta->memory_planned_buffer_size(id).get();
+      planned_buffers_.emplace_back(new uint8_t[size]);
+      planned_spans_.push_back({planned_buffers_.back().get(), size});
+    }
+    planned_memory_ = std::make_unique<HierarchicalAllocator>(
+        Span<Span<uint8_t>>(planned_spans_.data(), planned_spans_.size()));
+    method_allocator_ =
+        std::make_unique<MemoryAllocator>(sizeof(method_pool_), method_pool_);
+    memory_manager_ = std::make_unique<MemoryManager>(
+        method_allocator_.get(), planned_memory_.get());
+
+    Result<Method> method =
+        program_->load_method("forward", memory_manager_.get());
+    ASSERT_EQ(method.error(), Error::Ok);
+    method_ = std::make_unique<Method>(std::move(method.get()));
+  }
+
+  // Adds ones to the state, and returns the first element of the new state
+  // plus one.
+  float step() {
+    float input_data[4] = {1.f, 1.f, 1.f, 1.f};
+    int32_t sizes[2] = {2, 2};
+    uint8_t dim_order[2] = {0, 1};
+    int32_t strides[2] = {2, 1};
+    TensorImpl impl(
+        ScalarType::Float, 2, sizes, input_data, dim_order, strides);
+    EXPECT_EQ(method_->set_input(EValue(Tensor(&impl)), 0), Error::Ok);
+    EXPECT_EQ(method_->execute(), Error::Ok);
+    return method_->get_output(0).toTensor().const_data_ptr<float>()[0];
+  }
+
+  std::unique_ptr<FileDataLoader> loader_;
+  std::unique_ptr<Program> program_;
+  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers_;
+  std::vector<Span<uint8_t>> planned_spans_;
+  std::unique_ptr<HierarchicalAllocator> planned_memory_;
+  uint8_t method_pool_[32 * 1024];
+  std::unique_ptr<MemoryAllocator> method_allocator_;
+  std::unique_ptr<MemoryManager> memory_manager_;
+  std::unique_ptr<Method> method_;
+};
+
+TEST_F(StatePoolTest, MethodStateSurvivesAndResets) {
+  // The 2x2 float state is all that its planned buffer holds.
+  Result<size_t> state_size = method_->state_size();
+  ASSERT_EQ(state_size.error(), Error::Ok);
+  EXPECT_EQ(state_size.get(), 4 * sizeof(float));
+
+  EXPECT_FLOAT_EQ(step(), 2.f);
+  EXPECT_FLOAT_EQ(step(), 3.f);
+  ASSERT_EQ(method_->reset_state(), Error::Ok);
+  EXPECT_FLOAT_EQ(step(), 2.f);
+
+  // State moved to a buffer of the caller starts with what it holds.
+  float state[4] = {5.f, 5.f, 5.f, 5.f};
+  EXPECT_EQ(
+      method_->set_state_buffer(state, sizeof(float)),
+      Error::InvalidArgument);
+  ASSERT_EQ(method_->set_state_buffer(state, sizeof(state)), Error::Ok);
+  EXPECT_FLOAT_EQ(step(), 7.f);
+  EXPECT_FLOAT_EQ(state[3], 6.f);
+
+  // Going back to the planned buffer finds the state as it was left.
+  ASSERT_EQ(method_->set_state_buffer(nullptr, 0), Error::Ok);
+  EXPECT_FLOAT_EQ(step(), 3.f);
+  EXPECT_FLOAT_EQ(state[0], 6.f);
+}
+
+TEST_F(StatePoolTest, StreamsKeepTheirOwnState) {
+  Result<StatePool> pool = StatePool::create(method_.get(), 2);
+  ASSERT_EQ(pool.error(), Error::Ok);
+  EXPECT_EQ(pool->max_streams(), 2);
+  EXPECT_EQ(pool->state_size(), 4 * sizeof(float));
+
+  Result<size_t> a = pool->open_stream();
+  ASSERT_EQ(a.error(), Error::Ok);
+  EXPECT_FLOAT_EQ(step(), 2.f);
+  EXPECT_FLOAT_EQ(step(), 3.f);
+
+  Result<size_t> b = pool->open_stream();
+  ASSERT_EQ(b.error(), Error::Ok);
+  EXPECT_NE(a.get(), b.get());
+  EXPECT_EQ(pool->num_streams(), 2);
+  EXPECT_FLOAT_EQ(step(), 2.f);
+
+  // The pool is full.
+  EXPECT_EQ(pool->open_stream().error(), Error::MemoryAllocationFailed);
+
+  ASSERT_EQ(pool->select_stream(a.get()), Error::Ok);
+  EXPECT_FLOAT_EQ(step(), 4.f);
+  ASSERT_EQ(pool->reset_stream(a.get()), Error::Ok);
+  EXPECT_FLOAT_EQ(step(), 2.f);
+  ASSERT_EQ(pool->select_stream(b.get()), Error::Ok);
+  EXPECT_FLOAT_EQ(step(), 3.f);
+
+  // A closed slot is reused, starting from the initial state.
+  ASSERT_EQ(pool->close_stream(b.get()), Error::Ok);
+  EXPECT_EQ(pool->select_stream(b.get()), Error::InvalidArgument);
+  EXPECT_EQ(pool->close_stream(b.get()), Error::InvalidArgument);
+  Result<size_t> c = pool->open_stream();
+  ASSERT_EQ(c.error(), Error::Ok);
+  EXPECT_EQ(c.get(), b.get());
+  EXPECT_FLOAT_EQ(step(), 2.f);
+}
+
+TEST_F(StatePoolTest, DestroyingThePoolRestoresTheMethodState) {
+  EXPECT_FLOAT_EQ(step(), 2.f);
+  {
+    Result<StatePool> pool = StatePool::create(method_.get(), 1);
+    ASSERT_EQ(pool.error(), Error::Ok);
+    ASSERT_EQ(pool->open_stream().error(), Error::Ok);
+    EXPECT_FLOAT_EQ(step(), 2.f);
+  }
+  EXPECT_FLOAT_EQ(step(), 3.f);
+}
+
+TEST_F(StatePoolTest, RejectsBadArguments) {
+  EXPECT_EQ(StatePool::create(nullptr, 1).error(), Error::InvalidArgument);
+  EXPECT_EQ(
+      StatePool::create(method_.get(), 0).error(), Error::InvalidArgument);
+}
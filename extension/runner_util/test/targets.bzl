@@ -0,0 +1,60 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets(is_fbcode = False):
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # The tests use these vars to find the program files to load. This uses
+    # an fbcode target path because the authoring/export tools intentionally
+    # don't work in xplat (since they're host-only tools).
+    if not runtime.is_oss and is_fbcode:
+        modules_env = {
+            "ET_MODULE_DYNAMIC_BATCH_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleDynamicBatch.pte])",
+            "ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleDynamicCatUnallocatedIO.pte])",
+            "ET_MODULE_STATEFUL_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleStateful.pte])",
+        }
+
+        runtime.cxx_test(
+            name = "state_pool_test",
+            srcs = [
+                "state_pool_test.cpp",
+            ],
+            deps = [
+                "//executorch/extension/runner_util:state_pool",
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/kernels/portable:generated_lib",
+                "//executorch/runtime/executor/test:managed_memory_manager",
+            ],
+            env = modules_env,
+        )
+
+        runtime.cxx_test(
+            name = "pipeline_test",
+            srcs = [
+                "pipeline_test.cpp",
+            ],
+            deps = [
+                "//executorch/extension/runner_util:pipeline",
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/kernels/portable:generated_lib",
+                "//executorch/runtime/executor/test:managed_memory_manager",
+            ],
+            env = modules_env,
+        )
+
+        runtime.cxx_test(
+            name = "batch_scheduler_test",
+            srcs = [
+                "batch_scheduler_test.cpp",
+            ],
+            deps = [
+                "//executorch/extension/runner_util:batch_scheduler",
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/kernels/portable:generated_lib",
+                "//executorch/runtime/executor/test:managed_memory_manager",
+            ],
+            env = modules_env,
+        )
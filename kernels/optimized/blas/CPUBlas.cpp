@@ -7,6 +7,8 @@
  */
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/blas/GemmTuner.h>
+#include <executorch/kernels/optimized/blas/PackedGemm.h>
 
 #ifdef ET_BUILD_WITH_BLAS
 // clang-format off
@@ -18,6 +20,11 @@ extern "C" void sgemm_(char *transa, char *transb, int *m, int *n, int *k, float
 namespace executorch {
 namespace cpublas {
 
+// Builds with a BLAS never call these, but the kernels still register into
+// them.
+ET_DEFINE_DISPATCH(packed_gemm_fn<float>, packed_sgemm_stub);
+ET_DEFINE_DISPATCH(packed_gemm_fn<double>, packed_dgemm_stub);
+
 // clang-format off
 void normalize_last_dims(
     TransposeType transa, TransposeType transb,
@@ -68,6 +75,17 @@ void gemm(
       &beta_,
       c, &ldc_);
 #else
+  if (k == 0 || alpha == double(0)) {
+    scale_(m, n, beta, c, ldc);
+    return;
+  }
+  const GemmBlocking blocking =
+      get_gemm_blocking(transa, transb, m, n, k, a, lda, b, ldb);
+  if (packed_dgemm_stub(
+          transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+          blocking)) {
+    return;
+  }
   using acc_type = utils::compute_dtype<float>;
   gemm_impl(
       transa, transb,
@@ -104,6 +122,17 @@ void gemm(
       &beta_,
       c, &ldc_);
 #else
+  if (k == 0 || alpha == float(0)) {
+    scale_(m, n, beta, c, ldc);
+    return;
+  }
+  const GemmBlocking blocking =
+      get_gemm_blocking(transa, transb, m, n, k, a, lda, b, ldb);
+  if (packed_sgemm_stub(
+          transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+          blocking)) {
+    return;
+  }
   using acc_type = utils::compute_dtype<float>;
   gemm_impl(
       transa, transb,
@@ -12,6 +12,7 @@
 #include <type_traits>
 
 #include <executorch/kernels/optimized/blas/BlasKernel.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
 
 namespace executorch {
 namespace cpublas {
@@ -117,5 +118,33 @@ void gemm(
 }
 // clang-format on
 
+// Half and BFloat16 products are accumulated in float.
+// clang-format off
+template <typename T,
+          typename std::enable_if<
+              std::is_same<T, exec_aten::Half>::value ||
+                  std::is_same<T, exec_aten::BFloat16>::value,
+              int>::type = 0>
+void gemm(
+    TransposeType transa, TransposeType transb,
+    int64_t m, int64_t n, int64_t k,
+    const T alpha,
+    const T *a, int64_t lda,
+    const T *b, int64_t ldb,
+    const T beta,
+    T *c, int64_t ldc) {
+  normalize_last_dims(transa, transb, m, n, k, &lda, &ldb, &ldc);
+
+  gemm_impl(
+      transa, transb,
+      m, n, k,
+      static_cast<float>(alpha),
+      a, lda,
+      b, ldb,
+      static_cast<float>(beta),
+      c, ldc);
+}
+// clang-format on
+
 } // namespace cpublas
 } // namespace executorch
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/blas/GemmTuner.h>
+
+#include <executorch/runtime/platform/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86) || defined(__aarch64__)
+#define ET_GEMM_TUNER_CPUINFO 1
+#include <cpuinfo.h>
+#endif
+
+namespace executorch {
+namespace cpublas {
+
+namespace {
+
+using torch::executor::native::get_cpu_capability;
+
+// The blockings that tuning tries, all within the panel limits of
+// PackedGemm.h: smaller and larger op(A) blocks for L2, and deeper or
+// shallower reductions for L1.
+constexpr GemmBlocking kCandidateBlockings[] = {
+    kDefaultGemmBlocking,
+    {1, 8, 256},
+    {8, 8, 64},
+    {4, 32, 64},
+    {8, 32, 64},
+    {2, 8, 256},
+};
+
+// How often each candidate is timed, after one run that warms the caches.
+constexpr int kTimedRuns = 3;
+
+std::string compute_cpu_id() {
+  std::string id;
+#ifdef ET_GEMM_TUNER_CPUINFO
+  if (cpuinfo_initialize()) {
+    const struct cpuinfo_package* package = cpuinfo_get_package(0);
+    if (package != nullptr) {
+      id = package->name;
+    }
+    // Devices that share a package name may still differ in their cores.
+    for (uint32_t i = 0; i < cpuinfo_get_clusters_count(); ++i) {
+      char uarch[16];
+      snprintf(
+          uarch,
+          sizeof(uarch),
+          "/%x",
+          static_cast<unsigned>(cpuinfo_get_cluster(i)->uarch));
+      id += uarch;
+    }
+  }
+#endif // ET_GEMM_TUNER_CPUINFO
+  if (id.empty()) {
+    id = "unknown";
+  }
+  id += "/cap" + std::to_string(static_cast<int>(get_cpu_capability()));
+  // Tabs and newlines delimit the cache file.
+  std::replace(id.begin(), id.end(), '\t', ' ');
+  std::replace(id.begin(), id.end(), '\n', ' ');
+  return id;
+}
+
+struct TunerState {
+  std::mutex mutex;
+  std::string cache_path;
+  std::unordered_map<std::string, GemmBlocking> blockings;
+};
+
+TunerState& tuner_state() {
+  static TunerState state;
+  return state;
+}
+
+// Checked without the lock, so that gemm() costs nothing extra while tuning
+// is disabled.
+std::atomic<bool> tuning_enabled{false};
+
+std::string shape_key(
+    char dtype,
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k) {
+  char key[96];
+  snprintf(
+      key,
+      sizeof(key),
+      "%c %c%c %lld %lld %lld",
+      dtype,
+      to_blas(transa),
+      to_blas(transb),
+      static_cast<long long>(m),
+      static_cast<long long>(n),
+      static_cast<long long>(k));
+  return key;
+}
+
+// Reads the entries of this CPU from the cache file. Lines are
+// "<cpu id>\t<shape key>\t<mc_tiles> <nc_tiles> <kc>".
+bool load_cache(TunerState& state) {
+  FILE* file = fopen(state.cache_path.c_str(), "r");
+  if (file == nullptr) {
+    // Nothing tuned yet.
+    return true;
+  }
+  const std::string cpu_id = gemm_tuning_cpu_id();
+  char line[512];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    std::string entry(line);
+    const size_t tab1 = entry.find('\t');
+    const size_t tab2 =
+        tab1 == std::string::npos ? tab1 : entry.find('\t', tab1 + 1);
+    if (tab2 == std::string::npos || entry.compare(0, tab1, cpu_id) != 0) {
+      continue;
+    }
+    GemmBlocking blocking;
+    if (sscanf(
+            entry.c_str() + tab2 + 1,
+            "%d %d %d",
+            &blocking.mc_tiles,
+            &blocking.nc_tiles,
+            &blocking.kc) == 3) {
+      state.blockings[entry.substr(tab1 + 1, tab2 - tab1 - 1)] = blocking;
+    }
+  }
+  const bool ok = ferror(file) == 0;
+  fclose(file);
+  return ok;
+}
+
+void append_to_cache(
+    const TunerState& state,
+    const std::string& key,
+    const GemmBlocking& blocking) {
+  if (state.cache_path.empty()) {
+    return;
+  }
+  FILE* file = fopen(state.cache_path.c_str(), "a");
+  if (file == nullptr) {
+    ET_LOG(
+        Error, "Can't write GEMM tuning cache %s", state.cache_path.c_str());
+    return;
+  }
+  fprintf(
+      file,
+      "%s\t%s\t%d %d %d\n",
+      gemm_tuning_cpu_id(),
+      key.c_str(),
+      blocking.mc_tiles,
+      blocking.nc_tiles,
+      blocking.kc);
+  fclose(file);
+}
+
+template <typename T>
+GemmBlocking tune(
+    const ::torch::executor::native::DispatchStub<packed_gemm_fn<T>>& stub,
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const T* a,
+    int64_t lda,
+    const T* b,
+    int64_t ldb) {
+  using Clock = std::chrono::steady_clock;
+  std::vector<T> scratch(m * n);
+  GemmBlocking best = kDefaultGemmBlocking;
+  double best_seconds = std::numeric_limits<double>::infinity();
+  for (const GemmBlocking& candidate : kCandidateBlockings) {
+    double seconds = std::numeric_limits<double>::infinity();
+    for (int run = 0; run <= kTimedRuns; ++run) {
+      const auto start = Clock::now();
+      if (!stub(
+              transa,
+              transb,
+              m,
+              n,
+              k,
+              T(1),
+              a,
+              lda,
+              b,
+              ldb,
+              T(0),
+              scratch.data(),
+              m,
+              candidate)) {
+        // The shape is too small for the packed GEMM to run at all.
+        return kDefaultGemmBlocking;
+      }
+      const std::chrono::duration<double> elapsed = Clock::now() - start;
+      if (run > 0) {
+        seconds = std::min(seconds, elapsed.count());
+      }
+    }
+    if (seconds < best_seconds) {
+      best_seconds = seconds;
+      best = candidate;
+    }
+  }
+  return best;
+}
+
+template <typename T>
+GemmBlocking get_blocking(
+    const ::torch::executor::native::DispatchStub<packed_gemm_fn<T>>& stub,
+    char dtype,
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const T* a,
+    int64_t lda,
+    const T* b,
+    int64_t ldb) {
+  if (!tuning_enabled.load(std::memory_order_acquire)) {
+    return kDefaultGemmBlocking;
+  }
+  TunerState& state = tuner_state();
+  const std::string key = shape_key(dtype, transa, transb, m, n, k);
+  // Held while tuning, so that concurrent GEMMs don't skew the timings.
+  std::lock_guard<std::mutex> guard(state.mutex);
+  const auto it = state.blockings.find(key);
+  if (it != state.blockings.end()) {
+    return it->second;
+  }
+  const GemmBlocking blocking =
+      tune<T>(stub, transa, transb, m, n, k, a, lda, b, ldb);
+  state.blockings[key] = blocking;
+  append_to_cache(state, key, blocking);
+  return blocking;
+}
+
+} // namespace
+
+bool enable_gemm_tuning(const char* cache_path) {
+  TunerState& state = tuner_state();
+  std::lock_guard<std::mutex> guard(state.mutex);
+  state.blockings.clear();
+  state.cache_path = cache_path != nullptr ? cache_path : "";
+  bool ok = true;
+  if (!state.cache_path.empty()) {
+    ok = load_cache(state);
+    if (!ok) {
+      ET_LOG(Error, "Can't read GEMM tuning cache %s", cache_path);
+    }
+  }
+  tuning_enabled.store(true, std::memory_order_release);
+  return ok;
+}
+
+void disable_gemm_tuning() {
+  TunerState& state = tuner_state();
+  std::lock_guard<std::mutex> guard(state.mutex);
+  tuning_enabled.store(false, std::memory_order_release);
+  state.blockings.clear();
+  state.cache_path.clear();
+}
+
+const char* gemm_tuning_cpu_id() {
+  static const std::string id = compute_cpu_id();
+  return id.c_str();
+}
+
+GemmBlocking get_gemm_blocking(
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const float* a,
+    int64_t lda,
+    const float* b,
+    int64_t ldb) {
+  return get_blocking<float>(
+      packed_sgemm_stub, 'f', transa, transb, m, n, k, a, lda, b, ldb);
+}
+
+GemmBlocking get_gemm_blocking(
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const double* a,
+    int64_t lda,
+    const double* b,
+    int64_t ldb) {
+  return get_blocking<double>(
+      packed_dgemm_stub, 'd', transa, transb, m, n, k, a, lda, b, ldb);
+}
+
+} // namespace cpublas
+} // namespace executorch
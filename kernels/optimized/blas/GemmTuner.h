@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Optional tuning of the cache blocks of the packed GEMM (see PackedGemm.h)
+// for the CPU it runs on. The best blocks depend on the sizes of the caches,
+// which differ between devices that share an instruction set, e.g. between
+// Android SoCs. Off by default, in which case gemm() uses
+// kDefaultGemmBlocking.
+
+#include <executorch/kernels/optimized/blas/PackedGemm.h>
+
+#include <cstdint>
+
+namespace executorch {
+namespace cpublas {
+
+/**
+ * Enables tuning. The first gemm() of each shape, i.e. of each dtype,
+ * transposes, m, n and k, then times the packed GEMM with each of a few
+ * candidate blockings on scratch output, and uses the fastest one for that
+ * shape from then on. Tuning a shape costs a few dozen GEMMs of that shape.
+ *
+ * @param[in] cache_path A file to persist the results in, keyed by the
+ *     identity of the CPU (see gemm_tuning_cpu_id()), so that later processes
+ *     on the same kind of CPU skip tuning. Results for this CPU are loaded
+ *     from it, and new ones are appended. Entries for other CPUs are kept, so
+ *     that devices can share one file. May be null to only tune in memory.
+ *
+ * @returns false if `cache_path` exists but could not be read. Tuning is
+ *     enabled regardless.
+ */
+bool enable_gemm_tuning(const char* cache_path);
+
+/// Disables tuning and forgets the blockings that were tuned or loaded.
+void disable_gemm_tuning();
+
+/**
+ * Returns the string that identifies the CPU in the tuning cache: the name
+ * of the processor package, the microarchitectures of its core clusters and
+ * the CPUCapability that the GEMM micro-kernel was picked for.
+ */
+const char* gemm_tuning_cpu_id();
+
+/**
+ * Returns the blocking that gemm() should run the packed GEMM with for these
+ * arguments: kDefaultGemmBlocking, unless tuning is enabled. Tuning reads `a`
+ * and `b` but does not write any caller memory.
+ */
+GemmBlocking get_gemm_blocking(
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const float* a,
+    int64_t lda,
+    const float* b,
+    int64_t ldb);
+
+GemmBlocking get_gemm_blocking(
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const double* a,
+    int64_t lda,
+    const double* b,
+    int64_t ldb);
+
+} // namespace cpublas
+} // namespace executorch
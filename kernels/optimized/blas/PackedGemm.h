@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// The cache-blocked, packed GEMM that gemm() uses in builds without an
+// external BLAS. Its micro-kernel is sized by the vector width, so it is
+// compiled once per CPUCapability and picked at runtime; see
+// kernels/optimized/cpu/dispatch_stub.h. Its cache block sizes are chosen at
+// runtime, so that they can be tuned per CPU. The implementation lives in
+// gemm_kernels/.
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/cpu/dispatch_stub.h>
+
+#include <cstdint>
+
+namespace executorch {
+namespace cpublas {
+
+/**
+ * The cache blocks of the packed GEMM: op(A) is cut into blocks of
+ * mc_tiles micro-kernel tiles of rows by kc, and op(B) into blocks of kc by
+ * nc_tiles tiles of columns. The best sizes depend on the caches of the CPU;
+ * see GemmTuner.h.
+ *
+ * The packed panels live on the stack, so mc_tiles * kc must be at most
+ * kMaxPackedGemmTilesTimesDepth, and so must nc_tiles * kc / 4. Blockings
+ * outside these limits are replaced by kDefaultGemmBlocking.
+ */
+struct GemmBlocking {
+  int32_t mc_tiles;
+  int32_t nc_tiles;
+  int32_t kc;
+};
+
+constexpr int32_t kMaxPackedGemmTilesTimesDepth = 512;
+constexpr GemmBlocking kDefaultGemmBlocking = {4, 16, 128};
+
+/**
+ * c = alpha * op(a) @ op(b) + beta * c, for column-major matrices, with
+ * k > 0 and alpha != 0, using the given cache blocks. Returns false without
+ * touching c when m is too small for the micro-kernel of the current CPU, so
+ * that most of each tile would be padding; the caller should then use
+ * gemm_impl().
+ */
+template <typename T>
+using packed_gemm_fn = bool (*)(
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    const T* a,
+    int64_t lda,
+    const T* b,
+    int64_t ldb,
+    T beta,
+    T* c,
+    int64_t ldc,
+    const GemmBlocking& blocking);
+
+ET_DECLARE_DISPATCH(packed_gemm_fn<float>, packed_sgemm_stub);
+ET_DECLARE_DISPATCH(packed_gemm_fn<double>, packed_dgemm_stub);
+
+} // namespace cpublas
+} // namespace executorch
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <executorch/kernels/optimized/blas/PackedGemm.h>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#include <algorithm>
+
+namespace executorch {
+namespace cpublas {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+/*
+ * A cache-blocked GEMM over packed panels, for builds without an external
+ * BLAS. op(A) is cut into mc x kc blocks and op(B) into kc x nc blocks, which
+ * are each copied into contiguous panels: op(A) in slivers of kMR rows and
+ * op(B) in slivers of kNR columns. A micro-kernel then computes each kMR x kNR
+ * tile of C in registers, reading both panels sequentially. Packing also
+ * takes care of the transposes, so the micro-kernel only has one form.
+ */
+template <typename T>
+struct PackedGemm {
+  using Vec = vec::Vectorized<T>;
+
+  // Rows and columns of the C tile that the micro-kernel keeps in registers.
+  static constexpr int64_t kMR = 2 * Vec::size();
+  static constexpr int64_t kNR = 4;
+
+  // Sizes of the packed panels, which live on the stack. The block sizes are
+  // chosen at runtime within them; by default a panel of op(B) stays in L1
+  // and a panel of op(A) in L2.
+  static constexpr int64_t kAPanelSize = kMaxPackedGemmTilesTimesDepth * kMR;
+  static constexpr int64_t kBPanelSize =
+      kMaxPackedGemmTilesTimesDepth * 4 * kNR;
+
+  // Copies op(A)[i0:i0+mc, p0:p0+kc] into slivers of kMR rows, padding the
+  // last one with zeros.
+  static void pack_a(
+      TransposeType trans,
+      const T* a,
+      int64_t lda,
+      int64_t i0,
+      int64_t p0,
+      int64_t mc,
+      int64_t kc,
+      T* packed) {
+    for (int64_t is = 0; is < mc; is += kMR) {
+      const int64_t mr = std::min(kMR, mc - is);
+      for (int64_t p = 0; p < kc; ++p) {
+        for (int64_t r = 0; r < mr; ++r) {
+          const int64_t i = i0 + is + r;
+          const int64_t l = p0 + p;
+          packed[p * kMR + r] = trans == TransposeType::NoTranspose
+              ? a[i + l * lda]
+              : a[l + i * lda];
+        }
+        for (int64_t r = mr; r < kMR; ++r) {
+          packed[p * kMR + r] = T(0);
+        }
+      }
+      packed += kMR * kc;
+    }
+  }
+
+  // Copies op(B)[p0:p0+kc, j0:j0+nc] into slivers of kNR columns, padding the
+  // last one with zeros.
+  static void pack_b(
+      TransposeType trans,
+      const T* b,
+      int64_t ldb,
+      int64_t p0,
+      int64_t j0,
+      int64_t kc,
+      int64_t nc,
+      T* packed) {
+    for (int64_t js = 0; js < nc; js += kNR) {
+      const int64_t nr = std::min(kNR, nc - js);
+      for (int64_t p = 0; p < kc; ++p) {
+        for (int64_t c = 0; c < nr; ++c) {
+          const int64_t j = j0 + js + c;
+          const int64_t l = p0 + p;
+          packed[p * kNR + c] = trans == TransposeType::NoTranspose
+              ? b[l + j * ldb]
+              : b[j + l * ldb];
+        }
+        for (int64_t c = nr; c < kNR; ++c) {
+          packed[p * kNR + c] = T(0);
+        }
+      }
+      packed += kNR * kc;
+    }
+  }
+
+  // c[0:mr, 0:nr] = alpha * (a_panel @ b_panel) + beta * c[0:mr, 0:nr]. Does
+  // not read c when beta is zero.
+  static void micro_kernel(
+      int64_t kc,
+      const T* a_panel,
+      const T* b_panel,
+      T alpha,
+      T beta,
+      T* c,
+      int64_t ldc,
+      int64_t mr,
+      int64_t nr) {
+    Vec acc[kNR][2];
+    for (int64_t j = 0; j < kNR; ++j) {
+      acc[j][0] = Vec(T(0));
+      acc[j][1] = Vec(T(0));
+    }
+    for (int64_t p = 0; p < kc; ++p) {
+      const Vec a0 = Vec::loadu(a_panel + p * kMR);
+      const Vec a1 = Vec::loadu(a_panel + p * kMR + Vec::size());
+      for (int64_t j = 0; j < kNR; ++j) {
+        const Vec bj(b_panel[p * kNR + j]);
+        acc[j][0] = vec::fmadd(a0, bj, acc[j][0]);
+        acc[j][1] = vec::fmadd(a1, bj, acc[j][1]);
+      }
+    }
+
+    const Vec alpha_vec(alpha);
+    if (mr == kMR) {
+      const Vec beta_vec(beta);
+      for (int64_t j = 0; j < nr; ++j) {
+        T* c_col = c + j * ldc;
+        for (int64_t h = 0; h < 2; ++h) {
+          Vec result = acc[j][h] * alpha_vec;
+          if (beta != T(0)) {
+            result = vec::fmadd(
+                Vec::loadu(c_col + h * Vec::size()), beta_vec, result);
+          }
+          result.store(c_col + h * Vec::size());
+        }
+      }
+      return;
+    }
+    __at_align__ T tile[kNR][kMR];
+    for (int64_t j = 0; j < nr; ++j) {
+      (acc[j][0] * alpha_vec).store(tile[j]);
+      (acc[j][1] * alpha_vec).store(tile[j] + Vec::size());
+      T* c_col = c + j * ldc;
+      for (int64_t i = 0; i < mr; ++i) {
+        c_col[i] = beta == T(0) ? tile[j][i] : beta * c_col[i] + tile[j][i];
+      }
+    }
+  }
+
+  static void run(
+      TransposeType transa,
+      TransposeType transb,
+      int64_t m,
+      int64_t n,
+      int64_t k,
+      T alpha,
+      const T* a,
+      int64_t lda,
+      const T* b,
+      int64_t ldb,
+      T beta,
+      T* c,
+      int64_t ldc,
+      int64_t mc_block,
+      int64_t nc_block,
+      int64_t kc_block) {
+    __at_align__ T a_packed[kAPanelSize];
+    __at_align__ T b_packed[kBPanelSize];
+    for (int64_t j0 = 0; j0 < n; j0 += nc_block) {
+      const int64_t nc = std::min(nc_block, n - j0);
+      for (int64_t p0 = 0; p0 < k; p0 += kc_block) {
+        const int64_t kc = std::min(kc_block, k - p0);
+        // Later blocks of the reduction accumulate into C.
+        const T beta_block = p0 == 0 ? beta : T(1);
+        pack_b(transb, b, ldb, p0, j0, kc, nc, b_packed);
+        for (int64_t i0 = 0; i0 < m; i0 += mc_block) {
+          const int64_t mc = std::min(mc_block, m - i0);
+          pack_a(transa, a, lda, i0, p0, mc, kc, a_packed);
+          for (int64_t js = 0; js < nc; js += kNR) {
+            for (int64_t is = 0; is < mc; is += kMR) {
+              micro_kernel(
+                  kc,
+                  a_packed + is * kc,
+                  b_packed + js * kc,
+                  alpha,
+                  beta_block,
+                  c + (i0 + is) + (j0 + js) * ldc,
+                  ldc,
+                  std::min(kMR, mc - is),
+                  std::min(kNR, nc - js));
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+template <typename T>
+bool packed_gemm(
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    const T* a,
+    int64_t lda,
+    const T* b,
+    int64_t ldb,
+    T beta,
+    T* c,
+    int64_t ldc,
+    const GemmBlocking& blocking) {
+  using Gemm = PackedGemm<T>;
+  // Below this many rows of C, most of each micro-kernel tile would be
+  // padding.
+  if (m < Gemm::kMR / 2) {
+    return false;
+  }
+  const bool fits = blocking.mc_tiles > 0 && blocking.nc_tiles > 0 &&
+      blocking.kc > 0 &&
+      blocking.mc_tiles * blocking.kc <= kMaxPackedGemmTilesTimesDepth &&
+      blocking.nc_tiles * blocking.kc <= 4 * kMaxPackedGemmTilesTimesDepth;
+  const GemmBlocking& sizes = fits ? blocking : kDefaultGemmBlocking;
+  Gemm::run(
+      transa,
+      transb,
+      m,
+      n,
+      k,
+      alpha,
+      a,
+      lda,
+      b,
+      ldb,
+      beta,
+      c,
+      ldc,
+      sizes.mc_tiles * Gemm::kMR,
+      sizes.nc_tiles * Gemm::kNR,
+      sizes.kc);
+  return true;
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(packed_sgemm_stub, &packed_gemm<float>);
+ET_REGISTER_DISPATCH(packed_dgemm_stub, &packed_gemm<double>);
+
+} // namespace cpublas
+} // namespace executorch
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/dispatch_stub.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define ET_DISPATCH_X86 1
+#include <cpuinfo.h>
+#elif defined(__aarch64__)
+#define ET_DISPATCH_ARM64 1
+#include <cpuinfo.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+CPUCapability compute_cpu_capability() {
+#ifdef ET_DISPATCH_X86
+  if (cpuinfo_initialize()) {
+    // The AVX512 kernels are built with -mavx512{f,bw,dq,vl} and -mfma.
+    if (cpuinfo_has_x86_avx512f() && cpuinfo_has_x86_avx512bw() &&
+        cpuinfo_has_x86_avx512dq() && cpuinfo_has_x86_avx512vl() &&
+        cpuinfo_has_x86_fma3()) {
+      return CPUCapability::AVX512;
+    }
+    // The AVX2 kernels are built with -mavx2, -mfma and -mf16c.
+    if (cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3() &&
+        cpuinfo_has_x86_f16c()) {
+      return CPUCapability::AVX2;
+    }
+  }
+#endif // ET_DISPATCH_X86
+#ifdef ET_DISPATCH_ARM64
+  if (cpuinfo_initialize()) {
+    // The SVE256 kernels are built with -msve-vector-bits=256, so they are
+    // only correct on CPUs whose vectors are exactly that long.
+    if (cpuinfo_has_arm_sve() && cpuinfo_get_max_arm_sve_length() == 256) {
+      return CPUCapability::SVE256;
+    }
+  }
+#endif // ET_DISPATCH_ARM64
+  return CPUCapability::DEFAULT;
+}
+
+} // namespace
+
+CPUCapability get_cpu_capability() {
+  static const CPUCapability capability = compute_cpu_capability();
+  return capability;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
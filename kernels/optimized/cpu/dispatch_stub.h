@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Runtime CPU dispatch for optimized kernels, modeled on ATen's DispatchStub.
+//
+// A kernel that wants to use the widest vector instructions the CPU offers is
+// split in two. The operator itself, compiled once with the baseline flags,
+// calls a DispatchStub. The vectorized body lives in a separate source that is
+// compiled once per CPUCapability, with -DCPU_CAPABILITY=<name> and
+// -DCPU_CAPABILITY_<name> plus the matching -m flags, and that registers
+// itself into the stub with ET_REGISTER_DISPATCH. Since the variants only
+// differ in their CPU_CAPABILITY inline namespace, everything they define must
+// live in that namespace or in an anonymous one.
+
+#include <executorch/runtime/platform/assert.h>
+
+#include <utility>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * The instruction sets kernels can be compiled for. DEFAULT uses the flags of
+ * the platform; AVX2 and AVX512 are only built for x86, and SVE256 only for
+ * aarch64.
+ */
+enum class CPUCapability {
+  DEFAULT = 0,
+  AVX2 = 1,
+  AVX512 = 2,
+  SVE256 = 3,
+};
+
+/**
+ * Returns the most capable CPUCapability that the current CPU supports. It is
+ * detected with cpuinfo on the first call and cached; it is always DEFAULT on
+ * architectures other than x86 and aarch64.
+ */
+CPUCapability get_cpu_capability();
+
+/**
+ * Holds one implementation of a kernel per CPUCapability, and calls the most
+ * capable one that both the CPU supports and the build registered.
+ *
+ * A stub must be a namespace-scope variable (see ET_DEFINE_DISPATCH), so that
+ * it is constant-initialized before the static initializers that register its
+ * implementations run.
+ */
+template <typename FnPtr>
+struct DispatchStub {
+  using FnPtrType = FnPtr;
+
+  FnPtr default_impl = nullptr;
+  FnPtr avx2_impl = nullptr;
+  FnPtr avx512_impl = nullptr;
+  FnPtr sve256_impl = nullptr;
+
+  constexpr DispatchStub() = default;
+
+  DispatchStub(const DispatchStub&) = delete;
+  DispatchStub& operator=(const DispatchStub&) = delete;
+
+  template <typename... Args>
+  auto operator()(Args&&... args) const {
+    return choose(get_cpu_capability())(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Returns the implementation to use on a CPU with `capability`, falling back
+   * to less capable implementations when the better ones were not built.
+   */
+  FnPtr choose(CPUCapability capability) const {
+    if (capability == CPUCapability::SVE256 && sve256_impl != nullptr) {
+      return sve256_impl;
+    }
+    if (capability == CPUCapability::AVX512 && avx512_impl != nullptr) {
+      return avx512_impl;
+    }
+    if ((capability == CPUCapability::AVX512 ||
+         capability == CPUCapability::AVX2) &&
+        avx2_impl != nullptr) {
+      return avx2_impl;
+    }
+    ET_CHECK_MSG(
+        default_impl != nullptr,
+        "No DEFAULT kernel registered; is the kernel library linked whole?");
+    return default_impl;
+  }
+
+  void set(CPUCapability capability, FnPtr fn) {
+    switch (capability) {
+      case CPUCapability::DEFAULT:
+        default_impl = fn;
+        break;
+      case CPUCapability::AVX2:
+        avx2_impl = fn;
+        break;
+      case CPUCapability::AVX512:
+        avx512_impl = fn;
+        break;
+      case CPUCapability::SVE256:
+        sve256_impl = fn;
+        break;
+    }
+  }
+};
+
+template <typename Stub>
+struct DispatchRegisterer {
+  DispatchRegisterer(
+      Stub& stub,
+      CPUCapability capability,
+      typename Stub::FnPtrType fn) {
+    stub.set(capability, fn);
+  }
+};
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+// The CPUCapability that the current translation unit is compiled for.
+#if defined(CPU_CAPABILITY_AVX512)
+#define ET_CPU_CAPABILITY_VALUE \
+  ::torch::executor::native::CPUCapability::AVX512
+#elif defined(CPU_CAPABILITY_AVX2)
+#define ET_CPU_CAPABILITY_VALUE ::torch::executor::native::CPUCapability::AVX2
+#elif defined(CPU_CAPABILITY_SVE256)
+#define ET_CPU_CAPABILITY_VALUE \
+  ::torch::executor::native::CPUCapability::SVE256
+#else
+#define ET_CPU_CAPABILITY_VALUE \
+  ::torch::executor::native::CPUCapability::DEFAULT
+#endif
+
+/// Declares a stub, usually in a header shared by the operator and kernel.
+#define ET_DECLARE_DISPATCH(fn_type, name) \
+  extern ::torch::executor::native::DispatchStub<fn_type> name
+
+/// Defines a stub declared with ET_DECLARE_DISPATCH, in exactly one source
+/// that is compiled once.
+#define ET_DEFINE_DISPATCH(fn_type, name) \
+  ::torch::executor::native::DispatchStub<fn_type> name
+
+/// Registers `fn` as the implementation of the stub `name` for the
+/// CPUCapability that the current translation unit is compiled for.
+#define ET_REGISTER_DISPATCH(name, fn)                                  \
+  static ::torch::executor::native::DispatchRegisterer<decltype(name)> \
+      name##_registerer(name, ET_CPU_CAPABILITY_VALUE, fn)
@@ -22,6 +22,10 @@ namespace torch {
 namespace executor {
 namespace native {
 
+// Wrapped like the vec library, since the per-CPUCapability kernels in
+// vec_kernels/ each instantiate these with their own Vectorized types.
+inline namespace CPU_CAPABILITY {
+
 template <typename T>
 using acc_t = executorch::utils::compute_dtype<T>;
 
@@ -186,6 +190,7 @@ RowwiseMoments(const T* X, int64_t N, int64_t ddof = 0) {
   }
 }
 
+} // namespace CPU_CAPABILITY
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -37,46 +38,39 @@ Tensor& opt_add_out(
     auto error = resize_tensor(out, a.sizes());
     ET_CHECK_MSG(error == Error::Ok, "Failed to resize output tensor.");
 
-    ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "add", CTYPE, [&]() {
-      CTYPE alpha_val;
-      ET_EXTRACT_SCALAR(alpha, alpha_val);
-
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
-    });
+    add_stub(
+        out_type,
+        out.mutable_data_ptr(),
+        a.const_data_ptr(),
+        b.const_data_ptr(),
+        alpha,
+        out.numel());
   } else {
     ScalarType common_type = promoteTypes(a_type, b_type);
     ET_CHECK(canCast(common_type, out_type));
 
     resize_to_broadcast_target_size(a, b, out);
 
-    ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "add", CTYPE_A, [&]() {
-      ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "add", CTYPE_B, [&]() {
-        ET_SWITCH_REAL_TYPES_AND(
-            Bool, common_type, ctx, "add", CTYPE_IN, [&]() {
-              ET_SWITCH_REAL_TYPES_AND(
-                  Bool, out_type, ctx, "add", CTYPE_OUT, [&]() {
-                    CTYPE_IN alpha_val;
-                    ET_EXTRACT_SCALAR(alpha, alpha_val);
-
-                    apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
-                        [alpha_val](const CTYPE_A val_a, const CTYPE_B val_b) {
-                          CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
-                          CTYPE_IN b_casted = static_cast<CTYPE_IN>(val_b);
-                          CTYPE_IN value = a_casted + alpha_val * b_casted;
-
-                          return static_cast<CTYPE_OUT>(value);
-                        },
-                        a,
-                        b,
-                        out);
-                  });
-            });
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "add", CTYPE_A, [&]() {
+      ET_SWITCH_REALHBBF16_TYPES(b_type, ctx, "add", CTYPE_B, [&]() {
+        ET_SWITCH_REALHBBF16_TYPES(common_type, ctx, "add", CTYPE_IN, [&]() {
+          ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "add", CTYPE_OUT, [&]() {
+            CTYPE_IN alpha_val;
+            ET_EXTRACT_SCALAR(alpha, alpha_val);
+
+            apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
+                [alpha_val](const CTYPE_A val_a, const CTYPE_B val_b) {
+                  CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
+                  CTYPE_IN b_casted = static_cast<CTYPE_IN>(val_b);
+                  CTYPE_IN value = a_casted + alpha_val * b_casted;
+
+                  return static_cast<CTYPE_OUT>(value);
+                },
+                a,
+                b,
+                out);
+          });
+        });
       });
     });
   }
@@ -104,7 +98,7 @@ Tensor& opt_add_scalar_out(
   ET_CHECK_MSG(error == Error::Ok, "Failed to resize output tensor.");
 
   if (a_type == common_type && a_type == out_type) {
-    ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "add", CTYPE, [&]() {
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "add", CTYPE, [&]() {
       ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "add", CTYPE_B, [&]() {
         CTYPE_B b_val;
         ET_EXTRACT_SCALAR(b, b_val);
@@ -123,28 +117,25 @@ Tensor& opt_add_scalar_out(
       });
     });
   } else {
-    ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "add", CTYPE_A, [&]() {
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "add", CTYPE_A, [&]() {
       ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "add", CTYPE_B, [&]() {
-        ET_SWITCH_REAL_TYPES_AND(
-            Bool, common_type, ctx, "add", CTYPE_IN, [&]() {
-              ET_SWITCH_REAL_TYPES_AND(
-                  Bool, out_type, ctx, "add", CTYPE_OUT, [&]() {
-                    CTYPE_B b_val;
-                    ET_EXTRACT_SCALAR(b, b_val);
-                    CTYPE_IN b_casted = static_cast<CTYPE_IN>(b_val);
-                    CTYPE_IN alpha_val;
-                    ET_EXTRACT_SCALAR(alpha, alpha_val);
-
-                    const size_t n = a.numel();
-                    const CTYPE_A* a_data = a.const_data_ptr<CTYPE_A>();
-                    CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
-                    for (auto i = 0; i < n; ++i) {
-                      out_data[i] = static_cast<CTYPE_OUT>(
-                          static_cast<CTYPE_IN>(a_data[i]) +
-                          alpha_val * b_casted);
-                    }
-                  });
-            });
+        ET_SWITCH_REALHBBF16_TYPES(common_type, ctx, "add", CTYPE_IN, [&]() {
+          ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "add", CTYPE_OUT, [&]() {
+            CTYPE_B b_val;
+            ET_EXTRACT_SCALAR(b, b_val);
+            CTYPE_IN b_casted = static_cast<CTYPE_IN>(b_val);
+            CTYPE_IN alpha_val;
+            ET_EXTRACT_SCALAR(alpha, alpha_val);
+
+            const size_t n = a.numel();
+            const CTYPE_A* a_data = a.const_data_ptr<CTYPE_A>();
+            CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
+            for (auto i = 0; i < n; ++i) {
+              out_data[i] = static_cast<CTYPE_OUT>(
+                  static_cast<CTYPE_IN>(a_data[i]) + alpha_val * b_casted);
+            }
+          });
+        });
       });
     });
   }
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/portable/cpu/scalar_utils.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
+#include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using Scalar = exec_aten::Scalar;
+using ScalarType = exec_aten::ScalarType;
+
+// addmm.out(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1,
+//     Scalar alpha=1, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_addmm_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    const Scalar& beta,
+    const Scalar& alpha,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_addmm_args(in, mat1, mat2, beta, alpha, out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_mm_out_target_size(mat1, mat2, output_sizes, &output_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_broadcastable_to(in, out), InvalidArgument, out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  ScalarType alpha_dtype = utils::get_scalar_dtype(alpha);
+  ScalarType beta_dtype = utils::get_scalar_dtype(beta);
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, "addmm", CTYPE, [&]() {
+    ET_SWITCH_SCALAR_OBJ_TYPES(alpha_dtype, ctx, "addmm", ALPHA_T, [&]() {
+      ET_SWITCH_SCALAR_OBJ_TYPES(beta_dtype, ctx, "addmm", BETA_T, [&]() {
+        using executorch::cpublas::TransposeType;
+
+        const int64_t m = mat1.size(0);
+        const int64_t n = mat1.size(1);
+        const int64_t p = mat2.size(1);
+        const CTYPE alpha_val = convert<CTYPE>(alpha.to<ALPHA_T>());
+        const CTYPE beta_val = convert<CTYPE>(beta.to<BETA_T>());
+
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+        const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+        const CTYPE* mat1_data = mat1.const_data_ptr<CTYPE>();
+        const CTYPE* mat2_data = mat2.const_data_ptr<CTYPE>();
+
+        // `in` broadcasts to [m, p] from at most two dims, each of which is
+        // either full or 1.
+        const int64_t in_rows = in.dim() == 2 ? in.size(0) : 1;
+        const int64_t in_cols = in.dim() >= 1 ? in.size(in.dim() - 1) : 1;
+        const int64_t in_row_stride = in_rows > 1 ? in_cols : 0;
+        const int64_t in_col_stride = in_cols > 1 ? 1 : 0;
+
+        // Each chunk of rows of `out` only depends on the same rows of `in`
+        // and `mat1`.
+        parallel_for(
+            0, m, parallel_grain_size(n * p), [&](int64_t begin, int64_t end) {
+              // As in ATen, a zero beta ignores `in`, even its NaNs.
+              if (beta_val != static_cast<CTYPE>(0)) {
+                for (int64_t i = begin; i < end; ++i) {
+                  const CTYPE* in_row = in_data + i * in_row_stride;
+                  CTYPE* out_row = out_data + i * p;
+                  for (int64_t j = 0; j < p; ++j) {
+                    out_row[j] = in_row[j * in_col_stride];
+                  }
+                }
+              }
+              // gemm() is column-major, so it computes
+              // out^T = alpha * mat2^T @ mat1^T + beta * out^T.
+              // clang-format off
+              executorch::cpublas::gemm(
+                  TransposeType::NoTranspose, TransposeType::NoTranspose,
+                  p, end - begin, n,
+                  alpha_val,
+                  mat2_data, p,
+                  mat1_data + begin * n, n,
+                  beta_val,
+                  out_data + begin * p, p);
+              // clang-format on
+            });
+      });
+    });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
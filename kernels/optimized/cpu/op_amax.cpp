@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/platform/assert.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+void check_preconditions(
+    const Tensor& in,
+    const ArrayRef<int64_t>& dim_list,
+    bool keepdim,
+    Tensor& out) {
+  ET_CHECK_SAME_DTYPE2(in, out);
+  check_dim_list_is_valid(in, dim_list);
+  if (in.dim() != 0) {
+    for (const auto& d : dim_list) {
+      ET_CHECK_NON_ZERO_DIM_SIZE(d, in);
+    }
+  }
+  ET_CHECK_MSG(
+      out.dim() == compute_reduced_out_dim(in, dim_list, keepdim),
+      "Number of dims of out tensor is not compatible with inputs and params");
+  ET_CHECK_DEFAULT_OR_CHANNELSLAST_DIMORDER(in);
+  ET_CHECK_DEFAULT_OR_CHANNELSLAST_DIMORDER(out);
+}
+
+bool can_use_vec_kernels(const Tensor& in, const Tensor& out) {
+  return in.scalar_type() == out.scalar_type() &&
+      (in.scalar_type() == ScalarType::Float ||
+       in.scalar_type() == ScalarType::Double);
+}
+
+} // namespace
+
+Tensor& opt_amax_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    ArrayRef<int64_t> dim_list,
+    bool keepdim,
+    Tensor& out) {
+  (void)ctx;
+
+  check_preconditions(in, dim_list, keepdim, out);
+
+  Error e = resize_reduction_out(in, dim_list, keepdim, out);
+  ET_CHECK_MSG(e == Error::Ok, "Failed to resize out tensor in amax_out");
+
+  // Fast path: contiguous floating point tensors go through the vectorized
+  // kernel for the current CPU.
+  ReducePlan plan;
+  if (can_use_vec_kernels(in, out) &&
+      make_reduce_plan(in, dim_list, out, &plan)) {
+    parallel_for(
+        0,
+        plan.out_numel,
+        parallel_grain_size(plan.reduce_numel),
+        [&](int64_t begin, int64_t end) {
+          amax_stub(
+              out.scalar_type(),
+              in.const_data_ptr(),
+              out.mutable_data_ptr(),
+              plan,
+              begin,
+              end);
+        });
+    return out;
+  }
+
+  ET_SWITCH_REAL_TYPES_AND(Bool, in.scalar_type(), ctx, "amax", CTYPE, [&]() {
+    CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+    parallel_for_each_reduce_over_dim_list_output_index(
+        in, dim_list, out, [&](const size_t out_ix) {
+          out_data[out_ix] = reduce_over_dim_list<CTYPE>(
+              [](CTYPE v, CTYPE max_v) {
+                return std::isnan(v) || v > max_v ? v : max_v;
+              },
+              in,
+              dim_list,
+              out_ix);
+        });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
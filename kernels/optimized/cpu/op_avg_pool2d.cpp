@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/cpu/pool_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// Average pooling that walks raw pointers instead of computing the linear
+// index of every tap. Channels-last tensors add each window tap to all of a
+// pixel's channels at once; other tensors are pooled one row of a plane at a
+// time, adding each tap to every output of the row whose window is entirely
+// in bounds, so the inner loop runs along the width.
+//
+// Either way, each output sums its taps in row-major order before dividing,
+// in the input type, like the portable kernel.
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+
+namespace {
+
+struct AvgPoolDivisor {
+  bool count_include_pad;
+  exec_aten::optional<int64_t> divisor_override;
+
+  // The divisor of a window that starts at (y0, x0) and has the given
+  // in-bounds taps.
+  int64_t get(
+      const Pool2dGeometry& g,
+      const int64_t y0,
+      const int64_t x0,
+      const int64_t taps_h,
+      const int64_t taps_w) const {
+    if (divisor_override.has_value()) {
+      return divisor_override.value();
+    }
+    if (count_include_pad) {
+      // Padding counts, but not the part of the window past the padding.
+      return (std::min(y0 + g.kernel_h, g.in_h + g.pad_h) - y0) *
+          (std::min(x0 + g.kernel_w, g.in_w + g.pad_w) - x0);
+    }
+    return taps_h * taps_w;
+  }
+};
+
+template <typename CTYPE>
+void avg_pool2d_planes(
+    const Pool2dGeometry& g,
+    const AvgPoolDivisor& divisor,
+    const CTYPE* const in_ptr,
+    CTYPE* const out_ptr) {
+  const int64_t rows = g.batches * g.channels * g.out_h;
+  // The row-wise sums need a contiguous output row.
+  int64_t ox_begin = 0;
+  int64_t ox_end = 0;
+  if (g.out_strides[3] == 1) {
+    get_pool_interior(
+        g.out_w,
+        g.in_w,
+        g.kernel_w,
+        g.stride_w,
+        g.pad_w,
+        g.dilation_w,
+        &ox_begin,
+        &ox_end);
+  }
+  const int64_t in_step = g.stride_w * g.in_strides[3];
+
+  parallel_for(
+      0,
+      rows,
+      parallel_grain_size(g.out_w * g.kernel_h * g.kernel_w),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t r = begin; r < end; ++r) {
+          const int64_t oy = r % g.out_h;
+          const int64_t c = (r / g.out_h) % g.channels;
+          const int64_t n = r / (g.out_h * g.channels);
+          const CTYPE* const in_plane =
+              in_ptr + n * g.in_strides[0] + c * g.in_strides[1];
+          CTYPE* const out_row = out_ptr + n * g.out_strides[0] +
+              c * g.out_strides[1] + oy * g.out_strides[2];
+
+          const int64_t y0 = oy * g.stride_h - g.pad_h;
+          int64_t ky_begin = 0;
+          int64_t ky_end = 0;
+          clip_pool_window(
+              y0, g.in_h, g.kernel_h, g.dilation_h, &ky_begin, &ky_end);
+
+          // Outputs whose windows are in bounds along the width.
+          CTYPE* const interior = out_row + ox_begin;
+          const int64_t num_interior = ox_end - ox_begin;
+          std::fill(interior, interior + num_interior, static_cast<CTYPE>(0));
+          for (int64_t ky = ky_begin; ky < ky_end; ++ky) {
+            const int64_t iy = y0 + ky * g.dilation_h;
+            for (int64_t kx = 0; kx < g.kernel_w; ++kx) {
+              const int64_t ix =
+                  ox_begin * g.stride_w - g.pad_w + kx * g.dilation_w;
+              const CTYPE* const in =
+                  in_plane + iy * g.in_strides[2] + ix * g.in_strides[3];
+              if (in_step == 1) {
+                for (int64_t i = 0; i < num_interior; ++i) {
+                  interior[i] += in[i];
+                }
+              } else {
+                for (int64_t i = 0; i < num_interior; ++i) {
+                  interior[i] += in[i * in_step];
+                }
+              }
+            }
+          }
+          if (num_interior > 0 && ky_end > ky_begin) {
+            const CTYPE d = static_cast<CTYPE>(divisor.get(
+                g,
+                y0,
+                ox_begin * g.stride_w - g.pad_w,
+                ky_end - ky_begin,
+                g.kernel_w));
+            for (int64_t i = 0; i < num_interior; ++i) {
+              interior[i] = interior[i] / d;
+            }
+          }
+
+          // The rest are clipped one at a time.
+          for (int64_t ox = 0; ox < g.out_w; ++ox) {
+            if (ox == ox_begin && ox_end > ox_begin) {
+              ox = ox_end - 1;
+              continue;
+            }
+            const int64_t x0 = ox * g.stride_w - g.pad_w;
+            int64_t kx_begin = 0;
+            int64_t kx_end = 0;
+            clip_pool_window(
+                x0, g.in_w, g.kernel_w, g.dilation_w, &kx_begin, &kx_end);
+            CTYPE sum = 0;
+            for (int64_t ky = ky_begin; ky < ky_end; ++ky) {
+              const CTYPE* const in_row =
+                  in_plane + (y0 + ky * g.dilation_h) * g.in_strides[2];
+              for (int64_t kx = kx_begin; kx < kx_end; ++kx) {
+                sum += in_row[(x0 + kx * g.dilation_w) * g.in_strides[3]];
+              }
+            }
+            const int64_t taps = (ky_end - ky_begin) * (kx_end - kx_begin);
+            out_row[ox * g.out_strides[3]] = taps == 0
+                ? static_cast<CTYPE>(0)
+                : sum /
+                    static_cast<CTYPE>(divisor.get(
+                        g, y0, x0, ky_end - ky_begin, kx_end - kx_begin));
+          }
+        }
+      });
+}
+
+// Input and output are channels-last, so each window tap is a contiguous
+// vector of channels that adds to a contiguous vector of sums.
+template <typename CTYPE>
+void avg_pool2d_channels_last(
+    const Pool2dGeometry& g,
+    const AvgPoolDivisor& divisor,
+    const CTYPE* const in_ptr,
+    CTYPE* const out_ptr) {
+  const int64_t pixels = g.batches * g.out_h * g.out_w;
+  const int64_t C = g.channels;
+
+  parallel_for(
+      0,
+      pixels,
+      parallel_grain_size(C * g.kernel_h * g.kernel_w),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t p = begin; p < end; ++p) {
+          const int64_t ox = p % g.out_w;
+          const int64_t oy = (p / g.out_w) % g.out_h;
+          const int64_t n = p / (g.out_w * g.out_h);
+          CTYPE* const out = out_ptr + n * g.out_strides[0] +
+              oy * g.out_strides[2] + ox * g.out_strides[3];
+
+          const int64_t y0 = oy * g.stride_h - g.pad_h;
+          const int64_t x0 = ox * g.stride_w - g.pad_w;
+          int64_t ky_begin = 0;
+          int64_t ky_end = 0;
+          int64_t kx_begin = 0;
+          int64_t kx_end = 0;
+          clip_pool_window(
+              y0, g.in_h, g.kernel_h, g.dilation_h, &ky_begin, &ky_end);
+          clip_pool_window(
+              x0, g.in_w, g.kernel_w, g.dilation_w, &kx_begin, &kx_end);
+
+          std::fill(out, out + C, static_cast<CTYPE>(0));
+          if (ky_begin == ky_end || kx_begin == kx_end) {
+            continue;
+          }
+          for (int64_t ky = ky_begin; ky < ky_end; ++ky) {
+            const int64_t iy = y0 + ky * g.dilation_h;
+            for (int64_t kx = kx_begin; kx < kx_end; ++kx) {
+              const int64_t ix = x0 + kx * g.dilation_w;
+              const CTYPE* const in = in_ptr + n * g.in_strides[0] +
+                  iy * g.in_strides[2] + ix * g.in_strides[3];
+              for (int64_t ch = 0; ch < C; ++ch) {
+                out[ch] += in[ch];
+              }
+            }
+          }
+          const CTYPE d = static_cast<CTYPE>(divisor.get(
+              g, y0, x0, ky_end - ky_begin, kx_end - kx_begin));
+          for (int64_t ch = 0; ch < C; ++ch) {
+            out[ch] = out[ch] / d;
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_avg_pool2d_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    exec_aten::optional<int64_t> divisor_override,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_avg_pool2d_args(
+          in,
+          kernel_size,
+          stride,
+          padding,
+          ceil_mode,
+          count_include_pad,
+          divisor_override,
+          out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_avg_pool2d_out_target_size(
+      in, kernel_size, stride, padding, ceil_mode, output_sizes, &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const Pool2dGeometry g = get_pool2d_geometry(
+      in, out, kernel_size, stride, padding, /*dilation=*/{});
+  const AvgPoolDivisor divisor{count_include_pad, divisor_override};
+  const bool channels_last =
+      g.in_strides[1] == 1 && g.out_strides[1] == 1 && g.channels > 1;
+
+  ScalarType in_type = in.scalar_type();
+  ET_SWITCH_FLOAT_TYPES_AND(Long, in_type, ctx, __func__, CTYPE, [&]() {
+    const CTYPE* const in_ptr = in.const_data_ptr<CTYPE>();
+    CTYPE* const out_ptr = out.mutable_data_ptr<CTYPE>();
+    if (channels_last) {
+      avg_pool2d_channels_last<CTYPE>(g, divisor, in_ptr, out_ptr);
+    } else {
+      avg_pool2d_planes<CTYPE>(g, divisor, in_ptr, out_ptr);
+    }
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -147,6 +147,8 @@ Tensor& opt_bmm_out(
   auto scalar_type = self.scalar_type();
   switch (scalar_type) {
     ET_FORALL_REAL_TYPES(BMM_TENSOR)
+    BMM_TENSOR(exec_aten::Half, Half)
+    BMM_TENSOR(exec_aten::BFloat16, BFloat16)
     default:
       ET_CHECK_MSG(
           false, "Unhandled dtype %" PRId8, static_cast<int8_t>(scalar_type));
@@ -0,0 +1,545 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// Computes a convolution as GEMMs between the weights and im2col columns of
+// the input. The columns are built one tile of output pixels at a time, in
+// scratch from the temp allocator, so that they stay in cache while the GEMM
+// reads them and tiles can be computed in parallel.
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+
+namespace {
+
+// Bytes of im2col columns that a task fills before multiplying them.
+constexpr int64_t kColumnTileBytes = 64 * 1024;
+
+// Fewest output pixels in a tile, so that each GEMM does enough work.
+constexpr int64_t kMinTilePixels = 16;
+
+// Most column tiles allocated at once, which bounds the scratch memory and
+// the number of tasks that run in parallel.
+constexpr int64_t kMaxColumnTiles = 8;
+
+int64_t divup(int64_t x, int64_t y) {
+  return (x + y - 1) / y;
+}
+
+/**
+ * The geometry of a 2D convolution; a 1D convolution is viewed as a 2D one of
+ * height 1. Strides are in elements and in (N, C, H, W) order, whatever the
+ * dim order of the tensor.
+ */
+struct ConvGeometry {
+  int64_t batches;
+  int64_t in_c;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_c;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  int64_t groups;
+  int64_t in_strides[4];
+  int64_t weight_strides[4];
+  int64_t out_strides[4];
+
+  int64_t in_c_per_group() const {
+    return in_c / groups;
+  }
+  int64_t out_c_per_group() const {
+    return out_c / groups;
+  }
+  /// The rows of the im2col matrix, which the GEMM reduces over.
+  int64_t col_rows() const {
+    return in_c_per_group() * kernel_h * kernel_w;
+  }
+  int64_t out_pixels() const {
+    return out_h * out_w;
+  }
+};
+
+/// Writes the (N, C, H, W) sizes and strides of `t`, with a height of 1 for
+/// 3-D tensors.
+void get_nchw_view(const Tensor& t, int64_t sizes[4], int64_t strides[4]) {
+  exec_aten::StridesType t_strides[kTensorDimensionLimit];
+  dim_order_to_stride_nocheck(
+      t.sizes().data(), t.dim_order().data(), t.dim(), t_strides);
+  if (t.dim() == 3) {
+    sizes[0] = t.size(0);
+    sizes[1] = t.size(1);
+    sizes[2] = 1;
+    sizes[3] = t.size(2);
+    strides[0] = t_strides[0];
+    strides[1] = t_strides[1];
+    strides[2] = 0;
+    strides[3] = t_strides[2];
+  } else {
+    for (size_t i = 0; i < 4; ++i) {
+      sizes[i] = t.size(i);
+      strides[i] = t_strides[i];
+    }
+  }
+}
+
+ConvGeometry get_conv_geometry(
+    const Tensor& in,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    const Tensor& out) {
+  ConvGeometry g;
+  int64_t sizes[4];
+  get_nchw_view(in, sizes, g.in_strides);
+  g.batches = sizes[0];
+  g.in_c = sizes[1];
+  g.in_h = sizes[2];
+  g.in_w = sizes[3];
+  get_nchw_view(weight, sizes, g.weight_strides);
+  g.kernel_h = sizes[2];
+  g.kernel_w = sizes[3];
+  get_nchw_view(out, sizes, g.out_strides);
+  g.out_c = sizes[1];
+  g.out_h = sizes[2];
+  g.out_w = sizes[3];
+  if (in.dim() == 3) {
+    g.stride_h = 1;
+    g.stride_w = val_at(stride, 0);
+    g.pad_h = 0;
+    g.pad_w = val_at(padding, 0, /*default_value=*/0);
+    g.dilation_h = 1;
+    g.dilation_w = val_at(dilation, 0, /*default_value=*/1);
+  } else {
+    g.stride_h = val_at(stride, 0);
+    g.stride_w = val_at(stride, 1);
+    g.pad_h = val_at(padding, 0, /*default_value=*/0);
+    g.pad_w = val_at(padding, 1, /*default_value=*/0);
+    g.dilation_h = val_at(dilation, 0, /*default_value=*/1);
+    g.dilation_w = val_at(dilation, 1, /*default_value=*/1);
+  }
+  g.groups = groups;
+  return g;
+}
+
+/**
+ * A K x P matrix over the input, with a row for each (in channel, kernel y,
+ * kernel x) of a group and a column for each output pixel of a tile. Element
+ * (k, p) is at `data[k * ld + p]`, or at `data[p * ld + k]` if `transposed`.
+ */
+template <typename CTYPE>
+struct Columns {
+  const CTYPE* data;
+  int64_t ld;
+  bool transposed;
+};
+
+/// Fills `col` with the im2col columns of the `num_pixels` output pixels from
+/// `pixel_begin` of one (batch, group), laid out as `Columns{col, ...}`.
+template <typename CTYPE>
+void im2col_tile(
+    const CTYPE* in,
+    const ConvGeometry& g,
+    int64_t batch,
+    int64_t group,
+    int64_t pixel_begin,
+    int64_t num_pixels,
+    bool transposed,
+    CTYPE* col) {
+  const int64_t row_stride = transposed ? 1 : num_pixels;
+  const int64_t pixel_stride = transposed ? g.col_rows() : 1;
+  const CTYPE* in_group = in + batch * g.in_strides[0] +
+      group * g.in_c_per_group() * g.in_strides[1];
+  int64_t row = 0;
+  for (int64_t ic = 0; ic < g.in_c_per_group(); ++ic) {
+    const CTYPE* in_c = in_group + ic * g.in_strides[1];
+    for (int64_t ky = 0; ky < g.kernel_h; ++ky) {
+      for (int64_t kx = 0; kx < g.kernel_w; ++kx, ++row) {
+        CTYPE* col_row = col + row * row_stride;
+        int64_t oy = pixel_begin / g.out_w;
+        int64_t ox = pixel_begin % g.out_w;
+        for (int64_t p = 0; p < num_pixels; ++p) {
+          const int64_t iy = oy * g.stride_h - g.pad_h + ky * g.dilation_h;
+          const int64_t ix = ox * g.stride_w - g.pad_w + kx * g.dilation_w;
+          col_row[p * pixel_stride] =
+              (iy >= 0 && iy < g.in_h && ix >= 0 && ix < g.in_w)
+              ? in_c[iy * g.in_strides[2] + ix * g.in_strides[3]]
+              : static_cast<CTYPE>(0);
+          if (++ox == g.out_w) {
+            ox = 0;
+            ++oy;
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Computes the output channels of `group` for `num_pixels` output pixels from
+ * `pixel_begin` as one GEMM between `weight`, a contiguous [out_c][col_rows]
+ * matrix, and `cols`.
+ */
+template <typename CTYPE, typename CTYPE_BIAS>
+void conv_tile_gemm(
+    const Columns<CTYPE>& cols,
+    const CTYPE* weight,
+    const CTYPE_BIAS* bias,
+    const ConvGeometry& g,
+    bool out_channels_last,
+    int64_t batch,
+    int64_t group,
+    int64_t pixel_begin,
+    int64_t num_pixels,
+    CTYPE* out) {
+  using executorch::cpublas::TransposeType;
+
+  const int64_t K = g.col_rows();
+  const int64_t out_c_per_group = g.out_c_per_group();
+  const CTYPE* w_group = weight + group * out_c_per_group * K;
+  CTYPE* out_tile = out + batch * g.out_strides[0] +
+      group * out_c_per_group * g.out_strides[1] +
+      pixel_begin * (out_channels_last ? g.out_strides[3] : 1);
+
+  CTYPE beta = static_cast<CTYPE>(0);
+  if (bias != nullptr) {
+    const CTYPE_BIAS* b_group = bias + group * out_c_per_group;
+    for (int64_t oc = 0; oc < out_c_per_group; ++oc) {
+      const CTYPE value = static_cast<CTYPE>(b_group[oc]);
+      for (int64_t p = 0; p < num_pixels; ++p) {
+        out_tile[oc * g.out_strides[1] + p * g.out_strides[3]] = value;
+      }
+    }
+    beta = static_cast<CTYPE>(1);
+  }
+
+  // gemm() takes column-major matrices.
+  if (out_channels_last) {
+    // out[p][oc] = sum_k weight[oc][k] * cols(k, p)
+    // clang-format off
+    executorch::cpublas::gemm(
+        TransposeType::Transpose,
+        cols.transposed ? TransposeType::NoTranspose : TransposeType::Transpose,
+        out_c_per_group, num_pixels, K,
+        static_cast<CTYPE>(1),
+        w_group, K,
+        cols.data, cols.ld,
+        beta,
+        out_tile, g.out_strides[3]);
+    // clang-format on
+  } else {
+    // out[oc][p] = sum_k cols(k, p) * weight[oc][k]
+    // clang-format off
+    executorch::cpublas::gemm(
+        cols.transposed ? TransposeType::Transpose : TransposeType::NoTranspose,
+        TransposeType::NoTranspose,
+        num_pixels, out_c_per_group, K,
+        static_cast<CTYPE>(1),
+        cols.data, cols.ld,
+        w_group, K,
+        beta,
+        out_tile, g.out_strides[1]);
+    // clang-format on
+  }
+}
+
+/// Computes the same outputs as conv_tile_gemm() straight from strided
+/// tensors, for when there is no scratch memory for columns or weights.
+template <typename CTYPE, typename CTYPE_BIAS>
+void conv_tile_direct(
+    const CTYPE* in,
+    const CTYPE* weight,
+    const CTYPE_BIAS* bias,
+    const ConvGeometry& g,
+    int64_t batch,
+    int64_t group,
+    int64_t pixel_begin,
+    int64_t num_pixels,
+    CTYPE* out) {
+  const int64_t in_c_per_group = g.in_c_per_group();
+  const int64_t out_c_per_group = g.out_c_per_group();
+  const CTYPE* in_group = in + batch * g.in_strides[0] +
+      group * in_c_per_group * g.in_strides[1];
+  for (int64_t p = pixel_begin; p < pixel_begin + num_pixels; ++p) {
+    const int64_t oy = p / g.out_w;
+    const int64_t ox = p % g.out_w;
+    for (int64_t oc = group * out_c_per_group;
+         oc < (group + 1) * out_c_per_group;
+         ++oc) {
+      CTYPE accum = bias != nullptr ? static_cast<CTYPE>(bias[oc])
+                                    : static_cast<CTYPE>(0);
+      const CTYPE* w_oc = weight + oc * g.weight_strides[0];
+      for (int64_t ic = 0; ic < in_c_per_group; ++ic) {
+        for (int64_t ky = 0; ky < g.kernel_h; ++ky) {
+          const int64_t iy = oy * g.stride_h - g.pad_h + ky * g.dilation_h;
+          if (iy < 0 || iy >= g.in_h) {
+            continue;
+          }
+          for (int64_t kx = 0; kx < g.kernel_w; ++kx) {
+            const int64_t ix = ox * g.stride_w - g.pad_w + kx * g.dilation_w;
+            if (ix < 0 || ix >= g.in_w) {
+              continue;
+            }
+            accum += in_group
+                         [ic * g.in_strides[1] + iy * g.in_strides[2] +
+                          ix * g.in_strides[3]] *
+                w_oc
+                    [ic * g.weight_strides[1] + ky * g.weight_strides[2] +
+                     kx * g.weight_strides[3]];
+          }
+        }
+      }
+      out
+          [batch * g.out_strides[0] + oc * g.out_strides[1] +
+           oy * g.out_strides[2] + ox * g.out_strides[3]] = accum;
+    }
+  }
+}
+
+template <typename CTYPE, typename CTYPE_BIAS>
+void convolution(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    const ConvGeometry& g,
+    Tensor& out) {
+  const CTYPE* const in_ptr = in.const_data_ptr<CTYPE>();
+  const CTYPE* const w_ptr = weight.const_data_ptr<CTYPE>();
+  const CTYPE_BIAS* const bias_ptr =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE_BIAS>() : nullptr;
+  CTYPE* const out_ptr = out.mutable_data_ptr<CTYPE>();
+
+  const bool in_default = is_default_dim_order(
+      in.dim_order().data(), in.dim_order().size());
+  const bool out_channels_last = !is_default_dim_order(
+      out.dim_order().data(), out.dim_order().size());
+  const bool pack_weight = !is_default_dim_order(
+      weight.dim_order().data(), weight.dim_order().size());
+  // A pointwise convolution reads its columns straight from the input, as
+  // long as each pixel's channels or each channel's pixels are contiguous.
+  const bool pointwise = g.kernel_h == 1 && g.kernel_w == 1 &&
+      g.stride_h == 1 && g.stride_w == 1 && g.pad_h == 0 && g.pad_w == 0;
+
+  const int64_t K = g.col_rows();
+  const int64_t num_pixels = g.out_pixels();
+  const int64_t tile_pixels = std::min(
+      num_pixels,
+      std::max<int64_t>(
+          kMinTilePixels,
+          kColumnTileBytes / static_cast<int64_t>(K * sizeof(CTYPE))));
+  const int64_t tiles_per_plane = divup(num_pixels, tile_pixels);
+  const int64_t num_tiles = g.batches * g.groups * tiles_per_plane;
+  const int64_t grain_size = std::max(
+      parallel_grain_size(g.out_c_per_group() * K * tile_pixels),
+      divup(num_tiles, kMaxColumnTiles));
+  const int64_t num_column_tiles = pointwise ? 0 : divup(num_tiles, grain_size);
+
+  const size_t column_tile_size = K * tile_pixels;
+  const size_t scratch_size = num_column_tiles * column_tile_size +
+      (pack_weight ? g.out_c * K : 0);
+  CTYPE* scratch = nullptr;
+  if (scratch_size > 0) {
+    Result<void*> temp = ctx.allocate_temp(scratch_size * sizeof(CTYPE));
+    if (temp.ok()) {
+      scratch = static_cast<CTYPE*>(temp.get());
+    } else {
+      ET_LOG(
+          Debug,
+          "No %zu bytes of temp memory for convolution; running it directly",
+          scratch_size * sizeof(CTYPE));
+    }
+  }
+
+  if (scratch_size > 0 && scratch == nullptr) {
+    parallel_for(
+        0,
+        num_tiles,
+        parallel_grain_size(g.out_c_per_group() * K * tile_pixels),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t t = begin; t < end; ++t) {
+            const int64_t plane = t / tiles_per_plane;
+            const int64_t pixel_begin = (t % tiles_per_plane) * tile_pixels;
+            conv_tile_direct<CTYPE, CTYPE_BIAS>(
+                in_ptr,
+                w_ptr,
+                bias_ptr,
+                g,
+                plane / g.groups,
+                plane % g.groups,
+                pixel_begin,
+                std::min(tile_pixels, num_pixels - pixel_begin),
+                out_ptr);
+          }
+        });
+    return;
+  }
+
+  const CTYPE* packed_weight = w_ptr;
+  if (pack_weight) {
+    CTYPE* dst = scratch + num_column_tiles * column_tile_size;
+    packed_weight = dst;
+    for (int64_t oc = 0; oc < g.out_c; ++oc) {
+      for (int64_t ic = 0; ic < g.in_c_per_group(); ++ic) {
+        for (int64_t ky = 0; ky < g.kernel_h; ++ky) {
+          for (int64_t kx = 0; kx < g.kernel_w; ++kx) {
+            *dst++ = w_ptr
+                [oc * g.weight_strides[0] + ic * g.weight_strides[1] +
+                 ky * g.weight_strides[2] + kx * g.weight_strides[3]];
+          }
+        }
+      }
+    }
+  }
+
+  // Every chunk but the last has at least grain_size tiles, so no two chunks
+  // start in the same multiple of grain_size, and each can claim the column
+  // tile at that index.
+  parallel_for(0, num_tiles, grain_size, [&](int64_t begin, int64_t end) {
+    CTYPE* const col = pointwise
+        ? nullptr
+        : scratch + (begin / grain_size) * column_tile_size;
+    for (int64_t t = begin; t < end; ++t) {
+      const int64_t plane = t / tiles_per_plane;
+      const int64_t batch = plane / g.groups;
+      const int64_t group = plane % g.groups;
+      const int64_t pixel_begin = (t % tiles_per_plane) * tile_pixels;
+      const int64_t tile_size = std::min(tile_pixels, num_pixels - pixel_begin);
+
+      Columns<CTYPE> cols;
+      if (pointwise) {
+        // The input pixels are the output pixels.
+        const CTYPE* in_group = in_ptr + batch * g.in_strides[0] +
+            group * g.in_c_per_group() * g.in_strides[1];
+        if (in_default) {
+          cols = {in_group + pixel_begin, g.in_strides[1], false};
+        } else {
+          cols = {
+              in_group + pixel_begin * g.in_strides[3], g.in_strides[3], true};
+        }
+      } else {
+        // Match the layout of the output, so that the GEMM reads the columns
+        // along its reduction.
+        im2col_tile(
+            in_ptr,
+            g,
+            batch,
+            group,
+            pixel_begin,
+            tile_size,
+            out_channels_last,
+            col);
+        cols = {col, out_channels_last ? K : tile_size, out_channels_last};
+      }
+      conv_tile_gemm<CTYPE, CTYPE_BIAS>(
+          cols,
+          packed_weight,
+          bias_ptr,
+          g,
+          out_channels_last,
+          batch,
+          group,
+          pixel_begin,
+          tile_size,
+          out_ptr);
+    }
+  });
+}
+
+} // namespace
+
+Tensor& opt_convolution_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_args(
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      in, weight, stride, padding, dilation, output_sizes, &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, in.dim() - 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const ConvGeometry g =
+      get_conv_geometry(in, weight, stride, padding, dilation, groups, out);
+
+  ScalarType in_type = in.scalar_type();
+  ScalarType bias_type = in_type;
+  if (bias.has_value()) {
+    bias_type = bias.value().scalar_type();
+  }
+  ET_SWITCH_REAL_TYPES(in_type, ctx, "convolution", CTYPE, [&]() {
+    ET_SWITCH_REAL_TYPES_AND(
+        Bool, bias_type, ctx, "convolution", CTYPE_BIAS, [&]() {
+          convolution<CTYPE, CTYPE_BIAS>(ctx, in, weight, bias, g, out);
+        });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/kernels/optimized/cpu/unary_ufunc_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+Tensor& opt_cos_out(RuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  return opt_unary_ufunc_realb_to_float(cos_stub, std::cos, ctx, in, out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
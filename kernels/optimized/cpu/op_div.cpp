@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -53,40 +54,35 @@ Tensor& opt_div_out(
     auto error = resize_tensor(out, a.sizes());
     ET_CHECK_MSG(error == Error::Ok, "Failed to resize output tensor.");
 
-    ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "div", CTYPE, [&]() {
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [](Vec x, Vec y) { return x / y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
-    });
+    div_stub(
+        out_type,
+        out.mutable_data_ptr(),
+        a.const_data_ptr(),
+        b.const_data_ptr(),
+        out.numel());
   } else {
     ScalarType common_type = get_compute_type(a_type, b_type);
     ET_CHECK(canCast(common_type, out_type));
 
     resize_to_broadcast_target_size(a, b, out);
 
-    ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "div", CTYPE_A, [&]() {
-      ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "div", CTYPE_B, [&]() {
-        ET_SWITCH_REAL_TYPES_AND(
-            Bool, common_type, ctx, "div", CTYPE_IN, [&]() {
-              ET_SWITCH_REAL_TYPES_AND(
-                  Bool, out_type, ctx, "div", CTYPE_OUT, [&]() {
-                    apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
-                        [](const CTYPE_A val_a, const CTYPE_B val_b) {
-                          CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
-                          CTYPE_IN b_casted = static_cast<CTYPE_IN>(val_b);
-                          CTYPE_IN value = a_casted / b_casted;
-
-                          return static_cast<CTYPE_OUT>(value);
-                        },
-                        a,
-                        b,
-                        out);
-                  });
-            });
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "div", CTYPE_A, [&]() {
+      ET_SWITCH_REALHBBF16_TYPES(b_type, ctx, "div", CTYPE_B, [&]() {
+        ET_SWITCH_REALHBBF16_TYPES(common_type, ctx, "div", CTYPE_IN, [&]() {
+          ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "div", CTYPE_OUT, [&]() {
+            apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
+                [](const CTYPE_A val_a, const CTYPE_B val_b) {
+                  CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
+                  CTYPE_IN b_casted = static_cast<CTYPE_IN>(val_b);
+                  CTYPE_IN value = a_casted / b_casted;
+
+                  return static_cast<CTYPE_OUT>(value);
+                },
+                a,
+                b,
+                out);
+          });
+        });
       });
     });
   }
@@ -113,7 +109,7 @@ Tensor& opt_div_scalar_out(
   ET_CHECK_MSG(error == Error::Ok, "Failed to resize output tensor.");
 
   if (a_type == common_type && a_type == out_type) {
-    ET_SWITCH_REAL_TYPES(a_type, ctx, "div", CTYPE, [&]() {
+    ET_SWITCH_REALHBF16_TYPES(a_type, ctx, "div", CTYPE, [&]() {
       ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "div", CTYPE_B, [&]() {
         CTYPE_B b_val;
         ET_EXTRACT_SCALAR(b, b_val);
@@ -128,10 +124,10 @@ Tensor& opt_div_scalar_out(
       });
     });
   } else {
-    ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "div", CTYPE_A, [&]() {
+    ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "div", CTYPE_A, [&]() {
       ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "div", CTYPE_B, [&]() {
-        ET_SWITCH_REAL_TYPES(common_type, ctx, "div", CTYPE_IN, [&]() {
-          ET_SWITCH_REAL_TYPES(out_type, ctx, "div", CTYPE_OUT, [&]() {
+        ET_SWITCH_REALHBF16_TYPES(common_type, ctx, "div", CTYPE_IN, [&]() {
+          ET_SWITCH_REALHBF16_TYPES(out_type, ctx, "div", CTYPE_OUT, [&]() {
             CTYPE_B b_val;
             ET_EXTRACT_SCALAR(b, b_val);
             CTYPE_IN b_casted = static_cast<CTYPE_IN>(b_val);
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+// The instructions of a fused_elementwise program. Keep in sync with
+// exir/passes/fuse_elementwise_pass.py.
+enum Opcode : int64_t {
+  LOAD_INPUT = 0,
+  LOAD_CONST = 1,
+  ADD = 2,
+  SUB = 3,
+  MUL = 4,
+  DIV = 5,
+  MAXIMUM = 6,
+  MINIMUM = 7,
+  NEG = 8,
+  RELU = 9,
+  EXP = 10,
+  SIGMOID = 11,
+  TANH = 12,
+};
+
+constexpr size_t kMaxStackDepth = 8;
+constexpr size_t kMaxInputs = 64;
+
+// The number of elements that each instruction processes at a time. Small
+// enough that the stack stays in L1, large enough to amortize the dispatch.
+constexpr int64_t kBlockSize = 256;
+
+bool is_binary(int64_t opcode) {
+  return opcode >= ADD && opcode <= MINIMUM;
+}
+
+bool is_unary(int64_t opcode) {
+  return opcode >= NEG && opcode <= TANH;
+}
+
+// Checks that the program only reads valid operands, never under- or
+// overflows the stack, and leaves exactly one value on it.
+bool check_code(
+    exec_aten::ArrayRef<int64_t> code,
+    size_t num_inputs,
+    size_t num_constants) {
+  size_t depth = 0;
+  for (size_t pc = 0; pc < code.size(); ++pc) {
+    const int64_t opcode = code[pc];
+    if (opcode == LOAD_INPUT || opcode == LOAD_CONST) {
+      const size_t limit = opcode == LOAD_INPUT ? num_inputs : num_constants;
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          pc + 1 < code.size() && code[pc + 1] >= 0 &&
+              static_cast<size_t>(code[pc + 1]) < limit,
+          "Invalid operand at %zu",
+          pc);
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          depth < kMaxStackDepth, "Stack overflow at %zu", pc);
+      depth++;
+      pc++;
+    } else if (is_binary(opcode)) {
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(depth >= 2, "Stack underflow at %zu", pc);
+      depth--;
+    } else if (is_unary(opcode)) {
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(depth >= 1, "Stack underflow at %zu", pc);
+    } else {
+      ET_LOG(Error, "Unknown opcode %" PRId64 " at %zu", opcode, pc);
+      return false;
+    }
+  }
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      depth == 1, "Code leaves %zu values on the stack", depth);
+  return true;
+}
+
+// Runs the program on the elements [begin, end) of the inputs. Each stack
+// slot points either straight into an input, or into its own buffer once an
+// instruction has written to it, so loading an input costs nothing.
+void run_code(
+    exec_aten::ArrayRef<int64_t> code,
+    const float* const* inputs,
+    exec_aten::ArrayRef<double> constants,
+    float* out,
+    int64_t begin,
+    int64_t end) {
+  using Vec = executorch::vec::Vectorized<float>;
+  alignas(64) float buffers[kMaxStackDepth][kBlockSize];
+  const float* stack[kMaxStackDepth];
+
+  for (int64_t block = begin; block < end; block += kBlockSize) {
+    const int64_t n = std::min(kBlockSize, end - block);
+    size_t top = 0;
+    for (size_t pc = 0; pc < code.size(); ++pc) {
+      const int64_t opcode = code[pc];
+      if (opcode == LOAD_INPUT) {
+        stack[top++] = inputs[code[++pc]] + block;
+        continue;
+      }
+      if (opcode == LOAD_CONST) {
+        const float value = static_cast<float>(constants[code[++pc]]);
+        std::fill(buffers[top], buffers[top] + n, value);
+        stack[top] = buffers[top];
+        top++;
+        continue;
+      }
+      const float* b = nullptr;
+      if (is_binary(opcode)) {
+        b = stack[--top];
+      }
+      float* dst = buffers[top - 1];
+      const float* a = stack[top - 1];
+      switch (opcode) {
+        case ADD:
+          executorch::vec::map2<float>(
+              [](Vec x, Vec y) { return x + y; }, dst, a, b, n);
+          break;
+        case SUB:
+          executorch::vec::map2<float>(
+              [](Vec x, Vec y) { return x - y; }, dst, a, b, n);
+          break;
+        case MUL:
+          executorch::vec::map2<float>(
+              [](Vec x, Vec y) { return x * y; }, dst, a, b, n);
+          break;
+        case DIV:
+          executorch::vec::map2<float>(
+              [](Vec x, Vec y) { return x / y; }, dst, a, b, n);
+          break;
+        case MAXIMUM:
+          executorch::vec::map2<float>(
+              [](Vec x, Vec y) { return executorch::vec::maximum(x, y); },
+              dst,
+              a,
+              b,
+              n);
+          break;
+        case MINIMUM:
+          executorch::vec::map2<float>(
+              [](Vec x, Vec y) { return executorch::vec::minimum(x, y); },
+              dst,
+              a,
+              b,
+              n);
+          break;
+        case NEG:
+          executorch::vec::map<float>([](Vec x) { return x.neg(); }, dst, a, n);
+          break;
+        case RELU:
+          executorch::vec::map<float>(
+              [](Vec x) { return executorch::vec::maximum(x, Vec(0)); },
+              dst,
+              a,
+              n);
+          break;
+        case EXP:
+          executorch::vec::map<float>([](Vec x) { return x.exp(); }, dst, a, n);
+          break;
+        case SIGMOID:
+          executorch::vec::map<float>(
+              [](Vec x) { return Vec(1) / (Vec(1) + x.neg().exp()); },
+              dst,
+              a,
+              n);
+          break;
+        case TANH:
+          executorch::vec::map<float>(
+              [](Vec x) { return x.tanh(); }, dst, a, n);
+          break;
+        default:
+          // Rejected by check_code()
+          break;
+      }
+      stack[top - 1] = dst;
+    }
+    std::copy(stack[0], stack[0] + n, out + block);
+  }
+}
+
+} // namespace
+
+// fused_elementwise.out(Tensor[] inputs, int[] code, float[] constants, *,
+//     Tensor(a!) out) -> Tensor(a!)
+//
+// Computes each element of out by running `code`, a stack machine program
+// emitted by FuseElementwisePass, on the elements at the same index of the
+// inputs, which are contiguous float tensors of the same shape.
+Tensor& opt_fused_elementwise_out(
+    RuntimeContext& ctx,
+    exec_aten::ArrayRef<Tensor> inputs,
+    exec_aten::ArrayRef<int64_t> code,
+    exec_aten::ArrayRef<double> constants,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      inputs.size() > 0 && inputs.size() <= kMaxInputs,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      check_code(code, inputs.size(), constants.size()),
+      InvalidArgument,
+      out);
+  for (const Tensor& input : inputs) {
+    ET_KERNEL_CHECK(
+        ctx,
+        input.scalar_type() == ScalarType::Float &&
+            input.sizes().equals(inputs[0].sizes()),
+        InvalidArgument,
+        out);
+  }
+  ET_KERNEL_CHECK(
+      ctx, out.scalar_type() == ScalarType::Float, InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, inputs[0].sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const float* input_data[kMaxInputs];
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    input_data[i] = inputs[i].const_data_ptr<float>();
+  }
+  float* out_data = out.mutable_data_ptr<float>();
+
+  parallel_for(
+      0,
+      out.numel(),
+      std::max(kBlockSize, parallel_grain_size(code.size())),
+      [&](int64_t begin, int64_t end) {
+        run_code(code, input_data, constants, out_data, begin, end);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -6,14 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#ifdef __aarch64__
-#include <arm_neon.h>
-#include <sleef.h>
-#endif
-
-#include <cmath>
-
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <executorch/runtime/platform/assert.h>
 
 namespace torch {
@@ -32,58 +27,14 @@ namespace {
  * 'approximate' specifies the method used to approximation the Gelu function
  *  either 'none' to not approximate or 'tanh'
  *
- * Assumes that the tensors are contiguous, are the same shape, and have the
- * same dtype. CTYPE should be the C type (like `float` or `double`) that
- * matches the dtype of the tensors.
+ * Assumes that the tensors are contiguous, are the same shape, and are float.
  */
-template <typename CTYPE>
 void gelu(const Tensor& input, string_view approximate, Tensor& output) {
-  const CTYPE* in_data = input.data_ptr<CTYPE>();
-  CTYPE* out_data = output.data_ptr<CTYPE>();
-  size_t lim = input.numel();
-
-  // TODO: Add fast path for tanh using sleef's tanh
+  bool approximate_tanh = false;
   if (approximate == "tanh") {
-    // 0.5 * x * (1 + Tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))
-    for (size_t i = 0; i < lim; ++i) {
-      const CTYPE x = in_data[i];
-      const CTYPE kBeta = M_SQRT2 * M_2_SQRTPI * 0.5;
-      const CTYPE kKappa = 0.044715;
-      auto x_cube = x * x * x;
-      auto inner = kBeta * (x + kKappa * x_cube);
-      out_data[i] = CTYPE(0.5) * x * (CTYPE(1) + std::tanh(inner));
-    }
-  } else if (approximate == "none") { // dont appx
-    // GELU(x) = x * Φ(x) where Φ(x) is the is the Cumulative Distribution
-    // Function for Gaussian Distribution.
-
-#ifndef __aarch64__
-    for (size_t i = 0; i < lim; ++i) {
-      const CTYPE x = in_data[i];
-      out_data[i] = CTYPE(0.5) * x * (CTYPE(1) + std::erf(x * M_SQRT1_2));
-    }
-#else
-    size_t i = 0;
-    if (std::is_same<CTYPE, float>::value) {
-      for (; i + 4 < lim; i += 4) {
-        const float32x4_t in =
-            vld1q_f32(static_cast<const float*>(&in_data[i]));
-        const float32x4_t m_sqrt1_2x4 = {
-            M_SQRT1_2, M_SQRT1_2, M_SQRT1_2, M_SQRT1_2};
-        const float32x4_t ones = vmovq_n_f32(1.0);
-        const float32x4_t halves = vmovq_n_f32(0.5);
-        float32x4_t out = Sleef_erff4_u10(vmulq_f32(in, m_sqrt1_2x4));
-        vst1q_f32(
-            static_cast<float*>(&out_data[i]),
-            vmulq_f32(vmulq_f32(vaddq_f32(out, ones), in), halves));
-      }
-    }
-    for (; i < lim; ++i) {
-      const CTYPE x = in_data[i];
-      out_data[i] = CTYPE(0.5) * x * (CTYPE(1) + std::erf(x * M_SQRT1_2));
-    }
-#endif // __aarch64__
-
+    approximate_tanh = true;
+  } else if (approximate == "none") {
+    approximate_tanh = false;
   } else {
     ET_CHECK_MSG(
         false,
@@ -91,6 +42,16 @@ void gelu(const Tensor& input, string_view approximate, Tensor& output) {
         static_cast<int>(approximate.length()),
         approximate.data());
   }
+  const float* const in_data = input.const_data_ptr<float>();
+  float* const out_data = output.mutable_data_ptr<float>();
+  parallel_for(
+      0,
+      input.numel(),
+      parallel_grain_size(1),
+      [&](int64_t begin, int64_t end) {
+        gelu_stub(
+            in_data + begin, out_data + begin, end - begin, approximate_tanh);
+      });
 }
 
 } // namespace
@@ -110,22 +71,17 @@ Tensor& opt_gelu_out(
   (void)context;
   ET_CHECK_SAME_SHAPE_AND_DTYPE2(input, out);
 
-// helper for generating the cases for different data types
-#define GELU(ctype, dtype)                \
-  case ScalarType::dtype:                 \
-    gelu<ctype>(input, approximate, out); \
-    break;
-
   switch (input.scalar_type()) {
     // TODO support Double as well
-    GELU(float, Float)
+    case ScalarType::Float:
+      gelu(input, approximate, out);
+      break;
     default:
       ET_CHECK_MSG(
           false,
           "Unhandled dtype %" PRId8,
           static_cast<int8_t>(input.scalar_type()));
   }
-#undef GELU
 
   return out;
 }
@@ -6,8 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <executorch/kernels/optimized/vec/functional.h>
-#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
@@ -37,15 +36,12 @@ Tensor& opt_le_tensor_out(
   ScalarType out_type = out.scalar_type();
 
   if (a_type == b_type && a_type == out_type) {
-    ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "le", CTYPE, [&]() {
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [](Vec x, Vec y) { return x.le(y); },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          a.numel());
-    });
+    le_stub(
+        out_type,
+        out.mutable_data_ptr(),
+        a.const_data_ptr(),
+        b.const_data_ptr(),
+        a.numel());
   } else {
     ScalarType common_type = promoteTypes(a_type, b_type);
     ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "le", CTYPE_A, [&]() {
@@ -87,19 +83,8 @@ Tensor& opt_le_scalar_out(
   ScalarType out_type = out.scalar_type();
 
   if (a_type == common_type && a_type == out_type) {
-    ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "le", CTYPE, [&]() {
-      ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "le", CTYPE_B, [&]() {
-        CTYPE_B b_val = 0;
-        ET_EXTRACT_SCALAR(b, b_val);
-        CTYPE b_casted = static_cast<CTYPE>(b_val);
-        using Vec = executorch::vec::Vectorized<CTYPE>;
-        executorch::vec::map<CTYPE>(
-            [b_casted](Vec x) { return x.le(Vec(b_casted)); },
-            out.mutable_data_ptr<CTYPE>(),
-            a.const_data_ptr<CTYPE>(),
-            a.numel());
-      });
-    });
+    le_scalar_stub(
+        a_type, out.mutable_data_ptr(), a.const_data_ptr(), b, a.numel());
   } else {
     ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "le", CTYPE_A, [&]() {
       ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "le", CTYPE_B, [&]() {
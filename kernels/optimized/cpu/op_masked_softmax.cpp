@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+/**
+ * Which row of `mask` applies to each row of `in` along its last dimension:
+ * row r uses mask row (r / row_repeat) % rows.
+ */
+struct MaskLayout {
+  int64_t rows;
+  int64_t row_repeat;
+};
+
+// The mask types of aten::_masked_softmax. Types 0 and 1 only apply to a 2-D
+// mask over a 4-D input; anything else is treated as type 2.
+constexpr int64_t kSrcMask = 0;
+constexpr int64_t kKeyPaddingMask = 1;
+constexpr int64_t kSameShapeMask = 2;
+
+bool check_masked_softmax_args(
+    const Tensor& in,
+    const Tensor& mask,
+    int64_t dim,
+    int64_t mask_type,
+    const Tensor& out,
+    MaskLayout* layout) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, out));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      in.scalar_type() == ScalarType::Float ||
+          in.scalar_type() == ScalarType::Double,
+      "Only Float and Double inputs are supported");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_bool_type(mask));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_has_dim(in, dim));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      in.dim() == 0 || dim == in.dim() - 1,
+      "Only the last dimension is supported, got %" PRId64,
+      dim);
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_contiguous(in));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_contiguous(mask));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_contiguous(out));
+
+  const int64_t dim_size = in.dim() == 0 ? 1 : in.size(in.dim() - 1);
+  const int64_t num_rows = in.numel() / std::max<int64_t>(dim_size, 1);
+  if (mask.dim() != 2 || in.dim() != 4) {
+    mask_type = kSameShapeMask;
+  }
+  switch (mask_type) {
+    case kSrcMask:
+      // (L, L) attention mask, shared by every batch and head.
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          mask.size(0) == in.size(2) && mask.size(1) == in.size(3),
+          "For mask_type == 0 mask shape should be (L, L)");
+      layout->rows = mask.size(0);
+      layout->row_repeat = 1;
+      return true;
+    case kKeyPaddingMask:
+      // (B, L) padding mask, shared by every head and query of a batch.
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          mask.size(0) == in.size(0) && mask.size(1) == in.size(3),
+          "For mask_type == 1 mask shape should be (B, L)");
+      layout->rows = mask.size(0);
+      layout->row_repeat = in.size(1) * in.size(2);
+      return true;
+    case kSameShapeMask:
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          mask.sizes() == in.sizes(),
+          "For mask_type == 2 mask shape should match input shape");
+      layout->rows = std::max<int64_t>(num_rows, 1);
+      layout->row_repeat = 1;
+      return true;
+    default:
+      ET_LOG(Error, "Invalid mask_type %" PRId64, mask_type);
+      return false;
+  }
+}
+
+} // namespace
+
+// _masked_softmax.out(Tensor self, Tensor mask, int? dim=None,
+// int? mask_type=None, *, Tensor(a!) out) -> Tensor(a!)
+//
+// Softmax over the last dimension, ignoring the elements whose mask entry is
+// true, e.g. for attention. Rows whose elements are all masked are set to
+// zero.
+Tensor& opt_masked_softmax_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mask,
+    exec_aten::optional<int64_t> dim,
+    exec_aten::optional<int64_t> mask_type,
+    Tensor& out) {
+  const int64_t last_dim = in.dim() == 0 ? 0 : in.dim() - 1;
+  int64_t d = dim.has_value() ? dim.value() : last_dim;
+  d = d < 0 ? d + nonzero_dim(in) : d;
+
+  MaskLayout layout;
+  ET_KERNEL_CHECK(
+      ctx,
+      check_masked_softmax_args(
+          in,
+          mask,
+          d,
+          mask_type.has_value() ? mask_type.value() : kSameShapeMask,
+          out,
+          &layout),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  const int64_t dim_size = in.dim() == 0 ? 1 : in.size(last_dim);
+  const int64_t num_rows = in.numel() / dim_size;
+  const bool* const mask_data = mask.const_data_ptr<bool>();
+  parallel_for(
+      0,
+      num_rows,
+      parallel_grain_size(dim_size),
+      [&](int64_t begin, int64_t end) {
+        masked_softmax_stub(
+            in.scalar_type(),
+            in.const_data_ptr(),
+            mask_data,
+            out.mutable_data_ptr(),
+            begin,
+            end,
+            dim_size,
+            layout.rows,
+            layout.row_repeat);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
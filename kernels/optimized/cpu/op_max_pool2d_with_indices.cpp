@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <tuple>
+
+#include <executorch/kernels/optimized/cpu/pool_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+// Max pooling that walks raw pointers instead of computing the linear index of
+// every tap. Channels-last tensors reduce each window tap across all of a
+// pixel's channels at once; other tensors are pooled one row of a plane at a
+// time, with the common 2x2 and 3x3 windows unrolled where they need no
+// clipping.
+//
+// Like the portable kernel, the first in-bounds tap of a window (in row-major
+// order) initializes the maximum and a later tap only replaces it if it is
+// greater, so ties and NaNs resolve to the same value and index.
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+
+namespace {
+
+template <typename CTYPE>
+void max_window(
+    const Pool2dGeometry& g,
+    const CTYPE* const in_plane,
+    const int64_t y0,
+    const int64_t ky_begin,
+    const int64_t ky_end,
+    const int64_t x0,
+    const int64_t kx_begin,
+    const int64_t kx_end,
+    CTYPE* const out,
+    int64_t* const index) {
+  CTYPE max_val = 0;
+  int64_t max_idx = 0;
+  bool initialized = false;
+  for (int64_t ky = ky_begin; ky < ky_end; ++ky) {
+    const int64_t iy = y0 + ky * g.dilation_h;
+    const CTYPE* const in_row = in_plane + iy * g.in_strides[2];
+    for (int64_t kx = kx_begin; kx < kx_end; ++kx) {
+      const int64_t ix = x0 + kx * g.dilation_w;
+      const CTYPE val = in_row[ix * g.in_strides[3]];
+      if (!initialized || val > max_val) {
+        max_val = val;
+        max_idx = iy * g.in_w + ix;
+        initialized = true;
+      }
+    }
+  }
+  *out = max_val;
+  *index = max_idx;
+}
+
+// A K x K window with dilation 1 that is entirely in bounds, so the taps
+// unroll.
+template <typename CTYPE, int64_t K>
+void max_window_unrolled(
+    const Pool2dGeometry& g,
+    const CTYPE* const in_plane,
+    const int64_t y0,
+    const int64_t x0,
+    CTYPE* const out,
+    int64_t* const index) {
+  const CTYPE* const in_px =
+      in_plane + y0 * g.in_strides[2] + x0 * g.in_strides[3];
+  CTYPE max_val = in_px[0];
+  int64_t max_off = 0;
+  for (int64_t ky = 0; ky < K; ++ky) {
+    for (int64_t kx = 0; kx < K; ++kx) {
+      const CTYPE val = in_px[ky * g.in_strides[2] + kx * g.in_strides[3]];
+      if (val > max_val) {
+        max_val = val;
+        max_off = ky * g.in_w + kx;
+      }
+    }
+  }
+  *out = max_val;
+  *index = y0 * g.in_w + x0 + max_off;
+}
+
+template <typename CTYPE>
+void max_pool2d_planes(
+    const Pool2dGeometry& g,
+    const int64_t* const idx_strides,
+    const CTYPE* const in_ptr,
+    CTYPE* const out_ptr,
+    int64_t* const indices_ptr) {
+  const int64_t rows = g.batches * g.channels * g.out_h;
+  const bool unroll = g.kernel_h == g.kernel_w &&
+      (g.kernel_h == 2 || g.kernel_h == 3) && g.dilation_h == 1 &&
+      g.dilation_w == 1;
+  int64_t ox_begin = 0;
+  int64_t ox_end = 0;
+  get_pool_interior(
+      g.out_w,
+      g.in_w,
+      g.kernel_w,
+      g.stride_w,
+      g.pad_w,
+      g.dilation_w,
+      &ox_begin,
+      &ox_end);
+
+  parallel_for(
+      0,
+      rows,
+      parallel_grain_size(g.out_w * g.kernel_h * g.kernel_w),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t r = begin; r < end; ++r) {
+          const int64_t oy = r % g.out_h;
+          const int64_t c = (r / g.out_h) % g.channels;
+          const int64_t n = r / (g.out_h * g.channels);
+          const CTYPE* const in_plane =
+              in_ptr + n * g.in_strides[0] + c * g.in_strides[1];
+          CTYPE* const out_row = out_ptr + n * g.out_strides[0] +
+              c * g.out_strides[1] + oy * g.out_strides[2];
+          int64_t* const idx_row = indices_ptr + n * idx_strides[0] +
+              c * idx_strides[1] + oy * idx_strides[2];
+
+          const int64_t y0 = oy * g.stride_h - g.pad_h;
+          int64_t ky_begin = 0;
+          int64_t ky_end = 0;
+          clip_pool_window(
+              y0, g.in_h, g.kernel_h, g.dilation_h, &ky_begin, &ky_end);
+          const bool row_unrolled =
+              unroll && ky_begin == 0 && ky_end == g.kernel_h;
+
+          for (int64_t ox = 0; ox < g.out_w; ++ox) {
+            CTYPE* const out = out_row + ox * g.out_strides[3];
+            int64_t* const index = idx_row + ox * idx_strides[3];
+            const int64_t x0 = ox * g.stride_w - g.pad_w;
+            if (row_unrolled && ox >= ox_begin && ox < ox_end) {
+              if (g.kernel_h == 2) {
+                max_window_unrolled<CTYPE, 2>(g, in_plane, y0, x0, out, index);
+              } else {
+                max_window_unrolled<CTYPE, 3>(g, in_plane, y0, x0, out, index);
+              }
+              continue;
+            }
+            int64_t kx_begin = 0;
+            int64_t kx_end = 0;
+            clip_pool_window(
+                x0, g.in_w, g.kernel_w, g.dilation_w, &kx_begin, &kx_end);
+            max_window(
+                g,
+                in_plane,
+                y0,
+                ky_begin,
+                ky_end,
+                x0,
+                kx_begin,
+                kx_end,
+                out,
+                index);
+          }
+        }
+      });
+}
+
+// Every tensor is channels-last, so each window tap is a contiguous vector of
+// channels that updates a contiguous vector of maxima and indices.
+template <typename CTYPE>
+void max_pool2d_channels_last(
+    const Pool2dGeometry& g,
+    const int64_t* const idx_strides,
+    const CTYPE* const in_ptr,
+    CTYPE* const out_ptr,
+    int64_t* const indices_ptr) {
+  const int64_t pixels = g.batches * g.out_h * g.out_w;
+  const int64_t C = g.channels;
+
+  parallel_for(
+      0,
+      pixels,
+      parallel_grain_size(C * g.kernel_h * g.kernel_w),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t p = begin; p < end; ++p) {
+          const int64_t ox = p % g.out_w;
+          const int64_t oy = (p / g.out_w) % g.out_h;
+          const int64_t n = p / (g.out_w * g.out_h);
+          CTYPE* const out = out_ptr + n * g.out_strides[0] +
+              oy * g.out_strides[2] + ox * g.out_strides[3];
+          int64_t* const index = indices_ptr + n * idx_strides[0] +
+              oy * idx_strides[2] + ox * idx_strides[3];
+
+          const int64_t y0 = oy * g.stride_h - g.pad_h;
+          const int64_t x0 = ox * g.stride_w - g.pad_w;
+          int64_t ky_begin = 0;
+          int64_t ky_end = 0;
+          int64_t kx_begin = 0;
+          int64_t kx_end = 0;
+          clip_pool_window(
+              y0, g.in_h, g.kernel_h, g.dilation_h, &ky_begin, &ky_end);
+          clip_pool_window(
+              x0, g.in_w, g.kernel_w, g.dilation_w, &kx_begin, &kx_end);
+          if (ky_begin == ky_end || kx_begin == kx_end) {
+            std::fill(out, out + C, static_cast<CTYPE>(0));
+            std::fill(index, index + C, 0);
+            continue;
+          }
+
+          bool initialized = false;
+          for (int64_t ky = ky_begin; ky < ky_end; ++ky) {
+            const int64_t iy = y0 + ky * g.dilation_h;
+            for (int64_t kx = kx_begin; kx < kx_end; ++kx) {
+              const int64_t ix = x0 + kx * g.dilation_w;
+              const CTYPE* const in = in_ptr + n * g.in_strides[0] +
+                  iy * g.in_strides[2] + ix * g.in_strides[3];
+              const int64_t in_idx = iy * g.in_w + ix;
+              if (!initialized) {
+                std::copy(in, in + C, out);
+                std::fill(index, index + C, in_idx);
+                initialized = true;
+                continue;
+              }
+              for (int64_t ch = 0; ch < C; ++ch) {
+                const bool greater = in[ch] > out[ch];
+                out[ch] = greater ? in[ch] : out[ch];
+                index[ch] = greater ? in_idx : index[ch];
+              }
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> opt_max_pool2d_with_indices_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    Tensor& out,
+    Tensor& indices) {
+  std::tuple<Tensor&, Tensor&> ret_val(out, indices);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_max_pool2d_with_indices_args(
+          in, kernel_size, stride, padding, dilation, ceil_mode, out, indices),
+      InvalidArgument,
+      ret_val);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_max_pool2d_with_indices_out_target_size(
+      in,
+      kernel_size,
+      stride,
+      padding,
+      dilation,
+      ceil_mode,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, 2),
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(indices, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      ret_val);
+
+  const Pool2dGeometry g =
+      get_pool2d_geometry(in, out, kernel_size, stride, padding, dilation);
+  int64_t idx_strides[4];
+  get_pool2d_strides(indices, idx_strides);
+  const bool channels_last = g.in_strides[1] == 1 && g.out_strides[1] == 1 &&
+      idx_strides[1] == 1 && g.channels > 1;
+
+  ScalarType in_type = in.scalar_type();
+  ET_SWITCH_REAL_TYPES(in_type, ctx, __func__, CTYPE, [&]() {
+    const CTYPE* const in_ptr = in.const_data_ptr<CTYPE>();
+    CTYPE* const out_ptr = out.mutable_data_ptr<CTYPE>();
+    int64_t* const indices_ptr = indices.mutable_data_ptr<int64_t>();
+    if (channels_last) {
+      max_pool2d_channels_last<CTYPE>(
+          g, idx_strides, in_ptr, out_ptr, indices_ptr);
+    } else {
+      max_pool2d_planes<CTYPE>(g, idx_strides, in_ptr, out_ptr, indices_ptr);
+    }
+  });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+Tensor& opt_mm_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& mat2,
+    Tensor& out) {
+  ET_KERNEL_CHECK(ctx, check_mm_args(in, mat2, out), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_mm_out_target_size(in, mat2, output_sizes, &output_ndim);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, "mm", CTYPE, [&]() {
+    using executorch::cpublas::TransposeType;
+
+    const int64_t m = in.size(0);
+    const int64_t n = in.size(1);
+    const int64_t p = mat2.size(1);
+
+    CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+    const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+    const CTYPE* mat2_data = mat2.const_data_ptr<CTYPE>();
+
+    // gemm() is column-major, so it computes out^T = mat2^T @ in^T. Each chunk
+    // of rows of `out` only depends on the same rows of `in`.
+    parallel_for(
+        0, m, parallel_grain_size(n * p), [&](int64_t begin, int64_t end) {
+          // clang-format off
+          executorch::cpublas::gemm(
+              TransposeType::NoTranspose, TransposeType::NoTranspose,
+              p, end - begin, n,
+              static_cast<CTYPE>(1),
+              mat2_data, p,
+              in_data + begin * n, n,
+              static_cast<CTYPE>(0),
+              out_data + begin * p, p);
+          // clang-format on
+        });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
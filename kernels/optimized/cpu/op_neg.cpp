@@ -6,8 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <executorch/kernels/optimized/vec/functional.h>
-#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -21,14 +20,8 @@ Tensor& opt_neg_out(RuntimeContext& ctx, const Tensor& in, Tensor& out) {
   auto error = resize_tensor(out, in.sizes());
   ET_CHECK_MSG(error == Error::Ok, "Failed to resize output tensor.");
 
-  ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "neg", CTYPE, [&] {
-    using Vec = executorch::vec::Vectorized<CTYPE>;
-    executorch::vec::map<CTYPE>(
-        [](Vec x) { return x.neg(); },
-        out.mutable_data_ptr<CTYPE>(),
-        in.const_data_ptr<CTYPE>(),
-        in.numel());
-  });
+  neg_stub(
+      in.scalar_type(), out.mutable_data_ptr(), in.const_data_ptr(), in.numel());
 
   return out;
 }
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+// rms_norm.out(Tensor input, Tensor weight, float eps, *, Tensor(a!) out)
+//     -> Tensor(a!)
+//
+// Normalizes each row of the last dim of input by its root mean square and
+// scales it by weight: out = input * rsqrt(mean(input^2, -1) + eps) * weight,
+// as in Llama's RMSNorm. One pass computes the sum of squares of a row and a
+// second one writes it out, instead of the five kernels and four
+// intermediate tensors of the decomposed form.
+Tensor& opt_rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    double eps,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      in.scalar_type() == ScalarType::Float &&
+          weight.scalar_type() == ScalarType::Float &&
+          out.scalar_type() == ScalarType::Float,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(ctx, in.dim() >= 1, InvalidArgument, out);
+  const int64_t dim = in.size(in.dim() - 1);
+  ET_KERNEL_CHECK(
+      ctx,
+      weight.dim() == 1 && weight.size(0) == dim,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      is_default_dim_order(in.dim_order().data(), in.dim()),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  using Vec = executorch::vec::Vectorized<float>;
+  const float* in_data = in.const_data_ptr<float>();
+  const float* weight_data = weight.const_data_ptr<float>();
+  float* out_data = out.mutable_data_ptr<float>();
+  const int64_t rows = in.numel() / dim;
+  const float inv_dim = 1.0f / static_cast<float>(dim);
+  const float eps_f = static_cast<float>(eps);
+
+  parallel_for(
+      0, rows, parallel_grain_size(2 * dim), [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const float* x = in_data + row * dim;
+          float* y = out_data + row * dim;
+          const float sum_squares = executorch::vec::map_reduce_all<float>(
+              [](Vec v) { return v * v; },
+              [](Vec a, Vec b) { return a + b; },
+              x,
+              dim);
+          const Vec scale(1.0f / std::sqrt(sum_squares * inv_dim + eps_f));
+          executorch::vec::map2<float>(
+              [scale](Vec v, Vec w) { return v * scale * w; },
+              y,
+              x,
+              weight_data,
+              dim);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
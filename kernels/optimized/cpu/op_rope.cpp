@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+// The number of elements of the head dim that are rotated at a time; even,
+// and small enough for the per-position tables to stay on the stack.
+constexpr int64_t kChunkSize = 128;
+
+} // namespace
+
+// rope.out(Tensor input, Tensor freqs_cos, Tensor freqs_sin, *,
+//     Tensor(a!) out) -> Tensor(a!)
+//
+// Applies rotary position embeddings to input, a contiguous
+// [batch, seq_len, n_heads, head_dim] tensor, by rotating each pair of
+// adjacent elements (x[2i], x[2i + 1]) of a head by the angle of position s
+// and frequency i, given as freqs_cos[s][i] and freqs_sin[s][i]:
+//
+//   out[2i]     = x[2i] * cos - x[2i + 1] * sin
+//   out[2i + 1] = x[2i] * sin + x[2i + 1] * cos
+//
+// This is Llama's apply_rotary_emb() for one of xq or xk.
+Tensor& opt_rope_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      in.scalar_type() == ScalarType::Float &&
+          freqs_cos.scalar_type() == ScalarType::Float &&
+          freqs_sin.scalar_type() == ScalarType::Float &&
+          out.scalar_type() == ScalarType::Float,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(ctx, in.dim() == 4, InvalidArgument, out);
+  const int64_t batch = in.size(0);
+  const int64_t seq_len = in.size(1);
+  const int64_t n_heads = in.size(2);
+  const int64_t head_dim = in.size(3);
+  ET_KERNEL_CHECK(ctx, head_dim % 2 == 0, InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      freqs_cos.dim() == 2 && freqs_cos.size(0) == seq_len &&
+          freqs_cos.size(1) == head_dim / 2 &&
+          freqs_sin.sizes().equals(freqs_cos.sizes()),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      is_default_dim_order(in.dim_order().data(), in.dim()) &&
+          is_default_dim_order(freqs_cos.dim_order().data(), 2) &&
+          is_default_dim_order(freqs_sin.dim_order().data(), 2),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  using Vec = executorch::vec::Vectorized<float>;
+  const float* in_data = in.const_data_ptr<float>();
+  const float* cos_data = freqs_cos.const_data_ptr<float>();
+  const float* sin_data = freqs_sin.const_data_ptr<float>();
+  float* out_data = out.mutable_data_ptr<float>();
+  const int64_t half_dim = head_dim / 2;
+
+  // Each position's angles are shared by all of its heads, so they are laid
+  // out once per position, interleaved to match the pairs:
+  //   cos_table = [c0, c0, c1, c1, ...], sin_table = [-s0, s0, -s1, s1, ...]
+  // which turns the rotation into out = x * cos_table + swap(x) * sin_table,
+  // where swap() exchanges the elements of each pair.
+  parallel_for(
+      0,
+      batch * seq_len,
+      parallel_grain_size(2 * n_heads * head_dim),
+      [&](int64_t begin, int64_t end) {
+        alignas(64) float cos_table[kChunkSize];
+        alignas(64) float sin_table[kChunkSize];
+        alignas(64) float swapped[kChunkSize];
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t pos = row % seq_len;
+          const float* cos_row = cos_data + pos * half_dim;
+          const float* sin_row = sin_data + pos * half_dim;
+          for (int64_t d = 0; d < head_dim; d += kChunkSize) {
+            const int64_t n = std::min(kChunkSize, head_dim - d);
+            for (int64_t i = 0; i < n; i += 2) {
+              const float c = cos_row[(d + i) / 2];
+              const float s = sin_row[(d + i) / 2];
+              cos_table[i] = c;
+              cos_table[i + 1] = c;
+              sin_table[i] = -s;
+              sin_table[i + 1] = s;
+            }
+            for (int64_t h = 0; h < n_heads; ++h) {
+              const int64_t offset = (row * n_heads + h) * head_dim + d;
+              const float* x = in_data + offset;
+              for (int64_t i = 0; i < n; i += 2) {
+                swapped[i] = x[i + 1];
+                swapped[i + 1] = x[i];
+              }
+              executorch::vec::map4<float>(
+                  [](Vec v, Vec c, Vec sv, Vec s) { return v * c + sv * s; },
+                  out_data + offset,
+                  x,
+                  cos_table,
+                  swapped,
+                  sin_table,
+                  n);
+            }
+          }
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
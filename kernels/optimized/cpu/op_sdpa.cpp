@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+// The queries of a tile, which share each block of keys and values that
+// they read.
+constexpr int64_t kQueryBlockSize = 32;
+// The keys whose scores a tile holds at once.
+constexpr int64_t kKeyBlockSize = 128;
+// Bounds the scratch memory, which is one tile's worth per chunk of tiles.
+constexpr int64_t kMaxScratchTiles = 64;
+
+int64_t divup(int64_t x, int64_t y) {
+  return (x + y - 1) / y;
+}
+
+struct SdpaGeometry {
+  int64_t batches;
+  int64_t heads;
+  int64_t kv_heads;
+  int64_t q_len;
+  int64_t kv_len;
+  int64_t head_dim;
+  float scale;
+  bool is_causal;
+  // Null if there is no mask; otherwise [q_len, kv_len].
+  const float* mask;
+
+  int64_t scratch_size() const {
+    return kQueryBlockSize * kKeyBlockSize + kQueryBlockSize * head_dim +
+        2 * kQueryBlockSize;
+  }
+};
+
+// Computes the attention of queries [q_begin, q_begin + q_size) of one head,
+// flash attention style: the keys are read a block at a time, and the softmax
+// of each query is computed online, rescaling the output accumulated so far
+// whenever the maximum score grows. The scores are never materialized beyond
+// one block.
+void sdpa_tile(
+    const float* q_data,
+    const float* k_data,
+    const float* v_data,
+    const SdpaGeometry& g,
+    int64_t plane,
+    int64_t q_begin,
+    int64_t q_size,
+    float* scratch,
+    float* out_data) {
+  using executorch::cpublas::TransposeType;
+  using Vec = executorch::vec::Vectorized<float>;
+  constexpr float kNegInf = -std::numeric_limits<float>::infinity();
+
+  const int64_t D = g.head_dim;
+  const int64_t batch = plane / g.heads;
+  // Grouped query attention: consecutive heads share a key and value head.
+  const int64_t kv_head = (plane % g.heads) / (g.heads / g.kv_heads);
+  const float* q = q_data + (plane * g.q_len + q_begin) * D;
+  const float* k = k_data + (batch * g.kv_heads + kv_head) * g.kv_len * D;
+  const float* v = v_data + (batch * g.kv_heads + kv_head) * g.kv_len * D;
+  float* out = out_data + (plane * g.q_len + q_begin) * D;
+
+  float* scores = scratch; // [q_size, block size]
+  float* acc = scores + kQueryBlockSize * kKeyBlockSize; // [q_size, D]
+  float* row_max = acc + kQueryBlockSize * D;
+  float* row_sum = row_max + kQueryBlockSize;
+  std::fill(acc, acc + q_size * D, 0.0f);
+  std::fill(row_max, row_max + q_size, kNegInf);
+  std::fill(row_sum, row_sum + q_size, 0.0f);
+
+  // The causal mask is aligned to the last key: query i sees the keys up to
+  // i + causal_offset, so that the queries can follow cached keys.
+  const int64_t causal_offset = g.kv_len - g.q_len;
+  const int64_t kv_end = g.is_causal
+      ? std::max<int64_t>(
+            0, std::min(g.kv_len, q_begin + q_size + causal_offset))
+      : g.kv_len;
+
+  for (int64_t kv_begin = 0; kv_begin < kv_end; kv_begin += kKeyBlockSize) {
+    const int64_t n = std::min(kKeyBlockSize, kv_end - kv_begin);
+    // scores = scale * q k^T, in the column major terms of BLAS.
+    // clang-format off
+    executorch::cpublas::gemm(
+        TransposeType::Transpose, TransposeType::NoTranspose,
+        n, q_size, D,
+        g.scale,
+        k + kv_begin * D, D,
+        q, D,
+        0.0f,
+        scores, n);
+    // clang-format on
+
+    for (int64_t i = 0; i < q_size; ++i) {
+      float* s = scores + i * n;
+      if (g.mask != nullptr) {
+        const float* mask_row = g.mask + (q_begin + i) * g.kv_len + kv_begin;
+        executorch::vec::map2<float>(
+            [](Vec x, Vec m) { return x + m; }, s, s, mask_row, n);
+      }
+      if (g.is_causal) {
+        const int64_t first_masked =
+            std::max<int64_t>(0, q_begin + i + causal_offset + 1 - kv_begin);
+        for (int64_t j = first_masked; j < n; ++j) {
+          s[j] = kNegInf;
+        }
+      }
+      const float block_max = executorch::vec::reduce_all<float>(
+          [](Vec a, Vec b) { return executorch::vec::maximum(a, b); }, s, n);
+      const float new_max = std::max(row_max[i], block_max);
+      if (new_max == kNegInf) {
+        // Nothing is visible to this query yet.
+        std::fill(s, s + n, 0.0f);
+        continue;
+      }
+      const Vec max_vec(new_max);
+      executorch::vec::map<float>(
+          [max_vec](Vec x) { return (x - max_vec).exp(); }, s, s, n);
+      const float block_sum = executorch::vec::reduce_all<float>(
+          [](Vec a, Vec b) { return a + b; }, s, n);
+      const float correction = std::exp(row_max[i] - new_max);
+      row_sum[i] = row_sum[i] * correction + block_sum;
+      row_max[i] = new_max;
+      if (correction != 1.0f) {
+        const Vec correction_vec(correction);
+        float* acc_row = acc + i * D;
+        executorch::vec::map<float>(
+            [correction_vec](Vec x) { return x * correction_vec; },
+            acc_row,
+            acc_row,
+            D);
+      }
+    }
+
+    // acc += softmax numerators * v
+    // clang-format off
+    executorch::cpublas::gemm(
+        TransposeType::NoTranspose, TransposeType::NoTranspose,
+        D, q_size, n,
+        1.0f,
+        v + kv_begin * D, D,
+        scores, n,
+        1.0f,
+        acc, D);
+    // clang-format on
+  }
+
+  for (int64_t i = 0; i < q_size; ++i) {
+    // A query that sees no key at all gets zeros rather than NaNs.
+    const Vec inv_sum(row_sum[i] > 0 ? 1.0f / row_sum[i] : 0.0f);
+    executorch::vec::map<float>(
+        [inv_sum](Vec x) { return x * inv_sum; }, out + i * D, acc + i * D, D);
+  }
+}
+
+} // namespace
+
+// sdpa.out(Tensor query, Tensor key, Tensor value, Tensor? attn_mask,
+//     bool is_causal, float? scale, *, Tensor(a!) out) -> Tensor(a!)
+//
+// Scaled dot product attention, softmax(query key^T * scale + mask) value, of
+// contiguous float [batch, heads, q_len, head_dim] queries over
+// [batch, kv_heads, kv_len, head_dim] keys and values, where heads is a
+// multiple of kv_heads. attn_mask is added to the scores, and is
+// [q_len, kv_len] after any leading dims of size 1. is_causal hides from
+// query i the keys after i + kv_len - q_len. scale defaults to
+// 1 / sqrt(head_dim).
+//
+// Memory stays in O(q_len * head_dim) beyond the inputs, rather than the
+// O(q_len * kv_len) of the decomposed matmul -> softmax -> matmul.
+Tensor& opt_sdpa_out(
+    RuntimeContext& ctx,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const exec_aten::optional<Tensor>& attn_mask,
+    bool is_causal,
+    const exec_aten::optional<double> scale,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      query.scalar_type() == ScalarType::Float &&
+          key.scalar_type() == ScalarType::Float &&
+          value.scalar_type() == ScalarType::Float &&
+          out.scalar_type() == ScalarType::Float,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      query.dim() == 4 && key.dim() == 4 && value.dim() == 4,
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      is_default_dim_order(query.dim_order().data(), 4) &&
+          is_default_dim_order(key.dim_order().data(), 4) &&
+          is_default_dim_order(value.dim_order().data(), 4),
+      InvalidArgument,
+      out);
+
+  SdpaGeometry g;
+  g.batches = query.size(0);
+  g.heads = query.size(1);
+  g.kv_heads = key.size(1);
+  g.q_len = query.size(2);
+  g.kv_len = key.size(2);
+  g.head_dim = query.size(3);
+  g.is_causal = is_causal;
+  g.mask = nullptr;
+  ET_KERNEL_CHECK(
+      ctx,
+      key.sizes().equals(value.sizes()) && key.size(0) == g.batches &&
+          key.size(3) == g.head_dim && g.kv_heads > 0 &&
+          g.heads % g.kv_heads == 0,
+      InvalidArgument,
+      out);
+  if (attn_mask.has_value()) {
+    const Tensor& mask = attn_mask.value();
+    bool valid = mask.scalar_type() == ScalarType::Float && mask.dim() >= 2 &&
+        mask.size(mask.dim() - 2) == g.q_len &&
+        mask.size(mask.dim() - 1) == g.kv_len &&
+        is_default_dim_order(mask.dim_order().data(), mask.dim());
+    for (size_t d = 0; d + 2 < mask.dim(); ++d) {
+      valid = valid && mask.size(d) == 1;
+    }
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        valid,
+        InvalidArgument,
+        out,
+        "attn_mask must be a float [q_len, kv_len] mask");
+    g.mask = mask.const_data_ptr<float>();
+  }
+  g.scale = static_cast<float>(
+      scale.has_value() ? scale.value()
+                        : 1.0 / std::sqrt(static_cast<double>(g.head_dim)));
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, query.sizes()) == Error::Ok, InvalidArgument, out);
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const int64_t tiles_per_plane = divup(g.q_len, kQueryBlockSize);
+  const int64_t num_tiles = g.batches * g.heads * tiles_per_plane;
+  const int64_t grain_size = std::max(
+      parallel_grain_size(
+          2 * std::min(g.q_len, kQueryBlockSize) * g.kv_len * g.head_dim),
+      divup(num_tiles, kMaxScratchTiles));
+  const int64_t num_scratch_tiles = divup(num_tiles, grain_size);
+  const size_t scratch_bytes =
+      num_scratch_tiles * g.scratch_size() * sizeof(float);
+  Result<void*> temp = ctx.allocate_temp(scratch_bytes);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      temp.ok(),
+      MemoryAllocationFailed,
+      out,
+      "sdpa needs %zu bytes of temp memory",
+      scratch_bytes);
+  float* scratch = static_cast<float*>(temp.get());
+
+  const float* q_data = query.const_data_ptr<float>();
+  const float* k_data = key.const_data_ptr<float>();
+  const float* v_data = value.const_data_ptr<float>();
+  float* out_data = out.mutable_data_ptr<float>();
+  // Every chunk but the last has at least grain_size tiles, so each can
+  // claim the scratch tile at the index of the multiple of grain_size that
+  // it starts in.
+  parallel_for(0, num_tiles, grain_size, [&](int64_t begin, int64_t end) {
+    float* tile_scratch = scratch + (begin / grain_size) * g.scratch_size();
+    for (int64_t t = begin; t < end; ++t) {
+      const int64_t q_begin = (t % tiles_per_plane) * kQueryBlockSize;
+      sdpa_tile(
+          q_data,
+          k_data,
+          v_data,
+          g,
+          t / tiles_per_plane,
+          q_begin,
+          std::min(kQueryBlockSize, g.q_len - q_begin),
+          tile_scratch,
+          out_data);
+    }
+  });
+  ctx.free_temp(scratch);
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+// _softmax.out(Tensor self, int dim, bool half_to_float, *, Tensor(a!) out)
+// -> Tensor(a!)
+Tensor& opt_softmax_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out) {
+  check_softmax_args(in, dim, half_to_float, out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  // Adjust for negative dim
+  dim = dim < 0 ? dim + nonzero_dim(in) : dim;
+
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  // A 0-D tensor is treated as a single softmax over one element.
+  const bool is_scalar = in.dim() == 0;
+  const int64_t dim_size = is_scalar ? 1 : in.size(dim);
+  const int64_t outer_size = is_scalar ? 1 : getLeadingDims(in, dim);
+  const int64_t inner_size = is_scalar ? 1 : getTrailingDims(in, dim);
+  const int64_t outer_stride = dim_size * inner_size;
+
+  const char* const in_data = static_cast<const char*>(in.const_data_ptr());
+  char* const out_data = static_cast<char*>(out.mutable_data_ptr());
+  const size_t outer_nbytes = outer_stride * in.element_size();
+
+  parallel_for(
+      0,
+      outer_size,
+      parallel_grain_size(outer_stride),
+      [&](int64_t begin, int64_t end) {
+        softmax_stub(
+            in.scalar_type(),
+            in_data + begin * outer_nbytes,
+            out_data + begin * outer_nbytes,
+            end - begin,
+            dim_size,
+            inner_size);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
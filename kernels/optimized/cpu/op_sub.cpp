@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -37,28 +38,23 @@ Tensor& opt_sub_out(
     auto error = resize_tensor(out, a.sizes());
     ET_CHECK_MSG(error == Error::Ok, "Failed to resize output tensor.");
 
-    ET_SWITCH_REAL_TYPES(out_type, ctx, "sub", CTYPE, [&]() {
-      CTYPE alpha_val;
-      ET_EXTRACT_SCALAR(alpha, alpha_val);
-
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [alpha_val](Vec x, Vec y) { return x - Vec(alpha_val) * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
-    });
+    sub_stub(
+        out_type,
+        out.mutable_data_ptr(),
+        a.const_data_ptr(),
+        b.const_data_ptr(),
+        alpha,
+        out.numel());
   } else {
     ScalarType common_type = promoteTypes(a_type, b_type);
     ET_CHECK(canCast(common_type, out_type));
 
     resize_to_broadcast_target_size(a, b, out);
 
-    ET_SWITCH_REAL_TYPES(a_type, ctx, "sub", CTYPE_A, [&]() {
-      ET_SWITCH_REAL_TYPES(b_type, ctx, "sub", CTYPE_B, [&]() {
-        ET_SWITCH_REAL_TYPES(common_type, ctx, "sub", CTYPE_IN, [&]() {
-          ET_SWITCH_REAL_TYPES(out_type, ctx, "sub", CTYPE_OUT, [&]() {
+    ET_SWITCH_REALHBF16_TYPES(a_type, ctx, "sub", CTYPE_A, [&]() {
+      ET_SWITCH_REALHBF16_TYPES(b_type, ctx, "sub", CTYPE_B, [&]() {
+        ET_SWITCH_REALHBF16_TYPES(common_type, ctx, "sub", CTYPE_IN, [&]() {
+          ET_SWITCH_REALHBF16_TYPES(out_type, ctx, "sub", CTYPE_OUT, [&]() {
             CTYPE_IN alpha_val;
             ET_EXTRACT_SCALAR(alpha, alpha_val);
 
@@ -102,7 +98,7 @@ Tensor& opt_sub_scalar_out(
   ET_CHECK_MSG(error == Error::Ok, "Failed to resize output tensor.");
 
   if (a_type == common_type && a_type == out_type) {
-    ET_SWITCH_REAL_TYPES(a_type, ctx, "sub", CTYPE, [&]() {
+    ET_SWITCH_REALHBF16_TYPES(a_type, ctx, "sub", CTYPE, [&]() {
       ET_SWITCH_REAL_TYPES(b_type, ctx, "sub", CTYPE_B, [&]() {
         CTYPE_B b_val;
         ET_EXTRACT_SCALAR(b, b_val);
@@ -121,10 +117,10 @@ Tensor& opt_sub_scalar_out(
       });
     });
   } else {
-    ET_SWITCH_REAL_TYPES(a_type, ctx, "sub", CTYPE_A, [&]() {
+    ET_SWITCH_REALHBF16_TYPES(a_type, ctx, "sub", CTYPE_A, [&]() {
       ET_SWITCH_REAL_TYPES(b_type, ctx, "sub", CTYPE_B, [&]() {
-        ET_SWITCH_REAL_TYPES(common_type, ctx, "sub", CTYPE_IN, [&]() {
-          ET_SWITCH_REAL_TYPES(out_type, ctx, "sub", CTYPE_OUT, [&]() {
+        ET_SWITCH_REALHBF16_TYPES(common_type, ctx, "sub", CTYPE_IN, [&]() {
+          ET_SWITCH_REALHBF16_TYPES(out_type, ctx, "sub", CTYPE_OUT, [&]() {
             CTYPE_B b_val;
             ET_EXTRACT_SCALAR(b, b_val);
             CTYPE_IN b_casted = static_cast<CTYPE_IN>(b_val);
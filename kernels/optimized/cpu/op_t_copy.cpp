@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/permute_util.h>
+#include <executorch/kernels/portable/cpu/util/transpose_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+/**
+ * Expects input to be <= 2-D tensor and transposes dimensions 0 and 1.
+ * 0-D and 1-D tensors are returned as is. When input is a 2-D tensor this
+ * is equivalent to transpose(input, 0, 1).
+ * t_copy.out(Tensor self, Tensor(a!) out)
+ */
+Tensor& opt_t_copy_out(RuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(ctx, check_t_copy_args(in, out), InvalidArgument, out);
+
+  if (in.dim() < 2) {
+    // Resize for dynamic shape
+    ET_KERNEL_CHECK(
+        ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+    if (in.numel() > 0) {
+      memcpy(out.mutable_data_ptr(), in.const_data_ptr(), in.nbytes());
+    }
+
+    return out;
+  }
+
+  Tensor::SizesType expected_out_size[kTensorDimensionLimit];
+  size_t expected_out_dim = 0;
+  get_transpose_out_target_size(in, 1, 0, expected_out_size, &expected_out_dim);
+
+  // Resize for dynamic shape
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_out_size, expected_out_dim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t dims[] = {1, 0};
+  permute_tensor(in, dims, out);
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+void convert_elements(
+    const Tensor& self,
+    Tensor& out,
+    const size_t begin,
+    const size_t end) {
+  const size_t in_elem_size = self.element_size();
+  const size_t out_elem_size = out.element_size();
+  const char* const in = self.const_data_ptr<char>() + begin * in_elem_size;
+  char* const out_data = out.mutable_data_ptr<char>() + begin * out_elem_size;
+  const ScalarType in_type = self.scalar_type();
+  const ScalarType out_type = out.scalar_type();
+  if (convert_stub(in_type, out_type, in, out_data, end - begin)) {
+    return;
+  }
+  ET_SWITCH_REALHBBF16_TYPES(in_type, nullptr, "_to_copy", IN, [&] {
+    ET_SWITCH_REALHBBF16_TYPES(out_type, nullptr, "_to_copy", OUT, [&] {
+      const IN* const in_ptr = reinterpret_cast<const IN*>(in);
+      OUT* const out_ptr = reinterpret_cast<OUT*>(out_data);
+      for (size_t i = 0; i < end - begin; ++i) {
+        out_ptr[i] = static_cast<OUT>(in_ptr[i]);
+      }
+    });
+  });
+}
+
+} // namespace
+
+// to_copy.out(Tensor self, *, bool non_blocking=False, MemoryFormat?
+// memory_format=None, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_to_copy_out(
+    RuntimeContext& ctx,
+    const Tensor& self,
+    bool non_blocking,
+    exec_aten::optional<exec_aten::MemoryFormat> memory_format,
+    Tensor& out) {
+  (void)ctx;
+  // Right now we only support blocking data transfer
+  ET_CHECK(non_blocking == false);
+
+  // Right now we only focus on contiguous memory, memory_format shall be
+  // exec::aten::MemoryFormat::Contiguous or none.
+  ET_CHECK(
+      !memory_format.has_value() ||
+      memory_format.value() == MemoryFormat::Contiguous);
+
+  torch::executor::Error err = resize_tensor(out, self.sizes());
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in to_copy_out");
+
+  // self and out should be in same size.
+  ET_CHECK_SAME_SHAPE2(self, out);
+
+  if (self.scalar_type() == out.scalar_type()) {
+    copy_blocks(
+        out.mutable_data_ptr<char>(),
+        /*dst_stride=*/0,
+        self.const_data_ptr<char>(),
+        /*src_stride=*/0,
+        self.nbytes(),
+        /*nblocks=*/1);
+    return out;
+  }
+
+  parallel_for(
+      0,
+      self.numel(),
+      parallel_grain_size(1),
+      [&](int64_t begin, int64_t end) {
+        convert_elements(self, out, begin, end);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
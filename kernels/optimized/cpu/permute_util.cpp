@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/permute_util.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+/**
+ * The permutation as a walk over the output, from its outermost to its
+ * innermost dimension in memory, with the input and output stride of every
+ * step. Dimensions of size 1 are dropped, and neighbouring dimensions that are
+ * also neighbours, in the same order, in both tensors are merged, so that
+ * e.g. permuting a contiguous [A, B, C] by (0, 2, 1) is viewed as a batch of
+ * A transposes of [B, C] and an identity permutation as a single contiguous
+ * run.
+ */
+struct PermutedView {
+  int64_t ndim = 0;
+  int64_t sizes[kTensorDimensionLimit];
+  int64_t in_strides[kTensorDimensionLimit];
+  int64_t out_strides[kTensorDimensionLimit];
+};
+
+PermutedView get_permuted_view(
+    const Tensor& in,
+    exec_aten::ArrayRef<int64_t> dims,
+    const Tensor& out) {
+  // Output dimensions by decreasing output stride, i.e. in memory order.
+  int64_t order[kTensorDimensionLimit];
+  int64_t n = 0;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (out.size(i) == 1) {
+      continue;
+    }
+    int64_t k = n++;
+    for (; k > 0 && out.strides()[order[k - 1]] < out.strides()[i]; --k) {
+      order[k] = order[k - 1];
+    }
+    order[k] = i;
+  }
+
+  PermutedView view;
+  for (int64_t k = 0; k < n; ++k) {
+    const int64_t i = order[k];
+    const int64_t d = dims[i] >= 0 ? dims[i] : dims[i] + in.dim();
+    const int64_t size = out.size(i);
+    const int64_t in_stride = in.strides()[d];
+    const int64_t out_stride = out.strides()[i];
+    const int64_t last = view.ndim - 1;
+    if (view.ndim > 0 && view.in_strides[last] == in_stride * size &&
+        view.out_strides[last] == out_stride * size) {
+      view.sizes[last] *= size;
+      view.in_strides[last] = in_stride;
+      view.out_strides[last] = out_stride;
+    } else {
+      view.sizes[view.ndim] = size;
+      view.in_strides[view.ndim] = in_stride;
+      view.out_strides[view.ndim] = out_stride;
+      view.ndim++;
+    }
+  }
+  return view;
+}
+
+/**
+ * Calls `fn(in_offset, out_offset)` for every position of the view's
+ * dimensions, except for `skip0` and `skip1`, which are left to `fn`.
+ */
+template <typename Fn>
+void for_each_offset(
+    const PermutedView& view,
+    int64_t skip0,
+    int64_t skip1,
+    const Fn& fn) {
+  int64_t index[kTensorDimensionLimit] = {0};
+  int64_t in_offset = 0;
+  int64_t out_offset = 0;
+  while (true) {
+    fn(in_offset, out_offset);
+    int64_t d = view.ndim - 1;
+    for (; d >= 0; --d) {
+      if (d == skip0 || d == skip1) {
+        continue;
+      }
+      in_offset += view.in_strides[d];
+      out_offset += view.out_strides[d];
+      if (++index[d] < view.sizes[d]) {
+        break;
+      }
+      in_offset -= view.in_strides[d] * view.sizes[d];
+      out_offset -= view.out_strides[d] * view.sizes[d];
+      index[d] = 0;
+    }
+    if (d < 0) {
+      return;
+    }
+  }
+}
+
+template <typename T>
+void gather(const PermutedView& view, const void* in_data, void* out_data) {
+  const T* in = static_cast<const T*>(in_data);
+  T* out = static_cast<T*>(out_data);
+  const int64_t last = view.ndim - 1;
+  const int64_t size = view.sizes[last];
+  const int64_t in_stride = view.in_strides[last];
+  const int64_t out_stride = view.out_strides[last];
+  for_each_offset(view, last, -1, [&](int64_t in_offset, int64_t out_offset) {
+    for (int64_t j = 0; j < size; ++j) {
+      out[out_offset + j * out_stride] = in[in_offset + j * in_stride];
+    }
+  });
+}
+
+// Copies element by element along the innermost output dimension.
+void gather_elements(
+    const PermutedView& view,
+    size_t element_size,
+    const void* in_data,
+    void* out_data) {
+  switch (element_size) {
+    case 1:
+      gather<uint8_t>(view, in_data, out_data);
+      return;
+    case 2:
+      gather<uint16_t>(view, in_data, out_data);
+      return;
+    case 4:
+      gather<uint32_t>(view, in_data, out_data);
+      return;
+    case 8:
+      gather<uint64_t>(view, in_data, out_data);
+      return;
+    default:
+      break;
+  }
+  const char* in = static_cast<const char*>(in_data);
+  char* out = static_cast<char*>(out_data);
+  const int64_t last = view.ndim - 1;
+  for_each_offset(view, last, -1, [&](int64_t in_offset, int64_t out_offset) {
+    for (int64_t j = 0; j < view.sizes[last]; ++j) {
+      memcpy(
+          out + (out_offset + j * view.out_strides[last]) * element_size,
+          in + (in_offset + j * view.in_strides[last]) * element_size,
+          element_size);
+    }
+  });
+}
+
+} // namespace
+
+void permute_tensor(
+    const Tensor& in,
+    exec_aten::ArrayRef<int64_t> dims,
+    Tensor& out) {
+  if (out.numel() == 0) {
+    return;
+  }
+
+  const size_t element_size = out.element_size();
+  const char* const in_data = static_cast<const char*>(in.const_data_ptr());
+  char* const out_data = static_cast<char*>(out.mutable_data_ptr());
+
+  const PermutedView view = get_permuted_view(in, dims, out);
+  if (view.ndim == 0) {
+    memcpy(out_data, in_data, element_size);
+    return;
+  }
+
+  const int64_t last = view.ndim - 1;
+  if (view.out_strides[last] != 1) {
+    gather_elements(view, element_size, in_data, out_data);
+    return;
+  }
+
+  if (view.in_strides[last] == 1) {
+    // The innermost output dimension is contiguous in the input too.
+    const size_t run_bytes = view.sizes[last] * element_size;
+    for_each_offset(view, last, -1, [&](int64_t in_offset, int64_t out_offset) {
+      memcpy(
+          out_data + out_offset * element_size,
+          in_data + in_offset * element_size,
+          run_bytes);
+    });
+    return;
+  }
+
+  // Otherwise, some other output dimension is the input's contiguous one, and
+  // those two dimensions are transposed.
+  int64_t t = 0;
+  while (t < last && view.in_strides[t] != 1) {
+    ++t;
+  }
+  if (t == last) {
+    // No contiguous input dimension left.
+    gather_elements(view, element_size, in_data, out_data);
+    return;
+  }
+
+  // Input rows run along the output's innermost dimension, and input columns
+  // along dimension t.
+  const int64_t in_rows = view.sizes[last];
+  const int64_t in_cols = view.sizes[t];
+  const int64_t in_row_stride = view.in_strides[last];
+  const int64_t out_row_stride = view.out_strides[t];
+  for_each_offset(view, t, last, [&](int64_t in_offset, int64_t out_offset) {
+    transpose_stub(
+        element_size,
+        in_data + in_offset * element_size,
+        in_row_stride,
+        out_data + out_offset * element_size,
+        out_row_stride,
+        in_rows,
+        in_cols);
+  });
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
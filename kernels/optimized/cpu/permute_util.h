@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Copies `in` into `out` with its dimensions permuted by `dims`, so that
+ * out.size(i) == in.size(dims[i]). `dims` must be a valid permutation and
+ * `out` must already have the permuted sizes and the dtype of `in`; either
+ * tensor may be in any dim order.
+ *
+ * Dimensions that are contiguous in both tensors are coalesced, runs that are
+ * contiguous in both are copied with memcpy, and when the innermost
+ * dimensions of the two tensors differ they are transposed by transpose_stub,
+ * e.g. for NCHW <-> NHWC conversions.
+ */
+void permute_tensor(
+    const exec_aten::Tensor& in,
+    exec_aten::ArrayRef<int64_t> dims,
+    exec_aten::Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
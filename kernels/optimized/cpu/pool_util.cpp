@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/pool_util.h>
+
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+void get_pool2d_strides(const exec_aten::Tensor& t, int64_t strides[4]) {
+  exec_aten::StridesType t_strides[kTensorDimensionLimit];
+  dim_order_to_stride_nocheck(
+      t.sizes().data(), t.dim_order().data(), t.dim(), t_strides);
+  const size_t offset = 4 - t.dim();
+  strides[0] = 0;
+  for (size_t i = 0; i < t.dim(); ++i) {
+    strides[offset + i] = t_strides[i];
+  }
+}
+
+Pool2dGeometry get_pool2d_geometry(
+    const exec_aten::Tensor& in,
+    const exec_aten::Tensor& out,
+    exec_aten::ArrayRef<int64_t> kernel_size,
+    exec_aten::ArrayRef<int64_t> stride,
+    exec_aten::ArrayRef<int64_t> padding,
+    exec_aten::ArrayRef<int64_t> dilation) {
+  Pool2dGeometry g;
+  const size_t dim = in.dim();
+  g.batches = dim == 4 ? in.size(0) : 1;
+  g.channels = in.size(dim - 3);
+  g.in_h = in.size(dim - 2);
+  g.in_w = in.size(dim - 1);
+  g.out_h = out.size(dim - 2);
+  g.out_w = out.size(dim - 1);
+  g.kernel_h = val_at(kernel_size, 0);
+  g.kernel_w = val_at(kernel_size, 1);
+  g.stride_h = val_at(stride, 0, /*default_value=*/g.kernel_h);
+  g.stride_w = val_at(stride, 1, /*default_value=*/g.kernel_w);
+  g.pad_h = val_at(padding, 0, /*default_value=*/0);
+  g.pad_w = val_at(padding, 1, /*default_value=*/0);
+  g.dilation_h = val_at(dilation, 0, /*default_value=*/1);
+  g.dilation_w = val_at(dilation, 1, /*default_value=*/1);
+  get_pool2d_strides(in, g.in_strides);
+  get_pool2d_strides(out, g.out_strides);
+  return g;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * The geometry of a 2D pooling of a 3-D {C, H, W} or 4-D {N, C, H, W} tensor;
+ * a 3-D tensor is viewed as a batch of one. Strides are in elements and in
+ * (N, C, H, W) order, whatever the dim order of the tensor.
+ */
+struct Pool2dGeometry {
+  int64_t batches;
+  int64_t channels;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  int64_t in_strides[4];
+  int64_t out_strides[4];
+};
+
+/**
+ * Returns the geometry of pooling `in` into `out`, which already has its
+ * output size. Arguments that are empty take the same defaults as in
+ * kernel_reduction_then_map_2d(): the stride defaults to the kernel size, the
+ * padding to 0 and the dilation to 1.
+ */
+Pool2dGeometry get_pool2d_geometry(
+    const exec_aten::Tensor& in,
+    const exec_aten::Tensor& out,
+    exec_aten::ArrayRef<int64_t> kernel_size,
+    exec_aten::ArrayRef<int64_t> stride,
+    exec_aten::ArrayRef<int64_t> padding,
+    exec_aten::ArrayRef<int64_t> dilation);
+
+/**
+ * Writes the (N, C, H, W) strides of a 3-D or 4-D tensor to `strides`, with a
+ * batch stride of 0 for a 3-D tensor.
+ */
+void get_pool2d_strides(const exec_aten::Tensor& t, int64_t strides[4]);
+
+/**
+ * Clips the taps of a window along one dim, which starts at `start` and has
+ * `kernel` taps `dilation` apart, to the input of size `size`. The taps in
+ * [*begin, *end) are in bounds; the range is empty if none are.
+ */
+inline void clip_pool_window(
+    int64_t start,
+    int64_t size,
+    int64_t kernel,
+    int64_t dilation,
+    int64_t* begin,
+    int64_t* end) {
+  *begin = start < 0 ? (-start + dilation - 1) / dilation : 0;
+  *end = start < size
+      ? std::min(kernel, (size - start + dilation - 1) / dilation)
+      : 0;
+  *begin = std::min(*begin, *end);
+}
+
+/**
+ * Returns the outputs [*begin, *end) along one dim whose windows have every
+ * tap in bounds, so that kernels can skip clipping them.
+ */
+inline void get_pool_interior(
+    int64_t out_size,
+    int64_t size,
+    int64_t kernel,
+    int64_t stride,
+    int64_t pad,
+    int64_t dilation,
+    int64_t* begin,
+    int64_t* end) {
+  // start = o * stride - pad must be >= 0, and start + (kernel - 1) *
+  // dilation must be < size.
+  const int64_t last_start = size - 1 - (kernel - 1) * dilation;
+  *begin = std::min(out_size, (pad + stride - 1) / stride);
+  *end = last_start + pad < 0
+      ? *begin
+      : std::min(out_size, (last_start + pad) / stride + 1);
+  *end = std::max(*begin, *end);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/reduce_plan.h>
+
+#include <cstring>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+bool make_reduce_plan(
+    const Tensor& in,
+    const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
+    const Tensor& out,
+    ReducePlan* plan) {
+  if (in.numel() == 0 || !tensor_is_contiguous(in) ||
+      !tensor_is_contiguous(out)) {
+    return false;
+  }
+
+  bool is_reduced[kTensorDimensionLimit];
+  const bool reduce_all =
+      !dim_list.has_value() || dim_list.value().size() == 0;
+  memset(is_reduced, reduce_all, sizeof(is_reduced));
+  if (!reduce_all) {
+    for (const auto d : dim_list.value()) {
+      is_reduced[d < 0 ? d + in.dim() : d] = true;
+    }
+  }
+
+  // Merge adjacent dimensions of the same kind. Since `in` is contiguous, the
+  // stride of a group is the stride of its innermost dimension.
+  int64_t num_groups = 0;
+  int64_t group_sizes[kTensorDimensionLimit];
+  int64_t group_strides[kTensorDimensionLimit];
+  bool group_is_reduced[kTensorDimensionLimit];
+  for (size_t d = 0; d < in.dim(); ++d) {
+    if (in.size(d) == 1) {
+      continue;
+    }
+    if (num_groups > 0 && group_is_reduced[num_groups - 1] == is_reduced[d]) {
+      group_sizes[num_groups - 1] *= in.size(d);
+      group_strides[num_groups - 1] = in.strides()[d];
+    } else {
+      group_sizes[num_groups] = in.size(d);
+      group_strides[num_groups] = in.strides()[d];
+      group_is_reduced[num_groups] = is_reduced[d];
+      ++num_groups;
+    }
+  }
+
+  plan->row_size = 1;
+  plan->inner_size = 1;
+  if (num_groups > 0) {
+    --num_groups;
+    if (group_is_reduced[num_groups]) {
+      plan->row_size = group_sizes[num_groups];
+    } else {
+      plan->inner_size = group_sizes[num_groups];
+    }
+  }
+
+  plan->num_outer_groups = 0;
+  plan->num_reduce_groups = 0;
+  plan->out_numel = plan->inner_size;
+  plan->reduce_numel = plan->row_size;
+  for (int64_t g = 0; g < num_groups; ++g) {
+    if (group_is_reduced[g]) {
+      plan->reduce_sizes[plan->num_reduce_groups] = group_sizes[g];
+      plan->reduce_strides[plan->num_reduce_groups] = group_strides[g];
+      ++plan->num_reduce_groups;
+      plan->reduce_numel *= group_sizes[g];
+    } else {
+      plan->outer_sizes[plan->num_outer_groups] = group_sizes[g];
+      plan->outer_strides[plan->num_outer_groups] = group_strides[g];
+      ++plan->num_outer_groups;
+      plan->out_numel *= group_sizes[g];
+    }
+  }
+
+  return plan->out_numel == out.numel();
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
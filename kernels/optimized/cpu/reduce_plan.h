@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Describes the reduction of a contiguous tensor over a list of dimensions as
+ * a walk over raw memory, for the vectorized reduction kernels in
+ * vec_kernels.h.
+ *
+ * The input is viewed as groups of dimensions, outermost first, that
+ * alternate between kept and reduced: adjacent dimensions of the same kind
+ * are merged and dimensions of size 1 are dropped. The innermost group then
+ * decides the kind of reduction:
+ *
+ * - If it is reduced, each output element reduces over contiguous rows of
+ *   `row_size` elements ("inner reduction"), e.g. a sum over the last
+ *   dimension. `inner_size` is 1.
+ * - If it is kept, each of the `inner_size` contiguous output elements that
+ *   share their outer index reduces over elements `inner_size` apart, so
+ *   kernels vectorize across the output elements instead ("outer
+ *   reduction"). `row_size` is 1.
+ *
+ * Either way, the remaining groups are split into `outer_*`, which locate
+ * the first input element of an output element, and `reduce_*`, whose
+ * offsets are added to it to visit every row (or every element, for an
+ * outer reduction) of the reduction.
+ */
+struct ReducePlan {
+  // Kept groups other than the innermost one, outermost first. The output
+  // elements are numbered in the same order.
+  int64_t num_outer_groups;
+  int64_t outer_sizes[kTensorDimensionLimit];
+  int64_t outer_strides[kTensorDimensionLimit];
+
+  // Reduced groups other than the innermost one, outermost first.
+  int64_t num_reduce_groups;
+  int64_t reduce_sizes[kTensorDimensionLimit];
+  int64_t reduce_strides[kTensorDimensionLimit];
+
+  int64_t row_size;
+  int64_t inner_size;
+
+  // Number of output elements, and of input elements reduced into each.
+  int64_t out_numel;
+  int64_t reduce_numel;
+};
+
+/**
+ * Fills `plan` for reducing `in` over `dim_list` (every dimension if it is
+ * null or empty) into `out`. Returns false if either tensor is not
+ * contiguous or `in` is empty, in which case the caller must use the generic
+ * path in kernels/portable/cpu/util/reduce_util.h.
+ */
+bool make_reduce_plan(
+    const exec_aten::Tensor& in,
+    const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
+    const exec_aten::Tensor& out,
+    ReducePlan* plan);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Online softmax statistics, as in "Online normalizer calculation for
+// softmax" (Milakov and Gimelshein, 2018), for the softmax and log_softmax
+// kernels in vec_kernels/.
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// Wrapped like the vec library, since the per-CPUCapability kernels in
+// vec_kernels/ each instantiate these with their own Vectorized types.
+inline namespace CPU_CAPABILITY {
+
+/**
+ * Per-lane running maximum, and sum of exp(x - maximum), of a stream of
+ * vectors. This yields both statistics of a softmax in a single read of its
+ * input: when the maximum grows, the sum so far is rescaled instead of being
+ * recomputed.
+ *
+ * The maximum starts at the lowest finite value rather than -inf, so that a
+ * lane that has only seen -inf never computes -inf - -inf; its sum stays 0.
+ */
+template <typename T>
+class OnlineSoftmaxStats {
+ public:
+  using Vec = executorch::vec::Vectorized<T>;
+
+  // Vectors that add() takes at once. They share a single rescale of the sum.
+  static constexpr int64_t kBlockSize = 4;
+
+  void add(const Vec* x, int64_t n) {
+    Vec block_max = x[0];
+    for (int64_t i = 1; i < n; ++i) {
+      block_max = executorch::vec::maximum(block_max, x[i]);
+    }
+    const Vec new_max = executorch::vec::maximum(max_, block_max);
+    Vec sum = sum_ * (max_ - new_max).exp();
+    for (int64_t i = 0; i < n; ++i) {
+      sum = sum + (x[i] - new_max).exp();
+    }
+    max_ = new_max;
+    sum_ = sum;
+  }
+
+  const Vec& max() const {
+    return max_;
+  }
+
+  const Vec& sum() const {
+    return sum_;
+  }
+
+  // Combines the lanes into the statistics of everything added so far.
+  void reduce(T* max, T* sum) const {
+    const T m = executorch::vec::vec_reduce_all<T>(
+        [](Vec a, Vec b) { return executorch::vec::maximum(a, b); }, max_);
+    *max = m;
+    *sum = executorch::vec::vec_reduce_all<T>(
+        [](Vec a, Vec b) { return a + b; }, sum_ * (max_ - Vec(m)).exp());
+  }
+
+ private:
+  Vec max_ = Vec(std::numeric_limits<T>::lowest());
+  Vec sum_ = Vec(T(0));
+};
+
+/**
+ * Computes the maximum and the sum of exp(x - maximum) of `n` elements in a
+ * single pass. `load(i, count)` must return elements [i, i + count) in the
+ * first `count` lanes of a vector and -inf in the others; it is how masked
+ * kernels hide elements.
+ */
+template <typename T, typename LoadOp>
+void online_softmax_stats(const LoadOp& load, int64_t n, T* max, T* sum) {
+  using Vec = executorch::vec::Vectorized<T>;
+  using Stats = OnlineSoftmaxStats<T>;
+  constexpr int64_t kVecSize = Vec::size();
+  constexpr int64_t kStep = Stats::kBlockSize * kVecSize;
+
+  Stats stats;
+  Vec x[Stats::kBlockSize];
+  int64_t i = 0;
+  for (; i + kStep <= n; i += kStep) {
+    for (int64_t b = 0; b < Stats::kBlockSize; ++b) {
+      x[b] = load(i + b * kVecSize, kVecSize);
+    }
+    stats.add(x, Stats::kBlockSize);
+  }
+  int64_t num_left = 0;
+  for (; i < n; i += kVecSize) {
+    x[num_left++] = load(i, std::min(kVecSize, n - i));
+  }
+  if (num_left > 0) {
+    stats.add(x, num_left);
+  }
+  stats.reduce(max, sum);
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -1,58 +1,164 @@
+load("@fbsource//xplat/executorch/backends/xnnpack/third-party:third_party_libs.bzl", "third_party_dep")
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+load("@fbsource//xplat/executorch/kernels/optimized:lib_defs.bzl", "define_dispatched_library")
 load("@fbsource//xplat/executorch/kernels/optimized:op_registration_util.bzl", "define_op_target", "op_target")
 
 _OPTIMIZED_ATEN_OPS = (
     op_target(
         name = "op_add",
         deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_addmm",
+        deps = [
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
+            "//executorch/kernels/portable/cpu/util:matmul_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_amax",
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_avg_pool2d",
+        deps = [
+            ":pool_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
     op_target(
         name = "op_bmm",
         deps = [
             "//executorch/kernels/optimized:libblas",
         ],
     ),
+    op_target(
+        name = "op_cat",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_convolution",
+        deps = [
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_cos",
+        deps = [
+            ":unary_ufunc_util",
+        ],
+    ),
     op_target(
         name = "op_div",
         deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
-    op_target(name = "op_exp"),
+    op_target(
+        name = "op_embedding",
+        deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_erf",
+        deps = [
+            ":unary_ufunc_util",
+        ],
+    ),
+    op_target(
+        name = "op_exp",
+        deps = [
+            ":unary_ufunc_util",
+        ],
+    ),
     op_target(
         name = "op_gelu",
-        deps = select({
-            "DEFAULT": [],
-            "ovr_config//runtime:fbcode-arm64": [
-                "fbsource//third-party/sleef:sleef_arm",
-            ],
-        }),
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     ),
     op_target(
         name = "op_le",
         deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
             "//executorch/kernels/portable/cpu:scalar_utils",
         ],
     ),
+    op_target(
+        name = "op_log",
+        deps = [
+            ":unary_ufunc_util",
+        ],
+    ),
     op_target(
         name = "op_log_softmax",
-        deps = select({
-            "DEFAULT": [
-                "//executorch/kernels/portable/cpu/util:activation_ops_util",
-            ],
-            "ovr_config//runtime:fbcode-arm64": [
-                "//executorch/kernels/portable/cpu/util:activation_ops_util",
-                "fbsource//third-party/sleef:sleef_arm",
-            ],
-        }),
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_masked_softmax",
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_max_pool2d_with_indices",
+        deps = [
+            ":pool_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_mean",
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_mm",
+        deps = [
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/portable/cpu/util:matmul_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     ),
     op_target(
         name = "op_mul",
         deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
@@ -60,18 +166,128 @@ _OPTIMIZED_ATEN_OPS = (
     op_target(
         name = "op_native_layer_norm",
         deps = [
-            ":moments_utils",
+            ":vec_kernels",
+            ":vec_kernels_impl",
             "//executorch/kernels/portable/cpu/util:normalization_ops_util",
         ],
     ),
-    op_target(name = "op_neg"),
+    op_target(
+        name = "op_neg",
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+        ],
+    ),
+    op_target(
+        name = "op_permute_copy",
+        deps = [
+            ":permute_util",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_sigmoid",
+        deps = [
+            ":unary_ufunc_util",
+        ],
+    ),
+    op_target(
+        name = "op_sin",
+        deps = [
+            ":unary_ufunc_util",
+        ],
+    ),
+    op_target(
+        name = "op_softmax",
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
     op_target(
         name = "op_sub",
         deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_sum",
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_t_copy",
+        deps = [
+            ":permute_util",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
+        ],
+    ),
+    op_target(
+        name = "op_tanh",
+        deps = [
+            ":unary_ufunc_util",
+        ],
+    ),
+    op_target(
+        name = "op_to_copy",
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_transpose_copy",
+        deps = [
+            ":permute_util",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
+        ],
+    ),
+    op_target(
+        name = "op_var",
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+)
+
+_CUSTOM_OPS = (
+    op_target(
+        name = "op_fused_elementwise",
+        deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_rms_norm",
+        deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_rope",
+        deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_sdpa",
+        deps = [
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
 )
 
 def define_common_targets():
@@ -82,11 +298,12 @@ def define_common_targets():
     """
 
     # Define build targets for all operators registered in the tables above.
-    for op in _OPTIMIZED_ATEN_OPS:
+    for op in _OPTIMIZED_ATEN_OPS + _CUSTOM_OPS:
         define_op_target(**op)
 
     aten_op_targets = [":{}".format(op["name"]) for op in _OPTIMIZED_ATEN_OPS]
-    all_op_targets = aten_op_targets
+    custom_op_targets = [":{}".format(op["name"]) for op in _CUSTOM_OPS]
+    all_op_targets = aten_op_targets + custom_op_targets
 
     runtime.cxx_library(
         name = "cpu_optimized",
@@ -105,3 +322,118 @@ def define_common_targets():
             "//executorch/kernels/optimized:libutils",
         ],
     )
+
+    runtime.cxx_library(
+        name = "softmax_utils",
+        srcs = [],
+        exported_headers = ["softmax_utils.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/optimized:libutils",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "permute_util",
+        srcs = ["permute_util.cpp"],
+        exported_headers = ["permute_util.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "pool_util",
+        srcs = ["pool_util.cpp"],
+        exported_headers = ["pool_util.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        deps = [
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "unary_ufunc_util",
+        srcs = ["unary_ufunc_util.cpp"],
+        exported_headers = ["unary_ufunc_util.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        deps = [
+            "//executorch/kernels/portable/cpu/pattern:pattern",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+        exported_deps = [
+            ":vec_kernels",
+            ":vec_kernels_impl",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "reduce_plan",
+        srcs = ["reduce_plan.cpp"],
+        exported_headers = ["reduce_plan.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "dispatch_stub",
+        srcs = ["dispatch_stub.cpp"],
+        exported_headers = ["dispatch_stub.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        deps = select({
+            "DEFAULT": [],
+            "ovr_config//cpu:arm64": [
+                third_party_dep("cpuinfo"),
+            ],
+            "ovr_config//cpu:x86_64": [
+                third_party_dep("cpuinfo"),
+            ],
+        }),
+    )
+
+    # The stubs that the operators above call, and their per-CPU-capability
+    # implementations.
+    runtime.cxx_library(
+        name = "vec_kernels",
+        srcs = ["vec_kernels.cpp"],
+        exported_headers = ["vec_kernels.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            ":dispatch_stub",
+            ":reduce_plan",
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+    )
+
+    define_dispatched_library(
+        name = "vec_kernels_impl",
+        srcs = native.glob(["vec_kernels/*.cpp"]),
+        deps = [
+            ":moments_utils",
+            ":softmax_utils",
+            ":vec_kernels",
+            "//executorch/kernels/optimized:libutils",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+        visibility = ["//executorch/kernels/optimized/..."],
+    )
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/unary_ufunc_util.h>
+
+#include <executorch/kernels/portable/cpu/pattern/pattern.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+Tensor& opt_unary_ufunc_realb_to_float(
+    const DispatchStub<unary_op_fn>& stub,
+    FunctionRef<double(double)> fn,
+    RuntimeContext& ctx,
+    const Tensor& in,
+    Tensor& out) {
+  const ScalarType out_type = out.scalar_type();
+  if (in.scalar_type() != out_type ||
+      (out_type != ScalarType::Float && out_type != ScalarType::Double)) {
+    return internal::unary_ufunc_realb_to_float(fn, ctx, in, out);
+  }
+
+  // Resize for dynamic shape
+  auto error = resize_tensor(out, in.sizes());
+  ET_CHECK_MSG(error == Error::Ok, "Failed to resize output tensor.");
+
+  const size_t elem_size = in.element_size();
+  const char* const in_data = in.const_data_ptr<char>();
+  char* const out_data = out.mutable_data_ptr<char>();
+  parallel_for(
+      0, in.numel(), parallel_grain_size(1), [&](int64_t begin, int64_t end) {
+        stub(
+            out_type,
+            out_data + begin * elem_size,
+            in_data + begin * elem_size,
+            end - begin);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/runtime/core/function_ref.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Implements a unary op from Real or Bool to Float or Double. When `in` and
+ * `out` share a floating point dtype, `stub` maps the elements in parallel
+ * chunks; otherwise each element is cast to the output dtype and passed to
+ * `fn`, like the portable unary_ufunc_realb_to_float().
+ */
+Tensor& opt_unary_ufunc_realb_to_float(
+    const DispatchStub<unary_op_fn>& stub,
+    FunctionRef<double(double)> fn,
+    RuntimeContext& ctx,
+    const Tensor& in,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+ET_DEFINE_DISPATCH(binary_op_alpha_fn, add_stub);
+ET_DEFINE_DISPATCH(binary_op_alpha_fn, sub_stub);
+ET_DEFINE_DISPATCH(binary_op_fn, mul_stub);
+ET_DEFINE_DISPATCH(binary_op_fn, div_stub);
+ET_DEFINE_DISPATCH(binary_op_fn, le_stub);
+ET_DEFINE_DISPATCH(binary_scalar_op_fn, le_scalar_stub);
+ET_DEFINE_DISPATCH(unary_op_fn, exp_stub);
+ET_DEFINE_DISPATCH(unary_op_fn, neg_stub);
+ET_DEFINE_DISPATCH(unary_op_fn, log_stub);
+ET_DEFINE_DISPATCH(unary_op_fn, tanh_stub);
+ET_DEFINE_DISPATCH(unary_op_fn, sigmoid_stub);
+ET_DEFINE_DISPATCH(unary_op_fn, erf_stub);
+ET_DEFINE_DISPATCH(unary_op_fn, sin_stub);
+ET_DEFINE_DISPATCH(unary_op_fn, cos_stub);
+ET_DEFINE_DISPATCH(convert_fn, convert_stub);
+ET_DEFINE_DISPATCH(gelu_fn, gelu_stub);
+ET_DEFINE_DISPATCH(layer_norm_fn, layer_norm_stub);
+ET_DEFINE_DISPATCH(log_softmax_fn, log_softmax_stub);
+ET_DEFINE_DISPATCH(softmax_fn, softmax_stub);
+ET_DEFINE_DISPATCH(masked_softmax_fn, masked_softmax_stub);
+ET_DEFINE_DISPATCH(reduce_div_fn, sum_stub);
+ET_DEFINE_DISPATCH(reduce_div_fn, var_stub);
+ET_DEFINE_DISPATCH(reduce_fn, amax_stub);
+ET_DEFINE_DISPATCH(transpose_fn, transpose_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Vectorized kernel bodies that are compiled once per CPUCapability and picked
+// at runtime; see dispatch_stub.h. The implementations live in vec_kernels/.
+//
+// The kernels take raw, contiguous buffers and the dtype of their elements, so
+// that the per-capability sources do not need any Tensor code.
+
+#include <executorch/kernels/optimized/cpu/dispatch_stub.h>
+#include <executorch/kernels/optimized/cpu/reduce_plan.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// out[i] = a[i] <op> alpha * b[i] for `n` elements of `dtype`.
+using binary_op_alpha_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    const exec_aten::Scalar& alpha,
+    size_t n);
+
+// out[i] = a[i] <op> b[i] for `n` elements of `dtype`.
+using binary_op_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    size_t n);
+
+// out[i] = a[i] <op> b for `n` elements of `dtype`, after casting the scalar
+// `b` to `dtype`.
+using binary_scalar_op_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    void* out,
+    const void* a,
+    const exec_aten::Scalar& b,
+    size_t n);
+
+ET_DECLARE_DISPATCH(binary_op_alpha_fn, add_stub);
+ET_DECLARE_DISPATCH(binary_op_alpha_fn, sub_stub);
+ET_DECLARE_DISPATCH(binary_op_fn, mul_stub);
+ET_DECLARE_DISPATCH(binary_op_fn, div_stub);
+ET_DECLARE_DISPATCH(binary_op_fn, le_stub);
+ET_DECLARE_DISPATCH(binary_scalar_op_fn, le_scalar_stub);
+
+// out[i] = <op>(in[i]) for `n` elements of `dtype`.
+using unary_op_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    void* out,
+    const void* in,
+    size_t n);
+
+ET_DECLARE_DISPATCH(unary_op_fn, exp_stub);
+ET_DECLARE_DISPATCH(unary_op_fn, neg_stub);
+
+// Transcendental functions of `n` elements of Float or Double. The AVX2,
+// AVX512 and NEON kernels use the Sleef routines behind Vectorized: exp, log
+// and tanh are within 1 ULP, sin and cos within 3.5 ULP for float on x86 and
+// 1 ULP otherwise, and float erf on x86 is the Abramowitz-Stegun polynomial,
+// within 1.5e-7 absolute. sigmoid is 1 / (1 + exp(-x)). The DEFAULT kernels
+// call libm per element.
+ET_DECLARE_DISPATCH(unary_op_fn, log_stub);
+ET_DECLARE_DISPATCH(unary_op_fn, tanh_stub);
+ET_DECLARE_DISPATCH(unary_op_fn, sigmoid_stub);
+ET_DECLARE_DISPATCH(unary_op_fn, erf_stub);
+ET_DECLARE_DISPATCH(unary_op_fn, sin_stub);
+ET_DECLARE_DISPATCH(unary_op_fn, cos_stub);
+
+// out[i] = static_cast<out_type>(in[i]) for `n` elements. Returns false,
+// without writing anything, for the pairs of dtypes it does not vectorize.
+using convert_fn = bool (*)(
+    exec_aten::ScalarType in_type,
+    exec_aten::ScalarType out_type,
+    const void* in,
+    void* out,
+    size_t n);
+
+ET_DECLARE_DISPATCH(convert_fn, convert_stub);
+
+// gelu of `n` floats, with the tanh approximation when `approximate_tanh`.
+using gelu_fn =
+    void (*)(const float* in, float* out, size_t n, bool approximate_tanh);
+
+ET_DECLARE_DISPATCH(gelu_fn, gelu_stub);
+
+// Normalizes each of the `M` rows of `N` elements in `input`, then scales by
+// `gamma` and shifts by `beta` when they are not null. Writes the mean and
+// reciprocal standard deviation of each row to `mean` and `rstd`.
+using layer_norm_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    const void* input,
+    const void* gamma,
+    const void* beta,
+    double eps,
+    size_t M,
+    size_t N,
+    void* out,
+    void* mean,
+    void* rstd);
+
+ET_DECLARE_DISPATCH(layer_norm_fn, layer_norm_stub);
+
+// log_softmax over the middle dimension of an [outer_size, dim_size,
+// inner_size] float buffer.
+using log_softmax_fn = void (*)(
+    const float* input,
+    float* out,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size);
+
+ET_DECLARE_DISPATCH(log_softmax_fn, log_softmax_stub);
+
+// softmax over the middle dimension of an [outer_size, dim_size, inner_size]
+// buffer of `dtype`.
+using softmax_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    const void* input,
+    void* out,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size);
+
+ET_DECLARE_DISPATCH(softmax_fn, softmax_stub);
+
+// softmax over each of the rows [row_begin, row_end) of `dim_size` contiguous
+// elements of `dtype`, ignoring the elements whose `mask` entry is true. Row r
+// uses mask row (r / mask_row_repeat) % mask_rows. Rows whose elements are all
+// masked are set to zero.
+using masked_softmax_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    const void* input,
+    const bool* mask,
+    void* out,
+    int64_t row_begin,
+    int64_t row_end,
+    int64_t dim_size,
+    int64_t mask_rows,
+    int64_t mask_row_repeat);
+
+ET_DECLARE_DISPATCH(masked_softmax_fn, masked_softmax_stub);
+
+// Reductions of a contiguous buffer of `dtype` as described by `plan`, writing
+// only the output elements [begin, end) so that callers can split the outputs
+// across threads.
+using reduce_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    const void* in,
+    void* out,
+    const ReducePlan& plan,
+    int64_t begin,
+    int64_t end);
+
+// Like reduce_fn, dividing each result by `divisor`.
+using reduce_div_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    const void* in,
+    void* out,
+    const ReducePlan& plan,
+    double divisor,
+    int64_t begin,
+    int64_t end);
+
+// Sums, accumulated pairwise so that rounding error grows with the log of the
+// reduction size. Also computes means, with the reduction size as divisor.
+ET_DECLARE_DISPATCH(reduce_div_fn, sum_stub);
+// Sums of squared deviations from the mean, e.g. variances with the divisor
+// set to the reduction size minus the correction.
+ET_DECLARE_DISPATCH(reduce_div_fn, var_stub);
+// Maxima, propagating NaN.
+ET_DECLARE_DISPATCH(reduce_fn, amax_stub);
+
+// Transposes the `rows` x `cols` matrix of elements of `element_size` bytes
+// at `src` into the `cols` x `rows` matrix at `dst`:
+// dst[j * ld_dst + i] = src[i * ld_src + j]. The buffers must not overlap.
+using transpose_fn = void (*)(
+    size_t element_size,
+    const void* src,
+    int64_t ld_src,
+    void* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols);
+
+ET_DECLARE_DISPATCH(transpose_fn, transpose_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
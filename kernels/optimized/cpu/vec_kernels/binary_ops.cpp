@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/scalar_utils.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+using ScalarType = exec_aten::ScalarType;
+using Scalar = exec_aten::Scalar;
+
+// The dtype switches below match the fast paths of the operators that call
+// them, and use the same names, so dtype selective builds see the same keys.
+//
+// Vectorized has no Half or BFloat16 specialization, so those dtypes take its
+// generic element-wise path, whose arithmetic comes from half.h and
+// bfloat16.h: native fp16 instructions on ARMv8.2+, float elsewhere.
+
+void add_kernel(
+    ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    const Scalar& alpha,
+    size_t n) {
+  ET_SWITCH_REALHBBF16_TYPES(dtype, nullptr, "add", CTYPE, [&]() {
+    CTYPE alpha_val;
+    ET_EXTRACT_SCALAR(alpha, alpha_val);
+
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    executorch::vec::map2<CTYPE>(
+        [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
+        static_cast<CTYPE*>(out),
+        static_cast<const CTYPE*>(a),
+        static_cast<const CTYPE*>(b),
+        n);
+  });
+}
+
+void sub_kernel(
+    ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    const Scalar& alpha,
+    size_t n) {
+  ET_SWITCH_REALHBF16_TYPES(dtype, nullptr, "sub", CTYPE, [&]() {
+    CTYPE alpha_val;
+    ET_EXTRACT_SCALAR(alpha, alpha_val);
+
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    executorch::vec::map2<CTYPE>(
+        [alpha_val](Vec x, Vec y) { return x - Vec(alpha_val) * y; },
+        static_cast<CTYPE*>(out),
+        static_cast<const CTYPE*>(a),
+        static_cast<const CTYPE*>(b),
+        n);
+  });
+}
+
+void mul_kernel(
+    ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    size_t n) {
+  ET_SWITCH_REALHBBF16_TYPES(dtype, nullptr, "mul", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    executorch::vec::map2<CTYPE>(
+        [](Vec x, Vec y) { return x * y; },
+        static_cast<CTYPE*>(out),
+        static_cast<const CTYPE*>(a),
+        static_cast<const CTYPE*>(b),
+        n);
+  });
+}
+
+void div_kernel(
+    ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    size_t n) {
+  ET_SWITCH_REALHBBF16_TYPES(dtype, nullptr, "div", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    executorch::vec::map2<CTYPE>(
+        [](Vec x, Vec y) { return x / y; },
+        static_cast<CTYPE*>(out),
+        static_cast<const CTYPE*>(a),
+        static_cast<const CTYPE*>(b),
+        n);
+  });
+}
+
+void le_kernel(
+    ScalarType dtype,
+    void* out,
+    const void* a,
+    const void* b,
+    size_t n) {
+  ET_SWITCH_REAL_TYPES_AND(Bool, dtype, nullptr, "le", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    executorch::vec::map2<CTYPE>(
+        [](Vec x, Vec y) { return x.le(y); },
+        static_cast<CTYPE*>(out),
+        static_cast<const CTYPE*>(a),
+        static_cast<const CTYPE*>(b),
+        n);
+  });
+}
+
+void le_scalar_kernel(
+    ScalarType dtype,
+    void* out,
+    const void* a,
+    const Scalar& b,
+    size_t n) {
+  const ScalarType b_type = utils::get_scalar_dtype(b);
+  ET_SWITCH_REAL_TYPES_AND(Bool, dtype, nullptr, "le", CTYPE, [&]() {
+    ET_SWITCH_REAL_TYPES_AND(Bool, b_type, nullptr, "le", CTYPE_B, [&]() {
+      CTYPE_B b_val = 0;
+      ET_EXTRACT_SCALAR(b, b_val);
+      CTYPE b_casted = static_cast<CTYPE>(b_val);
+      using Vec = executorch::vec::Vectorized<CTYPE>;
+      executorch::vec::map<CTYPE>(
+          [b_casted](Vec x) { return x.le(Vec(b_casted)); },
+          static_cast<CTYPE*>(out),
+          static_cast<const CTYPE*>(a),
+          n);
+    });
+  });
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(add_stub, &add_kernel);
+ET_REGISTER_DISPATCH(sub_stub, &sub_kernel);
+ET_REGISTER_DISPATCH(mul_stub, &mul_kernel);
+ET_REGISTER_DISPATCH(div_stub, &div_kernel);
+ET_REGISTER_DISPATCH(le_stub, &le_kernel);
+ET_REGISTER_DISPATCH(le_scalar_stub, &le_scalar_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
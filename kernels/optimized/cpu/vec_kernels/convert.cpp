@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_half.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+using ScalarType = exec_aten::ScalarType;
+
+template <typename IN, typename OUT>
+bool try_convert(
+    ScalarType in_type,
+    ScalarType out_type,
+    const void* in,
+    void* out,
+    size_t n) {
+  if (in_type != CppTypeToScalarType<IN>::value ||
+      out_type != CppTypeToScalarType<OUT>::value) {
+    return false;
+  }
+  executorch::vec::convert(
+      static_cast<const IN*>(in), static_cast<OUT*>(out), n);
+  return true;
+}
+
+// The conversions that models do at their inputs and outputs. Each pair is
+// instantiated once per CPUCapability, so the list is kept short; the
+// specializations of convert() use the conversion instructions, and the
+// generic convert() loop auto-vectorizes for the others.
+bool convert_kernel(
+    ScalarType in_type,
+    ScalarType out_type,
+    const void* in,
+    void* out,
+    size_t n) {
+  return try_convert<float, exec_aten::Half>(in_type, out_type, in, out, n) ||
+      try_convert<exec_aten::Half, float>(in_type, out_type, in, out, n) ||
+      try_convert<float, int8_t>(in_type, out_type, in, out, n) ||
+      try_convert<int8_t, float>(in_type, out_type, in, out, n) ||
+      try_convert<float, uint8_t>(in_type, out_type, in, out, n) ||
+      try_convert<uint8_t, float>(in_type, out_type, in, out, n) ||
+      try_convert<float, int32_t>(in_type, out_type, in, out, n) ||
+      try_convert<int32_t, float>(in_type, out_type, in, out, n) ||
+      try_convert<int64_t, int32_t>(in_type, out_type, in, out, n) ||
+      try_convert<int32_t, int64_t>(in_type, out_type, in, out, n) ||
+      try_convert<bool, float>(in_type, out_type, in, out, n);
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(convert_stub, &convert_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
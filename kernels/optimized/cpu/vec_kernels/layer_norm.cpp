@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <executorch/kernels/optimized/cpu/moments_utils.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+// The rows of a layer_norm read their input twice: once for the moments and
+// once to normalize it.
+constexpr int64_t kLayerNormWorkPerElement = 3;
+
+template <typename CTYPE>
+void layer_norm(
+    const CTYPE* input_data,
+    const CTYPE* gamma_data,
+    const CTYPE* beta_data,
+    CTYPE eps,
+    size_t M,
+    size_t N,
+    CTYPE* out_data,
+    CTYPE* mean_data,
+    CTYPE* rstd_data) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  if (M == 0) {
+    return;
+  }
+
+  if (N == 0) {
+    for (int i = 0; i < M; ++i) {
+      mean_data[i] = static_cast<CTYPE>(0);
+      rstd_data[i] = static_cast<CTYPE>(NAN);
+    }
+    return;
+  }
+
+  const bool gamma_null = gamma_data == nullptr;
+  const bool beta_null = beta_data == nullptr;
+
+  // Rows are independent, and each writes its own mean and rstd along with
+  // its output.
+  parallel_for(
+      0,
+      M,
+      parallel_grain_size(kLayerNormWorkPerElement * N),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const CTYPE* src_ptr = input_data + i * N;
+          CTYPE* dst_ptr = out_data + i * N;
+
+          CTYPE mean_val;
+          CTYPE rstd_val;
+          std::tie(mean_val, rstd_val) = RowwiseMoments(src_ptr, N);
+          rstd_val = CTYPE(1) / std::sqrt(rstd_val + eps);
+
+          const CTYPE scale = rstd_val;
+          const CTYPE offset = -rstd_val * mean_val;
+
+          if (gamma_null || beta_null) {
+            for (size_t j = 0; j < N; ++j) {
+              const CTYPE gamma_v = gamma_null ? CTYPE(1) : gamma_data[j];
+              const CTYPE beta_v = beta_null ? CTYPE(0) : beta_data[j];
+              dst_ptr[j] = (src_ptr[j] * scale + offset) * gamma_v + beta_v;
+            }
+          } else {
+            executorch::vec::map3<CTYPE>(
+                [scale, offset](Vec x, Vec gamma, Vec beta) {
+                  return (x * Vec(scale) + Vec(offset)) * gamma + beta;
+                },
+                dst_ptr,
+                src_ptr,
+                gamma_data,
+                beta_data,
+                N);
+          }
+
+          mean_data[i] = mean_val;
+          rstd_data[i] = rstd_val;
+        }
+      });
+}
+
+// The number of elements of a Half or BFloat16 row that are widened to float
+// at a time.
+constexpr size_t kReducedPrecisionChunk = 256;
+
+template <typename CTYPE>
+void to_float(const CTYPE* src, size_t n, float* dst) {
+  for (size_t k = 0; k < n; ++k) {
+    dst[k] = static_cast<float>(src[k]);
+  }
+}
+
+/**
+ * layer_norm of Half or BFloat16 rows, for which Vectorized has no
+ * arithmetic. Each row is widened to float a chunk at a time, and the chunks
+ * go through the same vectorized float moments and normalization as the
+ * float kernel. The moments of the chunks are merged with AddMoments().
+ */
+template <typename CTYPE>
+void layer_norm_reduced_precision(
+    const CTYPE* input_data,
+    const CTYPE* gamma_data,
+    const CTYPE* beta_data,
+    float eps,
+    size_t M,
+    size_t N,
+    CTYPE* out_data,
+    CTYPE* mean_data,
+    CTYPE* rstd_data) {
+  using Vec = executorch::vec::Vectorized<float>;
+
+  if (N == 0) {
+    for (size_t i = 0; i < M; ++i) {
+      mean_data[i] = static_cast<CTYPE>(0);
+      rstd_data[i] = static_cast<CTYPE>(NAN);
+    }
+    return;
+  }
+
+  const bool gamma_null = gamma_data == nullptr;
+  const bool beta_null = beta_data == nullptr;
+
+  parallel_for(
+      0,
+      M,
+      parallel_grain_size(kLayerNormWorkPerElement * N),
+      [&](int64_t begin, int64_t end) {
+        float x_buf[kReducedPrecisionChunk];
+        float gamma_buf[kReducedPrecisionChunk];
+        float beta_buf[kReducedPrecisionChunk];
+        for (int64_t i = begin; i < end; ++i) {
+          const CTYPE* src_ptr = input_data + i * N;
+          CTYPE* dst_ptr = out_data + i * N;
+
+          int64_t m0 = 0;
+          float m1 = 0;
+          float m2 = 0;
+          for (size_t j = 0; j < N; j += kReducedPrecisionChunk) {
+            const size_t n = std::min(kReducedPrecisionChunk, N - j);
+            to_float(src_ptr + j, n, x_buf);
+            float chunk_mean;
+            float chunk_var;
+            std::tie(chunk_mean, chunk_var) = RowwiseMoments(x_buf, n);
+            AddMoments<float>(n, chunk_mean, chunk_var * n, m0, m1, m2);
+          }
+          const float mean_val = m1;
+          const float rstd_val = 1.0f / std::sqrt(m2 / N + eps);
+
+          const float scale = rstd_val;
+          const float offset = -rstd_val * mean_val;
+
+          for (size_t j = 0; j < N; j += kReducedPrecisionChunk) {
+            const size_t n = std::min(kReducedPrecisionChunk, N - j);
+            to_float(src_ptr + j, n, x_buf);
+            if (gamma_null || beta_null) {
+              for (size_t k = 0; k < n; ++k) {
+                const float gamma_v =
+                    gamma_null ? 1.0f : static_cast<float>(gamma_data[j + k]);
+                const float beta_v =
+                    beta_null ? 0.0f : static_cast<float>(beta_data[j + k]);
+                x_buf[k] = (x_buf[k] * scale + offset) * gamma_v + beta_v;
+              }
+            } else {
+              to_float(gamma_data + j, n, gamma_buf);
+              to_float(beta_data + j, n, beta_buf);
+              executorch::vec::map3<float>(
+                  [scale, offset](Vec x, Vec gamma, Vec beta) {
+                    return (x * Vec(scale) + Vec(offset)) * gamma + beta;
+                  },
+                  x_buf,
+                  x_buf,
+                  gamma_buf,
+                  beta_buf,
+                  n);
+            }
+            for (size_t k = 0; k < n; ++k) {
+              dst_ptr[j + k] = static_cast<CTYPE>(x_buf[k]);
+            }
+          }
+
+          mean_data[i] = static_cast<CTYPE>(mean_val);
+          rstd_data[i] = static_cast<CTYPE>(rstd_val);
+        }
+      });
+}
+
+void layer_norm_kernel(
+    exec_aten::ScalarType dtype,
+    const void* input,
+    const void* gamma,
+    const void* beta,
+    double eps,
+    size_t M,
+    size_t N,
+    void* out,
+    void* mean,
+    void* rstd) {
+  if (dtype == exec_aten::ScalarType::Half ||
+      dtype == exec_aten::ScalarType::BFloat16) {
+    ET_SWITCH_TWO_TYPES(
+        Half, BFloat16, dtype, nullptr, "native_layer_norm", CTYPE, [&]() {
+          layer_norm_reduced_precision<CTYPE>(
+              static_cast<const CTYPE*>(input),
+              static_cast<const CTYPE*>(gamma),
+              static_cast<const CTYPE*>(beta),
+              static_cast<float>(eps),
+              M,
+              N,
+              static_cast<CTYPE*>(out),
+              static_cast<CTYPE*>(mean),
+              static_cast<CTYPE*>(rstd));
+        });
+    return;
+  }
+  ET_SWITCH_FLOAT_TYPES(dtype, nullptr, "native_layer_norm", CTYPE, [&]() {
+    layer_norm<CTYPE>(
+        static_cast<const CTYPE*>(input),
+        static_cast<const CTYPE*>(gamma),
+        static_cast<const CTYPE*>(beta),
+        static_cast<CTYPE>(eps),
+        M,
+        N,
+        static_cast<CTYPE*>(out),
+        static_cast<CTYPE*>(mean),
+        static_cast<CTYPE*>(rstd));
+  });
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(layer_norm_stub, &layer_norm_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <executorch/kernels/optimized/cpu/softmax_utils.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+using Vec = executorch::vec::Vectorized<float>;
+
+/**
+ * log_softmax over `dim_size` contiguous elements, i.e. when `dim` is the
+ * innermost dimension. Reads the input twice: once for the maximum and the
+ * sum of exponentials together (see softmax_utils.h), and once to write the
+ * output.
+ */
+void log_softmax_contiguous(const float* in, float* out, int64_t dim_size) {
+  const Vec neg_inf(-std::numeric_limits<float>::infinity());
+
+  float max_in;
+  float sum;
+  online_softmax_stats<float>(
+      [in, neg_inf](int64_t i, int64_t count) {
+        return Vec::set(neg_inf, Vec::loadu(in + i, count), count);
+      },
+      dim_size,
+      &max_in,
+      &sum);
+
+  const Vec shift_vec(max_in + std::log(sum));
+  executorch::vec::map<float>(
+      [shift_vec](Vec x) { return x - shift_vec; }, out, in, dim_size);
+}
+
+/**
+ * log_softmax over `dim_size` elements `inner_size` apart, for each of the
+ * `inner_size` contiguous positions. Vectorizes across the inner positions,
+ * which are independent, so every load stays contiguous.
+ */
+void log_softmax_strided(
+    const float* in,
+    float* out,
+    int64_t dim_size,
+    int64_t inner_size) {
+  using Stats = OnlineSoftmaxStats<float>;
+
+  for (int64_t j = 0; j < inner_size; j += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), inner_size - j);
+    const float* in_j = in + j;
+    float* out_j = out + j;
+
+    Stats stats;
+    Vec x[Stats::kBlockSize];
+    for (int64_t d = 0; d < dim_size; d += Stats::kBlockSize) {
+      const int64_t n = std::min(Stats::kBlockSize, dim_size - d);
+      for (int64_t b = 0; b < n; ++b) {
+        x[b] = Vec::loadu(in_j + (d + b) * inner_size, count);
+      }
+      stats.add(x, n);
+    }
+
+    const Vec shift_vec = stats.max() + stats.sum().log();
+    for (int64_t d = 0; d < dim_size; ++d) {
+      (Vec::loadu(in_j + d * inner_size, count) - shift_vec)
+          .store(out_j + d * inner_size, count);
+    }
+  }
+}
+
+void log_softmax_kernel(
+    const float* input,
+    float* out,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size) {
+  const int64_t outer_stride = dim_size * inner_size;
+  for (int64_t i = 0; i < outer_size; ++i) {
+    if (inner_size == 1) {
+      log_softmax_contiguous(
+          input + i * outer_stride, out + i * outer_stride, dim_size);
+    } else {
+      log_softmax_strided(
+          input + i * outer_stride,
+          out + i * outer_stride,
+          dim_size,
+          inner_size);
+    }
+  }
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(log_softmax_stub, &log_softmax_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+using ScalarType = exec_aten::ScalarType;
+
+/**
+ * Adds up a stream of vectors pairwise, so that the rounding error grows with
+ * the log of the number of vectors instead of linearly: the vectors are
+ * summed in short blocks, and the block sums are then combined like the
+ * nodes of a binary tree, by carrying into `levels_` the way a binary
+ * counter does.
+ */
+template <typename T>
+class CascadeSum {
+ public:
+  using Vec = executorch::vec::Vectorized<T>;
+
+  CascadeSum() = default;
+  explicit CascadeSum(const Vec& initial) : block_(initial) {}
+
+  void add(const Vec& v) {
+    block_ = block_ + v;
+    if (++block_count_ == kBlockSize) {
+      push_block();
+    }
+  }
+
+  Vec result() const {
+    Vec sum = block_;
+    for (int64_t l = 0; l < kLevels; ++l) {
+      if (filled_ & (uint64_t(1) << l)) {
+        sum = sum + levels_[l];
+      }
+    }
+    return sum;
+  }
+
+ private:
+  static constexpr int64_t kBlockSize = 8;
+  // Enough for 2^40 vectors; the top level absorbs anything beyond that.
+  static constexpr int64_t kLevels = 32;
+
+  void push_block() {
+    Vec carry = block_;
+    block_ = Vec(T(0));
+    block_count_ = 0;
+    int64_t l = 0;
+    for (; l < kLevels - 1 && (filled_ & (uint64_t(1) << l)); ++l) {
+      carry = carry + levels_[l];
+      filled_ &= ~(uint64_t(1) << l);
+    }
+    if (filled_ & (uint64_t(1) << l)) {
+      carry = carry + levels_[l];
+    }
+    levels_[l] = carry;
+    filled_ |= uint64_t(1) << l;
+  }
+
+  Vec block_ = Vec(T(0));
+  int64_t block_count_ = 0;
+  uint64_t filled_ = 0;
+  Vec levels_[kLevels];
+};
+
+template <typename T>
+struct SumReducer {
+  using Vec = executorch::vec::Vectorized<T>;
+  using Acc = CascadeSum<T>;
+
+  static T identity() {
+    return T(0);
+  }
+  static void add(Acc& acc, const Vec& v) {
+    acc.add(v);
+  }
+  static Vec result(const Acc& acc) {
+    return acc.result();
+  }
+  static Vec combine(const Vec& a, const Vec& b) {
+    return a + b;
+  }
+};
+
+// Propagates NaN, like the portable amax.
+template <typename T>
+struct MaxReducer {
+  using Vec = executorch::vec::Vectorized<T>;
+  using Acc = Vec;
+
+  static T identity() {
+    return -std::numeric_limits<T>::infinity();
+  }
+  static void add(Acc& acc, const Vec& v) {
+    acc = executorch::vec::maximum(acc, v);
+  }
+  static Vec result(const Acc& acc) {
+    return acc;
+  }
+  static Vec combine(const Vec& a, const Vec& b) {
+    return executorch::vec::maximum(a, b);
+  }
+};
+
+// Offset of the first input element of the output elements with outer index
+// `outer_ix`.
+int64_t outer_offset(const ReducePlan& plan, int64_t outer_ix) {
+  int64_t offset = 0;
+  for (int64_t g = plan.num_outer_groups - 1; g >= 0; --g) {
+    offset += (outer_ix % plan.outer_sizes[g]) * plan.outer_strides[g];
+    outer_ix /= plan.outer_sizes[g];
+  }
+  return offset;
+}
+
+// Calls `fn(offset)` with the offset, relative to the first input element of
+// an output element, of each row (or element, for an outer reduction) that it
+// reduces over.
+template <typename Fn>
+void for_each_reduce_offset(const ReducePlan& plan, const Fn& fn) {
+  int64_t index[kTensorDimensionLimit] = {0};
+  int64_t offset = 0;
+  while (true) {
+    fn(offset);
+    int64_t g = plan.num_reduce_groups - 1;
+    for (; g >= 0; --g) {
+      offset += plan.reduce_strides[g];
+      if (++index[g] < plan.reduce_sizes[g]) {
+        break;
+      }
+      offset -= plan.reduce_strides[g] * plan.reduce_sizes[g];
+      index[g] = 0;
+    }
+    if (g < 0) {
+      return;
+    }
+  }
+}
+
+/**
+ * Reduces map(x, center) over the input elements of each output element in
+ * [begin, end) and writes finish(result) to it. `center` is centers[i] for
+ * output element i, or zero when `centers` is null; it may alias `out`.
+ */
+template <typename Reducer, typename T, typename MapOp, typename FinishOp>
+void reduce_over_plan(
+    const ReducePlan& plan,
+    const T* in,
+    T* out,
+    const T* centers,
+    int64_t begin,
+    int64_t end,
+    const MapOp& map,
+    const FinishOp& finish) {
+  using Vec = executorch::vec::Vectorized<T>;
+  constexpr int64_t kVecSize = Vec::size();
+  const Vec identity(Reducer::identity());
+
+  if (plan.inner_size == 1) {
+    // Inner reduction: each output element reads whole rows, which are
+    // vectorized along.
+    const int64_t n = plan.row_size;
+    for (int64_t i = begin; i < end; ++i) {
+      const T* base = in + outer_offset(plan, i);
+      const Vec center(centers != nullptr ? centers[i] : T(0));
+      typename Reducer::Acc acc(identity);
+      for_each_reduce_offset(plan, [&](int64_t offset) {
+        const T* row = base + offset;
+        int64_t j = 0;
+        for (; j + 4 * kVecSize <= n; j += 4 * kVecSize) {
+          const Vec a = Reducer::combine(
+              map(Vec::loadu(row + j), center),
+              map(Vec::loadu(row + j + kVecSize), center));
+          const Vec b = Reducer::combine(
+              map(Vec::loadu(row + j + 2 * kVecSize), center),
+              map(Vec::loadu(row + j + 3 * kVecSize), center));
+          Reducer::add(acc, Reducer::combine(a, b));
+        }
+        for (; j + kVecSize <= n; j += kVecSize) {
+          Reducer::add(acc, map(Vec::loadu(row + j), center));
+        }
+        if (j < n) {
+          const Vec tail = map(Vec::loadu(row + j, n - j), center);
+          Reducer::add(acc, Vec::set(identity, tail, n - j));
+        }
+      });
+      out[i] = finish(executorch::vec::vec_reduce_all<T>(
+          Reducer::combine, Reducer::result(acc)));
+    }
+    return;
+  }
+
+  // Outer reduction: the output elements that share an outer index are
+  // contiguous, and so are their input elements at each reduction offset, so
+  // vectorize across them. Each pass covers kVecsPerPass vectors of outputs
+  // so that every cache line it loads is fully used.
+  constexpr int64_t kVecsPerPass = 4;
+  const int64_t inner = plan.inner_size;
+  for (int64_t i = begin; i < end;) {
+    const int64_t outer_ix = i / inner;
+    const int64_t pass_end = std::min(
+        {end, (outer_ix + 1) * inner, i + kVecsPerPass * kVecSize});
+    const T* base = in + outer_offset(plan, outer_ix) + (i - outer_ix * inner);
+    const int64_t num_vecs = (pass_end - i + kVecSize - 1) / kVecSize;
+
+    int64_t counts[kVecsPerPass];
+    Vec center[kVecsPerPass];
+    typename Reducer::Acc acc[kVecsPerPass];
+    for (int64_t v = 0; v < num_vecs; ++v) {
+      counts[v] = std::min(kVecSize, pass_end - i - v * kVecSize);
+      center[v] = centers != nullptr
+          ? Vec::loadu(centers + i + v * kVecSize, counts[v])
+          : Vec(T(0));
+      acc[v] = typename Reducer::Acc(identity);
+    }
+    for_each_reduce_offset(plan, [&](int64_t offset) {
+      const T* p = base + offset;
+      for (int64_t v = 0; v < num_vecs; ++v) {
+        Reducer::add(
+            acc[v], map(Vec::loadu(p + v * kVecSize, counts[v]), center[v]));
+      }
+    });
+    for (int64_t v = 0; v < num_vecs; ++v) {
+      finish(Reducer::result(acc[v])).store(out + i + v * kVecSize, counts[v]);
+    }
+    i = pass_end;
+  }
+}
+
+void sum_kernel(
+    ScalarType dtype,
+    const void* in,
+    void* out,
+    const ReducePlan& plan,
+    double divisor,
+    int64_t begin,
+    int64_t end) {
+  ET_SWITCH_FLOAT_TYPES(dtype, nullptr, "sum", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    const CTYPE d = static_cast<CTYPE>(divisor);
+    reduce_over_plan<SumReducer<CTYPE>>(
+        plan,
+        static_cast<const CTYPE*>(in),
+        static_cast<CTYPE*>(out),
+        /*centers=*/static_cast<const CTYPE*>(nullptr),
+        begin,
+        end,
+        [](const Vec& x, const Vec&) { return x; },
+        [d](auto x) { return x / decltype(x)(d); });
+  });
+}
+
+void var_kernel(
+    ScalarType dtype,
+    const void* in,
+    void* out,
+    const ReducePlan& plan,
+    double denominator,
+    int64_t begin,
+    int64_t end) {
+  ET_SWITCH_FLOAT_TYPES(dtype, nullptr, "var", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    const CTYPE* in_data = static_cast<const CTYPE*>(in);
+    CTYPE* out_data = static_cast<CTYPE*>(out);
+    // Two passes, for accuracy: the means go to `out` first, then each is
+    // replaced by the variance around it.
+    const CTYPE n = static_cast<CTYPE>(plan.reduce_numel);
+    reduce_over_plan<SumReducer<CTYPE>>(
+        plan,
+        in_data,
+        out_data,
+        /*centers=*/static_cast<const CTYPE*>(nullptr),
+        begin,
+        end,
+        [](const Vec& x, const Vec&) { return x; },
+        [n](auto x) { return x / decltype(x)(n); });
+    const CTYPE d = static_cast<CTYPE>(denominator);
+    reduce_over_plan<SumReducer<CTYPE>>(
+        plan,
+        in_data,
+        out_data,
+        /*centers=*/out_data,
+        begin,
+        end,
+        [](const Vec& x, const Vec& mean) {
+          const Vec diff = x - mean;
+          return diff * diff;
+        },
+        [d](auto x) { return x / decltype(x)(d); });
+  });
+}
+
+void amax_kernel(
+    ScalarType dtype,
+    const void* in,
+    void* out,
+    const ReducePlan& plan,
+    int64_t begin,
+    int64_t end) {
+  ET_SWITCH_FLOAT_TYPES(dtype, nullptr, "amax", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    reduce_over_plan<MaxReducer<CTYPE>>(
+        plan,
+        static_cast<const CTYPE*>(in),
+        static_cast<CTYPE*>(out),
+        /*centers=*/static_cast<const CTYPE*>(nullptr),
+        begin,
+        end,
+        [](const Vec& x, const Vec&) { return x; },
+        [](auto x) { return x; });
+  });
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(sum_stub, &sum_kernel);
+ET_REGISTER_DISPATCH(var_stub, &var_kernel);
+ET_REGISTER_DISPATCH(amax_stub, &amax_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <executorch/kernels/optimized/cpu/softmax_utils.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+/**
+ * Softmax over `dim_size` contiguous elements, i.e. when `dim` is the
+ * innermost dimension. Reads the input twice: once for the maximum and the
+ * sum of exponentials together (see softmax_utils.h), and once to write the
+ * output.
+ */
+template <typename CTYPE>
+void softmax_contiguous(const CTYPE* in, CTYPE* out, int64_t dim_size) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const Vec neg_inf(-std::numeric_limits<CTYPE>::infinity());
+
+  CTYPE max_in;
+  CTYPE sum;
+  online_softmax_stats<CTYPE>(
+      [in, neg_inf](int64_t i, int64_t count) {
+        return Vec::set(neg_inf, Vec::loadu(in + i, count), count);
+      },
+      dim_size,
+      &max_in,
+      &sum);
+
+  const Vec max_vec(max_in);
+  const Vec scale_vec(CTYPE(1) / sum);
+  executorch::vec::map<CTYPE>(
+      [max_vec, scale_vec](Vec x) { return (x - max_vec).exp() * scale_vec; },
+      out,
+      in,
+      dim_size);
+}
+
+/**
+ * Softmax over `dim_size` elements `inner_size` apart, for each of the
+ * `inner_size` contiguous positions. Vectorizes across the inner positions,
+ * which are independent, so every load stays contiguous.
+ */
+template <typename CTYPE>
+void softmax_strided(
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t dim_size,
+    int64_t inner_size) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  using Stats = OnlineSoftmaxStats<CTYPE>;
+
+  for (int64_t j = 0; j < inner_size; j += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), inner_size - j);
+    const CTYPE* in_j = in + j;
+    CTYPE* out_j = out + j;
+
+    Stats stats;
+    Vec x[Stats::kBlockSize];
+    for (int64_t d = 0; d < dim_size; d += Stats::kBlockSize) {
+      const int64_t n = std::min(Stats::kBlockSize, dim_size - d);
+      for (int64_t b = 0; b < n; ++b) {
+        x[b] = Vec::loadu(in_j + (d + b) * inner_size, count);
+      }
+      stats.add(x, n);
+    }
+
+    const Vec max_vec = stats.max();
+    const Vec scale_vec = Vec(CTYPE(1)) / stats.sum();
+    for (int64_t d = 0; d < dim_size; ++d) {
+      ((Vec::loadu(in_j + d * inner_size, count) - max_vec).exp() * scale_vec)
+          .store(out_j + d * inner_size, count);
+    }
+  }
+}
+
+/**
+ * Softmax of Half or BFloat16 elements, for which Vectorized has no
+ * arithmetic. Widens each element to float and keeps the maximum and the sum
+ * of exponentials in float, for up to kChunk inner positions at a time so that
+ * the loads stay contiguous.
+ */
+template <typename CTYPE>
+void softmax_reduced_precision(
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t dim_size,
+    int64_t inner_size) {
+  constexpr int64_t kChunk = 64;
+  float max_in[kChunk];
+  float sum[kChunk];
+
+  for (int64_t j = 0; j < inner_size; j += kChunk) {
+    const int64_t n = std::min(kChunk, inner_size - j);
+    std::fill(max_in, max_in + n, -std::numeric_limits<float>::infinity());
+    std::fill(sum, sum + n, 0.0f);
+    for (int64_t d = 0; d < dim_size; ++d) {
+      const CTYPE* in_d = in + d * inner_size + j;
+      for (int64_t b = 0; b < n; ++b) {
+        max_in[b] = std::max(max_in[b], static_cast<float>(in_d[b]));
+      }
+    }
+    for (int64_t d = 0; d < dim_size; ++d) {
+      const CTYPE* in_d = in + d * inner_size + j;
+      for (int64_t b = 0; b < n; ++b) {
+        sum[b] += std::exp(static_cast<float>(in_d[b]) - max_in[b]);
+      }
+    }
+    for (int64_t d = 0; d < dim_size; ++d) {
+      const CTYPE* in_d = in + d * inner_size + j;
+      CTYPE* out_d = out + d * inner_size + j;
+      for (int64_t b = 0; b < n; ++b) {
+        out_d[b] = static_cast<CTYPE>(
+            std::exp(static_cast<float>(in_d[b]) - max_in[b]) / sum[b]);
+      }
+    }
+  }
+}
+
+/**
+ * Softmax over each of the rows [row_begin, row_end) of `dim_size`
+ * contiguous elements, ignoring the elements whose `mask` entry is true.
+ * Row r uses mask row (r / mask_row_repeat) % mask_rows. Rows whose elements
+ * are all masked are set to zero.
+ */
+template <typename CTYPE>
+void masked_softmax_rows(
+    const CTYPE* in,
+    const bool* mask,
+    CTYPE* out,
+    int64_t row_begin,
+    int64_t row_end,
+    int64_t dim_size,
+    int64_t mask_rows,
+    int64_t mask_row_repeat) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  constexpr int64_t kVecSize = Vec::size();
+  const Vec zero(CTYPE(0));
+  const Vec neg_inf(-std::numeric_limits<CTYPE>::infinity());
+
+  for (int64_t r = row_begin; r < row_end; ++r) {
+    const CTYPE* in_r = in + r * dim_size;
+    CTYPE* out_r = out + r * dim_size;
+    const bool* mask_r =
+        mask + ((r / mask_row_repeat) % mask_rows) * dim_size;
+
+    // Returns elements [i, i + count) of the row, with -inf in the lanes that
+    // are masked or past `count`.
+    const auto load = [&](int64_t i, int64_t count) {
+      __at_align__ CTYPE hidden[kVecSize];
+      for (int64_t l = 0; l < kVecSize; ++l) {
+        hidden[l] = l >= count || mask_r[i + l] ? CTYPE(1) : CTYPE(0);
+      }
+      return Vec::blendv(
+          Vec::loadu(in_r + i, count), neg_inf, Vec::loadu(hidden) != zero);
+    };
+
+    CTYPE max_in;
+    CTYPE sum;
+    online_softmax_stats<CTYPE>(load, dim_size, &max_in, &sum);
+
+    if (sum == CTYPE(0)) {
+      std::fill(out_r, out_r + dim_size, CTYPE(0));
+      continue;
+    }
+    const Vec max_vec(max_in);
+    const Vec scale_vec(CTYPE(1) / sum);
+    for (int64_t i = 0; i < dim_size; i += kVecSize) {
+      const int64_t count = std::min(kVecSize, dim_size - i);
+      ((load(i, count) - max_vec).exp() * scale_vec).store(out_r + i, count);
+    }
+  }
+}
+
+void softmax_kernel(
+    exec_aten::ScalarType dtype,
+    const void* input,
+    void* out,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size) {
+  const int64_t outer_stride = dim_size * inner_size;
+  if (dtype == exec_aten::ScalarType::Half ||
+      dtype == exec_aten::ScalarType::BFloat16) {
+    ET_SWITCH_TWO_TYPES(
+        Half, BFloat16, dtype, nullptr, "_softmax", CTYPE, [&]() {
+          const CTYPE* const in_data = static_cast<const CTYPE*>(input);
+          CTYPE* const out_data = static_cast<CTYPE*>(out);
+          for (int64_t i = 0; i < outer_size; ++i) {
+            softmax_reduced_precision(
+                in_data + i * outer_stride,
+                out_data + i * outer_stride,
+                dim_size,
+                inner_size);
+          }
+        });
+    return;
+  }
+  ET_SWITCH_FLOAT_TYPES(dtype, nullptr, "_softmax", CTYPE, [&]() {
+    const CTYPE* const in_data = static_cast<const CTYPE*>(input);
+    CTYPE* const out_data = static_cast<CTYPE*>(out);
+    for (int64_t i = 0; i < outer_size; ++i) {
+      const CTYPE* in_i = in_data + i * outer_stride;
+      CTYPE* out_i = out_data + i * outer_stride;
+      if (inner_size == 1) {
+        softmax_contiguous(in_i, out_i, dim_size);
+      } else {
+        softmax_strided(in_i, out_i, dim_size, inner_size);
+      }
+    }
+  });
+}
+
+void masked_softmax_kernel(
+    exec_aten::ScalarType dtype,
+    const void* input,
+    const bool* mask,
+    void* out,
+    int64_t row_begin,
+    int64_t row_end,
+    int64_t dim_size,
+    int64_t mask_rows,
+    int64_t mask_row_repeat) {
+  ET_SWITCH_FLOAT_TYPES(dtype, nullptr, "_masked_softmax", CTYPE, [&]() {
+    masked_softmax_rows(
+        static_cast<const CTYPE*>(input),
+        mask,
+        static_cast<CTYPE*>(out),
+        row_begin,
+        row_end,
+        dim_size,
+        mask_rows,
+        mask_row_repeat);
+  });
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(softmax_stub, &softmax_kernel);
+ET_REGISTER_DISPATCH(masked_softmax_stub, &masked_softmax_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <cstdint>
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+// 4-byte elements are moved as floats where the vec library has a shuffle
+// based transpose_mxn for them. Those only move bits around, so they are fine
+// for any 4-byte element. Elsewhere the generic transpose_mxn is used, on
+// integers so that no floating point value is ever loaded.
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+using Word32 = float;
+constexpr int64_t kBlock32 = 16;
+#elif (defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)) || \
+    (defined(__aarch64__) && !defined(CPU_CAPABILITY_SVE256))
+using Word32 = float;
+constexpr int64_t kBlock32 = 8;
+#else
+using Word32 = uint32_t;
+constexpr int64_t kBlock32 = 8;
+#endif
+
+// Edge of the blocks handed to transpose_mxn for other element sizes.
+constexpr int64_t kBlock = 8;
+
+// Largest edge of the leaves of the recursion: a leaf's source and
+// destination then take at most 64 * 64 * 8 bytes each, and the source rows
+// that a column of blocks reads stay in cache until the next column.
+constexpr int64_t kLeafSize = 64;
+
+template <typename T, int64_t kBlockSize>
+void transpose_leaf(
+    const T* src,
+    int64_t ld_src,
+    T* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols) {
+  const int64_t full_rows = rows - rows % kBlockSize;
+  const int64_t full_cols = cols - cols % kBlockSize;
+  for (int64_t i = 0; i < full_rows; i += kBlockSize) {
+    for (int64_t j = 0; j < full_cols; j += kBlockSize) {
+      executorch::vec::transpose_mxn<T, kBlockSize, kBlockSize>(
+          src + i * ld_src + j, ld_src, dst + j * ld_dst + i, ld_dst);
+    }
+    for (int64_t ii = i; ii < i + kBlockSize; ++ii) {
+      for (int64_t j = full_cols; j < cols; ++j) {
+        dst[j * ld_dst + ii] = src[ii * ld_src + j];
+      }
+    }
+  }
+  for (int64_t i = full_rows; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      dst[j * ld_dst + i] = src[i * ld_src + j];
+    }
+  }
+}
+
+/**
+ * Cache-oblivious transpose: halves the longer side, on a block boundary,
+ * until both sides fit in a leaf. Every level of the cache then ends up
+ * holding whole sub-matrices of the source and destination at once, whatever
+ * its size.
+ */
+template <typename T, int64_t kBlockSize>
+void transpose_recursive(
+    const T* src,
+    int64_t ld_src,
+    T* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols) {
+  while (rows > kLeafSize || cols > kLeafSize) {
+    if (rows >= cols) {
+      const int64_t half =
+          (rows / 2 + kBlockSize - 1) / kBlockSize * kBlockSize;
+      transpose_recursive<T, kBlockSize>(src, ld_src, dst, ld_dst, half, cols);
+      src += half * ld_src;
+      dst += half;
+      rows -= half;
+    } else {
+      const int64_t half =
+          (cols / 2 + kBlockSize - 1) / kBlockSize * kBlockSize;
+      transpose_recursive<T, kBlockSize>(src, ld_src, dst, ld_dst, rows, half);
+      src += half;
+      dst += half * ld_dst;
+      cols -= half;
+    }
+  }
+  transpose_leaf<T, kBlockSize>(src, ld_src, dst, ld_dst, rows, cols);
+}
+
+template <typename T, int64_t kBlockSize>
+void transpose_typed(
+    const void* src,
+    int64_t ld_src,
+    void* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols) {
+  transpose_recursive<T, kBlockSize>(
+      static_cast<const T*>(src),
+      ld_src,
+      static_cast<T*>(dst),
+      ld_dst,
+      rows,
+      cols);
+}
+
+void transpose_kernel(
+    size_t element_size,
+    const void* src,
+    int64_t ld_src,
+    void* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols) {
+  switch (element_size) {
+    case 1:
+      transpose_typed<uint8_t, kBlock>(src, ld_src, dst, ld_dst, rows, cols);
+      return;
+    case 2:
+      transpose_typed<uint16_t, kBlock>(src, ld_src, dst, ld_dst, rows, cols);
+      return;
+    case 4:
+      transpose_typed<Word32, kBlock32>(src, ld_src, dst, ld_dst, rows, cols);
+      return;
+    case 8:
+      transpose_typed<uint64_t, kBlock>(src, ld_src, dst, ld_dst, rows, cols);
+      return;
+    default:
+      break;
+  }
+  const char* src_bytes = static_cast<const char*>(src);
+  char* dst_bytes = static_cast<char*>(dst);
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      memcpy(
+          dst_bytes + (j * ld_dst + i) * element_size,
+          src_bytes + (i * ld_src + j) * element_size,
+          element_size);
+    }
+  }
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(transpose_stub, &transpose_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
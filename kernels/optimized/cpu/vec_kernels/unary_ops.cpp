@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability; see dispatch_stub.h.
+
+#include <cmath>
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+inline namespace CPU_CAPABILITY {
+namespace {
+
+using ScalarType = exec_aten::ScalarType;
+
+void exp_kernel(ScalarType dtype, void* out, const void* in, size_t n) {
+  ET_SWITCH_FLOAT_TYPES(dtype, nullptr, "exp", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    executorch::vec::map<CTYPE>(
+        [](Vec x) { return x.exp(); },
+        static_cast<CTYPE*>(out),
+        static_cast<const CTYPE*>(in),
+        n);
+  });
+}
+
+// Defines `<name>_kernel`, which maps `<name>`, a method of Vectorized, over
+// Float or Double elements.
+#define DEFINE_FLOAT_UNARY_KERNEL(name)                         \
+  void name##_kernel(                                           \
+      ScalarType dtype, void* out, const void* in, size_t n) {  \
+    ET_SWITCH_FLOAT_TYPES(dtype, nullptr, #name, CTYPE, [&]() { \
+      using Vec = executorch::vec::Vectorized<CTYPE>;           \
+      executorch::vec::map<CTYPE>(                              \
+          [](Vec x) { return x.name(); },                       \
+          static_cast<CTYPE*>(out),                             \
+          static_cast<const CTYPE*>(in),                        \
+          n);                                                   \
+    });                                                         \
+  }
+
+DEFINE_FLOAT_UNARY_KERNEL(log)
+DEFINE_FLOAT_UNARY_KERNEL(tanh)
+DEFINE_FLOAT_UNARY_KERNEL(erf)
+DEFINE_FLOAT_UNARY_KERNEL(sin)
+DEFINE_FLOAT_UNARY_KERNEL(cos)
+
+#undef DEFINE_FLOAT_UNARY_KERNEL
+
+void sigmoid_kernel(ScalarType dtype, void* out, const void* in, size_t n) {
+  ET_SWITCH_FLOAT_TYPES(dtype, nullptr, "sigmoid", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    const Vec one(1);
+    executorch::vec::map<CTYPE>(
+        [one](Vec x) { return one / (one + x.neg().exp()); },
+        static_cast<CTYPE*>(out),
+        static_cast<const CTYPE*>(in),
+        n);
+  });
+}
+
+void neg_kernel(ScalarType dtype, void* out, const void* in, size_t n) {
+  ET_SWITCH_REAL_TYPES(dtype, nullptr, "neg", CTYPE, [&]() {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    executorch::vec::map<CTYPE>(
+        [](Vec x) { return x.neg(); },
+        static_cast<CTYPE*>(out),
+        static_cast<const CTYPE*>(in),
+        n);
+  });
+}
+
+void gelu_kernel(
+    const float* in,
+    float* out,
+    size_t n,
+    bool approximate_tanh) {
+  using Vec = executorch::vec::Vectorized<float>;
+  const Vec half(0.5f);
+  const Vec one(1.0f);
+  if (approximate_tanh) {
+    // 0.5 * x * (1 + Tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))
+    const Vec beta(M_SQRT2 * M_2_SQRTPI * 0.5);
+    const Vec kappa(0.044715f);
+    executorch::vec::map<float>(
+        [half, one, beta, kappa](Vec x) {
+          const Vec inner = beta * executorch::vec::fmadd(kappa * x, x * x, x);
+          return half * x * (one + inner.tanh());
+        },
+        out,
+        in,
+        n);
+  } else {
+    // GELU(x) = x * Φ(x) where Φ(x) is the is the Cumulative Distribution
+    // Function for Gaussian Distribution.
+    const Vec sqrt1_2(M_SQRT1_2);
+    executorch::vec::map<float>(
+        [half, one, sqrt1_2](Vec x) {
+          return half * x * (one + (x * sqrt1_2).erf());
+        },
+        out,
+        in,
+        n);
+  }
+}
+
+} // namespace
+} // namespace CPU_CAPABILITY
+
+ET_REGISTER_DISPATCH(exp_stub, &exp_kernel);
+ET_REGISTER_DISPATCH(neg_stub, &neg_kernel);
+ET_REGISTER_DISPATCH(log_stub, &log_kernel);
+ET_REGISTER_DISPATCH(tanh_stub, &tanh_kernel);
+ET_REGISTER_DISPATCH(sigmoid_stub, &sigmoid_kernel);
+ET_REGISTER_DISPATCH(erf_stub, &erf_kernel);
+ET_REGISTER_DISPATCH(sin_stub, &sin_kernel);
+ET_REGISTER_DISPATCH(cos_stub, &cos_kernel);
+ET_REGISTER_DISPATCH(gelu_stub, &gelu_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -1,4 +1,5 @@
 load("@fbsource//tools/build_defs:default_platform_defs.bzl", "DEVSERVER_PLATFORM_REGEX")
+load("@fbsource//xplat/executorch/backends/xnnpack/third-party:third_party_libs.bzl", "third_party_dep")
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 
 # Because vec exists as a collection of header files, compile and preprocessor
@@ -37,6 +38,97 @@ def get_vec_fbcode_preprocessor_flags():
     ]
     return preprocessor_flags
 
+# The x86 and aarch64 CPU capabilities that get_cpu_capability() in
+# kernels/optimized/cpu/dispatch_stub.h can select, and the compiler flags that
+# the kernels built for each one need. The DEFAULT capability uses the flags of
+# the platform.
+_X86_CPU_CAPABILITY_FLAGS = {
+    "AVX2": ["-mavx2", "-mfma", "-mf16c"],
+    "AVX512": ["-mavx512f", "-mavx512bw", "-mavx512dq", "-mavx512vl", "-mfma"],
+}
+
+_ARM64_CPU_CAPABILITY_FLAGS = {
+    "SVE256": ["-march=armv8.2-a+sve", "-msve-vector-bits=256"],
+}
+
+def _define_capability_variants(name, srcs, deps, capability_flags, sleef_dep):
+    variants = []
+    for capability, compiler_flags in capability_flags.items():
+        variant = "{}_{}".format(name, capability)
+        runtime.cxx_library(
+            name = variant,
+            srcs = srcs,
+            deps = deps + [sleef_dep],
+            preprocessor_flags = [
+                "-DCPU_CAPABILITY={}".format(capability),
+                "-DCPU_CAPABILITY_{}".format(capability),
+            ],
+            compiler_flags = compiler_flags,
+            # @lint-ignore BUCKLINT link_whole
+            link_whole = True,
+        )
+        variants.append(":{}".format(variant))
+    return variants
+
+def define_dispatched_library(name, srcs, deps = [], visibility = []):
+    """Defines a library of kernels that are picked at runtime by CPU capability.
+
+    Each of `srcs` is compiled once for the DEFAULT capability and once more for
+    each of AVX2 and AVX512 on x86, or for SVE256 on aarch64. The sources
+    register themselves into DispatchStubs (see
+    kernels/optimized/cpu/dispatch_stub.h) with static initializers, so every
+    variant is linked whole.
+
+    Args:
+        name: The name of the target that links all of the variants.
+        srcs: Sources that use ET_REGISTER_DISPATCH.
+        deps: Deps of every variant.
+        visibility: Visibility of `name`.
+    """
+    runtime.cxx_library(
+        name = "{}_DEFAULT".format(name),
+        srcs = srcs,
+        deps = deps,
+        preprocessor_flags = ["-DCPU_CAPABILITY=DEFAULT"],
+        fbandroid_platform_preprocessor_flags = get_vec_android_preprocessor_flags(),
+        fbandroid_platform_deps = [
+            (
+                "^android-arm64.*$",
+                [
+                    "fbsource//third-party/sleef:sleef_arm",
+                ],
+            ),
+        ],
+        # @lint-ignore BUCKLINT link_whole
+        link_whole = True,
+    )
+
+    x86_variants = _define_capability_variants(
+        name,
+        srcs,
+        deps,
+        _X86_CPU_CAPABILITY_FLAGS,
+        "fbsource//third-party/sleef:sleef",
+    )
+    arm64_variants = _define_capability_variants(
+        name,
+        srcs,
+        deps,
+        _ARM64_CPU_CAPABILITY_FLAGS,
+        "fbsource//third-party/sleef:sleef_arm",
+    )
+
+    runtime.cxx_library(
+        name = name,
+        srcs = [],
+        visibility = visibility,
+        exported_deps = [":{}_DEFAULT".format(name)] + select({
+            "DEFAULT": [],
+            "ovr_config//cpu:arm64": arm64_variants,
+            "ovr_config//cpu:x86_64": x86_variants,
+        }),
+    )
+
 # Currently, having a dependency on fbsource//third-party/sleef:sleef may cause
 # duplicate symbol errors when linking fbcode targets in opt mode that also
 # depend on ATen. This is because ATen accesses sleef via the third-party folder
@@ -100,20 +192,43 @@ def define_libs():
     )
 
     runtime.cxx_library(
-        name = "libblas",
-        srcs = native.glob([
-            "blas/**/*.cpp",
-        ]),
+        name = "libblas_headers",
         exported_headers = native.glob([
             "blas/**/*.h",
         ]),
         header_namespace = "executorch/kernels/optimized",
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libutils",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/optimized/cpu:dispatch_stub",
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+    )
+
+    # The packed GEMM used by builds without a BLAS, compiled per CPU
+    # capability.
+    define_dispatched_library(
+        name = "libblas_kernels",
+        srcs = native.glob([
+            "blas/gemm_kernels/*.cpp",
+        ]),
+        deps = [
+            ":libblas_headers",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "libblas",
+        srcs = native.glob([
+            "blas/*.cpp",
+        ]),
         visibility = [
             "//executorch/...",
             "@EXECUTORCH_CLIENTS",
         ],
         # TODO(ssjia): Link with Accelerate for Apple builds
-        fbandroid_platform_preprocessor_flags = [
+        fbandroid_platform_preprocessor_flags = get_vec_android_preprocessor_flags() + [
             (
                 "^android-arm64.*$",
                 [
@@ -130,6 +245,19 @@ def define_libs():
             ),
         ],
         exported_deps = [
-            "//executorch/kernels/optimized:libutils",
+            ":libblas_headers",
         ],
+        deps = [
+            ":libblas_kernels",
+            "//executorch/runtime/platform:platform",
+        ] + select({
+            # GemmTuner.cpp identifies the CPU with cpuinfo.
+            "DEFAULT": [],
+            "ovr_config//cpu:arm64": [
+                third_party_dep("cpuinfo"),
+            ],
+            "ovr_config//cpu:x86_64": [
+                third_party_dep("cpuinfo"),
+            ],
+        }),
     )
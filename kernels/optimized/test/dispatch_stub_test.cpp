@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/kernels/optimized/cpu/dispatch_stub.h>
+#include <executorch/test/utils/DeathTest.h>
+
+using torch::executor::native::CPUCapability;
+using torch::executor::native::DispatchStub;
+using torch::executor::native::get_cpu_capability;
+
+namespace {
+
+using fn_type = int (*)(int);
+
+int default_fn(int x) {
+  return x;
+}
+
+int avx2_fn(int x) {
+  return 2 * x;
+}
+
+int avx512_fn(int x) {
+  return 3 * x;
+}
+
+int sve256_fn(int x) {
+  return 4 * x;
+}
+
+ET_DEFINE_DISPATCH(fn_type, registered_stub);
+ET_REGISTER_DISPATCH(registered_stub, &avx2_fn);
+
+} // namespace
+
+TEST(DispatchStubTest, FallsBackToLessCapableImpls) {
+  DispatchStub<fn_type> stub;
+  stub.set(CPUCapability::DEFAULT, &default_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::DEFAULT), &default_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::AVX2), &default_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::AVX512), &default_fn);
+
+  stub.set(CPUCapability::AVX2, &avx2_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::DEFAULT), &default_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::AVX2), &avx2_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::AVX512), &avx2_fn);
+
+  stub.set(CPUCapability::AVX512, &avx512_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::AVX2), &avx2_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::AVX512), &avx512_fn);
+}
+
+TEST(DispatchStubTest, DoesNotFallBackAcrossArchitectures) {
+  DispatchStub<fn_type> stub;
+  stub.set(CPUCapability::DEFAULT, &default_fn);
+  stub.set(CPUCapability::AVX2, &avx2_fn);
+  stub.set(CPUCapability::AVX512, &avx512_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::SVE256), &default_fn);
+
+  stub.set(CPUCapability::SVE256, &sve256_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::SVE256), &sve256_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::AVX512), &avx512_fn);
+  EXPECT_EQ(stub.choose(CPUCapability::DEFAULT), &default_fn);
+}
+
+TEST(DispatchStubTest, CallsImplForCurrentCpu) {
+  DispatchStub<fn_type> stub;
+  stub.set(CPUCapability::DEFAULT, &default_fn);
+  stub.set(CPUCapability::AVX2, &avx2_fn);
+  stub.set(CPUCapability::AVX512, &avx512_fn);
+
+  const int expected = stub.choose(get_cpu_capability())(7);
+  EXPECT_EQ(stub(7), expected);
+  EXPECT_EQ(get_cpu_capability(), get_cpu_capability());
+}
+
+TEST(DispatchStubTest, RegistersForCapabilityOfTranslationUnit) {
+  EXPECT_EQ(registered_stub.choose(ET_CPU_CAPABILITY_VALUE), &avx2_fn);
+}
+
+TEST(DispatchStubTest, MissingDefaultImplDies) {
+  DispatchStub<fn_type> stub;
+  ET_EXPECT_DEATH(stub.choose(CPUCapability::DEFAULT), "");
+}
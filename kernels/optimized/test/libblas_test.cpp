@@ -9,7 +9,11 @@
 #include <gtest/gtest.h>
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/blas/GemmTuner.h>
 
+#include <cstdio>
+#include <fstream>
+#include <string>
 #include <vector>
 
 #define TEST_FORALL_SUPPORTED_CTYPES(_, N) \
@@ -74,3 +78,163 @@ void test_matmul_ones() {
 TEST(BlasTest, MatmulOnes) {
   TEST_FORALL_SUPPORTED_CTYPES(test_matmul_ones, 25);
 }
+
+namespace {
+
+// Fill a vector with small integers, so that every product and sum in a gemm
+// of the sizes below is exact.
+template <typename T>
+void fill_pattern(std::vector<T>& arr, int64_t seed) {
+  for (size_t i = 0; i < arr.size(); ++i) {
+    arr[i] = static_cast<T>(static_cast<int64_t>((i * 7 + seed) % 5) - 2);
+  }
+}
+
+// Column-major reference for c = alpha * op(a) @ op(b) + beta * c.
+template <typename T>
+void reference_gemm(
+    executorch::cpublas::TransposeType transa,
+    executorch::cpublas::TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    const T* a,
+    int64_t lda,
+    const T* b,
+    int64_t ldb,
+    T beta,
+    T* c,
+    int64_t ldc) {
+  using executorch::cpublas::TransposeType;
+  for (int64_t j = 0; j < n; ++j) {
+    for (int64_t i = 0; i < m; ++i) {
+      T sum = 0;
+      for (int64_t l = 0; l < k; ++l) {
+        const T a_il = transa == TransposeType::NoTranspose ? a[i + l * lda]
+                                                            : a[l + i * lda];
+        const T b_lj = transb == TransposeType::NoTranspose ? b[l + j * ldb]
+                                                            : b[j + l * ldb];
+        sum += a_il * b_lj;
+      }
+      c[i + j * ldc] = alpha * sum + beta * c[i + j * ldc];
+    }
+  }
+}
+
+} // namespace
+
+template <class CTYPE>
+void test_matmul_matches_reference(
+    executorch::cpublas::TransposeType transa,
+    executorch::cpublas::TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k) {
+  using executorch::cpublas::TransposeType;
+
+  const int64_t lda = transa == TransposeType::NoTranspose ? m : k;
+  const int64_t ldb = transb == TransposeType::NoTranspose ? k : n;
+  std::vector<CTYPE> a(m * k);
+  fill_pattern(a, 1);
+  std::vector<CTYPE> b(k * n);
+  fill_pattern(b, 2);
+  std::vector<CTYPE> out(m * n);
+  fill_pattern(out, 3);
+  std::vector<CTYPE> expected = out;
+
+  const CTYPE alpha = 2;
+  const CTYPE beta = -1;
+  reference_gemm(
+      transa,
+      transb,
+      m,
+      n,
+      k,
+      alpha,
+      a.data(),
+      lda,
+      b.data(),
+      ldb,
+      beta,
+      expected.data(),
+      m);
+  executorch::cpublas::gemm(
+      transa,
+      transb,
+      m,
+      n,
+      k,
+      alpha,
+      a.data(),
+      lda,
+      b.data(),
+      ldb,
+      beta,
+      out.data(),
+      m);
+
+  EXPECT_EQ(out, expected) << "m=" << m << " n=" << n << " k=" << k;
+}
+
+template <class CTYPE>
+void test_matmul_matches_reference_all_shapes() {
+  using executorch::cpublas::TransposeType;
+  // Sizes on both sides of the micro-kernel tile and cache block edges,
+  // including a reduction longer than one block.
+  const int64_t sizes[][3] = {
+      {1, 1, 1}, {3, 5, 7}, {17, 9, 13}, {33, 70, 5}, {70, 33, 150}};
+  for (TransposeType transa :
+       {TransposeType::NoTranspose, TransposeType::Transpose}) {
+    for (TransposeType transb :
+         {TransposeType::NoTranspose, TransposeType::Transpose}) {
+      for (const auto& size : sizes) {
+        test_matmul_matches_reference<CTYPE>(
+            transa, transb, size[0], size[1], size[2]);
+      }
+    }
+  }
+}
+
+TEST(BlasTest, MatmulMatchesReference) {
+  test_matmul_matches_reference_all_shapes<double>();
+  test_matmul_matches_reference_all_shapes<float>();
+}
+
+TEST(BlasTest, TunedMatmulMatchesReference) {
+  const std::string cache_path =
+      ::testing::TempDir() + "libblas_test_gemm_tuning_cache.txt";
+  std::remove(cache_path.c_str());
+
+  EXPECT_TRUE(executorch::cpublas::enable_gemm_tuning(cache_path.c_str()));
+  test_matmul_matches_reference_all_shapes<double>();
+  test_matmul_matches_reference_all_shapes<float>();
+  // Tuned blockings are reused on later calls.
+  test_matmul_matches_reference_all_shapes<float>();
+  executorch::cpublas::disable_gemm_tuning();
+
+  // Every tuned shape was persisted once, under this CPU's identity.
+  std::ifstream cache(cache_path);
+  std::string line;
+  size_t num_entries = 0;
+  const std::string prefix =
+      std::string(executorch::cpublas::gemm_tuning_cpu_id()) + "\t";
+  while (std::getline(cache, line)) {
+    EXPECT_EQ(line.compare(0, prefix.size(), prefix), 0) << line;
+    num_entries++;
+  }
+  // 5 sizes by 4 transpose combinations, for each of the 2 dtypes.
+  EXPECT_EQ(num_entries, 40);
+
+  // Loading the cache skips tuning, so nothing is appended.
+  EXPECT_TRUE(executorch::cpublas::enable_gemm_tuning(cache_path.c_str()));
+  test_matmul_matches_reference_all_shapes<float>();
+  executorch::cpublas::disable_gemm_tuning();
+  std::ifstream reloaded(cache_path);
+  num_entries = 0;
+  while (std::getline(reloaded, line)) {
+    num_entries++;
+  }
+  EXPECT_EQ(num_entries, 40);
+  std::remove(cache_path.c_str());
+}
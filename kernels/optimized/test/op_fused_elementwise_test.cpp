@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/NativeFunctions.h> // Declares the fused operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::opt_fused_elementwise_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+// Opcodes of exir/passes/fuse_elementwise_pass.py
+constexpr int64_t LOAD_INPUT = 0;
+constexpr int64_t LOAD_CONST = 1;
+constexpr int64_t ADD = 2;
+constexpr int64_t SUB = 3;
+constexpr int64_t MUL = 4;
+constexpr int64_t DIV = 5;
+constexpr int64_t RELU = 9;
+constexpr int64_t SIGMOID = 11;
+
+class OpFusedElementwiseTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  Tensor& op_fused_elementwise_out(
+      const std::vector<Tensor>& inputs,
+      const std::vector<int64_t>& code,
+      const std::vector<double>& constants,
+      Tensor& out) {
+    return opt_fused_elementwise_out(
+        context_,
+        ArrayRef<Tensor>(inputs.data(), inputs.size()),
+        ArrayRef<int64_t>(code.data(), code.size()),
+        ArrayRef<double>(constants.data(), constants.size()),
+        out);
+  }
+
+  RuntimeContext context_{};
+};
+
+} // namespace
+
+TEST_F(OpFusedElementwiseTest, MulAddRelu) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({2, 3}, {-3, -2, -1, 1, 2, 3});
+  Tensor y = tf.make({2, 3}, {1, 2, 3, 4, 5, 6});
+  Tensor out = tf.zeros({2, 3});
+
+  // relu(x * y + 2.5)
+  op_fused_elementwise_out(
+      {x, y},
+      {LOAD_INPUT, 0, LOAD_INPUT, 1, MUL, LOAD_CONST, 0, ADD, RELU},
+      {2.5},
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({2, 3}, {0, 0, 0, 6.5, 12.5, 20.5}));
+}
+
+TEST_F(OpFusedElementwiseTest, OperandOrder) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({4}, {1, 2, 4, 8});
+  Tensor out = tf.zeros({4});
+
+  // (1 - x) / x
+  op_fused_elementwise_out(
+      {x}, {LOAD_CONST, 0, LOAD_INPUT, 0, SUB, LOAD_INPUT, 0, DIV}, {1}, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({4}, {0, -0.5, -0.75, -0.875}));
+}
+
+TEST_F(OpFusedElementwiseTest, SpansManyBlocks) {
+  // Larger than the interpreter's block size, and not a multiple of it or of
+  // any vector width.
+  const int32_t size = 1000 + 3;
+  std::vector<float> x_data(size);
+  std::vector<float> expected(size);
+  for (int32_t i = 0; i < size; ++i) {
+    x_data[i] = (i - size / 2) / 100.0f;
+    expected[i] = 1.0f / (1.0f + std::exp(-x_data[i]));
+  }
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({size}, x_data);
+  Tensor out = tf.zeros({size});
+
+  op_fused_elementwise_out({x}, {LOAD_INPUT, 0, SIGMOID}, {}, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({size}, expected));
+}
+
+TEST_F(OpFusedElementwiseTest, RejectsUnbalancedCode) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({2});
+  Tensor out = tf.zeros({2});
+
+  // Leaves two values on the stack
+  ET_EXPECT_KERNEL_FAILURE(
+      op_fused_elementwise_out({x}, {LOAD_INPUT, 0, LOAD_INPUT, 0}, {}, out));
+}
+
+TEST_F(OpFusedElementwiseTest, RejectsInvalidOperand) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({2});
+  Tensor out = tf.zeros({2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      op_fused_elementwise_out({x}, {LOAD_INPUT, 1}, {}, out));
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/NativeFunctions.h> // Declares the fused operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::opt_rms_norm_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+class OpRMSNormTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  Tensor&
+  op_rms_norm_out(const Tensor& in, const Tensor& weight, double eps, Tensor& out) {
+    return opt_rms_norm_out(context_, in, weight, eps, out);
+  }
+
+  RuntimeContext context_{};
+};
+
+// x * rsqrt(mean(x^2, -1) + eps) * weight, one row at a time.
+std::vector<float> reference_rms_norm(
+    const std::vector<float>& x,
+    const std::vector<float>& weight,
+    float eps) {
+  const size_t dim = weight.size();
+  std::vector<float> out(x.size());
+  for (size_t row = 0; row < x.size() / dim; ++row) {
+    float sum_squares = 0;
+    for (size_t i = 0; i < dim; ++i) {
+      sum_squares += x[row * dim + i] * x[row * dim + i];
+    }
+    const float scale = 1.0f / std::sqrt(sum_squares / dim + eps);
+    for (size_t i = 0; i < dim; ++i) {
+      out[row * dim + i] = x[row * dim + i] * scale * weight[i];
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+TEST_F(OpRMSNormTest, SmallRows) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({2, 2}, {3, 4, 1, -1});
+  Tensor weight = tf.make({2}, {1, 2});
+  Tensor out = tf.zeros({2, 2});
+
+  // The rows have root mean squares sqrt(12.5) and 1.
+  op_rms_norm_out(x, weight, 0, out);
+  const float s = 1.0f / std::sqrt(12.5f);
+  EXPECT_TENSOR_CLOSE(out, tf.make({2, 2}, {3 * s, 8 * s, 1, -2}));
+}
+
+TEST_F(OpRMSNormTest, MatchesReference) {
+  // Rows not a multiple of any vector width, in a 3-D input.
+  const int32_t rows = 2 * 5;
+  const int32_t dim = 67;
+  std::vector<float> x_data(rows * dim);
+  std::vector<float> weight_data(dim);
+  for (int32_t i = 0; i < rows * dim; ++i) {
+    x_data[i] = std::sin(0.37f * i);
+  }
+  for (int32_t i = 0; i < dim; ++i) {
+    weight_data[i] = 0.5f + i / 100.0f;
+  }
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({2, 5, dim}, x_data);
+  Tensor weight = tf.make({dim}, weight_data);
+  Tensor out = tf.zeros({2, 5, dim});
+
+  op_rms_norm_out(x, weight, 1e-5, out);
+  EXPECT_TENSOR_CLOSE(
+      out,
+      tf.make({2, 5, dim}, reference_rms_norm(x_data, weight_data, 1e-5f)));
+}
+
+TEST_F(OpRMSNormTest, RejectsMismatchedWeight) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({2, 4});
+  Tensor weight = tf.ones({3});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(op_rms_norm_out(x, weight, 1e-5, out));
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/NativeFunctions.h> // Declares the fused operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::opt_rope_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+class OpRopeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  Tensor& op_rope_out(
+      const Tensor& in,
+      const Tensor& freqs_cos,
+      const Tensor& freqs_sin,
+      Tensor& out) {
+    return opt_rope_out(context_, in, freqs_cos, freqs_sin, out);
+  }
+
+  RuntimeContext context_{};
+};
+
+} // namespace
+
+TEST_F(OpRopeTest, RotatesPairs) {
+  TensorFactory<ScalarType::Float> tf;
+  // [batch 1, seq_len 2, n_heads 1, head_dim 4]
+  Tensor x = tf.make({1, 2, 1, 4}, {1, 0, 0, 1, 1, 2, 3, 4});
+  // Position 0 rotates by 90 and 0 degrees, position 1 by 180 and 90.
+  Tensor freqs_cos = tf.make({2, 2}, {0, 1, -1, 0});
+  Tensor freqs_sin = tf.make({2, 2}, {1, 0, 0, 1});
+  Tensor out = tf.zeros({1, 2, 1, 4});
+
+  op_rope_out(x, freqs_cos, freqs_sin, out);
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({1, 2, 1, 4}, {0, 1, 0, 1, -1, -2, -4, 3}));
+}
+
+TEST_F(OpRopeTest, MatchesReference) {
+  // A head dim spanning more than one chunk of the kernel and not a multiple
+  // of any vector width, with several heads and batches.
+  const int32_t batch = 2;
+  const int32_t seq_len = 3;
+  const int32_t n_heads = 3;
+  const int32_t head_dim = 2 * 67 + 128;
+  const int32_t half_dim = head_dim / 2;
+  std::vector<float> x_data(batch * seq_len * n_heads * head_dim);
+  std::vector<float> cos_data(seq_len * half_dim);
+  std::vector<float> sin_data(seq_len * half_dim);
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = std::sin(0.31f * i);
+  }
+  for (int32_t s = 0; s < seq_len; ++s) {
+    for (int32_t i = 0; i < half_dim; ++i) {
+      const float angle = s * std::pow(10000.0f, -2.0f * i / head_dim);
+      cos_data[s * half_dim + i] = std::cos(angle);
+      sin_data[s * half_dim + i] = std::sin(angle);
+    }
+  }
+  std::vector<float> expected(x_data.size());
+  for (size_t row = 0; row < x_data.size() / head_dim; ++row) {
+    const int32_t s = (row / n_heads) % seq_len;
+    for (int32_t i = 0; i < half_dim; ++i) {
+      const float x0 = x_data[row * head_dim + 2 * i];
+      const float x1 = x_data[row * head_dim + 2 * i + 1];
+      const float c = cos_data[s * half_dim + i];
+      const float sn = sin_data[s * half_dim + i];
+      expected[row * head_dim + 2 * i] = x0 * c - x1 * sn;
+      expected[row * head_dim + 2 * i + 1] = x0 * sn + x1 * c;
+    }
+  }
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({batch, seq_len, n_heads, head_dim}, x_data);
+  Tensor freqs_cos = tf.make({seq_len, half_dim}, cos_data);
+  Tensor freqs_sin = tf.make({seq_len, half_dim}, sin_data);
+  Tensor out = tf.zeros({batch, seq_len, n_heads, head_dim});
+
+  op_rope_out(x, freqs_cos, freqs_sin, out);
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({batch, seq_len, n_heads, head_dim}, expected));
+}
+
+TEST_F(OpRopeTest, RejectsMismatchedFreqs) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({1, 2, 1, 4});
+  // One position short.
+  Tensor freqs_cos = tf.ones({1, 2});
+  Tensor freqs_sin = tf.ones({1, 2});
+  Tensor out = tf.zeros({1, 2, 1, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(op_rope_out(x, freqs_cos, freqs_sin, out));
+}
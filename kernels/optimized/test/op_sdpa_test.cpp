@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/NativeFunctions.h> // Declares the fused operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::MemoryAllocator;
+using torch::executor::native::opt_sdpa_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+struct Shape {
+  int32_t batches;
+  int32_t heads;
+  int32_t kv_heads;
+  int32_t q_len;
+  int32_t kv_len;
+  int32_t head_dim;
+};
+
+class OpSdpaTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  Tensor& op_sdpa_out(
+      const Tensor& query,
+      const Tensor& key,
+      const Tensor& value,
+      const optional<Tensor>& attn_mask,
+      bool is_causal,
+      optional<double> scale,
+      Tensor& out) {
+    static uint8_t temp_memory[1024 * 1024];
+    MemoryAllocator temp_allocator(sizeof(temp_memory), temp_memory);
+    RuntimeContext context(/*event_tracer=*/nullptr, &temp_allocator);
+    return opt_sdpa_out(
+        context, query, key, value, attn_mask, is_causal, scale, out);
+  }
+
+  // softmax(q k^T / sqrt(head_dim) + mask) v, one query at a time.
+  static std::vector<float> reference_sdpa(
+      const Shape& s,
+      const std::vector<float>& q,
+      const std::vector<float>& k,
+      const std::vector<float>& v,
+      const std::vector<float>* mask,
+      bool is_causal) {
+    const int32_t D = s.head_dim;
+    std::vector<float> out(s.batches * s.heads * s.q_len * D, 0);
+    std::vector<float> scores(s.kv_len);
+    for (int32_t b = 0; b < s.batches; ++b) {
+      for (int32_t h = 0; h < s.heads; ++h) {
+        const int32_t kvh = h / (s.heads / s.kv_heads);
+        for (int32_t i = 0; i < s.q_len; ++i) {
+          const float* qi = &q[((b * s.heads + h) * s.q_len + i) * D];
+          float max_score = -std::numeric_limits<float>::infinity();
+          for (int32_t j = 0; j < s.kv_len; ++j) {
+            const float* kj = &k[((b * s.kv_heads + kvh) * s.kv_len + j) * D];
+            float dot = 0;
+            for (int32_t d = 0; d < D; ++d) {
+              dot += qi[d] * kj[d];
+            }
+            scores[j] = dot / std::sqrt(static_cast<float>(D));
+            if (mask != nullptr) {
+              scores[j] += (*mask)[i * s.kv_len + j];
+            }
+            if (is_causal && j > i + s.kv_len - s.q_len) {
+              scores[j] = -std::numeric_limits<float>::infinity();
+            }
+            max_score = std::max(max_score, scores[j]);
+          }
+          float sum = 0;
+          for (int32_t j = 0; j < s.kv_len; ++j) {
+            scores[j] = std::exp(scores[j] - max_score);
+            sum += scores[j];
+          }
+          float* oi = &out[((b * s.heads + h) * s.q_len + i) * D];
+          for (int32_t j = 0; j < s.kv_len; ++j) {
+            const float* vj = &v[((b * s.kv_heads + kvh) * s.kv_len + j) * D];
+            for (int32_t d = 0; d < D; ++d) {
+              oi[d] += scores[j] / sum * vj[d];
+            }
+          }
+        }
+      }
+    }
+    return out;
+  }
+
+  void expect_matches_reference(
+      const Shape& s,
+      bool with_mask,
+      bool is_causal) {
+    std::vector<float> q(s.batches * s.heads * s.q_len * s.head_dim);
+    std::vector<float> k(s.batches * s.kv_heads * s.kv_len * s.head_dim);
+    std::vector<float> v(k.size());
+    std::vector<float> mask(s.q_len * s.kv_len);
+    for (size_t i = 0; i < q.size(); ++i) {
+      q[i] = std::sin(0.7f * i);
+    }
+    for (size_t i = 0; i < k.size(); ++i) {
+      k[i] = std::cos(0.3f * i);
+      v[i] = std::sin(0.11f * i + 1);
+    }
+    for (size_t i = 0; i < mask.size(); ++i) {
+      mask[i] = i % 3 == 0 ? -std::numeric_limits<float>::infinity()
+                           : 0.1f * (i % 5);
+    }
+    // Keep the first key visible, so that no query is fully masked.
+    for (int32_t i = 0; i < s.q_len; ++i) {
+      mask[i * s.kv_len] = 0;
+    }
+
+    TensorFactory<ScalarType::Float> tf;
+    Tensor query = tf.make({s.batches, s.heads, s.q_len, s.head_dim}, q);
+    Tensor key = tf.make({s.batches, s.kv_heads, s.kv_len, s.head_dim}, k);
+    Tensor value = tf.make({s.batches, s.kv_heads, s.kv_len, s.head_dim}, v);
+    Tensor mask_tensor = tf.make({1, 1, s.q_len, s.kv_len}, mask);
+    Tensor out = tf.zeros({s.batches, s.heads, s.q_len, s.head_dim});
+
+    op_sdpa_out(
+        query,
+        key,
+        value,
+        with_mask ? optional<Tensor>(mask_tensor) : optional<Tensor>(),
+        is_causal,
+        optional<double>(),
+        out);
+    // The blocked softmax sums in a different order than the reference.
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out,
+        tf.make(
+            {s.batches, s.heads, s.q_len, s.head_dim},
+            reference_sdpa(
+                s, q, k, v, with_mask ? &mask : nullptr, is_causal)),
+        1e-5,
+        1e-6);
+  }
+};
+
+} // namespace
+
+TEST_F(OpSdpaTest, SingleKey) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor query = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  Tensor key = tf.make({1, 1, 1, 2}, {5, 6});
+  Tensor value = tf.make({1, 1, 1, 2}, {7, 8});
+  Tensor out = tf.zeros({1, 1, 2, 2});
+
+  // Every query attends only to the one value.
+  op_sdpa_out(
+      query, key, value, optional<Tensor>(), false, optional<double>(), out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 2, 2}, {7, 8, 7, 8}));
+}
+
+TEST_F(OpSdpaTest, ExplicitScale) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor query = tf.make({1, 1, 1, 1}, {1});
+  Tensor key = tf.make({1, 1, 2, 1}, {0, 1});
+  Tensor value = tf.make({1, 1, 2, 1}, {0, 1});
+  Tensor out = tf.zeros({1, 1, 1, 1});
+
+  // Scores 0 and log(3) weigh the values 1:3.
+  op_sdpa_out(
+      query,
+      key,
+      value,
+      optional<Tensor>(),
+      false,
+      optional<double>(std::log(3.0)),
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 1, 1}, {0.75}));
+}
+
+TEST_F(OpSdpaTest, MatchesReference) {
+  // More keys than a block, and more queries than a tile.
+  expect_matches_reference({2, 2, 2, 37, 300, 16}, false, false);
+}
+
+TEST_F(OpSdpaTest, Mask) {
+  expect_matches_reference({1, 2, 2, 5, 200, 8}, true, false);
+}
+
+TEST_F(OpSdpaTest, Causal) {
+  expect_matches_reference({1, 2, 2, 70, 70, 8}, false, true);
+}
+
+TEST_F(OpSdpaTest, CausalDecodeOverCache) {
+  // New queries at the end of a longer cache, with grouped query attention.
+  expect_matches_reference({1, 4, 2, 3, 260, 16}, true, true);
+}
+
+TEST_F(OpSdpaTest, RejectsIndivisibleHeads) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor query = tf.ones({1, 3, 2, 4});
+  Tensor key = tf.ones({1, 2, 2, 4});
+  Tensor value = tf.ones({1, 2, 2, 4});
+  Tensor out = tf.zeros({1, 3, 2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(op_sdpa_out(
+      query, key, value, optional<Tensor>(), false, optional<double>(), out));
+}
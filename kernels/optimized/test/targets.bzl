@@ -4,7 +4,7 @@ load(
     "get_vec_android_preprocessor_flags",
     "get_vec_cxx_preprocessor_flags",
 )
-load("@fbsource//xplat/executorch/kernels/test:util.bzl", "define_supported_features_lib")
+load("@fbsource//xplat/executorch/kernels/test:util.bzl", "define_supported_features_lib", "op_test")
 
 def _lib_test_bin(name, extra_deps = [], in_cpu = False):
     """Defines a cxx_binary() for a single test file.
@@ -39,5 +39,11 @@ def define_common_targets():
     define_supported_features_lib()
 
     _lib_test_bin("libvec_test_bin")
+    _lib_test_bin("dispatch_stub_test_bin", in_cpu = True)
     _lib_test_bin("moments_utils_test_bin", in_cpu = True)
     _lib_test_bin("libblas_test_bin")
+
+    op_test("op_fused_elementwise_test", kernel_name = "optimized", aten_compatible = False)
+    op_test("op_rms_norm_test", kernel_name = "optimized", aten_compatible = False)
+    op_test("op_rope_test", kernel_name = "optimized", aten_compatible = False)
+    op_test("op_sdpa_test", kernel_name = "optimized", aten_compatible = False)
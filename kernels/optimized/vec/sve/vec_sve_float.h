@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <executorch/kernels/optimized/vec/intrinsics.h>
+#include <executorch/kernels/optimized/vec/vec_base.h>
+
+#if defined(CPU_CAPABILITY_SVE256)
+#include <arm_sve.h>
+#include <sleef.h>
+#endif
+
+namespace executorch {
+namespace vec {
+// See Note [CPU_CAPABILITY namespace]
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_SVE256)
+
+// SVE registers are sizeless, so they can only be class members when the
+// vector length is fixed at compile time with -msve-vector-bits. The SVE256
+// kernels are built with -msve-vector-bits=256, and only dispatched to on CPUs
+// whose vector length is exactly 256 bits.
+#if !defined(__ARM_FEATURE_SVE_BITS) || __ARM_FEATURE_SVE_BITS != 256
+#error "CPU_CAPABILITY_SVE256 requires -msve-vector-bits=256"
+#endif
+
+typedef svfloat32_t vls_float32_t
+    __attribute__((arm_sve_vector_bits(__ARM_FEATURE_SVE_BITS)));
+
+template <> class Vectorized<float> {
+private:
+  vls_float32_t values;
+  static svbool_t ptrue() {
+    return svptrue_b32();
+  }
+  // Expands a predicate to all-ones lanes for true and all-zeros lanes for
+  // false, which is how the other backends represent vector booleans.
+  static Vectorized<float> pred_to_vec(svbool_t pred) {
+    return svreinterpret_f32_s32(
+        svsel_s32(pred, svdup_n_s32(-1), svdup_n_s32(0)));
+  }
+public:
+  using value_type = float;
+  using size_type = int;
+  static constexpr size_type size() {
+    return __ARM_FEATURE_SVE_BITS / (8 * sizeof(float));
+  }
+  Vectorized() {}
+  Vectorized(svfloat32_t v) : values(v) {}
+  Vectorized(float val) : values(svdup_n_f32(val)) {}
+  Vectorized(float val0, float val1, float val2, float val3,
+         float val4, float val5, float val6, float val7) {
+    __at_align__ float buffer[size()] = {
+        val0, val1, val2, val3, val4, val5, val6, val7};
+    values = svld1_f32(ptrue(), buffer);
+  }
+  operator svfloat32_t() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vectorized<float> blend(const Vectorized<float>& a, const Vectorized<float>& b) {
+    __at_align__ int32_t flags[size()];
+    for (int i = 0; i < size(); ++i) {
+      flags[i] = (mask & (1ULL << i)) ? 1 : 0;
+    }
+    svbool_t pred = svcmpne_n_s32(ptrue(), svld1_s32(ptrue(), flags), 0);
+    return svsel_f32(pred, b.values, a.values);
+  }
+  static Vectorized<float> blendv(const Vectorized<float>& a, const Vectorized<float>& b,
+                              const Vectorized<float>& mask) {
+    // NB: Like the other backends, this requires each lane of the mask to be
+    // either all zeros or all ones.
+    svbool_t pred = svcmpne_n_s32(ptrue(), svreinterpret_s32_f32(mask.values), 0);
+    return svsel_f32(pred, b.values, a.values);
+  }
+  template<typename step_t>
+  static Vectorized<float> arange(float base = 0.f, step_t step = static_cast<step_t>(1)) {
+    svfloat32_t steps = svcvt_f32_s32_x(ptrue(), svindex_s32(0, 1));
+    return svadd_n_f32_x(
+        ptrue(), svmul_n_f32_x(ptrue(), steps, static_cast<float>(step)), base);
+  }
+  static Vectorized<float> set(const Vectorized<float>& a, const Vectorized<float>& b,
+                           int64_t count = size()) {
+    // The first `count` lanes come from b.
+    if (count <= 0) {
+      return a;
+    }
+    if (count >= size()) {
+      return b;
+    }
+    return svsel_f32(svwhilelt_b32_s64(0, count), b.values, a.values);
+  }
+  static Vectorized<float> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return svld1_f32(ptrue(), reinterpret_cast<const float*>(ptr));
+    }
+    // Inactive lanes are zeroed and never read, so a partial load does not
+    // touch memory past `count` elements.
+    return svld1_f32(
+        svwhilelt_b32_s64(0, count), reinterpret_cast<const float*>(ptr));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      svst1_f32(ptrue(), reinterpret_cast<float*>(ptr), values);
+    } else if (count > 0) {
+      svst1_f32(svwhilelt_b32_s64(0, count), reinterpret_cast<float*>(ptr), values);
+    }
+  }
+  const float& operator[](int idx) const  = delete;
+  float& operator[](int idx) = delete;
+  int zero_mask() const {
+    // returns an integer mask where all zero elements are translated to 1-bit and others are translated to 0-bit
+    __at_align__ int32_t flags[size()];
+    svst1_s32(
+        ptrue(),
+        flags,
+        svsel_s32(
+            svcmpeq_n_f32(ptrue(), values, 0.f), svdup_n_s32(1), svdup_n_s32(0)));
+    int mask = 0;
+    for (int i = 0; i < size(); ++i) {
+      if (flags[i] != 0) {
+        mask |= (1 << i);
+      }
+    }
+    return mask;
+  }
+  Vectorized<float> isnan() const {
+    return pred_to_vec(svcmpuo_f32(ptrue(), values, values));
+  }
+  Vectorized<float> map(float (*const f)(float)) const {
+    __at_align__ float tmp[size()];
+    store(tmp);
+    for (size_t i = 0; i < size(); ++i) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vectorized<float> abs() const {
+    return svabs_f32_x(ptrue(), values);
+  }
+  Vectorized<float> acos() const {
+    return Vectorized<float>(Sleef_acosfx_u10sve(values));
+  }
+  Vectorized<float> asin() const {
+    return Vectorized<float>(Sleef_asinfx_u10sve(values));
+  }
+  Vectorized<float> atan() const {
+    return Vectorized<float>(Sleef_atanfx_u10sve(values));
+  }
+  Vectorized<float> atan2(const Vectorized<float> &b) const {
+    return Vectorized<float>(Sleef_atan2fx_u10sve(values, b.values));
+  }
+  Vectorized<float> copysign(const Vectorized<float> &sign) const {
+    return Vectorized<float>(Sleef_copysignfx_sve(values, sign.values));
+  }
+  Vectorized<float> erf() const {
+    return Vectorized<float>(Sleef_erffx_u10sve(values));
+  }
+  Vectorized<float> erfc() const {
+    return Vectorized<float>(Sleef_erfcfx_u15sve(values));
+  }
+  Vectorized<float> exp() const {
+    return Vectorized<float>(Sleef_expfx_u10sve(values));
+  }
+  Vectorized<float> exp2() const {
+    return Vectorized<float>(Sleef_exp2fx_u10sve(values));
+  }
+  Vectorized<float> expm1() const {
+    return Vectorized<float>(Sleef_expm1fx_u10sve(values));
+  }
+  Vectorized<float> fmod(const Vectorized<float>& q) const {
+    return Vectorized<float>(Sleef_fmodfx_sve(values, q.values));
+  }
+  Vectorized<float> hypot(const Vectorized<float> &b) const {
+    return Vectorized<float>(Sleef_hypotfx_u05sve(values, b.values));
+  }
+  Vectorized<float> log() const {
+    return Vectorized<float>(Sleef_logfx_u10sve(values));
+  }
+  Vectorized<float> log10() const {
+    return Vectorized<float>(Sleef_log10fx_u10sve(values));
+  }
+  Vectorized<float> log1p() const {
+    return Vectorized<float>(Sleef_log1pfx_u10sve(values));
+  }
+  Vectorized<float> log2() const {
+    return Vectorized<float>(Sleef_log2fx_u10sve(values));
+  }
+  Vectorized<float> nextafter(const Vectorized<float> &b) const {
+    return Vectorized<float>(Sleef_nextafterfx_sve(values, b.values));
+  }
+  Vectorized<float> frac() const;
+  Vectorized<float> sin() const {
+    return Vectorized<float>(Sleef_sinfx_u10sve(values));
+  }
+  Vectorized<float> sinh() const {
+    return Vectorized<float>(Sleef_sinhfx_u10sve(values));
+  }
+  Vectorized<float> cos() const {
+    return Vectorized<float>(Sleef_cosfx_u10sve(values));
+  }
+  Vectorized<float> cosh() const {
+    return Vectorized<float>(Sleef_coshfx_u10sve(values));
+  }
+  Vectorized<float> ceil() const {
+    return svrintp_f32_x(ptrue(), values);
+  }
+  Vectorized<float> floor() const {
+    return svrintm_f32_x(ptrue(), values);
+  }
+  Vectorized<float> neg() const {
+    return svneg_f32_x(ptrue(), values);
+  }
+  Vectorized<float> round() const {
+    // Rounds half to even, like the AVX2 and AVX512 versions.
+    return svrintn_f32_x(ptrue(), values);
+  }
+  Vectorized<float> tan() const {
+    return Vectorized<float>(Sleef_tanfx_u10sve(values));
+  }
+  Vectorized<float> tanh() const {
+    return Vectorized<float>(Sleef_tanhfx_u10sve(values));
+  }
+  Vectorized<float> trunc() const {
+    return svrintz_f32_x(ptrue(), values);
+  }
+  Vectorized<float> lgamma() const {
+    return Vectorized<float>(Sleef_lgammafx_u10sve(values));
+  }
+  Vectorized<float> sqrt() const {
+    return svsqrt_f32_x(ptrue(), values);
+  }
+  Vectorized<float> reciprocal() const {
+    return svdivr_n_f32_x(ptrue(), values, 1.f);
+  }
+  Vectorized<float> rsqrt() const {
+    return this->sqrt().reciprocal();
+  }
+  Vectorized<float> pow(const Vectorized<float> &b) const {
+    return Vectorized<float>(Sleef_powfx_u10sve(values, b.values));
+  }
+  // Comparisons are ordered, i.e. false if an operand is NaN, except for !=,
+  // matching the _CMP_**_OQ and _CMP_NEQ_UQ predicates of the x86 versions.
+  Vectorized<float> operator==(const Vectorized<float>& other) const {
+    return pred_to_vec(svcmpeq_f32(ptrue(), values, other.values));
+  }
+
+  Vectorized<float> operator!=(const Vectorized<float>& other) const {
+    return pred_to_vec(svnot_b_z(
+        ptrue(), svcmpeq_f32(ptrue(), values, other.values)));
+  }
+
+  Vectorized<float> operator<(const Vectorized<float>& other) const {
+    return pred_to_vec(svcmplt_f32(ptrue(), values, other.values));
+  }
+
+  Vectorized<float> operator<=(const Vectorized<float>& other) const {
+    return pred_to_vec(svcmple_f32(ptrue(), values, other.values));
+  }
+
+  Vectorized<float> operator>(const Vectorized<float>& other) const {
+    return pred_to_vec(svcmpgt_f32(ptrue(), values, other.values));
+  }
+
+  Vectorized<float> operator>=(const Vectorized<float>& other) const {
+    return pred_to_vec(svcmpge_f32(ptrue(), values, other.values));
+  }
+
+  Vectorized<float> eq(const Vectorized<float>& other) const;
+  Vectorized<float> ne(const Vectorized<float>& other) const;
+  Vectorized<float> gt(const Vectorized<float>& other) const;
+  Vectorized<float> ge(const Vectorized<float>& other) const;
+  Vectorized<float> lt(const Vectorized<float>& other) const;
+  Vectorized<float> le(const Vectorized<float>& other) const;
+};
+
+template <>
+Vectorized<float> inline operator+(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svadd_f32_x(svptrue_b32(), a, b);
+}
+
+template <>
+Vectorized<float> inline operator-(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svsub_f32_x(svptrue_b32(), a, b);
+}
+
+template <>
+Vectorized<float> inline operator*(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svmul_f32_x(svptrue_b32(), a, b);
+}
+
+template <>
+Vectorized<float> inline operator/(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svdiv_f32_x(svptrue_b32(), a, b);
+}
+
+// frac. Implement this here so we can use subtraction
+inline Vectorized<float> Vectorized<float>::frac() const {
+  return *this - this->trunc();
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN. FMAX does so, unlike FMAXNM.
+template <>
+Vectorized<float> inline maximum(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svmax_f32_x(svptrue_b32(), a, b);
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN. FMIN does so, unlike FMINNM.
+template <>
+Vectorized<float> inline minimum(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svmin_f32_x(svptrue_b32(), a, b);
+}
+
+template <>
+Vectorized<float> inline clamp(const Vectorized<float>& a, const Vectorized<float>& min, const Vectorized<float>& max) {
+  return minimum(max, maximum(min, a));
+}
+
+template <>
+Vectorized<float> inline clamp_max(const Vectorized<float>& a, const Vectorized<float>& max) {
+  return minimum(max, a);
+}
+
+template <>
+Vectorized<float> inline clamp_min(const Vectorized<float>& a, const Vectorized<float>& min) {
+  return maximum(min, a);
+}
+
+template <>
+Vectorized<float> inline operator&(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svreinterpret_f32_u32(svand_u32_x(
+      svptrue_b32(), svreinterpret_u32_f32(a), svreinterpret_u32_f32(b)));
+}
+
+template <>
+Vectorized<float> inline operator|(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svreinterpret_f32_u32(svorr_u32_x(
+      svptrue_b32(), svreinterpret_u32_f32(a), svreinterpret_u32_f32(b)));
+}
+
+template <>
+Vectorized<float> inline operator^(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return svreinterpret_f32_u32(sveor_u32_x(
+      svptrue_b32(), svreinterpret_u32_f32(a), svreinterpret_u32_f32(b)));
+}
+
+inline Vectorized<float> Vectorized<float>::eq(const Vectorized<float>& other) const {
+  return (*this == other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::ne(const Vectorized<float>& other) const {
+  return (*this != other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::gt(const Vectorized<float>& other) const {
+  return (*this > other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::ge(const Vectorized<float>& other) const {
+  return (*this >= other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::lt(const Vectorized<float>& other) const {
+  return (*this < other) & Vectorized<float>(1.0f);
+}
+
+inline Vectorized<float> Vectorized<float>::le(const Vectorized<float>& other) const {
+  return (*this <= other) & Vectorized<float>(1.0f);
+}
+
+template <>
+inline void convert(const float* src, float* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i += Vectorized<float>::size()) {
+    svbool_t pred = svwhilelt_b32_s64(i, n);
+    svst1_f32(pred, dst + i, svld1_f32(pred, src + i));
+  }
+}
+
+template <>
+inline void convert(const float* src, int32_t* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i += Vectorized<float>::size()) {
+    svbool_t pred = svwhilelt_b32_s64(i, n);
+    svst1_s32(pred, dst + i, svcvt_s32_f32_x(pred, svld1_f32(pred, src + i)));
+  }
+}
+
+template <>
+inline void convert(const int32_t* src, float* dst, int64_t n) {
+  for (int64_t i = 0; i < n; i += Vectorized<float>::size()) {
+    svbool_t pred = svwhilelt_b32_s64(i, n);
+    svst1_f32(pred, dst + i, svcvt_f32_s32_x(pred, svld1_s32(pred, src + i)));
+  }
+}
+
+template <>
+Vectorized<float> inline fmadd(const Vectorized<float>& a, const Vectorized<float>& b, const Vectorized<float>& c) {
+  // a * b + c
+  return svmad_f32_x(svptrue_b32(), a, b, c);
+}
+
+template <>
+Vectorized<float> inline fmsub(const Vectorized<float>& a, const Vectorized<float>& b, const Vectorized<float>& c) {
+  // a * b - c
+  return svnmsb_f32_x(svptrue_b32(), a, b, c);
+}
+
+#endif // defined(CPU_CAPABILITY_SVE256)
+
+}}}
@@ -8,7 +8,13 @@
 
 #pragma once
 
+#if defined(CPU_CAPABILITY_AVX512)
+#include <executorch/kernels/optimized/vec/vec512/vec512.h>
+#elif defined(CPU_CAPABILITY_SVE256)
+#include <executorch/kernels/optimized/vec/sve/vec_sve.h>
+#else
 #include <executorch/kernels/optimized/vec/vec256/vec256.h>
+#endif
 
 namespace executorch {
 namespace vec {
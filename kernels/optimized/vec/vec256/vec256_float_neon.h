@@ -803,6 +803,40 @@ Vectorized<float> inline fmsub(const Vectorized<float>& a, const Vectorized<floa
   return Vectorized<float>(r0, r1);
 }
 
+// Transposes the 4x4 block at src into dst.
+inline void transpose_4x4_neon(
+    const float* src,
+    int64_t ld_src,
+    float* dst,
+    int64_t ld_dst) {
+  // a0 b0 a2 b2 / a1 b1 a3 b3, and likewise for rows c and d
+  const float32x4x2_t ab = vtrnq_f32(vld1q_f32(src), vld1q_f32(src + ld_src));
+  const float32x4x2_t cd =
+      vtrnq_f32(vld1q_f32(src + 2 * ld_src), vld1q_f32(src + 3 * ld_src));
+  vst1q_f32(dst, vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0])));
+  vst1q_f32(
+      dst + ld_dst,
+      vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1])));
+  vst1q_f32(
+      dst + 2 * ld_dst,
+      vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0])));
+  vst1q_f32(
+      dst + 3 * ld_dst,
+      vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1])));
+}
+
+template<>
+inline void transpose_mxn<float, 8, 8>(
+    const float* src,
+    int64_t ld_src,
+    float* dst,
+    int64_t ld_dst) {
+  transpose_4x4_neon(src, ld_src, dst, ld_dst);
+  transpose_4x4_neon(src + 4, ld_src, dst + 4 * ld_dst, ld_dst);
+  transpose_4x4_neon(src + 4 * ld_src, ld_src, dst + 4, ld_dst);
+  transpose_4x4_neon(src + 4 * ld_src + 4, ld_src, dst + 4 * ld_dst + 4, ld_dst);
+}
+
 #endif /* defined(aarch64) */
 
 }}}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+template <typename SELF_CTYPE, typename OUT_CTYPE>
+void _to_dim_order_copy_impl(const Tensor& self, Tensor& out) {
+  const SELF_CTYPE* self_data = self.const_data_ptr<SELF_CTYPE>();
+  OUT_CTYPE* out_data = out.mutable_data_ptr<OUT_CTYPE>();
+
+  if (self.dim_order().equals(out.dim_order())) {
+    for (size_t i = 0; i < self.numel(); ++i) {
+      out_data[i] = static_cast<OUT_CTYPE>(self_data[i]);
+    }
+    return;
+  }
+
+  // Walk out in memory order, and find each element in self by its
+  // coordinates.
+  const size_t ndim = self.dim();
+  exec_aten::StridesType self_strides[kTensorDimensionLimit];
+  dim_order_to_stride_nocheck(
+      self.sizes().data(), self.dim_order().data(), ndim, self_strides);
+  exec_aten::DimOrderType out_dim_order[kTensorDimensionLimit];
+  for (size_t d = 0; d < ndim; ++d) {
+    out_dim_order[d] = out.dim_order()[d];
+  }
+
+  size_t coord[kTensorDimensionLimit] = {0};
+  size_t self_index = 0;
+  for (size_t i = 0; i < out.numel(); ++i) {
+    out_data[i] = static_cast<OUT_CTYPE>(self_data[self_index]);
+    // Increment the coordinate, innermost dim of out first
+    for (size_t k = ndim; k-- > 0;) {
+      const size_t d = out_dim_order[k];
+      coord[d]++;
+      self_index += self_strides[d];
+      if (coord[d] < self.size(d)) {
+        break;
+      }
+      self_index -= coord[d] * self_strides[d];
+      coord[d] = 0;
+    }
+  }
+}
+
+} // namespace
+
+// _to_dim_order_copy.out(Tensor self, *, bool non_blocking=False, int[]?
+// dim_order=None, Tensor(a!) out) -> Tensor(a!)
+//
+// Copies self into out, converting the dtype and the dim order to those of
+// out. The dim order of out is fixed when it is memory planned; dim_order
+// must match it, and defaults to the contiguous one.
+Tensor& _to_dim_order_copy_out(
+    RuntimeContext& ctx,
+    const Tensor& self,
+    bool non_blocking,
+    exec_aten::optional<exec_aten::ArrayRef<int64_t>> dim_order,
+    Tensor& out) {
+  // Right now we only support blocking data transfer
+  ET_KERNEL_CHECK(ctx, non_blocking == false, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, self.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(ctx, tensor_has_valid_dim_order(self), InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, tensor_has_valid_dim_order(out), InvalidArgument, out);
+
+  if (dim_order.has_value()) {
+    exec_aten::ArrayRef<int64_t> expected = dim_order.value();
+    ET_KERNEL_CHECK(ctx, expected.size() == out.dim(), InvalidArgument, out);
+    for (size_t d = 0; d < expected.size(); ++d) {
+      ET_KERNEL_CHECK(
+          ctx, expected[d] == out.dim_order()[d], InvalidArgument, out);
+    }
+  } else {
+    ET_KERNEL_CHECK(
+        ctx,
+        is_default_dim_order(out.dim_order().data(), out.dim()),
+        InvalidArgument,
+        out);
+  }
+
+  ET_SWITCH_REAL_TYPES_AND(
+      Bool, self.scalar_type(), ctx, "_to_dim_order_copy", SELF_CTYPE, [&] {
+        ET_SWITCH_REAL_TYPES_AND(
+            Bool,
+            out.scalar_type(),
+            ctx,
+            "_to_dim_order_copy",
+            OUT_CTYPE,
+            [&] { _to_dim_order_copy_impl<SELF_CTYPE, OUT_CTYPE>(self, out); });
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
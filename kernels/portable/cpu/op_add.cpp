@@ -33,10 +33,28 @@ Tensor& add_out(
 
   ET_CHECK(canCast(common_type, out_type));
 
-  ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "add", CTYPE_A, [&]() {
-    ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "add", CTYPE_B, [&]() {
-      ET_SWITCH_REAL_TYPES_AND(Bool, common_type, ctx, "add", CTYPE_IN, [&]() {
-        ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "add", CTYPE_OUT, [&]() {
+  // With a single dtype, one switch level is enough, and the loop has no
+  // conversions in it.
+  if (a_type == b_type && a_type == out_type) {
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "add", CTYPE, [&]() {
+      CTYPE alpha_val;
+      ET_EXTRACT_SCALAR(alpha, alpha_val);
+
+      apply_binary_elementwise_fn<CTYPE, CTYPE, CTYPE>(
+          [alpha_val](const CTYPE val_a, const CTYPE val_b) {
+            return static_cast<CTYPE>(val_a + alpha_val * val_b);
+          },
+          a,
+          b,
+          out);
+    });
+    return out;
+  }
+
+  ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "add", CTYPE_A, [&]() {
+    ET_SWITCH_REALHBBF16_TYPES(b_type, ctx, "add", CTYPE_B, [&]() {
+      ET_SWITCH_REALHBBF16_TYPES(common_type, ctx, "add", CTYPE_IN, [&]() {
+        ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "add", CTYPE_OUT, [&]() {
           CTYPE_IN alpha_val;
           ET_EXTRACT_SCALAR(alpha, alpha_val);
 
@@ -78,10 +96,10 @@ Tensor& add_scalar_out(
 
   ET_CHECK(common_type == out_type);
 
-  ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "add", CTYPE_A, [&]() {
+  ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "add", CTYPE_A, [&]() {
     ET_SWITCH_SCALAR_OBJ_TYPES(b_type, ctx, "add", CTYPE_B, [&]() {
-      ET_SWITCH_REAL_TYPES_AND(Bool, common_type, ctx, "add", CTYPE_IN, [&]() {
-        ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "add", CTYPE_OUT, [&]() {
+      ET_SWITCH_REALHBBF16_TYPES(common_type, ctx, "add", CTYPE_IN, [&]() {
+        ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "add", CTYPE_OUT, [&]() {
           CTYPE_B b_val;
           ET_EXTRACT_SCALAR(b, b_val);
           CTYPE_IN b_casted = static_cast<CTYPE_IN>(b_val);
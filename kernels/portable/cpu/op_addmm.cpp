@@ -11,6 +11,7 @@
 #include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
 #include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -47,36 +48,50 @@ Tensor& addmm_out(
 
   ScalarType alpha_dtype = utils::get_scalar_dtype(alpha);
   ScalarType beta_dtype = utils::get_scalar_dtype(beta);
-  ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "addmm", CTYPE, [&]() {
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, "addmm", CTYPE, [&]() {
     ET_SWITCH_SCALAR_OBJ_TYPES(alpha_dtype, ctx, "addmm", ALPHA_T, [&]() {
       ET_SWITCH_SCALAR_OBJ_TYPES(beta_dtype, ctx, "addmm", BETA_T, [&]() {
         size_t m = mat1.size(0);
         size_t n = mat1.size(1);
         size_t p = mat2.size(1);
 
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+        const CTYPE* mat1_data = mat1.const_data_ptr<CTYPE>();
+        const CTYPE* mat2_data = mat2.const_data_ptr<CTYPE>();
+        // Each chunk of rows of `out` only depends on the same rows of `in`
+        // and `mat1`.
+        const int64_t grain_size = parallel_grain_size(n * p);
+
         if (out.sizes() == in.sizes()) {
           // vec_addmm assumes that no broadcasting is required.
-          vec_addmm<CTYPE, CTYPE>(
-              out.mutable_data_ptr<CTYPE>(),
-              in.const_data_ptr<CTYPE>(),
-              mat1.const_data_ptr<CTYPE>(),
-              mat2.const_data_ptr<CTYPE>(),
-              m,
-              n,
-              p,
-              convert<CTYPE>(beta.to<BETA_T>()),
-              convert<CTYPE>(alpha.to<ALPHA_T>()));
+          const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+          const CTYPE beta_val = convert<CTYPE>(beta.to<BETA_T>());
+          const CTYPE alpha_val = convert<CTYPE>(alpha.to<ALPHA_T>());
+          parallel_for(0, m, grain_size, [&](int64_t begin, int64_t end) {
+            vec_addmm<CTYPE, CTYPE>(
+                out_data + begin * p,
+                in_data + begin * p,
+                mat1_data + begin * n,
+                mat2_data,
+                end - begin,
+                n,
+                p,
+                beta_val,
+                alpha_val);
+          });
         } else {
           // If broadcasting is required, them compute the matmul and addition
           // separately, using apply_binary_elementwise_fn to perform the
           // addition while applying broadcasting
-          vec_matmul<CTYPE, CTYPE>(
-              out.mutable_data_ptr<CTYPE>(),
-              mat1.const_data_ptr<CTYPE>(),
-              mat2.const_data_ptr<CTYPE>(),
-              m,
-              n,
-              p);
+          parallel_for(0, m, grain_size, [&](int64_t begin, int64_t end) {
+            vec_matmul<CTYPE, CTYPE>(
+                out_data + begin * p,
+                mat1_data + begin * n,
+                mat2_data,
+                end - begin,
+                n,
+                p);
+          });
 
           CTYPE alpha_val = convert<CTYPE>(alpha.to<ALPHA_T>());
           CTYPE beta_val = convert<CTYPE>(beta.to<BETA_T>());
@@ -57,15 +57,16 @@ Tensor& amin_out(
 
   ET_SWITCH_REAL_TYPES_AND(Bool, in.scalar_type(), ctx, "amin", CTYPE, [&]() {
     CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
-    for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
-      out_data[out_ix] = reduce_over_dim_list<CTYPE>(
-          [](CTYPE v, CTYPE min_v) {
-            return std::isnan(v) || v < min_v ? v : min_v;
-          },
-          in,
-          dim_list,
-          out_ix);
-    }
+    parallel_for_each_reduce_over_dim_list_output_index(
+        in, dim_list, out, [&](const size_t out_ix) {
+          out_data[out_ix] = reduce_over_dim_list<CTYPE>(
+              [](CTYPE v, CTYPE min_v) {
+                return std::isnan(v) || v < min_v ? v : min_v;
+              },
+              in,
+              dim_list,
+              out_ix);
+        });
   });
 
   return out;
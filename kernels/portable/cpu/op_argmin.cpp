@@ -66,20 +66,21 @@ Tensor& argmin_out(
   ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "argmin", CTYPE, [&] {
     long* out_data = out.mutable_data_ptr<long>();
 
-    for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
-      std::tuple<CTYPE, long> acc = reduce_over_dim<CTYPE>(
-          [](CTYPE v, long ix, CTYPE acc_val, long acc_ix) {
-            if (!std::isnan(acc_val) && (std::isnan(v) || v < acc_val)) {
-              acc_val = v;
-              acc_ix = ix;
-            }
-            return std::tuple<CTYPE, long>{acc_val, acc_ix};
-          },
-          in,
-          dim,
-          out_ix);
-      out_data[out_ix] = std::get<1>(acc);
-    }
+    parallel_for_each_reduce_over_dim_output_index(
+        in, dim, out, [&](const size_t out_ix) {
+          std::tuple<CTYPE, long> acc = reduce_over_dim<CTYPE>(
+              [](CTYPE v, long ix, CTYPE acc_val, long acc_ix) {
+                if (!std::isnan(acc_val) && (std::isnan(v) || v < acc_val)) {
+                  acc_val = v;
+                  acc_ix = ix;
+                }
+                return std::tuple<CTYPE, long>{acc_val, acc_ix};
+              },
+              in,
+              dim,
+              out_ix);
+          out_data[out_ix] = std::get<1>(acc);
+        });
   });
 
   return out;
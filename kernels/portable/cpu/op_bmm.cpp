@@ -9,6 +9,7 @@
 #include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
 #include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -32,7 +33,7 @@ Tensor& bmm_out(
       InvalidArgument,
       out);
 
-  ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "bmm", CTYPE, [&]() {
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, "bmm", CTYPE, [&]() {
     const CTYPE* in_data = in.const_data_ptr<CTYPE>();
     const CTYPE* mat2_data = mat2.const_data_ptr<CTYPE>();
     CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
@@ -42,14 +43,20 @@ Tensor& bmm_out(
     int64_t n = in.size(2);
     int64_t p = mat2.size(2);
 
-    for (int i = 0; i < batch_size; ++i) {
-      const CTYPE* in_data_offset = in_data + i * m * n;
-      const CTYPE* mat2_data_offset = mat2_data + i * n * p;
-      CTYPE* out_data_offset = out_data + i * m * p;
+    parallel_for(
+        0,
+        batch_size,
+        parallel_grain_size(m * n * p),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            const CTYPE* in_data_offset = in_data + i * m * n;
+            const CTYPE* mat2_data_offset = mat2_data + i * n * p;
+            CTYPE* out_data_offset = out_data + i * m * p;
 
-      vec_matmul<CTYPE>(
-          out_data_offset, in_data_offset, mat2_data_offset, m, n, p);
-    }
+            vec_matmul<CTYPE>(
+                out_data_offset, in_data_offset, mat2_data_offset, m, n, p);
+          }
+        });
   });
 
   return out;
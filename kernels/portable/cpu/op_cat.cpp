@@ -31,8 +31,12 @@ Tensor& cat_out(
   Tensor::SizesType expected_out_size[kTensorDimensionLimit];
   size_t expected_out_dim = 0;
   get_cat_out_target_size(tensors, dim, expected_out_size, &expected_out_dim);
-  ET_CHECK(
-      resize_tensor(out, {expected_out_size, expected_out_dim}) == Error::Ok);
+  ET_KERNEL_CHECK(
+      ctx,
+      ctx.resize_tensor(out, {expected_out_size, expected_out_dim}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
 
   // Special handling when all inputs are 1D-empty tensors for aten consistency
   // In that case, just return an 1D-empty tensor without checking dim
@@ -52,6 +56,38 @@ Tensor& cat_out(
   const size_t ninputs = tensors.size();
 
   const auto out_type = out.scalar_type();
+
+  bool same_dtype = true;
+  for (size_t j = 0; j < ninputs; ++j) {
+    if (tensors[j].numel() != 0 && tensors[j].scalar_type() != out_type) {
+      same_dtype = false;
+      break;
+    }
+  }
+  if (same_dtype) {
+    // Each input contributes one contiguous block to every outer slice of
+    // out, so copy it with memcpy.
+    const size_t elem_size = out.element_size();
+    const size_t out_block_nbytes = out.size(dim) * dim_stride * elem_size;
+    char* out_ptr = out.mutable_data_ptr<char>();
+    for (size_t j = 0; j < ninputs; ++j) {
+      if (tensors[j].numel() == 0) {
+        continue;
+      }
+      const size_t in_block_nbytes =
+          tensors[j].size(dim) * dim_stride * elem_size;
+      copy_blocks(
+          out_ptr,
+          out_block_nbytes,
+          tensors[j].const_data_ptr<char>(),
+          in_block_nbytes,
+          in_block_nbytes,
+          outer);
+      out_ptr += in_block_nbytes;
+    }
+    return out;
+  }
+
   ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "cat", CTYPE_OUT, [&] {
     CTYPE_OUT* out_ptr = out.mutable_data_ptr<CTYPE_OUT>();
     for (size_t i = 0; i < outer; ++i) {
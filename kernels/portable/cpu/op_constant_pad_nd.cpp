@@ -6,10 +6,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
 
@@ -56,9 +58,7 @@ Error resize_to_expected_out_size(
 
 template <typename CTYPE>
 void set_all_to_value(CTYPE* out_data, size_t step_len, CTYPE value) {
-  for (size_t i = 0; i < step_len; ++i) {
-    out_data[i] = value;
-  }
+  std::fill(out_data, out_data + step_len, value);
 }
 
 template <typename CTYPE>
@@ -156,7 +156,8 @@ void constant_pad_nd_out_impl(
   int64_t out_strides[kTensorDimensionLimit];
 
   // Collect sizes and strides of input and output tensors and determine the
-  // last padded dimension
+  // first and last padded dimensions
+  size_t first_padded_dim = ndim;
   size_t last_padded_dim = 0;
   for (size_t i = 0; i < ndim; ++i) {
     self_sizes[i] = self.size(i);
@@ -167,6 +168,7 @@ void constant_pad_nd_out_impl(
     size_t pad_i = ndim - 1 - i;
     if (pad_i >= 0 && pad_i < pad.size() / 2) {
       if (pad[2 * pad_i] + pad[2 * pad_i + 1] > 0) {
+        first_padded_dim = std::min(first_padded_dim, i);
         last_padded_dim = i;
       }
     }
@@ -177,18 +179,40 @@ void constant_pad_nd_out_impl(
   IntArrayRef out_sizes_ref(out_sizes, ndim);
   IntArrayRef out_strides_ref(out_strides, ndim);
 
-  apply_padding_to_dim(
-      ndim,
-      self_data,
-      self_sizes_ref,
-      self_strides_ref,
-      out_data,
-      out_sizes_ref,
-      out_strides_ref,
-      pad,
-      value_v,
-      last_padded_dim,
-      0);
+  // The dims before the first padded one are the same size in the input and
+  // the output, so each slice along them pads independently.
+  if (first_padded_dim == ndim) {
+    first_padded_dim = 0;
+  }
+  int64_t num_slices = 1;
+  for (size_t i = 0; i < first_padded_dim; ++i) {
+    num_slices *= self_sizes[i];
+  }
+  const int64_t in_slice_len =
+      first_padded_dim > 0 ? self_strides[first_padded_dim - 1] : self.numel();
+  const int64_t out_slice_len =
+      first_padded_dim > 0 ? out_strides[first_padded_dim - 1] : out.numel();
+
+  parallel_for(
+      0,
+      num_slices,
+      parallel_grain_size(out_slice_len),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          apply_padding_to_dim(
+              ndim,
+              self_data + i * in_slice_len,
+              self_sizes_ref,
+              self_strides_ref,
+              out_data + i * out_slice_len,
+              out_sizes_ref,
+              out_strides_ref,
+              pad,
+              value_v,
+              last_padded_dim,
+              first_padded_dim);
+        }
+      });
 }
 
 } // namespace
@@ -11,6 +11,7 @@
 #include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
 #include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -232,34 +233,40 @@ void convolution_wrapper(
   const CTYPE_BIAS* const bias_ptr =
       bias.has_value() ? bias.value().const_data_ptr<CTYPE_BIAS>() : nullptr;
 
-  for (size_t batch = 0; batch < out_N; ++batch) {
-    for (size_t group = 0; group < groups; ++group) {
-      // Align channel offset based on the group
-      size_t out_c_start = group * out_C_per_group;
-      // Populate all the out channels in the group
-      for (size_t out_c = out_c_start; out_c < out_c_start + out_C_per_group;
-           ++out_c) {
-        conv2d_impl(
-            in_ptr,
-            in_sizes,
-            {in_strides, 4},
-            w_ptr,
-            weight_sizes,
-            {weight_strides, 4},
-            bias_ptr,
-            stride_,
-            padding_,
-            dilation_,
-            groups,
-            out_ptr,
-            out_sizes,
-            {out_strides, 4},
-            batch,
-            group,
-            out_c);
-      }
-    }
-  }
+  // Every (batch, out channel) pair writes its own plane of `out`, so they
+  // can be computed in parallel.
+  const int64_t work_per_channel = out_sizes[2] * out_sizes[3] *
+      weight_sizes[1] * weight_sizes[2] * weight_sizes[3];
+  parallel_for(
+      0,
+      out_N * out_C,
+      parallel_grain_size(work_per_channel),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const size_t batch = i / out_C;
+          const size_t out_c = i % out_C;
+          // The group that the out channel belongs to
+          const size_t group = out_c / out_C_per_group;
+          conv2d_impl(
+              in_ptr,
+              in_sizes,
+              {in_strides, 4},
+              w_ptr,
+              weight_sizes,
+              {weight_strides, 4},
+              bias_ptr,
+              stride_,
+              padding_,
+              dilation_,
+              groups,
+              out_ptr,
+              out_sizes,
+              {out_strides, 4},
+              batch,
+              group,
+              out_c);
+        }
+      });
 }
 
 } // namespace
@@ -7,7 +7,9 @@
  */
 
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <executorch/runtime/platform/assert.h>
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 //#include <cstdint>
@@ -21,12 +23,16 @@ using Tensor = exec_aten::Tensor;
 using ScalarType = exec_aten::ScalarType;
 
 namespace {
+
+// Elements per block of a blocked scan. Blocks are fixed rather than derived
+// from the number of threads, so the result of a scan does not depend on it.
+constexpr size_t kScanBlockSize = kParallelWorkPerTask;
+
 /**
- * Returns the cumulative sum of elements of input in the dimension dim.
- *
- * Given a self tensor whose size is (d1, d2, .., d_dim, ..., dm), and does
- * cumsum along dim, we first copy all values in self[d1, d2, .., 0, ..., dm]
- * to out[d1, d2, .., 0, ..., dm] since no cumsum should be done for the
+ * Scans columns [col_begin, col_end) of the trailing dims of one leading
+ * slice. Given a self tensor whose size is (d1, d2, .., d_dim, ..., dm), and
+ * does cumsum along dim, we first copy all values in self[d1, d2, .., 0, ...,
+ * dm] to out[d1, d2, .., 0, ..., dm] since no cumsum should be done for the
  * first element. Then calculate all out[d1, d2, .., i, ..., dm] by adding
  * out[d1, d2, .., i-1, ..., dm] and self[d1, d2, .., i-1, ..., dm].
  * This approach ensures that computations are sequential rather than jumpy at
@@ -34,6 +40,80 @@ namespace {
  * well as reducing the number of cache misses.
  */
 template <typename CTYPE_IN, typename CTYPE_OUT>
+void cumsum_columns(
+    const CTYPE_IN* const input_data,
+    CTYPE_OUT* const output_data,
+    const size_t dim_size,
+    const size_t trailing_dims,
+    const size_t col_begin,
+    const size_t col_end) {
+  for (size_t idx = col_begin; idx < col_end; idx++) {
+    output_data[idx] = static_cast<CTYPE_OUT>(input_data[idx]);
+  }
+
+  for (size_t j = 1; j < dim_size; j++) {
+    size_t cur_round_base = j * trailing_dims;
+    size_t prev_round_base = (j - 1) * trailing_dims;
+    for (size_t idx = col_begin; idx < col_end; idx++) {
+      output_data[cur_round_base + idx] =
+          static_cast<CTYPE_OUT>(input_data[cur_round_base + idx]) +
+          output_data[prev_round_base + idx];
+    }
+  }
+}
+
+/**
+ * Scans a long contiguous 1-D slice in two parallel passes over blocks of
+ * kScanBlockSize elements. The first sums each block into its last element,
+ * and a serial scan turns those into the sum up to the end of each block.
+ * The second then scans the rest of each block from the sum of the blocks
+ * before it. For floating point types this adds in a different order than a
+ * serial scan, so results may differ in the last bits.
+ */
+template <typename CTYPE_IN, typename CTYPE_OUT>
+void cumsum_blocked(
+    const CTYPE_IN* const input_data,
+    CTYPE_OUT* const output_data,
+    const size_t size) {
+  const size_t num_blocks = (size + kScanBlockSize - 1) / kScanBlockSize;
+  auto block_last = [&](size_t block) {
+    return std::min(size, (block + 1) * kScanBlockSize) - 1;
+  };
+
+  parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (size_t block = begin; block < end; ++block) {
+      CTYPE_OUT sum = 0;
+      for (size_t i = block * kScanBlockSize; i <= block_last(block); ++i) {
+        sum = sum + static_cast<CTYPE_OUT>(input_data[i]);
+      }
+      output_data[block_last(block)] = sum;
+    }
+  });
+
+  for (size_t block = 1; block < num_blocks; ++block) {
+    output_data[block_last(block)] =
+        output_data[block_last(block - 1)] + output_data[block_last(block)];
+  }
+
+  // The last element of each block is final, and only read by the next one.
+  parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (size_t block = begin; block < end; ++block) {
+      CTYPE_OUT sum =
+          block == 0 ? CTYPE_OUT(0) : output_data[block_last(block - 1)];
+      for (size_t i = block * kScanBlockSize; i < block_last(block); ++i) {
+        sum = sum + static_cast<CTYPE_OUT>(input_data[i]);
+        output_data[i] = sum;
+      }
+    }
+  });
+}
+
+/**
+ * Returns the cumulative sum of elements of input in the dimension dim. Slices
+ * along the leading dims are scanned in parallel; with a single slice, its
+ * columns are, or a long 1-D slice is split into blocks.
+ */
+template <typename CTYPE_IN, typename CTYPE_OUT>
 void cumsum_tensors(const Tensor& self, int64_t dim, Tensor& out) {
   if (self.numel() == 0) {
     return;
@@ -50,24 +130,40 @@ void cumsum_tensors(const Tensor& self, int64_t dim, Tensor& out) {
   const size_t dim_size = static_cast<size_t>(self.size(dim));
   const size_t leading_dims = getLeadingDims(self, dim);
   const size_t trailing_dims = getTrailingDims(self, dim);
-
-  for (size_t i = 0; i < leading_dims; i++) {
-    size_t start_loc = i * (trailing_dims * dim_size);
-
-    for (size_t idx = 0; idx < trailing_dims; idx++) {
-      output_data_base[start_loc + idx] =
-          static_cast<CTYPE_OUT>(input_data_base[start_loc + idx]);
-    }
-
-    for (size_t j = 1; j < dim_size; j++) {
-      size_t cur_round_base = start_loc + j * trailing_dims;
-      size_t prev_round_base = start_loc + (j - 1) * trailing_dims;
-      for (size_t idx = 0; idx < trailing_dims; idx++) {
-        output_data_base[cur_round_base + idx] =
-            static_cast<CTYPE_OUT>(input_data_base[cur_round_base + idx]) +
-            output_data_base[prev_round_base + idx];
-      }
-    }
+  const size_t slice_size = dim_size * trailing_dims;
+
+  if (leading_dims == 1 && trailing_dims == 1 && dim_size > kScanBlockSize) {
+    cumsum_blocked(input_data_base, output_data_base, dim_size);
+  } else if (leading_dims == 1) {
+    parallel_for(
+        0,
+        trailing_dims,
+        parallel_grain_size(dim_size),
+        [&](int64_t begin, int64_t end) {
+          cumsum_columns(
+              input_data_base,
+              output_data_base,
+              dim_size,
+              trailing_dims,
+              begin,
+              end);
+        });
+  } else {
+    parallel_for(
+        0,
+        leading_dims,
+        parallel_grain_size(slice_size),
+        [&](int64_t begin, int64_t end) {
+          for (size_t i = begin; i < end; i++) {
+            cumsum_columns(
+                input_data_base + i * slice_size,
+                output_data_base + i * slice_size,
+                dim_size,
+                trailing_dims,
+                0,
+                trailing_dims);
+          }
+        });
   }
 }
 
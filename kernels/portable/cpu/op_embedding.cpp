@@ -9,6 +9,7 @@
 #include <cstring>
 
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 // A simple lookup table that looks up embeddings in a fixed dictionary and
 // size.
@@ -25,6 +26,10 @@ using ScalarType = exec_aten::ScalarType;
 
 namespace {
 
+// How many indices ahead of the row being copied to prefetch rows.
+constexpr int64_t kPrefetchDistance = 2;
+constexpr int64_t kCacheLineSize = 64;
+
 template <typename CTYPE>
 void embedding_kernel(
     const Tensor& weight,
@@ -48,14 +53,33 @@ void embedding_kernel(
         "indices_ptr[%d] %ld < 0",
         i,
         static_cast<long>(indices_ptr[i]));
-    if (w_data != nullptr) {
-      memcpy(
-          out_data,
-          w_data + nbytes_per_entry * indices_ptr[i],
-          nbytes_per_entry);
-    }
-    out_data += nbytes_per_entry;
   }
+  if (w_data == nullptr) {
+    return;
+  }
+
+  // Rows are gathered from anywhere in the table, so fetch the ones of the
+  // next few indices while copying the current one.
+  parallel_for(
+      0,
+      indices.numel(),
+      parallel_grain_size(nbytes_per_entry),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          if (i + kPrefetchDistance < end) {
+            const char* next =
+                w_data + nbytes_per_entry * indices_ptr[i + kPrefetchDistance];
+            for (int64_t offset = 0; offset < nbytes_per_entry;
+                 offset += kCacheLineSize) {
+              __ET_PREFETCH(next + offset);
+            }
+          }
+          memcpy(
+              out_data + nbytes_per_entry * i,
+              w_data + nbytes_per_entry * indices_ptr[i],
+              nbytes_per_entry);
+        }
+      });
 }
 
 void resize_out_tensor(
@@ -14,6 +14,7 @@
 #include <executorch/kernels/portable/cpu/util/advanced_index_util.h>
 #include <executorch/kernels/portable/cpu/util/broadcast_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -84,18 +85,41 @@ Tensor& index_Tensor_out(
   compute_dim_map(in, indices, dim_map, block_count == 1);
   compute_index_map(in, indices, ix_map);
 
+  // The dimensions after the last indexed one are copied a whole row at a
+  // time, and the rows are independent, so they are gathered in parallel.
+  const size_t trailing_ndim = get_num_trailing_non_indexed_dims(in, indices);
+  size_t row_numel = 1;
+  for (size_t d = in.dim() - trailing_ndim; d < in.dim(); d++) {
+    row_numel *= in.size(d);
+  }
+  const size_t num_rows = out.numel() / row_numel;
+
   ET_SWITCH_REAL_TYPES_AND(Bool, in_type, ctx, __func__, CTYPE, [&]() {
     const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
     CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
 
-    for (auto out_ix = 0; out_ix < out.numel(); out_ix++) {
-      size_t in_ix = 0;
-      bool success = true;
-      std::tie(in_ix, success) =
-          get_in_ix(in, indices, out, out_ix, start, xdim, dim_map, ix_map);
-      ET_KERNEL_CHECK(ctx, success, InvalidArgument, out);
-      out_data[out_ix] = in_data[in_ix];
-    }
+    parallel_for(
+        0,
+        num_rows,
+        parallel_grain_size(row_numel),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; row++) {
+            const size_t out_ix = row * row_numel;
+            size_t in_ix = 0;
+            bool success = true;
+            std::tie(in_ix, success) = get_in_ix(
+                in, indices, out, out_ix, start, xdim, dim_map, ix_map);
+            ET_KERNEL_CHECK(ctx, success, InvalidArgument, out);
+            if (row_numel == 1) {
+              out_data[out_ix] = in_data[in_ix];
+            } else {
+              memcpy(
+                  out_data + out_ix,
+                  in_data + in_ix,
+                  row_numel * sizeof(CTYPE));
+            }
+          }
+        });
   });
 
   return out;
@@ -88,8 +88,12 @@ Tensor& index_put_out(
     return out;
   }
 
-  // To start, copy the input data into the out tensor
-  memcpy(out.mutable_data_ptr<char>(), in.const_data_ptr<char>(), in.nbytes());
+  // To start, copy the input data into the out tensor, unless out is planned
+  // in place of the input, as for mutable state
+  if (out.const_data_ptr() != in.const_data_ptr()) {
+    memcpy(
+        out.mutable_data_ptr<char>(), in.const_data_ptr<char>(), in.nbytes());
+  }
 
   // In what follows, `x = in[indices]`. This tensor is implicit, and it would
   // be much easier to be able to allocate memory, and then call index.Tensor
@@ -115,11 +119,26 @@ Tensor& index_put_out(
     x_numel *= x_sizes[i];
   }
 
+  // The dimensions after the last indexed one are the trailing dimensions of
+  // `x` too, so `x` is walked a row of them at a time: each row is contiguous
+  // in `out`, and in `values` unless `values` broadcasts along it. Rows can
+  // repeat when indices do, so they are put in order.
+  const size_t trailing_ndim = get_num_trailing_non_indexed_dims(in, indices);
+  size_t row_numel = 1;
+  for (size_t d = in.dim() - trailing_ndim; d < in.dim(); d++) {
+    row_numel *= in.size(d);
+  }
+  bool values_rows_contiguous = values.dim() >= trailing_ndim;
+  for (size_t i = 1; values_rows_contiguous && i <= trailing_ndim; i++) {
+    values_rows_contiguous =
+        values.size(values.dim() - i) == in.size(in.dim() - i);
+  }
+
   ET_SWITCH_REAL_TYPES_AND(Bool, in_type, ctx, __func__, CTYPE, [&]() {
     const CTYPE* const values_data = values.const_data_ptr<CTYPE>();
     CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
 
-    for (auto x_ix = 0; x_ix < x_numel; x_ix++) {
+    for (size_t x_ix = 0; x_ix < x_numel; x_ix += row_numel) {
       size_t in_ix = 0;
 
       size_t x_coord[kTensorDimensionLimit];
@@ -135,13 +154,32 @@ Tensor& index_put_out(
           out);
 
       in_ix = coordinateToIndex(in, in_coord);
+      CTYPE* const out_row = out_data + in_ix;
 
       // Braodcast values
-      size_t val_ix = linearize_access_indexes(x_coord, x_dim, values);
-      if (accumulate) {
-        out_data[in_ix] += values_data[val_ix];
+      if (values_rows_contiguous || values.numel() == 1) {
+        const size_t val_ix = linearize_access_indexes(x_coord, x_dim, values);
+        const CTYPE* const values_row = values_data + val_ix;
+        const size_t val_step = values_rows_contiguous ? 1 : 0;
+        for (size_t i = 0; i < row_numel; i++) {
+          if (accumulate) {
+            out_row[i] += values_row[i * val_step];
+          } else {
+            out_row[i] = values_row[i * val_step];
+          }
+        }
       } else {
-        out_data[in_ix] = values_data[val_ix];
+        for (size_t i = 0; i < row_numel; i++) {
+          delinearize_index(
+              x_ix + i, {x_sizes, x_dim}, x_coord, kTensorDimensionLimit);
+          const size_t val_ix =
+              linearize_access_indexes(x_coord, x_dim, values);
+          if (accumulate) {
+            out_row[i] += values_data[val_ix];
+          } else {
+            out_row[i] = values_data[val_ix];
+          }
+        }
       }
     }
   });
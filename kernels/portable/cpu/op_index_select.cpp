@@ -12,6 +12,7 @@
 
 #include <executorch/kernels/portable/cpu/util/index_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -65,17 +66,22 @@ Tensor& index_select_out(
 
   ScalarType ix_type = index.scalar_type();
 
+  // Each selected row is copied whole, and rows are independent.
   ET_SWITCH_TWO_TYPES(Long, Int, ix_type, ctx, __func__, CTYPE, [&]() {
-    const CTYPE* const index_arr = index.mutable_data_ptr<CTYPE>();
-    for (int i = 0; i < leading_dims; i++) {
-      const char* src = input_data + i * in_dim_length * length_per_step;
-      char* dest = out_data + i * out_dim_length * length_per_step;
-      for (auto j = 0; j < out_dim_length; j++) {
-        const char* copy_src = src + index_arr[j] * length_per_step;
-        memcpy(dest, copy_src, length_per_step);
-        dest += length_per_step;
-      }
-    }
+    const CTYPE* const index_arr = index.const_data_ptr<CTYPE>();
+    parallel_for(
+        0,
+        leading_dims * out_dim_length,
+        parallel_grain_size(trailing_dims),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; row++) {
+            const size_t i = row / out_dim_length;
+            const size_t j = row % out_dim_length;
+            const char* copy_src = input_data +
+                (i * in_dim_length + index_arr[j]) * length_per_step;
+            memcpy(out_data + row * length_per_step, copy_src, length_per_step);
+          }
+        });
   });
 
   return out;
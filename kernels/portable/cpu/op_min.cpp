@@ -79,21 +79,22 @@ std::tuple<Tensor&, Tensor&> min_out(
     CTYPE* min_data = min.mutable_data_ptr<CTYPE>();
     long* min_indices_data = min_indices.mutable_data_ptr<long>();
 
-    for (size_t out_ix = 0; out_ix < min.numel(); ++out_ix) {
-      std::tuple<CTYPE, long> acc = reduce_over_dim<CTYPE>(
-          [](CTYPE v, long ix, CTYPE acc_val, long acc_ix) {
-            if (!std::isnan(acc_val) && (std::isnan(v) || v < acc_val)) {
-              acc_val = v;
-              acc_ix = ix;
-            }
-            return std::tuple<CTYPE, long>{acc_val, acc_ix};
-          },
-          in,
-          dim,
-          out_ix);
-      min_data[out_ix] = std::get<0>(acc);
-      min_indices_data[out_ix] = std::get<1>(acc);
-    }
+    parallel_for_each_reduce_over_dim_output_index(
+        in, dim, min, [&](const size_t out_ix) {
+          std::tuple<CTYPE, long> acc = reduce_over_dim<CTYPE>(
+              [](CTYPE v, long ix, CTYPE acc_val, long acc_ix) {
+                if (!std::isnan(acc_val) && (std::isnan(v) || v < acc_val)) {
+                  acc_val = v;
+                  acc_ix = ix;
+                }
+                return std::tuple<CTYPE, long>{acc_val, acc_ix};
+              },
+              in,
+              dim,
+              out_ix);
+          min_data[out_ix] = std::get<0>(acc);
+          min_indices_data[out_ix] = std::get<1>(acc);
+        });
   });
   return {min, min_indices};
 }
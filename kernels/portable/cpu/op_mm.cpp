@@ -9,6 +9,7 @@
 #include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
 #include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -29,18 +30,26 @@ mm_out(RuntimeContext& ctx, const Tensor& in, const Tensor& mat2, Tensor& out) {
       InvalidArgument,
       out);
 
-  ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "mm", CTYPE, [&]() {
+  ET_SWITCH_REALHBF16_TYPES(in.scalar_type(), ctx, "mm", CTYPE, [&]() {
     size_t m = in.size(0);
     size_t n = in.size(1);
     size_t p = mat2.size(1);
 
-    vec_matmul<CTYPE>(
-        out.mutable_data_ptr<CTYPE>(),
-        in.const_data_ptr<CTYPE>(),
-        mat2.const_data_ptr<CTYPE>(),
-        m,
-        n,
-        p);
+    CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+    const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+    const CTYPE* mat2_data = mat2.const_data_ptr<CTYPE>();
+
+    // Each chunk of rows of `out` only depends on the same rows of `in`.
+    parallel_for(
+        0, m, parallel_grain_size(n * p), [&](int64_t begin, int64_t end) {
+          vec_matmul<CTYPE>(
+              out_data + begin * p,
+              in_data + begin * n,
+              mat2_data,
+              end - begin,
+              n,
+              p);
+        });
   });
 
   return out;
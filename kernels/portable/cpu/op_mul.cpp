@@ -29,10 +29,25 @@ mul_out(RuntimeContext& ctx, const Tensor& a, const Tensor& b, Tensor& out) {
 
   ET_CHECK(canCast(common_type, out_type));
 
-  ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "mul", CTYPE_A, [&]() {
-    ET_SWITCH_REAL_TYPES_AND(Bool, b_type, ctx, "mul", CTYPE_B, [&]() {
-      ET_SWITCH_REAL_TYPES_AND(Bool, common_type, ctx, "mul", CTYPE_IN, [&]() {
-        ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "mul", CTYPE_OUT, [&]() {
+  // With a single dtype, one switch level is enough, and the loop has no
+  // conversions in it.
+  if (a_type == b_type && a_type == out_type) {
+    ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "mul", CTYPE, [&]() {
+      apply_binary_elementwise_fn<CTYPE, CTYPE, CTYPE>(
+          [](const CTYPE val_a, const CTYPE val_b) {
+            return static_cast<CTYPE>(val_a * val_b);
+          },
+          a,
+          b,
+          out);
+    });
+    return out;
+  }
+
+  ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "mul", CTYPE_A, [&]() {
+    ET_SWITCH_REALHBBF16_TYPES(b_type, ctx, "mul", CTYPE_B, [&]() {
+      ET_SWITCH_REALHBBF16_TYPES(common_type, ctx, "mul", CTYPE_IN, [&]() {
+        ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "mul", CTYPE_OUT, [&]() {
           apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
               [](const CTYPE_A val_a, const CTYPE_B val_b) {
                 CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
@@ -70,10 +85,10 @@ Tensor& mul_scalar_out(
 
   ET_CHECK(common_type == out_type);
 
-  ET_SWITCH_REAL_TYPES_AND(Bool, a_type, ctx, "mul", CTYPE_A, [&]() {
+  ET_SWITCH_REALHBBF16_TYPES(a_type, ctx, "mul", CTYPE_A, [&]() {
     ET_SWITCH_SCALAR_OBJ_TYPES(b_type, ctx, "mul", CTYPE_B, [&]() {
-      ET_SWITCH_REAL_TYPES_AND(Bool, common_type, ctx, "mul", CTYPE_IN, [&]() {
-        ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "mul", CTYPE_OUT, [&]() {
+      ET_SWITCH_REALHBBF16_TYPES(common_type, ctx, "mul", CTYPE_IN, [&]() {
+        ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "mul", CTYPE_OUT, [&]() {
           CTYPE_B b_val;
           ET_EXTRACT_SCALAR(b, b_val);
           CTYPE_IN b_casted = static_cast<CTYPE_IN>(b_val);
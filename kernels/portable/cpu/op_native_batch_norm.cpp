@@ -6,11 +6,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <tuple>
 
 #include <executorch/kernels/portable/cpu/util/normalization_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <executorch/runtime/platform/assert.h>
 
 namespace torch {
@@ -63,17 +65,21 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
       InvalidArgument,
       ret_val);
 
-  // For now, only support the default dim order
   ET_KERNEL_CHECK(
       ctx,
-      is_default_dim_order(in.dim_order().data(), in.dim_order().size()),
+      tensor_is_default_or_channels_last_dim_order(in),
       InvalidArgument,
       ret_val);
+  ET_KERNEL_CHECK(
+      ctx, in.dim_order().equals(out.dim_order()), InvalidArgument, ret_val);
 
   size_t C_dim = in.dim() >= 1 ? 1 : 0;
   size_t C = in.size(C_dim);
   size_t outer = getLeadingDims(in, C_dim);
   size_t inner = getTrailingDims(in, C_dim);
+  // In the channels last dim order, the channels are the innermost dim
+  bool channels_last =
+      !is_default_dim_order(in.dim_order().data(), in.dim_order().size());
 
   ET_SWITCH_FLOAT_TYPES(
       in.scalar_type(), ctx, "native_batch_norm_legit_no_training", CTYPE, [&] {
@@ -82,27 +88,67 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
 
         const CTYPE* const mean_data = running_mean.const_data_ptr<CTYPE>();
         const CTYPE* const var_data = running_var.const_data_ptr<CTYPE>();
-
-        for (size_t i = 0; i < outer; ++i) {
-          for (size_t c = 0; c < C; ++c) {
-            CTYPE mean = mean_data[c];
-            CTYPE var = var_data[c];
-            CTYPE invstd = 1.0 / std::sqrt(var + eps);
-            CTYPE weight_val = 1;
-            if (weight.has_value()) {
-              weight_val = weight.value().const_data_ptr<CTYPE>()[c];
-            }
-            CTYPE bias_val = 0;
-            if (bias.has_value()) {
-              bias_val = bias.value().const_data_ptr<CTYPE>()[c];
-            }
-            for (size_t j = 0; j < inner; ++j) {
-              *out_data = (*in_data - mean) * invstd * weight_val + bias_val;
-              out_data++;
-              in_data++;
+        const CTYPE* const weight_data = weight.has_value()
+            ? weight.value().const_data_ptr<CTYPE>()
+            : nullptr;
+        const CTYPE* const bias_data =
+            bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+
+        // In inference, batch norm is the affine map x * scale + shift of each
+        // channel.
+        auto get_scale_and_shift = [&](size_t c, CTYPE& scale, CTYPE& shift) {
+          const CTYPE invstd = 1.0 / std::sqrt(var_data[c] + eps);
+          scale = weight_data == nullptr ? invstd : weight_data[c] * invstd;
+          shift = (bias_data == nullptr ? 0 : bias_data[c]) -
+              mean_data[c] * scale;
+        };
+
+        if (channels_last) {
+          // Compute the parameters of a tile of channels at a time, and apply
+          // them to the tile of every pixel.
+          constexpr size_t kTile = 16;
+          CTYPE scale[kTile];
+          CTYPE shift[kTile];
+          const size_t num_pixels = outer * inner;
+          for (size_t c0 = 0; c0 < C; c0 += kTile) {
+            const size_t tile = std::min(kTile, C - c0);
+            for (size_t c = 0; c < tile; ++c) {
+              get_scale_and_shift(c0 + c, scale[c], shift[c]);
             }
+            parallel_for(
+                0,
+                num_pixels,
+                parallel_grain_size(tile),
+                [&](int64_t begin, int64_t end) {
+                  for (int64_t i = begin; i < end; ++i) {
+                    const CTYPE* in_pixel = in_data + i * C + c0;
+                    CTYPE* out_pixel = out_data + i * C + c0;
+                    for (size_t c = 0; c < tile; ++c) {
+                      out_pixel[c] = in_pixel[c] * scale[c] + shift[c];
+                    }
+                  }
+                });
           }
+          return;
         }
+
+        // Each plane of `inner` elements belongs to one channel.
+        parallel_for(
+            0,
+            outer * C,
+            parallel_grain_size(inner),
+            [&](int64_t begin, int64_t end) {
+              for (int64_t p = begin; p < end; ++p) {
+                CTYPE scale;
+                CTYPE shift;
+                get_scale_and_shift(p % C, scale, shift);
+                const CTYPE* in_plane = in_data + p * inner;
+                CTYPE* out_plane = out_data + p * inner;
+                for (size_t j = 0; j < inner; ++j) {
+                  out_plane[j] = in_plane[j] * scale + shift;
+                }
+              }
+            });
       });
 
   return ret_val;
@@ -26,7 +26,7 @@ void layer_norm(
     IntArrayRef normalized_shape,
     const optional<Tensor>& weight,
     const optional<Tensor>& bias,
-    CTYPE eps,
+    vec_acc_t<CTYPE> eps,
     Tensor& out,
     Tensor& mean,
     Tensor& rstd) {
@@ -66,26 +66,29 @@ void layer_norm(
     bias_data = nullptr;
   }
 
+  // Half and BFloat16 statistics are computed in float.
+  using acc_t = vec_acc_t<CTYPE>;
   for (int i = 0; i < leading; ++i) {
     const CTYPE* x = input_data + i * normalized;
     CTYPE* y = out_data + i * normalized;
 
     // compute E[X] and Var[x] = E[x^2] - E[x]^2
-    CTYPE sum = reduce_add(x, normalized);
-    CTYPE sq_sum = vec_powerf(x, normalized);
-    CTYPE mean_value = sum / normalized;
-    CTYPE variance = sq_sum / normalized - mean_value * mean_value;
-    CTYPE std = std::sqrt(variance + eps);
+    acc_t sum = reduce_add(x, normalized);
+    acc_t sq_sum = vec_powerf(x, normalized);
+    acc_t mean_value = sum / normalized;
+    acc_t variance = sq_sum / normalized - mean_value * mean_value;
+    acc_t std = std::sqrt(variance + eps);
 
     // Calculate the elements of output
     for (int j = 0; j < normalized; ++j) {
-      CTYPE w = weight_data ? weight_data[j] : static_cast<CTYPE>(1);
-      CTYPE b = bias_data ? bias_data[j] : static_cast<CTYPE>(0);
-      y[j] = (x[j] - mean_value) / std * w + b;
+      acc_t w = weight_data ? static_cast<acc_t>(weight_data[j]) : 1;
+      acc_t b = bias_data ? static_cast<acc_t>(bias_data[j]) : 0;
+      y[j] = static_cast<CTYPE>(
+          (static_cast<acc_t>(x[j]) - mean_value) / std * w + b);
     }
 
-    mean_data[i] = mean_value;
-    rstd_data[i] = 1.0 / std;
+    mean_data[i] = static_cast<CTYPE>(mean_value);
+    rstd_data[i] = static_cast<CTYPE>(1.0 / std);
   }
 }
 
@@ -140,7 +143,7 @@ std::tuple<Tensor&, Tensor&, Tensor&> native_layer_norm_out(
       InvalidArgument,
       ret_val);
 
-  ET_SWITCH_FLOAT_TYPES(input.scalar_type(), ctx, __func__, CTYPE, [&]() {
+  ET_SWITCH_FLOATHBF16_TYPES(input.scalar_type(), ctx, __func__, CTYPE, [&]() {
     layer_norm<CTYPE>(
         input, normalized_shape, weight, bias, eps, out, mean_out, rstd_out);
   });
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cinttypes>
 #include <cmath>
 #include <cstring>
 
@@ -51,7 +52,7 @@ void check_preconditions(const Tensor& input, const Tensor& output) {
  * out to the appropriate size, and then loop again and properly write into out
  */
 template <typename CTYPE>
-void nonzero(const Tensor& input, Tensor& output) {
+void nonzero(RuntimeContext& ctx, const Tensor& input, Tensor& output) {
   const CTYPE* in_data = input.const_data_ptr<CTYPE>();
   size_t lim = input.numel();
   int32_t num_nonzero = 0;
@@ -66,7 +67,13 @@ void nonzero(const Tensor& input, Tensor& output) {
   // resize out
   SizesType out_shape[2] = {
       static_cast<SizesType>(num_nonzero), static_cast<SizesType>(input.dim())};
-  resize(output, ArrayRef<exec_aten::SizesType>(out_shape, 2));
+  // The output is usually unbounded, so it may need more storage.
+  Error err =
+      ctx.resize_tensor(output, ArrayRef<exec_aten::SizesType>(out_shape, 2));
+  ET_CHECK_MSG(
+      err == Error::Ok,
+      "Failed to resize out: 0x%" PRIx32,
+      static_cast<uint32_t>(err));
 
   size_t index[kTensorDimensionLimit];
   memset(index, 0, sizeof(index));
@@ -92,12 +99,10 @@ void nonzero(const Tensor& input, Tensor& output) {
  * Out is a 2-D tensor where every row is a non zero index of the input.
  */
 Tensor& nonzero_out(RuntimeContext& ctx, const Tensor& in, Tensor& out) {
-  (void)ctx;
-
   check_preconditions(in, out);
 
   ET_SWITCH_REAL_TYPES_AND(Bool, in.scalar_type(), ctx, "nonzero", CTYPE, [&] {
-    nonzero<CTYPE>(in, out);
+    nonzero<CTYPE>(ctx, in, out);
   });
 
   return out;
@@ -8,6 +8,7 @@
 
 #include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -16,6 +17,40 @@ namespace native {
 using SizesType = exec_aten::SizesType;
 using Tensor = exec_aten::Tensor;
 
+namespace {
+
+// Interleaves S input rows, `in_row_stride` elements apart, into one output
+// row: out_row[w * S + s2] = in_row[s2 * in_row_stride + w]. The common
+// upscale factors are template parameters so that the inner loop unrolls.
+template <typename CTYPE, int64_t S>
+void shuffle_row(
+    const CTYPE* const in_row,
+    const int64_t in_row_stride,
+    const int64_t width,
+    CTYPE* const out_row) {
+  for (int64_t w = 0; w < width; w++) {
+    for (int64_t s2 = 0; s2 < S; s2++) {
+      out_row[w * S + s2] = in_row[s2 * in_row_stride + w];
+    }
+  }
+}
+
+template <typename CTYPE>
+void shuffle_row(
+    const CTYPE* const in_row,
+    const int64_t in_row_stride,
+    const int64_t width,
+    const int64_t S,
+    CTYPE* const out_row) {
+  for (int64_t w = 0; w < width; w++) {
+    for (int64_t s2 = 0; s2 < S; s2++) {
+      out_row[w * S + s2] = in_row[s2 * in_row_stride + w];
+    }
+  }
+}
+
+} // namespace
+
 Tensor& pixel_shuffle_out(
     RuntimeContext& ctx,
     const Tensor& in,
@@ -70,22 +105,38 @@ Tensor& pixel_shuffle_out(
 
         // input tensor shape of [n, c, s1, s2, h, w]
         // output tensor shape of [n, c, h, s1, w, s2]
-        size_t i = 0;
-        for (size_t n = 0; n < leading_dims; n++) {
-          for (size_t c = 0; c < sub_channels; c++) {
-            for (size_t h = 0; h < height; h++) {
-              for (size_t s1 = 0; s1 < S; s1++) {
-                for (size_t w = 0; w < width; w++) {
-                  for (size_t s2 = 0; s2 < S; s2++) {
-                    int64_t input_offset = n * stride_n + c * stride_c +
-                        s1 * stride_s1 + s2 * stride_s2 + h * stride_h + w;
-                    out_data[i++] = in_data[input_offset];
-                  }
+        // Each output row (n, c, h, s1) interleaves the S input rows
+        // (n, c, s1, s2, h) for s2 in [0, S), and rows are independent.
+        const int64_t num_rows = leading_dims * sub_channels * height * S;
+        const int64_t out_row_len = width * S;
+        parallel_for(
+            0,
+            num_rows,
+            parallel_grain_size(out_row_len),
+            [&](int64_t begin, int64_t end) {
+              for (int64_t row = begin; row < end; row++) {
+                const int64_t s1 = row % S;
+                const int64_t h = (row / S) % height;
+                const int64_t c = (row / (S * height)) % sub_channels;
+                const int64_t n = row / (S * height * sub_channels);
+                const CTYPE* const in_row = in_data + n * stride_n +
+                    c * stride_c + s1 * stride_s1 + h * stride_h;
+                CTYPE* const out_row = out_data + row * out_row_len;
+                switch (S) {
+                  case 2:
+                    shuffle_row<CTYPE, 2>(in_row, stride_s2, width, out_row);
+                    break;
+                  case 3:
+                    shuffle_row<CTYPE, 3>(in_row, stride_s2, width, out_row);
+                    break;
+                  case 4:
+                    shuffle_row<CTYPE, 4>(in_row, stride_s2, width, out_row);
+                    break;
+                  default:
+                    shuffle_row<CTYPE>(in_row, stride_s2, width, S, out_row);
                 }
               }
-            }
-          }
-        }
+            });
       });
 
   return out;
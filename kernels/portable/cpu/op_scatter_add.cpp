@@ -8,6 +8,8 @@
 
 #include <executorch/kernels/portable/cpu/util/index_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
 #include <cstring>
 
 namespace torch {
@@ -48,6 +50,106 @@ void scatter_add_helper(
   }
 }
 
+// Whether the dimensions of `t` from `first_dim` on are laid out contiguously.
+bool is_contiguous_from(const Tensor& t, size_t first_dim) {
+  size_t expected_stride = 1;
+  for (size_t d = t.dim(); d > first_dim; --d) {
+    if (t.size(d - 1) != 1 && t.strides()[d - 1] != expected_stride) {
+      return false;
+    }
+    expected_stride *= t.size(d - 1);
+  }
+  return true;
+}
+
+// The index, src and out share their sizes after `dim`, and those dimensions
+// are contiguous, so each index element scatters a whole contiguous row of
+// trailing elements.
+bool can_scatter_add_rows(
+    const Tensor& src,
+    const Tensor& index,
+    const Tensor& out,
+    int64_t dim) {
+  if (index.dim() == 0 || index.dim() != src.dim() ||
+      index.dim() != out.dim()) {
+    return false;
+  }
+  for (size_t d = dim + 1; d < index.dim(); ++d) {
+    if (index.size(d) != src.size(d) || index.size(d) != out.size(d)) {
+      return false;
+    }
+  }
+  return is_contiguous_from(index, 0) && is_contiguous_from(src, dim + 1) &&
+      is_contiguous_from(out, dim + 1);
+}
+
+// Splits the index into (leading, dim, trailing) and scatters along `dim`
+// for each leading and trailing coordinate. Distinct leading or trailing
+// coordinates write distinct out elements, so they are scattered in parallel;
+// along `dim`, elements are added in index order, like scatter_add_helper.
+template <typename CTYPE>
+void scatter_add_rows(
+    const CTYPE* src_data,
+    const long* index_data,
+    CTYPE* out_data,
+    const Tensor& src,
+    const Tensor& index,
+    const Tensor& out,
+    int64_t dim) {
+  const size_t leading = getLeadingDims(index, dim);
+  const size_t index_dim_size = index.size(dim);
+  const size_t trailing = getTrailingDims(index, dim);
+  const size_t src_dim_stride = src.strides()[dim];
+  const size_t out_dim_stride = out.strides()[dim];
+
+  parallel_for(
+      0,
+      leading * trailing,
+      parallel_grain_size(index_dim_size),
+      [&](int64_t begin, int64_t end) {
+        for (size_t l = begin / trailing; l * trailing < end; ++l) {
+          // Offsets of this leading coordinate in src and out.
+          size_t src_base = 0;
+          size_t out_base = 0;
+          size_t rem = l;
+          for (int64_t d = dim - 1; d >= 0; --d) {
+            const size_t coord = rem % index.size(d);
+            rem /= index.size(d);
+            src_base += coord * src.strides()[d];
+            out_base += coord * out.strides()[d];
+          }
+          const size_t t_begin = std::max<int64_t>(begin - l * trailing, 0);
+          const size_t t_end = std::min<int64_t>(end - l * trailing, trailing);
+          const long* const index_row =
+              index_data + l * index_dim_size * trailing;
+
+          if (trailing == 1) {
+            // A run of equal indices keeps its sum in a register.
+            for (size_t k = 0; k < index_dim_size;) {
+              const long target = index_row[k];
+              CTYPE* const dst = out_data + out_base + target * out_dim_stride;
+              CTYPE sum = *dst;
+              do {
+                sum += src_data[src_base + k * src_dim_stride];
+                ++k;
+              } while (k < index_dim_size && index_row[k] == target);
+              *dst = sum;
+            }
+            continue;
+          }
+          for (size_t k = 0; k < index_dim_size; ++k) {
+            const long* const ix = index_row + k * trailing;
+            const CTYPE* const src_row =
+                src_data + src_base + k * src_dim_stride;
+            CTYPE* const out_row = out_data + out_base;
+            for (size_t t = t_begin; t < t_end; ++t) {
+              out_row[ix[t] * out_dim_stride + t] += src_row[t];
+            }
+          }
+        }
+      });
+}
+
 } // namespace
 
 Tensor& scatter_add_out(
@@ -89,8 +191,13 @@ Tensor& scatter_add_out(
       if (self.dim() == 0) {
         out_data[0] += nonempty_size(index, 0) * src_data[0];
       } else {
-        scatter_add_helper<CTYPE>(
-            src_data, index_data, out_data, src, index, out, dim);
+        if (can_scatter_add_rows(src, index, out, dim)) {
+          scatter_add_rows<CTYPE>(
+              src_data, index_data, out_data, src, index, out, dim);
+        } else {
+          scatter_add_helper<CTYPE>(
+              src_data, index_data, out_data, src, index, out, dim);
+        }
       }
     }
   });
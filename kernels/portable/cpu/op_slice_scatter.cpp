@@ -165,8 +165,11 @@ Tensor& slice_scatter_out(
   size_t leading_dims = getLeadingDims(input, dim);
   size_t trailing_dims = getTrailingDims(input, dim);
 
-  // To start, copy the input into the output
-  memcpy(out.mutable_data_ptr(), input.const_data_ptr(), input.nbytes());
+  // To start, copy the input into the output, unless out is planned in place
+  // of the input, as for mutable state
+  if (out.const_data_ptr() != input.const_data_ptr()) {
+    memcpy(out.mutable_data_ptr(), input.const_data_ptr(), input.nbytes());
+  }
 
   ScalarType in_type = input.scalar_type();
   ScalarType src_type = src.scalar_type();
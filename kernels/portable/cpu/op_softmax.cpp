@@ -11,6 +11,7 @@
 #include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
 #include <executorch/kernels/portable/cpu/util/functional_util.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/kernels/portable/cpu/vec_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -35,29 +36,32 @@ Tensor& softmax_out(
   // Adjust for negative dim
   dim = dim < 0 ? dim + nonzero_dim(in) : dim;
 
-  ET_SWITCH_FLOAT_TYPES(in.scalar_type(), ctx, "softmax", CTYPE, [&]() {
+  ET_SWITCH_FLOATHBF16_TYPES(in.scalar_type(), ctx, "softmax", CTYPE, [&]() {
+    // Half and BFloat16 are computed in float.
+    using acc_t = vec_acc_t<CTYPE>;
     const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
     CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
 
-    apply_over_dim(
+    parallel_apply_over_dim(
         [in_data, out_data](
             const size_t size, const size_t stride, const size_t base) {
           // calculate max in softmax dim. During softmax computation each
           // value is subtracted by the maximum in value before calling exp
           // to preserve numerical stability.
-          const CTYPE max_in = apply_unary_reduce_fn(
-              [](const CTYPE val_in, CTYPE val_accum) {
+          const acc_t max_in = apply_unary_map_reduce_fn<CTYPE, acc_t>(
+              [](const CTYPE val_in) { return static_cast<acc_t>(val_in); },
+              [](const acc_t val_in, acc_t val_accum) {
                 return std::max(val_in, val_accum);
               },
               in_data + base,
               size,
               stride);
 
-          const CTYPE temp_sum = apply_unary_map_reduce_fn<CTYPE, CTYPE>(
+          const acc_t temp_sum = apply_unary_map_reduce_fn<CTYPE, acc_t>(
               [max_in](const CTYPE val_in) {
-                return std::exp(val_in - max_in);
+                return std::exp(static_cast<acc_t>(val_in) - max_in);
               },
-              [](const CTYPE mapped_in, CTYPE val_accum) {
+              [](const acc_t mapped_in, acc_t val_accum) {
                 return val_accum + mapped_in;
               },
               in_data + base,
@@ -66,7 +70,8 @@ Tensor& softmax_out(
 
           apply_unary_map_fn(
               [max_in, temp_sum](const CTYPE val_in) {
-                return std::exp(val_in - max_in) / temp_sum;
+                return static_cast<CTYPE>(
+                    std::exp(static_cast<acc_t>(val_in) - max_in) / temp_sum);
               },
               in_data + base,
               out_data + base,
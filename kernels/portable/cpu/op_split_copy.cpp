@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstring>
 
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -175,6 +176,28 @@ void split_copy_Tensor_out(
   ScalarType in_type = input.scalar_type();
   ScalarType out_type = out[0].scalar_type();
 
+  if (in_type == out_type) {
+    // Each output takes one contiguous block of every outer slice of input.
+    const size_t elem_size = input.element_size();
+    const char* input_data = input.const_data_ptr<char>();
+    for (size_t i = 0, e = out.size(); i < e; ++i) {
+      const size_t out_block_nbytes =
+          out[i].size(dim) * trailing_dims * elem_size;
+      if (out_block_nbytes == 0) {
+        continue;
+      }
+      copy_blocks(
+          out[i].mutable_data_ptr<char>(),
+          out_block_nbytes,
+          input_data,
+          step * elem_size,
+          out_block_nbytes,
+          leading_dims);
+      input_data += out_block_nbytes;
+    }
+    return;
+  }
+
   ET_SWITCH_REAL_TYPES_AND(Bool, in_type, ctx, __func__, CTYPE_IN, [&]() {
     ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, __func__, CTYPE_OUT, [&]() {
       const CTYPE_IN* input_data = input.const_data_ptr<CTYPE_IN>();
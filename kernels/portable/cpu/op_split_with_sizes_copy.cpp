@@ -69,6 +69,37 @@ void split_with_sizes_copy_out(
   ScalarType in_type = in.scalar_type();
   ScalarType out_type = out[0].scalar_type();
 
+  if (in_type == out_type) {
+    // Without broadcasting, each output takes one contiguous block of every
+    // outer slice of in.
+    bool is_broadcasted = false;
+    for (size_t i = 0; i < out.size(); ++i) {
+      target_out_sizes[dim] = static_cast<Tensor::SizesType>(split_sizes[i]);
+      if (!out[i].sizes().equals({target_out_sizes, target_out_ndim})) {
+        is_broadcasted = true;
+        break;
+      }
+    }
+    if (!is_broadcasted) {
+      const size_t elem_size = in.element_size();
+      const char* in_data = in.const_data_ptr<char>();
+      for (size_t i = 0; i < out.size(); ++i) {
+        const size_t chunk_nbytes = split_sizes[i] * trailing_dims * elem_size;
+        if (out[i].numel() != 0) {
+          copy_blocks(
+              out[i].mutable_data_ptr<char>(),
+              chunk_nbytes,
+              in_data,
+              step * elem_size,
+              chunk_nbytes,
+              leading_dims);
+        }
+        in_data += chunk_nbytes;
+      }
+      return;
+    }
+  }
+
   ET_SWITCH_REAL_TYPES_AND(Bool, in_type, ctx, __func__, CTYPE_IN, [&]() {
     ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, __func__, CTYPE_OUT, [&]() {
       const CTYPE_IN* in_data = in.const_data_ptr<CTYPE_IN>();
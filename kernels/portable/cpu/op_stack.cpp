@@ -45,6 +45,30 @@ Tensor& stack_out(
   const size_t ninputs = tensors.size();
 
   const auto out_type = out.scalar_type();
+
+  bool same_dtype = true;
+  for (size_t j = 0; j < ninputs; ++j) {
+    if (tensors[j].scalar_type() != out_type) {
+      same_dtype = false;
+      break;
+    }
+  }
+  if (same_dtype) {
+    // Each input is one contiguous block of every outer slice of out.
+    const size_t block_nbytes = inner * out.element_size();
+    char* out_ptr = out.mutable_data_ptr<char>();
+    for (size_t j = 0; j < ninputs; ++j) {
+      copy_blocks(
+          out_ptr + j * block_nbytes,
+          ninputs * block_nbytes,
+          tensors[j].const_data_ptr<char>(),
+          block_nbytes,
+          block_nbytes,
+          outer);
+    }
+    return out;
+  }
+
   ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "stack", CTYPE_OUT, [&] {
     CTYPE_OUT* out_ptr = out.mutable_data_ptr<CTYPE_OUT>();
     for (size_t i = 0; i < outer; ++i) {
@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstring>
 
+#include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -102,6 +103,23 @@ void unbind_copy_int_out(
   ScalarType in_type = input.scalar_type();
   ScalarType out_type = out[0].scalar_type();
 
+  if (in_type == out_type) {
+    // Each output takes one contiguous block of every outer slice of input.
+    const size_t elem_size = input.element_size();
+    const size_t block_nbytes = trailing_dims * elem_size;
+    const char* const input_data = input.const_data_ptr<char>();
+    for (size_t i = 0, e = out.size(); i < e; ++i) {
+      copy_blocks(
+          out[i].mutable_data_ptr<char>(),
+          block_nbytes,
+          input_data + i * block_nbytes,
+          step * elem_size,
+          block_nbytes,
+          leading_dims);
+    }
+    return;
+  }
+
   ET_SWITCH_REAL_TYPES_AND(Bool, in_type, ctx, __func__, CTYPE_IN, [&]() {
     ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, __func__, CTYPE_OUT, [&]() {
       const CTYPE_IN* const input_data = input.const_data_ptr<CTYPE_IN>();
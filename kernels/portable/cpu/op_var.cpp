@@ -60,26 +60,27 @@ Tensor& var_out(
           out_data[out_ix] = NAN;
         }
       } else {
-        for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
-          CTYPE_OUT sum = map_reduce_over_dim_list<CTYPE_IN, CTYPE_OUT>(
-              [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); },
-              [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
-              in,
-              dim_list,
-              out_ix);
-          CTYPE_OUT mean = sum / num;
-          CTYPE_OUT sum2 = map_reduce_over_dim_list<CTYPE_IN, CTYPE_OUT>(
-              [mean](CTYPE_IN v) {
-                return (
-                    (static_cast<CTYPE_OUT>(v) - mean) *
-                    (static_cast<CTYPE_OUT>(v) - mean));
-              },
-              [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
-              in,
-              dim_list,
-              out_ix);
-          out_data[out_ix] = sum2 / denominator;
-        }
+        parallel_for_each_reduce_over_dim_list_output_index(
+            in, dim_list, out, [&](const size_t out_ix) {
+              CTYPE_OUT sum = map_reduce_over_dim_list<CTYPE_IN, CTYPE_OUT>(
+                  [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); },
+                  [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
+                  in,
+                  dim_list,
+                  out_ix);
+              CTYPE_OUT mean = sum / num;
+              CTYPE_OUT sum2 = map_reduce_over_dim_list<CTYPE_IN, CTYPE_OUT>(
+                  [mean](CTYPE_IN v) {
+                    return (
+                        (static_cast<CTYPE_OUT>(v) - mean) *
+                        (static_cast<CTYPE_OUT>(v) - mean));
+                  },
+                  [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
+                  in,
+                  dim_list,
+                  out_ix);
+              out_data[out_ix] = sum2 / denominator;
+            });
       }
     });
   });
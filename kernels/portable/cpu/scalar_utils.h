@@ -184,6 +184,35 @@ bool extract_scalar(Scalar scalar, FLOAT_T* out_val) {
   return true;
 }
 
+/**
+ * Extracts a half-precision floating point value from a Scalar.
+ *
+ * @param[in] scalar The source of the value to extract.
+ * @param[out] out_val The extracted value, on success.
+ * @returns `true` if a value was extracted, and sets `*out_val` to that value.
+ *    `false` if a value could not be extracted, for the same reasons as for
+ *    `float`, or because the value is outside the finite range of HALF_T.
+ */
+template <
+    typename HALF_T,
+    typename std::enable_if<
+        std::is_same<HALF_T, exec_aten::Half>::value ||
+            std::is_same<HALF_T, exec_aten::BFloat16>::value,
+        bool>::type = true>
+bool extract_scalar(Scalar scalar, HALF_T* out_val) {
+  float val;
+  if (!extract_scalar(scalar, &val)) {
+    return false;
+  }
+  if (std::isfinite(val) &&
+      (val < static_cast<float>(std::numeric_limits<HALF_T>::lowest()) ||
+       val > static_cast<float>(std::numeric_limits<HALF_T>::max()))) {
+    return false;
+  }
+  *out_val = static_cast<HALF_T>(val);
+  return true;
+}
+
 /**
  * Extracts a boolean value from a Scalar.
  *
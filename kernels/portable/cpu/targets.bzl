@@ -40,6 +40,7 @@ _ATEN_OPS = (
         deps = [
             "//executorch/kernels/portable/cpu/util:broadcast_util",
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
             ":scalar_utils",
             ":vec_ops",
         ],
@@ -175,6 +176,7 @@ _ATEN_OPS = (
         name = "op_bmm",
         deps = [
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
             ":vec_ops",
         ],
     ),
@@ -202,12 +204,16 @@ _ATEN_OPS = (
     ),
     op_target(
         name = "op_constant_pad_nd",
-        deps = [":scalar_utils"],
+        deps = [
+            ":scalar_utils",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     ),
     op_target(
         name = "op_convolution",
         deps = [
             "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
             ":vec_ops",
         ],
     ),
@@ -237,6 +243,7 @@ _ATEN_OPS = (
         deps = [
             "//executorch/runtime/core/exec_aten/util:scalar_type_util",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
     ),
     op_target(
@@ -255,6 +262,9 @@ _ATEN_OPS = (
     ),
     op_target(
         name = "op_embedding",
+        deps = [
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     ),
     op_target(
         name = "op_eq",
@@ -376,6 +386,7 @@ _ATEN_OPS = (
         deps = [
             "//executorch/kernels/portable/cpu/util:advanced_index_util",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
     ),
     op_target(
@@ -389,6 +400,7 @@ _ATEN_OPS = (
         name = "op_index_select",
         deps = [
             "//executorch/kernels/portable/cpu/util:index_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
     ),
     op_target(
@@ -526,6 +538,7 @@ _ATEN_OPS = (
         name = "op_mm",
         deps = [
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
             ":vec_ops",
         ],
     ),
@@ -541,6 +554,7 @@ _ATEN_OPS = (
         name = "op_native_batch_norm",
         deps = [
             "//executorch/kernels/portable/cpu/util:normalization_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
     ),
     op_target(
@@ -586,6 +600,7 @@ _ATEN_OPS = (
         name = "op_pixel_shuffle",
         deps = [
             "//executorch/kernels/portable/cpu/util:copy_ops_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
     ),
     op_target(
@@ -643,6 +658,7 @@ _ATEN_OPS = (
             "//executorch/kernels/portable/cpu/util:index_util",
             "//executorch/runtime/core/exec_aten/util:scalar_type_util",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
     ),
     op_target(
@@ -702,6 +718,9 @@ _ATEN_OPS = (
     ),
     op_target(
         name = "op_split_copy",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
     ),
     op_target(
         name = "op_split_with_sizes_copy",
@@ -775,6 +794,9 @@ _ATEN_OPS = (
     ),
     op_target(
         name = "op_unbind_copy",
+        deps = [
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
     ),
     op_target(
         name = "op_unsqueeze_copy",
@@ -813,6 +835,9 @@ _ATEN_OPS = (
 # ops, and must be split. They can, however, share common code via a library dep
 # if necessary.
 _CUSTOM_OPS = (
+    op_target(
+        name = "op__to_dim_order_copy",
+    ),
     op_target(
         name = "op_allclose",
     ),
@@ -260,6 +260,23 @@ size_t get_num_leading_null_indices(TensorOptList indices) {
   return start;
 }
 
+size_t get_num_trailing_non_indexed_dims(
+    const Tensor& in,
+    TensorOptList indices) {
+  size_t in_i = 0;
+  size_t indexed_end = 0;
+  for (size_t i = 0; i < indices.size(); i++) {
+    if (indices[i].has_value()) {
+      const Tensor& index = indices[i].value();
+      in_i += is_mask_index(index) ? index.dim() : 1;
+      indexed_end = in_i;
+    } else {
+      in_i++;
+    }
+  }
+  return in.dim() - indexed_end;
+}
+
 bool get_index_out_target_size(
     const Tensor& in,
     TensorOptList indices,
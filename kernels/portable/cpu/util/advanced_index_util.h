@@ -72,6 +72,15 @@ size_t get_num_null_indices(TensorOptList indices);
  */
 size_t get_num_leading_null_indices(TensorOptList indices);
 
+/**
+ * Computes the number of input dimensions after the last indexed one. These
+ * dimensions are also the last dimensions of the indexing result, so each
+ * block of the result that spans them maps to a contiguous block of the input.
+ */
+size_t get_num_trailing_non_indexed_dims(
+    const Tensor& in,
+    TensorOptList indices);
+
 /**
  * Compute the expected size for the out tensor
  */
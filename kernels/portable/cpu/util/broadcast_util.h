@@ -10,6 +10,7 @@
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <array>
 
 namespace torch {
 namespace executor {
@@ -253,6 +254,110 @@ size_t linearize_access_indexes(
     ssize_t broadcast_to_ndim,
     const Tensor& broadcast_from);
 
+/**
+ * Walks the output of a broadcasting elementwise op in runs along its
+ * innermost dimension, tracking the offset of the element that each input
+ * contributes to the start of the current run. Dimensions that every operand
+ * walks as one are coalesced first, so adding a [C] bias to an [N, H, W, C]
+ * tensor is N*H*W runs of C, and an op without any broadcasting is a single
+ * run. Moving to the next run is amortized O(1), with no divisions.
+ *
+ * The output is expected to be contiguous, and every input broadcastable to
+ * it.
+ */
+template <size_t kNumInputs>
+class BroadcastRunIterator {
+ public:
+  BroadcastRunIterator(
+      const Tensor& out,
+      const std::array<const Tensor*, kNumInputs>& inputs) {
+    const ssize_t out_dim = out.dim();
+    for (ssize_t d = 0; d < out_dim; ++d) {
+      const size_t size = out.size(d);
+      if (size == 1) {
+        // Contributes to no offset.
+        continue;
+      }
+      ssize_t strides[kNumInputs];
+      for (size_t i = 0; i < kNumInputs; ++i) {
+        const Tensor& t = *inputs[i];
+        const ssize_t td = d - (out_dim - t.dim());
+        ET_DCHECK_MSG(
+            td < 0 || t.size(td) == 1 || t.size(td) == size,
+            "Input %zu is not broadcastable to the output",
+            i);
+        strides[i] = (td < 0 || t.size(td) == 1) ? 0 : t.strides()[td];
+      }
+      // The previous dim merges into this one if every input steps over it
+      // by exactly one run of this one.
+      bool coalesce = ndim_ > 0;
+      for (size_t i = 0; i < kNumInputs && coalesce; ++i) {
+        coalesce = strides_[i][ndim_ - 1] == strides[i] * ssize_t(size);
+      }
+      if (coalesce) {
+        sizes_[ndim_ - 1] *= size;
+      } else {
+        sizes_[ndim_] = size;
+        ndim_++;
+      }
+      for (size_t i = 0; i < kNumInputs; ++i) {
+        strides_[i][ndim_ - 1] = strides[i];
+      }
+    }
+    if (ndim_ == 0) {
+      sizes_[0] = 1;
+      for (size_t i = 0; i < kNumInputs; ++i) {
+        strides_[i][0] = 0;
+      }
+      ndim_ = 1;
+    }
+    for (size_t d = 0; d < ndim_; ++d) {
+      index_[d] = 0;
+    }
+    for (size_t i = 0; i < kNumInputs; ++i) {
+      offsets_[i] = 0;
+    }
+  }
+
+  /// Number of output elements in each run.
+  size_t run_size() const {
+    return sizes_[ndim_ - 1];
+  }
+
+  /// Element stride of input `i` within a run; 0 if it is broadcast along it.
+  ssize_t run_stride(size_t i) const {
+    return strides_[i][ndim_ - 1];
+  }
+
+  /// Element offset of input `i` at the start of the current run.
+  size_t offset(size_t i) const {
+    return offsets_[i];
+  }
+
+  /// Moves to the next run.
+  void next() {
+    for (ssize_t d = ssize_t(ndim_) - 2; d >= 0; --d) {
+      if (++index_[d] < sizes_[d]) {
+        for (size_t i = 0; i < kNumInputs; ++i) {
+          offsets_[i] += strides_[i][d];
+        }
+        return;
+      }
+      index_[d] = 0;
+      for (size_t i = 0; i < kNumInputs; ++i) {
+        offsets_[i] -= strides_[i][d] * (sizes_[d] - 1);
+      }
+    }
+  }
+
+ private:
+  size_t ndim_ = 0;
+  size_t sizes_[kTensorDimensionLimit];
+  ssize_t strides_[kNumInputs][kTensorDimensionLimit];
+  size_t index_[kTensorDimensionLimit];
+  size_t offsets_[kNumInputs];
+};
+
 //
 // Mapping with broadcasting
 //
@@ -261,6 +366,11 @@ size_t linearize_access_indexes(
  * Useful for binary elementwise operators. For each element of the inputs,
  * perform a computation and write to the corresponding element of the output.
  * Tensor broadcasting is applied wherever it is required.
+ *
+ * `out` may share its data with an input that has the same sizes and dtype,
+ * since each output element is written after its inputs are read and no
+ * other output element reads them. Memory planning relies on this to run
+ * kernels built on this function in place.
  */
 template <typename CTYPE_A, typename CTYPE_B, typename CTYPE_OUT, typename Op>
 inline void apply_binary_elementwise_fn(
@@ -268,31 +378,42 @@ inline void apply_binary_elementwise_fn(
     const Tensor& a,
     const Tensor& b,
     const Tensor& out) {
-  const bool a_is_broadcasted = !out.sizes().equals(a.sizes());
-  const bool b_is_broadcasted = !out.sizes().equals(b.sizes());
-  const bool any_is_broadcasted = (a_is_broadcasted || b_is_broadcasted);
-
   const CTYPE_A* const data_a = a.const_data_ptr<CTYPE_A>();
   const CTYPE_B* const data_b = b.const_data_ptr<CTYPE_B>();
   CTYPE_OUT* const data_out = out.mutable_data_ptr<CTYPE_OUT>();
 
-  for (size_t i = 0; i < out.numel(); ++i) {
-    size_t a_linear_index = i;
-    size_t b_linear_index = i;
-
-    if (any_is_broadcasted) {
-      size_t out_indexes[kTensorDimensionLimit];
-      delinearize_index(i, out, out_indexes, kTensorDimensionLimit);
-
-      if (a_is_broadcasted) {
-        a_linear_index = linearize_access_indexes(out_indexes, out.dim(), a);
+  const size_t numel = out.numel();
+  if (numel == 0) {
+    return;
+  }
+  BroadcastRunIterator<2> it(out, {&a, &b});
+  const size_t run = it.run_size();
+  const ssize_t a_step = it.run_stride(0);
+  const ssize_t b_step = it.run_stride(1);
+  for (size_t start = 0; start < numel; start += run, it.next()) {
+    const CTYPE_A* const run_a = data_a + it.offset(0);
+    const CTYPE_B* const run_b = data_b + it.offset(1);
+    CTYPE_OUT* const run_out = data_out + start;
+    // Separate loops for the common cases, which the compiler can vectorize.
+    if (a_step == 1 && b_step == 1) {
+      for (size_t j = 0; j < run; ++j) {
+        run_out[j] = compute_fun(run_a[j], run_b[j]);
+      }
+    } else if (a_step == 1 && b_step == 0) {
+      const CTYPE_B val_b = run_b[0];
+      for (size_t j = 0; j < run; ++j) {
+        run_out[j] = compute_fun(run_a[j], val_b);
+      }
+    } else if (a_step == 0 && b_step == 1) {
+      const CTYPE_A val_a = run_a[0];
+      for (size_t j = 0; j < run; ++j) {
+        run_out[j] = compute_fun(val_a, run_b[j]);
       }
-      if (b_is_broadcasted) {
-        b_linear_index = linearize_access_indexes(out_indexes, out.dim(), b);
+    } else {
+      for (size_t j = 0; j < run; ++j) {
+        run_out[j] = compute_fun(run_a[j * a_step], run_b[j * b_step]);
       }
     }
-
-    data_out[i] = compute_fun(data_a[a_linear_index], data_b[b_linear_index]);
   }
 }
 
@@ -313,39 +434,35 @@ inline void apply_ternary_elementwise_fn(
     const Tensor& b,
     const Tensor& c,
     const Tensor& out) {
-  const bool a_is_broadcasted = !out.sizes().equals(a.sizes());
-  const bool b_is_broadcasted = !out.sizes().equals(b.sizes());
-  const bool c_is_broadcasted = !out.sizes().equals(c.sizes());
-  const bool any_is_broadcasted =
-      (a_is_broadcasted || b_is_broadcasted || c_is_broadcasted);
-
   const CTYPE_A* const data_a = a.const_data_ptr<CTYPE_A>();
   const CTYPE_B* const data_b = b.const_data_ptr<CTYPE_B>();
   const CTYPE_C* const data_c = c.const_data_ptr<CTYPE_C>();
   CTYPE_OUT* const data_out = out.mutable_data_ptr<CTYPE_OUT>();
 
-  for (size_t i = 0; i < out.numel(); ++i) {
-    size_t a_linear_index = i;
-    size_t b_linear_index = i;
-    size_t c_linear_index = i;
-
-    if (any_is_broadcasted) {
-      size_t out_indexes[kTensorDimensionLimit];
-      delinearize_index(i, out, out_indexes, kTensorDimensionLimit);
-
-      if (a_is_broadcasted) {
-        a_linear_index = linearize_access_indexes(out_indexes, out.dim(), a);
-      }
-      if (b_is_broadcasted) {
-        b_linear_index = linearize_access_indexes(out_indexes, out.dim(), b);
+  const size_t numel = out.numel();
+  if (numel == 0) {
+    return;
+  }
+  BroadcastRunIterator<3> it(out, {&a, &b, &c});
+  const size_t run = it.run_size();
+  const ssize_t a_step = it.run_stride(0);
+  const ssize_t b_step = it.run_stride(1);
+  const ssize_t c_step = it.run_stride(2);
+  for (size_t start = 0; start < numel; start += run, it.next()) {
+    const CTYPE_A* const run_a = data_a + it.offset(0);
+    const CTYPE_B* const run_b = data_b + it.offset(1);
+    const CTYPE_C* const run_c = data_c + it.offset(2);
+    CTYPE_OUT* const run_out = data_out + start;
+    if (a_step == 1 && b_step == 1 && c_step == 1) {
+      for (size_t j = 0; j < run; ++j) {
+        run_out[j] = compute_fun(run_a[j], run_b[j], run_c[j]);
       }
-      if (c_is_broadcasted) {
-        c_linear_index = linearize_access_indexes(out_indexes, out.dim(), c);
+    } else {
+      for (size_t j = 0; j < run; ++j) {
+        run_out[j] = compute_fun(
+            run_a[j * a_step], run_b[j * b_step], run_c[j * c_step]);
       }
     }
-
-    data_out[i] = compute_fun(
-        data_a[a_linear_index], data_b[b_linear_index], data_c[c_linear_index]);
   }
 }
 
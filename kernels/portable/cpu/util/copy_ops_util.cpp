@@ -9,6 +9,7 @@
 #include <cstring>
 
 #include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 
 namespace torch {
 namespace executor {
@@ -17,6 +18,10 @@ using Tensor = exec_aten::Tensor;
 
 namespace {
 
+// memcpy moves about one 16-byte vector in the time of a multiply-add, the
+// unit of work that parallel_grain_size() expects.
+constexpr size_t kCopyBytesPerWork = 16;
+
 size_t as_strided_copy_compute_storage_nbytes(
     IntArrayRef sizes,
     IntArrayRef strides,
@@ -470,5 +475,39 @@ bool check_tril_args(const Tensor& in, Tensor& out) {
   return true;
 }
 
+void copy_blocks(
+    char* dst,
+    size_t dst_stride,
+    const char* src,
+    size_t src_stride,
+    size_t block_nbytes,
+    size_t nblocks) {
+  if (block_nbytes == 0 || nblocks == 0) {
+    return;
+  }
+  if (nblocks == 1 ||
+      (dst_stride == block_nbytes && src_stride == block_nbytes)) {
+    // One contiguous run; split it into byte ranges so that a single large
+    // block, e.g. a cat along dim 0, is still copied in parallel.
+    parallel_for(
+        0,
+        block_nbytes * nblocks,
+        kParallelWorkPerTask * kCopyBytesPerWork,
+        [&](int64_t begin, int64_t end) {
+          memcpy(dst + begin, src + begin, end - begin);
+        });
+    return;
+  }
+  parallel_for(
+      0,
+      nblocks,
+      parallel_grain_size(block_nbytes / kCopyBytesPerWork),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          memcpy(dst + i * dst_stride, src + i * src_stride, block_nbytes);
+        }
+      });
+}
+
 } // namespace executor
 } // namespace torch
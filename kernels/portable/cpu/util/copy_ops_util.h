@@ -123,5 +123,20 @@ void get_stack_out_target_size(
 
 bool check_tril_args(const Tensor& in, Tensor& out);
 
+/**
+ * Copies `nblocks` blocks of `block_nbytes` bytes each, where block `i`
+ * starts at `src + i * src_stride` and goes to `dst + i * dst_stride`. This is
+ * how the concatenation-like ops (cat, stack, split, unbind) move data when
+ * their input and output dtypes match, since each slice along the op's dim is
+ * then a contiguous run of bytes. The blocks are copied in parallel.
+ */
+void copy_blocks(
+    char* dst,
+    size_t dst_stride,
+    const char* src,
+    size_t src_stride,
+    size_t block_nbytes,
+    size_t nblocks);
+
 } // namespace executor
 } // namespace torch
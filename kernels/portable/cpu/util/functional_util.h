@@ -43,6 +43,10 @@ inline CTYPE apply_unary_reduce_fn(
 /**
  * Applies `map_fun` to `size` elements of `data_in`, writing results to
  * `data_out`. The `stride` can also be defined; by default it is set to 1.
+ *
+ * Each output element only depends on the input element at the same index,
+ * so `data_out` may be the same as `data_in`. Memory planning relies on this
+ * to run kernels built on this function in place.
  */
 template <typename CTYPE_IN, typename CTYPE_OUT, typename MapOp>
 inline void apply_unary_map_fn(
@@ -10,6 +10,7 @@
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <cstring>
 #include <tuple>
 
@@ -228,6 +229,45 @@ void apply_over_dim(
   }
 }
 
+/**
+ * Like apply_over_dim(fn, in, dim), but spreads the calls to `fn` over the
+ * threadpool when one is available (see parallel_for()). Each call to `fn`
+ * must only write to state that belongs to its own slice, e.g. the elements
+ * of an output with the same shape as `in` that the slice covers.
+ */
+template <typename Fn>
+void parallel_apply_over_dim(
+    const Fn& fn,
+    const Tensor& in,
+    const optional<int64_t>& dim) {
+  if (!dim.has_value() || in.dim() == 0) {
+    apply_over_dim(fn, in, dim);
+    return;
+  }
+  ET_CHECK_VALID_DIM(dim.value(), in.dim());
+
+  if (in.numel() == 0) {
+    return;
+  }
+
+  const size_t d = ET_NORMALIZE_IX(dim.value(), in.dim());
+
+  const size_t size = in.size(d);
+  const size_t stride = in.strides()[d];
+  const size_t outer_stride = size * stride;
+  const size_t num_slices = getLeadingDims(in, d) * stride;
+  parallel_for(
+      0,
+      num_slices,
+      parallel_grain_size(size),
+      [&fn, size, stride, outer_stride](int64_t begin, int64_t end) {
+        for (size_t slice = begin; slice < static_cast<size_t>(end); ++slice) {
+          const size_t base = (slice / stride) * outer_stride + slice % stride;
+          fn(size, stride, base);
+        }
+      });
+}
+
 /**
  * Useful to reduce a tensor `in` over a given dimension `dim` for the output
  * element at index `out_ix` using the reduce function `fn`, which
@@ -340,6 +380,57 @@ void apply_over_dim_list(
       fn, in, is_in_dim_list, base, ustart, uend);
 }
 
+/**
+ * Calls `fn(out_ix)` for every index of the output of reducing `in` over
+ * `dim`, spreading the calls over the threadpool when one is available (see
+ * parallel_for()). Each call must only write to the output element(s) at
+ * `out_ix`. Typical usage wraps one of the reduce functions below:
+ *
+ * parallel_for_each_reduce_over_dim_output_index(
+ *     in, dim, out, [&](const size_t out_ix) {
+ *       out_data[out_ix] = reduce_over_dim<CTYPE>(..., in, dim, out_ix);
+ *     });
+ */
+template <typename Fn>
+void parallel_for_each_reduce_over_dim_output_index(
+    const Tensor& in,
+    const optional<int64_t>& dim,
+    const Tensor& out,
+    const Fn& fn) {
+  const int64_t reduction_size = get_reduced_dim_product(in, dim);
+  parallel_for(
+      0,
+      out.numel(),
+      parallel_grain_size(reduction_size),
+      [&fn](int64_t begin, int64_t end) {
+        for (int64_t out_ix = begin; out_ix < end; ++out_ix) {
+          fn(out_ix);
+        }
+      });
+}
+
+/**
+ * Like parallel_for_each_reduce_over_dim_output_index(), for a reduction of
+ * `in` over the dimensions in `dim_list`.
+ */
+template <typename Fn>
+void parallel_for_each_reduce_over_dim_list_output_index(
+    const Tensor& in,
+    const optional<ArrayRef<int64_t>>& dim_list,
+    const Tensor& out,
+    const Fn& fn) {
+  const int64_t reduction_size = get_reduced_dim_product(in, dim_list);
+  parallel_for(
+      0,
+      out.numel(),
+      parallel_grain_size(reduction_size),
+      [&fn](int64_t begin, int64_t end) {
+        for (int64_t out_ix = begin; out_ix < end; ++out_ix) {
+          fn(out_ix);
+        }
+      });
+}
+
 //
 // Reduce Functions
 //
@@ -183,3 +183,130 @@ TEST(BroadcastUtilTest, LinearizeIndex) {
     EXPECT_EQ(linear_index, 2);
   }
 }
+
+namespace {
+
+// apply_binary_elementwise_fn() computed the slow way, an index at a time.
+Tensor reference_binary_add(
+    TensorFactory<ScalarType::Int>& tf,
+    const Tensor& a,
+    const Tensor& b,
+    const std::vector<int32_t>& out_sizes) {
+  Tensor out = tf.zeros(out_sizes);
+  for (size_t i = 0; i < out.numel(); ++i) {
+    size_t indexes[torch::executor::kTensorDimensionLimit];
+    delinearize_index(
+        i, out, indexes, torch::executor::kTensorDimensionLimit);
+    out.mutable_data_ptr<int32_t>()[i] =
+        a.const_data_ptr<int32_t>()[linearize_access_indexes(
+            indexes, out.dim(), a)] +
+        b.const_data_ptr<int32_t>()[linearize_access_indexes(
+            indexes, out.dim(), b)];
+  }
+  return out;
+}
+
+Tensor iota(TensorFactory<ScalarType::Int>& tf, std::vector<int32_t> sizes) {
+  Tensor t = tf.zeros(sizes);
+  for (size_t i = 0; i < t.numel(); ++i) {
+    t.mutable_data_ptr<int32_t>()[i] = static_cast<int32_t>(i);
+  }
+  return t;
+}
+
+} // namespace
+
+TEST(BroadcastUtilTest, BroadcastRunIteratorCoalescesDims) {
+  TensorFactory<ScalarType::Int> tf;
+
+  // No broadcasting: a single run over everything.
+  Tensor out = tf.zeros({2, 3, 4});
+  Tensor same = tf.zeros({2, 3, 4});
+  torch::executor::BroadcastRunIterator<2> plain(out, {&same, &same});
+  EXPECT_EQ(plain.run_size(), 24);
+  EXPECT_EQ(plain.run_stride(0), 1);
+
+  // A bias over the last dim: runs of the last dim, restarting the bias.
+  Tensor bias = tf.zeros({4});
+  torch::executor::BroadcastRunIterator<2> biased(out, {&same, &bias});
+  EXPECT_EQ(biased.run_size(), 4);
+  EXPECT_EQ(biased.run_stride(1), 1);
+  biased.next();
+  EXPECT_EQ(biased.offset(0), 4);
+  EXPECT_EQ(biased.offset(1), 0);
+
+  // A per-row scale: runs of the last dim over a single scale value.
+  Tensor scale = tf.zeros({2, 3, 1});
+  torch::executor::BroadcastRunIterator<2> scaled(out, {&same, &scale});
+  EXPECT_EQ(scaled.run_size(), 4);
+  EXPECT_EQ(scaled.run_stride(1), 0);
+  scaled.next();
+  scaled.next();
+  EXPECT_EQ(scaled.offset(0), 8);
+  EXPECT_EQ(scaled.offset(1), 2);
+}
+
+TEST(BroadcastUtilTest, ApplyBinaryElementwiseFnBroadcasts) {
+  TensorFactory<ScalarType::Int> tf;
+  const std::vector<std::vector<std::vector<int32_t>>> cases = {
+      {{2, 3, 4}, {2, 3, 4}, {2, 3, 4}},
+      {{2, 3, 4}, {4}, {2, 3, 4}},
+      {{2, 3, 4}, {2, 3, 1}, {2, 3, 4}},
+      {{2, 3, 4}, {1, 3, 1}, {2, 3, 4}},
+      {{2, 1, 4}, {3, 1}, {2, 3, 4}},
+      {{1}, {2, 3}, {2, 3}},
+      {{}, {5}, {5}},
+      {{2, 1, 3, 1}, {1, 4, 1, 5}, {2, 4, 3, 5}},
+  };
+  for (const auto& c : cases) {
+    Tensor a = iota(tf, c[0]);
+    Tensor b = iota(tf, c[1]);
+    Tensor out = tf.zeros(c[2]);
+    torch::executor::apply_binary_elementwise_fn<int32_t, int32_t, int32_t>(
+        [](int32_t x, int32_t y) { return x + y; }, a, b, out);
+    EXPECT_TENSOR_EQ(out, reference_binary_add(tf, a, b, c[2]));
+  }
+}
+
+TEST(BroadcastUtilTest, ApplyBinaryElementwiseFnInPlace) {
+  TensorFactory<ScalarType::Int> tf;
+  // The first input has the output's sizes, so the output can share its data.
+  const std::vector<std::vector<std::vector<int32_t>>> cases = {
+      {{2, 3, 4}, {2, 3, 4}},
+      {{2, 3, 4}, {4}},
+      {{2, 3, 4}, {2, 1, 4}},
+      {{2, 3, 4}, {1}},
+  };
+  for (const auto& c : cases) {
+    Tensor a = iota(tf, c[0]);
+    Tensor b = iota(tf, c[1]);
+    Tensor expected = reference_binary_add(tf, a, b, c[0]);
+    torch::executor::apply_binary_elementwise_fn<int32_t, int32_t, int32_t>(
+        [](int32_t x, int32_t y) { return x + y; }, a, b, a);
+    EXPECT_TENSOR_EQ(a, expected);
+  }
+}
+
+TEST(BroadcastUtilTest, ApplyTernaryElementwiseFnBroadcasts) {
+  TensorFactory<ScalarType::Int> tf;
+  Tensor a = iota(tf, {2, 1, 4});
+  Tensor b = iota(tf, {3, 1});
+  Tensor c = iota(tf, {4});
+  Tensor out = tf.zeros({2, 3, 4});
+  torch::executor::
+      apply_ternary_elementwise_fn<int32_t, int32_t, int32_t, int32_t>(
+          [](int32_t x, int32_t y, int32_t z) { return x * 100 + y * 10 + z; },
+          a,
+          b,
+          c,
+          out);
+  for (int32_t i = 0; i < 2; ++i) {
+    for (int32_t j = 0; j < 3; ++j) {
+      for (int32_t k = 0; k < 4; ++k) {
+        EXPECT_EQ(
+            out.const_data_ptr<int32_t>()[(i * 3 + j) * 4 + k],
+            (i * 4 + k) * 100 + j * 10 + k);
+      }
+    }
+  }
+}
@@ -62,6 +62,13 @@ inline void vec_scalef(
   }
 }
 
+/// The type that sums of T are accumulated in. Half-precision types such as
+/// Half and BFloat16, which are not builtin arithmetic types, accumulate in
+/// float so that long reductions do not lose precision.
+template <typename T>
+using vec_acc_t =
+    typename std::conditional<std::is_arithmetic<T>::value, T, float>::type;
+
 /// x: m * n, y: n * p, z: m * p.
 /// z[i][j] = sum(x[i][k] * y[k][j])
 template <typename T, typename U = T>
@@ -72,13 +79,15 @@ inline void vec_matmul(
     int64_t m,
     int64_t n,
     int64_t p) {
+  using acc_t = vec_acc_t<T>;
   for (size_t i = 0; i < m; ++i) {
     for (size_t j = 0; j < p; ++j) {
-      T sum = 0;
+      acc_t sum = 0;
       for (size_t k = 0; k < n; ++k) {
-        sum += x[i * n + k] * y[k * p + j];
+        sum += static_cast<acc_t>(x[i * n + k]) *
+            static_cast<acc_t>(y[k * p + j]);
       }
-      z[i * p + j] = sum;
+      z[i * p + j] = static_cast<T>(sum);
     }
   }
 }
@@ -97,13 +106,16 @@ inline void vec_addmm(
     int64_t p,
     U beta,
     U alpha) {
+  using acc_t = vec_acc_t<T>;
   for (size_t i = 0; i < m; ++i) {
     for (size_t j = 0; j < p; ++j) {
-      T sum = 0;
+      acc_t sum = 0;
       for (size_t k = 0; k < n; ++k) {
-        sum += mat1_data[i * n + k] * mat2_data[k * p + j];
+        sum += static_cast<acc_t>(mat1_data[i * n + k]) *
+            static_cast<acc_t>(mat2_data[k * p + j]);
       }
-      out_data[i * p + j] = sum * alpha + self_data[i * p + j] * beta;
+      out_data[i * p + j] = static_cast<T>(
+          sum * alpha + static_cast<acc_t>(self_data[i * p + j]) * beta);
     }
   }
 }
@@ -120,7 +132,8 @@ template <typename T>
 inline float vec_powerf(const T* x, size_t size) {
   float sum = 0;
   for (size_t i = 0; i < size; ++i) {
-    sum += x[i] * x[i];
+    const vec_acc_t<T> xi = x[i];
+    sum += xi * xi;
   }
   return sum;
 }
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::optional;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::_to_dim_order_copy_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+class OpToDimOrderCopyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+
+  Tensor& op__to_dim_order_copy_out(
+      const Tensor& self,
+      optional<ArrayRef<int64_t>> dim_order,
+      Tensor& out) {
+    return _to_dim_order_copy_out(
+        context_, self, /*non_blocking=*/false, dim_order, out);
+  }
+
+  RuntimeContext context_{};
+};
+
+const std::vector<int64_t> kChannelsLast = {0, 2, 3, 1};
+
+} // namespace
+
+TEST_F(OpToDimOrderCopyTest, ContiguousToChannelsLast) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor self = tf.make({1, 2, 2, 3}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+  Tensor out = tf.full_channels_last({1, 2, 2, 3}, 0);
+
+  op__to_dim_order_copy_out(
+      self, ArrayRef<int64_t>(kChannelsLast.data(), kChannelsLast.size()), out);
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make_channels_last(
+          {1, 2, 2, 3}, {0, 6, 1, 7, 2, 8, 3, 9, 4, 10, 5, 11}));
+}
+
+TEST_F(OpToDimOrderCopyTest, ChannelsLastToContiguous) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor self = tf.make_channels_last(
+      {1, 2, 2, 3}, {0, 6, 1, 7, 2, 8, 3, 9, 4, 10, 5, 11});
+  Tensor out = tf.zeros({1, 2, 2, 3});
+
+  op__to_dim_order_copy_out(self, {}, out);
+  EXPECT_TENSOR_EQ(
+      out, tf.make({1, 2, 2, 3}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+}
+
+TEST_F(OpToDimOrderCopyTest, ConvertsDtype) {
+  TensorFactory<ScalarType::Int> tf_int;
+  TensorFactory<ScalarType::Float> tf_float;
+  Tensor self = tf_int.make({2, 2}, {1, 2, 3, 4});
+  Tensor out = tf_float.zeros({2, 2});
+
+  op__to_dim_order_copy_out(self, {}, out);
+  EXPECT_TENSOR_EQ(out, tf_float.make({2, 2}, {1, 2, 3, 4}));
+}
+
+TEST_F(OpToDimOrderCopyTest, RejectsMismatchedDimOrder) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor self = tf.ones({1, 2, 2, 3});
+  // The dim order of out is contiguous, not channels last
+  Tensor out = tf.zeros({1, 2, 2, 3});
+
+  ET_EXPECT_KERNEL_FAILURE(op__to_dim_order_copy_out(
+      self,
+      ArrayRef<int64_t>(kChannelsLast.data(), kChannelsLast.size()),
+      out));
+}
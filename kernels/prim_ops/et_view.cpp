@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/prim_ops/et_view.h>
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/platform/assert.h>
+
+using exec_aten::Tensor;
+
+namespace torch {
+namespace executor {
+namespace function {
+
+// executorch_prim::et_view.default(Tensor self, int[] size) -> Tensor
+//
+// Replaces view-like copy ops such as view_copy and squeeze_copy; see
+// exir/passes/replace_view_copy_with_view_pass.py. The output aliases the
+// storage of `self`, so nothing is copied. Memory planning usually places out
+// at the same offset as self already, in which case this only checks that the
+// sizes agree; otherwise, e.g. when self is a graph input whose buffer the
+// caller provides, out is pointed at self's data on every call.
+void et_view(RuntimeContext& context, EValue** stack) {
+  (void)context;
+
+  auto self = (*stack[0]).toTensor();
+  auto size = (*stack[1]).toIntList();
+  auto out = (*stack[2]).toTensor();
+
+  ET_CHECK_MSG(
+      self.scalar_type() == out.scalar_type(),
+      "self and out must have the same dtype");
+  ET_CHECK_MSG(
+      size.size() == static_cast<size_t>(out.dim()),
+      "size has %zu dims, but out has %zd",
+      size.size(),
+      ssize_t(out.dim()));
+  for (size_t i = 0; i < size.size(); ++i) {
+    ET_CHECK_MSG(
+        size[i] == out.size(i),
+        "size[%zu] = %" PRId64 " does not match out.size(%zu) = %zd",
+        i,
+        size[i],
+        i,
+        ssize_t(out.size(i)));
+  }
+  ET_CHECK_MSG(
+      self.numel() == out.numel(),
+      "self has %zd elements, but out has %zd",
+      ssize_t(self.numel()),
+      ssize_t(out.numel()));
+
+  if (out.const_data_ptr() != self.const_data_ptr()) {
+    ET_CHECK_MSG(
+        internal::set_tensor_data(out, self.mutable_data_ptr(), self.nbytes()) ==
+            Error::Ok,
+        "Failed to point out at the data of self");
+  }
+}
+
+} // namespace function
+} // namespace executor
+} // namespace torch
@@ -7,12 +7,14 @@
  */
 
 #include <executorch/kernels/prim_ops/et_copy_index.h>
+#include <executorch/kernels/prim_ops/et_view.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/kernel/operator_registry.h>
 
 using KernelArrayRef = ::torch::executor::ArrayRef<::torch::executor::Kernel>;
 using torch::executor::function::et_copy_index;
+using torch::executor::function::et_view;
 
 namespace torch {
 namespace executor {
@@ -125,11 +127,15 @@ static Kernel prim_ops[] = {
     Kernel(
         "executorch_prim::floordiv.Scalar",
         [](RuntimeContext& context, EValue** stack) {
-          (void)context;
           EValue& a = *stack[0];
           EValue& b = *stack[1];
           EValue& out = *stack[2];
           if (a.isInt() && b.isInt()) {
+            if (b.toInt() == 0) {
+              ET_LOG(Error, "Integer division by zero in floordiv");
+              context.fail(Error::InvalidArgument);
+              return;
+            }
             const int64_t quot = a.toInt() / b.toInt();
             if (std::signbit(a.toInt()) == std::signbit(b.toInt())) {
               out = EValue(quot);
@@ -224,6 +230,9 @@ static Kernel prim_ops[] = {
     // executorch_prim::et_copy_index.tensor(tensor, tensor) -> tensor
     Kernel("executorch_prim::et_copy_index.tensor", &et_copy_index),
 
+    // executorch_prim::et_view.default(Tensor, int[]) -> Tensor
+    Kernel("executorch_prim::et_view.default", &et_view),
+
 };
 
 static KernelArrayRef kernel_array_ref(
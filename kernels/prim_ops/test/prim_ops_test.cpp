@@ -111,6 +111,26 @@ TEST_F(RegisterPrimOpsTest, TestAlgebraOps) {
   EXPECT_FLOAT_EQ(stack[2]->toDouble(), 0.75);
 }
 
+TEST_F(RegisterPrimOpsTest, TestFloorDivRoundsTowardNegativeInfinity) {
+  EValue values[3] = {EValue(int64_t(-7)), EValue(int64_t(2)), EValue()};
+  EValue* stack[3] = {&values[0], &values[1], &values[2]};
+
+  getOpsFn("executorch_prim::floordiv.Scalar")(context, stack);
+  EXPECT_EQ(stack[2]->toInt(), -4);
+
+  values[1] = EValue(int64_t(-2));
+  getOpsFn("executorch_prim::floordiv.Scalar")(context, stack);
+  EXPECT_EQ(stack[2]->toInt(), 3);
+}
+
+TEST_F(RegisterPrimOpsTest, TestFloorDivByZeroFails) {
+  EValue values[3] = {EValue(int64_t(7)), EValue(int64_t(0)), EValue()};
+  EValue* stack[3] = {&values[0], &values[1], &values[2]};
+
+  getOpsFn("executorch_prim::floordiv.Scalar")(context, stack);
+  EXPECT_EQ(context.failure_state(), Error::InvalidArgument);
+}
+
 TEST_F(RegisterPrimOpsTest, TestETCopyIndex) {
   EXPECT_TRUE(hasOpsFn("executorch_prim::et_copy_index.tensor"));
 
@@ -221,6 +241,51 @@ TEST_F(RegisterPrimOpsTest, TestETCopyIndexStaticShape) {
 #endif
 }
 
+TEST_F(RegisterPrimOpsTest, TestETView) {
+  EXPECT_TRUE(hasOpsFn("executorch_prim::et_view.default"));
+
+  testing::TensorFactory<ScalarType::Int> tf;
+
+  auto self = tf.make({2, 3}, {1, 2, 3, 4, 5, 6});
+  // Not memory planned: et_view points it at the data of self.
+  auto out = tf.zeros({3, 2});
+  internal::reset_data_ptr(out);
+
+  EValue size_values[2] = {EValue(int64_t(3)), EValue(int64_t(2))};
+  EValue* size_wrapped[2] = {&size_values[0], &size_values[1]};
+  int64_t size_unwrapped[2] = {0, 0};
+  BoxedEvalueList<int64_t> size(size_wrapped, size_unwrapped, 2);
+
+  EValue values[3] = {EValue(self), EValue(size), EValue(out)};
+  EValue* stack[3] = {&values[0], &values[1], &values[2]};
+
+  getOpsFn("executorch_prim::et_view.default")(context, stack);
+  EXPECT_EQ(out.const_data_ptr(), self.const_data_ptr());
+  EXPECT_TENSOR_EQ(out, tf.make({3, 2}, {1, 2, 3, 4, 5, 6}));
+
+  // A later call with an already aliased output is a no-op.
+  getOpsFn("executorch_prim::et_view.default")(context, stack);
+  EXPECT_EQ(out.const_data_ptr(), self.const_data_ptr());
+}
+
+TEST_F(RegisterPrimOpsTest, TestETViewMismatchedSizeDies) {
+  testing::TensorFactory<ScalarType::Int> tf;
+
+  auto self = tf.ones({2, 3});
+  auto out = tf.zeros({3, 2});
+
+  EValue size_values[2] = {EValue(int64_t(2)), EValue(int64_t(3))};
+  EValue* size_wrapped[2] = {&size_values[0], &size_values[1]};
+  int64_t size_unwrapped[2] = {0, 0};
+  BoxedEvalueList<int64_t> size(size_wrapped, size_unwrapped, 2);
+
+  EValue values[3] = {EValue(self), EValue(size), EValue(out)};
+  EValue* stack[3] = {&values[0], &values[1], &values[2]};
+
+  ET_EXPECT_DEATH(
+      getOpsFn("executorch_prim::et_view.default")(context, stack), "");
+}
+
 TEST_F(RegisterPrimOpsTest, TestBooleanOps) {
   EValue values[3];
   double a = 3;
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+template <typename T>
+using optional = exec_aten::optional<T>;
+
+namespace {
+
+// Returns the value of a 2-element argument at dim, or its single value.
+int64_t param_at(IntArrayRef param, size_t dim) {
+  return param.size() == 1 ? param[0] : param[dim];
+}
+
+// The output size of a pooling window along one dim, as computed by ATen.
+int64_t pooled_size(
+    int64_t in_size,
+    int64_t kernel_size,
+    int64_t stride,
+    int64_t padding,
+    bool ceil_mode) {
+  int64_t out_size =
+      (in_size + 2 * padding - kernel_size + (ceil_mode ? stride - 1 : 0)) /
+          stride +
+      1;
+  // The last window must start inside the input or its left padding
+  if (ceil_mode && (out_size - 1) * stride >= in_size + padding) {
+    --out_size;
+  }
+  return out_size;
+}
+
+struct PoolGeometry {
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t padding_h;
+  int64_t padding_w;
+};
+
+/**
+ * Averages the windows of one input plane. The sum of each window, less the
+ * zero point, is exact in int32, and is scaled to the output once.
+ */
+template <typename CTYPE>
+void quantized_avg_pool2d_plane(
+    const CTYPE* in,
+    int32_t in_zero_point,
+    float in_scale,
+    bool count_include_pad,
+    int64_t divisor_override,
+    float out_inv_scale,
+    int32_t out_zero_point,
+    int32_t out_quant_min,
+    int32_t out_quant_max,
+    const PoolGeometry& g,
+    CTYPE* out) {
+  for (int64_t oh = 0; oh < g.out_h; ++oh) {
+    int64_t h0 = oh * g.stride_h - g.padding_h;
+    int64_t h1 = std::min(h0 + g.kernel_h, g.in_h + g.padding_h);
+    const int64_t padded_h = h1 - h0;
+    h0 = std::max<int64_t>(h0, 0);
+    h1 = std::min(h1, g.in_h);
+    for (int64_t ow = 0; ow < g.out_w; ++ow) {
+      int64_t w0 = ow * g.stride_w - g.padding_w;
+      int64_t w1 = std::min(w0 + g.kernel_w, g.in_w + g.padding_w);
+      const int64_t padded_w = w1 - w0;
+      w0 = std::max<int64_t>(w0, 0);
+      w1 = std::min(w1, g.in_w);
+
+      int32_t sum = 0;
+      for (int64_t ih = h0; ih < h1; ++ih) {
+        const CTYPE* row = in + ih * g.in_w;
+        for (int64_t iw = w0; iw < w1; ++iw) {
+          sum += static_cast<int32_t>(row[iw]) - in_zero_point;
+        }
+      }
+      int64_t divisor = divisor_override;
+      if (divisor == 0) {
+        divisor = count_include_pad ? padded_h * padded_w
+                                    : (h1 - h0) * (w1 - w0);
+      }
+      const float value = divisor > 0
+          ? static_cast<float>(sum) * in_scale / static_cast<float>(divisor)
+          : 0.0f;
+      out[oh * g.out_w + ow] = internal::quantize_float<CTYPE>(
+          value, out_inv_scale, out_zero_point, out_quant_min, out_quant_max);
+    }
+  }
+}
+
+} // namespace
+
+/**
+ * Quantized 2D average pooling, out = quantize(avg_pool2d(dequantize(input),
+ * ...)), with per-tensor quantization of the input and output, and the
+ * arguments and semantics of aten::avg_pool2d. Window sums are accumulated in
+ * int32 and requantized directly.
+ *
+ * input is a contiguous [N, C, H, W] or [C, H, W], and out has the same dtype,
+ * either uint8 or int8.
+ */
+Tensor& quantized_avg_pool2d_out(
+    const Tensor& in,
+    double in_scale,
+    int64_t in_zero_point,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    optional<int64_t> divisor_override,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  ET_CHECK_MSG(
+      (in.scalar_type() == ScalarType::Byte ||
+       in.scalar_type() == ScalarType::Char) &&
+          in.scalar_type() == out.scalar_type(),
+      "input and out must both be Byte or Char");
+  ET_CHECK_MSG(
+      in.dim() == 3 || in.dim() == 4,
+      "input must be 3-D or 4-D, got %zd-D",
+      ssize_t(in.dim()));
+  ET_CHECK_MSG(
+      is_default_dim_order(in.dim_order().data(), in.dim()) &&
+          is_default_dim_order(out.dim_order().data(), out.dim()),
+      "input and out must be contiguous");
+  ET_CHECK_MSG(
+      kernel_size.size() == 1 || kernel_size.size() == 2,
+      "kernel_size must have 1 or 2 values");
+  ET_CHECK_MSG(
+      stride.size() <= 2 && padding.size() >= 1 && padding.size() <= 2,
+      "stride must have at most 2 values, and padding 1 or 2");
+  ET_CHECK_MSG(
+      !divisor_override.has_value() || divisor_override.value() != 0,
+      "divisor must be not zero");
+  ET_CHECK_MSG(
+      in_zero_point >= -128 && in_zero_point <= 255,
+      "zero point %" PRId64 " is out of the 8-bit range",
+      in_zero_point);
+  ET_CHECK_MSG(
+      out_quant_min <= out_quant_max &&
+          out_quant_min >=
+              (out.scalar_type() == ScalarType::Byte ? 0 : INT8_MIN) &&
+          out_quant_max <=
+              (out.scalar_type() == ScalarType::Byte ? UINT8_MAX : INT8_MAX),
+      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for the output dtype",
+      out_quant_min,
+      out_quant_max);
+
+  PoolGeometry g;
+  g.in_h = in.size(in.dim() - 2);
+  g.in_w = in.size(in.dim() - 1);
+  g.kernel_h = param_at(kernel_size, 0);
+  g.kernel_w = param_at(kernel_size, 1);
+  // An empty stride defaults to the kernel size
+  g.stride_h = stride.empty() ? g.kernel_h : param_at(stride, 0);
+  g.stride_w = stride.empty() ? g.kernel_w : param_at(stride, 1);
+  g.padding_h = param_at(padding, 0);
+  g.padding_w = param_at(padding, 1);
+  ET_CHECK_MSG(
+      g.kernel_h > 0 && g.kernel_w > 0 && g.stride_h > 0 && g.stride_w > 0,
+      "kernel_size and stride must be positive");
+  ET_CHECK_MSG(
+      g.padding_h >= 0 && g.padding_w >= 0 && 2 * g.padding_h <= g.kernel_h &&
+          2 * g.padding_w <= g.kernel_w,
+      "padding must be non-negative and at most half the kernel size");
+  g.out_h =
+      pooled_size(g.in_h, g.kernel_h, g.stride_h, g.padding_h, ceil_mode);
+  g.out_w =
+      pooled_size(g.in_w, g.kernel_w, g.stride_w, g.padding_w, ceil_mode);
+  ET_CHECK_MSG(
+      g.out_h > 0 && g.out_w > 0, "The kernel is larger than the input");
+
+  Tensor::SizesType out_sizes[4];
+  for (size_t i = 0; i < in.dim() - 2; ++i) {
+    out_sizes[i] = in.size(i);
+  }
+  out_sizes[in.dim() - 2] = static_cast<Tensor::SizesType>(g.out_h);
+  out_sizes[in.dim() - 1] = static_cast<Tensor::SizesType>(g.out_w);
+  torch::executor::Error err =
+      resize_tensor(out, {out_sizes, static_cast<size_t>(in.dim())});
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in quantized_avg_pool2d_out");
+
+  const int64_t planes = getLeadingDims(in, in.dim() - 2);
+  const int64_t in_plane = g.in_h * g.in_w;
+  const int64_t out_plane = g.out_h * g.out_w;
+  const float out_inv_scale = 1.0f / static_cast<float>(out_scale);
+
+  ET_SWITCH_TWO_TYPES(
+      Byte, Char, in.scalar_type(), nullptr, __func__, CTYPE, [&] {
+        const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+        parallel_for(
+            0,
+            planes,
+            parallel_grain_size(out_plane * g.kernel_h * g.kernel_w),
+            [&](int64_t begin, int64_t end) {
+              for (int64_t i = begin; i < end; ++i) {
+                quantized_avg_pool2d_plane<CTYPE>(
+                    in_data + i * in_plane,
+                    static_cast<int32_t>(in_zero_point),
+                    static_cast<float>(in_scale),
+                    count_include_pad,
+                    divisor_override.has_value() ? divisor_override.value() : 0,
+                    out_inv_scale,
+                    static_cast<int32_t>(out_zero_point),
+                    static_cast<int32_t>(out_quant_min),
+                    static_cast<int32_t>(out_quant_max),
+                    g,
+                    out_data + i * out_plane);
+              }
+            });
+      });
+
+  return out;
+}
+
+Tensor& quantized_avg_pool2d_out(
+    RuntimeContext& context,
+    const Tensor& in,
+    double in_scale,
+    int64_t in_zero_point,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    optional<int64_t> divisor_override,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  (void)context;
+  return quantized_avg_pool2d_out(
+      in,
+      in_scale,
+      in_zero_point,
+      kernel_size,
+      stride,
+      padding,
+      ceil_mode,
+      count_include_pad,
+      divisor_override,
+      out_scale,
+      out_zero_point,
+      out_quant_min,
+      out_quant_max,
+      out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -6,7 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <executorch/kernels/portable/cpu/vec_ops.h>
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
 #include <cinttypes>
@@ -25,8 +25,6 @@ using ScalarType = exec_aten::ScalarType;
 
 namespace {
 
-constexpr float SMALL_SCALE_THRESHOLD = 6.1e-5f;
-
 /**
  * Asserts that the parameters are valid.
  */
@@ -72,80 +70,21 @@ void choose_qparams(
     int32_t qmax,
     Tensor& scale_out,
     Tensor& zero_point_out) {
-  const float* x_fp32 = input.data_ptr<float>();
+  const float* x_fp32 = input.const_data_ptr<float>();
   // Compute x_min, x_max and q_params (scale, zero_point)
-  float min = torch::executor::vec_minf(x_fp32, input.numel());
-  float max = torch::executor::vec_maxf(x_fp32, input.numel());
-
-  // We extend the [min, max] interval to ensure that it contains 0.
-  // Otherwise, we would not meet the requirement that 0 be an exactly
-  // representable value.
-  min = std::min(min, 0.f);
-  max = std::max(max, 0.f);
-
-  // Use double precision for intermediate computation but use single precision
-  // in final number to reflect the actual number used during quantization.
-  double scale = (static_cast<double>(max) - min) / (qmax - qmin);
-  // If scale is 0 or too small so its reciprocal is infinity, we arbitrary
-  // adjust the scale to 0.1 . We want to avoid scale's reciprocal being
-  // infinity because some of fbgemm code pre-computes scale's reciprocal to do
-  // multiplication instead of division in the time critical part of code.
-  if (float(scale) == 0.0f || std::isinf(1.0f / float(scale))) {
-    scale = 0.1;
+  float min = 0.0f;
+  float max = 0.0f;
+  if (input.numel() > 0) {
+    internal::float_range(x_fp32, input.numel(), &min, &max);
   }
-  ET_CHECK_MSG(scale > 0, "quantization scale should be > 0");
 
-  // Cut off small scale
-  if (scale < SMALL_SCALE_THRESHOLD) {
-    float org_scale = scale;
-    scale = SMALL_SCALE_THRESHOLD;
-    // Adjust the min and max based on the new scale
-    if (min == 0.0f) {
-      max = SMALL_SCALE_THRESHOLD * (qmax - qmin);
-    } else if (max == 0.0f) {
-      min = -SMALL_SCALE_THRESHOLD * (qmax - qmin);
-    } else {
-      float amplifier = SMALL_SCALE_THRESHOLD / org_scale;
-      min *= amplifier;
-      max *= amplifier;
-    }
-  }
-
-  // Zero-point computation.
-  // First the initial floating-point computation. The zero-point can be
-  // determined from solving an affine equation for any known pair
-  // (real value, corresponding quantized value).
-  // We know two such pairs: (rmin, qmin) and (rmax, qmax).
-  // The arithmetic error on the zero point computed from either pair
-  // will be roughly machine_epsilon * (sum of absolute values of terms)
-  // so we want to use the variant that adds the smaller terms.
-  double zero_point_from_min = qmin - min / static_cast<double>(scale);
-  double zero_point_from_max = qmax - max / static_cast<double>(scale);
-  double zero_point_from_min_error =
-      std::abs(qmin) - std::abs(min / static_cast<double>(scale));
-  double zero_point_from_max_error =
-      std::abs(qmax) - std::abs(max / static_cast<double>(scale));
-  double initial_zero_point =
-      zero_point_from_min_error < zero_point_from_max_error
-      ? zero_point_from_min
-      : zero_point_from_max;
-
-  // Now we need to nudge the zero point to be an integer
-  // (our zero points are integer, and this is motivated by the requirement
-  // to be able to represent the real value "0" exactly as a quantized value,
-  // which is required in multiple places, for example in Im2col with zero
-  // padding).
-  int32_t nudged_zero_point = 0;
-  if (initial_zero_point < qmin) {
-    nudged_zero_point = qmin;
-  } else if (initial_zero_point > qmax) {
-    nudged_zero_point = qmax;
-  } else {
-    nudged_zero_point = nearbyint(static_cast<float>(initial_zero_point));
-  }
+  double scale = 0;
+  int32_t zero_point = 0;
+  internal::choose_qparams(min, max, qmin, qmax, &scale, &zero_point);
+  ET_CHECK_MSG(scale > 0, "quantization scale should be > 0");
 
-  scale_out.data_ptr<double>()[0] = scale;
-  zero_point_out.data_ptr<int64_t>()[0] = nudged_zero_point;
+  scale_out.mutable_data_ptr<double>()[0] = scale;
+  zero_point_out.mutable_data_ptr<int64_t>()[0] = zero_point;
 }
 } // namespace
 
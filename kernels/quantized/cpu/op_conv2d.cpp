@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+template <typename T>
+using optional = exec_aten::optional<T>;
+
+namespace {
+
+// Output columns whose int32 accumulators stay in registers or L1 while the
+// input rows under them are read.
+constexpr int64_t kColumnsPerTile = 64;
+
+bool is_8bit(ScalarType dtype) {
+  return dtype == ScalarType::Byte || dtype == ScalarType::Char;
+}
+
+// Returns the value of a 2-element argument at dim, or its single value.
+int64_t param_at(IntArrayRef param, size_t dim) {
+  return param.size() == 1 ? param[0] : param[dim];
+}
+
+void check_quantized_conv2d_args(
+    const Tensor& in,
+    int64_t in_zero_point,
+    const Tensor& weight,
+    int64_t weight_zero_point,
+    const optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    const Tensor& out) {
+  ET_CHECK_MSG(
+      is_8bit(in.scalar_type()) && is_8bit(weight.scalar_type()) &&
+          is_8bit(out.scalar_type()),
+      "input, weight and out must be Byte or Char");
+  ET_CHECK_MSG(
+      in.dim() == 4 && weight.dim() == 4,
+      "input and weight must be 4-D, got %zd-D and %zd-D",
+      ssize_t(in.dim()),
+      ssize_t(weight.dim()));
+  ET_CHECK_MSG(
+      is_default_dim_order(in.dim_order().data(), in.dim()) &&
+          is_default_dim_order(weight.dim_order().data(), weight.dim()) &&
+          is_default_dim_order(out.dim_order().data(), out.dim()),
+      "input, weight and out must be contiguous");
+  for (IntArrayRef param : {stride, padding, dilation}) {
+    ET_CHECK_MSG(
+        param.size() == 1 || param.size() == 2,
+        "stride, padding and dilation must have 1 or 2 values");
+  }
+  for (size_t dim = 0; dim < 2; ++dim) {
+    ET_CHECK_MSG(
+        param_at(stride, dim) > 0 && param_at(dilation, dim) > 0 &&
+            param_at(padding, dim) >= 0,
+        "invalid stride, padding or dilation");
+  }
+  ET_CHECK_MSG(
+      groups > 0 && in.size(1) % groups == 0 && weight.size(0) % groups == 0,
+      "groups %" PRId64 " must divide the input and output channels",
+      groups);
+  ET_CHECK_MSG(
+      in.size(1) == weight.size(1) * groups,
+      "input has %zd channels but weight expects %zd",
+      ssize_t(in.size(1)),
+      ssize_t(weight.size(1) * groups));
+  if (bias.has_value()) {
+    ET_CHECK_MSG(
+        bias.value().scalar_type() == ScalarType::Float,
+        "bias.scalar_type() %" PRId8 " is not Float",
+        static_cast<int8_t>(bias.value().scalar_type()));
+    ET_CHECK_MSG(
+        bias.value().numel() == weight.size(0),
+        "Expected bias to have %zd elements received: %zd",
+        ssize_t(weight.size(0)),
+        ssize_t(bias.value().numel()));
+  }
+  ET_CHECK_MSG(
+      in_zero_point >= -128 && in_zero_point <= 255 &&
+          weight_zero_point >= -128 && weight_zero_point <= 255,
+      "zero points %" PRId64 " and %" PRId64 " are out of the 8-bit range",
+      in_zero_point,
+      weight_zero_point);
+  ET_CHECK_MSG(
+      out_quant_min <= out_quant_max &&
+          out_quant_min >=
+              (out.scalar_type() == ScalarType::Byte ? 0 : INT8_MIN) &&
+          out_quant_max <=
+              (out.scalar_type() == ScalarType::Byte ? UINT8_MAX : INT8_MAX),
+      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for the output dtype",
+      out_quant_min,
+      out_quant_max);
+}
+
+struct ConvGeometry {
+  int64_t in_channels_per_group;
+  int64_t out_channels_per_group;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t padding_h;
+  int64_t padding_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+};
+
+// Returns the first of the output columns [begin, end) whose input column
+// ow * stride + offset is >= 0, and the end of those whose input column is
+// < width.
+void valid_columns(
+    int64_t offset,
+    int64_t stride,
+    int64_t width,
+    int64_t begin,
+    int64_t end,
+    int64_t* valid_begin,
+    int64_t* valid_end) {
+  const int64_t lo = offset >= 0 ? 0 : (-offset + stride - 1) / stride;
+  const int64_t hi =
+      width - offset > 0 ? (width - offset + stride - 1) / stride : 0;
+  *valid_begin = std::max(begin, lo);
+  *valid_end = std::max(*valid_begin, std::min(end, hi));
+}
+
+/**
+ * Computes the output plane of channel oc for one batch element. Each weight
+ * value, less its zero point, is multiplied into a tile of output columns at
+ * once, which reads the input row under them with a fixed stride, and
+ * accumulates in int32. Padding contributes nothing, since it dequantizes to
+ * zero.
+ */
+template <typename IN_T, typename WEIGHT_T, typename OUT_T>
+void quantized_conv2d_plane(
+    const IN_T* in,
+    int32_t in_zero_point,
+    const WEIGHT_T* weight,
+    int32_t weight_zero_point,
+    float bias,
+    float acc_scale,
+    float out_inv_scale,
+    int32_t out_zero_point,
+    int32_t out_quant_min,
+    int32_t out_quant_max,
+    const ConvGeometry& g,
+    OUT_T* out) {
+  int32_t acc[kColumnsPerTile];
+  for (int64_t oh = 0; oh < g.out_h; ++oh) {
+    for (int64_t ow0 = 0; ow0 < g.out_w; ow0 += kColumnsPerTile) {
+      const int64_t ow1 = std::min(g.out_w, ow0 + kColumnsPerTile);
+      std::fill(acc, acc + (ow1 - ow0), 0);
+      for (int64_t ic = 0; ic < g.in_channels_per_group; ++ic) {
+        for (int64_t kh = 0; kh < g.kernel_h; ++kh) {
+          const int64_t ih = oh * g.stride_h - g.padding_h + kh * g.dilation_h;
+          if (ih < 0 || ih >= g.in_h) {
+            continue;
+          }
+          const IN_T* in_row = in + (ic * g.in_h + ih) * g.in_w;
+          const WEIGHT_T* weight_row =
+              weight + (ic * g.kernel_h + kh) * g.kernel_w;
+          for (int64_t kw = 0; kw < g.kernel_w; ++kw) {
+            const int32_t w =
+                static_cast<int32_t>(weight_row[kw]) - weight_zero_point;
+            if (w == 0) {
+              continue;
+            }
+            const int64_t offset = kw * g.dilation_w - g.padding_w;
+            int64_t begin;
+            int64_t end;
+            valid_columns(
+                offset, g.stride_w, g.in_w, ow0, ow1, &begin, &end);
+            if (begin == end) {
+              continue;
+            }
+            const IN_T* x = in_row + begin * g.stride_w + offset;
+            for (int64_t ow = begin; ow < end; ++ow) {
+              acc[ow - ow0] +=
+                  (static_cast<int32_t>(*x) - in_zero_point) * w;
+              x += g.stride_w;
+            }
+          }
+        }
+      }
+      for (int64_t ow = ow0; ow < ow1; ++ow) {
+        out[oh * g.out_w + ow] = internal::quantize_float<OUT_T>(
+            static_cast<float>(acc[ow - ow0]) * acc_scale + bias,
+            out_inv_scale,
+            out_zero_point,
+            out_quant_min,
+            out_quant_max);
+      }
+    }
+  }
+}
+
+} // namespace
+
+/**
+ * Quantized 2D convolution, out = quantize(conv2d(dequantize(input),
+ * dequantize(weight), bias)), with per-tensor quantization of the input,
+ * weight and output. Products are accumulated in int32 and requantized
+ * directly, without materializing the dequantized operands.
+ *
+ * input is a contiguous [N, C_in, H, W], weight is [C_out, C_in / groups, KH,
+ * KW], bias, if any, is a float [C_out], and out is [N, C_out, H_out, W_out].
+ * Each of them may be uint8 or int8.
+ */
+Tensor& quantized_conv2d_out(
+    const Tensor& in,
+    double in_scale,
+    int64_t in_zero_point,
+    const Tensor& weight,
+    double weight_scale,
+    int64_t weight_zero_point,
+    const optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  check_quantized_conv2d_args(
+      in,
+      in_zero_point,
+      weight,
+      weight_zero_point,
+      bias,
+      stride,
+      padding,
+      dilation,
+      groups,
+      out_quant_min,
+      out_quant_max,
+      out);
+
+  ConvGeometry g;
+  g.in_channels_per_group = weight.size(1);
+  g.out_channels_per_group = weight.size(0) / groups;
+  g.in_h = in.size(2);
+  g.in_w = in.size(3);
+  g.kernel_h = weight.size(2);
+  g.kernel_w = weight.size(3);
+  g.stride_h = param_at(stride, 0);
+  g.stride_w = param_at(stride, 1);
+  g.padding_h = param_at(padding, 0);
+  g.padding_w = param_at(padding, 1);
+  g.dilation_h = param_at(dilation, 0);
+  g.dilation_w = param_at(dilation, 1);
+  g.out_h = (g.in_h + 2 * g.padding_h - g.dilation_h * (g.kernel_h - 1) - 1) /
+          g.stride_h +
+      1;
+  g.out_w = (g.in_w + 2 * g.padding_w - g.dilation_w * (g.kernel_w - 1) - 1) /
+          g.stride_w +
+      1;
+  ET_CHECK_MSG(
+      g.out_h > 0 && g.out_w > 0, "The kernel is larger than the input");
+
+  const Tensor::SizesType out_sizes[4] = {
+      static_cast<Tensor::SizesType>(in.size(0)),
+      static_cast<Tensor::SizesType>(weight.size(0)),
+      static_cast<Tensor::SizesType>(g.out_h),
+      static_cast<Tensor::SizesType>(g.out_w)};
+  torch::executor::Error err = resize_tensor(out, {out_sizes, 4});
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in quantized_conv2d_out");
+
+  const int64_t batch = in.size(0);
+  const int64_t out_channels = weight.size(0);
+  const int64_t in_plane = in.size(1) * g.in_h * g.in_w;
+  const int64_t weight_filter =
+      g.in_channels_per_group * g.kernel_h * g.kernel_w;
+  const int64_t out_plane = g.out_h * g.out_w;
+  // Same float arithmetic as dequantizing both operands, up to the order of
+  // the sum.
+  const float acc_scale =
+      static_cast<float>(in_scale) * static_cast<float>(weight_scale);
+  const float out_inv_scale = 1.0f / static_cast<float>(out_scale);
+  const float* bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<float>() : nullptr;
+
+  ET_SWITCH_TWO_TYPES(
+      Byte, Char, in.scalar_type(), nullptr, __func__, IN_T, [&] {
+        ET_SWITCH_TWO_TYPES(
+            Byte, Char, weight.scalar_type(), nullptr, __func__, WEIGHT_T, [&] {
+              ET_SWITCH_TWO_TYPES(
+                  Byte, Char, out.scalar_type(), nullptr, __func__, OUT_T, [&] {
+                    const IN_T* in_data = in.const_data_ptr<IN_T>();
+                    const WEIGHT_T* weight_data =
+                        weight.const_data_ptr<WEIGHT_T>();
+                    OUT_T* out_data = out.mutable_data_ptr<OUT_T>();
+                    // One task per output plane
+                    parallel_for(
+                        0,
+                        batch * out_channels,
+                        parallel_grain_size(out_plane * weight_filter),
+                        [&](int64_t begin, int64_t end) {
+                          for (int64_t i = begin; i < end; ++i) {
+                            const int64_t n = i / out_channels;
+                            const int64_t oc = i % out_channels;
+                            const int64_t group = oc / g.out_channels_per_group;
+                            quantized_conv2d_plane<IN_T, WEIGHT_T, OUT_T>(
+                                in_data + n * in_plane +
+                                    group * g.in_channels_per_group * g.in_h *
+                                        g.in_w,
+                                static_cast<int32_t>(in_zero_point),
+                                weight_data + oc * weight_filter,
+                                static_cast<int32_t>(weight_zero_point),
+                                bias_data != nullptr ? bias_data[oc] : 0.0f,
+                                acc_scale,
+                                out_inv_scale,
+                                static_cast<int32_t>(out_zero_point),
+                                static_cast<int32_t>(out_quant_min),
+                                static_cast<int32_t>(out_quant_max),
+                                g,
+                                out_data + i * out_plane);
+                          }
+                        });
+                  });
+            });
+      });
+
+  return out;
+}
+
+Tensor& quantized_conv2d_out(
+    RuntimeContext& context,
+    const Tensor& in,
+    double in_scale,
+    int64_t in_zero_point,
+    const Tensor& weight,
+    double weight_scale,
+    int64_t weight_zero_point,
+    const optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  (void)context;
+  return quantized_conv2d_out(
+      in,
+      in_scale,
+      in_zero_point,
+      weight,
+      weight_scale,
+      weight_zero_point,
+      bias,
+      stride,
+      padding,
+      dilation,
+      groups,
+      out_scale,
+      out_zero_point,
+      out_quant_min,
+      out_quant_max,
+      out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -6,7 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
@@ -21,6 +23,8 @@ namespace native {
 using Tensor = exec_aten::Tensor;
 using Scalar = exec_aten::Scalar;
 using ScalarType = exec_aten::ScalarType;
+template <typename T>
+using optional = exec_aten::optional<T>;
 
 namespace {
 
@@ -63,6 +67,50 @@ void check_dequantize_per_tensor_args(
   (void)zero_point;
 }
 
+template <typename IN_CTYPE, typename OUT_CTYPE>
+void dequantize_values(
+    const IN_CTYPE* in,
+    OUT_CTYPE* out,
+    int64_t n,
+    double scale,
+    int64_t zero_point) {
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = static_cast<OUT_CTYPE>(
+        (in[i] - static_cast<int32_t>(zero_point)) * static_cast<float>(scale));
+  }
+}
+
+// The 8-bit to float conversions are vectorized.
+template <>
+void dequantize_values<uint8_t, float>(
+    const uint8_t* in,
+    float* out,
+    int64_t n,
+    double scale,
+    int64_t zero_point) {
+  internal::dequantize_to_floats(
+      in,
+      out,
+      n,
+      static_cast<float>(scale),
+      static_cast<int32_t>(zero_point));
+}
+
+template <>
+void dequantize_values<int8_t, float>(
+    const int8_t* in,
+    float* out,
+    int64_t n,
+    double scale,
+    int64_t zero_point) {
+  internal::dequantize_to_floats(
+      in,
+      out,
+      n,
+      static_cast<float>(scale),
+      static_cast<int32_t>(zero_point));
+}
+
 } // namespace
 
 /**
@@ -92,14 +140,23 @@ Tensor& dequantize_per_tensor_out(
 
   // calculate the dequantized output, cast scale to float to match fbgemm
   // behavior
-#define DEQUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)                        \
-  case ScalarType::out_dtype:                                                  \
-    for (size_t i = 0; i < input.numel(); i++) {                               \
-      out.data_ptr<OUT_CTYPE>()[i] = static_cast<OUT_CTYPE>(                   \
-          (input.data_ptr<IN_CTYPE>()[i] - static_cast<int32_t>(zero_point)) * \
-          static_cast<float>(scale));                                          \
-    }                                                                          \
-    break;
+#define DEQUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)         \
+  case ScalarType::out_dtype: {                                 \
+    const IN_CTYPE* in_data = input.const_data_ptr<IN_CTYPE>(); \
+    OUT_CTYPE* out_data = out.mutable_data_ptr<OUT_CTYPE>();    \
+    parallel_for(                                               \
+        0,                                                      \
+        input.numel(),                                          \
+        parallel_grain_size(1),                                 \
+        [&](int64_t begin, int64_t end) {                       \
+          dequantize_values<IN_CTYPE, OUT_CTYPE>(               \
+              in_data + begin,                                  \
+              out_data + begin,                                 \
+              end - begin,                                      \
+              scale,                                            \
+              zero_point);                                      \
+        });                                                     \
+  } break;
 #define CALCULATE_INT_TYPE(IN_CTYPE, in_dtype)               \
   case ScalarType::in_dtype:                                 \
     switch (out.scalar_type()) {                             \
@@ -121,7 +178,7 @@ Tensor& dequantize_per_tensor_out(
           static_cast<int8_t>(input.scalar_type()));
   }
 
-#undef CALCULATE_FLOAT_TYPE
+#undef CALCULATE_INT_TYPE
 #undef DEQUANTIZE_IMPL
   return out;
 }
@@ -162,6 +219,113 @@ Tensor& dequantize_per_tensor_tensor_args_out(
   return out;
 }
 
+/**
+ * Dequantizes the input tensor with a scale and zero point per slice of it
+ * along `axis`. Zero points default to 0.
+ */
+Tensor& dequantize_per_channel_out(
+    const Tensor& input,
+    const Tensor& scale,
+    const optional<Tensor>& opt_zero_points,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max,
+    ScalarType dtype,
+    Tensor& out) {
+  torch::executor::Error err = resize_tensor(out, input.sizes());
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in dequantize_per_channel_out");
+
+  if (axis < 0) {
+    axis += input.dim();
+  }
+  ET_CHECK_MSG(
+      axis >= 0 && axis < input.dim(),
+      "axis %" PRId64 " is out of range for a %zd-D input",
+      axis,
+      ssize_t(input.dim()));
+  ET_CHECK_MSG(
+      scale.scalar_type() == ScalarType::Double,
+      "Expected scale to be Double tensor received: %" PRId8,
+      static_cast<int8_t>(scale.scalar_type()));
+  ET_CHECK_MSG(
+      scale.numel() == input.size(axis),
+      "Expected scale to have %zd elements received: %zd",
+      ssize_t(input.size(axis)),
+      ssize_t(scale.numel()));
+  const int64_t* zero_point_data = nullptr;
+  if (opt_zero_points.has_value()) {
+    const Tensor& zero_points = opt_zero_points.value();
+    ET_CHECK_MSG(
+        zero_points.scalar_type() == ScalarType::Long,
+        "Expected zero_points to be Long tensor received: %" PRId8,
+        static_cast<int8_t>(zero_points.scalar_type()));
+    ET_CHECK_MSG(
+        zero_points.numel() == input.size(axis),
+        "Expected zero_points to have %zd elements received: %zd",
+        ssize_t(input.size(axis)),
+        ssize_t(zero_points.numel()));
+    zero_point_data = zero_points.const_data_ptr<int64_t>();
+  }
+
+  check_dequantize_per_tensor_args(
+      input, 0, 0, quant_min, quant_max, dtype, out);
+
+  const double* scale_data = scale.const_data_ptr<double>();
+  const int64_t channels = input.size(axis);
+  const int64_t inner_size = getTrailingDims(input, axis);
+  const int64_t num_rows = getLeadingDims(input, axis) * channels;
+
+  // Each row of inner_size elements has a single scale and zero point.
+#define DEQUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)                    \
+  case ScalarType::out_dtype: {                                            \
+    const IN_CTYPE* in_data = input.const_data_ptr<IN_CTYPE>();            \
+    OUT_CTYPE* out_data = out.mutable_data_ptr<OUT_CTYPE>();               \
+    parallel_for(                                                          \
+        0,                                                                 \
+        num_rows,                                                          \
+        parallel_grain_size(inner_size),                                   \
+        [&](int64_t begin, int64_t end) {                                  \
+          for (int64_t row = begin; row < end; row++) {                    \
+            const int64_t channel = row % channels;                        \
+            const int64_t zero_point =                                     \
+                zero_point_data == nullptr ? 0 : zero_point_data[channel]; \
+            dequantize_values<IN_CTYPE, OUT_CTYPE>(                        \
+                in_data + row * inner_size,                                \
+                out_data + row * inner_size,                               \
+                inner_size,                                                \
+                scale_data[channel],                                       \
+                zero_point);                                               \
+          }                                                                \
+        });                                                                \
+  } break;
+#define CALCULATE_INT_TYPE(IN_CTYPE, in_dtype)               \
+  case ScalarType::in_dtype:                                 \
+    switch (out.scalar_type()) {                             \
+      ET_FORALL_FLOAT_TYPES_WITH(IN_CTYPE, DEQUANTIZE_IMPL); \
+      default:                                               \
+        ET_CHECK_MSG(                                        \
+            false,                                           \
+            "Unhandled output dtype %" PRId8,                \
+            static_cast<int8_t>(out.scalar_type()));         \
+    }                                                        \
+    break;
+
+  switch (input.scalar_type()) {
+    ET_FORALL_INT_TYPES(CALCULATE_INT_TYPE);
+    default:
+      ET_CHECK_MSG(
+          false,
+          "Unhandled input dtype %" PRId8,
+          static_cast<int8_t>(input.scalar_type()));
+  }
+
+#undef CALCULATE_INT_TYPE
+#undef DEQUANTIZE_IMPL
+  return out;
+}
+
 Tensor& dequantize_per_tensor_out(
     RuntimeContext& context,
     const Tensor& input,
@@ -194,6 +358,28 @@ Tensor& dequantize_per_tensor_tensor_args_out(
       input, scale, zero_point, quant_min, quant_max, dtype, out);
 }
 
+Tensor& dequantize_per_channel_out(
+    RuntimeContext& context,
+    const Tensor& input,
+    const Tensor& scale,
+    const optional<Tensor>& opt_zero_points,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max,
+    ScalarType dtype,
+    Tensor& out) {
+  (void)context;
+  return dequantize_per_channel_out(
+      input,
+      scale,
+      opt_zero_points,
+      axis,
+      quant_min,
+      quant_max,
+      dtype,
+      out);
+}
+
 } // namespace native
 } // namespace executor
 } // namespace torch
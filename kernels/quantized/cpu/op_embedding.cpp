@@ -6,7 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
@@ -21,6 +23,10 @@ using ScalarType = exec_aten::ScalarType;
 
 namespace {
 
+// How many indices ahead of the row being dequantized to prefetch rows.
+constexpr int64_t kPrefetchDistance = 2;
+constexpr int64_t kCacheLineSize = 64;
+
 /**
  * Asserts that the parameters are valid.
  */
@@ -66,6 +72,52 @@ void check_embedding_byte_args(
       " is greater than weight quant max: %" PRId64,
       weight_quant_min,
       weight_quant_max);
+
+  ET_CHECK_MSG(weight.dim() == 2, "weight must be 2-D");
+
+  // The qparams are either per row, or per group of consecutive columns of
+  // each row.
+  ET_CHECK_MSG(
+      weight_scales.dim() == 1 || weight_scales.dim() == 2,
+      "weight_scales must be 1-D or 2-D");
+  ET_CHECK_MSG(
+      weight_scales.size(0) == weight.size(0),
+      "weight_scales has %zd rows but weight has %zd",
+      ssize_t(weight_scales.size(0)),
+      ssize_t(weight.size(0)));
+  if (weight_scales.dim() == 2) {
+    ET_CHECK_MSG(
+        weight_scales.size(1) > 0 &&
+            weight.size(1) % weight_scales.size(1) == 0,
+        "weight has %zd columns, not a multiple of the %zd groups",
+        ssize_t(weight.size(1)),
+        ssize_t(weight_scales.size(1)));
+  }
+  ET_CHECK_MSG(
+      weight_zero_points.numel() == weight_scales.numel(),
+      "weight_zero_points has %zd elements but weight_scales has %zd",
+      ssize_t(weight_zero_points.numel()),
+      ssize_t(weight_scales.numel()));
+
+  const int64_t* indices_ptr = indices.const_data_ptr<int64_t>();
+  const int64_t num_embeddings = weight.size(0);
+  for (size_t i = 0; i < indices.numel(); ++i) {
+    ET_CHECK_MSG(
+        indices_ptr[i] >= 0 && indices_ptr[i] < num_embeddings,
+        "indices[%zu] %" PRId64 " is out of range [0, %" PRId64 ")",
+        i,
+        indices_ptr[i],
+        num_embeddings);
+  }
+}
+
+template <class WEIGHT_CTYPE>
+void prefetch_row(const WEIGHT_CTYPE* row, int64_t embedding_dim) {
+  const char* bytes = reinterpret_cast<const char*>(row);
+  const int64_t nbytes = embedding_dim * sizeof(WEIGHT_CTYPE);
+  for (int64_t offset = 0; offset < nbytes; offset += kCacheLineSize) {
+    __ET_PREFETCH(bytes + offset);
+  }
 }
 
 /**
@@ -81,28 +133,43 @@ void embedding_byte_per_channel(
     Tensor& out) {
   // An embedding layer nn.Embedding(num_embeddings, embedding_dim) has a weight
   // of shape (num_embeddings, embedding_dim).
-  auto embedding_dim = weight.size(1);
+  const int64_t embedding_dim = weight.size(1);
 
-  OUT_CTYPE* out_data = out.data_ptr<OUT_CTYPE>();
-  const int64_t* indices_ptr = indices.data_ptr<int64_t>();
+  OUT_CTYPE* out_data = out.mutable_data_ptr<OUT_CTYPE>();
+  const int64_t* indices_ptr = indices.const_data_ptr<int64_t>();
+  const WEIGHT_CTYPE* weight_data = weight.const_data_ptr<WEIGHT_CTYPE>();
 
-  const float* scales = weight_scales.data_ptr<float>();
-  const float* zero_points = weight_zero_points.data_ptr<float>();
+  const float* scales = weight_scales.const_data_ptr<float>();
+  const float* zero_points = weight_zero_points.const_data_ptr<float>();
+  const int64_t num_groups =
+      weight_scales.dim() == 2 ? weight_scales.size(1) : 1;
+  const int64_t group_size = embedding_dim / num_groups;
 
-  for (int i = 0; i < indices.numel(); i++) {
-    int64_t index = indices_ptr[i];
-    float zp = zero_points[index];
-    float scale = scales[index];
-
-    const WEIGHT_CTYPE* w_data =
-        weight.data_ptr<WEIGHT_CTYPE>() + embedding_dim * index;
-
-    for (int j = 0; j < embedding_dim; ++j) {
-      out_data[j] =
-          static_cast<OUT_CTYPE>((static_cast<float>(w_data[j]) - zp) * scale);
-    }
-    out_data += embedding_dim;
-  }
+  // Rows are gathered from anywhere in the table, so fetch the ones of the
+  // next few indices while dequantizing the current one.
+  parallel_for(
+      0,
+      indices.numel(),
+      parallel_grain_size(embedding_dim),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          if (i + kPrefetchDistance < end) {
+            prefetch_row(
+                weight_data +
+                    embedding_dim * indices_ptr[i + kPrefetchDistance],
+                embedding_dim);
+          }
+          const int64_t index = indices_ptr[i];
+          for (int64_t g = 0; g < num_groups; ++g) {
+            internal::dequantize_to_floats(
+                weight_data + embedding_dim * index + group_size * g,
+                out_data + embedding_dim * i + group_size * g,
+                group_size,
+                scales[index * num_groups + g],
+                zero_points[index * num_groups + g]);
+          }
+        }
+      });
 }
 
 void resize_out_tensor(
@@ -130,7 +197,9 @@ void resize_out_tensor(
 /**
  * Retrieves the embeddings specified by indices, dequantizes them, and stores
  * them in out. The weight is quantized per channel, with a scale and zero_point
- * for each embedding.
+ * for each embedding, or group-wise, with weight_scales and weight_zero_points
+ * of shape [num_embeddings, num_groups] holding a scale and zero_point for
+ * each group of embedding_dim / num_groups consecutive values of a row.
  *
  * Corresponds as the out variant to torch.ops.quantized.embedding_byte
  *
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+template <typename T>
+using optional = exec_aten::optional<T>;
+
+namespace {
+
+// How many indices ahead of the row being dequantized to prefetch rows.
+constexpr int64_t kPrefetchDistance = 2;
+constexpr int64_t kCacheLineSize = 64;
+
+/**
+ * Asserts that the parameters are valid.
+ */
+void check_embedding_4bit_args(
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    const int64_t weight_quant_min,
+    const int64_t weight_quant_max,
+    const Tensor& indices,
+    Tensor& out) {
+  ET_CHECK_MSG(
+      weight.scalar_type() == ScalarType::Byte,
+      "weight.scalar_type() %" PRId8 " is not Byte",
+      static_cast<int8_t>(weight.scalar_type()));
+  ET_CHECK_MSG(weight.dim() == 2, "weight must be 2-D");
+
+  ET_CHECK_MSG(
+      weight_scales.scalar_type() == ScalarType::Float,
+      "weight_scales.scalar_type() %" PRId8 " is not Float",
+      static_cast<int8_t>(weight_scales.scalar_type()));
+  ET_CHECK_MSG(
+      weight_scales.dim() == 1 || weight_scales.dim() == 2,
+      "weight_scales must be 1-D or 2-D");
+  ET_CHECK_MSG(
+      weight_scales.size(0) == weight.size(0),
+      "weight_scales has %zd rows but weight has %zd",
+      ssize_t(weight_scales.size(0)),
+      ssize_t(weight.size(0)));
+  if (weight_scales.dim() == 2) {
+    // Each group starts on a byte boundary of the packed row.
+    const int64_t embedding_dim = weight.size(1) * 2;
+    ET_CHECK_MSG(
+        weight_scales.size(1) > 0 &&
+            embedding_dim % weight_scales.size(1) == 0 &&
+            (embedding_dim / weight_scales.size(1)) % 2 == 0,
+        "embedding_dim %zd does not split into %zd groups of even size",
+        ssize_t(embedding_dim),
+        ssize_t(weight_scales.size(1)));
+  }
+
+  if (opt_weight_zero_points.has_value()) {
+    const Tensor& weight_zero_points = opt_weight_zero_points.value();
+    ET_CHECK_MSG(
+        weight_zero_points.scalar_type() == ScalarType::Float,
+        "weight_zero_points.scalar_type() %" PRId8 " is not Float",
+        static_cast<int8_t>(weight_zero_points.scalar_type()));
+    ET_CHECK_MSG(
+        weight_zero_points.numel() == weight_scales.numel(),
+        "weight_zero_points has %zd elements but weight_scales has %zd",
+        ssize_t(weight_zero_points.numel()),
+        ssize_t(weight_scales.numel()));
+  }
+
+  ET_CHECK_MSG(
+      indices.scalar_type() == ScalarType::Long,
+      "indices.scalar_type() %" PRId8 " is not Long only Long is supported:",
+      static_cast<int8_t>(indices.scalar_type()));
+
+  ET_CHECK_MSG(
+      out.scalar_type() == ScalarType::Float,
+      "out.scalar_type() %" PRId8 " is not supported:",
+      static_cast<int8_t>(out.scalar_type()));
+
+  ET_CHECK_MSG(
+      weight_quant_min <= weight_quant_max && weight_quant_min >= -8 &&
+          weight_quant_max <= 7,
+      "invalid weight quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for 4-bit values",
+      weight_quant_min,
+      weight_quant_max);
+
+  const int64_t* indices_ptr = indices.const_data_ptr<int64_t>();
+  const int64_t num_embeddings = weight.size(0);
+  for (size_t i = 0; i < indices.numel(); ++i) {
+    ET_CHECK_MSG(
+        indices_ptr[i] >= 0 && indices_ptr[i] < num_embeddings,
+        "indices[%zu] %" PRId64 " is out of range [0, %" PRId64 ")",
+        i,
+        indices_ptr[i],
+        num_embeddings);
+  }
+}
+
+void prefetch_row(const uint8_t* row, int64_t nbytes) {
+  for (int64_t offset = 0; offset < nbytes; offset += kCacheLineSize) {
+    __ET_PREFETCH(row + offset);
+  }
+}
+
+void embedding_4bit_per_group(
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    const Tensor& indices,
+    Tensor& out) {
+  const int64_t packed_dim = weight.size(1);
+  const int64_t embedding_dim = packed_dim * 2;
+  const int64_t num_groups =
+      weight_scales.dim() == 2 ? weight_scales.size(1) : 1;
+  const int64_t group_size = embedding_dim / num_groups;
+
+  float* out_data = out.mutable_data_ptr<float>();
+  const int64_t* indices_ptr = indices.const_data_ptr<int64_t>();
+  const uint8_t* weight_data = weight.const_data_ptr<uint8_t>();
+  const float* scales = weight_scales.const_data_ptr<float>();
+  const float* zero_points = opt_weight_zero_points.has_value()
+      ? opt_weight_zero_points.value().const_data_ptr<float>()
+      : nullptr;
+
+  // Rows are gathered from anywhere in the table, so fetch the ones of the
+  // next few indices while dequantizing the current one.
+  parallel_for(
+      0,
+      indices.numel(),
+      parallel_grain_size(embedding_dim),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          if (i + kPrefetchDistance < end) {
+            prefetch_row(
+                weight_data + packed_dim * indices_ptr[i + kPrefetchDistance],
+                packed_dim);
+          }
+          const int64_t index = indices_ptr[i];
+          for (int64_t g = 0; g < num_groups; ++g) {
+            const int64_t qparam = index * num_groups + g;
+            internal::dequantize_4bit_to_floats(
+                weight_data + packed_dim * index + group_size * g / 2,
+                out_data + embedding_dim * i + group_size * g,
+                group_size,
+                scales[qparam],
+                zero_points != nullptr ? zero_points[qparam] : 0.0f);
+          }
+        }
+      });
+}
+
+void resize_out_tensor(
+    const Tensor& weight,
+    const Tensor& indices,
+    Tensor& out) {
+  exec_aten::SizesType expected_output_size[kTensorDimensionLimit];
+  for (size_t i = 0; i < indices.dim(); i++) {
+    expected_output_size[i] = indices.size(i);
+  }
+  expected_output_size[indices.dim()] = weight.size(1) * 2;
+
+  exec_aten::ArrayRef<exec_aten::SizesType> output_size{
+      expected_output_size, static_cast<size_t>(indices.dim() + 1)};
+
+  torch::executor::Error err = resize_tensor(out, output_size);
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in quantized_embedding_4bit_out");
+}
+
+} // namespace
+
+/**
+ * Retrieves the embeddings specified by indices, dequantizes them, and stores
+ * them in out. The weight holds signed 4-bit values packed two per byte, so
+ * it is [num_embeddings, embedding_dim / 2]: byte j of a row holds value 2j in
+ * its high nibble and value 2j + 1 in its low nibble, each stored with an
+ * offset of 8.
+ *
+ * weight_scales and weight_zero_points are either [num_embeddings], or
+ * [num_embeddings, num_groups] with a scale and zero_point for each group of
+ * embedding_dim / num_groups consecutive values of a row. Without zero points,
+ * the values are symmetric.
+ *
+ * As for embedding_byte, quant_min and quant_max are only metadata.
+ */
+Tensor& quantized_embedding_4bit_out(
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    const int64_t weight_quant_min,
+    const int64_t weight_quant_max,
+    const Tensor& indices,
+    Tensor& out) {
+  check_embedding_4bit_args(
+      weight,
+      weight_scales,
+      opt_weight_zero_points,
+      weight_quant_min,
+      weight_quant_max,
+      indices,
+      out);
+  resize_out_tensor(weight, indices, out);
+  embedding_4bit_per_group(
+      weight, weight_scales, opt_weight_zero_points, indices, out);
+  return out;
+}
+
+Tensor& quantized_embedding_4bit_out(
+    RuntimeContext& context,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const Tensor& indices,
+    Tensor& out) {
+  (void)context;
+  return quantized_embedding_4bit_out(
+      weight,
+      weight_scales,
+      opt_weight_zero_points,
+      weight_quant_min,
+      weight_quant_max,
+      indices,
+      out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+template <typename T>
+using optional = exec_aten::optional<T>;
+
+namespace {
+
+// Rows of the weight that a task computes against every input row, sized to
+// keep them in cache while the input rows stream by.
+constexpr int64_t kWeightRowsPerBlock = 16;
+
+void check_quantized_linear_args(
+    const Tensor& in,
+    int64_t in_zero_point,
+    const Tensor& weight,
+    int64_t weight_zero_point,
+    const optional<Tensor>& bias,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    const Tensor& out) {
+  ET_CHECK_MSG(
+      in.scalar_type() == ScalarType::Byte ||
+          in.scalar_type() == ScalarType::Char,
+      "input.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(in.scalar_type()));
+  ET_CHECK_MSG(
+      weight.scalar_type() == ScalarType::Byte ||
+          weight.scalar_type() == ScalarType::Char,
+      "weight.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(weight.scalar_type()));
+  ET_CHECK_MSG(
+      out.scalar_type() == ScalarType::Byte ||
+          out.scalar_type() == ScalarType::Char,
+      "out.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(out.scalar_type()));
+  ET_CHECK_MSG(in.dim() >= 1, "input must have at least one dimension");
+  ET_CHECK_MSG(
+      weight.dim() == 2,
+      "weight must be 2-D, got %zd-D",
+      ssize_t(weight.dim()));
+  ET_CHECK_MSG(
+      in.size(in.dim() - 1) == weight.size(1),
+      "input has %zd features but weight expects %zd",
+      ssize_t(in.size(in.dim() - 1)),
+      ssize_t(weight.size(1)));
+  if (bias.has_value()) {
+    ET_CHECK_MSG(
+        bias.value().scalar_type() == ScalarType::Float,
+        "bias.scalar_type() %" PRId8 " is not Float",
+        static_cast<int8_t>(bias.value().scalar_type()));
+    ET_CHECK_MSG(
+        bias.value().numel() == weight.size(0),
+        "Expected bias to have %zd elements received: %zd",
+        ssize_t(weight.size(0)),
+        ssize_t(bias.value().numel()));
+  }
+  ET_CHECK_MSG(
+      in_zero_point >= -128 && in_zero_point <= 255 &&
+          weight_zero_point >= -128 && weight_zero_point <= 255,
+      "zero points %" PRId64 " and %" PRId64 " are out of the 8-bit range",
+      in_zero_point,
+      weight_zero_point);
+  ET_CHECK_MSG(
+      out_quant_min <= out_quant_max &&
+          out_quant_min >=
+              (out.scalar_type() == ScalarType::Byte ? 0 : INT8_MIN) &&
+          out_quant_max <=
+              (out.scalar_type() == ScalarType::Byte ? UINT8_MAX : INT8_MAX),
+      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for the output dtype",
+      out_quant_min,
+      out_quant_max);
+}
+
+/**
+ * Computes the output columns [n_begin, n_end) of every one of the `m` rows:
+ * the int32 dot product of an input row and a weight row, scaled back to
+ * float, plus the bias, and quantized again.
+ */
+template <typename IN_T, typename WEIGHT_T, typename OUT_T>
+void quantized_linear_columns(
+    const IN_T* in,
+    int32_t in_zero_point,
+    const WEIGHT_T* weight,
+    int32_t weight_zero_point,
+    const float* bias,
+    float acc_scale,
+    float out_inv_scale,
+    int32_t out_zero_point,
+    int32_t out_quant_min,
+    int32_t out_quant_max,
+    OUT_T* out,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    int64_t n_begin,
+    int64_t n_end) {
+  for (int64_t n0 = n_begin; n0 < n_end; n0 += kWeightRowsPerBlock) {
+    const int64_t n1 = std::min(n_end, n0 + kWeightRowsPerBlock);
+    for (int64_t i = 0; i < m; ++i) {
+      const IN_T* in_row = in + i * k;
+      for (int64_t j = n0; j < n1; ++j) {
+        const int32_t acc = internal::dot_8bit(
+            in_row, in_zero_point, weight + j * k, weight_zero_point, k);
+        const float value = static_cast<float>(acc) * acc_scale +
+            (bias != nullptr ? bias[j] : 0.0f);
+        out[i * n + j] = internal::quantize_float<OUT_T>(
+            value,
+            out_inv_scale,
+            out_zero_point,
+            out_quant_min,
+            out_quant_max);
+      }
+    }
+  }
+}
+
+} // namespace
+
+/**
+ * Quantized linear layer, out = quantize(dequantize(input) @
+ * dequantize(weight).T + bias), with per-tensor quantization of the input,
+ * weight and output. Products are accumulated in int32 and requantized
+ * directly, without materializing the dequantized operands.
+ *
+ * input is [..., K], weight is [N, K], bias, if any, is a float [N], and out
+ * is [..., N]. Each of them may be uint8 or int8.
+ */
+Tensor& quantized_linear_out(
+    const Tensor& in,
+    double in_scale,
+    int64_t in_zero_point,
+    const Tensor& weight,
+    double weight_scale,
+    int64_t weight_zero_point,
+    const optional<Tensor>& bias,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  check_quantized_linear_args(
+      in,
+      in_zero_point,
+      weight,
+      weight_zero_point,
+      bias,
+      out_quant_min,
+      out_quant_max,
+      out);
+
+  Tensor::SizesType out_sizes[kTensorDimensionLimit];
+  for (size_t i = 0; i < in.dim() - 1; ++i) {
+    out_sizes[i] = in.size(i);
+  }
+  out_sizes[in.dim() - 1] = weight.size(0);
+  torch::executor::Error err =
+      resize_tensor(out, {out_sizes, static_cast<size_t>(in.dim())});
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in quantized_linear_out");
+
+  const int64_t k = weight.size(1);
+  const int64_t n = weight.size(0);
+  const int64_t m = getLeadingDims(in, in.dim() - 1);
+  // Same float arithmetic as dequantizing both operands, up to the order of
+  // the sum.
+  const float acc_scale =
+      static_cast<float>(in_scale) * static_cast<float>(weight_scale);
+  const float out_inv_scale = 1.0f / static_cast<float>(out_scale);
+  const float* bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<float>() : nullptr;
+
+  ET_SWITCH_TWO_TYPES(
+      Byte, Char, in.scalar_type(), nullptr, __func__, IN_T, [&] {
+        ET_SWITCH_TWO_TYPES(
+            Byte, Char, weight.scalar_type(), nullptr, __func__, WEIGHT_T, [&] {
+              ET_SWITCH_TWO_TYPES(
+                  Byte, Char, out.scalar_type(), nullptr, __func__, OUT_T, [&] {
+                    // Split the weight rows rather than the input rows, so
+                    // that single-row inputs, e.g. while decoding, still use
+                    // every thread.
+                    parallel_for(
+                        0,
+                        n,
+                        parallel_grain_size(m * k),
+                        [&](int64_t begin, int64_t end) {
+                          quantized_linear_columns<IN_T, WEIGHT_T, OUT_T>(
+                              in.const_data_ptr<IN_T>(),
+                              static_cast<int32_t>(in_zero_point),
+                              weight.const_data_ptr<WEIGHT_T>(),
+                              static_cast<int32_t>(weight_zero_point),
+                              bias_data,
+                              acc_scale,
+                              out_inv_scale,
+                              static_cast<int32_t>(out_zero_point),
+                              static_cast<int32_t>(out_quant_min),
+                              static_cast<int32_t>(out_quant_max),
+                              out.mutable_data_ptr<OUT_T>(),
+                              m,
+                              n,
+                              k,
+                              begin,
+                              end);
+                        });
+                  });
+            });
+      });
+
+  return out;
+}
+
+Tensor& quantized_linear_out(
+    RuntimeContext& context,
+    const Tensor& in,
+    double in_scale,
+    int64_t in_zero_point,
+    const Tensor& weight,
+    double weight_scale,
+    int64_t weight_zero_point,
+    const optional<Tensor>& bias,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  (void)context;
+  return quantized_linear_out(
+      in,
+      in_scale,
+      in_zero_point,
+      weight,
+      weight_scale,
+      weight_zero_point,
+      bias,
+      out_scale,
+      out_zero_point,
+      out_quant_min,
+      out_quant_max,
+      out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
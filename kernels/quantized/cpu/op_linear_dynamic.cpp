@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+template <typename T>
+using optional = exec_aten::optional<T>;
+
+namespace {
+
+// The input is quantized to int8 over its full range, like the dynamically
+// quantized linear layers of the XNNPACK quantizer.
+constexpr int32_t kInQuantMin = -128;
+constexpr int32_t kInQuantMax = 127;
+
+// Rows of the weight that a task computes against every input row, sized to
+// keep them in cache while the input rows stream by.
+constexpr int64_t kWeightRowsPerBlock = 16;
+
+void check_linear_dynamic_args(
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const optional<Tensor>& bias,
+    const Tensor& out) {
+  ET_CHECK_MSG(
+      in.scalar_type() == ScalarType::Float,
+      "input.scalar_type() %" PRId8 " is not Float",
+      static_cast<int8_t>(in.scalar_type()));
+  ET_CHECK_MSG(
+      out.scalar_type() == ScalarType::Float,
+      "out.scalar_type() %" PRId8 " is not Float",
+      static_cast<int8_t>(out.scalar_type()));
+  ET_CHECK_MSG(
+      weight.scalar_type() == ScalarType::Byte ||
+          weight.scalar_type() == ScalarType::Char,
+      "weight.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(weight.scalar_type()));
+  ET_CHECK_MSG(in.dim() >= 1, "input must have at least one dimension");
+  ET_CHECK_MSG(
+      weight.dim() == 2,
+      "weight must be 2-D, got %zd-D",
+      ssize_t(weight.dim()));
+  ET_CHECK_MSG(
+      in.size(in.dim() - 1) == weight.size(1),
+      "input has %zd features but weight expects %zd",
+      ssize_t(in.size(in.dim() - 1)),
+      ssize_t(weight.size(1)));
+
+  const int64_t n = weight.size(0);
+  ET_CHECK_MSG(
+      weight_scales.scalar_type() == ScalarType::Float,
+      "weight_scales.scalar_type() %" PRId8 " is not Float",
+      static_cast<int8_t>(weight_scales.scalar_type()));
+  ET_CHECK_MSG(
+      weight_scales.numel() == n,
+      "Expected weight_scales to have %zd elements received: %zd",
+      ssize_t(n),
+      ssize_t(weight_scales.numel()));
+  if (opt_weight_zero_points.has_value()) {
+    const Tensor& zero_points = opt_weight_zero_points.value();
+    ET_CHECK_MSG(
+        zero_points.scalar_type() == ScalarType::Long,
+        "weight_zero_points.scalar_type() %" PRId8 " is not Long",
+        static_cast<int8_t>(zero_points.scalar_type()));
+    ET_CHECK_MSG(
+        zero_points.numel() == n,
+        "Expected weight_zero_points to have %zd elements received: %zd",
+        ssize_t(n),
+        ssize_t(zero_points.numel()));
+    // dot_8bit() needs 8-bit zero points.
+    const int64_t* data = zero_points.const_data_ptr<int64_t>();
+    for (int64_t j = 0; j < n; ++j) {
+      ET_CHECK_MSG(
+          data[j] >= -128 && data[j] <= 255,
+          "weight zero point %" PRId64 " is out of the 8-bit range",
+          data[j]);
+    }
+  }
+  ET_CHECK_MSG(
+      weight_quant_min <= weight_quant_max &&
+          weight_quant_min >=
+              (weight.scalar_type() == ScalarType::Byte ? 0 : INT8_MIN) &&
+          weight_quant_max <=
+              (weight.scalar_type() == ScalarType::Byte ? UINT8_MAX
+                                                        : INT8_MAX),
+      "invalid weight quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for the weight dtype",
+      weight_quant_min,
+      weight_quant_max);
+
+  if (bias.has_value()) {
+    ET_CHECK_MSG(
+        bias.value().scalar_type() == ScalarType::Float,
+        "bias.scalar_type() %" PRId8 " is not Float",
+        static_cast<int8_t>(bias.value().scalar_type()));
+    ET_CHECK_MSG(
+        bias.value().numel() == n,
+        "Expected bias to have %zd elements received: %zd",
+        ssize_t(n),
+        ssize_t(bias.value().numel()));
+  }
+}
+
+/**
+ * Computes the output columns [n_begin, n_end) of every one of the `m` rows:
+ * the int32 dot product of a quantized input row and a weight row, scaled by
+ * the input scale and the scale of the weight row, plus the bias.
+ */
+template <typename WEIGHT_T>
+void linear_dynamic_columns(
+    const int8_t* in,
+    int32_t in_zero_point,
+    float in_scale,
+    const WEIGHT_T* weight,
+    const float* weight_scales,
+    const int64_t* weight_zero_points,
+    const float* bias,
+    float* out,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    int64_t n_begin,
+    int64_t n_end) {
+  for (int64_t n0 = n_begin; n0 < n_end; n0 += kWeightRowsPerBlock) {
+    const int64_t n1 = std::min(n_end, n0 + kWeightRowsPerBlock);
+    for (int64_t i = 0; i < m; ++i) {
+      const int8_t* in_row = in + i * k;
+      for (int64_t j = n0; j < n1; ++j) {
+        const int32_t weight_zero_point = weight_zero_points != nullptr
+            ? static_cast<int32_t>(weight_zero_points[j])
+            : 0;
+        const int32_t acc = internal::dot_8bit(
+            in_row, in_zero_point, weight + j * k, weight_zero_point, k);
+        out[i * n + j] =
+            static_cast<float>(acc) * (in_scale * weight_scales[j]) +
+            (bias != nullptr ? bias[j] : 0.0f);
+      }
+    }
+  }
+}
+
+} // namespace
+
+/**
+ * Dynamically quantized linear layer with float input and output,
+ * out = dequantize(quantize(input)) @ dequantize(weight).T + bias, where the
+ * input is quantized per tensor to int8 with the qparams that choose_qparams
+ * gives for its range at run time. Fuses choose_qparams, quantize_per_tensor
+ * and the linear layer: the input is quantized once into temp memory and
+ * multiplied with the weight in int32, and only the output is dequantized.
+ *
+ * weight is a uint8 or int8 [N, K] quantized per row: weight_scales is a float
+ * [N], and weight_zero_points, if any, an int64 [N]; without zero points the
+ * weight is symmetric. input is [..., K], bias, if any, is a float [N], and
+ * out is [..., N]. Needs M * K bytes of temp memory, for the M rows of input.
+ */
+Tensor& quantized_linear_dynamic_out(
+    RuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const optional<Tensor>& bias,
+    Tensor& out) {
+  check_linear_dynamic_args(
+      in,
+      weight,
+      weight_scales,
+      opt_weight_zero_points,
+      weight_quant_min,
+      weight_quant_max,
+      bias,
+      out);
+
+  Tensor::SizesType out_sizes[kTensorDimensionLimit];
+  for (size_t i = 0; i < in.dim() - 1; ++i) {
+    out_sizes[i] = in.size(i);
+  }
+  out_sizes[in.dim() - 1] = weight.size(0);
+  torch::executor::Error err =
+      resize_tensor(out, {out_sizes, static_cast<size_t>(in.dim())});
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in quantized_linear_dynamic_out");
+
+  const int64_t k = weight.size(1);
+  const int64_t n = weight.size(0);
+  const int64_t m = getLeadingDims(in, in.dim() - 1);
+  if (m == 0 || n == 0) {
+    return out;
+  }
+  const float* in_data = in.const_data_ptr<float>();
+
+  // choose_qparams of the whole input.
+  float min = 0.0f;
+  float max = 0.0f;
+  if (k > 0) {
+    internal::float_range(in_data, m * k, &min, &max);
+  }
+  double scale = 0;
+  int32_t zero_point = 0;
+  internal::choose_qparams(
+      min, max, kInQuantMin, kInQuantMax, &scale, &zero_point);
+  // Same float arithmetic as quantize_per_tensor and dequantize_per_tensor.
+  const float in_scale = static_cast<float>(scale);
+  const float in_inv_scale = 1.0f / in_scale;
+
+  const size_t temp_bytes = static_cast<size_t>(m * k);
+  Result<void*> temp = ctx.allocate_temp(temp_bytes > 0 ? temp_bytes : 1);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      temp.ok(),
+      MemoryAllocationFailed,
+      out,
+      "linear_dynamic needs %zu bytes of temp memory",
+      temp_bytes);
+  int8_t* in_quantized = static_cast<int8_t*>(temp.get());
+
+  parallel_for(0, m, parallel_grain_size(k), [&](int64_t begin, int64_t end) {
+    internal::quantize_floats<int8_t>(
+        in_data + begin * k,
+        in_quantized + begin * k,
+        (end - begin) * k,
+        in_inv_scale,
+        zero_point,
+        kInQuantMin,
+        kInQuantMax);
+  });
+
+  const float* scales_data = weight_scales.const_data_ptr<float>();
+  const int64_t* zero_points_data = opt_weight_zero_points.has_value()
+      ? opt_weight_zero_points.value().const_data_ptr<int64_t>()
+      : nullptr;
+  const float* bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<float>() : nullptr;
+  float* out_data = out.mutable_data_ptr<float>();
+
+  ET_SWITCH_TWO_TYPES(
+      Byte, Char, weight.scalar_type(), ctx, __func__, WEIGHT_T, [&] {
+        // Split the weight rows rather than the input rows, so that
+        // single-row inputs, e.g. while decoding, still use every thread.
+        parallel_for(
+            0, n, parallel_grain_size(m * k), [&](int64_t begin, int64_t end) {
+              linear_dynamic_columns<WEIGHT_T>(
+                  in_quantized,
+                  zero_point,
+                  in_scale,
+                  weight.const_data_ptr<WEIGHT_T>(),
+                  scales_data,
+                  zero_points_data,
+                  bias_data,
+                  out_data,
+                  m,
+                  n,
+                  k,
+                  begin,
+                  end);
+            });
+      });
+
+  ctx.free_temp(in_quantized);
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+template <typename T>
+using optional = exec_aten::optional<T>;
+
+namespace {
+
+// Weight values dequantized at once, then multiplied with every input row.
+// Even, so that chunks of packed 4-bit rows start on a byte boundary.
+constexpr int64_t kChunkSize = 256;
+
+/**
+ * Asserts that the parameters are valid. `k` is the number of input features,
+ * which for 4-bit weights is twice the number of bytes in a row.
+ */
+void check_linear_groupwise_args(
+    const Tensor& in,
+    const Tensor& weight,
+    int64_t k,
+    int64_t bits,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const optional<Tensor>& bias,
+    const Tensor& out) {
+  ET_CHECK_MSG(
+      in.scalar_type() == ScalarType::Float,
+      "input.scalar_type() %" PRId8 " is not Float",
+      static_cast<int8_t>(in.scalar_type()));
+  ET_CHECK_MSG(
+      out.scalar_type() == ScalarType::Float,
+      "out.scalar_type() %" PRId8 " is not Float",
+      static_cast<int8_t>(out.scalar_type()));
+  ET_CHECK_MSG(in.dim() >= 1, "input must have at least one dimension");
+  ET_CHECK_MSG(
+      in.size(in.dim() - 1) == k,
+      "input has %zd features but weight expects %zd",
+      ssize_t(in.size(in.dim() - 1)),
+      ssize_t(k));
+
+  const int64_t n = weight.size(0);
+  ET_CHECK_MSG(
+      weight_scales.scalar_type() == ScalarType::Float,
+      "weight_scales.scalar_type() %" PRId8 " is not Float",
+      static_cast<int8_t>(weight_scales.scalar_type()));
+  ET_CHECK_MSG(
+      (weight_scales.dim() == 1 || weight_scales.dim() == 2) &&
+          weight_scales.size(0) == n,
+      "weight_scales must be [%zd] or [%zd, num_groups]",
+      ssize_t(n),
+      ssize_t(n));
+  if (weight_scales.dim() == 2) {
+    const int64_t num_groups = weight_scales.size(1);
+    ET_CHECK_MSG(
+        num_groups > 0 && k % num_groups == 0 &&
+            (bits == 8 || (k / num_groups) % 2 == 0),
+        "%zd input features do not split into %zd groups%s",
+        ssize_t(k),
+        ssize_t(num_groups),
+        bits == 8 ? "" : " of even size");
+  }
+  if (opt_weight_zero_points.has_value()) {
+    ET_CHECK_MSG(
+        opt_weight_zero_points.value().scalar_type() == ScalarType::Float,
+        "weight_zero_points.scalar_type() %" PRId8 " is not Float",
+        static_cast<int8_t>(opt_weight_zero_points.value().scalar_type()));
+    ET_CHECK_MSG(
+        opt_weight_zero_points.value().numel() == weight_scales.numel(),
+        "weight_zero_points has %zd elements but weight_scales has %zd",
+        ssize_t(opt_weight_zero_points.value().numel()),
+        ssize_t(weight_scales.numel()));
+  }
+
+  const int64_t lo = bits == 8 ? INT8_MIN : -8;
+  const int64_t hi = bits == 8 ? UINT8_MAX : 7;
+  ET_CHECK_MSG(
+      weight_quant_min <= weight_quant_max && weight_quant_min >= lo &&
+          weight_quant_max <= hi,
+      "invalid weight quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for %" PRId64 "-bit values",
+      weight_quant_min,
+      weight_quant_max,
+      bits);
+
+  if (bias.has_value()) {
+    ET_CHECK_MSG(
+        bias.value().scalar_type() == ScalarType::Float,
+        "bias.scalar_type() %" PRId8 " is not Float",
+        static_cast<int8_t>(bias.value().scalar_type()));
+    ET_CHECK_MSG(
+        bias.value().numel() == n,
+        "Expected bias to have %zd elements received: %zd",
+        ssize_t(n),
+        ssize_t(bias.value().numel()));
+  }
+}
+
+void resize_out_tensor(const Tensor& in, int64_t n, Tensor& out) {
+  Tensor::SizesType out_sizes[kTensorDimensionLimit];
+  for (size_t i = 0; i < in.dim() - 1; ++i) {
+    out_sizes[i] = in.size(i);
+  }
+  out_sizes[in.dim() - 1] = n;
+  torch::executor::Error err =
+      resize_tensor(out, {out_sizes, static_cast<size_t>(in.dim())});
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in quantized linear");
+}
+
+/**
+ * out = in @ dequantize(weight).T + bias for float inputs of `k` features and
+ * `n` quantized weight rows. Each chunk of a weight row is dequantized once by
+ * `dequantize_chunk(row, begin, len, scale, zero_point, chunk)` and then
+ * multiplied with every input row, so that the weight, the bulk of the memory
+ * traffic, is only read in its quantized form.
+ */
+template <typename DequantizeChunk>
+void linear_groupwise(
+    const Tensor& in,
+    int64_t n,
+    int64_t k,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    const optional<Tensor>& bias,
+    Tensor& out,
+    const DequantizeChunk& dequantize_chunk) {
+  const int64_t m = getLeadingDims(in, in.dim() - 1);
+  const int64_t num_groups =
+      weight_scales.dim() == 2 ? weight_scales.size(1) : 1;
+  const int64_t group_size = k / num_groups;
+  const float* in_data = in.const_data_ptr<float>();
+  const float* scales = weight_scales.const_data_ptr<float>();
+  const float* zero_points = opt_weight_zero_points.has_value()
+      ? opt_weight_zero_points.value().const_data_ptr<float>()
+      : nullptr;
+  const float* bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<float>() : nullptr;
+  float* out_data = out.mutable_data_ptr<float>();
+
+  // Split the weight rows rather than the input rows, so that single-row
+  // inputs, e.g. while decoding, still use every thread.
+  parallel_for(
+      0, n, parallel_grain_size(m * k), [&](int64_t begin, int64_t end) {
+        float chunk[kChunkSize];
+        for (int64_t j = begin; j < end; ++j) {
+          for (int64_t i = 0; i < m; ++i) {
+            out_data[i * n + j] = bias_data != nullptr ? bias_data[j] : 0.0f;
+          }
+          for (int64_t g = 0; g < num_groups; ++g) {
+            const int64_t qparam = j * num_groups + g;
+            const float scale = scales[qparam];
+            const float zero_point =
+                zero_points != nullptr ? zero_points[qparam] : 0.0f;
+            for (int64_t c = 0; c < group_size; c += kChunkSize) {
+              const int64_t chunk_begin = g * group_size + c;
+              const int64_t len = std::min(kChunkSize, group_size - c);
+              dequantize_chunk(j, chunk_begin, len, scale, zero_point, chunk);
+              for (int64_t i = 0; i < m; ++i) {
+                out_data[i * n + j] += internal::dot_floats(
+                    in_data + i * k + chunk_begin, chunk, len);
+              }
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+/**
+ * Linear layer with float input and output and a weight quantized to 8 bits,
+ * out = input @ dequantize(weight).T + bias.
+ *
+ * weight is a uint8 or int8 [N, K]. weight_scales and weight_zero_points are
+ * either [N], or [N, num_groups] with a scale and zero_point for each group of
+ * K / num_groups consecutive values of a row. Without zero points, the values
+ * are symmetric. input is [..., K], bias, if any, is [N], and out is [..., N].
+ */
+Tensor& quantized_linear_byte_out(
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const optional<Tensor>& bias,
+    Tensor& out) {
+  ET_CHECK_MSG(
+      weight.scalar_type() == ScalarType::Byte ||
+          weight.scalar_type() == ScalarType::Char,
+      "weight.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(weight.scalar_type()));
+  ET_CHECK_MSG(weight.dim() == 2, "weight must be 2-D");
+  const int64_t k = weight.size(1);
+  check_linear_groupwise_args(
+      in,
+      weight,
+      k,
+      /*bits=*/8,
+      weight_scales,
+      opt_weight_zero_points,
+      weight_quant_min,
+      weight_quant_max,
+      bias,
+      out);
+  resize_out_tensor(in, weight.size(0), out);
+
+  ET_SWITCH_TWO_TYPES(
+      Byte, Char, weight.scalar_type(), nullptr, __func__, WEIGHT_T, [&] {
+        const WEIGHT_T* weight_data = weight.const_data_ptr<WEIGHT_T>();
+        linear_groupwise(
+            in,
+            weight.size(0),
+            k,
+            weight_scales,
+            opt_weight_zero_points,
+            bias,
+            out,
+            [&](int64_t row,
+                int64_t begin,
+                int64_t len,
+                float scale,
+                float zero_point,
+                float* chunk) {
+              internal::dequantize_to_floats(
+                  weight_data + row * k + begin, chunk, len, scale, zero_point);
+            });
+      });
+  return out;
+}
+
+/**
+ * Linear layer with float input and output and a weight quantized to 4 bits,
+ * out = input @ dequantize(weight).T + bias.
+ *
+ * weight holds signed 4-bit values packed two per byte, so it is a uint8
+ * [N, K / 2]: byte j of a row holds value 2j in its high nibble and value
+ * 2j + 1 in its low nibble, each stored with an offset of 8. The qparams,
+ * input, bias and out are as for quantized_linear_byte_out, with groups of an
+ * even size.
+ */
+Tensor& quantized_linear_4bit_out(
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const optional<Tensor>& bias,
+    Tensor& out) {
+  ET_CHECK_MSG(
+      weight.scalar_type() == ScalarType::Byte,
+      "weight.scalar_type() %" PRId8 " is not Byte",
+      static_cast<int8_t>(weight.scalar_type()));
+  ET_CHECK_MSG(weight.dim() == 2, "weight must be 2-D");
+  const int64_t packed_k = weight.size(1);
+  const int64_t k = packed_k * 2;
+  check_linear_groupwise_args(
+      in,
+      weight,
+      k,
+      /*bits=*/4,
+      weight_scales,
+      opt_weight_zero_points,
+      weight_quant_min,
+      weight_quant_max,
+      bias,
+      out);
+  resize_out_tensor(in, weight.size(0), out);
+
+  const uint8_t* weight_data = weight.const_data_ptr<uint8_t>();
+  linear_groupwise(
+      in,
+      weight.size(0),
+      k,
+      weight_scales,
+      opt_weight_zero_points,
+      bias,
+      out,
+      [&](int64_t row,
+          int64_t begin,
+          int64_t len,
+          float scale,
+          float zero_point,
+          float* chunk) {
+        internal::dequantize_4bit_to_floats(
+            weight_data + row * packed_k + begin / 2,
+            chunk,
+            len,
+            scale,
+            zero_point);
+      });
+  return out;
+}
+
+Tensor& quantized_linear_byte_out(
+    RuntimeContext& context,
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const optional<Tensor>& bias,
+    Tensor& out) {
+  (void)context;
+  return quantized_linear_byte_out(
+      in,
+      weight,
+      weight_scales,
+      opt_weight_zero_points,
+      weight_quant_min,
+      weight_quant_max,
+      bias,
+      out);
+}
+
+Tensor& quantized_linear_4bit_out(
+    RuntimeContext& context,
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& opt_weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const optional<Tensor>& bias,
+    Tensor& out) {
+  (void)context;
+  return quantized_linear_4bit_out(
+      in,
+      weight,
+      weight_scales,
+      opt_weight_zero_points,
+      weight_quant_min,
+      weight_quant_max,
+      bias,
+      out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
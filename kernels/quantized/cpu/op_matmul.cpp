@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+// Output columns accumulated at once. The int32 accumulators of a block stay
+// on the stack, and the matching slice of each row of b is contiguous.
+constexpr int64_t kColumnsPerBlock = 64;
+
+void check_quantized_matmul_args(
+    const Tensor& a,
+    int64_t a_zero_point,
+    const Tensor& b,
+    int64_t b_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    const Tensor& out) {
+  ET_CHECK_MSG(
+      a.scalar_type() == ScalarType::Byte ||
+          a.scalar_type() == ScalarType::Char,
+      "a.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(a.scalar_type()));
+  ET_CHECK_MSG(
+      b.scalar_type() == ScalarType::Byte ||
+          b.scalar_type() == ScalarType::Char,
+      "b.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(b.scalar_type()));
+  ET_CHECK_MSG(
+      out.scalar_type() == ScalarType::Byte ||
+          out.scalar_type() == ScalarType::Char,
+      "out.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(out.scalar_type()));
+  ET_CHECK_MSG(a.dim() >= 2, "a must have at least two dimensions");
+  ET_CHECK_MSG(
+      b.dim() == 2 || b.dim() == a.dim(),
+      "b must be 2-D or have as many dimensions as a, got %zd-D",
+      ssize_t(b.dim()));
+  ET_CHECK_MSG(
+      a.size(a.dim() - 1) == b.size(b.dim() - 2),
+      "a has %zd columns but b has %zd rows",
+      ssize_t(a.size(a.dim() - 1)),
+      ssize_t(b.size(b.dim() - 2)));
+  if (b.dim() > 2) {
+    for (size_t i = 0; i < a.dim() - 2; ++i) {
+      ET_CHECK_MSG(
+          a.size(i) == b.size(i),
+          "batch dim %zu of a (%zd) and b (%zd) differ",
+          i,
+          ssize_t(a.size(i)),
+          ssize_t(b.size(i)));
+    }
+  }
+  ET_CHECK_MSG(
+      a_zero_point >= -128 && a_zero_point <= 255 && b_zero_point >= -128 &&
+          b_zero_point <= 255,
+      "zero points %" PRId64 " and %" PRId64 " are out of the 8-bit range",
+      a_zero_point,
+      b_zero_point);
+  ET_CHECK_MSG(
+      out_quant_min <= out_quant_max &&
+          out_quant_min >=
+              (out.scalar_type() == ScalarType::Byte ? 0 : INT8_MIN) &&
+          out_quant_max <=
+              (out.scalar_type() == ScalarType::Byte ? UINT8_MAX : INT8_MAX),
+      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for the output dtype",
+      out_quant_min,
+      out_quant_max);
+}
+
+/**
+ * Computes the columns [n0, n1) of one output row, a_row @ b, where a_row has
+ * `k` elements and b is [k, n]. Each row of a and b is walked contiguously,
+ * accumulating scaled rows of b into int32 sums.
+ */
+template <typename A_T, typename B_T, typename OUT_T>
+void quantized_matmul_row_block(
+    const A_T* a_row,
+    int32_t a_zero_point,
+    const B_T* b,
+    int32_t b_zero_point,
+    float acc_scale,
+    float out_inv_scale,
+    int32_t out_zero_point,
+    int32_t out_quant_min,
+    int32_t out_quant_max,
+    OUT_T* out_row,
+    int64_t n,
+    int64_t k,
+    int64_t n0,
+    int64_t n1) {
+  int32_t acc[kColumnsPerBlock] = {};
+  const int64_t width = n1 - n0;
+  for (int64_t l = 0; l < k; ++l) {
+    const int32_t a_value = static_cast<int32_t>(a_row[l]) - a_zero_point;
+    if (a_value == 0) {
+      continue;
+    }
+    const B_T* b_row = b + l * n + n0;
+    for (int64_t j = 0; j < width; ++j) {
+      acc[j] += a_value * (static_cast<int32_t>(b_row[j]) - b_zero_point);
+    }
+  }
+  for (int64_t j = 0; j < width; ++j) {
+    out_row[n0 + j] = internal::quantize_float<OUT_T>(
+        static_cast<float>(acc[j]) * acc_scale,
+        out_inv_scale,
+        out_zero_point,
+        out_quant_min,
+        out_quant_max);
+  }
+}
+
+} // namespace
+
+/**
+ * Quantized matrix product, out = quantize(dequantize(a) @ dequantize(b)),
+ * with per-tensor quantization of both operands and of the output. Products
+ * are accumulated in int32 and requantized directly, without materializing
+ * the dequantized operands.
+ *
+ * a is [..., M, K] and b is either [K, N], shared by every matrix of a, or
+ * [..., K, N] with the same leading dims as a. out is [..., M, N]. Each of
+ * them may be uint8 or int8.
+ */
+Tensor& quantized_matmul_out(
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    const Tensor& b,
+    double b_scale,
+    int64_t b_zero_point,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  check_quantized_matmul_args(
+      a,
+      a_zero_point,
+      b,
+      b_zero_point,
+      out_quant_min,
+      out_quant_max,
+      out);
+
+  Tensor::SizesType out_sizes[kTensorDimensionLimit];
+  for (size_t i = 0; i < a.dim() - 1; ++i) {
+    out_sizes[i] = a.size(i);
+  }
+  out_sizes[a.dim() - 1] = b.size(b.dim() - 1);
+  torch::executor::Error err =
+      resize_tensor(out, {out_sizes, static_cast<size_t>(a.dim())});
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in quantized_matmul_out");
+
+  const int64_t m = a.size(a.dim() - 2);
+  const int64_t k = a.size(a.dim() - 1);
+  const int64_t n = b.size(b.dim() - 1);
+  const int64_t rows = getLeadingDims(a, a.dim() - 1);
+  // Each task is one block of columns of one output row.
+  const int64_t blocks_per_row = (n + kColumnsPerBlock - 1) / kColumnsPerBlock;
+  // b is shared by every matrix of a when it is 2-D.
+  const int64_t b_matrix_stride = b.dim() == 2 ? 0 : k * n;
+  const float acc_scale =
+      static_cast<float>(a_scale) * static_cast<float>(b_scale);
+  const float out_inv_scale = 1.0f / static_cast<float>(out_scale);
+
+  ET_SWITCH_TWO_TYPES(
+      Byte, Char, a.scalar_type(), nullptr, __func__, A_T, [&] {
+        ET_SWITCH_TWO_TYPES(
+            Byte, Char, b.scalar_type(), nullptr, __func__, B_T, [&] {
+              ET_SWITCH_TWO_TYPES(
+                  Byte, Char, out.scalar_type(), nullptr, __func__, OUT_T, [&] {
+                    const A_T* a_data = a.const_data_ptr<A_T>();
+                    const B_T* b_data = b.const_data_ptr<B_T>();
+                    OUT_T* out_data = out.mutable_data_ptr<OUT_T>();
+                    parallel_for(
+                        0,
+                        rows * blocks_per_row,
+                        parallel_grain_size(k * kColumnsPerBlock),
+                        [&](int64_t begin, int64_t end) {
+                          for (int64_t task = begin; task < end; ++task) {
+                            const int64_t row = task / blocks_per_row;
+                            const int64_t n0 =
+                                (task % blocks_per_row) * kColumnsPerBlock;
+                            quantized_matmul_row_block<A_T, B_T, OUT_T>(
+                                a_data + row * k,
+                                static_cast<int32_t>(a_zero_point),
+                                b_data + (row / m) * b_matrix_stride,
+                                static_cast<int32_t>(b_zero_point),
+                                acc_scale,
+                                out_inv_scale,
+                                static_cast<int32_t>(out_zero_point),
+                                static_cast<int32_t>(out_quant_min),
+                                static_cast<int32_t>(out_quant_max),
+                                out_data + row * n,
+                                n,
+                                k,
+                                n0,
+                                std::min(n, n0 + kColumnsPerBlock));
+                          }
+                        });
+                  });
+            });
+      });
+
+  return out;
+}
+
+Tensor& quantized_matmul_out(
+    RuntimeContext& context,
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    const Tensor& b,
+    double b_scale,
+    int64_t b_zero_point,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  (void)context;
+  return quantized_matmul_out(
+      a,
+      a_scale,
+      a_zero_point,
+      b,
+      b_scale,
+      b_zero_point,
+      out_scale,
+      out_zero_point,
+      out_quant_min,
+      out_quant_max,
+      out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+// Elements multiplied and requantized at once.
+constexpr int64_t kMulChunkSize = 256;
+
+void check_quant_range(
+    const char* name,
+    ScalarType dtype,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  const int64_t lo = dtype == ScalarType::Byte ? 0 : INT8_MIN;
+  const int64_t hi = dtype == ScalarType::Byte ? UINT8_MAX : INT8_MAX;
+  ET_CHECK_MSG(
+      quant_min >= lo && quant_max <= hi && quant_min <= quant_max,
+      "invalid quant_min: %" PRId64 " or quant_max: %" PRId64
+      " for tensor %s. Min should be <= max and both should be in the range "
+      "of its dtype",
+      quant_min,
+      quant_max,
+      name);
+  ET_CHECK_MSG(
+      zero_point >= -128 && zero_point <= 255,
+      "zero point %" PRId64 " of tensor %s is out of the 8-bit range",
+      zero_point,
+      name);
+}
+
+/**
+ * Multiplies the zero point adjusted values of a and b in int32, which is
+ * exact for 8-bit values, and requantizes the products with the combined
+ * scale a_scale * b_scale / out_scale.
+ */
+template <typename CTYPE>
+void mul_tensors(
+    const Tensor& a,
+    int32_t a_zero_point,
+    const Tensor& b,
+    int32_t b_zero_point,
+    float acc_scale,
+    float out_inv_scale,
+    int32_t out_zero_point,
+    int32_t out_quant_min,
+    int32_t out_quant_max,
+    Tensor& out) {
+  const CTYPE* data_a = a.const_data_ptr<CTYPE>();
+  const CTYPE* data_b = b.const_data_ptr<CTYPE>();
+  CTYPE* data_out = out.mutable_data_ptr<CTYPE>();
+
+  parallel_for(
+      0,
+      a.numel(),
+      parallel_grain_size(kMulChunkSize),
+      [&](int64_t begin, int64_t end) {
+        float products[kMulChunkSize];
+        for (int64_t i = begin; i < end; i += kMulChunkSize) {
+          const int64_t len = std::min(kMulChunkSize, end - i);
+          for (int64_t j = 0; j < len; ++j) {
+            const int32_t product =
+                (static_cast<int32_t>(data_a[i + j]) - a_zero_point) *
+                (static_cast<int32_t>(data_b[i + j]) - b_zero_point);
+            products[j] = static_cast<float>(product) * acc_scale;
+          }
+          internal::quantize_floats(
+              products,
+              data_out + i,
+              len,
+              out_inv_scale,
+              out_zero_point,
+              out_quant_min,
+              out_quant_max);
+        }
+      });
+}
+
+} // namespace
+
+/**
+ * Performs element wise multiplication of the input tensors into out. Should
+ * be numerically equivalent to Dq -> fp mul -> Q, up to the rounding of the
+ * scales.
+ *
+ * PREREQ: a, b and out should be the same shape and dtype, either uint8 or
+ * int8, and each quant_min and quant_max should be in the range of that dtype.
+ */
+Tensor& quantized_mul_out(
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    int64_t a_quant_min,
+    int64_t a_quant_max,
+    const Tensor& b,
+    double b_scale,
+    int64_t b_zero_point,
+    int64_t b_quant_min,
+    int64_t b_quant_max,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  ET_CHECK_SAME_SHAPE_AND_DTYPE3(a, b, out);
+  ET_CHECK_MSG(
+      a.scalar_type() == ScalarType::Byte ||
+          a.scalar_type() == ScalarType::Char,
+      "a.scalar_type() %" PRId8 " is not Byte or Char",
+      static_cast<int8_t>(a.scalar_type()));
+  check_quant_range(
+      "a", a.scalar_type(), a_zero_point, a_quant_min, a_quant_max);
+  check_quant_range(
+      "b", b.scalar_type(), b_zero_point, b_quant_min, b_quant_max);
+  check_quant_range(
+      "out", out.scalar_type(), out_zero_point, out_quant_min, out_quant_max);
+
+  // downsize to maintain numerical consistency with fbgemm
+  const float acc_scale =
+      static_cast<float>(a_scale) * static_cast<float>(b_scale);
+  const float out_inv_scale = 1.0f / static_cast<float>(out_scale);
+
+  ET_SWITCH_TWO_TYPES(
+      Byte, Char, a.scalar_type(), nullptr, __func__, CTYPE, [&] {
+        mul_tensors<CTYPE>(
+            a,
+            static_cast<int32_t>(a_zero_point),
+            b,
+            static_cast<int32_t>(b_zero_point),
+            acc_scale,
+            out_inv_scale,
+            static_cast<int32_t>(out_zero_point),
+            static_cast<int32_t>(out_quant_min),
+            static_cast<int32_t>(out_quant_max),
+            out);
+      });
+
+  return out;
+}
+
+Tensor& quantized_mul_out(
+    RuntimeContext& context,
+    const Tensor& a,
+    double a_scale,
+    int64_t a_zero_point,
+    int64_t a_quant_min,
+    int64_t a_quant_max,
+    const Tensor& b,
+    double b_scale,
+    int64_t b_zero_point,
+    int64_t b_quant_min,
+    int64_t b_quant_max,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    Tensor& out) {
+  (void)context;
+  return quantized_mul_out(
+      a,
+      a_scale,
+      a_zero_point,
+      a_quant_min,
+      a_quant_max,
+      b,
+      b_scale,
+      b_zero_point,
+      b_quant_min,
+      b_quant_max,
+      out_scale,
+      out_zero_point,
+      out_quant_min,
+      out_quant_max,
+      out);
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
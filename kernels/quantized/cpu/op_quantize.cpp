@@ -6,7 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/quantized/cpu/quantize_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
@@ -101,6 +103,64 @@ T quantize_val(
   return static_cast<T>(qvalue);
 }
 
+namespace {
+
+template <typename IN_CTYPE, typename OUT_CTYPE>
+void quantize_values(
+    const IN_CTYPE* in,
+    OUT_CTYPE* out,
+    int64_t n,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = quantize_val<OUT_CTYPE, IN_CTYPE>(
+        scale, zero_point, in[i], quant_min, quant_max);
+  }
+}
+
+// The float to 8-bit conversions are vectorized.
+template <>
+void quantize_values<float, uint8_t>(
+    const float* in,
+    uint8_t* out,
+    int64_t n,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  internal::quantize_floats(
+      in,
+      out,
+      n,
+      1.0f / static_cast<float>(scale),
+      static_cast<int32_t>(zero_point),
+      static_cast<int32_t>(quant_min),
+      static_cast<int32_t>(quant_max));
+}
+
+template <>
+void quantize_values<float, int8_t>(
+    const float* in,
+    int8_t* out,
+    int64_t n,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  internal::quantize_floats(
+      in,
+      out,
+      n,
+      1.0f / static_cast<float>(scale),
+      static_cast<int32_t>(zero_point),
+      static_cast<int32_t>(quant_min),
+      static_cast<int32_t>(quant_max));
+}
+
+} // namespace
+
 Tensor& quantize_per_tensor_out(
     const Tensor& input,
     double scale,
@@ -117,14 +177,25 @@ Tensor& quantize_per_tensor_out(
   check_quantize_per_tensor_args(input, quant_min, quant_max, dtype, out);
 
   // calculate the quantized input
-#define QUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)                   \
-  case ScalarType::out_dtype:                                           \
-    for (size_t i = 0; i < input.numel(); i++) {                        \
-      IN_CTYPE value = input.data_ptr<IN_CTYPE>()[i];                   \
-      out.data_ptr<OUT_CTYPE>()[i] = quantize_val<OUT_CTYPE, IN_CTYPE>( \
-          scale, zero_point, value, quant_min, quant_max);              \
-    }                                                                   \
-    break;
+#define QUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)           \
+  case ScalarType::out_dtype: {                                 \
+    const IN_CTYPE* in_data = input.const_data_ptr<IN_CTYPE>(); \
+    OUT_CTYPE* out_data = out.mutable_data_ptr<OUT_CTYPE>();    \
+    parallel_for(                                               \
+        0,                                                      \
+        input.numel(),                                          \
+        parallel_grain_size(1),                                 \
+        [&](int64_t begin, int64_t end) {                       \
+          quantize_values<IN_CTYPE, OUT_CTYPE>(                 \
+              in_data + begin,                                  \
+              out_data + begin,                                 \
+              end - begin,                                      \
+              scale,                                            \
+              zero_point,                                       \
+              quant_min,                                        \
+              quant_max);                                       \
+        });                                                     \
+  } break;
 #define CALCULATE_FLOAT_TYPE(IN_CTYPE, in_dtype)         \
   case ScalarType::in_dtype:                             \
     switch (out.scalar_type()) {                         \
@@ -186,6 +257,107 @@ Tensor& quantize_per_tensor_tensor_args_out(
   return out;
 }
 
+/**
+ * Quantizes the input tensor with a scale and zero point per slice of it along
+ * `axis`.
+ */
+Tensor& quantize_per_channel_out(
+    const Tensor& input,
+    const Tensor& scale,
+    const Tensor& zero_point,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max,
+    ScalarType dtype,
+    Tensor& out) {
+  torch::executor::Error err = resize_tensor(out, input.sizes());
+  ET_CHECK_MSG(
+      err == torch::executor::Error::Ok,
+      "Failed to resize out Tensor in quantize_per_channel_out");
+
+  if (axis < 0) {
+    axis += input.dim();
+  }
+  ET_CHECK_MSG(
+      axis >= 0 && axis < input.dim(),
+      "axis %" PRId64 " is out of range for a %zd-D input",
+      axis,
+      ssize_t(input.dim()));
+  ET_CHECK_MSG(
+      scale.scalar_type() == ScalarType::Double,
+      "Expected scale to be Double tensor received: %" PRId8,
+      static_cast<int8_t>(scale.scalar_type()));
+  ET_CHECK_MSG(
+      zero_point.scalar_type() == ScalarType::Long,
+      "Expected zero_point to be Long tensor received: %" PRId8,
+      static_cast<int8_t>(zero_point.scalar_type()));
+  ET_CHECK_MSG(
+      scale.numel() == input.size(axis),
+      "Expected scale to have %zd elements received: %zd",
+      ssize_t(input.size(axis)),
+      ssize_t(scale.numel()));
+  ET_CHECK_MSG(
+      zero_point.numel() == input.size(axis),
+      "Expected zero_point to have %zd elements received: %zd",
+      ssize_t(input.size(axis)),
+      ssize_t(zero_point.numel()));
+
+  check_quantize_per_tensor_args(input, quant_min, quant_max, dtype, out);
+
+  const double* scale_data = scale.const_data_ptr<double>();
+  const int64_t* zero_point_data = zero_point.const_data_ptr<int64_t>();
+  const int64_t channels = input.size(axis);
+  const int64_t inner_size = getTrailingDims(input, axis);
+  const int64_t num_rows = getLeadingDims(input, axis) * channels;
+
+  // Each row of inner_size elements has a single scale and zero point.
+#define QUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)           \
+  case ScalarType::out_dtype: {                                 \
+    const IN_CTYPE* in_data = input.const_data_ptr<IN_CTYPE>(); \
+    OUT_CTYPE* out_data = out.mutable_data_ptr<OUT_CTYPE>();    \
+    parallel_for(                                               \
+        0,                                                      \
+        num_rows,                                               \
+        parallel_grain_size(inner_size),                        \
+        [&](int64_t begin, int64_t end) {                       \
+          for (int64_t row = begin; row < end; row++) {         \
+            const int64_t channel = row % channels;             \
+            quantize_values<IN_CTYPE, OUT_CTYPE>(               \
+                in_data + row * inner_size,                     \
+                out_data + row * inner_size,                    \
+                inner_size,                                     \
+                scale_data[channel],                            \
+                zero_point_data[channel],                       \
+                quant_min,                                      \
+                quant_max);                                     \
+          }                                                     \
+        });                                                     \
+  } break;
+#define CALCULATE_FLOAT_TYPE(IN_CTYPE, in_dtype)         \
+  case ScalarType::in_dtype:                             \
+    switch (out.scalar_type()) {                         \
+      ET_FORALL_INT_TYPES_WITH(IN_CTYPE, QUANTIZE_IMPL); \
+      default:                                           \
+        ET_CHECK_MSG(                                    \
+            false,                                       \
+            "Unhandled output dtype %" PRId8,            \
+            static_cast<int8_t>(out.scalar_type()));     \
+    }                                                    \
+    break;
+
+  switch (input.scalar_type()) {
+    ET_FORALL_FLOAT_TYPES(CALCULATE_FLOAT_TYPE);
+    default:
+      ET_CHECK_MSG(
+          false,
+          "Unhandled input dtype %" PRId8,
+          static_cast<int8_t>(input.scalar_type()));
+  }
+#undef CALCULATE_FLOAT_TYPE
+#undef QUANTIZE_IMPL
+  return out;
+}
+
 Tensor& quantize_per_tensor_out(
     RuntimeContext& context,
 
@@ -219,6 +391,21 @@ Tensor& quantize_per_tensor_tensor_args_out(
       input, scale, zero_point, quant_min, quant_max, dtype, out);
 }
 
+Tensor& quantize_per_channel_out(
+    RuntimeContext& context,
+    const Tensor& input,
+    const Tensor& scale,
+    const Tensor& zero_point,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max,
+    ScalarType dtype,
+    Tensor& out) {
+  (void)context;
+  return quantize_per_channel_out(
+      input, scale, zero_point, axis, quant_min, quant_max, dtype, out);
+}
+
 } // namespace native
 } // namespace executor
 } // namespace torch
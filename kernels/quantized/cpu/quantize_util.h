@@ -0,0 +1,619 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Conversions between float and 8-bit quantized values, vectorized with NEON
+// on aarch64 and with AVX2 when the kernels are built with it. They follow the
+// formulas of quantize_val() in op_quantize.cpp and of op_dequantize.cpp:
+// float products, rounding half to even, and clamping to [quant_min,
+// quant_max]. Values too large for an int64, including infinities, saturate,
+// and NaN becomes quant_min, whatever the path and platform.
+//
+// Also holds the int32-accumulated dot product of the quantized matmul
+// kernels, the float zero point dequantization of embedding_byte, the packed
+// 4-bit weights of the group-wise quantized ops, and the qparams that
+// choose_qparams and the dynamically quantized ops derive from a float range.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ET_QUANTIZE_USE_NEON 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define ET_QUANTIZE_USE_AVX2 1
+#endif
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace internal {
+
+template <typename T>
+inline T quantize_float(
+    float value,
+    float inv_scale,
+    int32_t zero_point,
+    int32_t quant_min,
+    int32_t quant_max) {
+  // Clamped before rounding like the vectorized loops below; written so that
+  // NaN ends up at the lower bound.
+  const float lo = static_cast<float>(quant_min - zero_point);
+  const float hi = static_cast<float>(quant_max - zero_point);
+  float x = inv_scale * value;
+  x = lo < x ? x : lo;
+  x = x < hi ? x : hi;
+  return static_cast<T>(zero_point + static_cast<int32_t>(std::nearbyint(x)));
+}
+
+#if defined(ET_QUANTIZE_USE_NEON)
+
+// Quantizes 16 floats, clamped to [lo, hi] before rounding; lo and hi are
+// quant_min and quant_max minus the zero point. Since both are integers,
+// clamping first gives the same result as clamping the rounded value, and
+// keeps the conversion to int32 in range. vmaxnmq returns lo for NaN.
+inline int16x8x2_t quantize_16_neon(
+    const float* in,
+    float32x4_t inv_scale,
+    float32x4_t lo,
+    float32x4_t hi,
+    int32x4_t zero_point) {
+  int32x4_t q[4];
+  for (int i = 0; i < 4; ++i) {
+    const float32x4_t x = vminq_f32(
+        vmaxnmq_f32(vmulq_f32(vld1q_f32(in + 4 * i), inv_scale), lo), hi);
+    // vcvtnq rounds to nearest, ties to even.
+    q[i] = vaddq_s32(vcvtnq_s32_f32(x), zero_point);
+  }
+  int16x8x2_t r;
+  r.val[0] = vcombine_s16(vqmovn_s32(q[0]), vqmovn_s32(q[1]));
+  r.val[1] = vcombine_s16(vqmovn_s32(q[2]), vqmovn_s32(q[3]));
+  return r;
+}
+
+#elif defined(ET_QUANTIZE_USE_AVX2)
+
+// Like quantize_16_neon, for 32 floats. Returns them as int16, in the lane
+// order that _mm256_packs_epi32 leaves them in; see quantize_unshuffle_avx2.
+inline void quantize_32_avx2(
+    const float* in,
+    __m256 inv_scale,
+    __m256 lo,
+    __m256 hi,
+    __m256i zero_point,
+    __m256i* q01,
+    __m256i* q23) {
+  __m256i q[4];
+  for (int i = 0; i < 4; ++i) {
+    // _mm256_max_ps returns its second operand, lo, for NaN.
+    const __m256 x = _mm256_min_ps(
+        _mm256_max_ps(
+            _mm256_mul_ps(_mm256_loadu_ps(in + 8 * i), inv_scale), lo),
+        hi);
+    // Rounds to nearest, ties to even, under the default MXCSR mode.
+    q[i] = _mm256_add_epi32(_mm256_cvtps_epi32(x), zero_point);
+  }
+  *q01 = _mm256_packs_epi32(q[0], q[1]);
+  *q23 = _mm256_packs_epi32(q[2], q[3]);
+}
+
+// Undoes the lane interleaving of _mm256_packs_epi32 and _mm256_packs_epi16.
+inline __m256i quantize_unshuffle_avx2(__m256i packed) {
+  return _mm256_permutevar8x32_epi32(
+      packed, _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0));
+}
+
+#endif
+
+/**
+ * out[i] = clamp(round(in[i] * inv_scale) + zero_point, quant_min, quant_max)
+ * for `n` floats, with T either uint8_t or int8_t.
+ */
+template <typename T>
+inline void quantize_floats(
+    const float* in,
+    T* out,
+    int64_t n,
+    float inv_scale,
+    int32_t zero_point,
+    int32_t quant_min,
+    int32_t quant_max) {
+  static_assert(
+      std::is_same<T, uint8_t>::value || std::is_same<T, int8_t>::value,
+      "Only 8-bit outputs are vectorized");
+  int64_t i = 0;
+#if defined(ET_QUANTIZE_USE_NEON)
+  const float32x4_t inv_scale_v = vdupq_n_f32(inv_scale);
+  const float32x4_t lo =
+      vdupq_n_f32(static_cast<float>(quant_min - zero_point));
+  const float32x4_t hi =
+      vdupq_n_f32(static_cast<float>(quant_max - zero_point));
+  const int32x4_t zero_point_v = vdupq_n_s32(zero_point);
+  for (; i + 16 <= n; i += 16) {
+    const int16x8x2_t q =
+        quantize_16_neon(in + i, inv_scale_v, lo, hi, zero_point_v);
+    if (std::is_same<T, uint8_t>::value) {
+      vst1q_u8(
+          reinterpret_cast<uint8_t*>(out + i),
+          vcombine_u8(vqmovun_s16(q.val[0]), vqmovun_s16(q.val[1])));
+    } else {
+      vst1q_s8(
+          reinterpret_cast<int8_t*>(out + i),
+          vcombine_s8(vqmovn_s16(q.val[0]), vqmovn_s16(q.val[1])));
+    }
+  }
+#elif defined(ET_QUANTIZE_USE_AVX2)
+  const __m256 inv_scale_v = _mm256_set1_ps(inv_scale);
+  const __m256 lo = _mm256_set1_ps(static_cast<float>(quant_min - zero_point));
+  const __m256 hi = _mm256_set1_ps(static_cast<float>(quant_max - zero_point));
+  const __m256i zero_point_v = _mm256_set1_epi32(zero_point);
+  for (; i + 32 <= n; i += 32) {
+    __m256i q01, q23;
+    quantize_32_avx2(in + i, inv_scale_v, lo, hi, zero_point_v, &q01, &q23);
+    const __m256i packed = std::is_same<T, uint8_t>::value
+        ? _mm256_packus_epi16(q01, q23)
+        : _mm256_packs_epi16(q01, q23);
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(out + i), quantize_unshuffle_avx2(packed));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] =
+        quantize_float<T>(in[i], inv_scale, zero_point, quant_min, quant_max);
+  }
+}
+
+/**
+ * out[i] = (in[i] - zero_point) * scale for `n` values, with T either uint8_t
+ * or int8_t.
+ */
+template <typename T>
+inline void dequantize_to_floats(
+    const T* in,
+    float* out,
+    int64_t n,
+    float scale,
+    int32_t zero_point) {
+  static_assert(
+      std::is_same<T, uint8_t>::value || std::is_same<T, int8_t>::value,
+      "Only 8-bit inputs are vectorized");
+  int64_t i = 0;
+#if defined(ET_QUANTIZE_USE_NEON)
+  const float32x4_t scale_v = vdupq_n_f32(scale);
+  const int32x4_t zero_point_v = vdupq_n_s32(zero_point);
+  for (; i + 16 <= n; i += 16) {
+    int16x8_t wide[2];
+    if (std::is_same<T, uint8_t>::value) {
+      const uint8x16_t q = vld1q_u8(reinterpret_cast<const uint8_t*>(in + i));
+      wide[0] = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(q)));
+      wide[1] = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(q)));
+    } else {
+      const int8x16_t q = vld1q_s8(reinterpret_cast<const int8_t*>(in + i));
+      wide[0] = vmovl_s8(vget_low_s8(q));
+      wide[1] = vmovl_s8(vget_high_s8(q));
+    }
+    for (int j = 0; j < 2; ++j) {
+      const int32x4_t a =
+          vsubq_s32(vmovl_s16(vget_low_s16(wide[j])), zero_point_v);
+      const int32x4_t b =
+          vsubq_s32(vmovl_s16(vget_high_s16(wide[j])), zero_point_v);
+      vst1q_f32(out + i + 8 * j, vmulq_f32(vcvtq_f32_s32(a), scale_v));
+      vst1q_f32(out + i + 8 * j + 4, vmulq_f32(vcvtq_f32_s32(b), scale_v));
+    }
+  }
+#elif defined(ET_QUANTIZE_USE_AVX2)
+  const __m256 scale_v = _mm256_set1_ps(scale);
+  const __m256i zero_point_v = _mm256_set1_epi32(zero_point);
+  for (; i + 8 <= n; i += 8) {
+    const __m128i q =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i));
+    const __m256i wide = std::is_same<T, uint8_t>::value
+        ? _mm256_cvtepu8_epi32(q)
+        : _mm256_cvtepi8_epi32(q);
+    _mm256_storeu_ps(
+        out + i,
+        _mm256_mul_ps(
+            _mm256_cvtepi32_ps(_mm256_sub_epi32(wide, zero_point_v)),
+            scale_v));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = static_cast<float>(in[i] - zero_point) * scale;
+  }
+}
+
+/**
+ * out[i] = (in[i] - zero_point) * scale for `n` values with a float zero
+ * point, as used by embedding_byte, with T either uint8_t or int8_t.
+ */
+template <typename T>
+inline void dequantize_to_floats(
+    const T* in,
+    float* out,
+    int64_t n,
+    float scale,
+    float zero_point) {
+  static_assert(
+      std::is_same<T, uint8_t>::value || std::is_same<T, int8_t>::value,
+      "Only 8-bit inputs are vectorized");
+  int64_t i = 0;
+#if defined(ET_QUANTIZE_USE_NEON)
+  const float32x4_t scale_v = vdupq_n_f32(scale);
+  const float32x4_t zero_point_v = vdupq_n_f32(zero_point);
+  for (; i + 8 <= n; i += 8) {
+    int16x8_t wide;
+    if (std::is_same<T, uint8_t>::value) {
+      wide = vreinterpretq_s16_u16(
+          vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t*>(in + i))));
+    } else {
+      wide = vmovl_s8(vld1_s8(reinterpret_cast<const int8_t*>(in + i)));
+    }
+    const float32x4_t a = vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide)));
+    const float32x4_t b = vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide)));
+    vst1q_f32(out + i, vmulq_f32(vsubq_f32(a, zero_point_v), scale_v));
+    vst1q_f32(out + i + 4, vmulq_f32(vsubq_f32(b, zero_point_v), scale_v));
+  }
+#elif defined(ET_QUANTIZE_USE_AVX2)
+  const __m256 scale_v = _mm256_set1_ps(scale);
+  const __m256 zero_point_v = _mm256_set1_ps(zero_point);
+  for (; i + 8 <= n; i += 8) {
+    const __m128i q =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i));
+    const __m256i wide = std::is_same<T, uint8_t>::value
+        ? _mm256_cvtepu8_epi32(q)
+        : _mm256_cvtepi8_epi32(q);
+    _mm256_storeu_ps(
+        out + i,
+        _mm256_mul_ps(
+            _mm256_sub_ps(_mm256_cvtepi32_ps(wide), zero_point_v), scale_v));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = (static_cast<float>(in[i]) - zero_point) * scale;
+  }
+}
+
+/**
+ * Returns the signed 4-bit value `j` of `packed`. Each byte holds two values
+ * stored with an offset of 8, the even one in the high nibble.
+ */
+inline int32_t get_4bit(const uint8_t* packed, int64_t j) {
+  const uint8_t byte = packed[j / 2];
+  return static_cast<int32_t>(j % 2 == 0 ? byte >> 4 : byte & 0x0F) - 8;
+}
+
+/**
+ * out[i] = (get_4bit(packed, i) - zero_point) * scale for an even number `n`
+ * of values.
+ */
+inline void dequantize_4bit_to_floats(
+    const uint8_t* packed,
+    float* out,
+    int64_t n,
+    float scale,
+    float zero_point) {
+  int64_t i = 0;
+#if defined(ET_QUANTIZE_USE_NEON)
+  const float32x4_t scale_v = vdupq_n_f32(scale);
+  const float32x4_t zero_point_v = vdupq_n_f32(zero_point);
+  const int16x8_t offset = vdupq_n_s16(8);
+  for (; i + 16 <= n; i += 16) {
+    const uint8x8_t bytes = vld1_u8(packed + i / 2);
+    const uint8x8x2_t values =
+        vzip_u8(vshr_n_u8(bytes, 4), vand_u8(bytes, vdup_n_u8(0x0F)));
+    for (int j = 0; j < 2; ++j) {
+      const int16x8_t wide =
+          vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(values.val[j])), offset);
+      const float32x4_t a = vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide)));
+      const float32x4_t b = vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide)));
+      vst1q_f32(
+          out + i + 8 * j, vmulq_f32(vsubq_f32(a, zero_point_v), scale_v));
+      vst1q_f32(
+          out + i + 8 * j + 4,
+          vmulq_f32(vsubq_f32(b, zero_point_v), scale_v));
+    }
+  }
+#elif defined(ET_QUANTIZE_USE_AVX2)
+  const __m256 scale_v = _mm256_set1_ps(scale);
+  const __m256 zero_point_v = _mm256_set1_ps(zero_point);
+  const __m256i offset = _mm256_set1_epi32(8);
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  for (; i + 16 <= n; i += 16) {
+    const __m128i bytes =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(packed + i / 2));
+    const __m128i values = _mm_unpacklo_epi8(
+        _mm_and_si128(_mm_srli_epi16(bytes, 4), mask),
+        _mm_and_si128(bytes, mask));
+    const __m128i halves[2] = {values, _mm_srli_si128(values, 8)};
+    for (int j = 0; j < 2; ++j) {
+      const __m256i wide =
+          _mm256_sub_epi32(_mm256_cvtepu8_epi32(halves[j]), offset);
+      _mm256_storeu_ps(
+          out + i + 8 * j,
+          _mm256_mul_ps(
+              _mm256_sub_ps(_mm256_cvtepi32_ps(wide), zero_point_v),
+              scale_v));
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = (static_cast<float>(get_4bit(packed, i)) - zero_point) * scale;
+  }
+}
+
+/**
+ * Sets `*min` and `*max` to the smallest and largest of `n` floats, with n > 0,
+ * in a single pass. How NaN is ordered depends on the path taken.
+ */
+inline void float_range(const float* in, int64_t n, float* min, float* max) {
+  int64_t i = 0;
+  float lo = in[0];
+  float hi = in[0];
+#if defined(ET_QUANTIZE_USE_NEON)
+  if (n >= 8) {
+    float32x4_t lo0 = vld1q_f32(in);
+    float32x4_t lo1 = vld1q_f32(in + 4);
+    float32x4_t hi0 = lo0;
+    float32x4_t hi1 = lo1;
+    for (i = 8; i + 8 <= n; i += 8) {
+      const float32x4_t a = vld1q_f32(in + i);
+      const float32x4_t b = vld1q_f32(in + i + 4);
+      lo0 = vminq_f32(lo0, a);
+      lo1 = vminq_f32(lo1, b);
+      hi0 = vmaxq_f32(hi0, a);
+      hi1 = vmaxq_f32(hi1, b);
+    }
+    lo = vminvq_f32(vminq_f32(lo0, lo1));
+    hi = vmaxvq_f32(vmaxq_f32(hi0, hi1));
+  }
+#elif defined(ET_QUANTIZE_USE_AVX2)
+  if (n >= 16) {
+    __m256 lo0 = _mm256_loadu_ps(in);
+    __m256 lo1 = _mm256_loadu_ps(in + 8);
+    __m256 hi0 = lo0;
+    __m256 hi1 = lo1;
+    for (i = 16; i + 16 <= n; i += 16) {
+      const __m256 a = _mm256_loadu_ps(in + i);
+      const __m256 b = _mm256_loadu_ps(in + i + 8);
+      lo0 = _mm256_min_ps(lo0, a);
+      lo1 = _mm256_min_ps(lo1, b);
+      hi0 = _mm256_max_ps(hi0, a);
+      hi1 = _mm256_max_ps(hi1, b);
+    }
+    const __m256 lo8 = _mm256_min_ps(lo0, lo1);
+    const __m256 hi8 = _mm256_max_ps(hi0, hi1);
+    __m128 lo4 = _mm_min_ps(
+        _mm256_castps256_ps128(lo8), _mm256_extractf128_ps(lo8, 1));
+    __m128 hi4 = _mm_max_ps(
+        _mm256_castps256_ps128(hi8), _mm256_extractf128_ps(hi8, 1));
+    lo4 = _mm_min_ps(lo4, _mm_movehl_ps(lo4, lo4));
+    hi4 = _mm_max_ps(hi4, _mm_movehl_ps(hi4, hi4));
+    lo4 = _mm_min_ss(lo4, _mm_shuffle_ps(lo4, lo4, 1));
+    hi4 = _mm_max_ss(hi4, _mm_shuffle_ps(hi4, hi4, 1));
+    lo = _mm_cvtss_f32(lo4);
+    hi = _mm_cvtss_f32(hi4);
+  }
+#endif
+  for (; i < n; ++i) {
+    lo = std::min(lo, in[i]);
+    hi = std::max(hi, in[i]);
+  }
+  *min = lo;
+  *max = hi;
+}
+
+/**
+ * Computes the per-tensor qparams that map the float range [min, max],
+ * widened to include 0, onto [qmin, qmax], like PyTorch's choose_qparams.
+ */
+inline void choose_qparams(
+    float min,
+    float max,
+    int32_t qmin,
+    int32_t qmax,
+    double* scale_out,
+    int32_t* zero_point_out) {
+  constexpr float kSmallScaleThreshold = 6.1e-5f;
+
+  // We extend the [min, max] interval to ensure that it contains 0.
+  // Otherwise, we would not meet the requirement that 0 be an exactly
+  // representable value.
+  min = std::min(min, 0.f);
+  max = std::max(max, 0.f);
+
+  // Use double precision for intermediate computation but use single precision
+  // in final number to reflect the actual number used during quantization.
+  double scale = (static_cast<double>(max) - min) / (qmax - qmin);
+  // If scale is 0 or too small so its reciprocal is infinity, we arbitrary
+  // adjust the scale to 0.1 . We want to avoid scale's reciprocal being
+  // infinity because some of fbgemm code pre-computes scale's reciprocal to do
+  // multiplication instead of division in the time critical part of code.
+  if (float(scale) == 0.0f || std::isinf(1.0f / float(scale))) {
+    scale = 0.1;
+  }
+
+  // Cut off small scale
+  if (scale < kSmallScaleThreshold) {
+    float org_scale = scale;
+    scale = kSmallScaleThreshold;
+    // Adjust the min and max based on the new scale
+    if (min == 0.0f) {
+      max = kSmallScaleThreshold * (qmax - qmin);
+    } else if (max == 0.0f) {
+      min = -kSmallScaleThreshold * (qmax - qmin);
+    } else {
+      float amplifier = kSmallScaleThreshold / org_scale;
+      min *= amplifier;
+      max *= amplifier;
+    }
+  }
+
+  // Zero-point computation.
+  // First the initial floating-point computation. The zero-point can be
+  // determined from solving an affine equation for any known pair
+  // (real value, corresponding quantized value).
+  // We know two such pairs: (rmin, qmin) and (rmax, qmax).
+  // The arithmetic error on the zero point computed from either pair
+  // will be roughly machine_epsilon * (sum of absolute values of terms)
+  // so we want to use the variant that adds the smaller terms.
+  double zero_point_from_min = qmin - min / static_cast<double>(scale);
+  double zero_point_from_max = qmax - max / static_cast<double>(scale);
+  double zero_point_from_min_error =
+      std::abs(qmin) - std::abs(min / static_cast<double>(scale));
+  double zero_point_from_max_error =
+      std::abs(qmax) - std::abs(max / static_cast<double>(scale));
+  double initial_zero_point =
+      zero_point_from_min_error < zero_point_from_max_error
+      ? zero_point_from_min
+      : zero_point_from_max;
+
+  // Now we need to nudge the zero point to be an integer
+  // (our zero points are integer, and this is motivated by the requirement
+  // to be able to represent the real value "0" exactly as a quantized value,
+  // which is required in multiple places, for example in Im2col with zero
+  // padding).
+  int32_t nudged_zero_point = 0;
+  if (initial_zero_point < qmin) {
+    nudged_zero_point = qmin;
+  } else if (initial_zero_point > qmax) {
+    nudged_zero_point = qmax;
+  } else {
+    nudged_zero_point = std::nearbyint(static_cast<float>(initial_zero_point));
+  }
+
+  *scale_out = scale;
+  *zero_point_out = nudged_zero_point;
+}
+
+/**
+ * Returns sum_i a[i] * b[i] for `n` floats. The order of the sum depends on
+ * the path taken.
+ */
+inline float dot_floats(const float* a, const float* b, int64_t n) {
+  int64_t i = 0;
+  float sum = 0.0f;
+#if defined(ET_QUANTIZE_USE_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (; i + 8 <= n; i += 8) {
+    acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+#elif defined(ET_QUANTIZE_USE_AVX2)
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+#if defined(__FMA__)
+    acc0 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    acc1 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+#else
+    acc0 = _mm256_add_ps(
+        acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    acc1 = _mm256_add_ps(
+        acc1,
+        _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+#endif
+  }
+  const __m256 acc = _mm256_add_ps(acc0, acc1);
+  __m128 acc4 =
+      _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  acc4 = _mm_hadd_ps(acc4, acc4);
+  acc4 = _mm_hadd_ps(acc4, acc4);
+  sum = _mm_cvtss_f32(acc4);
+#endif
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+#if defined(ET_QUANTIZE_USE_NEON)
+
+inline int16x8_t load_widen_8_neon(const uint8_t* in) {
+  return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(in)));
+}
+
+inline int16x8_t load_widen_8_neon(const int8_t* in) {
+  return vmovl_s8(vld1_s8(in));
+}
+
+#elif defined(ET_QUANTIZE_USE_AVX2)
+
+inline __m256i load_widen_16_avx2(const uint8_t* in) {
+  return _mm256_cvtepu8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+}
+
+inline __m256i load_widen_16_avx2(const int8_t* in) {
+  return _mm256_cvtepi8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+}
+
+#endif
+
+/**
+ * Returns sum_i (a[i] - a_zero_point) * (b[i] - b_zero_point) for `n` 8-bit
+ * values, with A and B each either uint8_t or int8_t, accumulated in int32.
+ * The zero points must be in [-128, 255], so that the differences and their
+ * pairwise sums of products fit in int16 and int32.
+ */
+template <typename A, typename B>
+inline int32_t dot_8bit(
+    const A* a,
+    int32_t a_zero_point,
+    const B* b,
+    int32_t b_zero_point,
+    int64_t n) {
+  int64_t i = 0;
+  int32_t sum = 0;
+#if defined(ET_QUANTIZE_USE_NEON)
+  const int16x8_t a_zero_point_v = vdupq_n_s16(a_zero_point);
+  const int16x8_t b_zero_point_v = vdupq_n_s16(b_zero_point);
+  int32x4_t acc = vdupq_n_s32(0);
+  for (; i + 8 <= n; i += 8) {
+    const int16x8_t x = vsubq_s16(load_widen_8_neon(a + i), a_zero_point_v);
+    const int16x8_t y = vsubq_s16(load_widen_8_neon(b + i), b_zero_point_v);
+    acc = vmlal_s16(acc, vget_low_s16(x), vget_low_s16(y));
+    acc = vmlal_s16(acc, vget_high_s16(x), vget_high_s16(y));
+  }
+  sum = vaddvq_s32(acc);
+#elif defined(ET_QUANTIZE_USE_AVX2)
+  const __m256i a_zero_point_v = _mm256_set1_epi16(a_zero_point);
+  const __m256i b_zero_point_v = _mm256_set1_epi16(b_zero_point);
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 16 <= n; i += 16) {
+    const __m256i x =
+        _mm256_sub_epi16(load_widen_16_avx2(a + i), a_zero_point_v);
+    const __m256i y =
+        _mm256_sub_epi16(load_widen_16_avx2(b + i), b_zero_point_v);
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, y));
+  }
+  __m128i acc4 = _mm_add_epi32(
+      _mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  acc4 = _mm_hadd_epi32(acc4, acc4);
+  acc4 = _mm_hadd_epi32(acc4, acc4);
+  sum = _mm_cvtsi128_si32(acc4);
+#endif
+  for (; i < n; ++i) {
+    sum += (static_cast<int32_t>(a[i]) - a_zero_point) *
+        (static_cast<int32_t>(b[i]) - b_zero_point);
+  }
+  return sum;
+}
+
+} // namespace internal
+} // namespace native
+} // namespace executor
+} // namespace torch
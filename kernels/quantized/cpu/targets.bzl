@@ -4,21 +4,93 @@ load("@fbsource//xplat/executorch/kernels/portable:op_registration_util.bzl", "d
 _QUANT_OPS = (
     op_target(
         name = "op_add",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_avg_pool2d",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     ),
     op_target(
         name = "op_choose_qparams",
         deps = [
-            "//executorch/kernels/portable/cpu:vec_ops",
+            ":quantize_util",
+        ],
+    ),
+    op_target(
+        name = "op_conv2d",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
         ],
     ),
     op_target(
         name = "op_dequantize",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     ),
     op_target(
         name = "op_embedding",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_embedding4b",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_linear",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_linear_dynamic",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_linear_groupwise",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_matmul",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
+    ),
+    op_target(
+        name = "op_mul",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     ),
     op_target(
         name = "op_quantize",
+        deps = [
+            ":quantize_util",
+            "//executorch/runtime/kernel:thread_parallel_interface",
+        ],
     ),
 )
 
@@ -26,6 +98,13 @@ def define_common_targets():
     for op in _QUANT_OPS:
         define_op_target(is_aten_op = False, **op)
 
+    runtime.cxx_library(
+        name = "quantize_util",
+        srcs = [],
+        exported_headers = ["quantize_util.h"],
+        visibility = ["//executorch/kernels/quantized/..."],
+    )
+
     quant_op_targets = [":{}".format(op["name"]) for op in _QUANT_OPS]
 
     runtime.cxx_library(
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/test/utils/DeathTest.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::quantized_avg_pool2d_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+Tensor& avg_pool2d(
+    const Tensor& in,
+    const std::vector<int64_t>& kernel_size,
+    const std::vector<int64_t>& stride,
+    const std::vector<int64_t>& padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    Tensor& out) {
+  return quantized_avg_pool2d_out(
+      in,
+      /*in_scale=*/0.5,
+      /*in_zero_point=*/10,
+      ArrayRef<int64_t>(kernel_size.data(), kernel_size.size()),
+      ArrayRef<int64_t>(stride.data(), stride.size()),
+      ArrayRef<int64_t>(padding.data(), padding.size()),
+      ceil_mode,
+      count_include_pad,
+      /*divisor_override=*/optional<int64_t>(),
+      /*out_scale=*/0.25,
+      /*out_zero_point=*/20,
+      /*out_quant_min=*/0,
+      /*out_quant_max=*/255,
+      out);
+}
+
+} // namespace
+
+TEST(OpQuantizedAvgPool2dTest, DefaultStride) {
+  TensorFactory<ScalarType::Byte> tfu8;
+
+  // Dequantizes to 0..7 in each of two planes
+  Tensor in = tfu8.make(
+      {1, 2, 2, 4},
+      {10, 12, 14, 16, 18, 20, 22, 24, 24, 22, 20, 18, 16, 14, 12, 10});
+  Tensor out = tfu8.zeros({1, 2, 1, 2});
+
+  avg_pool2d(in, {2, 2}, {}, {0}, false, true, out);
+
+  // The averages 2.5, 4.5, 4.5 and 2.5, requantized
+  Tensor expected = tfu8.make({1, 2, 1, 2}, {30, 38, 38, 30});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedAvgPool2dTest, PaddingAndCeilMode) {
+  TensorFactory<ScalarType::Byte> tfu8;
+
+  // Dequantizes to 1..9
+  Tensor in =
+      tfu8.make({1, 3, 3}, {12, 14, 16, 18, 20, 22, 24, 26, 28});
+  Tensor out_include_pad = tfu8.zeros({1, 2, 2});
+  Tensor out_exclude_pad = tfu8.zeros({1, 2, 2});
+
+  avg_pool2d(in, {2}, {2}, {1}, true, true, out_include_pad);
+  avg_pool2d(in, {2}, {2}, {1}, true, false, out_exclude_pad);
+
+  // Windows: {1}, {2, 3}, {4, 7}, {5, 6, 8, 9}
+  EXPECT_TENSOR_EQ(out_include_pad, tfu8.make({1, 2, 2}, {21, 25, 31, 48}));
+  EXPECT_TENSOR_EQ(out_exclude_pad, tfu8.make({1, 2, 2}, {24, 30, 42, 48}));
+}
+
+TEST(OpQuantizedAvgPool2dTest, MismatchedDtypesDies) {
+  TensorFactory<ScalarType::Byte> tfu8;
+  TensorFactory<ScalarType::Char> tfi8;
+
+  Tensor in = tfu8.zeros({1, 2, 2});
+  Tensor out = tfi8.zeros({1, 1, 1});
+
+  ET_EXPECT_DEATH(avg_pool2d(in, {2}, {}, {0}, false, true, out), "");
+}
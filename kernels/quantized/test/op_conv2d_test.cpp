@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/test/utils/DeathTest.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::quantized_conv2d_out;
+using torch::executor::testing::TensorFactory;
+
+TEST(OpQuantizedConv2dTest, SmallExample) {
+  TensorFactory<ScalarType::Byte> tfu8;
+  TensorFactory<ScalarType::Char> tfi8;
+
+  // 1x1x3x3 input of 1..9, summed over 2x2 windows
+  Tensor in = tfu8.make({1, 1, 3, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  Tensor weight = tfi8.make({1, 1, 2, 2}, {1, 1, 1, 1});
+  Tensor out = tfu8.zeros({1, 1, 2, 2});
+  const std::vector<int64_t> ones = {1, 1};
+  const std::vector<int64_t> zeros = {0, 0};
+
+  quantized_conv2d_out(
+      in,
+      /*in_scale=*/1,
+      /*in_zero_point=*/0,
+      weight,
+      /*weight_scale=*/1,
+      /*weight_zero_point=*/0,
+      /*bias=*/optional<Tensor>(),
+      /*stride=*/ArrayRef<int64_t>(ones.data(), ones.size()),
+      /*padding=*/ArrayRef<int64_t>(zeros.data(), zeros.size()),
+      /*dilation=*/ArrayRef<int64_t>(ones.data(), ones.size()),
+      /*groups=*/1,
+      /*out_scale=*/1,
+      /*out_zero_point=*/0,
+      /*out_quant_min=*/0,
+      /*out_quant_max=*/255,
+      out);
+
+  Tensor expected = tfu8.make({1, 1, 2, 2}, {12, 16, 24, 28});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedConv2dTest, StridedPaddedGroupedMatchesReference) {
+  TensorFactory<ScalarType::Byte> tfu8;
+  TensorFactory<ScalarType::Char> tfi8;
+  TensorFactory<ScalarType::Float> tff;
+
+  constexpr int64_t batch = 2;
+  constexpr int64_t in_channels = 4;
+  constexpr int64_t out_channels = 6;
+  constexpr int64_t groups = 2;
+  constexpr int64_t h = 7;
+  // Wider than one tile of output columns
+  constexpr int64_t w = 150;
+  constexpr int64_t kh = 3;
+  constexpr int64_t kw = 3;
+  const std::vector<int64_t> stride = {2, 1};
+  const std::vector<int64_t> padding = {1, 2};
+  const std::vector<int64_t> dilation = {1, 2};
+  const int32_t out_h = (h + 2 * padding[0] - dilation[0] * (kh - 1) - 1) /
+          stride[0] +
+      1;
+  const int32_t out_w = (w + 2 * padding[1] - dilation[1] * (kw - 1) - 1) /
+          stride[1] +
+      1;
+  // Scales whose ratio keeps the sums away from rounding ties
+  const double in_scale = 0.0213;
+  const double weight_scale = 0.0117;
+  const double out_scale = 0.531;
+  const int64_t in_zero_point = 128;
+  const int64_t weight_zero_point = 3;
+  const int64_t out_zero_point = 120;
+  const int64_t icg = in_channels / groups;
+  const int64_t ocg = out_channels / groups;
+
+  std::vector<uint8_t> in_data(batch * in_channels * h * w);
+  std::vector<int8_t> weight_data(out_channels * icg * kh * kw);
+  std::vector<float> bias_data(out_channels);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<uint8_t>((i * 41) % 256);
+  }
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<int8_t>((i * 29) % 256 - 128);
+  }
+  for (int64_t i = 0; i < out_channels; ++i) {
+    bias_data[i] = 0.25f * i - 0.5f;
+  }
+
+  std::vector<uint8_t> expected_data(batch * out_channels * out_h * out_w);
+  for (int64_t n = 0; n < batch; ++n) {
+    for (int64_t oc = 0; oc < out_channels; ++oc) {
+      const int64_t group = oc / ocg;
+      for (int64_t oy = 0; oy < out_h; ++oy) {
+        for (int64_t ox = 0; ox < out_w; ++ox) {
+          double acc = bias_data[oc];
+          for (int64_t ic = 0; ic < icg; ++ic) {
+            for (int64_t y = 0; y < kh; ++y) {
+              for (int64_t x = 0; x < kw; ++x) {
+                const int64_t iy =
+                    oy * stride[0] - padding[0] + y * dilation[0];
+                const int64_t ix =
+                    ox * stride[1] - padding[1] + x * dilation[1];
+                if (iy < 0 || iy >= h || ix < 0 || ix >= w) {
+                  continue;
+                }
+                const int64_t c = group * icg + ic;
+                acc += (in_data[((n * in_channels + c) * h + iy) * w + ix] -
+                        in_zero_point) *
+                    in_scale *
+                    (weight_data[((oc * icg + ic) * kh + y) * kw + x] -
+                     weight_zero_point) *
+                    weight_scale;
+              }
+            }
+          }
+          const double q = std::nearbyint(acc / out_scale) + out_zero_point;
+          expected_data[((n * out_channels + oc) * out_h + oy) * out_w + ox] =
+              static_cast<uint8_t>(
+                  std::min<double>(std::max<double>(q, 0), 255));
+        }
+      }
+    }
+  }
+
+  Tensor out = tfu8.zeros({batch, out_channels, out_h, out_w});
+  quantized_conv2d_out(
+      tfu8.make({batch, in_channels, h, w}, in_data),
+      in_scale,
+      in_zero_point,
+      tfi8.make({out_channels, icg, kh, kw}, weight_data),
+      weight_scale,
+      weight_zero_point,
+      optional<Tensor>(tff.make({out_channels}, bias_data)),
+      ArrayRef<int64_t>(stride.data(), stride.size()),
+      ArrayRef<int64_t>(padding.data(), padding.size()),
+      ArrayRef<int64_t>(dilation.data(), dilation.size()),
+      groups,
+      out_scale,
+      out_zero_point,
+      0,
+      255,
+      out);
+  EXPECT_TENSOR_EQ(
+      out, tfu8.make({batch, out_channels, out_h, out_w}, expected_data));
+}
+
+TEST(OpQuantizedConv2dTest, MismatchedChannelsDies) {
+  TensorFactory<ScalarType::Byte> tfu8;
+
+  Tensor in = tfu8.zeros({1, 3, 4, 4});
+  Tensor weight = tfu8.zeros({2, 2, 3, 3});
+  Tensor out = tfu8.zeros({1, 2, 2, 2});
+  const std::vector<int64_t> ones = {1};
+  const std::vector<int64_t> zeros = {0};
+
+  ET_EXPECT_DEATH(
+      quantized_conv2d_out(
+          in,
+          1,
+          0,
+          weight,
+          1,
+          0,
+          optional<Tensor>(),
+          ArrayRef<int64_t>(ones.data(), ones.size()),
+          ArrayRef<int64_t>(zeros.data(), zeros.size()),
+          ArrayRef<int64_t>(ones.data(), ones.size()),
+          1,
+          1,
+          0,
+          0,
+          255,
+          out),
+      "");
+}
@@ -14,13 +14,18 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using exec_aten::Scalar;
 using exec_aten::ScalarType;
 using exec_aten::Tensor;
+using exec_aten::optional;
+using torch::executor::native::dequantize_per_channel_out;
 using torch::executor::native::dequantize_per_tensor_out;
 using torch::executor::native::dequantize_per_tensor_tensor_args_out;
 using torch::executor::testing::TensorFactory;
@@ -90,3 +95,65 @@ TEST(OpDequantizeOutTest, TensorArgOverload) {
 
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST(OpDequantizeOutTest, Int8VectorizedMatchesScalar) {
+  TensorFactory<ScalarType::Char> tf;
+
+  // Long enough for the vectorized loops, with a scalar tail.
+  std::vector<int8_t> input_data(37);
+  std::vector<float> expected_data(input_data.size());
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = static_cast<int8_t>(-128 + 7 * i);
+    expected_data[i] = (input_data[i] + 3) * 0.25f;
+  }
+  Tensor input = tf.make({37}, input_data);
+
+  TensorFactory<ScalarType::Float> tfo;
+  Tensor out = tfo.zeros({37});
+  dequantize_per_tensor_out(
+      input,
+      /*scale=*/0.25,
+      /*zero_point=*/-3,
+      /*quant_min=*/-128,
+      /*quant_max=*/127,
+      ScalarType::Char,
+      out);
+
+  EXPECT_TENSOR_EQ(out, tfo.make({37}, expected_data));
+}
+
+TEST(OpDequantizeOutTest, PerChannel) {
+  TensorFactory<ScalarType::Byte> tf_byte;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf_byte.make({3, 2}, {10, 20, 10, 20, 10, 20});
+  Tensor scale = tf_double.make({3}, {0.5, 1, 2});
+  Tensor zero_point = tf_long.make({3}, {0, 10, 15});
+
+  TensorFactory<ScalarType::Float> tfo;
+  Tensor out = tfo.zeros({3, 2});
+  dequantize_per_channel_out(
+      input,
+      scale,
+      zero_point,
+      /*axis=*/0,
+      /*quant_min=*/0,
+      /*quant_max=*/255,
+      ScalarType::Byte,
+      out);
+  EXPECT_TENSOR_EQ(out, tfo.make({3, 2}, {5, 10, 0, 10, -10, 10}));
+
+  // Without zero points, along the last axis.
+  scale = tf_double.make({2}, {0.5, 2});
+  dequantize_per_channel_out(
+      input,
+      scale,
+      optional<Tensor>(),
+      /*axis=*/-1,
+      /*quant_min=*/0,
+      /*quant_max=*/255,
+      ScalarType::Byte,
+      out);
+  EXPECT_TENSOR_EQ(out, tfo.make({3, 2}, {5, 40, 5, 40, 5, 40}));
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/test/utils/DeathTest.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::quantized_embedding_4bit_out;
+using torch::executor::testing::TensorFactory;
+
+TEST(OpQuantizedEmbedding4bTest, TestPackedValues) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Row 0 holds {-8, 7, 0, 1}, row 1 holds {2, -1, 3, -3}.
+  Tensor weight = tfb.make({2, 2}, {0x0F, 0x89, 0xA7, 0xB5});
+  Tensor weight_scales = tf.make({2}, {0.5, 2});
+  Tensor weight_zero_points = tf.make({2}, {0, 1});
+  Tensor indices = tfl.make({3}, {1, 0, 1});
+  Tensor out = tf.zeros({3, 4});
+
+  quantized_embedding_4bit_out(
+      weight, weight_scales, weight_zero_points, -8, 7, indices, out);
+
+  // clang-format off
+  Tensor expected = tf.make(
+      {3, 4},
+      {2, -4, 4, -8,
+       -4, 3.5, 0, 0.5,
+       2, -4, 4, -8});
+  // clang-format on
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedEmbedding4bTest, GroupWiseMatchesScalarFormula) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Two groups of 34 values per row: each group covers the vectorized body
+  // and its tail.
+  constexpr int32_t kNumEmbeddings = 3;
+  constexpr int32_t kEmbeddingDim = 68;
+  constexpr int32_t kNumGroups = 2;
+  std::vector<uint8_t> weight_data(kNumEmbeddings * kEmbeddingDim / 2);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<uint8_t>((i * 97 + 13) % 256);
+  }
+  std::vector<float> scales = {0.5, 0.25, 1, 2, 0.1, 3};
+  std::vector<int64_t> indices = {2, 0, 1, 2};
+
+  Tensor out = tf.zeros({2, 2, kEmbeddingDim});
+  quantized_embedding_4bit_out(
+      tfb.make({kNumEmbeddings, kEmbeddingDim / 2}, weight_data),
+      tf.make({kNumEmbeddings, kNumGroups}, scales),
+      optional<Tensor>(),
+      -8,
+      7,
+      tfl.make({2, 2}, indices),
+      out);
+
+  std::vector<float> expected;
+  for (int64_t index : indices) {
+    for (int32_t j = 0; j < kEmbeddingDim; ++j) {
+      const uint8_t byte = weight_data[index * kEmbeddingDim / 2 + j / 2];
+      const int32_t value = (j % 2 == 0 ? byte >> 4 : byte & 0x0F) - 8;
+      const float scale =
+          scales[index * kNumGroups + j / (kEmbeddingDim / kNumGroups)];
+      expected.push_back(static_cast<float>(value) * scale);
+    }
+  }
+  EXPECT_TENSOR_EQ(out, tf.make({2, 2, kEmbeddingDim}, expected));
+}
+
+TEST(OpQuantizedEmbedding4bTest, OddGroupSizeDies) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  Tensor out = tf.zeros({1, 6});
+  ET_EXPECT_DEATH(
+      quantized_embedding_4bit_out(
+          tfb.zeros({2, 3}),
+          tf.ones({2, 2}),
+          optional<Tensor>(),
+          -8,
+          7,
+          tfl.make({1}, {0}),
+          out),
+      "");
+}
@@ -17,6 +17,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -167,3 +168,60 @@ TEST(OpQuantizedEmbeddingTest, ConsitencyWithReferencePattern) {
   EXPECT_TENSOR_EQ(out, fp_out);
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST(OpQuantizedEmbeddingTest, LongRowsPerChannelQParams) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_l;
+  TensorFactory<ScalarType::Char> tfi8;
+
+  // Rows long enough for the vectorized path and its tail, each with its own
+  // scale and zero point.
+  constexpr int32_t kNumEmbeddings = 4;
+  constexpr int32_t kEmbeddingDim = 37;
+  std::vector<int8_t> weight_data(kNumEmbeddings * kEmbeddingDim);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<int8_t>((i * 23) % 256 - 128);
+  }
+  std::vector<float> scales = {0.5, 0.25, 0.1, 2};
+  std::vector<float> zero_points = {0, -3.5, 7, 1};
+  std::vector<int64_t> indices = {3, 0, 3, 2, 1};
+
+  Tensor out = tf.zeros({5, kEmbeddingDim});
+  quantized_embedding_byte_out(
+      tfi8.make({kNumEmbeddings, kEmbeddingDim}, weight_data),
+      tf.make({kNumEmbeddings}, scales),
+      tf.make({kNumEmbeddings}, zero_points),
+      -128,
+      127,
+      tf_l.make({5}, indices),
+      out);
+
+  std::vector<float> expected;
+  for (int64_t index : indices) {
+    for (int32_t j = 0; j < kEmbeddingDim; ++j) {
+      expected.push_back(
+          (static_cast<float>(weight_data[index * kEmbeddingDim + j]) -
+           zero_points[index]) *
+          scales[index]);
+    }
+  }
+  EXPECT_TENSOR_EQ(out, tf.make({5, kEmbeddingDim}, expected));
+}
+
+TEST(OpQuantizedEmbeddingTest, OutOfRangeIndexDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_l;
+  TensorFactory<ScalarType::Byte> tfu8;
+
+  Tensor out = tf.zeros({1, 2});
+  ET_EXPECT_DEATH(
+      quantized_embedding_byte_out(
+          tfu8.zeros({3, 2}),
+          tf.ones({3}),
+          tf.zeros({3}),
+          0,
+          255,
+          tf_l.make({1}, {3}),
+          out),
+      "");
+}
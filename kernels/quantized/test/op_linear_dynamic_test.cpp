@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/test/utils/DeathTest.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::RuntimeContext;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::MemoryAllocator;
+using torch::executor::native::quantized_linear_dynamic_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+Tensor& linear_dynamic_out(
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const optional<Tensor>& weight_zero_points,
+    int64_t weight_quant_min,
+    int64_t weight_quant_max,
+    const optional<Tensor>& bias,
+    Tensor& out) {
+  static uint8_t temp_memory[64 * 1024];
+  MemoryAllocator temp_allocator(sizeof(temp_memory), temp_memory);
+  RuntimeContext context(/*event_tracer=*/nullptr, &temp_allocator);
+  return quantized_linear_dynamic_out(
+      context,
+      in,
+      weight,
+      weight_scales,
+      weight_zero_points,
+      weight_quant_min,
+      weight_quant_max,
+      bias,
+      out);
+}
+
+} // namespace
+
+TEST(OpQuantizedLinearDynamicTest, SmallExample) {
+  TensorFactory<ScalarType::Char> tfc;
+  TensorFactory<ScalarType::Float> tf;
+
+  // The input spans [-2, 127 / 64], so it quantizes exactly with a scale of
+  // 1 / 64 and a zero point of 0.
+  Tensor in = tf.make({1, 4}, {-2, 0.5, 1.984375, 0.25});
+  Tensor weight = tfc.make({2, 4}, {1, 2, -1, 4, 0, -3, 2, 1});
+  Tensor weight_scales = tf.make({2}, {0.5, 0.25});
+  Tensor bias = tf.make({2}, {1, -1});
+  Tensor out = tf.zeros({1, 2});
+
+  linear_dynamic_out(
+      in, weight, weight_scales, optional<Tensor>(), -127, 127, bias, out);
+
+  // {-1.984375 * 0.5 + 1, 2.71875 * 0.25 - 1}
+  Tensor expected = tf.make({1, 2}, {0.0078125, -0.3203125});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedLinearDynamicTest, MatchesFloatReference) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Long> tfl;
+  TensorFactory<ScalarType::Float> tf;
+
+  // Long enough rows for the vectorized loops and their tails, and more
+  // weight rows than one block.
+  constexpr int64_t m = 3;
+  constexpr int64_t n = 21;
+  constexpr int64_t k = 77;
+  std::vector<uint8_t> weight_data(n * k);
+  std::vector<float> scales(n);
+  std::vector<int64_t> zero_points(n);
+  std::vector<float> bias(n);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<uint8_t>((i * 31 + 7) % 256);
+  }
+  for (int64_t j = 0; j < n; ++j) {
+    scales[j] = 0.01f * static_cast<float>(j % 5 + 1);
+    zero_points[j] = 120 + j;
+    bias[j] = static_cast<float>(j) * 0.25f - 2.0f;
+  }
+  std::vector<float> in_data(m * k);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>((i * 7) % 13) / 4.0f - 1.5f;
+  }
+
+  Tensor out = tf.zeros({1, m, n});
+  linear_dynamic_out(
+      tf.make({1, m, k}, in_data),
+      tfb.make({n, k}, weight_data),
+      tf.make({n}, scales),
+      tfl.make({n}, zero_points),
+      0,
+      255,
+      tf.make({n}, bias),
+      out);
+
+  // Each input value is off by at most half an input quantization step.
+  const float in_min =
+      std::min(0.0f, *std::min_element(in_data.begin(), in_data.end()));
+  const float in_max =
+      std::max(0.0f, *std::max_element(in_data.begin(), in_data.end()));
+  const double in_step = (static_cast<double>(in_max) - in_min) / 255;
+  const float* out_data = out.const_data_ptr<float>();
+  for (int64_t i = 0; i < m; ++i) {
+    for (int64_t j = 0; j < n; ++j) {
+      double expected = bias[j];
+      double tolerance = 1e-4;
+      for (int64_t l = 0; l < k; ++l) {
+        const double w =
+            (static_cast<double>(weight_data[j * k + l]) - zero_points[j]) *
+            scales[j];
+        expected += in_data[i * k + l] * w;
+        tolerance += std::abs(w) * in_step / 2;
+      }
+      EXPECT_NEAR(out_data[i * n + j], expected, tolerance);
+    }
+  }
+}
+
+TEST(OpQuantizedLinearDynamicTest, MismatchedScalesDies) {
+  TensorFactory<ScalarType::Char> tfc;
+  TensorFactory<ScalarType::Float> tf;
+
+  // One scale per weight row is needed.
+  Tensor out = tf.zeros({1, 2});
+  ET_EXPECT_DEATH(
+      linear_dynamic_out(
+          tf.ones({1, 3}),
+          tfc.zeros({2, 3}),
+          tf.ones({3}),
+          optional<Tensor>(),
+          -127,
+          127,
+          optional<Tensor>(),
+          out),
+      "");
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/test/utils/DeathTest.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::quantized_linear_4bit_out;
+using torch::executor::native::quantized_linear_byte_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+/// in @ weight.T + bias in double, for a dequantized [n, k] weight.
+std::vector<float> reference_linear(
+    const std::vector<float>& in,
+    const std::vector<float>& weight,
+    const std::vector<float>& bias,
+    int64_t m,
+    int64_t n,
+    int64_t k) {
+  std::vector<float> out(m * n);
+  for (int64_t i = 0; i < m; ++i) {
+    for (int64_t j = 0; j < n; ++j) {
+      double acc = bias.empty() ? 0.0 : bias[j];
+      for (int64_t l = 0; l < k; ++l) {
+        acc += static_cast<double>(in[i * k + l]) * weight[j * k + l];
+      }
+      out[i * n + j] = static_cast<float>(acc);
+    }
+  }
+  return out;
+}
+
+std::vector<float> make_input(int64_t size) {
+  std::vector<float> in(size);
+  for (int64_t i = 0; i < size; ++i) {
+    in[i] = static_cast<float>((i * 7) % 13) / 8.0f - 0.75f;
+  }
+  return in;
+}
+
+} // namespace
+
+TEST(OpQuantizedLinearGroupwiseTest, ByteSmallExample) {
+  TensorFactory<ScalarType::Char> tfc;
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 2}, {1, 2});
+  Tensor weight = tfc.make({2, 2}, {2, -4, 3, 1});
+  Tensor weight_scales = tf.make({2}, {0.5, 1});
+  Tensor weight_zero_points = tf.make({2}, {0, 1});
+  Tensor bias = tf.make({2}, {1, -1});
+  Tensor out = tf.zeros({1, 2});
+
+  quantized_linear_byte_out(
+      in, weight, weight_scales, weight_zero_points, -128, 127, bias, out);
+
+  // {1 * 1 + 2 * -2 + 1, 1 * 2 + 2 * 0 - 1}
+  Tensor expected = tf.make({1, 2}, {-2, 1});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedLinearGroupwiseTest, ByteGroupWiseMatchesReference) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+
+  // Groups longer than a chunk, to cover the chunking within a group.
+  constexpr int64_t m = 2;
+  constexpr int64_t n = 5;
+  constexpr int64_t k = 640;
+  constexpr int64_t num_groups = 2;
+  constexpr int64_t group_size = k / num_groups;
+  std::vector<uint8_t> weight_data(n * k);
+  std::vector<float> scales(n * num_groups);
+  std::vector<float> zero_points(n * num_groups);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<uint8_t>((i * 31) % 256);
+  }
+  for (size_t i = 0; i < scales.size(); ++i) {
+    scales[i] = 0.01f * static_cast<float>(i + 1);
+    zero_points[i] = static_cast<float>(120 + i);
+  }
+  std::vector<float> weight_fp(n * k);
+  for (int64_t j = 0; j < n; ++j) {
+    for (int64_t l = 0; l < k; ++l) {
+      const int64_t qparam = j * num_groups + l / group_size;
+      weight_fp[j * k + l] =
+          (static_cast<float>(weight_data[j * k + l]) - zero_points[qparam]) *
+          scales[qparam];
+    }
+  }
+  std::vector<float> in_data = make_input(m * k);
+
+  Tensor out = tf.zeros({m, n});
+  quantized_linear_byte_out(
+      tf.make({m, k}, in_data),
+      tfb.make({n, k}, weight_data),
+      tf.make({n, num_groups}, scales),
+      tf.make({n, num_groups}, zero_points),
+      0,
+      255,
+      optional<Tensor>(),
+      out);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out,
+      tf.make({m, n}, reference_linear(in_data, weight_fp, {}, m, n, k)),
+      1e-4,
+      1e-3);
+}
+
+TEST(OpQuantizedLinearGroupwiseTest, FourBitGroupWiseMatchesReference) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+
+  constexpr int64_t m = 3;
+  constexpr int64_t n = 4;
+  constexpr int64_t k = 96;
+  constexpr int64_t num_groups = 3;
+  constexpr int64_t group_size = k / num_groups;
+  std::vector<uint8_t> weight_data(n * k / 2);
+  std::vector<float> scales(n * num_groups);
+  std::vector<float> bias(n);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<uint8_t>((i * 67 + 5) % 256);
+  }
+  for (size_t i = 0; i < scales.size(); ++i) {
+    scales[i] = 0.05f * static_cast<float>(i % 4 + 1);
+  }
+  for (size_t i = 0; i < bias.size(); ++i) {
+    bias[i] = static_cast<float>(i) - 1.5f;
+  }
+  std::vector<float> weight_fp(n * k);
+  for (int64_t j = 0; j < n; ++j) {
+    for (int64_t l = 0; l < k; ++l) {
+      const uint8_t byte = weight_data[(j * k + l) / 2];
+      const int32_t value = (l % 2 == 0 ? byte >> 4 : byte & 0x0F) - 8;
+      weight_fp[j * k + l] = static_cast<float>(value) *
+          scales[j * num_groups + l / group_size];
+    }
+  }
+  std::vector<float> in_data = make_input(m * k);
+
+  Tensor out = tf.zeros({m, n});
+  quantized_linear_4bit_out(
+      tf.make({m, k}, in_data),
+      tfb.make({n, k / 2}, weight_data),
+      tf.make({n, num_groups}, scales),
+      optional<Tensor>(),
+      -8,
+      7,
+      tf.make({n}, bias),
+      out);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out,
+      tf.make({m, n}, reference_linear(in_data, weight_fp, bias, m, n, k)),
+      1e-4,
+      1e-3);
+}
+
+TEST(OpQuantizedLinearGroupwiseTest, MismatchedFeaturesDies) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+
+  // 4-bit rows of 3 bytes hold 6 features, not 3.
+  Tensor out = tf.zeros({1, 2});
+  ET_EXPECT_DEATH(
+      quantized_linear_4bit_out(
+          tf.ones({1, 3}),
+          tfb.zeros({2, 3}),
+          tf.ones({2}),
+          optional<Tensor>(),
+          -8,
+          7,
+          optional<Tensor>(),
+          out),
+      "");
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/test/utils/DeathTest.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::quantized_linear_out;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+/// Dequantizes the operands, computes the linear layer in double and
+/// quantizes the result again.
+template <typename IN_T, typename WEIGHT_T, typename OUT_T>
+std::vector<OUT_T> reference_linear(
+    const std::vector<IN_T>& in,
+    double in_scale,
+    int64_t in_zero_point,
+    const std::vector<WEIGHT_T>& weight,
+    double weight_scale,
+    int64_t weight_zero_point,
+    const std::vector<float>& bias,
+    double out_scale,
+    int64_t out_zero_point,
+    int64_t out_quant_min,
+    int64_t out_quant_max,
+    int64_t m,
+    int64_t n,
+    int64_t k) {
+  std::vector<OUT_T> out(m * n);
+  for (int64_t i = 0; i < m; ++i) {
+    for (int64_t j = 0; j < n; ++j) {
+      double acc = bias.empty() ? 0.0 : bias[j];
+      for (int64_t l = 0; l < k; ++l) {
+        acc += (in[i * k + l] - in_zero_point) * in_scale *
+            (weight[j * k + l] - weight_zero_point) * weight_scale;
+      }
+      const double q = std::nearbyint(acc / out_scale) + out_zero_point;
+      out[i * n + j] = static_cast<OUT_T>(std::min<double>(
+          std::max<double>(q, out_quant_min), out_quant_max));
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(OpQuantizedLinearTest, SmallExample) {
+  TensorFactory<ScalarType::Byte> tfu8;
+  TensorFactory<ScalarType::Char> tfi8;
+  TensorFactory<ScalarType::Float> tf;
+
+  // Dequantized input is {{1, 2}}, weight is {{1, -1}, {2, 0.5}}.
+  Tensor in = tfu8.make({1, 2}, {12, 14});
+  Tensor weight = tfi8.make({2, 2}, {2, -2, 4, 1});
+  Tensor bias = tf.make({2}, {0.5, -1});
+  Tensor out = tfu8.zeros({1, 2});
+
+  quantized_linear_out(
+      in,
+      /*in_scale=*/0.5,
+      /*in_zero_point=*/10,
+      weight,
+      /*weight_scale=*/0.5,
+      /*weight_zero_point=*/0,
+      bias,
+      /*out_scale=*/0.25,
+      /*out_zero_point=*/100,
+      /*out_quant_min=*/0,
+      /*out_quant_max=*/255,
+      out);
+
+  // {1 - 2 + 0.5, 2 + 1 - 1} / 0.25 + 100
+  Tensor expected = tfu8.make({1, 2}, {98, 108});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedLinearTest, MatchesReferenceForAllDtypes) {
+  TensorFactory<ScalarType::Byte> tfu8;
+  TensorFactory<ScalarType::Char> tfi8;
+  TensorFactory<ScalarType::Float> tf;
+
+  // Long enough rows and enough weight rows to cover the vectorized body, its
+  // tail and several blocks of weight rows.
+  constexpr int64_t m = 3;
+  constexpr int64_t n = 37;
+  constexpr int64_t k = 45;
+  std::vector<uint8_t> in_data(m * k);
+  std::vector<int8_t> weight_data(n * k);
+  std::vector<float> bias_data(n);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<uint8_t>((i * 37) % 256);
+  }
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<int8_t>((i * 53) % 256 - 128);
+  }
+  for (size_t i = 0; i < bias_data.size(); ++i) {
+    bias_data[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  std::vector<int8_t> in_data_i8(in_data.begin(), in_data.end());
+  std::vector<uint8_t> weight_data_u8(weight_data.begin(), weight_data.end());
+
+  const double in_scale = 0.02;
+  const double weight_scale = 0.01;
+  const double out_scale = 0.05;
+
+  {
+    Tensor out = tfu8.zeros({m, n});
+    quantized_linear_out(
+        tfu8.make({m, k}, in_data),
+        in_scale,
+        128,
+        tfi8.make({n, k}, weight_data),
+        weight_scale,
+        -3,
+        tf.make({n}, bias_data),
+        out_scale,
+        120,
+        0,
+        255,
+        out);
+    EXPECT_TENSOR_EQ(
+        out,
+        tfu8.make(
+            {m, n},
+            reference_linear<uint8_t, int8_t, uint8_t>(
+                in_data,
+                in_scale,
+                128,
+                weight_data,
+                weight_scale,
+                -3,
+                bias_data,
+                out_scale,
+                120,
+                0,
+                255,
+                m,
+                n,
+                k)));
+  }
+  {
+    Tensor out = tfi8.zeros({m, n});
+    quantized_linear_out(
+        tfi8.make({m, k}, in_data_i8),
+        in_scale,
+        -5,
+        tfu8.make({n, k}, weight_data_u8),
+        weight_scale,
+        130,
+        optional<Tensor>(),
+        out_scale,
+        0,
+        -128,
+        127,
+        out);
+    EXPECT_TENSOR_EQ(
+        out,
+        tfi8.make(
+            {m, n},
+            reference_linear<int8_t, uint8_t, int8_t>(
+                in_data_i8,
+                in_scale,
+                -5,
+                weight_data_u8,
+                weight_scale,
+                130,
+                {},
+                out_scale,
+                0,
+                -128,
+                127,
+                m,
+                n,
+                k)));
+  }
+}
+
+TEST(OpQuantizedLinearTest, KeepsLeadingDims) {
+  TensorFactory<ScalarType::Char> tfi8;
+
+  Tensor in = tfi8.make({2, 1, 2}, {1, 2, 3, 4});
+  Tensor weight = tfi8.make({3, 2}, {1, 0, 0, 1, 1, 1});
+  Tensor out = tfi8.zeros({2, 1, 3});
+
+  quantized_linear_out(
+      in,
+      /*in_scale=*/1,
+      /*in_zero_point=*/0,
+      weight,
+      /*weight_scale=*/1,
+      /*weight_zero_point=*/0,
+      optional<Tensor>(),
+      /*out_scale=*/1,
+      /*out_zero_point=*/0,
+      /*out_quant_min=*/-128,
+      /*out_quant_max=*/127,
+      out);
+
+  Tensor expected = tfi8.make({2, 1, 3}, {1, 2, 3, 3, 4, 7});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedLinearTest, MismatchedFeaturesDies) {
+  TensorFactory<ScalarType::Char> tfi8;
+
+  Tensor in = tfi8.zeros({2, 3});
+  Tensor weight = tfi8.zeros({4, 2});
+  Tensor out = tfi8.zeros({2, 4});
+
+  ET_EXPECT_DEATH(
+      quantized_linear_out(
+          in, 1, 0, weight, 1, 0, optional<Tensor>(), 1, 0, -128, 127, out),
+      "");
+}
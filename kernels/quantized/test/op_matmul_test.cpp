@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/test/utils/DeathTest.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::quantized_matmul_out;
+using torch::executor::testing::TensorFactory;
+
+TEST(OpQuantizedMatmulTest, SmallExample) {
+  TensorFactory<ScalarType::Char> tfi8;
+
+  Tensor a = tfi8.make({2, 2}, {1, 2, 3, 4});
+  Tensor b = tfi8.make({2, 3}, {1, 0, -1, 0, 1, 2});
+  Tensor out = tfi8.zeros({2, 3});
+
+  quantized_matmul_out(
+      a,
+      /*a_scale=*/0.5,
+      /*a_zero_point=*/0,
+      b,
+      /*b_scale=*/2,
+      /*b_zero_point=*/0,
+      /*out_scale=*/1,
+      /*out_zero_point=*/-1,
+      /*out_quant_min=*/-128,
+      /*out_quant_max=*/127,
+      out);
+
+  Tensor expected = tfi8.make({2, 3}, {0, 1, 2, 2, 3, 4});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedMatmulTest, BatchedMatchesReference) {
+  TensorFactory<ScalarType::Byte> tfu8;
+  TensorFactory<ScalarType::Char> tfi8;
+
+  // More columns than one block, and a batched b.
+  constexpr int64_t batch = 2;
+  constexpr int64_t m = 3;
+  constexpr int64_t k = 7;
+  constexpr int64_t n = 70;
+  const double a_scale = 0.03;
+  const double b_scale = 0.02;
+  const double out_scale = 0.04;
+  const int64_t a_zero_point = 128;
+  const int64_t b_zero_point = -2;
+  const int64_t out_zero_point = 10;
+
+  std::vector<uint8_t> a_data(batch * m * k);
+  std::vector<int8_t> b_data(batch * k * n);
+  for (size_t i = 0; i < a_data.size(); ++i) {
+    a_data[i] = static_cast<uint8_t>((i * 41) % 256);
+  }
+  for (size_t i = 0; i < b_data.size(); ++i) {
+    b_data[i] = static_cast<int8_t>((i * 29) % 256 - 128);
+  }
+
+  std::vector<int8_t> expected_data(batch * m * n);
+  for (int64_t bi = 0; bi < batch; ++bi) {
+    for (int64_t i = 0; i < m; ++i) {
+      for (int64_t j = 0; j < n; ++j) {
+        double acc = 0;
+        for (int64_t l = 0; l < k; ++l) {
+          acc += (a_data[(bi * m + i) * k + l] - a_zero_point) * a_scale *
+              (b_data[(bi * k + l) * n + j] - b_zero_point) * b_scale;
+        }
+        const double q = std::nearbyint(acc / out_scale) + out_zero_point;
+        expected_data[(bi * m + i) * n + j] = static_cast<int8_t>(
+            std::min<double>(std::max<double>(q, -128), 127));
+      }
+    }
+  }
+
+  Tensor out = tfi8.zeros({batch, m, n});
+  quantized_matmul_out(
+      tfu8.make({batch, m, k}, a_data),
+      a_scale,
+      a_zero_point,
+      tfi8.make({batch, k, n}, b_data),
+      b_scale,
+      b_zero_point,
+      out_scale,
+      out_zero_point,
+      -128,
+      127,
+      out);
+  EXPECT_TENSOR_EQ(out, tfi8.make({batch, m, n}, expected_data));
+}
+
+TEST(OpQuantizedMatmulTest, SharedRhs) {
+  TensorFactory<ScalarType::Byte> tfu8;
+
+  Tensor a = tfu8.make({2, 1, 2}, {1, 2, 3, 4});
+  Tensor b = tfu8.make({2, 2}, {1, 0, 0, 1});
+  Tensor out = tfu8.zeros({2, 1, 2});
+
+  quantized_matmul_out(a, 1, 0, b, 1, 0, 1, 0, 0, 255, out);
+
+  Tensor expected = tfu8.make({2, 1, 2}, {1, 2, 3, 4});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedMatmulTest, MismatchedInnerDimDies) {
+  TensorFactory<ScalarType::Byte> tfu8;
+
+  Tensor a = tfu8.zeros({2, 3});
+  Tensor b = tfu8.zeros({2, 2});
+  Tensor out = tfu8.zeros({2, 2});
+
+  ET_EXPECT_DEATH(
+      quantized_matmul_out(a, 1, 0, b, 1, 0, 1, 0, 0, 255, out), "");
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/test/utils/DeathTest.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::quantized_mul_out;
+using torch::executor::testing::TensorFactory;
+
+TEST(OpQuantizedMulTest, SmallExample) {
+  TensorFactory<ScalarType::Byte> tfu8;
+
+  Tensor a = tfu8.make({4}, {10, 12, 14, 8});
+  Tensor b = tfu8.make({4}, {3, 4, 0, 6});
+  Tensor out = tfu8.zeros({4});
+
+  // (a - 10) * 0.5 * (b - 2) * 2 / 0.25 + 100
+  quantized_mul_out(
+      a,
+      /*a_scale=*/0.5,
+      /*a_zero_point=*/10,
+      /*a_quant_min=*/0,
+      /*a_quant_max=*/255,
+      b,
+      /*b_scale=*/2,
+      /*b_zero_point=*/2,
+      /*b_quant_min=*/0,
+      /*b_quant_max=*/255,
+      /*out_scale=*/0.25,
+      /*out_zero_point=*/100,
+      /*out_quant_min=*/0,
+      /*out_quant_max=*/255,
+      out);
+
+  Tensor expected = tfu8.make({4}, {100, 116, 68, 68});
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+TEST(OpQuantizedMulTest, LargeMatchesReference) {
+  TensorFactory<ScalarType::Char> tfi8;
+
+  // More elements than one chunk, and not a multiple of it
+  constexpr int64_t n = 1000;
+  // Scales whose ratio keeps the products away from rounding ties
+  const double a_scale = 0.047;
+  const double b_scale = 0.021;
+  const double out_scale = 0.0313;
+  const int64_t a_zero_point = 3;
+  const int64_t b_zero_point = -5;
+  const int64_t out_zero_point = 1;
+
+  std::vector<int8_t> a_data(n);
+  std::vector<int8_t> b_data(n);
+  std::vector<int8_t> expected_data(n);
+  for (int64_t i = 0; i < n; ++i) {
+    a_data[i] = static_cast<int8_t>((i * 37) % 256 - 128);
+    b_data[i] = static_cast<int8_t>((i * 53) % 256 - 128);
+    const double product = (a_data[i] - a_zero_point) * a_scale *
+        (b_data[i] - b_zero_point) * b_scale;
+    const double q = std::nearbyint(product / out_scale) + out_zero_point;
+    expected_data[i] =
+        static_cast<int8_t>(std::min<double>(std::max<double>(q, -128), 127));
+  }
+
+  Tensor out = tfi8.zeros({n});
+  quantized_mul_out(
+      tfi8.make({n}, a_data),
+      a_scale,
+      a_zero_point,
+      -128,
+      127,
+      tfi8.make({n}, b_data),
+      b_scale,
+      b_zero_point,
+      -128,
+      127,
+      out_scale,
+      out_zero_point,
+      -128,
+      127,
+      out);
+  EXPECT_TENSOR_EQ(out, tfi8.make({n}, expected_data));
+}
+
+TEST(OpQuantizedMulTest, MismatchedShapesDies) {
+  TensorFactory<ScalarType::Byte> tfu8;
+
+  Tensor a = tfu8.zeros({2, 3});
+  Tensor b = tfu8.zeros({3, 2});
+  Tensor out = tfu8.zeros({2, 3});
+
+  ET_EXPECT_DEATH(
+      quantized_mul_out(
+          a, 1, 0, 0, 255, b, 1, 0, 0, 255, 1, 0, 0, 255, out),
+      "");
+}
@@ -14,13 +14,17 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using exec_aten::Scalar;
 using exec_aten::ScalarType;
 using exec_aten::Tensor;
+using torch::executor::native::quantize_per_channel_out;
 using torch::executor::native::quantize_per_tensor_out;
 using torch::executor::native::quantize_per_tensor_tensor_args_out;
 using torch::executor::testing::TensorFactory;
@@ -97,3 +101,72 @@ TEST(OpQuantizeOutTest, TestOutOfBounds) {
 
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST(OpQuantizeOutTest, RoundsHalfToEvenAndSaturates) {
+  TensorFactory<ScalarType::Float> tf_float;
+
+  // Long enough for the vectorized loops, with a scalar tail. Input values
+  // are exact in float, so every product lands exactly on a tie or a bound.
+  std::vector<float> input_data(45);
+  std::vector<int8_t> expected_data(input_data.size());
+  for (size_t i = 0; i < input_data.size(); i++) {
+    // -11, -10.5, ..., 11: ties round to the even neighbour.
+    input_data[i] = -11.0f + 0.5f * i;
+    const float rounded = std::nearbyint(input_data[i]);
+    expected_data[i] =
+        static_cast<int8_t>(std::min(std::max(rounded + 1.0f, -8.0f), 7.0f));
+  }
+  Tensor input = tf_float.make({45}, input_data);
+
+  TensorFactory<ScalarType::Char> tfo;
+  Tensor out = tfo.zeros({45});
+  quantize_per_tensor_out(
+      input,
+      /*scale=*/1.0,
+      /*zero_point=*/1,
+      /*quant_min=*/-8,
+      /*quant_max=*/7,
+      ScalarType::Char,
+      out);
+
+  EXPECT_TENSOR_EQ(out, tfo.make({45}, expected_data));
+}
+
+TEST(OpQuantizeOutTest, PerChannel) {
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  // clang-format off
+  Tensor input = tf_float.make(
+    {2, 3, 2},
+    {
+      1, 2, 3, 4, 5, 6,
+      -1, -2, -3, -4, -5, -6
+    });
+  // clang-format on
+  Tensor scale = tf_double.make({3}, {0.5, 1, 2});
+  Tensor zero_point = tf_long.make({3}, {0, 10, 100});
+
+  TensorFactory<ScalarType::Byte> tfo;
+  Tensor out = tfo.zeros({2, 3, 2});
+  quantize_per_channel_out(
+      input,
+      scale,
+      zero_point,
+      /*axis=*/1,
+      /*quant_min=*/0,
+      /*quant_max=*/255,
+      ScalarType::Byte,
+      out);
+
+  // clang-format off
+  Tensor expected = tfo.make(
+    {2, 3, 2},
+    {
+      2, 4, 13, 14, 102, 103,
+      0, 0, 7, 6, 98, 97
+    });
+  // clang-format on
+  EXPECT_TENSOR_EQ(out, expected);
+}
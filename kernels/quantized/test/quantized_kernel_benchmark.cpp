@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Times the quantized kernels over the shapes that kernel_benchmark.cpp uses
+ * for their float counterparts, so that e.g. the quantized_linear.out rows
+ * can be compared with the mm.out rows of the portable and optimized
+ * libraries.
+ *
+ * Usage:
+ *   quantized_kernel_benchmark [op filter] [min seconds per case]
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the operators
+#include <executorch/kernels/test/BenchmarkUtil.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstdint>
+#include <vector>
+
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::dequantize_per_tensor_out;
+using torch::executor::native::quantize_per_tensor_out;
+using torch::executor::native::quantized_embedding_byte_out;
+using torch::executor::native::quantized_linear_out;
+using torch::executor::testing::fill_benchmark_tensor;
+using torch::executor::testing::KernelBenchmark;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+TensorFactory<ScalarType::Float> tf;
+TensorFactory<ScalarType::Byte> tfu8;
+TensorFactory<ScalarType::Char> tfi8;
+TensorFactory<ScalarType::Long> tf_long;
+
+/// Fills a quantized tensor with a spread of values over the whole range.
+template <typename T>
+void fill_quantized(Tensor& t) {
+  T* data = t.mutable_data_ptr<T>();
+  for (size_t i = 0; i < t.numel(); ++i) {
+    data[i] = static_cast<T>((i * 37) % 256);
+  }
+}
+
+void bench_quantize(KernelBenchmark& bench) {
+  // MobileNetV2 activations and llama2 hidden states.
+  const std::vector<std::vector<int32_t>> shapes = {
+      {1, 24, 56, 56}, {1, 128, 288}};
+  const char* names[] = {"1x24x56x56", "1x128x288"};
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    Tensor f = tf.zeros(shapes[i]);
+    fill_benchmark_tensor<float>(f);
+    Tensor q = tfu8.zeros(shapes[i]);
+    const double bytes = f.numel() * (sizeof(float) + sizeof(uint8_t));
+    bench.run("quantize_per_tensor.out", names[i], "f32->u8", 0, bytes, [&]() {
+      quantize_per_tensor_out(f, 0.01, 128, 0, 255, ScalarType::Byte, q);
+    });
+    bench.run(
+        "dequantize_per_tensor.out", names[i], "u8->f32", 0, bytes, [&]() {
+          dequantize_per_tensor_out(q, 0.01, 128, 0, 255, ScalarType::Byte, f);
+        });
+  }
+}
+
+void bench_linear(KernelBenchmark& bench) {
+  struct Case {
+    const char* shape;
+    int32_t m;
+    int32_t k;
+    int32_t n;
+  };
+  // The mm.out shapes of kernel_benchmark.cpp; the weight is n x k here.
+  const Case cases[] = {
+      {"1x288*288x288", 1, 288, 288},
+      {"128x288*288x288", 128, 288, 288},
+      {"128x288*288x768", 128, 288, 768},
+      {"1x1280*1280x1000", 1, 1280, 1000},
+  };
+  for (const Case& c : cases) {
+    Tensor in = tfu8.zeros({c.m, c.k});
+    fill_quantized<uint8_t>(in);
+    Tensor weight = tfi8.zeros({c.n, c.k});
+    fill_quantized<int8_t>(weight);
+    Tensor bias = tf.zeros({c.n});
+    fill_benchmark_tensor<float>(bias);
+    Tensor out = tfu8.zeros({c.m, c.n});
+    bench.run(
+        "quantized_linear.out",
+        c.shape,
+        "u8*i8->u8",
+        2.0 * c.m * c.k * c.n,
+        in.numel() + weight.numel() + bias.numel() * sizeof(float) +
+            out.numel(),
+        [&]() {
+          quantized_linear_out(
+              in,
+              /*in_scale=*/0.02,
+              /*in_zero_point=*/128,
+              weight,
+              /*weight_scale=*/0.01,
+              /*weight_zero_point=*/0,
+              optional<Tensor>(bias),
+              /*out_scale=*/0.5,
+              /*out_zero_point=*/128,
+              /*out_quant_min=*/0,
+              /*out_quant_max=*/255,
+              out);
+        });
+  }
+}
+
+void bench_embedding(KernelBenchmark& bench) {
+  // The embedding.out case of kernel_benchmark.cpp with per-row qparams.
+  Tensor weight = tfu8.zeros({32000, 288});
+  fill_quantized<uint8_t>(weight);
+  Tensor scales = tf.full({32000}, 0.01);
+  Tensor zero_points = tf.full({32000}, 128);
+  std::vector<int64_t> index_data(128);
+  for (size_t i = 0; i < index_data.size(); ++i) {
+    index_data[i] = (i * 7919) % 32000;
+  }
+  Tensor indices = tf_long.make({128}, index_data);
+  Tensor out = tf.zeros({128, 288});
+  bench.run(
+      "embedding_byte.out",
+      "32000x288[128]",
+      "u8->f32",
+      0,
+      out.numel() * (sizeof(uint8_t) + sizeof(float)) +
+          indices.numel() * sizeof(int64_t),
+      [&]() {
+        quantized_embedding_byte_out(
+            weight, scales, zero_points, 0, 255, indices, out);
+      });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  torch::executor::runtime_init();
+  KernelBenchmark bench("quantized", argc, argv);
+  bench_quantize(bench);
+  bench_linear(bench);
+  bench_embedding(bench);
+  return 0;
+}
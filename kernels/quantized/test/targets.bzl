@@ -1,3 +1,4 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 load("@fbsource//xplat/executorch/kernels/test:util.bzl", "define_supported_features_lib", "op_test")
 
 def define_common_targets():
@@ -6,6 +7,14 @@ def define_common_targets():
     op_test("op_quantize_test", kernel_name = "quantized")
     op_test("op_dequantize_test", kernel_name = "quantized")
     op_test("op_choose_qparams_test", kernel_name = "quantized")
+    op_test("op_linear_test", kernel_name = "quantized")
+    op_test("op_linear_groupwise_test", kernel_name = "quantized")
+    op_test("op_linear_dynamic_test", kernel_name = "quantized")
+    op_test("op_embedding4b_test", kernel_name = "quantized")
+    op_test("op_matmul_test", kernel_name = "quantized")
+    op_test("op_mul_test", kernel_name = "quantized")
+    op_test("op_conv2d_test", kernel_name = "quantized")
+    op_test("op_avg_pool2d_test", kernel_name = "quantized")
     op_test("op_add_test", kernel_name = "quantized", deps = [
         "//executorch/kernels/quantized/cpu:op_dequantize",
         "//executorch/kernels/quantized/cpu:op_quantize",
@@ -25,3 +34,15 @@ def define_common_targets():
         "//executorch/kernels/portable/cpu:op_embedding",
         "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
     ])
+
+    runtime.cxx_binary(
+        name = "quantized_kernel_benchmark",
+        srcs = ["quantized_kernel_benchmark.cpp"],
+        deps = [
+            "//executorch/kernels/quantized:generated_lib",
+            "//executorch/kernels/quantized:generated_lib_headers",
+            "//executorch/kernels/test:benchmark_util",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ * Kernel benchmark utilities: times a kernel call and prints one result line
+ * with its throughput. The same cases built against different kernel
+ * libraries print lines that differ only in the library column, so runs can
+ * be compared by joining on the other columns.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+
+namespace torch {
+namespace executor {
+namespace testing {
+
+/**
+ * Runs kernel benchmark cases and reports their results. Cases are named
+ * "<op>" and only run if their name contains the filter given on the command
+ * line.
+ *
+ * Usage:
+ *   <benchmark> [filter] [min_seconds]
+ */
+class KernelBenchmark {
+ public:
+  KernelBenchmark(const char* library, int argc, char** argv)
+      : library_(library),
+        filter_(argc > 1 ? argv[1] : ""),
+        min_seconds_(argc > 2 ? std::strtod(argv[2], nullptr) : 0.2),
+        temp_memory_(kTempMemoryBytes),
+        temp_allocator_(temp_memory_.size(), temp_memory_.data()),
+        context_(/*event_tracer=*/nullptr, &temp_allocator_) {
+    printf(
+        "%-10s %-22s %-28s %-14s %10s %12s %9s %9s\n",
+        "library",
+        "op",
+        "shape",
+        "variant",
+        "iters",
+        "ns/iter",
+        "GFLOP/s",
+        "GB/s");
+  }
+
+  /// The context to pass to kernels. Its temp allocator is reset after every
+  /// call, as the runtime does between instructions.
+  exec_aten::RuntimeContext& context() {
+    return context_;
+  }
+
+  /**
+   * Times `fn`, which runs the kernel once, and prints a result line.
+   *
+   * @param[in] op The operator name, matched against the filter.
+   * @param[in] shape Describes the input shapes, e.g. "1x64x56x56".
+   * @param[in] variant Describes the dtype and dim order, e.g. "f32/nhwc".
+   * @param[in] flops Floating point (or integer MAC) operations per call. Zero
+   *     for memory-bound ops, whose GFLOP/s column is left empty.
+   * @param[in] bytes Bytes read and written per call.
+   */
+  template <typename Fn>
+  void run(
+      const char* op,
+      const char* shape,
+      const char* variant,
+      double flops,
+      double bytes,
+      Fn fn) {
+    if (strstr(op, filter_) == nullptr) {
+      return;
+    }
+    // Warm up caches and any lazily initialized kernel state.
+    for (int i = 0; i < 3; ++i) {
+      call(fn);
+    }
+    size_t iterations = 0;
+    double elapsed_ns = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (elapsed_ns < min_seconds_ * 1e9) {
+      call(fn);
+      ++iterations;
+      elapsed_ns = std::chrono::duration<double, std::nano>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    }
+    const double ns = elapsed_ns / iterations;
+    char gflops[16] = "-";
+    if (flops > 0) {
+      snprintf(gflops, sizeof(gflops), "%.2f", flops / ns);
+    }
+    printf(
+        "%-10s %-22s %-28s %-14s %10zu %12.0f %9s %9.2f\n",
+        library_,
+        op,
+        shape,
+        variant,
+        iterations,
+        ns,
+        gflops,
+        bytes / ns);
+  }
+
+ private:
+  template <typename Fn>
+  void call(Fn& fn) {
+    fn();
+    temp_allocator_.reset();
+  }
+
+  static constexpr size_t kTempMemoryBytes = 4 * 1024 * 1024;
+
+  const char* library_;
+  const char* filter_;
+  double min_seconds_;
+  std::vector<uint8_t> temp_memory_;
+  MemoryAllocator temp_allocator_;
+  exec_aten::RuntimeContext context_;
+};
+
+/// Fills a tensor with deterministic values in [-1, 1) so that kernels take
+/// their usual paths; NaNs or denormals would skew the timings.
+template <typename T>
+void fill_benchmark_tensor(exec_aten::Tensor& t) {
+  T* data = t.mutable_data_ptr<T>();
+  for (size_t i = 0; i < t.numel(); ++i) {
+    data[i] = static_cast<T>(static_cast<float>((i * 7919) % 2000) / 1000 - 1);
+  }
+}
+
+} // namespace testing
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Times the ATen-compatible kernels of one kernel library over shapes taken
+ * from examples/models: MobileNetV2 convolutions and residual adds, and the
+ * attention and feed-forward layers of the stories15M llama2. The same source
+ * is built once per library (see kernel_benchmark_<library> in targets.bzl),
+ * so running the portable and optimized binaries gives comparable rows.
+ *
+ * Usage:
+ *   <library>_kernel_benchmark [op filter] [min seconds per case]
+ */
+
+#include <executorch/kernels/test/BenchmarkUtil.h>
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operators
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstdint>
+#include <vector>
+
+#ifndef ET_KERNEL_LIBRARY_NAME
+#define ET_KERNEL_LIBRARY_NAME "unknown"
+#endif
+
+using exec_aten::ArrayRef;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::fill_benchmark_tensor;
+using torch::executor::testing::KernelBenchmark;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+constexpr double kF32 = sizeof(float);
+
+TensorFactory<ScalarType::Float> tf;
+TensorFactory<ScalarType::Long> tf_long;
+
+Tensor make_f32(const std::vector<int32_t>& sizes, bool channels_last = false) {
+  Tensor t = channels_last ? tf.full_channels_last(sizes, 0) : tf.zeros(sizes);
+  fill_benchmark_tensor<float>(t);
+  return t;
+}
+
+void bench_binary(KernelBenchmark& bench) {
+  struct Case {
+    const char* shape;
+    std::vector<int32_t> a;
+    std::vector<int32_t> b;
+    bool channels_last;
+  };
+  const Case cases[] = {
+      // MobileNetV2 residual connections.
+      {"1x24x56x56", {1, 24, 56, 56}, {1, 24, 56, 56}, false},
+      {"1x24x56x56", {1, 24, 56, 56}, {1, 24, 56, 56}, true},
+      // llama2 residual connections and broadcast of a per-channel weight.
+      {"1x128x288", {1, 128, 288}, {1, 128, 288}, false},
+      {"1x128x288+288", {1, 128, 288}, {288}, false},
+  };
+  for (const Case& c : cases) {
+    Tensor a = make_f32(c.a, c.channels_last);
+    Tensor b = make_f32(c.b, c.channels_last && c.a == c.b);
+    Tensor out = make_f32(c.a, c.channels_last);
+    const char* variant = c.channels_last ? "f32/nhwc" : "f32/contig";
+    const double bytes = (a.numel() + b.numel() + out.numel()) * kF32;
+    bench.run("add.out", c.shape, variant, out.numel(), bytes, [&]() {
+      torch::executor::aten::add_outf(bench.context(), a, b, 1, out);
+    });
+    bench.run("mul.out", c.shape, variant, out.numel(), bytes, [&]() {
+      torch::executor::aten::mul_outf(bench.context(), a, b, out);
+    });
+  }
+}
+
+void bench_matmul(KernelBenchmark& bench) {
+  struct Case {
+    const char* shape;
+    int32_t m;
+    int32_t k;
+    int32_t n;
+  };
+  const Case cases[] = {
+      // llama2 decode and prefill projections, and the feed-forward layer.
+      {"1x288*288x288", 1, 288, 288},
+      {"128x288*288x288", 128, 288, 288},
+      {"128x288*288x768", 128, 288, 768},
+      // MobileNetV2 classifier.
+      {"1x1280*1280x1000", 1, 1280, 1000},
+  };
+  for (const Case& c : cases) {
+    Tensor a = make_f32({c.m, c.k});
+    Tensor b = make_f32({c.k, c.n});
+    Tensor bias = make_f32({c.n});
+    Tensor out = make_f32({c.m, c.n});
+    const double flops = 2.0 * c.m * c.k * c.n;
+    const double bytes = (a.numel() + b.numel() + out.numel()) * kF32;
+    bench.run("mm.out", c.shape, "f32/contig", flops, bytes, [&]() {
+      torch::executor::aten::mm_outf(bench.context(), a, b, out);
+    });
+    bench.run(
+        "addmm.out",
+        c.shape,
+        "f32/contig",
+        flops,
+        bytes + bias.numel() * kF32,
+        [&]() {
+          torch::executor::aten::addmm_outf(
+              bench.context(), bias, a, b, 1, 1, out);
+        });
+  }
+
+  // llama2 attention scores and weighted values: 6 heads of size 48.
+  Tensor q = make_f32({6, 128, 48});
+  Tensor kt = make_f32({6, 48, 128});
+  Tensor scores = make_f32({6, 128, 128});
+  bench.run(
+      "bmm.out",
+      "6x128x48*6x48x128",
+      "f32/contig",
+      2.0 * 6 * 128 * 48 * 128,
+      (q.numel() + kt.numel() + scores.numel()) * kF32,
+      [&]() {
+        torch::executor::aten::bmm_outf(bench.context(), q, kt, scores);
+      });
+}
+
+void bench_convolution(KernelBenchmark& bench) {
+  struct Case {
+    const char* shape;
+    std::vector<int32_t> in;
+    std::vector<int32_t> weight;
+    std::vector<int32_t> out;
+    int64_t stride;
+    int64_t padding;
+    int64_t groups;
+  };
+  // MobileNetV2: the stem, and the depthwise and pointwise convolutions of
+  // the first bottleneck.
+  const Case cases[] = {
+      {"1x3x224x224 k3 s2",
+       {1, 3, 224, 224},
+       {32, 3, 3, 3},
+       {1, 32, 112, 112},
+       2,
+       1,
+       1},
+      {"1x32x112x112 dw3",
+       {1, 32, 112, 112},
+       {32, 1, 3, 3},
+       {1, 32, 112, 112},
+       1,
+       1,
+       32},
+      {"1x32x112x112 k1",
+       {1, 32, 112, 112},
+       {16, 32, 1, 1},
+       {1, 16, 112, 112},
+       1,
+       0,
+       1},
+  };
+  for (bool channels_last : {false, true}) {
+    for (const Case& c : cases) {
+      Tensor in = make_f32(c.in, channels_last);
+      Tensor weight = make_f32(c.weight, channels_last);
+      Tensor bias = make_f32({c.weight[0]});
+      Tensor out = make_f32(c.out, channels_last);
+      const int64_t stride[] = {c.stride, c.stride};
+      const int64_t padding[] = {c.padding, c.padding};
+      const int64_t dilation[] = {1, 1};
+      const double flops = 2.0 * out.numel() * (c.in[1] / c.groups) *
+          c.weight[2] * c.weight[3];
+      const double bytes =
+          (in.numel() + weight.numel() + bias.numel() + out.numel()) * kF32;
+      bench.run(
+          "convolution.out",
+          c.shape,
+          channels_last ? "f32/nhwc" : "f32/contig",
+          flops,
+          bytes,
+          [&]() {
+            torch::executor::aten::convolution_outf(
+                bench.context(),
+                in,
+                weight,
+                optional<Tensor>(bias),
+                ArrayRef<int64_t>(stride, 2),
+                ArrayRef<int64_t>(padding, 2),
+                ArrayRef<int64_t>(dilation, 2),
+                /*transposed=*/false,
+                ArrayRef<int64_t>{},
+                c.groups,
+                out);
+          });
+    }
+  }
+}
+
+void bench_normalization(KernelBenchmark& bench) {
+  // llama2 attention probabilities.
+  Tensor scores = make_f32({6, 128, 128});
+  Tensor probs = make_f32({6, 128, 128});
+  bench.run(
+      "_softmax.out",
+      "6x128x128 dim-1",
+      "f32/contig",
+      0,
+      2 * scores.numel() * kF32,
+      [&]() {
+        torch::executor::aten::_softmax_outf(
+            bench.context(), scores, -1, false, probs);
+      });
+
+  // Transformer layer norm and feed-forward activation.
+  Tensor in = make_f32({1, 128, 768});
+  Tensor weight = make_f32({768});
+  Tensor bias = make_f32({768});
+  Tensor out = make_f32({1, 128, 768});
+  Tensor mean = make_f32({1, 128, 1});
+  Tensor rstd = make_f32({1, 128, 1});
+  const int64_t normalized_shape[] = {768};
+  bench.run(
+      "native_layer_norm.out",
+      "1x128x768",
+      "f32/contig",
+      0,
+      2 * in.numel() * kF32,
+      [&]() {
+        torch::executor::aten::native_layer_norm_outf(
+            bench.context(),
+            in,
+            ArrayRef<int64_t>(normalized_shape, 1),
+            optional<Tensor>(weight),
+            optional<Tensor>(bias),
+            1e-5,
+            out,
+            mean,
+            rstd);
+      });
+  bench.run(
+      "gelu.out",
+      "1x128x768",
+      "f32/contig",
+      0,
+      2 * in.numel() * kF32,
+      [&]() {
+        torch::executor::aten::gelu_outf(bench.context(), in, "none", out);
+      });
+}
+
+void bench_data_movement(KernelBenchmark& bench) {
+  // Concatenation along channels, as in the skip connections of UNet-style
+  // models.
+  Tensor a = make_f32({1, 64, 56, 56});
+  Tensor b = make_f32({1, 64, 56, 56});
+  Tensor cat_out = make_f32({1, 128, 56, 56});
+  Tensor tensors[] = {a, b};
+  bench.run(
+      "cat.out",
+      "2x1x64x56x56 dim1",
+      "f32/contig",
+      0,
+      2 * cat_out.numel() * kF32,
+      [&]() {
+        torch::executor::aten::cat_outf(
+            bench.context(), ArrayRef<Tensor>(tensors, 2), 1, cat_out);
+      });
+
+  // llama2 token embedding of a 128 token prompt.
+  Tensor weight = make_f32({32000, 288});
+  std::vector<int64_t> index_data(128);
+  for (size_t i = 0; i < index_data.size(); ++i) {
+    index_data[i] = (i * 7919) % 32000;
+  }
+  Tensor indices = tf_long.make({128}, index_data);
+  Tensor out = make_f32({128, 288});
+  bench.run(
+      "embedding.out",
+      "32000x288[128]",
+      "f32/contig",
+      0,
+      2 * out.numel() * kF32 + indices.numel() * sizeof(int64_t),
+      [&]() {
+        torch::executor::aten::embedding_outf(
+            bench.context(), weight, indices, -1, false, false, out);
+      });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  torch::executor::runtime_init();
+  KernelBenchmark bench(ET_KERNEL_LIBRARY_NAME, argc, argv);
+  bench_binary(bench);
+  bench_matmul(bench);
+  bench_convolution(bench);
+  bench_normalization(bench);
+  bench_data_movement(bench);
+  return 0;
+}
@@ -131,6 +131,52 @@ TEST(OpAddOutKernelTest, DoubleTensors) {
   test_floating_point_add_out<ScalarType::Double>();
 }
 
+// Half and BFloat16 keep about 3 and 2 significant decimal digits.
+template <ScalarType DTYPE>
+void test_reduced_precision_add_out() {
+  TensorFactory<DTYPE> tf;
+
+  const std::vector<int32_t> sizes = {2, 2};
+
+  Tensor out = tf.zeros(sizes);
+
+  op_add_out(
+      tf.make(sizes, /*data=*/{1.1, 2.2, 4.4, 8.8}),
+      tf.ones(sizes),
+      /*alpha=*/1.1,
+      out);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out,
+      tf.make(sizes, /*data=*/{2.2, 3.3, 5.5, 9.9}),
+      /*rtol=*/1e-2,
+      /*atol=*/1e-2);
+}
+
+TEST(OpAddOutKernelTest, HalfTensors) {
+  test_reduced_precision_add_out<ScalarType::Half>();
+}
+
+TEST(OpAddOutKernelTest, BFloat16Tensors) {
+  test_reduced_precision_add_out<ScalarType::BFloat16>();
+}
+
+TEST(OpAddOutKernelTest, HalfAndFloatInputTensor) {
+  TensorFactory<ScalarType::Half> tfh;
+  TensorFactory<ScalarType::Float> tff;
+
+  const std::vector<int32_t> sizes = {2, 2};
+
+  Tensor a = tfh.make(sizes, /*data=*/{0.5, 1.5, 2.5, 3.5});
+  Tensor b = tff.make(sizes, /*data=*/{0.25, 0.25, 0.25, 0.25});
+
+  // Half and Float promote to Float.
+  Tensor out = tff.zeros(sizes);
+
+  op_add_out(a, b, /*alpha=*/1, out);
+  EXPECT_TENSOR_EQ(out, tff.make(sizes, {0.75, 1.75, 2.75, 3.75}));
+}
+
 TEST(OpAddOutKernelTest, BoolAndIntInputTensor) {
   TensorFactory<ScalarType::Bool> tf;
   TensorFactory<ScalarType::Int> tfi;
@@ -1047,3 +1047,41 @@ TEST(OpAvgPool2DOutTest, SanityCheck4DCeilModeNoIncludePadding) {
       out);
   EXPECT_TENSOR_CLOSE(out, out_expected);
 }
+
+TEST(OpAvgPool2DOutTest, ChannelsLast) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+
+  // Channels are the innermost dim of the data
+  exec_aten::Tensor self = tfFloat.make_channels_last(
+      {1, 2, 5, 5},
+      {-4, 3,  1, -1, -3, 4,  2,  0,  -2, -4, -1, -3, 4,  2,  0,  -2, -4,
+       3,  1,  -1, 2, 0,  -2, -4, 3,  1,  -1, -3, 4,  2,  -4, 3,  1,  -1,
+       -3, 4,  2, 0,  -2, -4, -1, -3, 4,  2,  0,  -2, -4, 3,  1,  -1});
+  ::std::vector<int64_t> kernel_size_vec = {3, 3};
+  exec_aten::ArrayRef<int64_t> kernel_size = exec_aten::ArrayRef<int64_t>(
+      kernel_size_vec.data(), kernel_size_vec.size());
+  ::std::vector<int64_t> stride_vec = {2, 2};
+  exec_aten::ArrayRef<int64_t> stride =
+      exec_aten::ArrayRef<int64_t>(stride_vec.data(), stride_vec.size());
+  ::std::vector<int64_t> padding_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> padding =
+      exec_aten::ArrayRef<int64_t>(padding_vec.data(), padding_vec.size());
+  bool ceil_mode = false;
+  bool count_include_pad = false;
+  exec_aten::optional<int64_t> divisor_override;
+  exec_aten::Tensor out = tfFloat.full_channels_last({1, 2, 3, 3}, 0);
+  exec_aten::Tensor out_expected = tfFloat.make_channels_last(
+      {1, 2, 3, 3},
+      {0, 0.25, 0, 1, -0.75, -0.5, 0, -0.5, 0, 0, 0, -0.5, 0, 0.25, 0, 1,
+       -0.75, -0.5});
+  op_avg_pool2d_out(
+      self,
+      kernel_size,
+      stride,
+      padding,
+      ceil_mode,
+      count_include_pad,
+      divisor_override,
+      out);
+  EXPECT_TENSOR_CLOSE(out, out_expected);
+}
@@ -156,6 +156,22 @@ TEST(OpCatOutTest, AllDtypesSupported) {
   // for those types.
 }
 
+TEST(OpCatOutTest, MixedDtypesCastToOut) {
+  TensorFactory<ScalarType::Int> tf_int;
+  TensorFactory<ScalarType::Float> tf_float;
+
+  // Inputs whose dtype differs from out's are converted element by element,
+  // the others are copied as is.
+  Tensor x = tf_float.make({2, 2}, {1.5, 2.5, 3.5, 4.5});
+  Tensor y = tf_int.make({2, 1}, {10, 20});
+  std::vector<Tensor> inputs = {x, y};
+
+  Tensor out = tf_float.zeros({2, 3});
+  op_cat_out(ArrayRef<Tensor>(inputs.data(), inputs.size()), /*dim=*/1, out);
+
+  EXPECT_TENSOR_EQ(out, tf_float.make({2, 3}, {1.5, 2.5, 10, 3.5, 4.5, 20}));
+}
+
 TEST(OpCatOutTest, EmptyInputTensorShapeIgnored) {
   if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
     GTEST_SKIP() << "ATen kernel doesn't ignore empty input tensor shape";
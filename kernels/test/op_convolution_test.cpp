@@ -12,6 +12,8 @@
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
 
 #include <gtest/gtest.h>
 
@@ -20,9 +22,11 @@ using exec_aten::ArrayRef;
 using exec_aten::optional;
 using exec_aten::ScalarType;
 using exec_aten::Tensor;
+using torch::executor::MemoryAllocator;
 using torch::executor::testing::TensorFactory;
 
-Tensor& op_convolution_out(
+Tensor& convolution_out_with_temp_allocator(
+    MemoryAllocator* temp_allocator,
     const Tensor& input,
     const Tensor& weight,
     const optional<Tensor>& bias,
@@ -33,7 +37,7 @@ Tensor& op_convolution_out(
     ArrayRef<int64_t> output_padding,
     int64_t groups,
     Tensor& out) {
-  exec_aten::RuntimeContext context{};
+  exec_aten::RuntimeContext context(/*event_tracer=*/nullptr, temp_allocator);
   return torch::executor::aten::convolution_outf(
       context,
       input,
@@ -48,6 +52,34 @@ Tensor& op_convolution_out(
       out);
 }
 
+// Gives the kernel temp memory, which some implementations use for scratch.
+Tensor& op_convolution_out(
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    ArrayRef<int64_t> stride,
+    ArrayRef<int64_t> padding,
+    ArrayRef<int64_t> dilation,
+    bool transposed,
+    ArrayRef<int64_t> output_padding,
+    int64_t groups,
+    Tensor& out) {
+  static uint8_t temp_memory[256 * 1024];
+  MemoryAllocator temp_allocator(sizeof(temp_memory), temp_memory);
+  return convolution_out_with_temp_allocator(
+      &temp_allocator,
+      input,
+      weight,
+      bias,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      out);
+}
+
 /* Correctness Test Template for test code generation via Python */
 /* %python
 correctness_test_template = f"""
@@ -467,3 +499,51 @@ TEST(OpConvOut, DynamicShapeUnbound) {
   test_dynamic_shape(
       {1, 1, 1}, torch::executor::TensorShapeDynamism::DYNAMIC_UNBOUND);
 }
+
+TEST(OpConvOut, TempMemoryIsOptional) {
+  // Kernels may log when they fall back to not using temp memory.
+  torch::executor::runtime_init();
+
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor input = tf.make(
+      {1, 2, 3, 3}, {0,  1,  2,  3,  4,  5,  6,  7,  8,
+                     9, 10, 11, 12, 13, 14, 15, 16, 17});
+  Tensor weight = tf.ones({1, 2, 2, 2});
+  optional<Tensor> bias(tf.make({1}, {1}));
+  Tensor expected = tf.make({1, 1, 2, 2}, {53, 61, 77, 85});
+
+  int64_t stride[] = {1, 1};
+  int64_t padding[] = {0, 0};
+  int64_t dilation[] = {1, 1};
+  int64_t output_padding[] = {0};
+
+  Tensor out = tf.zeros({1, 1, 2, 2});
+  op_convolution_out(
+      input,
+      weight,
+      bias,
+      stride,
+      padding,
+      dilation,
+      false,
+      output_padding,
+      1,
+      out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+
+  Tensor out_without_temp = tf.zeros({1, 1, 2, 2});
+  convolution_out_with_temp_allocator(
+      /*temp_allocator=*/nullptr,
+      input,
+      weight,
+      bias,
+      stride,
+      padding,
+      dilation,
+      false,
+      output_padding,
+      1,
+      out_without_temp);
+  EXPECT_TENSOR_CLOSE(out_without_temp, expected);
+}
@@ -205,6 +205,28 @@ TEST(OpCumSumOutTest, SimpleGeneratedCase) {
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
 
+TEST(OpCumSumOutTest, LongScanSpansSeveralBlocks) {
+  TensorFactory<ScalarType::Int> tf_int;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  // Long enough to be scanned in parallel blocks, e.g. the offsets of a
+  // ragged batch.
+  const int32_t size = 100003;
+  std::vector<int32_t> lengths(size);
+  std::vector<int64_t> offsets(size);
+  int64_t offset = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    lengths[i] = i % 7;
+    offset += lengths[i];
+    offsets[i] = offset;
+  }
+
+  Tensor x = tf_int.make({size}, lengths);
+  Tensor out = tf_long.zeros({size});
+  op_cumsum_out(x, 0, ScalarType::Long, out);
+  EXPECT_TENSOR_EQ(out, tf_long.make({size}, offsets));
+}
+
 TEST(OpCumSumOutTest, DynamicShapeUpperBoundSameAsExpected) {
   TensorFactory<ScalarType::Float> tf;
 
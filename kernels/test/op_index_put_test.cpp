@@ -637,6 +637,24 @@ void test_dtype() {
   EXPECT_TENSOR_EQ(ret_alt_with_bool, tf.zeros(out_size));
 }
 
+TEST(OpIndexPutOutTest, OutAliasesInput) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // A cache of 3 positions of 2 values each, updated at position 1 in place,
+  // as memory planning does for mutable buffers
+  Tensor cache = tf.make({1, 3, 2}, {1., 2., 3., 4., 5., 6.});
+  optional<Tensor> indices[] = {
+      optional<Tensor>(), optional<Tensor>(tfl.make({1}, {1}))};
+  Tensor values = tf.make({1, 1, 2}, {7., 8.});
+
+  Tensor ret =
+      op_index_put_out(cache, indices, values, /*accumulate=*/false, cache);
+
+  EXPECT_TENSOR_EQ(ret, cache);
+  EXPECT_TENSOR_EQ(cache, tf.make({1, 3, 2}, {1., 2., 7., 8., 5., 6.}));
+}
+
 TEST(OpIndexPutOutTest, AllDtypesSupportedForInput) {
 #define TEST_ENTRY(ctype, dtype) \
   test_dtype<ScalarType::dtype, ScalarType::Long>();
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+Tensor& op_masked_softmax_out(
+    const Tensor& self,
+    const Tensor& mask,
+    optional<int64_t> dim,
+    optional<int64_t> mask_type,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::aten::_masked_softmax_outf(
+      context, self, mask, dim, mask_type, out);
+}
+
+TEST(OpMaskedSoftmaxOutTest, SameShapeMask) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tb;
+
+  // clang-format off
+  Tensor in = tf.make(
+    {2, 3},
+    {
+      0, 1, 2,
+      3, 4, 5
+    });
+  Tensor mask = tb.make(
+    {2, 3},
+    {
+      false, false, false,
+      false, true, false
+    });
+  // clang-format on
+  Tensor out = tf.zeros({2, 3});
+
+  Tensor ret = op_masked_softmax_out(in, mask, /*dim=*/1, /*mask_type=*/2, out);
+  EXPECT_TENSOR_EQ(ret, out);
+
+  // clang-format off
+  Tensor expected = tf.make(
+    {2, 3},
+    {
+      0.0900306, 0.244728, 0.665241,
+      0.119203,  0,        0.880797
+    });
+  // clang-format on
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpMaskedSoftmaxOutTest, FullyMaskedRowIsZero) {
+  TensorFactory<ScalarType::Double> tf;
+  TensorFactory<ScalarType::Bool> tb;
+
+  Tensor in = tf.make({2, 2}, {1, 2, 3, 4});
+  Tensor mask = tb.make({2, 2}, {true, true, false, false});
+  Tensor out = tf.zeros({2, 2});
+
+  op_masked_softmax_out(in, mask, /*dim=*/{}, /*mask_type=*/{}, out);
+
+  Tensor expected = tf.make({2, 2}, {0, 0, 0.268941, 0.731059});
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpMaskedSoftmaxOutTest, CausalSrcMask) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tb;
+
+  // (B, H, L, L) = (1, 2, 2, 2) scores with an (L, L) causal mask.
+  Tensor in = tf.make({1, 2, 2, 2}, {0, 1, 2, 3, 4, 5, 6, 7});
+  Tensor mask = tb.make({2, 2}, {false, true, false, false});
+  Tensor out = tf.zeros({1, 2, 2, 2});
+
+  op_masked_softmax_out(in, mask, /*dim=*/3, /*mask_type=*/0, out);
+
+  // clang-format off
+  Tensor expected = tf.make(
+    {1, 2, 2, 2},
+    {
+      1, 0, 0.268941, 0.731059,
+      1, 0, 0.268941, 0.731059
+    });
+  // clang-format on
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpMaskedSoftmaxOutTest, KeyPaddingMask) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tb;
+
+  // (B, H, L, L) = (2, 1, 2, 2) scores with a (B, L) padding mask that hides
+  // the last key of the second batch.
+  Tensor in = tf.make({2, 1, 2, 2}, {0, 1, 2, 3, 4, 5, 6, 7});
+  Tensor mask = tb.make({2, 2}, {false, false, false, true});
+  Tensor out = tf.zeros({2, 1, 2, 2});
+
+  op_masked_softmax_out(in, mask, /*dim=*/-1, /*mask_type=*/1, out);
+
+  // clang-format off
+  Tensor expected = tf.make(
+    {2, 1, 2, 2},
+    {
+      0.268941, 0.731059, 0.268941, 0.731059,
+      1,        0,        1,        0
+    });
+  // clang-format on
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpMaskedSoftmaxOutTest, LongRowsMatchSoftmax) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tb;
+
+  // Rows long enough to take the vectorized path, with nothing masked.
+  constexpr int32_t kSize = 67;
+  std::vector<float> in_data(2 * kSize);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  Tensor in = tf.make({2, kSize}, in_data);
+  Tensor mask = tb.zeros({2, kSize});
+  Tensor out = tf.zeros({2, kSize});
+  op_masked_softmax_out(in, mask, /*dim=*/1, /*mask_type=*/2, out);
+
+  Tensor expected = tf.zeros({2, kSize});
+  exec_aten::RuntimeContext context{};
+  torch::executor::aten::_softmax_outf(
+      context, in, /*dim=*/1, /*half_to_float=*/false, expected);
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpMaskedSoftmaxOutTest, MismatchedMaskShapeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tb;
+
+  Tensor in = tf.ones({2, 3});
+  Tensor mask = tb.zeros({3, 2});
+  Tensor out = tf.zeros({2, 3});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      op_masked_softmax_out(in, mask, /*dim=*/1, /*mask_type=*/2, out));
+}
+
+TEST(OpMaskedSoftmaxOutTest, NonLastDimDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tb;
+
+  Tensor in = tf.ones({2, 3});
+  Tensor mask = tb.zeros({2, 3});
+  Tensor out = tf.zeros({2, 3});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      op_masked_softmax_out(in, mask, /*dim=*/0, /*mask_type=*/2, out));
+}
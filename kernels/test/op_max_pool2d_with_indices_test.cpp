@@ -285,3 +285,76 @@ TEST(OpMaxPool2DWithIndicesOutTest, SanityTest3D) {
   EXPECT_TENSOR_CLOSE(out, out_expected);
   EXPECT_TENSOR_CLOSE(indices, indices_expected);
 }
+
+TEST(OpMaxPool2DWithIndicesOutTest, Kernel3x3Stride2WithTies) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Long> tfLong;
+
+  // Windows that hold their maximum more than once report its first index.
+  exec_aten::Tensor self = tfFloat.make(
+      {1, 2, 5, 5},
+      {-4, 1,  -3, 2, -2, -1, 4,  0, -4, 1,  2,  -2, 3, -1, 4,  -4, 1,
+       -3, 2,  -2, -1, 4, 0,  -4, 1, 3,  -1, 4,  0,  -4, -3, 2,  -2, 3,
+       -1, 0,  -4, 1, -3, 2,  3,  -1, 4, 0,  -4, -3, 2,  -2, 3,  -1});
+  ::std::vector<int64_t> kernel_size_vec = {3, 3};
+  exec_aten::ArrayRef<int64_t> kernel_size = exec_aten::ArrayRef<int64_t>(
+      kernel_size_vec.data(), kernel_size_vec.size());
+  ::std::vector<int64_t> stride_vec = {2, 2};
+  exec_aten::ArrayRef<int64_t> stride =
+      exec_aten::ArrayRef<int64_t>(stride_vec.data(), stride_vec.size());
+  ::std::vector<int64_t> padding_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> padding =
+      exec_aten::ArrayRef<int64_t>(padding_vec.data(), padding_vec.size());
+  ::std::vector<int64_t> dilation_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> dilation =
+      exec_aten::ArrayRef<int64_t>(dilation_vec.data(), dilation_vec.size());
+  bool ceil_mode = false;
+  exec_aten::Tensor out = tfFloat.zeros({1, 2, 3, 3});
+  exec_aten::Tensor indices = tfLong.zeros({1, 2, 3, 3});
+  exec_aten::Tensor out_expected = tfFloat.make(
+      {1, 2, 3, 3}, {4, 4, 2, 4, 4, 4, 4, 4, 2, 3, 4, 3, 3, 4, 3, 3, 4, 3});
+  exec_aten::Tensor indices_expected = tfLong.make(
+      {1, 2, 3, 3},
+      {6, 6, 3, 6, 6, 14, 21, 21, 18, 0, 2, 8, 15, 17, 8, 15, 17, 23});
+  op_max_pool2d_with_indices_out(
+      self, kernel_size, stride, padding, dilation, ceil_mode, out, indices);
+  EXPECT_TENSOR_CLOSE(out, out_expected);
+  EXPECT_TENSOR_CLOSE(indices, indices_expected);
+}
+
+TEST(OpMaxPool2DWithIndicesOutTest, ChannelsLast) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Long> tfLong;
+
+  // The input of Kernel3x3Stride2WithTies, with channels as the innermost dim
+  // of the data. Indices still count pixels within a channel.
+  exec_aten::Tensor self = tfFloat.make_channels_last(
+      {1, 2, 5, 5},
+      {-4, 3,  1, -1, -3, 4,  2,  0,  -2, -4, -1, -3, 4,  2,  0,  -2, -4,
+       3,  1,  -1, 2, 0,  -2, -4, 3,  1,  -1, -3, 4,  2,  -4, 3,  1,  -1,
+       -3, 4,  2, 0,  -2, -4, -1, -3, 4,  2,  0,  -2, -4, 3,  1,  -1});
+  ::std::vector<int64_t> kernel_size_vec = {3, 3};
+  exec_aten::ArrayRef<int64_t> kernel_size = exec_aten::ArrayRef<int64_t>(
+      kernel_size_vec.data(), kernel_size_vec.size());
+  ::std::vector<int64_t> stride_vec = {2, 2};
+  exec_aten::ArrayRef<int64_t> stride =
+      exec_aten::ArrayRef<int64_t>(stride_vec.data(), stride_vec.size());
+  ::std::vector<int64_t> padding_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> padding =
+      exec_aten::ArrayRef<int64_t>(padding_vec.data(), padding_vec.size());
+  ::std::vector<int64_t> dilation_vec = {1, 1};
+  exec_aten::ArrayRef<int64_t> dilation =
+      exec_aten::ArrayRef<int64_t>(dilation_vec.data(), dilation_vec.size());
+  bool ceil_mode = false;
+  exec_aten::Tensor out = tfFloat.full_channels_last({1, 2, 3, 3}, 0);
+  exec_aten::Tensor indices = tfLong.full_channels_last({1, 2, 3, 3}, 0);
+  exec_aten::Tensor out_expected = tfFloat.make_channels_last(
+      {1, 2, 3, 3}, {4, 3, 4, 4, 2, 3, 4, 3, 4, 4, 4, 3, 4, 3, 4, 4, 2, 3});
+  exec_aten::Tensor indices_expected = tfLong.make_channels_last(
+      {1, 2, 3, 3},
+      {6, 0, 6, 2, 3, 8, 6, 15, 6, 17, 14, 8, 21, 15, 21, 17, 18, 23});
+  op_max_pool2d_with_indices_out(
+      self, kernel_size, stride, padding, dilation, ceil_mode, out, indices);
+  EXPECT_TENSOR_CLOSE(out, out_expected);
+  EXPECT_TENSOR_CLOSE(indices, indices_expected);
+}
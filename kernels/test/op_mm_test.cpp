@@ -80,11 +80,27 @@ TEST(OpMmOutTest, AllDtypesSupported) {
 #define TEST_ENTRY(ctype, dtype) test_dtype<ctype, ScalarType::dtype>();
   ET_FORALL_REAL_TYPES(TEST_ENTRY);
 #undef TEST_ENTRY
-  // TODO: Also add tests for half, complex, quantized, and other types. Easiest
+  test_dtype<exec_aten::Half, ScalarType::Half>();
+  test_dtype<exec_aten::BFloat16, ScalarType::BFloat16>();
+  // TODO: Also add tests for complex, quantized, and other types. Easiest
   // way to do that would be to make TensorFactory support zeros() and ones()
   // for those types.
 }
 
+TEST(OpMmOutTest, BFloat16AccumulatesInFloat) {
+  TensorFactory<ScalarType::BFloat16> tf;
+
+  // 512 is exact in BFloat16, but a BFloat16 sum of ones stops growing at 256
+  // because 257 rounds back down to 256.
+  Tensor x = tf.ones({1, 512});
+  Tensor y = tf.ones({512, 1});
+  Tensor out = tf.zeros({1, 1});
+
+  op_mm_out(x, y, out);
+
+  EXPECT_TENSOR_EQ(out, tf.full({1, 1}, 512));
+}
+
 TEST(OpMmOutTest, EmptyInputWithEmptyOutTensorPasses) {
   TensorFactory<ScalarType::Float> tf;
 
@@ -825,3 +825,36 @@ TEST(OpNativeBatchNormLegitNoTrainingOutTest, SampleAtomicTestNoWeightNoBias) {
   EXPECT_TENSOR_CLOSE(out1, out1_expected);
   EXPECT_TENSOR_CLOSE(out2, out2_expected);
 }
+
+TEST(OpNativeBatchNormLegitNoTrainingOutTest, ChannelsLast) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+
+  // Channels are the innermost dim of the data
+  exec_aten::Tensor input =
+      tfFloat.make_channels_last({1, 2, 1, 2}, {3, 2, 5, 4});
+  exec_aten::optional<exec_aten::Tensor> weight =
+      exec_aten::optional<exec_aten::Tensor>(tfFloat.make({2}, {2, 1}));
+  exec_aten::optional<exec_aten::Tensor> bias =
+      exec_aten::optional<exec_aten::Tensor>(tfFloat.make({2}, {0, 1}));
+  exec_aten::Tensor running_mean = tfFloat.make({2}, {1, 2});
+  exec_aten::Tensor running_var = tfFloat.make({2}, {4, 1});
+  double momentum = 0.1;
+  double eps = 0;
+  exec_aten::Tensor out0 = tfFloat.full_channels_last({1, 2, 1, 2}, 0);
+  exec_aten::Tensor out1 = tfFloat.zeros({0});
+  exec_aten::Tensor out2 = tfFloat.zeros({0});
+  exec_aten::Tensor out0_expected =
+      tfFloat.make_channels_last({1, 2, 1, 2}, {2, 1, 4, 3});
+  op_native_batch_norm_legit_no_training_out(
+      input,
+      weight,
+      bias,
+      running_mean,
+      running_var,
+      momentum,
+      eps,
+      out0,
+      out1,
+      out2);
+  EXPECT_TENSOR_CLOSE(out0, out0_expected);
+}
@@ -301,6 +301,90 @@ TEST(OpNativeLayerNormTest, FloatTensors) {
   run_floating_point_test_cases<ScalarType::Double>();
 }
 
+// Half and BFloat16 keep about 3 and 2 significant decimal digits, so they are
+// compared with a looser tolerance than run_test_cases() uses.
+template <ScalarType DTYPE>
+void run_reduced_precision_test_case() {
+  TensorFactory<DTYPE> tf;
+
+  Tensor in = tf.make({2, 3}, {1.0, 0.0, -1.0, -1.0, 4.0, 0.0});
+  Tensor weight = tf.ones({3});
+  Tensor bias = tf.zeros({3});
+  Tensor out0 = tf.zeros({2, 3});
+  Tensor out1 =
+      tf.zeros({2, 3}, torch::executor::TensorShapeDynamism::DYNAMIC_BOUND);
+  Tensor out2 =
+      tf.zeros({2, 3}, torch::executor::TensorShapeDynamism::DYNAMIC_BOUND);
+  std::vector<int64_t> normalized_shape = {3};
+
+  op_native_layer_norm_out(
+      in,
+      IntArrayRef(normalized_shape.data(), normalized_shape.size()),
+      weight,
+      bias,
+      1.0e-5,
+      out0,
+      out1,
+      out2);
+
+  Tensor expected = tf.make(
+      {2, 3}, {1.22474, 0.0000, -1.22474, -0.925819, 1.38873, -0.46291});
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out0, expected, /*rtol=*/1e-2, /*atol=*/1e-2);
+}
+
+TEST(OpNativeLayerNormTest, HalfAndBFloat16Tensors) {
+  run_reduced_precision_test_case<ScalarType::Half>();
+  run_reduced_precision_test_case<ScalarType::BFloat16>();
+}
+
+TEST(OpNativeLayerNormTest, HalfMatchesFloatOnLongRows) {
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Half> tf_half;
+
+  // Rows long enough that kernels may accumulate their moments in pieces.
+  constexpr int32_t kRows = 3;
+  constexpr int32_t kCols = 1000;
+  std::vector<float> in_data(kRows * kCols);
+  std::vector<exec_aten::Half> in_data_half(in_data.size());
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    // Multiples of 0.5 in [-3, 3], which Half represents exactly.
+    in_data[i] = static_cast<float>(i % 13) * 0.5f - 3.0f;
+    in_data_half[i] = exec_aten::Half(in_data[i]);
+  }
+  std::vector<int64_t> normalized_shape = {kCols};
+  IntArrayRef shape(normalized_shape.data(), normalized_shape.size());
+
+  Tensor in = tf_float.make({kRows, kCols}, in_data);
+  Tensor out0 = tf_float.zeros({kRows, kCols});
+  Tensor out1 = tf_float.zeros({kRows, 1});
+  Tensor out2 = tf_float.zeros({kRows, 1});
+  op_native_layer_norm_out(
+      in, shape, nullopt, nullopt, 1.0e-5, out0, out1, out2);
+
+  Tensor in_half = tf_half.make({kRows, kCols}, in_data_half);
+  Tensor out0_half = tf_half.zeros({kRows, kCols});
+  Tensor out1_half = tf_half.zeros({kRows, 1});
+  Tensor out2_half = tf_half.zeros({kRows, 1});
+  op_native_layer_norm_out(
+      in_half,
+      shape,
+      nullopt,
+      nullopt,
+      1.0e-5,
+      out0_half,
+      out1_half,
+      out2_half);
+
+  const float* expected_data = out0.const_data_ptr<float>();
+  std::vector<exec_aten::Half> expected(
+      expected_data, expected_data + out0.numel());
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out0_half,
+      tf_half.make({kRows, kCols}, expected),
+      /*rtol=*/1e-2,
+      /*atol=*/1e-2);
+}
+
 TEST(OpNativeLayerNormTest, IntTensorsDies) {
   // Cannot be represented by a type other than float.
   run_int_test_cases<ScalarType::Int>();
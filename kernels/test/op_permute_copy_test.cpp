@@ -461,3 +461,33 @@ TEST(OpPermuteCopyKernelTest, DynamicShapeUnbound) {
   op_permute_copy_out(x, perm_aref, out);
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST(OpPermuteCopyKernelTest, LargeTransposeWithUnitDims) {
+  TensorFactory<ScalarType::Int> tf;
+
+  // Large enough to span several tiles of a blocked transpose, with a size 1
+  // dim that should not change the result.
+  const std::vector<int32_t> sizes = {2, 1, 18, 19};
+  std::vector<int32_t> in_data(2 * 18 * 19);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = i;
+  }
+  Tensor x = tf.make(sizes, in_data);
+
+  // out[a][d][b][c] = x[a][b][c][d]
+  const std::vector<int64_t> new_dim = {0, 3, 1, 2};
+  const std::vector<int32_t> new_sizes = {2, 19, 1, 18};
+  std::vector<int32_t> expected_data;
+  for (int32_t a = 0; a < 2; ++a) {
+    for (int32_t d = 0; d < 19; ++d) {
+      for (int32_t c = 0; c < 18; ++c) {
+        expected_data.push_back((a * 18 + c) * 19 + d);
+      }
+    }
+  }
+
+  Tensor out = tf.zeros(new_sizes);
+  op_permute_copy_out(
+      x, ArrayRef<int64_t>(new_dim.data(), new_dim.size()), out);
+  EXPECT_TENSOR_EQ(out, tf.make(new_sizes, expected_data));
+}
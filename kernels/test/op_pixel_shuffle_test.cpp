@@ -80,6 +80,28 @@ TEST(OpPixelShuffleOutKernelTest, LargerInputRank) {
   EXPECT_TENSOR_EQ(out, tf.ones(out_sizes));
 }
 
+TEST(OpPixelShuffleOutKernelTest, UpscaleFactor3WithBatches) {
+  TensorFactory<ScalarType::Int> tf;
+
+  std::vector<int32_t> in_data(36);
+  for (int32_t i = 0; i < 36; ++i) {
+    in_data[i] = i;
+  }
+  Tensor a = tf.make(/*sizes=*/{2, 9, 1, 2}, in_data);
+
+  const std::vector<int32_t> out_sizes = {2, 1, 3, 6};
+  Tensor out = tf.zeros(out_sizes);
+
+  op_pixel_shuffle_out(a, 3, out);
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make(
+          out_sizes,
+          {0,  2,  4,  1,  3,  5,  6,  8,  10, 7,  9,  11,
+           12, 14, 16, 13, 15, 17, 18, 20, 22, 19, 21, 23,
+           24, 26, 28, 25, 27, 29, 30, 32, 34, 31, 33, 35}));
+}
+
 // Mismatched shape tests.
 TEST(OpPixelShuffleOutKernelTest, InvalidInputChannelsDies) {
   TensorFactory<ScalarType::Int> tf;
@@ -185,6 +185,53 @@ TEST(OpScatterAddOutKernelTest, InfinityAndNANTest) {
   // clang-format on
 }
 
+TEST(OpScatterAddOutKernelTest, RepeatedIndicesAlongRows) {
+  TensorFactory<ScalarType::Long> tf_index;
+  TensorFactory<ScalarType::Float> tf_data;
+
+  // The index shares the trailing size of self and src, so whole rows are
+  // scattered, and several of them land on the same row of out.
+  const std::vector<int32_t> sizes = {2, 3, 2};
+  // clang-format off
+  Tensor src = tf_data.make(
+      /*sizes=*/{2, 4, 2},
+      {
+        1,  2,  3,  4,  5,  6,  7,  8,
+        9, 10, 11, 12, 13, 14, 15, 16
+      });
+  Tensor index = tf_index.make(
+      /*sizes=*/{2, 4, 2},
+      {
+        0, 2, 0, 2, 1, 1, 0, 0,
+        2, 2, 2, 1, 2, 0, 1, 2
+      });
+  // clang-format on
+  Tensor self = tf_data.ones(sizes);
+  Tensor out = tf_data.zeros(sizes);
+
+  op_scatter_add_out(self, 1, index, src, out);
+  // clang-format off
+  EXPECT_TENSOR_EQ(
+      out,
+      tf_data.make(sizes,
+      {
+        12,  9,  6,  7,  1,  7,
+         1, 15, 16, 13, 34, 27
+      }));
+  // clang-format on
+
+  // Runs of equal indices along the last dimension.
+  Tensor self_1d = tf_data.zeros({4});
+  Tensor out_1d = tf_data.zeros({4});
+  op_scatter_add_out(
+      self_1d,
+      0,
+      tf_index.make({6}, {0, 0, 0, 3, 3, 1}),
+      tf_data.make({6}, {1, 2, 3, 4, 5, 6}),
+      out_1d);
+  EXPECT_TENSOR_EQ(out_1d, tf_data.make({4}, {6, 6, 0, 9}));
+}
+
 // Invalid dimensions
 template <ScalarType DATA_DTYPE>
 void test_scatter_add_out_invalid_dim() {
@@ -59,6 +59,32 @@ TEST(OpSigmoidOutKernelTest, AllRealInputDoubleOutputSupport) {
 #undef TEST_ENTRY
 }
 
+TEST(OpSigmoidOutKernelTest, FloatInputFloatOutputSupport) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Long enough to cover both full vectors and a tail, and saturating at both
+  // ends.
+  const std::vector<int32_t> sizes = {20};
+  Tensor out = tf.zeros(sizes);
+
+  // clang-format off
+  op_sigmoid_out(
+      tf.make(sizes, /*data=*/{
+          -100, -8, -4, -2, -1, -0.5, -0.25, 0, 0.25, 0.5,
+          1, 2, 4, 8, 100, 3, -3, 0.75, -0.75, 1.5}),
+      out);
+
+  EXPECT_TENSOR_CLOSE(
+      out,
+      tf.make(sizes, /*data=*/{
+          0, 0.00033535013, 0.01798621, 0.119202922,
+          0.268941421, 0.377540669, 0.437823499, 0.5,
+          0.562176501, 0.622459331, 0.731058579, 0.880797078,
+          0.98201379, 0.99966465, 1, 0.952574127,
+          0.0474258732, 0.679178699, 0.320821301, 0.817574476}));
+  // clang-format on
+}
+
 // Mismatched shape tests.
 TEST(OpSigmoidOutKernelTest, MismatchedShapesDies) {
   if (SupportedFeatures::get()->is_aten) {
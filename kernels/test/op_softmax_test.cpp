@@ -83,11 +83,60 @@ void test_dtype() {
 TEST(OpSoftmaxOutTest, AllDtypesSupported) {
   test_dtype<float, ScalarType::Float>();
   test_dtype<double, ScalarType::Double>();
-  // TODO: Also add tests for half, complex, quantized, and other types. Easiest
+  // TODO: Also add tests for complex, quantized, and other types. Easiest
   // way to do that would be to make TensorFactory support zeros() and ones()
   // for those types.
 }
 
+// Half and BFloat16 keep about 3 and 2 significant decimal digits.
+template <exec_aten::ScalarType DTYPE>
+void test_reduced_precision_dtype() {
+  TensorFactory<DTYPE> tf;
+
+  // clang-format off
+  Tensor x = tf.make(
+    {2, 3},
+    {
+      0, 1, 2,
+      3, 4, 5
+    });
+  // clang-format on
+
+  Tensor out = tf.zeros({2, 3});
+
+  op_softmax_out(x, /*dim=*/1, /*half_to_float*/ false, out);
+
+  // clang-format off
+  Tensor expected = tf.make(
+    {2, 3},
+    {
+      0.0900306, 0.244728, 0.665241,
+      0.0900306, 0.244728, 0.665241
+    });
+  // clang-format on
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, /*rtol=*/1e-2, /*atol=*/1e-3);
+
+  // A strided softmax, over the outer dim.
+  op_softmax_out(x, /*dim=*/0, /*half_to_float*/ false, out);
+
+  // clang-format off
+  expected = tf.make(
+    {2, 3},
+    {
+      0.0474259, 0.0474259, 0.0474259,
+      0.952574, 0.952574, 0.952574
+    });
+  // clang-format on
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, /*rtol=*/1e-2, /*atol=*/1e-3);
+}
+
+TEST(OpSoftmaxOutTest, HalfAndBFloat16Supported) {
+  test_reduced_precision_dtype<ScalarType::Half>();
+  test_reduced_precision_dtype<ScalarType::BFloat16>();
+}
+
 TEST(OpSoftmaxOutTest, MismatchedDimensionsDies) {
   TensorFactory<ScalarType::Float> tff;
 
@@ -299,3 +348,34 @@ TEST(OpSoftmaxOutTest, DynamicShapeUnbound) {
   Tensor ret = op_softmax_out(x, 1, false, out);
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
+
+TEST(OpSoftmaxOutTest, LeadingDimWithWideInnerDim) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Softmax over dim 0 of a (2, 11) tensor, so that each softmax is strided
+  // and the inner dim does not fill a whole number of vectors. Values are
+  // large enough that exp() would overflow without subtracting the maximum.
+  std::vector<float> in_data(22, 1000);
+  std::fill(in_data.begin() + 11, in_data.end(), 1001);
+  Tensor x = tf.make({2, 11}, in_data);
+
+  std::vector<float> expected_data(22, 0.268941);
+  std::fill(expected_data.begin() + 11, expected_data.end(), 0.731059);
+  Tensor expected = tf.make({2, 11}, expected_data);
+
+  Tensor out = tf.zeros({2, 11});
+  op_softmax_out(x, /*dim=*/0, /*half_to_float=*/false, out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
+
+TEST(OpSoftmaxOutTest, LongInnermostDim) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // A softmax dim that does not fill a whole number of vectors.
+  Tensor x = tf.full({2, 19}, 1000);
+  Tensor expected = tf.full({2, 19}, 1.0 / 19);
+
+  Tensor out = tf.zeros({2, 19});
+  op_softmax_out(x, /*dim=*/1, /*half_to_float=*/false, out);
+  EXPECT_TENSOR_CLOSE(out, expected);
+}
@@ -246,6 +246,43 @@ TEST(OpToTest, NanInfSupported) {
 #undef TEST_KERNEL
 }
 
+TEST(OpToTest, HalfFloatConversions) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Half> tfh;
+
+  // Long enough to cover both the vectorized loop and its tail. Every value is
+  // exactly representable in Half.
+  std::vector<float> data(37);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i) * 0.25f - 4.0f;
+  }
+  std::vector<exec_aten::Half> half_data(data.begin(), data.end());
+
+  Tensor out_half = tfh.zeros({37});
+  op_to_copy_out(tf.make({37}, data), false, {}, out_half);
+  EXPECT_TENSOR_EQ(out_half, tfh.make({37}, half_data));
+
+  Tensor out_float = tf.zeros({37});
+  op_to_copy_out(tfh.make({37}, half_data), false, {}, out_float);
+  EXPECT_TENSOR_EQ(out_float, tf.make({37}, data));
+
+  // Halfway cases round to the even neighbor.
+  const float ulp = 1.0f / 1024;
+  std::vector<float> ties(16, 1.0f);
+  ties[0] = 1.0f + ulp / 2;
+  ties[1] = 1.0f + ulp * 3 / 2;
+  ties[15] = 1.0f + ulp * 3 / 2;
+  std::vector<float> rounded(16, 1.0f);
+  rounded[1] = 1.0f + ulp * 2;
+  rounded[15] = 1.0f + ulp * 2;
+  Tensor out_ties = tfh.zeros({16});
+  op_to_copy_out(tf.make({16}, ties), false, {}, out_ties);
+  EXPECT_TENSOR_EQ(
+      out_ties,
+      tfh.make(
+          {16}, std::vector<exec_aten::Half>(rounded.begin(), rounded.end())));
+}
+
 // To further emphasize the accuracy of our op_to, we test the conversion
 // from floating-point types to signed int types directly by the test cases
 // generated by core Pytorch directly. Such data is random generated in [-5, 5].
@@ -15,7 +15,11 @@ def make_example_generated_op_test_target():
     Makes a test for kernels/test/util generated_op_test() helper
     Here we use portable kernel. Try with `buck test xplat/executorch/kernels/test:op_<>_test`
     """
-    op_test_cpp_files = native.glob(["op_*_test.cpp"])
+    op_test_cpp_files = native.glob(
+        ["op_*_test.cpp"],
+        # Only implemented by the optimized kernels.
+        exclude = ["op_masked_softmax_test.cpp"],
+    )
 
     # The op name is from the beginning to the part without `_test.cpp` (:-9)
     op_to_test = [f[:-9] for f in op_test_cpp_files]
@@ -150,6 +154,39 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "benchmark_util",
+        exported_headers = [
+            "BenchmarkUtil.h",
+        ],
+        visibility = [
+            "//executorch/kernels/...",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:memory_allocator",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/kernel:kernel_runtime_context",
+        ],
+    )
+
+    # Times the same cases against each kernel library; compare the outputs of
+    # portable_kernel_benchmark and optimized_kernel_benchmark. The quantized
+    # kernels are timed by //executorch/kernels/quantized/test:quantized_kernel_benchmark.
+    for kernel in ("portable", "optimized"):
+        runtime.cxx_binary(
+            name = "{}_kernel_benchmark".format(kernel),
+            srcs = ["kernel_benchmark.cpp"],
+            preprocessor_flags = ["-DET_KERNEL_LIBRARY_NAME=\"{}\"".format(kernel)],
+            deps = [
+                ":benchmark_util",
+                ":function_header_wrapper_{}".format(kernel),
+                "//executorch/kernels/{}:generated_lib".format(kernel),
+                "//executorch/kernels/{}:generated_lib_headers".format(kernel),
+                "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+                "//executorch/runtime/platform:platform",
+            ],
+        )
+
     codegen_function_header_wrapper("executorch/kernels/aten", "aten")
     codegen_function_header_wrapper("executorch/kernels/portable", "portable")
     codegen_function_header_wrapper("executorch/kernels/optimized", "optimized")
@@ -160,9 +197,9 @@ def define_common_targets():
     _common_op_test("op_acos_test", ["aten", "portable"])
     _common_op_test("op_acosh_test", ["aten", "portable"])
     _common_op_test("op_add_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_addmm_test", ["aten", "portable"])
+    _common_op_test("op_addmm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_alias_copy_test", ["aten", "portable"])
-    _common_op_test("op_amax_test", ["aten", "portable"])
+    _common_op_test("op_amax_test", ["aten", "portable", "optimized"])
     _common_op_test("op_amin_test", ["aten", "portable"])
     _common_op_test("op_any_test", ["aten", "portable"])
     _common_op_test("op_arange_test", ["aten", "portable"])
@@ -173,28 +210,28 @@ def define_common_targets():
     _common_op_test("op_asinh_test", ["aten", "portable"])
     _common_op_test("op_atan_test", ["aten", "portable"])
     _common_op_test("op_atanh_test", ["aten", "portable"])
-    _common_op_test("op_avg_pool2d_test", ["aten", "portable"])
+    _common_op_test("op_avg_pool2d_test", ["aten", "portable", "optimized"])
     _common_op_test("op_bitwise_and_test", ["aten", "portable"])
     _common_op_test("op_bitwise_not_test", ["aten", "portable"])
     _common_op_test("op_bitwise_or_test", ["aten", "portable"])
     _common_op_test("op_bitwise_xor_test", ["aten", "portable"])
     _common_op_test("op_bmm_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_cat_test", ["aten", "portable"])
+    _common_op_test("op_cat_test", ["aten", "portable", "optimized"])
     _common_op_test("op_ceil_test", ["aten", "portable"])
     _common_op_test("op_clamp_test", ["aten", "portable"])
     _common_op_test("op_clone_test", ["aten", "portable"])
     _common_op_test("op_constant_pad_nd_test", ["aten", "portable"])
-    _common_op_test("op_convolution_test", ["aten", "portable"])
+    _common_op_test("op_convolution_test", ["aten", "portable", "optimized"])
     _common_op_test("op_copy_test", ["aten", "portable"])
-    _common_op_test("op_cos_test", ["aten", "portable"])
+    _common_op_test("op_cos_test", ["aten", "portable", "optimized"])
     _common_op_test("op_cosh_test", ["aten", "portable"])
     _common_op_test("op_cumsum_test", ["aten", "portable"])
     _common_op_test("op_detach_copy_test", ["aten", "portable"])
     _common_op_test("op_div_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_embedding_test", ["aten", "portable"])
+    _common_op_test("op_embedding_test", ["aten", "portable", "optimized"])
     _common_op_test("op_empty_test", ["aten", "portable"])
     _common_op_test("op_eq_test", ["aten", "portable"])
-    _common_op_test("op_erf_test", ["aten", "portable"])
+    _common_op_test("op_erf_test", ["aten", "portable", "optimized"])
     _common_op_test("op_exp_test", ["aten", "portable", "optimized"])
     _common_op_test("op_expand_copy_test", ["aten", "portable"])
     _common_op_test("op_fill_test", ["aten", "portable"])
@@ -217,7 +254,7 @@ def define_common_targets():
     _common_op_test("op_leaky_relu_test", ["aten", "portable"])
     _common_op_test("op_lift_fresh_copy_test", ["aten", "portable"])
     _common_op_test("op_log_softmax_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_log_test", ["aten", "portable"])
+    _common_op_test("op_log_test", ["aten", "portable", "optimized"])
     _common_op_test("op_logical_and_test", ["aten", "portable"])
     _common_op_test("op_logical_not_test", ["aten", "portable"])
     _common_op_test("op_logical_or_test", ["aten", "portable"])
@@ -225,12 +262,13 @@ def define_common_targets():
     _common_op_test("op_logit_test", ["aten", "portable"])
     _common_op_test("op_lt_test", ["aten", "portable"])
     _common_op_test("op_masked_fill_test", ["aten", "portable"])
+    _common_op_test("op_masked_softmax_test", ["optimized"])
     _common_op_test("op_max_test", ["aten", "portable"])
-    _common_op_test("op_max_pool2d_with_indices_test", ["aten", "portable"])
-    _common_op_test("op_mean_test", ["aten", "portable"])
+    _common_op_test("op_max_pool2d_with_indices_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_mean_test", ["aten", "portable", "optimized"])
     _common_op_test("op_min_test", ["aten", "portable"])
     _common_op_test("op_minimum_test", ["aten", "portable"])
-    _common_op_test("op_mm_test", ["aten", "portable"])
+    _common_op_test("op_mm_test", ["aten", "portable", "optimized"])
     _common_op_test("op_mul_test", ["aten", "portable", "optimized"])
     _common_op_test("op_pow_test", ["aten", "portable"])
     _common_op_test("op_native_batch_norm_test", ["aten", "portable"])
@@ -239,7 +277,7 @@ def define_common_targets():
     _common_op_test("op_neg_test", ["aten", "portable", "optimized"])
     _common_op_test("op_nonzero_test", ["aten", "portable"])
     _common_op_test("op_ones_test", ["aten", "portable"])
-    _common_op_test("op_permute_copy_test", ["aten", "portable"])
+    _common_op_test("op_permute_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_pixel_shuffle_test", ["aten", "portable"])
     _common_op_test("op_reciprocal_test", ["aten", "portable"])
     _common_op_test("op_relu_test", ["aten", "portable"])
@@ -252,29 +290,29 @@ def define_common_targets():
     _common_op_test("op_scatter_add_test", ["aten", "portable"])
     _common_op_test("op_select_scatter_test", ["aten", "portable"])
     _common_op_test("op_select_copy_test", ["aten", "portable"])
-    _common_op_test("op_sigmoid_test", ["aten", "portable"])
+    _common_op_test("op_sigmoid_test", ["aten", "portable", "optimized"])
     _common_op_test("op_sign_test", ["aten", "portable"])
-    _common_op_test("op_sin_test", ["aten", "portable"])
+    _common_op_test("op_sin_test", ["aten", "portable", "optimized"])
     _common_op_test("op_sinh_test", ["aten", "portable"])
     _common_op_test("op_slice_scatter_test", ["aten", "portable"])
     _common_op_test("op_slice_copy_test", ["aten", "portable"])
-    _common_op_test("op_softmax_test", ["aten", "portable"])
+    _common_op_test("op_softmax_test", ["aten", "portable", "optimized"])
     _common_op_test("op_split_copy_test", ["aten", "portable"])
     _common_op_test("op_split_with_sizes_copy_test", ["aten", "portable"])
     _common_op_test("op_sqrt_test", ["aten", "portable"])
     _common_op_test("op_squeeze_copy_test", ["aten", "portable"])
     _common_op_test("op_stack_test", ["aten", "portable"])
     _common_op_test("op_sub_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_sum_test", ["aten", "portable"])
-    _common_op_test("op_t_copy_test", ["aten", "portable"])
+    _common_op_test("op_sum_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_t_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_tan_test", ["aten", "portable"])
-    _common_op_test("op_tanh_test", ["aten", "portable"])
-    _common_op_test("op_to_copy_test", ["aten", "portable"])
-    _common_op_test("op_transpose_copy_test", ["aten", "portable"])
+    _common_op_test("op_tanh_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_to_copy_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_transpose_copy_test", ["aten", "portable", "optimized"])
     _common_op_test("op_tril_test", ["aten", "portable"])
     _common_op_test("op_unbind_copy_test", ["aten", "portable"])
     _common_op_test("op_unsqueeze_copy_test", ["aten", "portable"])
-    _common_op_test("op_var_test", ["aten", "portable"])
+    _common_op_test("op_var_test", ["aten", "portable", "optimized"])
     _common_op_test("op_view_copy_test", ["aten", "portable"])
     _common_op_test("op_where_test", ["aten", "portable"])
     _common_op_test("op_zeros_test", ["aten", "portable"])
@@ -5,6 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 import dataclasses
+import logging
 import struct
 from collections import OrderedDict
 from enum import Enum
@@ -15,6 +16,8 @@ from prettytable import PrettyTable
 
 # This version number should match the one defined in profiler.h
 ET_PROF_VER = 0x00000001
+# Version of the aggregated profiling section, also defined in profiler.h
+ET_PROF_AGG_VER = 0x00010001
 
 # This string defines the layout of the prof_result_t struct
 # defined in executorch/profiler/profiler.h. This is used to
@@ -28,6 +31,10 @@ PROF_HEADER_STRUCT_FMT = "32s7I0Q"
 PROF_RESULT_STRUCT_FMT = "32siIQQ0Q"
 ALLOCATOR_STRUCT_FMT = "32sQ0Q"
 ALLOCATION_STRUCT_FMT = "2I0Q"
+# Layouts of prof_agg_header_t and prof_agg_event_t. The number of histogram
+# buckets in prof_agg_event_t is read from the header.
+PROF_AGG_HEADER_STRUCT_FMT = "6I0Q"
+PROF_AGG_EVENT_STRUCT_FMT = "32si3I4Q{num_buckets}I0Q"
 CHAIN_IDX_NO_CHAIN = -1
 
 
@@ -106,6 +113,81 @@ class MemEvent:
     total_allocations_done: int
 
 
+@dataclasses.dataclass
+class ProfileAggregate:
+    """
+    Running stats of an event logged by a runtime built with PROFILING_AGGREGATE,
+    over every time the event ran. Times are in the requested time scale and
+    percentiles are estimated from the histogram.
+    """
+
+    name: str
+    chain_idx: int
+    instruction_idx: int
+    count: int
+    avg: float
+    min: float
+    max: float
+    p50: float
+    p90: float
+    p99: float
+    # Number of durations in each histogram bucket, in ticks.
+    histogram: List[int]
+
+
+def scale_time(ticks: float, time_scale: TimeScale) -> float:
+    time_div_factor = {
+        TimeScale.CPU_CYCLES: 1,
+        TimeScale.TIME_IN_MS: 1,
+        TimeScale.TIME_IN_US: 1000,
+        TimeScale.TIME_IN_NS: 1000000,
+    }
+    div_factor = time_div_factor[time_scale]
+    if div_factor == 1:
+        return ticks
+    return round(ticks / div_factor, 4)
+
+
+def agg_bucket_bounds(bucket: int, sub_bucket_bits: int) -> Tuple[int, int]:
+    """
+    Returns the range of durations [low, high) in ticks that fall into a
+    histogram bucket. Mirrors agg_bucket() in profiler.cpp.
+    """
+    sub_buckets = 1 << sub_bucket_bits
+    if bucket < sub_buckets:
+        return bucket, bucket + 1
+    shift = bucket // sub_buckets - 1
+    low = (sub_buckets + bucket % sub_buckets) << shift
+    return low, low + (1 << shift)
+
+
+def agg_percentile(
+    histogram: List[int],
+    sub_bucket_bits: int,
+    count: int,
+    min_ticks: int,
+    max_ticks: int,
+    percentile: float,
+) -> float:
+    """
+    Estimates a percentile in ticks by interpolating within the histogram bucket
+    that contains it.
+    """
+    rank = percentile / 100 * count
+    seen = 0
+    for bucket, num in enumerate(histogram):
+        if num == 0 or seen + num < rank:
+            seen += num
+            continue
+        low, high = agg_bucket_bounds(bucket, sub_bucket_bits)
+        if bucket == len(histogram) - 1:
+            # The last bucket also holds every longer duration.
+            high = max(high, max_ticks + 1)
+        estimate = low + (high - low) * (rank - seen) / num
+        return min(max(estimate, min_ticks), max_ticks)
+    return max_ticks
+
+
 def adjust_time_scale(event: ProfileData, time_scale: TimeScale):
     time_div_factor = {
         TimeScale.CPU_CYCLES: 1,
@@ -245,7 +327,7 @@ def deserialize_profile_results(
     prof_result_struct_size = struct.calcsize(PROF_RESULT_STRUCT_FMT)
     prof_blocks = OrderedDict()
     allocator_dict = {}
-    base_offset = 0
+    base_offset = _prof_agg_section_size(buff)
 
     while base_offset < len(buff):
         # Unpack the header for this profiling block from which we can figure
@@ -322,6 +404,166 @@ def deserialize_profile_results(
     return parse_prof_blocks(prof_blocks, allocator_dict, time_scale)
 
 
+def _prof_agg_section_size(buff: bytes) -> int:
+    """
+    Returns the size of the aggregated section at the start of the profiling
+    buffer, or 0 if the runtime wasn't built with PROFILING_AGGREGATE.
+    """
+    if len(buff) < struct.calcsize(PROF_AGG_HEADER_STRUCT_FMT):
+        return 0
+    (
+        prof_ver,
+        num_buckets,
+        _,
+        max_entries,
+        _,
+        _,
+    ) = struct.unpack_from(PROF_AGG_HEADER_STRUCT_FMT, buff)
+    if prof_ver != ET_PROF_AGG_VER:
+        return 0
+    header_size = struct.calcsize(PROF_AGG_HEADER_STRUCT_FMT)
+    event_size = struct.calcsize(
+        PROF_AGG_EVENT_STRUCT_FMT.format(num_buckets=num_buckets)
+    )
+    return header_size + max_entries * event_size
+
+
+def deserialize_profile_aggregates(
+    buff: bytes, time_scale: TimeScale = TimeScale.TIME_IN_NS
+) -> Dict[str, List[ProfileAggregate]]:
+    """
+    Returns the aggregated events of a runtime built with PROFILING_AGGREGATE,
+    grouped by the name of the profiling block they were logged in. Returns an
+    empty dictionary for other runtimes.
+    """
+    agg_section_size = _prof_agg_section_size(buff)
+    if agg_section_size == 0:
+        return OrderedDict()
+
+    (
+        _,
+        num_buckets,
+        sub_bucket_bits,
+        _,
+        entries,
+        dropped_events,
+    ) = struct.unpack_from(PROF_AGG_HEADER_STRUCT_FMT, buff)
+    if dropped_events > 0:
+        logging.warning(
+            f"{dropped_events} profiling events were dropped because there were "
+            "more distinct events than MAX_PROFILE_AGG_ENTRIES."
+        )
+
+    # The aggregated events refer to the profiling blocks that follow by index.
+    block_names = []
+    base_offset = agg_section_size
+    while base_offset < len(buff):
+        prof_header_args = list(
+            struct.unpack_from(PROF_HEADER_STRUCT_FMT, buff, offset=base_offset)
+        )
+        prof_header_args[0] = prof_header_args[0].decode("utf-8").replace("\u0000", "")
+        prof_header = ProfilerHeader(*prof_header_args)
+        block_names.append(prof_header.name)
+        base_offset += (
+            struct.calcsize(PROF_HEADER_STRUCT_FMT)
+            + struct.calcsize(PROF_RESULT_STRUCT_FMT) * prof_header.max_prof_entries
+            + struct.calcsize(ALLOCATOR_STRUCT_FMT) * prof_header.max_allocator_entries
+            + struct.calcsize(ALLOCATION_STRUCT_FMT) * prof_header.max_mem_prof_entries
+        )
+
+    event_fmt = PROF_AGG_EVENT_STRUCT_FMT.format(num_buckets=num_buckets)
+    event_size = struct.calcsize(event_fmt)
+    aggregates = OrderedDict()
+    for i in range(entries):
+        (
+            name_bytes,
+            chain_idx,
+            instruction_idx,
+            block_idx,
+            _,
+            count,
+            sum_ticks,
+            min_ticks,
+            max_ticks,
+            *histogram,
+        ) = struct.unpack_from(
+            event_fmt,
+            buff,
+            offset=struct.calcsize(PROF_AGG_HEADER_STRUCT_FMT) + i * event_size,
+        )
+        if count == 0:
+            # The event never ended.
+            continue
+
+        def percentile(p: float) -> float:
+            return scale_time(
+                agg_percentile(
+                    histogram, sub_bucket_bits, count, min_ticks, max_ticks, p
+                ),
+                time_scale,
+            )
+
+        block_name = (
+            block_names[block_idx] if block_idx < len(block_names) else "default"
+        )
+        aggregates.setdefault(block_name, []).append(
+            ProfileAggregate(
+                name_bytes.decode("utf-8").replace("\u0000", ""),
+                chain_idx,
+                instruction_idx,
+                count,
+                scale_time(sum_ticks / count, time_scale),
+                scale_time(min_ticks, time_scale),
+                scale_time(max_ticks, time_scale),
+                percentile(50),
+                percentile(90),
+                percentile(99),
+                histogram,
+            )
+        )
+    return aggregates
+
+
+def profile_aggregate_table(
+    aggregates: Dict[str, List[ProfileAggregate]]
+) -> List[PrettyTable]:
+    tables = []
+    for name, aggregate_list in aggregates.items():
+        table = PrettyTable()
+        table.title = name + " aggregated"
+        table.add_rows(
+            [
+                (
+                    entry.name,
+                    entry.chain_idx,
+                    entry.instruction_idx,
+                    entry.count,
+                    entry.avg,
+                    entry.min,
+                    entry.p50,
+                    entry.p90,
+                    entry.p99,
+                    entry.max,
+                )
+                for entry in aggregate_list
+            ]
+        )
+        table.field_names = [
+            "Name",
+            "Chain",
+            "Instr",
+            "Count",
+            "Avg",
+            "Min",
+            "P50",
+            "P90",
+            "P99",
+            "Max",
+        ]
+        tables.append(table)
+    return tables
+
+
 def profile_table(
     profile_data: Dict[str, List[ProfileEvent]], model_buffer=None
 ) -> List[PrettyTable]:
@@ -330,6 +572,9 @@ def profile_table(
     max_len = 0
 
     for name, prof_entries_list in profile_data.items():
+        if len(prof_entries_list) == 0:
+            # Blocks of an aggregating runtime only hold memory events.
+            continue
         table = PrettyTable()
         table.title = name
         table.add_rows(
@@ -8,9 +8,11 @@ import argparse
 import sys
 
 from executorch.profiler.parse_profiler_results import (
+    deserialize_profile_aggregates,
     deserialize_profile_results,
     mem_profile_table,
     profile_aggregate_framework_tax,
+    profile_aggregate_table,
     profile_framework_tax_table,
     profile_table,
 )
@@ -35,6 +37,12 @@ def main() -> int:
     for table in prof_tables_agg:
         print(table)
 
+    aggregate_tables = profile_aggregate_table(
+        deserialize_profile_aggregates(out_bytes)
+    )
+    for table in aggregate_tables:
+        print(table)
+
     mem_prof_tables = mem_profile_table(mem_allocations)
     for table in mem_prof_tables:
         print(table)
@@ -8,11 +8,47 @@
 
 #pragma once
 
+#include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/event_tracer.h>
 
 namespace torch {
 namespace executor {
 
+/**
+ * A handle that an asynchronous backend uses to report that an execution it
+ * started has finished. Trivially copyable, so backends can keep it past the
+ * end of their `execute()` call.
+ */
+class BackendCompletion final {
+ public:
+  /// Receives the result of the asynchronous execution.
+  using CompletionFn = void (*)(void* context, Error status);
+
+  BackendCompletion() = default;
+  BackendCompletion(CompletionFn fn, void* context)
+      : fn_(fn), context_(context) {}
+
+  /// Returns true if this handle can be completed.
+  bool valid() const {
+    return fn_ != nullptr;
+  }
+
+  /**
+   * Reports the result of the execution. Must be called exactly once for each
+   * `execute()` call that returned `Error::Pending`, after all outputs have
+   * been written. May be called from any thread.
+   */
+  void complete(Error status) const {
+    if (fn_ != nullptr) {
+      fn_(context_, status);
+    }
+  }
+
+ private:
+  CompletionFn fn_ = nullptr;
+  void* context_ = nullptr;
+};
+
 /**
  * BackendExecutionContext will be used to inject run time context.
  * The current plan is to add temp allocator and event tracer (for profiling) as
@@ -20,8 +56,10 @@ namespace executor {
  */
 class BackendExecutionContext final {
  public:
-  BackendExecutionContext(EventTracer* event_tracer = nullptr)
-      : event_tracer_(event_tracer) {}
+  BackendExecutionContext(
+      EventTracer* event_tracer = nullptr,
+      BackendCompletion completion = BackendCompletion())
+      : event_tracer_(event_tracer), completion_(completion) {}
 
   /**
    * Returns a pointer to an instance of EventTracer to do profiling/debugging
@@ -32,8 +70,26 @@ class BackendExecutionContext final {
     return event_tracer_;
   }
 
+  /**
+   * Returns true if the caller accepts asynchronous completion. Only then may
+   * `execute()` return `Error::Pending`, after which the backend must call
+   * `completion().complete()` once the work has finished.
+   */
+  bool can_complete_async() const {
+    return completion_.valid();
+  }
+
+  /**
+   * Returns the handle to complete an execution that returned
+   * `Error::Pending`. Invalid unless `can_complete_async()` is true.
+   */
+  BackendCompletion completion() const {
+    return completion_;
+  }
+
  private:
   EventTracer* event_tracer_ = nullptr;
+  BackendCompletion completion_;
 };
 
 } // namespace executor
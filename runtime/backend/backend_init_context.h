@@ -18,8 +18,11 @@ namespace executor {
  */
 class BackendInitContext final {
  public:
-  BackendInitContext(MemoryAllocator* runtime_allocator)
-      : runtime_allocator_(runtime_allocator) {}
+  BackendInitContext(
+      MemoryAllocator* runtime_allocator,
+      bool processed_is_mapped = false)
+      : runtime_allocator_(runtime_allocator),
+        processed_is_mapped_(processed_is_mapped) {}
 
   /** Get the runtime allocator passed from Method. It's the same runtime
    * executor used by the standard executor runtime and the life span is the
@@ -29,8 +32,24 @@ class BackendInitContext final {
     return runtime_allocator_;
   }
 
+  /**
+   * Returns true if the `processed` buffer passed to init() is a read-only
+   * mapping of the program file, e.g. from an MmapDataLoader, rather than a
+   * copy in RAM. The backend may then keep the buffer, or move it elsewhere,
+   * and reference its contents in place, e.g. weights, instead of copying
+   * them: the data stays valid until the buffer is freed, and only costs
+   * reclaimable page cache.
+   *
+   * If false, the backend should copy what it needs and free the buffer, as
+   * keeping it pins a private copy of the data.
+   */
+  bool is_processed_mapped() const {
+    return processed_is_mapped_;
+  }
+
  private:
   MemoryAllocator* runtime_allocator_;
+  bool processed_is_mapped_;
 };
 
 } // namespace executor
@@ -80,6 +80,20 @@ class PyTorchBackendInterface {
       FreeableBuffer* processed,
       ArrayRef<CompileSpec> compile_specs) const = 0;
 
+  /**
+   * Returns true if init() may run on any thread, concurrently with other
+   * init() calls of this and other backends. Method::init() then initializes
+   * the delegates of such backends in parallel on the threadpool, when the
+   * runtime is built with one.
+   *
+   * The allocator of the BackendInitContext may be used concurrently: the
+   * runtime serializes its calls. Any other state that init() shares between
+   * calls, such as caches, must be guarded by the backend.
+   */
+  __ET_NODISCARD virtual bool is_init_thread_safe() const {
+    return false;
+  }
+
   /**
    * Responsible for executing the given method’s handle, as it was produced
    * by compile.
@@ -89,12 +103,136 @@ class PyTorchBackendInterface {
    *     delegate blobs.
    * @param[in] args The method’s inputs and outputs.
    * @retval Error::Ok if successful.
+   * @retval Error::Pending if `context.can_complete_async()` is true and the
+   *     backend has started work that will finish later. The backend must call
+   *     `context.completion().complete()` once the outputs in `args` have been
+   *     written. Must not be returned when `can_complete_async()` is false.
    */
   __ET_NODISCARD virtual Error execute(
       BackendExecutionContext& context,
       DelegateHandle* handle,
       EValue** args) const = 0;
 
+  /**
+   * Returns true if the backend implements bind() and execute_bound(). The
+   * runtime then calls bind() only when the storage of a delegate call's
+   * arguments changed since the previous call, and execute_bound() instead
+   * of execute().
+   */
+  __ET_NODISCARD virtual bool supports_binding() const {
+    return false;
+  }
+
+  /**
+   * Binds the arguments of subsequent execute_bound() calls to a handle, so
+   * that the backend can resolve and cache their data pointers once.
+   *
+   * The runtime calls bind() before the first execute_bound() and again
+   * whenever the args array or the data pointer of one of its tensors
+   * changed, e.g. after Method::set_input() or set_output_data_ptr(). `args`
+   * stays valid until the next bind(), so anything else that may change
+   * between calls, such as tensor shapes or scalar values, must be read
+   * through it at execute time.
+   *
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @param[in] args The method’s inputs and outputs.
+   * @retval Error::Ok if successful. On failure, the runtime calls bind()
+   *     again before the next execution.
+   */
+  __ET_NODISCARD virtual Error bind(
+      __ET_UNUSED DelegateHandle* handle,
+      __ET_UNUSED EValue** args) const {
+    return Error::NotSupported;
+  }
+
+  /**
+   * Executes the handle with the arguments of the most recent bind(). Same
+   * contract as `execute()` otherwise.
+   */
+  __ET_NODISCARD virtual Error execute_bound(
+      __ET_UNUSED BackendExecutionContext& context,
+      __ET_UNUSED DelegateHandle* handle) const {
+    return Error::NotSupported;
+  }
+
+  /**
+   * Does the work that the backend would otherwise do lazily in the first
+   * execute() of a handle, such as allocating workspaces, compiling
+   * pipelines or loading the model onto an accelerator, for
+   * Method::warmup(). May be called any time after `init()` while the handle
+   * is not executing, and possibly more than once. execute() must still work
+   * if it is never called.
+   *
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @retval Error::Ok if successful, or if the backend has nothing to
+   *     prepare.
+   */
+  __ET_NODISCARD virtual Error prepare(
+      __ET_UNUSED DelegateHandle* handle) const {
+    return Error::Ok;
+  }
+
+  /**
+   * Returns the bytes that a handle holds outside of the runtime's
+   * allocators, such as workspaces, packed weights or device buffers, for
+   * Method::memory_stats(). Memory that several handles share, like a shared
+   * workspace, may be reported by each of them.
+   *
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @retval Error::NotSupported if the backend does not track its memory.
+   */
+  __ET_NODISCARD virtual Result<size_t> get_memory_usage(
+      __ET_UNUSED DelegateHandle* handle) const {
+    return Error::NotSupported;
+  }
+
+  /**
+   * Returns the size in bytes of the data that `update_constant()` takes for
+   * a constant that the handle holds, without changing anything.
+   * Method::set_constants() checks every name with this before it replaces
+   * any constant, so backends that implement `update_constant()` must
+   * implement this too.
+   *
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @param[in] name The fully qualified name of the constant, as passed to
+   *     `update_constant()`.
+   * @retval Error::NotFound if the handle does not hold a constant of this
+   *     name.
+   * @retval Error::NotSupported if the backend can't replace constants.
+   */
+  __ET_NODISCARD virtual Result<size_t> get_constant_nbytes(
+      __ET_UNUSED DelegateHandle* handle,
+      __ET_UNUSED const char* name) const {
+    return Error::NotSupported;
+  }
+
+  /**
+   * Replaces a constant that the handle holds its own copy of, e.g. a weight
+   * that was lowered into the processed data and packed by `init()`, for
+   * Method::set_constants(). Only the handles that hold the named constant
+   * need to repack anything.
+   *
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @param[in] name The fully qualified name of the nn.Module parameter or
+   *     buffer that the constant holds.
+   * @param[in] data The new data, laid out like the original tensor, or
+   *     nullptr to go back to the constant of the processed data. Stays valid
+   *     until the next call for the same name or until the handle is
+   *     destroyed.
+   * @param[in] nbytes The size of `data` in bytes.
+   * @retval Error::Ok if the handle holds the constant and now uses `data`.
+   * @retval Error::NotFound if the handle does not hold a constant of this
+   *     name.
+   * @retval Error::NotSupported if the backend can't replace constants.
+   */
+  __ET_NODISCARD virtual Error update_constant(
+      __ET_UNUSED DelegateHandle* handle,
+      __ET_UNUSED const char* name,
+      __ET_UNUSED const void* data,
+      __ET_UNUSED size_t nbytes) const {
+    return Error::NotSupported;
+  }
+
   /**
    * Responsible for destroying a handle, if it's required for some backend.
    * It may be needed for some backends. For example, resources associated with
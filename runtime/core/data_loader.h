@@ -37,6 +37,65 @@ class DataLoader {
       size_t offset,
       size_t size) = 0;
 
+  /**
+   * Receives the result of a LoadAsync(): the loaded data, or the error that
+   * prevented loading it.
+   *
+   * @param[in] context The `context` passed to LoadAsync().
+   * @param[in] result The data on success, which the callee now owns.
+   */
+  using LoadCallback = void (*)(void* context, Result<FreeableBuffer> result);
+
+  /**
+   * Starts loading `size` bytes at byte offset `offset`, and calls
+   * `callback(context, result)` exactly once when the load completes. The
+   * callback may run on any thread, and may run before this call returns.
+   *
+   * Lets callers keep loading on a thread that must not block on I/O. The
+   * default implementation calls Load() and then the callback on the calling
+   * thread.
+   *
+   * NOTE: This must be thread-safe, like Load().
+   *
+   * @retval Error::Ok The load was started, and `callback` will be called.
+   * @returns Other errors if the load could not be started, in which case
+   *     `callback` will not be called.
+   */
+  __ET_NODISCARD virtual Error
+  LoadAsync(size_t offset, size_t size, LoadCallback callback, void* context) {
+    callback(context, Load(offset, size));
+    return Error::Ok;
+  }
+
+  /**
+   * Hints that `Load(offset, size)` will be called soon, so that the
+   * implementation can start reading the data in the background, e.g. into
+   * the OS page cache. Must not block on the I/O, and must be thread-safe.
+   *
+   * Calling this is optional, and it has no observable effect other than on
+   * the speed of a later Load().
+   *
+   * @retval Error::Ok The hint was accepted.
+   * @retval Error::NotSupported The implementation ignores hints. This is the
+   *     default.
+   */
+  __ET_NODISCARD virtual Error Prefetch(size_t offset, size_t size) {
+    (void)offset;
+    (void)size;
+    return Error::NotSupported;
+  }
+
+  /**
+   * Returns true if the buffers that Load() returns are read-only mappings of
+   * the data source, e.g. `mmap()`ed file pages, rather than copies. Such a
+   * buffer stays valid until it is freed, even after this loader is
+   * destroyed, and keeping it only costs reclaimable page cache. Consumers
+   * can then reference its contents in place instead of copying them.
+   */
+  virtual bool loads_mapped_data() const {
+    return false;
+  }
+
   /**
    * Returns the length of the underlying data source, typically the file size.
    */
@@ -44,6 +44,10 @@ enum class Error : error_code_t {
   /// Status indicating there are no more steps of execution to run
   EndOfMethod = 0x03,
 
+  /// Status indicating an asynchronous operation has started but has not yet
+  /// completed
+  Pending = 0x04,
+
   /*
    * Logical errors.
    */
@@ -67,6 +67,94 @@ struct EventTracerEntry {
   /// executorch/exir/backend/utils.py.
   DelegateDebugIdType delegate_event_id_type;
 };
+
+/// Memory id of a tensor that memory planning did not place, such as a
+/// constant or a tensor whose memory is allocated at runtime.
+constexpr int32_t kUnplannedMemoryId = -1;
+
+/**
+ * A tensor that an instruction read or wrote, and where memory planning
+ * placed it. Passed to EventTracer::log_instruction_memory().
+ **/
+struct TensorMemoryAccess {
+  /// Id of the planned memory buffer that holds the tensor, as serialized in
+  /// its AllocationDetails, or kUnplannedMemoryId.
+  int32_t memory_id;
+  /// Offset of the tensor in that buffer, in bytes.
+  uint64_t memory_offset;
+  /// Size of the tensor's data, in bytes.
+  uint64_t nbytes;
+  /// True if the instruction wrote the tensor, false if it read it.
+  bool is_write;
+};
+
+/**
+ * A phase of loading a Program or initializing a Method, with the I/O and
+ * memory that it took. Passed to EventTracer::log_load_event().
+ **/
+struct LoadEvent {
+  /// Name of the phase, e.g. "Method::parse_values". For the load and init of
+  /// a single delegate, the id of its backend.
+  const char* name;
+  /// Index of the delegate in the method's plan for the phase of a single
+  /// delegate, or -1.
+  int32_t delegate_index;
+  /// The time at which the phase started.
+  et_timestamp_t start_time;
+  /// The time at which the phase ended.
+  et_timestamp_t end_time;
+  /// Bytes that the phase read through the Program's DataLoader. Data that was
+  /// already loaded, such as inline constants, is not counted.
+  uint64_t bytes_loaded;
+  /// Bytes that the phase allocated from the method allocator. Zero for the
+  /// phases of Program::load(), which has no method allocator.
+  uint64_t bytes_allocated;
+};
+
+/// The most dimensions of an output that IntermediateOutput records sizes for.
+constexpr size_t kMaxLoggedOutputDims = 16;
+
+/**
+ * Summary statistics of a tensor, cheap enough to compute for every output of
+ * every instruction of a production-size run.
+ **/
+struct TensorStats {
+  /// Number of elements.
+  uint64_t numel;
+  /// Minimum, maximum and mean of the elements that are not NaN. All 0 if
+  /// there are none, or if the dtype is not a number, e.g. a quantized type.
+  double min;
+  double max;
+  double mean;
+  /// Number of NaN elements.
+  uint64_t nan_count;
+  /// A 64-bit hash of the tensor's bytes. Outputs with equal bytes have equal
+  /// hashes, so that two runs can be compared without keeping their data.
+  uint64_t hash;
+};
+
+/**
+ * A tensor that an instruction output. Passed to
+ * EventTracer::log_intermediate_output().
+ **/
+struct IntermediateOutput {
+  /// Index of the tensor among the outputs of the instruction.
+  uint32_t output_index;
+  /// The tensor's ScalarType, as its integer value.
+  int8_t scalar_type;
+  /// Number of dimensions of the tensor.
+  uint32_t dim;
+  /// The sizes of the first kMaxLoggedOutputDims dimensions.
+  int64_t sizes[kMaxLoggedOutputDims];
+  TensorStats stats;
+  /// The tensor's data if the instruction is one whose full outputs were
+  /// requested with set_full_output_debug_handles(), nullptr otherwise. Only
+  /// valid during the call.
+  const void* data;
+  /// Size of the tensor's data, in bytes.
+  size_t nbytes;
+};
+
 /**
  * EventTracer is a class that users can inherit and implement to
  * log/serialize/stream etc. the profiling and debugging events that are
@@ -210,6 +298,54 @@ class EventTracer {
    */
   virtual AllocatorID track_allocator(const char* name) = 0;
 
+  /**
+   * Log the tensors that an instruction accessed. The runtime only calls this
+   * while memory tracing is enabled, see set_memory_tracing_enabled().
+   *
+   * @param[in] chain_id Chain of the instruction.
+   * @param[in] debug_handle Index of the instruction in its chain.
+   * @param[in] bytes_read Total size of the tensors that the instruction read.
+   * @param[in] bytes_written Total size of the tensors that the instruction
+   * wrote.
+   * @param[in] accesses The tensors that the instruction accessed. This may
+   * only be a prefix of them if the instruction accessed many tensors; the
+   * byte totals always cover all of them. Only valid during this call.
+   * @param[in] num_accesses Number of entries in `accesses`.
+   */
+  virtual void log_instruction_memory(
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      size_t bytes_read,
+      size_t bytes_written,
+      const TensorMemoryAccess* accesses,
+      size_t num_accesses) = 0;
+
+  /**
+   * Log a phase of loading a Program or initializing a Method. The runtime
+   * logs these from the thread that loads, while the program or method is
+   * loading, so that cold-start time can be attributed to I/O, verification,
+   * kernel resolution or delegate initialization.
+   *
+   * @param[in] event The phase. Its name does not need to outlive this call.
+   */
+  virtual void log_load_event(const LoadEvent& event) = 0;
+
+  /**
+   * Log a tensor that an instruction output. The runtime only calls this
+   * while intermediate output logging is enabled, see
+   * set_intermediate_output_logging_enabled(), once for each output tensor of
+   * each kernel call.
+   *
+   * @param[in] chain_id Chain of the instruction.
+   * @param[in] debug_handle Index of the instruction in its chain.
+   * @param[in] output The output, with its statistics and, for the
+   * instructions requested with set_full_output_debug_handles(), its data.
+   */
+  virtual void log_intermediate_output(
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      const IntermediateOutput& output) = 0;
+
   /**
    * Helper function to set the chain id ands debug handle. Users have two
    * options, the first is that they can directly pass in the chain id and debug
@@ -236,25 +372,88 @@ class EventTracer {
    * @param[in] debug_handle Debug handle of the current instruction being
    * executed. In this context debug handle and instruction id are the same
    * thing.
+   *
+   * Implementations that are used from several threads at once override these
+   * to keep the values per thread.
    */
-  void set_chain_debug_handle(ChainID chain_id, DebugHandle debug_handle) {
+  virtual void set_chain_debug_handle(
+      ChainID chain_id,
+      DebugHandle debug_handle) {
     chain_id_ = chain_id;
     debug_handle_ = debug_handle;
   }
 
-  ChainID get_current_chain_id() {
+  virtual ChainID get_current_chain_id() {
     return chain_id_;
   }
 
-  DebugHandle get_current_debug_handle() {
+  virtual DebugHandle get_current_debug_handle() {
     return debug_handle_;
   }
 
+  /**
+   * Enables calls to log_instruction_memory(). Finding the tensors accessed
+   * by each instruction has a cost, so the runtime skips it unless enabled.
+   * Disabled by default.
+   */
+  void set_memory_tracing_enabled(bool enabled) {
+    memory_tracing_enabled_ = enabled;
+  }
+
+  bool memory_tracing_enabled() const {
+    return memory_tracing_enabled_;
+  }
+
+  /**
+   * Enables calls to log_intermediate_output(). Computing the statistics
+   * reads every output once, so the runtime skips it unless enabled.
+   * Disabled by default.
+   */
+  void set_intermediate_output_logging_enabled(bool enabled) {
+    intermediate_output_logging_enabled_ = enabled;
+  }
+
+  bool intermediate_output_logging_enabled() const {
+    return intermediate_output_logging_enabled_;
+  }
+
+  /**
+   * Requests the full data of the outputs of the instructions with these
+   * debug handles, in any chain, in addition to their statistics. Copying
+   * whole tensors is expensive, so this is meant for the few instructions
+   * that the statistics of a run point at. Has no effect unless intermediate
+   * output logging is enabled.
+   *
+   * @param[in] debug_handles The instructions. Must outlive the EventTracer,
+   * or the next call to this method. An empty list requests none.
+   * @param[in] num_debug_handles Number of entries in `debug_handles`.
+   */
+  void set_full_output_debug_handles(
+      const DebugHandle* debug_handles,
+      size_t num_debug_handles) {
+    full_output_debug_handles_ = debug_handles;
+    num_full_output_debug_handles_ = num_debug_handles;
+  }
+
+  /// Returns true if the full outputs of `debug_handle` were requested.
+  bool logs_full_output(DebugHandle debug_handle) const {
+    for (size_t i = 0; i < num_full_output_debug_handles_; ++i) {
+      if (full_output_debug_handles_[i] == debug_handle) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   virtual ~EventTracer() {}
 
  protected:
   ChainID chain_id_ = kUnsetChainId;
   DebugHandle debug_handle_ = kUnsetDebugHandle;
+  bool memory_tracing_enabled_ = false;
+  bool intermediate_output_logging_enabled_ = false;
+  const DebugHandle* full_output_debug_handles_ = nullptr;
+  size_t num_full_output_debug_handles_ = 0;
 };
 
 } // namespace executor
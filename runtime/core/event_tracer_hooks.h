@@ -198,6 +198,93 @@ inline void event_tracer_track_allocation(
 #endif
 }
 
+/// Returns true if the runtime should log the memory accessed by each
+/// instruction via event_tracer_log_instruction_memory().
+inline bool event_tracer_memory_tracing_enabled(EventTracer* event_tracer) {
+#ifdef ET_EVENT_TRACER_ENABLED
+  return event_tracer != nullptr && event_tracer->memory_tracing_enabled();
+#else //! ET_EVENT_TRACER_ENABLED
+  (void)event_tracer;
+  return false;
+#endif
+}
+
+/// Log the tensors accessed by the instruction identified by chain_id and
+/// debug_handle.
+inline void event_tracer_log_instruction_memory(
+    EventTracer* event_tracer,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    size_t bytes_read,
+    size_t bytes_written,
+    const TensorMemoryAccess* accesses,
+    size_t num_accesses) {
+#ifdef ET_EVENT_TRACER_ENABLED
+  if (event_tracer) {
+    event_tracer->log_instruction_memory(
+        chain_id,
+        debug_handle,
+        bytes_read,
+        bytes_written,
+        accesses,
+        num_accesses);
+  }
+#else //! ET_EVENT_TRACER_ENABLED
+  (void)event_tracer;
+  (void)chain_id;
+  (void)debug_handle;
+  (void)bytes_read;
+  (void)bytes_written;
+  (void)accesses;
+  (void)num_accesses;
+#endif
+}
+
+/// Log a phase of loading a Program or initializing a Method.
+inline void event_tracer_log_load_event(
+    EventTracer* event_tracer,
+    const LoadEvent& event) {
+#ifdef ET_EVENT_TRACER_ENABLED
+  if (event_tracer) {
+    event_tracer->log_load_event(event);
+  }
+#else //! ET_EVENT_TRACER_ENABLED
+  (void)event_tracer;
+  (void)event;
+#endif
+}
+
+/// Returns true if the runtime should log the outputs of each instruction via
+/// event_tracer_log_intermediate_output().
+inline bool event_tracer_intermediate_output_logging_enabled(
+    EventTracer* event_tracer) {
+#ifdef ET_EVENT_TRACER_ENABLED
+  return event_tracer != nullptr &&
+      event_tracer->intermediate_output_logging_enabled();
+#else //! ET_EVENT_TRACER_ENABLED
+  (void)event_tracer;
+  return false;
+#endif
+}
+
+/// Log an output of the instruction identified by chain_id and debug_handle.
+inline void event_tracer_log_intermediate_output(
+    EventTracer* event_tracer,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    const IntermediateOutput& output) {
+#ifdef ET_EVENT_TRACER_ENABLED
+  if (event_tracer) {
+    event_tracer->log_intermediate_output(chain_id, debug_handle, output);
+  }
+#else //! ET_EVENT_TRACER_ENABLED
+  (void)event_tracer;
+  (void)chain_id;
+  (void)debug_handle;
+  (void)output;
+#endif
+}
+
 } // namespace internal
 } // namespace executor
 } // namespace torch
@@ -30,20 +30,25 @@ namespace {
  * `tensors_are_close()`.
  *
  * T must be a floating point type. Non-floating point data should be compared
- * directly.
+ * directly. Half and BFloat16 elements are compared as float.
  */
 template <
     typename T,
-    typename = std::enable_if_t<std::is_floating_point<T>::value>>
+    typename = std::enable_if_t<
+        std::is_floating_point<T>::value ||
+        std::is_same<T, exec_aten::Half>::value ||
+        std::is_same<T, exec_aten::BFloat16>::value>>
 bool data_is_close(
     const T* a,
     const T* b,
     size_t numel,
     double rtol,
     double atol) {
+  using compare_t =
+      std::conditional_t<std::is_floating_point<T>::value, T, float>;
   for (size_t i = 0; i < numel; i++) {
-    const auto ai = a[i];
-    const auto bi = b[i];
+    const auto ai = static_cast<compare_t>(a[i]);
+    const auto bi = static_cast<compare_t>(b[i]);
 
     if (std::isnan(ai) && std::isnan(bi)) {
       // NaN == NaN
@@ -110,6 +115,20 @@ bool tensors_are_close(
         a.numel(),
         rtol,
         atol);
+  } else if (a.scalar_type() == ScalarType::Half) {
+    return data_is_close<exec_aten::Half>(
+        a.const_data_ptr<exec_aten::Half>(),
+        b.const_data_ptr<exec_aten::Half>(),
+        a.numel(),
+        rtol,
+        atol);
+  } else if (a.scalar_type() == ScalarType::BFloat16) {
+    return data_is_close<exec_aten::BFloat16>(
+        a.const_data_ptr<exec_aten::BFloat16>(),
+        b.const_data_ptr<exec_aten::BFloat16>(),
+        a.numel(),
+        rtol,
+        atol);
   } else {
     // Non-floating-point types can be compared bitwise.
     return memcmp(a.const_data_ptr(), b.const_data_ptr(), a.nbytes()) == 0;
@@ -150,6 +169,20 @@ bool tensor_data_is_close(
         a.numel(),
         rtol,
         atol);
+  } else if (a.scalar_type() == ScalarType::Half) {
+    return data_is_close<exec_aten::Half>(
+        a.const_data_ptr<exec_aten::Half>(),
+        b.const_data_ptr<exec_aten::Half>(),
+        a.numel(),
+        rtol,
+        atol);
+  } else if (a.scalar_type() == ScalarType::BFloat16) {
+    return data_is_close<exec_aten::BFloat16>(
+        a.const_data_ptr<exec_aten::BFloat16>(),
+        b.const_data_ptr<exec_aten::BFloat16>(),
+        a.numel(),
+        rtol,
+        atol);
   } else {
     // Non-floating-point types can be compared bitwise.
     return memcmp(a.const_data_ptr(), b.const_data_ptr(), a.nbytes()) == 0;
@@ -252,6 +285,8 @@ std::ostream& operator<<(std::ostream& os, const Tensor& t) {
 
   switch (t.scalar_type()) {
     ET_FORALL_REAL_TYPES_AND(Bool, PRINT_CASE)
+    PRINT_CASE(exec_aten::Half, Half)
+    PRINT_CASE(exec_aten::BFloat16, BFloat16)
     default:
       ET_CHECK_MSG(
           false,
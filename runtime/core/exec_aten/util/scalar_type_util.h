@@ -517,6 +517,21 @@ inline exec_aten::ScalarType promoteTypes(
     ET_CHECK_MSG(false, "promoteTypes not valid for bits dtypes");
   }
 
+  // BFloat16 is not in the table below. As in ATen, it wins against integral
+  // types, and promotes to Float along with Half.
+  constexpr auto bf = exec_aten::ScalarType::BFloat16;
+  if (a == bf || b == bf) {
+    const exec_aten::ScalarType other = a == bf ? b : a;
+    if (other == bf ||
+        torch::executor::isIntegralType(other, /*includeBool=*/true)) {
+      return bf;
+    }
+    if (other == f2) {
+      return f4;
+    }
+    return other == c2 ? c4 : other;
+  }
+
   // 12 types are handled by this function, see the constexpr definitions above
   const int NUM_PROMOTE_TYPES = 12;
 
@@ -546,11 +561,9 @@ inline exec_aten::ScalarType promoteTypes(
 inline size_t sizeof_scalar_type(exec_aten::ScalarType type) {
   // Reject types that are not yet supported or are out of bounds.
   ET_CHECK_MSG(
-      type != exec_aten::ScalarType::Half &&
-          type != exec_aten::ScalarType::ComplexHalf &&
+      type != exec_aten::ScalarType::ComplexHalf &&
           type != exec_aten::ScalarType::ComplexFloat &&
           type != exec_aten::ScalarType::ComplexDouble &&
-          type != exec_aten::ScalarType::BFloat16 &&
           type != exec_aten::ScalarType::Undefined,
       "Invalid or unsupported ScalarType %" PRId8,
       static_cast<int8_t>(type));
@@ -572,6 +585,41 @@ inline size_t sizeof_scalar_type(exec_aten::ScalarType type) {
   return type_size;
 }
 
+//
+// Dtype selective build
+//
+
+namespace internal {
+/// Whether the null-terminated names `a` and `b` are the same, at compile
+/// time if possible.
+inline constexpr bool kernel_name_equals(const char* a, const char* b) {
+  while (*a != '\0' && *a == *b) {
+    ++a;
+    ++b;
+  }
+  return *a == *b;
+}
+} // namespace internal
+
+#ifdef EXECUTORCH_SELECTIVE_BUILD_DTYPE
+// Generated by codegen/tools/gen_selected_op_variants.py from the selected
+// operators of a build. Defines should_include_kernel_dtype() for the dtypes
+// that its models use.
+#include "selected_op_variants.h"
+#else
+/**
+ * Whether the ET_SWITCH macros named `operator_name` handle `scalar_type`.
+ * Dtype selective builds only keep the dtypes that the selected models use,
+ * so that the compiler can drop the code for all other dtypes; the rest of
+ * the time, every dtype is kept.
+ */
+inline constexpr bool should_include_kernel_dtype(
+    __ET_UNUSED const char* operator_name,
+    __ET_UNUSED exec_aten::ScalarType scalar_type) {
+  return true;
+}
+#endif
+
 //
 // Helper macros for switch case macros (see below)
 //
@@ -582,10 +630,24 @@ inline size_t sizeof_scalar_type(exec_aten::ScalarType type) {
 
 #define ET_INTERNAL_SWITCH_CASE(enum_type, CTYPE_ALIAS, ...)  \
   case enum_type: {                                           \
+    ET_INTERNAL_CHECK_SELECTIVE_BUILD(enum_type);             \
     using CTYPE_ALIAS = ScalarTypeToCppType<enum_type>::type; \
     return __VA_ARGS__();                                     \
   }
 
+// Aborts on dtypes that a dtype selective build left out. The condition is a
+// compile-time constant for literal switch names, so the code after it is
+// dropped for those dtypes.
+#define ET_INTERNAL_CHECK_SELECTIVE_BUILD(enum_type)               \
+  if (!::torch::executor::should_include_kernel_dtype(             \
+          et_switch_name, enum_type)) {                            \
+    ET_CHECK_MSG(                                                  \
+        false,                                                     \
+        "dtype %s is not selected for %s in this build",           \
+        toString(enum_type),                                       \
+        et_switch_name);                                           \
+  }
+
 #define ET_INTERNAL_SWITCH(TYPE, CONTEXT, NAME, ...) \
   [&] {                                              \
     const auto& _st = TYPE;                          \
@@ -697,6 +759,25 @@ inline size_t sizeof_scalar_type(exec_aten::ScalarType type) {
   ET_INTERNAL_SWITCH_CASE(                                                    \
       exec_aten::ScalarType::ADDITIONAL, CTYPE_ALIAS, __VA_ARGS__)
 
+#define ET_INTERNAL_SWITCH_CASE_FLOATHBF16_TYPES(CTYPE_ALIAS, ...) \
+  ET_INTERNAL_SWITCH_CASE_FLOAT_TYPES(CTYPE_ALIAS, __VA_ARGS__)     \
+  ET_INTERNAL_SWITCH_CASE(                                          \
+      exec_aten::ScalarType::Half, CTYPE_ALIAS, __VA_ARGS__)        \
+  ET_INTERNAL_SWITCH_CASE(                                          \
+      exec_aten::ScalarType::BFloat16, CTYPE_ALIAS, __VA_ARGS__)
+
+#define ET_INTERNAL_SWITCH_CASE_REALHBF16_TYPES(CTYPE_ALIAS, ...) \
+  ET_INTERNAL_SWITCH_CASE_REAL_TYPES(CTYPE_ALIAS, __VA_ARGS__)    \
+  ET_INTERNAL_SWITCH_CASE(                                        \
+      exec_aten::ScalarType::Half, CTYPE_ALIAS, __VA_ARGS__)      \
+  ET_INTERNAL_SWITCH_CASE(                                        \
+      exec_aten::ScalarType::BFloat16, CTYPE_ALIAS, __VA_ARGS__)
+
+#define ET_INTERNAL_SWITCH_CASE_REALHBBF16_TYPES(CTYPE_ALIAS, ...)  \
+  ET_INTERNAL_SWITCH_CASE_REALHBF16_TYPES(CTYPE_ALIAS, __VA_ARGS__) \
+  ET_INTERNAL_SWITCH_CASE(                                          \
+      exec_aten::ScalarType::Bool, CTYPE_ALIAS, __VA_ARGS__)
+
 #define ET_INTERNAL_SWITCH_CASE_QINT_TYPES(CTYPE_ALIAS, ...)     \
   ET_INTERNAL_SWITCH_CASE(                                       \
       exec_aten::ScalarType::QInt8, CTYPE_ALIAS, __VA_ARGS__)    \
@@ -831,6 +912,30 @@ inline size_t sizeof_scalar_type(exec_aten::ScalarType type) {
       ET_INTERNAL_SWITCH_CASE_FLOAT_TYPES_AND(         \
           ADDITIONAL, CTYPE_ALIAS, __VA_ARGS__))
 
+// Float, Double, Half and BFloat16.
+#define ET_SWITCH_FLOATHBF16_TYPES(TYPE, CONTEXT, NAME, CTYPE_ALIAS, ...) \
+  ET_INTERNAL_SWITCH(                                                     \
+      TYPE,                                                               \
+      CONTEXT,                                                            \
+      NAME,                                                               \
+      ET_INTERNAL_SWITCH_CASE_FLOATHBF16_TYPES(CTYPE_ALIAS, __VA_ARGS__))
+
+// The REAL types, Half and BFloat16.
+#define ET_SWITCH_REALHBF16_TYPES(TYPE, CONTEXT, NAME, CTYPE_ALIAS, ...) \
+  ET_INTERNAL_SWITCH(                                                    \
+      TYPE,                                                              \
+      CONTEXT,                                                           \
+      NAME,                                                              \
+      ET_INTERNAL_SWITCH_CASE_REALHBF16_TYPES(CTYPE_ALIAS, __VA_ARGS__))
+
+// The REAL types, Half, Bool and BFloat16.
+#define ET_SWITCH_REALHBBF16_TYPES(TYPE, CONTEXT, NAME, CTYPE_ALIAS, ...) \
+  ET_INTERNAL_SWITCH(                                                     \
+      TYPE,                                                               \
+      CONTEXT,                                                            \
+      NAME,                                                               \
+      ET_INTERNAL_SWITCH_CASE_REALHBBF16_TYPES(CTYPE_ALIAS, __VA_ARGS__))
+
 #define ET_SWITCH_QINT_TYPES(TYPE, CONTEXT, NAME, CTYPE_ALIAS, ...) \
   ET_INTERNAL_SWITCH(                                               \
       TYPE,                                                         \
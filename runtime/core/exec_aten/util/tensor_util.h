@@ -1020,6 +1020,24 @@ __ET_NODISCARD Error resize_tensor_impl(
     exec_aten::TensorImpl* impl,
     exec_aten::ArrayRef<exec_aten::SizesType> new_sizes);
 
+#ifndef USE_ATEN_LIB
+/**
+ * Returns the number of bytes of storage behind the data of `impl`, which
+ * bounds how far it can be resized.
+ */
+size_t tensor_impl_capacity(const exec_aten::TensorImpl* impl);
+
+/**
+ * Points a DYNAMIC_UNBOUND tensor at new storage of `capacity` bytes so that it
+ * can be resized beyond its previous storage. The existing contents are not
+ * copied.
+ */
+__ET_NODISCARD Error set_tensor_impl_storage(
+    exec_aten::TensorImpl* impl,
+    void* data,
+    size_t capacity);
+#endif // USE_ATEN_LIB
+
 } // namespace internal
 
 /**
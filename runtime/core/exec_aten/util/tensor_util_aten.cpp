@@ -126,8 +126,11 @@ Error copy_tensor_data(const at::Tensor& t_dst, const at::Tensor& t_src) {
         t_dst.nbytes(),
         t_src.nbytes());
     // Copy the source data to the preallocated memory of the destination, which
-    // must be the same size as the source.
-    std::memcpy(dst_data_ptr, t_src.const_data_ptr(), t_src.nbytes());
+    // must be the same size as the source. Callers that wrote the input in
+    // place pass the destination's own data, which needs no copy.
+    if (dst_data_ptr != t_src.const_data_ptr()) {
+      std::memcpy(dst_data_ptr, t_src.const_data_ptr(), t_src.nbytes());
+    }
   }
 
   return Error::Ok;
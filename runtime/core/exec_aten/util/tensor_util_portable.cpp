@@ -110,8 +110,12 @@ Error copy_tensor_data(
         "t_dst.nbytes() %zu != t_src.nbytes(). %zu",
         t_dst.nbytes(),
         t_src.nbytes());
-    std::memcpy(
-        t_dst.mutable_data_ptr(), t_src.const_data_ptr(), t_src.nbytes());
+    // Callers that wrote the input in place pass the destination's own data,
+    // which needs no copy.
+    if (t_dst.const_data_ptr() != t_src.const_data_ptr()) {
+      std::memcpy(
+          t_dst.mutable_data_ptr(), t_src.const_data_ptr(), t_src.nbytes());
+    }
   }
   return Error::Ok;
 }
@@ -142,6 +146,21 @@ class TensorResizerFriend final {
       exec_aten::ArrayRef<exec_aten::SizesType> new_sizes) {
     return impl->internal_resize_contiguous(new_sizes);
   }
+
+  static size_t capacity(const exec_aten::TensorImpl* impl) {
+    return impl->capacity_;
+  }
+
+  __ET_NODISCARD static Error
+  set_storage(exec_aten::TensorImpl* impl, void* data, size_t capacity) {
+    ET_CHECK_OR_RETURN_ERROR(
+        impl->shape_dynamism() == TensorShapeDynamism::DYNAMIC_UNBOUND,
+        NotSupported,
+        "Only DYNAMIC_UNBOUND tensors can be given new storage");
+    impl->data_ = data;
+    impl->capacity_ = capacity;
+    return Error::Ok;
+  }
 };
 
 Error resize_tensor_impl(
@@ -149,6 +168,17 @@ Error resize_tensor_impl(
     torch::executor::ArrayRef<exec_aten::SizesType> new_sizes) {
   return TensorResizerFriend::resize_tensor_impl(impl, new_sizes);
 }
+
+size_t tensor_impl_capacity(const torch::executor::TensorImpl* impl) {
+  return TensorResizerFriend::capacity(impl);
+}
+
+Error set_tensor_impl_storage(
+    torch::executor::TensorImpl* impl,
+    void* data,
+    size_t capacity) {
+  return TensorResizerFriend::set_storage(impl, data, capacity);
+}
 } // namespace internal
 
 } // namespace executor
@@ -141,4 +141,18 @@ TEST(ScalarTypeUtilTest, promoteTypesTest) {
   ET_CHECK(
       promoteTypes(ScalarType::Char, ScalarType::Bool) == ScalarType::Char);
   ET_CHECK(promoteTypes(ScalarType::Bool, ScalarType::Int) == ScalarType::Int);
+
+  // BFloat16 is handled outside of the lookup table.
+  ET_CHECK(
+      promoteTypes(ScalarType::BFloat16, ScalarType::BFloat16) ==
+      ScalarType::BFloat16);
+  ET_CHECK(
+      promoteTypes(ScalarType::Long, ScalarType::BFloat16) ==
+      ScalarType::BFloat16);
+  ET_CHECK(
+      promoteTypes(ScalarType::BFloat16, ScalarType::Half) ==
+      ScalarType::Float);
+  ET_CHECK(
+      promoteTypes(ScalarType::Double, ScalarType::BFloat16) ==
+      ScalarType::Double);
 }
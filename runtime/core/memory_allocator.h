@@ -139,6 +139,18 @@ class MemoryAllocator {
     return static_cast<T*>(this->allocate(size * sizeof(T), alignment));
   }
 
+  /**
+   * Returns memory from allocate() so that later allocations can reuse it.
+   *
+   * This allocator can't reuse individual allocations, so this does nothing;
+   * the memory is reclaimed by reset(). Subclasses such as pool allocators
+   * override it.
+   *
+   * @param[in] ptr A pointer returned by allocate() on this allocator since
+   *     the last reset(), or nullptr.
+   */
+  virtual void free(__ET_UNUSED void* ptr) {}
+
   // Returns the allocator memory's base address.
   virtual uint8_t* base_address() const {
     return begin_;
@@ -149,6 +161,12 @@ class MemoryAllocator {
     return size_;
   }
 
+  // Returns the number of bytes allocated since the last reset(), including
+  // alignment padding.
+  virtual size_t used_size() const {
+    return static_cast<size_t>(cur_ - begin_);
+  }
+
   // Resets the current pointer to the base address. It does nothing to
   // the contents.
   virtual void reset() {
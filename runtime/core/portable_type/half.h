@@ -8,18 +8,405 @@
 
 #pragma once
 
+#include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <limits>
+
+// On ARMv8.2-A and later with the FP16 extension, _Float16 arithmetic compiles
+// to native half-precision instructions, which also vectorize.
+#if defined(__aarch64__) && defined(__ARM_FEATURE_FP16_SCALAR_ARITHMETIC)
+#define ET_HALF_NATIVE_ARITHMETIC 1
+#else
+#define ET_HALF_NATIVE_ARITHMETIC 0
+#endif
 
 namespace torch {
 namespace executor {
 
+namespace internal {
+
+inline float fp32_from_bits(uint32_t bits) {
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+inline uint32_t fp32_to_bits(float f) {
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+/**
+ * Converts the bits of an IEEE 754 half-precision value to float, with the
+ * bit manipulations of the FP16 library that c10/util/Half.h also uses.
+ */
+inline float fp16_ieee_to_fp32_value(uint16_t h) {
+  // Move the half to the upper bits of a word, then drop its sign.
+  const uint32_t w = static_cast<uint32_t>(h) << 16;
+  const uint32_t sign = w & UINT32_C(0x80000000);
+  const uint32_t two_w = w + w;
+
+  // Normal values: shift the exponent and mantissa into place, and rebias the
+  // exponent by scaling. Inf and NaN keep an all-ones exponent.
+  const uint32_t exp_offset = UINT32_C(0xE0) << 23;
+  const float exp_scale = 0x1.0p-112f;
+  const float normalized_value =
+      fp32_from_bits((two_w >> 4) + exp_offset) * exp_scale;
+
+  // Subnormal values: let the FPU normalize the mantissa.
+  const uint32_t magic_mask = UINT32_C(126) << 23;
+  const float magic_bias = 0.5f;
+  const float denormalized_value =
+      fp32_from_bits((two_w >> 17) | magic_mask) - magic_bias;
+
+  const uint32_t denormalized_cutoff = UINT32_C(1) << 27;
+  const uint32_t result = sign |
+      (two_w < denormalized_cutoff ? fp32_to_bits(denormalized_value)
+                                   : fp32_to_bits(normalized_value));
+  return fp32_from_bits(result);
+}
+
+/**
+ * Converts a float to the bits of the nearest IEEE 754 half-precision value,
+ * rounding ties to even.
+ */
+inline uint16_t fp16_ieee_from_fp32_value(float f) {
+  // Scaling up and back down lets the FPU round the mantissa, and saturates
+  // values that are too large to infinity.
+  const float scale_to_inf = 0x1.0p+112f;
+  const float scale_to_zero = 0x1.0p-110f;
+  float base = (std::fabs(f) * scale_to_inf) * scale_to_zero;
+
+  const uint32_t w = fp32_to_bits(f);
+  const uint32_t shl1_w = w + w;
+  const uint32_t sign = w & UINT32_C(0x80000000);
+  uint32_t bias = shl1_w & UINT32_C(0xFF000000);
+  if (bias < UINT32_C(0x71000000)) {
+    bias = UINT32_C(0x71000000);
+  }
+
+  base = fp32_from_bits((bias >> 1) + UINT32_C(0x07800000)) + base;
+  const uint32_t bits = fp32_to_bits(base);
+  const uint32_t exp_bits = (bits >> 13) & UINT32_C(0x00007C00);
+  const uint32_t mantissa_bits = bits & UINT32_C(0x00000FFF);
+  const uint32_t nonsign = exp_bits + mantissa_bits;
+  return static_cast<uint16_t>(
+      (sign >> 16) | (shl1_w > UINT32_C(0xFF000000) ? 0x7E00 : nonsign));
+}
+
+#if ET_HALF_NATIVE_ARITHMETIC
+using half_compute_t = _Float16;
+
+inline _Float16 half_compute_from_bits(uint16_t bits) {
+  _Float16 value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+inline uint16_t half_compute_to_bits(_Float16 value) {
+  uint16_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline float fp16_to_float(uint16_t bits) {
+  return static_cast<float>(half_compute_from_bits(bits));
+}
+
+inline uint16_t fp16_from_float(float value) {
+  return half_compute_to_bits(static_cast<_Float16>(value));
+}
+#else
+using half_compute_t = float;
+
+inline float half_compute_from_bits(uint16_t bits) {
+  return fp16_ieee_to_fp32_value(bits);
+}
+
+inline uint16_t half_compute_to_bits(float value) {
+  return fp16_ieee_from_fp32_value(value);
+}
+
+inline float fp16_to_float(uint16_t bits) {
+  return fp16_ieee_to_fp32_value(bits);
+}
+
+inline uint16_t fp16_from_float(float value) {
+  return fp16_ieee_from_fp32_value(value);
+}
+#endif
+
+} // namespace internal
+
 /**
  * A half-precision floating point type, compatible with c10/util/Half.h from
  * pytorch core.
+ *
+ * Values convert implicitly to and from float. Arithmetic between two Halfs
+ * produces a Half: it is computed natively where the CPU supports it (see
+ * ET_HALF_NATIVE_ARITHMETIC), and in float otherwise. Kernels that accumulate
+ * many values should accumulate in float instead.
  */
 struct alignas(2) Half {
   uint16_t x;
+
+  struct from_bits_t {};
+  static constexpr from_bits_t from_bits() {
+    return from_bits_t();
+  }
+
+  Half() = default;
+
+  constexpr Half(uint16_t bits, from_bits_t) : x(bits) {}
+
+  /* implicit */ Half(float value) : x(internal::fp16_from_float(value)) {}
+
+  operator float() const {
+    return internal::fp16_to_float(x);
+  }
 };
 
+namespace internal {
+
+inline half_compute_t half_compute(Half h) {
+  return half_compute_from_bits(h.x);
+}
+
+inline Half half_from_compute(half_compute_t value) {
+  return Half(half_compute_to_bits(value), Half::from_bits());
+}
+
+} // namespace internal
+
+/// Arithmetic with Half operands.
+
+inline Half operator+(const Half& a, const Half& b) {
+  return internal::half_from_compute(
+      internal::half_compute(a) + internal::half_compute(b));
+}
+
+inline Half operator-(const Half& a, const Half& b) {
+  return internal::half_from_compute(
+      internal::half_compute(a) - internal::half_compute(b));
+}
+
+inline Half operator*(const Half& a, const Half& b) {
+  return internal::half_from_compute(
+      internal::half_compute(a) * internal::half_compute(b));
+}
+
+inline Half operator/(const Half& a, const Half& b) {
+  return internal::half_from_compute(
+      internal::half_compute(a) / internal::half_compute(b));
+}
+
+inline Half operator-(const Half& a) {
+  return internal::half_from_compute(-internal::half_compute(a));
+}
+
+inline Half& operator+=(Half& a, const Half& b) {
+  a = a + b;
+  return a;
+}
+
+inline Half& operator-=(Half& a, const Half& b) {
+  a = a - b;
+  return a;
+}
+
+inline Half& operator*=(Half& a, const Half& b) {
+  a = a * b;
+  return a;
+}
+
+inline Half& operator/=(Half& a, const Half& b) {
+  a = a / b;
+  return a;
+}
+
+/// Arithmetic with floats, which produces floats.
+
+inline float operator+(Half a, float b) {
+  return static_cast<float>(a) + b;
+}
+inline float operator-(Half a, float b) {
+  return static_cast<float>(a) - b;
+}
+inline float operator*(Half a, float b) {
+  return static_cast<float>(a) * b;
+}
+inline float operator/(Half a, float b) {
+  return static_cast<float>(a) / b;
+}
+
+inline float operator+(float a, Half b) {
+  return a + static_cast<float>(b);
+}
+inline float operator-(float a, Half b) {
+  return a - static_cast<float>(b);
+}
+inline float operator*(float a, Half b) {
+  return a * static_cast<float>(b);
+}
+inline float operator/(float a, Half b) {
+  return a / static_cast<float>(b);
+}
+
+inline float& operator+=(float& a, const Half& b) {
+  return a += static_cast<float>(b);
+}
+inline float& operator-=(float& a, const Half& b) {
+  return a -= static_cast<float>(b);
+}
+inline float& operator*=(float& a, const Half& b) {
+  return a *= static_cast<float>(b);
+}
+inline float& operator/=(float& a, const Half& b) {
+  return a /= static_cast<float>(b);
+}
+
+/// Arithmetic with doubles, which produces doubles.
+
+inline double operator+(Half a, double b) {
+  return static_cast<double>(a) + b;
+}
+inline double operator-(Half a, double b) {
+  return static_cast<double>(a) - b;
+}
+inline double operator*(Half a, double b) {
+  return static_cast<double>(a) * b;
+}
+inline double operator/(Half a, double b) {
+  return static_cast<double>(a) / b;
+}
+
+inline double operator+(double a, Half b) {
+  return a + static_cast<double>(b);
+}
+inline double operator-(double a, Half b) {
+  return a - static_cast<double>(b);
+}
+inline double operator*(double a, Half b) {
+  return a * static_cast<double>(b);
+}
+inline double operator/(double a, Half b) {
+  return a / static_cast<double>(b);
+}
+
+/// Arithmetic with integers, which produces Halfs.
+
+inline Half operator+(Half a, int64_t b) {
+  return a + static_cast<Half>(b);
+}
+inline Half operator-(Half a, int64_t b) {
+  return a - static_cast<Half>(b);
+}
+inline Half operator*(Half a, int64_t b) {
+  return a * static_cast<Half>(b);
+}
+inline Half operator/(Half a, int64_t b) {
+  return a / static_cast<Half>(b);
+}
+
+inline Half operator+(int64_t a, Half b) {
+  return static_cast<Half>(a) + b;
+}
+inline Half operator-(int64_t a, Half b) {
+  return static_cast<Half>(a) - b;
+}
+inline Half operator*(int64_t a, Half b) {
+  return static_cast<Half>(a) * b;
+}
+inline Half operator/(int64_t a, Half b) {
+  return static_cast<Half>(a) / b;
+}
+
+inline Half operator+(Half a, int b) {
+  return a + static_cast<int64_t>(b);
+}
+inline Half operator-(Half a, int b) {
+  return a - static_cast<int64_t>(b);
+}
+inline Half operator*(Half a, int b) {
+  return a * static_cast<int64_t>(b);
+}
+inline Half operator/(Half a, int b) {
+  return a / static_cast<int64_t>(b);
+}
+
+inline Half operator+(int a, Half b) {
+  return static_cast<int64_t>(a) + b;
+}
+inline Half operator-(int a, Half b) {
+  return static_cast<int64_t>(a) - b;
+}
+inline Half operator*(int a, Half b) {
+  return static_cast<int64_t>(a) * b;
+}
+inline Half operator/(int a, Half b) {
+  return static_cast<int64_t>(a) / b;
+}
+
 } // namespace executor
 } // namespace torch
+
+namespace std {
+
+template <>
+class numeric_limits<torch::executor::Half> {
+  using Half = torch::executor::Half;
+
+ public:
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = false;
+  static constexpr bool has_infinity = true;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = true;
+  static constexpr auto has_denorm = numeric_limits<float>::has_denorm;
+  static constexpr auto round_style = numeric_limits<float>::round_style;
+  static constexpr bool is_iec559 = true;
+  static constexpr bool is_bounded = true;
+  static constexpr bool is_modulo = false;
+  static constexpr int digits = 11;
+  static constexpr int digits10 = 3;
+  static constexpr int max_digits10 = 5;
+  static constexpr int radix = 2;
+  static constexpr int min_exponent = -13;
+  static constexpr int min_exponent10 = -4;
+  static constexpr int max_exponent = 16;
+  static constexpr int max_exponent10 = 4;
+
+  static constexpr Half min() {
+    return Half(0x0400, Half::from_bits());
+  }
+  static constexpr Half lowest() {
+    return Half(0xFBFF, Half::from_bits());
+  }
+  static constexpr Half max() {
+    return Half(0x7BFF, Half::from_bits());
+  }
+  static constexpr Half epsilon() {
+    return Half(0x1400, Half::from_bits());
+  }
+  static constexpr Half round_error() {
+    return Half(0x3800, Half::from_bits());
+  }
+  static constexpr Half infinity() {
+    return Half(0x7C00, Half::from_bits());
+  }
+  static constexpr Half quiet_NaN() {
+    return Half(0x7E00, Half::from_bits());
+  }
+  static constexpr Half signaling_NaN() {
+    return Half(0x7D00, Half::from_bits());
+  }
+  static constexpr Half denorm_min() {
+    return Half(0x0001, Half::from_bits());
+  }
+};
+
+} // namespace std
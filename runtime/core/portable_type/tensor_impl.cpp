@@ -143,8 +143,13 @@ Error TensorImpl::internal_resize_contiguous(ArrayRef<SizesType> new_sizes) {
 
   auto new_numel = compute_numel(new_sizes.data(), dim_);
 
-  // Upper bounded tensors can be reshaped but not beyond upper bound
-  if (shape_dynamism_ == TensorShapeDynamism::DYNAMIC_BOUND) {
+  // Upper bounded tensors can be reshaped but not beyond upper bound.
+  // Unbounded tensors can't outgrow their storage either, unless they don't
+  // have any yet; the runtime gives them more storage before resizing them
+  // beyond it.
+  if (shape_dynamism_ == TensorShapeDynamism::DYNAMIC_BOUND ||
+      (shape_dynamism_ == TensorShapeDynamism::DYNAMIC_UNBOUND &&
+       data_ != nullptr)) {
     auto new_nbytes = new_numel * sizeof_scalar_type(type_);
     ET_CHECK_OR_RETURN_ERROR(
         new_nbytes <= capacity_,
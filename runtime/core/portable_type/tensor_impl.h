@@ -166,6 +166,11 @@ class TensorImpl {
   /// Sets the underlying data blob to the passed in pointer.
   void set_data(void* ptr);
 
+  /// Returns the mutability of the shape of the tensor.
+  TensorShapeDynamism shape_dynamism() const {
+    return shape_dynamism_;
+  }
+
   /*
    * DEPRECATED: Use torch::executor::resize_tensor() or
    * torch::executor::resize_tensor_impl().
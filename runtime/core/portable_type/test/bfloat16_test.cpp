@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/core/portable_type/bfloat16.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+namespace torch {
+namespace executor {
+
+TEST(BFloat16Test, RoundTripsExactValues) {
+  for (float f : {0.0f, -0.0f, 1.0f, -2.5f, 256.0f, 3.3895314e38f}) {
+    EXPECT_EQ(static_cast<float>(BFloat16(f)), f);
+  }
+}
+
+TEST(BFloat16Test, RoundsToNearestEven) {
+  // 257 is halfway between 256 and 258; the tie goes to the even mantissa.
+  EXPECT_EQ(static_cast<float>(BFloat16(257.0f)), 256.0f);
+  EXPECT_EQ(static_cast<float>(BFloat16(259.0f)), 260.0f);
+  EXPECT_EQ(static_cast<float>(BFloat16(257.5f)), 258.0f);
+}
+
+TEST(BFloat16Test, SpecialValues) {
+  EXPECT_TRUE(std::isinf(static_cast<float>(BFloat16(INFINITY))));
+  EXPECT_TRUE(std::isnan(static_cast<float>(BFloat16(NAN))));
+  // Rounding must not turn a NaN whose payload is in the low bits into inf.
+  EXPECT_TRUE(std::isnan(static_cast<float>(
+      BFloat16(std::numeric_limits<float>::signaling_NaN()))));
+  EXPECT_EQ(BFloat16(-0.0f).x, 0x8000);
+}
+
+TEST(BFloat16Test, Arithmetic) {
+  const BFloat16 a(1.5f);
+  const BFloat16 b(0.25f);
+  EXPECT_EQ(static_cast<float>(a + b), 1.75f);
+  EXPECT_EQ(static_cast<float>(a - b), 1.25f);
+  EXPECT_EQ(static_cast<float>(a * b), 0.375f);
+  EXPECT_EQ(static_cast<float>(a / b), 6.0f);
+  EXPECT_EQ(static_cast<float>(-a), -1.5f);
+
+  // Mixed with float, the result is a float and is not rounded to BFloat16.
+  EXPECT_EQ(a + 1e-3f, 1.5f + 1e-3f);
+
+  BFloat16 c = a;
+  c += b;
+  EXPECT_EQ(static_cast<float>(c), 1.75f);
+}
+
+TEST(BFloat16Test, NumericLimits) {
+  using limits = std::numeric_limits<BFloat16>;
+  EXPECT_EQ(static_cast<float>(limits::max()), 3.3895314e38f);
+  EXPECT_EQ(
+      static_cast<float>(limits::min()), std::numeric_limits<float>::min());
+  EXPECT_EQ(static_cast<float>(limits::epsilon()), 0.0078125f);
+  EXPECT_TRUE(std::isinf(static_cast<float>(limits::infinity())));
+  EXPECT_TRUE(std::isnan(static_cast<float>(limits::quiet_NaN())));
+  EXPECT_TRUE(std::isnan(static_cast<float>(limits::signaling_NaN())));
+}
+
+} // namespace executor
+} // namespace torch
@@ -16,7 +16,7 @@ namespace executor {
 TEST(TensorTest, InvalidScalarType) {
   TensorImpl::SizesType sizes[1] = {1};
   // A type that executorch doesn't support yet.
-  ET_EXPECT_DEATH({ TensorImpl x(ScalarType::BFloat16, 1, sizes); }, "");
+  ET_EXPECT_DEATH({ TensorImpl x(ScalarType::ComplexFloat, 1, sizes); }, "");
 
   // The literal Undefined type.
   ET_EXPECT_DEATH({ TensorImpl y(ScalarType::Undefined, 1, sizes); }, "");
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/core/portable_type/half.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+namespace torch {
+namespace executor {
+
+TEST(HalfTest, RoundTripsExactValues) {
+  for (float f : {0.0f, -0.0f, 1.0f, -2.5f, 0.099975586f, 65504.0f}) {
+    EXPECT_EQ(static_cast<float>(Half(f)), f);
+  }
+  // The smallest subnormal.
+  EXPECT_EQ(static_cast<float>(Half(5.9604645e-8f)), 5.9604645e-8f);
+}
+
+TEST(HalfTest, RoundsToNearestEven) {
+  // 2049 is halfway between 2048 and 2050; the tie goes to the even mantissa.
+  EXPECT_EQ(static_cast<float>(Half(2049.0f)), 2048.0f);
+  EXPECT_EQ(static_cast<float>(Half(2051.0f)), 2052.0f);
+  EXPECT_EQ(Half(1.0f + 1e-4f).x, Half(1.0f).x);
+}
+
+TEST(HalfTest, SpecialValues) {
+  EXPECT_TRUE(std::isinf(static_cast<float>(Half(1e6f))));
+  EXPECT_TRUE(std::isinf(static_cast<float>(Half(-1e6f))));
+  EXPECT_TRUE(std::isnan(static_cast<float>(Half(NAN))));
+  EXPECT_EQ(Half(0.0f).x, 0x0000);
+  EXPECT_EQ(Half(-0.0f).x, 0x8000);
+}
+
+TEST(HalfTest, Arithmetic) {
+  const Half a(1.5f);
+  const Half b(0.25f);
+  EXPECT_EQ(static_cast<float>(a + b), 1.75f);
+  EXPECT_EQ(static_cast<float>(a - b), 1.25f);
+  EXPECT_EQ(static_cast<float>(a * b), 0.375f);
+  EXPECT_EQ(static_cast<float>(a / b), 6.0f);
+  EXPECT_EQ(static_cast<float>(-a), -1.5f);
+
+  // Mixed with float, the result is a float and is not rounded to Half.
+  EXPECT_EQ(a + 1e-4f, 1.5f + 1e-4f);
+
+  Half c = a;
+  c += b;
+  EXPECT_EQ(static_cast<float>(c), 1.75f);
+}
+
+TEST(HalfTest, NumericLimits) {
+  using limits = std::numeric_limits<Half>;
+  EXPECT_EQ(static_cast<float>(limits::max()), 65504.0f);
+  EXPECT_EQ(static_cast<float>(limits::lowest()), -65504.0f);
+  EXPECT_EQ(static_cast<float>(limits::min()), 6.1035156e-5f);
+  EXPECT_EQ(static_cast<float>(limits::epsilon()), 9.765625e-4f);
+  EXPECT_TRUE(std::isinf(static_cast<float>(limits::infinity())));
+  EXPECT_TRUE(std::isnan(static_cast<float>(limits::quiet_NaN())));
+}
+
+} // namespace executor
+} // namespace torch
@@ -56,6 +56,34 @@ class DummyEventTracer : public EventTracer {
     return 0;
   }
 
+  void log_instruction_memory(
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      size_t bytes_read,
+      size_t bytes_written,
+      const TensorMemoryAccess* accesses,
+      size_t num_accesses) override {
+    (void)chain_id;
+    (void)debug_handle;
+    (void)bytes_read;
+    (void)bytes_written;
+    (void)accesses;
+    (void)num_accesses;
+  }
+
+  void log_load_event(const LoadEvent& event) override {
+    (void)event;
+  }
+
+  void log_intermediate_output(
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      const IntermediateOutput& output) override {
+    (void)chain_id;
+    (void)debug_handle;
+    (void)output;
+  }
+
   EventTracerEntry start_profiling_delegate(
       const char* name,
       DebugHandle delegate_debug_id) override {
@@ -105,6 +133,22 @@ void RunSimpleTracerTest(EventTracer* event_tracer) {
   AllocatorID allocator_id =
       event_tracer_track_allocator(event_tracer, "AllocatorName");
   event_tracer_track_allocation(event_tracer, allocator_id, 64);
+  if (event_tracer != nullptr) {
+    event_tracer->set_memory_tracing_enabled(true);
+  }
+  TensorMemoryAccess access = {1, 64, 16, /*is_write=*/true};
+  if (event_tracer_memory_tracing_enabled(event_tracer)) {
+    event_tracer_log_instruction_memory(event_tracer, 0, 1, 0, 16, &access, 1);
+  }
+  LoadEvent load_event = {"ExampleLoad", -1, 0, 1, 1024, 256};
+  event_tracer_log_load_event(event_tracer, load_event);
+  if (event_tracer != nullptr) {
+    event_tracer->set_intermediate_output_logging_enabled(true);
+  }
+  IntermediateOutput output = {};
+  if (event_tracer_intermediate_output_logging_enabled(event_tracer)) {
+    event_tracer_log_intermediate_output(event_tracer, 0, 1, output);
+  }
 }
 
 TEST(TestEventTracer, SimpleEventTracerTest) {
@@ -145,7 +189,23 @@ TEST(TestEventTracer, SimpleEventTracerTestDelegate) {
   }
 }
 
+TEST(TestEventTracer, FullOutputDebugHandles) {
+  DummyEventTracer dummy;
+  EXPECT_FALSE(dummy.intermediate_output_logging_enabled());
+  EXPECT_FALSE(dummy.logs_full_output(3));
+
+  DebugHandle handles[] = {3, 7};
+  dummy.set_full_output_debug_handles(handles, 2);
+  EXPECT_TRUE(dummy.logs_full_output(3));
+  EXPECT_TRUE(dummy.logs_full_output(7));
+  EXPECT_FALSE(dummy.logs_full_output(4));
+
+  dummy.set_full_output_debug_handles(nullptr, 0);
+  EXPECT_FALSE(dummy.logs_full_output(3));
+}
+
 } // namespace executor
 } // namespace torch
 // TODO : (T163645377) Add more test coverage to log and verify events passed
 // into DummyTracer.
+
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Interface for running the independent chains of a Method concurrently.
+ *
+ * The core runtime does not create threads. Clients that want the chains of a
+ * multi-chain Method to run in parallel provide an implementation of this
+ * interface, typically backed by a thread pool, and attach it with
+ * `Method::set_chain_executor()`.
+ *
+ * NOTE: Prototype API; subject to change.
+ */
+class ChainExecutor {
+ public:
+  /// A task to run. `context` is the pointer passed to run().
+  using TaskFn = void (*)(void* context, size_t task_index);
+
+  /**
+   * Calls `fn(context, i)` for every `i` in `[0, num_tasks)`, potentially in
+   * parallel. Must not return until all calls have completed.
+   *
+   * The tasks passed here may themselves run delegates or kernels that use a
+   * thread pool, so implementations must not block on a pool that those tasks
+   * could also need.
+   */
+  virtual void run(TaskFn fn, void* context, size_t num_tasks) = 0;
+
+  virtual ~ChainExecutor() = default;
+};
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/array_ref.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Chooses among the alternative lowerings that a program may carry for a
+ * delegated partition, e.g. one for XNNPACK and one for QNN.
+ *
+ * Without a selector, Method::init() uses the first lowering whose backend is
+ * registered and available, in the order the program lists them. With one,
+ * select() may pick another, or ask the method to time every available
+ * lowering on its first load and report the results to on_measured(), so
+ * that the selector can remember the fastest one for this device.
+ *
+ * Partitions with a single available lowering are not passed to the
+ * selector.
+ */
+class DelegateSelector {
+ public:
+  /// Returned by select() to time every candidate.
+  static constexpr int32_t kMeasure = -1;
+
+  virtual ~DelegateSelector() = default;
+
+  /**
+   * Chooses the lowering to use for a partition.
+   *
+   * @param[in] method_name The name of the method being loaded.
+   * @param[in] delegate_index The index of the partition in the method's
+   *     delegates.
+   * @param[in] backend_ids The backends of the lowerings that are available
+   *     on this device, in the program's order of preference.
+   *
+   * @returns An index into `backend_ids`, or kMeasure to time every
+   *     candidate and use the fastest one.
+   */
+  virtual int32_t select(
+      const char* method_name,
+      size_t delegate_index,
+      ArrayRef<const char*> backend_ids) = 0;
+
+  /**
+   * Called after the candidates of a partition were timed.
+   *
+   * @param[in] method_name The name of the method being loaded.
+   * @param[in] delegate_index The index of the partition in the method's
+   *     delegates.
+   * @param[in] backend_ids The candidates that select() was given.
+   * @param[in] ticks The median et_pal_current_ticks() duration of one run of
+   *     each candidate, or 0 for candidates that failed to initialize or run.
+   * @param[in] chosen The index of the candidate that the method uses.
+   */
+  virtual void on_measured(
+      __ET_UNUSED const char* method_name,
+      __ET_UNUSED size_t delegate_index,
+      __ET_UNUSED ArrayRef<const char*> backend_ids,
+      __ET_UNUSED ArrayRef<uint64_t> ticks,
+      __ET_UNUSED size_t chosen) {}
+
+  /**
+   * Returns the number of timed runs of each candidate, after one untimed
+   * warm-up run.
+   */
+  virtual size_t num_measured_runs() const {
+    return 5;
+  }
+};
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <executorch/runtime/core/event_tracer_hooks.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+/**
+ * Logs a LoadEvent that spans the lifetime of this object. Its bytes loaded
+ * are the growth of a counter that the caller keeps, and its bytes allocated
+ * the growth of the allocator's used_size(). Does nothing without an
+ * EventTracer.
+ */
+class LoadEventScope final {
+ public:
+  /**
+   * @param[in] event_tracer The EventTracer to log to, or nullptr.
+   * @param[in] name The name of the phase. Must outlive this object.
+   * @param[in] bytes_loaded Counter of the bytes loaded, or nullptr.
+   * @param[in] allocator The allocator to track, or nullptr.
+   * @param[in] delegate_index See LoadEvent::delegate_index.
+   */
+  LoadEventScope(
+      EventTracer* event_tracer,
+      const char* name,
+      const uint64_t* bytes_loaded,
+      const MemoryAllocator* allocator,
+      int32_t delegate_index = -1) {
+#ifdef ET_EVENT_TRACER_ENABLED
+    event_tracer_ = event_tracer;
+    if (event_tracer_ == nullptr) {
+      return;
+    }
+    bytes_loaded_ = bytes_loaded;
+    allocator_ = allocator;
+    event_.name = name;
+    event_.delegate_index = delegate_index;
+    event_.bytes_loaded = bytes_loaded != nullptr ? *bytes_loaded : 0;
+    event_.bytes_allocated = allocator != nullptr ? allocator->used_size() : 0;
+    event_.start_time = et_pal_current_ticks();
+#else //! ET_EVENT_TRACER_ENABLED
+    (void)event_tracer;
+    (void)name;
+    (void)bytes_loaded;
+    (void)allocator;
+    (void)delegate_index;
+#endif
+  }
+
+  ~LoadEventScope() {
+#ifdef ET_EVENT_TRACER_ENABLED
+    if (event_tracer_ == nullptr) {
+      return;
+    }
+    event_.end_time = et_pal_current_ticks();
+    event_.bytes_loaded = bytes_loaded_ != nullptr
+        ? *bytes_loaded_ - event_.bytes_loaded
+        : 0;
+    event_.bytes_allocated = allocator_ != nullptr
+        ? allocator_->used_size() - event_.bytes_allocated
+        : 0;
+    event_tracer_log_load_event(event_tracer_, event_);
+#endif
+  }
+
+ private:
+#ifdef ET_EVENT_TRACER_ENABLED
+  EventTracer* event_tracer_;
+  const uint64_t* bytes_loaded_;
+  const MemoryAllocator* allocator_;
+  // Holds the starting values of the counters until the scope ends.
+  LoadEvent event_;
+#endif
+};
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
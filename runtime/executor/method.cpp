@@ -8,9 +8,13 @@
 
 #include <executorch/runtime/executor/method.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <type_traits>
 
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/event_tracer_hooks.h>
@@ -18,11 +22,15 @@
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/load_event_scope.h>
 #include <executorch/runtime/executor/memory_manager.h>
+#include <executorch/runtime/executor/operator_cache.h>
 #include <executorch/runtime/executor/program.h>
 #include <executorch/runtime/executor/tensor_parser.h>
+#include <executorch/runtime/executor/weight_streamer.h>
 #include <executorch/runtime/kernel/kernel_runtime_context.h>
 #include <executorch/runtime/kernel/operator_registry.h>
+#include <executorch/runtime/kernel/thread_parallel_interface.h>
 #include <executorch/runtime/platform/assert.h>
 #include <executorch/runtime/platform/log.h>
 #include <executorch/runtime/platform/profiler.h>
@@ -39,22 +47,68 @@ namespace executor {
 // @lint-ignore CLANGTIDY facebook-hte-ShadowingClass
 class BackendDelegate final {
  public:
+  /// The lowering_index() of entries that do not load a lowering.
+  static constexpr size_t kNoLowering = SIZE_MAX;
+
+  /**
+   * Initializes an already-allocated BackendDelegate that holds no delegate.
+   * Load() may load one into it later.
+   *
+   * @param[in] lowering_index The index of the lowering that the entry will
+   *     load in the plan's delegates, or kNoLowering if the entry only holds
+   *     an alternative lowering of another partition.
+   * @param[in] measure Whether to time the alternatives of the partition.
+   * @param[out] out The BackendDelegate to initialize.
+   */
+  static void InitEmpty(
+      size_t lowering_index,
+      bool measure,
+      BackendDelegate* out) {
+    new (&out->segment_) FreeableBuffer();
+    out->backend_ = nullptr;
+    out->backend_id_ = nullptr;
+    out->compile_specs_ = nullptr;
+    out->num_compile_specs_ = 0;
+    out->handle_ = nullptr;
+    out->initialized_ = false;
+    out->lowering_index_ = lowering_index;
+    out->measure_ = measure;
+    out->bound_args_ = nullptr;
+    out->bound_data_ = nullptr;
+    out->bound_capacity_ = 0;
+  }
+
+  /**
+   * Destroys the loaded delegate, if any, leaving the entry empty so that
+   * Load() can load another lowering of the partition into it.
+   */
+  void Reset(size_t lowering_index) {
+    const bool measure = measure_;
+    const void** bound_data = bound_data_;
+    const size_t bound_capacity = bound_capacity_;
+    this->~BackendDelegate();
+    InitEmpty(lowering_index, measure, this);
+    // Keep the binding storage for the lowering that replaces this one.
+    bound_data_ = bound_data;
+    bound_capacity_ = bound_capacity;
+  }
+
   /**
-   * Initializes an already-allocated BackendDelegate from its serialized
-   * representation.
+   * Prepares an already-allocated BackendDelegate from its serialized
+   * representation: looks up the backend, and loads the data and compile
+   * specs to pass to it. Init() then initializes the backend.
    *
    * @param[in] delegate The serialized backend delegate to load.
    * @param[in] program The serialized program to load from.
-   * @param[in] backend_init_context The context pointer to pass to the
-   *     backend's init() method.
-   * @param[out] out The BackendDelegate to initialize.
+   * @param[in] allocator The allocator for the data and compile specs.
+   * @param[out] out The BackendDelegate to prepare.
    *
-   * @returns Error::Ok if the initialization succeeded, or an error otherwise.
+   * @returns Error::Ok if the delegate was loaded, or an error otherwise.
    */
-  static Error Init(
+  static Error Load(
       const executorch_flatbuffer::BackendDelegate& delegate,
       const Program* program,
-      BackendInitContext& backend_init_context,
+      MemoryAllocator* allocator,
       BackendDelegate* out) {
     // Look up the backend.
     const char* backend_id = delegate.id()->c_str();
@@ -71,7 +125,8 @@ class BackendDelegate final {
         backend_id);
 
     // Get the delegate data.
-    Result<FreeableBuffer> processed_data = GetProcessedData(delegate, program);
+    Result<FreeableBuffer> processed_data =
+        GetProcessedData(delegate, program, allocator);
     if (!processed_data.ok()) {
       ET_LOG(Error, "Failed to load data for backend %s", backend_id);
       return processed_data.error();
@@ -80,39 +135,138 @@ class BackendDelegate final {
     // Parse compilation specs from program
     CompileSpec* compile_specs;
     Error err = PopulateCompileSpecs(
-        delegate.compile_specs(), backend_init_context, &compile_specs);
+        delegate.compile_specs(), allocator, &compile_specs);
     if (err != Error::Ok) {
       ET_LOG(Error, "Failed to get compile specs for backend %s", backend_id);
       return err;
     }
-    size_t num_compile_specs = delegate.compile_specs()->size();
 
     out->backend_ = backend;
+    out->backend_id_ = backend_id;
+    out->compile_specs_ = compile_specs;
+    out->num_compile_specs_ = delegate.compile_specs()->size();
     out->handle_ = nullptr;
+    out->initialized_ = false;
     // Pass a pointer to this buffer to the backend. It's safe for the backend
     // to point its handle to this object, since it will outlive the backend.
     new (&out->segment_) FreeableBuffer(std::move(processed_data.get()));
+    return Error::Ok;
+  }
 
-    // Initialize the delegate.
-    Result<DelegateHandle*> handle = backend->init(
+  /**
+   * Initializes the backend of a delegate prepared by Load(). On failure, the
+   * delegate data is freed and the destructor will not call the backend.
+   *
+   * @param[in] backend_init_context The context to pass to the backend's
+   *     init() method.
+   *
+   * @returns Error::Ok if the initialization succeeded, or an error otherwise.
+   */
+  Error Init(BackendInitContext& backend_init_context) {
+    Result<DelegateHandle*> handle = backend_->init(
         backend_init_context,
-        &out->segment_,
-        ArrayRef<CompileSpec>(compile_specs, num_compile_specs));
+        &segment_,
+        ArrayRef<CompileSpec>(compile_specs_, num_compile_specs_));
     if (!handle.ok()) {
       ET_LOG(
           Error,
           "Init failed for backend %s: 0x%" PRIx32,
-          backend_id,
+          backend_id_,
           static_cast<uint32_t>(handle.error()));
-      out->segment_.Free();
+      segment_.Free();
       return handle.error();
     }
-    out->handle_ = handle.get();
+    handle_ = handle.get();
+    initialized_ = true;
     return Error::Ok;
   }
 
+  /**
+   * Returns true if Init() may run concurrently with the Init() of other
+   * delegates. See PyTorchBackendInterface::is_init_thread_safe().
+   */
+  bool IsInitThreadSafe() const {
+    return backend_ != nullptr && backend_->is_init_thread_safe();
+  }
+
+  /// Returns the size of the data that Load() passes to the backend.
+  size_t ProcessedDataSize() const {
+    return segment_.size();
+  }
+
+  /**
+   * Returns the memory that the backend holds for this delegate outside of
+   * the runtime's allocators. See PyTorchBackendInterface::get_memory_usage().
+   */
+  Result<size_t> GetMemoryUsage() const {
+    return backend_->get_memory_usage(handle_);
+  }
+
+  /**
+   * Lets the backend do its lazy initialization of this delegate ahead of the
+   * first execution. See PyTorchBackendInterface::prepare().
+   */
+  Error Prepare() const {
+    return backend_->prepare(handle_);
+  }
+
+  /**
+   * Replaces a constant that the backend holds for this delegate. See
+   * PyTorchBackendInterface::update_constant().
+   */
+  Error UpdateConstant(const char* name, const void* data, size_t nbytes)
+      const {
+    return backend_->update_constant(handle_, name, data, nbytes);
+  }
+
+  /**
+   * Returns the size of a constant that the backend holds for this delegate.
+   * See PyTorchBackendInterface::get_constant_nbytes().
+   */
+  Result<size_t> GetConstantNbytes(const char* name) const {
+    return backend_->get_constant_nbytes(handle_, name);
+  }
+
+  /// Returns true if Load() loaded a lowering into this entry.
+  bool IsLoaded() const {
+    return backend_ != nullptr;
+  }
+
+  /// Returns true if Init() succeeded, so that the delegate can execute.
+  bool IsInitialized() const {
+    return initialized_;
+  }
+
+  /**
+   * Returns the index in the plan's delegates of the lowering that this entry
+   * loads, or kNoLowering.
+   */
+  size_t lowering_index() const {
+    return lowering_index_;
+  }
+
+  /// Returns true if the alternatives of this partition should be timed.
+  bool measure() const {
+    return measure_;
+  }
+
+  /**
+   * Returns true if Init() will pass the backend a read-only mapping of the
+   * program file for this delegate. See
+   * BackendInitContext::is_processed_mapped().
+   */
+  static bool IsProcessedDataMapped(
+      const executorch_flatbuffer::BackendDelegate& delegate,
+      const Program* program) {
+    // Inline data lives in the program's own buffer, which the backend can't
+    // keep past the program's lifetime.
+    return delegate.processed()->location() ==
+        executorch_flatbuffer::DataLocation::SEGMENT &&
+        program->is_segment_mapped(delegate.processed()->index());
+  }
+
   ~BackendDelegate() {
-    if (backend_ != nullptr) {
+    if (initialized_) {
       backend_->destroy(handle_);
     }
   }
@@ -124,10 +278,75 @@ class BackendDelegate final {
     return backend_->execute(backend_execution_context, handle_, args);
   }
 
+  /**
+   * Allocates the storage that Execute() needs to track the arguments bound
+   * to the backend, if the backend supports binding. Called for each call of
+   * the delegate.
+   *
+   * @param[in] num_args The number of arguments of the call.
+   * @param[in] allocator The allocator for the storage.
+   *
+   * @returns Error::Ok if the storage was allocated or is not needed, or an
+   *     error otherwise.
+   */
+  Error PrepareBinding(size_t num_args, MemoryAllocator* allocator) {
+    if (!backend_->supports_binding() || num_args <= bound_capacity_) {
+      return Error::Ok;
+    }
+    bound_data_ =
+        ET_ALLOCATE_LIST_OR_RETURN_ERROR(allocator, const void*, num_args);
+    bound_capacity_ = num_args;
+    return Error::Ok;
+  }
+
+  /**
+   * Executes a call of the delegate. Backends that support binding are only
+   * asked to bind the arguments when their storage changed since the previous
+   * call, and otherwise run with the arguments they already bound.
+   */
+  Error Execute(
+      BackendExecutionContext& backend_execution_context,
+      InstructionArgs args) {
+    if (args.size() > bound_capacity_ || !backend_->supports_binding()) {
+      return Execute(backend_execution_context, args.data());
+    }
+    EXECUTORCH_SCOPE_PROF("delegate_execute");
+    if (!IsBound(args)) {
+      Error err = backend_->bind(handle_, args.data());
+      if (err != Error::Ok) {
+        bound_args_ = nullptr;
+        return err;
+      }
+      bound_args_ = args.data();
+      for (size_t i = 0; i < args.size(); ++i) {
+        bound_data_[i] = DataOf(*args[i]);
+      }
+    }
+    return backend_->execute_bound(backend_execution_context, handle_);
+  }
+
  private:
   // Not constructible.
   BackendDelegate() = delete;
 
+  /// Returns the data of a tensor argument, or nullptr for other arguments.
+  static const void* DataOf(const EValue& arg) {
+    return arg.isTensor() ? arg.toTensor().const_data_ptr() : nullptr;
+  }
+
+  /// Returns true if `args` is what the backend was last bound to.
+  bool IsBound(InstructionArgs args) const {
+    if (bound_args_ != args.data()) {
+      return false;
+    }
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (bound_data_[i] != DataOf(*args[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   // Disallow copy/move.
   BackendDelegate(const BackendDelegate&) = delete;
   BackendDelegate& operator=(const BackendDelegate&) = delete;
@@ -137,14 +356,12 @@ class BackendDelegate final {
   static Error PopulateCompileSpecs(
       const flatbuffers::Vector<flatbuffers::Offset<
           executorch_flatbuffer::CompileSpec>>* compile_specs_in_program,
-      BackendInitContext& backend_init_context,
+      MemoryAllocator* allocator,
       CompileSpec** out_spec) {
     auto number_of_compile_specs = compile_specs_in_program->size();
 
     CompileSpec* compile_specs_list = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-        backend_init_context.get_runtime_allocator(),
-        CompileSpec,
-        number_of_compile_specs);
+        allocator, CompileSpec, number_of_compile_specs);
 
     // Initialize the spec list for each method spec
     for (size_t j = 0; j < number_of_compile_specs; j++) {
@@ -164,7 +381,8 @@ class BackendDelegate final {
 
   static Result<FreeableBuffer> GetProcessedData(
       const executorch_flatbuffer::BackendDelegate& delegate,
-      const Program* program) {
+      const Program* program,
+      MemoryAllocator* decompression_allocator) {
     const executorch_flatbuffer::BackendDelegateDataReference* processed =
         delegate.processed();
     switch (processed->location()) {
@@ -182,88 +400,1029 @@ class BackendDelegate final {
             /*free_fn=*/nullptr);
       }
       case executorch_flatbuffer::DataLocation::SEGMENT: {
-        return program->LoadSegment(processed->index());
+        // Compressed segments are decompressed into method memory, which
+        // outlives the backend's use of them.
+        return program->LoadSegment(
+            processed->index(), decompression_allocator);
+      }
+      default:
+        ET_LOG(
+            Error,
+            "Unknown data location %u",
+            static_cast<unsigned int>(processed->location()));
+        return Error::Internal;
+    }
+  }
+
+  FreeableBuffer segment_;
+  const PyTorchBackendInterface* backend_;
+  const char* backend_id_;
+  CompileSpec* compile_specs_;
+  size_t num_compile_specs_;
+  DelegateHandle* handle_;
+  /// True once Init() succeeded, so that the backend must destroy handle_.
+  bool initialized_;
+  size_t lowering_index_;
+  bool measure_;
+  /// The arguments that the backend was last bound to, or nullptr.
+  EValue** bound_args_;
+  /// The data of each of bound_args_ when they were bound.
+  const void** bound_data_;
+  size_t bound_capacity_;
+};
+
+/**
+ * Pre-decoded form of a serialized instruction.
+ *
+ * Method::init() lowers every flatbuffer instruction into one of these so that
+ * the execution loop can dispatch without touching flatbuffer vtables.
+ */
+struct Instruction {
+  enum class Type : uint8_t {
+    KernelCall,
+    ScalarOp,
+    DelegateCall,
+    JumpFalseCall,
+    MoveCall,
+    FreeCall,
+    MapBegin,
+    MapEnd,
+    WhileBegin,
+    WhileEnd,
+  };
+
+  /// The kind of instruction; determines which fields below are meaningful.
+  Type type;
+
+  /// The scalar prim ops that the interpreter runs inline.
+  enum class ScalarOpcode : uint8_t {
+    Add,
+    Sub,
+    Mul,
+    FloorDiv,
+    Eq,
+    Gt,
+    Lt,
+    Ge,
+    Le,
+    SymSize,
+    SymNumel,
+  };
+
+  /// ScalarOp: The operation.
+  ScalarOpcode scalar_op;
+
+  /**
+   * KernelCall/ScalarOp: Index into the operators table, used for error
+   * reporting.
+   * DelegateCall: Index into the delegates table.
+   * JumpFalseCall: Index of the condition value.
+   * MoveCall: Index of the value to move from.
+   * FreeCall: Index of the tensor value whose data should be released.
+   * MapEnd: Index of the iteration count value.
+   * WhileBegin: Number of loop-carried tensors.
+   */
+  int32_t index;
+
+  /**
+   * JumpFalseCall: Instruction index to jump to if the condition is false.
+   * MoveCall: Index of the value to move into.
+   * MapBegin: Instruction index to jump to once all rows are done.
+   * MapEnd: Instruction index of the matching MapBegin.
+   * WhileEnd: Instruction index of the matching WhileBegin.
+   */
+  int32_t target;
+
+  /**
+   * KernelCall: The resolved kernel.
+   * ScalarOp: The resolved kernel, which runs the operands that the inline
+   * path doesn't handle.
+   */
+  OpFunction kernel;
+
+  /**
+   * KernelCall/ScalarOp/DelegateCall: Pointers to the argument values.
+   * MapBegin: Pointers to the input, slice, output, body output and iteration
+   * count values, in that order.
+   * WhileBegin: Pointers to the init values, the state values and the body
+   * output values, then to the iteration count value.
+   */
+  InstructionArgs args;
+
+  /// A MoveCall or FreeCall that was folded into the instruction before it.
+  struct Folded {
+    Type type;
+    int32_t index;
+    int32_t target;
+  };
+
+  /**
+   * KernelCall/ScalarOp/DelegateCall: MoveCalls and FreeCalls that
+   * immediately followed this instruction in the program, to run after it
+   * succeeds.
+   */
+  Span<Folded> folded;
+
+  /// The index of this instruction in the serialized chain, for profiling.
+  uint32_t source_index;
+};
+
+/**
+ * Runtime state for a chain of instructions.
+ */
+struct Chain {
+  /// Pointer to the associated flatbuffer chain.
+  const executorch_flatbuffer::Chain* s_chain_;
+
+  /// The pre-decoded instructions of the chain, in execution order.
+  Span<Instruction> instructions_;
+};
+
+namespace {
+
+// Points the next `num_args` entries of `arg_pool` at the argument values, and
+// advances it past them.
+InstructionArgs gen_instruction_arguments(
+    EValue* values,
+    size_t num_args,
+    const int32_t* arg_idxs,
+    EValue**& arg_pool) {
+  EValue** arg_list = arg_pool;
+  for (size_t i = 0; i < num_args; ++i) {
+    arg_list[i] = &values[arg_idxs[i]];
+  }
+  arg_pool += num_args;
+  return InstructionArgs(arg_list, num_args);
+}
+
+// The values a MapBegin points at: input, slice, output, body output and
+// iteration count.
+constexpr size_t kMapBeginNumArgs = 5;
+
+// The number of argument values of the calls in `s_chain`.
+size_t count_instruction_arguments(
+    const executorch_flatbuffer::Chain* s_chain) {
+  size_t num_args = 0;
+  for (const auto instruction : *s_chain->instructions()) {
+    switch (instruction->instr_args_type()) {
+      case executorch_flatbuffer::InstructionArguments::KernelCall:
+        num_args += instruction->instr_args_as_KernelCall()->args()->size();
+        break;
+      case executorch_flatbuffer::InstructionArguments::DelegateCall:
+        num_args += instruction->instr_args_as_DelegateCall()->args()->size();
+        break;
+      case executorch_flatbuffer::InstructionArguments::MapBegin:
+        num_args += kMapBeginNumArgs;
+        break;
+      case executorch_flatbuffer::InstructionArguments::WhileBegin: {
+        const auto state =
+            instruction->instr_args_as_WhileBegin()->state_indices();
+        num_args += 3 * (state == nullptr ? 0 : state->size()) + 1;
+      } break;
+      default:
+        break;
+    }
+  }
+  return num_args;
+}
+
+bool parse_cond_value(const EValue& cond_value) {
+  // The cond value attached to the JF instruction at the beginning of an
+  // if/else branch is a Tensor which we parse and decide whether to continue
+  // to execute the if branch or jump to the else branch.
+  // The cond value attached to the JF instruction at the end of the if branch
+  // is a Bool Scalar which resolves to false and points us to the instruction
+  // to jump to which will take us to a point that is after the else branch.
+  if (cond_value.isTensor()) {
+    const exec_aten::Tensor& cond_val = cond_value.toTensor();
+
+    // All the tensors and scalar cond values should be of bool type
+    // currently. If that's not the case then something is wrong in the model
+    // and we should exit.
+    ET_CHECK_MSG(
+        ScalarType::Bool == cond_val.scalar_type(),
+        "Expected dtype of %" PRId8 " got %" PRId8,
+        static_cast<int8_t>(ScalarType::Bool),
+        static_cast<int8_t>(cond_val.scalar_type()));
+
+    const bool* cond_data = cond_val.const_data_ptr<bool>();
+    for (size_t i = 0; i < cond_val.numel(); i++) {
+      if (!cond_data[i]) {
+        return false;
+      }
+    }
+  } else if (cond_value.isBool()) {
+    if (!cond_value.toBool()) {
+      return false;
+    }
+  } else {
+    ET_CHECK_MSG(false, "Unsupported EValue was passed in for JF instruction");
+  }
+
+  return true;
+}
+
+/**
+ * Finds the inline form of the operator `name`.`overload`, if it is one of the
+ * scalar prim ops that dynamic shape models use for their shape math.
+ *
+ * @returns Whether there is one, in which case it is stored in `opcode`.
+ */
+bool find_scalar_opcode(
+    const char* name,
+    const char* overload,
+    size_t n_args,
+    Instruction::ScalarOpcode* opcode) {
+  using Opcode = Instruction::ScalarOpcode;
+  static constexpr struct {
+    const char* name;
+    const char* overload;
+    size_t n_args;
+    Opcode opcode;
+  } kScalarOps[] = {
+      {"executorch_prim::add", "Scalar", 3, Opcode::Add},
+      {"executorch_prim::sub", "Scalar", 3, Opcode::Sub},
+      {"executorch_prim::mul", "Scalar", 3, Opcode::Mul},
+      {"executorch_prim::floordiv", "Scalar", 3, Opcode::FloorDiv},
+      {"executorch_prim::eq", "Scalar", 3, Opcode::Eq},
+      {"executorch_prim::gt", "Scalar", 3, Opcode::Gt},
+      {"executorch_prim::lt", "Scalar", 3, Opcode::Lt},
+      {"executorch_prim::ge", "Scalar", 3, Opcode::Ge},
+      {"executorch_prim::le", "Scalar", 3, Opcode::Le},
+      {"aten::sym_size", "int", 3, Opcode::SymSize},
+      {"aten::sym_numel", "", 2, Opcode::SymNumel},
+  };
+  for (const auto& op : kScalarOps) {
+    if (n_args == op.n_args && std::strcmp(name, op.name) == 0 &&
+        std::strcmp(overload, op.overload) == 0) {
+      *opcode = op.opcode;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Runs a ScalarOp without going through its kernel, when its operands are
+ * ints, or a tensor and an int for the size ops. The results match the
+ * kernels in kernels/prim_ops.
+ *
+ * @returns Whether it ran; if not, the kernel must handle the operands.
+ */
+bool run_scalar_op(Instruction::ScalarOpcode opcode, InstructionArgs args) {
+  using Opcode = Instruction::ScalarOpcode;
+  if (opcode == Opcode::SymNumel) {
+    if (!args[0]->isTensor()) {
+      return false;
+    }
+    *args[1] = EValue(static_cast<int64_t>(args[0]->toTensor().numel()));
+    return true;
+  }
+  if (opcode == Opcode::SymSize) {
+    if (!args[0]->isTensor() || !args[1]->isInt()) {
+      return false;
+    }
+    *args[2] = EValue(
+        static_cast<int64_t>(args[0]->toTensor().size(args[1]->toInt())));
+    return true;
+  }
+  if (!args[0]->isInt() || !args[1]->isInt()) {
+    return false;
+  }
+  const int64_t a = args[0]->toInt();
+  const int64_t b = args[1]->toInt();
+  EValue& out = *args[2];
+  switch (opcode) {
+    case Opcode::Add:
+      out = EValue(a + b);
+      break;
+    case Opcode::Sub:
+      out = EValue(a - b);
+      break;
+    case Opcode::Mul:
+      out = EValue(a * b);
+      break;
+    case Opcode::FloorDiv: {
+      if (b == 0) {
+        return false;
+      }
+      const int64_t quot = a / b;
+      out = EValue((a % b != 0 && ((a < 0) != (b < 0))) ? quot - 1 : quot);
+    } break;
+    case Opcode::Eq:
+      out = EValue(a == b);
+      break;
+    case Opcode::Gt:
+      out = EValue(a > b);
+      break;
+    case Opcode::Lt:
+      out = EValue(a < b);
+      break;
+    case Opcode::Ge:
+      out = EValue(a >= b);
+      break;
+    case Opcode::Le:
+      out = EValue(a <= b);
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+/**
+ * The work of a MapBegin between two iterations of a map: stores the row that
+ * the previous iteration produced, and points the slice and the body output
+ * at the next row. Rows are views, so nothing is copied unless the body
+ * produced its output somewhere else, e.g. as a view of another tensor.
+ *
+ * @param[in] args The input, slice, output, body output and iteration count.
+ * @returns Whether there is another row to run the body on.
+ */
+Result<bool> begin_map_iteration(InstructionArgs args) {
+  const exec_aten::Tensor& input = args[0]->toTensor();
+  const exec_aten::Tensor& slice = args[1]->toTensor();
+  const exec_aten::Tensor& output = args[2]->toTensor();
+  const exec_aten::Tensor& body_output = args[3]->toTensor();
+  const int64_t iter = args[4]->toInt();
+
+  if (iter == 0) {
+    // Rows are only views when dim 0 is the outermost one.
+    ET_CHECK_OR_RETURN_ERROR(
+        input.dim() >= 1 && output.dim() >= 1 &&
+            is_default_dim_order(input.dim_order().data(), input.dim()) &&
+            is_default_dim_order(output.dim_order().data(), output.dim()),
+        InvalidArgument,
+        "MAP_BEGIN needs contiguous input and output tensors");
+    exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+    output_sizes[0] = input.size(0);
+    for (size_t d = 1; d < output.dim(); ++d) {
+      output_sizes[d] = output.size(d);
+    }
+    Error err = resize_tensor(
+        output, exec_aten::ArrayRef<exec_aten::SizesType>(
+                    output_sizes, output.dim()));
+    if (err == Error::Ok) {
+      err = resize_tensor(
+          slice,
+          exec_aten::ArrayRef<exec_aten::SizesType>(
+              input.sizes().data() + 1, input.dim() - 1));
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        err == Error::Ok,
+        InvalidArgument,
+        "MAP_BEGIN could not resize the output or slice for %" PRId64 " rows",
+        static_cast<int64_t>(input.size(0)));
+  }
+
+  const size_t input_row_nbytes =
+      getTrailingDims(input, 0) * input.element_size();
+  const size_t output_row_nbytes =
+      getTrailingDims(output, 0) * output.element_size();
+  auto* input_data =
+      static_cast<uint8_t*>(const_cast<void*>(input.const_data_ptr()));
+  auto* output_data = static_cast<uint8_t*>(output.mutable_data_ptr());
+
+  if (iter > 0) {
+    ET_CHECK_OR_RETURN_ERROR(
+        body_output.nbytes() == output_row_nbytes,
+        InvalidArgument,
+        "Map body produced %zu bytes for an output row of %zu bytes",
+        body_output.nbytes(),
+        output_row_nbytes);
+    uint8_t* row = output_data + (iter - 1) * output_row_nbytes;
+    if (body_output.const_data_ptr() != row) {
+      std::memcpy(row, body_output.const_data_ptr(), output_row_nbytes);
+    }
+  }
+  if (iter == input.size(0)) {
+    *args[4] = EValue(static_cast<int64_t>(0));
+    return false;
+  }
+
+  Error err = internal::set_tensor_data(
+      slice, input_data + iter * input_row_nbytes, input_row_nbytes);
+  if (err == Error::Ok) {
+    err = internal::set_tensor_data(
+        body_output, output_data + iter * output_row_nbytes, output_row_nbytes);
+  }
+  if (err != Error::Ok) {
+    return err;
+  }
+  return true;
+}
+
+/**
+ * Points `state` at the data of `body_output` and `body_output` at the data
+ * that `state` had, after giving `state` the sizes of `body_output`.
+ */
+Error swap_tensor_data(
+    const exec_aten::Tensor& state,
+    const exec_aten::Tensor& body_output) {
+  Error err = resize_tensor(state, body_output.sizes());
+  if (err != Error::Ok) {
+    return err;
+  }
+  void* state_data = state.mutable_data_ptr();
+  err = internal::set_tensor_data(
+      state, body_output.mutable_data_ptr(), body_output.nbytes());
+  if (err != Error::Ok) {
+    return err;
+  }
+  return internal::set_tensor_data(
+      body_output, state_data, body_output.nbytes());
+}
+
+/**
+ * The work of a WhileBegin: the first time, copies the init values into the
+ * state; after that, swaps the state with the body outputs of the iteration
+ * that just ran. A body output that is its own state, because the body passes
+ * it through, is left alone.
+ *
+ * @param[in] args The init, state and body output values, then the iteration
+ *     count.
+ * @param[in] n The number of loop-carried tensors.
+ */
+Error begin_while_iteration(InstructionArgs args, size_t n) {
+  EValue& iter = *args[3 * n];
+  for (size_t i = 0; i < n; ++i) {
+    const exec_aten::Tensor& state = args[n + i]->toTensor();
+    if (iter.toInt() == 0) {
+      Error err = resize_tensor(state, args[i]->toTensor().sizes());
+      if (err == Error::Ok) {
+        err = internal::copy_tensor_data(state, args[i]->toTensor());
+      }
+      if (err != Error::Ok) {
+        return err;
+      }
+    } else if (args[2 * n + i] != args[n + i]) {
+      Error err = swap_tensor_data(state, args[2 * n + i]->toTensor());
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+  iter = EValue(iter.toInt() + 1);
+  return Error::Ok;
+}
+
+/**
+ * The work of a WhileEnd. After an odd number of swaps, each state tensor
+ * holds the buffer its body output started with; swaps them back and copies
+ * the final state over, so that the state stays in its own buffer, which may
+ * be an output buffer the caller provided. Then resets the iteration count.
+ *
+ * @param[in] args The arguments of the matching WhileBegin.
+ * @param[in] n The number of loop-carried tensors.
+ */
+Error end_while(InstructionArgs args, size_t n) {
+  EValue& iter = *args[3 * n];
+  // Every WhileBegin after the first swapped.
+  const bool swapped = iter.toInt() % 2 == 0;
+  iter = EValue(static_cast<int64_t>(0));
+  if (!swapped) {
+    return Error::Ok;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    if (args[2 * n + i] == args[n + i]) {
+      continue;
+    }
+    const exec_aten::Tensor& state = args[n + i]->toTensor();
+    const exec_aten::Tensor& body_output = args[2 * n + i]->toTensor();
+    void* final_data = state.mutable_data_ptr();
+    Error err = internal::set_tensor_data(
+        state, body_output.mutable_data_ptr(), state.nbytes());
+    if (err == Error::Ok) {
+      err = internal::set_tensor_data(
+          body_output, final_data, body_output.nbytes());
+    }
+    if (err != Error::Ok) {
+      return err;
+    }
+    std::memcpy(state.mutable_data_ptr(), final_data, state.nbytes());
+  }
+  return Error::Ok;
+}
+
+/// Returns true if the two value index lists share an element.
+bool value_lists_intersect(
+    const flatbuffers::Vector<int32_t>* a,
+    const flatbuffers::Vector<int32_t>* b) {
+  for (size_t i = 0; i < a->size(); ++i) {
+    for (size_t j = 0; j < b->size(); ++j) {
+      if (a->Get(i) == b->Get(j)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * Returns true if `later` must run after `earlier`: it reads a value that
+ * `earlier` writes, writes a value that `earlier` reads, or both write the
+ * same value. Chains that don't declare their inputs and outputs are assumed
+ * to depend on everything.
+ */
+bool chain_depends_on(
+    const executorch_flatbuffer::Chain* later,
+    const executorch_flatbuffer::Chain* earlier) {
+  if (later->inputs() == nullptr || later->outputs() == nullptr ||
+      earlier->inputs() == nullptr || earlier->outputs() == nullptr) {
+    return true;
+  }
+  return value_lists_intersect(earlier->outputs(), later->inputs()) ||
+      value_lists_intersect(earlier->inputs(), later->outputs()) ||
+      value_lists_intersect(earlier->outputs(), later->outputs());
+}
+
+/// Runs the MoveCalls and FreeCalls folded into an instruction.
+void run_folded(EValue* values, Span<Instruction::Folded> folded) {
+  for (const auto& op : folded) {
+    if (op.type == Instruction::Type::MoveCall) {
+      values[op.target] = values[op.index];
+    } else {
+      internal::reset_data_ptr(values[op.index].toTensor());
+    }
+  }
+}
+
+/// Maximum number of tensors per instruction whose placement is passed to the
+/// EventTracer. The byte totals still cover every tensor.
+constexpr size_t kMaxLoggedTensorAccesses = 16;
+
+/// The tensors that one instruction accessed, for
+/// EventTracer::log_instruction_memory().
+struct InstructionMemoryLog {
+  TensorMemoryAccess accesses[kMaxLoggedTensorAccesses];
+  size_t num_accesses = 0;
+  size_t bytes_read = 0;
+  size_t bytes_written = 0;
+};
+
+/// Adds the tensor values[value_index], if it is one, to `log`.
+void log_tensor_access(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const EValue* values,
+    size_t value_index,
+    bool is_write,
+    InstructionMemoryLog& log) {
+  if (!values[value_index].isTensor()) {
+    return;
+  }
+  const size_t nbytes = values[value_index].toTensor().nbytes();
+  if (is_write) {
+    log.bytes_written += nbytes;
+  } else {
+    log.bytes_read += nbytes;
+  }
+  if (log.num_accesses == kMaxLoggedTensorAccesses) {
+    return;
+  }
+  TensorMemoryAccess& access = log.accesses[log.num_accesses++];
+  access.memory_id = kUnplannedMemoryId;
+  access.memory_offset = 0;
+  access.nbytes = nbytes;
+  access.is_write = is_write;
+  const auto* s_tensor = plan->values()->Get(value_index)->val_as_Tensor();
+  if (s_tensor != nullptr && s_tensor->allocation_info() != nullptr &&
+      s_tensor->constant_buffer_idx() == 0) {
+    access.memory_id =
+        static_cast<int32_t>(s_tensor->allocation_info()->memory_id());
+    access.memory_offset = s_tensor->allocation_info()->memory_offset();
+  }
+}
+
+/// Adds the tensor or the tensors of the tensor list values[value_index] to
+/// `log`.
+void log_value_access(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const EValue* values,
+    size_t value_index,
+    bool is_write,
+    InstructionMemoryLog& log) {
+  const auto* s_list = plan->values()->Get(value_index)->val_as_TensorList();
+  if (s_list == nullptr) {
+    log_tensor_access(plan, values, value_index, is_write, log);
+    return;
+  }
+  for (auto item : *s_list->items()) {
+    log_tensor_access(plan, values, item, is_write, log);
+  }
+}
+
+/// Returns true if values[index] is values[ret_index] or, if that is a tensor
+/// list, one of its elements.
+bool aliases_value(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    size_t ret_index,
+    size_t index) {
+  if (index == ret_index) {
+    return true;
+  }
+  const auto* s_list = plan->values()->Get(ret_index)->val_as_TensorList();
+  if (s_list == nullptr) {
+    return false;
+  }
+  for (auto item : *s_list->items()) {
+    if (static_cast<size_t>(item) == index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Logs the tensors that a KernelCall read and wrote to the EventTracer. The
+ * emitter passes a kernel's return value as its last argument, and the out
+ * arguments before it alias that value or, for a list of outputs, its
+ * elements; every other tensor argument is an input.
+ */
+void log_kernel_memory(
+    EventTracer* event_tracer,
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const EValue* values,
+    InstructionArgs args,
+    size_t chain_idx,
+    size_t instr_idx) {
+  if (args.size() == 0) {
+    return;
+  }
+  InstructionMemoryLog log;
+  const size_t ret_index = args[args.size() - 1] - values;
+  log_value_access(plan, values, ret_index, /*is_write=*/true, log);
+  for (size_t i = 0; i + 1 < args.size(); ++i) {
+    const size_t index = args[i] - values;
+    if (!aliases_value(plan, ret_index, index)) {
+      log_value_access(plan, values, index, /*is_write=*/false, log);
+    }
+  }
+  internal::event_tracer_log_instruction_memory(
+      event_tracer,
+      static_cast<ChainID>(chain_idx),
+      static_cast<DebugHandle>(instr_idx),
+      log.bytes_read,
+      log.bytes_written,
+      log.accesses,
+      log.num_accesses);
+}
+
+/**
+ * Hashes `nbytes` bytes a word at a time. Only needs to tell outputs apart
+ * across runs, so it favors speed over the quality of the mix.
+ */
+uint64_t hash_bytes(const void* data, size_t nbytes) {
+  constexpr uint64_t kMul = 0xff51afd7ed558ccdULL;
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash = 0x9e3779b97f4a7c15ULL ^ nbytes;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= nbytes; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ word) * kMul;
+    hash ^= hash >> 32;
+  }
+  if (i < nbytes) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes + i, nbytes - i);
+    hash = (hash ^ word) * kMul;
+    hash ^= hash >> 32;
+  }
+  return hash;
+}
+
+/// Computes the statistics of `tensor`, and logs them with its data if
+/// `full` is true.
+void log_output_tensor(
+    EventTracer* event_tracer,
+    const exec_aten::Tensor& tensor,
+    uint32_t output_index,
+    bool full,
+    size_t chain_idx,
+    size_t instr_idx) {
+  IntermediateOutput output = {};
+  output.output_index = output_index;
+  output.scalar_type = static_cast<int8_t>(tensor.scalar_type());
+  output.dim = static_cast<uint32_t>(tensor.dim());
+  for (size_t d = 0; d < output.dim && d < kMaxLoggedOutputDims; ++d) {
+    output.sizes[d] = tensor.size(d);
+  }
+  output.nbytes = tensor.nbytes();
+  output.data = full ? tensor.const_data_ptr() : nullptr;
+
+  TensorStats& stats = output.stats;
+  stats.numel = tensor.numel();
+  stats.hash = hash_bytes(tensor.const_data_ptr(), tensor.nbytes());
+  const exec_aten::ScalarType type = tensor.scalar_type();
+  if (isIntegralType(type, /*includeBool=*/true) || isFloatingType(type)) {
+    ET_SWITCH_REALHBBF16_TYPES(type, nullptr, "log_output", CTYPE, [&]() {
+      const CTYPE* data = tensor.const_data_ptr<CTYPE>();
+      double sum = 0;
+      size_t count = 0;
+      for (size_t i = 0; i < stats.numel; ++i) {
+        const double value = static_cast<double>(data[i]);
+        if (value != value) {
+          stats.nan_count++;
+          continue;
+        }
+        if (count == 0 || value < stats.min) {
+          stats.min = value;
+        }
+        if (count == 0 || value > stats.max) {
+          stats.max = value;
+        }
+        sum += value;
+        count++;
+      }
+      stats.mean = count > 0 ? sum / count : 0;
+    });
+  }
+  internal::event_tracer_log_intermediate_output(
+      event_tracer,
+      static_cast<ChainID>(chain_idx),
+      static_cast<DebugHandle>(instr_idx),
+      output);
+}
+
+/**
+ * Logs the outputs of a KernelCall to the EventTracer: its return value, the
+ * last argument, which is a tensor or a list of them.
+ */
+void log_kernel_outputs(
+    EventTracer* event_tracer,
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    const EValue* values,
+    InstructionArgs args,
+    size_t chain_idx,
+    size_t instr_idx) {
+  if (args.size() == 0) {
+    return;
+  }
+  const bool full =
+      event_tracer->logs_full_output(static_cast<DebugHandle>(instr_idx));
+  const size_t ret_index = args[args.size() - 1] - values;
+  const auto* s_list = plan->values()->Get(ret_index)->val_as_TensorList();
+  if (s_list == nullptr) {
+    if (values[ret_index].isTensor()) {
+      log_output_tensor(
+          event_tracer,
+          values[ret_index].toTensor(),
+          0,
+          full,
+          chain_idx,
+          instr_idx);
+    }
+    return;
+  }
+  uint32_t output_index = 0;
+  for (auto item : *s_list->items()) {
+    if (values[item].isTensor()) {
+      log_output_tensor(
+          event_tracer,
+          values[item].toTensor(),
+          output_index,
+          full,
+          chain_idx,
+          instr_idx);
+    }
+    output_index++;
+  }
+}
+
+/// Marks an instruction that fold_bookkeeping_instructions() will remove.
+constexpr uint32_t kFoldedMarker = UINT32_MAX;
+
+/// Whether `target` of the instruction is an instruction index.
+bool is_jump(const Instruction& instr) {
+  return instr.type == Instruction::Type::JumpFalseCall ||
+      instr.type == Instruction::Type::MapBegin ||
+      instr.type == Instruction::Type::MapEnd ||
+      instr.type == Instruction::Type::WhileEnd;
+}
+
+/**
+ * Folds each run of MoveCalls and FreeCalls that directly follows a
+ * KernelCall or DelegateCall into that call, so that the interpreter doesn't
+ * dispatch them separately, and compacts the remaining instructions. Jump
+ * destinations are remapped; bookkeeping instructions that are themselves jump
+ * destinations are left alone, since jumping to them must not run the call
+ * before them.
+ *
+ * @returns The number of instructions left in `instructions`.
+ */
+Result<size_t> fold_bookkeeping_instructions(
+    MemoryAllocator* method_allocator,
+    Instruction* instructions,
+    size_t num_instructions) {
+  // Only runs that start right after a call can fold; skip the bookkeeping
+  // below for chains that have none.
+  bool has_candidate = false;
+  for (size_t i = 1; i < num_instructions && !has_candidate; ++i) {
+    const Instruction::Type type = instructions[i].type;
+    const Instruction::Type prev = instructions[i - 1].type;
+    has_candidate = (type == Instruction::Type::MoveCall ||
+                     type == Instruction::Type::FreeCall) &&
+        (prev == Instruction::Type::KernelCall ||
+         prev == Instruction::Type::ScalarOp ||
+         prev == Instruction::Type::DelegateCall);
+  }
+  if (!has_candidate) {
+    return num_instructions;
+  }
+
+  // new_index[i] first marks whether instruction i is a jump destination, and
+  // is then overwritten with its index after compaction. Jump targets may be
+  // num_instructions, so it has one extra entry for the end of the chain.
+  uint32_t* new_index = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+      method_allocator, uint32_t, num_instructions + 1);
+  std::fill(new_index, new_index + num_instructions + 1, 0);
+  for (size_t i = 0; i < num_instructions; ++i) {
+    if (is_jump(instructions[i])) {
+      new_index[instructions[i].target] = 1;
+    }
+  }
+
+  // Decide what to fold, recording the prefix count of folded instructions.
+  size_t num_folded = 0;
+  bool can_fold = false;
+  for (size_t i = 0; i < num_instructions; ++i) {
+    Instruction& instr = instructions[i];
+    const bool is_jump_destination = new_index[i] != 0;
+    new_index[i] = static_cast<uint32_t>(i - num_folded);
+    if (instr.type == Instruction::Type::MoveCall ||
+        instr.type == Instruction::Type::FreeCall) {
+      if (can_fold && !is_jump_destination) {
+        instr.source_index = kFoldedMarker;
+        num_folded++;
+        continue;
       }
-      default:
-        ET_LOG(
-            Error,
-            "Unknown data location %u",
-            static_cast<unsigned int>(processed->location()));
-        return Error::Internal;
+      can_fold = false;
+    } else {
+      can_fold = instr.type == Instruction::Type::KernelCall ||
+          instr.type == Instruction::Type::ScalarOp ||
+          instr.type == Instruction::Type::DelegateCall;
     }
   }
+  new_index[num_instructions] =
+      static_cast<uint32_t>(num_instructions - num_folded);
+  if (num_folded == 0) {
+    return num_instructions;
+  }
 
-  FreeableBuffer segment_;
-  const PyTorchBackendInterface* backend_;
-  DelegateHandle* handle_;
-};
+  Instruction::Folded* folded = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+      method_allocator, Instruction::Folded, num_folded);
 
-/**
- * Runtime state for a chain of instructions.
- */
-struct Chain {
-  /// Pointer to the associated flatbuffer chain.
-  const executorch_flatbuffer::Chain* s_chain_;
+  // Remap jump destinations before compacting. Destinations are never folded,
+  // so each one keeps its own instruction.
+  for (size_t i = 0; i < num_instructions; ++i) {
+    Instruction& instr = instructions[i];
+    if (is_jump(instr)) {
+      instr.target = static_cast<int32_t>(new_index[instr.target]);
+    }
+  }
+
+  // Compact. The folded lists of successive calls are contiguous in `folded`.
+  size_t num_kept = 0;
+  size_t num_written = 0;
+  for (size_t i = 0; i < num_instructions; ++i) {
+    const Instruction& instr = instructions[i];
+    if (instr.source_index == kFoldedMarker) {
+      Instruction& host = instructions[num_kept - 1];
+      const size_t begin = host.folded.size() == 0
+          ? num_written
+          : static_cast<size_t>(host.folded.data() - folded);
+      folded[num_written++] = {instr.type, instr.index, instr.target};
+      host.folded =
+          Span<Instruction::Folded>(&folded[begin], num_written - begin);
+      continue;
+    }
+    if (num_kept != i) {
+      instructions[num_kept] = instr;
+    }
+    num_kept++;
+  }
+  return num_kept;
+}
 
-  /// Each entry is a list of parameters for a kernel or delegate call.
-  Span<InstructionArgs> argument_lists_;
-  /// Each instruction will have one kernel (not for delegate).
-  OpFunction* kernels_;
+/// Stands in for the EventTracer scopes in code paths that run without an
+/// EventTracer, so that they compile down to nothing.
+struct NoopProfileScope final {
+  template <typename... Args>
+  explicit NoopProfileScope(Args&&...) {}
 };
 
-namespace {
+/// The EventTracer scope to use in an execution path that is specialized on
+/// whether an EventTracer is attached.
+template <bool kTracing>
+using ProfileScope = typename std::
+    conditional<kTracing, internal::EventTracerProfileScope, NoopProfileScope>::
+        type;
+template <bool kTracing>
+using ProfileInstructionScope = typename std::conditional<
+    kTracing,
+    internal::EventTracerProfileInstructionScope,
+    NoopProfileScope>::type;
 
-Result<InstructionArgs> gen_instruction_arguments(
-    MemoryAllocator* method_allocator,
-    EValue* values,
-    size_t num_args,
-    const int32_t* arg_idxs) {
-  EValue** arg_list =
-      ET_ALLOCATE_LIST_OR_RETURN_ERROR(method_allocator, EValue*, num_args);
-  for (size_t i = 0; i < num_args; ++i) {
-    arg_list[i] = &values[arg_idxs[i]];
+/**
+ * Returns true if a kernel of `chain` takes a DYNAMIC_UNBOUND tensor, which
+ * it may grow through the dynamic allocator.
+ */
+bool chain_grows_unbounded_tensors(const Chain& chain) {
+#ifdef USE_ATEN_LIB
+  // ATen tensors manage their own storage.
+  (void)chain;
+#else // !USE_ATEN_LIB
+  for (const Instruction& instruction : chain.instructions_) {
+    if (instruction.type != Instruction::Type::KernelCall) {
+      continue;
+    }
+    for (EValue* arg : instruction.args) {
+      if (arg->isTensor() &&
+          arg->toTensor().unsafeGetTensorImpl()->shape_dynamism() ==
+              TensorShapeDynamism::DYNAMIC_UNBOUND) {
+        return true;
+      }
+    }
   }
-  return InstructionArgs(arg_list, num_args);
+#endif // USE_ATEN_LIB
+  return false;
 }
 
-bool parse_cond_value(const EValue& cond_value) {
-  // The cond value attached to the JF instruction at the beginning of an
-  // if/else branch is a Tensor which we parse and decide whether to continue
-  // to execute the if branch or jump to the else branch.
-  // The cond value attached to the JF instruction at the end of the if branch
-  // is a Bool Scalar which resolves to false and points us to the instruction
-  // to jump to which will take us to a point that is after the else branch.
-  if (cond_value.isTensor()) {
-    const exec_aten::Tensor& cond_val = cond_value.toTensor();
+} // namespace
 
-    // All the tensors and scalar cond values should be of bool type
-    // currently. If that's not the case then something is wrong in the model
-    // and we should exit.
-    ET_CHECK_MSG(
-        ScalarType::Bool == cond_val.scalar_type(),
-        "Expected dtype of %" PRId8 " got %" PRId8,
-        static_cast<int8_t>(ScalarType::Bool),
-        static_cast<int8_t>(cond_val.scalar_type()));
+Error Method::plan_chain_schedule() {
+  n_chain_waves_ = n_chains_;
+  chain_wave_order_ = nullptr;
+  chain_wave_offsets_ = nullptr;
+  chain_wave_serial_ = nullptr;
+  chain_errors_ = nullptr;
+  if (n_chains_ < 2) {
+    return Error::Ok;
+  }
 
-    const bool* cond_data = cond_val.const_data_ptr<bool>();
-    for (size_t i = 0; i < cond_val.numel(); i++) {
-      if (!cond_data[i]) {
-        return false;
+  // Assign each chain to the earliest wave that comes after all of the chains
+  // it depends on. Dependencies only point backwards in program order, so a
+  // single forward pass is enough.
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto chains = serialization_plan_->chains();
+  uint32_t* waves =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(method_allocator, uint32_t, n_chains_);
+  size_t n_waves = 0;
+  for (size_t i = 0; i < n_chains_; ++i) {
+    uint32_t wave = 0;
+    for (size_t j = 0; j < i; ++j) {
+      if (waves[j] + 1 > wave &&
+          chain_depends_on(chains->Get(i), chains->Get(j))) {
+        wave = waves[j] + 1;
       }
     }
-  } else if (cond_value.isBool()) {
-    if (!cond_value.toBool()) {
-      return false;
+    waves[i] = wave;
+    n_waves = wave + 1 > n_waves ? wave + 1 : n_waves;
+  }
+  if (n_waves == n_chains_) {
+    // Every chain depends on the one before it; execute() will use the
+    // sequential path.
+    return Error::Ok;
+  }
+
+  // Bucket the chains by wave, preserving program order within each wave,
+  // except that the chains that must not run concurrently come first.
+  uint32_t* offsets =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(method_allocator, uint32_t, n_waves + 1);
+  uint32_t* serial =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(method_allocator, uint32_t, n_waves);
+  uint32_t* order =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(method_allocator, uint32_t, n_chains_);
+  Error* errors =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(method_allocator, Error, n_chains_);
+  uint32_t n_ordered = 0;
+  offsets[0] = 0;
+  for (size_t w = 0; w < n_waves; ++w) {
+    for (size_t i = 0; i < n_chains_; ++i) {
+      if (waves[i] == w && chain_grows_unbounded_tensors(chains_[i])) {
+        order[n_ordered++] = static_cast<uint32_t>(i);
+      }
     }
-  } else {
-    ET_CHECK_MSG(false, "Unsupported EValue was passed in for JF instruction");
+    serial[w] = n_ordered - offsets[w];
+    for (size_t i = 0; i < n_chains_; ++i) {
+      if (waves[i] == w && !chain_grows_unbounded_tensors(chains_[i])) {
+        order[n_ordered++] = static_cast<uint32_t>(i);
+      }
+    }
+    offsets[w + 1] = n_ordered;
+  }
+  for (size_t i = 0; i < n_chains_; ++i) {
+    errors[i] = Error::Ok;
   }
 
-  return true;
+  n_chain_waves_ = n_waves;
+  chain_wave_order_ = order;
+  chain_wave_offsets_ = offsets;
+  chain_wave_serial_ = serial;
+  chain_errors_ = errors;
+  return Error::Ok;
 }
 
-} // namespace
-
 Error Method::parse_values() {
   auto flatbuffer_values = serialization_plan_->values();
   ET_CHECK(flatbuffer_values != nullptr);
@@ -276,6 +1435,53 @@ Error Method::parse_values() {
   // safe for errors to return without updating any state.
   n_value_ = 0;
 
+  // One pass ahead of parsing sizes the storage that the values share, so that
+  // it takes a few allocations rather than some per value. When the program
+  // keeps its constants in a segment, this method loads the ones that its
+  // tensors use. There can be no more of them than there are constant tensors.
+  const bool has_constant_segment = program_->has_constant_segment();
+  size_t n_constant_tensor = 0;
+  size_t n_int_list_item = 0;
+  for (size_t i = 0; i < n_value; ++i) {
+    auto serialization_value = flatbuffer_values->Get(i);
+    switch (serialization_value->val_type()) {
+      case executorch_flatbuffer::KernelTypes::Tensor:
+        if (has_constant_segment &&
+            serialization_value->val_as_Tensor()->constant_buffer_idx() > 0 &&
+            !(weight_streamer_ != nullptr &&
+              weight_streamer_->is_streamed(i))) {
+          n_constant_tensor++;
+          // Start reading the data before the loop below loads it.
+          program_->PrefetchConstantSegmentBuffer(
+              serialization_value->val_as_Tensor()->constant_buffer_idx());
+        }
+        break;
+      case executorch_flatbuffer::KernelTypes::IntList:
+        n_int_list_item +=
+            serialization_value->val_as_IntList()->items()->size();
+        break;
+      default:
+        break;
+    }
+  }
+  n_constant_buffer_ = 0;
+  if (n_constant_tensor > 0) {
+    constant_buffers_ = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+        memory_manager_->method_allocator(), ConstantBuffer, n_constant_tensor);
+  }
+  // The boxed and unboxed representations of all the int lists, each list
+  // taking the next slice of both.
+  EValue** int_list_boxed = nullptr;
+  int64_t* int_list_unboxed = nullptr;
+  if (n_int_list_item > 0) {
+    int_list_boxed = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+        memory_manager_->method_allocator(), EValue*, n_int_list_item);
+    int_list_unboxed = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+        memory_manager_->method_allocator(), int64_t, n_int_list_item);
+  }
+
+  // Tensors of the same static shape share their metadata.
+  internal::ShapeCache shape_cache;
   for (size_t i = 0; i < n_value; ++i) {
     auto serialization_value = flatbuffer_values->Get(i);
     switch (serialization_value->val_type()) {
@@ -298,16 +1504,12 @@ Error Method::parse_values() {
       } break;
       case executorch_flatbuffer::KernelTypes::IntList: {
         const auto items = serialization_value->val_as_IntList()->items();
-        // Allocate space for boxed and unboxed list representations using
-        // values_ as source of truth
-        auto* evalp_list =
-            memory_manager_->method_allocator()->allocateList<EValue*>(
-                items->size());
-        auto* int_list =
-            memory_manager_->method_allocator()->allocateList<int64_t>(
-                items->size());
-
-        // initialize boxed list
+        // The boxed list, using values_ as the source of truth, and space for
+        // the unboxed one.
+        EValue** evalp_list = int_list_boxed;
+        int64_t* int_list = int_list_unboxed;
+        int_list_boxed += items->size();
+        int_list_unboxed += items->size();
         for (size_t j = 0; j < items->size(); j++) {
           evalp_list[j] = &values_[static_cast<size_t>(items->Get(j))];
         }
@@ -336,8 +1538,45 @@ Error Method::parse_values() {
         new (&values_[i]) EValue(fb_str->c_str(), fb_str->size());
       } break;
       case executorch_flatbuffer::KernelTypes::Tensor: {
+        const auto* s_tensor = serialization_value->val_as_Tensor();
+        const FreeableBuffer* constant_data = nullptr;
+        // Streamed constants start out without data; the streamer points them
+        // at it while the instructions that use them run.
+        const bool streamed =
+            weight_streamer_ != nullptr && weight_streamer_->is_streamed(i);
+        size_t streamed_offset = 0;
+        size_t streamed_size = 0;
+        if (streamed) {
+          Error err = program_->get_constant_segment_buffer_range(
+              s_tensor->constant_buffer_idx(),
+              &streamed_offset,
+              &streamed_size);
+          if (err != Error::Ok) {
+            return err;
+          }
+        }
+        const FreeableBuffer streamed_placeholder(
+            nullptr, streamed_size, /*free_fn=*/nullptr);
+        if (streamed) {
+          constant_data = &streamed_placeholder;
+        } else if (
+            constant_buffers_ != nullptr &&
+            s_tensor->constant_buffer_idx() > 0) {
+          auto buffer = get_constant_buffer(s_tensor->constant_buffer_idx());
+          if (!buffer.ok()) {
+            ET_LOG(
+                Error,
+                "Failed loading constant buffer %" PRIu32
+                " of tensor at index %zu: 0x%" PRIx32,
+                s_tensor->constant_buffer_idx(),
+                i,
+                static_cast<uint32_t>(buffer.error()));
+            return buffer.error();
+          }
+          constant_data = buffer.get();
+        }
         auto t = deserialization::parseTensor(
-            program_, memory_manager_, serialization_value->val_as_Tensor());
+            program_, memory_manager_, s_tensor, constant_data, &shape_cache);
         if (!t.ok()) {
           ET_LOG(
               Error,
@@ -347,6 +1586,9 @@ Error Method::parse_values() {
           return t.error();
         }
         new (&values_[i]) EValue(t.get());
+        if (streamed) {
+          weight_streamer_->bind(i, &values_[i]);
+        }
       } break;
       case executorch_flatbuffer::KernelTypes::TensorList: {
         // get list of serialization tensors and allocate storage for executor
@@ -404,6 +1646,47 @@ Error Method::parse_values() {
   return Error::Ok;
 }
 
+Result<const FreeableBuffer*> Method::get_constant_buffer(
+    size_t buffer_index) {
+  // Tensors that share a constant, e.g. tied weights, share the loaded data.
+  // Methods have few enough constants that a linear search is cheap next to
+  // loading them.
+  for (size_t i = 0; i < n_constant_buffer_; ++i) {
+    if (constant_buffers_[i].index == buffer_index) {
+      return &constant_buffers_[i].data;
+    }
+  }
+  ConstantBuffer* entry = &constant_buffers_[n_constant_buffer_];
+  if (constant_source_ != nullptr) {
+    for (size_t i = 0; i < constant_source_->n_constant_buffer_; ++i) {
+      const ConstantBuffer& shared = constant_source_->constant_buffers_[i];
+      if (shared.index == buffer_index) {
+        // Borrow the data without taking ownership; the source outlives this
+        // Method.
+        new (entry) ConstantBuffer{
+            buffer_index,
+            FreeableBuffer(
+                shared.data.data(), shared.data.size(), /*free_fn=*/nullptr),
+            /*borrowed=*/true};
+        n_constant_buffer_++;
+        return &entry->data;
+      }
+    }
+  }
+  Result<FreeableBuffer> data =
+      program_->LoadConstantSegmentBuffer(buffer_index);
+  if (!data.ok()) {
+    return data.error();
+  }
+  // ~Method() cleans up n_constant_buffer_ entries, so only count the entry
+  // once it is initialized.
+  init_bytes_loaded_ += data->size();
+  new (entry) ConstantBuffer{
+      buffer_index, std::move(data.get()), /*borrowed=*/false};
+  n_constant_buffer_++;
+  return &entry->data;
+}
+
 /**
  * Private/helper method for populating operator_name from the Operator.
  * operator_name is a char pointer that is already allocated. The size of
@@ -438,18 +1721,66 @@ static void populateOperatorName(
 
 Error Method::resolve_operator(
     int32_t op_index,
-    OpFunction* kernels,
-    size_t kernel_index,
+    OpFunction* kernel,
     InstructionArgs args,
-    size_t n_args) {
+    size_t n_args,
+    internal::OperatorCache* operator_cache) {
   // TODO(T153505381, T153506819) Investigate optimizing this function for both
   // space and time.
+  const auto ops = serialization_plan_->operators();
+  const auto& op = ops->Get(op_index);
+  const char* name = op->name()->c_str();
+  const char* overload = op->overload()->c_str();
+
+  // Encode the dtypes and dim orders of the tensor arguments so that
+  // resolutions shared with previously-loaded methods can be reused without
+  // formatting the name or allocating TensorMeta.
+  static_assert(
+      sizeof(exec_aten::DimOrderType) == 1,
+      "Kernel keys store one byte per dim order entry");
+  uint8_t cache_key[internal::OperatorCache::kMaxKeyBytes];
+  size_t cache_key_size = 0;
+  if (operator_cache != nullptr) {
+    for (size_t i = 0; i < n_args; i++) {
+      EValue* eval = args[i];
+      if (!eval->isTensor()) {
+        continue;
+      }
+      auto tensor = eval->toTensor();
+      const size_t dim = tensor.dim();
+      if (cache_key_size + 2 + dim > sizeof(cache_key)) {
+        // Too large to cache; resolve normally.
+        operator_cache = nullptr;
+        break;
+      }
+      cache_key[cache_key_size++] = static_cast<uint8_t>(tensor.scalar_type());
+      cache_key[cache_key_size++] = static_cast<uint8_t>(dim);
+      Error err = get_dim_order(
+          tensor,
+          reinterpret_cast<exec_aten::DimOrderType*>(
+              &cache_key[cache_key_size]),
+          dim);
+      ET_CHECK_OR_RETURN_ERROR(
+          err == Error::Ok,
+          InvalidArgument,
+          "Error setting dim_order %zu: 0x%" PRIx32,
+          i,
+          static_cast<uint32_t>(err));
+      cache_key_size += dim;
+    }
+    if (operator_cache != nullptr) {
+      const OpFunction* cached =
+          operator_cache->find(name, overload, cache_key, cache_key_size);
+      if (cached != nullptr) {
+        *kernel = *cached;
+        return Error::Ok;
+      }
+    }
+  }
 
   // resolve name
   constexpr size_t kTempBufferSizeForName = 100;
   char operator_name[kTempBufferSizeForName];
-  const auto ops = serialization_plan_->operators();
-  const auto& op = ops->Get(op_index);
 
   populateOperatorName(op, kTempBufferSizeForName, operator_name);
 
@@ -479,10 +1810,38 @@ Error Method::resolve_operator(
       count++;
     }
   }
+  // Kernels with shape predicates may only be chosen once and for all when the
+  // shapes of the tensor arguments can't change after loading.
+  bool static_shapes = true;
+#ifdef USE_ATEN_LIB
+  static_shapes = false;
+#else // !USE_ATEN_LIB
+  for (size_t i = 0; i < n_args; i++) {
+    if (args[i]->isTensor() &&
+        args[i]->toTensor().unsafeGetTensorImpl()->shape_dynamism() !=
+            TensorShapeDynamism::STATIC) {
+      static_shapes = false;
+      break;
+    }
+  }
+#endif // USE_ATEN_LIB
+
   // search kernel
-  if (hasOpsFn(operator_name, ArrayRef<TensorMeta>(meta, count))) {
-    kernels[kernel_index] =
-        getOpsFn(operator_name, ArrayRef<TensorMeta>(meta, count));
+  bool shape_specialized = false;
+  const OpFunction* found = getOpsFnForArgs(
+      operator_name,
+      ArrayRef<TensorMeta>(meta, count),
+      static_shapes ? ArrayRef<EValue*>(args.data(), n_args)
+                    : ArrayRef<EValue*>(),
+      &shape_specialized);
+  if (found != nullptr) {
+    *kernel = *found;
+    // The cache keys on dtypes and dim orders only, so operators with
+    // shape-specialized kernels are resolved anew for every call.
+    if (operator_cache != nullptr && !shape_specialized) {
+      operator_cache->insert(
+          name, overload, cache_key, cache_key_size, *kernel);
+    }
     return Error::Ok;
   } else {
     ET_LOG(Error, "Missing operator: [%d] %s", op_index, operator_name);
@@ -494,9 +1853,20 @@ Result<Method> Method::load(
     executorch_flatbuffer::ExecutionPlan* s_plan,
     const Program* program,
     MemoryManager* memory_manager,
-    EventTracer* event_tracer) {
+    EventTracer* event_tracer,
+    internal::OperatorCache* operator_cache,
+    const Method* constant_source,
+    DelegateSelector* delegate_selector,
+    const WeightStreamingConfig* weight_streaming) {
   Method method(program, memory_manager, event_tracer);
-  Error err = method.init(s_plan);
+  method.constant_source_ = constant_source;
+  method.delegate_selector_ = delegate_selector;
+  method.weight_streaming_ = weight_streaming;
+  Error err = method.init(s_plan, operator_cache);
+  // Only needed during init().
+  method.constant_source_ = nullptr;
+  method.delegate_selector_ = nullptr;
+  method.weight_streaming_ = nullptr;
   if (err != Error::Ok) {
     return err;
   } else {
@@ -505,7 +1875,312 @@ Result<Method> Method::load(
   }
 }
 
-Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
+namespace {
+
+/**
+ * Serializes the allocate() and free() calls of a MemoryAllocator, so that
+ * delegates that initialize concurrently can share the method allocator.
+ * Allocations are short, so a spinlock avoids depending on a mutex.
+ */
+class SerializedAllocator final : public MemoryAllocator {
+ public:
+  explicit SerializedAllocator(MemoryAllocator* allocator)
+      : MemoryAllocator(0, nullptr), allocator_(allocator) {}
+
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    lock();
+    void* ptr = allocator_->allocate(size, alignment);
+    unlock();
+    return ptr;
+  }
+
+  void free(void* ptr) override {
+    lock();
+    allocator_->free(ptr);
+    unlock();
+  }
+
+  /// Also guards the callers' own state that is shared between delegates.
+  void lock() {
+    while (lock_.test_and_set(std::memory_order_acquire)) {
+    }
+  }
+
+  void unlock() {
+    lock_.clear(std::memory_order_release);
+  }
+
+ private:
+  MemoryAllocator* const allocator_;
+  std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+};
+
+} // namespace
+
+Error Method::init_thread_safe_delegates() {
+  const auto delegates = serialization_plan_->delegates();
+  // The delegates share the method allocator through a lock.
+  SerializedAllocator allocator(memory_manager_->method_allocator());
+
+  // The index and error of the first delegate that failed to initialize.
+  // Delegates after it are skipped, so that the error does not depend on
+  // thread timing. Those that were already initialized are destroyed by
+  // ~Method().
+  size_t failed_index = n_delegate_;
+  Error failed_error = Error::Ok;
+
+  // Without a threadpool, parallel_for() runs the delegates in order on this
+  // thread.
+  parallel_for(0, n_delegate_, 1, [&](int64_t begin, int64_t end) {
+    for (size_t i = begin; i < static_cast<size_t>(end); ++i) {
+      if (!delegates_[i].IsInitThreadSafe()) {
+        continue;
+      }
+      allocator.lock();
+      const bool skip = i > failed_index;
+      allocator.unlock();
+      if (skip) {
+        continue;
+      }
+      BackendInitContext backend_init_context(
+          &allocator,
+          BackendDelegate::IsProcessedDataMapped(
+              *delegates->Get(delegates_[i].lowering_index()), program_));
+      Error err = delegates_[i].Init(backend_init_context);
+      if (err != Error::Ok) {
+        allocator.lock();
+        if (i < failed_index) {
+          failed_index = i;
+          failed_error = err;
+        }
+        allocator.unlock();
+      }
+    }
+  });
+  return failed_error;
+}
+
+namespace {
+
+/// The most lowerings that one partition may have, including its own.
+constexpr size_t kMaxDelegateLowerings = 8;
+
+/// The most timed runs of each lowering of a partition.
+constexpr size_t kMaxMeasuredRuns = 15;
+
+/**
+ * Returns the median duration in ticks of `runs` runs of a delegate, after a
+ * warm-up run, or 0 if a run failed.
+ */
+uint64_t time_delegate(
+    const BackendDelegate& delegate,
+    EValue** args,
+    size_t runs) {
+  BackendExecutionContext backend_execution_context;
+  if (delegate.Execute(backend_execution_context, args) != Error::Ok) {
+    return 0;
+  }
+  uint64_t durations[kMaxMeasuredRuns];
+  for (size_t r = 0; r < runs; ++r) {
+    const et_timestamp_t start = et_pal_current_ticks();
+    Error err = delegate.Execute(backend_execution_context, args);
+    const et_timestamp_t end = et_pal_current_ticks();
+    if (err != Error::Ok) {
+      return 0;
+    }
+    // Keep 0 for failures.
+    durations[r] = std::max<uint64_t>(end - start, 1);
+  }
+  std::nth_element(durations, durations + runs / 2, durations + runs);
+  return durations[runs / 2];
+}
+
+} // namespace
+
+bool Method::is_alternative_delegate(size_t index) const {
+  const auto delegates = serialization_plan_->delegates();
+  for (size_t i = 0; i < delegates->size(); ++i) {
+    const auto* alternatives = delegates->Get(i)->alternatives();
+    if (i == index || alternatives == nullptr) {
+      continue;
+    }
+    for (size_t k = 0; k < alternatives->size(); ++k) {
+      if (alternatives->Get(k) == index) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+Result<size_t> Method::available_lowerings(
+    size_t index,
+    const char** backend_ids,
+    size_t* lowerings) const {
+  const auto delegates = serialization_plan_->delegates();
+  const auto* alternatives = delegates->Get(index)->alternatives();
+  const size_t n_alternatives =
+      alternatives != nullptr ? alternatives->size() : 0;
+  ET_CHECK_OR_RETURN_ERROR(
+      n_alternatives < kMaxDelegateLowerings,
+      NotSupported,
+      "Delegate %zu has %zu alternative lowerings; max %zu",
+      index,
+      n_alternatives,
+      kMaxDelegateLowerings - 1);
+
+  size_t count = 0;
+  for (size_t k = 0; k <= n_alternatives; ++k) {
+    const size_t lowering = k == 0 ? index : alternatives->Get(k - 1);
+    ET_CHECK_OR_RETURN_ERROR(
+        lowering < delegates->size() && (k == 0 || lowering != index),
+        InvalidProgram,
+        "Delegate %zu has invalid alternative %zu",
+        index,
+        lowering);
+    const char* backend_id = delegates->Get(lowering)->id()->c_str();
+    const PyTorchBackendInterface* backend = get_backend_class(backend_id);
+    if (backend != nullptr && backend->is_available()) {
+      backend_ids[count] = backend_id;
+      lowerings[count] = lowering;
+      ++count;
+    }
+  }
+  return count;
+}
+
+Result<size_t> Method::select_lowering(size_t index, bool* measure) {
+  *measure = false;
+  const char* backend_ids[kMaxDelegateLowerings];
+  size_t lowerings[kMaxDelegateLowerings];
+  Result<size_t> count = available_lowerings(index, backend_ids, lowerings);
+  if (!count.ok()) {
+    return count.error();
+  }
+  if (count.get() == 0) {
+    // Load() reports why the preferred lowering can't be used.
+    return index;
+  }
+  if (count.get() == 1 || delegate_selector_ == nullptr) {
+    return lowerings[0];
+  }
+
+  const int32_t selected = delegate_selector_->select(
+      serialization_plan_->name()->c_str(),
+      index,
+      ArrayRef<const char*>(backend_ids, count.get()));
+  if (selected == DelegateSelector::kMeasure) {
+    // Start with the preferred lowering; measure_delegates() switches to the
+    // fastest one.
+    *measure = true;
+    return lowerings[0];
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      selected >= 0 && static_cast<size_t>(selected) < count.get(),
+      InvalidArgument,
+      "Selected lowering %" PRId32 " of %zu for delegate %zu",
+      selected,
+      count.get(),
+      index);
+  return lowerings[selected];
+}
+
+Error Method::reload_delegate(size_t index, size_t lowering) {
+  BackendDelegate& delegate = delegates_[index];
+  delegate.Reset(lowering);
+  const auto& serialized = *serialization_plan_->delegates()->Get(lowering);
+  MemoryAllocator* method_allocator = memory_manager_->method_allocator();
+  Error err =
+      BackendDelegate::Load(serialized, program_, method_allocator, &delegate);
+  if (err != Error::Ok) {
+    return err;
+  }
+  BackendInitContext backend_init_context(
+      method_allocator,
+      BackendDelegate::IsProcessedDataMapped(serialized, program_));
+  return delegate.Init(backend_init_context);
+}
+
+Error Method::measure_delegates() {
+  for (size_t i = 0; i < n_delegate_; ++i) {
+    BackendDelegate& delegate = delegates_[i];
+    if (!delegate.measure()) {
+      continue;
+    }
+
+    // Run the partition on the arguments of its first call, which must all
+    // have memory.
+    Span<EValue*> args;
+    for (size_t c = 0; c < n_chains_ && args.size() == 0; ++c) {
+      for (const Instruction& instruction : chains_[c].instructions_) {
+        if (instruction.type == Instruction::Type::DelegateCall &&
+            static_cast<size_t>(instruction.index) == i) {
+          args = instruction.args;
+          break;
+        }
+      }
+    }
+    bool runnable = args.size() > 0;
+    for (EValue* arg : args) {
+      if (arg->isTensor() && arg->toTensor().nbytes() > 0 &&
+          arg->toTensor().const_data_ptr() == nullptr) {
+        runnable = false;
+      }
+    }
+    if (!runnable) {
+      ET_LOG(
+          Info,
+          "Not timing the lowerings of delegate %zu, whose arguments have "
+          "no memory until they are set",
+          i);
+      continue;
+    }
+
+    const char* backend_ids[kMaxDelegateLowerings];
+    size_t lowerings[kMaxDelegateLowerings];
+    Result<size_t> count = available_lowerings(i, backend_ids, lowerings);
+    if (!count.ok()) {
+      return count.error();
+    }
+    const size_t runs = std::min(
+        std::max<size_t>(delegate_selector_->num_measured_runs(), 1),
+        kMaxMeasuredRuns);
+
+    uint64_t ticks[kMaxDelegateLowerings] = {};
+    size_t best = 0;
+    for (size_t k = 0; k < count.get(); ++k) {
+      if (delegate.lowering_index() != lowerings[k] ||
+          !delegate.IsInitialized()) {
+        if (reload_delegate(i, lowerings[k]) != Error::Ok) {
+          continue;
+        }
+      }
+      ticks[k] = time_delegate(delegate, args.data(), runs);
+      if (ticks[k] != 0 && (ticks[best] == 0 || ticks[k] < ticks[best])) {
+        best = k;
+      }
+    }
+
+    if (delegate.lowering_index() != lowerings[best] ||
+        !delegate.IsInitialized()) {
+      Error err = reload_delegate(i, lowerings[best]);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+    delegate_selector_->on_measured(
+        serialization_plan_->name()->c_str(),
+        i,
+        ArrayRef<const char*>(backend_ids, count.get()),
+        ArrayRef<uint64_t>(ticks, count.get()),
+        best);
+  }
+  return Error::Ok;
+}
+
+Error Method::init(
+    executorch_flatbuffer::ExecutionPlan* s_plan,
+    internal::OperatorCache* operator_cache) {
   EXECUTORCH_SCOPE_PROF("Method::init");
   internal::EventTracerProfileScope event_tracer_profile_scope =
       internal::EventTracerProfileScope(event_tracer_, "Method::init");
@@ -519,9 +2194,49 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
       InitializationState::InitializationFailed; // Until proven otherwise
   serialization_plan_ = s_plan;
   auto method_allocator = memory_manager_->method_allocator();
+  init_bytes_loaded_ = 0;
+  const size_t method_allocator_start = method_allocator->used_size();
+  internal::LoadEventScope init_load_event(
+      event_tracer_, "Method::init", &init_bytes_loaded_, method_allocator);
+
+  {
+    // Let the loader start reading the delegate segments now, so that the I/O
+    // overlaps with parsing the values and initializing earlier delegates.
+    const auto delegates = serialization_plan_->delegates();
+    if (delegates != nullptr) {
+      for (size_t i = 0; i < delegates->size(); ++i) {
+        if (is_alternative_delegate(i)) {
+          // Only loaded if chosen over the preferred lowering.
+          continue;
+        }
+        const auto* processed = delegates->Get(i)->processed();
+        if (processed != nullptr &&
+            processed->location() ==
+                executorch_flatbuffer::DataLocation::SEGMENT) {
+          program_->PrefetchSegment(processed->index());
+        }
+      }
+    }
+  }
+
+  if (weight_streaming_ != nullptr) {
+    // Decide which constants to stream before parsing the values, which then
+    // leaves those unloaded.
+    auto streamer = internal::WeightStreamer::create(
+        program_, serialization_plan_, method_allocator, *weight_streaming_);
+    if (!streamer.ok()) {
+      return streamer.error();
+    }
+    weight_streamer_ = streamer.get();
+  }
 
   {
     // Parse the elements of the values_ array.
+    internal::LoadEventScope load_event(
+        event_tracer_,
+        "Method::parse_values",
+        &init_bytes_loaded_,
+        method_allocator);
     Error err = parse_values();
     if (err != Error::Ok) {
       return err;
@@ -530,34 +2245,106 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
 
   {
     // Resolve delegates
+    const size_t delegate_allocator_start = method_allocator->used_size();
     const auto delegates = serialization_plan_->delegates();
     ET_CHECK(delegates != nullptr);
     size_t n_delegate = delegates->size();
     delegates_ = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
         method_allocator, BackendDelegate, n_delegate);
 
-    // n_delegate_ counts the number of successfully-initialized delegates for
-    // ~Method() to clean up, and is incremented at the bottom of the loop. This
-    // makes it safe for errors to return without updating any state.
-    n_delegate_ = 0;
+    // Every entry starts out empty, so that ~Method() can clean up all of
+    // them whenever init() fails.
+    for (size_t i = 0; i < n_delegate; ++i) {
+      BackendDelegate::InitEmpty(
+          BackendDelegate::kNoLowering, /*measure=*/false, &delegates_[i]);
+    }
+    n_delegate_ = n_delegate;
+
+    // Choose the lowering of each partition, which may be one of the
+    // alternatives that the program carries for it. The entries of the
+    // alternatives themselves stay empty.
+    //
+    // Delegates whose backends have a thread-safe init() are initialized in
+    // parallel once all delegates are loaded, if there are several of them.
+    // The others are initialized in order as they load, so that each can
+    // free its data before the next one is loaded.
+    size_t n_thread_safe = 0;
+    for (size_t i = 0; i < n_delegate; ++i) {
+      if (is_alternative_delegate(i)) {
+        continue;
+      }
+      bool measure = false;
+      Result<size_t> lowering = select_lowering(i, &measure);
+      if (!lowering.ok()) {
+        return lowering.error();
+      }
+      BackendDelegate::InitEmpty(lowering.get(), measure, &delegates_[i]);
+      const PyTorchBackendInterface* backend =
+          get_backend_class(delegates->Get(lowering.get())->id()->c_str());
+      if (backend != nullptr && backend->is_init_thread_safe()) {
+        ++n_thread_safe;
+      }
+    }
+    const bool concurrent = n_thread_safe > 1;
+
+    for (size_t i = 0; i < n_delegate; ++i) {
+      const size_t lowering = delegates_[i].lowering_index();
+      if (lowering == BackendDelegate::kNoLowering) {
+        continue;
+      }
+      const auto& delegate = *delegates->Get(lowering);
+      // Covers the load, and the init unless it runs concurrently below.
+      internal::LoadEventScope load_event(
+          event_tracer_,
+          delegate.id()->c_str(),
+          &init_bytes_loaded_,
+          method_allocator,
+          static_cast<int32_t>(i));
+      Error err = BackendDelegate::Load(
+          delegate, program_, method_allocator, &delegates_[i]);
+      if (err != Error::Ok) {
+        return err;
+      }
+      if (delegate.processed()->location() ==
+          executorch_flatbuffer::DataLocation::SEGMENT) {
+        init_bytes_loaded_ += delegates_[i].ProcessedDataSize();
+      }
+
+      if (concurrent && delegates_[i].IsInitThreadSafe()) {
+        continue;
+      }
+      BackendInitContext backend_init_context(
+          method_allocator,
+          BackendDelegate::IsProcessedDataMapped(delegate, program_));
+      err = delegates_[i].Init(backend_init_context);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
 
-    for (size_t i = 0; i < n_delegate; ++i) {
-      const auto& delegate = *delegates->Get(i);
-      BackendInitContext backend_init_context(method_allocator);
-      Error err = BackendDelegate::Init(
-          delegate, program_, backend_init_context, &delegates_[i]);
+    if (concurrent) {
+      // The workers don't log; one event covers all of their inits.
+      internal::LoadEventScope load_event(
+          event_tracer_,
+          "Method::init_delegates",
+          &init_bytes_loaded_,
+          method_allocator);
+      Error err = init_thread_safe_delegates();
       if (err != Error::Ok) {
         return err;
       }
-      // ~Method() will try to clean up n_delegate_ entries in the delegates_
-      // array. Only increment this once we know the entry is valid, so that
-      // we don't try to clean up an uninitialized entry.
-      n_delegate_ = i + 1;
     }
+    delegate_allocator_bytes_ =
+        method_allocator->used_size() - delegate_allocator_start;
   }
 
   {
     // Load chains
+    internal::LoadEventScope load_event(
+        event_tracer_,
+        "Method::resolve_operators",
+        &init_bytes_loaded_,
+        method_allocator);
     const auto chains = serialization_plan_->chains();
     ET_CHECK(chains != nullptr);
     n_chains_ = chains->size();
@@ -567,59 +2354,296 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
     int32_t num_instructions_missing_op = 0;
     for (size_t i = 0; i < n_chains_; ++i) {
       auto s_chain = chains->Get(i);
+      ET_CHECK_OR_RETURN_ERROR(
+          s_chain->instructions() != nullptr,
+          InvalidProgram,
+          "chain %zu has no instructions field",
+          i);
       auto num_instructions = s_chain->instructions()->size();
-      auto chain_instruction_kernels = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-          method_allocator, OpFunction, num_instructions);
-      auto chain_instruction_arg_lists = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-          method_allocator, InstructionArgs, num_instructions);
-
-      // Set up the argument lists ahead of time and store pointers to them to
-      // use when the instructions are called
-      for (size_t instr_idx = 0; instr_idx < s_chain->instructions()->size();
-           ++instr_idx) {
+      auto chain_instructions = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+          method_allocator, Instruction, num_instructions);
+      // The argument lists of the chain's calls sit back to back in one
+      // allocation, in execution order.
+      const size_t num_chain_args = count_instruction_arguments(s_chain);
+      EValue** arg_pool = nullptr;
+      if (num_chain_args > 0) {
+        arg_pool = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+            method_allocator, EValue*, num_chain_args);
+      }
+
+      // Decode the instructions ahead of time, setting up their argument
+      // lists and resolving their kernels, so that execution doesn't need to
+      // look at the flatbuffer again.
+      for (size_t instr_idx = 0; instr_idx < num_instructions; ++instr_idx) {
         const auto instruction = s_chain->instructions()->Get(instr_idx);
+        Instruction& decoded = chain_instructions[instr_idx];
+        decoded.scalar_op = Instruction::ScalarOpcode::Add;
+        decoded.index = 0;
+        decoded.target = 0;
+        decoded.kernel = OpFunction(nullptr);
+        decoded.args = InstructionArgs();
+        decoded.folded = Span<Instruction::Folded>();
+        decoded.source_index = static_cast<uint32_t>(instr_idx);
         switch (instruction->instr_args_type()) {
           case executorch_flatbuffer::InstructionArguments::KernelCall: {
-            const auto arg_idxs =
-                instruction->instr_args_as_KernelCall()->args();
-            auto res = gen_instruction_arguments(
-                method_allocator, values_, arg_idxs->size(), arg_idxs->data());
-            if (!res.ok()) {
-              return res.error();
-            }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+            const auto kernel_call = instruction->instr_args_as_KernelCall();
+            const auto arg_idxs = kernel_call->args();
+            decoded.type = Instruction::Type::KernelCall;
+            decoded.index = kernel_call->op_index();
+            decoded.args = gen_instruction_arguments(
+                values_, arg_idxs->size(), arg_idxs->data(), arg_pool);
             auto err = resolve_operator(
-                instruction->instr_args_as_KernelCall()->op_index(),
-                chain_instruction_kernels,
-                instr_idx,
-                res.get(),
-                arg_idxs->size());
+                kernel_call->op_index(),
+                &decoded.kernel,
+                decoded.args,
+                arg_idxs->size(),
+                operator_cache);
             if (err == Error::OperatorMissing) {
               num_instructions_missing_op++;
             } else if (err == Error::MemoryAllocationFailed) {
               return err;
+            } else if (err == Error::Ok) {
+              const auto op =
+                  serialization_plan_->operators()->Get(decoded.index);
+              if (find_scalar_opcode(
+                      op->name()->c_str(),
+                      op->overload()->c_str(),
+                      arg_idxs->size(),
+                      &decoded.scalar_op)) {
+                decoded.type = Instruction::Type::ScalarOp;
+              }
             }
           } break;
           case executorch_flatbuffer::InstructionArguments::DelegateCall: {
-            const auto arg_idxs =
-                instruction->instr_args_as_DelegateCall()->args();
-            auto res = gen_instruction_arguments(
-                method_allocator, values_, arg_idxs->size(), arg_idxs->data());
-            if (!res.ok()) {
-              return res.error();
+            const auto delegate_call =
+                instruction->instr_args_as_DelegateCall();
+            const auto arg_idxs = delegate_call->args();
+            decoded.type = Instruction::Type::DelegateCall;
+            decoded.index = delegate_call->delegate_index();
+            decoded.args = gen_instruction_arguments(
+                values_, arg_idxs->size(), arg_idxs->data(), arg_pool);
+            ET_CHECK_OR_RETURN_ERROR(
+                decoded.index >= 0 &&
+                    static_cast<size_t>(decoded.index) < n_delegate_,
+                InvalidProgram,
+                "DELEGATE_CALL index %" PRId32
+                " >= num delegates %zu at instruction %zu",
+                decoded.index,
+                n_delegate_,
+                instr_idx);
+            ET_CHECK_OR_RETURN_ERROR(
+                delegates_[decoded.index].IsLoaded(),
+                InvalidProgram,
+                "DELEGATE_CALL to alternative lowering %" PRId32
+                " at instruction %zu",
+                decoded.index,
+                instr_idx);
+            Error err = delegates_[decoded.index].PrepareBinding(
+                decoded.args.size(), method_allocator);
+            if (err != Error::Ok) {
+              return err;
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+          } break;
+          case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
+            const auto jf_call = instruction->instr_args_as_JumpFalseCall();
+            decoded.type = Instruction::Type::JumpFalseCall;
+            decoded.index = jf_call->cond_value_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                is_valid_value_index(decoded.index),
+                InvalidProgram,
+                "JF_CALL cond value index %" PRId32 " out of range",
+                decoded.index);
+            decoded.target = jf_call->destination_instruction();
+            ET_CHECK_OR_RETURN_ERROR(
+                decoded.target >= 0 &&
+                    static_cast<size_t>(decoded.target) <= num_instructions,
+                InvalidProgram,
+                "JF_CALL destination %" PRId32
+                " out of range for chain %zu with %zu instructions",
+                decoded.target,
+                i,
+                (size_t)num_instructions);
+          } break;
+          case executorch_flatbuffer::InstructionArguments::MoveCall: {
+            const auto move_call = instruction->instr_args_as_MoveCall();
+            decoded.type = Instruction::Type::MoveCall;
+            decoded.index = move_call->move_from();
+            decoded.target = move_call->move_to();
+            ET_CHECK_OR_RETURN_ERROR(
+                is_valid_value_index(decoded.index) &&
+                    is_valid_value_index(decoded.target),
+                InvalidProgram,
+                "MOVE_CALL value indices %" PRId32 " -> %" PRId32
+                " out of range",
+                decoded.index,
+                decoded.target);
+          } break;
+          case executorch_flatbuffer::InstructionArguments::FreeCall: {
+            decoded.type = Instruction::Type::FreeCall;
+            decoded.index = instruction->instr_args_as_FreeCall()->value_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                is_valid_value_index(decoded.index) &&
+                    values_[decoded.index].isTensor(),
+                InvalidProgram,
+                "FREE_CALL value index %" PRId32 " is not a tensor",
+                decoded.index);
+          } break;
+          case executorch_flatbuffer::InstructionArguments::MapBegin: {
+            const auto map_begin = instruction->instr_args_as_MapBegin();
+            const int32_t arg_idxs[kMapBeginNumArgs] = {
+                map_begin->input_index(),
+                map_begin->slice_index(),
+                map_begin->output_index(),
+                map_begin->body_output_index(),
+                map_begin->iter_index(),
+            };
+            for (size_t a = 0; a < kMapBeginNumArgs; ++a) {
+              const bool is_iter = a == kMapBeginNumArgs - 1;
+              ET_CHECK_OR_RETURN_ERROR(
+                  is_valid_value_index(arg_idxs[a]) &&
+                      (is_iter ? values_[arg_idxs[a]].isInt()
+                               : values_[arg_idxs[a]].isTensor()),
+                  InvalidProgram,
+                  "MAP_BEGIN value index %" PRId32 " at instruction %zu is "
+                  "out of range or of the wrong type",
+                  arg_idxs[a],
+                  instr_idx);
+            }
+            // The slice and the body output are repointed every iteration,
+            // so they can't be the same value.
+            ET_CHECK_OR_RETURN_ERROR(
+                arg_idxs[1] != arg_idxs[3],
+                InvalidProgram,
+                "MAP_BEGIN at instruction %zu has the same slice and body "
+                "output",
+                instr_idx);
+            decoded.type = Instruction::Type::MapBegin;
+            decoded.args = gen_instruction_arguments(
+                values_, kMapBeginNumArgs, arg_idxs, arg_pool);
+            decoded.target = map_begin->end_instruction();
+            ET_CHECK_OR_RETURN_ERROR(
+                decoded.target > static_cast<int32_t>(instr_idx) &&
+                    static_cast<size_t>(decoded.target) <= num_instructions,
+                InvalidProgram,
+                "MAP_BEGIN end %" PRId32
+                " out of range for chain %zu with %zu instructions",
+                decoded.target,
+                i,
+                (size_t)num_instructions);
+          } break;
+          case executorch_flatbuffer::InstructionArguments::MapEnd: {
+            const auto map_end = instruction->instr_args_as_MapEnd();
+            decoded.type = Instruction::Type::MapEnd;
+            decoded.index = map_end->iter_index();
+            decoded.target = map_end->begin_instruction();
+            ET_CHECK_OR_RETURN_ERROR(
+                is_valid_value_index(decoded.index) &&
+                    values_[decoded.index].isInt(),
+                InvalidProgram,
+                "MAP_END iteration count index %" PRId32 " is not an int",
+                decoded.index);
+            // The MapBegin comes first, so it has already been decoded.
+            ET_CHECK_OR_RETURN_ERROR(
+                decoded.target >= 0 &&
+                    decoded.target < static_cast<int32_t>(instr_idx) &&
+                    chain_instructions[decoded.target].type ==
+                        Instruction::Type::MapBegin,
+                InvalidProgram,
+                "MAP_END at instruction %zu does not point at a MAP_BEGIN",
+                instr_idx);
+          } break;
+          case executorch_flatbuffer::InstructionArguments::WhileBegin: {
+            const auto while_begin = instruction->instr_args_as_WhileBegin();
+            const auto init = while_begin->init_indices();
+            const auto state = while_begin->state_indices();
+            const auto body_outputs = while_begin->body_output_indices();
+            ET_CHECK_OR_RETURN_ERROR(
+                init != nullptr && state != nullptr &&
+                    body_outputs != nullptr &&
+                    init->size() == state->size() &&
+                    body_outputs->size() == state->size(),
+                InvalidProgram,
+                "WHILE_BEGIN at instruction %zu needs one init value and one "
+                "body output per state value",
+                instr_idx);
+            const size_t n = state->size();
+            for (const auto lists : {init, state, body_outputs}) {
+              for (const int32_t value_idx : *lists) {
+                ET_CHECK_OR_RETURN_ERROR(
+                    is_valid_value_index(value_idx) &&
+                        values_[value_idx].isTensor(),
+                    InvalidProgram,
+                    "WHILE_BEGIN value index %" PRId32
+                    " at instruction %zu is not a tensor",
+                    value_idx,
+                    instr_idx);
+              }
+            }
+            // Swapping a body output with anything but its own state would
+            // leave two state values sharing one buffer.
+            for (size_t a = 0; a < n; ++a) {
+              for (size_t b = 0; b < n; ++b) {
+                ET_CHECK_OR_RETURN_ERROR(
+                    (a == b || state->Get(a) != state->Get(b)) &&
+                        (a == b || body_outputs->Get(a) != state->Get(b)),
+                    InvalidProgram,
+                    "WHILE_BEGIN at instruction %zu has aliased state values",
+                    instr_idx);
+              }
+            }
+            ET_CHECK_OR_RETURN_ERROR(
+                is_valid_value_index(while_begin->iter_index()) &&
+                    values_[while_begin->iter_index()].isInt(),
+                InvalidProgram,
+                "WHILE_BEGIN iteration count index %" PRId32 " is not an int",
+                while_begin->iter_index());
+            decoded.type = Instruction::Type::WhileBegin;
+            decoded.index = static_cast<int32_t>(n);
+            EValue** args = arg_pool;
+            gen_instruction_arguments(values_, n, init->data(), arg_pool);
+            gen_instruction_arguments(values_, n, state->data(), arg_pool);
+            gen_instruction_arguments(
+                values_, n, body_outputs->data(), arg_pool);
+            const int32_t iter_index = while_begin->iter_index();
+            gen_instruction_arguments(values_, 1, &iter_index, arg_pool);
+            decoded.args = InstructionArgs(args, 3 * n + 1);
+          } break;
+          case executorch_flatbuffer::InstructionArguments::WhileEnd: {
+            decoded.type = Instruction::Type::WhileEnd;
+            decoded.target =
+                instruction->instr_args_as_WhileEnd()->begin_instruction();
+            // The WhileBegin comes first, so it has already been decoded.
+            ET_CHECK_OR_RETURN_ERROR(
+                decoded.target >= 0 &&
+                    decoded.target < static_cast<int32_t>(instr_idx) &&
+                    chain_instructions[decoded.target].type ==
+                        Instruction::Type::WhileBegin,
+                InvalidProgram,
+                "WHILE_END at instruction %zu does not point at a WHILE_BEGIN",
+                instr_idx);
           } break;
           default:
-            // wasteful but non kernel/delegate instructions are fairly sparse
-            // maybe need to revisit if FreeCall becomes to populous
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+            ET_LOG(
+                Error,
+                "Instruction is not supported. %hhu",
+                static_cast<uint8_t>(instruction->instr_args_type()));
+            return Error::InvalidProgram;
+        }
+      }
+      // When tracing, keep every instruction so that each one still gets its
+      // own event.
+      size_t num_kept = num_instructions;
+      if (event_tracer_ == nullptr) {
+        auto res = fold_bookkeeping_instructions(
+            method_allocator, chain_instructions, num_instructions);
+        if (!res.ok()) {
+          return res.error();
         }
+        num_kept = res.get();
       }
       chains_[i] = Chain{
           s_chain,
-          Span<InstructionArgs>(chain_instruction_arg_lists, num_instructions),
-          chain_instruction_kernels,
+          Span<Instruction>(chain_instructions, num_kept),
       };
     }
     ET_CHECK_OR_RETURN_ERROR(
@@ -630,6 +2654,34 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
         num_instructions_missing_op);
   }
 
+  if (weight_streamer_ != nullptr) {
+    // The streamer only allows a single chain of calls. Note the uses after
+    // folding, since those are the indices that execution reports.
+    const auto instructions = chains_[0].instructions_;
+    for (size_t j = 0; j < instructions.size(); ++j) {
+      const Instruction& instruction = instructions[j];
+      if (instruction.type == Instruction::Type::KernelCall ||
+          instruction.type == Instruction::Type::ScalarOp ||
+          instruction.type == Instruction::Type::DelegateCall) {
+        for (EValue* arg : instruction.args) {
+          weight_streamer_->note_use(static_cast<size_t>(arg - values_), j);
+        }
+      }
+    }
+    Error err = weight_streamer_->finish_init(method_allocator);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
+  {
+    // Find chains that can run concurrently.
+    Error err = plan_chain_schedule();
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
   pre_allocated_input_ = false;
 
   // Get pre_allocation info for input tensors
@@ -658,8 +2710,19 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
       "Expected program to have at least one chain received %zu",
       n_chains_);
 
+  {
+    // Time the lowerings of the partitions whose selector asked for it, now
+    // that the delegate calls know their arguments.
+    Error err = measure_delegates();
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
   step_state_ = StepState{0, 0};
 
+  method_allocator_bytes_ =
+      method_allocator->used_size() - method_allocator_start;
   init_state_ = InitializationState::Initialized;
   return Error::Ok;
 }
@@ -821,49 +2884,659 @@ Method::set_inputs(const exec_aten::ArrayRef<EValue>& input_evalues) {
   return Error::Ok;
 }
 
-__ET_NODISCARD Error
-Method::set_output_data_ptr(void* buffer, size_t size, size_t output_idx) {
-  // Check method state
+__ET_NODISCARD Error
+Method::set_output_data_ptr(void* buffer, size_t size, size_t output_idx) {
+  // Check method state
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Outputs can not be retrieved until method has been initialized.");
+
+  ET_CHECK_OR_RETURN_ERROR(
+      !pre_allocated_output_,
+      InvalidState,
+      "Overriding output data pointer allocated by memory plan is not allowed.");
+
+  // Check the args
+  ET_CHECK_OR_RETURN_ERROR(
+      output_idx <= outputs_size(),
+      InvalidArgument,
+      "output_idx: %zu num_outputs: %zu",
+      output_idx,
+      outputs_size());
+
+  auto& output = mutable_output(output_idx);
+  ET_CHECK_OR_RETURN_ERROR(
+      output.isTensor(),
+      InvalidArgument,
+      "output type: %zu is not tensor",
+      (size_t)output.tag);
+
+  auto& t = output.toTensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      output.isTensor(),
+      InvalidArgument,
+      "output type: %zu is not tensor",
+      (size_t)output.tag);
+  ET_CHECK_OR_RETURN_ERROR(
+      t.nbytes() <= size,
+      InvalidArgument,
+      "buffer size: %zu is smaller then expected tensor size: %zu",
+      size,
+      t.nbytes());
+
+  // Set data
+  return internal::set_tensor_data(t, buffer, size);
+}
+
+namespace {
+
+/// Checks one list of an IOBufferSet against the values it will back.
+Error validate_io_buffers(
+    exec_aten::ArrayRef<Method::IOBuffer> buffers,
+    const EValue* values,
+    const flatbuffers::Vector<int32_t>* value_indices,
+    bool pre_allocated,
+    const char* kind,
+    size_t set_index) {
+  ET_CHECK_OR_RETURN_ERROR(
+      buffers.size() == value_indices->size(),
+      InvalidArgument,
+      "Buffer set %zu has %zu %s buffers; expected %zu",
+      set_index,
+      buffers.size(),
+      kind,
+      static_cast<size_t>(value_indices->size()));
+  for (size_t i = 0; i < buffers.size(); i++) {
+    const EValue& value = values[value_indices->Get(i)];
+    if (!value.isTensor()) {
+      ET_CHECK_OR_RETURN_ERROR(
+          buffers[i].data == nullptr,
+          InvalidArgument,
+          "Buffer set %zu provides a buffer for non-tensor %s %zu",
+          set_index,
+          kind,
+          i);
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        !pre_allocated,
+        InvalidState,
+        "Overriding %s data pointer allocated by memory plan is not allowed.",
+        kind);
+    ET_CHECK_OR_RETURN_ERROR(
+        buffers[i].data != nullptr,
+        InvalidArgument,
+        "Buffer set %zu is missing the buffer for %s %zu",
+        set_index,
+        kind,
+        i);
+    const size_t nbytes = value.toTensor().nbytes();
+    ET_CHECK_OR_RETURN_ERROR(
+        buffers[i].size >= nbytes,
+        InvalidArgument,
+        "Buffer set %zu %s %zu: buffer size %zu < tensor size %zu",
+        set_index,
+        kind,
+        i,
+        buffers[i].size,
+        nbytes);
+  }
+  return Error::Ok;
+}
+
+} // namespace
+
+Error Method::set_io_buffer_sets(
+    exec_aten::ArrayRef<IOBufferSet> buffer_sets) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Buffers can not be registered until method has been initialized.");
+  for (size_t i = 0; i < buffer_sets.size(); i++) {
+    Error err = validate_io_buffers(
+        buffer_sets[i].inputs,
+        values_,
+        serialization_plan_->inputs(),
+        pre_allocated_input_,
+        "input",
+        i);
+    if (err != Error::Ok) {
+      return err;
+    }
+    err = validate_io_buffers(
+        buffer_sets[i].outputs,
+        values_,
+        serialization_plan_->outputs(),
+        pre_allocated_output_,
+        "output",
+        i);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  io_buffer_sets_ = buffer_sets;
+  return Error::Ok;
+}
+
+Error Method::select_io_buffer_set(size_t index) {
+  ET_CHECK_OR_RETURN_ERROR(
+      index < io_buffer_sets_.size(),
+      InvalidArgument,
+      "Buffer set %zu >= num registered sets %zu",
+      index,
+      io_buffer_sets_.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      !async_pending_,
+      InvalidState,
+      "Cannot switch buffers while an asynchronous execution is pending.");
+
+  // Sizes were validated by set_io_buffer_sets(), so this only rebinds.
+  const IOBufferSet& set = io_buffer_sets_[index];
+  for (size_t i = 0; i < set.inputs.size(); i++) {
+    if (set.inputs[i].data == nullptr) {
+      continue;
+    }
+    Error err = internal::set_tensor_data(
+        mutable_input(i).toTensor(), set.inputs[i].data, set.inputs[i].size);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  for (size_t i = 0; i < set.outputs.size(); i++) {
+    if (set.outputs[i].data == nullptr) {
+      continue;
+    }
+    Error err = internal::set_tensor_data(
+        mutable_output(i).toTensor(),
+        set.outputs[i].data,
+        set.outputs[i].size);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  return Error::Ok;
+}
+
+namespace {
+
+/// Mutable state tensors have both initial data and planned memory; see
+/// getTensorDataPtr().
+bool is_state_tensor(const executorch_flatbuffer::Tensor* s_tensor) {
+  return s_tensor != nullptr && s_tensor->constant_buffer_idx() > 0 &&
+      s_tensor->allocation_info() != nullptr;
+}
+
+} // namespace
+
+int32_t Method::find_named_constant(const char* name) const {
+  const auto named_constants = serialization_plan_->named_constants();
+  if (named_constants == nullptr) {
+    return -1;
+  }
+  for (const auto* named_constant : *named_constants) {
+    if (named_constant->name() != nullptr &&
+        strcmp(named_constant->name()->c_str(), name) == 0) {
+      return named_constant->value_index();
+    }
+  }
+  return -1;
+}
+
+Error Method::set_constant_data(
+    size_t value_index,
+    const void* data,
+    size_t nbytes) {
+  const auto* s_tensor =
+      serialization_plan_->values()->Get(value_index)->val_as_Tensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      s_tensor != nullptr && s_tensor->constant_buffer_idx() > 0 &&
+          s_tensor->allocation_info() == nullptr,
+      InvalidProgram,
+      "Named constant at value index %zu is not a constant tensor",
+      value_index);
+  ET_CHECK_OR_RETURN_ERROR(
+      weight_streamer_ == nullptr ||
+          !weight_streamer_->is_streamed(value_index),
+      NotSupported,
+      "Constant at value index %zu is streamed",
+      value_index);
+  const exec_aten::Tensor& tensor = values_[value_index].toTensor();
+  if (data == nullptr) {
+    // Go back to the data that parse_values() gave the tensor.
+    const uint32_t buffer_index = s_tensor->constant_buffer_idx();
+    for (size_t i = 0; i < n_constant_buffer_; ++i) {
+      if (constant_buffers_[i].index == buffer_index) {
+        data = constant_buffers_[i].data.data();
+        nbytes = constant_buffers_[i].data.size();
+        break;
+      }
+    }
+    if (data == nullptr) {
+      Result<const void*> own =
+          program_->get_constant_buffer_data(buffer_index);
+      if (!own.ok()) {
+        return own.error();
+      }
+      data = own.get();
+      nbytes = tensor.nbytes();
+    }
+  } else {
+    ET_CHECK_OR_RETURN_ERROR(
+        nbytes == tensor.nbytes(),
+        InvalidArgument,
+        "Constant at value index %zu has %zu bytes, got %zu",
+        value_index,
+        static_cast<size_t>(tensor.nbytes()),
+        nbytes);
+  }
+  // Constants are only read; see the const_cast note in the tensor parser.
+  return internal::set_tensor_data(tensor, const_cast<void*>(data), nbytes);
+}
+
+Error Method::check_constant(const ConstantData& constant) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      constant.name != nullptr && constant.data != nullptr,
+      InvalidArgument,
+      "Constant has no name or data");
+  const int32_t value_index = find_named_constant(constant.name);
+  if (value_index < 0) {
+    // Only delegates hold it, if anything does.
+    bool found = false;
+    for (size_t i = 0; i < n_delegate_; ++i) {
+      if (!delegates_[i].IsInitialized()) {
+        continue;
+      }
+      Result<size_t> nbytes = delegates_[i].GetConstantNbytes(constant.name);
+      if (nbytes.error() == Error::NotFound ||
+          nbytes.error() == Error::NotSupported) {
+        continue;
+      }
+      if (!nbytes.ok()) {
+        return nbytes.error();
+      }
+      ET_CHECK_OR_RETURN_ERROR(
+          constant.nbytes == nbytes.get(),
+          InvalidArgument,
+          "Delegate %zu holds constant %s of %zu bytes, got %zu",
+          i,
+          constant.name,
+          nbytes.get(),
+          constant.nbytes);
+      found = true;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        found, NotFound, "Method has no constant named %s", constant.name);
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      is_valid_value_index(value_index) && values_[value_index].isTensor(),
+      InvalidProgram,
+      "Named constant %s has invalid value index %" PRId32,
+      constant.name,
+      value_index);
+  const auto* s_tensor =
+      serialization_plan_->values()->Get(value_index)->val_as_Tensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      !is_state_tensor(s_tensor),
+      InvalidArgument,
+      "Named constant %s is mutable state",
+      constant.name);
+  ET_CHECK_OR_RETURN_ERROR(
+      s_tensor != nullptr && s_tensor->constant_buffer_idx() > 0,
+      InvalidProgram,
+      "Named constant %s is not a constant tensor",
+      constant.name);
+  ET_CHECK_OR_RETURN_ERROR(
+      weight_streamer_ == nullptr ||
+          !weight_streamer_->is_streamed(value_index),
+      NotSupported,
+      "Constant %s is streamed",
+      constant.name);
+  ET_CHECK_OR_RETURN_ERROR(
+      constant.nbytes == values_[value_index].toTensor().nbytes(),
+      InvalidArgument,
+      "Constant %s has %zu bytes, got %zu",
+      constant.name,
+      static_cast<size_t>(values_[value_index].toTensor().nbytes()),
+      constant.nbytes);
+  return Error::Ok;
+}
+
+Error Method::update_delegate_constant(
+    const char* name,
+    const void* data,
+    size_t nbytes) {
+  bool found = false;
+  for (size_t i = 0; i < n_delegate_; ++i) {
+    if (!delegates_[i].IsInitialized()) {
+      continue;
+    }
+    Error err = delegates_[i].UpdateConstant(name, data, nbytes);
+    if (err == Error::Ok) {
+      found = true;
+    } else if (err != Error::NotFound && err != Error::NotSupported) {
+      ET_LOG(
+          Error,
+          "Delegate %zu failed to update constant %s: 0x%" PRIx32,
+          i,
+          name,
+          static_cast<uint32_t>(err));
+      return err;
+    }
+  }
+  return found ? Error::Ok : Error::NotFound;
+}
+
+Error Method::set_constants(exec_aten::ArrayRef<ConstantData> constants) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Constants can not be set until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0 &&
+          !async_pending_,
+      InvalidState,
+      "Constants can not be set mid execution.");
+
+  // Check every constant before changing anything, so that a rejected set
+  // leaves the previous one in place.
+  for (const ConstantData& constant : constants) {
+    Error err = check_constant(constant);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
+  // Restore what the previous set replaced and the new one doesn't. Those
+  // that both replace are simply repointed below, so that delegates only
+  // repack each of them once.
+  for (const ConstantData& previous : constants_) {
+    bool replaced = false;
+    for (const ConstantData& constant : constants) {
+      if (strcmp(previous.name, constant.name) == 0) {
+        replaced = true;
+        break;
+      }
+    }
+    if (replaced) {
+      continue;
+    }
+    const int32_t value_index = find_named_constant(previous.name);
+    Error err = value_index >= 0
+        ? set_constant_data(value_index, /*data=*/nullptr, /*nbytes=*/0)
+        : update_delegate_constant(previous.name, /*data=*/nullptr, 0);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  constants_ = constants;
+
+  for (const ConstantData& constant : constants) {
+    const int32_t value_index = find_named_constant(constant.name);
+    Error err = Error::Ok;
+    if (value_index >= 0) {
+      err = set_constant_data(value_index, constant.data, constant.nbytes);
+    } else {
+      err = update_delegate_constant(
+          constant.name, constant.data, constant.nbytes);
+    }
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  return Error::Ok;
+}
+
+Error Method::get_state_span(uint32_t* memory_id, size_t* begin, size_t* end)
+    const {
+  bool found = false;
+  for (size_t i = 0; i < n_value_; ++i) {
+    const auto* s_tensor =
+        serialization_plan_->values()->Get(i)->val_as_Tensor();
+    if (!is_state_tensor(s_tensor)) {
+      continue;
+    }
+    const auto* allocation_info = s_tensor->allocation_info();
+    const size_t offset = allocation_info->memory_offset();
+    const size_t nbytes = values_[i].toTensor().nbytes();
+    if (!found) {
+      *memory_id = allocation_info->memory_id();
+      *begin = offset;
+      *end = offset + nbytes;
+      found = true;
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        allocation_info->memory_id() == *memory_id,
+        NotSupported,
+        "Mutable state is planned in memory ids %" PRIu32 " and %" PRIu32,
+        *memory_id,
+        allocation_info->memory_id());
+    *begin = std::min(*begin, offset);
+    *end = std::max(*end, offset + nbytes);
+  }
+  return found ? Error::Ok : Error::NotFound;
+}
+
+Result<size_t> Method::state_size() const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "State can not be inspected until method has been initialized.");
+  uint32_t memory_id = 0;
+  size_t begin = 0;
+  size_t end = 0;
+  Error err = get_state_span(&memory_id, &begin, &end);
+  if (err != Error::Ok) {
+    return err;
+  }
+  return end - begin;
+}
+
+Error Method::set_state_buffer(void* data, size_t size) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "State can not be moved until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0 &&
+          !async_pending_,
+      InvalidState,
+      "State can not be moved mid execution.");
+  uint32_t memory_id = 0;
+  size_t begin = 0;
+  size_t end = 0;
+  Error err = get_state_span(&memory_id, &begin, &end);
+  if (err != Error::Ok) {
+    return err;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      data == nullptr || size >= end - begin,
+      InvalidArgument,
+      "State buffer has %zu bytes, state needs %zu",
+      size,
+      end - begin);
+
+  // State tensors are never reused by memory planning, so the only tensors
+  // planned within the span are the state, its aliases, e.g. the outputs of
+  // the ops that update it in place, and tensors in gaps between state
+  // tensors, which can live anywhere.
+  for (size_t i = 0; i < n_value_; ++i) {
+    const auto* s_tensor =
+        serialization_plan_->values()->Get(i)->val_as_Tensor();
+    if (s_tensor == nullptr || s_tensor->allocation_info() == nullptr ||
+        s_tensor->allocation_info()->memory_id() != memory_id) {
+      continue;
+    }
+    const size_t offset = s_tensor->allocation_info()->memory_offset();
+    if (offset < begin || offset >= end) {
+      continue;
+    }
+    void* tensor_data = nullptr;
+    if (data != nullptr) {
+      tensor_data = static_cast<uint8_t*>(data) + (offset - begin);
+    } else {
+      // memory_id 0 is reserved; see getTensorDataPtr().
+      Result<void*> planned = memory_manager_->planned_memory()
+                                  ->get_offset_address(
+                                      memory_id - 1, offset, end - offset);
+      if (!planned.ok()) {
+        return planned.error();
+      }
+      tensor_data = planned.get();
+    }
+    err = internal::set_tensor_data(
+        values_[i].toTensor(), tensor_data, end - offset);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  return Error::Ok;
+}
+
+Error Method::reset_state() {
   ET_CHECK_OR_RETURN_ERROR(
       initialized(),
       InvalidState,
-      "Outputs can not be retrieved until method has been initialized.");
-
+      "State can not be reset until method has been initialized.");
   ET_CHECK_OR_RETURN_ERROR(
-      !pre_allocated_output_,
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0 &&
+          !async_pending_,
       InvalidState,
-      "Overriding output data pointer allocated by memory plan is not allowed.");
+      "State can not be reset mid execution.");
+  for (size_t i = 0; i < n_value_; ++i) {
+    const auto* s_tensor =
+        serialization_plan_->values()->Get(i)->val_as_Tensor();
+    if (!is_state_tensor(s_tensor)) {
+      continue;
+    }
+    const uint32_t buffer_index = s_tensor->constant_buffer_idx();
+    const void* initial_data = nullptr;
+    for (size_t j = 0; j < n_constant_buffer_; ++j) {
+      if (constant_buffers_[j].index == buffer_index) {
+        initial_data = constant_buffers_[j].data.data();
+        break;
+      }
+    }
+    if (initial_data == nullptr) {
+      Result<const void*> data =
+          program_->get_constant_buffer_data(buffer_index);
+      if (!data.ok()) {
+        return data.error();
+      }
+      initial_data = data.get();
+    }
+    const exec_aten::Tensor& tensor = values_[i].toTensor();
+    if (tensor.nbytes() > 0) {
+      std::memcpy(tensor.mutable_data_ptr(), initial_data, tensor.nbytes());
+    }
+  }
+  return Error::Ok;
+}
 
-  // Check the args
-  ET_CHECK_OR_RETURN_ERROR(
-      output_idx <= outputs_size(),
-      InvalidArgument,
-      "output_idx: %zu num_outputs: %zu",
-      output_idx,
-      outputs_size());
+namespace {
 
-  auto& output = mutable_output(output_idx);
-  ET_CHECK_OR_RETURN_ERROR(
-      output.isTensor(),
-      InvalidArgument,
-      "output type: %zu is not tensor",
-      (size_t)output.tag);
+/// The stride at which warmup() reads constants. No larger than the smallest
+/// common page size, so that no page is skipped.
+constexpr size_t kWarmupPageSize = 4096;
 
-  auto& t = output.toTensor();
+/// Reads a byte of every page of `data`, so that the OS pages them in.
+void touch_pages(const void* data, size_t nbytes) {
+  const volatile uint8_t* bytes = static_cast<const volatile uint8_t*>(data);
+  uint8_t sink = 0;
+  for (size_t i = 0; i < nbytes; i += kWarmupPageSize) {
+    sink ^= bytes[i];
+  }
+  if (nbytes > 0) {
+    sink ^= bytes[nbytes - 1];
+  }
+  (void)sink;
+}
+
+} // namespace
+
+Error Method::warmup(const WarmupConfig& config) {
+  EXECUTORCH_SCOPE_PROF("Method::warmup");
   ET_CHECK_OR_RETURN_ERROR(
-      output.isTensor(),
-      InvalidArgument,
-      "output type: %zu is not tensor",
-      (size_t)output.tag);
+      initialized(),
+      InvalidState,
+      "Method can not be warmed up until it has been initialized.");
   ET_CHECK_OR_RETURN_ERROR(
-      t.nbytes() <= size,
-      InvalidArgument,
-      "buffer size: %zu is smaller then expected tensor size: %zu",
-      size,
-      t.nbytes());
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0 &&
+          !async_pending_,
+      InvalidState,
+      "Method can not be warmed up mid execution.");
 
-  // Set data
-  return internal::set_tensor_data(t, buffer, size);
+  if (config.touch_constants) {
+    // Constants have initial data and no planned memory; state tensors, which
+    // have both, were already written by the load. Streamed weights are not
+    // loaded yet and have no data.
+    for (size_t i = 0; i < n_value_; ++i) {
+      const auto* s_tensor =
+          serialization_plan_->values()->Get(i)->val_as_Tensor();
+      if (s_tensor == nullptr || s_tensor->constant_buffer_idx() == 0 ||
+          s_tensor->allocation_info() != nullptr) {
+        continue;
+      }
+      const exec_aten::Tensor& tensor = values_[i].toTensor();
+      if (tensor.const_data_ptr() != nullptr) {
+        touch_pages(tensor.const_data_ptr(), tensor.nbytes());
+      }
+    }
+  }
+
+  if (config.prepare_delegates) {
+    for (size_t i = 0; i < n_delegate_; ++i) {
+      if (!delegates_[i].IsInitialized()) {
+        continue;
+      }
+      Error err = delegates_[i].Prepare();
+      if (err != Error::Ok) {
+        ET_LOG(
+            Error,
+            "Failed to prepare delegate %zu: 0x%" PRIx32,
+            i,
+            static_cast<uint32_t>(err));
+        return err;
+      }
+    }
+  }
+
+  if (config.num_executions == 0) {
+    return Error::Ok;
+  }
+  for (size_t i = 0; i < inputs_size(); ++i) {
+    const EValue& input = values_[get_input_index(i)];
+    if (!input.isTensor()) {
+      // Other inputs keep the values they were exported with.
+      continue;
+    }
+    const exec_aten::Tensor& tensor = input.toTensor();
+    ET_CHECK_OR_RETURN_ERROR(
+        tensor.const_data_ptr() != nullptr || tensor.nbytes() == 0,
+        InvalidState,
+        "Input %zu has no memory; set it before warming up",
+        i);
+    if (pre_allocated_input_ && tensor.nbytes() > 0) {
+      std::memset(tensor.mutable_data_ptr(), 0, tensor.nbytes());
+    }
+  }
+  const bool event_tracer_enabled = event_tracer_enabled_;
+  event_tracer_enabled_ = false;
+  Error err = Error::Ok;
+  for (size_t i = 0; i < config.num_executions && err == Error::Ok; ++i) {
+    err = execute();
+  }
+  event_tracer_enabled_ = event_tracer_enabled;
+  if (err != Error::Ok) {
+    ET_LOG(
+        Error,
+        "Warmup execution failed: 0x%" PRIx32,
+        static_cast<uint32_t>(err));
+    return err;
+  }
+  return reset_state();
 }
 
 __ET_NODISCARD Error
@@ -889,41 +3562,66 @@ Method::get_outputs(EValue* output_evalues, size_t length) {
   return Error::Ok;
 }
 
-Error Method::execute_instruction() {
-  // TODO(jakeszwe): remove all the ET_CHECKS in this function and properly
-  // return the error instead
+void Method::release_temp_memory(MemoryAllocator* temp_allocator) {
+  if (temp_allocator == nullptr) {
+    return;
+  }
+  const size_t used = temp_allocator->used_size();
+  if (used > temp_allocator_high_watermark_) {
+    temp_allocator_high_watermark_ = used;
+  }
+  temp_allocator->reset();
+}
 
-  auto& chain = chains_[step_state_.chain_idx];
-  auto instructions = chain.s_chain_->instructions();
+template <bool kTracing>
+Error Method::execute_instruction(
+    StepState& state,
+    EventTracer* event_tracer,
+    MemoryAllocator* temp_allocator,
+    MemoryAllocator* dynamic_allocator) {
+  // Without tracing, nothing below may reach the EventTracer.
+  if (!kTracing) {
+    event_tracer = nullptr;
+  }
+  auto& chain = chains_[state.chain_idx];
+  auto instructions = chain.instructions_;
 
-  ET_CHECK_OR_RETURN_ERROR(
-      step_state_.instr_idx < instructions->size(),
-      Internal,
+  // Callers only pass states that point at a valid instruction, and init()
+  // validated every jump destination.
+  ET_DCHECK_MSG(
+      state.instr_idx < instructions.size(),
       "Instr index %zu >= chain[%zu] instr count %zu",
-      step_state_.instr_idx,
-      step_state_.chain_idx,
-      (size_t)instructions->size());
+      state.instr_idx,
+      state.chain_idx,
+      instructions.size());
+
+  if (weight_streamer_ != nullptr) {
+    // Load the weights of this instruction, and free those of earlier ones.
+    Error err = weight_streamer_->prepare(state.instr_idx);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
 
-  auto instruction = instructions->Get(step_state_.instr_idx);
-  switch (instruction->instr_args_type()) {
-    case executorch_flatbuffer::InstructionArguments::KernelCall: {
+  const Instruction& instruction = instructions[state.instr_idx];
+  switch (instruction.type) {
+    case Instruction::Type::KernelCall: {
       EXECUTORCH_SCOPE_PROF("OPERATOR_CALL");
-      internal::EventTracerProfileScope event_tracer_scope =
-          internal::EventTracerProfileScope(event_tracer_, "OPERATOR_CALL");
-      // TODO(T147221312): Also expose the temp allocator and tensor resizer
-      // via the context.
-      KernelRuntimeContext context(event_tracer_);
-      auto args = chain.argument_lists_[step_state_.instr_idx];
-      chain.kernels_[step_state_.instr_idx](context, args.data());
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "OPERATOR_CALL");
+      KernelRuntimeContext context(
+          event_tracer, temp_allocator, dynamic_allocator);
+      auto args = instruction.args;
+      instruction.kernel(context, args.data());
+      // Anything the kernel allocated from the temp allocator is dead now.
+      release_temp_memory(temp_allocator);
       Error err = context.failure_state();
       if (err != Error::Ok) {
-        auto op_index = instruction->instr_args_as_KernelCall()->op_index();
-        auto op = serialization_plan_->operators()->Get(op_index);
+        auto op = serialization_plan_->operators()->Get(instruction.index);
         ET_LOG(
             Error,
             "KernelCall failed at instruction %zu:%zu in operator %s.%s: 0x%x",
-            step_state_.chain_idx,
-            step_state_.instr_idx,
+            state.chain_idx,
+            state.instr_idx,
             op->name()->c_str(),
             op->overload()->c_str(),
             (unsigned int)err);
@@ -939,67 +3637,167 @@ Error Method::execute_instruction() {
         // little slow. Do the same for DelegateCall errors.
         return err;
       }
+      run_folded(values_, instruction.folded);
+    } break;
+    case Instruction::Type::ScalarOp: {
+      EXECUTORCH_SCOPE_PROF("OPERATOR_CALL");
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "OPERATOR_CALL");
+      if (!run_scalar_op(instruction.scalar_op, instruction.args)) {
+        KernelRuntimeContext context(
+            event_tracer, temp_allocator, dynamic_allocator);
+        instruction.kernel(context, instruction.args.data());
+        Error err = context.failure_state();
+        if (err != Error::Ok) {
+          ET_LOG(
+              Error,
+              "Scalar op failed at instruction %zu:%zu: 0x%x",
+              state.chain_idx,
+              state.instr_idx,
+              (unsigned int)err);
+          return err;
+        }
+      }
+      run_folded(values_, instruction.folded);
     } break;
-    case executorch_flatbuffer::InstructionArguments::DelegateCall: {
+    case Instruction::Type::DelegateCall: {
       EXECUTORCH_SCOPE_PROF("DELEGATE_CALL");
-      internal::EventTracerProfileScope event_tracer_profile_scope =
-          internal::EventTracerProfileScope(event_tracer_, "DELEGATE_CALL");
-      auto delegate_idx =
-          instruction->instr_args_as_DelegateCall()->delegate_index();
-      ET_CHECK_OR_RETURN_ERROR(
-          delegate_idx < n_delegate_,
-          Internal,
-          "DELEGATE_CALL index %" PRIu32
-          " >= num delegates %zu at instruction %zu",
-          delegate_idx,
-          n_delegate_,
-          step_state_.instr_idx);
-      BackendExecutionContext backend_execution_context(event_tracer_);
-      Error err = delegates_[delegate_idx].Execute(
-          backend_execution_context,
-          chain.argument_lists_[step_state_.instr_idx].data());
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "DELEGATE_CALL");
+      // The delegate index was validated against n_delegate_ by init().
+      // Backends may only complete asynchronously under execute_async().
+      BackendExecutionContext backend_execution_context(
+          event_tracer,
+          BackendCompletion(async_completion_fn_, async_completion_context_));
+      Error err = delegates_[instruction.index].Execute(
+          backend_execution_context, instruction.args);
+      if (err == Error::Pending) {
+        // Leave state pointing at this instruction; run_async_impl() moves
+        // on to the kernels that need not wait for it. Delegates get no temp
+        // memory, so those kernels may use the temp allocator.
+        ET_CHECK_OR_RETURN_ERROR(
+            async_completion_fn_ != nullptr,
+            Internal,
+            "CALL_DELEGATE at instruction %zu returned Pending outside of "
+            "execute_async()",
+            state.instr_idx);
+        return Error::Pending;
+      }
+      release_temp_memory(temp_allocator);
       if (err != Error::Ok) {
         ET_LOG(
             Error,
             "CALL_DELEGATE execute failed at instruction %zu: 0x%" PRIx32,
-            step_state_.instr_idx,
+            state.instr_idx,
             static_cast<uint32_t>(err));
         return err;
       }
+      run_folded(values_, instruction.folded);
     } break;
-    case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
+    case Instruction::Type::JumpFalseCall: {
       EXECUTORCH_SCOPE_PROF("JF_CALL");
-      internal::EventTracerProfileScope event_tracer_profile_scope =
-          internal::EventTracerProfileScope(event_tracer_, "JF_CALL");
-      auto jf_call = instruction->instr_args_as_JumpFalseCall();
-      bool jf_result = parse_cond_value(values_[jf_call->cond_value_index()]);
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "JF_CALL");
+      bool jf_result = parse_cond_value(values_[instruction.index]);
       if (!jf_result) {
-        step_state_.instr_idx = jf_call->destination_instruction();
+        state.instr_idx = instruction.target;
         return Error::Ok;
       }
     } break;
-    case executorch_flatbuffer::InstructionArguments::MoveCall: {
+    case Instruction::Type::MoveCall: {
       EXECUTORCH_SCOPE_PROF("MOVE_CALL");
-      internal::EventTracerProfileScope event_tracer_profile_scope =
-          internal::EventTracerProfileScope(event_tracer_, "MOVE_CALL");
-      auto move_call = instruction->instr_args_as_MoveCall();
-      mutable_value(move_call->move_to()) = get_value(move_call->move_from());
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "MOVE_CALL");
+      values_[instruction.target] = values_[instruction.index];
     } break;
-    case executorch_flatbuffer::InstructionArguments::FreeCall: {
+    case Instruction::Type::FreeCall: {
       EXECUTORCH_SCOPE_PROF("FREE_CALL");
-      internal::EventTracerProfileScope event_tracer_profile_scope =
-          internal::EventTracerProfileScope(event_tracer_, "FREE_CALL");
-      auto free_call = instruction->instr_args_as_FreeCall();
-      auto t = values_[free_call->value_index()].toTensor();
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "FREE_CALL");
+      auto t = values_[instruction.index].toTensor();
       internal::reset_data_ptr(t);
     } break;
+    case Instruction::Type::MapBegin: {
+      EXECUTORCH_SCOPE_PROF("MAP_BEGIN");
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "MAP_BEGIN");
+      Result<bool> has_next_row = begin_map_iteration(instruction.args);
+      if (!has_next_row.ok()) {
+        ET_LOG(
+            Error,
+            "MAP_BEGIN failed at instruction %zu:%zu: 0x%" PRIx32,
+            state.chain_idx,
+            state.instr_idx,
+            static_cast<uint32_t>(has_next_row.error()));
+        return has_next_row.error();
+      }
+      if (!has_next_row.get()) {
+        state.instr_idx = instruction.target;
+        return Error::Ok;
+      }
+    } break;
+    case Instruction::Type::MapEnd: {
+      EXECUTORCH_SCOPE_PROF("MAP_END");
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "MAP_END");
+      EValue& iter = values_[instruction.index];
+      iter = EValue(iter.toInt() + 1);
+      state.instr_idx = instruction.target;
+      return Error::Ok;
+    }
+    case Instruction::Type::WhileBegin: {
+      EXECUTORCH_SCOPE_PROF("WHILE_BEGIN");
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "WHILE_BEGIN");
+      Error err = begin_while_iteration(instruction.args, instruction.index);
+      if (err != Error::Ok) {
+        ET_LOG(
+            Error,
+            "WHILE_BEGIN failed at instruction %zu:%zu: 0x%" PRIx32,
+            state.chain_idx,
+            state.instr_idx,
+            static_cast<uint32_t>(err));
+        return err;
+      }
+    } break;
+    case Instruction::Type::WhileEnd: {
+      EXECUTORCH_SCOPE_PROF("WHILE_END");
+      ProfileScope<kTracing> event_tracer_scope(event_tracer, "WHILE_END");
+      const Instruction& begin = instructions[instruction.target];
+      Error err = end_while(begin.args, begin.index);
+      if (err != Error::Ok) {
+        ET_LOG(
+            Error,
+            "WHILE_END failed at instruction %zu:%zu: 0x%" PRIx32,
+            state.chain_idx,
+            state.instr_idx,
+            static_cast<uint32_t>(err));
+        return err;
+      }
+    } break;
     default:
       ET_CHECK_MSG(
           false,
           "Instruction is not supported. %hhu",
-          static_cast<uint8_t>(instruction->instr_args_type()));
+          static_cast<uint8_t>(instruction.type));
   }
-  step_state_.instr_idx += 1;
+  // Logged outside of the OPERATOR_CALL scope so that it doesn't add to the
+  // operator's time, and after the kernel so that outputs have their final
+  // sizes.
+  if (kTracing && instruction.type == Instruction::Type::KernelCall &&
+      internal::event_tracer_memory_tracing_enabled(event_tracer)) {
+    log_kernel_memory(
+        event_tracer,
+        serialization_plan_,
+        values_,
+        instruction.args,
+        state.chain_idx,
+        state.instr_idx);
+  }
+  if (kTracing && instruction.type == Instruction::Type::KernelCall &&
+      internal::event_tracer_intermediate_output_logging_enabled(
+          event_tracer)) {
+    log_kernel_outputs(
+        event_tracer,
+        serialization_plan_,
+        values_,
+        instruction.args,
+        state.chain_idx,
+        state.instr_idx);
+  }
+  state.instr_idx += 1;
   return Error::Ok;
 }
 
@@ -1013,29 +3811,33 @@ Error Method::experimental_reset_execution() {
 }
 
 Error Method::experimental_step() {
+  EventTracer* event_tracer = active_event_tracer();
   EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
       static_cast<int32_t>(step_state_.chain_idx),
       static_cast<uint32_t>(step_state_.instr_idx));
   internal::EventTracerProfileInstructionScope event_tracer_instr_scope =
       internal::EventTracerProfileInstructionScope(
-          event_tracer_,
+          event_tracer,
           static_cast<int32_t>(step_state_.chain_idx),
           static_cast<uint32_t>(step_state_.instr_idx));
   EXECUTORCH_SCOPE_PROF("Method::step");
   internal::EventTracerProfileScope event_tracer_profile_scope =
-      internal::EventTracerProfileScope(event_tracer_, "Method::step");
+      internal::EventTracerProfileScope(event_tracer, "Method::step");
   ET_CHECK_OR_RETURN_ERROR(
       initialized(),
       InvalidState,
       "Cannot execute until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      !async_pending_,
+      InvalidState,
+      "Cannot step while an asynchronous execution is pending.");
 
   // If chain_step_ is on n_chains_, then we have no instructions run.
   if (step_state_.chain_idx == n_chains_) {
     return Error::EndOfMethod;
   }
 
-  auto num_instructions =
-      chains_[step_state_.chain_idx].s_chain_->instructions()->size();
+  auto num_instructions = chains_[step_state_.chain_idx].instructions_.size();
 
   // Special case chains with no instructions. These appear for example in a
   // model that just returns the input/a constant.
@@ -1044,7 +3846,12 @@ Error Method::experimental_step() {
     return Error::Ok;
   }
 
-  auto status = execute_instruction();
+  MemoryAllocator* temp_allocator = memory_manager_->temp_allocator();
+  auto status = event_tracer != nullptr
+      ? execute_instruction<true>(
+            step_state_, event_tracer, temp_allocator, dynamic_allocator_)
+      : execute_instruction<false>(
+            step_state_, nullptr, temp_allocator, dynamic_allocator_);
   if (status != Error::Ok) {
     return status;
   }
@@ -1058,47 +3865,378 @@ Error Method::experimental_step() {
 }
 
 Error Method::execute() {
-  internal::event_tracer_create_event_block(event_tracer_, "Execute");
+  EventTracer* event_tracer = active_event_tracer();
+  internal::event_tracer_create_event_block(event_tracer, "Execute");
   internal::EventTracerProfileScope event_tracer_profile_scope =
-      internal::EventTracerProfileScope(event_tracer_, "Method::execute");
+      internal::EventTracerProfileScope(event_tracer, "Method::execute");
   EXECUTORCH_SCOPE_PROF("Method::execute");
   ET_CHECK_OR_RETURN_ERROR(
       initialized(),
       NotSupported,
       "Cannot execute until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      !async_pending_,
+      InvalidState,
+      "Cannot execute while an asynchronous execution is pending.");
 
-  // Chains are executed sequentially today, but future async designs may
-  // branch and run many in parallel or out of order.
-  for (step_state_.chain_idx = 0; step_state_.chain_idx < n_chains_;
-       ++step_state_.chain_idx) {
-    Chain& chain = chains_[step_state_.chain_idx];
-    auto instructions = chain.s_chain_->instructions();
-    ET_CHECK_OR_RETURN_ERROR(
-        instructions != nullptr,
-        Internal,
-        "chain %zu has no instructions field",
-        step_state_.chain_idx);
+  // Start from an empty temp allocator, whatever the caller did with it
+  // between executions.
+  MemoryAllocator* temp_allocator = memory_manager_->temp_allocator();
+  if (temp_allocator != nullptr) {
+    temp_allocator->reset();
+  }
 
-    // Loop over instructions
-    step_state_.instr_idx = 0;
-    while (step_state_.instr_idx < chain.s_chain_->instructions()->size()) {
-      EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
-          static_cast<int32_t>(step_state_.chain_idx),
-          static_cast<uint32_t>(step_state_.instr_idx));
-      internal::EventTracerProfileInstructionScope event_tracer_instr_scope =
-          internal::EventTracerProfileInstructionScope(
-              event_tracer_,
-              static_cast<ChainID>(step_state_.chain_idx),
-              static_cast<DebugHandle>(step_state_.instr_idx));
-      auto status = execute_instruction();
-      if (status != Error::Ok) {
-        return status;
+  if (chain_executor_ != nullptr && chain_wave_order_ != nullptr) {
+    Error err = execute_chains_concurrently();
+    if (err != Error::Ok) {
+      return err;
+    }
+    step_state_ = StepState{0, 0};
+    return Error::Ok;
+  }
+
+  // Without a ChainExecutor, chains are executed sequentially in program
+  // order. Everything about the instructions was validated by init(), so the
+  // only thing left to check here is whether each instruction succeeded.
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    Error err = execute_chain(chain_idx, /*concurrent=*/false);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  // Leave the Method ready for the next call, without going through
+  // experimental_reset_execution().
+  step_state_ = StepState{0, 0};
+  return Error::Ok;
+}
+
+Error Method::execute_async(
+    AsyncCompletionFn on_delegate_complete,
+    void* context) {
+  EventTracer* event_tracer = active_event_tracer();
+  internal::event_tracer_create_event_block(event_tracer, "Execute");
+  internal::EventTracerProfileScope event_tracer_profile_scope =
+      internal::EventTracerProfileScope(event_tracer, "Method::execute_async");
+  EXECUTORCH_SCOPE_PROF("Method::execute_async");
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      NotSupported,
+      "Cannot execute until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      !async_pending_,
+      InvalidState,
+      "Cannot execute while an asynchronous execution is pending.");
+  ET_CHECK_OR_RETURN_ERROR(
+      on_delegate_complete != nullptr,
+      InvalidArgument,
+      "on_delegate_complete must not be null");
+
+  async_completion_fn_ = on_delegate_complete;
+  async_completion_context_ = context;
+  step_state_ = StepState{0, 0};
+  return run_async();
+}
+
+Error Method::resume_async(Error delegate_status) {
+  internal::EventTracerProfileScope event_tracer_profile_scope =
+      internal::EventTracerProfileScope(
+          active_event_tracer(), "Method::resume_async");
+  EXECUTORCH_SCOPE_PROF("Method::resume_async");
+  ET_CHECK_OR_RETURN_ERROR(
+      async_pending_,
+      InvalidState,
+      "No asynchronous execution is pending.");
+  async_pending_ = false;
+  const Error run_ahead_error = run_ahead_error_;
+  run_ahead_error_ = Error::Ok;
+
+  if (delegate_status != Error::Ok || run_ahead_error != Error::Ok) {
+    if (delegate_status != Error::Ok) {
+      ET_LOG(
+          Error,
+          "CALL_DELEGATE execute failed asynchronously at instruction "
+          "%zu:%zu: 0x%" PRIx32,
+          step_state_.chain_idx,
+          pending_instr_idx_,
+          static_cast<uint32_t>(delegate_status));
+    }
+    async_completion_fn_ = nullptr;
+    async_completion_context_ = nullptr;
+    step_state_ = StepState{0, 0};
+    return delegate_status != Error::Ok ? delegate_status : run_ahead_error;
+  }
+
+  // Finish the delegate call that just completed. step_state_ already points
+  // past it and the kernels that ran ahead of it.
+  run_folded(
+      values_,
+      chains_[step_state_.chain_idx].instructions_[pending_instr_idx_].folded);
+  return run_async();
+}
+
+Error Method::run_async() {
+  // The tracer can't change while an execution is pending, so re-checking it
+  // on every resume is consistent.
+  EventTracer* event_tracer = active_event_tracer();
+  return event_tracer != nullptr ? run_async_impl<true>(event_tracer)
+                                 : run_async_impl<false>(nullptr);
+}
+
+namespace {
+
+/// Returns the bytes of storage at the data of `tensor`, which bounds what an
+/// instruction can read or write through it, even if it resizes the tensor.
+size_t storage_extent(const exec_aten::Tensor& tensor) {
+#ifdef USE_ATEN_LIB
+  return tensor.nbytes();
+#else
+  return internal::tensor_impl_capacity(tensor.unsafeGetTensorImpl());
+#endif
+}
+
+/// Returns true if the storage of two tensors overlaps.
+bool storage_overlaps(const exec_aten::Tensor& a, const exec_aten::Tensor& b) {
+  const uint8_t* a_begin = static_cast<const uint8_t*>(a.const_data_ptr());
+  const uint8_t* b_begin = static_cast<const uint8_t*>(b.const_data_ptr());
+  if (a_begin == nullptr || b_begin == nullptr) {
+    return false;
+  }
+  return a_begin < b_begin + storage_extent(b) &&
+      b_begin < a_begin + storage_extent(a);
+}
+
+/**
+ * Returns true if instructions with arguments `a` and `b` may run in either
+ * order: they share no values, and no tensor storage that the memory plan
+ * may reuse between them. Lists are assumed to conflict.
+ */
+bool args_independent(InstructionArgs a, InstructionArgs b) {
+  for (const EValue* x : a) {
+    if (x->isTensorList() || x->isListOptionalTensor()) {
+      return false;
+    }
+    for (const EValue* y : b) {
+      if (x == y) {
+        return false;
       }
+      if (y->isTensorList() || y->isListOptionalTensor()) {
+        return false;
+      }
+      if (x->isTensor() && y->isTensor() &&
+          storage_overlaps(x->toTensor(), y->toTensor())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+template <bool kTracing>
+void Method::run_ahead_of_delegate(
+    EventTracer* event_tracer,
+    MemoryAllocator* temp_allocator) {
+  auto instructions = chains_[step_state_.chain_idx].instructions_;
+  const Instruction& pending = instructions[pending_instr_idx_];
+  // Moves and frees folded into the delegate call only run once it completes,
+  // and the weight streamer frees weights by instruction order.
+  if (pending.folded.size() > 0 || weight_streamer_ != nullptr) {
+    return;
+  }
+  while (step_state_.instr_idx < instructions.size()) {
+    const Instruction& instruction = instructions[step_state_.instr_idx];
+    if ((instruction.type != Instruction::Type::KernelCall &&
+         instruction.type != Instruction::Type::ScalarOp) ||
+        !args_independent(pending.args, instruction.args)) {
+      return;
+    }
+    EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
+        static_cast<int32_t>(step_state_.chain_idx), instruction.source_index);
+    ProfileInstructionScope<kTracing> event_tracer_instr_scope(
+        event_tracer,
+        static_cast<ChainID>(step_state_.chain_idx),
+        static_cast<DebugHandle>(instruction.source_index));
+    Error err = execute_instruction<kTracing>(
+        step_state_, event_tracer, temp_allocator, dynamic_allocator_);
+    if (err != Error::Ok) {
+      // Reported by resume_async(), once the delegate is done with its
+      // arguments.
+      run_ahead_error_ = err;
+      return;
+    }
+  }
+}
+
+template <bool kTracing>
+Error Method::run_async_impl(EventTracer* event_tracer) {
+  MemoryAllocator* temp_allocator = memory_manager_->temp_allocator();
+  Error status = Error::Ok;
+  while (step_state_.chain_idx < n_chains_) {
+    if (step_state_.instr_idx ==
+        chains_[step_state_.chain_idx].instructions_.size()) {
+      step_state_.chain_idx += 1;
+      step_state_.instr_idx = 0;
+      continue;
+    }
+    // Report the serialized index, which differs from instr_idx once
+    // bookkeeping instructions have been folded.
+    const uint32_t source_index = chains_[step_state_.chain_idx]
+                                      .instructions_[step_state_.instr_idx]
+                                      .source_index;
+    EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
+        static_cast<int32_t>(step_state_.chain_idx), source_index);
+    ProfileInstructionScope<kTracing> event_tracer_instr_scope(
+        event_tracer,
+        static_cast<ChainID>(step_state_.chain_idx),
+        static_cast<DebugHandle>(source_index));
+    status = execute_instruction<kTracing>(
+        step_state_, event_tracer, temp_allocator, dynamic_allocator_);
+    if (status == Error::Pending) {
+      async_pending_ = true;
+      pending_instr_idx_ = step_state_.instr_idx;
+      step_state_.instr_idx += 1;
+      run_ahead_of_delegate<kTracing>(event_tracer, temp_allocator);
+      return status;
+    }
+    if (status != Error::Ok) {
+      break;
+    }
+  }
+  // Finished or failed; either way the next execution starts from the top.
+  async_completion_fn_ = nullptr;
+  async_completion_context_ = nullptr;
+  step_state_ = StepState{0, 0};
+  return status;
+}
+
+Error Method::execute_chain(size_t chain_idx, bool concurrent) {
+  // Neither the EventTracer nor the allocators are thread-safe, so chains
+  // that may run alongside others don't get them.
+  EventTracer* event_tracer = concurrent ? nullptr : active_event_tracer();
+  MemoryAllocator* temp_allocator =
+      concurrent ? nullptr : memory_manager_->temp_allocator();
+  MemoryAllocator* dynamic_allocator = concurrent ? nullptr : dynamic_allocator_;
+  return event_tracer != nullptr
+      ? execute_chain_instructions<true>(
+            chain_idx, event_tracer, temp_allocator, dynamic_allocator)
+      : execute_chain_instructions<false>(
+            chain_idx, nullptr, temp_allocator, dynamic_allocator);
+}
+
+template <bool kTracing>
+Error Method::execute_chain_instructions(
+    size_t chain_idx,
+    EventTracer* event_tracer,
+    MemoryAllocator* temp_allocator,
+    MemoryAllocator* dynamic_allocator) {
+  StepState state{chain_idx, 0};
+  const size_t num_instructions = chains_[chain_idx].instructions_.size();
+  while (state.instr_idx < num_instructions) {
+    const uint32_t source_index =
+        chains_[chain_idx].instructions_[state.instr_idx].source_index;
+    EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
+        static_cast<int32_t>(state.chain_idx), source_index);
+    ProfileInstructionScope<kTracing> event_tracer_instr_scope(
+        event_tracer,
+        static_cast<ChainID>(state.chain_idx),
+        static_cast<DebugHandle>(source_index));
+    Error status = execute_instruction<kTracing>(
+        state, event_tracer, temp_allocator, dynamic_allocator);
+    if (status != Error::Ok) {
+      return status;
     }
   }
-  // TODO(jakeszwe, dbort): Decide on calling execute back to back without
-  // going through the reset api first.
-  return experimental_reset_execution();
+  return Error::Ok;
+}
+
+Error Method::execute_chains_concurrently() {
+  struct WaveContext {
+    Method* method;
+    const uint32_t* chains;
+  };
+
+  for (size_t wave = 0; wave < n_chain_waves_; ++wave) {
+    uint32_t begin = chain_wave_offsets_[wave];
+    const uint32_t end = chain_wave_offsets_[wave + 1];
+    // Chains that may grow unbounded tensors need the dynamic allocator, so
+    // they run inline before the others of their wave. So does a chain with
+    // nothing to overlap with, which then gets full tracing support.
+    uint32_t serial_end = begin + chain_wave_serial_[wave];
+    if (end - serial_end == 1) {
+      serial_end = end;
+    }
+    for (; begin < serial_end; ++begin) {
+      Error err = execute_chain(chain_wave_order_[begin], /*concurrent=*/false);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+    if (begin == end) {
+      continue;
+    }
+
+    WaveContext context{this, &chain_wave_order_[begin]};
+    chain_executor_->run(
+        [](void* ctx, size_t task_index) {
+          auto* wave_context = static_cast<WaveContext*>(ctx);
+          const uint32_t chain_idx = wave_context->chains[task_index];
+          wave_context->method->chain_errors_[chain_idx] =
+              wave_context->method->execute_chain(
+                  chain_idx, /*concurrent=*/true);
+        },
+        &context,
+        end - begin);
+
+    // Report the first failure in program order so that the result is
+    // deterministic regardless of how the executor scheduled the chains.
+    for (uint32_t i = begin; i < end; ++i) {
+      const uint32_t chain_idx = chain_wave_order_[i];
+      if (chain_errors_[chain_idx] != Error::Ok) {
+        ET_LOG(
+            Error,
+            "Chain %" PRIu32 " failed: 0x%" PRIx32,
+            chain_idx,
+            static_cast<uint32_t>(chain_errors_[chain_idx]));
+        return chain_errors_[chain_idx];
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+MethodMemoryStats Method::memory_stats() const {
+  MethodMemoryStats stats = {};
+  stats.method_allocator_bytes = method_allocator_bytes_;
+  stats.delegate_allocator_bytes = delegate_allocator_bytes_;
+  const MethodMeta meta = method_meta();
+  for (size_t i = 0; i < meta.num_memory_planned_buffers(); ++i) {
+    Result<int64_t> size = meta.memory_planned_buffer_size(i);
+    if (size.ok()) {
+      stats.planned_bytes += static_cast<size_t>(size.get());
+    }
+  }
+  stats.temp_allocator_high_watermark = temp_allocator_high_watermark_;
+  for (size_t i = 0; i < n_constant_buffer_; ++i) {
+    if (!constant_buffers_[i].borrowed) {
+      stats.constant_bytes += constant_buffers_[i].data.size();
+    }
+  }
+  if (weight_streamer_ != nullptr) {
+    stats.constant_bytes += weight_streamer_->resident_bytes();
+  }
+  for (size_t i = 0; i < n_delegate_; ++i) {
+    if (!delegates_[i].IsInitialized()) {
+      continue;
+    }
+    Result<size_t> usage = delegates_[i].GetMemoryUsage();
+    if (usage.ok()) {
+      stats.delegate_heap_bytes += usage.get();
+    } else {
+      ++stats.num_unreported_delegates;
+    }
+  }
+  return stats;
 }
 
 MethodMeta Method::method_meta() const {
@@ -1170,6 +4308,16 @@ Method::~Method() {
       delegates_[i].~BackendDelegate();
     }
   }
+  // Free the constants loaded from the constant segment, now that no values
+  // point into them.
+  if (constant_buffers_ != nullptr) {
+    for (int i = 0; i < n_constant_buffer_; i++) {
+      constant_buffers_[i].~ConstantBuffer();
+    }
+  }
+  if (weight_streamer_ != nullptr) {
+    weight_streamer_->~WeightStreamer();
+  }
   // All other fields are trivially destructible.
 }
 } // namespace executor
@@ -11,6 +11,9 @@
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/executor/chain_executor.h>
+#include <executorch/runtime/executor/delegate_selector.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method_meta.h>
 #include <executorch/runtime/platform/compiler.h>
@@ -37,11 +40,78 @@ class FunctionRef;
 template <typename T>
 class Span;
 class KernelRuntimeContext;
+namespace internal {
+class OperatorCache;
+class WeightStreamer;
+} // namespace internal
 using OpFunction = FunctionRef<void(KernelRuntimeContext&, EValue**)>;
 /// A list of pointers into the master values table that together compose the
 /// argument list for a single instruction
 using InstructionArgs = Span<EValue*>;
 
+/**
+ * The memory that a loaded Method holds. See Method::memory_stats().
+ */
+struct MethodMemoryStats {
+  /// Bytes that loading the Method took from the MemoryManager's method
+  /// allocator, including delegate_allocator_bytes.
+  size_t method_allocator_bytes;
+  /// Bytes that the delegates took from the method allocator while they were
+  /// loaded and initialized.
+  size_t delegate_allocator_bytes;
+  /// Total size of the memory-planned buffers that the Method expects, per
+  /// MethodMeta::memory_planned_buffer_size().
+  size_t planned_bytes;
+  /// See Method::temp_allocator_high_watermark().
+  size_t temp_allocator_high_watermark;
+  /// Bytes of constant data that the Method loaded from the program's
+  /// constant segment. Constants borrowed from another Method, and constants
+  /// that live in the program's own data, are not counted. Streamed weights
+  /// (see WeightStreamingConfig) count while they are loaded.
+  size_t constant_bytes;
+  /// Bytes that the delegates hold outside of the runtime's allocators, as
+  /// reported by PyTorchBackendInterface::get_memory_usage().
+  size_t delegate_heap_bytes;
+  /// Number of initialized delegates whose backends do not report their
+  /// memory, and are missing from delegate_heap_bytes.
+  size_t num_unreported_delegates;
+};
+
+/**
+ * Loads the constant weights of a Method on demand while it executes, instead
+ * of all of them when it is loaded, for models whose weights don't fit in
+ * memory at once. Each weight is loaded from the program's constant segment
+ * just before the first instruction that uses it and freed after the last
+ * one, while the DataLoader is asked to prefetch the weights of the next
+ * instructions. See Program::load_method().
+ *
+ * Only supported for methods with a single chain and no control flow, whose
+ * program keeps its constants in a segment. Weights that are method inputs or
+ * outputs, or that Move or Free instructions refer to, are loaded as usual.
+ */
+struct WeightStreamingConfig {
+  /// Number of weights, in order of first use, that the DataLoader is asked
+  /// to prefetch ahead of the instruction that is about to run.
+  size_t prefetch_buffers = 2;
+};
+
+/**
+ * What Method::warmup() does to move the cost of a first execution to an
+ * earlier point, e.g. app start.
+ */
+struct WarmupConfig {
+  /// Read every page of the method's constant data, so that constants mapped
+  /// from the program file are paged in.
+  bool touch_constants = true;
+  /// Let every delegate do its lazy initialization; see
+  /// PyTorchBackendInterface::prepare().
+  bool prepare_delegates = true;
+  /// Number of executions to run on synthetic inputs, to warm up caches and
+  /// anything that delegates only set up when they execute. Memory-planned
+  /// tensor inputs are zero-filled for them.
+  size_t num_executions = 0;
+};
+
 /**
  * An executable method of an executorch program. Maps to a python method like
  * `forward()` on the original nn.Module.
@@ -58,12 +128,37 @@ class Method final {
         memory_manager_(rhs.memory_manager_),
         serialization_plan_(rhs.serialization_plan_),
         event_tracer_(rhs.event_tracer_),
+        event_tracer_enabled_(rhs.event_tracer_enabled_),
         n_value_(rhs.n_value_),
         values_(rhs.values_),
         n_delegate_(rhs.n_delegate_),
         delegates_(rhs.delegates_),
+        n_constant_buffer_(rhs.n_constant_buffer_),
+        constant_buffers_(rhs.constant_buffers_),
+        constant_source_(rhs.constant_source_),
+        delegate_selector_(rhs.delegate_selector_),
+        weight_streaming_(rhs.weight_streaming_),
+        weight_streamer_(rhs.weight_streamer_),
+        init_bytes_loaded_(rhs.init_bytes_loaded_),
+        method_allocator_bytes_(rhs.method_allocator_bytes_),
+        delegate_allocator_bytes_(rhs.delegate_allocator_bytes_),
         n_chains_(rhs.n_chains_),
         chains_(rhs.chains_),
+        chain_executor_(rhs.chain_executor_),
+        dynamic_allocator_(rhs.dynamic_allocator_),
+        temp_allocator_high_watermark_(rhs.temp_allocator_high_watermark_),
+        n_chain_waves_(rhs.n_chain_waves_),
+        chain_wave_order_(rhs.chain_wave_order_),
+        chain_wave_offsets_(rhs.chain_wave_offsets_),
+        chain_wave_serial_(rhs.chain_wave_serial_),
+        chain_errors_(rhs.chain_errors_),
+        async_completion_fn_(rhs.async_completion_fn_),
+        async_completion_context_(rhs.async_completion_context_),
+        async_pending_(rhs.async_pending_),
+        pending_instr_idx_(rhs.pending_instr_idx_),
+        run_ahead_error_(rhs.run_ahead_error_),
+        io_buffer_sets_(rhs.io_buffer_sets_),
+        constants_(rhs.constants_),
         init_state_(rhs.init_state_),
         pre_allocated_input_(rhs.pre_allocated_input_),
         pre_allocated_output_(rhs.pre_allocated_output_) {
@@ -73,6 +168,9 @@ class Method final {
     rhs.values_ = nullptr;
     rhs.n_delegate_ = 0;
     rhs.delegates_ = nullptr;
+    rhs.n_constant_buffer_ = 0;
+    rhs.constant_buffers_ = nullptr;
+    rhs.weight_streamer_ = nullptr;
 
     // Helpful: Try to ensure that any other interactions with the old object
     // result in failures.
@@ -82,8 +180,25 @@ class Method final {
     rhs.memory_manager_ = nullptr;
     rhs.serialization_plan_ = nullptr;
     rhs.event_tracer_ = nullptr;
+    rhs.constant_source_ = nullptr;
+    rhs.delegate_selector_ = nullptr;
+    rhs.weight_streaming_ = nullptr;
     rhs.n_chains_ = 0;
     rhs.chains_ = nullptr;
+    rhs.chain_executor_ = nullptr;
+    rhs.dynamic_allocator_ = nullptr;
+    rhs.n_chain_waves_ = 0;
+    rhs.chain_wave_order_ = nullptr;
+    rhs.chain_wave_offsets_ = nullptr;
+    rhs.chain_wave_serial_ = nullptr;
+    rhs.async_completion_fn_ = nullptr;
+    rhs.async_completion_context_ = nullptr;
+    rhs.async_pending_ = false;
+    rhs.pending_instr_idx_ = 0;
+    rhs.run_ahead_error_ = Error::Ok;
+    rhs.io_buffer_sets_ = {};
+    rhs.constants_ = {};
+    rhs.chain_errors_ = nullptr;
     rhs.pre_allocated_input_ = false;
     rhs.pre_allocated_output_ = false;
   }
@@ -145,6 +260,173 @@ class Method final {
   __ET_NODISCARD Error
   set_output_data_ptr(void* buffer, size_t size, size_t output_idx);
 
+  /// A caller-owned data buffer for one tensor input or output.
+  struct IOBuffer {
+    void* data;
+    /// Size of `data` in bytes.
+    size_t size;
+  };
+
+  /**
+   * One set of data buffers for the inputs and outputs of the method. Entry
+   * `i` of `inputs` backs input `i` and entry `i` of `outputs` backs output
+   * `i`; entries for non-tensor values must be `{nullptr, 0}`.
+   */
+  struct IOBufferSet {
+    exec_aten::ArrayRef<IOBuffer> inputs;
+    exec_aten::ArrayRef<IOBuffer> outputs;
+  };
+
+  /**
+   * Registers rotating sets of input and output buffers, so that a producer
+   * can fill one set while the method executes out of another and switch
+   * between them with select_io_buffer_set() without copying.
+   *
+   * Every set is validated here: its lists must have `inputs_size()` and
+   * `outputs_size()` entries, and each tensor buffer must be at least as large
+   * as the tensor it backs. As with set_output_data_ptr(), the tensors must not
+   * have buffers allocated by the memory plan. Does not change the bindings of
+   * any tensor.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @param[in] buffer_sets The sets to rotate between. The list and the
+   *     buffers must outlive the Method, or the next call to this method. An
+   *     empty list unregisters all sets.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  __ET_NODISCARD Error
+  set_io_buffer_sets(exec_aten::ArrayRef<IOBufferSet> buffer_sets);
+
+  /**
+   * Points every tensor input and output at the buffers of one of the sets
+   * registered with set_io_buffer_sets(). Must not be called while the
+   * method is executing.
+   *
+   * @param[in] index The set to use.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  __ET_NODISCARD Error select_io_buffer_set(size_t index);
+
+  /// Replacement data for a named constant. See set_constants().
+  struct ConstantData {
+    /// The fully qualified name of the nn.Module parameter or buffer, e.g.
+    /// "layers.0.attention.wq.weight".
+    const char* name;
+    /// The new data, laid out like the constant tensor.
+    const void* data;
+    /// The size of `data` in bytes.
+    size_t nbytes;
+  };
+
+  /**
+   * Points constants of the method at caller-owned data by name, e.g. to swap
+   * in the weights of a fine-tuned adapter while the program and the
+   * constants of the base model stay loaded. Constants that a previous call
+   * replaced and that are not in `constants` go back to their own data, so an
+   * empty list restores the method's original weights.
+   *
+   * A constant tensor of the method is repointed without copying, and its
+   * data must have the tensor's exact size. Delegates that take it as an
+   * argument rebind it on their next call. Names that are not constants of
+   * the method are offered to its delegates, and only the delegates that
+   * hold such a constant repack it; see
+   * PyTorchBackendInterface::update_constant(). Must not be called while the
+   * method is executing.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @param[in] constants The constants to replace. The list and the data must
+   *     outlive the Method, or the next call to this method.
+   *
+   * Every constant is checked before any is replaced, so the errors below
+   * leave the previous set in place.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::NotFound if neither the method nor any of its delegates
+   *     has a constant of one of the names.
+   * @retval Error::InvalidArgument if one of the names is mutable state of
+   *     the method, or if the data of a constant has the wrong size.
+   * @retval Error::NotSupported if a constant is streamed; see
+   *     WeightStreamingConfig.
+   * @returns Other errors from delegates. A delegate that fails while it
+   *     repacks a constant may leave some constants replaced; calling this
+   *     method again with an empty list restores all of them.
+   */
+  __ET_NODISCARD Error
+  set_constants(exec_aten::ArrayRef<ConstantData> constants);
+
+  /**
+   * Returns the number of bytes that the method's mutable state, e.g. a KV
+   * cache or the context of a streaming encoder, spans in its memory-planned
+   * buffer. This is the size of the buffers that set_state_buffer() takes.
+   * Exporting with MemoryPlanningPass(mutable_buffer_mem_id=...) plans the
+   * state in a buffer of its own, which keeps this size to the state alone.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @retval Error::NotFound if the method has no mutable state.
+   * @retval Error::NotSupported if the state is spread over several
+   *     memory-planned buffers.
+   */
+  __ET_NODISCARD Result<size_t> state_size() const;
+
+  /**
+   * Points the method's mutable state at caller-owned memory, so that one
+   * loaded method can keep the state of many independent streams, e.g. audio
+   * streams, and switch between them without copying. Every tensor planned
+   * within the state's span moves to the same relative offset in `data`;
+   * the memory keeps whatever state it held, so call reset_state() to start a
+   * new stream in it. Must not be called while the method is executing.
+   *
+   * Methods that share planned buffers, and with them the state, must each be
+   * pointed at the same memory.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @param[in] data The memory to keep the state in, of at least
+   *     state_size() bytes and aligned like the memory-planned buffers. It
+   *     must outlive the Method, or the next call to this method. nullptr
+   *     goes back to the memory-planned buffer.
+   * @param[in] size The size of `data` in bytes.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  __ET_NODISCARD Error set_state_buffer(void* data, size_t size);
+
+  /**
+   * Overwrites the method's mutable state, wherever set_state_buffer() put
+   * it, with its initial values from the program, as when the method was
+   * loaded. Must not be called while the method is executing.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  __ET_NODISCARD Error reset_state();
+
+  /**
+   * Does ahead of time what would otherwise slow down the first executions
+   * of the method: page faults on constants mapped from the program file,
+   * lazy allocations and compilation in delegates, and cold caches. See
+   * WarmupConfig.
+   *
+   * Executions on synthetic inputs overwrite the method's memory-planned
+   * inputs and its outputs, so set the inputs after warming up. The mutable
+   * state, if any, is reset to its initial values after them. The executions
+   * are not traced.
+   *
+   * @param[in] config What to do.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if `config.num_executions` is not zero and a
+   *     tensor input has no memory-planned buffer and was not set.
+   * @returns Other errors from delegates or from the executions.
+   */
+  __ET_NODISCARD Error warmup(const WarmupConfig& config = WarmupConfig());
+
   /**
    * Copies the method's outputs into the provided array.
    *
@@ -167,13 +449,161 @@ class Method final {
   /**
    * Execute the method.
    *
-   * NOTE: Will fail if the method has been partially executed using the
-   * `experimental_step()` api.
+   * All instructions are validated once by the load that created this Method,
+   * so repeated calls only run the instructions and check whether each of them
+   * succeeded. The Method is ready to execute again as soon as this returns.
+   *
+   * NOTE: Restarts execution from the first instruction if the method has been
+   * partially executed using the `experimental_step()` api.
    *
    * @returns Error::Ok on success, non-Ok on failure.
    */
   __ET_NODISCARD Error execute();
 
+  /// Receives the result of a delegate call that returned `Error::Pending`
+  /// during execute_async().
+  using AsyncCompletionFn = void (*)(void* context, Error status);
+
+  /**
+   * Starts executing the method from its first instruction, allowing delegates
+   * whose backends support it to run asynchronously.
+   *
+   * Instructions run on the calling thread until a delegate returns
+   * `Error::Pending`. The kernels that follow it in the same chain keep
+   * running while the delegate works, as long as they share no values and no
+   * tensor memory with the delegate call, e.g. CPU ops of a branch that does
+   * not consume a GPU partition's outputs. At the first instruction that
+   * does, this call returns `Error::Pending`, leaving the Method suspended
+   * until the delegate call completes. When the backend finishes it calls
+   * `on_delegate_complete(context, status)`, possibly from another thread and
+   * possibly before this call has returned. Once both have happened, the
+   * client must call resume_async() with that status, on any one thread, to
+   * continue the method. Between those points the calling thread is free to
+   * do other work, such as preparing the inputs of another Method.
+   *
+   * Chains always run sequentially in this mode, even if a ChainExecutor is
+   * set.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @param[in] on_delegate_complete Called once for each pending delegate
+   *     call. Must not call back into this Method.
+   * @param[in] context Passed through to `on_delegate_complete`.
+   *
+   * @retval Error::Ok The method ran to the end without suspending.
+   * @retval Error::Pending A delegate is still running; call resume_async()
+   *     after `on_delegate_complete` has been called.
+   * @retval Error::InvalidState A previous execution is still pending.
+   * @returns Other errors if an instruction failed. The next execution starts
+   *     again from the first instruction.
+   */
+  __ET_NODISCARD Error
+  execute_async(AsyncCompletionFn on_delegate_complete, void* context);
+
+  /**
+   * Continues an execution suspended by execute_async() or a previous
+   * resume_async() call.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @param[in] delegate_status The status passed to `on_delegate_complete`.
+   *
+   * @returns The same values as execute_async(). If `delegate_status` is not
+   *     Error::Ok, it is returned and the execution is abandoned.
+   */
+  __ET_NODISCARD Error resume_async(Error delegate_status);
+
+  /**
+   * Sets the ChainExecutor that execute() will use to run independent chains of
+   * this Method concurrently.
+   *
+   * At load time the Method uses the `inputs` and `outputs` lists of its
+   * chains to group them into waves of chains that do not read or write each
+   * other's values. When an executor is set, execute() dispatches each wave
+   * with more than one chain onto it; otherwise chains run sequentially in
+   * program order, which is also the behavior for Methods with a single chain.
+   *
+   * Concurrently-running chains do not receive the EventTracer or the temp
+   * allocator, since neither is thread-safe. Chains whose kernels take
+   * DYNAMIC_UNBOUND tensors need the dynamic allocator to grow them, so they
+   * run on the calling thread before the rest of their wave. The memory plan
+   * of the program must not place values of chains in the same wave in
+   * overlapping memory.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @param[in] chain_executor The executor to use, or nullptr to restore
+   *     sequential execution. Must outlive any subsequent execute() calls.
+   */
+  void set_chain_executor(ChainExecutor* chain_executor) {
+    chain_executor_ = chain_executor;
+  }
+
+  /**
+   * Sets the allocator that gives DYNAMIC_UNBOUND tensors more storage when a
+   * kernel resizes them beyond what the memory plan reserved for them.
+   *
+   * Storage obtained from it stays in use by its tensor for the lifetime of
+   * the Method, and each tensor grows geometrically, so repeated executions
+   * with long inputs don't keep allocating. Without a dynamic allocator,
+   * unbounded tensors behave like bounded ones and fail to grow beyond their
+   * planned size. Chains that may grow unbounded tensors are never run
+   * concurrently with others, so they always receive it.
+   *
+   * NOTE: Prototype API; subject to change.
+   *
+   * @param[in] dynamic_allocator The allocator to use, or nullptr to disable
+   *     growth. Must outlive the Method and must never be reset while the
+   *     Method is alive.
+   */
+  void set_dynamic_allocator(MemoryAllocator* dynamic_allocator) {
+    dynamic_allocator_ = dynamic_allocator;
+  }
+
+  /**
+   * Returns the largest number of bytes that any single instruction has used
+   * from the MemoryManager's temp allocator, as reported by its used_size(),
+   * since the Method was loaded or since the last call to
+   * reset_temp_allocator_high_watermark().
+   *
+   * The runtime resets the temp allocator after every kernel and delegate
+   * call, so after running representative inputs this is the smallest temp
+   * allocator size that those inputs need. Chains that run concurrently do
+   * not receive the temp allocator, and are not measured.
+   */
+  size_t temp_allocator_high_watermark() const {
+    return temp_allocator_high_watermark_;
+  }
+
+  /// Restarts temp_allocator_high_watermark() from zero.
+  void reset_temp_allocator_high_watermark() {
+    temp_allocator_high_watermark_ = 0;
+  }
+
+  /**
+   * Returns the memory that this Method holds, e.g. for a scheduler to decide
+   * how many Methods to keep loaded at once.
+   */
+  MethodMemoryStats memory_stats() const;
+
+  /**
+   * Enables or disables event tracing for this Method. Tracing is enabled by
+   * default, and has no effect unless an EventTracer was passed to
+   * Program::load_method().
+   *
+   * While disabled, execution takes the same path as a Method loaded without
+   * an EventTracer, and does not pay for any profiling or debug logging.
+   * Instructions are still reported with their serialized indices when tracing
+   * is enabled again.
+   *
+   * Must not be called while an execute_async() call is pending.
+   *
+   * NOTE: Prototype API; subject to change.
+   */
+  void set_event_tracer_enabled(bool enabled) {
+    event_tracer_enabled_ = enabled;
+  }
+
   /**
    * Advances/executes a single instruction in the method.
    *
@@ -269,12 +699,37 @@ class Method final {
         memory_manager_(memory_manager),
         serialization_plan_(nullptr),
         event_tracer_(event_tracer),
+        event_tracer_enabled_(true),
         n_value_(0),
         values_(nullptr),
         n_delegate_(0),
         delegates_(nullptr),
+        n_constant_buffer_(0),
+        constant_buffers_(nullptr),
+        constant_source_(nullptr),
+        delegate_selector_(nullptr),
+        weight_streaming_(nullptr),
+        weight_streamer_(nullptr),
+        init_bytes_loaded_(0),
+        method_allocator_bytes_(0),
+        delegate_allocator_bytes_(0),
         n_chains_(0),
         chains_(nullptr),
+        chain_executor_(nullptr),
+        dynamic_allocator_(nullptr),
+        temp_allocator_high_watermark_(0),
+        n_chain_waves_(0),
+        chain_wave_order_(nullptr),
+        chain_wave_offsets_(nullptr),
+        chain_wave_serial_(nullptr),
+        chain_errors_(nullptr),
+        async_completion_fn_(nullptr),
+        async_completion_context_(nullptr),
+        async_pending_(false),
+        pending_instr_idx_(0),
+        run_ahead_error_(Error::Ok),
+        io_buffer_sets_(),
+        constants_(),
         init_state_(InitializationState::Uninitialized),
         pre_allocated_input_(false),
         pre_allocated_output_(false) {}
@@ -284,28 +739,175 @@ class Method final {
       executorch_flatbuffer::ExecutionPlan* s_plan,
       const Program* program,
       MemoryManager* memory_manager,
-      EventTracer* event_tracer);
+      EventTracer* event_tracer,
+      internal::OperatorCache* operator_cache = nullptr,
+      const Method* constant_source = nullptr,
+      DelegateSelector* delegate_selector = nullptr,
+      const WeightStreamingConfig* weight_streaming = nullptr);
 
   /**
    * Initialize the method from its serialized representation.
    *
+   * @param[in] s_plan The serialized method to initialize from.
+   * @param[in] operator_cache If non-null, kernel resolutions are looked up in
+   *     and added to this cache, which may be shared with other methods of the
+   *     same Program.
+   *
    * @returns Error::Ok on success, non-Ok on failure.
    */
-  __ET_NODISCARD Error init(executorch_flatbuffer::ExecutionPlan* s_plan);
+  __ET_NODISCARD Error init(
+      executorch_flatbuffer::ExecutionPlan* s_plan,
+      internal::OperatorCache* operator_cache = nullptr);
+
+  /**
+   * Initializes the loaded delegates whose backends have a thread-safe
+   * init(), in parallel on the threadpool. On failure, returns the error of
+   * the first of them that failed, in delegate order.
+   */
+  __ET_NODISCARD Error init_thread_safe_delegates();
+
+  /**
+   * Returns true if delegate `index` of the plan is an alternative lowering
+   * of another partition, which is only loaded in its place.
+   */
+  bool is_alternative_delegate(size_t index) const;
+
+  /**
+   * Collects the lowerings of partition `index` whose backends are
+   * available: the partition's own, then its alternatives, in order.
+   *
+   * @param[out] backend_ids The backend IDs of the lowerings.
+   * @param[out] lowerings The indices of the lowerings in the plan's
+   *     delegates.
+   *
+   * @returns The number of available lowerings.
+   */
+  Result<size_t> available_lowerings(
+      size_t index,
+      const char** backend_ids,
+      size_t* lowerings) const;
+
+  /**
+   * Chooses the lowering to load for partition `index`, with the help of
+   * delegate_selector_, and sets `*measure` if all of them should be timed
+   * by measure_delegates().
+   *
+   * @returns The index of the lowering in the plan's delegates.
+   */
+  Result<size_t> select_lowering(size_t index, bool* measure);
+
+  /**
+   * Replaces the delegate of partition `index` with the given lowering, and
+   * initializes it.
+   */
+  __ET_NODISCARD Error reload_delegate(size_t index, size_t lowering);
+
+  /**
+   * Times every available lowering of the partitions that select_lowering()
+   * marked, keeps the fastest one and reports the results to
+   * delegate_selector_.
+   */
+  __ET_NODISCARD Error measure_delegates();
 
   /// Returns true if the Method was successfully initialized.
   inline bool initialized() const {
     return init_state_ == InitializationState::Initialized;
   }
 
-  // Executes a single instruction using the state in step_state_
-  __ET_NODISCARD Error execute_instruction();
+  /// Returns true if `index` refers to an entry of the values_ table.
+  inline bool is_valid_value_index(int32_t index) const {
+    return index >= 0 && static_cast<size_t>(index) < n_value_;
+  }
+
+  /**
+   * Executes a single instruction and advances `state` to the next one.
+   *
+   * `kTracing` selects whether the instruction reports to `event_tracer`. The
+   * `false` specialization compiles out every EventTracer hook, and ignores
+   * `event_tracer`.
+   *
+   * @param[in,out] state The chain and instruction to execute.
+   * @param[in] event_tracer The EventTracer to log to. May be nullptr.
+   * @param[in] temp_allocator The allocator to provide to kernels for
+   *     temporary memory. Reset after the instruction. May be nullptr.
+   * @param[in] dynamic_allocator The allocator to provide to kernels for
+   *     growing DYNAMIC_UNBOUND tensors. May be nullptr.
+   */
+  template <bool kTracing>
+  __ET_NODISCARD Error execute_instruction(
+      StepState& state,
+      EventTracer* event_tracer,
+      MemoryAllocator* temp_allocator,
+      MemoryAllocator* dynamic_allocator);
+
+  /**
+   * Records how much of `temp_allocator` the instruction that just finished
+   * used, then resets it. Does nothing if `temp_allocator` is nullptr.
+   */
+  void release_temp_memory(MemoryAllocator* temp_allocator);
+
+  /**
+   * Executes all instructions of a chain.
+   *
+   * @param[in] chain_idx The chain to execute.
+   * @param[in] concurrent True if other chains may be executing at the same
+   *     time, in which case the chain runs without the EventTracer and temp
+   *     allocator.
+   */
+  __ET_NODISCARD Error execute_chain(size_t chain_idx, bool concurrent);
+
+  /// The loop of execute_chain(), specialized on whether an EventTracer is in
+  /// use.
+  template <bool kTracing>
+  __ET_NODISCARD Error execute_chain_instructions(
+      size_t chain_idx,
+      EventTracer* event_tracer,
+      MemoryAllocator* temp_allocator,
+      MemoryAllocator* dynamic_allocator);
+
+  /// Executes all chains, dispatching independent waves of chains onto
+  /// chain_executor_.
+  __ET_NODISCARD Error execute_chains_concurrently();
+
+  /**
+   * Runs instructions from step_state_ until the end of the method or until a
+   * delegate call is pending. Used by execute_async() and resume_async().
+   */
+  __ET_NODISCARD Error run_async();
+
+  /// The loop of run_async(), specialized on whether an EventTracer is in use.
+  template <bool kTracing>
+  __ET_NODISCARD Error run_async_impl(EventTracer* event_tracer);
+
+  /**
+   * Runs the kernels after the pending delegate call at pending_instr_idx_
+   * that are independent of it, advancing step_state_ past them. A kernel
+   * failure is kept in run_ahead_error_ until the delegate call completes.
+   */
+  template <bool kTracing>
+  void run_ahead_of_delegate(
+      EventTracer* event_tracer,
+      MemoryAllocator* temp_allocator);
+
+  /// Returns the EventTracer that execution should report to, or nullptr if
+  /// there is none or tracing was disabled with set_event_tracer_enabled().
+  EventTracer* active_event_tracer() const {
+    return event_tracer_enabled_ ? event_tracer_ : nullptr;
+  }
+
+  /**
+   * Groups chains into waves of mutually-independent chains based on the
+   * values they read and write. Leaves the schedule empty if no two chains
+   * can run concurrently.
+   */
+  __ET_NODISCARD Error plan_chain_schedule();
 
   StepState step_state_;
   const Program* program_;
   MemoryManager* memory_manager_;
   executorch_flatbuffer::ExecutionPlan* serialization_plan_;
   EventTracer* event_tracer_;
+  bool event_tracer_enabled_;
 
   size_t n_value_;
   EValue* values_;
@@ -313,9 +915,79 @@ class Method final {
   size_t n_delegate_;
   BackendDelegate* delegates_;
 
+  /// A constant buffer loaded from the program's constant segment.
+  struct ConstantBuffer {
+    /// The Tensor.constant_buffer_idx that refers to this buffer.
+    size_t index;
+    FreeableBuffer data;
+    /// True if `data` belongs to constant_source_ rather than this Method.
+    bool borrowed;
+  };
+  /// The constants that this method loaded from the constant segment, if the
+  /// program has one. Tensors in values_ point into them, so they are freed
+  /// after the values.
+  size_t n_constant_buffer_;
+  ConstantBuffer* constant_buffers_;
+  /// While loading, another initialized Method of the same plan whose
+  /// constant buffers this one borrows instead of loading its own copies.
+  /// nullptr otherwise.
+  const Method* constant_source_;
+  /// While loading, chooses among the alternative lowerings of partitions.
+  /// nullptr otherwise.
+  DelegateSelector* delegate_selector_;
+  /// While loading, how to stream the weights, or nullptr to load them all.
+  const WeightStreamingConfig* weight_streaming_;
+  /// Loads and frees the streamed weights during execution, if any. Lives in
+  /// the method allocator; tensors in values_ point into its buffers.
+  internal::WeightStreamer* weight_streamer_;
+  /// While loading, the bytes that init() has read through the program's
+  /// DataLoader. See LoadEvent::bytes_loaded.
+  uint64_t init_bytes_loaded_;
+  /// See MethodMemoryStats::method_allocator_bytes.
+  size_t method_allocator_bytes_;
+  /// See MethodMemoryStats::delegate_allocator_bytes.
+  size_t delegate_allocator_bytes_;
+
   size_t n_chains_;
   Chain* chains_;
 
+  ChainExecutor* chain_executor_;
+  MemoryAllocator* dynamic_allocator_;
+  /// See temp_allocator_high_watermark().
+  size_t temp_allocator_high_watermark_;
+  /// Number of waves in the chain schedule; equal to n_chains_ when no chains
+  /// can run concurrently.
+  size_t n_chain_waves_;
+  /// Chain indices, grouped by wave. nullptr if there is no parallelism.
+  uint32_t* chain_wave_order_;
+  /// Wave `w` contains chain_wave_order_[offsets[w]..offsets[w + 1]).
+  uint32_t* chain_wave_offsets_;
+  /// The number of chains at the start of each wave that run on the calling
+  /// thread, because their kernels may grow unbounded tensors through the
+  /// dynamic allocator, which is not thread-safe.
+  uint32_t* chain_wave_serial_;
+  /// Per-chain results of concurrently-executed chains.
+  Error* chain_errors_;
+
+  /// The completion callback of the current execute_async() call, or nullptr
+  /// when no asynchronous execution is in progress.
+  AsyncCompletionFn async_completion_fn_;
+  void* async_completion_context_;
+  /// True while the delegate call at pending_instr_idx_ of the current chain
+  /// has returned Error::Pending and not completed yet.
+  bool async_pending_;
+  /// The instruction of the pending delegate call. step_state_ points past it
+  /// and the kernels that ran ahead of its completion.
+  size_t pending_instr_idx_;
+  /// The first error of a kernel that ran ahead of the pending delegate call.
+  Error run_ahead_error_;
+
+  /// Caller-owned buffer sets registered with set_io_buffer_sets().
+  exec_aten::ArrayRef<IOBufferSet> io_buffer_sets_;
+
+  /// Caller-owned constants registered with set_constants().
+  exec_aten::ArrayRef<ConstantData> constants_;
+
   InitializationState init_state_;
   bool pre_allocated_input_;
   bool pre_allocated_output_;
@@ -327,12 +999,58 @@ class Method final {
    */
   __ET_NODISCARD Error parse_values();
 
+  /**
+   * Returns the index in values_ of the constant tensor named `name` in the
+   * plan's named_constants, or -1 if there is none.
+   */
+  int32_t find_named_constant(const char* name) const;
+
+  /**
+   * Checks that set_constants() can replace `constant`: it must name a
+   * constant tensor of the plan that is not mutable state, or a constant that
+   * an initialized delegate holds, and have data of the right size.
+   */
+  __ET_NODISCARD Error check_constant(const ConstantData& constant) const;
+
+  /**
+   * Points the constant tensor at values_[value_index] at `data`, or back at
+   * its own data if `data` is nullptr.
+   */
+  __ET_NODISCARD Error
+  set_constant_data(size_t value_index, const void* data, size_t nbytes);
+
+  /**
+   * Offers a constant to the initialized delegates, which replace it if they
+   * hold it. `data` nullptr restores their own.
+   *
+   * @returns Error::NotFound if no delegate holds the constant.
+   */
+  __ET_NODISCARD Error
+  update_delegate_constant(const char* name, const void* data, size_t nbytes);
+
+  /**
+   * Finds the memory-planned buffer holding the mutable state and the span
+   * [begin, end) of its offsets that the state tensors cover.
+   */
+  __ET_NODISCARD Error
+  get_state_span(uint32_t* memory_id, size_t* begin, size_t* end) const;
+
+  /**
+   * Returns the data of the constant buffer `buffer_index`, loading it from
+   * the program's constant segment the first time it is needed, or borrowing
+   * it from constant_source_ if that already loaded it. Must only be
+   * called while parsing the values, after constant_buffers_ has been
+   * allocated.
+   */
+  __ET_NODISCARD Result<const FreeableBuffer*> get_constant_buffer(
+      size_t buffer_index);
+
   __ET_NODISCARD Error resolve_operator(
       int32_t op_index,
-      OpFunction* kernels,
-      size_t kernel_index,
+      OpFunction* kernel,
       InstructionArgs args,
-      size_t n_args);
+      size_t n_args,
+      internal::OperatorCache* operator_cache);
 };
 
 } // namespace executor
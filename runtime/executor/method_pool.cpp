@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/method_pool.h>
+
+#include <new>
+
+#include <executorch/runtime/core/event_tracer_hooks.h>
+#include <executorch/runtime/executor/operator_cache.h>
+#include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/profiler.h>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+void destroy_methods(Method* methods, size_t n_methods) {
+  // The others borrow the constants of methods[0], so destroy it last.
+  for (size_t i = n_methods; i > 0; --i) {
+    methods[i - 1].~Method();
+  }
+}
+
+} // namespace
+
+Result<MethodPool> MethodPool::load(
+    const Program* program,
+    const char* method_name,
+    ArrayRef<MemoryManager*> memory_managers,
+    MemoryAllocator* pool_allocator,
+    EventTracer* event_tracer) {
+  EXECUTORCH_SCOPE_PROF("MethodPool::load");
+  const size_t n_methods = memory_managers.size();
+  ET_CHECK_OR_RETURN_ERROR(
+      n_methods > 0 && n_methods <= kMaxMethods,
+      InvalidArgument,
+      "Pool size %zu must be between 1 and %zu",
+      n_methods,
+      kMaxMethods);
+  Method* methods = pool_allocator->allocateList<Method>(n_methods);
+  if (methods == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+
+  internal::event_tracer_create_event_block(event_tracer, "Default");
+  internal::EventTracerProfileScope event_tracer_scope =
+      internal::EventTracerProfileScope(event_tracer, "MethodPool::load");
+
+  internal::OperatorCache operator_cache;
+  for (size_t i = 0; i < n_methods; ++i) {
+    Result<Method> method = program->load_method_shared(
+        method_name,
+        memory_managers[i],
+        event_tracer,
+        &operator_cache,
+        /*constant_source=*/i == 0 ? nullptr : &methods[0]);
+    if (!method.ok()) {
+      destroy_methods(methods, i);
+      return method.error();
+    }
+    new (&methods[i]) Method(std::move(method.get()));
+  }
+  return MethodPool(methods, n_methods);
+}
+
+MethodPool::~MethodPool() {
+  if (methods_ != nullptr) {
+    destroy_methods(methods_, n_methods_);
+  }
+}
+
+Method* MethodPool::try_acquire() {
+  uint64_t mask = free_mask_.load(std::memory_order_relaxed);
+  while (mask != 0) {
+    // Prefer the lowest idle instance, whose arenas are most likely to still
+    // be in cache.
+    const uint64_t bit = mask & (~mask + 1);
+    if (free_mask_.compare_exchange_weak(
+            mask,
+            mask & ~bit,
+            std::memory_order_acquire,
+            std::memory_order_relaxed)) {
+      size_t index = 0;
+      while ((uint64_t(1) << index) != bit) {
+        ++index;
+      }
+      return &methods_[index];
+    }
+  }
+  return nullptr;
+}
+
+void MethodPool::release(Method* method) {
+  ET_CHECK_MSG(
+      method >= methods_ && method < methods_ + n_methods_,
+      "Method %p is not part of this pool",
+      static_cast<void*>(method));
+  const uint64_t bit = uint64_t(1) << (method - methods_);
+  const uint64_t previous =
+      free_mask_.fetch_or(bit, std::memory_order_release);
+  ET_CHECK_MSG(
+      (previous & bit) == 0,
+      "Method %zu released but not checked out",
+      static_cast<size_t>(method - methods_));
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/array_ref.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/memory_manager.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Several instances of the same method of a Program, for servers that run
+ * one method from many threads at once.
+ *
+ * Each instance has its own MemoryManager, and so its own planned arenas and
+ * values, but they load constants only once: the constant buffers of the
+ * first instance are borrowed by the others, and kernels are resolved once
+ * for all of them. Backends share their delegate state across instances
+ * through their own caches, e.g. the packed weights of XNNPACK.
+ *
+ * Threads check instances out with try_acquire() and return them with
+ * release(), or with a MethodPool::Lease. Checkout and return are lock-free
+ * and may be called concurrently; a Method is used by at most one thread at
+ * a time. The pool does not block: a caller that finds every instance busy
+ * waits on its own primitive, e.g. a condition variable signaled after
+ * release().
+ */
+class MethodPool final {
+ public:
+  /// The maximum number of instances in one pool.
+  static constexpr size_t kMaxMethods = 64;
+
+  /**
+   * Loads one instance of a method for each of `memory_managers`.
+   *
+   * @param[in] program The Program to load from. Must outlive the pool.
+   * @param[in] method_name The name of the method to load.
+   * @param[in] memory_managers The allocators of each instance. Must not
+   *     share planned memory, and must outlive the pool.
+   * @param[in] pool_allocator Holds the instances. Must outlive the pool.
+   * @param[in] event_tracer The event tracer to use for all instances, or
+   *     nullptr. Must support being called from several threads at once.
+   *
+   * @returns The pool on success.
+   * @retval Error::InvalidArgument There are no memory managers, or more than
+   *     kMaxMethods.
+   * @retval Error::MemoryAllocationFailed `pool_allocator` is too small.
+   * @returns Any error of Program::load_method().
+   */
+  __ET_NODISCARD static Result<MethodPool> load(
+      const Program* program,
+      const char* method_name,
+      ArrayRef<MemoryManager*> memory_managers,
+      MemoryAllocator* pool_allocator,
+      EventTracer* event_tracer = nullptr);
+
+  /**
+   * Move ctor. Must not be called while any instance is checked out.
+   */
+  MethodPool(MethodPool&& rhs) noexcept
+      : methods_(rhs.methods_),
+        n_methods_(rhs.n_methods_),
+        free_mask_(rhs.free_mask_.load(std::memory_order_relaxed)) {
+    rhs.methods_ = nullptr;
+    rhs.n_methods_ = 0;
+    rhs.free_mask_.store(0, std::memory_order_relaxed);
+  }
+
+  ~MethodPool();
+
+  /// Returns the number of instances in the pool.
+  size_t size() const {
+    return n_methods_;
+  }
+
+  /**
+   * Checks out an idle instance.
+   *
+   * @returns The instance, or nullptr if all of them are checked out.
+   */
+  Method* try_acquire();
+
+  /**
+   * Returns an instance checked out with try_acquire(). The caller must not
+   * use it afterwards.
+   */
+  void release(Method* method);
+
+  /**
+   * Checks out an instance for the lifetime of the lease, and returns it to
+   * the pool when the lease is destroyed.
+   */
+  class Lease final {
+   public:
+    explicit Lease(MethodPool& pool)
+        : pool_(&pool), method_(pool.try_acquire()) {}
+
+    Lease(Lease&& rhs) noexcept : pool_(rhs.pool_), method_(rhs.method_) {
+      rhs.method_ = nullptr;
+    }
+
+    ~Lease() {
+      if (method_ != nullptr) {
+        pool_->release(method_);
+      }
+    }
+
+    /// Returns true if the lease holds an instance.
+    bool ok() const {
+      return method_ != nullptr;
+    }
+
+    /// The checked-out instance. Only valid if ok() is true.
+    Method& operator*() const {
+      return *method_;
+    }
+    Method* operator->() const {
+      return method_;
+    }
+
+   private:
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease& operator=(Lease&&) = delete;
+
+    MethodPool* pool_;
+    Method* method_;
+  };
+
+ private:
+  MethodPool(const MethodPool&) = delete;
+  MethodPool& operator=(const MethodPool&) = delete;
+  MethodPool& operator=(MethodPool&&) = delete;
+
+  MethodPool(Method* methods, size_t n_methods)
+      : methods_(methods),
+        n_methods_(n_methods),
+        free_mask_(
+            n_methods == kMaxMethods ? ~uint64_t(0)
+                                     : (uint64_t(1) << n_methods) - 1) {}
+
+  /// The instances. The others borrow the constants of methods_[0].
+  Method* methods_;
+  size_t n_methods_;
+  /// Bit i is set while methods_[i] is idle.
+  std::atomic<uint64_t> free_mask_;
+};
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/operator_cache.h>
+
+#include <cstring>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+namespace {
+
+uint32_t hash_resolution(
+    const char* name,
+    const char* overload,
+    const uint8_t* key,
+    size_t key_size) {
+  // 32-bit FNV-1a over the name, overload and key, with a separator between
+  // the strings so that "a" + "bc" and "ab" + "c" differ.
+  uint32_t hash = 2166136261u;
+  for (const char* s = name; *s != '\0'; ++s) {
+    hash = (hash ^ static_cast<uint8_t>(*s)) * 16777619u;
+  }
+  hash *= 16777619u;
+  for (const char* s = overload; *s != '\0'; ++s) {
+    hash = (hash ^ static_cast<uint8_t>(*s)) * 16777619u;
+  }
+  hash *= 16777619u;
+  for (size_t i = 0; i < key_size; ++i) {
+    hash = (hash ^ key[i]) * 16777619u;
+  }
+  return hash;
+}
+
+} // namespace
+
+const OpFunction* OperatorCache::find(
+    const char* name,
+    const char* overload,
+    const uint8_t* key,
+    size_t key_size) const {
+  if (key_size > kMaxKeyBytes) {
+    return nullptr;
+  }
+  const uint32_t hash = hash_resolution(name, overload, key, key_size);
+  for (size_t i = 0; i < num_entries_; ++i) {
+    const Entry& e = entries_[i];
+    if (e.hash == hash && e.key_size == key_size &&
+        std::memcmp(e.key, key, key_size) == 0 &&
+        std::strcmp(e.name, name) == 0 &&
+        std::strcmp(e.overload, overload) == 0) {
+      return &e.kernel;
+    }
+  }
+  return nullptr;
+}
+
+void OperatorCache::insert(
+    const char* name,
+    const char* overload,
+    const uint8_t* key,
+    size_t key_size,
+    const OpFunction& kernel) {
+  if (num_entries_ >= kNumEntries || key_size > kMaxKeyBytes) {
+    return;
+  }
+  Entry& e = entries_[num_entries_++];
+  e.hash = hash_resolution(name, overload, key, key_size);
+  e.key_size = static_cast<uint8_t>(key_size);
+  std::memcpy(e.key, key, key_size);
+  e.name = name;
+  e.overload = overload;
+  e.kernel = kernel;
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/kernel/operator_registry.h>
+
+/*
+ * The number of distinct (operator, kernel key) pairs that
+ * Program::load_methods() remembers while loading a batch of methods. Targets
+ * with tight stack budgets can shrink it by passing
+ * -DET_OPERATOR_CACHE_SIZE=<n> on the compile line; 0 disables the cache.
+ */
+#ifndef ET_OPERATOR_CACHE_SIZE
+#define ET_OPERATOR_CACHE_SIZE 32
+#endif
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+/**
+ * Remembers the kernels that Method::init() resolved for (operator name,
+ * overload, kernel key) triples so that methods loaded together from the same
+ * Program do not repeat the operator name formatting and registry lookup for
+ * operators they share.
+ *
+ * The cache holds pointers to the operator name strings inside the Program, so
+ * it must not outlive the Program that the methods were loaded from. It is not
+ * thread-safe.
+ */
+class OperatorCache final {
+ public:
+  /// Maximum number of cached resolutions.
+  static constexpr size_t kNumEntries = ET_OPERATOR_CACHE_SIZE;
+
+  /// Maximum size of an encoded kernel key. Resolutions whose keys do not fit
+  /// are not cached.
+  static constexpr size_t kMaxKeyBytes = 48;
+
+  OperatorCache() = default;
+
+  /**
+   * Looks up a previous resolution.
+   *
+   * @param[in] name The operator name, without the overload.
+   * @param[in] overload The operator overload name; may be empty.
+   * @param[in] key The encoded kernel key of the tensor arguments.
+   * @param[in] key_size The number of bytes in `key`.
+   *
+   * @returns The cached kernel, or nullptr if there is none.
+   */
+  const OpFunction* find(
+      const char* name,
+      const char* overload,
+      const uint8_t* key,
+      size_t key_size) const;
+
+  /**
+   * Records a resolution. Silently drops it if the cache is full or the key is
+   * larger than kMaxKeyBytes.
+   */
+  void insert(
+      const char* name,
+      const char* overload,
+      const uint8_t* key,
+      size_t key_size,
+      const OpFunction& kernel);
+
+ private:
+  struct Entry {
+    uint32_t hash;
+    uint8_t key_size;
+    uint8_t key[kMaxKeyBytes];
+    const char* name;
+    const char* overload;
+    OpFunction kernel;
+  };
+
+  // Keep a one-element array when the cache is disabled so that the class is
+  // still well-formed.
+  Entry entries_[kNumEntries > 0 ? kNumEntries : 1];
+  size_t num_entries_ = 0;
+};
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
@@ -8,12 +8,17 @@
 
 #include <executorch/runtime/executor/program.h>
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstddef>
 #include <cstdint>
 
 #include <executorch/runtime/core/event_tracer_hooks.h>
+#include <executorch/runtime/executor/load_event_scope.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/operator_cache.h>
+#include <executorch/runtime/executor/segment_decompressor.h>
 #include <executorch/runtime/platform/profiler.h>
 #include <executorch/schema/extended_header.h>
 #include <executorch/schema/program_generated.h>
@@ -39,9 +44,9 @@ namespace {
  */
 constexpr size_t kMinimumAlignment = alignof(std::max_align_t);
 
-bool IsAligned(const void* data) {
+bool IsAligned(const void* data, size_t alignment = kMinimumAlignment) {
   uintptr_t addr = reinterpret_cast<uintptr_t>(data);
-  return addr % kMinimumAlignment == 0;
+  return addr % alignment == 0;
 }
 
 Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
@@ -62,12 +67,21 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
 
 /* static */ Result<Program> Program::load(
     DataLoader* loader,
-    Program::Verification verification) {
+    Program::Verification verification,
+    EventTracer* event_tracer) {
   EXECUTORCH_SCOPE_PROF("Program::load");
+  internal::event_tracer_create_event_block(event_tracer, "Program::load");
+  // Bytes read through the loader, for the LoadEvents.
+  uint64_t bytes_loaded = 0;
+  internal::LoadEventScope load_event(
+      event_tracer, "Program::load", &bytes_loaded, /*allocator=*/nullptr);
 
   // See if the program size is in the header.
   size_t program_size = 0;
   size_t segment_base_offset = 0;
+  bool has_program_checksum = false;
+  uint32_t program_checksum = 0;
+  size_t tensor_alignment = 0;
   {
     EXECUTORCH_SCOPE_PROF("Program::check_header");
     Result<FreeableBuffer> header =
@@ -75,12 +89,16 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
     if (!header.ok()) {
       return header.error();
     }
+    bytes_loaded += header->size();
     Result<ExtendedHeader> eh =
         ExtendedHeader::Parse(header->data(), header->size());
     if (eh.ok()) {
       // The header has the program size.
       program_size = eh->program_size;
       segment_base_offset = eh->segment_base_offset;
+      has_program_checksum = eh->has_program_checksum;
+      program_checksum = eh->program_checksum;
+      tensor_alignment = eh->tensor_alignment;
     } else if (eh.error() == Error::NotFound) {
       // No header; the program consumes the whole file, and there are no
       // segments.
@@ -91,10 +109,26 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
     }
   }
 
+  ET_CHECK_OR_RETURN_ERROR(
+      (tensor_alignment & (tensor_alignment - 1)) == 0,
+      InvalidProgram,
+      "Tensor alignment %zu is not a power of 2",
+      tensor_alignment);
+
   // Load the flatbuffer data as a segment.
   uint32_t prof_tok = EXECUTORCH_BEGIN_PROF("Program::load_data");
-  Result<FreeableBuffer> program_data =
-      loader->Load(/*offset=*/0, program_size);
+  Result<FreeableBuffer> program_data = [&]() {
+    internal::LoadEventScope data_load_event(
+        event_tracer,
+        "Program::load_data",
+        &bytes_loaded,
+        /*allocator=*/nullptr);
+    Result<FreeableBuffer> data = loader->Load(/*offset=*/0, program_size);
+    if (data.ok()) {
+      bytes_loaded += data->size();
+    }
+    return data;
+  }();
   if (!program_data.ok()) {
     return program_data.error();
   }
@@ -113,6 +147,11 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
 
   // Do extra verification if requested.
   if (verification == Verification::InternalConsistency) {
+    internal::LoadEventScope verify_load_event(
+        event_tracer,
+        "Program::verify",
+        &bytes_loaded,
+        /*allocator=*/nullptr);
 #if ET_ENABLE_PROGRAM_VERIFICATION
     EXECUTORCH_SCOPE_PROF("Program::verify_internal_consistency");
     flatbuffers::Verifier verifier(
@@ -127,16 +166,40 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
     ET_LOG(
         Info, "InternalConsistency verification requested but not available");
 #endif
+  } else if (verification == Verification::Checksum) {
+    EXECUTORCH_SCOPE_PROF("Program::verify_checksum");
+    internal::LoadEventScope verify_load_event(
+        event_tracer,
+        "Program::verify",
+        &bytes_loaded,
+        /*allocator=*/nullptr);
+    ET_CHECK_OR_RETURN_ERROR(
+        has_program_checksum,
+        InvalidProgram,
+        "Checksum verification requested but the program has no checksum");
+    const uint32_t actual = ExtendedHeader::ComputeProgramChecksum(
+        program_data->data(), program_data->size());
+    ET_CHECK_OR_RETURN_ERROR(
+        actual == program_checksum,
+        InvalidProgram,
+        "Checksum 0x%08" PRIx32 " != expected 0x%08" PRIx32
+        "; data may be truncated or corrupt",
+        actual,
+        program_checksum);
   }
 
   // The flatbuffer data must start at an aligned address to ensure internal
-  // alignment of flatbuffer fields.
+  // alignment of flatbuffer fields, and of the constant tensors that the
+  // serializer aligned within it.
+  const size_t required_alignment =
+      std::max(kMinimumAlignment, tensor_alignment);
   ET_CHECK_OR_RETURN_ERROR(
-      IsAligned(program_data->data()),
+      IsAligned(program_data->data(), required_alignment),
       InvalidArgument,
-      "Program data 0x%p must be aligned to %zu",
+      "Program data 0x%p must be aligned to %zu; the DataLoader must be "
+      "created with at least that alignment",
       program_data->data(),
-      kMinimumAlignment);
+      required_alignment);
 
   // Get the pointer to the root flatbuffer table.
   const executorch_flatbuffer::Program* flatbuffer_program =
@@ -147,6 +210,7 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
   return Program(
       loader,
       segment_base_offset,
+      tensor_alignment,
       std::move(program_data.get()),
       flatbuffer_program);
 }
@@ -169,7 +233,9 @@ Result<const char*> Program::get_method_name(size_t plan_index) const {
 Result<Method> Program::load_method(
     const char* method_name,
     MemoryManager* memory_manager,
-    EventTracer* event_tracer) const {
+    EventTracer* event_tracer,
+    DelegateSelector* delegate_selector,
+    const WeightStreamingConfig* weight_streaming) const {
   EXECUTORCH_SCOPE_PROF("Program::load_method");
   internal::event_tracer_create_event_block(event_tracer, "Default");
   internal::EventTracerProfileScope event_tracer_scope =
@@ -178,7 +244,82 @@ Result<Method> Program::load_method(
   if (!plan.ok()) {
     return plan.error();
   }
-  return Method::load(plan.get(), this, memory_manager, event_tracer);
+  return Method::load(
+      plan.get(),
+      this,
+      memory_manager,
+      event_tracer,
+      /*operator_cache=*/nullptr,
+      /*constant_source=*/nullptr,
+      delegate_selector,
+      weight_streaming);
+}
+
+Result<Method> Program::load_method_shared(
+    const char* method_name,
+    MemoryManager* memory_manager,
+    EventTracer* event_tracer,
+    internal::OperatorCache* operator_cache,
+    const Method* constant_source) const {
+  auto plan = get_execution_plan(internal_program_, method_name);
+  if (!plan.ok()) {
+    return plan.error();
+  }
+  return Method::load(
+      plan.get(),
+      this,
+      memory_manager,
+      event_tracer,
+      operator_cache,
+      constant_source);
+}
+
+Error Program::load_methods(
+    ArrayRef<const char*> method_names,
+    ArrayRef<MemoryManager*> memory_managers,
+    MethodLoadedFn on_loaded,
+    void* context,
+    EventTracer* event_tracer,
+    DelegateSelector* delegate_selector) const {
+  EXECUTORCH_SCOPE_PROF("Program::load_methods");
+  ET_CHECK_OR_RETURN_ERROR(
+      method_names.size() == memory_managers.size(),
+      InvalidArgument,
+      "%zu method names but %zu memory managers",
+      method_names.size(),
+      memory_managers.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      on_loaded != nullptr, InvalidArgument, "on_loaded must not be null");
+
+  internal::event_tracer_create_event_block(event_tracer, "Default");
+  internal::EventTracerProfileScope event_tracer_scope =
+      internal::EventTracerProfileScope(event_tracer, "Program::load_methods");
+
+  // Lives only for this call, so the cache never holds resolutions for a
+  // registry that has since changed.
+  internal::OperatorCache operator_cache;
+  for (size_t i = 0; i < method_names.size(); i++) {
+    auto plan = get_execution_plan(internal_program_, method_names[i]);
+    if (!plan.ok()) {
+      Error err = plan.error();
+      on_loaded(context, i, err);
+      return err;
+    }
+    Result<Method> method = Method::load(
+        plan.get(),
+        this,
+        memory_managers[i],
+        event_tracer,
+        &operator_cache,
+        /*constant_source=*/nullptr,
+        delegate_selector);
+    Error err = method.error();
+    on_loaded(context, i, std::move(method));
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  return Error::Ok;
 }
 
 Result<MethodMeta> Program::method_meta(const char* method_name) const {
@@ -191,8 +332,19 @@ Result<MethodMeta> Program::method_meta(const char* method_name) const {
 
 Result<const void*> Program::get_constant_buffer_data(
     size_t buffer_index) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      !has_constant_segment(),
+      NotSupported,
+      "Constant buffer %zu is in the constant segment; it is loaded by the "
+      "Methods that use it",
+      buffer_index);
   auto internal_program =
       static_cast<const executorch_flatbuffer::Program*>(internal_program_);
+  ET_CHECK_OR_RETURN_ERROR(
+      internal_program->constant_buffer() != nullptr,
+      InvalidArgument,
+      "Constant buffer %zu requested, but program has no constant buffers",
+      buffer_index);
   size_t size = internal_program->constant_buffer()->size();
   ET_CHECK_OR_RETURN_ERROR(
       buffer_index < size,
@@ -207,6 +359,14 @@ Result<const void*> Program::get_constant_buffer_data(
       constant_buffer[buffer_index]->storage()->data());
 }
 
+bool Program::has_constant_segment() const {
+  const executorch_flatbuffer::SubsegmentOffsets* constant_segment =
+      internal_program_->constant_segment();
+  return constant_segment != nullptr &&
+      constant_segment->offsets() != nullptr &&
+      constant_segment->offsets()->size() > 0;
+}
+
 Result<int64_t> Program::get_non_const_buffer_size(
     size_t buffer_index,
     const char* method_name) const {
@@ -281,7 +441,9 @@ Error Program::get_backend_delegate_data(
   return HeaderStatus::NotPresent;
 }
 
-Result<FreeableBuffer> Program::LoadSegment(size_t index) const {
+Result<FreeableBuffer> Program::LoadSegment(
+    size_t index,
+    MemoryAllocator* allocator) const {
   EXECUTORCH_SCOPE_PROF("Program::LoadSegment");
   if (loader_ == nullptr || segment_base_offset_ == 0) {
     ET_LOG(Error, "No segments in program: requested index %zu", index);
@@ -295,12 +457,170 @@ Result<FreeableBuffer> Program::LoadSegment(size_t index) const {
   }
   const executorch_flatbuffer::DataSegment* segment =
       internal_program_->segments()->Get(index);
-  // Could fail if offset and size are out of bound for the data, or if this
-  // is reading from a file and fails, or for many other reasons depending on
-  // the implementation of the loader.
-  return loader_->Load(
+  switch (segment->compression()) {
+    case executorch_flatbuffer::SegmentCompression::NONE:
+      // Could fail if offset and size are out of bound for the data, or if
+      // this is reading from a file and fails, or for many other reasons
+      // depending on the implementation of the loader.
+      return loader_->Load(
+          segment_base_offset_ + segment->offset(), segment->size());
+    case executorch_flatbuffer::SegmentCompression::LZ4_BLOCK: {
+      ET_CHECK_OR_RETURN_ERROR(
+          allocator != nullptr,
+          NotSupported,
+          "Segment %zu is compressed, but there is no memory to decompress it",
+          index);
+      const size_t size = segment->uncompressed_size();
+      void* data = allocator->allocate(size, kMinimumAlignment);
+      if (data == nullptr) {
+        ET_LOG(
+            Error,
+            "Failed to allocate %zu bytes to decompress segment %zu",
+            size,
+            index);
+        return Error::MemoryAllocationFailed;
+      }
+      Error err = internal::decompress_lz4_block(
+          loader_,
+          segment_base_offset_ + segment->offset(),
+          segment->size(),
+          data,
+          size);
+      if (err != Error::Ok) {
+        ET_LOG(Error, "Failed to decompress segment %zu", index);
+        return err;
+      }
+      // The allocator owns the memory.
+      return FreeableBuffer(data, size, /*free_fn=*/nullptr);
+    }
+    default:
+      ET_LOG(
+          Error,
+          "Segment %zu has unknown compression %d",
+          index,
+          static_cast<int>(segment->compression()));
+      return Error::NotSupported;
+  }
+}
+
+bool Program::is_segment_mapped(size_t index) const {
+  if (loader_ == nullptr || !loader_->loads_mapped_data() ||
+      internal_program_->segments() == nullptr ||
+      index >= internal_program_->segments()->size()) {
+    return false;
+  }
+  // Compressed segments are decompressed into memory.
+  return internal_program_->segments()->Get(index)->compression() ==
+      executorch_flatbuffer::SegmentCompression::NONE;
+}
+
+Error Program::get_constant_segment_buffer_range(
+    size_t buffer_index,
+    size_t* out_offset,
+    size_t* out_size) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      has_constant_segment(),
+      InvalidArgument,
+      "Program has no constant segment");
+  ET_CHECK_OR_RETURN_ERROR(
+      loader_ != nullptr && segment_base_offset_ != 0,
+      InvalidProgram,
+      "Program has a constant segment table but no segments");
+  const executorch_flatbuffer::SubsegmentOffsets* constant_segment =
+      internal_program_->constant_segment();
+  const auto* offsets = constant_segment->offsets();
+  // Index 0 is reserved for non-constant tensors.
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer_index > 0 && buffer_index < offsets->size(),
+      InvalidArgument,
+      "Constant buffer %zu out of range [1, %zu)",
+      buffer_index,
+      (size_t)offsets->size());
+
+  const size_t segment_index = constant_segment->segment_index();
+  const size_t num_segments = internal_program_->segments() != nullptr
+      ? internal_program_->segments()->size()
+      : 0;
+  ET_CHECK_OR_RETURN_ERROR(
+      segment_index < num_segments,
+      InvalidProgram,
+      "Constant segment index %zu out of range (>= %zu)",
+      segment_index,
+      num_segments);
+  const executorch_flatbuffer::DataSegment* segment =
+      internal_program_->segments()->Get(segment_index);
+  // Buffers are loaded individually, which a compressed stream can't support.
+  ET_CHECK_OR_RETURN_ERROR(
+      segment->compression() ==
+          executorch_flatbuffer::SegmentCompression::NONE,
+      NotSupported,
+      "Constant segment %zu is compressed",
+      segment_index);
+
+  // Sizes are not recorded; a buffer extends to the start of the next one, or
+  // to the end of the segment for the last one.
+  const size_t begin = offsets->Get(buffer_index);
+  const size_t end = buffer_index + 1 < offsets->size()
+      ? offsets->Get(buffer_index + 1)
+      : segment->size();
+  ET_CHECK_OR_RETURN_ERROR(
+      begin <= end && end <= segment->size(),
+      InvalidProgram,
+      "Constant buffer %zu [%zu, %zu) is outside of its segment of size %zu",
+      buffer_index,
+      begin,
+      end,
+      (size_t)segment->size());
+  *out_offset = segment_base_offset_ + segment->offset() + begin;
+  *out_size = end - begin;
+  return Error::Ok;
+}
+
+Result<FreeableBuffer> Program::LoadConstantSegmentBuffer(
+    size_t buffer_index) const {
+  EXECUTORCH_SCOPE_PROF("Program::LoadConstantSegmentBuffer");
+  size_t offset = 0;
+  size_t size = 0;
+  Error err = get_constant_segment_buffer_range(buffer_index, &offset, &size);
+  if (err != Error::Ok) {
+    return err;
+  }
+  Result<FreeableBuffer> buffer = loader_->Load(offset, size);
+  if (buffer.ok() && tensor_alignment_ > 0) {
+    ET_CHECK_OR_RETURN_ERROR(
+        IsAligned(buffer->data(), tensor_alignment_),
+        InvalidArgument,
+        "Constant buffer %zu data 0x%p must be aligned to %zu; the DataLoader "
+        "must be created with at least that alignment",
+        buffer_index,
+        buffer->data(),
+        tensor_alignment_);
+  }
+  return buffer;
+}
+
+void Program::PrefetchSegment(size_t index) const {
+  if (loader_ == nullptr || segment_base_offset_ == 0 ||
+      internal_program_->segments() == nullptr ||
+      index >= internal_program_->segments()->size()) {
+    // LoadSegment() will report the problem.
+    return;
+  }
+  const executorch_flatbuffer::DataSegment* segment =
+      internal_program_->segments()->Get(index);
+  // Only a hint; loaders that can't prefetch return NotSupported.
+  (void)loader_->Prefetch(
       segment_base_offset_ + segment->offset(), segment->size());
 }
 
+void Program::PrefetchConstantSegmentBuffer(size_t buffer_index) const {
+  size_t offset = 0;
+  size_t size = 0;
+  if (get_constant_segment_buffer_range(buffer_index, &offset, &size) ==
+      Error::Ok) {
+    (void)loader_->Prefetch(offset, size);
+  }
+}
+
 } // namespace executor
 } // namespace torch
@@ -11,6 +11,7 @@
 #include <cinttypes>
 #include <cstdint>
 
+#include <executorch/runtime/core/array_ref.h>
 #include <executorch/runtime/core/data_loader.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/event_tracer.h>
@@ -37,6 +38,11 @@ class ProgramTestFriend;
 
 /**
  * A deserialized ExecuTorch program binary.
+ *
+ * A Program is not modified after it is loaded, so several threads may load
+ * methods from it concurrently, each with its own MemoryManager. Segments
+ * such as delegate data are then read in parallel through the DataLoader,
+ * whose Load() must be thread-safe.
  */
 class Program final {
  public:
@@ -61,6 +67,18 @@ class Program final {
      * proram data.
      */
     InternalConsistency,
+    /**
+     * Verify the data against the checksum that the extended header carries,
+     * which the serializer adds with program_checksum set in
+     * ExecutorchBackendConfig. Fails if there is no checksum.
+     *
+     * Catches truncated or corrupted data at the cost of a CRC-32 over the
+     * flatbuffer data, which is much cheaper than InternalConsistency.
+     * Segments are not covered. A checksum is not a signature: unlike
+     * InternalConsistency, this does not protect against data crafted to pass
+     * it, so only use it for programs from a trusted source.
+     */
+    Checksum,
   };
 
   /**
@@ -72,10 +90,13 @@ class Program final {
    *     instance.
    * @param[in] verification The type of verification to do before returning
    *     success.
+   * @param[in] event_tracer The EventTracer to log the phases of the load to,
+   *     as LoadEvents in an event block named "Program::load". May be nullptr.
    */
   __ET_NODISCARD static Result<Program> load(
       DataLoader* loader,
-      Verification verification = Verification::Minimal);
+      Verification verification = Verification::Minimal,
+      EventTracer* event_tracer = nullptr);
 
   /// DEPRECATED: Use the lowercase `load()` instead.
   __ET_DEPRECATED __ET_NODISCARD static Result<Program> Load(
@@ -92,9 +113,29 @@ class Program final {
    * Get the constant buffer inside Program with index buffer_idx
    * @param[in] buffer_idx the index of the buffer in the constant_buffer
    * @return The buffer with corresponding index
+   * @retval Error::NotSupported The program keeps its constants in a segment,
+   *     which Methods load on demand; see `has_constant_segment()`.
    */
   Result<const void*> get_constant_buffer_data(size_t buffer_idx) const;
 
+  /**
+   * Returns true if the constant tensor data lives in a segment that follows
+   * the flatbuffer data, rather than in the flatbuffer's constant_buffer
+   * table. Each Method then loads only the constants that it uses, when it is
+   * loaded, and frees them when it is destroyed.
+   */
+  bool has_constant_segment() const;
+
+  /**
+   * Returns the alignment in bytes that the serializer guarantees for the data
+   * of every constant tensor, which kernels and delegates may rely on, or zero
+   * if the program does not record one. Program::load() fails if the
+   * DataLoader does not preserve it.
+   */
+  size_t tensor_alignment() const {
+    return tensor_alignment_;
+  }
+
   /**
    * Returns the number of methods in the program.
    */
@@ -118,13 +159,64 @@ class Program final {
    * @param[in] memory_manager The allocators to use during initialization and
    *     execution of the loaded method.
    * @param[in] event_tracer The event tracer to use for this method run.
+   * @param[in] delegate_selector Chooses among the alternative lowerings of
+   *     the method's delegated partitions, or nullptr to use the first one
+   *     whose backend is available. Only used while loading.
+   * @param[in] weight_streaming If non-null, the method's weights are loaded
+   *     on demand while it executes rather than while it loads. See
+   *     WeightStreamingConfig. Only used while loading.
    *
    * @returns The loaded method on success, or an error on failure.
+   * @retval Error::NotSupported Weight streaming was requested for a method
+   *     that doesn't support it.
    */
   Result<Method> load_method(
       const char* method_name,
       MemoryManager* memory_manager,
-      EventTracer* event_tracer = nullptr) const;
+      EventTracer* event_tracer = nullptr,
+      DelegateSelector* delegate_selector = nullptr,
+      const WeightStreamingConfig* weight_streaming = nullptr) const;
+
+  /**
+   * Called by `load_methods()` once for each requested method, in order.
+   *
+   * @param[in] context The `context` pointer passed to `load_methods()`.
+   * @param[in] method_index The index into the `method_names` list passed to
+   *     `load_methods()`.
+   * @param[in] method The loaded method, or the error that prevented it from
+   *     loading.
+   */
+  using MethodLoadedFn =
+      void (*)(void* context, size_t method_index, Result<Method>&& method);
+
+  /**
+   * Loads several methods of this program, sharing kernel resolution between
+   * them. Operators that appear in more than one of the methods (e.g. in the
+   * prefill and decode methods of an LLM) are looked up in the kernel registry
+   * only once.
+   *
+   * @param[in] method_names The names of the methods to load.
+   * @param[in] memory_managers The allocators to use for each method; must
+   *     have the same length as `method_names`. Entries may be shared only if
+   *     the methods will never need their planned memory at the same time.
+   * @param[in] on_loaded Receives each method as it is loaded. Ownership of
+   *     the method passes to the callback.
+   * @param[in] context Passed through to `on_loaded`.
+   * @param[in] event_tracer The event tracer to use for the method runs.
+   * @param[in] delegate_selector Chooses among the alternative lowerings of
+   *     delegated partitions, or nullptr. See load_method().
+   *
+   * @retval Error::Ok All methods were loaded.
+   * @returns The first load failure. `on_loaded` receives the failing result,
+   *     and no further methods are loaded.
+   */
+  __ET_NODISCARD Error load_methods(
+      ArrayRef<const char*> method_names,
+      ArrayRef<MemoryManager*> memory_managers,
+      MethodLoadedFn on_loaded,
+      void* context,
+      EventTracer* event_tracer = nullptr,
+      DelegateSelector* delegate_selector = nullptr) const;
 
   /**
    * Gathers metadata for the named method.
@@ -222,6 +314,8 @@ class Program final {
   friend class BackendDelegate;
   friend class Executor;
   friend class Method;
+  friend class MethodPool;
+  friend class internal::WeightStreamer;
   friend class testing::ProgramTestFriend;
 
   const executorch_flatbuffer::Program* get_internal_program() const {
@@ -235,31 +329,108 @@ class Program final {
       size_t* out_size) const;
 
   /**
-   * Loads a segment by index.
+   * Loads the named method like load_method(). Kernel resolutions are shared
+   * through `operator_cache`, and constant buffers that `constant_source`
+   * already loaded are borrowed from it instead of loaded again. Used by
+   * MethodPool; either may be null.
+   */
+  Result<Method> load_method_shared(
+      const char* method_name,
+      MemoryManager* memory_manager,
+      EventTracer* event_tracer,
+      internal::OperatorCache* operator_cache,
+      const Method* constant_source) const;
+
+  /**
+   * Loads a segment by index. Compressed segments are decompressed while they
+   * are loaded.
    *
    * @param[in] index The sement index to load. This should be an index into
    *     the Program.segments list.
+   * @param[in] allocator The allocator to decompress a compressed segment
+   *     into. The returned buffer then lives as long as the allocation, and
+   *     freeing it does nothing. Unused for uncompressed segments.
    *
    * @returns The data as a FreeableBuffer, if the index is valid.
    * @retval Error::NotFound The program does not contain any segments or the
    *     index is out of range.
+   * @retval Error::NotSupported The segment is compressed, and `allocator` is
+   *     null or the compression is unknown.
+   * @retval Error::MemoryAllocationFailed `allocator` could not hold the
+   *     decompressed data.
+   * @retval Error::InvalidProgram The compressed data is corrupt.
    * @returns Other errors depending on the implementation of
    *     DataLoader: The Program.segment table is inconsistent, or the
    *     data cannot be accessed.
    */
-  __ET_NODISCARD Result<FreeableBuffer> LoadSegment(size_t index) const;
+  __ET_NODISCARD Result<FreeableBuffer> LoadSegment(
+      size_t index,
+      MemoryAllocator* allocator = nullptr) const;
+
+  /**
+   * Returns true if LoadSegment(index) returns a read-only mapping of the
+   * program file rather than a copy. See DataLoader::loads_mapped_data().
+   */
+  bool is_segment_mapped(size_t index) const;
+
+  /**
+   * Loads the data of a constant buffer from the constant segment. Only valid
+   * if `has_constant_segment()` is true.
+   *
+   * @param[in] buffer_index The index of the buffer, as referred to by
+   *     Tensor.constant_buffer_idx. Must be non-zero.
+   *
+   * @returns The buffer data. Its size may include padding that follows the
+   *     tensor data within the segment.
+   * @retval Error::InvalidArgument The index is out of range.
+   * @retval Error::InvalidProgram The constant segment table is inconsistent.
+   * @returns Other errors depending on the implementation of DataLoader.
+   */
+  __ET_NODISCARD Result<FreeableBuffer> LoadConstantSegmentBuffer(
+      size_t buffer_index) const;
+
+  /**
+   * Hints to the DataLoader that the segment will be loaded soon, so that it
+   * can start reading it in the background. Failures are not reported, since
+   * the later LoadSegment() call will report them.
+   *
+   * @param[in] index The segment index to prefetch. This should be an index
+   *     into the Program.segments list.
+   */
+  void PrefetchSegment(size_t index) const;
+
+  /**
+   * Like PrefetchSegment(), for the data that LoadConstantSegmentBuffer() will
+   * load for `buffer_index`.
+   */
+  void PrefetchConstantSegmentBuffer(size_t buffer_index) const;
+
+  /**
+   * Finds where the data of a constant buffer lives in the file.
+   *
+   * @param[in] buffer_index The index of the buffer, as referred to by
+   *     Tensor.constant_buffer_idx. Must be non-zero.
+   * @param[out] out_offset The offset of the data from the start of the file.
+   * @param[out] out_size The size of the data, which may include padding.
+   */
+  __ET_NODISCARD Error get_constant_segment_buffer_range(
+      size_t buffer_index,
+      size_t* out_offset,
+      size_t* out_size) const;
 
  private:
   Program(
       DataLoader* loader,
       size_t segment_base_offset,
+      size_t tensor_alignment,
       FreeableBuffer&& program_data,
       const executorch_flatbuffer::Program* internal_program)
       : program_data_(std::move(program_data)),
         // Don't need the loader if there are no segments.
         loader_(segment_base_offset > 0 ? loader : nullptr),
         internal_program_(internal_program),
-        segment_base_offset_(segment_base_offset) {}
+        segment_base_offset_(segment_base_offset),
+        tensor_alignment_(tensor_alignment) {}
 
   // Not copyable or assignable.
   Program(const Program& rhs) = delete;
@@ -279,6 +450,9 @@ class Program final {
   /// The offset to the first segment, in bytes. If zero, no segments should
   /// be present in internal_program_.
   size_t segment_base_offset_;
+
+  /// The guaranteed alignment of constant tensor data, or zero if unknown.
+  size_t tensor_alignment_;
 };
 
 } // namespace executor
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/segment_decompressor.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+namespace {
+
+/// The smallest match that the LZ4 block format can encode.
+constexpr size_t kMinMatchLength = 4;
+
+/// The token field value that means more length bytes follow.
+constexpr size_t kLengthContinues = 15;
+
+/**
+ * Reads a byte range of a DataLoader sequentially, holding at most one chunk
+ * of it in memory at a time.
+ */
+class ChunkReader final {
+ public:
+  ChunkReader(DataLoader* loader, size_t offset, size_t size)
+      : loader_(loader), next_offset_(offset), remaining_(size) {}
+
+  /// Returns true if every byte of the range has been read.
+  bool done() const {
+    return pos_ == chunk_.size() && remaining_ == 0;
+  }
+
+  /// Copies the next `size` bytes of the range into `out`.
+  __ET_NODISCARD Error read(uint8_t* out, size_t size) {
+    while (size > 0) {
+      if (pos_ == chunk_.size()) {
+        Error err = load_next_chunk();
+        if (err != Error::Ok) {
+          return err;
+        }
+      }
+      const size_t n = std::min(size, chunk_.size() - pos_);
+      std::memcpy(out, static_cast<const uint8_t*>(chunk_.data()) + pos_, n);
+      pos_ += n;
+      out += n;
+      size -= n;
+    }
+    return Error::Ok;
+  }
+
+ private:
+  __ET_NODISCARD Error load_next_chunk() {
+    ET_CHECK_OR_RETURN_ERROR(
+        remaining_ > 0, InvalidProgram, "LZ4 block is truncated");
+    const size_t size = std::min<size_t>(
+        remaining_, ET_SEGMENT_DECOMPRESSION_CHUNK_SIZE);
+    Result<FreeableBuffer> chunk = loader_->Load(next_offset_, size);
+    if (!chunk.ok()) {
+      return chunk.error();
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        chunk->size() == size,
+        InvalidState,
+        "Loaded %zu bytes at offset %zu, expected %zu",
+        chunk->size(),
+        next_offset_,
+        size);
+    // FreeableBuffer can't be move-assigned; destroying the old chunk frees
+    // it before the next one takes its place.
+    chunk_.~FreeableBuffer();
+    new (&chunk_) FreeableBuffer(std::move(chunk.get()));
+    pos_ = 0;
+    next_offset_ += size;
+    remaining_ -= size;
+    return Error::Ok;
+  }
+
+  DataLoader* loader_;
+  size_t next_offset_;
+  /// Bytes of the range that have not been loaded yet.
+  size_t remaining_;
+  FreeableBuffer chunk_;
+  /// Offset of the next unread byte in `chunk_`.
+  size_t pos_ = 0;
+};
+
+/**
+ * Adds the extra length bytes that follow a token field of 15 to `length`.
+ * Fails if the length grows past `limit`, which no valid block can exceed.
+ */
+__ET_NODISCARD Error
+read_length(ChunkReader& reader, size_t limit, size_t* length) {
+  if (*length != kLengthContinues) {
+    return Error::Ok;
+  }
+  uint8_t extra = 0;
+  do {
+    Error err = reader.read(&extra, 1);
+    if (err != Error::Ok) {
+      return err;
+    }
+    *length += extra;
+    ET_CHECK_OR_RETURN_ERROR(
+        *length <= limit, InvalidProgram, "LZ4 length overflows the output");
+  } while (extra == 255);
+  return Error::Ok;
+}
+
+} // namespace
+
+Error decompress_lz4_block(
+    DataLoader* loader,
+    size_t offset,
+    size_t compressed_size,
+    void* out,
+    size_t uncompressed_size) {
+  uint8_t* dst = static_cast<uint8_t*>(out);
+  size_t pos = 0;
+  ChunkReader reader(loader, offset, compressed_size);
+  // Each sequence is a token, literals, and a match that copies earlier
+  // output. The final sequence has no match.
+  while (!reader.done()) {
+    uint8_t token = 0;
+    Error err = reader.read(&token, 1);
+    if (err != Error::Ok) {
+      return err;
+    }
+
+    size_t num_literals = token >> 4;
+    err = read_length(reader, uncompressed_size, &num_literals);
+    if (err != Error::Ok) {
+      return err;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        num_literals <= uncompressed_size - pos,
+        InvalidProgram,
+        "LZ4 literals overflow the output at %zu",
+        pos);
+    err = reader.read(dst + pos, num_literals);
+    if (err != Error::Ok) {
+      return err;
+    }
+    pos += num_literals;
+    if (reader.done()) {
+      break;
+    }
+
+    uint8_t offset_bytes[2];
+    err = reader.read(offset_bytes, sizeof(offset_bytes));
+    if (err != Error::Ok) {
+      return err;
+    }
+    const size_t match_offset = offset_bytes[0] | (offset_bytes[1] << 8);
+    ET_CHECK_OR_RETURN_ERROR(
+        match_offset != 0 && match_offset <= pos,
+        InvalidProgram,
+        "Invalid LZ4 match offset %zu at %zu",
+        match_offset,
+        pos);
+    size_t match_length = token & 0xF;
+    err = read_length(reader, uncompressed_size, &match_length);
+    if (err != Error::Ok) {
+      return err;
+    }
+    match_length += kMinMatchLength;
+    ET_CHECK_OR_RETURN_ERROR(
+        match_length <= uncompressed_size - pos,
+        InvalidProgram,
+        "LZ4 match overflows the output at %zu",
+        pos);
+    // The match may overlap the bytes it produces, e.g. to repeat a short
+    // pattern, so it must be copied forward one byte at a time.
+    const uint8_t* src = dst + pos - match_offset;
+    for (size_t i = 0; i < match_length; ++i) {
+      dst[pos + i] = src[i];
+    }
+    pos += match_length;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      pos == uncompressed_size,
+      InvalidProgram,
+      "LZ4 block decompressed to %zu bytes, expected %zu",
+      pos,
+      uncompressed_size);
+  return Error::Ok;
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
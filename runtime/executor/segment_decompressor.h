@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/compiler.h>
+
+/*
+ * The number of bytes of compressed data that decompress_lz4_block() loads
+ * from the DataLoader at a time. Only one chunk is loaded at once, so this
+ * bounds the extra memory that decompression needs. Override with
+ * -DET_SEGMENT_DECOMPRESSION_CHUNK_SIZE=<n> on the compile line.
+ */
+#ifndef ET_SEGMENT_DECOMPRESSION_CHUNK_SIZE
+#define ET_SEGMENT_DECOMPRESSION_CHUNK_SIZE (16 * 1024)
+#endif
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+/**
+ * Decompresses a single LZ4 block, as written by the LZ4 block format (no frame
+ * header or checksums), into a caller-provided buffer.
+ *
+ * The compressed data is streamed through `loader` in chunks of
+ * ET_SEGMENT_DECOMPRESSION_CHUNK_SIZE bytes, so the whole compressed block
+ * never needs to be in memory at once. Works with any DataLoader.
+ *
+ * @param[in] loader The loader to read the compressed data from.
+ * @param[in] offset The offset of the compressed data in the loader.
+ * @param[in] compressed_size The size of the compressed data in bytes.
+ * @param[out] out Where to write the decompressed data.
+ * @param[in] uncompressed_size The size of `out` in bytes. The block must
+ *     decompress to exactly this many bytes.
+ *
+ * @retval Error::Ok `out` holds the decompressed data.
+ * @retval Error::InvalidProgram The data is not a valid LZ4 block, or
+ *     decompresses to a different size.
+ * @returns Other errors from `loader`.
+ */
+__ET_NODISCARD Error decompress_lz4_block(
+    DataLoader* loader,
+    size_t offset,
+    size_t compressed_size,
+    void* out,
+    size_t uncompressed_size);
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
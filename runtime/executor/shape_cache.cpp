@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/shape_cache.h>
+
+#include <cstring>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+namespace {
+
+uint32_t hash_shape(
+    const exec_aten::SizesType* sizes,
+    const exec_aten::DimOrderType* dim_order,
+    size_t dim) {
+  // 32-bit FNV-1a over the bytes of the sizes and the dim order.
+  uint32_t hash = 2166136261u;
+  const auto* bytes = reinterpret_cast<const uint8_t*>(sizes);
+  for (size_t i = 0; i < dim * sizeof(*sizes); ++i) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  bytes = reinterpret_cast<const uint8_t*>(dim_order);
+  for (size_t i = 0; i < dim * sizeof(*dim_order); ++i) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+} // namespace
+
+const ShapeCache::Shape* ShapeCache::find(
+    const exec_aten::SizesType* sizes,
+    const exec_aten::DimOrderType* dim_order,
+    size_t dim) const {
+  const uint32_t hash = hash_shape(sizes, dim_order, dim);
+  for (size_t i = 0; i < num_entries_; ++i) {
+    const Entry& e = entries_[i];
+    if (e.hash == hash && e.dim == dim &&
+        std::memcmp(e.shape.sizes, sizes, dim * sizeof(*sizes)) == 0 &&
+        std::memcmp(
+            e.shape.dim_order, dim_order, dim * sizeof(*dim_order)) == 0) {
+      return &e.shape;
+    }
+  }
+  return nullptr;
+}
+
+void ShapeCache::insert(const Shape& shape, size_t dim) {
+  if (num_entries_ >= kNumEntries) {
+    return;
+  }
+  Entry& e = entries_[num_entries_++];
+  e.hash = hash_shape(shape.sizes, shape.dim_order, dim);
+  e.dim = static_cast<uint32_t>(dim);
+  e.shape = shape;
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
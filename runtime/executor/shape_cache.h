@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+/*
+ * The number of distinct static tensor shapes whose metadata Method::init()
+ * shares between the tensors of a method. Targets with tight stack budgets can
+ * shrink it by passing -DET_SHAPE_CACHE_SIZE=<n> on the compile line; 0
+ * disables the cache.
+ */
+#ifndef ET_SHAPE_CACHE_SIZE
+#define ET_SHAPE_CACHE_SIZE 64
+#endif
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+/**
+ * Interns the sizes, dim order and strides of static-shape tensors, so that
+ * tensors of the same shape point at one copy of them. That saves computing
+ * and allocating the strides of every tensor, and makes the metadata of a
+ * method's tensors take fewer cache lines.
+ *
+ * Only the metadata of static tensors may be shared, since it is never written
+ * to. The cache holds pointers into the Program and into the method allocator,
+ * so it must not outlive either. It is not thread-safe.
+ */
+class ShapeCache final {
+ public:
+  /// Maximum number of cached shapes.
+  static constexpr size_t kNumEntries = ET_SHAPE_CACHE_SIZE;
+
+  /// The metadata of one shape.
+  struct Shape {
+    const exec_aten::SizesType* sizes;
+    const exec_aten::DimOrderType* dim_order;
+    const exec_aten::StridesType* strides;
+  };
+
+  ShapeCache() = default;
+
+  /**
+   * Looks up a shape by the contents of its sizes and dim order, which both
+   * have `dim` entries.
+   *
+   * @returns The cached shape, or nullptr if there is none.
+   */
+  const Shape* find(
+      const exec_aten::SizesType* sizes,
+      const exec_aten::DimOrderType* dim_order,
+      size_t dim) const;
+
+  /// Records a shape with `dim` dimensions. Silently drops it if the cache is
+  /// full.
+  void insert(const Shape& shape, size_t dim);
+
+ private:
+  struct Entry {
+    uint32_t hash;
+    uint32_t dim;
+    Shape shape;
+  };
+
+  // Keep a one-element array when the cache is disabled so that the class is
+  // still well-formed.
+  Entry entries_[kNumEntries > 0 ? kNumEntries : 1];
+  size_t num_entries_ = 0;
+};
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
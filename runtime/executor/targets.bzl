@@ -42,6 +42,51 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "chain_executor",
+        exported_headers = [
+            "chain_executor.h",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "delegate_selector",
+        exported_headers = [
+            "delegate_selector.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+            "//executorch/runtime/platform:platform",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "segment_decompressor",
+        srcs = [
+            "segment_decompressor.cpp",
+        ],
+        exported_headers = [
+            "segment_decompressor.h",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+        visibility = [
+            "//executorch/runtime/executor/...",
+        ],
+    )
+
     for aten_mode in (True, False):
         aten_suffix = "_aten" if aten_mode else ""
 
@@ -50,16 +95,25 @@ def define_common_targets():
             srcs = [
                 "method.cpp",
                 "method_meta.cpp",
+                "method_pool.cpp",
+                "operator_cache.cpp",
                 "program.cpp",
+                "shape_cache.cpp",
                 "tensor_parser_exec_aten.cpp",
                 "tensor_parser{}.cpp".format(aten_suffix if aten_mode else "_portable"),
+                "weight_streamer.cpp",
             ],
             headers = [
+                "load_event_scope.h",
+                "operator_cache.h",
+                "shape_cache.h",
                 "tensor_parser.h",
+                "weight_streamer.h",
             ],
             exported_headers = [
                 "method.h",
                 "method_meta.h",
+                "method_pool.h",
                 "program.h",
             ],
             deps = [
@@ -71,10 +125,12 @@ def define_common_targets():
                 "//executorch/runtime/core:core",
                 "//executorch/runtime/kernel:kernel_runtime_context" + aten_suffix,
                 "//executorch/runtime/kernel:operator_registry",
+                "//executorch/runtime/kernel:thread_parallel_interface",
                 "//executorch/runtime/platform:platform",
                 "//executorch/schema:extended_header",
                 "//executorch/schema:program",
                 ":memory_manager",
+                ":segment_decompressor",
             ],
             preprocessor_flags = _program_preprocessor_flags(),
             exported_deps = [
@@ -82,6 +138,8 @@ def define_common_targets():
                 "//executorch/runtime/core:core",
                 "//executorch/runtime/core:evalue" + aten_suffix,
                 "//executorch/runtime/platform:platform",
+                ":chain_executor",
+                ":delegate_selector",
                 ":memory_manager",
             ],
             visibility = [
@@ -12,16 +12,31 @@
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/shape_cache.h>
 #include <executorch/schema/program_generated.h>
 
 namespace torch {
 namespace executor {
 namespace deserialization {
 
+/**
+ * Deserializes `s_tensor`.
+ *
+ * @param[in] program The Program to use for constant buffer data.
+ * @param[in] memory_manager The source of memory for the tensor.
+ * @param[in] s_tensor The tensor to deserialize.
+ * @param[in] constant_data If non-null, the already-loaded data of a constant
+ *     tensor, used instead of looking it up in the program's constant_buffer
+ *     table. Must outlive the returned tensor.
+ * @param[in] shape_cache If non-null, static-shape tensors share their sizes,
+ *     dim order and strides with earlier tensors of the same shape through it.
+ */
 __ET_NODISCARD Result<exec_aten::Tensor> parseTensor(
     const Program* program,
     MemoryManager* memory_manager,
-    const executorch_flatbuffer::Tensor* s_tensor);
+    const executorch_flatbuffer::Tensor* s_tensor,
+    const FreeableBuffer* constant_data = nullptr,
+    internal::ShapeCache* shape_cache = nullptr);
 
 __ET_NODISCARD Result<BoxedEvalueList<exec_aten::Tensor>> parseTensorList(
     const flatbuffers::Vector<int32_t>* tensor_indices,
@@ -83,11 +98,15 @@ parseListOptionalType(
  * - constant_buffer > 0, allocation_info = Null: Constant Tensor.
  * - constant_buffer = 0, allocation_info = Non Null: Non-constant Tensor.
  * - constant_buffer = 0, allocation_info = Null: Input/placeholder Tensor.
+ * - constant_buffer > 0, allocation_info = Non Null: Mutable state Tensor,
+ *   planned like a non-constant and initialized from the constant buffer.
  *
  * @param[in] s_tensor The tensor to find the data pointer for.
  * @param[in] program The Program to use for constant buffer data.
  * @param[in] nbytes The amount of memory to get from the allocator.
  * @param[in] allocator The source of memory for non-constant tensors.
+ * @param[in] constant_data If non-null, the already-loaded data of a constant
+ *     tensor; see `parseTensor()`.
  *
  * @returns On success, the data pointer to use for the tensor. On failure, a
  *     non-Ok Error.
@@ -96,7 +115,8 @@ __ET_NODISCARD Result<void*> getTensorDataPtr(
     const executorch_flatbuffer::Tensor* s_tensor,
     const Program* program,
     size_t nbytes,
-    HierarchicalAllocator* allocator);
+    HierarchicalAllocator* allocator,
+    const FreeableBuffer* constant_data = nullptr);
 
 } // namespace deserialization
 } // namespace executor
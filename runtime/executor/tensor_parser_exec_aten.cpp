@@ -8,6 +8,9 @@
 
 #include <executorch/runtime/executor/tensor_parser.h>
 
+#include <cinttypes>
+#include <cstring>
+
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
@@ -53,7 +56,53 @@ __ET_NODISCARD Result<void*> getTensorDataPtr(
     const executorch_flatbuffer::Tensor* s_tensor,
     const Program* program,
     size_t nbytes,
-    HierarchicalAllocator* allocator) {
+    HierarchicalAllocator* allocator,
+    const FreeableBuffer* constant_data) {
+  const executorch_flatbuffer::AllocationDetails* allocation_info =
+      s_tensor->allocation_info();
+  if (s_tensor->constant_buffer_idx() > 0 && allocation_info != nullptr) {
+    // Mutable state. Its planned memory outlives each execution, so the
+    // initial value is only copied in here, when the method is loaded.
+    const uint32_t memory_id = allocation_info->memory_id() - 1;
+    Result<void*> data_ptr = allocator->get_offset_address(
+        memory_id, allocation_info->memory_offset(), nbytes);
+    if (!data_ptr.ok()) {
+      return data_ptr.error();
+    }
+    const void* initial_data = nullptr;
+    if (constant_data != nullptr) {
+      ET_CHECK_OR_RETURN_ERROR(
+          nbytes <= constant_data->size(),
+          InvalidProgram,
+          "Constant buffer %" PRIu32 " holds %zu bytes, tensor needs %zu",
+          s_tensor->constant_buffer_idx(),
+          constant_data->size(),
+          nbytes);
+      initial_data = constant_data->data();
+    } else {
+      auto data =
+          program->get_constant_buffer_data(s_tensor->constant_buffer_idx());
+      if (!data.ok()) {
+        return data.error();
+      }
+      initial_data = data.get();
+    }
+    if (nbytes > 0) {
+      std::memcpy(data_ptr.get(), initial_data, nbytes);
+    }
+    return data_ptr.get();
+  }
+  if (s_tensor->constant_buffer_idx() > 0 && constant_data != nullptr) {
+    ET_CHECK_OR_RETURN_ERROR(
+        nbytes <= constant_data->size(),
+        InvalidProgram,
+        "Constant buffer %" PRIu32 " holds %zu bytes, tensor needs %zu",
+        s_tensor->constant_buffer_idx(),
+        constant_data->size(),
+        nbytes);
+    // The data is loaded read-only; see the const_cast note below.
+    return const_cast<void*>(constant_data->data());
+  }
   if (s_tensor->constant_buffer_idx() > 0) {
     auto data =
         program->get_constant_buffer_data(s_tensor->constant_buffer_idx());
@@ -65,8 +114,6 @@ __ET_NODISCARD Result<void*> getTensorDataPtr(
     return const_cast<void*>(data.get());
   }
 
-  const executorch_flatbuffer::AllocationDetails* allocation_info =
-      s_tensor->allocation_info();
   if (allocation_info != nullptr) {
     // Normal non-constant Tensor. Allocate data using mem_id and offset.
 
@@ -23,7 +23,9 @@ namespace deserialization {
 Result<torch::executor::Tensor> parseTensor(
     const Program* program,
     MemoryManager* memory_manager,
-    const executorch_flatbuffer::Tensor* s_tensor) {
+    const executorch_flatbuffer::Tensor* s_tensor,
+    const FreeableBuffer* constant_data,
+    internal::ShapeCache* shape_cache) {
   EXECUTORCH_SCOPE_PROF("TensorParser::parseTensor");
   auto method_allocator = memory_manager->method_allocator();
 
@@ -33,57 +35,74 @@ Result<torch::executor::Tensor> parseTensor(
       "Non-zero storage offset %" PRId32 " not supported",
       s_tensor->storage_offset());
 
+  // For DYNAMIC_UNBOUND tensors the serialized sizes are only the initial
+  // shape, and any planned memory is sized for it. Kernels that resize them
+  // beyond it through KernelRuntimeContext::resize_tensor() move them to
+  // storage from the Method's dynamic allocator.
   TensorShapeDynamism dynamism =
       static_cast<TensorShapeDynamism>(s_tensor->shape_dynamism());
-  // TODO(T133200526): Remove this check once fully dynamic shapes are
-  // supported.
-  ET_CHECK_OR_RETURN_ERROR(
-      dynamism != TensorShapeDynamism::DYNAMIC_UNBOUND,
-      NotSupported,
-      "Fully dynamic tensor shapes not yet supported: T133200526");
 
   exec_aten::SizesType* sizes = nullptr;
   exec_aten::DimOrderType* dim_order = nullptr;
+  exec_aten::StridesType* strides = nullptr;
   const auto dim = s_tensor->sizes()->size();
   const auto serialized_sizes = s_tensor->sizes()->data();
   const auto serialized_dim_order = s_tensor->dim_order()->data();
-  // For dynamic shape tensors, allocate local buffers to allow mutable sizes
-  // and strides
-  if (dynamism != TensorShapeDynamism::STATIC) {
-    // copy sizes and dim order out of flatbuffer
-    // kimishpate: I think dim order can remain immutable and point to fb
-    // memory, unless we plan to implement in-place permute
-    exec_aten::SizesType* sizes_buf = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-        method_allocator, exec_aten::SizesType, dim);
-    exec_aten::DimOrderType* dim_order_buf = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-        method_allocator, exec_aten::DimOrderType, dim);
-    std::memcpy(
-        sizes_buf, serialized_sizes, sizeof(exec_aten::SizesType) * dim);
-    std::memcpy(
-        dim_order_buf,
-        serialized_dim_order,
-        sizeof(exec_aten::DimOrderType) * dim);
-
-    sizes = sizes_buf;
-    dim_order = dim_order_buf;
+  // The metadata of static tensors is never written to, so tensors of the
+  // same shape can share it.
+  const internal::ShapeCache::Shape* shared = nullptr;
+  if (dynamism == TensorShapeDynamism::STATIC && shape_cache != nullptr) {
+    shared = shape_cache->find(serialized_sizes, serialized_dim_order, dim);
+  }
+  if (shared != nullptr) {
+    // Const casts safe here as these tensors can't be resized, so these
+    // fields will not be modified.
+    sizes = const_cast<exec_aten::SizesType*>(shared->sizes);
+    dim_order = const_cast<exec_aten::DimOrderType*>(shared->dim_order);
+    strides = const_cast<exec_aten::StridesType*>(shared->strides);
   } else {
-    // Const cast safe here as these tensors can't be resized, so these fields
-    // will not be modified.
-    sizes = const_cast<exec_aten::SizesType*>(serialized_sizes);
-    dim_order = const_cast<exec_aten::DimOrderType*>(serialized_dim_order);
+    // For dynamic shape tensors, allocate local buffers to allow mutable
+    // sizes and strides
+    if (dynamism != TensorShapeDynamism::STATIC) {
+      // copy sizes and dim order out of flatbuffer
+      // kimishpate: I think dim order can remain immutable and point to fb
+      // memory, unless we plan to implement in-place permute
+      exec_aten::SizesType* sizes_buf = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+          method_allocator, exec_aten::SizesType, dim);
+      exec_aten::DimOrderType* dim_order_buf =
+          ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+              method_allocator, exec_aten::DimOrderType, dim);
+      std::memcpy(
+          sizes_buf, serialized_sizes, sizeof(exec_aten::SizesType) * dim);
+      std::memcpy(
+          dim_order_buf,
+          serialized_dim_order,
+          sizeof(exec_aten::DimOrderType) * dim);
+
+      sizes = sizes_buf;
+      dim_order = dim_order_buf;
+    } else {
+      // Const cast safe here as these tensors can't be resized, so these
+      // fields will not be modified.
+      sizes = const_cast<exec_aten::SizesType*>(serialized_sizes);
+      dim_order = const_cast<exec_aten::DimOrderType*>(serialized_dim_order);
+    }
+    // We will remove strides from schema.
+    // Allocating strides buffer here and populating it.
+    // In subsequent diffs we can remove strides accessor, however this
+    // will introduce incompatible APIs between ATen Tensor and ETensor.
+    strides = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+        method_allocator, exec_aten::StridesType, dim);
+    auto status =
+        torch::executor::dim_order_to_stride(sizes, dim_order, dim, strides);
+    ET_CHECK_OR_RETURN_ERROR(
+        status == Error::Ok,
+        Internal,
+        "dim_order_to_stride returned invalid status");
+    if (dynamism == TensorShapeDynamism::STATIC && shape_cache != nullptr) {
+      shape_cache->insert({sizes, dim_order, strides}, dim);
+    }
   }
-  // We will remove strides from schema.
-  // Allocating strides buffer here and populating it.
-  // In subsequent diffs we can remove strides accessor, however this
-  // will introduce incompatible APIs between ATen Tensor and ETensor.
-  exec_aten::StridesType* strides = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-      method_allocator, exec_aten::StridesType, dim);
-  auto status =
-      torch::executor::dim_order_to_stride(sizes, dim_order, dim, strides);
-  ET_CHECK_OR_RETURN_ERROR(
-      status == Error::Ok,
-      Internal,
-      "dim_order_to_stride returned invalid status");
 
   auto* tensor_impl = ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(
       method_allocator, torch::executor::TensorImpl);
@@ -103,7 +122,8 @@ Result<torch::executor::Tensor> parseTensor(
       s_tensor,
       program,
       tensor_impl->nbytes(),
-      memory_manager->planned_memory());
+      memory_manager->planned_memory(),
+      constant_data);
   if (!data_ptr.ok()) {
     ET_LOG(
         Error,
@@ -8,12 +8,17 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include <executorch/extension/data_loader/buffer_data_loader.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/data_loader/mmap_data_loader.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/result.h>
@@ -34,16 +39,20 @@ using torch::executor::BackendInitContext;
 using torch::executor::CompileSpec;
 using torch::executor::DataLoader;
 using torch::executor::DelegateHandle;
+using torch::executor::DelegateSelector;
 using torch::executor::Error;
 using torch::executor::EValue;
 using torch::executor::FreeableBuffer;
 using torch::executor::MemoryAllocator;
 using torch::executor::Method;
+using torch::executor::MethodMemoryStats;
+using torch::executor::MethodMeta;
 using torch::executor::Program;
 using torch::executor::PyTorchBackendInterface;
 using torch::executor::Result;
 using torch::executor::testing::ManagedMemoryManager;
 using torch::executor::util::FileDataLoader;
+using torch::executor::util::MmapDataLoader;
 
 /**
  * A backend class whose methods can be overridden individually.
@@ -56,8 +65,16 @@ class StubBackend final : public PyTorchBackendInterface {
       FreeableBuffer*,
       ArrayRef<CompileSpec>,
       MemoryAllocator*)>;
-  using ExecuteFn = std::function<Error(DelegateHandle*, EValue**)>;
+  using ExecuteFn = std::function<
+      Error(BackendExecutionContext&, DelegateHandle*, EValue**)>;
   using DestroyFn = std::function<void(DelegateHandle*)>;
+  using BindFn = std::function<Error(DelegateHandle*, EValue**)>;
+  using GetMemoryUsageFn = std::function<Result<size_t>(DelegateHandle*)>;
+  using GetConstantNbytesFn =
+      std::function<Result<size_t>(DelegateHandle*, const char*)>;
+  using UpdateConstantFn = std::function<
+      Error(DelegateHandle*, const char*, const void*, size_t)>;
+  using PrepareFn = std::function<Error(DelegateHandle*)>;
 
   // Default name that this backend is registered as.
   static constexpr char kName[] = "StubBackend";
@@ -82,6 +99,7 @@ class StubBackend final : public PyTorchBackendInterface {
       BackendInitContext& context,
       FreeableBuffer* processed,
       ArrayRef<CompileSpec> compile_specs) const override {
+    last_init_processed_is_mapped_ = context.is_processed_mapped();
     if (init_fn_) {
       return init_fn_.value()(
           processed, compile_specs, context.get_runtime_allocator());
@@ -90,21 +108,115 @@ class StubBackend final : public PyTorchBackendInterface {
     return nullptr;
   }
 
+  /**
+   * Returns the BackendInitContext::is_processed_mapped() value that the most
+   * recent init() call saw.
+   */
+  bool last_init_processed_is_mapped() const {
+    return last_init_processed_is_mapped_;
+  }
+
+  void set_init_thread_safe(bool thread_safe) {
+    init_thread_safe_ = thread_safe;
+  }
+
+  bool is_init_thread_safe() const override {
+    return init_thread_safe_;
+  }
+
   void install_execute(ExecuteFn fn) {
     execute_fn_ = fn;
   }
 
   Error execute(
-      __ET_UNUSED BackendExecutionContext& context,
+      BackendExecutionContext& context,
       DelegateHandle* handle,
       EValue** args) const override {
     if (execute_fn_) {
-      return execute_fn_.value()(handle, args);
+      return execute_fn_.value()(context, handle, args);
     }
     // Return a benign value otherwise.
     return Error::Ok;
   }
 
+  /**
+   * Makes the backend support binding. execute_bound() then calls the
+   * installed execute() with the args of the most recent bind().
+   */
+  void install_bind(BindFn fn) {
+    bind_fn_ = fn;
+  }
+
+  bool supports_binding() const override {
+    return bind_fn_.has_value();
+  }
+
+  Error bind(DelegateHandle* handle, EValue** args) const override {
+    Error err = bind_fn_.value()(handle, args);
+    bound_args_ = err == Error::Ok ? args : nullptr;
+    return err;
+  }
+
+  Error execute_bound(BackendExecutionContext& context, DelegateHandle* handle)
+      const override {
+    ++execute_bound_calls_;
+    return execute(context, handle, bound_args_);
+  }
+
+  /// Returns the number of execute_bound() calls since reset().
+  size_t execute_bound_calls() const {
+    return execute_bound_calls_;
+  }
+
+  void install_get_memory_usage(GetMemoryUsageFn fn) {
+    get_memory_usage_fn_ = fn;
+  }
+
+  Result<size_t> get_memory_usage(DelegateHandle* handle) const override {
+    if (get_memory_usage_fn_) {
+      return get_memory_usage_fn_.value()(handle);
+    }
+    return Error::NotSupported;
+  }
+
+  void install_get_constant_nbytes(GetConstantNbytesFn fn) {
+    get_constant_nbytes_fn_ = fn;
+  }
+
+  Result<size_t> get_constant_nbytes(DelegateHandle* handle, const char* name)
+      const override {
+    if (get_constant_nbytes_fn_) {
+      return get_constant_nbytes_fn_.value()(handle, name);
+    }
+    return Error::NotSupported;
+  }
+
+  void install_update_constant(UpdateConstantFn fn) {
+    update_constant_fn_ = fn;
+  }
+
+  Error update_constant(
+      DelegateHandle* handle,
+      const char* name,
+      const void* data,
+      size_t nbytes) const override {
+    if (update_constant_fn_) {
+      return update_constant_fn_.value()(handle, name, data, nbytes);
+    }
+    return Error::NotSupported;
+  }
+
+  void install_prepare(PrepareFn fn) {
+    prepare_fn_ = fn;
+  }
+
+  Error prepare(DelegateHandle* handle) const override {
+    if (prepare_fn_) {
+      return prepare_fn_.value()(handle);
+    }
+    return Error::Ok;
+  }
+
   void install_destroy(DestroyFn fn) {
     destroy_fn_ = fn;
   }
@@ -123,6 +235,15 @@ class StubBackend final : public PyTorchBackendInterface {
     init_fn_.reset();
     execute_fn_.reset();
     destroy_fn_.reset();
+    bind_fn_.reset();
+    get_memory_usage_fn_.reset();
+    get_constant_nbytes_fn_.reset();
+    update_constant_fn_.reset();
+    prepare_fn_.reset();
+    bound_args_ = nullptr;
+    execute_bound_calls_ = 0;
+    init_thread_safe_ = false;
+    last_init_processed_is_mapped_ = false;
   }
 
   /**
@@ -155,6 +276,15 @@ class StubBackend final : public PyTorchBackendInterface {
   std::optional<InitFn> init_fn_;
   std::optional<ExecuteFn> execute_fn_;
   std::optional<DestroyFn> destroy_fn_;
+  std::optional<BindFn> bind_fn_;
+  std::optional<GetMemoryUsageFn> get_memory_usage_fn_;
+  std::optional<GetConstantNbytesFn> get_constant_nbytes_fn_;
+  std::optional<UpdateConstantFn> update_constant_fn_;
+  std::optional<PrepareFn> prepare_fn_;
+  mutable EValue** bound_args_ = nullptr;
+  mutable size_t execute_bound_calls_ = 0;
+  bool init_thread_safe_ = false;
+  mutable bool last_init_processed_is_mapped_ = false;
 };
 
 bool StubBackend::registered_ = false;
@@ -168,10 +298,10 @@ class DataLoaderSpy : public DataLoader {
  public:
   /// A record of an operation performed on this DataLoader.
   struct Operation {
-    enum { Load, Free } op;
-    size_t offset; // Set for Load; zero for Free.
-    void* data; // Set for Free; nullptr for Load.
-    size_t size; // Set for Load and Free.
+    enum { Load, Prefetch, Free } op;
+    size_t offset; // Set for Load and Prefetch; zero for Free.
+    void* data; // Set for Free; nullptr for Load and Prefetch.
+    size_t size; // Set for Load, Prefetch and Free.
   };
 
   explicit DataLoaderSpy(DataLoader* delegate) : delegate_(delegate) {}
@@ -188,6 +318,16 @@ class DataLoaderSpy : public DataLoader {
         context->buffer.data(), context->buffer.size(), FreeBuffer, context);
   }
 
+  Error Prefetch(size_t offset, size_t size) override {
+    operations_.push_back(
+        {Operation::Prefetch, offset, /*data=*/nullptr, size});
+    return delegate_->Prefetch(offset, size);
+  }
+
+  bool loads_mapped_data() const override {
+    return delegate_->loads_mapped_data();
+  }
+
   Result<size_t> size() const override {
     return delegate_->size();
   }
@@ -348,6 +488,115 @@ TEST_P(BackendIntegrationTest, FreeingProcessedBufferSucceeds) {
   }
 }
 
+TEST_P(BackendIntegrationTest, ThreadSafeInitFailureIsReported) {
+  StubBackend::singleton().set_init_thread_safe(true);
+  size_t init_calls = 0;
+  StubBackend::singleton().install_init(
+      [&](__ET_UNUSED FreeableBuffer* processed,
+          __ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          __ET_UNUSED MemoryAllocator* runtime_allocator)
+          -> Result<DelegateHandle*> {
+        ++init_calls;
+        return Error::InvalidProgram;
+      });
+  size_t destroy_calls = 0;
+  StubBackend::singleton().install_destroy(
+      [&](__ET_UNUSED DelegateHandle* handle) { ++destroy_calls; });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method_res = program->load_method("forward", &mmm.get());
+
+  // The error of the failed delegate is returned, and since its init() did
+  // not succeed, the backend is not asked to destroy it.
+  EXPECT_EQ(method_res.error(), Error::InvalidProgram);
+  EXPECT_EQ(init_calls, 1);
+  EXPECT_EQ(destroy_calls, 0);
+}
+
+TEST_P(BackendIntegrationTest, ProcessedIsMappedOnlyForMappedSegments) {
+  // FileDataLoader copies segments into RAM.
+  {
+    Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+    ASSERT_EQ(loader.error(), Error::Ok);
+    Result<Program> program = Program::load(&loader.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method_res = program->load_method("forward", &mmm.get());
+    ASSERT_EQ(method_res.error(), Error::Ok);
+    EXPECT_FALSE(StubBackend::singleton().last_init_processed_is_mapped());
+  }
+
+  // MmapDataLoader maps them, but inline data lives in the program's buffer.
+  {
+    Result<MmapDataLoader> loader = MmapDataLoader::from(
+        program_path(), MmapDataLoader::MlockConfig::NoMlock);
+    ASSERT_EQ(loader.error(), Error::Ok);
+    Result<Program> program = Program::load(&loader.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method_res = program->load_method("forward", &mmm.get());
+    ASSERT_EQ(method_res.error(), Error::Ok);
+    EXPECT_EQ(
+        StubBackend::singleton().last_init_processed_is_mapped(),
+        using_segments());
+  }
+}
+
+TEST_P(BackendIntegrationTest, SegmentsArePrefetchedBeforeLoading) {
+  size_t processed_size = 0;
+  StubBackend::singleton().install_init(
+      [&](FreeableBuffer* processed,
+          __ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          __ET_UNUSED MemoryAllocator* runtime_allocator)
+          -> Result<DelegateHandle*> {
+        processed_size = processed->size();
+        return nullptr;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  DataLoaderSpy spy_loader(&loader.get());
+
+  Result<Program> program = Program::load(&spy_loader);
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method_res = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method_res.error(), Error::Ok);
+
+  // Find the load of the processed data, and the prefetch of the same range.
+  const auto& ops = spy_loader.operations();
+  size_t load_index = ops.size();
+  size_t prefetch_index = ops.size();
+  for (size_t i = 0; i < ops.size(); ++i) {
+    if (ops[i].op == DataLoaderSpy::Operation::Load &&
+        ops[i].size == processed_size && load_index == ops.size()) {
+      load_index = i;
+    }
+  }
+  for (size_t i = 0; i < ops.size(); ++i) {
+    if (ops[i].op == DataLoaderSpy::Operation::Prefetch &&
+        load_index < ops.size() && ops[i].offset == ops[load_index].offset &&
+        ops[i].size == processed_size) {
+      prefetch_index = i;
+    }
+  }
+  if (using_segments()) {
+    // The segment was hinted to the loader before it was loaded.
+    ASSERT_LT(load_index, ops.size());
+    ASSERT_LT(prefetch_index, ops.size());
+    EXPECT_LT(prefetch_index, load_index);
+  } else {
+    // The processed data is inline, so nothing is prefetched.
+    for (const auto& op : ops) {
+      EXPECT_FALSE(op.op == DataLoaderSpy::Operation::Prefetch);
+    }
+  }
+}
+
 TEST_P(BackendIntegrationTest, EndToEndTestWithProcessedAsHandle) {
   // Install an init() implementation that does not free its processed buffer,
   // and returns the FreeableBuffer as the delegate handle.
@@ -365,7 +614,9 @@ TEST_P(BackendIntegrationTest, EndToEndTestWithProcessedAsHandle) {
   // FreeableBuffer.
   DelegateHandle* execute_handle = nullptr;
   StubBackend::singleton().install_execute(
-      [&](DelegateHandle* handle, __ET_UNUSED EValue** args) -> Error {
+      [&](__ET_UNUSED BackendExecutionContext& context,
+          DelegateHandle* handle,
+          __ET_UNUSED EValue** args) -> Error {
         execute_handle = handle;
         auto* processed = reinterpret_cast<FreeableBuffer*>(handle);
 
@@ -444,6 +695,309 @@ TEST_P(BackendIntegrationTest, EndToEndTestWithProcessedAsHandle) {
   EXPECT_EQ(execute_handle, destroy_handle);
 }
 
+TEST_P(BackendIntegrationTest, ExecuteAsyncResumesAfterCompletion) {
+  // Install an execute() that completes asynchronously whenever the caller
+  // allows it, holding on to the completion like a real backend would.
+  torch::executor::BackendCompletion pending_completion;
+  size_t num_sync_calls = 0;
+  StubBackend::singleton().install_execute(
+      [&](BackendExecutionContext& context,
+          __ET_UNUSED DelegateHandle* handle,
+          __ET_UNUSED EValue** args) -> Error {
+        if (!context.can_complete_async()) {
+          num_sync_calls++;
+          return Error::Ok;
+        }
+        pending_completion = context.completion();
+        return Error::Pending;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+
+  struct Completion {
+    size_t num_calls = 0;
+    Error status = Error::Internal;
+  } completion;
+  auto on_complete = [](void* context, Error status) {
+    auto* c = static_cast<Completion*>(context);
+    c->num_calls++;
+    c->status = status;
+  };
+
+  // Runs until the delegate call, then suspends.
+  Error err = method->execute_async(on_complete, &completion);
+  ASSERT_EQ(err, Error::Pending);
+  ASSERT_TRUE(pending_completion.valid());
+
+  // Synchronous execution is rejected while suspended.
+  EXPECT_EQ(method->execute(), Error::InvalidState);
+  EXPECT_EQ(
+      method->execute_async(on_complete, &completion), Error::InvalidState);
+
+  // Complete every pending delegate call until the method finishes.
+  size_t num_pending = 0;
+  while (err == Error::Pending) {
+    num_pending++;
+    pending_completion.complete(Error::Ok);
+    EXPECT_EQ(completion.num_calls, num_pending);
+    err = method->resume_async(completion.status);
+  }
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_EQ(num_sync_calls, 0);
+
+  // Nothing left to resume.
+  EXPECT_EQ(method->resume_async(Error::Ok), Error::InvalidState);
+
+  // An asynchronous failure is reported by resume_async(), and the method can
+  // then run again from the start, synchronously this time.
+  ASSERT_EQ(method->execute_async(on_complete, &completion), Error::Pending);
+  pending_completion.complete(Error::Internal);
+  EXPECT_EQ(method->resume_async(completion.status), Error::Internal);
+  EXPECT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(num_sync_calls, num_pending);
+
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_P(BackendIntegrationTest, BoundArgsAreOnlyBoundWhenChanged) {
+  size_t bind_calls = 0;
+  Error bind_error = Error::Ok;
+  StubBackend::singleton().install_bind(
+      [&](__ET_UNUSED DelegateHandle* handle,
+          __ET_UNUSED EValue** args) -> Error {
+        ++bind_calls;
+        return bind_error;
+      });
+  size_t execute_calls = 0;
+  StubBackend::singleton().install_execute(
+      [&](__ET_UNUSED BackendExecutionContext& context,
+          __ET_UNUSED DelegateHandle* handle,
+          EValue** args) -> Error {
+        // execute_bound() passes the args that were bound.
+        EXPECT_NE(args, nullptr);
+        ++execute_calls;
+        return Error::Ok;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+
+  // The first run binds every delegate call.
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const size_t num_calls = execute_calls;
+  EXPECT_GT(num_calls, 0);
+  EXPECT_EQ(bind_calls, num_calls);
+  EXPECT_EQ(StubBackend::singleton().execute_bound_calls(), num_calls);
+
+  // The planned memory did not move, so the next run reuses the bindings.
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(bind_calls, num_calls);
+  EXPECT_EQ(execute_calls, 2 * num_calls);
+
+  torch::executor::util::FreeInputs(inputs);
+
+  // A failed bind() fails the call without executing it, and is retried on
+  // the next run.
+  ManagedMemoryManager mmm2(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method2 = program->load_method("forward", &mmm2.get());
+  ASSERT_EQ(method2.error(), Error::Ok);
+  inputs = torch::executor::util::PrepareInputTensors(*method2);
+  bind_calls = 0;
+  execute_calls = 0;
+  bind_error = Error::Internal;
+  EXPECT_EQ(method2->execute(), Error::Internal);
+  EXPECT_EQ(bind_calls, 1);
+  EXPECT_EQ(execute_calls, 0);
+  bind_error = Error::Ok;
+  EXPECT_EQ(method2->execute(), Error::Ok);
+  EXPECT_EQ(bind_calls, 1 + num_calls);
+  EXPECT_EQ(execute_calls, num_calls);
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_P(BackendIntegrationTest, MemoryStatsIncludeDelegates) {
+  constexpr size_t kDelegateAllocation = 256;
+  constexpr size_t kDelegateHeap = 4096;
+  size_t init_calls = 0;
+  StubBackend::singleton().install_init(
+      [&](__ET_UNUSED FreeableBuffer* processed,
+          __ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          MemoryAllocator* runtime_allocator) -> Result<DelegateHandle*> {
+        ++init_calls;
+        return runtime_allocator->allocate(kDelegateAllocation);
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  // Backends that don't report their memory are counted.
+  {
+    ManagedMemoryManager mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method = program->load_method("forward", &mmm.get());
+    ASSERT_EQ(method.error(), Error::Ok);
+    ASSERT_GT(init_calls, 0);
+    MethodMemoryStats stats = method->memory_stats();
+    EXPECT_EQ(stats.delegate_heap_bytes, 0);
+    EXPECT_EQ(stats.num_unreported_delegates, init_calls);
+  }
+
+  StubBackend::singleton().install_get_memory_usage(
+      [&](DelegateHandle* handle) -> Result<size_t> {
+        EXPECT_NE(handle, nullptr);
+        return kDelegateHeap;
+      });
+  init_calls = 0;
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  MethodMemoryStats stats = method->memory_stats();
+
+  EXPECT_EQ(stats.delegate_heap_bytes, init_calls * kDelegateHeap);
+  EXPECT_EQ(stats.num_unreported_delegates, 0);
+  EXPECT_GE(stats.delegate_allocator_bytes, init_calls * kDelegateAllocation);
+  EXPECT_GE(stats.method_allocator_bytes, stats.delegate_allocator_bytes);
+  EXPECT_LE(
+      stats.method_allocator_bytes,
+      mmm.get().method_allocator()->used_size());
+
+  MethodMeta meta = method->method_meta();
+  size_t planned_bytes = 0;
+  for (size_t i = 0; i < meta.num_memory_planned_buffers(); ++i) {
+    planned_bytes += meta.memory_planned_buffer_size(i).get();
+  }
+  EXPECT_EQ(stats.planned_bytes, planned_bytes);
+}
+
+TEST_P(BackendIntegrationTest, SetConstantsUpdatesDelegates) {
+  // Each delegate holds its own copy of a constant named "adapter.weight".
+  std::vector<const void*> updates;
+  StubBackend::singleton().install_get_constant_nbytes(
+      [&](DelegateHandle* handle, const char* name) -> Result<size_t> {
+        EXPECT_NE(handle, nullptr);
+        if (strcmp(name, "adapter.weight") != 0) {
+          return Error::NotFound;
+        }
+        return 4 * sizeof(float);
+      });
+  StubBackend::singleton().install_update_constant(
+      [&](DelegateHandle* handle,
+          const char* name,
+          const void* data,
+          size_t nbytes) -> Error {
+        EXPECT_NE(handle, nullptr);
+        if (strcmp(name, "adapter.weight") != 0) {
+          return Error::NotFound;
+        }
+        EXPECT_EQ(nbytes, data != nullptr ? 4 * sizeof(float) : 0);
+        updates.push_back(data);
+        return Error::Ok;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Every delegate that holds the constant is updated.
+  const float adapter[4] = {1.f, 2.f, 3.f, 4.f};
+  const Method::ConstantData constants[] = {
+      {"adapter.weight", adapter, sizeof(adapter)}};
+  ASSERT_EQ(method->set_constants({constants, 1}), Error::Ok);
+  ASSERT_GT(updates.size(), 0);
+  const size_t num_delegates = updates.size();
+  for (const void* data : updates) {
+    EXPECT_EQ(data, adapter);
+  }
+
+  // An empty set restores the delegates' own constants.
+  updates.clear();
+  ASSERT_EQ(method->set_constants({}), Error::Ok);
+  ASSERT_EQ(updates.size(), num_delegates);
+  for (const void* data : updates) {
+    EXPECT_EQ(data, nullptr);
+  }
+
+  // Names that nothing holds are rejected before anything is updated, even
+  // after a name that a delegate holds.
+  updates.clear();
+  const Method::ConstantData missing[] = {
+      {"adapter.weight", adapter, sizeof(adapter)},
+      {"missing.weight", adapter, sizeof(adapter)}};
+  EXPECT_EQ(method->set_constants({missing, 2}), Error::NotFound);
+  EXPECT_EQ(updates.size(), 0);
+
+  // So is data of the wrong size.
+  const Method::ConstantData truncated[] = {
+      {"adapter.weight", adapter, sizeof(adapter) - 1}};
+  EXPECT_EQ(method->set_constants({truncated, 1}), Error::InvalidArgument);
+  EXPECT_EQ(updates.size(), 0);
+}
+
+TEST_P(BackendIntegrationTest, WarmupPreparesAndExecutesDelegates) {
+  size_t prepare_calls = 0;
+  size_t execute_calls = 0;
+  StubBackend::singleton().install_prepare([&](DelegateHandle* handle) {
+    EXPECT_NE(handle, nullptr);
+    ++prepare_calls;
+    return Error::Ok;
+  });
+  StubBackend::singleton().install_execute(
+      [&](__ET_UNUSED BackendExecutionContext& context,
+          __ET_UNUSED DelegateHandle* handle,
+          __ET_UNUSED EValue** args) -> Error {
+        ++execute_calls;
+        return Error::Ok;
+      });
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // By default, only the delegates are prepared.
+  ASSERT_EQ(method->warmup(), Error::Ok);
+  ASSERT_GT(prepare_calls, 0);
+  EXPECT_EQ(execute_calls, 0);
+  const size_t num_delegates = prepare_calls;
+
+  // Dry executions run every delegate, without inputs being set.
+  torch::executor::WarmupConfig config;
+  config.prepare_delegates = false;
+  config.num_executions = 2;
+  ASSERT_EQ(method->warmup(config), Error::Ok);
+  EXPECT_EQ(prepare_calls, num_delegates);
+  EXPECT_EQ(execute_calls, 2 * num_delegates);
+
+  // Errors from the delegates are returned.
+  StubBackend::singleton().install_prepare(
+      [](__ET_UNUSED DelegateHandle* handle) { return Error::Internal; });
+  EXPECT_EQ(method->warmup(), Error::Internal);
+}
+
 // TODO: Add more tests for the runtime-to-backend interface. E.g.:
 // - Errors during init() or execute() result in runtime init/execution failures
 // - Correct values are passed to init()/execute()
@@ -458,6 +1012,224 @@ INSTANTIATE_TEST_SUITE_P(
     BackendIntegrationTest,
     testing::Values(false, true));
 
+/**
+ * A DelegateSelector that always makes the same choice, and records what it
+ * was asked and told.
+ */
+class FixedDelegateSelector final : public DelegateSelector {
+ public:
+  explicit FixedDelegateSelector(int32_t choice) : choice_(choice) {}
+
+  int32_t select(
+      const char* method_name,
+      __ET_UNUSED size_t delegate_index,
+      ArrayRef<const char*> backend_ids) override {
+    ++select_calls;
+    selected_method_name = method_name;
+    selected_backend_ids.assign(backend_ids.begin(), backend_ids.end());
+    return choice_;
+  }
+
+  void on_measured(
+      __ET_UNUSED const char* method_name,
+      __ET_UNUSED size_t delegate_index,
+      __ET_UNUSED ArrayRef<const char*> backend_ids,
+      ArrayRef<uint64_t> ticks,
+      size_t chosen) override {
+    ++measured_calls;
+    measured_ticks.assign(ticks.begin(), ticks.end());
+    measured_choice = chosen;
+  }
+
+  size_t num_measured_runs() const override {
+    return 3;
+  }
+
+  size_t select_calls = 0;
+  std::string selected_method_name;
+  std::vector<std::string> selected_backend_ids;
+  size_t measured_calls = 0;
+  std::vector<uint64_t> measured_ticks;
+  size_t measured_choice = 0;
+
+ private:
+  const int32_t choice_;
+};
+
+/**
+ * Loads ModuleAddMul-alternatives.pte, whose partition is lowered to
+ * StubBackend and, as an alternative, to AlternativeStubBackend, which is
+ * served by a second StubBackend instance.
+ */
+class DelegateSelectionTest : public ::testing::Test {
+ protected:
+  static constexpr char kAlternativeName[] = "AlternativeStubBackend";
+
+  void SetUp() override {
+    torch::executor::runtime_init();
+    ASSERT_EQ(StubBackend::register_singleton(), Error::Ok);
+    static const Error alternative_registered =
+        torch::executor::register_backend({kAlternativeName, &alternative()});
+    ASSERT_EQ(alternative_registered, Error::Ok);
+
+    const char* path = std::getenv("ET_MODULE_ADD_MUL_ALTERNATIVES_PATH");
+    ASSERT_NE(path, nullptr);
+    Result<FileDataLoader> loader = FileDataLoader::from(path);
+    ASSERT_EQ(loader.error(), Error::Ok);
+    loader_ = std::make_unique<FileDataLoader>(std::move(loader.get()));
+    Result<Program> program = Program::load(loader_.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    program_ = std::make_unique<Program>(std::move(program.get()));
+
+    // Count the inits and executions of each lowering.
+    install_counters(StubBackend::singleton(), &preferred_);
+    install_counters(alternative(), &alternative_);
+  }
+
+  void TearDown() override {
+    StubBackend::singleton().reset();
+    alternative().reset();
+  }
+
+  /// Returns the backend registered as kAlternativeName.
+  static StubBackend& alternative() {
+    static StubBackend backend;
+    return backend;
+  }
+
+  struct Counts {
+    size_t inits = 0;
+    size_t executions = 0;
+  };
+
+  static void install_counters(StubBackend& backend, Counts* counts) {
+    backend.install_init(
+        [counts](
+            __ET_UNUSED FreeableBuffer* processed,
+            __ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+            __ET_UNUSED MemoryAllocator* runtime_allocator)
+            -> Result<DelegateHandle*> {
+          ++counts->inits;
+          return nullptr;
+        });
+    backend.install_execute(
+        [counts](
+            __ET_UNUSED BackendExecutionContext& context,
+            __ET_UNUSED DelegateHandle* handle,
+            __ET_UNUSED EValue** args) -> Error {
+          ++counts->executions;
+          return Error::Ok;
+        });
+  }
+
+  /// Clears the execution counts and executes `method` once.
+  void execute_once(Method& method) {
+    preferred_ = {preferred_.inits, 0};
+    alternative_ = {alternative_.inits, 0};
+    ASSERT_EQ(method.execute(), Error::Ok);
+  }
+
+  std::unique_ptr<FileDataLoader> loader_;
+  std::unique_ptr<Program> program_;
+  Counts preferred_;
+  Counts alternative_;
+};
+
+TEST_F(DelegateSelectionTest, PrefersFirstAvailableLowering) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program_->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_EQ(preferred_.inits, 1);
+  EXPECT_EQ(alternative_.inits, 0);
+
+  execute_once(*method);
+  EXPECT_EQ(preferred_.executions, 1);
+  EXPECT_EQ(alternative_.executions, 0);
+}
+
+TEST_F(DelegateSelectionTest, FallsBackWhenPreferredBackendUnavailable) {
+  StubBackend::singleton().install_is_available([]() { return false; });
+
+  // With one available lowering, the selector is not consulted.
+  FixedDelegateSelector selector(0);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program_->load_method(
+      "forward", &mmm.get(), /*event_tracer=*/nullptr, &selector);
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_EQ(selector.select_calls, 0);
+  EXPECT_EQ(preferred_.inits, 0);
+  EXPECT_EQ(alternative_.inits, 1);
+
+  execute_once(*method);
+  EXPECT_EQ(preferred_.executions, 0);
+  EXPECT_EQ(alternative_.executions, 1);
+}
+
+TEST_F(DelegateSelectionTest, SelectorChoosesLowering) {
+  FixedDelegateSelector selector(1);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program_->load_method(
+      "forward", &mmm.get(), /*event_tracer=*/nullptr, &selector);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  EXPECT_EQ(selector.select_calls, 1);
+  EXPECT_EQ(selector.selected_method_name, "forward");
+  ASSERT_EQ(selector.selected_backend_ids.size(), 2);
+  EXPECT_EQ(selector.selected_backend_ids[0], StubBackend::kName);
+  EXPECT_EQ(selector.selected_backend_ids[1], kAlternativeName);
+  EXPECT_EQ(selector.measured_calls, 0);
+  EXPECT_EQ(preferred_.inits, 0);
+  EXPECT_EQ(alternative_.inits, 1);
+
+  execute_once(*method);
+  EXPECT_EQ(preferred_.executions, 0);
+  EXPECT_EQ(alternative_.executions, 1);
+}
+
+TEST_F(DelegateSelectionTest, OutOfRangeSelectionFails) {
+  for (const int32_t choice : {2, -2}) {
+    FixedDelegateSelector selector(choice);
+    ManagedMemoryManager mmm(
+        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method = program_->load_method(
+        "forward", &mmm.get(), /*event_tracer=*/nullptr, &selector);
+    EXPECT_EQ(method.error(), Error::InvalidArgument) << "choice " << choice;
+  }
+}
+
+TEST_F(DelegateSelectionTest, MeasureKeepsFastestLowering) {
+  // Make the preferred lowering much slower than the alternative.
+  StubBackend::singleton().install_execute(
+      [this](
+          __ET_UNUSED BackendExecutionContext& context,
+          __ET_UNUSED DelegateHandle* handle,
+          __ET_UNUSED EValue** args) -> Error {
+        ++preferred_.executions;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return Error::Ok;
+      });
+
+  FixedDelegateSelector selector(DelegateSelector::kMeasure);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program_->load_method(
+      "forward", &mmm.get(), /*event_tracer=*/nullptr, &selector);
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Each lowering ran once to warm up, then num_measured_runs() times.
+  EXPECT_EQ(preferred_.executions, 4);
+  EXPECT_EQ(alternative_.executions, 4);
+  ASSERT_EQ(selector.measured_calls, 1);
+  ASSERT_EQ(selector.measured_ticks.size(), 2);
+  EXPECT_GT(selector.measured_ticks[1], 0);
+  EXPECT_GT(selector.measured_ticks[0], selector.measured_ticks[1]);
+  EXPECT_EQ(selector.measured_choice, 1);
+
+  // The method keeps the fastest lowering.
+  execute_once(*method);
+  EXPECT_EQ(preferred_.executions, 0);
+  EXPECT_EQ(alternative_.executions, 1);
+}
+
 class DelegateDataAlignmentTest : public ::testing::TestWithParam<bool> {
  protected:
   void SetUp() override {
@@ -42,6 +42,7 @@ using torch::executor::util::FileDataLoader;
 
 constexpr size_t kDefaultNonConstMemBytes = 32 * 1024U;
 constexpr size_t kDefaultRuntimeMemBytes = 32 * 1024U;
+constexpr size_t kDefaultTempMemBytes = 1024U;
 
 /**
  * Used to control and observe the behavior of a kernel.
@@ -59,10 +60,18 @@ struct KernelControl {
   // returning.
   Error fail_value = Error::Ok;
 
+  // If non-zero, the kernel should allocate this many bytes of temp memory.
+  size_t temp_allocation_size = 0;
+
+  // The temp memory that the kernel most recently allocated.
+  void* last_temp_allocation = nullptr;
+
   void reset() {
     call_count = 0;
     call_context_fail = false;
     fail_value = Error::Ok;
+    temp_allocation_size = 0;
+    last_temp_allocation = nullptr;
   }
 
   /**
@@ -114,6 +123,12 @@ struct KernelControl {
       __ET_UNUSED EValue** args) {
     auto* control = KernelControl::singleton();
     control->call_count++;
+    if (control->temp_allocation_size > 0) {
+      Result<void*> temp =
+          context.allocate_temp(control->temp_allocation_size);
+      EXPECT_EQ(temp.error(), Error::Ok);
+      control->last_temp_allocation = temp.ok() ? temp.get() : nullptr;
+    }
     if (control->call_context_fail) {
       context.fail(control->fail_value);
     }
@@ -150,7 +165,9 @@ class KernelIntegrationTest : public ::testing::Test {
 
     // Load the forward method.
     mmm_ = std::make_unique<ManagedMemoryManager>(
-        kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+        kDefaultNonConstMemBytes,
+        kDefaultRuntimeMemBytes,
+        kDefaultTempMemBytes);
     Result<Method> method = program_->load_method("forward", &mmm_->get());
     ASSERT_EQ(method.error(), Error::Ok);
     method_ = std::make_unique<Method>(std::move(method.get()));
@@ -217,3 +234,49 @@ TEST_F(KernelIntegrationTest, FailurePropagates) {
   EXPECT_EQ(err, Error::Ok);
   EXPECT_EQ(control_->call_count, 3);
 }
+
+TEST_F(KernelIntegrationTest, TempAllocatorHighWatermarkIsRecorded) {
+  EXPECT_EQ(method_->temp_allocator_high_watermark(), 0);
+
+  control_->temp_allocation_size = 100;
+  Error err = method_->execute();
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_GE(method_->temp_allocator_high_watermark(), 100);
+  void* first_allocation = control_->last_temp_allocation;
+  ASSERT_NE(first_allocation, nullptr);
+
+  // The temp allocator was reset, so the next execution gets the same memory.
+  err = method_->execute();
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_EQ(control_->last_temp_allocation, first_allocation);
+
+  // Smaller allocations don't lower the high-watermark.
+  control_->temp_allocation_size = 10;
+  err = method_->execute();
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_GE(method_->temp_allocator_high_watermark(), 100);
+
+  // Until it is reset.
+  method_->reset_temp_allocator_high_watermark();
+  EXPECT_EQ(method_->temp_allocator_high_watermark(), 0);
+  err = method_->execute();
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_GE(method_->temp_allocator_high_watermark(), 10);
+  EXPECT_LT(method_->temp_allocator_high_watermark(), 100);
+}
+
+TEST_F(KernelIntegrationTest, TempAllocatorIsResetWhenKernelFails) {
+  control_->temp_allocation_size = 100;
+  control_->call_context_fail = true;
+  control_->fail_value = Error::InvalidArgument;
+  Error err = method_->execute();
+  EXPECT_EQ(err, Error::InvalidArgument);
+  void* first_allocation = control_->last_temp_allocation;
+  ASSERT_NE(first_allocation, nullptr);
+  EXPECT_GE(method_->temp_allocator_high_watermark(), 100);
+
+  control_->call_context_fail = false;
+  err = method_->execute();
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_EQ(control_->last_temp_allocation, first_allocation);
+}
@@ -117,3 +117,53 @@ TEST_F(KernelResolutionTest, ResolveKernelKeySuccess) {
   auto method = program_->load_method("forward", &mmm.get());
   ASSERT_EQ(method.error(), Error::Ok);
 }
+
+/**
+ * Test that methods loaded together share kernel resolution and each receive
+ * the registered kernel.
+ */
+TEST_F(KernelResolutionTest, LoadMethodsSharesResolution) {
+  Kernel kernel_1 = Kernel(
+      "aten::add.out", {}, [](KernelRuntimeContext& context, EValue** stack) {
+        (void)context;
+        *(stack[0]) = Scalar(100);
+      });
+  auto s1 = register_kernels({kernel_1});
+  EXPECT_EQ(s1, torch::executor::Error::Ok);
+
+  struct Loaded {
+    size_t num_ok = 0;
+    size_t num_calls = 0;
+  } loaded;
+  auto on_loaded = [](void* context, size_t index, Result<Method>&& method) {
+    auto* l = static_cast<Loaded*>(context);
+    EXPECT_EQ(index, l->num_calls);
+    l->num_calls++;
+    if (method.ok()) {
+      l->num_ok++;
+    }
+  };
+
+  ManagedMemoryManager mmm1(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  ManagedMemoryManager mmm2(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  const char* names[] = {"forward", "forward"};
+  torch::executor::MemoryManager* managers[] = {&mmm1.get(), &mmm2.get()};
+  Error err = program_->load_methods(
+      {names, 2}, {managers, 2}, on_loaded, &loaded);
+  ASSERT_EQ(err, Error::Ok);
+  EXPECT_EQ(loaded.num_calls, 2);
+  EXPECT_EQ(loaded.num_ok, 2);
+
+  // Loading stops at the first method that fails.
+  loaded = Loaded();
+  const char* bad_names[] = {"not_a_method", "forward"};
+  err = program_->load_methods(
+      {bad_names, 2}, {managers, 2}, on_loaded, &loaded);
+  EXPECT_EQ(err, Error::InvalidArgument);
+  EXPECT_EQ(loaded.num_calls, 1);
+  EXPECT_EQ(loaded.num_ok, 0);
+
+  // Mismatched list lengths are rejected.
+  err = program_->load_methods({names, 2}, {managers, 1}, on_loaded, &loaded);
+  EXPECT_EQ(err, Error::InvalidArgument);
+}
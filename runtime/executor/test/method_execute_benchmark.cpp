@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Measures the fixed per-call overhead of Method::execute() by repeatedly
+ * executing a tiny model, like ModuleAdd.pte, whose kernels do almost no work.
+ *
+ * Usage:
+ *   method_execute_benchmark [model.pte] [iterations]
+ *
+ * If the model path is not provided, uses the ET_MODULE_ADD_PATH environment
+ * variable, which is how the tests in this directory find ModuleAdd.pte.
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/util/util.h>
+
+using torch::executor::Error;
+using torch::executor::Method;
+using torch::executor::Program;
+using torch::executor::Result;
+using torch::executor::testing::ManagedMemoryManager;
+using torch::executor::util::FileDataLoader;
+
+namespace {
+constexpr size_t kPlannedMemBytes = 32 * 1024U;
+constexpr size_t kMethodAllocatorBytes = 32 * 1024U;
+constexpr size_t kDefaultIterations = 100000;
+constexpr size_t kWarmupIterations = 100;
+} // namespace
+
+int main(int argc, char** argv) {
+  torch::executor::runtime_init();
+
+  const char* model_path =
+      argc > 1 ? argv[1] : std::getenv("ET_MODULE_ADD_PATH");
+  if (model_path == nullptr) {
+    ET_LOG(Error, "Usage: %s <model.pte> [iterations]", argv[0]);
+    return 1;
+  }
+  const size_t iterations =
+      argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10))
+               : kDefaultIterations;
+
+  Result<FileDataLoader> loader = FileDataLoader::from(model_path);
+  ET_CHECK_MSG(
+      loader.ok(),
+      "FileDataLoader::from() failed: 0x%" PRIx32,
+      static_cast<uint32_t>(loader.error()));
+  Result<Program> program = Program::load(&loader.get());
+  ET_CHECK_MSG(
+      program.ok(),
+      "Program::load() failed: 0x%" PRIx32,
+      static_cast<uint32_t>(program.error()));
+
+  ManagedMemoryManager mmm(kPlannedMemBytes, kMethodAllocatorBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ET_CHECK_MSG(
+      method.ok(),
+      "load_method() failed: 0x%" PRIx32,
+      static_cast<uint32_t>(method.error()));
+
+  auto inputs = torch::executor::util::PrepareInputTensors(*method);
+
+  for (size_t i = 0; i < kWarmupIterations; ++i) {
+    Error err = method->execute();
+    ET_CHECK_MSG(
+        err == Error::Ok,
+        "execute() failed: 0x%" PRIx32,
+        static_cast<uint32_t>(err));
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    Error err = method->execute();
+    ET_CHECK_MSG(
+        err == Error::Ok,
+        "execute() failed: 0x%" PRIx32,
+        static_cast<uint32_t>(err));
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const double total_ns =
+      std::chrono::duration<double, std::nano>(end - start).count();
+  printf(
+      "%zu iterations, %.1f ns per execute()\n",
+      iterations,
+      iterations > 0 ? total_ns / iterations : 0.0);
+
+  torch::executor::util::FreeInputs(inputs);
+  return 0;
+}
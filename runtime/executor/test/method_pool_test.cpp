@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdlib>
+#include <memory>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/executor/method_pool.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/util/util.h>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using torch::executor::ArrayRef;
+using torch::executor::Error;
+using torch::executor::MemoryAllocator;
+using torch::executor::MemoryManager;
+using torch::executor::Method;
+using torch::executor::MethodPool;
+using torch::executor::Program;
+using torch::executor::Result;
+using torch::executor::testing::ManagedMemoryManager;
+using torch::executor::util::FileDataLoader;
+
+constexpr size_t kDefaultNonConstMemBytes = 32 * 1024U;
+constexpr size_t kDefaultRuntimeMemBytes = 32 * 1024U;
+constexpr size_t kPoolSize = 3;
+
+class MethodPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+
+    // ModuleMultipleEntry computes x + a and x + a + b, where a is all 3s and
+    // b is all 2s, with the constants in a separate segment.
+    Result<FileDataLoader> loader = FileDataLoader::from(
+        std::getenv("ET_MODULE_MULTI_ENTRY_CONSTANT_SEGMENT_PATH"));
+    ASSERT_EQ(loader.error(), Error::Ok);
+    loader_ = std::make_unique<FileDataLoader>(std::move(loader.get()));
+
+    Result<Program> program = Program::load(loader_.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    program_ = std::make_unique<Program>(std::move(program.get()));
+
+    for (size_t i = 0; i < kPoolSize; i++) {
+      mmms_[i] = std::make_unique<ManagedMemoryManager>(
+          kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+      memory_managers_[i] = &mmms_[i]->get();
+    }
+  }
+
+  Result<MethodPool> load_pool(const char* method_name) {
+    return MethodPool::load(
+        program_.get(),
+        method_name,
+        ArrayRef<MemoryManager*>(memory_managers_, kPoolSize),
+        &pool_allocator_);
+  }
+
+  static void expect_output(Method& method, float expected) {
+    exec_aten::ArrayRef<void*> inputs =
+        torch::executor::util::PrepareInputTensors(method);
+    ASSERT_EQ(method.execute(), Error::Ok);
+    const exec_aten::Tensor& output = method.get_output(0).toTensor();
+    for (size_t j = 0; j < output.numel(); j++) {
+      EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[j], expected);
+    }
+    torch::executor::util::FreeInputs(inputs);
+  }
+
+ private:
+  // Must outlive program_.
+  std::unique_ptr<FileDataLoader> loader_;
+  std::unique_ptr<ManagedMemoryManager> mmms_[kPoolSize];
+  uint8_t pool_memory_[kPoolSize * sizeof(Method) + 64];
+
+ protected:
+  std::unique_ptr<Program> program_;
+  MemoryManager* memory_managers_[kPoolSize];
+  MemoryAllocator pool_allocator_{sizeof(pool_memory_), pool_memory_};
+};
+
+TEST_F(MethodPoolTest, AcquireAndRelease) {
+  Result<MethodPool> pool = load_pool("forward2");
+  ASSERT_EQ(pool.error(), Error::Ok);
+  EXPECT_EQ(pool->size(), kPoolSize);
+
+  Method* methods[kPoolSize];
+  for (size_t i = 0; i < kPoolSize; i++) {
+    methods[i] = pool->try_acquire();
+    ASSERT_NE(methods[i], nullptr);
+    for (size_t j = 0; j < i; j++) {
+      EXPECT_NE(methods[i], methods[j]);
+    }
+  }
+  // Every instance is checked out.
+  EXPECT_EQ(pool->try_acquire(), nullptr);
+
+  // Every instance has the constants, including those that borrowed them.
+  for (size_t i = 0; i < kPoolSize; i++) {
+    expect_output(*methods[i], 6.f);
+  }
+
+  pool->release(methods[1]);
+  EXPECT_EQ(pool->try_acquire(), methods[1]);
+  pool->release(methods[1]);
+  pool->release(methods[0]);
+  pool->release(methods[2]);
+}
+
+TEST_F(MethodPoolTest, LeaseReturnsMethod) {
+  Result<MethodPool> pool = load_pool("forward");
+  ASSERT_EQ(pool.error(), Error::Ok);
+
+  Method* first = nullptr;
+  {
+    MethodPool::Lease lease(*pool);
+    ASSERT_TRUE(lease.ok());
+    first = &*lease;
+    expect_output(*lease, 4.f);
+  }
+  // The lowest idle instance is checked out first.
+  MethodPool::Lease lease(*pool);
+  EXPECT_EQ(&*lease, first);
+}
+
+TEST_F(MethodPoolTest, InstancesHaveSeparateArenas) {
+  Result<MethodPool> pool = load_pool("forward");
+  ASSERT_EQ(pool.error(), Error::Ok);
+
+  MethodPool::Lease a(*pool);
+  MethodPool::Lease b(*pool);
+  ASSERT_TRUE(a.ok());
+  ASSERT_TRUE(b.ok());
+  EXPECT_NE(
+      a->get_output(0).toTensor().const_data_ptr(),
+      b->get_output(0).toTensor().const_data_ptr());
+}
+
+TEST_F(MethodPoolTest, RejectsEmptyPool) {
+  Result<MethodPool> pool = MethodPool::load(
+      program_.get(), "forward", ArrayRef<MemoryManager*>(), &pool_allocator_);
+  EXPECT_EQ(pool.error(), Error::InvalidArgument);
+}
+
+TEST_F(MethodPoolTest, MissingMethodFails) {
+  Result<MethodPool> pool = load_pool("not_a_method");
+  EXPECT_NE(pool.error(), Error::Ok);
+}
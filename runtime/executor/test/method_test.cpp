@@ -8,12 +8,15 @@
 
 #include <cstdlib>
 #include <filesystem>
+#include <vector>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/program.h>
 #include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+#include <executorch/runtime/kernel/operator_registry.h>
 #include <executorch/runtime/platform/runtime.h>
 #include <executorch/util/util.h>
 #include <gtest/gtest.h>
@@ -22,9 +25,12 @@ using namespace ::testing;
 using exec_aten::ArrayRef;
 using torch::executor::Error;
 using torch::executor::EValue;
+using torch::executor::MemoryAllocator;
 using torch::executor::Method;
 using torch::executor::Program;
 using torch::executor::Result;
+using torch::executor::RuntimeContext;
+using torch::executor::WeightStreamingConfig;
 using torch::executor::testing::ManagedMemoryManager;
 using torch::executor::util::FileDataLoader;
 
@@ -55,6 +61,41 @@ class MethodTest : public ::testing::Test {
     load_program(std::getenv("ET_MODULE_INDEX_PATH"), "index");
     load_program(
         std::getenv("ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH"), "cat");
+    load_program(
+        std::getenv("ET_MODULE_MULTI_ENTRY_CONSTANT_SEGMENT_PATH"),
+        "multi_entry_constant_segment");
+    load_program(std::getenv("ET_MODULE_NONZERO_PATH"), "nonzero");
+    load_program(
+        std::getenv("ET_MODULE_FOLDED_MOVE_JUMPS_PATH"), "folded_move_jumps");
+    load_program(std::getenv("ET_MODULE_WHILE_DOUBLE_PATH"), "while_double");
+    load_program(
+        std::getenv("ET_MODULE_WHILE_DOUBLE_UNPLANNED_OUTPUT_PATH"),
+        "while_double_unplanned_output");
+    load_program(
+        std::getenv("ET_MODULE_SCALAR_PRIM_OPS_PATH"), "scalar_prim_ops");
+    load_program(
+        std::getenv("ET_MODULE_SCALAR_FLOOR_DIV_BY_ZERO_PATH"),
+        "scalar_floor_div_by_zero");
+    load_program(
+        std::getenv("ET_MODULE_NAMED_CONSTANTS_PATH"), "named_constants");
+  }
+
+ protected:
+  // Sets the inputs of a WhileDouble program, which computes x * 2**n.
+  void set_while_double_inputs(Method& method, float n) {
+    float x_data[2] = {1.f, 2.f};
+    int32_t x_sizes[1] = {2};
+    exec_aten::TensorImpl x_impl(
+        exec_aten::ScalarType::Float, 1, x_sizes, x_data);
+    float n_data[1] = {n};
+    int32_t n_sizes[1] = {1};
+    exec_aten::TensorImpl n_impl(
+        exec_aten::ScalarType::Float, 1, n_sizes, n_data);
+    // The inputs are planned, so set_input() copies their data.
+    ASSERT_EQ(
+        method.set_input(EValue(exec_aten::Tensor(&x_impl)), 0), Error::Ok);
+    ASSERT_EQ(
+        method.set_input(EValue(exec_aten::Tensor(&n_impl)), 1), Error::Ok);
   }
 
  private:
@@ -196,6 +237,412 @@ TEST_F(MethodTest, AliasedIOTest) {
   }
 }
 
+TEST_F(MethodTest, IOBufferSetTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["cat"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Two sets of (2,4) inputs and outputs large enough for the (3,4) result.
+  constexpr int buffer_size = 16;
+  float inputs[2][buffer_size] = {};
+  float outputs[2][buffer_size] = {};
+  Method::IOBuffer input_buffers[2][1] = {
+      {{inputs[0], sizeof(inputs[0])}}, {{inputs[1], sizeof(inputs[1])}}};
+  Method::IOBuffer output_buffers[2][1] = {
+      {{outputs[0], sizeof(outputs[0])}}, {{outputs[1], sizeof(outputs[1])}}};
+  Method::IOBufferSet sets[2] = {
+      {{input_buffers[0], 1}, {output_buffers[0], 1}},
+      {{input_buffers[1], 1}, {output_buffers[1], 1}}};
+
+  // Nothing is registered yet.
+  EXPECT_EQ(method->select_io_buffer_set(0), Error::InvalidArgument);
+
+  ASSERT_EQ(method->set_io_buffer_sets({sets, 2}), Error::Ok);
+  EXPECT_EQ(method->select_io_buffer_set(2), Error::InvalidArgument);
+
+  for (size_t i = 0; i < 2; i++) {
+    ASSERT_EQ(method->select_io_buffer_set(i), Error::Ok);
+    EXPECT_EQ(method->get_input(0).toTensor().const_data_ptr(), inputs[i]);
+    EXPECT_EQ(method->get_output(0).toTensor().const_data_ptr(), outputs[i]);
+
+    // Cat a 1x4 of ones to the 2x4 of zeros.
+    ASSERT_EQ(method->execute(), Error::Ok);
+    for (size_t j = 0; j < 2 * 4; j++) {
+      EXPECT_FLOAT_EQ(outputs[i][j], 0.f);
+    }
+    for (size_t j = 2 * 4; j < 3 * 4; j++) {
+      EXPECT_FLOAT_EQ(outputs[i][j], 1.f);
+    }
+  }
+
+  // Mismatched list lengths are rejected.
+  Method::IOBufferSet short_set = {{input_buffers[0], 1}, {}};
+  EXPECT_EQ(
+      method->set_io_buffer_sets({&short_set, 1}), Error::InvalidArgument);
+
+  // Buffers smaller than their tensors are rejected.
+  Method::IOBuffer tiny_input = {inputs[0], sizeof(float)};
+  Method::IOBufferSet tiny_set = {{&tiny_input, 1}, {output_buffers[0], 1}};
+  EXPECT_EQ(
+      method->set_io_buffer_sets({&tiny_set, 1}), Error::InvalidArgument);
+}
+
+TEST_F(MethodTest, ConstantSegmentTest) {
+  const Program* program = programs_["multi_entry_constant_segment"].get();
+  EXPECT_TRUE(program->has_constant_segment());
+  // The constants are not part of the flatbuffer data.
+  EXPECT_EQ(program->get_constant_buffer_data(1).error(), Error::NotSupported);
+
+  // ModuleMultipleEntry computes x + a and x + a + b, where a is all 3s and b
+  // is all 2s. Each method loads the constants it uses.
+  const char* method_names[] = {"forward", "forward2"};
+  const float expected[] = {4.f, 6.f};
+  for (size_t i = 0; i < 2; i++) {
+    ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method = program->load_method(method_names[i], &mmm.get());
+    ASSERT_EQ(method.error(), Error::Ok);
+
+    // Fills the inputs with ones.
+    exec_aten::ArrayRef<void*> inputs =
+        torch::executor::util::PrepareInputTensors(*method);
+    ASSERT_EQ(method->execute(), Error::Ok);
+
+    // Moving the method keeps the loaded constants alive.
+    Method moved(std::move(method.get()));
+    ASSERT_EQ(moved.execute(), Error::Ok);
+    const exec_aten::Tensor& output = moved.get_output(0).toTensor();
+    for (size_t j = 0; j < output.numel(); j++) {
+      EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[j], expected[i]);
+    }
+
+    torch::executor::util::FreeInputs(inputs);
+  }
+}
+
+TEST_F(MethodTest, WeightStreamingTest) {
+  const Program* program = programs_["multi_entry_constant_segment"].get();
+  WeightStreamingConfig config;
+  config.prefetch_buffers = 1;
+
+  // Loaded as usual, for comparison.
+  ManagedMemoryManager full_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> full = program->load_method("forward2", &full_mmm.get());
+  ASSERT_EQ(full.error(), Error::Ok);
+  const size_t full_constant_bytes = full->memory_stats().constant_bytes;
+
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method(
+      "forward2",
+      &mmm.get(),
+      /*event_tracer=*/nullptr,
+      /*delegate_selector=*/nullptr,
+      &config);
+  ASSERT_EQ(method.error(), Error::Ok);
+  // Nothing is loaded until the method runs.
+  EXPECT_EQ(method->memory_stats().constant_bytes, 0);
+
+  // forward2 computes x + a + b. Each constant is loaded for its add, and a
+  // is freed once the second add starts, so b is what's left afterwards.
+  exec_aten::ArrayRef<void*> inputs =
+      torch::executor::util::PrepareInputTensors(*method);
+  for (int run = 0; run < 2; run++) {
+    ASSERT_EQ(method->execute(), Error::Ok);
+    const exec_aten::Tensor& output = method->get_output(0).toTensor();
+    for (size_t j = 0; j < output.numel(); j++) {
+      EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[j], 6.f);
+    }
+    const size_t constant_bytes = method->memory_stats().constant_bytes;
+    EXPECT_GE(constant_bytes, 4 * sizeof(float));
+    EXPECT_LT(constant_bytes, full_constant_bytes);
+  }
+  torch::executor::util::FreeInputs(inputs);
+}
+
+TEST_F(MethodTest, WeightStreamingNeedsConstantSegmentTest) {
+  WeightStreamingConfig config;
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method(
+      "forward",
+      &mmm.get(),
+      /*event_tracer=*/nullptr,
+      /*delegate_selector=*/nullptr,
+      &config);
+  EXPECT_EQ(method.error(), Error::NotSupported);
+}
+
+TEST_F(MethodTest, IOBufferSetRejectsPlannedIOTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // ModuleAdd has memory-planned inputs (x, y, alpha) and output.
+  float data[3][4] = {};
+  Method::IOBuffer input_buffers[3] = {
+      {data[0], sizeof(data[0])}, {data[1], sizeof(data[1])}, {nullptr, 0}};
+  Method::IOBuffer output_buffers[1] = {{data[2], sizeof(data[2])}};
+  Method::IOBufferSet set = {{input_buffers, 3}, {output_buffers, 1}};
+  EXPECT_EQ(method->set_io_buffer_sets({&set, 1}), Error::InvalidState);
+}
+
+TEST_F(MethodTest, DynamicAllocatorGrowsUnboundedOutputTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["nonzero"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // The output of ModuleNonzero is unbounded and has no planned storage, so
+  // nonzero.out gets it from the dynamic allocator.
+  alignas(MemoryAllocator::kDefaultAlignment) uint8_t dynamic_pool[1024];
+  MemoryAllocator dynamic_allocator(sizeof(dynamic_pool), dynamic_pool);
+  method->set_dynamic_allocator(&dynamic_allocator);
+
+  float data[4 * 4];
+  for (size_t i = 0; i < 4 * 4; i++) {
+    data[i] = 1.0f;
+  }
+  int32_t sizes[2] = {4, 4};
+  exec_aten::TensorImpl impl(exec_aten::ScalarType::Float, 2, sizes, data);
+  ASSERT_EQ(method->set_input(EValue(exec_aten::Tensor(&impl)), 0), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+
+  const exec_aten::Tensor& out = method->get_output(0).toTensor();
+  ASSERT_EQ(out.size(0), 16);
+  ASSERT_EQ(out.size(1), 2);
+  const int64_t* indices = out.const_data_ptr<int64_t>();
+  for (int64_t i = 0; i < 16; i++) {
+    EXPECT_EQ(indices[2 * i], i / 4);
+    EXPECT_EQ(indices[2 * i + 1], i % 4);
+  }
+  EXPECT_GT(dynamic_allocator.used_size(), 0);
+
+  // Fewer nonzero elements fit in the storage that the output already has.
+  const void* grown_data = out.const_data_ptr();
+  const size_t used = dynamic_allocator.used_size();
+  data[0] = 0.0f;
+  ASSERT_EQ(method->set_input(EValue(exec_aten::Tensor(&impl)), 0), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(method->get_output(0).toTensor().size(0), 15);
+  EXPECT_EQ(method->get_output(0).toTensor().const_data_ptr(), grown_data);
+  EXPECT_EQ(dynamic_allocator.used_size(), used);
+}
+
+TEST_F(MethodTest, FoldedBookkeepingInstructionsTest) {
+  // FoldedMoveJumps holds 10 instructions; without an event tracer, the four
+  // MoveCalls and FreeCalls that follow a kernel are folded into it, and the
+  // jumps around them are remapped. The MoveCall that the then-branch jumps to
+  // stays an instruction of its own.
+  struct Case {
+    bool pred;
+    size_t expected_steps;
+    float expected[2];
+  };
+  const Case cases[] = {
+      // add, jf, mul, jf, move; 8 instructions without folding.
+      {true, 5, {16.f, 36.f}},
+      // add, jf, add, move; 6 instructions without folding.
+      {false, 4, {8.f, 12.f}},
+  };
+  for (const Case& c : cases) {
+    // The then-branch frees a planned tensor, so use a fresh Method per run.
+    ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method =
+        programs_["folded_move_jumps"]->load_method("forward", &mmm.get());
+    ASSERT_EQ(method.error(), Error::Ok);
+
+    float x_data[2] = {2.f, 3.f};
+    int32_t x_sizes[1] = {2};
+    exec_aten::TensorImpl x_impl(
+        exec_aten::ScalarType::Float, 1, x_sizes, x_data);
+    bool pred_data[1] = {c.pred};
+    int32_t pred_sizes[1] = {1};
+    exec_aten::TensorImpl pred_impl(
+        exec_aten::ScalarType::Bool, 1, pred_sizes, pred_data);
+    ASSERT_EQ(
+        method->set_input(EValue(exec_aten::Tensor(&x_impl)), 0), Error::Ok);
+    ASSERT_EQ(
+        method->set_input(EValue(exec_aten::Tensor(&pred_impl)), 1),
+        Error::Ok);
+
+    size_t steps = 0;
+    Error err = Error::Ok;
+    while ((err = method->experimental_step()) == Error::Ok) {
+      steps++;
+    }
+    ASSERT_EQ(err, Error::EndOfMethod);
+    EXPECT_EQ(steps, c.expected_steps);
+
+    const exec_aten::Tensor& y = method->get_output(0).toTensor();
+    ASSERT_EQ(y.numel(), 2);
+    EXPECT_FLOAT_EQ(y.const_data_ptr<float>()[0], c.expected[0]);
+    EXPECT_FLOAT_EQ(y.const_data_ptr<float>()[1], c.expected[1]);
+  }
+}
+
+TEST_F(MethodTest, WhileLoopTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["while_double"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // An even count leaves the state in its own buffer; an odd count leaves it
+  // in the body output's, for WhileEnd to move back. Running again also checks
+  // that WhileEnd reset the iteration count.
+  const void* planned_data = method->get_output(0).toTensor().const_data_ptr();
+  for (const float n : {2.f, 3.f, 0.f}) {
+    set_while_double_inputs(*method, n);
+    ASSERT_EQ(method->execute(), Error::Ok);
+    const exec_aten::Tensor& acc = method->get_output(0).toTensor();
+    EXPECT_EQ(acc.const_data_ptr(), planned_data);
+    const float scale = n == 2.f ? 4.f : n == 3.f ? 8.f : 1.f;
+    EXPECT_FLOAT_EQ(acc.const_data_ptr<float>()[0], 1.f * scale);
+    EXPECT_FLOAT_EQ(acc.const_data_ptr<float>()[1], 2.f * scale);
+  }
+}
+
+TEST_F(MethodTest, WhileLoopCallerOutputBufferTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["while_double_unplanned_output"]->load_method(
+      "forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // The loop state is the output, so the final state must land in the
+  // caller's buffer whichever buffer the last iteration wrote.
+  for (const float n : {2.f, 3.f}) {
+    float out[2] = {0.f, 0.f};
+    ASSERT_EQ(method->set_output_data_ptr(out, sizeof(out), 0), Error::Ok);
+    set_while_double_inputs(*method, n);
+    ASSERT_EQ(method->execute(), Error::Ok);
+    EXPECT_EQ(method->get_output(0).toTensor().const_data_ptr(), out);
+    const float scale = n == 2.f ? 4.f : 8.f;
+    EXPECT_FLOAT_EQ(out[0], 1.f * scale);
+    EXPECT_FLOAT_EQ(out[1], 2.f * scale);
+  }
+}
+
+TEST_F(MethodTest, ScalarOpsMatchPrimKernelsTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["scalar_prim_ops"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  float x_data[6] = {};
+  int32_t x_sizes[2] = {2, 3};
+  exec_aten::TensorImpl x_impl(
+      exec_aten::ScalarType::Float, 2, x_sizes, x_data);
+  const EValue x(exec_aten::Tensor(&x_impl));
+  ASSERT_EQ(method->set_input(x, 0), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+
+  // The same calls as in the ScalarPrimOps program. The int floordivs and the
+  // size ops run inline; the double operands fall back to the kernels.
+  const EValue neg7(int64_t(-7));
+  const EValue two(int64_t(2));
+  const EValue pos7(int64_t(7));
+  const EValue neg2(int64_t(-2));
+  const EValue one(int64_t(1));
+  const EValue double7_5(7.5);
+  const struct {
+    const char* op;
+    std::vector<EValue> args;
+  } calls[] = {
+      {"executorch_prim::floordiv.Scalar", {neg7, two}},
+      {"executorch_prim::floordiv.Scalar", {pos7, neg2}},
+      {"executorch_prim::floordiv.Scalar", {neg7, neg2}},
+      {"executorch_prim::floordiv.Scalar", {pos7, two}},
+      {"aten::sym_size.int", {x, one}},
+      {"aten::sym_numel", {x}},
+      {"executorch_prim::floordiv.Scalar", {double7_5, two}},
+      {"executorch_prim::add.Scalar", {double7_5, one}},
+  };
+  ASSERT_EQ(method->outputs_size(), sizeof(calls) / sizeof(calls[0]));
+  for (size_t i = 0; i < method->outputs_size(); i++) {
+    std::vector<EValue> stack_values = calls[i].args;
+    stack_values.emplace_back(int64_t(0));
+    std::vector<EValue*> stack;
+    for (EValue& value : stack_values) {
+      stack.push_back(&value);
+    }
+    RuntimeContext context;
+    torch::executor::getOpsFn(calls[i].op)(context, stack.data());
+    ASSERT_EQ(context.failure_state(), Error::Ok);
+    const EValue& expected = stack_values.back();
+
+    const EValue& actual = method->get_output(i);
+    ASSERT_EQ(actual.tag, expected.tag) << "output " << i;
+    if (expected.isInt()) {
+      EXPECT_EQ(actual.toInt(), expected.toInt()) << "output " << i;
+    } else {
+      EXPECT_DOUBLE_EQ(actual.toDouble(), expected.toDouble())
+          << "output " << i;
+    }
+  }
+  // Spot-check the kernels' rounding toward negative infinity.
+  EXPECT_EQ(method->get_output(0).toInt(), -4);
+  EXPECT_EQ(method->get_output(1).toInt(), -4);
+  EXPECT_EQ(method->get_output(2).toInt(), 3);
+  EXPECT_EQ(method->get_output(4).toInt(), 3);
+  EXPECT_EQ(method->get_output(5).toInt(), 6);
+  EXPECT_DOUBLE_EQ(method->get_output(6).toDouble(), 3.0);
+}
+
+TEST_F(MethodTest, ScalarFloorDivByZeroFallsBackToKernelTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["scalar_floor_div_by_zero"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // The inline path leaves division by zero to the kernel, which fails.
+  EXPECT_EQ(method->execute(), Error::InvalidArgument);
+}
+
+TEST_F(MethodTest, SetConstantsTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["named_constants"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Computes y = x + w, where w is a constant named "w" of [1, 2].
+  float x_data[2] = {10.f, 20.f};
+  int32_t x_sizes[1] = {2};
+  exec_aten::TensorImpl x_impl(
+      exec_aten::ScalarType::Float, 1, x_sizes, x_data);
+  ASSERT_EQ(
+      method->set_input(EValue(exec_aten::Tensor(&x_impl)), 0), Error::Ok);
+  auto expect_y = [&](float y0, float y1) {
+    ASSERT_EQ(method->execute(), Error::Ok);
+    const exec_aten::Tensor y = method->get_output(0).toTensor();
+    EXPECT_FLOAT_EQ(y.const_data_ptr<float>()[0], y0);
+    EXPECT_FLOAT_EQ(y.const_data_ptr<float>()[1], y1);
+  };
+  expect_y(11.f, 22.f);
+
+  // Swapping in new data changes the output.
+  const float w[2] = {100.f, 200.f};
+  const Method::ConstantData swapped[] = {{"w", w, sizeof(w)}};
+  ASSERT_EQ(method->set_constants({swapped, 1}), Error::Ok);
+  expect_y(110.f, 220.f);
+
+  // A set with a misspelled name, a mutable state tensor or data of the
+  // wrong size is rejected as a whole, and leaves the previous set in place.
+  const float other[2] = {1000.f, 2000.f};
+  const Method::ConstantData misspelled[] = {
+      {"w", other, sizeof(other)}, {"v", other, sizeof(other)}};
+  EXPECT_EQ(method->set_constants({misspelled, 2}), Error::NotFound);
+  expect_y(110.f, 220.f);
+  const Method::ConstantData state[] = {
+      {"w", other, sizeof(other)}, {"state", other, sizeof(other)}};
+  EXPECT_EQ(method->set_constants({state, 2}), Error::InvalidArgument);
+  expect_y(110.f, 220.f);
+  const Method::ConstantData truncated[] = {{"w", other, sizeof(float)}};
+  EXPECT_EQ(method->set_constants({truncated, 1}), Error::InvalidArgument);
+  expect_y(110.f, 220.f);
+
+  // An empty set restores the original data.
+  ASSERT_EQ(method->set_constants({}), Error::Ok);
+  expect_y(11.f, 22.f);
+}
+
 // TODO(T161163608): Test is disabled due to a resize bug in tensor_index_out of
 // the portable op lib
 
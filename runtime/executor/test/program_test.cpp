@@ -199,6 +199,47 @@ TEST_F(ProgramTest, VerificationCatchesCorruption) {
   ASSERT_EQ(program.error(), Error::InvalidProgram);
 }
 
+TEST_F(ProgramTest, DataParsesWithChecksumVerification) {
+  // This program was exported with a checksum in its extended header.
+  const char* path = std::getenv("ET_MODULE_MULTI_ENTRY_CONSTANT_SEGMENT_PATH");
+  Result<FileDataLoader> loader = FileDataLoader::from(path);
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  Result<Program> program =
+      Program::load(&loader.get(), Program::Verification::Checksum);
+  EXPECT_EQ(program.error(), Error::Ok);
+}
+
+TEST_F(ProgramTest, ChecksumVerificationCatchesCorruptData) {
+  const char* path = std::getenv("ET_MODULE_MULTI_ENTRY_CONSTANT_SEGMENT_PATH");
+  Result<FileDataLoader> loader = FileDataLoader::from(path);
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  // Make a local copy of the data.
+  size_t data_len = loader->size().get();
+  auto data = std::make_unique<char[]>(data_len);
+  {
+    Result<FreeableBuffer> src = loader->Load(/*offset=*/0, data_len);
+    ASSERT_EQ(src.error(), Error::Ok);
+    memcpy(data.get(), src->data(), data_len);
+  }
+
+  // Flip a byte of the flatbuffer data, just past the extended header.
+  data[64] ^= 0xff;
+  BufferDataLoader data_loader(data.get(), data_len);
+
+  Result<Program> program =
+      Program::load(&data_loader, Program::Verification::Checksum);
+  EXPECT_EQ(program.error(), Error::InvalidProgram);
+}
+
+TEST_F(ProgramTest, ChecksumVerificationRequiresChecksum) {
+  // ModuleAdd has no extended header, so it has no checksum either.
+  Result<Program> program =
+      Program::load(add_loader_.get(), Program::Verification::Checksum);
+  EXPECT_EQ(program.error(), Error::InvalidProgram);
+}
+
 TEST_F(ProgramTest, UnalignedProgramDataFails) {
   // Make a local copy of the data, on an odd alignment.
   size_t data_len = add_loader_->size().get();
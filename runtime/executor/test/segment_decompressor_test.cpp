@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/segment_decompressor.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using torch::executor::Error;
+using torch::executor::internal::decompress_lz4_block;
+using torch::executor::util::BufferDataLoader;
+
+namespace {
+
+void append_length(std::vector<uint8_t>* out, size_t length) {
+  while (length >= 255) {
+    out->push_back(255);
+    length -= 255;
+  }
+  out->push_back(static_cast<uint8_t>(length));
+}
+
+/**
+ * Appends an LZ4 sequence to `out`. A `match_length` of zero writes the final
+ * sequence of a block, which only has literals.
+ */
+void append_sequence(
+    std::vector<uint8_t>* out,
+    const std::string& literals,
+    size_t match_offset = 0,
+    size_t match_length = 0) {
+  const size_t match_code = match_length > 0 ? match_length - 4 : 0;
+  out->push_back(static_cast<uint8_t>(
+      (std::min<size_t>(literals.size(), 15) << 4) |
+      std::min<size_t>(match_code, 15)));
+  if (literals.size() >= 15) {
+    append_length(out, literals.size() - 15);
+  }
+  out->insert(out->end(), literals.begin(), literals.end());
+  if (match_length > 0) {
+    out->push_back(static_cast<uint8_t>(match_offset & 0xff));
+    out->push_back(static_cast<uint8_t>(match_offset >> 8));
+    if (match_code >= 15) {
+      append_length(out, match_code - 15);
+    }
+  }
+}
+
+} // namespace
+
+class SegmentDecompressorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+
+  /// Decompresses `block` into `out`, which must already have the expected
+  /// size.
+  Error decompress(const std::vector<uint8_t>& block, std::string* out) {
+    BufferDataLoader loader(block.data(), block.size());
+    return decompress_lz4_block(
+        &loader, /*offset=*/0, block.size(), &(*out)[0], out->size());
+  }
+};
+
+TEST_F(SegmentDecompressorTest, LiteralsOnly) {
+  std::vector<uint8_t> block;
+  append_sequence(&block, "hello");
+
+  std::string out(5, '\0');
+  EXPECT_EQ(decompress(block, &out), Error::Ok);
+  EXPECT_EQ(out, "hello");
+}
+
+TEST_F(SegmentDecompressorTest, OverlappingMatchesRepeatPatterns) {
+  std::vector<uint8_t> block;
+  // Copies "ab" forward over itself to produce "abababab".
+  append_sequence(&block, "ab", /*match_offset=*/2, /*match_length=*/8);
+  append_sequence(&block, "xyzzy");
+
+  std::string out(15, '\0');
+  EXPECT_EQ(decompress(block, &out), Error::Ok);
+  EXPECT_EQ(out, "ababababab" "xyzzy");
+}
+
+TEST_F(SegmentDecompressorTest, LongLengthsSpanSeveralChunks) {
+  // Literal and match runs longer than a chunk, so that literals, length
+  // bytes, and offsets straddle chunk boundaries.
+  std::string literals;
+  for (size_t i = 0; i < 3 * ET_SEGMENT_DECOMPRESSION_CHUNK_SIZE + 7; ++i) {
+    literals.push_back(static_cast<char>('a' + i % 23));
+  }
+  const size_t match_length = 2 * ET_SEGMENT_DECOMPRESSION_CHUNK_SIZE + 300;
+  std::vector<uint8_t> block;
+  append_sequence(&block, literals, /*match_offset=*/23, match_length);
+  append_sequence(&block, "tail!");
+
+  std::string expected = literals;
+  for (size_t i = 0; i < match_length; ++i) {
+    expected.push_back(expected[expected.size() - 23]);
+  }
+  expected += "tail!";
+
+  std::string out(expected.size(), '\0');
+  EXPECT_EQ(decompress(block, &out), Error::Ok);
+  EXPECT_EQ(out, expected);
+}
+
+TEST_F(SegmentDecompressorTest, ReadsAtAnOffsetWithinTheLoader) {
+  std::vector<uint8_t> data = {0xde, 0xad, 0xbe, 0xef};
+  append_sequence(&data, "abc", /*match_offset=*/3, /*match_length=*/6);
+  append_sequence(&data, "12345");
+  const size_t block_size = data.size() - 4;
+  // Trailing data that isn't part of the block.
+  data.push_back(0xff);
+
+  BufferDataLoader loader(data.data(), data.size());
+  std::string out(14, '\0');
+  EXPECT_EQ(
+      decompress_lz4_block(&loader, 4, block_size, &out[0], out.size()),
+      Error::Ok);
+  EXPECT_EQ(out, "abcabcabc12345");
+}
+
+TEST_F(SegmentDecompressorTest, EmptyBlockDecompressesToNothing) {
+  std::vector<uint8_t> block;
+  std::string out;
+  EXPECT_EQ(decompress(block, &out), Error::Ok);
+}
+
+TEST_F(SegmentDecompressorTest, WrongSizeFails) {
+  std::vector<uint8_t> block;
+  append_sequence(&block, "hello");
+
+  // Too small to hold the data.
+  std::string small(4, '\0');
+  EXPECT_EQ(decompress(block, &small), Error::InvalidProgram);
+
+  // Larger than the data.
+  std::string large(6, '\0');
+  EXPECT_EQ(decompress(block, &large), Error::InvalidProgram);
+}
+
+TEST_F(SegmentDecompressorTest, InvalidMatchOffsetFails) {
+  // An offset of zero.
+  {
+    std::vector<uint8_t> block;
+    append_sequence(&block, "ab", /*match_offset=*/0, /*match_length=*/4);
+    append_sequence(&block, "xyzzy");
+    std::string out(11, '\0');
+    EXPECT_EQ(decompress(block, &out), Error::InvalidProgram);
+  }
+  // An offset before the start of the output.
+  {
+    std::vector<uint8_t> block;
+    append_sequence(&block, "ab", /*match_offset=*/3, /*match_length=*/4);
+    append_sequence(&block, "xyzzy");
+    std::string out(11, '\0');
+    EXPECT_EQ(decompress(block, &out), Error::InvalidProgram);
+  }
+}
+
+TEST_F(SegmentDecompressorTest, TruncatedBlockFails) {
+  std::vector<uint8_t> block;
+  append_sequence(&block, "ab", /*match_offset=*/2, /*match_length=*/8);
+  append_sequence(&block, "xyzzy");
+  // Drop the end of the final literals.
+  block.resize(block.size() - 2);
+
+  std::string out(15, '\0');
+  EXPECT_EQ(decompress(block, &out), Error::InvalidProgram);
+}
+
+TEST_F(SegmentDecompressorTest, LoaderErrorsPropagate) {
+  std::vector<uint8_t> block;
+  append_sequence(&block, "hello");
+
+  // The range extends past the end of the loader's data.
+  BufferDataLoader loader(block.data(), block.size());
+  std::string out(5, '\0');
+  EXPECT_EQ(
+      decompress_lz4_block(&loader, 1, block.size(), &out[0], out.size()),
+      Error::InvalidArgument);
+}
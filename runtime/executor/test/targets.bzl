@@ -74,6 +74,31 @@ def define_common_targets(is_fbcode = False):
         ],
     )
 
+    runtime.cxx_binary(
+        name = "method_execute_benchmark",
+        srcs = [
+            "method_execute_benchmark.cpp",
+        ],
+        deps = [
+            ":managed_memory_manager",
+            "//executorch/runtime/executor:program",
+            "//executorch/kernels/portable:generated_lib",
+            "//executorch/extension/data_loader:file_data_loader",
+            "//executorch/util:util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "segment_decompressor_test",
+        srcs = [
+            "segment_decompressor_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/runtime/executor:segment_decompressor",
+        ],
+    )
+
     # TODO(dbort): Find a way to make these run for ANDROID/APPLE in xplat. The
     # android and ios test determinators don't like the reference to the model
     # file in fbcode. See https://fburl.com/9esapdmd
@@ -84,8 +109,16 @@ def define_common_targets(is_fbcode = False):
             # intentionally don't work in xplat (since they're host-only tools).
             "ET_MODULE_ADD_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleAdd.pte])",
             "ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleDynamicCatUnallocatedIO.pte])",
+            "ET_MODULE_FOLDED_MOVE_JUMPS_PATH": "$(location fbcode//executorch/test/models:handwritten_programs[FoldedMoveJumps.pte])",
             "ET_MODULE_INDEX_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleIndex.pte])",
+            "ET_MODULE_MULTI_ENTRY_CONSTANT_SEGMENT_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleMultipleEntry-constant-segment.pte])",
             "ET_MODULE_MULTI_ENTRY_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleMultipleEntry.pte])",
+            "ET_MODULE_NONZERO_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleNonzero.pte])",
+            "ET_MODULE_SCALAR_FLOOR_DIV_BY_ZERO_PATH": "$(location fbcode//executorch/test/models:handwritten_programs[ScalarFloorDivByZero.pte])",
+            "ET_MODULE_NAMED_CONSTANTS_PATH": "$(location fbcode//executorch/test/models:handwritten_programs[NamedConstants.pte])",
+            "ET_MODULE_SCALAR_PRIM_OPS_PATH": "$(location fbcode//executorch/test/models:handwritten_programs[ScalarPrimOps.pte])",
+            "ET_MODULE_WHILE_DOUBLE_PATH": "$(location fbcode//executorch/test/models:handwritten_programs[WhileDouble.pte])",
+            "ET_MODULE_WHILE_DOUBLE_UNPLANNED_OUTPUT_PATH": "$(location fbcode//executorch/test/models:handwritten_programs[WhileDoubleUnplannedOutput.pte])",
         }
 
         runtime.cxx_test(
@@ -108,6 +141,22 @@ def define_common_targets(is_fbcode = False):
             srcs = [
                 "method_test.cpp",
             ],
+            deps = [
+                ":managed_memory_manager",
+                "//executorch/runtime/executor:program",
+                "//executorch/util:util",
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/kernels/portable:generated_lib",
+                "//executorch/kernels/prim_ops:prim_ops_registry",
+            ],
+            env = modules_env,
+        )
+
+        runtime.cxx_test(
+            name = "method_pool_test",
+            srcs = [
+                "method_pool_test.cpp",
+            ],
             deps = [
                 ":managed_memory_manager",
                 "//executorch/runtime/executor:program",
@@ -188,6 +237,7 @@ def define_common_targets(is_fbcode = False):
                 "//executorch/runtime/executor:program",
                 "//executorch/extension/data_loader:buffer_data_loader",
                 "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/extension/data_loader:mmap_data_loader",
                 "//executorch/util:util",
             ],
             env = {
@@ -195,6 +245,7 @@ def define_common_targets(is_fbcode = False):
                 # Uses an fbcode target path because the authoring/export tools
                 # intentionally don't work in xplat (since they're host-only
                 # tools).
+                "ET_MODULE_ADD_MUL_ALTERNATIVES_PATH": "$(location fbcode//executorch/test/models:exported_delegated_programs[ModuleAddMul-alternatives.pte])",
                 "ET_MODULE_ADD_MUL_NOSEGMENTS_DA1024_PATH": "$(location fbcode//executorch/test/models:exported_delegated_programs[ModuleAddMul-nosegments-da1024.pte])",
                 "ET_MODULE_ADD_MUL_NOSEGMENTS_PATH": "$(location fbcode//executorch/test/models:exported_delegated_programs[ModuleAddMul-nosegments.pte])",
                 "ET_MODULE_ADD_MUL_PATH": "$(location fbcode//executorch/test/models:exported_delegated_programs[ModuleAddMul.pte])",
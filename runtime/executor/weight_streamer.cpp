@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/executor/weight_streamer.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <new>
+
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/profiler.h>
+#include <executorch/schema/program_generated.h>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+namespace {
+
+/// Marks a value that is streamed unless a later pass keeps it resident.
+constexpr int32_t kCandidate = 0;
+/// Marks a value that is loaded with the Method, if it is a constant at all.
+constexpr int32_t kResident = -1;
+
+/// Marks the constant tensors among `indices` as candidates.
+template <typename Indices>
+void mark_candidates(
+    const flatbuffers::Vector<
+        flatbuffers::Offset<executorch_flatbuffer::EValue>>* values,
+    const Indices* indices,
+    int32_t* slot_of_value) {
+  if (indices == nullptr) {
+    return;
+  }
+  for (const auto index : *indices) {
+    if (index < 0 || static_cast<size_t>(index) >= values->size()) {
+      // Method::init() reports invalid indices.
+      continue;
+    }
+    const auto* value = values->Get(index);
+    switch (value->val_type()) {
+      case executorch_flatbuffer::KernelTypes::Tensor: {
+        const auto* s_tensor = value->val_as_Tensor();
+        // Constants that have an allocation are mutable buffers whose
+        // initial data is copied into planned memory once.
+        if (s_tensor->constant_buffer_idx() > 0 &&
+            s_tensor->allocation_info() == nullptr) {
+          slot_of_value[index] = kCandidate;
+        }
+      } break;
+      case executorch_flatbuffer::KernelTypes::TensorList:
+        mark_candidates(
+            values, value->val_as_TensorList()->items(), slot_of_value);
+        break;
+      case executorch_flatbuffer::KernelTypes::OptionalTensorList:
+        mark_candidates(
+            values, value->val_as_OptionalTensorList()->items(), slot_of_value);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+/// Keeps the value at `index` resident.
+void mark_resident(int32_t index, size_t n_value, int32_t* slot_of_value) {
+  if (index >= 0 && static_cast<size_t>(index) < n_value) {
+    slot_of_value[index] = kResident;
+  }
+}
+
+} // namespace
+
+Result<WeightStreamer*> WeightStreamer::create(
+    const Program* program,
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    MemoryAllocator* allocator,
+    const WeightStreamingConfig& config) {
+#ifdef USE_ATEN_LIB
+  // An at::Tensor can't be parsed without data to point it at.
+  (void)program;
+  (void)plan;
+  (void)allocator;
+  (void)config;
+  ET_LOG(Error, "Weight streaming is not supported in ATen mode");
+  return Error::NotSupported;
+#else // !USE_ATEN_LIB
+  ET_CHECK_OR_RETURN_ERROR(
+      program->has_constant_segment(),
+      NotSupported,
+      "Weight streaming needs the constants in a segment");
+  const auto* chains = plan->chains();
+  ET_CHECK_OR_RETURN_ERROR(
+      chains != nullptr && chains->size() == 1,
+      NotSupported,
+      "Weight streaming needs a single chain, plan has %zu",
+      static_cast<size_t>(chains != nullptr ? chains->size() : 0));
+  const auto* values = plan->values();
+  ET_CHECK_OR_RETURN_ERROR(
+      values != nullptr, InvalidProgram, "Missing values");
+  const size_t n_value = values->size();
+
+  int32_t* slot_of_value =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(allocator, int32_t, n_value);
+  std::fill(slot_of_value, slot_of_value + n_value, kResident);
+
+  // Find the constants that calls take as arguments. Instructions run in
+  // order, so a constant's uses form one range of them.
+  const auto* instructions = chains->Get(0)->instructions();
+  if (instructions != nullptr) {
+    for (const auto* instruction : *instructions) {
+      switch (instruction->instr_args_type()) {
+        case executorch_flatbuffer::InstructionArguments::KernelCall:
+          mark_candidates(
+              values,
+              instruction->instr_args_as_KernelCall()->args(),
+              slot_of_value);
+          break;
+        case executorch_flatbuffer::InstructionArguments::DelegateCall:
+          mark_candidates(
+              values,
+              instruction->instr_args_as_DelegateCall()->args(),
+              slot_of_value);
+          break;
+        case executorch_flatbuffer::InstructionArguments::MoveCall:
+        case executorch_flatbuffer::InstructionArguments::FreeCall:
+          break;
+        default:
+          ET_LOG(
+              Error,
+              "Weight streaming does not support control flow instruction "
+              "type %" PRIu8,
+              static_cast<uint8_t>(instruction->instr_args_type()));
+          return Error::NotSupported;
+      }
+    }
+    // Values that Move/FreeCalls touch change hands outside of the calls.
+    for (const auto* instruction : *instructions) {
+      if (instruction->instr_args_type() ==
+          executorch_flatbuffer::InstructionArguments::MoveCall) {
+        const auto* move = instruction->instr_args_as_MoveCall();
+        mark_resident(move->move_from(), n_value, slot_of_value);
+        mark_resident(move->move_to(), n_value, slot_of_value);
+      } else if (
+          instruction->instr_args_type() ==
+          executorch_flatbuffer::InstructionArguments::FreeCall) {
+        mark_resident(
+            instruction->instr_args_as_FreeCall()->value_index(),
+            n_value,
+            slot_of_value);
+      }
+    }
+  }
+  // Inputs and outputs are visible to the caller between executions.
+  for (const auto* list : {plan->inputs(), plan->outputs()}) {
+    if (list != nullptr) {
+      for (const int32_t index : *list) {
+        mark_resident(index, n_value, slot_of_value);
+      }
+    }
+  }
+
+  size_t num_slots = 0;
+  for (size_t i = 0; i < n_value; ++i) {
+    if (slot_of_value[i] == kCandidate) {
+      slot_of_value[i] = static_cast<int32_t>(num_slots++);
+    }
+  }
+
+  WeightStreamer* streamer =
+      ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(allocator, WeightStreamer);
+  new (streamer) WeightStreamer(program, plan, config.prefetch_buffers);
+  streamer->slot_of_value_ = slot_of_value;
+  if (num_slots > 0) {
+    Slot* slots = allocator->allocateList<Slot>(num_slots);
+    if (slots == nullptr) {
+      streamer->~WeightStreamer();
+      return Error::MemoryAllocationFailed;
+    }
+    for (size_t i = 0; i < n_value; ++i) {
+      if (slot_of_value[i] >= 0) {
+        new (&slots[slot_of_value[i]]) Slot{
+            values->Get(i)->val_as_Tensor()->constant_buffer_idx(),
+            /*first_use=*/UINT32_MAX,
+            /*last_use=*/0,
+            /*value=*/nullptr,
+            FreeableBuffer()};
+      }
+    }
+    streamer->slots_ = slots;
+    streamer->num_slots_ = num_slots;
+  }
+  return streamer;
+#endif // !USE_ATEN_LIB
+}
+
+WeightStreamer::~WeightStreamer() {
+  for (size_t i = 0; i < num_slots_; ++i) {
+    slots_[i].~Slot();
+  }
+}
+
+void WeightStreamer::note_use(size_t value_index, size_t instr_idx) {
+  const int32_t slot_index = slot_of_value_[value_index];
+  if (slot_index >= 0) {
+    Slot& slot = slots_[slot_index];
+    slot.first_use = std::min(slot.first_use, static_cast<uint32_t>(instr_idx));
+    slot.last_use = std::max(slot.last_use, static_cast<uint32_t>(instr_idx));
+    return;
+  }
+  // Follow lists to the constants in them.
+  const auto* value = plan_->values()->Get(value_index);
+  const flatbuffers::Vector<int32_t>* items = nullptr;
+  if (value->val_type() == executorch_flatbuffer::KernelTypes::TensorList) {
+    items = value->val_as_TensorList()->items();
+  } else if (
+      value->val_type() ==
+      executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+    items = value->val_as_OptionalTensorList()->items();
+  }
+  if (items != nullptr) {
+    for (const int32_t item : *items) {
+      if (item >= 0 && slot_of_value_[item] >= 0) {
+        note_use(static_cast<size_t>(item), instr_idx);
+      }
+    }
+  }
+}
+
+Error WeightStreamer::finish_init(MemoryAllocator* allocator) {
+  if (num_slots_ == 0) {
+    return Error::Ok;
+  }
+  load_order_ =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(allocator, uint32_t, num_slots_);
+  evict_order_ =
+      ET_ALLOCATE_LIST_OR_RETURN_ERROR(allocator, uint32_t, num_slots_);
+  for (size_t i = 0; i < num_slots_; ++i) {
+    Slot& slot = slots_[i];
+    ET_CHECK_OR_RETURN_ERROR(
+        slot.value != nullptr && slot.value->isTensor(),
+        Internal,
+        "Streamed constant buffer %" PRIu32 " was not bound",
+        slot.buffer_index);
+    if (slot.first_use == UINT32_MAX) {
+      // Not used after all; load it for the first instruction only.
+      slot.first_use = 0;
+      slot.last_use = 0;
+    }
+    load_order_[i] = static_cast<uint32_t>(i);
+    evict_order_[i] = static_cast<uint32_t>(i);
+  }
+  std::stable_sort(
+      load_order_, load_order_ + num_slots_, [&](uint32_t a, uint32_t b) {
+        return slots_[a].first_use < slots_[b].first_use;
+      });
+  std::stable_sort(
+      evict_order_, evict_order_ + num_slots_, [&](uint32_t a, uint32_t b) {
+        return slots_[a].last_use < slots_[b].last_use;
+      });
+  // Start reading the first constants so that the first execution doesn't
+  // wait for all of them.
+  for (; prefetch_cursor_ < std::min(prefetch_buffers_, num_slots_);
+       ++prefetch_cursor_) {
+    program_->PrefetchConstantSegmentBuffer(
+        slots_[load_order_[prefetch_cursor_]].buffer_index);
+  }
+  return Error::Ok;
+}
+
+Error WeightStreamer::prepare(size_t instr_idx) {
+  if (num_slots_ == 0) {
+    return Error::Ok;
+  }
+  if (instr_idx < last_instr_idx_) {
+    // A new execution, or a reset one.
+    evict_all();
+  }
+  last_instr_idx_ = instr_idx;
+
+  while (evict_cursor_ < num_slots_ &&
+         slots_[evict_order_[evict_cursor_]].last_use < instr_idx) {
+    evict(slots_[evict_order_[evict_cursor_]]);
+    ++evict_cursor_;
+  }
+  while (load_cursor_ < num_slots_ &&
+         slots_[load_order_[load_cursor_]].first_use <= instr_idx) {
+    Slot& slot = slots_[load_order_[load_cursor_]];
+    if (slot.last_use >= instr_idx) {
+      Error err = load(slot);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+    ++load_cursor_;
+  }
+  // Keep the loader reading the next prefetch_buffers_ constants ahead.
+  prefetch_cursor_ = std::max(prefetch_cursor_, load_cursor_);
+  while (prefetch_cursor_ < num_slots_ &&
+         prefetch_cursor_ < load_cursor_ + prefetch_buffers_) {
+    program_->PrefetchConstantSegmentBuffer(
+        slots_[load_order_[prefetch_cursor_]].buffer_index);
+    ++prefetch_cursor_;
+  }
+  return Error::Ok;
+}
+
+Error WeightStreamer::load(Slot& slot) {
+  EXECUTORCH_SCOPE_PROF("WeightStreamer::load");
+  if (slot.data.data() != nullptr) {
+    return Error::Ok;
+  }
+  Result<FreeableBuffer> data =
+      program_->LoadConstantSegmentBuffer(slot.buffer_index);
+  if (!data.ok()) {
+    ET_LOG(
+        Error,
+        "Failed streaming constant buffer %" PRIu32 ": 0x%" PRIx32,
+        slot.buffer_index,
+        static_cast<uint32_t>(data.error()));
+    return data.error();
+  }
+  // The data is loaded read-only; kernels don't write to constants.
+  Error err = internal::set_tensor_data(
+      slot.value->toTensor(),
+      const_cast<void*>(data->data()),
+      data->size());
+  if (err != Error::Ok) {
+    return err;
+  }
+  resident_bytes_ += data->size();
+  peak_resident_bytes_ = std::max(peak_resident_bytes_, resident_bytes_);
+  // FreeableBuffer can't be move-assigned; the old one is empty.
+  slot.data.~FreeableBuffer();
+  new (&slot.data) FreeableBuffer(std::move(data.get()));
+  return Error::Ok;
+}
+
+void WeightStreamer::evict(Slot& slot) {
+  if (slot.data.data() == nullptr) {
+    return;
+  }
+  // Clear the pointer so that stale uses fail rather than read freed memory.
+  internal::reset_data_ptr(slot.value->toTensor());
+  resident_bytes_ -= slot.data.size();
+  slot.data.Free();
+}
+
+void WeightStreamer::evict_all() {
+  for (size_t i = 0; i < num_slots_; ++i) {
+    evict(slots_[i]);
+  }
+  load_cursor_ = 0;
+  evict_cursor_ = 0;
+  prefetch_cursor_ = 0;
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/evalue.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/executor/method.h>
+
+// Forward declare flatbuffer types.
+namespace executorch_flatbuffer {
+struct ExecutionPlan;
+} // namespace executorch_flatbuffer
+
+namespace torch {
+namespace executor {
+
+class Program;
+
+namespace internal {
+
+/**
+ * Loads the constant tensors of a Method from the program's constant segment
+ * just before the first instruction that uses them, and frees them after the
+ * last one, so that only the weights of the instructions in flight are
+ * resident. See WeightStreamingConfig.
+ *
+ * Only constants that straight-line kernel and delegate calls of the Method's
+ * only chain take as arguments are streamed. The others, e.g. mutable state
+ * or constants that are method outputs, are loaded with the Method as usual.
+ *
+ * Method::init() creates it before parsing the values, parses the streamed
+ * constants without data and bind()s them, then note_use()s every argument of
+ * the decoded instructions and calls finish_init(). Method::execute() calls
+ * prepare() before every instruction.
+ */
+class WeightStreamer final {
+ public:
+  /**
+   * Decides which constants of `plan` to stream.
+   *
+   * @param[in] program The program to load the constants from. Must have a
+   *     constant segment.
+   * @param[in] plan The plan of the Method.
+   * @param[in] allocator The method allocator, for the streamer's own state.
+   * @param[in] config How far ahead to prefetch.
+   *
+   * @retval Error::NotSupported The plan has several chains or control flow,
+   *     or the program keeps its constants in the flatbuffer.
+   */
+  __ET_NODISCARD static Result<WeightStreamer*> create(
+      const Program* program,
+      const executorch_flatbuffer::ExecutionPlan* plan,
+      MemoryAllocator* allocator,
+      const WeightStreamingConfig& config);
+
+  WeightStreamer(const WeightStreamer&) = delete;
+  WeightStreamer& operator=(const WeightStreamer&) = delete;
+
+  /// Frees the constants that are still loaded.
+  ~WeightStreamer();
+
+  /**
+   * Returns true if the tensor at `value_index` of the plan's values is
+   * streamed, in which case it must be parsed without data and then bound.
+   */
+  bool is_streamed(size_t value_index) const {
+    return slot_of_value_[value_index] >= 0;
+  }
+
+  /// Points the streamed constant at `value_index` at its parsed tensor.
+  void bind(size_t value_index, EValue* value) {
+    slots_[slot_of_value_[value_index]].value = value;
+  }
+
+  /**
+   * Records that instruction `instr_idx` of the decoded chain takes the value
+   * at `value_index` as an argument. Lists are followed to their tensors.
+   */
+  void note_use(size_t value_index, size_t instr_idx);
+
+  /// Orders the constants by their uses, once all of them have been noted.
+  __ET_NODISCARD Error finish_init(MemoryAllocator* allocator);
+
+  /**
+   * Makes the constants of instruction `instr_idx` resident: frees those
+   * whose last use has passed, loads those whose first use has come, and
+   * hints the loader about the next ones. Starting over from an earlier
+   * instruction frees everything, so a new execution reloads its constants.
+   */
+  __ET_NODISCARD Error prepare(size_t instr_idx);
+
+  /// Returns the bytes of streamed constants that are currently loaded.
+  size_t resident_bytes() const {
+    return resident_bytes_;
+  }
+
+  /// Returns the most bytes of streamed constants that were ever loaded at
+  /// once.
+  size_t peak_resident_bytes() const {
+    return peak_resident_bytes_;
+  }
+
+ private:
+  /// A streamed constant.
+  struct Slot {
+    /// Tensor.constant_buffer_idx of the constant.
+    uint32_t buffer_index;
+    /// The first and last instructions that use it.
+    uint32_t first_use;
+    uint32_t last_use;
+    /// The parsed tensor, whose data points into `data` while it is loaded.
+    EValue* value;
+    /// The loaded data, or empty.
+    FreeableBuffer data;
+  };
+
+  WeightStreamer(
+      const Program* program,
+      const executorch_flatbuffer::ExecutionPlan* plan,
+      size_t prefetch_buffers)
+      : program_(program), plan_(plan), prefetch_buffers_(prefetch_buffers) {}
+
+  __ET_NODISCARD Error load(Slot& slot);
+  void evict(Slot& slot);
+  void evict_all();
+
+  const Program* program_;
+  const executorch_flatbuffer::ExecutionPlan* plan_;
+  const size_t prefetch_buffers_;
+
+  /// For each of the plan's values, the index of its slot, or -1.
+  int32_t* slot_of_value_ = nullptr;
+  Slot* slots_ = nullptr;
+  size_t num_slots_ = 0;
+
+  /// Slot indices by first use and by last use.
+  uint32_t* load_order_ = nullptr;
+  uint32_t* evict_order_ = nullptr;
+  /// The next entries of load_order_ to load and hint, and of evict_order_ to
+  /// free.
+  size_t load_cursor_ = 0;
+  size_t prefetch_cursor_ = 0;
+  size_t evict_cursor_ = 0;
+  /// The instruction of the last prepare() call.
+  size_t last_instr_idx_ = 0;
+
+  size_t resident_bytes_ = 0;
+  size_t peak_resident_bytes_ = 0;
+};
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
@@ -10,6 +10,10 @@
 
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/event_tracer_hooks.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/core/result.h>
 #include <executorch/runtime/platform/compiler.h>
 
 namespace torch {
@@ -24,10 +28,28 @@ namespace executor {
 class KernelRuntimeContext {
  public:
   /**
-   * Construct a new kernel runtime context along with an optional event tracer.
+   * Construct a new kernel runtime context.
+   *
+   * KernelRuntimeContexts for ExecuTorch kernels are typically created by the
+   * runtime and are passed to the kernels as their first argument.
+   *
+   * @param[in] event_tracer The optional EventTracer to use for
+   *     profiling/debugging
+   * @param[in] temp_allocator The optional MemoryAllocator used to allocate
+   *     temporary memory for the kernel. If not provided, an error will be
+   *     returned when calling allocate_temp.
+   * @param[in] dynamic_allocator The optional MemoryAllocator used to give
+   *     DYNAMIC_UNBOUND tensors more storage when resize_tensor() grows them
+   *     beyond the storage that was planned for them. Memory allocated from
+   *     it must stay valid for as long as the tensors use it.
    */
-  KernelRuntimeContext(EventTracer* event_tracer = nullptr)
-      : event_tracer_(event_tracer) {}
+  KernelRuntimeContext(
+      EventTracer* event_tracer = nullptr,
+      MemoryAllocator* temp_allocator = nullptr,
+      MemoryAllocator* dynamic_allocator = nullptr)
+      : event_tracer_(event_tracer),
+        temp_allocator_(temp_allocator),
+        dynamic_allocator_(dynamic_allocator) {}
   /**
    * Tells the runtime that the kernel call has failed. Prefer this over
    * ET_CHECK_*(), which fatally panics the process/system.
@@ -60,12 +82,130 @@ class KernelRuntimeContext {
     return event_tracer_;
   }
 
-  // TODO(T147221312): Add a way to allocate temporary memory.
+  /**
+   * Allocates temporary memory that will be freed when the kernel returns. This
+   * returns a pointer to the allocated memory or an error if the allocation
+   * fails.
+   *
+   * Memory returned by this method is only valid for the duration of the
+   * current kernel call: the runtime resets the temp allocator after every
+   * instruction, so kernels must not cache these pointers.
+   *
+   * @param[in] size Number of bytes to allocate.
+   * @param[in] alignment Minimum alignment for the returned pointer. Must be a
+   *     power of 2.
+   *
+   * @returns A result object containing either a pointer to the allocated
+   *     memory or an error to indicate failure
+   */
+  Result<void*> allocate_temp(
+      size_t size,
+      size_t alignment = MemoryAllocator::kDefaultAlignment) {
+    ET_CHECK_OR_RETURN_ERROR(
+        temp_allocator_ != nullptr, NotFound, "No temp allocator provided");
+    void* temp_memory = temp_allocator_->allocate(size, alignment);
+    ET_CHECK_OR_RETURN_ERROR(
+        temp_memory != nullptr,
+        MemoryAllocationFailed,
+        "Failed to allocate temp memory. Bytes requested: %zu",
+        size);
+    return temp_memory;
+  }
 
-  // TODO(T147221312): Add a way to resize a tensor.
+  /**
+   * Returns memory from allocate_temp() before the kernel returns, so that
+   * later temp allocations in the same call can reuse it. Whether they do
+   * depends on the temp allocator; see MemoryAllocator::free().
+   *
+   * @param[in] ptr A pointer returned by allocate_temp() during the current
+   *     kernel call, or nullptr.
+   */
+  void free_temp(void* ptr) {
+    if (temp_allocator_ != nullptr) {
+      temp_allocator_->free(ptr);
+    }
+  }
+
+  /**
+   * Resizes a tensor to `new_sizes`. The rank of the tensor must stay the same,
+   * and the new size must fit within the capacity that was planned for it,
+   * unless the tensor is DYNAMIC_UNBOUND and the context has a dynamic
+   * allocator. In that case the tensor is given new storage, at least twice as
+   * large as before so that gradually-growing inputs rarely reallocate, and
+   * its old contents are not preserved.
+   *
+   * Kernels should prefer this over the free function `resize_tensor()` so
+   * that the runtime has a single place to observe and control resizing.
+   *
+   * @param[in] t The tensor to resize.
+   * @param[in] new_sizes The new sizes of the tensor.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  __ET_NODISCARD Error resize_tensor(
+      exec_aten::Tensor t,
+      exec_aten::ArrayRef<exec_aten::SizesType> new_sizes) {
+#ifndef USE_ATEN_LIB
+    // ATen tensors manage their own storage; only lean-mode tensors need to
+    // be given more.
+    auto* impl = t.unsafeGetTensorImpl();
+    if (impl->shape_dynamism() == TensorShapeDynamism::DYNAMIC_UNBOUND) {
+      // A size that wraps around would allocate too little and then pass
+      // the capacity check of TensorImpl.
+      size_t nbytes = impl->element_size();
+      for (auto size : new_sizes) {
+        ET_CHECK_OR_RETURN_ERROR(
+            size >= 0, InvalidArgument, "Negative size %zd", ssize_t(size));
+        ET_CHECK_OR_RETURN_ERROR(
+            !mul_overflows(nbytes, static_cast<size_t>(size), &nbytes),
+            InvalidArgument,
+            "Size of unbounded tensor overflows");
+      }
+      // Memory planning leaves most unbounded tensors without storage.
+      const size_t capacity = impl->data() != nullptr
+          ? internal::tensor_impl_capacity(impl)
+          : 0;
+      if (nbytes > capacity) {
+        ET_CHECK_OR_RETURN_ERROR(
+            dynamic_allocator_ != nullptr,
+            NotSupported,
+            "No dynamic allocator to grow unbounded tensor to %zu bytes",
+            nbytes);
+        size_t new_capacity = nbytes;
+        size_t doubled = 0;
+        if (!mul_overflows(capacity, 2, &doubled) && doubled > nbytes) {
+          new_capacity = doubled;
+        }
+        void* data = dynamic_allocator_->allocate(new_capacity);
+        ET_CHECK_OR_RETURN_ERROR(
+            data != nullptr,
+            MemoryAllocationFailed,
+            "Failed to grow unbounded tensor to %zu bytes",
+            new_capacity);
+        Error err = internal::set_tensor_impl_storage(impl, data, new_capacity);
+        if (err != Error::Ok) {
+          return err;
+        }
+      }
+    }
+#endif // USE_ATEN_LIB
+    return ::torch::executor::resize_tensor(t, new_sizes);
+  }
 
  private:
+  /// Sets `*out` to `a * b`, and returns true if that overflows.
+  static bool mul_overflows(size_t a, size_t b, size_t* out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, out);
+#else
+    *out = a * b;
+    return a != 0 && *out / a != b;
+#endif
+  }
+
   EventTracer* event_tracer_ = nullptr;
+  MemoryAllocator* temp_allocator_ = nullptr;
+  MemoryAllocator* dynamic_allocator_ = nullptr;
   Error failure_state_ = Error::Ok;
 };
 
@@ -17,6 +17,38 @@
 namespace torch {
 namespace executor {
 
+namespace {
+
+constexpr uint32_t kFnvOffsetBasis = 2166136261u;
+constexpr uint32_t kFnvPrime = 16777619u;
+
+/**
+ * Hashes a kernel name and key with FNV-1a. Fallback keys hash like an empty
+ * key string; KernelKey::equals() tells the two apart.
+ *
+ * Only the key bytes before the first NUL or TERMINATOR are hashed. Keys that
+ * compare equal always share that prefix, and stopping at NUL keeps the hash
+ * from reading past the end of keys that are missing their TERMINATOR.
+ */
+uint32_t hash_kernel(const char* name, const KernelKey& kernel_key) {
+  uint32_t hash = kFnvOffsetBasis;
+  for (const char* c = name; *c != '\0'; ++c) {
+    hash = (hash ^ static_cast<uint8_t>(*c)) * kFnvPrime;
+  }
+  // Separate the name from the key.
+  hash = (hash ^ 0u) * kFnvPrime;
+  if (!kernel_key.is_fallback()) {
+    for (const char* c = kernel_key.data();
+         *c != KernelKey::TERMINATOR && *c != '\0';
+         ++c) {
+      hash = (hash ^ static_cast<uint8_t>(*c)) * kFnvPrime;
+    }
+  }
+  return hash;
+}
+
+} // namespace
+
 OperatorRegistry& getOperatorRegistry();
 OperatorRegistry& getOperatorRegistry() {
   static OperatorRegistry operator_registry;
@@ -66,18 +98,26 @@ Error OperatorRegistry::register_kernels(const ArrayRef<Kernel>& kernels) {
   // for debugging purpose
   const char* lib_name = et_pal_get_shared_library_name(kernels.data());
 
+  constexpr uint32_t kMask = kKernelTableSize - 1;
   for (const auto& kernel : kernels) {
-    // linear search. This is fine if the number of kernels are small.
-    for (int32_t i = 0; i < this->num_kernels_; i++) {
-      Kernel k = this->kernels_[i];
+    // Probe for either an existing entry with the same name and key, which is
+    // an error, or the empty slot to insert the new kernel into.
+    uint32_t slot = hash_kernel(kernel.name_, kernel.kernel_key_) & kMask;
+    while (this->kernel_table_[slot] != 0) {
+      const Kernel& k = this->kernels_[this->kernel_table_[slot] - 1];
+      // Variants of a kernel may share its name and key, as long as their
+      // predicates differ.
       if (strcmp(kernel.name_, k.name_) == 0 &&
-          kernel.kernel_key_ == k.kernel_key_) {
+          kernel.kernel_key_ == k.kernel_key_ &&
+          kernel.predicate_ == k.predicate_) {
         ET_LOG(Error, "Re-registering %s, from %s", k.name_, lib_name);
         ET_LOG_KERNEL_KEY(k.kernel_key_);
         return Error::InvalidArgument;
       }
+      slot = (slot + 1) & kMask;
     }
     this->kernels_[this->num_kernels_++] = kernel;
+    this->kernel_table_[slot] = this->num_kernels_;
   }
   ET_LOG(
       Debug,
@@ -114,6 +154,58 @@ static void make_kernel_key_string(ArrayRef<TensorMeta> key, char* buf) {
 
 constexpr int BUF_SIZE = 307;
 
+int32_t OperatorRegistry::find_kernel(
+    const char* name,
+    const KernelKey& kernel_key) const {
+  constexpr uint32_t kMask = kKernelTableSize - 1;
+  uint32_t slot = hash_kernel(name, kernel_key) & kMask;
+  while (this->kernel_table_[slot] != 0) {
+    const uint32_t idx = this->kernel_table_[slot] - 1;
+    const Kernel& k = this->kernels_[idx];
+    if (k.predicate_ == nullptr && strcmp(k.name_, name) == 0 &&
+        k.kernel_key_ == kernel_key) {
+      return static_cast<int32_t>(idx);
+    }
+    slot = (slot + 1) & kMask;
+  }
+  return -1;
+}
+
+int32_t OperatorRegistry::find_kernel_for_args(
+    const char* name,
+    const KernelKey& kernel_key,
+    ArrayRef<EValue*> args,
+    bool* has_predicated) const {
+  constexpr uint32_t kMask = kKernelTableSize - 1;
+  int32_t best = -1;
+  int32_t unpredicated = -1;
+  // Variants with the same name and key hash alike, so they all sit in the
+  // probe sequence before the next empty slot.
+  uint32_t slot = hash_kernel(name, kernel_key) & kMask;
+  while (this->kernel_table_[slot] != 0) {
+    const int32_t idx = static_cast<int32_t>(this->kernel_table_[slot] - 1);
+    const Kernel& k = this->kernels_[idx];
+    slot = (slot + 1) & kMask;
+    if (strcmp(k.name_, name) != 0 || k.kernel_key_ != kernel_key) {
+      continue;
+    }
+    if (k.predicate_ == nullptr) {
+      unpredicated = idx;
+      continue;
+    }
+    *has_predicated = true;
+    if (args.empty() || !k.predicate_(args)) {
+      continue;
+    }
+    // Prefer the most specific variant, then the first registered one.
+    if (best < 0 || k.specificity_ > this->kernels_[best].specificity_ ||
+        (k.specificity_ == this->kernels_[best].specificity_ && idx < best)) {
+      best = idx;
+    }
+  }
+  return best >= 0 ? best : unpredicated;
+}
+
 bool OperatorRegistry::hasOpsFn(
     const char* name,
     ArrayRef<TensorMeta> meta_list) {
@@ -121,16 +213,8 @@ bool OperatorRegistry::hasOpsFn(
   make_kernel_key_string(meta_list, buf);
   KernelKey kernel_key = KernelKey(buf);
 
-  for (size_t idx = 0; idx < this->num_kernels_; idx++) {
-    if (strcmp(this->kernels_[idx].name_, name) == 0) {
-      if (this->kernels_[idx].kernel_key_.is_fallback() ||
-          this->kernels_[idx].kernel_key_ == kernel_key) {
-        return true;
-      }
-    }
-  }
-
-  return false;
+  return find_kernel(name, kernel_key) >= 0 ||
+      find_kernel(name, KernelKey()) >= 0;
 }
 
 const OpFunction& getOpsFn(const char* name, ArrayRef<TensorMeta> kernel_key) {
@@ -144,24 +228,47 @@ const OpFunction& OperatorRegistry::getOpsFn(
   make_kernel_key_string(meta_list, buf);
   KernelKey kernel_key = KernelKey(buf);
 
-  int32_t fallback_idx = -1;
-  for (size_t idx = 0; idx < this->num_kernels_; idx++) {
-    if (strcmp(this->kernels_[idx].name_, name) == 0) {
-      if (this->kernels_[idx].kernel_key_ == kernel_key) {
-        return this->kernels_[idx].op_;
-      }
-      if (this->kernels_[idx].kernel_key_.is_fallback()) {
-        fallback_idx = idx;
-      }
-    }
+  // Prefer a kernel specialized for these tensor types over the fallback.
+  int32_t idx = find_kernel(name, kernel_key);
+  if (idx < 0) {
+    idx = find_kernel(name, KernelKey());
   }
-  if (fallback_idx != -1) {
-    return this->kernels_[fallback_idx].op_;
+  if (idx >= 0) {
+    return this->kernels_[idx].op_;
   }
   ET_CHECK_MSG(false, "kernel '%s' not found.", name);
   ET_LOG_TENSOR_META(meta_list);
 }
 
+const OpFunction* getOpsFnForArgs(
+    const char* name,
+    ArrayRef<TensorMeta> meta_list,
+    ArrayRef<EValue*> args,
+    bool* shape_specialized) {
+  return getOperatorRegistry().getOpsFnForArgs(
+      name, meta_list, args, shape_specialized);
+}
+
+const OpFunction* OperatorRegistry::getOpsFnForArgs(
+    const char* name,
+    ArrayRef<TensorMeta> meta_list,
+    ArrayRef<EValue*> args,
+    bool* shape_specialized) {
+  char buf[BUF_SIZE] = {0};
+  make_kernel_key_string(meta_list, buf);
+  KernelKey kernel_key = KernelKey(buf);
+
+  bool has_predicated = false;
+  int32_t idx = find_kernel_for_args(name, kernel_key, args, &has_predicated);
+  if (idx < 0) {
+    idx = find_kernel_for_args(name, KernelKey(), args, &has_predicated);
+  }
+  if (shape_specialized != nullptr) {
+    *shape_specialized = has_predicated;
+  }
+  return idx >= 0 ? &this->kernels_[idx].op_ : nullptr;
+}
+
 ArrayRef<Kernel> get_kernels() {
   return getOperatorRegistry().get_kernels();
 }
@@ -46,6 +46,13 @@ using OpFunction =
     FunctionRef<void(KernelRuntimeContext&, EValue**)>; // TODO(T165139545):
                                                         // Remove FunctionRef
 
+/**
+ * A condition on the arguments of an operator call, such as "the inner
+ * dimension of the matmul is at most 16", that a shape-specialized kernel
+ * needs to hold. Must not modify the arguments. See Kernel::predicate_.
+ */
+using KernelPredicate = bool (*)(ArrayRef<EValue*> args);
+
 /**
  * Dtype and dim order metadata for a Tensor argument to an operator.
  * Used by the Executor to hold the tensor metadata info and retrieve kernel.
@@ -195,11 +202,33 @@ struct Kernel {
    * itself, we require the lifetime of the operator name to be at least as long
    * as the operator registry.
    */
+  /**
+   * If set, the kernel is a variant that only handles the calls whose
+   * arguments satisfy the predicate, e.g. small matmuls. Such kernels are only
+   * chosen when the shapes of the arguments can't change after loading; see
+   * getOpsFnForArgs(). Several variants may share a name and key, and the one
+   * with the highest `specificity_` among those that match is chosen.
+   */
+  KernelPredicate predicate_ = nullptr;
+  uint32_t specificity_ = 0;
+
   explicit Kernel(const char* name, OpFunction func) : name_(name), op_(func) {}
 
   explicit Kernel(const char* name, KernelKey key, OpFunction func)
       : name_(name), kernel_key_(key), op_(func) {}
 
+  explicit Kernel(
+      const char* name,
+      KernelKey key,
+      OpFunction func,
+      KernelPredicate predicate,
+      uint32_t specificity = 1)
+      : name_(name),
+        kernel_key_(key),
+        op_(func),
+        predicate_(predicate),
+        specificity_(specificity) {}
+
   Kernel() {}
 };
 
@@ -213,6 +242,19 @@ constexpr uint32_t kMaxNumOfKernels = MAX_KERNEL_NUM;
 constexpr uint32_t kMaxNumOfKernels =
     kOperatorTableMaxSize * kMaxNumOfKernelPerOp;
 #endif
+
+namespace internal {
+/// Returns the smallest power of 2 that is greater than or equal to `n`.
+constexpr uint32_t next_power_of_2(uint32_t n, uint32_t p = 1) {
+  return p >= n ? p : next_power_of_2(n, p << 1);
+}
+} // namespace internal
+
+// Number of slots in the registry's kernel hash table. Keeping it at least
+// twice the number of kernels bounds the load factor to 0.5, which keeps
+// linear probe sequences short.
+constexpr uint32_t kKernelTableSize =
+    internal::next_power_of_2(2 * kMaxNumOfKernels);
 /**
  * See OperatorRegistry::hasOpsFn()
  */
@@ -225,6 +267,15 @@ const OpFunction& getOpsFn(
     const char* name,
     ArrayRef<TensorMeta> meta_list = {});
 
+/**
+ * See OperatorRegistry::getOpsFnForArgs()
+ */
+const OpFunction* getOpsFnForArgs(
+    const char* name,
+    ArrayRef<TensorMeta> meta_list,
+    ArrayRef<EValue*> args,
+    bool* shape_specialized = nullptr);
+
 /**
  * See OperatorRegistry::get_kernels()
  */
@@ -239,7 +290,7 @@ __ET_NODISCARD Error register_kernels(const ArrayRef<Kernel>&);
 
 struct OperatorRegistry {
  public:
-  OperatorRegistry() : num_kernels_(0) {}
+  OperatorRegistry() : kernel_table_(), num_kernels_(0) {}
 
   /**
    * Registers the Kernels object (i.e. string name and function reference
@@ -262,13 +313,62 @@ struct OperatorRegistry {
    */
   const OpFunction& getOpsFn(const char* name, ArrayRef<TensorMeta> meta_list);
 
+  /**
+   * Like getOpsFn(), but also considers the kernels that were registered with
+   * a shape predicate. Among the kernels for the dtypes and dim orders of
+   * `meta_list`, or else among the fallback kernels, the most specific one
+   * whose predicate `args` satisfy is chosen, or else the one without a
+   * predicate.
+   *
+   * @param[in] name The operator name.
+   * @param[in] meta_list The dtypes and dim orders of the tensor arguments.
+   * @param[in] args The arguments of the call, to evaluate the predicates on.
+   *     Empty if their shapes may still change, in which case predicated
+   *     kernels are never chosen.
+   * @param[out] shape_specialized If not null, set to whether there are
+   *     predicated kernels to choose from, so that the result depends on
+   *     more than `meta_list`.
+   *
+   * @returns The kernel, or nullptr if there is none.
+   */
+  const OpFunction* getOpsFnForArgs(
+      const char* name,
+      ArrayRef<TensorMeta> meta_list,
+      ArrayRef<EValue*> args,
+      bool* shape_specialized);
+
   /**
    * Return all registered operators.
    */
   ArrayRef<Kernel> get_kernels();
 
  private:
+  /**
+   * Returns the index into kernels_ of the kernel with the given name and key
+   * and no predicate, or -1 if there is no such kernel.
+   */
+  int32_t find_kernel(const char* name, const KernelKey& kernel_key) const;
+
+  /**
+   * Returns the index into kernels_ of the best kernel with the given name
+   * and key for `args`, or -1 if there is none. Sets `*has_predicated` if
+   * there are kernels with predicates among them.
+   */
+  int32_t find_kernel_for_args(
+      const char* name,
+      const KernelKey& kernel_key,
+      ArrayRef<EValue*> args,
+      bool* has_predicated) const;
+
   Kernel kernels_[kMaxNumOfKernels];
+
+  /**
+   * Open-addressing hash table keyed on (name, kernel key). Each slot holds
+   * an index into kernels_ plus one, or zero if the slot is empty. Built at
+   * registration time so that lookups don't scan every registered kernel.
+   */
+  uint32_t kernel_table_[kKernelTableSize];
+
   uint32_t num_kernels_;
 };
 
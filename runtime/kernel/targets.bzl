@@ -38,6 +38,22 @@ def define_common_targets():
         preprocessor_flags = ["-DMAX_KERNEL_NUM=2"],
     )
 
+    # Builds parallel_for() on the threadpool. Without it, kernels that use
+    # parallel_for() run single-threaded, which keeps the threadpool and its
+    # dependencies out of builds that do not want them.
+    use_threadpool = native.read_config("executorch", "use_threadpool", "false") == "true"
+    runtime.cxx_library(
+        name = "thread_parallel_interface",
+        exported_headers = ["thread_parallel_interface.h"],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel",
+        ] if use_threadpool else [],
+    )
+
     for aten_mode in (True, False):
         aten_suffix = "_aten" if aten_mode else ""
 
@@ -54,10 +70,10 @@ def define_common_targets():
             ],
             exported_deps = [
                 "//executorch/runtime/core:core",
+                "//executorch/runtime/core:memory_allocator",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+                "//executorch/runtime/core/exec_aten/util:tensor_util" + aten_suffix,
                 "//executorch/runtime/platform:platform",
-                # TODO(T147221312): This will eventually depend on exec_aten
-                # once KernelRuntimeContext support tensor resizing, which is
-                # why this target supports aten mode.
             ],
         )
 
@@ -9,12 +9,15 @@
 #include <executorch/runtime/kernel/kernel_runtime_context.h>
 
 #include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/memory_allocator.h>
 #include <executorch/runtime/platform/runtime.h>
 #include <gtest/gtest.h>
 
 using namespace ::testing;
 using torch::executor::Error;
 using torch::executor::KernelRuntimeContext;
+using torch::executor::MemoryAllocator;
+using torch::executor::Result;
 
 class KernelRuntimeContextTest : public ::testing::Test {
  public:
@@ -47,3 +50,154 @@ TEST_F(KernelRuntimeContextTest, FailureStateReflectsFailure) {
   context.fail(Error::Ok);
   EXPECT_EQ(context.failure_state(), Error::Ok);
 }
+
+TEST_F(KernelRuntimeContextTest, FailureNoMemoryAllocatorProvided) {
+  KernelRuntimeContext context;
+  Result<void*> allocated_memory = context.allocate_temp(4);
+  EXPECT_EQ(allocated_memory.error(), Error::NotFound);
+}
+
+TEST_F(KernelRuntimeContextTest, SuccessfulMemoryAllocation) {
+  constexpr size_t temp_memory_allocator_pool_size = 4;
+  alignas(MemoryAllocator::kDefaultAlignment)
+      uint8_t temp_memory_allocator_pool[temp_memory_allocator_pool_size];
+  MemoryAllocator temp_allocator(
+      temp_memory_allocator_pool_size, temp_memory_allocator_pool);
+  KernelRuntimeContext context(nullptr, &temp_allocator);
+  Result<void*> allocated_memory = context.allocate_temp(4);
+  EXPECT_EQ(allocated_memory.ok(), true);
+}
+
+TEST_F(KernelRuntimeContextTest, FailureMemoryAllocationInsufficientSpace) {
+  constexpr size_t temp_memory_allocator_pool_size = 4;
+  alignas(MemoryAllocator::kDefaultAlignment)
+      uint8_t temp_memory_allocator_pool[temp_memory_allocator_pool_size];
+  MemoryAllocator temp_allocator(
+      temp_memory_allocator_pool_size, temp_memory_allocator_pool);
+  KernelRuntimeContext context(nullptr, &temp_allocator);
+  Result<void*> allocated_memory = context.allocate_temp(8);
+  EXPECT_EQ(allocated_memory.error(), Error::MemoryAllocationFailed);
+}
+
+#ifndef USE_ATEN_LIB
+TEST_F(KernelRuntimeContextTest, ResizeGrowsUnboundedTensorStorage) {
+  using torch::executor::ScalarType;
+  using torch::executor::Tensor;
+  using torch::executor::TensorImpl;
+  using torch::executor::TensorShapeDynamism;
+
+  float data[2] = {};
+  TensorImpl::SizesType sizes[1] = {2};
+  TensorImpl::DimOrderType dim_order[1] = {0};
+  TensorImpl::StridesType strides[1] = {1};
+  TensorImpl impl(
+      ScalarType::Float,
+      1,
+      sizes,
+      data,
+      dim_order,
+      strides,
+      TensorShapeDynamism::DYNAMIC_UNBOUND);
+  Tensor t(&impl);
+
+  // Without a dynamic allocator the tensor can't outgrow its storage.
+  TensorImpl::SizesType new_sizes[1] = {3};
+  KernelRuntimeContext no_allocator_context;
+  EXPECT_EQ(
+      no_allocator_context.resize_tensor(t, {new_sizes, 1}),
+      Error::NotSupported);
+  EXPECT_EQ(t.size(0), 2);
+
+  constexpr size_t pool_size = 64;
+  alignas(MemoryAllocator::kDefaultAlignment) uint8_t pool[pool_size];
+  MemoryAllocator dynamic_allocator(pool_size, pool);
+  KernelRuntimeContext context(nullptr, nullptr, &dynamic_allocator);
+
+  // Growing moves it to new storage, doubling the capacity.
+  ASSERT_EQ(context.resize_tensor(t, {new_sizes, 1}), Error::Ok);
+  EXPECT_EQ(t.size(0), 3);
+  EXPECT_NE(t.const_data_ptr(), data);
+  const void* grown_data = t.const_data_ptr();
+
+  // Growing within the new capacity doesn't reallocate.
+  new_sizes[0] = 4;
+  ASSERT_EQ(context.resize_tensor(t, {new_sizes, 1}), Error::Ok);
+  EXPECT_EQ(t.const_data_ptr(), grown_data);
+
+  // Fails cleanly once the allocator is exhausted.
+  new_sizes[0] = 64;
+  EXPECT_EQ(
+      context.resize_tensor(t, {new_sizes, 1}), Error::MemoryAllocationFailed);
+  EXPECT_EQ(t.size(0), 4);
+}
+
+TEST_F(KernelRuntimeContextTest, ResizeGivesUnplannedUnboundedTensorStorage) {
+  using torch::executor::ScalarType;
+  using torch::executor::Tensor;
+  using torch::executor::TensorImpl;
+  using torch::executor::TensorShapeDynamism;
+
+  // Memory planning leaves unbounded tensors without storage.
+  TensorImpl::SizesType sizes[1] = {2};
+  TensorImpl::DimOrderType dim_order[1] = {0};
+  TensorImpl::StridesType strides[1] = {1};
+  TensorImpl impl(
+      ScalarType::Float,
+      1,
+      sizes,
+      nullptr,
+      dim_order,
+      strides,
+      TensorShapeDynamism::DYNAMIC_UNBOUND);
+  Tensor t(&impl);
+
+  TensorImpl::SizesType new_sizes[1] = {2};
+  KernelRuntimeContext no_allocator_context;
+  EXPECT_EQ(
+      no_allocator_context.resize_tensor(t, {new_sizes, 1}),
+      Error::NotSupported);
+
+  constexpr size_t pool_size = 64;
+  alignas(MemoryAllocator::kDefaultAlignment) uint8_t pool[pool_size];
+  MemoryAllocator dynamic_allocator(pool_size, pool);
+  KernelRuntimeContext context(nullptr, nullptr, &dynamic_allocator);
+  ASSERT_EQ(context.resize_tensor(t, {new_sizes, 1}), Error::Ok);
+  EXPECT_NE(t.const_data_ptr(), nullptr);
+}
+
+TEST_F(KernelRuntimeContextTest, ResizeRejectsBadUnboundedSizes) {
+  using torch::executor::ScalarType;
+  using torch::executor::Tensor;
+  using torch::executor::TensorImpl;
+  using torch::executor::TensorShapeDynamism;
+
+  float data[4] = {};
+  TensorImpl::SizesType sizes[4] = {1, 1, 1, 4};
+  TensorImpl::DimOrderType dim_order[4] = {0, 1, 2, 3};
+  TensorImpl::StridesType strides[4] = {4, 4, 4, 1};
+  TensorImpl impl(
+      ScalarType::Float,
+      4,
+      sizes,
+      data,
+      dim_order,
+      strides,
+      TensorShapeDynamism::DYNAMIC_UNBOUND);
+  Tensor t(&impl);
+
+  constexpr size_t pool_size = 64;
+  alignas(MemoryAllocator::kDefaultAlignment) uint8_t pool[pool_size];
+  MemoryAllocator dynamic_allocator(pool_size, pool);
+  KernelRuntimeContext context(nullptr, nullptr, &dynamic_allocator);
+
+  TensorImpl::SizesType negative[4] = {1, 1, -1, 4};
+  EXPECT_EQ(context.resize_tensor(t, {negative, 4}), Error::InvalidArgument);
+
+  // The byte size wraps around, and must not pass as a small allocation.
+  constexpr TensorImpl::SizesType kBig = 1 << 30;
+  TensorImpl::SizesType huge[4] = {kBig, kBig, kBig, 16};
+  EXPECT_EQ(context.resize_tensor(t, {huge, 4}), Error::InvalidArgument);
+  EXPECT_EQ(t.size(3), 4);
+  EXPECT_EQ(t.const_data_ptr(), data);
+}
+#endif // USE_ATEN_LIB
@@ -7,6 +7,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <string>
 #include <vector>
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
@@ -290,5 +291,103 @@ TEST_F(OperatorRegistryTest, ExecutorUsesFallbackKernel) {
   ASSERT_EQ(val, 100);
 }
 
+TEST_F(OperatorRegistryTest, LookupWithManyRegisteredKernels) {
+  // Use a local registry so that the global one doesn't fill up, and give each
+  // kernel a distinct name that outlives the registry.
+  constexpr size_t kNumOps = 200;
+  std::vector<std::string> names;
+  names.reserve(kNumOps);
+  std::vector<Kernel> kernels;
+  for (size_t i = 0; i < kNumOps; i++) {
+    names.push_back("test::op_" + std::to_string(i));
+    kernels.emplace_back(
+        names.back().c_str(), [](RuntimeContext&, EValue** stack) {
+          *(stack[0]) = Scalar(1);
+        });
+  }
+  OperatorRegistry registry;
+  EXPECT_EQ(
+      registry.register_kernels(ArrayRef<Kernel>(kernels.data(), kNumOps)),
+      Error::Ok);
+  EXPECT_EQ(registry.get_kernels().size(), kNumOps);
+
+  for (size_t i = 0; i < kNumOps; i++) {
+    EXPECT_TRUE(registry.hasOpsFn(names[i].c_str(), {}));
+  }
+  EXPECT_FALSE(registry.hasOpsFn("test::op_", {}));
+  EXPECT_FALSE(registry.hasOpsFn("test::op_200", {}));
+
+  // Registering any of them again is still detected.
+  EXPECT_EQ(
+      registry.register_kernels(ArrayRef<Kernel>(&kernels[kNumOps / 2], 1)),
+      Error::InvalidArgument);
+}
+
+TEST_F(OperatorRegistryTest, ShapePredicatedKernelVariants) {
+  // The first argument stands in for a shape that the predicates inspect.
+  KernelPredicate small = [](ArrayRef<EValue*> args) {
+    return args[0]->toInt() <= 16;
+  };
+  KernelPredicate tiny = [](ArrayRef<EValue*> args) {
+    return args[0]->toInt() <= 4;
+  };
+  Kernel kernels[] = {
+      Kernel(
+          "test::mm",
+          [](RuntimeContext&, EValue** stack) { *(stack[1]) = Scalar(0); }),
+      Kernel(
+          "test::mm",
+          KernelKey{},
+          [](RuntimeContext&, EValue** stack) { *(stack[1]) = Scalar(1); },
+          small),
+      Kernel(
+          "test::mm",
+          KernelKey{},
+          [](RuntimeContext&, EValue** stack) { *(stack[1]) = Scalar(2); },
+          tiny,
+          /*specificity=*/2),
+      Kernel("test::other", [](RuntimeContext&, EValue**) {}),
+  };
+  OperatorRegistry registry;
+  EXPECT_EQ(registry.register_kernels(kernels), Error::Ok);
+  EXPECT_TRUE(registry.hasOpsFn("test::mm", {}));
+
+  auto run = [&](int64_t size, bool static_shapes) -> int64_t {
+    EValue values[2] = {EValue(size), EValue(Scalar(-1))};
+    EValue* args[2] = {&values[0], &values[1]};
+    bool shape_specialized = false;
+    const OpFunction* func = registry.getOpsFnForArgs(
+        "test::mm",
+        {},
+        static_shapes ? ArrayRef<EValue*>(args, 2) : ArrayRef<EValue*>(),
+        &shape_specialized);
+    EXPECT_NE(func, nullptr);
+    EXPECT_TRUE(shape_specialized);
+    RuntimeContext context{};
+    (*func)(context, args);
+    return values[1].toScalar().to<int64_t>();
+  };
+  // The most specific variant whose predicate holds wins.
+  EXPECT_EQ(run(3, /*static_shapes=*/true), 2);
+  EXPECT_EQ(run(10, /*static_shapes=*/true), 1);
+  EXPECT_EQ(run(100, /*static_shapes=*/true), 0);
+  // Without static shapes, only the kernel without a predicate applies.
+  EXPECT_EQ(run(3, /*static_shapes=*/false), 0);
+
+  bool shape_specialized = true;
+  EXPECT_NE(
+      registry.getOpsFnForArgs("test::other", {}, {}, &shape_specialized),
+      nullptr);
+  EXPECT_FALSE(shape_specialized);
+  EXPECT_EQ(
+      registry.getOpsFnForArgs("test::missing", {}, {}, &shape_specialized),
+      nullptr);
+
+  // A variant with the same predicate is a re-registration.
+  EXPECT_EQ(
+      registry.register_kernels(ArrayRef<Kernel>(&kernels[1], 1)),
+      Error::InvalidArgument);
+}
+
 } // namespace executor
 } // namespace torch
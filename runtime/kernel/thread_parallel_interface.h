@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
+namespace torch {
+namespace executor {
+
+/**
+ * The amount of work, in roughly the cost of one multiply-add, below which
+ * splitting a loop across threads costs more than it saves. Kernels divide
+ * it by the work per index to get the grain size they pass to
+ * parallel_for().
+ */
+constexpr int64_t kParallelWorkPerTask = 32768;
+
+/// Returns the grain size for a loop whose indices each cost `work_per_index`.
+inline int64_t parallel_grain_size(int64_t work_per_index) {
+  return std::max<int64_t>(
+      1, kParallelWorkPerTask / std::max<int64_t>(1, work_per_index));
+}
+
+/**
+ * Calls `f(chunk_begin, chunk_end)` on disjoint chunks that together cover
+ * [begin, end), and returns once every chunk is done. Each chunk has at least
+ * `grain_size` indices, except possibly the last.
+ *
+ * When the kernel library is built with the threadpool (ET_USE_THREADPOOL),
+ * the chunks run on the threads of the shared ThreadPool; otherwise, or
+ * within a NoThreadPoolGuard, or when called from inside another
+ * parallel_for(), `f` is called once on the whole range on this thread.
+ * Chunks may run concurrently, so `f` must only write to state that belongs
+ * to its own indices.
+ */
+template <typename Func>
+inline void parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const Func& f) {
+  if (begin >= end) {
+    return;
+  }
+#ifdef ET_USE_THREADPOOL
+  internal::parallel_for_threadpool(
+      begin,
+      end,
+      grain_size,
+      [](void* context, int64_t chunk_begin, int64_t chunk_end) {
+        (*static_cast<const Func*>(context))(chunk_begin, chunk_end);
+      },
+      const_cast<void*>(static_cast<const void*>(&f)));
+#else
+  (void)grain_size;
+  f(begin, end);
+#endif
+}
+
+} // namespace executor
+} // namespace torch
@@ -56,6 +56,13 @@
 
 #endif // defined(__GNUC__)
 
+/// Hints that the memory at addr will be read soon.
+#if defined(__GNUC__)
+#define __ET_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define __ET_PREFETCH(addr) ((void)(addr))
+#endif // defined(__GNUC__)
+
 #if (__cplusplus) >= 201703L
 
 #define __ET_FALLTHROUGH [[fallthrough]]
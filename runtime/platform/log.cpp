@@ -9,6 +9,7 @@
 #include <executorch/runtime/platform/log.h>
 
 #include <cstdio>
+#include <cstring>
 
 #include <executorch/runtime/platform/compiler.h>
 #include <executorch/runtime/platform/platform.h>
@@ -104,6 +105,69 @@ void vlogf(
 #endif // ET_LOG_ENABLED
 }
 
+#if ET_LOG_ENABLED && ET_LOG_DEFERRED
+
+/// Offset of the header fields of a deferred log record.
+static constexpr size_t kRecordLevelOffset = 0;
+static constexpr size_t kRecordFlagsOffset = 1;
+static constexpr size_t kRecordSiteIdOffset = 2;
+static constexpr size_t kRecordTimestampOffset = 6;
+static constexpr size_t kRecordHeaderLength = 14;
+
+/// Set in the flags of a record whose arguments did not all fit.
+static constexpr uint8_t kRecordTruncated = 1;
+
+LogRecordWriter::LogRecordWriter(LogLevel level, uint32_t site_id)
+    : len_(kRecordHeaderLength) {
+  const et_pal_log_level_t pal_level =
+      (int(level) >= 0 && level < LogLevel::NumLevels)
+      ? kLevelToPal[size_t(level)]
+      : et_pal_log_level_t::kUnknown;
+  const et_timestamp_t timestamp = getLogTimestamp();
+  buf_[kRecordLevelOffset] = static_cast<uint8_t>(pal_level);
+  buf_[kRecordFlagsOffset] = 0;
+  memcpy(buf_ + kRecordSiteIdOffset, &site_id, sizeof(site_id));
+  memcpy(buf_ + kRecordTimestampOffset, &timestamp, sizeof(timestamp));
+}
+
+void LogRecordWriter::add(const char* str) {
+  if (str == nullptr) {
+    add_value('p', uint64_t(0));
+    return;
+  }
+  size_t length = strlen(str);
+  if (length > UINT8_MAX) {
+    length = UINT8_MAX;
+    buf_[kRecordFlagsOffset] |= kRecordTruncated;
+  }
+  if (!reserve(2)) {
+    return;
+  }
+  // Keep as much of the string as fits.
+  if (len_ + 2 + length > kMaxLogRecordLength) {
+    length = kMaxLogRecordLength - len_ - 2;
+    buf_[kRecordFlagsOffset] |= kRecordTruncated;
+  }
+  buf_[len_++] = 's';
+  buf_[len_++] = static_cast<uint8_t>(length);
+  memcpy(buf_ + len_, str, length);
+  len_ += length;
+}
+
+bool LogRecordWriter::reserve(size_t size) {
+  if (len_ + size > kMaxLogRecordLength) {
+    buf_[kRecordFlagsOffset] |= kRecordTruncated;
+    return false;
+  }
+  return true;
+}
+
+void LogRecordWriter::emit() {
+  et_pal_emit_log_record(buf_, len_);
+}
+
+#endif // ET_LOG_ENABLED && ET_LOG_DEFERRED
+
 } // namespace internal
 } // namespace executor
 } // namespace torch
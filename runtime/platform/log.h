@@ -15,7 +15,10 @@
 
 #include <cstdarg>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <type_traits>
 
 #include <executorch/runtime/platform/compiler.h>
 #include <executorch/runtime/platform/types.h>
@@ -33,6 +36,27 @@
 #define ET_LOG_ENABLED 1
 #endif // !defined(ET_LOG_ENABLED)
 
+/*
+ * Deferred logging: instead of formatting messages, ET_LOG emits binary
+ * records that hold an ID of the format string and the raw arguments, to be
+ * formatted offline by sdk/log_decoder. This removes the formatting code and
+ * cost, and keeps the format strings out of the data the program reads.
+ *
+ * The file, line and format string of each ET_LOG go to the `et_log_sites`
+ * section, which is not loaded with the program, and the ID of a message is a
+ * hash of them computed at compile time. The section can be dumped from the
+ * linked binary with
+ * `objcopy --dump-section et_log_sites=<sites.bin> <binary>`.
+ * Requires an ELF toolchain, and string literal formats.
+ */
+#ifndef ET_LOG_DEFERRED
+#define ET_LOG_DEFERRED 0
+#endif // !defined(ET_LOG_DEFERRED)
+
+#if ET_LOG_ENABLED && ET_LOG_DEFERRED && defined(__APPLE__)
+#error "ET_LOG_DEFERRED needs an ELF toolchain"
+#endif
+
 namespace torch {
 namespace executor {
 
@@ -74,6 +98,17 @@ enum class LogLevel : uint8_t {
 
 namespace internal {
 
+/**
+ * True if ET_LOG messages at `Level` are compiled in, i.e. if `Level` is at
+ * least ET_MIN_LOG_LEVEL. A constant member rather than a function, so that
+ * compilers drop the disabled messages even without optimization.
+ */
+template <LogLevel Level>
+struct LogLevelEnabled {
+  static constexpr bool value = static_cast<uint32_t>(Level) >=
+      static_cast<uint32_t>(LogLevel::ET_MIN_LOG_LEVEL);
+};
+
 /**
  * Get the current timestamp to construct a log event.
  *
@@ -133,12 +168,184 @@ inline void logf(
 #endif // ET_LOG_ENABLED
 }
 
+#if ET_LOG_ENABLED && ET_LOG_DEFERRED
+
+/// Maximum length of a deferred log record.
+constexpr size_t kMaxLogRecordLength = 128;
+
+/**
+ * Builds a deferred log record and emits it with et_pal_emit_log_record().
+ *
+ * A record is a header followed by the arguments, in native byte order
+ * (sdk/log_decoder expects little-endian):
+ * - uint8_t: the et_pal_log_level_t of the message.
+ * - uint8_t: flags; bit 0 is set if arguments were dropped to fit the record.
+ * - uint32_t: the ID of the message; see log_site_id().
+ * - uint64_t: the timestamp of the message in system ticks.
+ * - For each argument, a tag byte and its value: 'i' and an int64_t for
+ *   signed integers, 'u' and a uint64_t for unsigned integers, 'f' and a
+ *   double, 'p' and a uint64_t for pointers, or 's', a uint8_t length and the
+ *   characters for strings.
+ *
+ * Note: This is an internal class. Use the `ET_LOG` macro instead.
+ */
+class LogRecordWriter {
+ public:
+  LogRecordWriter(LogLevel level, uint32_t site_id);
+
+  template <typename T>
+  typename std::enable_if<
+      std::is_integral<T>::value && std::is_signed<T>::value>::type
+  add(T value) {
+    add_value('i', static_cast<int64_t>(value));
+  }
+
+  template <typename T>
+  typename std::enable_if<
+      std::is_integral<T>::value && !std::is_signed<T>::value>::type
+  add(T value) {
+    add_value('u', static_cast<uint64_t>(value));
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_enum<T>::value>::type add(T value) {
+    add(static_cast<typename std::underlying_type<T>::type>(value));
+  }
+
+  void add(double value) {
+    add_value('f', value);
+  }
+
+  void add(const char* str);
+
+  void add(char* str) {
+    add(static_cast<const char*>(str));
+  }
+
+  template <typename T>
+  void add(T* ptr) {
+    add_value('p', static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)));
+  }
+
+  void add(std::nullptr_t) {
+    add_value('p', uint64_t(0));
+  }
+
+  /// Emits the record.
+  void emit();
+
+ private:
+  template <typename T>
+  void add_value(char tag, T value) {
+    if (!reserve(1 + sizeof(value))) {
+      return;
+    }
+    buf_[len_++] = static_cast<uint8_t>(tag);
+    memcpy(buf_ + len_, &value, sizeof(value));
+    len_ += sizeof(value);
+  }
+
+  /// Returns true if `size` more bytes fit, and flags the record otherwise.
+  bool reserve(size_t size);
+
+  uint8_t buf_[kMaxLogRecordLength];
+  size_t len_;
+};
+
+inline void add_log_args(__ET_UNUSED LogRecordWriter& writer) {}
+
+template <typename T, typename... Args>
+void add_log_args(LogRecordWriter& writer, const T& arg, const Args&... args) {
+  writer.add(arg);
+  add_log_args(writer, args...);
+}
+
+/**
+ * Returns the ID of a deferred log message: the 32-bit FNV-1a hash of its
+ * file, line and format, separated by NULs.
+ */
+template <size_t N>
+constexpr uint32_t log_site_id(const char (&site)[N]) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i + 1 < N; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(site[i])) * 16777619u;
+  }
+  return hash;
+}
+
+/**
+ * Lets the compiler check the arguments of deferred log messages against
+ * their format. Only used in unevaluated operands, so it has no definition.
+ */
+__ET_PRINTFLIKE(1, 2) int check_log_format(const char* format, ...);
+
+/**
+ * Emit a deferred log record.
+ *
+ * Note: This is an internal function. Use the `ET_LOG` macro instead.
+ *
+ * @param[in] level Log severity level.
+ * @param[in] site_id The ID of the message.
+ * @param[in] args The arguments of the message.
+ */
+template <typename... Args>
+void log_deferred(LogLevel level, uint32_t site_id, const Args&... args) {
+  LogRecordWriter writer(level, site_id);
+  add_log_args(writer, args...);
+  writer.emit();
+}
+
+#endif // ET_LOG_ENABLED && ET_LOG_DEFERRED
+
 } // namespace internal
 
 } // namespace executor
 } // namespace torch
 
-#if ET_LOG_ENABLED
+#if ET_LOG_ENABLED && ET_LOG_DEFERRED
+
+#define ET_INTERNAL_LOG_STRINGIFY_(_x) #_x
+#define ET_INTERNAL_LOG_STRINGIFY(_x) ET_INTERNAL_LOG_STRINGIFY_(_x)
+
+/**
+ * Log a message at the given log severity level, as a deferred log record.
+ * The format must be a string literal.
+ *
+ * The file, line and format of the message are emitted to the et_log_sites
+ * section with basic asm, which unlike a `section` attribute works the same
+ * in inline functions and templates. The assembler reads the format through
+ * #_format, which keeps its escapes. The asm is in a lambda because constexpr
+ * functions, which may log, cannot contain asm before C++20.
+ *
+ * @param[in] _level Log severity level.
+ * @param[in] _format Log message format string.
+ */
+#define ET_LOG(_level, _format, ...)                                       \
+  ({                                                                       \
+    if (torch::executor::internal::LogLevelEnabled<                        \
+            torch::executor::LogLevel::_level>::value) {                   \
+      [] {                                                                 \
+        __asm__(                                                           \
+            ".pushsection et_log_sites,\"\",%progbits\n\t"                 \
+            ".asciz " ET_INTERNAL_LOG_STRINGIFY(__FILE__) "\n\t"           \
+            ".asciz \"" ET_INTERNAL_LOG_STRINGIFY(__LINE__) "\"\n\t"       \
+            ".asciz " #_format "\n\t"                                      \
+            ".popsection");                                                \
+      }();                                                                 \
+      (void)sizeof(torch::executor::internal::check_log_format(            \
+          _format, ##__VA_ARGS__));                                        \
+      torch::executor::internal::log_deferred(                             \
+          torch::executor::LogLevel::_level,                               \
+          std::integral_constant<                                          \
+              uint32_t,                                                    \
+              torch::executor::internal::log_site_id(                      \
+                  __FILE__ "\0" ET_INTERNAL_LOG_STRINGIFY(                 \
+                      __LINE__) "\0" _format)>::value,                     \
+          ##__VA_ARGS__);                                                  \
+    }                                                                      \
+  })
+
+#elif ET_LOG_ENABLED
 
 /**
  * Log a message at the given log severity level.
@@ -146,21 +353,19 @@ inline void logf(
  * @param[in] _level Log severity level.
  * @param[in] _format Log message format string.
  */
-#define ET_LOG(_level, _format, ...)                                          \
-  ({                                                                          \
-    et_timestamp_t _timestamp = torch::executor::internal::getLogTimestamp(); \
-    auto _log_level = torch::executor::LogLevel::_level;                      \
-    if (static_cast<uint32_t>(_log_level) >=                                  \
-        static_cast<uint32_t>(torch::executor::LogLevel::ET_MIN_LOG_LEVEL)) { \
-      torch::executor::internal::logf(                                        \
-          _log_level,                                                         \
-          _timestamp,                                                         \
-          __ET_SHORT_FILENAME,                                                \
-          __ET_FUNCTION,                                                      \
-          __ET_LINE,                                                          \
-          _format,                                                            \
-          ##__VA_ARGS__);                                                     \
-    }                                                                         \
+#define ET_LOG(_level, _format, ...)                                      \
+  ({                                                                      \
+    if (torch::executor::internal::LogLevelEnabled<                       \
+            torch::executor::LogLevel::_level>::value) {                  \
+      torch::executor::internal::logf(                                    \
+          torch::executor::LogLevel::_level,                              \
+          torch::executor::internal::getLogTimestamp(),                   \
+          __ET_SHORT_FILENAME,                                            \
+          __ET_FUNCTION,                                                  \
+          __ET_LINE,                                                      \
+          _format,                                                        \
+          ##__VA_ARGS__);                                                 \
+    }                                                                     \
   })
 
 #else // ET_LOG_ENABLED
@@ -58,6 +58,55 @@ __ET_NORETURN void et_pal_abort(void) ET_INTERNAL_PLATFORM_WEAKNESS;
  */
 et_timestamp_t et_pal_current_ticks(void) ET_INTERNAL_PLATFORM_WEAKNESS;
 
+/**
+ * The ratio that converts et_pal_current_ticks() ticks to nanoseconds:
+ * `ns = ticks * numerator / denominator`.
+ */
+typedef struct {
+  uint64_t numerator;
+  uint64_t denominator;
+} et_tick_ratio_t;
+
+/**
+ * Return the duration of a tick of et_pal_current_ticks(), as a ratio that
+ * converts ticks to nanoseconds. The ratio is constant after et_pal_init().
+ * Platforms that override et_pal_current_ticks() should override this too.
+ *
+ * @retval The ticks-to-nanoseconds ratio, or {0, 0} if the platform does not
+ *     know the duration of its ticks.
+ */
+et_tick_ratio_t et_pal_ticks_to_ns_multiplier(void)
+    ET_INTERNAL_PLATFORM_WEAKNESS;
+
+/**
+ * Hardware performance counters that et_pal_read_perf_counters() may read.
+ * Values index the array passed to it.
+ */
+typedef enum {
+  kPerfCounterCycles = 0,
+  kPerfCounterInstructions = 1,
+  kPerfCounterL1DReadMisses = 2,
+  kPerfCounterLLCReadMisses = 3,
+  kNumPerfCounters,
+} et_pal_perf_counter_t;
+
+/**
+ * Read the calling thread's hardware performance counters.
+ *
+ * The counters are free-running, so callers measure a region of code by
+ * subtracting two reads. The counters may be set up lazily by the first call
+ * on each thread.
+ *
+ * @param[out] values Array of kNumPerfCounters entries, indexed by
+ *     et_pal_perf_counter_t. Entries for counters that were not read are left
+ *     unchanged.
+ *
+ * @retval A bitmask with bit `1 << counter` set for every counter that was
+ *     read into `values`, or 0 if the platform does not support counters.
+ */
+uint32_t et_pal_read_perf_counters(uint64_t* values)
+    ET_INTERNAL_PLATFORM_WEAKNESS;
+
 /**
  * Severity level of a log message. Values must map to printable 7-bit ASCII
  * uppercase letters.
@@ -91,4 +140,17 @@ void et_pal_emit_log_message(
     const char* message,
     size_t length) ET_INTERNAL_PLATFORM_WEAKNESS;
 
+/**
+ * Emit a binary log record via platform output, in builds with
+ * ET_LOG_DEFERRED. The record holds the ID of the message and its raw
+ * arguments instead of the formatted message; see
+ * torch::executor::internal::LogRecordWriter in log.h for the layout, and
+ * sdk/log_decoder for decoding it offline.
+ *
+ * @param[in] record The log record.
+ * @param[in] length The length of the record in bytes.
+ */
+void et_pal_emit_log_record(const void* record, size_t length)
+    ET_INTERNAL_PLATFORM_WEAKNESS;
+
 } // extern "C"
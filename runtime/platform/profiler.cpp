@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/compiler.h>
 #include <executorch/runtime/platform/hooks.h>
 #include <executorch/runtime/platform/platform.h>
 #include <executorch/runtime/platform/profiler.h>
@@ -18,23 +19,168 @@ namespace torch {
 namespace executor {
 
 namespace {
-static uint8_t prof_buf[prof_buf_size * MAX_PROFILE_BLOCKS];
+static uint8_t prof_buf[prof_agg_buf_size + prof_buf_size * MAX_PROFILE_BLOCKS];
+// Base pointer for the profiling blocks, which follow the aggregated section.
+static uint8_t* const prof_blocks_buf = prof_buf + prof_agg_buf_size;
 // Base pointer for header
 static prof_header_t* prof_header =
-    (prof_header_t*)((uintptr_t)prof_buf + prof_header_offset);
+    (prof_header_t*)((uintptr_t)prof_blocks_buf + prof_header_offset);
 // Base pointer for profiling entries
 static prof_event_t* prof_arr =
-    (prof_event_t*)((uintptr_t)prof_buf + prof_events_offset);
+    (prof_event_t*)((uintptr_t)prof_blocks_buf + prof_events_offset);
 // Base pointer for memory allocator info array
 static prof_allocator_t* mem_allocator_arr =
-    (prof_allocator_t*)((uintptr_t)prof_buf + prof_mem_alloc_info_offset);
+    (prof_allocator_t*)((uintptr_t)prof_blocks_buf +
+                        prof_mem_alloc_info_offset);
 // Base pointer for memory profiling entries
 static mem_prof_event_t* mem_prof_arr =
-    (mem_prof_event_t*)((uintptr_t)prof_buf + prof_mem_alloc_events_offset);
+    (mem_prof_event_t*)((uintptr_t)prof_blocks_buf +
+                        prof_mem_alloc_events_offset);
 
 static uint32_t num_blocks = 0;
+// Index of the block that events are currently logged in.
+static uint32_t curr_block_idx = 0;
 static bool prof_stats_dumped = false;
 prof_state_t profile_state_tls{-1, 0u};
+
+#ifdef PROFILING_AGGREGATE
+static prof_agg_header_t* const prof_agg_header = (prof_agg_header_t*)prof_buf;
+static prof_agg_event_t* const prof_agg_arr =
+    (prof_agg_event_t*)((uintptr_t)prof_buf + sizeof(prof_agg_header_t));
+
+// Open-addressing hash table from an event's key to its index in
+// prof_agg_arr plus one, 0 meaning empty. Having twice as many slots as
+// entries keeps the probe sequences short and guarantees a free slot.
+constexpr uint32_t kNumAggSlots = 2 * MAX_PROFILE_AGG_ENTRIES;
+static uint32_t prof_agg_slots[kNumAggSlots];
+// The name pointers passed to begin_profiling(), which are usually string
+// literals, to skip comparing the names in the common case.
+static const char* prof_agg_names[MAX_PROFILE_AGG_ENTRIES];
+
+// The aggregated entry is full, so the event is dropped.
+constexpr uint32_t kAggNoEntry = UINT32_MAX;
+// The stats were reset while the event was open, so it is ignored.
+constexpr uint32_t kAggStaleEntry = UINT32_MAX - 1;
+
+typedef struct {
+  uint64_t start_time;
+  uint32_t entry;
+  bool in_use;
+} prof_agg_open_event_t;
+
+// Events between begin_profiling() and end_profiling(). The token returned by
+// begin_profiling() is the index into this array.
+static prof_agg_open_event_t prof_agg_open_events[MAX_PROFILE_AGG_OPEN_EVENTS];
+
+uint32_t hash_agg_key(const char* name, const prof_state_t& state) {
+  // 32-bit FNV-1a over the (truncated) name and the rest of the key.
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < PROF_NAME_MAX_LEN && name[i] != '\0'; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(name[i])) * 16777619u;
+  }
+  const uint32_t words[] = {
+      curr_block_idx,
+      static_cast<uint32_t>(state.chain_idx),
+      state.instruction_idx};
+  for (uint32_t word : words) {
+    hash = (hash ^ word) * 16777619u;
+  }
+  return hash;
+}
+
+uint32_t find_or_add_agg_entry(const char* name, const prof_state_t& state) {
+  const uint32_t hash = hash_agg_key(name, state);
+  for (uint32_t probe = 0; probe < kNumAggSlots; ++probe) {
+    uint32_t& slot = prof_agg_slots[(hash + probe) % kNumAggSlots];
+    if (slot == 0) {
+      if (prof_agg_header->entries >= MAX_PROFILE_AGG_ENTRIES) {
+        return kAggNoEntry;
+      }
+      const uint32_t entry_idx = prof_agg_header->entries++;
+      prof_agg_event_t& entry = prof_agg_arr[entry_idx];
+      memset(&entry, 0, sizeof(entry));
+      strncpy(entry.name, name, PROF_NAME_MAX_LEN);
+      entry.chain_idx = state.chain_idx;
+      entry.instruction_idx = state.instruction_idx;
+      entry.block_idx = curr_block_idx;
+      entry.min = UINT64_MAX;
+      prof_agg_names[entry_idx] = name;
+      slot = entry_idx + 1;
+      return entry_idx;
+    }
+    const uint32_t entry_idx = slot - 1;
+    const prof_agg_event_t& entry = prof_agg_arr[entry_idx];
+    if (entry.block_idx == curr_block_idx &&
+        entry.chain_idx == state.chain_idx &&
+        entry.instruction_idx == state.instruction_idx &&
+        (prof_agg_names[entry_idx] == name ||
+         strncmp(entry.name, name, PROF_NAME_MAX_LEN) == 0)) {
+      return entry_idx;
+    }
+  }
+  return kAggNoEntry;
+}
+
+// Returns the histogram bucket that a duration falls into.
+uint32_t agg_bucket(uint64_t duration) {
+  constexpr uint64_t kSubBuckets = 1u << PROF_AGG_SUB_BUCKET_BITS;
+  if (duration < kSubBuckets) {
+    return static_cast<uint32_t>(duration);
+  }
+  const uint32_t msb = 63 - __builtin_clzll(duration);
+  const uint64_t sub_bucket =
+      (duration >> (msb - PROF_AGG_SUB_BUCKET_BITS)) & (kSubBuckets - 1);
+  const uint64_t bucket =
+      (msb - PROF_AGG_SUB_BUCKET_BITS + 1) * kSubBuckets + sub_bucket;
+  return bucket < PROF_AGG_NUM_BUCKETS ? static_cast<uint32_t>(bucket)
+                                       : PROF_AGG_NUM_BUCKETS - 1;
+}
+
+void reset_agg_stats() {
+  prof_agg_header->entries = 0;
+  prof_agg_header->dropped_events = 0;
+  memset(prof_agg_slots, 0, sizeof(prof_agg_slots));
+  for (size_t i = 0; i < MAX_PROFILE_AGG_OPEN_EVENTS; ++i) {
+    prof_agg_open_events[i].entry = kAggStaleEntry;
+  }
+}
+#endif // PROFILING_AGGREGATE
+
+// Returns the index of the existing block that a new block called `name`
+// should log into, or num_blocks if it needs a block of its own.
+uint32_t find_reusable_block(__ET_UNUSED const char* name) {
+#ifdef PROFILING_AGGREGATE
+  // Iterations of a block are aggregated, so go back to the block with the
+  // same name. Its memory events are replaced by the ones of this iteration.
+  for (uint32_t i = 0; i < num_blocks; ++i) {
+    const prof_header_t* header =
+        (const prof_header_t*)(prof_blocks_buf + i * prof_buf_size);
+    if (strncmp(header->name, name, PROF_NAME_MAX_LEN) == 0) {
+      return i;
+    }
+  }
+#endif // PROFILING_AGGREGATE
+  return num_blocks;
+}
+
+bool current_block_in_use() {
+#ifdef PROFILING_AGGREGATE
+  // Aggregated events refer to their block by index, so a block is never
+  // reused for another name.
+  return true;
+#else // PROFILING_AGGREGATE
+  return prof_header->prof_entries != 0 || prof_header->mem_prof_entries != 0 ||
+      prof_header->allocator_entries != 0;
+#endif // PROFILING_AGGREGATE
+}
+
+// Clears the events logged in the current profiling block.
+void reset_block_stats() {
+  prof_stats_dumped = false;
+  prof_header->prof_entries = 0;
+  prof_header->allocator_entries = 0;
+  prof_header->mem_prof_entries = 0;
+}
 } // namespace
 
 const prof_state_t& get_profile_tls_state() {
@@ -56,6 +202,24 @@ ExecutorchProfilerInstructionScope::~ExecutorchProfilerInstructionScope() {
 }
 
 uint32_t begin_profiling(const char* name) {
+#ifdef PROFILING_AGGREGATE
+  // Events are almost always nested, so the first free slot is usually right
+  // above the innermost open event.
+  uint32_t token = 0;
+  while (token < MAX_PROFILE_AGG_OPEN_EVENTS &&
+         prof_agg_open_events[token].in_use) {
+    ++token;
+  }
+  ET_CHECK_MSG(
+      token < MAX_PROFILE_AGG_OPEN_EVENTS,
+      "More than %d profiling events are open. Increase MAX_PROFILE_AGG_OPEN_EVENTS and re-compile.",
+      MAX_PROFILE_AGG_OPEN_EVENTS);
+  prof_agg_open_event_t& open_event = prof_agg_open_events[token];
+  open_event.entry = find_or_add_agg_entry(name, get_profile_tls_state());
+  open_event.in_use = true;
+  open_event.start_time = et_pal_current_ticks();
+  return token;
+#else // PROFILING_AGGREGATE
   ET_CHECK_MSG(
       prof_header->prof_entries < MAX_PROFILE_EVENTS,
       "Out of profiling buffer space. Increase MAX_PROFILE_EVENTS and re-compile.");
@@ -70,24 +234,57 @@ uint32_t begin_profiling(const char* name) {
   // any of the overhead in this function.
   prof_arr[curr_counter].start_time = et_pal_current_ticks();
   return curr_counter;
+#endif // PROFILING_AGGREGATE
 }
 
 void end_profiling(uint32_t token_id) {
+#ifdef PROFILING_AGGREGATE
+  const uint64_t end_time = et_pal_current_ticks();
+  ET_CHECK_MSG(
+      token_id < MAX_PROFILE_AGG_OPEN_EVENTS &&
+          prof_agg_open_events[token_id].in_use,
+      "Invalid token id.");
+  prof_agg_open_event_t& open_event = prof_agg_open_events[token_id];
+  open_event.in_use = false;
+  if (open_event.entry == kAggStaleEntry) {
+    return;
+  }
+  if (open_event.entry == kAggNoEntry) {
+    prof_agg_header->dropped_events++;
+    return;
+  }
+  prof_agg_event_t& entry = prof_agg_arr[open_event.entry];
+  const uint64_t duration = end_time - open_event.start_time;
+  entry.count++;
+  entry.sum += duration;
+  entry.min = duration < entry.min ? duration : entry.min;
+  entry.max = duration > entry.max ? duration : entry.max;
+  entry.buckets[agg_bucket(duration)]++;
+#else // PROFILING_AGGREGATE
   ET_CHECK_MSG(token_id < MAX_PROFILE_EVENTS, "Invalid token id.");
   prof_arr[token_id].end_time = et_pal_current_ticks();
+#endif // PROFILING_AGGREGATE
 }
 
 void dump_profile_stats(prof_result_t* prof_result) {
   prof_result->prof_data = (uint8_t*)prof_buf;
-  prof_result->num_bytes = num_blocks * prof_buf_size;
+  prof_result->num_bytes = prof_agg_buf_size + num_blocks * prof_buf_size;
   prof_result->num_blocks = num_blocks;
 
+#ifdef PROFILING_AGGREGATE
+  prof_agg_header->prof_ver = ET_PROF_AGG_VER;
+  prof_agg_header->num_buckets = PROF_AGG_NUM_BUCKETS;
+  prof_agg_header->sub_bucket_bits = PROF_AGG_SUB_BUCKET_BITS;
+  prof_agg_header->max_entries = MAX_PROFILE_AGG_ENTRIES;
+#endif // PROFILING_AGGREGATE
+
   if (!prof_stats_dumped) {
     for (size_t i = 0; i < num_blocks; i++) {
       prof_header_t* prof_header_local =
-          (prof_header_t*)(prof_buf + prof_buf_size * i);
+          (prof_header_t*)(prof_blocks_buf + prof_buf_size * i);
       prof_event_t* prof_event_local =
-          (prof_event_t*)(prof_buf + prof_buf_size * i + prof_events_offset);
+          (prof_event_t*)(prof_blocks_buf + prof_buf_size * i +
+                          prof_events_offset);
       // Copy over the string names into the space allocated in prof_event_t. We
       // avoided doing this earlier to keep the overhead in begin_profiling and
       // end_profiling as low as possible.
@@ -108,10 +305,10 @@ void dump_profile_stats(prof_result_t* prof_result) {
 }
 
 void reset_profile_stats() {
-  prof_stats_dumped = false;
-  prof_header->prof_entries = 0;
-  prof_header->allocator_entries = 0;
-  prof_header->mem_prof_entries = 0;
+  reset_block_stats();
+#ifdef PROFILING_AGGREGATE
+  reset_agg_stats();
+#endif // PROFILING_AGGREGATE
 }
 
 void track_allocation(int32_t id, uint32_t size) {
@@ -145,22 +342,27 @@ uint32_t track_allocator(const char* name) {
 }
 
 void profiling_create_block(const char* name) {
-  // If the current profiling block is not used then continue to use this, if
-  // not move onto the next block.
-  if (prof_header->prof_entries != 0 || prof_header->mem_prof_entries != 0 ||
-      prof_header->allocator_entries != 0 || num_blocks == 0) {
-    num_blocks += 1;
-    ET_CHECK_MSG(
-        num_blocks <= MAX_PROFILE_BLOCKS,
-        "Only %d blocks are supported and they've all been used up but %d is used. Increment MAX_PROFILE_BLOCKS and re-run",
-        MAX_PROFILE_BLOCKS,
-        num_blocks);
+  const uint32_t reused_block_idx = find_reusable_block(name);
+  if (reused_block_idx < num_blocks) {
+    curr_block_idx = reused_block_idx;
+  } else {
+    // If the current profiling block is not used then continue to use this,
+    // if not move onto the next block.
+    if (current_block_in_use() || num_blocks == 0) {
+      num_blocks += 1;
+      ET_CHECK_MSG(
+          num_blocks <= MAX_PROFILE_BLOCKS,
+          "Only %d blocks are supported and they've all been used up but %d is used. Increment MAX_PROFILE_BLOCKS and re-run",
+          MAX_PROFILE_BLOCKS,
+          num_blocks);
+    }
+    curr_block_idx = num_blocks - 1;
   }
 
   // Copy over the name of this profiling block.
   size_t str_len =
       strlen(name) >= PROF_NAME_MAX_LEN ? PROF_NAME_MAX_LEN : strlen(name);
-  uintptr_t base = (uintptr_t)prof_buf + (num_blocks - 1) * prof_buf_size;
+  uintptr_t base = (uintptr_t)prof_blocks_buf + curr_block_idx * prof_buf_size;
   prof_header = (prof_header_t*)(base + prof_header_offset);
   memset(prof_header->name, 0, PROF_NAME_MAX_LEN);
   memcpy(prof_header->name, name, str_len);
@@ -172,7 +374,7 @@ void profiling_create_block(const char* name) {
   prof_header->max_prof_entries = MAX_PROFILE_EVENTS;
   prof_header->max_allocator_entries = MEM_PROFILE_MAX_ALLOCATORS;
   prof_header->max_mem_prof_entries = MAX_MEM_PROFILE_EVENTS;
-  reset_profile_stats();
+  reset_block_stats();
 
   // Set the base addresses for the various profiling entries arrays.
   prof_arr = (prof_event_t*)(base + prof_events_offset);
@@ -18,6 +18,9 @@ namespace executor {
 // Version string used to check for compatibility with post-processing
 // tool
 #define ET_PROF_VER 0x00000001
+// Version of the aggregated profiling section, which takes the place of
+// prof_header_t::prof_ver at the start of that section.
+#define ET_PROF_AGG_VER 0x00010001
 
 // By default we support profiling upto 1024 perf events. Build
 // targets can override this to increase the profiling buffer size
@@ -46,6 +49,35 @@ namespace executor {
 #define MAX_PROFILE_BLOCKS 2
 #endif
 
+// With PROFILING_AGGREGATE defined, begin_profiling()/end_profiling() don't
+// log raw events. Instead they fold each event's duration into running stats
+// kept per (block name, event name, chain, instruction), so that the
+// profiling buffer stays the same size no matter how many times a model runs.
+// The raw profiling blocks still record memory events, and MAX_PROFILE_EVENTS
+// can be set to 0 to reclaim their space.
+//
+// By default up to 512 distinct events are aggregated; events beyond that are
+// counted in prof_agg_header_t::dropped_events.
+#ifndef MAX_PROFILE_AGG_ENTRIES
+#define MAX_PROFILE_AGG_ENTRIES 512
+#endif
+// Number of histogram buckets per aggregated event. Durations of less than
+// 2^PROF_AGG_SUB_BUCKET_BITS ticks get a bucket each; above that every power
+// of two is split into 2^PROF_AGG_SUB_BUCKET_BITS buckets, so percentiles are
+// resolved to within about 25%. Durations past the last bucket are counted in
+// it. The defaults of 128 buckets and 2 bits cover durations up to 2^33 ticks.
+#ifndef PROF_AGG_NUM_BUCKETS
+#define PROF_AGG_NUM_BUCKETS 128
+#endif
+#ifndef PROF_AGG_SUB_BUCKET_BITS
+#define PROF_AGG_SUB_BUCKET_BITS 2
+#endif
+// Maximum number of aggregated events that can be open at the same time,
+// i.e. their nesting depth.
+#ifndef MAX_PROFILE_AGG_OPEN_EVENTS
+#define MAX_PROFILE_AGG_OPEN_EVENTS 32
+#endif
+
 #define PROF_NAME_MAX_LEN 32
 
 typedef struct alignas(8) {
@@ -88,8 +120,40 @@ typedef struct alignas(8) {
   uint32_t mem_prof_entries;
 } prof_header_t;
 
+// Running stats of one aggregated event. Durations are in ticks.
+typedef struct alignas(8) {
+  char name[PROF_NAME_MAX_LEN];
+  int32_t chain_idx;
+  uint32_t instruction_idx;
+  // Index of the profiling block that the event was logged in.
+  uint32_t block_idx;
+  uint32_t reserved;
+  uint64_t count;
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+  uint32_t buckets[PROF_AGG_NUM_BUCKETS];
+} prof_agg_event_t;
+
+typedef struct alignas(8) {
+  uint32_t prof_ver;
+  uint32_t num_buckets;
+  uint32_t sub_bucket_bits;
+  uint32_t max_entries;
+  uint32_t entries;
+  uint32_t dropped_events;
+} prof_agg_header_t;
+
 /*
-This is what the layout of the profiling buffer looks like.
+With PROFILING_AGGREGATE the profiling buffer starts with the aggregated
+events, followed by the profiling blocks:
+---------------------------------------
+| Aggregated profiling header         |
+---------------------------------------
+| Aggregated events                   |
+---------------------------------------
+
+This is what the layout of each profiling block looks like.
 ---------------------------------------
 | Profiling header                    |
 ---------------------------------------
@@ -115,6 +179,14 @@ constexpr size_t prof_mem_alloc_info_offset =
 constexpr size_t prof_mem_alloc_events_offset = prof_mem_alloc_info_offset +
     sizeof(prof_allocator_t) * MEM_PROFILE_MAX_ALLOCATORS;
 
+// Size of the aggregated section at the start of the profiling buffer.
+#ifdef PROFILING_AGGREGATE
+constexpr size_t prof_agg_buf_size = sizeof(prof_agg_header_t) +
+    sizeof(prof_agg_event_t) * MAX_PROFILE_AGG_ENTRIES;
+#else
+constexpr size_t prof_agg_buf_size = 0;
+#endif
+
 // Set the initial state for the profiler assuming we're using the
 // statically allocated buffer declared in the profiler module.
 void profiler_init(void);
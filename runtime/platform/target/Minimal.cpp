@@ -34,6 +34,16 @@ et_timestamp_t et_pal_current_ticks(void) {
   return 11223344;
 }
 
+et_tick_ratio_t et_pal_ticks_to_ns_multiplier(void) {
+  // The duration of the ticks is unknown until et_pal_current_ticks() is
+  // overridden.
+  return {0, 0};
+}
+
+uint32_t et_pal_read_perf_counters(__ET_UNUSED uint64_t* values) {
+  return 0;
+}
+
 void et_pal_emit_log_message(
     __ET_UNUSED et_timestamp_t timestamp,
     __ET_UNUSED et_pal_log_level_t level,
@@ -42,3 +52,7 @@ void et_pal_emit_log_message(
     __ET_UNUSED size_t line,
     __ET_UNUSED const char* message,
     __ET_UNUSED size_t length) {}
+
+void et_pal_emit_log_record(
+    __ET_UNUSED const void* record,
+    __ET_UNUSED size_t length) {}
@@ -27,6 +27,19 @@
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
+#include <numeric>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif // defined(__x86_64__)
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif // defined(__linux__)
 
 #include <executorch/runtime/platform/compiler.h>
 
@@ -66,9 +79,90 @@
 /// Start time of the system (used to zero the system timestamp).
 static std::chrono::time_point<std::chrono::steady_clock> systemStartTime;
 
+/// Value of the cycle counter at systemStartTime.
+static uint64_t systemStartCycles;
+
+/// True if ticks come from the cycle counter instead of steady_clock.
+static bool useCycleCounter = false;
+
 /// Flag set to true if the PAL has been successfully initialized.
 static bool initialized = false;
 
+namespace {
+
+/// Denominator of the ratio of a calibrated cycle counter, which gives the
+/// ratio a precision of one part per million.
+constexpr uint64_t kCalibratedDenominator = 1000000;
+
+/// Shortest time to calibrate a cycle counter over.
+constexpr std::chrono::milliseconds kMinCalibrationTime(10);
+
+/**
+ * Returns true if the CPU has a cycle counter that ticks at a constant rate,
+ * which is much cheaper to read than steady_clock: CNTVCT_EL0 on AArch64, and
+ * the TSC on x86-64 CPUs whose TSC is invariant across frequency and power
+ * state changes.
+ */
+bool has_cycle_counter() {
+#if defined(__aarch64__)
+  return true;
+#elif defined(__x86_64__)
+  unsigned int eax, ebx, ecx, edx;
+  // CPUID.80000007H:EDX[8] is the invariant TSC flag.
+  return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) &&
+      (edx & (1u << 8)) != 0;
+#else
+  return false;
+#endif
+}
+
+/// Reads the cycle counter; only valid if has_cycle_counter().
+inline uint64_t read_cycle_counter() {
+#if defined(__aarch64__)
+  uint64_t value;
+  // The isb keeps the read from being reordered with the code it measures.
+  asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(value) : : "memory");
+  return value;
+#elif defined(__x86_64__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/// Returns the ticks-to-ns ratio of et_pal_current_ticks().
+et_tick_ratio_t compute_tick_ratio() {
+  if (!useCycleCounter) {
+    return {1, 1};
+  }
+#if defined(__aarch64__)
+  uint64_t frequency;
+  asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+  if (frequency != 0) {
+    const uint64_t divisor = std::gcd(frequency, uint64_t(1000000000));
+    return {1000000000 / divisor, frequency / divisor};
+  }
+  // The firmware did not set the frequency; calibrate like the TSC.
+#endif
+  // Time the counter against steady_clock since et_pal_init(), waiting if
+  // that is too short for a precise ratio.
+  auto now = std::chrono::steady_clock::now();
+  uint64_t cycles = read_cycle_counter();
+  while (now - systemStartTime < kMinCalibrationTime) {
+    now = std::chrono::steady_clock::now();
+    cycles = read_cycle_counter();
+  }
+  const double ns = std::chrono::duration<double, std::nano>(
+                        now - systemStartTime)
+                        .count();
+  const double ns_per_cycle = ns / double(cycles - systemStartCycles);
+  return {
+      static_cast<uint64_t>(ns_per_cycle * kCalibratedDenominator + 0.5),
+      kCalibratedDenominator};
+}
+
+} // namespace
+
 /**
  * Initialize the platform abstraction layer.
  *
@@ -80,7 +174,11 @@ void et_pal_init(void) {
     return;
   }
 
+  useCycleCounter = has_cycle_counter();
   systemStartTime = std::chrono::steady_clock::now();
+  if (useCycleCounter) {
+    systemStartCycles = read_cycle_counter();
+  }
   initialized = true;
 }
 
@@ -95,16 +193,39 @@ __ET_NORETURN void et_pal_abort(void) {
 /**
  * Return a monotonically non-decreasing timestamp in system ticks.
  *
+ * Ticks are cycles of the CPU's constant-rate counter when it has one, and
+ * nanoseconds of std::chrono::steady_clock otherwise; see
+ * et_pal_ticks_to_ns_multiplier().
+ *
  * @retval Timestamp value in system ticks.
  */
 et_timestamp_t et_pal_current_ticks(void) {
   _ASSERT_PAL_INITIALIZED();
+  if (useCycleCounter) {
+    return read_cycle_counter() - systemStartCycles;
+  }
   auto systemCurrentTime = std::chrono::steady_clock::now();
   return std::chrono::duration_cast<std::chrono::nanoseconds>(
              systemCurrentTime - systemStartTime)
       .count();
 }
 
+/**
+ * Return the duration of a tick of et_pal_current_ticks(), as a ratio that
+ * converts ticks to nanoseconds.
+ *
+ * The AArch64 counter reports its frequency. The TSC does not, so the first
+ * call times it against steady_clock, which takes up to 10ms if it is made
+ * right after et_pal_init().
+ *
+ * @retval The ticks-to-nanoseconds ratio.
+ */
+et_tick_ratio_t et_pal_ticks_to_ns_multiplier(void) {
+  _ASSERT_PAL_INITIALIZED();
+  static const et_tick_ratio_t ratio = compute_tick_ratio();
+  return ratio;
+}
+
 /**
  * Emit a log message via platform output (serial port, console, etc).
  *
@@ -127,7 +248,12 @@ void et_pal_emit_log_message(
     __ET_UNUSED size_t length) {
   _ASSERT_PAL_INITIALIZED();
 
-  // Not all platforms have ticks == nanoseconds, but this one does.
+  // Convert to nanoseconds without overflowing the intermediate product.
+  const et_tick_ratio_t ratio = et_pal_ticks_to_ns_multiplier();
+  if (ratio.denominator != 0) {
+    timestamp = (timestamp / ratio.denominator) * ratio.numerator +
+        (timestamp % ratio.denominator) * ratio.numerator / ratio.denominator;
+  }
   timestamp /= 1000; // To microseconds
   unsigned long int us = timestamp % 1000000;
   timestamp /= 1000000; // To seconds
@@ -157,3 +283,143 @@ void et_pal_emit_log_message(
       message);
   fflush(ET_LOG_OUTPUT_FILE);
 }
+
+/**
+ * Emit a binary log record via platform output (serial port, console, etc).
+ *
+ * Writes the record as a line of hex digits after the prefix
+ * "executorch-log-record: ", so that it can be captured from text output
+ * along with other logs and decoded by sdk/log_decoder.
+ *
+ * @param[in] record The log record.
+ * @param[in] length The length of the record in bytes.
+ */
+void et_pal_emit_log_record(const void* record, size_t length) {
+  _ASSERT_PAL_INITIALIZED();
+  const uint8_t* bytes = static_cast<const uint8_t*>(record);
+  fputs("executorch-log-record: ", ET_LOG_OUTPUT_FILE);
+  for (size_t i = 0; i < length; ++i) {
+    fprintf(ET_LOG_OUTPUT_FILE, "%02x", bytes[i]);
+  }
+  fputc('\n', ET_LOG_OUTPUT_FILE);
+  fflush(ET_LOG_OUTPUT_FILE);
+}
+
+#if defined(__linux__)
+
+namespace {
+
+/// The perf_event_open(2) group that counts the calling thread's events.
+class PerfCounterGroup {
+ public:
+  PerfCounterGroup() {
+    for (int i = 0; i < kNumPerfCounters; ++i) {
+      const et_pal_perf_counter_t counter =
+          static_cast<et_pal_perf_counter_t>(i);
+      const int fd = open_counter(counter, num_open_ > 0 ? fds_[0] : -1);
+      if (fd < 0) {
+        // Not every CPU or VM exposes every counter; read the rest.
+        continue;
+      }
+      fds_[num_open_] = fd;
+      counters_[num_open_] = counter;
+      ++num_open_;
+    }
+  }
+
+  ~PerfCounterGroup() {
+    for (int i = 0; i < num_open_; ++i) {
+      close(fds_[i]);
+    }
+  }
+
+  uint32_t read_values(uint64_t* values) const {
+    if (num_open_ == 0) {
+      return 0;
+    }
+    // With PERF_FORMAT_GROUP the leader returns the number of counters
+    // followed by their values, in the order they joined the group.
+    uint64_t buf[1 + kNumPerfCounters];
+    const size_t expected = (1 + num_open_) * sizeof(uint64_t);
+    if (read(fds_[0], buf, sizeof(buf)) != static_cast<ssize_t>(expected)) {
+      // A pinned group that could not be scheduled reads as end-of-file.
+      return 0;
+    }
+    uint32_t mask = 0;
+    for (int i = 0; i < num_open_; ++i) {
+      values[counters_[i]] = buf[1 + i];
+      mask |= 1u << counters_[i];
+    }
+    return mask;
+  }
+
+ private:
+  static int open_counter(et_pal_perf_counter_t counter, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    // Keep the whole group on the PMU, so that the values are never scaled
+    // estimates from multiplexing.
+    attr.pinned = group_fd == -1 ? 1 : 0;
+    switch (counter) {
+      case kPerfCounterCycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case kPerfCounterInstructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case kPerfCounterL1DReadMisses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+      case kPerfCounterLLCReadMisses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_LL |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+      default:
+        return -1;
+    }
+    // Count this thread on whichever CPU it runs on.
+    return static_cast<int>(syscall(
+        __NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1, group_fd, 0));
+  }
+
+  int fds_[kNumPerfCounters];
+  et_pal_perf_counter_t counters_[kNumPerfCounters];
+  int num_open_ = 0;
+};
+
+} // namespace
+
+#endif // defined(__linux__)
+
+/**
+ * Read the calling thread's hardware performance counters.
+ *
+ * On Linux the counters are opened with perf_event_open(2) the first time
+ * each thread calls this, and count user-space events only. Returns 0 if the
+ * kernel does not allow it, e.g. because of perf_event_paranoid, and on other
+ * systems.
+ *
+ * @param[out] values Array of kNumPerfCounters entries, indexed by
+ *     et_pal_perf_counter_t.
+ *
+ * @retval A bitmask of the counters that were read into `values`.
+ */
+uint32_t et_pal_read_perf_counters(__ET_UNUSED uint64_t* values) {
+#if defined(__linux__)
+  static thread_local PerfCounterGroup group;
+  return group.read_values(values);
+#else // defined(__linux__)
+  return 0;
+#endif // defined(__linux__)
+}
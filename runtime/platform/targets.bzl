@@ -27,6 +27,13 @@ def get_profiling_flags():
         if not profiling_enabled():
             fail("Cannot configure number of profiling blocks without enabling profiling first.")
         profiling_flags += ["-DMAX_PROFILE_BLOCKS={}".format(num_prof_blocks)]
+    if native.read_config("executorch", "prof_aggregate", "false") == "true":
+        if not profiling_enabled():
+            fail("Cannot aggregate profiling events without enabling profiling first.")
+        profiling_flags += ["-DPROFILING_AGGREGATE"]
+    prof_agg_entries = native.read_config("executorch", "prof_agg_entries", None)
+    if prof_agg_entries != None:
+        profiling_flags += ["-DMAX_PROFILE_AGG_ENTRIES={}".format(prof_agg_entries)]
     return profiling_flags
 
 def define_common_targets():
@@ -60,6 +67,17 @@ def define_common_targets():
     # Enable or disable ET_LOGs
     enable_et_log = native.read_config("executorch", "enable_et_log", None)
 
+    log_flags = ["-DET_LOG_ENABLED=0"] if enable_et_log else []
+
+    # The lowest ET_LOG level to build in; lower levels compile to nothing.
+    min_log_level = native.read_config("executorch", "min_log_level", None)
+    if min_log_level:
+        log_flags.append("-DET_MIN_LOG_LEVEL=" + min_log_level)
+
+    # Emit ET_LOGs as binary records for offline decoding by sdk/log_decoder.
+    if native.read_config("executorch", "log_deferred", None):
+        log_flags.append("-DET_LOG_DEFERRED=1")
+
     # Interfaces for executorch users
     runtime.cxx_library(
         name = "platform",
@@ -76,7 +94,7 @@ def define_common_targets():
             "profiler.cpp",
             "runtime.cpp",
         ],
-        exported_preprocessor_flags = get_profiling_flags() + (["-DET_LOG_ENABLED=0"] if enable_et_log else []),
+        exported_preprocessor_flags = get_profiling_flags() + log_flags,
         exported_deps = [
             "//executorch/runtime/platform:pal_interface",
             ":compiler",
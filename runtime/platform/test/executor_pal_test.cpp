@@ -6,6 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <chrono>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 #include <executorch/runtime/platform/platform.h>
@@ -27,3 +30,29 @@ TEST(ExecutorPalTest, TimestampCoherency) {
   et_timestamp_t time_b = et_pal_current_ticks();
   ASSERT_TRUE(time_b >= time_a);
 }
+
+TEST(ExecutorPalTest, TicksToNsMultiplier) {
+  et_pal_init();
+
+  et_tick_ratio_t ratio = et_pal_ticks_to_ns_multiplier();
+  ASSERT_GT(ratio.numerator, 0);
+  ASSERT_GT(ratio.denominator, 0);
+
+  // The ratio does not change once it is known.
+  et_tick_ratio_t again = et_pal_ticks_to_ns_multiplier();
+  EXPECT_EQ(again.numerator, ratio.numerator);
+  EXPECT_EQ(again.denominator, ratio.denominator);
+
+  // The ticks of a sleep convert to about as many nanoseconds as it lasted.
+  const auto start = std::chrono::steady_clock::now();
+  const et_timestamp_t ticks_a = et_pal_current_ticks();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const et_timestamp_t ticks_b = et_pal_current_ticks();
+  const double expected_ns = std::chrono::duration<double, std::nano>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+  const double ns = double(ticks_b - ticks_a) * ratio.numerator /
+      ratio.denominator;
+  EXPECT_GT(ns, 0.9 * expected_ns);
+  EXPECT_LT(ns, 1.1 * expected_ns);
+}
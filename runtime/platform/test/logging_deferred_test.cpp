@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/test/stub_platform.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+
+static_assert(ET_LOG_DEFERRED, "Build this test with -DET_LOG_DEFERRED=1");
+
+class RecordSpy : public PlatformIntercept {
+ public:
+  static constexpr et_timestamp_t kTimestamp = 1234;
+
+  et_timestamp_t current_ticks() override {
+    ++current_ticks_call_count;
+    return kTimestamp;
+  }
+
+  void emit_log_record(const void* record, size_t length) override {
+    const uint8_t* bytes = static_cast<const uint8_t*>(record);
+    records.emplace_back(bytes, bytes + length);
+  }
+
+  size_t current_ticks_call_count = 0;
+  std::vector<std::vector<uint8_t>> records;
+};
+
+namespace {
+
+template <typename T>
+T read(const std::vector<uint8_t>& record, size_t offset) {
+  T value;
+  memcpy(&value, record.data() + offset, sizeof(value));
+  return value;
+}
+
+} // namespace
+
+TEST(LoggingDeferredTest, DisabledLevelsAreCompiledOut) {
+  RecordSpy spy;
+  InterceptWith iw(spy);
+
+  // The test is built with ET_MIN_LOG_LEVEL=Info.
+  int evaluated = 0;
+  ET_LOG(Debug, "Not logged %d", ++evaluated);
+
+  EXPECT_EQ(evaluated, 0);
+  EXPECT_EQ(spy.current_ticks_call_count, 0);
+  EXPECT_TRUE(spy.records.empty());
+}
+
+TEST(LoggingDeferredTest, RecordHoldsIdAndArguments) {
+  RecordSpy spy;
+  InterceptWith iw(spy);
+
+  const uint32_t kLine = __LINE__ + 1;
+  ET_LOG(Info, "Deferred %d %zu %s %f", -2, size_t(7), "ab", 0.5);
+
+  ASSERT_EQ(spy.records.size(), 1);
+  const std::vector<uint8_t>& record = spy.records[0];
+  EXPECT_EQ(record[0], et_pal_log_level_t::kInfo);
+  EXPECT_EQ(record[1], 0); // Not truncated.
+
+  // The ID is the hash of the file, line and format.
+  std::string site = std::string(__FILE__) + '\0' + std::to_string(kLine) +
+      '\0' + "Deferred %d %zu %s %f";
+  uint32_t id = 2166136261u;
+  for (char c : site) {
+    id = (id ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  EXPECT_EQ(read<uint32_t>(record, 2), id);
+  EXPECT_EQ(read<uint64_t>(record, 6), RecordSpy::kTimestamp);
+
+  size_t offset = 14;
+  EXPECT_EQ(record[offset], 'i');
+  EXPECT_EQ(read<int64_t>(record, offset + 1), -2);
+  offset += 9;
+  EXPECT_EQ(record[offset], 'u');
+  EXPECT_EQ(read<uint64_t>(record, offset + 1), 7);
+  offset += 9;
+  EXPECT_EQ(record[offset], 's');
+  EXPECT_EQ(record[offset + 1], 2);
+  EXPECT_EQ(memcmp(record.data() + offset + 2, "ab", 2), 0);
+  offset += 4;
+  EXPECT_EQ(record[offset], 'f');
+  EXPECT_EQ(read<double>(record, offset + 1), 0.5);
+  offset += 9;
+  EXPECT_EQ(record.size(), offset);
+}
+
+TEST(LoggingDeferredTest, LongArgumentsAreTruncated) {
+  RecordSpy spy;
+  InterceptWith iw(spy);
+
+  constexpr size_t kMaxLength = torch::executor::internal::kMaxLogRecordLength;
+  std::string long_string(2 * kMaxLength, 'x');
+  ET_LOG(Error, "Long %s %d", long_string.c_str(), 1);
+
+  ASSERT_EQ(spy.records.size(), 1);
+  const std::vector<uint8_t>& record = spy.records[0];
+  EXPECT_EQ(record.size(), kMaxLength);
+  EXPECT_EQ(record[0], et_pal_log_level_t::kError);
+  EXPECT_EQ(record[1], 1); // Truncated.
+}
@@ -57,6 +57,16 @@ et_timestamp_t et_pal_current_ticks(void) {
   return platform_intercept->current_ticks();
 }
 
+et_tick_ratio_t et_pal_ticks_to_ns_multiplier(void) {
+  ASSERT_INTERCEPT_INSTALLED();
+  return platform_intercept->ticks_to_ns_multiplier();
+}
+
+uint32_t et_pal_read_perf_counters(uint64_t* values) {
+  ASSERT_INTERCEPT_INSTALLED();
+  return platform_intercept->read_perf_counters(values);
+}
+
 void et_pal_emit_log_message(
     et_timestamp_t timestamp,
     et_pal_log_level_t level,
@@ -70,6 +80,11 @@ void et_pal_emit_log_message(
       timestamp, level, filename, function, line, message, length);
 }
 
+void et_pal_emit_log_record(const void* record, size_t length) {
+  ASSERT_INTERCEPT_INSTALLED();
+  platform_intercept->emit_log_record(record, length);
+}
+
 } // extern "C"
 
 #include <gtest/gtest.h>
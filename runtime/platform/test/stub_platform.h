@@ -31,6 +31,16 @@ class PlatformIntercept {
     return 0;
   }
 
+  /// Called when et_pal_ticks_to_ns_multiplier() is called.
+  virtual et_tick_ratio_t ticks_to_ns_multiplier() {
+    return {1, 1};
+  }
+
+  /// Called when et_pal_read_perf_counters() is called.
+  virtual uint32_t read_perf_counters(__ET_UNUSED uint64_t* values) {
+    return 0;
+  }
+
   /// Called when et_pal_emit_log_message() is called.
   virtual void emit_log_message(
       __ET_UNUSED et_timestamp_t timestamp,
@@ -41,6 +51,11 @@ class PlatformIntercept {
       __ET_UNUSED const char* message,
       __ET_UNUSED size_t length) {}
 
+  /// Called when et_pal_emit_log_record() is called.
+  virtual void emit_log_record(
+      __ET_UNUSED const void* record,
+      __ET_UNUSED size_t length) {}
+
   virtual ~PlatformIntercept() = default;
 };
 
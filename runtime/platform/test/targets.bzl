@@ -75,3 +75,18 @@ def define_common_targets():
             "-DET_MIN_LOG_LEVEL=Debug",
         ],
     )
+
+    runtime.cxx_test(
+        name = "logging_deferred_test",
+        srcs = [
+            "logging_deferred_test.cpp",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+            ":stub_platform",
+        ],
+        compiler_flags = [
+            "-DET_LOG_DEFERRED=1",
+            "-DET_MIN_LOG_LEVEL=Info",
+        ],
+    )
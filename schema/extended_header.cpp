@@ -8,6 +8,7 @@
 
 #include <executorch/schema/extended_header.h>
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 
@@ -33,13 +34,34 @@ static constexpr size_t kHeaderProgramSizeOffset =
 static constexpr size_t kHeaderSegmentBaseOffsetOffset =
     kHeaderProgramSizeOffset + sizeof(uint64_t);
 
+/// The expected location of the optional program_checksum field relative to
+/// the beginning of the header.
+static constexpr size_t kHeaderProgramChecksumOffset =
+    kHeaderSegmentBaseOffsetOffset + sizeof(uint64_t);
+
 /**
- * The size of the header that covers the fields known of by this version of
- * the code. It's ok for a header to be larger as long as the fields stay in
+ * The size of the header that covers the required fields known of by this
+ * version of the code. It's ok for a header to be larger as long as the fields stay in
  * the same place, but this code will ignore any new fields.
  */
-static constexpr size_t kMinimumHeaderLength =
-    kHeaderSegmentBaseOffsetOffset + sizeof(uint64_t);
+static constexpr size_t kMinimumHeaderLength = kHeaderProgramChecksumOffset;
+
+/// The size of a header that has a program_checksum field.
+static constexpr size_t kHeaderLengthWithChecksum =
+    kHeaderProgramChecksumOffset + sizeof(uint32_t);
+
+/// The expected location of the optional tensor_alignment field relative to
+/// the beginning of the header. Follows the program_checksum field.
+static constexpr size_t kHeaderTensorAlignmentOffset =
+    kHeaderLengthWithChecksum;
+
+/// The size of a header that has a tensor_alignment field.
+static constexpr size_t kHeaderLengthWithTensorAlignment =
+    kHeaderTensorAlignmentOffset + sizeof(uint32_t);
+static_assert(
+    ExtendedHeader::kHeaderOffset + kHeaderLengthWithTensorAlignment <=
+        ExtendedHeader::kNumHeadBytes,
+    "All fields must be within the head bytes that Parse() reads");
 
 /// Interprets the 4 bytes at `data` as a little-endian uint32_t.
 uint32_t GetUInt32LE(const uint8_t* data) {
@@ -55,8 +77,53 @@ uint64_t GetUInt64LE(const uint8_t* data) {
       ((uint64_t)data[6] << 48) | ((uint64_t)data[7] << 56);
 }
 
+/// The table of the reflected CRC-32 polynomial 0xEDB88320 used by zlib, for
+/// one byte at a time.
+struct Crc32Table {
+  uint32_t entries[256];
+
+  constexpr Crc32Table() : entries() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      entries[i] = c;
+    }
+  }
+};
+
+constexpr Crc32Table kCrc32Table;
+
+/// Extends the running CRC-32 `crc`, in its inverted form, over `size` bytes
+/// of `data`, or over `size` zero bytes if `data` is null.
+uint32_t UpdateCrc32(uint32_t crc, const uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    const uint8_t byte = data != nullptr ? data[i] : 0;
+    crc = kCrc32Table.entries[(crc ^ byte) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
 } // namespace
 
+/* static */ uint32_t ExtendedHeader::ComputeProgramChecksum(
+    const void* data,
+    size_t size) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  const size_t field_begin = kHeaderOffset + kHeaderProgramChecksumOffset;
+  const size_t field_end = field_begin + sizeof(uint32_t);
+  uint32_t crc = 0xffffffffu;
+  crc = UpdateCrc32(crc, bytes, std::min(size, field_begin));
+  if (size > field_begin) {
+    crc = UpdateCrc32(crc, nullptr, std::min(size, field_end) - field_begin);
+  }
+  if (size > field_end) {
+    crc = UpdateCrc32(crc, bytes + field_end, size - field_end);
+  }
+  return crc ^ 0xffffffffu;
+}
+
 /* static */ Result<ExtendedHeader> ExtendedHeader::Parse(
     const void* data,
     size_t size) {
@@ -83,11 +150,22 @@ uint64_t GetUInt64LE(const uint8_t* data) {
     return Error::InvalidProgram;
   }
 
-  // The header is present and apparently valid.
+  // The header is present and apparently valid. Newer headers also have a
+  // checksum, and then possibly a tensor alignment.
+  const bool has_program_checksum = header_length >= kHeaderLengthWithChecksum;
+  const bool has_tensor_alignment =
+      header_length >= kHeaderLengthWithTensorAlignment;
   return ExtendedHeader{
       /*program_size=*/GetUInt64LE(header + kHeaderProgramSizeOffset),
       /*segment_base_offset=*/
       GetUInt64LE(header + kHeaderSegmentBaseOffsetOffset),
+      /*has_program_checksum=*/has_program_checksum,
+      /*program_checksum=*/
+      has_program_checksum ? GetUInt32LE(header + kHeaderProgramChecksumOffset)
+                           : 0,
+      /*tensor_alignment=*/
+      has_tensor_alignment ? GetUInt32LE(header + kHeaderTensorAlignmentOffset)
+                           : 0,
   };
 }
 
@@ -60,6 +60,19 @@ struct ExtendedHeader {
    */
   static Result<ExtendedHeader> Parse(const void* data, size_t size);
 
+  /**
+   * Computes the checksum of the serialized Program data that an
+   * ExtendedHeader may carry in its program_checksum field: the CRC-32 (as
+   * computed by zlib) of the data, with the program_checksum field itself
+   * taken as zeros.
+   *
+   * @param[in] data The serialized Program data, starting at offset 0, which
+   *     must contain a header with a program_checksum field.
+   * @param[in] size The size of the Program data, i.e. the program_size field
+   *     of the header. Segments are not covered.
+   */
+  static uint32_t ComputeProgramChecksum(const void* data, size_t size);
+
   /**
    * The size in bytes of the Program flatbuffer data, starting from offset
    * zero.
@@ -71,6 +84,26 @@ struct ExtendedHeader {
    * is present.
    */
   uint64_t segment_base_offset;
+
+  /**
+   * Whether the header has a program_checksum field. Older headers do not.
+   */
+  bool has_program_checksum;
+
+  /**
+   * The checksum of the Program data, as computed by ComputeProgramChecksum().
+   * Only meaningful if has_program_checksum is true.
+   */
+  uint32_t program_checksum;
+
+  /**
+   * The alignment in bytes, from the start of the file, that the serializer
+   * guarantees for the data of every constant tensor, whether inline in the
+   * Program data or in the constant segment. Zero if the header does not
+   * record one. Headers that record it always have a program_checksum field
+   * too.
+   */
+  uint32_t tensor_alignment;
 };
 
 } // namespace executor
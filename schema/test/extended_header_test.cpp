@@ -181,3 +181,94 @@ TEST_F(ExtendedHeaderTest, LongerHeaderLengthSucceeds) {
     EXPECT_EQ(header->segment_base_offset, kExampleSegmentBaseOffset);
   }
 }
+
+TEST_F(ExtendedHeaderTest, OlderHeaderHasNoChecksum) {
+  std::vector<uint8_t> program = CreateExampleProgramHead();
+
+  Result<ExtendedHeader> header =
+      ExtendedHeader::Parse(program.data(), program.size());
+  ASSERT_EQ(header.error(), Error::Ok);
+  EXPECT_FALSE(header->has_program_checksum);
+}
+
+/**
+ * Returns fake serialized Program head data whose header also has a
+ * program_checksum field, set to `checksum_bytes`.
+ */
+std::vector<uint8_t> CreateExampleProgramHeadWithChecksum(
+    const uint8_t (&checksum_bytes)[4]) {
+  std::vector<uint8_t> program = CreateExampleProgramHead();
+  program[kHeaderLengthOffset] = 0x1c;
+  memcpy(
+      program.data() + ExtendedHeader::kHeaderOffset +
+          sizeof(kExampleHeaderData),
+      checksum_bytes,
+      sizeof(checksum_bytes));
+  return program;
+}
+
+TEST_F(ExtendedHeaderTest, ChecksumParsesCorrectly) {
+  const uint8_t checksum_bytes[4] = {0x73, 0x63, 0x53, 0x43};
+  std::vector<uint8_t> program =
+      CreateExampleProgramHeadWithChecksum(checksum_bytes);
+
+  Result<ExtendedHeader> header =
+      ExtendedHeader::Parse(program.data(), program.size());
+  ASSERT_EQ(header.error(), Error::Ok);
+  EXPECT_EQ(header->program_size, kExampleProgramSize);
+  EXPECT_EQ(header->segment_base_offset, kExampleSegmentBaseOffset);
+  EXPECT_TRUE(header->has_program_checksum);
+  EXPECT_EQ(header->program_checksum, 0x43536373);
+}
+
+TEST_F(ExtendedHeaderTest, OlderHeaderHasNoTensorAlignment) {
+  const uint8_t checksum_bytes[4] = {0x73, 0x63, 0x53, 0x43};
+  for (const std::vector<uint8_t>& program :
+       {CreateExampleProgramHead(),
+        CreateExampleProgramHeadWithChecksum(checksum_bytes)}) {
+    Result<ExtendedHeader> header =
+        ExtendedHeader::Parse(program.data(), program.size());
+    ASSERT_EQ(header.error(), Error::Ok);
+    EXPECT_EQ(header->tensor_alignment, 0);
+  }
+}
+
+TEST_F(ExtendedHeaderTest, TensorAlignmentParsesCorrectly) {
+  const uint8_t checksum_bytes[4] = {0x73, 0x63, 0x53, 0x43};
+  std::vector<uint8_t> program =
+      CreateExampleProgramHeadWithChecksum(checksum_bytes);
+  program[kHeaderLengthOffset] = 0x20;
+  const uint8_t alignment_bytes[4] = {0x40, 0x00, 0x00, 0x00};
+  memcpy(
+      program.data() + ExtendedHeader::kHeaderOffset +
+          sizeof(kExampleHeaderData) + sizeof(checksum_bytes),
+      alignment_bytes,
+      sizeof(alignment_bytes));
+
+  Result<ExtendedHeader> header =
+      ExtendedHeader::Parse(program.data(), program.size());
+  ASSERT_EQ(header.error(), Error::Ok);
+  EXPECT_EQ(header->program_size, kExampleProgramSize);
+  EXPECT_EQ(header->segment_base_offset, kExampleSegmentBaseOffset);
+  EXPECT_TRUE(header->has_program_checksum);
+  EXPECT_EQ(header->program_checksum, 0x43536373);
+  EXPECT_EQ(header->tensor_alignment, 64);
+}
+
+TEST_F(ExtendedHeaderTest, ComputeProgramChecksumSkipsChecksumField) {
+  // The expected values are zlib.crc32() of the data with a zeroed checksum
+  // field, so the checksum field itself does not matter.
+  const uint8_t zero_bytes[4] = {0, 0, 0, 0};
+  const uint8_t other_bytes[4] = {0x73, 0x63, 0x53, 0x43};
+  for (const auto* checksum_bytes : {&zero_bytes, &other_bytes}) {
+    std::vector<uint8_t> program =
+        CreateExampleProgramHeadWithChecksum(*checksum_bytes);
+    EXPECT_EQ(
+        ExtendedHeader::ComputeProgramChecksum(program.data(), program.size()),
+        0x25dc66dc);
+    // Data that ends within the checksum field.
+    EXPECT_EQ(
+        ExtendedHeader::ComputeProgramChecksum(program.data(), 34),
+        0x973f0475);
+  }
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "executorch/sdk/etdump/emitter.h"
+
+#include <string.h>
+#include <algorithm>
+
+#include "executorch/runtime/platform/assert.h"
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+namespace {
+
+// Smallest working buffer handed to flatcc, per kind of buffer. Mirrors
+// flatcc_builder_default_alloc().
+size_t min_working_buffer_size(int alloc_type) {
+  switch (alloc_type) {
+    case flatcc_builder_alloc_ds:
+      return 256;
+    case flatcc_builder_alloc_fs:
+      return 512;
+    case flatcc_builder_alloc_us:
+      return 64;
+    default:
+      return 32;
+  }
+}
+
+} // namespace
+
+void ETDumpEmitter::init(Span<uint8_t> buffer) {
+  uintptr_t begin = reinterpret_cast<uintptr_t>(buffer.data());
+  uintptr_t aligned = (begin + kAlignment - 1) & ~(kAlignment - 1);
+  uintptr_t end = begin + buffer.size();
+  begin_ = reinterpret_cast<uint8_t*>(std::min(aligned, end));
+  end_ = reinterpret_cast<uint8_t*>(end);
+  front_size_ = 0;
+  back_size_ = 0;
+}
+
+int ETDumpEmitter::emit(
+    void* emit_context,
+    const flatcc_iovec_t* iov,
+    int iov_count,
+    flatbuffers_soffset_t offset,
+    size_t len) {
+  ETDumpEmitter* emitter = static_cast<ETDumpEmitter*>(emit_context);
+  if (len > emitter->free_bytes()) {
+    return -1;
+  }
+  uint8_t* dst;
+  if (offset < 0) {
+    emitter->front_size_ += len;
+    dst = emitter->end_ - emitter->front_size_;
+  } else {
+    dst = emitter->begin_ + emitter->back_size_;
+    emitter->back_size_ += len;
+  }
+  for (int i = 0; i < iov_count; ++i) {
+    if (iov[i].iov_base != nullptr) {
+      memcpy(dst, iov[i].iov_base, iov[i].iov_len);
+    } else {
+      memset(dst, 0, iov[i].iov_len);
+    }
+    dst += iov[i].iov_len;
+  }
+  return 0;
+}
+
+void* ETDumpEmitter::finalize(size_t* size) {
+  // [back | free | front] -> [front | back | free]
+  std::rotate(begin_, end_ - front_size_, end_);
+  *size = front_size_ + back_size_;
+  return begin_;
+}
+
+void* ETDumpBuilderAllocator::allocate(size_t size) {
+  if (reserve_begin_ != nullptr) {
+    uintptr_t start = (reinterpret_cast<uintptr_t>(reserve_begin_) +
+                       MemoryAllocator::kDefaultAlignment - 1) &
+        ~(MemoryAllocator::kDefaultAlignment - 1);
+    if (start + size <= reinterpret_cast<uintptr_t>(reserve_end_)) {
+      reserve_begin_ = reinterpret_cast<uint8_t*>(start + size);
+      return reinterpret_cast<void*>(start);
+    }
+  }
+  return allocator_->allocate(size);
+}
+
+int ETDumpBuilderAllocator::alloc(
+    void* alloc_context,
+    flatcc_iovec_t* b,
+    size_t request,
+    int zero_fill,
+    int alloc_type) {
+  ETDumpBuilderAllocator* self =
+      static_cast<ETDumpBuilderAllocator*>(alloc_context);
+  if (request == 0) {
+    // flatcc is releasing the buffer. The memory belongs to the
+    // MemoryAllocator, so there is nothing to free.
+    self->capacity_ -= b->iov_len;
+    b->iov_base = nullptr;
+    b->iov_len = 0;
+    return 0;
+  }
+  if (request <= b->iov_len) {
+    // Never shrink.
+    return 0;
+  }
+  size_t n = min_working_buffer_size(alloc_type);
+  if (alloc_type == flatcc_builder_alloc_ht) {
+    // The hash table uses exactly the size it asks for.
+    n = request;
+  }
+  while (n < request) {
+    n *= 2;
+  }
+  void* p = self->allocate(n);
+  if (p == nullptr) {
+    return -1;
+  }
+  if (b->iov_base != nullptr) {
+    memcpy(p, b->iov_base, b->iov_len);
+  }
+  if (zero_fill) {
+    memset(static_cast<uint8_t*>(p) + b->iov_len, 0, n - b->iov_len);
+  }
+  self->capacity_ += n - b->iov_len;
+  b->iov_base = p;
+  b->iov_len = n;
+  return 0;
+}
+
+bool ETDumpBuilderAllocator::reserve() {
+  // Each working buffer grows by at most doubling while a single event is
+  // added, which needs a new allocation of twice its current size.
+  const size_t needed = 2 * capacity_ + 1024;
+  if (reserve_begin_ != nullptr &&
+      static_cast<size_t>(reserve_end_ - reserve_begin_) >= needed) {
+    return true;
+  }
+  uint8_t* p = static_cast<uint8_t*>(allocator_->allocate(needed));
+  if (p == nullptr) {
+    return false;
+  }
+  reserve_begin_ = p;
+  reserve_end_ = p + needed;
+  return true;
+}
+
+int etdump_flatcc_custom_init(
+    flatcc_builder_t* builder,
+    ETDumpEmitter* emitter,
+    ETDumpBuilderAllocator* allocator) {
+  return flatcc_builder_custom_init(
+      builder,
+      ETDumpEmitter::emit,
+      emitter,
+      ETDumpBuilderAllocator::alloc,
+      allocator);
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
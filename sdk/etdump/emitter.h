@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/sdk/etdump/etdump_schema_flatcc_builder.h>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+/**
+ * A flatcc emitter that writes the finished ETDump into a caller-provided
+ * buffer instead of heap-allocated pages.
+ *
+ * flatcc builds buffers from both ends: "front" blocks are prepended and
+ * "back" blocks (clustered vtables) are appended. Front blocks are stored
+ * growing down from the end of the buffer and back blocks growing up from its
+ * start, and finalize() rotates them into a single contiguous flatbuffer.
+ */
+class ETDumpEmitter final {
+ public:
+  /// Alignment of the finalized buffer.
+  static constexpr size_t kAlignment = 16;
+
+  ETDumpEmitter() = default;
+
+  /// Uses `buffer` as the output buffer. Its start is aligned up to
+  /// kAlignment.
+  void init(Span<uint8_t> buffer);
+
+  /// The flatcc_builder_emit_fun that writes into the buffer.
+  static int emit(
+      void* emit_context,
+      const flatcc_iovec_t* iov,
+      int iov_count,
+      flatbuffers_soffset_t offset,
+      size_t len);
+
+  /// Returns the number of bytes that can still be emitted.
+  size_t free_bytes() const {
+    return static_cast<size_t>(end_ - begin_) - front_size_ - back_size_;
+  }
+
+  /**
+   * Makes the emitted data contiguous at the start of the buffer. Must only be
+   * called after the flatcc buffer has been ended. The emitter must not be
+   * used afterwards until it is reset().
+   *
+   * @param[out] size The size in bytes of the finalized flatbuffer.
+   *
+   * @returns A pointer to the finalized flatbuffer, inside the buffer passed
+   *     to init().
+   */
+  void* finalize(size_t* size);
+
+  /// Discards everything emitted so far.
+  void reset() {
+    front_size_ = 0;
+    back_size_ = 0;
+  }
+
+ private:
+  uint8_t* begin_ = nullptr;
+  uint8_t* end_ = nullptr;
+  size_t front_size_ = 0;
+  size_t back_size_ = 0;
+};
+
+/**
+ * A flatcc_builder_alloc_fun that serves the builder's working buffers (its
+ * stacks, vtable cache and hash table) from a MemoryAllocator.
+ *
+ * flatcc grows these buffers by reallocation, which a MemoryAllocator cannot
+ * do in place: a grown buffer is copied into a new allocation and the old one
+ * is abandoned. Running out of memory in the middle of building a table would
+ * leave the builder in an inconsistent state, so callers check reserve()
+ * before adding each event; it sets aside enough memory for every working
+ * buffer to double once.
+ */
+class ETDumpBuilderAllocator final {
+ public:
+  ETDumpBuilderAllocator() = default;
+
+  void init(MemoryAllocator* allocator) {
+    allocator_ = allocator;
+  }
+
+  /// The flatcc_builder_alloc_fun.
+  static int alloc(
+      void* alloc_context,
+      flatcc_iovec_t* b,
+      size_t request,
+      int zero_fill,
+      int alloc_type);
+
+  /**
+   * Makes sure that the next round of growth of the working buffers can be
+   * served without failing.
+   *
+   * @returns false if the MemoryAllocator does not have enough memory left.
+   */
+  bool reserve();
+
+ private:
+  void* allocate(size_t size);
+
+  MemoryAllocator* allocator_ = nullptr;
+  /// Total size of the working buffers currently handed to flatcc.
+  size_t capacity_ = 0;
+  /// Memory set aside by reserve() that growth is served from first.
+  uint8_t* reserve_begin_ = nullptr;
+  uint8_t* reserve_end_ = nullptr;
+};
+
+/**
+ * Initializes `builder` to emit into `emitter` and to allocate its working
+ * memory from `allocator`.
+ *
+ * @returns 0 on success, non-zero on failure.
+ */
+int etdump_flatcc_custom_init(
+    flatcc_builder_t* builder,
+    ETDumpEmitter* emitter,
+    ETDumpBuilderAllocator* allocator);
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,610 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "executorch/sdk/etdump/etdump_concurrent.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "executorch/runtime/platform/assert.h"
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+/// Returns a small id that is unique to the calling thread for the lifetime
+/// of the process. 0 is never used.
+uint32_t current_thread_id() {
+  static std::atomic<uint32_t> next_thread_id{1};
+  static thread_local uint32_t thread_id =
+      next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  return thread_id;
+}
+
+uint64_t next_instance_id() {
+  static std::atomic<uint64_t> next_id{1};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t round_up_to_power_of_two(size_t n) {
+  size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+/// Copies `src` into `dst`, truncating it to fit. A null `src` is copied as
+/// the empty string.
+void copy_name(char* dst, const char* src) {
+  if (src == nullptr) {
+    dst[0] = '\0';
+    return;
+  }
+  strncpy(dst, src, ConcurrentETDumpGen::kMaxNameLength - 1);
+  dst[ConcurrentETDumpGen::kMaxNameLength - 1] = '\0';
+}
+
+} // namespace
+
+/// An event logged by one thread, waiting to be replayed into its ETDumpGen.
+struct ConcurrentETDumpGen::Record {
+  enum class Type : uint8_t {
+    kCreateBlock,
+    kProfile,
+    kProfileDelegate,
+    kTrackAllocator,
+    kTrackAllocation,
+    kInstructionMemory,
+    kLoadEvent,
+    kIntermediateOutput,
+  };
+
+  Type type;
+  /// kProfileDelegate: whether the event has a string or an integer id.
+  DelegateDebugIdType delegate_id_type;
+  /// kProfile: whether the event has a name. kProfileDelegate: whether the
+  /// event has metadata.
+  bool has_string;
+  ChainID chain_id;
+  DebugHandle debug_handle;
+  /// kProfileDelegate: the integer delegate debug id. kTrackAllocation: the
+  /// allocator id. kLoadEvent: the delegate index. kIntermediateOutput: the
+  /// output index.
+  uint32_t id;
+  et_timestamp_t start_time;
+  et_timestamp_t end_time;
+  /// kTrackAllocation: the allocation size. kInstructionMemory: the bytes
+  /// read and written. kLoadEvent: the bytes loaded and allocated.
+  uint64_t size0;
+  uint64_t size1;
+  /// kIntermediateOutput: the dtype and statistics of the output.
+  int8_t scalar_type;
+  TensorStats stats;
+  /// The block, event, allocator or string delegate debug id.
+  char name[kMaxNameLength];
+  /// kProfileDelegate: the metadata.
+  char metadata[kMaxNameLength];
+};
+
+struct ConcurrentETDumpGen::ThreadState {
+  /// Id of the thread that claimed this state, or 0 if it is unclaimed.
+  std::atomic<uint32_t> thread_id{0};
+
+  // Only touched by the owning thread.
+  ChainID chain_id = kUnsetChainId;
+  DebugHandle debug_handle = kUnsetDebugHandle;
+  AllocatorID num_allocators = 0;
+  char open_names[kMaxOpenEvents][kMaxNameLength];
+  size_t num_open_names = 0;
+
+  Record* records = nullptr;
+  // Written by the producer and the consumer respectively. Kept on separate
+  // cache lines so that they don't contend.
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+  std::atomic<size_t> num_dropped{0};
+
+  // Only touched by the consumer.
+  ETDumpGen* etdump_gen = nullptr;
+};
+
+ConcurrentETDumpGen::ConcurrentETDumpGen(
+    size_t max_threads,
+    size_t ring_capacity)
+    : instance_id_(next_instance_id()),
+      max_threads_(max_threads),
+      ring_mask_(round_up_to_power_of_two(ring_capacity) - 1),
+      threads_(new ThreadState[max_threads]) {
+  ET_CHECK_MSG(max_threads > 0, "max_threads must be positive");
+  for (size_t i = 0; i < max_threads_; ++i) {
+    threads_[i].records = new Record[ring_mask_ + 1];
+  }
+}
+
+ConcurrentETDumpGen::~ConcurrentETDumpGen() {
+  for (size_t i = 0; i < max_threads_; ++i) {
+    delete[] threads_[i].records;
+    delete threads_[i].etdump_gen;
+  }
+  delete[] threads_;
+}
+
+ConcurrentETDumpGen::ThreadState* ConcurrentETDumpGen::thread_state() {
+  // Each thread remembers the state it claimed in the tracer it used last,
+  // so that switching between tracers only costs a scan of the states.
+  struct Cache {
+    uint64_t instance_id;
+    ThreadState* state;
+  };
+  static thread_local Cache cache = {0, nullptr};
+  if (cache.instance_id == instance_id_) {
+    return cache.state;
+  }
+
+  const uint32_t thread_id = current_thread_id();
+  ThreadState* state = nullptr;
+  for (size_t i = 0; i < max_threads_ && state == nullptr; ++i) {
+    if (threads_[i].thread_id.load(std::memory_order_acquire) == thread_id) {
+      state = &threads_[i];
+    }
+  }
+  for (size_t i = 0; i < max_threads_ && state == nullptr; ++i) {
+    uint32_t unclaimed = 0;
+    if (threads_[i].thread_id.compare_exchange_strong(
+            unclaimed, thread_id, std::memory_order_acq_rel)) {
+      state = &threads_[i];
+    }
+  }
+  if (state == nullptr) {
+    return nullptr;
+  }
+  cache = {instance_id_, state};
+  return state;
+}
+
+ConcurrentETDumpGen::Record* ConcurrentETDumpGen::begin_record(
+    ThreadState& state) {
+  const size_t head = state.head.load(std::memory_order_relaxed);
+  if (head - state.tail.load(std::memory_order_acquire) > ring_mask_) {
+    state.num_dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return &state.records[head & ring_mask_];
+}
+
+void ConcurrentETDumpGen::end_record(ThreadState& state) {
+  state.head.store(
+      state.head.load(std::memory_order_relaxed) + 1,
+      std::memory_order_release);
+}
+
+void ConcurrentETDumpGen::create_event_block(const char* name) {
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  // Allocator ids and open events belong to the block.
+  state->num_allocators = 0;
+  state->num_open_names = 0;
+  Record* record = begin_record(*state);
+  if (record == nullptr) {
+    return;
+  }
+  record->type = Record::Type::kCreateBlock;
+  copy_name(record->name, name);
+  end_record(*state);
+}
+
+EventTracerEntry ConcurrentETDumpGen::start_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  EventTracerEntry entry{};
+  entry.event_id = -1;
+  entry.delegate_event_id_type = DelegateDebugIdType::kNone;
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    return entry;
+  }
+  if (chain_id == kUnsetChainId) {
+    chain_id = state->chain_id;
+    debug_handle = state->debug_handle;
+  }
+  entry.chain_id = chain_id;
+  entry.debug_handle = debug_handle;
+  // Remember the name until the event ends, since the caller may release it.
+  if (name != nullptr && state->num_open_names < kMaxOpenEvents) {
+    entry.event_id = state->num_open_names;
+    copy_name(state->open_names[state->num_open_names++], name);
+  }
+  entry.start_time = et_pal_current_ticks();
+  return entry;
+}
+
+void ConcurrentETDumpGen::end_profiling(EventTracerEntry prof_entry) {
+  et_timestamp_t end_time = et_pal_current_ticks();
+  ET_CHECK_MSG(
+      prof_entry.delegate_event_id_type == DelegateDebugIdType::kNone,
+      "Delegate events must use end_profiling_delegate to mark the end of a delegate profiling event.");
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  const bool has_name = prof_entry.event_id >= 0 &&
+      static_cast<size_t>(prof_entry.event_id) < state->num_open_names;
+  Record* record = begin_record(*state);
+  if (record != nullptr) {
+    record->type = Record::Type::kProfile;
+    record->has_string = has_name;
+    record->chain_id = prof_entry.chain_id;
+    record->debug_handle = prof_entry.debug_handle;
+    record->start_time = prof_entry.start_time;
+    record->end_time = end_time;
+    if (has_name) {
+      memcpy(
+          record->name, state->open_names[prof_entry.event_id], kMaxNameLength);
+    }
+    end_record(*state);
+  }
+  if (has_name) {
+    // Also forgets any events nested in this one that never ended.
+    state->num_open_names = prof_entry.event_id;
+  }
+}
+
+EventTracerEntry ConcurrentETDumpGen::start_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index) {
+  ET_CHECK_MSG(
+      (name == nullptr) ^ (delegate_debug_index == -1),
+      "Only name or delegate_debug_index can be valid. Check DelegateMappingBuilder documentation for more details.");
+  EventTracerEntry entry{};
+  entry.event_id = -1;
+  entry.delegate_event_id_type =
+      name == nullptr ? DelegateDebugIdType::kInt : DelegateDebugIdType::kStr;
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    return entry;
+  }
+  entry.chain_id = state->chain_id;
+  entry.debug_handle = state->debug_handle;
+  if (name == nullptr) {
+    entry.event_id = delegate_debug_index;
+  } else if (state->num_open_names < kMaxOpenEvents) {
+    entry.event_id = state->num_open_names;
+    copy_name(state->open_names[state->num_open_names++], name);
+  }
+  entry.start_time = et_pal_current_ticks();
+  return entry;
+}
+
+void ConcurrentETDumpGen::end_profiling_delegate(
+    EventTracerEntry prof_entry,
+    const char* metadata) {
+  et_timestamp_t end_time = et_pal_current_ticks();
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  const bool is_str =
+      prof_entry.delegate_event_id_type == DelegateDebugIdType::kStr;
+  const bool has_name = is_str && prof_entry.event_id >= 0 &&
+      static_cast<size_t>(prof_entry.event_id) < state->num_open_names;
+  Record* record = begin_record(*state);
+  if (record != nullptr) {
+    record->type = Record::Type::kProfileDelegate;
+    record->delegate_id_type = prof_entry.delegate_event_id_type;
+    record->has_string = metadata != nullptr;
+    record->chain_id = prof_entry.chain_id;
+    record->debug_handle = prof_entry.debug_handle;
+    record->id = static_cast<uint32_t>(prof_entry.event_id);
+    record->start_time = prof_entry.start_time;
+    record->end_time = end_time;
+    // A string id whose name was not kept is recorded as empty.
+    copy_name(
+        record->name,
+        has_name ? state->open_names[prof_entry.event_id] : nullptr);
+    copy_name(record->metadata, metadata);
+    end_record(*state);
+  }
+  if (has_name) {
+    state->num_open_names = prof_entry.event_id;
+  }
+}
+
+void ConcurrentETDumpGen::log_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    const char* metadata) {
+  ET_CHECK_MSG(
+      (name == nullptr) ^ (delegate_debug_index == -1),
+      "Only name or delegate_debug_index can be valid. Check DelegateMappingBuilder documentation for more details.");
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Record* record = begin_record(*state);
+  if (record == nullptr) {
+    return;
+  }
+  record->type = Record::Type::kProfileDelegate;
+  record->delegate_id_type =
+      name == nullptr ? DelegateDebugIdType::kInt : DelegateDebugIdType::kStr;
+  record->has_string = metadata != nullptr;
+  record->chain_id = state->chain_id;
+  record->debug_handle = state->debug_handle;
+  record->id = delegate_debug_index;
+  record->start_time = start_time;
+  record->end_time = end_time;
+  copy_name(record->name, name);
+  copy_name(record->metadata, metadata);
+  end_record(*state);
+}
+
+AllocatorID ConcurrentETDumpGen::track_allocator(const char* name) {
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+  }
+  Record* record = begin_record(*state);
+  if (record == nullptr) {
+    return 0;
+  }
+  record->type = Record::Type::kTrackAllocator;
+  copy_name(record->name, name);
+  end_record(*state);
+  // ETDumpGen numbers the allocators of a block from 1 when they are
+  // replayed.
+  return ++state->num_allocators;
+}
+
+void ConcurrentETDumpGen::track_allocation(
+    AllocatorID allocator_id,
+    size_t allocation_size) {
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Record* record = begin_record(*state);
+  if (record == nullptr) {
+    return;
+  }
+  record->type = Record::Type::kTrackAllocation;
+  record->id = allocator_id;
+  record->size0 = allocation_size;
+  end_record(*state);
+}
+
+void ConcurrentETDumpGen::log_instruction_memory(
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    size_t bytes_read,
+    size_t bytes_written,
+    const TensorMemoryAccess* accesses,
+    size_t num_accesses) {
+  (void)accesses;
+  (void)num_accesses;
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Record* record = begin_record(*state);
+  if (record == nullptr) {
+    return;
+  }
+  record->type = Record::Type::kInstructionMemory;
+  record->chain_id = chain_id;
+  record->debug_handle = debug_handle;
+  record->size0 = bytes_read;
+  record->size1 = bytes_written;
+  end_record(*state);
+}
+
+void ConcurrentETDumpGen::log_load_event(const LoadEvent& event) {
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Record* record = begin_record(*state);
+  if (record == nullptr) {
+    return;
+  }
+  record->type = Record::Type::kLoadEvent;
+  record->has_string = event.name != nullptr;
+  if (record->has_string) {
+    copy_name(record->name, event.name);
+  }
+  record->id = static_cast<uint32_t>(event.delegate_index);
+  record->start_time = event.start_time;
+  record->end_time = event.end_time;
+  record->size0 = event.bytes_loaded;
+  record->size1 = event.bytes_allocated;
+  end_record(*state);
+}
+
+void ConcurrentETDumpGen::log_intermediate_output(
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    const IntermediateOutput& output) {
+  ThreadState* state = thread_state();
+  if (state == nullptr) {
+    num_unclaimed_drops_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Record* record = begin_record(*state);
+  if (record == nullptr) {
+    return;
+  }
+  record->type = Record::Type::kIntermediateOutput;
+  record->chain_id = chain_id;
+  record->debug_handle = debug_handle;
+  record->id = output.output_index;
+  record->scalar_type = output.scalar_type;
+  record->stats = output.stats;
+  end_record(*state);
+}
+
+void ConcurrentETDumpGen::set_chain_debug_handle(
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  ThreadState* state = thread_state();
+  if (state != nullptr) {
+    state->chain_id = chain_id;
+    state->debug_handle = debug_handle;
+  }
+}
+
+ChainID ConcurrentETDumpGen::get_current_chain_id() {
+  ThreadState* state = thread_state();
+  return state != nullptr ? state->chain_id : kUnsetChainId;
+}
+
+DebugHandle ConcurrentETDumpGen::get_current_debug_handle() {
+  ThreadState* state = thread_state();
+  return state != nullptr ? state->debug_handle : kUnsetDebugHandle;
+}
+
+void ConcurrentETDumpGen::replay(ThreadState& state, const Record& record) {
+  if (state.etdump_gen == nullptr) {
+    state.etdump_gen = new ETDumpGen();
+  }
+  ETDumpGen& gen = *state.etdump_gen;
+  switch (record.type) {
+    case Record::Type::kCreateBlock:
+      gen.create_event_block(record.name);
+      break;
+    case Record::Type::kProfile:
+      gen.log_profiling(
+          record.has_string ? record.name : nullptr,
+          record.chain_id,
+          record.debug_handle,
+          record.start_time,
+          record.end_time);
+      break;
+    case Record::Type::kProfileDelegate:
+      gen.set_chain_debug_handle(record.chain_id, record.debug_handle);
+      if (record.delegate_id_type == DelegateDebugIdType::kStr) {
+        gen.log_profiling_delegate(
+            record.name,
+            static_cast<DebugHandle>(-1),
+            record.start_time,
+            record.end_time,
+            record.has_string ? record.metadata : nullptr);
+      } else {
+        gen.log_profiling_delegate(
+            nullptr,
+            record.id,
+            record.start_time,
+            record.end_time,
+            record.has_string ? record.metadata : nullptr);
+      }
+      gen.set_chain_debug_handle(kUnsetChainId, kUnsetDebugHandle);
+      break;
+    case Record::Type::kTrackAllocator:
+      gen.track_allocator(record.name);
+      break;
+    case Record::Type::kTrackAllocation:
+      gen.track_allocation(record.id, record.size0);
+      break;
+    case Record::Type::kInstructionMemory:
+      gen.log_instruction_memory(
+          record.chain_id,
+          record.debug_handle,
+          record.size0,
+          record.size1,
+          nullptr,
+          0);
+      break;
+    case Record::Type::kLoadEvent: {
+      LoadEvent event;
+      event.name = record.has_string ? record.name : nullptr;
+      event.delegate_index = static_cast<int32_t>(record.id);
+      event.start_time = record.start_time;
+      event.end_time = record.end_time;
+      event.bytes_loaded = record.size0;
+      event.bytes_allocated = record.size1;
+      gen.log_load_event(event);
+      break;
+    }
+    case Record::Type::kIntermediateOutput: {
+      IntermediateOutput output;
+      output.output_index = record.id;
+      output.scalar_type = record.scalar_type;
+      output.dim = 0;
+      output.stats = record.stats;
+      output.data = nullptr;
+      output.nbytes = 0;
+      gen.log_intermediate_output(record.chain_id, record.debug_handle, output);
+      break;
+    }
+  }
+}
+
+void ConcurrentETDumpGen::drain() {
+  for (size_t i = 0; i < max_threads_; ++i) {
+    ThreadState& state = threads_[i];
+    if (state.thread_id.load(std::memory_order_acquire) == 0) {
+      // States are claimed in order, so the rest are unclaimed too.
+      break;
+    }
+    size_t tail = state.tail.load(std::memory_order_relaxed);
+    const size_t head = state.head.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+      replay(state, state.records[tail & ring_mask_]);
+    }
+    state.tail.store(tail, std::memory_order_release);
+  }
+}
+
+etdump_result ConcurrentETDumpGen::get_etdump_data() {
+  drain();
+  etdump_result* etdumps =
+      static_cast<etdump_result*>(calloc(max_threads_, sizeof(etdump_result)));
+  uint32_t* thread_ids =
+      static_cast<uint32_t*>(calloc(max_threads_, sizeof(uint32_t)));
+  ET_CHECK_MSG(
+      etdumps != nullptr && thread_ids != nullptr,
+      "Failed to allocate %zu ETDump results",
+      max_threads_);
+  for (size_t i = 0; i < max_threads_; ++i) {
+    if (threads_[i].etdump_gen != nullptr) {
+      etdumps[i] = threads_[i].etdump_gen->get_etdump_data();
+      thread_ids[i] = threads_[i].thread_id.load(std::memory_order_relaxed);
+    }
+  }
+  etdump_result result = merge_etdumps(etdumps, thread_ids, max_threads_);
+  for (size_t i = 0; i < max_threads_; ++i) {
+    free(etdumps[i].buf);
+  }
+  free(etdumps);
+  free(thread_ids);
+  return result;
+}
+
+size_t ConcurrentETDumpGen::get_num_dropped_events() {
+  size_t num_dropped = num_unclaimed_drops_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < max_threads_; ++i) {
+    num_dropped += threads_[i].num_dropped.load(std::memory_order_relaxed);
+  }
+  return num_dropped;
+}
+
+} // namespace executor
+} // namespace torch
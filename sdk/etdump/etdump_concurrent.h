@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/sdk/etdump/etdump_flatcc.h>
+#include "executorch/runtime/core/event_tracer.h"
+
+namespace torch {
+namespace executor {
+
+/**
+ * An EventTracer that several threads can log to at the same time, e.g. to
+ * trace Methods that execute concurrently.
+ *
+ * Each thread logs fixed-size records into a single-producer single-consumer
+ * ring of its own, so logging takes no locks and never waits: a thread claims
+ * a ring with a compare-and-swap the first time it logs, and afterwards only
+ * touches that ring. One consumer thread at a time moves the records out of
+ * the rings with drain(), replaying each thread's records into an ETDumpGen
+ * of its own, and get_etdump_data() merges those into a single ETDump whose
+ * RunData tables carry the id of the thread that recorded them.
+ *
+ * Since records have a fixed size, names and delegate metadata are truncated
+ * to kMaxNameLength - 1 bytes, log_instruction_memory() only keeps the
+ * byte totals, and log_intermediate_output() only keeps the dtype and the
+ * statistics of each output. Events that don't fit in a full ring, and events from threads
+ * beyond `max_threads`, are dropped and counted by get_num_dropped_events();
+ * drain() more often or use larger rings to avoid losing any.
+ */
+class ConcurrentETDumpGen final : public EventTracer {
+ public:
+  /// Maximum length of a recorded name, including the terminator.
+  static constexpr size_t kMaxNameLength = 48;
+
+  /// Maximum nesting depth of named events that are open on one thread.
+  /// Events nested more deeply are recorded without their names.
+  static constexpr size_t kMaxOpenEvents = 16;
+
+  /**
+   * @param[in] max_threads Maximum number of threads that can log events.
+   * @param[in] ring_capacity Number of records that each thread's ring holds
+   *     between calls to drain(). Rounded up to a power of two.
+   */
+  explicit ConcurrentETDumpGen(
+      size_t max_threads = 8,
+      size_t ring_capacity = 1024);
+  ~ConcurrentETDumpGen() override;
+
+  ConcurrentETDumpGen(const ConcurrentETDumpGen&) = delete;
+  ConcurrentETDumpGen& operator=(const ConcurrentETDumpGen&) = delete;
+
+  void create_event_block(const char* name) override;
+  EventTracerEntry start_profiling(
+      const char* name,
+      ChainID chain_id = kUnsetChainId,
+      DebugHandle debug_handle = kUnsetDebugHandle) override;
+  void end_profiling(EventTracerEntry prof_entry) override;
+  EventTracerEntry start_profiling_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index) override;
+  void end_profiling_delegate(
+      EventTracerEntry prof_entry,
+      const char* metadata) override;
+  void log_profiling_delegate(
+      const char* name,
+      DebugHandle delegate_debug_index,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const char* metadata) override;
+  void track_allocation(AllocatorID id, size_t size) override;
+  AllocatorID track_allocator(const char* name) override;
+  void log_instruction_memory(
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      size_t bytes_read,
+      size_t bytes_written,
+      const TensorMemoryAccess* accesses,
+      size_t num_accesses) override;
+  void log_load_event(const LoadEvent& event) override;
+  void log_intermediate_output(
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      const IntermediateOutput& output) override;
+
+  /// The chain id and debug handle are kept per thread.
+  void set_chain_debug_handle(ChainID chain_id, DebugHandle debug_handle)
+      override;
+  ChainID get_current_chain_id() override;
+  DebugHandle get_current_debug_handle() override;
+
+  /**
+   * Moves the records logged so far out of the rings. Safe to call while
+   * other threads are logging, but only from one thread at a time.
+   */
+  void drain();
+
+  /**
+   * Drains the rings and merges the blocks recorded by all threads into one
+   * ETDump, grouped by thread in the order that the threads first logged.
+   * Must only be called once, after all threads have stopped logging. The
+   * returned buffer is owned by the caller and must be released with free().
+   */
+  etdump_result get_etdump_data();
+
+  /// Returns the number of events that were dropped because a ring was full
+  /// or too many threads logged.
+  size_t get_num_dropped_events();
+
+ private:
+  struct Record;
+  struct ThreadState;
+
+  /// Returns the calling thread's state, claiming one on its first call, or
+  /// nullptr if all of them are taken.
+  ThreadState* thread_state();
+  /// Returns the next free record in `state`'s ring, or nullptr if it is full.
+  Record* begin_record(ThreadState& state);
+  /// Publishes the record returned by begin_record() to the consumer.
+  void end_record(ThreadState& state);
+  void replay(ThreadState& state, const Record& record);
+
+  /// Distinguishes this tracer in the threads' caches of their states.
+  const uint64_t instance_id_;
+  const size_t max_threads_;
+  const size_t ring_mask_;
+  ThreadState* threads_;
+  std::atomic<size_t> num_unclaimed_drops_{0};
+};
+
+} // namespace executor
+} // namespace torch
@@ -8,46 +8,481 @@
 
 #include "executorch/sdk/etdump/etdump_flatcc.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "executorch/runtime/platform/assert.h"
+#include "executorch/runtime/platform/log.h"
+#include "executorch/runtime/platform/platform.h"
 
 namespace torch {
 namespace executor {
 
+namespace {
+
+// Upper bounds on the number of bytes that the flatcc builder emits for each
+// kind of item, used to keep a fixed buffer from overflowing.
+constexpr size_t kRefBytes = sizeof(flatbuffers_uoffset_t);
+constexpr size_t kEventBytes = 128;
+constexpr size_t kAllocatorBytes = 32;
+constexpr size_t kPerfCountersBytes = 64;
+constexpr size_t kTensorMemoryAccessBytes = 48;
+// An OutputEvent's statistics and its Tensor, without sizes and data.
+constexpr size_t kOutputEventBytes = 160;
+constexpr size_t kRunDataBytes = 64;
+// The root table, its vtable, the size prefix and alignment padding.
+constexpr size_t kFinishBytes = 128;
+
+// The bytes needed for a string: its length prefix, terminator and padding.
+size_t string_bytes(const char* str) {
+  return str != nullptr ? strlen(str) + 8 : 0;
+}
+
+// Records the duration of the event timestamps in the ETDump being built.
+void add_ticks_to_ns(flatcc_builder_t* builder) {
+  const et_tick_ratio_t ratio = et_pal_ticks_to_ns_multiplier();
+  etdump_ETDump_ticks_to_ns_numerator_add(builder, ratio.numerator);
+  etdump_ETDump_ticks_to_ns_denominator_add(builder, ratio.denominator);
+}
+
+// Returns a copy of `str` in `builder`, or 0 (the null reference) if `str` is
+// absent.
+flatbuffers_string_ref_t copy_string(
+    flatcc_builder_t* builder,
+    flatbuffers_string_t str) {
+  if (str == nullptr) {
+    return 0;
+  }
+  return flatbuffers_string_create(builder, str, flatbuffers_string_len(str));
+}
+
+etdump_ProfileEvent_ref_t copy_profile_event(
+    flatcc_builder_t* builder,
+    etdump_ProfileEvent_table_t event) {
+  flatbuffers_string_ref_t name =
+      copy_string(builder, etdump_ProfileEvent_name(event));
+  flatbuffers_string_ref_t delegate_debug_id_str =
+      copy_string(builder, etdump_ProfileEvent_delegate_debug_id_str(event));
+  flatbuffers_string_ref_t delegate_debug_metadata =
+      copy_string(builder, etdump_ProfileEvent_delegate_debug_metadata(event));
+  etdump_PerfCounters_table_t counters =
+      etdump_ProfileEvent_perf_counters(event);
+  etdump_PerfCounters_ref_t counters_ref = 0;
+  if (counters != nullptr) {
+    counters_ref = etdump_PerfCounters_create(
+        builder,
+        etdump_PerfCounters_cycles(counters),
+        etdump_PerfCounters_instructions(counters),
+        etdump_PerfCounters_l1d_read_misses(counters),
+        etdump_PerfCounters_llc_read_misses(counters));
+  }
+
+  etdump_ProfileEvent_start(builder);
+  etdump_ProfileEvent_start_time_add(
+      builder, etdump_ProfileEvent_start_time(event));
+  etdump_ProfileEvent_end_time_add(
+      builder, etdump_ProfileEvent_end_time(event));
+  etdump_ProfileEvent_chain_id_add(
+      builder, etdump_ProfileEvent_chain_id(event));
+  etdump_ProfileEvent_instruction_id_add(
+      builder, etdump_ProfileEvent_instruction_id(event));
+  if (name != 0) {
+    etdump_ProfileEvent_name_add(builder, name);
+  }
+  if (delegate_debug_id_str != 0) {
+    etdump_ProfileEvent_delegate_debug_id_str_add(
+        builder, delegate_debug_id_str);
+  } else if (etdump_ProfileEvent_delegate_debug_id_int(event) != -1) {
+    etdump_ProfileEvent_delegate_debug_id_int_add(
+        builder, etdump_ProfileEvent_delegate_debug_id_int(event));
+  }
+  if (delegate_debug_metadata != 0) {
+    etdump_ProfileEvent_delegate_debug_metadata_add(
+        builder, delegate_debug_metadata);
+  }
+  if (counters_ref != 0) {
+    etdump_ProfileEvent_perf_counters_add(builder, counters_ref);
+  }
+  return etdump_ProfileEvent_end(builder);
+}
+
+etdump_MemoryEvent_ref_t copy_memory_event(
+    flatcc_builder_t* builder,
+    etdump_MemoryEvent_table_t event) {
+  etdump_TensorMemoryAccess_vec_t tensors = etdump_MemoryEvent_tensors(event);
+  etdump_TensorMemoryAccess_vec_ref_t tensors_ref = 0;
+  if (tensors != nullptr) {
+    etdump_TensorMemoryAccess_vec_start(builder);
+    for (size_t i = 0; i < etdump_TensorMemoryAccess_vec_len(tensors); ++i) {
+      etdump_TensorMemoryAccess_table_t tensor =
+          etdump_TensorMemoryAccess_vec_at(tensors, i);
+      etdump_TensorMemoryAccess_vec_push_create(
+          builder,
+          etdump_TensorMemoryAccess_memory_id(tensor),
+          etdump_TensorMemoryAccess_memory_offset(tensor),
+          etdump_TensorMemoryAccess_size(tensor),
+          etdump_TensorMemoryAccess_is_write(tensor));
+    }
+    tensors_ref = etdump_TensorMemoryAccess_vec_end(builder);
+  }
+  return etdump_MemoryEvent_create(
+      builder,
+      etdump_MemoryEvent_chain_id(event),
+      etdump_MemoryEvent_instruction_id(event),
+      etdump_MemoryEvent_bytes_read(event),
+      etdump_MemoryEvent_bytes_written(event),
+      tensors_ref);
+}
+
+etdump_LoadEvent_ref_t copy_load_event(
+    flatcc_builder_t* builder,
+    etdump_LoadEvent_table_t event) {
+  return etdump_LoadEvent_create(
+      builder,
+      copy_string(builder, etdump_LoadEvent_name(event)),
+      etdump_LoadEvent_delegate_index(event),
+      etdump_LoadEvent_start_time(event),
+      etdump_LoadEvent_end_time(event),
+      etdump_LoadEvent_bytes_loaded(event),
+      etdump_LoadEvent_bytes_allocated(event));
+}
+
+etdump_Tensor_ref_t copy_tensor(
+    flatcc_builder_t* builder,
+    etdump_Tensor_table_t tensor) {
+  flatbuffers_int32_vec_t sizes = etdump_Tensor_sizes(tensor);
+  flatbuffers_int32_vec_t strides = etdump_Tensor_strides(tensor);
+  flatbuffers_uint8_vec_t data = etdump_Tensor_data(tensor);
+  return etdump_Tensor_create(
+      builder,
+      etdump_Tensor_scalar_type(tensor),
+      sizes != nullptr ? flatbuffers_int32_vec_create(
+                             builder, sizes, flatbuffers_int32_vec_len(sizes))
+                       : 0,
+      strides != nullptr
+          ? flatbuffers_int32_vec_create(
+                builder, strides, flatbuffers_int32_vec_len(strides))
+          : 0,
+      data != nullptr ? flatbuffers_uint8_vec_create(
+                            builder, data, flatbuffers_uint8_vec_len(data))
+                      : 0);
+}
+
+etdump_OutputEvent_ref_t copy_output_event(
+    flatcc_builder_t* builder,
+    etdump_OutputEvent_table_t event) {
+  etdump_TensorStats_table_t stats = etdump_OutputEvent_stats(event);
+  etdump_TensorStats_ref_t stats_ref = 0;
+  if (stats != nullptr) {
+    stats_ref = etdump_TensorStats_create(
+        builder,
+        etdump_TensorStats_numel(stats),
+        etdump_TensorStats_min(stats),
+        etdump_TensorStats_max(stats),
+        etdump_TensorStats_mean(stats),
+        etdump_TensorStats_nan_count(stats),
+        etdump_TensorStats_hash(stats));
+  }
+  etdump_Tensor_table_t tensor = etdump_OutputEvent_tensor(event);
+  etdump_Tensor_ref_t tensor_ref =
+      tensor != nullptr ? copy_tensor(builder, tensor) : 0;
+  return etdump_OutputEvent_create(
+      builder,
+      etdump_OutputEvent_chain_id(event),
+      etdump_OutputEvent_instruction_id(event),
+      etdump_OutputEvent_output_index(event),
+      stats_ref,
+      tensor_ref);
+}
+
+// Copies the fields of `run_data` into the RunData table that is currently
+// open in `builder`, recording `thread_id` as its thread.
+void copy_run_data(
+    flatcc_builder_t* builder,
+    etdump_RunData_table_t run_data,
+    uint32_t thread_id) {
+  flatbuffers_string_t name = etdump_RunData_name(run_data);
+  if (name != nullptr) {
+    etdump_RunData_name_create_strn(
+        builder, name, flatbuffers_string_len(name));
+  }
+  if (thread_id != 0) {
+    etdump_RunData_thread_id_add(builder, thread_id);
+  }
+
+  etdump_Allocator_vec_t allocators = etdump_RunData_allocators(run_data);
+  if (allocators != nullptr) {
+    etdump_RunData_allocators_start(builder);
+    for (size_t i = 0; i < etdump_Allocator_vec_len(allocators); ++i) {
+      etdump_Allocator_table_t allocator =
+          etdump_Allocator_vec_at(allocators, i);
+      flatbuffers_string_ref_t ref =
+          copy_string(builder, etdump_Allocator_name(allocator));
+      etdump_RunData_allocators_push_create(builder, ref);
+    }
+    etdump_RunData_allocators_end(builder);
+  }
+
+  etdump_Event_vec_t events = etdump_RunData_events(run_data);
+  if (events != nullptr) {
+    etdump_RunData_events_start(builder);
+    for (size_t i = 0; i < etdump_Event_vec_len(events); ++i) {
+      etdump_Event_table_t event = etdump_Event_vec_at(events, i);
+      etdump_ProfileEvent_table_t profile_event =
+          etdump_Event_profile_event(event);
+      etdump_AllocationEvent_table_t allocation_event =
+          etdump_Event_allocation_event(event);
+      etdump_MemoryEvent_table_t memory_event =
+          etdump_Event_memory_event(event);
+      etdump_LoadEvent_table_t load_event = etdump_Event_load_event(event);
+      etdump_OutputEvent_table_t output_event =
+          etdump_Event_output_event(event);
+      if (profile_event != nullptr) {
+        etdump_ProfileEvent_ref_t id =
+            copy_profile_event(builder, profile_event);
+        etdump_RunData_events_push_start(builder);
+        etdump_Event_profile_event_add(builder, id);
+        etdump_RunData_events_push_end(builder);
+      } else if (allocation_event != nullptr) {
+        etdump_RunData_events_push_start(builder);
+        etdump_Event_allocation_event_create(
+            builder,
+            etdump_AllocationEvent_allocator_id(allocation_event),
+            etdump_AllocationEvent_allocation_size(allocation_event));
+        etdump_RunData_events_push_end(builder);
+      } else if (memory_event != nullptr) {
+        etdump_MemoryEvent_ref_t id = copy_memory_event(builder, memory_event);
+        etdump_RunData_events_push_start(builder);
+        etdump_Event_memory_event_add(builder, id);
+        etdump_RunData_events_push_end(builder);
+      } else if (load_event != nullptr) {
+        etdump_LoadEvent_ref_t id = copy_load_event(builder, load_event);
+        etdump_RunData_events_push_start(builder);
+        etdump_Event_load_event_add(builder, id);
+        etdump_RunData_events_push_end(builder);
+      } else if (output_event != nullptr) {
+        etdump_OutputEvent_ref_t id = copy_output_event(builder, output_event);
+        etdump_RunData_events_push_start(builder);
+        etdump_Event_output_event_add(builder, id);
+        etdump_RunData_events_push_end(builder);
+      }
+    }
+    etdump_RunData_events_end(builder);
+  }
+}
+
+} // namespace
+
 // Constructor implementation
 ETDumpGen::ETDumpGen() {
   // Initialize the flatcc builder using the buffer and buffer size
-  flatcc_builder_init(&builder);
-  flatbuffers_buffer_start(&builder, etdump_ETDump_file_identifier);
-  etdump_ETDump_start_as_root_with_size(&builder);
-  etdump_ETDump_version_add(&builder, ETDUMP_VERSION);
-  etdump_ETDump_run_data_start(&builder);
-  etdump_ETDump_run_data_push_start(&builder);
+  flatcc_builder_init(builder_);
+  start_etdump();
+}
+
+ETDumpGen::ETDumpGen(const ETDumpSamplingConfig& config) : ETDumpGen() {
+  set_sampling_config(config);
+  if (config.max_blocks > 0) {
+    retained_blocks = static_cast<RetainedBlock*>(
+        calloc(config.max_blocks, sizeof(RetainedBlock)));
+    ET_CHECK_MSG(
+        retained_blocks != nullptr,
+        "Failed to allocate %zu retained ETDump blocks",
+        config.max_blocks);
+  }
 }
 
 ETDumpGen::~ETDumpGen() {
   flatcc_builder_clear(&builder);
+  if (retained_blocks != nullptr) {
+    for (size_t i = 0; i < sampling_config.max_blocks; ++i) {
+      if (retained_blocks[i].buf != nullptr) {
+        flatcc_builder_aligned_free(retained_blocks[i].buf);
+      }
+      if (retained_blocks[i].builder_initialized) {
+        flatcc_builder_clear(&retained_blocks[i].builder);
+      }
+    }
+    free(retained_blocks);
+  }
+}
+
+ETDumpGen::ETDumpGen(
+    Span<uint8_t> buffer,
+    MemoryAllocator* builder_memory,
+    ETDumpOverflowPolicy policy,
+    const ETDumpSamplingConfig& config) {
+  ET_CHECK_MSG(
+      config.max_blocks == 0,
+      "max_blocks is not supported with a fixed ETDump buffer");
+  ET_CHECK_MSG(builder_memory != nullptr, "builder_memory must not be null");
+  set_sampling_config(config);
+  fixed_buffer = true;
+  overflow_policy = policy;
+  emitter.init(buffer);
+  ET_CHECK_MSG(
+      emitter.free_bytes() >= kFinishBytes,
+      "ETDump buffer of %zu bytes is too small",
+      buffer.size());
+  builder_allocator.init(builder_memory);
+  ET_CHECK_MSG(
+      builder_allocator.reserve() &&
+          internal::etdump_flatcc_custom_init(
+              builder_, &emitter, &builder_allocator) == 0,
+      "Failed to initialize the ETDump builder");
+  start_etdump();
+}
+
+void ETDumpGen::start_etdump() {
+  flatbuffers_buffer_start(builder_, etdump_ETDump_file_identifier);
+  etdump_ETDump_start_as_root_with_size(builder_);
+  etdump_ETDump_version_add(builder_, ETDUMP_VERSION);
+  add_ticks_to_ns(builder_);
+  etdump_ETDump_run_data_start(builder_);
+  etdump_ETDump_run_data_push_start(builder_);
+}
+
+void ETDumpGen::set_sampling_config(const ETDumpSamplingConfig& config) {
+  sampling_config = config;
+  // xorshift32 never leaves the all-zero state, so avoid starting there.
+  rng_state = config.seed != 0 ? config.seed : 1;
+}
+
+bool ETDumpGen::reserve(size_t bytes, size_t pending_bytes) {
+  if (fixed_buffer &&
+      (buffer_full || !builder_allocator.reserve() ||
+       bytes + pending_bytes + pending_output_bytes + kFinishBytes >
+           emitter.free_bytes())) {
+    // Stop recording for good, so that the end of an event is never logged
+    // without its start.
+    buffer_full = true;
+    ++num_dropped_events;
+    ET_CHECK_MSG(
+        overflow_policy != ETDumpOverflowPolicy::kAbort,
+        "ETDump buffer is full");
+    return false;
+  }
+  pending_output_bytes += pending_bytes;
+  return true;
+}
+
+bool ETDumpGen::reserve_event(size_t bytes) {
+  if (!reserve(bytes, kRefBytes)) {
+    return false;
+  }
+  // The event's entry in the events vector is emitted when the block closes.
+  block_pending_bytes += kRefBytes;
+  return true;
 }
 
 void ETDumpGen::clear_builder() {
   flatcc_builder_clear(&builder);
 }
 
+bool ETDumpGen::sample_next_block() {
+  const size_t block_index = num_blocks_seen++;
+  if (sampling_config.sample_every_n > 1 &&
+      block_index % sampling_config.sample_every_n != 0) {
+    return false;
+  }
+  if (sampling_config.sample_probability >= 1.0f) {
+    return true;
+  }
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  // Compare the top 24 bits, which a float represents exactly.
+  return static_cast<float>(rng_state >> 8) <
+      sampling_config.sample_probability * 16777216.0f;
+}
+
+void ETDumpGen::start_retained_block(const char* name) {
+  if (retained_block_open) {
+    finish_retained_block();
+  }
+  // Overwrite the oldest block once all of them are in use. Resetting the
+  // builder keeps the memory it already allocated.
+  current_retained_block = next_retained_block;
+  next_retained_block = (next_retained_block + 1) % sampling_config.max_blocks;
+  RetainedBlock& block = retained_blocks[current_retained_block];
+  if (block.buf != nullptr) {
+    flatcc_builder_aligned_free(block.buf);
+    block.buf = nullptr;
+  }
+  if (block.builder_initialized) {
+    flatcc_builder_reset(&block.builder);
+  } else {
+    flatcc_builder_init(&block.builder);
+    block.builder_initialized = true;
+  }
+
+  builder_ = &block.builder;
+  flatbuffers_buffer_start(builder_, etdump_ETDump_file_identifier);
+  etdump_ETDump_start_as_root_with_size(builder_);
+  etdump_ETDump_version_add(builder_, ETDUMP_VERSION);
+  add_ticks_to_ns(builder_);
+  etdump_ETDump_run_data_start(builder_);
+  etdump_ETDump_run_data_push_start(builder_);
+  etdump_RunData_name_create_strn(builder_, name, strlen(name));
+  ++num_blocks;
+  retained_block_open = true;
+  etdump_gen_state = ETDumpGen_Block_Created;
+}
+
+void ETDumpGen::finish_retained_block() {
+  if (etdump_gen_state == ETDumpGen_Adding_Events) {
+    etdump_RunData_events_end(builder_);
+  } else if (etdump_gen_state == ETDumpGen_Adding_Allocators) {
+    etdump_RunData_allocators_end(builder_);
+  }
+  etdump_ETDump_run_data_push_end(builder_);
+  etdump_ETDump_run_data_end(builder_);
+  etdump_ETDump_ref_t root = etdump_ETDump_end(builder_);
+  flatbuffers_buffer_end(builder_, root);
+  size_t size = 0;
+  retained_blocks[current_retained_block].buf =
+      flatcc_builder_finalize_aligned_buffer(builder_, &size);
+  retained_block_open = false;
+  etdump_gen_state = ETDumpGen_Init;
+}
+
 void ETDumpGen::create_event_block(const char* name) {
+  if (flush_every_n_blocks > 0 && num_blocks >= flush_every_n_blocks &&
+      flush_fn != nullptr) {
+    flush();
+  }
+  block_sampled = sample_next_block();
+  // Events left open by the previous block are never ended.
+  perf_counter_depth = 0;
+  if (!block_sampled) {
+    return;
+  }
+  if (retained_blocks != nullptr) {
+    start_retained_block(name);
+    return;
+  }
+  // The block's entry in the run_data vector is emitted when the whole ETDump
+  // is finished, and its RunData table when the block closes.
+  if (!reserve(string_bytes(name), kRunDataBytes + kRefBytes)) {
+    block_sampled = false;
+    return;
+  }
   if (etdump_gen_state == ETDumpGen_Adding_Events) {
-    etdump_RunData_events_end(&builder);
+    etdump_RunData_events_end(builder_);
   }
   if (num_blocks > 0) {
-    etdump_ETDump_run_data_push_end(&builder);
-    etdump_ETDump_run_data_push_start(&builder);
+    etdump_ETDump_run_data_push_end(builder_);
+    etdump_ETDump_run_data_push_start(builder_);
   }
+  // Closing the previous block emitted everything it had pending.
+  pending_output_bytes -= block_pending_bytes;
+  block_pending_bytes = kRunDataBytes;
   ++num_blocks;
-  etdump_RunData_name_create_strn(&builder, name, strlen(name));
+  etdump_RunData_name_create_strn(builder_, name, strlen(name));
   etdump_gen_state = ETDumpGen_Block_Created;
 }
 
 int64_t ETDumpGen::create_string_entry(const char* name) {
-  return flatbuffers_string_create_str(&builder, name);
+  return flatbuffers_string_create_str(builder_, name);
 }
 
 // ETDumpGen has the following possible states, ETDumpGen_Init,
@@ -70,9 +505,9 @@ void ETDumpGen::check_ready_to_add_events() {
          etdump_gen_state == ETDumpGen_Block_Created),
         "ETDumpGen in an invalid state. Cannot add new events now.");
     if (etdump_gen_state == ETDumpGen_Adding_Allocators) {
-      etdump_RunData_allocators_end(&builder);
+      etdump_RunData_allocators_end(builder_);
     }
-    etdump_RunData_events_start(&builder);
+    etdump_RunData_events_start(builder_);
     etdump_gen_state = ETDumpGen_Adding_Events;
   }
 }
@@ -81,6 +516,12 @@ EventTracerEntry ETDumpGen::start_profiling(
     const char* name,
     ChainID chain_id,
     DebugHandle debug_handle) {
+  // Also check for room for the ProfileEvent, so that end_profiling() is
+  // likely to fit.
+  if (!block_sampled || !reserve(string_bytes(name) + kEventBytes, 0)) {
+    // end_profiling() drops the entry without looking at it.
+    return EventTracerEntry{};
+  }
   EventTracerEntry prof_entry;
   prof_entry.event_id = name != nullptr ? create_string_entry(name) : -1;
   prof_entry.delegate_event_id_type = DelegateDebugIdType::kNone;
@@ -93,6 +534,7 @@ EventTracerEntry ETDumpGen::start_profiling(
     prof_entry.debug_handle = debug_handle;
   }
   prof_entry.start_time = et_pal_current_ticks();
+  push_perf_counters(prof_entry.start_time);
   return prof_entry;
 }
 
@@ -104,10 +546,15 @@ EventTracerEntry ETDumpGen::start_profiling_delegate(
   ET_CHECK_MSG(
       (name == nullptr) ^ (delegate_debug_index == -1),
       "Only name or delegate_debug_index can be valid. Check DelegateMappingBuilder documentation for more details.");
-  check_ready_to_add_events();
-  EventTracerEntry prof_entry;
   DelegateDebugIdType delegate_event_id_type =
       name == nullptr ? DelegateDebugIdType::kInt : DelegateDebugIdType::kStr;
+  if (!block_sampled || !reserve(string_bytes(name) + kEventBytes, 0)) {
+    EventTracerEntry prof_entry{};
+    prof_entry.delegate_event_id_type = delegate_event_id_type;
+    return prof_entry;
+  }
+  check_ready_to_add_events();
+  EventTracerEntry prof_entry;
   prof_entry.delegate_event_id_type = delegate_event_id_type;
   prof_entry.chain_id = chain_id_;
   prof_entry.debug_handle = debug_handle_;
@@ -115,45 +562,60 @@ EventTracerEntry ETDumpGen::start_profiling_delegate(
       ? create_string_entry(name)
       : delegate_debug_index;
   prof_entry.start_time = et_pal_current_ticks();
+  push_perf_counters(prof_entry.start_time);
   return prof_entry;
 }
 
 void ETDumpGen::end_profiling_delegate(
     EventTracerEntry event_tracer_entry,
     const char* metadata) {
+  PerfCounterSample counters;
+  const bool has_counters =
+      pop_perf_counters(event_tracer_entry.start_time, &counters);
+  if (!block_sampled ||
+      !reserve_event(
+          string_bytes(metadata) + kEventBytes +
+          (has_counters ? kPerfCountersBytes : 0))) {
+    return;
+  }
   et_timestamp_t end_time = et_pal_current_ticks();
   check_ready_to_add_events();
 
   int64_t string_id_metadata =
       metadata == nullptr ? -1 : create_string_entry(metadata);
+  etdump_PerfCounters_ref_t counters_ref =
+      has_counters ? create_perf_counters(counters) : 0;
 
   // Start building the ProfileEvent entry.
-  etdump_ProfileEvent_start(&builder);
-  etdump_ProfileEvent_start_time_add(&builder, event_tracer_entry.start_time);
-  etdump_ProfileEvent_end_time_add(&builder, end_time);
-  etdump_ProfileEvent_chain_id_add(&builder, chain_id_);
-  etdump_ProfileEvent_instruction_id_add(&builder, debug_handle_);
+  etdump_ProfileEvent_start(builder_);
+  etdump_ProfileEvent_start_time_add(builder_, event_tracer_entry.start_time);
+  etdump_ProfileEvent_end_time_add(builder_, end_time);
+  etdump_ProfileEvent_chain_id_add(builder_, chain_id_);
+  etdump_ProfileEvent_instruction_id_add(builder_, debug_handle_);
   // Delegate debug identifier can either be of a string type or an integer
   // type. If it's a string type then it's a value of type
   // flatbuffers_string_ref_t type, whereas if it's an integer type then we
   // write the integer value directly.
   if (event_tracer_entry.delegate_event_id_type == DelegateDebugIdType::kInt) {
     etdump_ProfileEvent_delegate_debug_id_int_add(
-        &builder, event_tracer_entry.event_id);
+        builder_, event_tracer_entry.event_id);
   } else {
     etdump_ProfileEvent_delegate_debug_id_str_add(
-        &builder, event_tracer_entry.event_id);
+        builder_, event_tracer_entry.event_id);
   }
   // String metadata is optional and if a nullptr is passed in then we don't
   // add anything.
   if (string_id_metadata != -1) {
     etdump_ProfileEvent_delegate_debug_metadata_add(
-        &builder, string_id_metadata);
+        builder_, string_id_metadata);
+  }
+  if (counters_ref != 0) {
+    etdump_ProfileEvent_perf_counters_add(builder_, counters_ref);
   }
-  etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(&builder);
-  etdump_RunData_events_push_start(&builder);
-  etdump_Event_profile_event_add(&builder, id);
-  etdump_RunData_events_push_end(&builder);
+  etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder_);
+  etdump_RunData_events_push_start(builder_);
+  etdump_Event_profile_event_add(builder_, id);
+  etdump_RunData_events_push_end(builder_);
 }
 
 void ETDumpGen::log_profiling_delegate(
@@ -165,100 +627,449 @@ void ETDumpGen::log_profiling_delegate(
   ET_CHECK_MSG(
       (name == nullptr) ^ (delegate_debug_index == -1),
       "Only name or delegate_debug_index can be valid. Check DelegateMappingBuilder documentation for more details.");
+  if (!block_sampled ||
+      !reserve_event(
+          string_bytes(name) + string_bytes(metadata) + kEventBytes)) {
+    return;
+  }
   check_ready_to_add_events();
   int64_t string_id = name != nullptr ? create_string_entry(name) : -1;
   int64_t string_id_metadata =
       metadata == nullptr ? -1 : create_string_entry(metadata);
-  etdump_ProfileEvent_start(&builder);
-  etdump_ProfileEvent_start_time_add(&builder, start_time);
-  etdump_ProfileEvent_end_time_add(&builder, end_time);
-  etdump_ProfileEvent_chain_id_add(&builder, chain_id_);
-  etdump_ProfileEvent_instruction_id_add(&builder, debug_handle_);
+  etdump_ProfileEvent_start(builder_);
+  etdump_ProfileEvent_start_time_add(builder_, start_time);
+  etdump_ProfileEvent_end_time_add(builder_, end_time);
+  etdump_ProfileEvent_chain_id_add(builder_, chain_id_);
+  etdump_ProfileEvent_instruction_id_add(builder_, debug_handle_);
   if (string_id == -1) {
     etdump_ProfileEvent_delegate_debug_id_int_add(
-        &builder, delegate_debug_index);
+        builder_, delegate_debug_index);
   } else {
-    etdump_ProfileEvent_delegate_debug_id_str_add(&builder, string_id);
+    etdump_ProfileEvent_delegate_debug_id_str_add(builder_, string_id);
   }
   if (string_id_metadata != -1) {
     etdump_ProfileEvent_delegate_debug_metadata_add(
-        &builder, string_id_metadata);
+        builder_, string_id_metadata);
   }
-  etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(&builder);
-  etdump_RunData_events_push_start(&builder);
-  etdump_Event_profile_event_add(&builder, id);
-  etdump_RunData_events_push_end(&builder);
+  etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder_);
+  etdump_RunData_events_push_start(builder_);
+  etdump_Event_profile_event_add(builder_, id);
+  etdump_RunData_events_push_end(builder_);
 }
 
 void ETDumpGen::end_profiling(EventTracerEntry prof_entry) {
+  // Read the counters first so that as little of ETDumpGen as possible is
+  // counted.
+  PerfCounterSample counters;
+  const bool has_counters = pop_perf_counters(prof_entry.start_time, &counters);
   et_timestamp_t end_time = et_pal_current_ticks();
   ET_CHECK_MSG(
       prof_entry.delegate_event_id_type == DelegateDebugIdType::kNone,
       "Delegate events must use end_profiling_delegate to mark the end of a delegate profiling event.");
+  if (!block_sampled ||
+      !reserve_event(kEventBytes + (has_counters ? kPerfCountersBytes : 0))) {
+    return;
+  }
   check_ready_to_add_events();
+  etdump_PerfCounters_ref_t counters_ref =
+      has_counters ? create_perf_counters(counters) : 0;
 
-  etdump_ProfileEvent_start(&builder);
-  etdump_ProfileEvent_start_time_add(&builder, prof_entry.start_time);
-  etdump_ProfileEvent_end_time_add(&builder, end_time);
-  etdump_ProfileEvent_chain_id_add(&builder, prof_entry.chain_id);
-  etdump_ProfileEvent_instruction_id_add(&builder, prof_entry.debug_handle);
+  etdump_ProfileEvent_start(builder_);
+  etdump_ProfileEvent_start_time_add(builder_, prof_entry.start_time);
+  etdump_ProfileEvent_end_time_add(builder_, end_time);
+  etdump_ProfileEvent_chain_id_add(builder_, prof_entry.chain_id);
+  etdump_ProfileEvent_instruction_id_add(builder_, prof_entry.debug_handle);
   if (prof_entry.event_id != -1) {
-    etdump_ProfileEvent_name_add(&builder, prof_entry.event_id);
+    etdump_ProfileEvent_name_add(builder_, prof_entry.event_id);
+  }
+  if (counters_ref != 0) {
+    etdump_ProfileEvent_perf_counters_add(builder_, counters_ref);
+  }
+  etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder_);
+  etdump_RunData_events_push_start(builder_);
+  etdump_Event_profile_event_add(builder_, id);
+  etdump_RunData_events_push_end(builder_);
+}
+
+void ETDumpGen::log_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time) {
+  if (!block_sampled || !reserve_event(string_bytes(name) + kEventBytes)) {
+    return;
+  }
+  check_ready_to_add_events();
+  int64_t string_id = name != nullptr ? create_string_entry(name) : -1;
+
+  etdump_ProfileEvent_start(builder_);
+  etdump_ProfileEvent_start_time_add(builder_, start_time);
+  etdump_ProfileEvent_end_time_add(builder_, end_time);
+  etdump_ProfileEvent_chain_id_add(builder_, chain_id);
+  etdump_ProfileEvent_instruction_id_add(builder_, debug_handle);
+  if (string_id != -1) {
+    etdump_ProfileEvent_name_add(builder_, string_id);
+  }
+  etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder_);
+  etdump_RunData_events_push_start(builder_);
+  etdump_Event_profile_event_add(builder_, id);
+  etdump_RunData_events_push_end(builder_);
+}
+
+void ETDumpGen::push_perf_counters(et_timestamp_t start_time) {
+  if (!perf_counters_enabled || perf_counter_depth >= kMaxPerfCounterDepth) {
+    return;
   }
-  etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(&builder);
-  etdump_RunData_events_push_start(&builder);
-  etdump_Event_profile_event_add(&builder, id);
-  etdump_RunData_events_push_end(&builder);
+  PerfCounterSample& sample = perf_counter_stack[perf_counter_depth];
+  sample.mask = et_pal_read_perf_counters(sample.values);
+  if (sample.mask == 0) {
+    return;
+  }
+  sample.start_time = start_time;
+  ++perf_counter_depth;
+}
+
+bool ETDumpGen::pop_perf_counters(
+    et_timestamp_t start_time,
+    PerfCounterSample* delta) {
+  // Entries that were dropped or nested too deeply have no sample of their
+  // own, and must not take the enclosing event's.
+  if (perf_counter_depth == 0 ||
+      perf_counter_stack[perf_counter_depth - 1].start_time != start_time) {
+    return false;
+  }
+  const PerfCounterSample& start = perf_counter_stack[--perf_counter_depth];
+  delta->mask = et_pal_read_perf_counters(delta->values) & start.mask;
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    if (delta->mask & (1u << i)) {
+      delta->values[i] -= start.values[i];
+    }
+  }
+  return delta->mask != 0;
+}
+
+etdump_PerfCounters_ref_t ETDumpGen::create_perf_counters(
+    const PerfCounterSample& delta) {
+  int64_t values[kNumPerfCounters];
+  for (size_t i = 0; i < kNumPerfCounters; ++i) {
+    values[i] =
+        delta.mask & (1u << i) ? static_cast<int64_t>(delta.values[i]) : -1;
+  }
+  return etdump_PerfCounters_create(
+      builder_,
+      values[kPerfCounterCycles],
+      values[kPerfCounterInstructions],
+      values[kPerfCounterL1DReadMisses],
+      values[kPerfCounterLLCReadMisses]);
 }
 
 AllocatorID ETDumpGen::track_allocator(const char* name) {
+  if (!block_sampled || !reserve_event(string_bytes(name) + kAllocatorBytes)) {
+    return 0;
+  }
   ET_CHECK_MSG(
       (etdump_gen_state == ETDumpGen_Block_Created ||
        etdump_gen_state == ETDumpGen_Adding_Allocators),
       "Allocators can only be added immediately after a new block is created and before any events are added.");
   if (etdump_gen_state != ETDumpGen_Adding_Allocators) {
-    etdump_RunData_allocators_start(&builder);
+    etdump_RunData_allocators_start(builder_);
     etdump_gen_state = ETDumpGen_Adding_Allocators;
   }
   flatbuffers_string_ref_t ref = create_string_entry(name);
-  etdump_RunData_allocators_push_create(&builder, ref);
-  return etdump_RunData_allocators_reserved_len(&builder);
+  etdump_RunData_allocators_push_create(builder_, ref);
+  return etdump_RunData_allocators_reserved_len(builder_);
 }
 
 void ETDumpGen::track_allocation(
     AllocatorID allocator_id,
     size_t allocation_size) {
+  if (!block_sampled || !reserve_event(kEventBytes)) {
+    return;
+  }
+  check_ready_to_add_events();
+
+  etdump_RunData_events_push_start(builder_);
+  etdump_Event_allocation_event_create(builder_, allocator_id, allocation_size);
+  etdump_RunData_events_push_end(builder_);
+}
+
+void ETDumpGen::log_instruction_memory(
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    size_t bytes_read,
+    size_t bytes_written,
+    const TensorMemoryAccess* accesses,
+    size_t num_accesses) {
+  if (!block_sampled ||
+      !reserve_event(kEventBytes + num_accesses * kTensorMemoryAccessBytes)) {
+    return;
+  }
+  check_ready_to_add_events();
+
+  etdump_TensorMemoryAccess_vec_start(builder_);
+  for (size_t i = 0; i < num_accesses; ++i) {
+    etdump_TensorMemoryAccess_vec_push_create(
+        builder_,
+        accesses[i].memory_id,
+        accesses[i].memory_offset,
+        accesses[i].nbytes,
+        accesses[i].is_write);
+  }
+  etdump_TensorMemoryAccess_vec_ref_t tensors_ref =
+      etdump_TensorMemoryAccess_vec_end(builder_);
+  etdump_MemoryEvent_ref_t id = etdump_MemoryEvent_create(
+      builder_, chain_id, debug_handle, bytes_read, bytes_written, tensors_ref);
+  etdump_RunData_events_push_start(builder_);
+  etdump_Event_memory_event_add(builder_, id);
+  etdump_RunData_events_push_end(builder_);
+}
+
+void ETDumpGen::log_load_event(const LoadEvent& event) {
+  if (!block_sampled ||
+      !reserve_event(string_bytes(event.name) + kEventBytes)) {
+    return;
+  }
   check_ready_to_add_events();
+  flatbuffers_string_ref_t name_ref =
+      event.name != nullptr ? create_string_entry(event.name) : 0;
 
-  etdump_RunData_events_push_start(&builder);
-  etdump_Event_allocation_event_create(&builder, allocator_id, allocation_size);
-  etdump_RunData_events_push_end(&builder);
+  etdump_LoadEvent_ref_t id = etdump_LoadEvent_create(
+      builder_,
+      name_ref,
+      event.delegate_index,
+      event.start_time,
+      event.end_time,
+      event.bytes_loaded,
+      event.bytes_allocated);
+  etdump_RunData_events_push_start(builder_);
+  etdump_Event_load_event_add(builder_, id);
+  etdump_RunData_events_push_end(builder_);
+}
+
+void ETDumpGen::log_intermediate_output(
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    const IntermediateOutput& output) {
+  const size_t dim = output.dim < kMaxLoggedOutputDims ? output.dim
+                                                       : kMaxLoggedOutputDims;
+  const size_t data_bytes = output.data != nullptr ? output.nbytes : 0;
+  if (!block_sampled ||
+      !reserve_event(
+          kEventBytes + kOutputEventBytes + dim * sizeof(int32_t) +
+          data_bytes + 2 * kRefBytes)) {
+    return;
+  }
+  check_ready_to_add_events();
+
+  flatbuffers_int32_vec_start(builder_);
+  for (size_t d = 0; d < dim; ++d) {
+    flatbuffers_int32_vec_push_create(
+        builder_, static_cast<int32_t>(output.sizes[d]));
+  }
+  flatbuffers_int32_vec_ref_t sizes_ref = flatbuffers_int32_vec_end(builder_);
+  flatbuffers_uint8_vec_ref_t data_ref = data_bytes > 0
+      ? flatbuffers_uint8_vec_create(
+            builder_, static_cast<const uint8_t*>(output.data), data_bytes)
+      : 0;
+  // The data is in the memory order of the tensor, so no strides are
+  // recorded for it.
+  etdump_Tensor_ref_t tensor_ref = etdump_Tensor_create(
+      builder_,
+      static_cast<executorch_flatbuffer_ScalarType_enum_t>(output.scalar_type),
+      sizes_ref,
+      /*strides=*/0,
+      data_ref);
+  etdump_TensorStats_ref_t stats_ref = etdump_TensorStats_create(
+      builder_,
+      output.stats.numel,
+      output.stats.min,
+      output.stats.max,
+      output.stats.mean,
+      output.stats.nan_count,
+      output.stats.hash);
+  etdump_OutputEvent_ref_t id = etdump_OutputEvent_create(
+      builder_,
+      chain_id,
+      debug_handle,
+      output.output_index,
+      stats_ref,
+      tensor_ref);
+  etdump_RunData_events_push_start(builder_);
+  etdump_Event_output_event_add(builder_, id);
+  etdump_RunData_events_push_end(builder_);
+}
+
+etdump_result ETDumpGen::get_retained_etdump_data() {
+  if (retained_block_open) {
+    finish_retained_block();
+  }
+  // Nothing may be added to the closed block; drop events until the next
+  // create_event_block().
+  block_sampled = false;
+
+  etdump_result result = {nullptr, 0};
+  const size_t num_retained = get_num_blocks();
+  if (num_retained == 0) {
+    return result;
+  }
+
+  flatcc_builder_reset(&builder);
+  flatbuffers_buffer_start(&builder, etdump_ETDump_file_identifier);
+  etdump_ETDump_start_as_root_with_size(&builder);
+  etdump_ETDump_version_add(&builder, ETDUMP_VERSION);
+  add_ticks_to_ns(&builder);
+  etdump_ETDump_run_data_start(&builder);
+  // Emit the retained blocks from oldest to newest.
+  const size_t max_blocks = sampling_config.max_blocks;
+  const size_t first = (next_retained_block + max_blocks - num_retained) %
+      max_blocks;
+  for (size_t i = 0; i < num_retained; ++i) {
+    void* block_buf = retained_blocks[(first + i) % max_blocks].buf;
+    size_t size = 0;
+    etdump_ETDump_table_t block = etdump_ETDump_as_root_with_identifier(
+        flatbuffers_read_size_prefix(block_buf, &size),
+        etdump_ETDump_file_identifier);
+    etdump_RunData_table_t run_data =
+        etdump_RunData_vec_at(etdump_ETDump_run_data(block), 0);
+    etdump_ETDump_run_data_push_start(&builder);
+    copy_run_data(&builder, run_data, etdump_RunData_thread_id(run_data));
+    etdump_ETDump_run_data_push_end(&builder);
+  }
+  etdump_ETDump_run_data_end(&builder);
+  etdump_ETDump_ref_t root = etdump_ETDump_end(&builder);
+  flatbuffers_buffer_end(&builder, root);
+  result.buf = flatcc_builder_finalize_aligned_buffer(&builder, &result.size);
+  return result;
 }
 
 etdump_result ETDumpGen::get_etdump_data() {
+  if (retained_blocks != nullptr) {
+    return get_retained_etdump_data();
+  }
+  return finish_etdump();
+}
+
+etdump_result ETDumpGen::finish_etdump() {
   etdump_result result;
   if (etdump_gen_state == ETDumpGen_Adding_Events) {
-    etdump_RunData_events_end(&builder);
+    etdump_RunData_events_end(builder_);
   } else if (etdump_gen_state == ETDumpGen_Adding_Allocators) {
-    etdump_RunData_allocators_end(&builder);
+    etdump_RunData_allocators_end(builder_);
   } else if (etdump_gen_state == ETDumpGen_Init) {
     result.buf = nullptr;
     result.size = 0;
     return result;
   }
-  etdump_ETDump_run_data_push_end(&builder);
-  etdump_ETDump_run_data_end(&builder);
-  etdump_ETDump_ref_t root = etdump_ETDump_end(&builder);
-  flatbuffers_buffer_end(&builder, root);
+  etdump_ETDump_run_data_push_end(builder_);
+  etdump_ETDump_run_data_end(builder_);
+  etdump_ETDump_ref_t root = etdump_ETDump_end(builder_);
+  flatbuffers_buffer_end(builder_, root);
   if (num_blocks == 0) {
     result = {nullptr, 0};
+  } else if (fixed_buffer) {
+    result.buf = emitter.finalize(&result.size);
+  } else {
+    result.buf = flatcc_builder_finalize_aligned_buffer(builder_, &result.size);
+  }
+  return result;
+}
+
+void ETDumpGen::set_flush_sink(
+    FlushFn fn,
+    void* context,
+    size_t every_n_blocks) {
+  ET_CHECK_MSG(
+      retained_blocks == nullptr,
+      "Flushing is not supported together with max_blocks");
+  flush_fn = fn;
+  flush_context = context;
+  flush_every_n_blocks = every_n_blocks;
+}
+
+void ETDumpGen::flush() {
+  ET_CHECK_MSG(flush_fn != nullptr, "No flush sink was set");
+  if (num_blocks == 0) {
+    return;
+  }
+  etdump_result result = finish_etdump();
+  flush_fn(flush_context, result.buf, result.size);
+  num_flushed_blocks += num_blocks;
+
+  // Start over, keeping the memory that the builder has already allocated.
+  if (fixed_buffer) {
+    emitter.reset();
+    buffer_full = false;
+    pending_output_bytes = 0;
+    block_pending_bytes = 0;
   } else {
+    free(result.buf);
+  }
+  flatcc_builder_reset(&builder);
+  start_etdump();
+  num_blocks = 0;
+  etdump_gen_state = ETDumpGen_Init;
+  // The block in progress, if any, was closed by finish_etdump().
+  block_sampled = false;
+}
+
+void ETDumpGen::write_to_file(void* context, const void* data, size_t size) {
+  FILE* file = static_cast<FILE*>(context);
+  if (fwrite(data, 1, size, file) != size) {
+    ET_LOG(Error, "Failed to write %zu bytes of ETDump", size);
+  }
+  fflush(file);
+}
+
+etdump_result merge_etdumps(
+    const etdump_result* etdumps,
+    const uint32_t* thread_ids,
+    size_t num_etdumps) {
+  etdump_result result = {nullptr, 0};
+  flatcc_builder_t builder;
+  flatcc_builder_init(&builder);
+  flatbuffers_buffer_start(&builder, etdump_ETDump_file_identifier);
+  etdump_ETDump_start_as_root_with_size(&builder);
+  etdump_ETDump_version_add(&builder, ETDUMP_VERSION);
+  add_ticks_to_ns(&builder);
+  etdump_ETDump_run_data_start(&builder);
+  size_t num_blocks = 0;
+  for (size_t i = 0; i < num_etdumps; ++i) {
+    if (etdumps[i].buf == nullptr) {
+      continue;
+    }
+    size_t size = 0;
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        flatbuffers_read_size_prefix(etdumps[i].buf, &size),
+        etdump_ETDump_file_identifier);
+    ET_CHECK_MSG(etdump != nullptr, "Input %zu is not an ETDump", i);
+    etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+    for (size_t j = 0; j < etdump_RunData_vec_len(run_data_vec); ++j) {
+      etdump_RunData_table_t run_data = etdump_RunData_vec_at(run_data_vec, j);
+      etdump_ETDump_run_data_push_start(&builder);
+      copy_run_data(
+          &builder,
+          run_data,
+          thread_ids != nullptr ? thread_ids[i]
+                                : etdump_RunData_thread_id(run_data));
+      etdump_ETDump_run_data_push_end(&builder);
+      ++num_blocks;
+    }
+  }
+  etdump_ETDump_run_data_end(&builder);
+  etdump_ETDump_ref_t root = etdump_ETDump_end(&builder);
+  flatbuffers_buffer_end(&builder, root);
+  if (num_blocks > 0) {
     result.buf = flatcc_builder_finalize_aligned_buffer(&builder, &result.size);
   }
+  flatcc_builder_clear(&builder);
   return result;
 }
 
 size_t ETDumpGen::get_num_blocks() {
+  if (retained_blocks != nullptr && num_blocks > sampling_config.max_blocks) {
+    return sampling_config.max_blocks;
+  }
   return num_blocks;
 }
 
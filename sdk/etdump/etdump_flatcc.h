@@ -8,9 +8,12 @@
 
 #pragma once
 
+#include <executorch/sdk/etdump/emitter.h>
 #include <executorch/sdk/etdump/etdump_schema_flatcc_builder.h>
 #include <executorch/sdk/etdump/etdump_schema_flatcc_reader.h>
 #include "executorch/runtime/core/event_tracer.h"
+#include "executorch/runtime/core/memory_allocator.h"
+#include "executorch/runtime/core/span.h"
 #include "executorch/runtime/platform/platform.h"
 
 #define ETDUMP_VERSION 0
@@ -30,9 +33,75 @@ struct etdump_result {
   size_t size;
 };
 
+/**
+ * Controls which event blocks an ETDumpGen records, so that tracing can be
+ * left on for long-running or heavily-loaded processes.
+ *
+ * A block (everything logged between two calls to create_event_block()) is
+ * recorded only if it passes both the every-Nth and the probabilistic test.
+ * Events logged into a block that was not sampled are dropped without touching
+ * the flatcc builder.
+ */
+struct ETDumpSamplingConfig {
+  /// Record one out of every `sample_every_n` blocks, starting with the first.
+  /// 0 and 1 both record every block.
+  size_t sample_every_n = 1;
+
+  /// Probability in [0, 1] that a block which passed the every-Nth test is
+  /// recorded.
+  float sample_probability = 1.0f;
+
+  /// Seed of the pseudo-random generator used for `sample_probability`. The
+  /// same seed produces the same sequence of sampled blocks.
+  uint32_t seed = 1;
+
+  /// If non-zero, only the most recently recorded `max_blocks` blocks are kept
+  /// and older ones are discarded, which bounds the memory that ETDumpGen
+  /// uses. 0 keeps every recorded block.
+  size_t max_blocks = 0;
+};
+
+/// What an ETDumpGen with a fixed buffer does when the buffer fills up.
+enum class ETDumpOverflowPolicy {
+  /// Drop the event that does not fit and every event after it until the next
+  /// flush(). The events recorded so far are still returned by
+  /// get_etdump_data().
+  kDropNewEvents,
+  /// Abort with ET_CHECK.
+  kAbort,
+};
+
 class ETDumpGen : public EventTracer {
  public:
+  /**
+   * Receives one finished, size-prefixed ETDump flatbuffer from flush().
+   * `data` is only valid for the duration of the call.
+   */
+  using FlushFn = void (*)(void* context, const void* data, size_t size);
+
   ETDumpGen();
+  explicit ETDumpGen(const ETDumpSamplingConfig& sampling_config);
+
+  /**
+   * Creates an ETDumpGen that never allocates from the heap.
+   *
+   * The serialized ETDump is built directly in `buffer`, and get_etdump_data()
+   * returns a pointer into it that must not be freed. The flatcc builder's
+   * working memory comes from `builder_memory`. Both must outlive the
+   * ETDumpGen.
+   *
+   * Before recording each event, ETDumpGen checks that the event and
+   * everything needed to finish the ETDump fits in the remaining memory, so
+   * that get_etdump_data() always produces a valid ETDump; events that don't
+   * fit are handled according to `overflow_policy`.
+   * ETDumpSamplingConfig::max_blocks must be 0.
+   */
+  ETDumpGen(
+      Span<uint8_t> buffer,
+      MemoryAllocator* builder_memory,
+      ETDumpOverflowPolicy overflow_policy =
+          ETDumpOverflowPolicy::kDropNewEvents,
+      const ETDumpSamplingConfig& sampling_config = ETDumpSamplingConfig());
 
   ~ETDumpGen() override;
   void clear_builder();
@@ -56,18 +125,211 @@ class ETDumpGen : public EventTracer {
       et_timestamp_t end_time,
       const char* metadata) override;
   virtual void track_allocation(AllocatorID id, size_t size) override;
+
+  /**
+   * Logs a profiling event that has already completed, as if by a
+   * start_profiling()/end_profiling() pair at the given times. Used to replay
+   * events that were timed elsewhere. Perf counters are not recorded.
+   */
+  void log_profiling(
+      const char* name,
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time);
   virtual AllocatorID track_allocator(const char* name) override;
+  virtual void log_instruction_memory(
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      size_t bytes_read,
+      size_t bytes_written,
+      const TensorMemoryAccess* accesses,
+      size_t num_accesses) override;
+  virtual void log_load_event(const LoadEvent& event) override;
+  virtual void log_intermediate_output(
+      ChainID chain_id,
+      DebugHandle debug_handle,
+      const IntermediateOutput& output) override;
+
+  /**
+   * Serializes the recorded blocks. The returned buffer is owned by the
+   * caller and must be released with free().
+   *
+   * When ETDumpSamplingConfig::max_blocks is set, the block being recorded is
+   * closed and may be called again later to take another snapshot of the
+   * blocks retained at that point; events logged before the next
+   * create_event_block() are dropped. Otherwise it must only be called once.
+   */
   etdump_result get_etdump_data();
+
+  /// Returns the number of blocks that get_etdump_data() would emit.
   size_t get_num_blocks();
 
+  /**
+   * Streams the ETDump to `flush_fn` so that long-running processes can get
+   * traces out while keeping memory use constant.
+   *
+   * Each flush() passes the blocks recorded since the previous one to
+   * `flush_fn` as a standalone size-prefixed ETDump, and then resets the
+   * builder while keeping its memory. Appending the flushed buffers to one
+   * file yields a stream that sdk/etdump/serialize.py can read back, even
+   * while it is still being written.
+   *
+   * Not supported together with ETDumpSamplingConfig::max_blocks.
+   *
+   * @param[in] flush_fn The sink, or nullptr to stop streaming.
+   * @param[in] context Passed to `flush_fn`.
+   * @param[in] flush_every_n_blocks If non-zero, create_event_block()
+   *     flushes automatically whenever this many blocks have been recorded.
+   *     Otherwise the ETDump is only flushed by explicit calls to flush().
+   */
+  void set_flush_sink(
+      FlushFn flush_fn,
+      void* context,
+      size_t flush_every_n_blocks = 0);
+
+  /**
+   * Passes the blocks recorded so far to the flush sink and starts a new
+   * ETDump. Events logged after this call and before the next
+   * create_event_block() are dropped, so call it between executions. Does
+   * nothing if no blocks were recorded.
+   */
+  void flush();
+
+  /// Returns the number of blocks passed to the flush sink so far.
+  size_t get_num_flushed_blocks() {
+    return num_flushed_blocks;
+  }
+
+  /// A FlushFn that appends to the `FILE*` passed as its context.
+  static void write_to_file(void* context, const void* data, size_t size);
+
+  /// Returns the number of calls to create_event_block(), including blocks
+  /// that were not sampled.
+  size_t get_num_blocks_seen() {
+    return num_blocks_seen;
+  }
+
+  /// Returns the number of events and blocks that were dropped because the
+  /// fixed buffer was full.
+  size_t get_num_dropped_events() {
+    return num_dropped_events;
+  }
+
+  /**
+   * Records the hardware performance counters read by
+   * et_pal_read_perf_counters() over the span of each event logged by
+   * start_profiling()/end_profiling() and their delegate variants, in
+   * ProfileEvent.perf_counters. Events nested more deeply than
+   * kMaxPerfCounterDepth and counters that the platform does not support are
+   * not recorded. Disabled by default.
+   */
+  void set_perf_counters_enabled(bool enabled) {
+    perf_counters_enabled = enabled;
+    perf_counter_depth = 0;
+  }
+
+  /// Maximum nesting depth of profiling events whose counters are recorded.
+  static constexpr size_t kMaxPerfCounterDepth = 8;
+
  private:
+  /// A block retained under ETDumpSamplingConfig::max_blocks. Each one is
+  /// built as a standalone ETDump with a single RunData, so that it can be
+  /// discarded independently of the others.
+  struct RetainedBlock {
+    flatcc_builder_t builder;
+    bool builder_initialized;
+    void* buf;
+  };
+
+  /// Counters read when a profiling event started.
+  struct PerfCounterSample {
+    et_timestamp_t start_time;
+    uint32_t mask;
+    uint64_t values[kNumPerfCounters];
+  };
+
   flatcc_builder_t builder;
+  // The builder that events are currently added to: either `builder` or the
+  // builder of the retained block being recorded.
+  flatcc_builder_t* builder_ = &builder;
   size_t num_blocks = 0;
   ETDumpGen_State etdump_gen_state = ETDumpGen_Init;
 
+  ETDumpSamplingConfig sampling_config;
+  uint32_t rng_state = 1;
+  size_t num_blocks_seen = 0;
+  // False while inside a block that was not sampled.
+  bool block_sampled = true;
+
+  RetainedBlock* retained_blocks = nullptr;
+  // True while a retained block is being recorded into
+  // retained_blocks[current_retained_block].
+  bool retained_block_open = false;
+  size_t current_retained_block = 0;
+  // Index that the next retained block will be recorded into.
+  size_t next_retained_block = 0;
+
+  // Fixed-buffer mode. The pending byte counts are upper bounds on what the
+  // builder will emit once the open vectors and tables are closed.
+  bool fixed_buffer = false;
+  internal::ETDumpEmitter emitter;
+  internal::ETDumpBuilderAllocator builder_allocator;
+  ETDumpOverflowPolicy overflow_policy = ETDumpOverflowPolicy::kDropNewEvents;
+  bool buffer_full = false;
+  size_t num_dropped_events = 0;
+  size_t pending_output_bytes = 0;
+  size_t block_pending_bytes = 0;
+
+  FlushFn flush_fn = nullptr;
+  void* flush_context = nullptr;
+  size_t flush_every_n_blocks = 0;
+  size_t num_flushed_blocks = 0;
+
+  // Counters of the open profiling events, innermost last.
+  bool perf_counters_enabled = false;
+  PerfCounterSample perf_counter_stack[kMaxPerfCounterDepth];
+  size_t perf_counter_depth = 0;
+
+  void start_etdump();
+  etdump_result finish_etdump();
+  void set_sampling_config(const ETDumpSamplingConfig& config);
+  /// Returns true if an item that emits up to `bytes` now and `pending_bytes`
+  /// later fits in the fixed buffer. Always true without a fixed buffer.
+  bool reserve(size_t bytes, size_t pending_bytes);
+  /// reserve() for an item that adds an entry to the current block's events
+  /// or allocators.
+  bool reserve_event(size_t bytes);
   void check_ready_to_add_events();
   int64_t create_string_entry(const char* name);
+  bool sample_next_block();
+  void start_retained_block(const char* name);
+  void finish_retained_block();
+  etdump_result get_retained_etdump_data();
+  void push_perf_counters(et_timestamp_t start_time);
+  bool pop_perf_counters(et_timestamp_t start_time, PerfCounterSample* delta);
+  etdump_PerfCounters_ref_t create_perf_counters(
+      const PerfCounterSample& delta);
 };
 
+/**
+ * Merges ETDumps produced by separate ETDumpGens into one that holds all of
+ * their blocks, in order.
+ *
+ * @param[in] etdumps The ETDumps to merge, as returned by
+ *     ETDumpGen::get_etdump_data(). Entries with a null buffer are skipped.
+ * @param[in] thread_ids If not null, `thread_ids[i]` is recorded as the
+ *     thread_id of every block of `etdumps[i]`. Otherwise the blocks keep their
+ *     thread ids.
+ * @param[in] num_etdumps The number of entries in `etdumps`.
+ *
+ * @returns The merged ETDump, which must be released with free(), or a null
+ *     buffer if there were no blocks.
+ */
+etdump_result merge_etdumps(
+    const etdump_result* etdumps,
+    const uint32_t* thread_ids,
+    size_t num_etdumps);
+
 } // namespace executor
 } // namespace torch
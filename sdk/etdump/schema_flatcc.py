@@ -22,8 +22,9 @@ from executorch.exir.scalar_type import ScalarType
 class Tensor:
     scalar_type: ScalarType
     sizes: List[int]
-    strides: List[int]
-    data: bytes
+    # Not set for the outputs in an OutputEvent whose data wasn't logged.
+    strides: Optional[List[int]]
+    data: Optional[bytes]
 
 
 @dataclass
@@ -88,6 +89,14 @@ class PROFILE_EVENT_ENUM(Enum):
     LOAD_MODEL = "Program::load_method"
 
 
+@dataclass
+class PerfCounters:
+    cycles: int = -1
+    instructions: int = -1
+    l1d_read_misses: int = -1
+    llc_read_misses: int = -1
+
+
 @dataclass
 class ProfileEvent:
     name: Optional[str]
@@ -98,6 +107,7 @@ class ProfileEvent:
     delegate_debug_metadata: Optional[str]
     start_time: int
     end_time: int
+    perf_counters: Optional[PerfCounters] = None
 
 
 @dataclass
@@ -106,17 +116,67 @@ class AllocationEvent:
     allocation_size: int
 
 
+@dataclass
+class TensorMemoryAccess:
+    memory_id: int
+    memory_offset: int
+    size: int
+    is_write: bool
+
+
+@dataclass
+class MemoryEvent:
+    chain_id: int
+    instruction_id: int
+    bytes_read: int
+    bytes_written: int
+    tensors: Optional[List[TensorMemoryAccess]]
+
+
+@dataclass
+class LoadEvent:
+    name: str
+    delegate_index: int
+    start_time: int
+    end_time: int
+    bytes_loaded: int
+    bytes_allocated: int
+
+
+@dataclass
+class TensorStats:
+    numel: int
+    min: float
+    max: float
+    mean: float
+    nan_count: int
+    hash: int
+
+
+@dataclass
+class OutputEvent:
+    chain_id: int
+    instruction_id: int
+    output_index: int
+    stats: Optional[TensorStats]
+    tensor: Optional[Tensor]
+
+
 @dataclass
 class Allocator:
     name: str
 
 
-# Must have one of profile_event, allocation_event, or debug_event
+# Must have one of profile_event, allocation_event, debug_event, memory_event,
+# load_event or output_event
 @dataclass
 class Event:
     profile_event: Optional[ProfileEvent]
     allocation_event: Optional[AllocationEvent]
     debug_event: Optional[DebugEvent]
+    memory_event: Optional[MemoryEvent] = None
+    load_event: Optional[LoadEvent] = None
+    output_event: Optional[OutputEvent] = None
 
 
 @dataclass
@@ -124,9 +184,14 @@ class RunData:
     name: str
     allocators: Optional[List[Allocator]]
     events: Optional[List[Event]]
+    thread_id: int = 0
 
 
 @dataclass
 class ETDumpFlatCC:
     version: int
     run_data: List[RunData]
+    # ns = ticks * ticks_to_ns_numerator / ticks_to_ns_denominator, or 0 if the
+    # duration of the ticks is unknown.
+    ticks_to_ns_numerator: int = 0
+    ticks_to_ns_denominator: int = 0
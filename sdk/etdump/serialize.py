@@ -8,6 +8,7 @@
 
 import json
 import os
+import struct
 import tempfile
 
 import pkg_resources
@@ -108,3 +109,51 @@ def deserialize_from_etdump_flatcc(
     return _deserialize_from_json_to_etdump_flatcc(
         _convert_from_flatcc(data, size_prefixed)
     )
+
+
+def deserialize_from_etdump_flatcc_stream(data: bytes) -> ETDumpFlatCC:
+    """
+    Given the output of an ETDumpGen that flushed periodically, i.e. a series of
+    size-prefixed etdump flatbuffers written back to back, this function will
+    deserialize all of them and return a single ETDump python object holding the
+    run data of every flatbuffer in order. A single size-prefixed etdump is a
+    valid stream of one buffer.
+
+    An incomplete buffer at the end of the stream, as seen when reading a file
+    that is still being written, is ignored.
+    Args:
+        data: The etdump stream.
+    Returns:
+        Deserialized ETDump python object.
+    """
+    prefix_size = struct.calcsize("<I")
+    version = None
+    ticks_to_ns = (0, 0)
+    run_data = []
+    offset = 0
+    while offset + prefix_size <= len(data):
+        (size,) = struct.unpack_from("<I", data, offset)
+        end = offset + prefix_size + size
+        if end > len(data):
+            break
+        etdump = deserialize_from_etdump_flatcc(data[offset:end])
+        if version is None:
+            version = etdump.version
+            ticks_to_ns = (
+                etdump.ticks_to_ns_numerator,
+                etdump.ticks_to_ns_denominator,
+            )
+        elif etdump.version != version:
+            raise ValueError(
+                f"ETDump stream mixes versions {version} and {etdump.version}"
+            )
+        run_data.extend(etdump.run_data)
+        offset = end
+    if version is None:
+        raise ValueError("ETDump stream does not contain a complete etdump")
+    return ETDumpFlatCC(
+        version=version,
+        run_data=run_data,
+        ticks_to_ns_numerator=ticks_to_ns[0],
+        ticks_to_ns_denominator=ticks_to_ns[1],
+    )
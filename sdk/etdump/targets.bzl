@@ -90,9 +90,11 @@ def define_common_targets():
     runtime.cxx_library(
         name = "etdump_flatcc",
         srcs = [
+            "emitter.cpp",
             "etdump_flatcc.cpp",
         ],
         exported_headers = [
+            "emitter.h",
             "etdump_flatcc.h",
         ],
         deps = [
@@ -104,3 +106,21 @@ def define_common_targets():
         ],
         visibility = ["//executorch/..."],
     )
+
+    runtime.cxx_library(
+        name = "etdump_concurrent",
+        srcs = [
+            "etdump_concurrent.cpp",
+        ],
+        exported_headers = [
+            "etdump_concurrent.h",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+        exported_deps = [
+            ":etdump_flatcc",
+            "//executorch/runtime/core:core",
+        ],
+        visibility = ["//executorch/..."],
+    )
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/sdk/etdump/etdump_concurrent.h>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace torch {
+namespace executor {
+
+class ConcurrentETDumpTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+};
+
+namespace {
+
+etdump_ETDump_table_t read_etdump(const etdump_result& result) {
+  size_t size = 0;
+  void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+  return etdump_ETDump_as_root_with_identifier(
+      buf, etdump_ETDump_file_identifier);
+}
+
+void log_events(ConcurrentETDumpGen* tracer, size_t num_events) {
+  tracer->create_event_block("worker_block");
+  for (size_t i = 0; i < num_events; ++i) {
+    EventTracerEntry entry = tracer->start_profiling("worker_event", 0, i);
+    tracer->end_profiling(entry);
+  }
+}
+
+} // namespace
+
+TEST_F(ConcurrentETDumpTest, MergesThreadsWithThreadIds) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kNumEvents = 20;
+  ConcurrentETDumpGen tracer(kNumThreads, 64);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(log_events, &tracer, kNumEvents);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(tracer.get_num_dropped_events(), 0);
+
+  etdump_result result = tracer.get_etdump_data();
+  ASSERT_NE(result.buf, nullptr);
+  etdump_ETDump_table_t etdump = read_etdump(result);
+  ASSERT_NE(etdump, nullptr);
+
+  etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+  ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), kNumThreads);
+  std::set<uint32_t> thread_ids;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    etdump_RunData_table_t run_data = etdump_RunData_vec_at(run_data_vec, i);
+    EXPECT_EQ(std::string(etdump_RunData_name(run_data)), "worker_block");
+    thread_ids.insert(etdump_RunData_thread_id(run_data));
+
+    etdump_Event_vec_t events = etdump_RunData_events(run_data);
+    ASSERT_EQ(etdump_Event_vec_len(events), kNumEvents);
+    for (size_t j = 0; j < kNumEvents; ++j) {
+      etdump_ProfileEvent_table_t event =
+          etdump_Event_profile_event(etdump_Event_vec_at(events, j));
+      EXPECT_EQ(std::string(etdump_ProfileEvent_name(event)), "worker_event");
+      EXPECT_EQ(etdump_ProfileEvent_instruction_id(event), j);
+      EXPECT_LE(
+          etdump_ProfileEvent_start_time(event),
+          etdump_ProfileEvent_end_time(event));
+    }
+  }
+  // Every thread got an id of its own, and 0 is reserved for "unknown".
+  EXPECT_EQ(thread_ids.size(), kNumThreads);
+  EXPECT_EQ(thread_ids.count(0), 0);
+
+  free(result.buf);
+}
+
+TEST_F(ConcurrentETDumpTest, DrainMakesRoomInTheRing) {
+  ConcurrentETDumpGen tracer(1, 4);
+  tracer.create_event_block("block");
+  for (size_t i = 0; i < 3; ++i) {
+    tracer.end_profiling(tracer.start_profiling("event"));
+  }
+  // The ring holds 4 records: the block and three events.
+  EXPECT_EQ(tracer.get_num_dropped_events(), 0);
+  tracer.end_profiling(tracer.start_profiling("event"));
+  EXPECT_EQ(tracer.get_num_dropped_events(), 1);
+
+  tracer.drain();
+  tracer.end_profiling(tracer.start_profiling("event"));
+  EXPECT_EQ(tracer.get_num_dropped_events(), 1);
+
+  etdump_result result = tracer.get_etdump_data();
+  etdump_RunData_vec_t run_data_vec =
+      etdump_ETDump_run_data(read_etdump(result));
+  ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), 1);
+  EXPECT_EQ(
+      etdump_Event_vec_len(
+          etdump_RunData_events(etdump_RunData_vec_at(run_data_vec, 0))),
+      4);
+  free(result.buf);
+}
+
+TEST_F(ConcurrentETDumpTest, DropsEventsFromTooManyThreads) {
+  ConcurrentETDumpGen tracer(1, 16);
+  log_events(&tracer, 1);
+  std::thread other(log_events, &tracer, 1);
+  other.join();
+  // The other thread's block and event (two records) had no ring to go to.
+  EXPECT_EQ(tracer.get_num_dropped_events(), 2);
+}
+
+TEST_F(ConcurrentETDumpTest, ChainAndDebugHandleArePerThread) {
+  ConcurrentETDumpGen tracer(2, 16);
+  tracer.set_chain_debug_handle(3, 7);
+  std::thread other([&tracer]() {
+    EXPECT_EQ(tracer.get_current_chain_id(), kUnsetChainId);
+    tracer.set_chain_debug_handle(5, 9);
+    EXPECT_EQ(tracer.get_current_debug_handle(), 9);
+  });
+  other.join();
+  EXPECT_EQ(tracer.get_current_chain_id(), 3);
+  EXPECT_EQ(tracer.get_current_debug_handle(), 7);
+}
+
+} // namespace executor
+} // namespace torch
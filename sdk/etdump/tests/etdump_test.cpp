@@ -14,6 +14,19 @@
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <string>
+#include <vector>
+
+// Fake counters for the PerfCounters test: every read advances the cycle
+// count by 100 and the instruction count by 40. Cache misses are unsupported.
+static uint64_t fake_perf_counter_reads = 0;
+
+extern "C" uint32_t et_pal_read_perf_counters(uint64_t* values) {
+  ++fake_perf_counter_reads;
+  values[kPerfCounterCycles] = fake_perf_counter_reads * 100;
+  values[kPerfCounterInstructions] = fake_perf_counter_reads * 40;
+  return (1u << kPerfCounterCycles) | (1u << kPerfCounterInstructions);
+}
 
 namespace torch {
 namespace executor {
@@ -366,5 +379,542 @@ TEST_F(ProfilerETDumpTest, LogDelegateEvents) {
   free(result.buf);
 }
 
+TEST_F(ProfilerETDumpTest, SampleEveryNthBlock) {
+  ETDumpSamplingConfig config;
+  config.sample_every_n = 3;
+  ETDumpGen sampled_gen(config);
+
+  const char* block_names[] = {"b0", "b1", "b2", "b3", "b4", "b5", "b6"};
+  for (const char* name : block_names) {
+    sampled_gen.create_event_block(name);
+    EventTracerEntry entry = sampled_gen.start_profiling("test_event", 0, 1);
+    sampled_gen.end_profiling(entry);
+    sampled_gen.track_allocation(1, 64);
+  }
+  EXPECT_EQ(sampled_gen.get_num_blocks_seen(), 7);
+  EXPECT_EQ(sampled_gen.get_num_blocks(), 3);
+
+  etdump_result result = sampled_gen.get_etdump_data();
+  ASSERT_TRUE(result.buf != nullptr);
+
+  size_t size = 0;
+  void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+  etdump_ETDump_table_t etdump =
+      etdump_ETDump_as_root_with_identifier(buf, etdump_ETDump_file_identifier);
+  etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+  ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), 3);
+
+  // Blocks 0, 3 and 6 are sampled, each with both of their events.
+  const char* expected_names[] = {"b0", "b3", "b6"};
+  for (size_t i = 0; i < 3; ++i) {
+    etdump_RunData_table_t run_data = etdump_RunData_vec_at(run_data_vec, i);
+    EXPECT_STREQ(etdump_RunData_name(run_data), expected_names[i]);
+    EXPECT_EQ(etdump_Event_vec_len(etdump_RunData_events(run_data)), 2);
+  }
+
+  free(result.buf);
+}
+
+TEST_F(ProfilerETDumpTest, SampleWithProbability) {
+  ETDumpSamplingConfig config;
+  config.sample_probability = 0.0f;
+  ETDumpGen none_gen(config);
+  for (size_t i = 0; i < 16; ++i) {
+    none_gen.create_event_block("test_block");
+    EventTracerEntry entry = none_gen.start_profiling("test_event", 0, 1);
+    none_gen.end_profiling(entry);
+  }
+  EXPECT_EQ(none_gen.get_num_blocks(), 0);
+  etdump_result result = none_gen.get_etdump_data();
+  EXPECT_EQ(result.buf, nullptr);
+
+  // The same seed samples the same blocks.
+  config.sample_probability = 0.5f;
+  config.seed = 1234;
+  ETDumpGen gen_a(config);
+  ETDumpGen gen_b(config);
+  for (size_t i = 0; i < 256; ++i) {
+    gen_a.create_event_block("test_block");
+    gen_b.create_event_block("test_block");
+  }
+  EXPECT_EQ(gen_a.get_num_blocks(), gen_b.get_num_blocks());
+  EXPECT_GT(gen_a.get_num_blocks(), 64);
+  EXPECT_LT(gen_a.get_num_blocks(), 192);
+}
+
+TEST_F(ProfilerETDumpTest, RetainLastBlocks) {
+  ETDumpSamplingConfig config;
+  config.max_blocks = 2;
+  ETDumpGen ring_gen(config);
+
+  const char* block_names[] = {"b0", "b1", "b2", "b3", "b4"};
+  for (size_t i = 0; i < 5; ++i) {
+    ring_gen.create_event_block(block_names[i]);
+    AllocatorID allocator_id = ring_gen.track_allocator("test_allocator");
+    ring_gen.track_allocation(allocator_id, 64 * (i + 1));
+    EventTracerEntry entry = ring_gen.start_profiling("test_event", 0, i);
+    ring_gen.end_profiling(entry);
+  }
+  EXPECT_EQ(ring_gen.get_num_blocks(), 2);
+
+  etdump_result result = ring_gen.get_etdump_data();
+  ASSERT_TRUE(result.buf != nullptr);
+
+  size_t size = 0;
+  void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+  etdump_ETDump_table_t etdump =
+      etdump_ETDump_as_root_with_identifier(buf, etdump_ETDump_file_identifier);
+  ASSERT_NE(etdump, nullptr);
+  EXPECT_EQ(etdump_ETDump_version(etdump), ETDUMP_VERSION);
+  etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+  ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), 2);
+
+  // Only the two most recent blocks remain, oldest first.
+  for (size_t i = 0; i < 2; ++i) {
+    etdump_RunData_table_t run_data = etdump_RunData_vec_at(run_data_vec, i);
+    EXPECT_STREQ(etdump_RunData_name(run_data), block_names[3 + i]);
+
+    etdump_Allocator_vec_t allocators = etdump_RunData_allocators(run_data);
+    ASSERT_EQ(etdump_Allocator_vec_len(allocators), 1);
+    EXPECT_STREQ(
+        etdump_Allocator_name(etdump_Allocator_vec_at(allocators, 0)),
+        "test_allocator");
+
+    etdump_Event_vec_t events = etdump_RunData_events(run_data);
+    ASSERT_EQ(etdump_Event_vec_len(events), 2);
+    EXPECT_EQ(
+        etdump_AllocationEvent_allocation_size(
+            etdump_Event_allocation_event(etdump_Event_vec_at(events, 0))),
+        64 * (4 + i));
+    etdump_ProfileEvent_table_t profile_event =
+        etdump_Event_profile_event(etdump_Event_vec_at(events, 1));
+    EXPECT_STREQ(etdump_ProfileEvent_name(profile_event), "test_event");
+    EXPECT_EQ(
+        etdump_ProfileEvent_instruction_id(profile_event),
+        static_cast<int32_t>(3 + i));
+  }
+  free(result.buf);
+
+  // Recording can continue after a snapshot.
+  ring_gen.create_event_block("b5");
+  EXPECT_EQ(ring_gen.get_num_blocks(), 2);
+  result = ring_gen.get_etdump_data();
+  ASSERT_TRUE(result.buf != nullptr);
+  buf = flatbuffers_read_size_prefix(result.buf, &size);
+  etdump =
+      etdump_ETDump_as_root_with_identifier(buf, etdump_ETDump_file_identifier);
+  run_data_vec = etdump_ETDump_run_data(etdump);
+  ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), 2);
+  EXPECT_STREQ(
+      etdump_RunData_name(etdump_RunData_vec_at(run_data_vec, 0)), "b4");
+  EXPECT_STREQ(
+      etdump_RunData_name(etdump_RunData_vec_at(run_data_vec, 1)), "b5");
+  free(result.buf);
+}
+
+TEST_F(ProfilerETDumpTest, FixedBuffer) {
+  alignas(16) static uint8_t builder_pool[16 * 1024];
+  alignas(16) static uint8_t output[4 * 1024];
+  MemoryAllocator builder_memory(sizeof(builder_pool), builder_pool);
+  ETDumpGen fixed_gen({output, sizeof(output)}, &builder_memory);
+
+  fixed_gen.create_event_block("test_block");
+  fixed_gen.track_allocator("test_allocator");
+  fixed_gen.track_allocation(1, 64);
+  EventTracerEntry entry = fixed_gen.start_profiling("test_event", 0, 1);
+  fixed_gen.end_profiling(entry);
+  fixed_gen.create_event_block("test_block_1");
+  entry = fixed_gen.start_profiling("test_event_1", 0, 2);
+  fixed_gen.end_profiling(entry);
+  EXPECT_EQ(fixed_gen.get_num_dropped_events(), 0);
+
+  etdump_result result = fixed_gen.get_etdump_data();
+  ASSERT_TRUE(result.buf != nullptr);
+  // The ETDump is built in place.
+  EXPECT_GE(static_cast<uint8_t*>(result.buf), output);
+  EXPECT_LE(static_cast<uint8_t*>(result.buf) + result.size, output + 4096);
+
+  size_t size = 0;
+  void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+  etdump_ETDump_table_t etdump =
+      etdump_ETDump_as_root_with_identifier(buf, etdump_ETDump_file_identifier);
+  ASSERT_NE(etdump, nullptr);
+  EXPECT_EQ(etdump_ETDump_version(etdump), ETDUMP_VERSION);
+  etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+  ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), 2);
+
+  etdump_RunData_table_t run_data_0 = etdump_RunData_vec_at(run_data_vec, 0);
+  EXPECT_STREQ(etdump_RunData_name(run_data_0), "test_block");
+  EXPECT_EQ(etdump_Allocator_vec_len(etdump_RunData_allocators(run_data_0)), 1);
+  etdump_Event_vec_t events = etdump_RunData_events(run_data_0);
+  ASSERT_EQ(etdump_Event_vec_len(events), 2);
+  EXPECT_STREQ(
+      etdump_ProfileEvent_name(
+          etdump_Event_profile_event(etdump_Event_vec_at(events, 1))),
+      "test_event");
+
+  etdump_RunData_table_t run_data_1 = etdump_RunData_vec_at(run_data_vec, 1);
+  EXPECT_STREQ(etdump_RunData_name(run_data_1), "test_block_1");
+  EXPECT_EQ(etdump_Event_vec_len(etdump_RunData_events(run_data_1)), 1);
+  // Don't free the result; it lives in `output`.
+}
+
+TEST_F(ProfilerETDumpTest, FixedBufferDropsEventsThatDontFit) {
+  alignas(16) static uint8_t builder_pool[16 * 1024];
+  alignas(16) static uint8_t output[1024];
+  MemoryAllocator builder_memory(sizeof(builder_pool), builder_pool);
+  ETDumpGen fixed_gen({output, sizeof(output)}, &builder_memory);
+
+  fixed_gen.create_event_block("test_block");
+  for (size_t i = 0; i < 64; ++i) {
+    EventTracerEntry entry = fixed_gen.start_profiling("test_event", 0, i);
+    fixed_gen.end_profiling(entry);
+  }
+  EXPECT_GT(fixed_gen.get_num_dropped_events(), 0);
+
+  // What was recorded before the buffer filled up is still a valid ETDump.
+  etdump_result result = fixed_gen.get_etdump_data();
+  ASSERT_TRUE(result.buf != nullptr);
+  size_t size = 0;
+  void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+  etdump_ETDump_table_t etdump =
+      etdump_ETDump_as_root_with_identifier(buf, etdump_ETDump_file_identifier);
+  ASSERT_NE(etdump, nullptr);
+  etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+  ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), 1);
+  size_t num_events = etdump_Event_vec_len(
+      etdump_RunData_events(etdump_RunData_vec_at(run_data_vec, 0)));
+  EXPECT_GT(num_events, 0);
+  EXPECT_LT(num_events, 64);
+
+  // The abort policy fails instead.
+  alignas(16) static uint8_t abort_pool[16 * 1024];
+  alignas(16) static uint8_t small_output[256];
+  MemoryAllocator abort_memory(sizeof(abort_pool), abort_pool);
+  ETDumpGen abort_gen(
+      {small_output, sizeof(small_output)},
+      &abort_memory,
+      ETDumpOverflowPolicy::kAbort);
+  abort_gen.create_event_block("test_block");
+  ET_EXPECT_DEATH(
+      {
+        for (size_t i = 0; i < 64; ++i) {
+          EventTracerEntry entry =
+              abort_gen.start_profiling("test_event", 0, i);
+          abort_gen.end_profiling(entry);
+        }
+      },
+      "");
+}
+
+TEST_F(ProfilerETDumpTest, PerfCounters) {
+  etdump_gen->create_event_block("test_block");
+  // Disabled by default.
+  EventTracerEntry entry = etdump_gen->start_profiling("no_counters", 0, 0);
+  etdump_gen->end_profiling(entry);
+
+  etdump_gen->set_perf_counters_enabled(true);
+  fake_perf_counter_reads = 0;
+  EventTracerEntry outer = etdump_gen->start_profiling("outer", 0, 1);
+  EventTracerEntry inner = etdump_gen->start_profiling("inner", 0, 2);
+  etdump_gen->end_profiling(inner);
+  etdump_gen->end_profiling(outer);
+  EventTracerEntry delegate =
+      etdump_gen->start_profiling_delegate(nullptr, 3);
+  etdump_gen->end_profiling_delegate(delegate, nullptr);
+
+  etdump_result result = etdump_gen->get_etdump_data();
+  ASSERT_TRUE(result.buf != nullptr);
+  size_t size = 0;
+  void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+  etdump_ETDump_table_t etdump =
+      etdump_ETDump_as_root_with_identifier(buf, etdump_ETDump_file_identifier);
+  etdump_Event_vec_t events = etdump_RunData_events(
+      etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+  ASSERT_EQ(etdump_Event_vec_len(events), 4);
+
+  auto counters_at = [&](size_t i) {
+    return etdump_ProfileEvent_perf_counters(
+        etdump_Event_profile_event(etdump_Event_vec_at(events, i)));
+  };
+  EXPECT_EQ(counters_at(0), nullptr);
+
+  // Each event gets the counters read between its own start and end.
+  etdump_PerfCounters_table_t inner_counters = counters_at(1);
+  ASSERT_NE(inner_counters, nullptr);
+  EXPECT_EQ(etdump_PerfCounters_cycles(inner_counters), 100);
+  EXPECT_EQ(etdump_PerfCounters_instructions(inner_counters), 40);
+  // Unsupported counters are left at their default.
+  EXPECT_EQ(etdump_PerfCounters_l1d_read_misses(inner_counters), -1);
+  EXPECT_EQ(etdump_PerfCounters_llc_read_misses(inner_counters), -1);
+
+  etdump_PerfCounters_table_t outer_counters = counters_at(2);
+  ASSERT_NE(outer_counters, nullptr);
+  EXPECT_EQ(etdump_PerfCounters_cycles(outer_counters), 300);
+  EXPECT_EQ(etdump_PerfCounters_instructions(outer_counters), 120);
+
+  etdump_PerfCounters_table_t delegate_counters = counters_at(3);
+  ASSERT_NE(delegate_counters, nullptr);
+  EXPECT_EQ(etdump_PerfCounters_cycles(delegate_counters), 100);
+
+  free(result.buf);
+}
+
+namespace {
+
+struct FlushedBuffers {
+  size_t num_flushes = 0;
+  // Names of the blocks in every flushed ETDump, in order.
+  std::vector<std::string> block_names;
+};
+
+void record_flush(void* context, const void* data, size_t size) {
+  auto* flushed = static_cast<FlushedBuffers*>(context);
+  ++flushed->num_flushes;
+  size_t prefix_size = 0;
+  const void* buf =
+      flatbuffers_read_size_prefix(const_cast<void*>(data), &prefix_size);
+  EXPECT_EQ(prefix_size + sizeof(flatbuffers_uoffset_t), size);
+  etdump_ETDump_table_t etdump =
+      etdump_ETDump_as_root_with_identifier(buf, etdump_ETDump_file_identifier);
+  ASSERT_NE(etdump, nullptr);
+  etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+  for (size_t i = 0; i < etdump_RunData_vec_len(run_data_vec); ++i) {
+    etdump_RunData_table_t run_data = etdump_RunData_vec_at(run_data_vec, i);
+    EXPECT_EQ(etdump_Event_vec_len(etdump_RunData_events(run_data)), 1);
+    flushed->block_names.emplace_back(etdump_RunData_name(run_data));
+  }
+}
+
+void record_block(ETDumpGen& gen, const char* name) {
+  gen.create_event_block(name);
+  EventTracerEntry entry = gen.start_profiling("test_event", 0, 1);
+  gen.end_profiling(entry);
+}
+
+} // namespace
+
+TEST_F(ProfilerETDumpTest, InstructionMemory) {
+  const TensorMemoryAccess accesses[] = {
+      {1, 256, 64, /*is_write=*/true},
+      {1, 0, 128, /*is_write=*/false},
+      {kUnplannedMemoryId, 0, 32, /*is_write=*/false},
+  };
+
+  // Check both a block emitted directly and one copied out of a retained
+  // block.
+  ETDumpSamplingConfig config;
+  config.max_blocks = 1;
+  ETDumpGen ring_gen(config);
+  for (ETDumpGen* gen : {etdump_gen, &ring_gen}) {
+    gen->create_event_block("test_block");
+    gen->log_instruction_memory(0, 3, 160, 64, accesses, 3);
+    gen->log_instruction_memory(0, 4, 0, 0, nullptr, 0);
+
+    etdump_result result = gen->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    ASSERT_NE(etdump, nullptr);
+    etdump_Event_vec_t events = etdump_RunData_events(
+        etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+    ASSERT_EQ(etdump_Event_vec_len(events), 2);
+
+    etdump_MemoryEvent_table_t event =
+        etdump_Event_memory_event(etdump_Event_vec_at(events, 0));
+    ASSERT_NE(event, nullptr);
+    EXPECT_EQ(etdump_MemoryEvent_chain_id(event), 0);
+    EXPECT_EQ(etdump_MemoryEvent_instruction_id(event), 3);
+    EXPECT_EQ(etdump_MemoryEvent_bytes_read(event), 160);
+    EXPECT_EQ(etdump_MemoryEvent_bytes_written(event), 64);
+    etdump_TensorMemoryAccess_vec_t tensors = etdump_MemoryEvent_tensors(event);
+    ASSERT_EQ(etdump_TensorMemoryAccess_vec_len(tensors), 3);
+    for (size_t i = 0; i < 3; ++i) {
+      etdump_TensorMemoryAccess_table_t tensor =
+          etdump_TensorMemoryAccess_vec_at(tensors, i);
+      EXPECT_EQ(
+          etdump_TensorMemoryAccess_memory_id(tensor), accesses[i].memory_id);
+      EXPECT_EQ(
+          etdump_TensorMemoryAccess_memory_offset(tensor),
+          accesses[i].memory_offset);
+      EXPECT_EQ(etdump_TensorMemoryAccess_size(tensor), accesses[i].nbytes);
+      EXPECT_EQ(
+          etdump_TensorMemoryAccess_is_write(tensor), accesses[i].is_write);
+    }
+
+    event = etdump_Event_memory_event(etdump_Event_vec_at(events, 1));
+    ASSERT_NE(event, nullptr);
+    EXPECT_EQ(etdump_MemoryEvent_instruction_id(event), 4);
+    EXPECT_EQ(
+        etdump_TensorMemoryAccess_vec_len(etdump_MemoryEvent_tensors(event)),
+        0);
+    free(result.buf);
+  }
+}
+
+TEST_F(ProfilerETDumpTest, LoadEvents) {
+  // Check both a block emitted directly and one copied out of a retained
+  // block.
+  ETDumpSamplingConfig config;
+  config.max_blocks = 1;
+  ETDumpGen ring_gen(config);
+  for (ETDumpGen* gen : {etdump_gen, &ring_gen}) {
+    gen->create_event_block("Program::load");
+    gen->log_load_event({"Program::load_data", -1, 10, 20, 4096, 0});
+    gen->log_load_event({"XnnpackBackend", 2, 30, 50, 1024, 512});
+
+    etdump_result result = gen->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    ASSERT_NE(etdump, nullptr);
+    etdump_Event_vec_t events = etdump_RunData_events(
+        etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+    ASSERT_EQ(etdump_Event_vec_len(events), 2);
+
+    etdump_LoadEvent_table_t event =
+        etdump_Event_load_event(etdump_Event_vec_at(events, 0));
+    ASSERT_NE(event, nullptr);
+    EXPECT_STREQ(etdump_LoadEvent_name(event), "Program::load_data");
+    EXPECT_EQ(etdump_LoadEvent_delegate_index(event), -1);
+    EXPECT_EQ(etdump_LoadEvent_start_time(event), 10);
+    EXPECT_EQ(etdump_LoadEvent_end_time(event), 20);
+    EXPECT_EQ(etdump_LoadEvent_bytes_loaded(event), 4096);
+    EXPECT_EQ(etdump_LoadEvent_bytes_allocated(event), 0);
+
+    event = etdump_Event_load_event(etdump_Event_vec_at(events, 1));
+    ASSERT_NE(event, nullptr);
+    EXPECT_STREQ(etdump_LoadEvent_name(event), "XnnpackBackend");
+    EXPECT_EQ(etdump_LoadEvent_delegate_index(event), 2);
+    EXPECT_EQ(etdump_LoadEvent_bytes_loaded(event), 1024);
+    EXPECT_EQ(etdump_LoadEvent_bytes_allocated(event), 512);
+    free(result.buf);
+  }
+}
+
+TEST_F(ProfilerETDumpTest, IntermediateOutputs) {
+  const float data[6] = {1.f, -2.f, 3.f, 4.f, 5.f, 6.f};
+  IntermediateOutput stats_only = {};
+  stats_only.output_index = 0;
+  stats_only.scalar_type = executorch_flatbuffer_ScalarType_FLOAT;
+  stats_only.dim = 2;
+  stats_only.sizes[0] = 2;
+  stats_only.sizes[1] = 3;
+  stats_only.stats = {6, -2.0, 6.0, 17.0 / 6, 0, 0x1234};
+  IntermediateOutput full = stats_only;
+  full.output_index = 1;
+  full.data = data;
+  full.nbytes = sizeof(data);
+
+  // Check both a block emitted directly and one copied out of a retained
+  // block.
+  ETDumpSamplingConfig config;
+  config.max_blocks = 1;
+  ETDumpGen ring_gen(config);
+  for (ETDumpGen* gen : {etdump_gen, &ring_gen}) {
+    gen->create_event_block("test_block");
+    gen->log_intermediate_output(0, 3, stats_only);
+    gen->log_intermediate_output(0, 3, full);
+
+    etdump_result result = gen->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    ASSERT_NE(etdump, nullptr);
+    etdump_Event_vec_t events = etdump_RunData_events(
+        etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+    ASSERT_EQ(etdump_Event_vec_len(events), 2);
+
+    for (size_t i = 0; i < 2; ++i) {
+      etdump_OutputEvent_table_t event =
+          etdump_Event_output_event(etdump_Event_vec_at(events, i));
+      ASSERT_NE(event, nullptr);
+      EXPECT_EQ(etdump_OutputEvent_chain_id(event), 0);
+      EXPECT_EQ(etdump_OutputEvent_instruction_id(event), 3);
+      EXPECT_EQ(etdump_OutputEvent_output_index(event), i);
+
+      etdump_TensorStats_table_t stats = etdump_OutputEvent_stats(event);
+      ASSERT_NE(stats, nullptr);
+      EXPECT_EQ(etdump_TensorStats_numel(stats), 6);
+      EXPECT_EQ(etdump_TensorStats_min(stats), -2.0);
+      EXPECT_EQ(etdump_TensorStats_max(stats), 6.0);
+      EXPECT_EQ(etdump_TensorStats_mean(stats), 17.0 / 6);
+      EXPECT_EQ(etdump_TensorStats_nan_count(stats), 0);
+      EXPECT_EQ(etdump_TensorStats_hash(stats), 0x1234);
+
+      etdump_Tensor_table_t tensor = etdump_OutputEvent_tensor(event);
+      ASSERT_NE(tensor, nullptr);
+      EXPECT_EQ(
+          etdump_Tensor_scalar_type(tensor),
+          executorch_flatbuffer_ScalarType_FLOAT);
+      flatbuffers_int32_vec_t sizes = etdump_Tensor_sizes(tensor);
+      ASSERT_EQ(flatbuffers_int32_vec_len(sizes), 2);
+      EXPECT_EQ(flatbuffers_int32_vec_at(sizes, 0), 2);
+      EXPECT_EQ(flatbuffers_int32_vec_at(sizes, 1), 3);
+    }
+
+    // Only the output that was asked for in full carries its data.
+    EXPECT_EQ(
+        etdump_Tensor_data(etdump_OutputEvent_tensor(
+            etdump_Event_output_event(etdump_Event_vec_at(events, 0)))),
+        nullptr);
+    flatbuffers_uint8_vec_t logged =
+        etdump_Tensor_data(etdump_OutputEvent_tensor(
+            etdump_Event_output_event(etdump_Event_vec_at(events, 1))));
+    ASSERT_EQ(flatbuffers_uint8_vec_len(logged), sizeof(data));
+    EXPECT_EQ(memcmp(logged, data, sizeof(data)), 0);
+    free(result.buf);
+  }
+}
+
+TEST_F(ProfilerETDumpTest, FlushEveryNBlocks) {
+  FlushedBuffers flushed;
+  etdump_gen->set_flush_sink(record_flush, &flushed, 2);
+
+  const char* block_names[] = {"b0", "b1", "b2", "b3", "b4"};
+  for (const char* name : block_names) {
+    record_block(*etdump_gen, name);
+  }
+  // b0 + b1 and b2 + b3 were flushed when b2 and b4 started.
+  EXPECT_EQ(flushed.num_flushes, 2);
+  EXPECT_EQ(etdump_gen->get_num_flushed_blocks(), 4);
+  EXPECT_EQ(etdump_gen->get_num_blocks(), 1);
+
+  etdump_gen->flush();
+  EXPECT_EQ(flushed.num_flushes, 3);
+  // Nothing left to flush.
+  etdump_gen->flush();
+  EXPECT_EQ(flushed.num_flushes, 3);
+
+  ASSERT_EQ(flushed.block_names.size(), 5);
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(flushed.block_names[i], block_names[i]);
+  }
+}
+
+TEST_F(ProfilerETDumpTest, FlushFixedBuffer) {
+  alignas(16) static uint8_t builder_pool[16 * 1024];
+  alignas(16) static uint8_t output[1024];
+  MemoryAllocator builder_memory(sizeof(builder_pool), builder_pool);
+  ETDumpGen fixed_gen({output, sizeof(output)}, &builder_memory);
+  FlushedBuffers flushed;
+  fixed_gen.set_flush_sink(record_flush, &flushed, 1);
+
+  // Many more blocks than fit in the buffer at once.
+  for (size_t i = 0; i < 100; ++i) {
+    record_block(fixed_gen, "test_block");
+  }
+  fixed_gen.flush();
+  EXPECT_EQ(flushed.num_flushes, 100);
+  EXPECT_EQ(flushed.block_names.size(), 100);
+  EXPECT_EQ(fixed_gen.get_num_dropped_events(), 0);
+}
+
 } // namespace executor
 } // namespace torch
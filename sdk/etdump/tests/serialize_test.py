@@ -95,6 +95,8 @@ def get_sample_etdump_flatcc() -> flatcc.ETDumpFlatCC:
                 ],
             )
         ],
+        ticks_to_ns_numerator=125,
+        ticks_to_ns_denominator=3,
     )
 
 
@@ -18,3 +18,15 @@ def define_common_targets():
             "//executorch/runtime/platform:platform",
         ],
     )
+
+    runtime.cxx_test(
+        name = "etdump_concurrent_test",
+        srcs = [
+            "etdump_concurrent_test.cpp",
+        ],
+        deps = [
+            "//executorch/sdk/etdump:etdump_concurrent",
+            "//executorch/sdk/etdump:etdump_schema_flatcc",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
@@ -4,14 +4,22 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
-from typing import Dict, Mapping, Optional
+from typing import Dict, List, Mapping, Optional, Sequence, Tuple
+
+import numpy as np
+import torch
 
 from executorch.sdk.debug_format.base_schema import OperatorNode
 
 from executorch.sdk.debug_format.et_schema import FXOperatorGraph, OperatorGraph
-from executorch.sdk.etdump.schema_flatcc import ETDumpFlatCC
+from executorch.sdk.etdump.schema_flatcc import (
+    ETDumpFlatCC,
+    MemoryEvent,
+    OutputEvent,
+    PROFILE_EVENT_ENUM,
+)
 
-from executorch.sdk.etdump.serialize import deserialize_from_etdump_flatcc
+from executorch.sdk.etdump.serialize import deserialize_from_etdump_flatcc_stream
 from executorch.sdk.etrecord import ETRecord
 
 EDGE_DIALECT_GRAPH_KEY = "edge_dialect_graph_module"
@@ -61,10 +69,353 @@ def create_debug_handle_to_op_node_mapping(
                 debug_handle_to_op_node_map[debug_handle] = element
 
 
-def gen_etdump_object(etdump_path: Optional[str] = None) -> ETDumpFlatCC:
-    # Gen event blocks from etdump
+def compute_arena_occupancy(
+    memory_events: List[MemoryEvent],
+) -> List[Tuple[Dict[int, int], Dict[int, int]]]:
+    """
+    Given the memory events of an execution, in order, computes for each of them the
+    occupancy of the memory planned arenas, keyed by memory id: the total size of the
+    live tensors, and the end offset of the highest live tensor.
+
+    Memory planning reuses the same region for tensors with disjoint lifetimes, and each
+    tensor is written once by the instruction that produces it, so a write to a region
+    starts a new lifetime there. A lifetime lasts until the last access to the region
+    before it is written again. Tensors that memory planning did not place are skipped.
+    """
+    # (memory_id, memory_offset, size) -> index of the open lifetime in `lifetimes`
+    open_lifetimes: Dict[Tuple[int, int, int], int] = {}
+    # [key, first access, last access]
+    lifetimes: List[List] = []
+    for index, event in enumerate(memory_events):
+        for tensor in event.tensors or []:
+            if tensor.memory_id < 0:
+                continue
+            key = (tensor.memory_id, tensor.memory_offset, tensor.size)
+            if tensor.is_write or key not in open_lifetimes:
+                open_lifetimes[key] = len(lifetimes)
+                lifetimes.append([key, index, index])
+            else:
+                lifetimes[open_lifetimes[key]][2] = index
+
+    occupancy: List[Tuple[Dict[int, int], Dict[int, int]]] = [
+        ({}, {}) for _ in memory_events
+    ]
+    for (memory_id, memory_offset, size), first, last in lifetimes:
+        for live_bytes, live_extent in occupancy[first : last + 1]:
+            live_bytes[memory_id] = live_bytes.get(memory_id, 0) + size
+            live_extent[memory_id] = max(
+                live_extent.get(memory_id, 0), memory_offset + size
+            )
+    return occupancy
+
+
+def find_first_output_mismatch(
+    reference: List[OutputEvent],
+    outputs: List[OutputEvent],
+    tolerance: Optional[float] = None,
+) -> Optional[Tuple[Optional[OutputEvent], Optional[OutputEvent]]]:
+    """
+    Given the output events of two executions of the same method, in order, returns
+    the first pair of outputs that differ, or None if they all match. If one
+    execution logged fewer outputs, the missing side of the pair is None.
+
+    Without a tolerance, outputs match if their contents hash the same, which is
+    exact down to the bit. With a tolerance, outputs match if they have the same
+    number of elements and NaNs, and their min, max and mean are within
+    `tolerance`, relative to the magnitude of the reference values.
+    """
+
+    def close(expected: float, actual: float, tolerance: float) -> bool:
+        return abs(expected - actual) <= tolerance * max(1.0, abs(expected))
+
+    def matches(expected: OutputEvent, actual: OutputEvent) -> bool:
+        if (expected.instruction_id, expected.output_index) != (
+            actual.instruction_id,
+            actual.output_index,
+        ):
+            return False
+        if expected.stats is None or actual.stats is None:
+            return expected.stats is actual.stats
+        if tolerance is None:
+            return expected.stats.hash == actual.stats.hash
+        return (
+            expected.stats.numel == actual.stats.numel
+            and expected.stats.nan_count == actual.stats.nan_count
+            and close(expected.stats.min, actual.stats.min, tolerance)
+            and close(expected.stats.max, actual.stats.max, tolerance)
+            and close(expected.stats.mean, actual.stats.mean, tolerance)
+        )
+
+    for index in range(max(len(reference), len(outputs))):
+        expected = reference[index] if index < len(reference) else None
+        actual = outputs[index] if index < len(outputs) else None
+        if expected is None or actual is None or not matches(expected, actual):
+            return (expected, actual)
+    return None
+
+
+# Ops that perform one floating point operation per output element
+ELEMENTWISE_OPS = {
+    "abs",
+    "add",
+    "clamp",
+    "div",
+    "exp",
+    "gelu",
+    "hardsigmoid",
+    "hardswish",
+    "hardtanh",
+    "leaky_relu",
+    "log",
+    "maximum",
+    "minimum",
+    "mul",
+    "neg",
+    "pow",
+    "relu",
+    "rsqrt",
+    "sigmoid",
+    "sqrt",
+    "sub",
+    "tanh",
+    "where",
+}
+
+# Ops that perform one floating point operation per input element
+REDUCTION_OPS = {"amax", "amin", "mean", "sum"}
+
+
+def _flatten_tensors(value) -> List[torch.Tensor]:
+    if isinstance(value, torch.Tensor):
+        return [value]
+    if isinstance(value, (list, tuple)):
+        return [t for v in value for t in _flatten_tensors(v)]
+    return []
+
+
+def _op_base_name(target) -> str:
+    # e.g. "aten.convolution.default" or "convolution.default" -> "convolution"
+    parts = getattr(target, "__name__", str(target)).split(".")
+    return parts[1] if parts[0] == "aten" and len(parts) > 1 else parts[0]
+
+
+def _compute_op_flops(node: torch.fx.Node) -> Optional[int]:
+    outputs = _flatten_tensors(node.meta.get("val"))
+    if not outputs:
+        return None
+    inputs = [
+        arg.meta.get("val") if isinstance(arg, torch.fx.Node) else arg
+        for arg in node.args
+    ]
+    name = _op_base_name(node.target)
+    out_numel = outputs[0].numel()
+    if name in ("mm", "bmm", "linear") and isinstance(inputs[0], torch.Tensor):
+        return 2 * out_numel * inputs[0].shape[-1]
+    if name == "addmm" and isinstance(inputs[1], torch.Tensor):
+        # addmm(bias, a, b) also adds the bias to each output element
+        return 2 * out_numel * inputs[1].shape[-1] + out_numel
+    if name == "convolution" and isinstance(inputs[1], torch.Tensor):
+        # weight is [out_c, in_c / groups, *kernel], or [in_c, out_c / groups, *kernel]
+        # if transposed, in which case each input element is scattered to the output
+        weight = inputs[1]
+        macs_per_element = weight.numel() // weight.shape[0]
+        transposed = len(inputs) > 6 and inputs[6]
+        if transposed and isinstance(inputs[0], torch.Tensor):
+            return 2 * inputs[0].numel() * macs_per_element
+        return 2 * out_numel * macs_per_element
+    if name in ELEMENTWISE_OPS:
+        return out_numel
+    if name in REDUCTION_OPS and isinstance(inputs[0], torch.Tensor):
+        return inputs[0].numel()
+    return None
+
+
+def compute_op_costs(
+    graph_module: torch.fx.GraphModule,
+) -> Dict[int, Tuple[Optional[int], int]]:
+    """
+    Given the graph of a program with tensor metadata, such as the Edge Dialect
+    graph of an ETRecord, estimates the work of each operator, keyed by debug
+    handle: the floating point operations it performs, or None if the op is not
+    modelled, and the bytes of tensor data it reads and writes.
+
+    Bytes assume that every input and output is moved once, which is the minimum
+    traffic of the op; achieved bandwidth computed from it is a lower bound.
+    """
+    op_costs: Dict[int, Tuple[Optional[int], int]] = {}
+    for node in graph_module.graph.nodes:
+        if node.op != "call_function":
+            continue
+        if (debug_handle := node.meta.get("debug_handle")) is None:
+            continue
+        tensors = _flatten_tensors(node.meta.get("val"))
+        for arg in node.args:
+            # Ops like cat take a list of tensors
+            for value in arg if isinstance(arg, (list, tuple)) else [arg]:
+                if isinstance(value, torch.fx.Node):
+                    tensors += _flatten_tensors(value.meta.get("val"))
+        bytes_moved = sum(t.numel() * t.element_size() for t in tensors)
+        op_costs[debug_handle] = (_compute_op_flops(node), bytes_moved)
+    return op_costs
+
+
+def bootstrap_mean_difference_ci(
+    base: Sequence[float],
+    new: Sequence[float],
+    confidence: float = 0.95,
+    num_resamples: int = 1000,
+    seed: int = 0,
+) -> Tuple[float, float]:
+    """
+    Given two sets of latency samples, returns a confidence interval for the
+    difference of their means (new - base), using a percentile bootstrap.
+
+    Latencies are usually skewed and have few samples, so resampling makes no
+    assumption about their distribution. The interval is deterministic for a
+    given seed. With a single sample on either side there is no spread to
+    resample, and the interval collapses to the observed difference.
+    """
+    if not 0 < confidence < 1:
+        raise ValueError(f"confidence must be in (0, 1), got {confidence}")
+    rng = np.random.default_rng(seed)
+    base_array = np.asarray(base, dtype=np.float64)
+    new_array = np.asarray(new, dtype=np.float64)
+    base_means = rng.choice(
+        base_array, size=(num_resamples, len(base_array))
+    ).mean(axis=1)
+    new_means = rng.choice(new_array, size=(num_resamples, len(new_array))).mean(
+        axis=1
+    )
+    alpha = (1 - confidence) / 2
+    low, high = np.quantile(new_means - base_means, [alpha, 1 - alpha])
+    return float(low), float(high)
+
+
+def etdump_ticks_per_ns(etdump: ETDumpFlatCC) -> Optional[float]:
+    """
+    Returns the number of ticks per nanosecond of the timestamps in the ETDump, or
+    None if the ETDump does not record the duration of its ticks.
+    """
+    if etdump.ticks_to_ns_numerator == 0 or etdump.ticks_to_ns_denominator == 0:
+        return None
+    return etdump.ticks_to_ns_denominator / etdump.ticks_to_ns_numerator
+
+
+def gen_chrome_trace_events(
+    etdump: ETDumpFlatCC, ticks_per_us: float = 1000.0
+) -> List[Dict]:
+    """
+    Given an ETDump, lays out every profiled event of every run on a timeline, in the
+    Chrome Trace Event format that chrome://tracing and Perfetto load. Each thread that
+    logged runs gets its own track, and the spans of the chains that ran are added
+    around their instructions, so that the nesting reads method > chain > operator or
+    delegate call > delegate-internal event.
+
+    Timestamps are converted to microseconds by dividing by ticks_per_us, e.g. 1000
+    for ETDumps timed in nanoseconds.
+    """
+    framework_names = {
+        PROFILE_EVENT_ENUM.RUN_MODEL.value,
+        PROFILE_EVENT_ENUM.LOAD_MODEL.value,
+    }
+    trace_events: List[Dict] = []
+    thread_ids = set()
+
+    def complete_event(name, category, start, end, thread_id, args) -> Dict:
+        return {
+            "name": name,
+            "cat": category,
+            "ph": "X",
+            "ts": start / ticks_per_us,
+            "dur": (end - start) / ticks_per_us,
+            "pid": 0,
+            "tid": thread_id,
+            "args": args,
+        }
+
+    for run_index, run in enumerate(etdump.run_data):
+        thread_ids.add(run.thread_id)
+        # chain id -> [start, end] of the instructions of the chain
+        chain_spans: Dict[int, List[int]] = {}
+        for event in run.events or []:
+            if (profile_event := event.profile_event) is None:
+                continue
+            args = {"run": run_index, "block": run.name}
+            if profile_event.instruction_id != -1:
+                args["chain_id"] = profile_event.chain_id
+                args["instruction_id"] = profile_event.instruction_id
+            name = profile_event.name or ""
+            if (
+                profile_event.delegate_debug_id_int is not None
+                and profile_event.delegate_debug_id_int != -1
+            ) or profile_event.delegate_debug_id_str:
+                category = "delegate"
+                delegate_id = (
+                    profile_event.delegate_debug_id_str
+                    or profile_event.delegate_debug_id_int
+                )
+                name = name or str(delegate_id)
+                args["delegate_debug_identifier"] = delegate_id
+                if profile_event.delegate_debug_metadata:
+                    args["delegate_debug_metadata"] = (
+                        profile_event.delegate_debug_metadata
+                    )
+            elif name in framework_names:
+                category = "framework"
+            elif name == PROFILE_EVENT_ENUM.DELEGATE_CALL.value:
+                category = "delegate_call"
+            else:
+                category = "operator"
+            if category != "framework" and profile_event.instruction_id != -1:
+                span = chain_spans.setdefault(
+                    profile_event.chain_id,
+                    [profile_event.start_time, profile_event.end_time],
+                )
+                span[0] = min(span[0], profile_event.start_time)
+                span[1] = max(span[1], profile_event.end_time)
+            trace_events.append(
+                complete_event(
+                    name,
+                    category,
+                    profile_event.start_time,
+                    profile_event.end_time,
+                    run.thread_id,
+                    args,
+                )
+            )
+        for chain_id, (start, end) in chain_spans.items():
+            trace_events.append(
+                complete_event(
+                    f"chain {chain_id}",
+                    "chain",
+                    start,
+                    end,
+                    run.thread_id,
+                    {"run": run_index, "block": run.name, "chain_id": chain_id},
+                )
+            )
+
+    for thread_id in sorted(thread_ids):
+        trace_events.append(
+            {
+                "name": "thread_name",
+                "ph": "M",
+                "pid": 0,
+                "tid": thread_id,
+                "args": {"name": f"thread {thread_id}"},
+            }
+        )
+    return trace_events
+
+
+def gen_etdump_object(
+    etdump_path: Optional[str] = None, etdump_data: Optional[bytes] = None
+) -> ETDumpFlatCC:
+    # Gen event blocks from etdump, either in memory or in a file
+    if etdump_data is not None:
+        return deserialize_from_etdump_flatcc_stream(etdump_data)
     if etdump_path is None:
-        raise ValueError("Etdump_path must be specified.")
+        raise ValueError("Either etdump_path or etdump_data must be specified.")
     with open(etdump_path, "rb") as buff:
-        etdump = deserialize_from_etdump_flatcc(buff.read())
+        etdump = deserialize_from_etdump_flatcc_stream(buff.read())
         return etdump
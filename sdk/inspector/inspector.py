@@ -5,6 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 import dataclasses
+import json
 import logging
 from collections import defaultdict, OrderedDict
 from dataclasses import dataclass
@@ -27,11 +28,24 @@ import torch
 from executorch.exir import ExportedProgram
 
 from executorch.sdk.debug_format.et_schema import OperatorNode
-from executorch.sdk.etdump.schema_flatcc import ETDumpFlatCC, ProfileEvent
+from executorch.sdk.etdump.schema_flatcc import (
+    ETDumpFlatCC,
+    LoadEvent,
+    MemoryEvent,
+    OutputEvent,
+    PerfCounters,
+    ProfileEvent,
+)
 from executorch.sdk.etrecord import parse_etrecord
 from executorch.sdk.inspector._inspector_utils import (
+    bootstrap_mean_difference_ci,
+    compute_arena_occupancy,
+    compute_op_costs,
     create_debug_handle_to_op_node_mapping,
     EDGE_DIALECT_GRAPH_KEY,
+    etdump_ticks_per_ns,
+    find_first_output_mismatch,
+    gen_chrome_trace_events,
     gen_etdump_object,
     gen_graphs_from_etrecord,
 )
@@ -50,6 +64,8 @@ EXCLUDED_COLUMNS_WHEN_PRINTING = [
     "stack_traces",
     "module_hierarchy",
     "debug_data",
+    "flops",
+    "bytes_moved",
 ]
 EXCLUDED_EVENTS_WHEN_PRINTING = {"OPERATOR_CALL"}
 
@@ -156,6 +172,9 @@ class Event:
         is_delegated_op: Whether or not the event was delegated.
         delegate_backend_name: Name of the backend this event was delegated to.
         debug_data: Intermediate data collected during runtime.
+        perf_counters: Hardware performance counters of the event, keyed by counter name (cycles, instructions, l1d_read_misses, llc_read_misses). Only counters that the runtime captured for every instance of the event are present.
+        flops: Floating point operations performed by the ops of the event, estimated from the shapes in `ETRecord`. None if any of its ops is not modelled.
+        bytes_moved: Bytes of tensor data read and written by the ops of the event, estimated from the shapes and dtypes in `ETRecord`.
     """
 
     name: str
@@ -168,6 +187,9 @@ class Event:
     is_delegated_op: Optional[bool] = None
     delegate_backend_name: Optional[str] = None
     debug_data: List[torch.Tensor] = dataclasses.field(default_factory=list)
+    perf_counters: Dict[str, PerfData] = dataclasses.field(default_factory=dict)
+    flops: Optional[int] = None
+    bytes_moved: Optional[int] = None
 
     _instruction_id: Optional[int] = None
 
@@ -204,9 +226,25 @@ class Event:
             perf_data=perf_data,
             delegate_debug_identifier=delegate_debug_identifier,
             is_delegated_op=is_delegated_op,
+            perf_counters=Event._gen_perf_counters(events),
             _instruction_id=signature.instruction_id,
         )
 
+    @staticmethod
+    def _gen_perf_counters(events: List[ProfileEvent]) -> Dict[str, PerfData]:
+        """
+        Helper function to collect the hardware performance counters of a list of
+        ProfileEvents, skipping counters that are missing (-1) from any of them
+        """
+        perf_counters: Dict[str, PerfData] = {}
+        if any(event.perf_counters is None for event in events):
+            return perf_counters
+        for field in dataclasses.fields(PerfCounters):
+            values = [getattr(event.perf_counters, field.name) for event in events]
+            if all(value != -1 for value in values):
+                perf_counters[field.name] = PerfData([float(v) for v in values])
+        return perf_counters
+
     def _associate_with_op_graph_nodes(
         self, debug_handle_to_op_node_map: Dict[int, OperatorNode]
     ) -> None:
@@ -234,6 +272,29 @@ class Event:
                     # TODO: consider having this as a dict from node.name -> node.op
                     self.op_types += [node.op]
 
+    def _associate_with_op_costs(
+        self, op_costs: Dict[int, Tuple[Optional[int], int]]
+    ) -> None:
+        """
+        Helper function to populate the flops and bytes_moved attributes by summing
+        the estimated costs of the ops the event covers
+        """
+        if self.name in RESERVED_FRAMEWORK_EVENT_NAMES:
+            return
+
+        if (debug_handles := self.debug_handles) is None:
+            return
+
+        if isinstance(debug_handles, int):
+            debug_handles = [debug_handles]
+
+        costs = [op_costs[handle] for handle in debug_handles if handle in op_costs]
+        if not costs:
+            return
+        flops = [op_flops for op_flops, _ in costs]
+        self.flops = None if None in flops else sum(flops)
+        self.bytes_moved = sum(op_bytes for _, op_bytes in costs)
+
 
 @dataclass
 class EventBlock:
@@ -245,12 +306,20 @@ class EventBlock:
     Args:
         name: Name of the profiling/debugging block.
         events: List of `Event`\ s associated with the profiling/debugging block.
+        memory_events: The memory traffic of each instruction, in execution order, as logged by the first run of the block that had memory tracing enabled.
+        load_events: The phases of loading the program or initializing a method, as logged by the first run of the block that logged any.
+        load_time_scale_factor: Divides the timestamps of load_events to convert them to target_time_scale.
+        output_events: The statistics of the output of each instruction, in execution order, as logged by the first run of the block that had intermediate output logging enabled.
     """
 
     name: str
     events: List[Event] = dataclasses.field(default_factory=list)
     source_time_scale: TimeScale = TimeScale.NS
     target_time_scale: TimeScale = TimeScale.MS
+    memory_events: List[MemoryEvent] = dataclasses.field(default_factory=list)
+    load_events: List[LoadEvent] = dataclasses.field(default_factory=list)
+    load_time_scale_factor: float = 1.0
+    output_events: List[OutputEvent] = dataclasses.field(default_factory=list)
 
     def to_dataframe(self, include_units: bool = False) -> pd.DataFrame:
         """
@@ -259,6 +328,10 @@ class EventBlock:
         Note: Rows that have an event_name = OPERATOR_CALL correspond to the perf of the
             previous operator + framework tax of making said operator call.
 
+        The gflops_per_s and gbytes_per_s columns give the throughput that each event
+        achieved at its average latency, for comparison with the peak of the hardware.
+        They need an ETRecord, and latencies in real time rather than cycles.
+
         Args:
             include_units: Whether headers should include units (default false)
 
@@ -268,6 +341,17 @@ class EventBlock:
 
         units = " (" + self.target_time_scale.value + ")" if include_units else ""
 
+        def per_second(amount: Optional[int], event: Event) -> Optional[float]:
+            # Throughput in units of 1e9, which needs latencies in real time
+            if (
+                amount is None
+                or self.target_time_scale == TimeScale.CYCLES
+                or not event.perf_data.avg
+            ):
+                return None
+            seconds = event.perf_data.avg / time_scale_dict[self.target_time_scale]
+            return amount / seconds / 1e9
+
         # TODO: push row generation down to Event
         data = {
             "event_block_name": [self.name] * len(self.events),
@@ -289,10 +373,128 @@ class EventBlock:
                 event.delegate_backend_name for event in self.events
             ],
             "debug_data": [event.debug_data for event in self.events],
+            "perf_counters": [
+                {name: data.avg for name, data in event.perf_counters.items()}
+                for event in self.events
+            ],
+            "flops": [event.flops for event in self.events],
+            "bytes_moved": [event.bytes_moved for event in self.events],
+            "gflops_per_s": [per_second(event.flops, event) for event in self.events],
+            "gbytes_per_s": [
+                per_second(event.bytes_moved, event) for event in self.events
+            ],
         }
         df = pd.DataFrame(data)
         return df
 
+    def to_memory_dataframe(self) -> pd.DataFrame:
+        """
+        Converts the memory events of the EventBlock into a DataFrame with each row
+        being an instruction, in execution order. Shows the memory bandwidth of each
+        instruction and the occupancy of the memory planned arenas over the course of
+        the execution, keyed by memory id.
+
+        Returns:
+            A Pandas DataFrame with the columns:
+                instruction_id: The instruction that executed.
+                bytes_read, bytes_written: The total size of the tensors that the instruction read and wrote.
+                live_bytes: Per arena, the total size of the tensors that are live during the instruction.
+                live_extent_bytes: Per arena, the end offset of the highest live tensor. The difference with live_bytes is space that the memory plan leaves unused at that point.
+        """
+        occupancy = compute_arena_occupancy(self.memory_events)
+        data = {
+            "event_block_name": [self.name] * len(self.memory_events),
+            "instruction_id": [event.instruction_id for event in self.memory_events],
+            "bytes_read": [event.bytes_read for event in self.memory_events],
+            "bytes_written": [event.bytes_written for event in self.memory_events],
+            "live_bytes": [live_bytes for live_bytes, _ in occupancy],
+            "live_extent_bytes": [live_extent for _, live_extent in occupancy],
+        }
+        return pd.DataFrame(data)
+
+    def to_load_dataframe(self) -> pd.DataFrame:
+        """
+        Converts the load events of the EventBlock into a DataFrame with each row
+        being a phase of loading the program or initializing a method, in the order
+        that the phases ended. Phases nest: e.g. Method::init covers the phases of the
+        method's values, delegates and operators. Attributes cold-start time to I/O,
+        verification, delegate initialization and kernel resolution.
+
+        Returns:
+            A Pandas DataFrame with the columns:
+                name: The phase, or the backend id for the load and init of a single delegate.
+                delegate_index: The index of that delegate in the method, or -1.
+                duration: The time that the phase took, in target_time_scale.
+                bytes_loaded: The bytes that the phase read through the program's DataLoader.
+                bytes_allocated: The bytes that the phase allocated from the method allocator.
+        """
+        data = {
+            "event_block_name": [self.name] * len(self.load_events),
+            "name": [event.name for event in self.load_events],
+            "delegate_index": [event.delegate_index for event in self.load_events],
+            "duration": [
+                float(event.end_time - event.start_time) / self.load_time_scale_factor
+                for event in self.load_events
+            ],
+            "bytes_loaded": [event.bytes_loaded for event in self.load_events],
+            "bytes_allocated": [event.bytes_allocated for event in self.load_events],
+        }
+        return pd.DataFrame(data)
+
+    def to_output_dataframe(self) -> pd.DataFrame:
+        """
+        Converts the output events of the EventBlock into a DataFrame with each row
+        being an output of an instruction, in execution order. The statistics are
+        over the non-NaN elements of the output.
+
+        Returns:
+            A Pandas DataFrame with the columns:
+                instruction_id, output_index: The instruction, and which of its outputs.
+                numel, nan_count: The number of elements of the output, and how many of them are NaN.
+                min, max, mean: The statistics of the output.
+                hash: A hash of the contents of the output, to tell whether two runs computed exactly the same output.
+                has_data: Whether the full output was logged.
+        """
+
+        def stat(event: OutputEvent, name: str) -> Optional[float]:
+            return getattr(event.stats, name) if event.stats is not None else None
+
+        data = {
+            "event_block_name": [self.name] * len(self.output_events),
+            "instruction_id": [event.instruction_id for event in self.output_events],
+            "output_index": [event.output_index for event in self.output_events],
+        }
+        for name in ("numel", "nan_count", "min", "max", "mean", "hash"):
+            data[name] = [stat(event, name) for event in self.output_events]
+        data["has_data"] = [
+            event.tensor is not None and bool(event.tensor.data)
+            for event in self.output_events
+        ]
+        return pd.DataFrame(data)
+
+    def find_first_output_mismatch(
+        self, reference: "EventBlock", tolerance: Optional[float] = None
+    ) -> Optional[Tuple[Optional[OutputEvent], Optional[OutputEvent]]]:
+        """
+        Finds the first instruction output of this EventBlock that differs from the
+        same output in `reference`, e.g. the block of a run on another device or of an
+        earlier build, to locate where two executions start to diverge. Log the full
+        data of the instructions around it to see the difference in detail.
+
+        Args:
+            reference: An EventBlock of the same method, with output events.
+            tolerance: If None, outputs must hash the same. Otherwise, their min,
+                max and mean must be within this tolerance, relative to the magnitude
+                of the reference values.
+
+        Returns:
+            The pair of output events from `reference` and this EventBlock that
+            differ first, or None if all of them match.
+        """
+        return find_first_output_mismatch(
+            reference.output_events, self.output_events, tolerance
+        )
+
     @staticmethod
     def _gen_from_etdump(
         etdump: ETDumpFlatCC,
@@ -304,7 +506,9 @@ class EventBlock:
         contents.
 
         An optional (inverse) scale factor can be provided to adjust the
-        etdump timestamps associated with each EventBlocks
+        etdump timestamps associated with each EventBlocks. If the etdump
+        records the duration of its ticks, the timestamps are converted with it
+        instead of source_time_scale, unless the source is in cycles.
         """
 
         # Group all the RunData by the set of profile events
@@ -312,6 +516,12 @@ class EventBlock:
             RunSignature,
             OrderedDict[ProfileEventSignature, List[ProfileEvent]],
         ] = defaultdict(OrderedDict)
+        # The memory events of the first run of each group that logged them
+        memory_run_groups: Dict[RunSignature, List[MemoryEvent]] = {}
+        # The load events of the first run of each group that logged them
+        load_run_groups: Dict[RunSignature, List[LoadEvent]] = {}
+        # The output events of the first run of each group that logged them
+        output_run_groups: Dict[RunSignature, List[OutputEvent]] = {}
         for run in etdump.run_data:
             if (run_events := run.events) is None:
                 continue
@@ -335,9 +545,43 @@ class EventBlock:
             for event_signature, event in profile_events.items():
                 run_signature_events.setdefault(event_signature, []).append(event)
 
-        scale_factor = (
-            time_scale_dict[source_time_scale] / time_scale_dict[target_time_scale]
-        )
+            memory_events = [
+                memory_event
+                for event in run_events
+                if (memory_event := event.memory_event) is not None
+            ]
+            if memory_events and run_signature not in memory_run_groups:
+                memory_run_groups[run_signature] = memory_events
+
+            load_events = [
+                load_event
+                for event in run_events
+                if (load_event := event.load_event) is not None
+            ]
+            if load_events and run_signature not in load_run_groups:
+                load_run_groups[run_signature] = load_events
+
+            output_events = [
+                output_event
+                for event in run_events
+                if (output_event := event.output_event) is not None
+            ]
+            if output_events and run_signature not in output_run_groups:
+                output_run_groups[run_signature] = output_events
+
+        ticks_per_ns = etdump_ticks_per_ns(etdump)
+        if ticks_per_ns is not None and source_time_scale != TimeScale.CYCLES:
+            source_time_scale = TimeScale.NS
+            scale_factor = (
+                ticks_per_ns
+                * time_scale_dict[TimeScale.NS]
+                / time_scale_dict[target_time_scale]
+            )
+        else:
+            scale_factor = (
+                time_scale_dict[source_time_scale]
+                / time_scale_dict[target_time_scale]
+            )
         # Create EventBlocks from the Profile Run Groups
         return [
             EventBlock(
@@ -348,8 +592,14 @@ class EventBlock:
                 ],
                 source_time_scale=source_time_scale,
                 target_time_scale=target_time_scale,
+                memory_events=memory_run_groups.get(run_signature, []),
+                load_events=load_run_groups.get(run_signature, []),
+                load_time_scale_factor=scale_factor,
+                output_events=output_run_groups.get(run_signature, []),
+            )
+            for index, (run_signature, profile_events) in enumerate(
+                profile_run_groups.items()
             )
-            for index, profile_events in enumerate(profile_run_groups.values())
         ]
 
     # TODO: Considering changing ETRecord deserialization logic to cast the ints in string format to actual ints
@@ -423,16 +673,18 @@ class Inspector:
         etrecord_path: Optional[str] = None,
         source_time_scale: TimeScale = TimeScale.NS,
         target_time_scale: TimeScale = TimeScale.MS,
+        etdump_data: Optional[bytes] = None,
     ) -> None:
         r"""
         Initialize an `Inspector` instance with the underlying `EventBlock`\ s populated with data from the provided ETDump path
         and optional ETRecord path.
 
         Args:
-            etdump_path: Path to the ETDump file.
+            etdump_path: Path to the ETDump file. Ignored if etdump_data is provided.
             etrecord_path: Optional path to the ETRecord file.
-            source_time_scale: The time scale of the performance data retrieved from the runtime. The default time hook implentation in the runtime returns NS.
+            source_time_scale: The time scale of the performance data retrieved from the runtime. The default time hook implentation in the runtime returns NS. Ignored, unless it is CYCLES, if the ETDump records the duration of its ticks.
             target_time_scale: The target time scale to which the users want their performance data converted to. Defaults to MS.
+            etdump_data: Optional ETDump bytes, such as those returned by ExecutorchModule.get_etdump() or profile_method() in the pybindings, to use instead of a file.
 
         Returns:
             None
@@ -444,7 +696,11 @@ class Inspector:
             else None
         )
 
-        etdump = gen_etdump_object(etdump_path=etdump_path)
+        etdump = (
+            gen_etdump_object(etdump_data=etdump_data)
+            if etdump_data is not None
+            else gen_etdump_object(etdump_path=etdump_path)
+        )
         if (source_time_scale == TimeScale.CYCLES) ^ (
             target_time_scale == TimeScale.CYCLES
         ):
@@ -452,6 +708,7 @@ class Inspector:
                 "For TimeScale in cycles both the source and target time scale have to be in cycles."
             )
 
+        self._etdump = etdump
         self._source_time_scale = source_time_scale
         self._target_time_scale = target_time_scale
         self.event_blocks = EventBlock._gen_from_etdump(
@@ -479,9 +736,17 @@ class Inspector:
             debug_handle_to_op_node_map,
         )
 
+        # Estimate the work of each op from the shapes and dtypes of the graph
+        op_costs = (
+            compute_op_costs(self._etrecord.edge_dialect_program.graph_module)
+            if self._etrecord.edge_dialect_program is not None
+            else {}
+        )
+
         for event_block in self.event_blocks:
             for event in event_block.events:
                 event._associate_with_op_graph_nodes(debug_handle_to_op_node_map)
+                event._associate_with_op_costs(op_costs)
 
     def print_data_tabular(self, include_units: bool = True) -> None:
         """
@@ -547,6 +812,76 @@ class Inspector:
                         break
         return total
 
+    def compare(
+        self,
+        other: "Inspector",
+        confidence: float = 0.95,
+        min_relative_change: float = 0.0,
+    ) -> pd.DataFrame:
+        """
+        Compares the latency of each Event against the matching Event of another
+        Inspector, e.g. one created from an ETDump taken after a kernel change, or
+        with a different delegate. Events match when they have the same name in
+        EventBlocks of the same name, counting repeated names in order.
+
+        A change is significant when the bootstrap confidence interval of the
+        difference of the average latencies excludes zero, and the change is at
+        least min_relative_change of the base average. Events that only appear on
+        one side are skipped.
+
+        Args:
+            other: The Inspector to compare against; self is the baseline.
+            confidence: The confidence level of the intervals (default 0.95).
+            min_relative_change: The smallest relative change to report as significant, e.g. 0.05 to ignore changes under 5% (default 0.0).
+
+        Returns:
+            A Pandas DataFrame with a row per matched Event and the columns:
+                event_block_name, event_name: The Event.
+                base_avg, new_avg: The average latencies of self and other.
+                diff, diff_ci_low, diff_ci_high: The difference of the averages (new - base) and its confidence interval.
+                relative_change: diff relative to base_avg.
+                verdict: "regression" or "improvement" if the change is significant, or "" otherwise.
+        """
+
+        def key_events(inspector: "Inspector") -> Dict[Tuple[str, str, int], Event]:
+            keyed = {}
+            for block in inspector.event_blocks:
+                occurrences: Dict[str, int] = defaultdict(int)
+                for event in block.events:
+                    keyed[(block.name, event.name, occurrences[event.name])] = event
+                    occurrences[event.name] += 1
+            return keyed
+
+        base_events = key_events(self)
+        new_events = key_events(other)
+        rows = []
+        for key, base_event in base_events.items():
+            if (new_event := new_events.get(key)) is None:
+                continue
+            base, new = base_event.perf_data, new_event.perf_data
+            diff = new.avg - base.avg
+            low, high = bootstrap_mean_difference_ci(base.raw, new.raw, confidence)
+            relative_change = diff / base.avg if base.avg else float("inf")
+            verdict = ""
+            if (low > 0 or high < 0) and abs(relative_change) >= min_relative_change:
+                verdict = "regression" if diff > 0 else "improvement"
+            rows.append(
+                {
+                    "event_block_name": key[0],
+                    "event_name": key[1],
+                    "base_avg": base.avg,
+                    "new_avg": new.avg,
+                    "diff": diff,
+                    "diff_ci_low": low,
+                    "diff_ci_high": high,
+                    "relative_change": relative_change,
+                    "verdict": verdict,
+                }
+            )
+        if skipped := len(base_events.keys() ^ new_events.keys()):
+            log.warning(f"{skipped} events only appear in one of the Inspectors")
+        return pd.DataFrame(rows)
+
     def get_op_list(
         self, event_block: str, show_delegated_ops: Optional[bool] = True
     ) -> Dict[str, List[Event]]:
@@ -563,6 +898,37 @@ class Inspector:
         # TODO: implement
         pass
 
+    def write_chrome_trace(self, path: str) -> None:
+        """
+        Writes every run in the ETDump to a JSON trace that chrome://tracing and
+        Perfetto (ui.perfetto.dev) display as a timeline, with a track per runtime
+        thread. Methods, chains, operator and delegate calls, and the events logged
+        inside delegates are nested by time, which makes the gaps between ops and
+        around delegate handoffs visible.
+
+        Timestamps are shown in microseconds. ETDumps timed in cycles show one cycle
+        per microsecond.
+
+        Args:
+            path: The path of the JSON file to write.
+
+        Returns:
+            None
+        """
+        ticks_per_ns = etdump_ticks_per_ns(self._etdump)
+        if self._source_time_scale == TimeScale.CYCLES:
+            ticks_per_us = 1.0
+        elif ticks_per_ns is not None:
+            ticks_per_us = ticks_per_ns * 1e3
+        else:
+            ticks_per_us = time_scale_dict[self._source_time_scale] / 1e6
+        trace = {
+            "traceEvents": gen_chrome_trace_events(self._etdump, ticks_per_us),
+            "displayTimeUnit": "ns",
+        }
+        with open(path, "w") as f:
+            json.dump(trace, f)
+
     def get_exported_program(
         self, graph: Optional[str] = None
     ) -> Optional[ExportedProgram]:
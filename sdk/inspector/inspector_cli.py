@@ -7,6 +7,7 @@
 import argparse
 
 from executorch.sdk.inspector.inspector import Inspector
+from tabulate import tabulate
 
 if __name__ == "__main__":
     parser = argparse.ArgumentParser()
@@ -21,9 +22,51 @@ if __name__ == "__main__":
         help="Provide an optional ETRecord file path.",
     )
 
+    parser.add_argument(
+        "--chrome_trace_path",
+        required=False,
+        help="Provide an optional path to write a Chrome/Perfetto JSON trace to.",
+    )
+    subparsers = parser.add_subparsers(dest="command")
+    compare_parser = subparsers.add_parser(
+        "compare",
+        help="Compare the latency of each event against another ETDump.",
+    )
+    compare_parser.add_argument(
+        "--new_etdump_path",
+        required=True,
+        help="Provide the ETDump file path to compare against --etdump_path.",
+    )
+    compare_parser.add_argument(
+        "--confidence",
+        type=float,
+        default=0.95,
+        help="Confidence level of the intervals (default 0.95).",
+    )
+    compare_parser.add_argument(
+        "--min_relative_change",
+        type=float,
+        default=0.0,
+        help="Smallest relative change to flag, e.g. 0.05 for 5%% (default 0).",
+    )
+
     args = parser.parse_args()
 
     inspector = Inspector(
         etdump_path=args.etdump_path, etrecord_path=args.etrecord_path
     )
-    inspector.print_data_tabular()
+    if args.command == "compare":
+        new_inspector = Inspector(
+            etdump_path=args.new_etdump_path, etrecord_path=args.etrecord_path
+        )
+        df = inspector.compare(
+            new_inspector,
+            confidence=args.confidence,
+            min_relative_change=args.min_relative_change,
+        )
+        print(tabulate(df, headers="keys", tablefmt="fancy_grid"))
+    else:
+        inspector.print_data_tabular()
+
+    if args.chrome_trace_path is not None:
+        inspector.write_chrome_trace(args.chrome_trace_path)
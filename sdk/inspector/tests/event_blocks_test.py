@@ -16,6 +16,7 @@ from executorch.sdk.inspector.inspector import (
     EventBlock,
     PerfData,
     ProfileEventSignature,
+    TimeScale,
 )
 
 
@@ -139,6 +140,140 @@ class TestEventBlock(unittest.TestCase):
         }
         self.assertSetEqual(run_counts, {(1, 2), (2, 1)})
 
+    def test_gen_from_etdump_ticks_to_ns(self) -> None:
+        """
+        Test that the ticks-to-ns ratio recorded in the ETDump converts the
+        timestamps, unless they are read as cycles
+        """
+        etdump: ETDumpFlatCC = TestEventBlock._get_sample_etdump_flatcc()
+        # 2 ticks per ns.
+        etdump.ticks_to_ns_numerator = 1
+        etdump.ticks_to_ns_denominator = 2
+
+        blocks: List[EventBlock] = EventBlock._gen_from_etdump(
+            etdump, TimeScale.US, TimeScale.NS
+        )
+        raw = {tuple(block.events[0].perf_data.raw) for block in blocks}
+        self.assertSetEqual(raw, {(0.5, 1.0), (0.5,)})
+        self.assertTrue(all(b.source_time_scale == TimeScale.NS for b in blocks))
+
+        blocks = EventBlock._gen_from_etdump(
+            etdump, TimeScale.CYCLES, TimeScale.CYCLES
+        )
+        raw = {tuple(block.events[0].perf_data.raw) for block in blocks}
+        self.assertSetEqual(raw, {(1.0, 2.0), (1.0,)})
+
+    def test_gen_from_etdump_memory_events(self) -> None:
+        """
+        Test that the memory events of the first run of each EventBlock are kept
+        """
+        etdump: ETDumpFlatCC = TestEventBlock._get_sample_etdump_flatcc()
+        for index, run_data in enumerate(etdump.run_data):
+            assert run_data.events is not None
+            run_data.events.append(
+                flatcc.Event(
+                    allocation_event=None,
+                    debug_event=None,
+                    profile_event=None,
+                    memory_event=flatcc.MemoryEvent(
+                        chain_id=0,
+                        instruction_id=1,
+                        bytes_read=index,
+                        bytes_written=0,
+                        tensors=[flatcc.TensorMemoryAccess(1, 0, 8, True)],
+                    ),
+                )
+            )
+        blocks: List[EventBlock] = EventBlock._gen_from_etdump(etdump)
+
+        # run_data_1 and run_data_2 share a block, run_data_3 has its own
+        bytes_read = {
+            (len(block.events), tuple(e.bytes_read for e in block.memory_events))
+            for block in blocks
+        }
+        self.assertSetEqual(bytes_read, {(1, (0,)), (2, (2,))})
+
+    def test_gen_from_etdump_load_events(self) -> None:
+        """
+        Test that the load events of the first run of each EventBlock are kept, and
+        that their durations are scaled to the target time scale
+        """
+        etdump: ETDumpFlatCC = TestEventBlock._get_sample_etdump_flatcc()
+        for index, run_data in enumerate(etdump.run_data):
+            assert run_data.events is not None
+            run_data.events.append(
+                flatcc.Event(
+                    allocation_event=None,
+                    debug_event=None,
+                    profile_event=None,
+                    load_event=flatcc.LoadEvent(
+                        name="Program::load_data",
+                        delegate_index=-1,
+                        start_time=0,
+                        end_time=(index + 1) * 1000,
+                        bytes_loaded=index,
+                        bytes_allocated=0,
+                    ),
+                )
+            )
+        blocks: List[EventBlock] = EventBlock._gen_from_etdump(
+            etdump, TimeScale.NS, TimeScale.US
+        )
+
+        # run_data_1 and run_data_2 share a block, run_data_3 has its own
+        rows = {
+            tuple(
+                block.to_load_dataframe()[["duration", "bytes_loaded"]].itertuples(
+                    index=False, name=None
+                )
+            )
+            for block in blocks
+        }
+        self.assertSetEqual(rows, {((1.0, 0),), ((3.0, 2),)})
+
+    def test_gen_from_etdump_output_events(self) -> None:
+        """
+        Test that the output events of the first run of each EventBlock are kept,
+        and that runs can be compared by them
+        """
+        etdump: ETDumpFlatCC = TestEventBlock._get_sample_etdump_flatcc()
+        for index, run_data in enumerate(etdump.run_data):
+            assert run_data.events is not None
+            run_data.events.append(
+                flatcc.Event(
+                    allocation_event=None,
+                    debug_event=None,
+                    profile_event=None,
+                    output_event=flatcc.OutputEvent(
+                        chain_id=0,
+                        instruction_id=1,
+                        output_index=0,
+                        stats=flatcc.TensorStats(4, -1.0, 2.0, 0.5, 0, index),
+                        tensor=None,
+                    ),
+                )
+            )
+        blocks: List[EventBlock] = EventBlock._gen_from_etdump(etdump)
+
+        # run_data_1 and run_data_2 share a block, run_data_3 has its own
+        rows = {
+            tuple(
+                block.to_output_dataframe()[
+                    ["instruction_id", "numel", "hash", "has_data"]
+                ].itertuples(index=False, name=None)
+            )
+            for block in blocks
+        }
+        self.assertSetEqual(rows, {((1, 4, 0, False),), ((1, 4, 2, False),)})
+
+        # The outputs hash differently, but their statistics are the same
+        mismatch = blocks[0].find_first_output_mismatch(blocks[1])
+        assert mismatch is not None
+        self.assertEqual(mismatch[0], blocks[1].output_events[0])
+        self.assertIsNone(
+            blocks[0].find_first_output_mismatch(blocks[1], tolerance=1e-6)
+        )
+
     def test_inspector_event_generation(self) -> None:
         """
         Test Inspector.Event derivation from various ProfileEvent cases
@@ -216,6 +351,34 @@ class TestEventBlock(unittest.TestCase):
             "delegate", 1, None, "identifier", scale_factor=10000
         )
 
+    def test_inspector_event_perf_counters(self) -> None:
+        """
+        Test that hardware performance counters are collected into Event.perf_counters,
+        keeping only the counters that every instance of the event captured
+        """
+        profile_events: List[flatcc.ProfileEvent] = []
+        for cycles, l1d_read_misses in [(100, 4), (300, -1)]:
+            profile_event = TestEventBlock._gen_sample_profile_event(
+                "op", 1, (0, 10)
+            )
+            profile_event.perf_counters = flatcc.PerfCounters(
+                cycles=cycles, instructions=50, l1d_read_misses=l1d_read_misses
+            )
+            profile_events.append(profile_event)
+
+        signature = ProfileEventSignature._gen_from_event(profile_events[0])
+        event = Event._gen_from_profile_events(signature, profile_events)
+        self.assertEqual(set(event.perf_counters), {"cycles", "instructions"})
+        self.assertEqual(event.perf_counters["cycles"].raw, [100.0, 300.0])
+        self.assertEqual(event.perf_counters["instructions"].avg, 50.0)
+
+        # Counters are dropped entirely if any instance lacks them.
+        profile_events.append(
+            TestEventBlock._gen_sample_profile_event("op", 1, (0, 10))
+        )
+        event = Event._gen_from_profile_events(signature, profile_events)
+        self.assertEqual(event.perf_counters, {})
+
     def test_gen_resolve_debug_handles(self) -> None:
         """
         Test that gen_resolve_debug_handles() correctly populates the EventBlock
@@ -21,7 +21,13 @@ from executorch.sdk.etrecord.tests.etrecord_test import TestETRecord
 
 from executorch.sdk.inspector import inspector
 
-from executorch.sdk.inspector.inspector import Event, EventBlock, Inspector, PerfData
+from executorch.sdk.inspector.inspector import (
+    Event,
+    EventBlock,
+    Inspector,
+    PerfData,
+    TimeScale,
+)
 
 
 OP_TYPE = "aten::add"
@@ -51,6 +57,27 @@ class TestInspector(unittest.TestCase):
         self.assertEqual(len(df["raw"].values[0]), RAW_DATA_SIZE)
         self.assertEqual(df["op_types"].values[0][0], OP_TYPE)
 
+    def test_event_block_to_dataframe_throughput(self) -> None:
+        # 2 GFLOP and 4 GB moved in 1000 ms on average
+        event = Event(
+            name="op_0",
+            perf_data=PerfData([500.0, 1500.0]),
+            flops=2 * 10**9,
+            bytes_moved=4 * 10**9,
+        )
+        df = EventBlock(name=EVENT_BLOCK_NAME, events=[event]).to_dataframe()
+        self.assertAlmostEqual(df["gflops_per_s"][0], 2.0)
+        self.assertAlmostEqual(df["gbytes_per_s"][0], 4.0)
+
+        # Cycles can't be converted to time
+        df = EventBlock(
+            name=EVENT_BLOCK_NAME,
+            events=[event],
+            source_time_scale=TimeScale.CYCLES,
+            target_time_scale=TimeScale.CYCLES,
+        ).to_dataframe()
+        self.assertIsNone(df["gflops_per_s"][0])
+
     def test_inspector_constructor(self):
         # Create a context manager to patch functions called by Inspector.__init__
         with patch.object(
@@ -75,6 +102,14 @@ class TestInspector(unittest.TestCase):
             # Because we mocked parse_etrecord() to return None, this method shouldn't be called
             mock_gen_graphs_from_etrecord.assert_not_called()
 
+    def test_inspector_constructor_with_etdump_data(self):
+        with patch.object(
+            inspector, "gen_etdump_object", return_value=None
+        ) as mock_gen_etdump, patch.object(EventBlock, "_gen_from_etdump"):
+            Inspector(etdump_data=b"etdump")
+
+            mock_gen_etdump.assert_called_once_with(etdump_data=b"etdump")
+
     def test_inspector_print_data_tabular(self):
         # Create a context manager to patch functions called by Inspector.__init__
         with patch.object(inspector, "parse_etrecord", return_value=None), patch.object(
@@ -97,6 +132,54 @@ class TestInspector(unittest.TestCase):
             with redirect_stdout(None):
                 inspector_instance.print_data_tabular()
 
+    def test_inspector_compare(self):
+        with patch.object(inspector, "parse_etrecord", return_value=None), patch.object(
+            inspector, "gen_etdump_object", return_value=None
+        ), patch.object(EventBlock, "_gen_from_etdump"), patch.object(
+            inspector, "gen_graphs_from_etrecord"
+        ):
+            base = Inspector(etdump_path=ETDUMP_PATH)
+            new = Inspector(etdump_path=ETDUMP_PATH)
+
+        def event_block(latencies):
+            return EventBlock(
+                name=EVENT_BLOCK_NAME,
+                events=[
+                    Event(name=name, perf_data=PerfData(raw))
+                    for name, raw in latencies
+                ],
+            )
+
+        base.event_blocks = [
+            event_block(
+                [
+                    ("op_0", [10.0, 11.0, 10.5, 10.2]),
+                    ("op_1", [5.0, 6.0, 5.5, 5.2]),
+                    ("op_2", [1.0, 1.1, 1.2, 0.9]),
+                    ("op_3", [1.0]),
+                ]
+            )
+        ]
+        new.event_blocks = [
+            event_block(
+                [
+                    ("op_0", [20.0, 21.0, 20.5, 20.2]),
+                    ("op_1", [5.0, 6.0, 5.5, 5.2]),
+                    ("op_2", [0.5, 0.6, 0.55, 0.52]),
+                ]
+            )
+        ]
+
+        df = base.compare(new)
+        # op_3 only appears in the baseline
+        self.assertEqual(list(df["event_name"]), ["op_0", "op_1", "op_2"])
+        self.assertEqual(list(df["verdict"]), ["regression", "", "improvement"])
+        self.assertAlmostEqual(df["relative_change"][0], 10.0 / 10.425)
+
+        # A threshold hides changes that are significant but small
+        df = base.compare(new, min_relative_change=2.0)
+        self.assertEqual(list(df["verdict"]), ["", "", ""])
+
     def test_inspector_associate_with_op_graph_nodes_single_debug_handle(self):
         # Test on an event with a single debug handle
         debug_handle = 111
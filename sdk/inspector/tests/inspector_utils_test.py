@@ -8,6 +8,8 @@ import tempfile
 import unittest
 from typing import Dict, Tuple
 
+import torch
+
 from executorch.sdk.debug_format.base_schema import (
     OperatorGraph,
     OperatorNode,
@@ -15,12 +17,27 @@ from executorch.sdk.debug_format.base_schema import (
 )
 
 from executorch.sdk.debug_format.et_schema import FXOperatorGraph
+from executorch.sdk.etdump.schema_flatcc import (
+    ETDumpFlatCC,
+    Event,
+    MemoryEvent,
+    OutputEvent,
+    ProfileEvent,
+    RunData,
+    TensorMemoryAccess,
+    TensorStats,
+)
 from executorch.sdk.etrecord import generate_etrecord, parse_etrecord
 
 from executorch.sdk.etrecord.tests.etrecord_test import TestETRecord
 from executorch.sdk.inspector._inspector_utils import (
+    bootstrap_mean_difference_ci,
+    compute_arena_occupancy,
+    compute_op_costs,
     create_debug_handle_to_op_node_mapping,
     EDGE_DIALECT_GRAPH_KEY,
+    find_first_output_mismatch,
+    gen_chrome_trace_events,
     gen_graphs_from_etrecord,
 )
 
@@ -57,6 +74,174 @@ class TestInspectorUtils(unittest.TestCase):
 
         self.assertEqual(debug_handle_to_op_node_map, expected_mapping)
 
+    def test_compute_arena_occupancy(self):
+        # A chain of four ops that ping-pongs between two regions of arena 1, reading
+        # an unplanned input in the first op.
+        def access(memory_id, memory_offset, size, is_write):
+            return TensorMemoryAccess(memory_id, memory_offset, size, is_write)
+
+        memory_events = [
+            MemoryEvent(
+                0, 0, 12, 16, [access(1, 0, 16, True), access(1, 16, 8, False)]
+            ),
+            MemoryEvent(
+                0, 1, 16, 16, [access(1, 32, 16, True), access(1, 0, 16, False)]
+            ),
+            MemoryEvent(
+                0, 2, 16, 16, [access(1, 0, 16, True), access(1, 32, 16, False)]
+            ),
+            MemoryEvent(
+                0,
+                3,
+                20,
+                16,
+                [
+                    access(1, 32, 16, True),
+                    access(1, 0, 16, False),
+                    access(-1, 0, 4, False),
+                ],
+            ),
+        ]
+
+        # The second op's output is dead after the third op reads it, so the
+        # fourth op's output reuses its region.
+        self.assertEqual(
+            compute_arena_occupancy(memory_events),
+            [
+                ({1: 24}, {1: 24}),
+                ({1: 32}, {1: 48}),
+                ({1: 32}, {1: 48}),
+                ({1: 32}, {1: 48}),
+            ],
+        )
+
+
+    def test_find_first_output_mismatch(self):
+        def output(instruction_id, mean, hash):
+            return OutputEvent(
+                0,
+                instruction_id,
+                0,
+                TensorStats(8, -1.0, 1.0, mean, 0, hash),
+                None,
+            )
+
+        reference = [output(0, 0.5, 11), output(1, 0.25, 12), output(2, 0.1, 13)]
+        self.assertIsNone(find_first_output_mismatch(reference, list(reference)))
+
+        # Instruction 1 rounds differently, and the difference grows after it.
+        outputs = [output(0, 0.5, 11), output(1, 0.2500001, 22), output(2, 0.2, 23)]
+        self.assertEqual(
+            find_first_output_mismatch(reference, outputs),
+            (reference[1], outputs[1]),
+        )
+        self.assertEqual(
+            find_first_output_mismatch(reference, outputs, tolerance=1e-3),
+            (reference[2], outputs[2]),
+        )
+
+        # An execution that stops early mismatches where it stopped.
+        self.assertEqual(
+            find_first_output_mismatch(reference, reference[:2]),
+            (reference[2], None),
+        )
+
+    def test_bootstrap_mean_difference_ci(self):
+        base = [10.0, 11.0, 10.5, 10.2, 10.8]
+        low, high = bootstrap_mean_difference_ci(base, [x + 5.0 for x in base])
+        self.assertTrue(0 < low <= 5.0 <= high)
+
+        # The same samples on both sides give an interval around zero
+        low, high = bootstrap_mean_difference_ci(base, base)
+        self.assertTrue(low <= 0.0 <= high)
+
+        # Single samples have no spread
+        self.assertEqual(bootstrap_mean_difference_ci([1.0], [3.0]), (2.0, 2.0))
+
+        with self.assertRaises(ValueError):
+            bootstrap_mean_difference_ci(base, base, confidence=1.0)
+
+    def test_compute_op_costs(self):
+        # relu(x @ w) with x [4, 8], w [8, 16], and a copy that isn't modelled
+        graph = torch.fx.Graph()
+        x = graph.placeholder("x")
+        x.meta["val"] = torch.empty(4, 8)
+        w = graph.placeholder("w")
+        w.meta["val"] = torch.empty(8, 16)
+        mm = graph.call_function(torch.ops.aten.mm.default, (x, w))
+        mm.meta["val"] = torch.empty(4, 16)
+        mm.meta["debug_handle"] = 1
+        relu = graph.call_function(torch.ops.aten.relu.default, (mm,))
+        relu.meta["val"] = torch.empty(4, 16)
+        relu.meta["debug_handle"] = 2
+        clone = graph.call_function(torch.ops.aten.clone.default, (relu,))
+        clone.meta["val"] = torch.empty(4, 16, dtype=torch.half)
+        clone.meta["debug_handle"] = 3
+        graph.output(clone)
+
+        self.assertEqual(
+            compute_op_costs(torch.fx.GraphModule(torch.nn.Module(), graph)),
+            {
+                1: (2 * 4 * 16 * 8, (32 + 128 + 64) * 4),
+                2: (64, (64 + 64) * 4),
+                3: (None, 64 * 2 + 64 * 4),
+            },
+        )
+
+    def test_gen_chrome_trace_events(self):
+        def profile_event(name, instruction_id, start, end, delegate_id=-1):
+            return Event(
+                profile_event=ProfileEvent(
+                    name=name,
+                    chain_id=0 if instruction_id != -1 else -1,
+                    instruction_id=instruction_id,
+                    delegate_debug_id_int=delegate_id,
+                    delegate_debug_id_str="",
+                    delegate_debug_metadata="",
+                    start_time=start,
+                    end_time=end,
+                ),
+                allocation_event=None,
+                debug_event=None,
+            )
+
+        # An op and a delegate call with an event inside the delegate, on thread 7
+        etdump = ETDumpFlatCC(
+            version=0,
+            run_data=[
+                RunData(
+                    name="Execute",
+                    allocators=None,
+                    events=[
+                        profile_event("native_call_add.out", 0, 2000, 4000),
+                        profile_event("DELEGATE_CALL", 1, 5000, 9000),
+                        profile_event("", 1, 6000, 8000, delegate_id=3),
+                        profile_event("Method::execute", -1, 1000, 10000),
+                    ],
+                    thread_id=7,
+                )
+            ],
+        )
+
+        trace_events = gen_chrome_trace_events(etdump, ticks_per_us=1000.0)
+        spans = {
+            event["name"]: (event["cat"], event["ts"], event["dur"], event["tid"])
+            for event in trace_events
+            if event["ph"] == "X"
+        }
+        self.assertEqual(
+            spans,
+            {
+                "native_call_add.out": ("operator", 2.0, 2.0, 7),
+                "DELEGATE_CALL": ("delegate_call", 5.0, 4.0, 7),
+                "3": ("delegate", 6.0, 2.0, 7),
+                "Method::execute": ("framework", 1.0, 9.0, 7),
+                "chain 0": ("chain", 2.0, 7.0, 7),
+            },
+        )
+        metadata = [event for event in trace_events if event["ph"] == "M"]
+        self.assertEqual(len(metadata), 1)
+        self.assertEqual(metadata[0]["tid"], 7)
 
 def gen_mock_operator_graph_with_expected_map() -> Tuple[
     OperatorGraph, Dict[int, OperatorNode]
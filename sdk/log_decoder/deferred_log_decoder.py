@@ -0,0 +1,258 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""
+Formats the binary log records that a runtime built with ET_LOG_DEFERRED emits
+instead of log messages. See runtime/platform/log.h for the record layout.
+
+The format strings of the messages are not in the records, but in the
+`et_log_sites` section of the runtime binary, which can be dumped with
+
+    objcopy --dump-section et_log_sites=sites.bin <binary>
+
+The records are read from text output (e.g. a console or serial log) in which
+the default POSIX PAL writes each of them as a line of hex digits after
+"executorch-log-record: "; other lines are passed through unchanged.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+from dataclasses import dataclass
+from typing import Dict, Iterable, Iterator, List, Union
+
+RECORD_PREFIX = "executorch-log-record: "
+
+# Level, flags, site ID, timestamp.
+RECORD_HEADER = struct.Struct("<BBIQ")
+RECORD_TRUNCATED = 1
+
+# A printf conversion: flags, width, precision, length modifier and conversion.
+CONVERSION = re.compile(
+    r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d*))?"
+    r"(?P<length>hh|h|ll|l|j|z|t|L)?(?P<conversion>[diouxXeEfFgGaAcsp%])"
+)
+
+# The number of bits of an unsigned conversion, by length modifier.
+LENGTH_BITS = {
+    "hh": 8,
+    "h": 16,
+    None: 32,
+    "l": 64,
+    "ll": 64,
+    "j": 64,
+    "z": 64,
+    "t": 64,
+}
+
+Arg = Union[int, float, str]
+
+
+@dataclass
+class LogSite:
+    """The source location and format string of an ET_LOG."""
+
+    filename: str
+    line: int
+    format: str
+
+
+@dataclass
+class LogRecord:
+    """A decoded log record."""
+
+    level: str
+    timestamp: int
+    site: LogSite
+    args: List[Arg]
+    truncated: bool
+
+
+def site_id(site: bytes) -> int:
+    """
+    Returns the ID of a log site, the 32-bit FNV-1a hash of its file, line and
+    format separated by NULs, as log_site_id() in log.h computes it.
+    """
+    hash = 2166136261
+    for byte in site:
+        hash = ((hash ^ byte) * 16777619) & 0xFFFFFFFF
+    return hash
+
+
+def parse_sites(section: bytes) -> Dict[int, LogSite]:
+    """
+    Parses the contents of the et_log_sites section into the sites of the
+    messages, by their ID. Each site is its file, line and format as
+    NUL-terminated strings. Sites that were compiled more than once, e.g. in
+    inline functions, appear more than once.
+    """
+    sites = {}
+    fields = section.split(b"\0")
+    # The section ends with a NUL, which leaves an empty last field.
+    if len(fields) % 3 != 1 or fields[-1]:
+        raise ValueError("The log sites section is truncated")
+    for i in range(0, len(fields) - 1, 3):
+        filename, line, fmt = fields[i : i + 3]
+        id = site_id(b"\0".join((filename, line, fmt)))
+        site = LogSite(
+            filename=os.path.basename(filename.decode("utf-8", errors="replace")),
+            line=int(line),
+            format=fmt.decode("utf-8", errors="replace"),
+        )
+        if sites.setdefault(id, site) != site:
+            raise ValueError(f"Log sites {sites[id]} and {site} have the same ID")
+    return sites
+
+
+def parse_args(data: bytes) -> List[Arg]:
+    """Parses the tagged arguments that follow the header of a record."""
+    args: List[Arg] = []
+    offset = 0
+    while offset < len(data):
+        tag = chr(data[offset])
+        offset += 1
+        if tag == "i":
+            (value,) = struct.unpack_from("<q", data, offset)
+            offset += 8
+        elif tag in ("u", "p"):
+            (value,) = struct.unpack_from("<Q", data, offset)
+            offset += 8
+        elif tag == "f":
+            (value,) = struct.unpack_from("<d", data, offset)
+            offset += 8
+        elif tag == "s":
+            length = data[offset]
+            value = data[offset + 1 : offset + 1 + length].decode(
+                "utf-8", errors="replace"
+            )
+            offset += 1 + length
+        else:
+            raise ValueError(f"Unknown log argument tag {tag!r}")
+        args.append(value)
+    return args
+
+
+def parse_record(record: bytes, sites: Dict[int, LogSite]) -> LogRecord:
+    """Parses a binary log record, looking up its site in `sites`."""
+    level, flags, id, timestamp = RECORD_HEADER.unpack_from(record)
+    if id not in sites:
+        raise ValueError(f"No log site with ID {id:#x}")
+    return LogRecord(
+        level=chr(level),
+        timestamp=timestamp,
+        site=sites[id],
+        args=parse_args(record[RECORD_HEADER.size :]),
+        truncated=bool(flags & RECORD_TRUNCATED),
+    )
+
+
+def format_message(fmt: str, args: List[Arg]) -> str:
+    """Formats `args` with the printf format string `fmt`."""
+    arg_iter = iter(args)
+
+    def next_arg() -> Arg:
+        # Arguments dropped from a truncated record are shown as "?".
+        return next(arg_iter, "?")
+
+    def replace(match: re.Match) -> str:
+        conversion = match.group("conversion")
+        if conversion == "%":
+            return "%"
+        spec = match.group("flags")
+        width = match.group("width")
+        if width == "*":
+            width = str(next_arg())
+        if width is not None:
+            spec += width
+        precision = match.group("precision")
+        if precision == "*":
+            precision = str(next_arg())
+        if precision is not None:
+            spec += "." + (precision or "0")
+        value = next_arg()
+        if isinstance(value, str) and conversion != "s":
+            return value
+        if conversion in "di":
+            return ("%" + spec + "d") % int(value)
+        if conversion in "ouxX":
+            bits = LENGTH_BITS[match.group("length")]
+            return ("%" + spec + conversion) % (int(value) & ((1 << bits) - 1))
+        if conversion in "eEfFgG":
+            return ("%" + spec + conversion) % float(value)
+        if conversion in "aA":
+            return float(value).hex()
+        if conversion == "c":
+            return ("%" + spec + "c") % chr(int(value) & 0xFF)
+        if conversion == "p":
+            return ("%" + spec + "s") % hex(int(value))
+        if not isinstance(value, str):
+            # A null string is recorded as a pointer.
+            value = "(null)"
+        return ("%" + spec + "s") % value
+
+    return CONVERSION.sub(replace, fmt)
+
+
+def format_record(record: LogRecord) -> str:
+    """
+    Formats a record like the log messages of the POSIX PAL, with the
+    timestamp in system ticks.
+    """
+    message = format_message(record.site.format, record.args)
+    if record.truncated:
+        message += " [truncated]"
+    return (
+        f"{record.level} {record.timestamp} executorch:"
+        f"{record.site.filename}:{record.site.line}] {message}"
+    )
+
+
+def decode_lines(lines: Iterable[str], sites: Dict[int, LogSite]) -> Iterator[str]:
+    """Decodes the records in `lines`, passing the other lines through."""
+    for line in lines:
+        line = line.rstrip("\n")
+        index = line.find(RECORD_PREFIX)
+        if index < 0:
+            yield line
+            continue
+        record = bytes.fromhex(line[index + len(RECORD_PREFIX) :].strip())
+        yield line[:index] + format_record(parse_record(record, sites))
+
+
+def parse_cli_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument(
+        "--sites_path",
+        required=True,
+        help="The et_log_sites section of the runtime binary, dumped with objcopy.",
+    )
+    parser.add_argument(
+        "--log_path",
+        help="The log output to decode. Defaults to stdin.",
+    )
+
+    return parser.parse_args()
+
+
+def main() -> None:
+    args = parse_cli_args()
+    with open(args.sites_path, "rb") as f:
+        sites = parse_sites(f.read())
+    log = (
+        open(args.log_path, "r", errors="replace")
+        if args.log_path is not None
+        else sys.stdin
+    )
+    with log:
+        for line in decode_lines(log, sites):
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
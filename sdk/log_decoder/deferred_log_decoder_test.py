@@ -0,0 +1,82 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import struct
+import unittest
+
+from executorch.sdk.log_decoder.deferred_log_decoder import (
+    decode_lines,
+    format_message,
+    parse_sites,
+    RECORD_PREFIX,
+    site_id,
+)
+
+METHOD_SITE = (
+    b"/src/executorch/runtime/executor/method.cpp\x00120\x00Loaded %s in %zu us"
+)
+
+# Two sites, the second one compiled twice.
+SITES = (
+    METHOD_SITE
+    + b"\x00kernels/op_add.cpp\x0042\x00Bad dtype %d, size %u\x00"
+    + b"kernels/op_add.cpp\x0042\x00Bad dtype %d, size %u\x00"
+)
+
+
+def make_record(level: str, id: int, timestamp: int, args: bytes, flags: int = 0):
+    return struct.pack("<BBIQ", ord(level), flags, id, timestamp) + args
+
+
+class DeferredLogDecoderTest(unittest.TestCase):
+    def test_parse_sites(self) -> None:
+        sites = parse_sites(SITES)
+        self.assertEqual(len(sites), 2)
+        site = sites[site_id(METHOD_SITE)]
+        self.assertEqual(site.filename, "method.cpp")
+        self.assertEqual(site.line, 120)
+        self.assertEqual(site.format, "Loaded %s in %zu us")
+
+    def test_parse_sites_truncated(self) -> None:
+        with self.assertRaises(ValueError):
+            parse_sites(SITES[:-5])
+
+    def test_decode_lines(self) -> None:
+        sites = parse_sites(SITES)
+        args = b"s\x07forward" + b"u" + struct.pack("<Q", 35)
+        record = make_record("I", site_id(METHOD_SITE), 1000, args)
+        lines = [
+            "Not a record\n",
+            "[device] " + RECORD_PREFIX + record.hex() + "\n",
+        ]
+        self.assertEqual(
+            list(decode_lines(lines, sites)),
+            [
+                "Not a record",
+                "[device] I 1000 executorch:method.cpp:120] Loaded forward in 35 us",
+            ],
+        )
+
+    def test_decode_truncated_record(self) -> None:
+        sites = parse_sites(SITES)
+        id = site_id(b"kernels/op_add.cpp\x0042\x00Bad dtype %d, size %u")
+        args = b"i" + struct.pack("<q", -1)
+        record = make_record("E", id, 5, args, flags=1)
+        (line,) = decode_lines([RECORD_PREFIX + record.hex()], sites)
+        self.assertEqual(
+            line, "E 5 executorch:op_add.cpp:42] Bad dtype -1, size ? [truncated]"
+        )
+
+    def test_format_message(self) -> None:
+        self.assertEqual(
+            format_message("%5.2f|%-4x|%c|%p|%lld%%", [3.14159, 255, 65, 4660, -7]),
+            " 3.14|ff  |A|0x1234|-7%",
+        )
+        # Negative values print as unsigned of the width of the conversion.
+        self.assertEqual(
+            format_message("%x %hhx %lx", [-1, -1, -1]), "ffffffff ff " + "f" * 16
+        )
+        self.assertEqual(format_message("%*d|%s", [4, 7, 0]), "   7|(null)")
@@ -0,0 +1,240 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""
+Attributes the code size of a linked runtime binary to the operator kernels it
+contains, and to the dtypes that each kernel was instantiated for, so that the
+kernels that a model does not need, and the dtypes that are most expensive to
+support, stand out.
+"""
+
+import argparse
+import json
+import re
+import subprocess
+from collections import defaultdict
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+import yaml
+
+from executorch.exir._serialize._program import deserialize_pte_binary
+
+# C++ spellings of the scalar types that ET_SWITCH macros instantiate kernels for,
+# as they appear in demangled template arguments.
+CPP_TYPE_TO_DTYPE = {
+    "bool": "Bool",
+    "unsigned char": "Byte",
+    "signed char": "Char",
+    "short": "Short",
+    "int": "Int",
+    "long": "Long",
+    "long long": "Long",
+    "float": "Float",
+    "double": "Double",
+    "Half": "Half",
+    "BFloat16": "BFloat16",
+}
+
+UNSPECIALIZED = "unspecialized"
+
+
+def parse_nm_output(nm_output: str) -> List[Tuple[str, int]]:
+    """
+    Parses the output of `nm --print-size --demangle` into (symbol, size in bytes)
+    pairs. Symbols without a size, such as undefined ones, are skipped.
+    """
+    symbols = []
+    for line in nm_output.splitlines():
+        parts = line.split(maxsplit=3)
+        if len(parts) < 4:
+            continue
+        _, size, symbol_type, name = parts
+        # Only code contributes to the size of the kernels
+        if symbol_type not in ("t", "T", "w", "W"):
+            continue
+        try:
+            symbols.append((name, int(size, 16)))
+        except ValueError:
+            continue
+    return symbols
+
+
+def load_kernel_names(functions_yaml_paths: Iterable[str]) -> Dict[str, str]:
+    """
+    Given kernel registration yamls such as kernels/portable/functions.yaml, returns
+    the name of each kernel function, without its namespace, mapped to the name of
+    the operator it implements, e.g. "add_out" -> "add.out".
+    """
+    kernel_names = {}
+    for path in functions_yaml_paths:
+        with open(path) as f:
+            entries = yaml.safe_load(f) or []
+        for entry in entries:
+            op = entry.get("op") or entry.get("func", "").split("(")[0]
+            for kernel in entry.get("kernels") or []:
+                if (kernel_name := kernel.get("kernel_name")) is not None:
+                    kernel_names[kernel_name.split("::")[-1]] = op
+    return kernel_names
+
+
+def get_program_operators(pte_data: bytes) -> Set[str]:
+    """
+    Returns the operators that the execution plans of a .pte file call, in the
+    "name.overload" form of the kernel registration yamls.
+    """
+    program = deserialize_pte_binary(pte_data)
+    ops = set()
+    for plan in program.execution_plan:
+        for operator in plan.operators:
+            # The yamls leave out the aten namespace, but not others
+            name = operator.name.removeprefix("aten::")
+            ops.add(f"{name}.{operator.overload}" if operator.overload else name)
+    return ops
+
+
+def _find_kernel(symbol: str, kernel_names: Dict[str, str]) -> Optional[str]:
+    # The outermost kernel function in the symbol owns it, e.g. the ET_SWITCH lambdas
+    # of add_out are named "torch::executor::native::add_out(...)::{lambda()#1}...".
+    for match in re.finditer(r"(\w+)\(", symbol):
+        if match.group(1) in kernel_names:
+            return kernel_names[match.group(1)]
+    return None
+
+
+def _template_args(symbol: str) -> List[str]:
+    # The arguments of every template in the symbol, nested ones included
+    args = []
+    starts = []
+    for index, char in enumerate(symbol):
+        if char == "<":
+            starts.append(index + 1)
+        elif char in ",>" and starts:
+            args.append(symbol[starts[-1] : index].strip())
+            if char == ">":
+                starts.pop()
+            else:
+                starts[-1] = index + 1
+    return args
+
+
+def _find_dtypes(symbol: str) -> str:
+    dtypes = [
+        CPP_TYPE_TO_DTYPE[name]
+        for arg in _template_args(symbol)
+        if (name := arg.split("::")[-1]) in CPP_TYPE_TO_DTYPE
+    ]
+    return ",".join(dtypes) if dtypes else UNSPECIALIZED
+
+
+def generate_kernel_size_information(
+    symbols: List[Tuple[str, int]],
+    kernel_names: Dict[str, str],
+    program_ops: Optional[Set[str]] = None,
+) -> Dict:
+    """
+    Generates a json-serializable Dict that attributes the code size of kernel
+    symbols to operators, sorted by size. Within each operator, the size is further
+    split by the dtypes found in the template arguments of its symbols, in order;
+    code that is not a template instantiation is "unspecialized".
+
+    If program_ops is provided, each operator is marked with whether the program
+    uses it, and the overview reports how much kernel code is unused, which is what
+    selective build would save.
+    """
+    op_sizes: Dict[str, Dict[str, int]] = defaultdict(lambda: defaultdict(int))
+    for symbol, size in symbols:
+        if (op := _find_kernel(symbol, kernel_names)) is not None:
+            op_sizes[op][_find_dtypes(symbol)] += size
+
+    kernels = []
+    for op, dtype_sizes in op_sizes.items():
+        kernel = {
+            "op": op,
+            "num_bytes": sum(dtype_sizes.values()),
+            "dtypes": dict(
+                sorted(dtype_sizes.items(), key=lambda item: item[1], reverse=True)
+            ),
+        }
+        if program_ops is not None:
+            kernel["used_by_program"] = op in program_ops
+        kernels.append(kernel)
+    kernels.sort(key=lambda kernel: kernel["num_bytes"], reverse=True)
+
+    overview = {"total_kernel_size": sum(kernel["num_bytes"] for kernel in kernels)}
+    if program_ops is not None:
+        overview["unused_kernel_size"] = sum(
+            kernel["num_bytes"] for kernel in kernels if not kernel["used_by_program"]
+        )
+        overview["missing_ops"] = sorted(program_ops - op_sizes.keys())
+
+    return {"kernels": kernels, "overview": overview}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument(
+        "--binary_path",
+        required=True,
+        help="The linked runtime binary to analyze, e.g. executor_runner",
+    )
+
+    parser.add_argument(
+        "--functions_yaml_path",
+        action="append",
+        required=True,
+        help="A kernel registration yaml, e.g. kernels/portable/functions.yaml. "
+        "Can be repeated.",
+    )
+
+    parser.add_argument(
+        "--pte_path",
+        help="An optional .pte file whose operators to compare the kernels against",
+    )
+
+    parser.add_argument(
+        "--nm",
+        default="nm",
+        help="The nm of the toolchain that built the binary",
+    )
+
+    parser.add_argument(
+        "--output_path",
+        default="kernel_size_information.json",
+        help="The output path for the kernel size information as a json file",
+    )
+
+    args = parser.parse_args()
+    return args
+
+
+def main():
+    args = parse_args()
+
+    nm_output = subprocess.run(
+        [args.nm, "--print-size", "--demangle", args.binary_path],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+
+    program_ops = None
+    if args.pte_path is not None:
+        with open(args.pte_path, "rb") as f:
+            program_ops = get_program_operators(f.read())
+
+    kernel_size_information = generate_kernel_size_information(
+        parse_nm_output(nm_output),
+        load_kernel_names(args.functions_yaml_path),
+        program_ops,
+    )
+
+    with open(args.output_path, "w") as f:
+        f.write(json.dumps(kernel_size_information))
+
+
+if __name__ == "__main__":
+    main()
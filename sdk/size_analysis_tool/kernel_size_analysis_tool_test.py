@@ -0,0 +1,93 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import tempfile
+import unittest
+
+from executorch.sdk.size_analysis_tool.kernel_size_analysis_tool import (
+    generate_kernel_size_information,
+    load_kernel_names,
+    parse_nm_output,
+)
+
+KERNEL_ARGS = (
+    "(torch::executor::RuntimeContext&, torch::executor::Tensor const&, "
+    "torch::executor::Tensor const&, torch::executor::Scalar const&, "
+    "torch::executor::Tensor&)"
+)
+
+NM_OUTPUT = f"""\
+0000000000001000 0000000000000100 T torch::executor::native::add_out{KERNEL_ARGS}
+0000000000002000 0000000000000200 t torch::executor::native::add_out{KERNEL_ARGS}::{{lambda()#1}}::operator()() const
+0000000000003000 0000000000000040 W void torch::executor::apply_binary_elementwise_fn<float, int, c10::Half>(torch::executor::native::add_out{KERNEL_ARGS}::{{lambda(float, int)#1}} const&)
+0000000000004000 0000000000000010 T torch::executor::native::mul_out{KERNEL_ARGS}
+0000000000005000 0000000000000020 T torch::executor::Method::execute()
+0000000000006000 0000000000000010 D torch::executor::native::add_out_table
+                 U memcpy
+"""
+
+
+class KernelSizeAnalysisToolTest(unittest.TestCase):
+    def test_parse_nm_output(self):
+        symbols = parse_nm_output(NM_OUTPUT)
+        # Data and undefined symbols are skipped
+        self.assertEqual(
+            [size for _, size in symbols], [0x100, 0x200, 0x40, 0x10, 0x20]
+        )
+
+    def test_load_kernel_names(self):
+        with tempfile.NamedTemporaryFile("w", suffix=".yaml") as f:
+            f.write(
+                """
+- op: add.out
+  kernels:
+    - arg_meta: null
+      kernel_name: torch::executor::add_out
+
+- func: custom::mul.out(Tensor a, Tensor b, *, Tensor(a!) out) -> Tensor(a!)
+  kernels:
+    - arg_meta: null
+      kernel_name: custom::native::mul_out
+"""
+            )
+            f.flush()
+            self.assertEqual(
+                load_kernel_names([f.name]),
+                {"add_out": "add.out", "mul_out": "custom::mul.out"},
+            )
+
+    def test_generate_kernel_size_information(self):
+        info = generate_kernel_size_information(
+            parse_nm_output(NM_OUTPUT),
+            {"add_out": "add.out", "mul_out": "mul.out"},
+            program_ops={"add.out", "sub.out"},
+        )
+
+        self.assertEqual(
+            info["kernels"],
+            [
+                {
+                    "op": "add.out",
+                    "num_bytes": 0x340,
+                    "dtypes": {"unspecialized": 0x300, "Float,Int,Half": 0x40},
+                    "used_by_program": True,
+                },
+                {
+                    "op": "mul.out",
+                    "num_bytes": 0x10,
+                    "dtypes": {"unspecialized": 0x10},
+                    "used_by_program": False,
+                },
+            ],
+        )
+        self.assertEqual(
+            info["overview"],
+            {
+                "total_kernel_size": 0x350,
+                "unused_kernel_size": 0x10,
+                "missing_ops": ["sub.out"],
+            },
+        )
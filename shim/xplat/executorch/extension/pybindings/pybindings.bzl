@@ -20,6 +20,7 @@ PORTABLE_MODULE_DEPS = [
     "//executorch/extension/memory_allocator:malloc_memory_allocator",
     "//executorch/util:util",
     "//executorch/runtime/executor/test:test_backend_compiler_lib",
+    "//executorch/sdk/etdump:etdump_flatcc",
 ] + get_all_cpu_backend_targets()
 
 ATEN_MODULE_DEPS = [
@@ -36,6 +37,7 @@ ATEN_MODULE_DEPS = [
     "//caffe2:torch_extension",
     "//caffe2:ATen",
     "//executorch/runtime/executor/test:test_backend_compiler_lib_aten",
+    "//executorch/sdk/etdump:etdump_flatcc",
 ]
 
 # Generated lib for all ATen ops with aten kernel used by models in model inventory
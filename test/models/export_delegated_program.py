@@ -13,7 +13,7 @@ from typing import Dict, final, Optional, Sequence, Type
 import executorch.exir as exir
 
 import torch
-from executorch.exir.backend.backend_api import to_backend
+from executorch.exir.backend.backend_api import add_alternative_lowering, to_backend
 from executorch.exir.backend.backend_details import BackendDetails, PreprocessResult
 from executorch.exir.backend.test.backend_with_compiler_demo import (
     BackendWithCompilerDemo,
@@ -26,6 +26,9 @@ Creates two versions of each file:
 - <module-name>.pte: Delegate data stored in segments outside of the flatbuffer data.
 - <module-name>-nosegments.pte: Delegate data is stored directly in the flatbuffer data.
 
+With --alternative_backend_id, instead creates <module-name>-alternatives.pte,
+whose partitions also carry a lowering to the alternative backend.
+
 This tool mainly exists to export programs for C++ tests, but can also
 be used to export models manually.
 """
@@ -64,6 +67,15 @@ class StubBackend(BackendDetails):
         return PreprocessResult(processed_bytes=b"StubBackend:data")
 
 
+@final
+class AlternativeStubBackend(BackendDetails):
+    """A second no-op backend, to lower partitions to alternatively."""
+
+    @staticmethod
+    def preprocess(*args, **kwargs) -> PreprocessResult:
+        return PreprocessResult(processed_bytes=b"AlternativeStubBackend:data")
+
+
 #
 # Program logic
 #
@@ -77,6 +89,7 @@ def export_module_to_program(
     constant_tensor_alignemnt: Optional[int] = None,
     delegate_alignment: Optional[int] = None,
     method: str = "forward",
+    alternative_backend_id: Optional[str] = None,
 ) -> bytes:
     eager_module = module_class().eval()
     inputs = ()
@@ -91,6 +104,8 @@ def export_module_to_program(
     ).to_edge()
 
     lowered_module = to_backend(backend_id, edge.exported_program, compile_specs=[])
+    if alternative_backend_id is not None:
+        add_alternative_lowering(lowered_module, alternative_backend_id, [])
 
     class CompositeModule(nn.Module):
         def __init__(self):
@@ -126,6 +141,7 @@ def main() -> None:
     known_backend_ids = [
         BackendWithCompilerDemo.__name__,
         StubBackend.__name__,
+        AlternativeStubBackend.__name__,
     ]
 
     # These args are optimized for genrule usage. There's a lot of startup
@@ -148,6 +164,14 @@ def main() -> None:
         help="ID of the backend to use for delegation; "
         + f"one of {known_backend_ids}",
     )
+    parser.add_argument(
+        "--alternative_backend_id",
+        type=str,
+        default=None,
+        help="ID of a backend to also lower each partition to, as an "
+        + "alternative that the runtime may choose; "
+        + f"one of {known_backend_ids}",
+    )
     parser.add_argument(
         "--outdir",
         type=str,
@@ -169,6 +193,19 @@ def main() -> None:
     # Export and write to the output files.
     os.makedirs(args.outdir, exist_ok=True)
     for module_name, module_class in module_names_to_classes.items():
+        if args.alternative_backend_id is not None:
+            outfile = os.path.join(args.outdir, f"{module_name}-alternatives.pte")
+            with open(outfile, "wb") as fp:
+                fp.write(
+                    export_module_to_program(
+                        module_class,
+                        backend_id=args.backend_id,
+                        extract_segments=True,
+                        alternative_backend_id=args.alternative_backend_id,
+                    )
+                )
+            print(f"Exported {module_name} and wrote program data to {outfile}")
+            continue
         for extract_segments in (True, False):
             suffix = "" if extract_segments else "-nosegments"
             # Create files with the default alignment, and a large alignment.
@@ -0,0 +1,408 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import argparse
+import os
+import struct
+from typing import Callable, Dict, List, Optional
+
+from executorch.exir._serialize._program import serialize_pte_binary
+from executorch.exir.scalar_type import ScalarType
+from executorch.exir.schema import (
+    AllocationDetails,
+    Bool,
+    Buffer,
+    Chain,
+    ContainerMetadata,
+    Double,
+    EValue,
+    ExecutionPlan,
+    FreeCall,
+    Instruction,
+    Int,
+    JumpFalseCall,
+    KernelCall,
+    MoveCall,
+    NamedConstant,
+    Operator,
+    Program,
+    Tensor,
+    TensorShapeDynamism,
+    WhileBegin,
+    WhileEnd,
+)
+
+"""Writes ExecuTorch .pte program files whose instructions are spelled out by
+hand.
+
+Some instruction layouts, like bookkeeping instructions that are jumped over or
+into, are hard to get out of export reliably, but the C++ tests need to know
+exactly which instructions a program holds. Each program here is built
+directly from the schema instead.
+"""
+
+#
+# Helpers
+#
+
+
+def _tensor(
+    scalar_type: ScalarType,
+    sizes: List[int],
+    memory_offset: Optional[int] = None,
+    constant_buffer_idx: int = 0,
+) -> EValue:
+    """Returns a tensor value, planned in memory buffer 1 at `memory_offset`,
+    backed by an entry of the constant buffer, or left for the runtime to point
+    somewhere if it is neither.
+    """
+    return EValue(
+        Tensor(
+            scalar_type=scalar_type,
+            storage_offset=0,
+            sizes=sizes,
+            dim_order=list(range(len(sizes))),
+            requires_grad=False,
+            layout=0,
+            constant_buffer_idx=constant_buffer_idx,
+            allocation_info=(
+                None
+                if memory_offset is None
+                else AllocationDetails(memory_id=1, memory_offset=memory_offset)
+            ),
+            shape_dynamism=TensorShapeDynamism.STATIC,
+        )
+    )
+
+
+def _program(
+    values: List[EValue],
+    inputs: List[int],
+    outputs: List[int],
+    instructions: List[Instruction],
+    operators: List[Operator],
+    planned_bytes: int,
+    constant_buffer: Optional[List[Buffer]] = None,
+    named_constants: Optional[List[NamedConstant]] = None,
+) -> Program:
+    """Returns a program with a single "forward" method of one chain."""
+    return Program(
+        version=0,
+        execution_plan=[
+            ExecutionPlan(
+                name="forward",
+                container_meta_type=ContainerMetadata(
+                    encoded_inp_str="", encoded_out_str=""
+                ),
+                values=values,
+                inputs=inputs,
+                outputs=outputs,
+                chains=[
+                    Chain(
+                        inputs=inputs,
+                        outputs=outputs,
+                        instructions=instructions,
+                        stacktrace=None,
+                    )
+                ],
+                operators=operators,
+                delegates=[],
+                non_const_buffer_sizes=[0, planned_bytes],
+                named_constants=named_constants,
+            )
+        ],
+        # Entry 0 is reserved for tensors without constant data.
+        constant_buffer=[Buffer(storage=b"")] + (constant_buffer or []),
+        backend_delegate_data=[],
+        segments=[],
+    )
+
+
+#
+# Programs
+#
+
+
+def folded_move_jumps() -> Program:
+    """Computes y = (x + x) * (x + x) if pred, and y = (x + x) + (x + x)
+    otherwise, for a float[2] x and a bool[1] pred.
+
+    Each branch ends in a MoveCall that the runtime folds into the kernel
+    before it, and the JumpFalseCalls jump around them. The last MoveCall is
+    the destination of the jump over the else branch, so it must stay an
+    instruction of its own.
+    """
+    x, pred, t, u, w, s, o, y, alpha, false = range(10)
+    values = [
+        _tensor(ScalarType.FLOAT, [2], memory_offset=0),  # x
+        _tensor(ScalarType.BOOL, [1], memory_offset=8),  # pred
+        _tensor(ScalarType.FLOAT, [2], memory_offset=16),  # t
+        _tensor(ScalarType.FLOAT, [2], memory_offset=24),  # u
+        _tensor(ScalarType.FLOAT, [2], memory_offset=32),  # w
+        # Move destinations, which alias the tensors moved into them.
+        _tensor(ScalarType.FLOAT, [2]),  # s
+        _tensor(ScalarType.FLOAT, [2]),  # o
+        _tensor(ScalarType.FLOAT, [2]),  # y
+        EValue(Int(1)),  # alpha
+        EValue(Bool(False)),
+    ]
+    add, mul = range(2)
+    instructions = [
+        # 0: t = x + x, then s = t (folded).
+        Instruction(KernelCall(op_index=add, args=[x, x, alpha, t, t])),
+        Instruction(MoveCall(move_from=t, move_to=s)),
+        # 2: if not pred, goto 7.
+        Instruction(JumpFalseCall(cond_value_index=pred, destination_instruction=7)),
+        # 3: u = s * s, then o = u and free t (folded).
+        Instruction(KernelCall(op_index=mul, args=[s, s, u, u])),
+        Instruction(MoveCall(move_from=u, move_to=o)),
+        Instruction(FreeCall(value_index=t)),
+        # 6: goto 9.
+        Instruction(
+            JumpFalseCall(cond_value_index=false, destination_instruction=9)
+        ),
+        # 7: w = s + s, then o = w (folded).
+        Instruction(KernelCall(op_index=add, args=[s, s, alpha, w, w])),
+        Instruction(MoveCall(move_from=w, move_to=o)),
+        # 9: y = o. A jump destination, so not folded into instruction 7.
+        Instruction(MoveCall(move_from=o, move_to=y)),
+    ]
+    return _program(
+        values,
+        inputs=[x, pred],
+        outputs=[y],
+        instructions=instructions,
+        operators=[
+            Operator(name="aten::add", overload="out"),
+            Operator(name="aten::mul", overload="out"),
+        ],
+        planned_bytes=40,
+    )
+
+
+def _while_double(planned_output: bool) -> Program:
+    """Computes acc = x * 2**n for a float[2] x and a float[1] n with a
+    while loop that carries a counter and acc, and returns acc.
+
+    The loop swaps each state with its body output on every iteration after
+    the first, so an odd n ends with the state in the body output's buffer and
+    an even n does not. If not `planned_output`, acc has no planned buffer, and
+    the caller must provide the output buffer.
+    """
+    x, n, zero, i, acc, pred, i_next, acc_next, one, iters, false = range(11)
+    values = [
+        _tensor(ScalarType.FLOAT, [2], memory_offset=0),  # x
+        _tensor(ScalarType.FLOAT, [1], memory_offset=8),  # n
+        _tensor(ScalarType.FLOAT, [1], constant_buffer_idx=1),  # zero
+        # The loop-carried state.
+        _tensor(ScalarType.FLOAT, [1], memory_offset=16),  # i
+        _tensor(  # acc
+            ScalarType.FLOAT, [2], memory_offset=24 if planned_output else None
+        ),
+        _tensor(ScalarType.BOOL, [1], memory_offset=32),  # pred
+        # The body outputs, swapped with the state by WhileBegin.
+        _tensor(ScalarType.FLOAT, [1], memory_offset=40),  # i_next
+        _tensor(ScalarType.FLOAT, [2], memory_offset=48),  # acc_next
+        EValue(Int(1)),  # one
+        EValue(Int(0)),  # iters
+        EValue(Bool(False)),
+    ]
+    lt, add_scalar, add = range(3)
+    instructions = [
+        # 0: (i, acc) = (zero, x) the first time, (i_next, acc_next) after.
+        Instruction(
+            WhileBegin(
+                init_indices=[zero, x],
+                state_indices=[i, acc],
+                body_output_indices=[i_next, acc_next],
+                iter_index=iters,
+            )
+        ),
+        # 1: if not i < n, goto 6.
+        Instruction(KernelCall(op_index=lt, args=[i, n, pred, pred])),
+        Instruction(JumpFalseCall(cond_value_index=pred, destination_instruction=6)),
+        # 3: i_next = i + 1; acc_next = acc + acc.
+        Instruction(
+            KernelCall(op_index=add_scalar, args=[i, one, one, i_next, i_next])
+        ),
+        Instruction(KernelCall(op_index=add, args=[acc, acc, one, acc_next, acc_next])),
+        # 5: goto 0.
+        Instruction(
+            JumpFalseCall(cond_value_index=false, destination_instruction=0)
+        ),
+        Instruction(WhileEnd(begin_instruction=0)),
+    ]
+    return _program(
+        values,
+        inputs=[x, n],
+        outputs=[acc],
+        instructions=instructions,
+        operators=[
+            Operator(name="aten::lt", overload="Tensor_out"),
+            Operator(name="aten::add", overload="Scalar_out"),
+            Operator(name="aten::add", overload="out"),
+        ],
+        planned_bytes=56,
+        constant_buffer=[Buffer(storage=struct.pack("<f", 0.0))],
+    )
+
+
+def while_double() -> Program:
+    return _while_double(planned_output=True)
+
+
+def while_double_unplanned_output() -> Program:
+    return _while_double(planned_output=False)
+
+
+def scalar_prim_ops() -> Program:
+    """Runs scalar prim ops that the runtime may run inline instead of calling
+    their kernels, and returns each result.
+
+    The floordivs cover each combination of signs. sym_size and sym_numel take
+    the float[2, 3] input x. The last two ops have a double operand, which only
+    the kernels handle.
+    """
+    x, neg7, two, pos7, neg2, one, double7_5 = range(7)
+    values = [
+        _tensor(ScalarType.FLOAT, [2, 3], memory_offset=0),  # x
+        EValue(Int(-7)),
+        EValue(Int(2)),
+        EValue(Int(7)),
+        EValue(Int(-2)),
+        EValue(Int(1)),
+        EValue(Double(7.5)),
+    ]
+    floordiv, sym_size, sym_numel, add = range(4)
+    calls = [
+        (floordiv, [neg7, two]),
+        (floordiv, [pos7, neg2]),
+        (floordiv, [neg7, neg2]),
+        (floordiv, [pos7, two]),
+        (sym_size, [x, one]),
+        (sym_numel, [x]),
+        (floordiv, [double7_5, two]),
+        (add, [double7_5, one]),
+    ]
+    outputs = []
+    instructions = []
+    for op_index, args in calls:
+        outputs.append(len(values))
+        values.append(EValue(Int(0)))
+        instructions.append(
+            Instruction(KernelCall(op_index=op_index, args=args + [outputs[-1]]))
+        )
+    return _program(
+        values,
+        inputs=[x],
+        outputs=outputs,
+        instructions=instructions,
+        operators=[
+            Operator(name="executorch_prim::floordiv", overload="Scalar"),
+            Operator(name="aten::sym_size", overload="int"),
+            Operator(name="aten::sym_numel", overload=""),
+            Operator(name="executorch_prim::add", overload="Scalar"),
+        ],
+        planned_bytes=24,
+    )
+
+
+def scalar_floor_div_by_zero() -> Program:
+    """Returns 7 // 0, which the runtime leaves to the floordiv kernel."""
+    values = [EValue(Int(7)), EValue(Int(0)), EValue(Int(0))]
+    return _program(
+        values,
+        inputs=[],
+        outputs=[2],
+        instructions=[Instruction(KernelCall(op_index=0, args=[0, 1, 2]))],
+        operators=[Operator(name="executorch_prim::floordiv", overload="Scalar")],
+        planned_bytes=0,
+    )
+
+
+def named_constants() -> Program:
+    """Computes y = x + w for a float[2] x and a constant float[2] w of
+    [1, 2], named "w".
+
+    It also holds a mutable state tensor named "state", which set_constants()
+    must reject even though it has initial data like a constant.
+    """
+    x, w, y, state, alpha = range(5)
+    values = [
+        _tensor(ScalarType.FLOAT, [2], memory_offset=0),  # x
+        _tensor(ScalarType.FLOAT, [2], constant_buffer_idx=1),  # w
+        _tensor(ScalarType.FLOAT, [2], memory_offset=8),  # y
+        _tensor(  # state
+            ScalarType.FLOAT, [2], memory_offset=16, constant_buffer_idx=2
+        ),
+        EValue(Int(1)),  # alpha
+    ]
+    return _program(
+        values,
+        inputs=[x],
+        outputs=[y],
+        instructions=[
+            Instruction(KernelCall(op_index=0, args=[x, w, alpha, y, y])),
+        ],
+        operators=[Operator(name="aten::add", overload="out")],
+        planned_bytes=24,
+        constant_buffer=[
+            Buffer(storage=struct.pack("<2f", 1.0, 2.0)),
+            Buffer(storage=struct.pack("<2f", 0.0, 0.0)),
+        ],
+        named_constants=[
+            NamedConstant(name="w", value_index=w),
+            NamedConstant(name="state", value_index=state),
+        ],
+    )
+
+
+#
+# Program logic
+#
+
+# Program names, as given to --programs, to the functions that build them.
+PROGRAMS: Dict[str, Callable[[], Program]] = {
+    "FoldedMoveJumps": folded_move_jumps,
+    "WhileDouble": while_double,
+    "WhileDoubleUnplannedOutput": while_double_unplanned_output,
+    "ScalarPrimOps": scalar_prim_ops,
+    "ScalarFloorDivByZero": scalar_floor_div_by_zero,
+    "NamedConstants": named_constants,
+}
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(
+        prog="export_handwritten_program",
+        description="Writes handwritten ExecuTorch programs to .pte files",
+    )
+    parser.add_argument(
+        "--programs",
+        help="Comma-separated list of program names to write; "
+        + f"any of {list(PROGRAMS)}",
+        type=lambda s: [item.strip() for item in s.split(",")],
+    )
+    parser.add_argument(
+        "--outdir",
+        type=str,
+        required=True,
+        help="Path to the directory to write <program-name>.pte files to.",
+    )
+    args = parser.parse_args()
+
+    os.makedirs(args.outdir, exist_ok=True)
+    for name in args.programs:
+        if name not in PROGRAMS:
+            raise NameError(f"Unknown program '{name}'")
+        outfile = os.path.join(args.outdir, f"{name}.pte")
+        with open(outfile, "wb") as fp:
+            fp.write(serialize_pte_binary(PROGRAMS[name]()))
+        print(f"Wrote program data for {name} to {outfile}")
+
+
+if __name__ == "__main__":
+    main()
@@ -12,6 +12,7 @@ from typing import Any, Dict, List, Type
 
 import torch
 from executorch.exir import CaptureConfig
+from executorch.exir._serialize import _serialize_pte_binary
 from executorch.exir.passes import MemoryPlanningPass
 from executorch.test.end2end.exported_module import ExportedModule
 from torch import nn
@@ -115,6 +116,47 @@ class ModuleDynamicCatUnallocatedIO(nn.Module):
         return {"capture_config": CaptureConfig(pt2_mode=True, enable_aot=True)}
 
 
+class ModuleDynamicBatch(nn.Module):
+    """Adds one to a batch of up to 8 rows."""
+
+    def __init__(self):
+        super(ModuleDynamicBatch, self).__init__()
+        self._inputs = (torch.randn(8, 4),)
+
+    def forward(self, x):
+        return x + 1
+
+    def get_random_inputs(self):
+        return self._inputs
+
+    def get_constraints(self):
+        return [
+            dynamic_dim(self._inputs[0], 0) <= 8,
+        ]
+
+    @staticmethod
+    def get_export_kwargs():
+        return {"capture_config": CaptureConfig(pt2_mode=True, enable_aot=True)}
+
+
+class ModuleNonzero(nn.Module):
+    """Returns the indices of the nonzero elements of its input, an output
+    whose size depends on the data and is not memory-planned."""
+
+    def __init__(self):
+        super(ModuleNonzero, self).__init__()
+
+    def forward(self, x):
+        return torch.nonzero(x)
+
+    def get_random_inputs(self):
+        return (torch.ones(4, 4),)
+
+    @staticmethod
+    def get_export_kwargs():
+        return {"capture_config": CaptureConfig(enable_dynamic_shape=True)}
+
+
 class ModuleLinear(torch.nn.Module):
     def __init__(self):
         super().__init__()
@@ -150,12 +192,38 @@ class ModuleMultipleEntry(torch.nn.Module):
         return ["forward", "forward2"]
 
 
+class ModuleStateful(nn.Module):
+    """Accumulates its inputs in a mutable buffer that persists across
+    executions."""
+
+    def __init__(self):
+        super().__init__()
+        self.register_buffer("state", torch.zeros(2, 2))
+
+    def forward(self, x: torch.Tensor):
+        self.state.add_(x)
+        return self.state + x
+
+    def get_random_inputs(self):
+        return (torch.ones(2, 2, dtype=torch.float),)
+
+    def get_memory_planning_pass(self):
+        # Plans the state in a buffer of its own.
+        return MemoryPlanningPass("greedy", mutable_buffer_mem_id=2)
+
+    @staticmethod
+    def get_export_kwargs():
+        return {"capture_config": CaptureConfig(pt2_mode=True, enable_aot=True)}
+
+
 #
 # Main logic.
 #
 
 
-def export_module_to_program(module_class: Type[nn.Module]):
+def export_module_to_program(
+    module_class: Type[nn.Module], extract_constant_segment: bool = False
+):
     """Exports the module and returns the serialized program data."""
     # Look for an optional @staticmethod that defines custom trace params.
     export_kwargs: Dict[str, Any] = {}
@@ -168,6 +236,14 @@ def export_module_to_program(module_class: Type[nn.Module]):
     else:
         methods = ["forward"]
     module = ExportedModule.export(module_class, methods, **export_kwargs)
+    if extract_constant_segment:
+        return _serialize_pte_binary(
+            module.executorch_program.program,
+            extract_segments=True,
+            extract_constant_segment=True,
+            # Lets the runtime tests exercise Verification::Checksum.
+            program_checksum=True,
+        )
     return module.executorch_program.buffer
 
 
@@ -191,6 +267,12 @@ def main() -> None:
         required=True,
         help="Path to the directory to write <classname>.pte files to",
     )
+    parser.add_argument(
+        "--extract-constant-segment",
+        action="store_true",
+        help="Move constant tensor data into a segment, and write "
+        + "<classname>-constant-segment.pte files",
+    )
     args = parser.parse_args()
 
     # Find the classes to export. Only looks in this module for now, but could
@@ -205,9 +287,15 @@ def main() -> None:
     # Export and write to the output files.
     os.makedirs(args.outdir, exist_ok=True)
     for module_name, module_class in module_names_to_classes.items():
-        outfile = os.path.join(args.outdir, f"{module_name}.pte")
+        suffix = "-constant-segment" if args.extract_constant_segment else ""
+        outfile = os.path.join(args.outdir, f"{module_name}{suffix}.pte")
         with open(outfile, "wb") as fp:
-            fp.write(export_module_to_program(module_class))
+            fp.write(
+                export_module_to_program(
+                    module_class,
+                    extract_constant_segment=args.extract_constant_segment,
+                )
+            )
         print(f"Exported {module_name} and wrote program data to {outfile}")
 
 
@@ -64,15 +64,28 @@ def define_common_targets():
         "ModuleLinear",
         "ModuleMultipleEntry",
         "ModuleIndex",
+        "ModuleNonzero",
         "ModuleDynamicCatUnallocatedIO",
+        "ModuleDynamicBatch",
+        "ModuleStateful",
+    ]
+
+    # Class names of nn.Modules to also export with their constant tensor data
+    # in a segment, as "<name>-constant-segment.pte".
+    CONSTANT_SEGMENT_MODULES_TO_EXPORT = [
+        "ModuleMultipleEntry",
     ]
 
     # Generates Executorch .pte program files for various modules at build time.
     # To use one, depend on a target like ":exported_programs[ModuleAdd.pte]".
     runtime.genrule(
         name = "exported_programs",
-        cmd = "$(exe :export_program) --modules " + ",".join(MODULES_TO_EXPORT) + " --outdir $OUT",
-        outs = {fname + ".pte": [fname + ".pte"] for fname in MODULES_TO_EXPORT},
+        cmd = "$(exe :export_program) --modules " + ",".join(MODULES_TO_EXPORT) + " --outdir $OUT" +
+              " && $(exe :export_program) --extract-constant-segment --modules " + ",".join(CONSTANT_SEGMENT_MODULES_TO_EXPORT) + " --outdir $OUT",
+        outs = dict(
+            {fname + ".pte": [fname + ".pte"] for fname in MODULES_TO_EXPORT},
+            **{fname + "-constant-segment.pte": [fname + "-constant-segment.pte"] for fname in CONSTANT_SEGMENT_MODULES_TO_EXPORT}
+        ),
         default_outs = ["."],
         visibility = [
             "//executorch/...",
@@ -86,6 +99,51 @@ def define_common_targets():
         _is_external_target = True,
     )
 
+    runtime.python_library(
+        name = "export_handwritten_program_lib",
+        srcs = ["export_handwritten_program.py"],
+        deps = [
+            "//executorch/exir:schema",
+            "//executorch/exir:scalar_type",
+            "//executorch/exir/_serialize:lib",
+        ],
+        visibility = [],  # Private
+    )
+
+    runtime.python_binary(
+        name = "export_handwritten_program",
+        main_module = "executorch.test.models.export_handwritten_program",
+        deps = [
+            ":export_handwritten_program_lib",
+        ],
+        visibility = [],  # Private
+    )
+
+    # Names of the programs for :handwritten_programs to write; see
+    # export_handwritten_program.py.
+    HANDWRITTEN_PROGRAMS = [
+        "FoldedMoveJumps",
+        "WhileDouble",
+        "WhileDoubleUnplannedOutput",
+        "ScalarPrimOps",
+        "ScalarFloorDivByZero",
+        "NamedConstants",
+    ]
+
+    # Generates Executorch .pte program files with handwritten instructions at
+    # build time. To use one, depend on a target like
+    # ":handwritten_programs[FoldedMoveJumps.pte]".
+    runtime.genrule(
+        name = "handwritten_programs",
+        cmd = "$(exe :export_handwritten_program) --programs " + ",".join(HANDWRITTEN_PROGRAMS) + " --outdir $OUT",
+        outs = {fname + ".pte": [fname + ".pte"] for fname in HANDWRITTEN_PROGRAMS},
+        default_outs = ["."],
+        visibility = [
+            "//executorch/runtime/executor/test/...",
+            "//executorch/test/...",
+        ],
+    )
+
     runtime.python_library(
         name = "export_delegated_program_lib",
         srcs = ["export_delegated_program.py"],
@@ -123,24 +181,38 @@ def define_common_targets():
     # Name of the backend to use when exporting delegated programs.
     BACKEND_ID = "StubBackend"
 
+    # Name of the backend to lower the partitions of
+    # "<name>-alternatives.pte" to as well.
+    ALTERNATIVE_BACKEND_ID = "AlternativeStubBackend"
+
     # Generates Executorch .pte program files for various modules at build time.
     # To use one, depend on a target like
     # ":exported_delegated_programs[ModuleAdd.pte]" or
     # ":exported_delegated_programs[ModuleAdd-nosegments.pte]" (which does not
-    # extract the delegate data blobs into segments).
+    # extract the delegate data blobs into segments), or
+    # ":exported_delegated_programs[ModuleAdd-alternatives.pte]" (whose
+    # partitions also carry a lowering to ALTERNATIVE_BACKEND_ID).
     runtime.genrule(
         name = "exported_delegated_programs",
         cmd = "$(exe :export_delegated_program)" +
               " --modules " + ",".join(DELEGATED_MODULES_TO_EXPORT) +
               " --backend_id " + BACKEND_ID +
+              " --outdir $OUT" +
+              " && $(exe :export_delegated_program)" +
+              " --modules " + ",".join(DELEGATED_MODULES_TO_EXPORT) +
+              " --backend_id " + BACKEND_ID +
+              " --alternative_backend_id " + ALTERNATIVE_BACKEND_ID +
               " --outdir $OUT",
-        outs = {
-            fname + seg_suffix + da_suffix + ".pte": [fname + seg_suffix + da_suffix + ".pte"]
-            for fname in DELEGATED_MODULES_TO_EXPORT
-            for seg_suffix in ["", "-nosegments"]
-            # "da" = delegate alignment
-            for da_suffix in ["", "-da1024"]
-        },
+        outs = dict(
+            {
+                fname + seg_suffix + da_suffix + ".pte": [fname + seg_suffix + da_suffix + ".pte"]
+                for fname in DELEGATED_MODULES_TO_EXPORT
+                for seg_suffix in ["", "-nosegments"]
+                # "da" = delegate alignment
+                for da_suffix in ["", "-da1024"]
+            },
+            **{fname + "-alternatives.pte": [fname + "-alternatives.pte"] for fname in DELEGATED_MODULES_TO_EXPORT}
+        ),
         default_outs = ["."],
         visibility = [
             "//executorch/runtime/executor/test/...",
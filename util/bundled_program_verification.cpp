@@ -8,6 +8,7 @@
 
 #include <executorch/util/bundled_program_verification.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
@@ -20,6 +21,7 @@
 #include <executorch/runtime/core/memory_allocator.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/platform.h>
 #include <executorch/schema/bundled_program_schema_generated.h>
 
 namespace torch {
@@ -76,9 +78,79 @@ TensorImpl impl_like(
 }
 #endif
 
+// The number of elements that data_mismatches() checks at once. Large enough
+// to amortize the per-block branch, small enough to stop early on a mismatch.
+constexpr size_t kBlockSize = 64;
+
+/**
+ * Returns true if every element of the two arrays is finite and within
+ * tolerance. Has no branches, so that the compiler can vectorize it; blocks
+ * for which it returns false may still be close, e.g. with matching NaNs.
+ */
+template <typename T>
+bool block_is_close(
+    const T* a,
+    const T* b,
+    size_t numel,
+    double rtol,
+    double atol) {
+  // An integer reduction; compilers do not vectorize `bool &=`.
+  unsigned not_close = 0;
+  for (size_t i = 0; i < numel; i++) {
+    // Also not close if either element is NaN or infinite.
+    not_close |= !(std::abs(a[i] - b[i]) <= atol + std::abs(rtol * b[i]));
+  }
+  return not_close == 0;
+}
+
 /**
- * Returns true if the two arrays are close according to the description on
+ * Returns true if the two elements are close according to the description on
  * `tensors_are_close()`.
+ */
+template <typename T>
+bool element_is_close(T a, T b, double rtol, double atol) {
+  if (std::isnan(a) && std::isnan(b)) {
+    // NaN == NaN
+    return true;
+  } else if (!std::isfinite(a) && !std::isfinite(b) && ((a > 0) == (b > 0))) {
+    // -Inf == -Inf
+    // +Inf == +Inf
+    return true;
+  } else if (rtol == 0 && atol == 0) {
+    // Exact comparison; avoid unnecessary math.
+    return a == b;
+  }
+  auto allowed_error = atol + std::abs(rtol * b);
+  auto actual_error = std::abs(a - b);
+  return std::isfinite(actual_error) && actual_error <= allowed_error;
+}
+
+/// Adds the errors of the finite elements `a[i]` against `b[i]` to `stats`.
+template <typename T>
+void accumulate_errors(
+    const T* a,
+    const T* b,
+    size_t numel,
+    OutputComparison* stats) {
+  double max_abs_error = stats->max_abs_error;
+  double max_rel_error = stats->max_rel_error;
+  for (size_t i = 0; i < numel; i++) {
+    const double abs_error = std::abs(static_cast<double>(a[i]) - b[i]);
+    const double rel_error = b[i] != 0 ? abs_error / std::abs(b[i]) : 0;
+    max_abs_error = abs_error > max_abs_error ? abs_error : max_abs_error;
+    max_rel_error = rel_error > max_rel_error ? rel_error : max_rel_error;
+  }
+  stats->max_abs_error = max_abs_error;
+  stats->max_rel_error = max_rel_error;
+}
+
+/**
+ * Returns the number of elements of the two arrays that are not close
+ * according to the description on `tensors_are_close()`.
+ *
+ * If `stats` is null, stops at the first block with a mismatch, so that the
+ * count is only meaningful as zero or non-zero. Otherwise checks every element
+ * and adds the errors to `stats`.
  *
  * T must be a floating point type. Non-floating point data should be compared
  * directly.
@@ -86,44 +158,117 @@ TensorImpl impl_like(
 template <
     typename T,
     typename = std::enable_if_t<std::is_floating_point<T>::value>>
-bool data_is_close(
+size_t data_mismatches(
     const T* a,
     const T* b,
     size_t numel,
     double rtol,
-    double atol) {
-  for (size_t i = 0; i < numel; i++) {
-    const auto ai = a[i];
-    const auto bi = b[i];
-
-    if (std::isnan(ai) && std::isnan(bi)) {
-      // NaN == NaN
-    } else if (
-        !std::isfinite(ai) && !std::isfinite(bi) && ((ai > 0) == (bi > 0))) {
-      // -Inf == -Inf
-      // +Inf == +Inf
-    } else if (rtol == 0 && atol == 0) {
-      // Exact comparison; avoid unnecessary math.
-      if (ai != bi) {
-        return false;
+    double atol,
+    OutputComparison* stats) {
+  size_t mismatches = 0;
+  for (size_t begin = 0; begin < numel; begin += kBlockSize) {
+    const T* a_block = a + begin;
+    const T* b_block = b + begin;
+    const size_t block_numel = std::min(kBlockSize, numel - begin);
+    // Nearly every block of a passing output is entirely finite and close,
+    // so only the others are checked element by element.
+    if (block_is_close(a_block, b_block, block_numel, rtol, atol)) {
+      if (stats != nullptr) {
+        accumulate_errors(a_block, b_block, block_numel, stats);
       }
-    } else {
-      auto allowed_error = atol + std::abs(rtol * bi);
-      auto actual_error = std::abs(ai - bi);
-      if (!std::isfinite(actual_error) || actual_error > allowed_error) {
-        return false;
+      continue;
+    }
+    for (size_t i = 0; i < block_numel; i++) {
+      if (!element_is_close(a_block[i], b_block[i], rtol, atol)) {
+        mismatches++;
       }
+      if (stats != nullptr && std::isfinite(a_block[i]) &&
+          std::isfinite(b_block[i])) {
+        accumulate_errors(a_block + i, b_block + i, 1, stats);
+      }
+    }
+    if (mismatches > 0 && stats == nullptr) {
+      return mismatches;
     }
   }
-  return true;
+  return mismatches;
 }
 
+/**
+ * Returns the number of elements of the two tensors that are not close,
+ * comparing the elements of non-floating point tensors bitwise. See
+ * `data_mismatches()` for how `stats` is used.
+ */
+size_t tensor_data_mismatches(
+    const Tensor& a,
+    const Tensor& b,
+    double rtol,
+    double atol,
+    OutputComparison* stats) {
+  if (stats != nullptr) {
+    stats->compared_elements += a.numel();
+  }
+  if (a.nbytes() == 0) {
+    // Note that this case is important. It's valid for a zero-size tensor to
+    // have a null data pointer, but in some environments it's invalid to pass a
+    // null pointer to memcmp() even when the size is zero.
+    return 0;
+  } else if (a.scalar_type() == ScalarType::Float) {
+    return data_mismatches<float>(
+        a.const_data_ptr<float>(),
+        b.const_data_ptr<float>(),
+        a.numel(),
+        rtol,
+        atol,
+        stats);
+  } else if (a.scalar_type() == ScalarType::Double) {
+    return data_mismatches<double>(
+        a.const_data_ptr<double>(),
+        b.const_data_ptr<double>(),
+        a.numel(),
+        rtol,
+        atol,
+        stats);
+  }
+  // Non-floating-point types can be compared bitwise.
+  if (memcmp(a.const_data_ptr(), b.const_data_ptr(), a.nbytes()) == 0) {
+    return 0;
+  } else if (stats == nullptr) {
+    return 1;
+  }
+  const size_t element_size = a.nbytes() / a.numel();
+  const auto* a_data = static_cast<const uint8_t*>(a.const_data_ptr());
+  const auto* b_data = static_cast<const uint8_t*>(b.const_data_ptr());
+  size_t mismatches = 0;
+  for (size_t i = 0; i < a.nbytes(); i += element_size) {
+    if (memcmp(a_data + i, b_data + i, element_size) != 0) {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
+/**
+ * Returns true if the two tensors are close: they have the same dtype and
+ * shape, and every pair of floating point elements a and b satisfies
+ * |a - b| <= atol + |rtol * b|, or both are NaN, or both are the same
+ * infinity. Non-floating point elements must be equal.
+ *
+ * If `stats` is not null, checks every element and adds the mismatches and
+ * errors to it.
+ */
 bool tensors_are_close(
     const Tensor& a,
     const Tensor& b,
     double rtol,
-    double atol) {
+    double atol,
+    OutputComparison* stats = nullptr) {
   if (a.scalar_type() != b.scalar_type() || a.sizes() != b.sizes()) {
+    if (stats != nullptr) {
+      // Every element of mismatched tensors counts as a mismatch.
+      stats->compared_elements += a.numel();
+      stats->mismatched_elements += a.numel();
+    }
     return false;
   }
 
@@ -139,30 +284,11 @@ bool tensors_are_close(
   // b[i_1, i_2, ... i_n] = b.const_data_ptr()[m])
   // So we can just compare the two underlying data sequentially to figure out
   // if the two tensors are same.
-
-  if (a.nbytes() == 0) {
-    // Note that this case is important. It's valid for a zero-size tensor to
-    // have a null data pointer, but in some environments it's invalid to pass a
-    // null pointer to memcmp() even when the size is zero.
-    return true;
-  } else if (a.scalar_type() == ScalarType::Float) {
-    return data_is_close<float>(
-        a.const_data_ptr<float>(),
-        b.const_data_ptr<float>(),
-        a.numel(),
-        rtol,
-        atol);
-  } else if (a.scalar_type() == ScalarType::Double) {
-    return data_is_close<double>(
-        a.const_data_ptr<double>(),
-        b.const_data_ptr<double>(),
-        a.numel(),
-        rtol,
-        atol);
-  } else {
-    // Non-floating-point types can be compared bitwise.
-    return memcmp(a.const_data_ptr(), b.const_data_ptr(), a.nbytes()) == 0;
+  const size_t mismatches = tensor_data_mismatches(a, b, rtol, atol, stats);
+  if (stats != nullptr) {
+    stats->mismatched_elements += mismatches;
   }
+  return mismatches == 0;
 }
 
 Result<executorch_flatbuffer::BundledExecutionPlanTest*> get_method_test(
@@ -181,6 +307,25 @@ Result<executorch_flatbuffer::BundledExecutionPlanTest*> get_method_test(
 
 } // namespace
 
+__ET_NODISCARD Result<size_t> GetNumBundledTestSets(
+    serialized_bundled_program* bundled_program_ptr,
+    const char* method_name) {
+  ET_CHECK_OR_RETURN_ERROR(
+      executorch_flatbuffer::BundledProgramBufferHasIdentifier(
+          bundled_program_ptr),
+      NotSupported,
+      "The input buffer should be a bundled program.");
+
+  auto method_test = get_method_test(
+      executorch_flatbuffer::GetBundledProgram(bundled_program_ptr),
+      method_name);
+
+  if (!method_test.ok()) {
+    return method_test.error();
+  }
+  return method_test.get()->test_sets()->size();
+}
+
 // Load testset_idx-th bundled data into the Method
 __ET_NODISCARD Error LoadBundledInput(
     Method& method,
@@ -202,6 +347,12 @@ __ET_NODISCARD Error LoadBundledInput(
     return method_test.error();
   }
 
+  ET_CHECK_OR_RETURN_ERROR(
+      testset_idx < method_test.get()->test_sets()->size(),
+      InvalidArgument,
+      "Test set %zu is out of range for method '%s'",
+      testset_idx,
+      method_name);
   auto bundled_inputs =
       method_test.get()->test_sets()->Get(testset_idx)->inputs();
 
@@ -282,7 +433,8 @@ __ET_NODISCARD Error VerifyResultWithBundledExpectedOutput(
     const char* method_name,
     size_t testset_idx,
     double rtol,
-    double atol) {
+    double atol,
+    OutputComparison* comparison) {
   ET_CHECK_OR_RETURN_ERROR(
       executorch_flatbuffer::BundledProgramBufferHasIdentifier(
           bundled_program_ptr),
@@ -300,6 +452,11 @@ __ET_NODISCARD Error VerifyResultWithBundledExpectedOutput(
   auto bundled_expected_outputs =
       method_test.get()->test_sets()->Get(testset_idx)->expected_outputs();
 
+  if (comparison != nullptr) {
+    *comparison = OutputComparison();
+  }
+  bool all_close = true;
+
   for (size_t output_idx = 0; output_idx < method.outputs_size();
        output_idx++) {
     auto bundled_expected_output =
@@ -319,10 +476,27 @@ __ET_NODISCARD Error VerifyResultWithBundledExpectedOutput(
             impl_like(bundled_expected_output_tensor, memory_allocator);
         Tensor t = Tensor(&impl);
 #endif
-        ET_CHECK_OR_RETURN_ERROR(
-            tensors_are_close(t, method_output_tensor, rtol, atol),
-            NotFound, // maybe some new error tag?
-            "Method's output data mismatched the expected one.");
+        if (comparison != nullptr) {
+          // Compare every output, so that the caller gets the whole picture.
+          all_close &= tensors_are_close(
+              t, method_output_tensor, rtol, atol, comparison);
+          break;
+        }
+        if (!tensors_are_close(t, method_output_tensor, rtol, atol)) {
+          // Only a failing output pays for the full comparison.
+          OutputComparison stats;
+          tensors_are_close(t, method_output_tensor, rtol, atol, &stats);
+          ET_LOG(
+              Error,
+              "Output %zu mismatched the expected one: %zu of %zu elements "
+              "out of tolerance, max abs error %g, max rel error %g",
+              output_idx,
+              stats.mismatched_elements,
+              stats.compared_elements,
+              stats.max_abs_error,
+              stats.max_rel_error);
+          return Error::NotFound; // maybe some new error tag?
+        }
         break;
       }
       default: {
@@ -336,9 +510,137 @@ __ET_NODISCARD Error VerifyResultWithBundledExpectedOutput(
     }
   }
 
+  if (!all_close) {
+    ET_LOG(
+        Error,
+        "Method's output data mismatched the expected one: %zu of %zu "
+        "elements out of tolerance, max abs error %g, max rel error %g",
+        comparison->mismatched_elements,
+        comparison->compared_elements,
+        comparison->max_abs_error,
+        comparison->max_rel_error);
+    return Error::NotFound;
+  }
   return Error::Ok;
 }
 
+__ET_NODISCARD Error VerifyPerformanceWithBundledBudget(
+    Method& method,
+    serialized_bundled_program* bundled_program_ptr,
+    MemoryAllocator* memory_allocator,
+    const char* method_name,
+    PerformanceStats* stats,
+    double ticks_per_us) {
+  ET_CHECK_OR_RETURN_ERROR(
+      executorch_flatbuffer::BundledProgramBufferHasIdentifier(
+          bundled_program_ptr),
+      NotSupported,
+      "The input buffer should be a bundled program.");
+
+  auto method_test = get_method_test(
+      executorch_flatbuffer::GetBundledProgram(bundled_program_ptr),
+      method_name);
+
+  if (!method_test.ok()) {
+    return method_test.error();
+  }
+
+  const auto* budget = method_test.get()->performance_budget();
+  ET_CHECK_OR_RETURN_ERROR(
+      budget != nullptr,
+      InvalidArgument,
+      "No performance budget bundled for method '%s'",
+      method_name);
+  const size_t num_test_sets = method_test.get()->test_sets()->size();
+  const size_t num_runs = num_test_sets * budget->num_iterations();
+  ET_CHECK_OR_RETURN_ERROR(
+      num_runs > 0,
+      InvalidArgument,
+      "Method '%s' has %zu test sets and %" PRIu32 " iterations to time",
+      method_name,
+      num_test_sets,
+      budget->num_iterations());
+
+  et_timestamp_t* latencies = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+      memory_allocator, et_timestamp_t, num_runs);
+  size_t run = 0;
+  for (size_t testset_idx = 0; testset_idx < num_test_sets; testset_idx++) {
+    Error status = LoadBundledInput(
+        method,
+        bundled_program_ptr,
+        memory_allocator,
+        method_name,
+        testset_idx);
+    if (status != Error::Ok) {
+      return status;
+    }
+    for (uint32_t i = 0; i < budget->num_warmup_iterations(); i++) {
+      status = method.execute();
+      if (status != Error::Ok) {
+        return status;
+      }
+    }
+    for (uint32_t i = 0; i < budget->num_iterations(); i++) {
+      const et_timestamp_t start = et_pal_current_ticks();
+      status = method.execute();
+      latencies[run++] = et_pal_current_ticks() - start;
+      if (status != Error::Ok) {
+        return status;
+      }
+    }
+  }
+
+  if (ticks_per_us == 0) {
+    const et_tick_ratio_t ratio = et_pal_ticks_to_ns_multiplier();
+    ticks_per_us = ratio.numerator != 0
+        ? 1000.0 * ratio.denominator / ratio.numerator
+        : 1000.0;
+  }
+
+  // Nearest-rank percentiles of the sorted latencies.
+  std::sort(latencies, latencies + num_runs);
+  auto percentile_us = [&](size_t percent) -> uint64_t {
+    const size_t rank = (percent * num_runs + 99) / 100;
+    return static_cast<uint64_t>(latencies[rank - 1] / ticks_per_us);
+  };
+  PerformanceStats measured;
+  measured.num_runs = num_runs;
+  measured.p50_latency_us = percentile_us(50);
+  measured.p90_latency_us = percentile_us(90);
+  measured.p99_latency_us = percentile_us(99);
+  measured.max_latency_us = percentile_us(100);
+  const MethodMeta method_meta = method.method_meta();
+  for (size_t i = 0; i < method_meta.num_memory_planned_buffers(); i++) {
+    measured.planned_memory_bytes +=
+        method_meta.memory_planned_buffer_size(i).get();
+  }
+  if (stats != nullptr) {
+    *stats = measured;
+  }
+
+  bool within_budget = true;
+  auto check = [&](const char* name, uint64_t value, uint64_t limit) {
+    if (limit != 0 && value > limit) {
+      ET_LOG(
+          Error,
+          "Method '%s' exceeds its %s budget: %" PRIu64 " > %" PRIu64,
+          method_name,
+          name,
+          value,
+          limit);
+      within_budget = false;
+    }
+  };
+  check("p50 latency (us)", measured.p50_latency_us, budget->p50_latency_us());
+  check("p90 latency (us)", measured.p90_latency_us, budget->p90_latency_us());
+  check("p99 latency (us)", measured.p99_latency_us, budget->p99_latency_us());
+  check(
+      "planned memory (bytes)",
+      measured.planned_memory_bytes,
+      budget->max_planned_memory_bytes());
+  return within_budget ? Error::Ok : Error::NotFound;
+}
+
 __ET_NODISCARD Error GetProgramData(
     void* file_data,
     size_t file_data_len,
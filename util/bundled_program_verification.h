@@ -9,6 +9,7 @@
 #pragma once
 
 #include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/core/result.h>
 #include <executorch/runtime/executor/method.h>
 
 namespace torch {
@@ -20,6 +21,35 @@ namespace util {
  */
 using serialized_bundled_program = const void;
 
+/**
+ * How closely the outputs of a Method matched the bundled expected outputs.
+ */
+struct OutputComparison {
+  /// The number of output elements that were compared.
+  size_t compared_elements = 0;
+  /// The number of output elements that were out of tolerance.
+  size_t mismatched_elements = 0;
+  /// The largest |actual - expected| over the finite floating point elements.
+  double max_abs_error = 0;
+  /// The largest |actual - expected| / |expected| over the finite floating
+  /// point elements whose expected value is not zero.
+  double max_rel_error = 0;
+};
+
+/**
+ * Returns the number of bundled test sets of a Method, e.g. to load each of
+ * them with LoadBundledInput().
+ *
+ * @param[in] bundled_program_ptr The bundled program.
+ * @param[in] method_name The name of the Method.
+ *
+ * @returns The number of test sets, or Error::InvalidArgument if none are
+ * bundled for the Method.
+ */
+__ET_NODISCARD Result<size_t> GetNumBundledTestSets(
+    serialized_bundled_program* bundled_program_ptr,
+    const char* method_name);
+
 /**
  * Load testset_idx-th bundled input of method_idx-th Method test in
  * bundled_program_ptr to given Method.
@@ -49,6 +79,10 @@ __ET_NODISCARD Error LoadBundledInput(
  * @param[in] testset_idx  The index of expected output needs to be compared.
  * @param[in] rtol Relative tolerance used for data comparsion.
  * @param[in] atol Absolute tolerance used for data comparsion.
+ * @param[out] comparison If not null, every element of every output is
+ *     compared and the mismatches and errors are written here. Otherwise the
+ *     comparison stops at the first mismatch, and only its output is fully
+ *     compared to log the errors.
  *
  * @returns Return Error::Ok if two outputs match, or the error happens during
  * execution.
@@ -60,7 +94,52 @@ __ET_NODISCARD Error VerifyResultWithBundledExpectedOutput(
     const char* method_name,
     size_t testset_idx,
     double rtol = 1e-5,
-    double atol = 1e-8);
+    double atol = 1e-8,
+    OutputComparison* comparison = nullptr);
+
+/**
+ * What VerifyPerformanceWithBundledBudget() measured.
+ */
+struct PerformanceStats {
+  /// The number of timed runs of the method.
+  size_t num_runs = 0;
+  /// Latency percentiles of a single run, in microseconds.
+  uint64_t p50_latency_us = 0;
+  uint64_t p90_latency_us = 0;
+  uint64_t p99_latency_us = 0;
+  uint64_t max_latency_us = 0;
+  /// The total size of the memory-planned buffers of the method.
+  size_t planned_memory_bytes = 0;
+};
+
+/**
+ * Runs every bundled test set of the Method as many times as the performance
+ * budget bundled for it says, and checks the latency percentiles and planned
+ * memory against the budget. Outputs are not verified; see
+ * VerifyResultWithBundledExpectedOutput().
+ *
+ * @param[in] method The Method to measure.
+ * @param[in] bundled_program_ptr The bundled program contains the budget.
+ * @param[in] memory_allocator Allocator for the bundled inputs and the
+ *     latency of every run.
+ * @param[in] method_name  The name of the Method being measured.
+ * @param[out] stats If not null, receives the measurements, also when they
+ *     exceed the budget.
+ * @param[in] ticks_per_us The number of et_pal_current_ticks() ticks per
+ *     microsecond, or 0 to use et_pal_ticks_to_ns_multiplier(), taking the
+ *     ticks as nanoseconds if the PAL does not know their duration.
+ *
+ * @returns Error::Ok if the Method is within its budget, Error::NotFound if
+ * it exceeds it, Error::InvalidArgument if no budget is bundled for it, or the
+ * error that happens during execution.
+ */
+__ET_NODISCARD Error VerifyPerformanceWithBundledBudget(
+    Method& method,
+    serialized_bundled_program* bundled_program_ptr,
+    MemoryAllocator* memory_allocator,
+    const char* method_name,
+    PerformanceStats* stats = nullptr,
+    double ticks_per_us = 0);
 
 /**
  * Finds the serialized ExecuTorch program data in the provided bundled program
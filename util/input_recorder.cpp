@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/util/input_recorder.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include <executorch/runtime/platform/log.h>
+#include <executorch/schema/bundled_program_schema_generated.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+namespace {
+
+// Must match BUNDLED_PROGRAM_SCHEMA_VERSION in bundled_program/version.py.
+constexpr uint32_t kBundledProgramSchemaVersion = 3;
+
+// The force_align of the data and program vectors in the schema.
+constexpr size_t kBundledDataAlignment = 16;
+
+} // namespace
+
+InputRecorder::InputRecorder(const char* method_name, Config config)
+    : method_name_(method_name), config_(config) {}
+
+Error InputRecorder::record(exec_aten::ArrayRef<EValue> inputs) {
+  const size_t call = num_calls_++;
+  if (config_.sample_interval == 0 || call % config_.sample_interval != 0 ||
+      recordings_.size() >= config_.max_recordings) {
+    return Error::Ok;
+  }
+
+  size_t bytes = 0;
+  for (const EValue& input : inputs) {
+    if (input.isTensor()) {
+      bytes += input.toTensor().nbytes();
+    } else if (!input.isInt() && !input.isDouble() && !input.isBool()) {
+      ET_LOG(
+          Error,
+          "Can't record an input of type %" PRIu32,
+          static_cast<uint32_t>(input.tag));
+      return Error::NotSupported;
+    }
+  }
+  if (recorded_bytes_ + bytes > config_.max_bytes) {
+    return Error::Ok;
+  }
+
+  std::vector<RecordedValue> recording(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const EValue& input = inputs[i];
+    RecordedValue& value = recording[i];
+    if (input.isTensor()) {
+      const exec_aten::Tensor& tensor = input.toTensor();
+      value.type = RecordedValue::Type::kTensor;
+      value.scalar_type = static_cast<int8_t>(tensor.scalar_type());
+      value.sizes.assign(tensor.sizes().begin(), tensor.sizes().end());
+      value.dim_order.assign(
+          tensor.dim_order().begin(), tensor.dim_order().end());
+      const uint8_t* data = tensor.const_data_ptr<uint8_t>();
+      value.data.assign(data, data + tensor.nbytes());
+    } else if (input.isInt()) {
+      value.type = RecordedValue::Type::kInt;
+      value.int_val = input.toInt();
+    } else if (input.isDouble()) {
+      value.type = RecordedValue::Type::kDouble;
+      value.double_val = input.toDouble();
+    } else {
+      value.type = RecordedValue::Type::kBool;
+      value.bool_val = input.toBool();
+    }
+  }
+  recordings_.push_back(std::move(recording));
+  recorded_bytes_ += bytes;
+  return Error::Ok;
+}
+
+Error InputRecorder::write_bundled_program(
+    const void* program_data,
+    size_t program_size,
+    const char* path) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      !recordings_.empty(),
+      NotFound,
+      "No inputs of method '%s' were recorded",
+      method_name_.c_str());
+
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<executorch_flatbuffer::BundledIOSet>>
+      test_sets;
+  test_sets.reserve(recordings_.size());
+  for (const std::vector<RecordedValue>& recording : recordings_) {
+    std::vector<flatbuffers::Offset<executorch_flatbuffer::BundledValue>>
+        inputs;
+    inputs.reserve(recording.size());
+    for (const RecordedValue& value : recording) {
+      switch (value.type) {
+        case RecordedValue::Type::kTensor: {
+          auto sizes = builder.CreateVector(value.sizes);
+          builder.ForceVectorAlignment(
+              value.data.size(), sizeof(uint8_t), kBundledDataAlignment);
+          auto data = builder.CreateVector(value.data);
+          auto dim_order = builder.CreateVector(value.dim_order);
+          auto tensor = executorch_flatbuffer::CreateBundledTensor(
+              builder,
+              static_cast<executorch_flatbuffer::ScalarType>(
+                  value.scalar_type),
+              sizes,
+              data,
+              dim_order);
+          inputs.push_back(executorch_flatbuffer::CreateBundledValue(
+              builder,
+              executorch_flatbuffer::BundledValueUnion::BundledTensor,
+              tensor.Union()));
+          break;
+        }
+        case RecordedValue::Type::kInt:
+          inputs.push_back(executorch_flatbuffer::CreateBundledValue(
+              builder,
+              executorch_flatbuffer::BundledValueUnion::BundledInt,
+              executorch_flatbuffer::CreateBundledInt(builder, value.int_val)
+                  .Union()));
+          break;
+        case RecordedValue::Type::kDouble:
+          inputs.push_back(executorch_flatbuffer::CreateBundledValue(
+              builder,
+              executorch_flatbuffer::BundledValueUnion::BundledDouble,
+              executorch_flatbuffer::CreateBundledDouble(
+                  builder, value.double_val)
+                  .Union()));
+          break;
+        case RecordedValue::Type::kBool:
+          inputs.push_back(executorch_flatbuffer::CreateBundledValue(
+              builder,
+              executorch_flatbuffer::BundledValueUnion::BundledBool,
+              executorch_flatbuffer::CreateBundledBool(builder, value.bool_val)
+                  .Union()));
+          break;
+      }
+    }
+    test_sets.push_back(executorch_flatbuffer::CreateBundledIOSet(
+        builder,
+        builder.CreateVector(inputs),
+        builder.CreateVector(
+            std::vector<
+                flatbuffers::Offset<executorch_flatbuffer::BundledValue>>())));
+  }
+
+  auto method_test = executorch_flatbuffer::CreateBundledExecutionPlanTest(
+      builder,
+      builder.CreateString(method_name_),
+      builder.CreateVector(test_sets));
+  builder.ForceVectorAlignment(
+      program_size, sizeof(uint8_t), kBundledDataAlignment);
+  auto program = builder.CreateVector(
+      static_cast<const uint8_t*>(program_data), program_size);
+  executorch_flatbuffer::FinishBundledProgramBuffer(
+      builder,
+      executorch_flatbuffer::CreateBundledProgram(
+          builder,
+          kBundledProgramSchemaVersion,
+          builder.CreateVector(&method_test, 1),
+          program));
+
+  FILE* file = fopen(path, "wb");
+  ET_CHECK_OR_RETURN_ERROR(
+      file != nullptr, AccessFailed, "Could not open %s for writing", path);
+  const size_t written =
+      fwrite(builder.GetBufferPointer(), 1, builder.GetSize(), file);
+  const bool closed = fclose(file) == 0;
+  ET_CHECK_OR_RETURN_ERROR(
+      written == builder.GetSize() && closed,
+      AccessFailed,
+      "Could not write %s",
+      path);
+  return Error::Ok;
+}
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <executorch/runtime/core/array_ref.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/evalue.h>
+
+namespace torch {
+namespace executor {
+namespace util {
+
+/**
+ * Records a sample of the inputs that a Method receives in production, and
+ * writes them out as the test sets of a bundled program, so that benchmarks
+ * can replay real data (its sparsity, sequence lengths, etc.) instead of
+ * random or all-ones tensors. The sets load with LoadBundledInput(); they have
+ * no expected outputs, so they are not meant for
+ * VerifyResultWithBundledExpectedOutput().
+ *
+ * @code
+ *   InputRecorder::Config config;
+ *   config.sample_interval = 100;
+ *   InputRecorder recorder("forward", config);
+ *   ...
+ *   recorder.record(inputs);
+ *   method.set_inputs(inputs);
+ *   method.execute();
+ *   ...
+ *   recorder.write_bundled_program(program_data, program_size, path);
+ * @endcode
+ *
+ * Inputs are copied when they are recorded, so they may be reused or freed
+ * right after. Only tensor, int, double and bool inputs can be recorded.
+ *
+ * Not thread-safe.
+ */
+class InputRecorder final {
+ public:
+  struct Config {
+    /// Record one in every `sample_interval` calls to record(), starting
+    /// with the first one.
+    size_t sample_interval = 1;
+    /// Stop recording after this many sets of inputs.
+    size_t max_recordings = 16;
+    /// Stop recording once the recorded tensor data would exceed this many
+    /// bytes. Keeps the file, and the memory held until it is written, small.
+    size_t max_bytes = 64 * 1024 * 1024;
+  };
+
+  /**
+   * @param[in] method_name The name of the Method whose inputs are recorded,
+   *     under which the test sets are written.
+   * @param[in] config When to record.
+   */
+  explicit InputRecorder(const char* method_name, Config config);
+  explicit InputRecorder(const char* method_name)
+      : InputRecorder(method_name, Config()) {}
+
+  /**
+   * Records a copy of `inputs` if this call is sampled and the caps allow it.
+   * Call with the same inputs as Method::set_inputs().
+   *
+   * @retval Error::Ok if the inputs were recorded or skipped by the sampling
+   *     or the caps.
+   * @retval Error::NotSupported if an input has a type that can't be
+   *     recorded. Nothing is recorded for the call.
+   */
+  __ET_NODISCARD Error record(exec_aten::ArrayRef<EValue> inputs);
+
+  /**
+   * Writes a bundled program file with the program and a test set for each
+   * recorded set of inputs.
+   *
+   * @param[in] program_data The serialized Program that the inputs are for.
+   * @param[in] program_size The size of `program_data` in bytes.
+   * @param[in] path The file to write.
+   *
+   * @retval Error::NotFound if no inputs were recorded.
+   * @retval Error::AccessFailed if the file can't be written.
+   */
+  __ET_NODISCARD Error write_bundled_program(
+      const void* program_data,
+      size_t program_size,
+      const char* path) const;
+
+  /// Returns the number of sets of inputs recorded so far.
+  size_t num_recordings() const {
+    return recordings_.size();
+  }
+
+  /// Returns the bytes of tensor data recorded so far.
+  size_t recorded_bytes() const {
+    return recorded_bytes_;
+  }
+
+ private:
+  /// A copy of one input.
+  struct RecordedValue {
+    enum class Type { kTensor, kInt, kDouble, kBool };
+    Type type;
+    int8_t scalar_type;
+    std::vector<int32_t> sizes;
+    std::vector<uint8_t> dim_order;
+    std::vector<uint8_t> data;
+    int64_t int_val;
+    double double_val;
+    bool bool_val;
+  };
+
+  const std::string method_name_;
+  const Config config_;
+  size_t num_calls_ = 0;
+  size_t recorded_bytes_ = 0;
+  std::vector<std::vector<RecordedValue>> recordings_;
+};
+
+} // namespace util
+} // namespace executor
+} // namespace torch
@@ -21,6 +21,26 @@ def define_common_targets():
         ],
     )
 
+    # Records sampled Method inputs into a bundled program, e.g. for
+    # benchmarks to replay. Reads the dim order of tensors, so it is only
+    # built for the portable tensor type.
+    runtime.cxx_library(
+        name = "input_recorder",
+        srcs = ["input_recorder.cpp"],
+        exported_headers = ["input_recorder.h"],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+            "//executorch/schema:bundled_program_schema",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:evalue",
+        ],
+    )
+
     for aten_mode in (True, False):
         aten_suffix = ("_aten" if aten_mode else "")
         runtime.cxx_library(